@@ -76,6 +76,22 @@ void Context::setBenchmarkCuDNN(bool b) {
   benchmark_cudnn = b;
 }
 
+bool Context::benchmarkReductions() const {
+  return benchmark_reductions;
+}
+
+void Context::setBenchmarkReductions(bool b) {
+  benchmark_reductions = b;
+}
+
+bool Context::fastTranscendentals() const {
+  return fast_transcendentals;
+}
+
+void Context::setFastTranscendentals(bool b) {
+  fast_transcendentals = b;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
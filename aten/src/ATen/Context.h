@@ -130,6 +130,14 @@ class CAFFE2_API Context {
   void setBenchmarkCuDNN(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // Whether CUDA reductions time their candidate launch configs on the first
+  // reduction of each geometry, see Note [Reduction autotuning]
+  bool benchmarkReductions() const;
+  void setBenchmarkReductions(bool);
+  // Whether the CPU transcendental functions (see at::vml) may use their
+  // faster but less accurate implementations, e.g. for inference.
+  bool fastTranscendentals() const;
+  void setFastTranscendentals(bool);
   std::unique_ptr<Generator>
     generator_registry[static_cast<int>(DeviceType::COMPILE_TIME_MAX_DEVICE_TYPES)];
 private:
@@ -154,6 +162,8 @@ private:
   bool enabled_cudnn = true;
   bool deterministic_cudnn = false;
   bool benchmark_cudnn = false;
+  bool benchmark_reductions = false;
+  bool fast_transcendentals = false;
   std::atomic<size_t> next_id;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
   std::unique_ptr<THHState, void(*)(THHState*)> thh_state;
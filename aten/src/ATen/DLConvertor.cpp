@@ -183,15 +183,19 @@ Tensor fromDLPack(const DLManagedTensor* src) {
   auto deleter = [src](void* self) {
     src->deleter(const_cast<DLManagedTensor*>(src));
   };
+  // Producers may hand out a view into a larger allocation as its base pointer
+  // plus a byte offset, which we fold into the data pointer of the tensor.
+  void* data = static_cast<char*>(src->dl_tensor.data) +
+      src->dl_tensor.byte_offset;
   if (!src->dl_tensor.strides) {
-    return at::from_blob(src->dl_tensor.data,
+    return at::from_blob(data,
         IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
         deleter,
         at::device(device).dtype(stype));
   }
 
   return at::from_blob(
-      src->dl_tensor.data,
+      data,
       IntArrayRef(src->dl_tensor.shape, src->dl_tensor.ndim),
       IntArrayRef(src->dl_tensor.strides, src->dl_tensor.ndim),
       deleter,
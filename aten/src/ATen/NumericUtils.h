@@ -1,3 +1,5 @@
+#include <c10/util/BFloat16.h>
+
 #include <cmath>
 #include <type_traits>
 
@@ -19,4 +21,8 @@ inline bool _isnan(T val) {
   return std::isnan(val);
 }
 
+inline bool _isnan(at::BFloat16 val) {
+  return std::isnan(static_cast<float>(val));
+}
+
 } // namespace at
@@ -48,15 +48,52 @@ std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
   AT_CHECK(device_id == 0);
   // Create new thread pool
   AT_CHECK(create_new);
-  return std::make_shared<PTThreadPool>(pool_size);
+  return std::make_shared<PTThreadPool>(
+      pool_size,
+      /* numa_node_id */ -1,
+      c10::getNUMAPolicy(c10::ThreadPoolKind::INTER_OP));
 }
 
+// Sets the size of the intra-op parallel regions started by the calling
+// thread only, unlike set_num_threads which also records it globally.
+void set_thread_local_num_threads(int nthreads) {
+#ifdef _OPENMP
+  omp_set_num_threads(nthreads);
+#endif
+#ifdef TH_BLAS_MKL
+  mkl_set_num_threads_local(nthreads);
+#endif
+}
+
+// Applies the intra-op NUMA policy to the workers of the OpenMP team of the
+// calling thread, see Note [NUMA policies of thread pools]
+void apply_openmp_numa_policy() {
+#ifdef _OPENMP
+  auto policy = c10::getNUMAPolicy(c10::ThreadPoolKind::INTRA_OP);
+  if (policy == c10::NUMAPolicy::NONE) {
+    return;
+  }
+  int home_node = c10::GetCurrentCPUNUMANode();
+#pragma omp parallel
+  {
+    // the calling thread keeps its own placement
+    if (omp_get_thread_num() != 0) {
+      c10::ApplyNUMAPolicy(
+          policy, omp_get_thread_num(), omp_get_num_threads(), home_node);
+    }
+  }
+#endif
 }
 
+} // namespace
+
 void init_num_threads() {
   auto nthreads = num_threads.load();
   if (nthreads > 0) {
     set_num_threads(nthreads);
+  } else if (c10::getThreadBudget() > 0) {
+    // See Note [Thread budget]
+    set_thread_local_num_threads(c10::getThreadBudget());
   } else {
 #if defined(_OPENMP) && defined(TH_BLAS_MKL)
   // If we are using MKL an OpenMP make sure the number of threads match.
@@ -66,6 +103,7 @@ void init_num_threads() {
   omp_set_num_threads(mkl_get_max_threads());
 #endif
   }
+  apply_openmp_numa_policy();
 }
 
 void set_num_threads(int nthreads) {
@@ -85,6 +123,8 @@ void set_num_threads(int nthreads) {
   // See https://github.com/pytorch/pytorch/issues/13757
   mkl_set_dynamic(false);
 #endif
+  // the team may have grown
+  apply_openmp_numa_policy();
 }
 
 // Explicitly calling omp_get_max_threads() as the size of the parallel
@@ -92,6 +132,14 @@ void set_num_threads(int nthreads) {
 // Use init_num_threads() during thread initialization to ensure
 // consistent size of parallel region in different threads
 int get_num_threads() {
+  if (internal::use_native_intraop()) {
+    // See Note [Native work-stealing intra-op backend]
+    int nthreads = num_threads.load();
+    if (nthreads <= 0) {
+      nthreads = TaskThreadPoolBase::defaultNumThreads();
+    }
+    return internal::native_num_threads(nthreads);
+  }
 #ifdef _OPENMP
   return omp_get_max_threads();
 #else
@@ -111,6 +159,15 @@ std::string get_parallel_info() {
 
   ss << "ATen/Parallel:\n\tat::get_num_threads() : "
      << at::get_num_threads() << std::endl;
+  ss << "\tthread budget : " << c10::getThreadBudget() << std::endl;
+  ss << "\tintra-op NUMA policy : "
+     << c10::NUMAPolicyName(c10::getNUMAPolicy(c10::ThreadPoolKind::INTRA_OP))
+     << std::endl;
+  ss << "\tinter-op NUMA policy : "
+     << c10::NUMAPolicyName(c10::getNUMAPolicy(c10::ThreadPoolKind::INTER_OP))
+     << std::endl;
+  ss << "\tintra-op backend : "
+     << (internal::use_native_intraop() ? "native" : "openmp") << std::endl;
 
   ss << at::get_openmp_version() << std::endl;
 #ifdef _OPENMP
@@ -130,18 +187,29 @@ std::string get_parallel_info() {
   ss << "Environment variables:" << std::endl;
   ss << "\tOMP_NUM_THREADS : " << get_env_var("OMP_NUM_THREADS") << std::endl;
   ss << "\tMKL_NUM_THREADS : " << get_env_var("MKL_NUM_THREADS") << std::endl;
+  ss << "\tTORCH_THREAD_BUDGET : " << get_env_var("TORCH_THREAD_BUDGET") << std::endl;
+  ss << "\tATEN_INTRAOP_BACKEND : " << get_env_var("ATEN_INTRAOP_BACKEND") << std::endl;
+  ss << "\tTORCH_INTRAOP_NUMA_POLICY : " << get_env_var("TORCH_INTRAOP_NUMA_POLICY") << std::endl;
+  ss << "\tTORCH_INTEROP_NUMA_POLICY : " << get_env_var("TORCH_INTEROP_NUMA_POLICY") << std::endl;
 
   return ss.str();
 }
 
 PTThreadPool::PTThreadPool(
     int pool_size,
-    int numa_node_id)
-    : c10::ThreadPool(pool_size, numa_node_id) {}
+    int numa_node_id,
+    c10::NUMAPolicy numa_policy)
+    : c10::ThreadPool(pool_size, numa_node_id, numa_policy) {}
 
 void PTThreadPool::init_thread() {
   c10::setThreadName("PTThreadPool");
   at::init_num_threads();
+  // Every worker of the pool may start its own parallel region, so with a
+  // thread budget each of them only gets its share of it, see
+  // Note [Thread budget]
+  if (num_threads.load() <= 0 && c10::getThreadBudget() > 0) {
+    set_thread_local_num_threads(c10::threadBudgetShare(size()));
+  }
 }
 
 C10_REGISTER_CREATOR(ThreadPoolRegistry, C10, create_c10_threadpool);
@@ -5,6 +5,7 @@
 #include <atomic>
 #include <cstddef>
 #include <exception>
+#include <functional>
 
 #ifdef _OPENMP
 #define INTRA_OP_PARALLEL
@@ -20,6 +21,18 @@ namespace internal {
 // no parallel algorithm (such as parallel_reduce) should split work into
 // smaller than GRAIN_SIZE chunks.
 constexpr int64_t GRAIN_SIZE = 32768;
+
+// Native work-stealing backend, enabled with ATEN_INTRAOP_BACKEND=native.
+// See Note [Native work-stealing intra-op backend]
+CAFFE2_API bool use_native_intraop();
+CAFFE2_API int native_thread_num();
+CAFFE2_API bool native_in_task();
+CAFFE2_API int native_num_threads(int requested);
+CAFFE2_API void native_parallel_for(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f);
 } // namespace internal
 
 inline int64_t divup(int64_t x, int64_t y) {
@@ -38,6 +51,9 @@ CAFFE2_API int get_num_threads();
 // Returns the current thread number (starting from 0)
 // in the current parallel region, or 0 in the sequential region
 inline int get_thread_num() {
+  if (internal::use_native_intraop()) {
+    return internal::native_thread_num();
+  }
 #ifdef _OPENMP
   return omp_get_thread_num();
 #else
@@ -46,6 +62,9 @@ inline int get_thread_num() {
 }
 
 inline bool in_parallel_region() {
+  if (internal::use_native_intraop()) {
+    return internal::native_in_task();
+  }
 #ifdef _OPENMP
   return omp_in_parallel();
 #else
@@ -59,6 +78,17 @@ inline void parallel_for(
     const int64_t end,
     const int64_t grain_size,
     const F& f) {
+  if (internal::use_native_intraop()) {
+    if (begin >= end) {
+      return;
+    }
+    if ((end - begin) < grain_size || get_num_threads() == 1) {
+      f(begin, end);
+      return;
+    }
+    internal::native_parallel_for(begin, end, grain_size, f);
+    return;
+  }
 #ifdef _OPENMP
   std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
   std::exception_ptr eptr;
@@ -135,6 +165,16 @@ inline scalar_t parallel_reduce(
     const int64_t num_results = divup((end - begin), grain_size);
     std::vector<scalar_t> results(num_results);
     scalar_t* results_data = results.data();
+    if (internal::use_native_intraop()) {
+      parallel_for(0, num_results, 1, [&](int64_t begin_id, int64_t end_id) {
+        for (int64_t id = begin_id; id < end_id; id++) {
+          int64_t i = begin + id * grain_size;
+          results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
+        }
+      });
+      return std::accumulate(
+          results_data, results_data + results.size(), ident, sf);
+    }
 #ifdef _OPENMP
 #pragma omp parallel for if ((end - begin) >= grain_size)
 #endif
@@ -154,7 +194,8 @@ class CAFFE2_API PTThreadPool : public c10::ThreadPool {
  public:
   explicit PTThreadPool(
       int pool_size,
-      int numa_node_id = -1);
+      int numa_node_id = -1,
+      c10::NUMAPolicy numa_policy = c10::NUMAPolicy::NONE);
 
   void init_thread() override;
 };
@@ -0,0 +1,293 @@
+#include <ATen/Parallel.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Note [Native work-stealing intra-op backend]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default at::parallel_for statically splits its range over the threads of
+// an OpenMP parallel region, and runs nested calls serially.  With
+// ATEN_INTRAOP_BACKEND=native it instead runs on a pool of worker threads
+// with one task deque per worker:
+//
+// - A parallel_for call becomes a "job".  Its range is pushed as a single
+//   task onto the deque of the calling thread (threads outside of the pool
+//   share one extra deque).  Whoever runs a task larger than the job's chunk
+//   size splits it in half, pushes the upper half back onto its own deque,
+//   and continues with the lower half, so work is split lazily and only as
+//   far as needed to keep all threads busy.
+// - Idle workers pop tasks from the back of their own deque and steal from
+//   the front of the other deques.
+// - The calling thread helps out until its job is finished, but only runs
+//   tasks of that very job.  This matters because kernels index per-thread
+//   buffers with get_thread_num(); running an unrelated task in the middle of
+//   another one on the same thread could clobber them.
+// - A parallel_for called from within a task is simply another job, so
+//   nested parallelism (including from inter-op tasks started with
+//   at::launch) turns into stealable subtasks instead of being serialized.
+//
+// Threads are numbered 1..N-1 within the pool, and every thread outside of it
+// is number 0, so get_thread_num() < get_num_threads() holds for every
+// thread running tasks of a given job.  The pool is sized by
+// get_num_threads() when it is first used.
+
+namespace at {
+namespace internal {
+
+namespace {
+
+struct Job {
+  const std::function<void(int64_t, int64_t)>* f;
+  int64_t chunk_size;
+  // number of elements of the range that have not been processed yet
+  std::atomic<int64_t> remaining;
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+};
+
+struct Task {
+  Job* job;
+  int64_t begin;
+  int64_t end;
+};
+
+struct TaskQueue {
+  std::mutex mutex;
+  std::deque<Task> tasks;
+};
+
+thread_local int thread_num = 0;
+thread_local int task_depth = 0;
+
+class NativePool {
+ public:
+  explicit NativePool(int num_threads)
+      : num_threads_(num_threads),
+        queues_(num_threads),
+        epoch_(0),
+        workers_(std::make_shared<PTThreadPool>(
+            num_threads - 1,
+            /* numa_node_id */ -1,
+            c10::getNUMAPolicy(c10::ThreadPoolKind::INTRA_OP))) {
+    for (auto& queue : queues_) {
+      queue.reset(new TaskQueue());
+    }
+    for (int i = 1; i < num_threads_; ++i) {
+      workers_->run([this, i]() { worker_loop(i); });
+    }
+  }
+
+  int num_threads() const {
+    return num_threads_;
+  }
+
+  void run(Job& job, int64_t begin, int64_t end) {
+    push(thread_num, {&job, begin, end});
+    while (job.remaining.load(std::memory_order_acquire) > 0) {
+      uint64_t epoch = epoch_.load();
+      Task task;
+      if (pop_job_task(job, &task)) {
+        execute(task);
+        continue;
+      }
+      wait_for_change(epoch, [&]() {
+        return job.remaining.load(std::memory_order_acquire) == 0;
+      });
+    }
+  }
+
+ private:
+  void push(int queue_id, const Task& task) {
+    {
+      std::lock_guard<std::mutex> guard(queues_[queue_id]->mutex);
+      queues_[queue_id]->tasks.push_back(task);
+    }
+    notify();
+  }
+
+  void notify() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      epoch_++;
+    }
+    cv_.notify_all();
+  }
+
+  // Blocks until a task was pushed or a job finished since `epoch` was
+  // read, or until `done` holds.
+  template <typename Pred>
+  void wait_for_change(uint64_t epoch, const Pred& done) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&]() { return epoch_.load() != epoch || done(); });
+  }
+
+  bool pop_any_task(Task* task) {
+    // own deque first, newest task first
+    {
+      auto& queue = *queues_[thread_num];
+      std::lock_guard<std::mutex> guard(queue.mutex);
+      if (!queue.tasks.empty()) {
+        *task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+      }
+    }
+    // then steal the oldest task of some other deque
+    for (int i = 1; i < num_threads_; ++i) {
+      auto& queue = *queues_[(thread_num + i) % num_threads_];
+      std::lock_guard<std::mutex> guard(queue.mutex);
+      if (!queue.tasks.empty()) {
+        *task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool pop_job_task(Job& job, Task* task) {
+    for (int i = 0; i < num_threads_; ++i) {
+      auto& queue = *queues_[(thread_num + i) % num_threads_];
+      std::lock_guard<std::mutex> guard(queue.mutex);
+      // the most recently pushed tasks of the job are at the back of our own
+      // deque, and in front of the other ones
+      if (i == 0) {
+        for (auto it = queue.tasks.rbegin(); it != queue.tasks.rend(); ++it) {
+          if (it->job == &job) {
+            *task = *it;
+            queue.tasks.erase(std::next(it).base());
+            return true;
+          }
+        }
+      } else {
+        for (auto it = queue.tasks.begin(); it != queue.tasks.end(); ++it) {
+          if (it->job == &job) {
+            *task = *it;
+            queue.tasks.erase(it);
+            return true;
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  void execute(Task task) {
+    Job* job = task.job;
+    while (task.end - task.begin > job->chunk_size) {
+      int64_t mid = task.begin + divup((task.end - task.begin) / 2, job->chunk_size) * job->chunk_size;
+      push(thread_num, {job, mid, task.end});
+      task.end = mid;
+    }
+    task_depth++;
+    try {
+      (*job->f)(task.begin, task.end);
+    } catch (...) {
+      if (!job->err_flag.test_and_set()) {
+        job->eptr = std::current_exception();
+      }
+    }
+    task_depth--;
+    // NB: the job may be destroyed as soon as remaining drops to zero, so it
+    // must not be touched afterwards
+    if (job->remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel) ==
+        task.end - task.begin) {
+      notify();
+    }
+  }
+
+  void worker_loop(int id) {
+    thread_num = id;
+    while (true) {
+      uint64_t epoch = epoch_.load();
+      Task task;
+      if (pop_any_task(&task)) {
+        execute(task);
+        continue;
+      }
+      wait_for_change(epoch, []() { return false; });
+    }
+  }
+
+  const int num_threads_;
+  // queues_[0] is shared by all threads outside of the pool
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  // bumped under mutex_ whenever a task is pushed or a job finishes
+  std::atomic<uint64_t> epoch_;
+  std::shared_ptr<PTThreadPool> workers_;
+};
+
+NativePool& get_native_pool() {
+  // Intentionally leaked: the workers never return, so the pool must never
+  // be joined on exit.
+  static NativePool* pool = new NativePool(std::max(1, get_num_threads()));
+  return *pool;
+}
+
+std::atomic<bool> native_pool_created{false};
+
+} // namespace
+
+bool use_native_intraop() {
+  static const bool use_native = []() {
+    const char* backend = std::getenv("ATEN_INTRAOP_BACKEND");
+    if (!backend) {
+      return false;
+    }
+    if (strcmp(backend, "native") == 0) {
+      return true;
+    }
+    AT_CHECK(strcmp(backend, "openmp") == 0,
+        "ATEN_INTRAOP_BACKEND must be either 'openmp' or 'native', got '", backend, "'");
+    return false;
+  }();
+  return use_native;
+}
+
+int native_thread_num() {
+  return thread_num;
+}
+
+bool native_in_task() {
+  return task_depth > 0;
+}
+
+int native_num_threads(int requested) {
+  if (native_pool_created.load()) {
+    return get_native_pool().num_threads();
+  }
+  return requested;
+}
+
+void native_parallel_for(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f) {
+  auto& pool = get_native_pool();
+  native_pool_created.store(true);
+  // a few tasks per thread, so that there is something left to steal when
+  // the work is uneven
+  constexpr int64_t kTasksPerThread = 4;
+  Job job;
+  job.f = &f;
+  job.chunk_size = std::max(
+      std::max(grain_size, (int64_t)1),
+      divup(end - begin, pool.num_threads() * kTasksPerThread));
+  job.remaining.store(end - begin);
+  pool.run(job, begin, end);
+  if (job.eptr) {
+    std::rethrow_exception(job.eptr);
+  }
+}
+
+} // namespace internal
+} // namespace at
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace at {
+
+/**
+ * Philox4x32-10, the counter-based random number generator of Salmon et al.,
+ * "Parallel Random Numbers: As Easy as 1, 2, 3" (SC 2011), which is also what
+ * curand's Philox4_32_10 generates on CUDA.
+ *
+ * The values are a function of a 64-bit key (the seed) and a 128-bit counter,
+ * which makes it cheap to start a stream anywhere: the engine constructed with
+ * (seed, subsequence, offset) returns the same values as one constructed with
+ * (seed, subsequence), after it returned `offset` values. Different
+ * subsequences of the same seed don't overlap for the first 2^66 values.
+ * This is what lets threads fill disjoint parts of a tensor from one seed.
+ */
+class Philox4x32_10 {
+ public:
+  explicit Philox4x32_10(
+      uint64_t seed,
+      uint64_t subsequence = 0,
+      uint64_t offset = 0) {
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+    counter_[0] = 0;
+    counter_[1] = 0;
+    counter_[2] = static_cast<uint32_t>(subsequence);
+    counter_[3] = static_cast<uint32_t>(subsequence >> 32);
+    skip(offset / 4);
+    next_ = offset % 4;
+    output_ = rounds(counter_, key_);
+  }
+
+  // Returns 32 random bits
+  uint32_t operator()() {
+    if (next_ == 4) {
+      increment();
+      output_ = rounds(counter_, key_);
+      next_ = 0;
+    }
+    return output_[next_++];
+  }
+
+ private:
+  using Block = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  static Block round(const Block& counter, const Key& key) {
+    const uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * counter[0];
+    const uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * counter[2];
+    return {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+             static_cast<uint32_t>(product1),
+             static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+             static_cast<uint32_t>(product0)}};
+  }
+
+  static Block rounds(Block counter, Key key) {
+    for (int i = 0; i < 9; ++i) {
+      counter = round(counter, key);
+      key[0] += kWeyl0;
+      key[1] += kWeyl1;
+    }
+    return round(counter, key);
+  }
+
+  // Advances the low 64 bits of the counter by one, carrying into the
+  // subsequence past 2^64 blocks like curand does.
+  void increment() {
+    if (++counter_[0] == 0 && ++counter_[1] == 0 && ++counter_[2] == 0) {
+      ++counter_[3];
+    }
+  }
+
+  void skip(uint64_t blocks) {
+    const uint64_t low =
+        (static_cast<uint64_t>(counter_[1]) << 32 | counter_[0]) + blocks;
+    if (low < blocks && ++counter_[2] == 0) {
+      ++counter_[3];
+    }
+    counter_[0] = static_cast<uint32_t>(low);
+    counter_[1] = static_cast<uint32_t>(low >> 32);
+  }
+
+  Key key_;
+  Block counter_;
+  Block output_;
+  uint32_t next_;
+};
+
+} // namespace at
@@ -801,6 +801,9 @@ inline Tensor Tensor::to_mkldnn() const {
 inline Tensor Tensor::quantize_linear(double scale, int64_t zero_point, ScalarType dtype) const {
     return dispatch_type().quantize_linear(*this, scale, zero_point, dtype);
 }
+inline Tensor Tensor::quantize_linear_per_channel(const Tensor & scales, const Tensor & zero_points, IntArrayRef axis, ScalarType dtype) const {
+    return dispatch_type().quantize_linear_per_channel(*this, scales, zero_points, axis, dtype);
+}
 inline Tensor Tensor::dequantize() const {
     return dispatch_type().dequantize(*this);
 }
@@ -810,6 +813,12 @@ inline Scalar Tensor::q_scale() const {
 inline Scalar Tensor::q_zero_point() const {
     return dispatch_type().q_zero_point(*this);
 }
+inline Tensor Tensor::q_per_channel_scales() const {
+    return dispatch_type().q_per_channel_scales(*this);
+}
+inline Tensor Tensor::q_per_channel_zero_points() const {
+    return dispatch_type().q_per_channel_zero_points(*this);
+}
 inline Tensor Tensor::int_repr() const {
     return dispatch_type().int_repr(*this);
 }
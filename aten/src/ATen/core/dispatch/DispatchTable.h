@@ -1,7 +1,6 @@
 #pragma once
 
 #include <ATen/core/function_schema.h>
-#include <c10/util/LeftRight.h>
 #include <c10/util/Metaprogramming.h>
 #include <c10/util/flat_hash_map.h>
 #include <ATen/core/ivalue.h>
@@ -32,10 +31,15 @@ using KernelCacheCreatorFunction = std::function<std::unique_ptr<c10::KernelCach
  * is registered. When a kernel is looked up from the dispatcher, a new
  * cache instance is created for it and each call to that kernel will get
  * this same cache instance.
+ *
+ * Kernels registered from C++ functors, functions or lambdas also store an
+ * unboxed entry point, see Note [Unboxed kernel calls]. Stack based kernels
+ * don't have one.
  */
 struct DispatchTableEntry final {
   /*not-nullable*/ KernelFunction* kernel_func;
   /*not-nullable*/ KernelCacheCreatorFunction cache_creator_func;
+  /*nullable*/ void* unboxed_kernel_func;
 };
 
 namespace detail {
@@ -151,7 +155,19 @@ class DispatchTable final {
    */
    const DispatchTableEntry& lookup(const Stack* stack) const {
      if (C10_LIKELY(dispatch_strategy_.is_valid_)) {
-       TensorTypeId dispatch_key = dispatch_strategy_.get_dispatch_key(stack);
+       return lookup(dispatch_strategy_.get_dispatch_key(stack));
+     } else {
+       return lookup(TensorTypeIds::undefined());
+     }
+   }
+
+  /**
+   * Find the kernel to call for arguments whose first tensor argument has
+   * the given TensorTypeId. For operators without tensor arguments, pass
+   * TensorTypeIds::undefined() to get the fallback kernel.
+   */
+   const DispatchTableEntry& lookup(TensorTypeId dispatch_key) const {
+     if (C10_LIKELY(dispatch_strategy_.is_valid_)) {
        auto found = kernels_.lookup(dispatch_key);
        if (nullptr != found) {
          return *found;
@@ -10,6 +10,106 @@ namespace c10 {
 
 class CAFFE2_API OperatorHandle;
 
+// Note [Unboxed kernel calls]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The boxed calling convention (KernelFunction) passes the arguments and
+// returns of a kernel on a Stack of IValues. That is what the JIT interpreter
+// has at hand, but callers from C++ pay for allocating the stack, boxing each
+// argument and unboxing it again in the kernel wrapper. Kernels registered
+// from a functor, function or lambda therefore also store an unboxed entry
+// point,
+//
+//   Return unboxed_kernel_func(KernelCache* functor, Args... args)
+//
+// which calls the functor directly, with Args the decayed parameter types of
+// its operator() (arguments are taken by value, e.g. Tensor for a const
+// Tensor& parameter). OpKernel::callUnboxed<Return, Args...> calls it with
+// types the caller has to spell exactly; they are not checked against the
+// kernel, and a mismatch is undefined behavior. Kernels without an unboxed entry point, i.e. stack based ones,
+// are called through a stack, so callUnboxed works for any kernel.
+
+namespace detail {
+  // Boxes the arguments of callUnboxed for kernels that only have a boxed
+  // entry point.
+  template<class T>
+  struct box_unboxed_arg final {
+    template<class T_>
+    static IValue call(T_&& v) {
+      return IValue(std::forward<T_>(v));
+    }
+  };
+  template<class T>
+  struct box_unboxed_arg<c10::optional<T>> final {
+    static IValue call(c10::optional<T> v) {
+      if (!v.has_value()) {
+        return IValue();
+      }
+      return box_unboxed_arg<T>::call(std::move(*v));
+    }
+  };
+  template<class T>
+  struct box_unboxed_arg<c10::ArrayRef<T>> final {
+    static IValue call(c10::ArrayRef<T> v) {
+      return IValue(v.vec());
+    }
+  };
+
+  template<class Return>
+  struct unbox_returns final {
+    static Return call(Stack* stack) {
+      AT_ASSERT(stack->size() == 1);
+      return std::move((*stack)[0]).to<Return>();
+    }
+  };
+  template<>
+  struct unbox_returns<void> final {
+    static void call(Stack* stack) {}
+  };
+  template<class... Returns>
+  struct unbox_returns<std::tuple<Returns...>> final {
+    static std::tuple<Returns...> call(Stack* stack) {
+      AT_ASSERT(stack->size() == sizeof...(Returns));
+      return call_(stack, guts::make_index_sequence<sizeof...(Returns)>());
+    }
+
+  private:
+    template<size_t... indices>
+    static std::tuple<Returns...> call_(Stack* stack, guts::index_sequence<indices...>) {
+      return std::tuple<Returns...>(std::move((*stack)[indices]).to<Returns>()...);
+    }
+  };
+
+  // The TensorTypeId of the first tensor argument, which is what the boxed
+  // dispatcher dispatches on. Optional tensors don't count, like they don't in
+  // the schema.
+  inline TensorTypeId dispatch_key_of() {
+    return TensorTypeIds::undefined();
+  }
+  template<class... Rest>
+  TensorTypeId dispatch_key_of(const at::Tensor& first, const Rest&... rest) {
+    return first.type_id();
+  }
+  template<class... Rest>
+  TensorTypeId dispatch_key_of(at::ArrayRef<at::Tensor> first, const Rest&... rest) {
+    if (first.size() == 0) {
+      throw std::runtime_error("Tried to dispatch based on an empty tensor list. When the first tensor argument of an operator is a tensor list, then it must not be empty.");
+    }
+    return first[0].type_id();
+  }
+  template<class... Rest>
+  TensorTypeId dispatch_key_of(const std::vector<at::Tensor>& first, const Rest&... rest) {
+    return dispatch_key_of(at::ArrayRef<at::Tensor>(first));
+  }
+  template<class First, class... Rest>
+  guts::enable_if_t<
+      !std::is_convertible<const First&, at::ArrayRef<at::Tensor>>::value &&
+      !std::is_same<First, at::Tensor>::value,
+      TensorTypeId>
+  dispatch_key_of(const First& first, const Rest&... rest) {
+    return dispatch_key_of(rest...);
+  }
+}
+
 /**
  * This class represents an operator kernel, i.e. an operator *after* it was
  * dispatched to a certain device. You can use it to call the kernel.
@@ -39,13 +139,40 @@ public:
     return (*kernel_)(stack, cache_.get());
   }
 
+  /**
+   * Call the operator kernel with the given arguments, without boxing them
+   * if the kernel has an unboxed entry point. Return and Args are the return
+   * and parameter types of the kernel, see Note [Unboxed kernel calls].
+   *
+   * Example:
+   *
+   * > auto kernel = c10::Dispatcher::singleton().lookup(op, a.type_id());
+   * > Tensor result = kernel.callUnboxed<Tensor, Tensor, double>(a, 2.0);
+   */
+  template<class Return, class... Args>
+  Return callUnboxed(Args... args) const {
+    static_assert(guts::conjunction<std::is_same<Args, guts::decay_t<Args>>...>::value,
+        "callUnboxed takes the arguments by value. Please spell them without references or const.");
+    if (C10_LIKELY(unboxed_kernel_ != nullptr)) {
+      using UnboxedKernel = Return (KernelCache*, Args...);
+      return (*reinterpret_cast<UnboxedKernel*>(unboxed_kernel_))(
+          cache_.get(), std::forward<Args>(args)...);
+    }
+    Stack stack;
+    stack.reserve(sizeof...(Args));
+    torch::jit::push(stack, detail::box_unboxed_arg<guts::decay_t<Args>>::call(std::forward<Args>(args))...);
+    call(&stack);
+    return detail::unbox_returns<Return>::call(&stack);
+  }
+
 private:
-  explicit OpKernel(KernelFunction* kernel, const KernelCacheCreatorFunction& cache_creator)
-  : kernel_(kernel), cache_(cache_creator()) {}
+  explicit OpKernel(KernelFunction* kernel, const KernelCacheCreatorFunction& cache_creator, void* unboxed_kernel)
+  : kernel_(kernel), cache_(cache_creator()), unboxed_kernel_(unboxed_kernel) {}
   friend class Dispatcher;
 
   KernelFunction* kernel_;
   std::unique_ptr<c10::KernelCache> cache_;
+  void* unboxed_kernel_;
 };
 
 /**
@@ -116,7 +243,7 @@ public:
    * @return A RAII object that manages the lifetime of the registration.
    *         Once that object is destructed, the kernel will be deregistered.
    */
-  RegistrationHandleRAII registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func);
+  RegistrationHandleRAII registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func, void* unboxed_kernel_func = nullptr);
 
   /**
    * Register a fallback kernel for an operator.
@@ -126,13 +253,31 @@ public:
    * @return A RAII object that manages the lifetime of the registration.
    *         Once that object is destructed, the kernel will be deregistered.
    */
-  RegistrationHandleRAII registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func);
+  RegistrationHandleRAII registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func, void* unboxed_kernel_func = nullptr);
 
   /**
    * Perform a dynamic dispatch and get the kernel for an operator.
    */
   OpKernel lookup(const OperatorHandle& op, const Stack* stack) const;
 
+  /**
+   * Get the kernel of an operator for arguments whose first tensor argument
+   * has the TensorTypeId `dispatch_key`, without putting them on a stack.
+   */
+  OpKernel lookup(const OperatorHandle& op, TensorTypeId dispatch_key) const;
+
+  /**
+   * Dispatch on the arguments and call the kernel with them unboxed, see
+   * Note [Unboxed kernel calls]. This creates the kernel's cache for each
+   * call; callers that call the same kernel repeatedly can keep the OpKernel
+   * from lookup() around to avoid that.
+   */
+  template<class Return, class... Args>
+  Return callUnboxed(const OperatorHandle& op, Args... args) const {
+    return lookup(op, detail::dispatch_key_of(args...))
+        .template callUnboxed<Return, Args...>(std::forward<Args>(args)...);
+  }
+
   /**
    * Add a listener that gets called whenever a new op is registered or an existing
    * op is deregistered. Immediately after registering, this listener gets called
@@ -195,7 +340,13 @@ private:
 inline OpKernel Dispatcher::lookup(const OperatorHandle& op, const Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
   const DispatchTableEntry& kernel = op.operatorIterator_->op.lookupKernel(stack);
-  return OpKernel(kernel.kernel_func, kernel.cache_creator_func);
+  return OpKernel(kernel.kernel_func, kernel.cache_creator_func, kernel.unboxed_kernel_func);
+}
+
+inline OpKernel Dispatcher::lookup(const OperatorHandle& op, TensorTypeId dispatch_key) const {
+  // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  const DispatchTableEntry& kernel = op.operatorIterator_->op.lookupKernel(dispatch_key);
+  return OpKernel(kernel.kernel_func, kernel.cache_creator_func, kernel.unboxed_kernel_func);
 }
 
 } // namespace c10
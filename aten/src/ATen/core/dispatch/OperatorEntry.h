@@ -2,6 +2,7 @@
 
 #include <ATen/core/dispatch/DispatchTable.h>
 #include <ATen/core/dispatch/RegistrationHandleRAII.h>
+#include <c10/util/CopyOnWrite.h>
 #include <list>
 
 namespace c10 {
@@ -28,6 +29,12 @@ public:
     });
   }
 
+  DispatchTableEntry lookupKernel(TensorTypeId dispatch_key) const {
+    return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
+      return dispatchTable.lookup(dispatch_key);
+    });
+  }
+
   void prepareForDeregistration();
 
   RegistrationHandleRAII registerKernel(TensorTypeId dispatch_key, DispatchTableEntry kernel);
@@ -39,8 +46,12 @@ private:
 
   FunctionSchema schema_;
 
-  // The dispatchTable stores the current kernel for each dispatch key
-  LeftRight<DispatchTable> dispatchTable_;
+  // The dispatchTable stores the current kernel for each dispatch key.
+  // It is read on every op call, possibly from many threads at once, and only
+  // written when kernels are registered or deregistered. CopyOnWrite makes
+  // the lookups a single pointer load, so readers never write to a shared
+  // cache line; each registration keeps a copy of the (small) table alive.
+  CopyOnWrite<DispatchTable> dispatchTable_;
 
   // The kernels map stores all registered kernels for a certain dispatch key.
   // If an operator library gets loaded that overwrites already existing kernels,
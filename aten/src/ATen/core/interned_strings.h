@@ -97,6 +97,8 @@ namespace c10 {
   _(prim, profile)                 \
   _(prim, AddStatValue)            \
   _(prim, TimePoint)               \
+  _(prim, AllocateArena)           \
+  _(prim, ArenaTensor)             \
   _(aten, append)                  \
   _(aten, item)                    \
   _(aten, format)                  \
@@ -131,8 +131,8 @@ void ivalue::Object::resizeObject(size_t slot) {
 
 static bool CompareIValue(const std::pair<IValue, IValue>& aWrap,
                           const std::pair<IValue, IValue>& bWrap) {
-  const auto a = aWrap.first;
-  const auto b = bWrap.first;
+  const auto& a = aWrap.first;
+  const auto& b = bWrap.first;
   if (a.isString() && b.isString()) {
     return a.toStringRef().compare(b.toStringRef()) < 0;
   } else if (a.isInt() && b.isInt()) {
@@ -145,6 +145,7 @@ static bool CompareIValue(const std::pair<IValue, IValue>& aWrap,
 
 const ivalue::GenericDict::IterationOrder ivalue::GenericDict::iterationOrder() const {
   IterationOrder ordered;
+  ordered.reserve(elements().size());
   for (auto element : elements()) {
     ordered.emplace_back(element.key(), element.value());
   }
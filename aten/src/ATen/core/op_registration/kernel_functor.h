@@ -286,6 +286,24 @@ namespace detail {
     }
   };
 
+  // The unboxed entry point of a functor kernel, see Note [Unboxed kernel calls].
+  // It takes the arguments by value, whether the functor takes them by value
+  // or by reference, so that callers call all kernels of an operator alike.
+  template<class KernelFunctor, class ReturnType, class ParameterList> struct wrap_kernel_functor_unboxed_ final {};
+  template<class KernelFunctor, class ReturnType, class... ParameterTypes>
+  struct wrap_kernel_functor_unboxed_<KernelFunctor, ReturnType, guts::typelist::typelist<ParameterTypes...>> final {
+    static ReturnType call(KernelCache* cache, guts::decay_t<ParameterTypes>... args) {
+      KernelFunctor* functor = static_cast<KernelFunctor*>(cache);
+      return (*functor)(std::forward<ParameterTypes>(args)...);
+    }
+  };
+  template<class KernelFunctor>
+  using wrap_kernel_functor_unboxed = wrap_kernel_functor_unboxed_<
+      KernelFunctor,
+      typename guts::infer_function_traits_t<KernelFunctor>::return_type,
+      typename guts::infer_function_traits_t<KernelFunctor>::parameter_types
+  >;
+
   template<class KernelFunctor, class... Args>
   class KernelFactory final {
     static_assert(std::is_constructible<KernelFunctor, Args...>::value, "Wrong argument types for constructor of kernel functor.");
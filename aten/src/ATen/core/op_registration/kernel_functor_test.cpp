@@ -970,4 +970,49 @@ TEST(OperatorRegistrationTest_FunctorBasedKernel, givenMismatchedKernel_withDiff
   );
 }
 
+
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernel_whenCalledUnboxed_thenCallsRightKernel) {
+  auto registrar = RegisterOperators()
+      .op("_test::my_op(Tensor dummy, int input) -> int", RegisterOperators::options().kernel<IncrementKernel>().dispatchKey(TensorType1()))
+      .op("_test::my_op(Tensor dummy, int input) -> int", RegisterOperators::options().kernel<DecrementKernel>().dispatchKey(TensorType2()));
+  auto op = c10::Dispatcher::singleton().findSchema("_test::my_op", "");
+  ASSERT_TRUE(op.has_value());
+
+  EXPECT_EQ(6, (c10::Dispatcher::singleton().callUnboxed<int64_t, Tensor, int64_t>(*op, dummyTensor(TensorType1()), 5)));
+  EXPECT_EQ(4, (c10::Dispatcher::singleton().callUnboxed<int64_t, Tensor, int64_t>(*op, dummyTensor(TensorType2()), 5)));
+}
+
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithCache_whenCalledUnboxed_thenCacheIsKeptCorrectly) {
+  auto registrar = RegisterOperators()
+      .op("_test::cache_op(Tensor input) -> int", RegisterOperators::options().kernel<KernelWithCache>().dispatchKey(TensorType1()));
+  auto op = c10::Dispatcher::singleton().findSchema("_test::cache_op", "");
+  ASSERT_TRUE(op.has_value());
+
+  // boxed and unboxed calls share the cache of the looked up kernel
+  auto kernel = c10::Dispatcher::singleton().lookup(*op, TensorType1());
+  EXPECT_EQ(4, kernel.callUnboxed<int64_t>(dummyTensor(TensorType1())));
+  auto stack = makeStack(dummyTensor(TensorType1()));
+  kernel.call(&stack);
+  EXPECT_EQ(5, stack[0].toInt());
+  EXPECT_EQ(6, kernel.callUnboxed<int64_t>(dummyTensor(TensorType1())));
+}
+
+struct KernelWithMultipleOutputs final : OperatorKernel {
+  std::tuple<Tensor, int64_t> operator()(const Tensor& tensor, c10::optional<int64_t> input) {
+    return std::make_tuple(tensor, input.value_or(-1));
+  }
+};
+
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithMultipleOutputs_whenCalledUnboxed_thenReturnsOutputs) {
+  auto registrar = RegisterOperators()
+      .op("_test::multiple_outputs(Tensor dummy, int? input) -> (Tensor, int)", RegisterOperators::options().kernel<KernelWithMultipleOutputs>().dispatchKey(TensorType1()));
+  auto op = c10::Dispatcher::singleton().findSchema("_test::multiple_outputs", "");
+  ASSERT_TRUE(op.has_value());
+
+  auto result = c10::Dispatcher::singleton().callUnboxed<std::tuple<Tensor, int64_t>, Tensor, c10::optional<int64_t>>(
+      *op, dummyTensor(TensorType1()), c10::nullopt);
+  EXPECT_EQ(TensorType1(), std::get<0>(result).type_id());
+  EXPECT_EQ(-1, std::get<1>(result));
+}
+
 }
@@ -188,4 +188,16 @@ TEST(OperatorRegistrationTest_StackBasedKernel, givenKernelWithCache_whenCalled_
   EXPECT_EQ(6, stack[0].toInt());
 }
 
+
+TEST(OperatorRegistrationTest_StackBasedKernel, givenKernel_whenCalledUnboxed_thenBoxesArguments) {
+  auto registrar = RegisterOperators()
+      .op("_test::my_op(Tensor dummy, int input) -> int", RegisterOperators::options().kernel(&incrementKernel, &noCache).dispatchKey(TensorType1()))
+      .op("_test::my_op(Tensor dummy, int input) -> int", RegisterOperators::options().kernel(&decrementKernel, &noCache).dispatchKey(TensorType2()));
+  auto op = c10::Dispatcher::singleton().findSchema("_test::my_op", "");
+  ASSERT_TRUE(op.has_value());
+
+  EXPECT_EQ(6, (c10::Dispatcher::singleton().callUnboxed<int64_t, at::Tensor, int64_t>(*op, dummyTensor(TensorType1()), 5)));
+  EXPECT_EQ(4, (c10::Dispatcher::singleton().callUnboxed<int64_t, at::Tensor, int64_t>(*op, dummyTensor(TensorType2()), 5)));
+}
+
 }
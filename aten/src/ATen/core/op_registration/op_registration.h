@@ -51,7 +51,7 @@ public:
 
     // internal-only for registering stack based kernels
     Options&& kernel(KernelFunction* kernel_func, KernelCacheCreatorFunction&& cache_creator) && {
-      return std::move(*this).kernel(kernel_func, std::move(cache_creator), nullptr);
+      return std::move(*this).kernel(kernel_func, std::move(cache_creator), nullptr, nullptr);
     }
 
     /**
@@ -178,9 +178,10 @@ public:
     }
 
   private:
-    Options&& kernel(KernelFunction* kernel_func, KernelCacheCreatorFunction&& cache_creator, std::unique_ptr<FunctionSchema>&& inferred_function_schema) && {
+    Options&& kernel(KernelFunction* kernel_func, KernelCacheCreatorFunction&& cache_creator, void* unboxed_kernel_func, std::unique_ptr<FunctionSchema>&& inferred_function_schema) && {
       config.kernel_func = kernel_func;
       config.cache_creator_func = std::move(cache_creator);
+      config.unboxed_kernel_func = unboxed_kernel_func;
       config.inferred_function_schema = std::move(inferred_function_schema);
       return std::move(*this);
     }
@@ -190,6 +191,7 @@ public:
       return std::move(*this).kernel(
         &detail::wrap_kernel_functor<KernelFunctor, AllowDeprecatedTypes>::call,
         detail::KernelFactory<KernelFunctor, guts::decay_t<ConstructorParameters>...>(std::forward<ConstructorParameters>(constructorParameters)...),
+        reinterpret_cast<void*>(&detail::wrap_kernel_functor_unboxed<KernelFunctor>::call),
         detail::FunctionSchemaInferer<KernelFunctor>()()
       );
     }
@@ -203,12 +205,14 @@ public:
         : dispatch_key(c10::nullopt)
         , kernel_func(nullptr)
         , cache_creator_func(nullptr)
+        , unboxed_kernel_func(nullptr)
         , inferred_function_schema(nullptr)
       {}
 
       c10::optional<TensorTypeId> dispatch_key;
       KernelFunction* kernel_func;
       KernelCacheCreatorFunction cache_creator_func;
+      void* unboxed_kernel_func;
       std::unique_ptr<FunctionSchema> inferred_function_schema;
     };
 
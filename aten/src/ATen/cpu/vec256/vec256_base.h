@@ -19,6 +19,22 @@
 #define __at_align32__
 #endif
 
+// Note [Vec256 in AVX512 builds]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Vec256<T> is the vector type of the instruction set a kernel is being
+// compiled for, and kernels must only rely on Vec256<T>::size() rather than
+// on it being 256 bits wide.  When a kernel is compiled for the AVX512
+// capability (CPU_CAPABILITY_AVX512), all Vec256 types are 512 bits wide: the
+// specializations for float, double and the integer types in vec512_*.h use
+// AVX-512 registers, and the emulated types below hold VECTOR_WIDTH bytes, so
+// that e.g. Vec256<float> and Vec256<int32_t> still have the same number of
+// lanes.
+#if defined(CPU_CAPABILITY_AVX512)
+#define VECTOR_WIDTH 64
+#else
+#define VECTOR_WIDTH 32
+#endif
+
 namespace at {
 namespace vec256 {
 // See Note [Acceptable use of anonymous namespace in header]
@@ -45,7 +61,7 @@ using int_same_size_t = typename int_of_size<sizeof(T)>::type;
 template <class T>
 struct Vec256 {
 private:
-  T values[32 / sizeof(T)] = {0};
+  T values[VECTOR_WIDTH / sizeof(T)] = {0};
 public:
   // Note [constexpr static function to avoid odr-usage compiler bug]
   // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -80,7 +96,7 @@ public:
   // identifier is odr-used or not, and in any case it's hard to tel if
   // a variabe is odr-used or not.  So best to just cut the probem at the root.
   static constexpr int size() {
-    return 32 / sizeof(T);
+    return VECTOR_WIDTH / sizeof(T);
   }
   Vec256() {}
   Vec256(T val) {
@@ -200,6 +216,12 @@ public:
   Vec256<T> log() const {
     return map(std::log);
   }
+  // The *_fast variants may be less accurate than the functions they stand
+  // for: the Sleef specializations are within 3.5-ULP instead of 1-ULP. They
+  // are used by at::vml when Context::fastTranscendentals() is set.
+  Vec256<T> log_fast() const {
+    return log();
+  }
   Vec256<T> log10() const {
     return map(std::log10);
   }
@@ -215,6 +237,9 @@ public:
   Vec256<T> cos() const {
     return map(std::cos);
   }
+  Vec256<T> cos_fast() const {
+    return cos();
+  }
   Vec256<T> cosh() const {
     return map(std::cosh);
   }
@@ -233,15 +258,27 @@ public:
   Vec256<T> sin() const {
     return map(std::sin);
   }
+  Vec256<T> sin_fast() const {
+    return sin();
+  }
   Vec256<T> sinh() const {
     return map(std::sinh);
   }
   Vec256<T> tan() const {
     return map(std::tan);
   }
+  Vec256<T> tan_fast() const {
+    return tan();
+  }
   Vec256<T> tanh() const {
     return map(std::tanh);
   }
+  Vec256<T> tanh_fast() const {
+    return tanh();
+  }
+  Vec256<T> sigmoid() const {
+    return map([](T x) -> T { return (T)(1) / ((T)(1) + std::exp(-x)); });
+  }
   Vec256<T> trunc() const {
     return map(std::trunc);
   }
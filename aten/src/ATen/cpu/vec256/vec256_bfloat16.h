@@ -0,0 +1,337 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec256/vec256_float.h>
+#include <ATen/cpu/vec256/vec512_float.h>
+
+#include <tuple>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Note [Vec256<BFloat16>]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// There is no BFloat16 arithmetic on the CPUs we target, so the kernels load
+// and store BFloat16 (halving their memory traffic compared to float) but
+// compute in float. Vec256<BFloat16> holds twice as many elements as
+// Vec256<float>; with AVX2 each of its operations converts to two Vec256<float>
+// in registers, runs the float operation on both and rounds the results back
+// (to nearest even, as BFloat16's constructor does). Kernels that chain several
+// operations, or accumulate (reductions, GEMM), should instead convert once
+// with convert_bfloat16_float, work on the Vec256<float>s, and convert back
+// with convert_float_bfloat16, which also avoids rounding the intermediate
+// results. Without AVX2 both fall back to the emulated Vec256 with scalar
+// loops.
+
+#if defined(__AVX2__) && !defined(_MSC_VER) && !defined(CPU_CAPABILITY_AVX512)
+
+static inline void cvtbf16_fp32(const __m256i& a, __m256& o1, __m256& o2) {
+  __m128i lo = _mm256_extractf128_si256(a, 0);
+  __m128i hi = _mm256_extractf128_si256(a, 1);
+  o1 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(lo), 16));
+  o2 = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(hi), 16));
+}
+
+static inline __m256i cvtfp32_bf16_bits(const __m256& a) {
+  const __m256i ones = _mm256_set1_epi32(0x1);
+  const __m256i bias = _mm256_set1_epi32(0x7fff);
+  const __m256i nan = _mm256_set1_epi32(0x7fc0);
+  __m256i bits = _mm256_castps_si256(a);
+  // bits += 0x7fff + ((bits >> 16) & 1), see c10::detail::round_to_nearest_even
+  __m256i rounded = _mm256_add_epi32(
+      bits, _mm256_add_epi32(bias, _mm256_and_si256(_mm256_srli_epi32(bits, 16), ones)));
+  rounded = _mm256_srli_epi32(rounded, 16);
+  __m256i is_ordered = _mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_ORD_Q));
+  return _mm256_blendv_epi8(nan, rounded, is_ordered);
+}
+
+static inline __m256i cvtfp32_bf16(const __m256& a, const __m256& b) {
+  // packus works within 128 bit lanes, which the permute puts back in order
+  __m256i packed = _mm256_packus_epi32(cvtfp32_bf16_bits(a), cvtfp32_bf16_bits(b));
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+// Masks (all ones or all zeros) don't need rounding, and must not be turned
+// into NaNs
+static inline __m256i merge_compare_result(const __m256& a, const __m256& b) {
+  __m256i packed = _mm256_packs_epi32(_mm256_castps_si256(a), _mm256_castps_si256(b));
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+template <typename Op>
+static inline __m256i unary_op_as_fp32(const __m256i& a, const Op& op) {
+  __m256 lo, hi;
+  cvtbf16_fp32(a, lo, hi);
+  return cvtfp32_bf16(op(Vec256<float>(lo)), op(Vec256<float>(hi)));
+}
+
+template <typename Op>
+static inline __m256i binary_op_as_fp32(const __m256i& a, const __m256i& b, const Op& op) {
+  __m256 a_lo, a_hi, b_lo, b_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  return cvtfp32_bf16(
+      op(Vec256<float>(a_lo), Vec256<float>(b_lo)),
+      op(Vec256<float>(a_hi), Vec256<float>(b_hi)));
+}
+
+template <typename Op>
+static inline __m256i compare_as_fp32(const __m256i& a, const __m256i& b, const Op& op) {
+  __m256 a_lo, a_hi, b_lo, b_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  return merge_compare_result(
+      op(Vec256<float>(a_lo), Vec256<float>(b_lo)),
+      op(Vec256<float>(a_hi), Vec256<float>(b_hi)));
+}
+
+template <> class Vec256<BFloat16> {
+private:
+  __m256i values;
+
+public:
+  static constexpr int size() {
+    return 16;
+  }
+  Vec256() {}
+  Vec256(__m256i v) : values(v) {}
+  Vec256(BFloat16 val) {
+    values = _mm256_set1_epi16(val.x);
+  }
+  Vec256(BFloat16 val1, BFloat16 val2, BFloat16 val3, BFloat16 val4,
+         BFloat16 val5, BFloat16 val6, BFloat16 val7, BFloat16 val8,
+         BFloat16 val9, BFloat16 val10, BFloat16 val11, BFloat16 val12,
+         BFloat16 val13, BFloat16 val14, BFloat16 val15, BFloat16 val16) {
+    values = _mm256_setr_epi16(
+        val1.x, val2.x, val3.x, val4.x, val5.x, val6.x, val7.x, val8.x,
+        val9.x, val10.x, val11.x, val12.x, val13.x, val14.x, val15.x, val16.x);
+  }
+  operator __m256i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec256<BFloat16> blend(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+    __at_align32__ BFloat16 tmp_a[size()];
+    __at_align32__ BFloat16 tmp_b[size()];
+    a.store(tmp_a);
+    b.store(tmp_b);
+    for (int64_t i = 0; i < size(); i++) {
+      if (mask & (1LL << i)) {
+        tmp_a[i] = tmp_b[i];
+      }
+    }
+    return loadu(tmp_a);
+  }
+  static Vec256<BFloat16> blendv(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                                 const Vec256<BFloat16>& mask) {
+    return _mm256_blendv_epi8(a.values, b.values, mask.values);
+  }
+  static Vec256<BFloat16> arange(BFloat16 base = 0.f, BFloat16 step = 1.f) {
+    __at_align32__ BFloat16 tmp[size()];
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = base + static_cast<float>(i) * step;
+    }
+    return loadu(tmp);
+  }
+  static Vec256<BFloat16> set(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                              int64_t count = size()) {
+    __at_align32__ BFloat16 tmp_a[size()];
+    __at_align32__ BFloat16 tmp_b[size()];
+    a.store(tmp_a);
+    b.store(tmp_b);
+    for (int64_t i = 0; i < count && i < size(); i++) {
+      tmp_a[i] = tmp_b[i];
+    }
+    return loadu(tmp_a);
+  }
+  static Vec256<BFloat16> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __at_align32__ BFloat16 tmp_values[size()] = {};
+    std::memcpy(tmp_values, ptr, count * sizeof(BFloat16));
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      __at_align32__ BFloat16 tmp_values[size()];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(BFloat16));
+    }
+  }
+  const BFloat16& operator[](int idx) const  = delete;
+  BFloat16& operator[](int idx) = delete;
+  Vec256<BFloat16> map(BFloat16 (*f)(BFloat16)) const {
+    __at_align32__ BFloat16 tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<BFloat16> abs() const {
+    return _mm256_andnot_si256(_mm256_set1_epi16(static_cast<int16_t>(0x8000)), values);
+  }
+  Vec256<BFloat16> neg() const {
+    return _mm256_xor_si256(_mm256_set1_epi16(static_cast<int16_t>(0x8000)), values);
+  }
+#define DEFINE_UNARY_OP_AS_FP32(op)                                            \
+  Vec256<BFloat16> op() const {                                                \
+    return unary_op_as_fp32(values, [](Vec256<float> x) { return x.op(); });  \
+  }
+  DEFINE_UNARY_OP_AS_FP32(acos)
+  DEFINE_UNARY_OP_AS_FP32(asin)
+  DEFINE_UNARY_OP_AS_FP32(atan)
+  DEFINE_UNARY_OP_AS_FP32(erf)
+  DEFINE_UNARY_OP_AS_FP32(erfc)
+  DEFINE_UNARY_OP_AS_FP32(exp)
+  DEFINE_UNARY_OP_AS_FP32(expm1)
+  DEFINE_UNARY_OP_AS_FP32(log)
+  DEFINE_UNARY_OP_AS_FP32(log_fast)
+  DEFINE_UNARY_OP_AS_FP32(log2)
+  DEFINE_UNARY_OP_AS_FP32(log10)
+  DEFINE_UNARY_OP_AS_FP32(log1p)
+  DEFINE_UNARY_OP_AS_FP32(frac)
+  DEFINE_UNARY_OP_AS_FP32(sin)
+  DEFINE_UNARY_OP_AS_FP32(sin_fast)
+  DEFINE_UNARY_OP_AS_FP32(sinh)
+  DEFINE_UNARY_OP_AS_FP32(cos)
+  DEFINE_UNARY_OP_AS_FP32(cos_fast)
+  DEFINE_UNARY_OP_AS_FP32(cosh)
+  DEFINE_UNARY_OP_AS_FP32(ceil)
+  DEFINE_UNARY_OP_AS_FP32(floor)
+  DEFINE_UNARY_OP_AS_FP32(round)
+  DEFINE_UNARY_OP_AS_FP32(tan)
+  DEFINE_UNARY_OP_AS_FP32(tan_fast)
+  DEFINE_UNARY_OP_AS_FP32(tanh)
+  DEFINE_UNARY_OP_AS_FP32(tanh_fast)
+  DEFINE_UNARY_OP_AS_FP32(sigmoid)
+  DEFINE_UNARY_OP_AS_FP32(trunc)
+  DEFINE_UNARY_OP_AS_FP32(sqrt)
+  DEFINE_UNARY_OP_AS_FP32(reciprocal)
+  DEFINE_UNARY_OP_AS_FP32(rsqrt)
+#undef DEFINE_UNARY_OP_AS_FP32
+  Vec256<BFloat16> pow(const Vec256<BFloat16> &b) const {
+    return binary_op_as_fp32(values, b, [](Vec256<float> x, Vec256<float> y) { return x.pow(y); });
+  }
+  Vec256<BFloat16> operator==(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x == y; });
+  }
+  Vec256<BFloat16> operator!=(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x != y; });
+  }
+  Vec256<BFloat16> operator<(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x < y; });
+  }
+  Vec256<BFloat16> operator<=(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x <= y; });
+  }
+  Vec256<BFloat16> operator>(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x > y; });
+  }
+  Vec256<BFloat16> operator>=(const Vec256<BFloat16>& other) const {
+    return compare_as_fp32(values, other, [](Vec256<float> x, Vec256<float> y) { return x >= y; });
+  }
+
+};
+
+template <>
+Vec256<BFloat16> inline operator+(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return x + y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator-(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return x - y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator*(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return x * y; });
+}
+
+template <>
+Vec256<BFloat16> inline operator/(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return x / y; });
+}
+
+// Propagates NaN like Vec256<float>'s maximum
+template <>
+Vec256<BFloat16> inline maximum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return maximum(x, y); });
+}
+
+// Propagates NaN like Vec256<float>'s minimum
+template <>
+Vec256<BFloat16> inline minimum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](Vec256<float> x, Vec256<float> y) { return minimum(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator&(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_and_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator|(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_or_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator^(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_xor_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline fmadd(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                              const Vec256<BFloat16>& c) {
+  __m256 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  cvtbf16_fp32(c, c_lo, c_hi);
+  return cvtfp32_bf16(_mm256_fmadd_ps(a_lo, b_lo, c_lo), _mm256_fmadd_ps(a_hi, b_hi, c_hi));
+}
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(const Vec256<BFloat16>& a) {
+  __m256 o1, o2;
+  cvtbf16_fp32(a, o1, o2);
+  return std::make_tuple(o1, o2);
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a, const Vec256<float>& b) {
+  return cvtfp32_bf16(a, b);
+}
+
+#else
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(const Vec256<BFloat16>& a) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ BFloat16 arr[K];
+  __at_align32__ float arr2[K];
+  a.store(arr);
+  for (int64_t k = 0; k < K; k++) {
+    arr2[k] = arr[k];
+  }
+  return std::make_tuple(
+      Vec256<float>::loadu(arr2), Vec256<float>::loadu(arr2 + Vec256<float>::size()));
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a, const Vec256<float>& b) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ float arr[K];
+  __at_align32__ BFloat16 arr2[K];
+  a.store(arr);
+  b.store(arr + Vec256<float>::size());
+  for (int64_t k = 0; k < K; k++) {
+    arr2[k] = arr[k];
+  }
+  return Vec256<BFloat16>::loadu(arr2);
+}
+
+#endif
+
+}}}
@@ -2,7 +2,7 @@
 
 #include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/cpu/vec256/vec256_base.h>
-#if defined(__AVX__) && !defined(_MSC_VER)
+#if defined(__AVX__) && !defined(_MSC_VER) && !defined(CPU_CAPABILITY_AVX512)
 #include <sleef.h>
 #endif
 
@@ -11,7 +11,7 @@ namespace vec256 {
 // See Note [Acceptable use of anonymous namespace in header]
 namespace {
 
-#if defined(__AVX__) && !defined(_MSC_VER)
+#if defined(__AVX__) && !defined(_MSC_VER) && !defined(CPU_CAPABILITY_AVX512)
 
 template <> class Vec256<double> {
 private:
@@ -114,6 +114,9 @@ public:
   Vec256<double> log() const {
     return Vec256<double>(Sleef_logd4_u10(values));
   }
+  Vec256<double> log_fast() const {
+    return Vec256<double>(Sleef_logd4_u35(values));
+  }
   Vec256<double> log2() const {
     return Vec256<double>(Sleef_log2d4_u10(values));
   }
@@ -124,16 +127,22 @@ public:
     return Vec256<double>(Sleef_log1pd4_u10(values));
   }
   Vec256<double> sin() const {
-    return map(std::sin);
+    return Vec256<double>(Sleef_sind4_u10(values));
+  }
+  Vec256<double> sin_fast() const {
+    return Vec256<double>(Sleef_sind4_u35(values));
   }
   Vec256<double> sinh() const {
-    return map(std::sinh);
+    return Vec256<double>(Sleef_sinhd4_u10(values));
   }
   Vec256<double> cos() const {
-    return map(std::cos);
+    return Vec256<double>(Sleef_cosd4_u10(values));
+  }
+  Vec256<double> cos_fast() const {
+    return Vec256<double>(Sleef_cosd4_u35(values));
   }
   Vec256<double> cosh() const {
-    return map(std::cos);
+    return Vec256<double>(Sleef_coshd4_u10(values));
   }
   Vec256<double> ceil() const {
     return _mm256_ceil_pd(values);
@@ -149,11 +158,21 @@ public:
     return _mm256_round_pd(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
   }
   Vec256<double> tan() const {
-    return map(std::tan);
+    return Vec256<double>(Sleef_tand4_u10(values));
+  }
+  Vec256<double> tan_fast() const {
+    return Vec256<double>(Sleef_tand4_u35(values));
   }
   Vec256<double> tanh() const {
     return Vec256<double>(Sleef_tanhd4_u10(values));
   }
+  Vec256<double> tanh_fast() const {
+    return Vec256<double>(Sleef_tanhd4_u35(values));
+  }
+  Vec256<double> sigmoid() const {
+    const auto one = _mm256_set1_pd(1);
+    return _mm256_div_pd(one, _mm256_add_pd(one, Sleef_expd4_u10(neg().values)));
+  }
   Vec256<double> trunc() const {
     return _mm256_round_pd(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
   }
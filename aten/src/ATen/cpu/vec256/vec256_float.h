@@ -2,7 +2,7 @@
 
 #include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/cpu/vec256/vec256_base.h>
-#if defined(__AVX__) && !defined(_MSC_VER)
+#if defined(__AVX__) && !defined(_MSC_VER) && !defined(CPU_CAPABILITY_AVX512)
 #include <sleef.h>
 #endif
 
@@ -11,7 +11,7 @@ namespace vec256 {
 // See Note [Acceptable use of anonymous namespace in header]
 namespace {
 
-#if defined(__AVX__) && !defined(_MSC_VER)
+#if defined(__AVX__) && !defined(_MSC_VER) && !defined(CPU_CAPABILITY_AVX512)
 
 template <> class Vec256<float> {
 private:
@@ -122,6 +122,9 @@ public:
   Vec256<float> log() const {
     return Vec256<float>(Sleef_logf8_u10(values));
   }
+  Vec256<float> log_fast() const {
+    return Vec256<float>(Sleef_logf8_u35(values));
+  }
   Vec256<float> log2() const {
     return Vec256<float>(Sleef_log2f8_u10(values));
   }
@@ -133,16 +136,22 @@ public:
   }
   Vec256<float> frac() const;
   Vec256<float> sin() const {
-    return map(std::sin);
+    return Vec256<float>(Sleef_sinf8_u10(values));
+  }
+  Vec256<float> sin_fast() const {
+    return Vec256<float>(Sleef_sinf8_u35(values));
   }
   Vec256<float> sinh() const {
-    return map(std::sinh);
+    return Vec256<float>(Sleef_sinhf8_u10(values));
   }
   Vec256<float> cos() const {
-    return map(std::cos);
+    return Vec256<float>(Sleef_cosf8_u10(values));
+  }
+  Vec256<float> cos_fast() const {
+    return Vec256<float>(Sleef_cosf8_u35(values));
   }
   Vec256<float> cosh() const {
-    return map(std::cosh);
+    return Vec256<float>(Sleef_coshf8_u10(values));
   }
   Vec256<float> ceil() const {
     return _mm256_ceil_ps(values);
@@ -157,11 +166,21 @@ public:
     return _mm256_round_ps(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
   }
   Vec256<float> tan() const {
-    return map(std::tan);
+    return Vec256<float>(Sleef_tanf8_u10(values));
+  }
+  Vec256<float> tan_fast() const {
+    return Vec256<float>(Sleef_tanf8_u35(values));
   }
   Vec256<float> tanh() const {
     return Vec256<float>(Sleef_tanhf8_u10(values));
   }
+  Vec256<float> tanh_fast() const {
+    return Vec256<float>(Sleef_tanhf8_u35(values));
+  }
+  Vec256<float> sigmoid() const {
+    const auto one = _mm256_set1_ps(1);
+    return _mm256_div_ps(one, _mm256_add_ps(one, Sleef_expf8_u10(neg().values)));
+  }
   Vec256<float> trunc() const {
     return _mm256_round_ps(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
   }
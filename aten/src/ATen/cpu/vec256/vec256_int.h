@@ -7,7 +7,7 @@ namespace at {
 namespace vec256 {
 namespace {
 
-#ifdef __AVX2__
+#if defined(__AVX2__) && !defined(CPU_CAPABILITY_AVX512)
 
 struct Vec256i {
 protected:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/Config.h>
+#include <ATen/Context.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
@@ -20,6 +21,12 @@
 // When MKL is available it will call into MKL's VML library similar to NumPy
 // If MKL is not available it will use SLEEF.
 
+// When at::globalContext().fastTranscendentals() is set, the transcendental
+// functions use faster implementations with a larger error: VML's enhanced
+// performance (VML_EP) mode with MKL, which also covers exp and erf, and the
+// 3.5-ULP SLEEF functions for log, sin, cos, tan and tanh otherwise (see the
+// *_fast methods of Vec256).
+
 // This file might be compiled under AVX or AVX2 when called from e.g.
 // UnaryOpsKernel.cpp
 
@@ -97,12 +104,33 @@ inline void vrsqrt(scalar_t* out, scalar_t* in, int64_t size) {
     });                                                                 \
   }
 
+#define IMPLEMENT_VML_FAST_BUG(op)                                       \
+  template <typename scalar_t>                                            \
+  inline void v##op(scalar_t* out, const scalar_t* in, int64_t size) {    \
+    DL_RUNTIME_BUG(op, scalar_t)                                          \
+    if (at::globalContext().fastTranscendentals()) {                      \
+      parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) { \
+        map([](const Vec256<scalar_t>& x) { return x.op##_fast(); },      \
+            out + begin,                                                  \
+            in + begin,                                                   \
+            end - begin);                                                 \
+      });                                                                 \
+    } else {                                                              \
+      parallel_for(0, size, 2048, [out, in](int64_t begin, int64_t end) { \
+        map([](const Vec256<scalar_t>& x) { return x.op(); },             \
+            out + begin,                                                  \
+            in + begin,                                                   \
+            end - begin);                                                 \
+      });                                                                 \
+    }                                                                     \
+  }
+
 IMPLEMENT_VML_BUG(abs)
 IMPLEMENT_VML_BUG(acos)
 IMPLEMENT_VML_BUG(asin)
 IMPLEMENT_VML_BUG(atan)
 IMPLEMENT_VML_BUG(ceil)
-IMPLEMENT_VML_BUG(cos)
+IMPLEMENT_VML_FAST_BUG(cos)
 // IMPLEMENT_VML_BUG(cosh)
 IMPLEMENT_VML_BUG(erf)
 IMPLEMENT_VML_BUG(erfc)
@@ -110,18 +138,18 @@ IMPLEMENT_VML_BUG(exp)
 IMPLEMENT_VML_BUG(expm1)
 IMPLEMENT_VML_BUG(floor)
 IMPLEMENT_VML(reciprocal)
-IMPLEMENT_VML_BUG(log)
+IMPLEMENT_VML_FAST_BUG(log)
 IMPLEMENT_VML_BUG(log10)
 IMPLEMENT_VML_BUG(log1p)
 IMPLEMENT_VML_BUG(log2)
 IMPLEMENT_VML(neg)
-IMPLEMENT_VML_BUG(sin)
+IMPLEMENT_VML_FAST_BUG(sin)
 // IMPLEMENT_VML_BUG(sinh)
 IMPLEMENT_VML_BUG(sqrt)
 IMPLEMENT_VML_BUG(round)
 IMPLEMENT_VML(rsqrt)
-IMPLEMENT_VML_BUG(tan)
-IMPLEMENT_VML_BUG(tanh)
+IMPLEMENT_VML_FAST_BUG(tan)
+IMPLEMENT_VML_FAST_BUG(tanh)
 IMPLEMENT_VML_BUG(trunc)
 
 #if AT_MKL_ENABLED() && !defined(__APPLE__)
@@ -132,13 +160,20 @@ IMPLEMENT_VML_BUG(trunc)
 static_assert(
     std::is_same<MKL_INT, int32_t>::value,
     "MKL_INT is assumed to be int32_t");
-#define IMPLEMENT_VML_MKL_STUB(op, mklop, type, mkltype)                    \
+
+template <bool allow_fast>
+inline MKL_INT64 vml_mode() {
+  const bool fast = allow_fast && at::globalContext().fastTranscendentals();
+  return (fast ? VML_EP : VML_HA) | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE;
+}
+
+#define IMPLEMENT_VML_MKL_STUB(op, mklop, type, mkltype, allow_fast) \
   template <>                                                           \
   inline void v##op(type * out, const type * in, int64_t size) {          \
     int64_t max_mkl_ind = std::numeric_limits<MKL_INT>::max();          \
+    const MKL_INT64 mode = vml_mode<allow_fast>();                      \
     if (size <= static_cast<int64_t>(max_mkl_ind)) {                    \
-      vm##mkltype##mklop(                                               \
-          size, in, out, VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE); \
+      vm##mkltype##mklop(size, in, out, mode);                          \
     } else {                                                            \
       MKL_INT ind = 0;                                                  \
       int64_t chunks = size / max_mkl_ind;                              \
@@ -148,19 +183,23 @@ static_assert(
             max_mkl_ind,                                                \
             in + ind * max_mkl_ind,                                     \
             out + ind * max_mkl_ind,                                    \
-            VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE);              \
+            mode);                                                      \
       }                                                                 \
       vm##mkltype##mklop(                                               \
           rest,                                                         \
           in + ind * max_mkl_ind,                                       \
           out + ind * max_mkl_ind,                                      \
-          VML_HA | VML_FTZDAZ_OFF | VML_ERRMODE_IGNORE);                \
+          mode);                                                        \
     }                                                                   \
   }
 
-#define IMPLEMENT_VML_MKL(op, mklop)          \
-  IMPLEMENT_VML_MKL_STUB(op, mklop, float, s) \
-  IMPLEMENT_VML_MKL_STUB(op, mklop, double, d)
+#define IMPLEMENT_VML_MKL(op, mklop)                 \
+  IMPLEMENT_VML_MKL_STUB(op, mklop, float, s, false) \
+  IMPLEMENT_VML_MKL_STUB(op, mklop, double, d, false)
+
+#define IMPLEMENT_VML_MKL_FAST(op, mklop)           \
+  IMPLEMENT_VML_MKL_STUB(op, mklop, float, s, true) \
+  IMPLEMENT_VML_MKL_STUB(op, mklop, double, d, true)
 
 // NB: abs, cosh and sinh were temporarily disabled due to issues with Apple clang
 
@@ -168,20 +207,20 @@ IMPLEMENT_VML_MKL(abs, Abs)
 IMPLEMENT_VML_MKL(acos, Acos)
 IMPLEMENT_VML_MKL(asin, Asin)
 IMPLEMENT_VML_MKL(atan, Atan)
-IMPLEMENT_VML_MKL(cos, Cos)
+IMPLEMENT_VML_MKL_FAST(cos, Cos)
 // IMPLEMENT_VML_MKL(cosh, Cosh)
-IMPLEMENT_VML_MKL(erf, Erf)
+IMPLEMENT_VML_MKL_FAST(erf, Erf)
 IMPLEMENT_VML_MKL(erfc, Erfc)
-IMPLEMENT_VML_MKL(exp, Exp)
+IMPLEMENT_VML_MKL_FAST(exp, Exp)
 IMPLEMENT_VML_MKL(expm1, Expm1)
-IMPLEMENT_VML_MKL(log, Ln)
+IMPLEMENT_VML_MKL_FAST(log, Ln)
 IMPLEMENT_VML_MKL(log10, Log10)
 IMPLEMENT_VML_MKL(log1p, Log1p)
-IMPLEMENT_VML_MKL(sin, Sin)
+IMPLEMENT_VML_MKL_FAST(sin, Sin)
 // IMPLEMENT_VML_MKL(sinh, Sinh)
 IMPLEMENT_VML_MKL(sqrt, Sqrt)
-IMPLEMENT_VML_MKL(tan, Tan)
-IMPLEMENT_VML_MKL(tanh, Tanh)
+IMPLEMENT_VML_MKL_FAST(tan, Tan)
+IMPLEMENT_VML_MKL_FAST(tanh, Tanh)
 IMPLEMENT_VML_MKL(trunc, Trunc)
 
 #if INTEL_MKL_VERSION >= 20180406
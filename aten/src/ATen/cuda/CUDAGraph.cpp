@@ -0,0 +1,83 @@
+#include <ATen/cuda/CUDAGraph.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/util/Exception.h>
+
+namespace at { namespace cuda {
+
+CUDAGraph::CUDAGraph()
+  // CUDAStreams may not be default-constructed
+  : capture_stream_(getCurrentCUDAStream()) {
+#ifndef AT_CUDA_GRAPHS_ENABLED
+  AT_ERROR("CUDA graphs require CUDA 10.1 or newer");
+#endif
+}
+
+void CUDAGraph::capture_begin() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(!has_graph_exec_ && capture_pool_ == 0,
+              "This CUDAGraph has already been captured. Call reset() to capture it again.");
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream != getDefaultCUDAStream(),
+              "CUDA graphs must be captured on a non-default stream.");
+  capture_stream_ = stream;
+  capture_pool_ = c10::cuda::CUDACachingAllocator::beginCapturePool();
+  // The caching allocator may call cudaMalloc while capturing, which only the
+  // relaxed mode allows
+  cudaError_t err = cudaStreamBeginCapture(capture_stream_, cudaStreamCaptureModeRelaxed);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::endCapturePool();
+    c10::cuda::CUDACachingAllocator::releaseCapturePool(capture_pool_);
+    capture_pool_ = 0;
+    AT_CUDA_CHECK(err);
+  }
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(capture_pool_ != 0 && !has_graph_exec_,
+              "capture_end() was called without a matching capture_begin().");
+  TORCH_CHECK(getCurrentCUDAStream() == capture_stream_,
+              "capture_end() must be called on the stream capture_begin() was called on.");
+  cudaError_t err = cudaStreamEndCapture(capture_stream_, &graph_);
+  c10::cuda::CUDACachingAllocator::endCapturePool();
+  AT_CUDA_CHECK(err);
+  TORCH_CHECK(graph_ != nullptr, "Invalid capture.");
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+  // Only the executable graph is needed to replay
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  graph_ = nullptr;
+#endif
+}
+
+void CUDAGraph::replay() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  TORCH_CHECK(has_graph_exec_, "Called replay() on a CUDAGraph that has not been captured.");
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+#endif
+}
+
+void CUDAGraph::reset() {
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  if (has_graph_exec_) {
+    // The blocks of the pool may only be reused once the last replay is done
+    AT_CUDA_CHECK(cudaDeviceSynchronize());
+    AT_CUDA_CHECK(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  if (capture_pool_ != 0) {
+    c10::cuda::CUDACachingAllocator::releaseCapturePool(capture_pool_);
+    capture_pool_ = 0;
+  }
+#endif
+}
+
+CUDAGraph::~CUDAGraph() {
+  try {
+    reset();
+  } catch (...) { /* No throw */ }
+}
+
+}} // namespace at::cuda
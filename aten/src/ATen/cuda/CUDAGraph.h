@@ -0,0 +1,52 @@
+#pragma once
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cstdint>
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDA_VERSION >= 10010
+#define AT_CUDA_GRAPHS_ENABLED
+#endif
+
+namespace at { namespace cuda {
+
+/*
+* A CUDAGraph records the kernels and copies issued on the current stream
+* between capture_begin() and capture_end(), and replays all of them with a
+* single launch on each call to replay(). Nothing is executed while capturing.
+*
+* Replays read and write the addresses used during capture, so the inputs of
+* the captured work should be copied into the tensors captured from before
+* each replay, and its outputs read from the tensors it produced. The memory
+* allocated or freed while capturing belongs to the graph, and is not reused
+* until the graph is reset or destroyed (see Note [Capture pools] in
+* CUDACachingAllocator.cpp).
+*
+* The work has to be run once before it is captured, so that the libraries it
+* calls are initialized, and it must not synchronize with the host, or use the
+* legacy default stream. Requires CUDA 10.1 or newer.
+*/
+struct AT_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  void capture_begin();
+  void capture_end();
+  void replay();
+  void reset();
+
+private:
+#ifdef AT_CUDA_GRAPHS_ENABLED
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  bool has_graph_exec_ = false;
+  uint64_t capture_pool_ = 0;
+  CUDAStream capture_stream_;
+};
+
+}} // namespace at::cuda
@@ -228,6 +228,46 @@ void CUDAHooks::cuFFTClearPlanCache(int64_t device_index) const {
 #endif
 }
 
+int64_t CUDAHooks::cuFFTGetPlanCacheMaxWorkspaceSize(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_max_workspace_size_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+void CUDAHooks::cuFFTSetPlanCacheMaxWorkspaceSize(int64_t device_index, int64_t max_workspace_size) const {
+#ifndef __HIP_PLATFORM_HCC__
+  at::native::detail::cufft_set_plan_cache_max_workspace_size_impl(device_index, max_workspace_size);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+int64_t CUDAHooks::cuFFTGetPlanCacheWorkspaceSize(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_workspace_size_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+int64_t CUDAHooks::cuFFTGetPlanCacheHits(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_hits_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+int64_t CUDAHooks::cuFFTGetPlanCacheMisses(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_misses_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
 int CUDAHooks::getNumGPUs() const {
   return at::cuda::device_count();
 }
@@ -28,6 +28,11 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   void cuFFTSetPlanCacheMaxSize(int64_t device_index, int64_t max_size) const override;
   int64_t cuFFTGetPlanCacheSize(int64_t device_index) const override;
   void cuFFTClearPlanCache(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheMaxWorkspaceSize(int64_t device_index) const override;
+  void cuFFTSetPlanCacheMaxWorkspaceSize(int64_t device_index, int64_t max_workspace_size) const override;
+  int64_t cuFFTGetPlanCacheWorkspaceSize(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheHits(int64_t device_index) const override;
+  int64_t cuFFTGetPlanCacheMisses(int64_t device_index) const override;
   int getNumGPUs() const override;
 };
 
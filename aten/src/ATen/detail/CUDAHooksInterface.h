@@ -127,6 +127,26 @@ struct CAFFE2_API CUDAHooksInterface {
     AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
   }
 
+  virtual int64_t cuFFTGetPlanCacheMaxWorkspaceSize(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual void cuFFTSetPlanCacheMaxWorkspaceSize(int64_t device_index, int64_t max_workspace_size) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheWorkspaceSize(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheHits(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheMisses(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual int getNumGPUs() const {
     return 0;
   }
@@ -9,6 +9,8 @@
 
 #include <TH/TH.h>  // for USE_LAPACK
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 // First the required LAPACK implementations are registered here.
@@ -126,6 +128,171 @@ template<> void lapackTriangularSolve<float>(char uplo, char trans, char diag, i
 }
 #endif
 
+// Direct kernels for small matrices. For matrices up to kSmallMatrixSize x kSmallMatrixSize
+// the LAPACK call overhead dominates the arithmetic, so they are factored here with the
+// size known at compile time, which lets the compiler unroll the loops and keep the
+// matrix in registers. The kernels follow the LAPACK conventions (column-major storage
+// with leading dimension N, 1-based pivots, info codes) so that their results are
+// interchangeable with the LAPACK routines they replace.
+constexpr int64_t kSmallMatrixSize = 8;
+
+// LU factorization with partial pivoting, as getrf
+template<typename scalar_t, int N>
+struct SmallLu {
+  static void apply(scalar_t* a, int* ipiv, int* info) {
+    scalar_t m[N * N];
+    std::copy(a, a + N * N, m);
+    *info = 0;
+    for (int k = 0; k < N; k++) {
+      int p = k;
+      scalar_t max_abs = std::abs(m[k + k * N]);
+      for (int i = k + 1; i < N; i++) {
+        scalar_t v = std::abs(m[i + k * N]);
+        if (v > max_abs) {
+          max_abs = v;
+          p = i;
+        }
+      }
+      ipiv[k] = p + 1;
+      if (m[p + k * N] == 0) {
+        // The column below the diagonal is zero, so there is nothing to eliminate
+        if (*info == 0) {
+          *info = k + 1;
+        }
+        continue;
+      }
+      if (p != k) {
+        for (int j = 0; j < N; j++) {
+          std::swap(m[k + j * N], m[p + j * N]);
+        }
+      }
+      scalar_t pivot_inv = scalar_t(1) / m[k + k * N];
+      for (int i = k + 1; i < N; i++) {
+        m[i + k * N] *= pivot_inv;
+      }
+      for (int j = k + 1; j < N; j++) {
+        scalar_t m_kj = m[k + j * N];
+        for (int i = k + 1; i < N; i++) {
+          m[i + j * N] -= m[i + k * N] * m_kj;
+        }
+      }
+    }
+    std::copy(m, m + N * N, a);
+  }
+};
+
+// Solves A X = B given the LU factorization of A, as getrs
+template<typename scalar_t, int N>
+struct SmallLuSolve {
+  static void apply(const scalar_t* lu, const int* ipiv, scalar_t* b, int64_t nrhs) {
+    for (int64_t c = 0; c < nrhs; c++) {
+      scalar_t x[N];
+      std::copy(b + c * N, b + (c + 1) * N, x);
+      for (int k = 0; k < N; k++) {
+        std::swap(x[k], x[ipiv[k] - 1]);
+      }
+      for (int i = 1; i < N; i++) {
+        for (int k = 0; k < i; k++) {
+          x[i] -= lu[i + k * N] * x[k];
+        }
+      }
+      for (int i = N - 1; i >= 0; i--) {
+        for (int k = i + 1; k < N; k++) {
+          x[i] -= lu[i + k * N] * x[k];
+        }
+        x[i] /= lu[i + i * N];
+      }
+      std::copy(x, x + N, b + c * N);
+    }
+  }
+};
+
+// Solves A X = B, overwriting A with its LU factorization and B with X, as gesv
+template<typename scalar_t, int N>
+struct SmallSolve {
+  static void apply(scalar_t* a, scalar_t* b, int64_t nrhs, int* info) {
+    int ipiv[N];
+    SmallLu<scalar_t, N>::apply(a, ipiv, info);
+    if (*info == 0) {
+      SmallLuSolve<scalar_t, N>::apply(a, ipiv, b, nrhs);
+    }
+  }
+};
+
+// Overwrites A with its inverse, as getrf followed by getri
+template<typename scalar_t, int N>
+struct SmallInverse {
+  static void apply(scalar_t* a, int* info) {
+    int ipiv[N];
+    SmallLu<scalar_t, N>::apply(a, ipiv, info);
+    if (*info != 0) {
+      return;
+    }
+    scalar_t inv[N * N] = {};
+    for (int i = 0; i < N; i++) {
+      inv[i + i * N] = 1;
+    }
+    SmallLuSolve<scalar_t, N>::apply(a, ipiv, inv, N);
+    std::copy(inv, inv + N * N, a);
+  }
+};
+
+// Cholesky factorization, as potrf. Only the triangle selected by upper is referenced
+// and overwritten.
+template<typename scalar_t, int N>
+struct SmallCholesky {
+  static void apply(scalar_t* a, bool upper, int* info) {
+    scalar_t m[N * N];
+    std::copy(a, a + N * N, m);
+    // Element (i, j) of the referenced lower triangle, or its transpose in the upper one
+    auto elem = [&](int i, int j) -> scalar_t& { return upper ? m[j + i * N] : m[i + j * N]; };
+    *info = 0;
+    for (int j = 0; j < N; j++) {
+      scalar_t ajj = elem(j, j);
+      for (int k = 0; k < j; k++) {
+        ajj -= elem(j, k) * elem(j, k);
+      }
+      if (!(ajj > 0)) {
+        elem(j, j) = ajj;
+        *info = j + 1;
+        break;
+      }
+      ajj = std::sqrt(ajj);
+      elem(j, j) = ajj;
+      for (int i = j + 1; i < N; i++) {
+        scalar_t aij = elem(i, j);
+        for (int k = 0; k < j; k++) {
+          aij -= elem(i, k) * elem(j, k);
+        }
+        elem(i, j) = aij / ajj;
+      }
+    }
+    std::copy(m, m + N * N, a);
+  }
+};
+
+// Runs Kernel<scalar_t, n>::apply(args...) if n is small enough for the direct kernels.
+// Returns false, without doing anything, otherwise.
+template<typename scalar_t, template<typename, int> class Kernel, typename... Args>
+static bool applySmall(int64_t n, Args&&... args) {
+  switch (n) {
+    case 1: Kernel<scalar_t, 1>::apply(std::forward<Args>(args)...); return true;
+    case 2: Kernel<scalar_t, 2>::apply(std::forward<Args>(args)...); return true;
+    case 3: Kernel<scalar_t, 3>::apply(std::forward<Args>(args)...); return true;
+    case 4: Kernel<scalar_t, 4>::apply(std::forward<Args>(args)...); return true;
+    case 5: Kernel<scalar_t, 5>::apply(std::forward<Args>(args)...); return true;
+    case 6: Kernel<scalar_t, 6>::apply(std::forward<Args>(args)...); return true;
+    case 7: Kernel<scalar_t, 7>::apply(std::forward<Args>(args)...); return true;
+    case 8: Kernel<scalar_t, 8>::apply(std::forward<Args>(args)...); return true;
+    default: return false;
+  }
+}
+
+// Grain size for parallelizing over a batch of n x n factorizations, which cost O(n^3) each
+static inline int64_t batchGrainSize(int64_t n) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, n * n * n));
+}
+
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
@@ -144,18 +311,19 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
-
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data<int>(), b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  // Every matrix is checked afterwards, so errors don't need to stop the other matrices
+  at::parallel_for(0, batch_size, batchGrainSize(n), [&](int64_t start, int64_t end) {
+    std::vector<int> ipiv(n);
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      if (!applySmall<scalar_t, SmallSolve>(n, A_working_ptr, b_working_ptr, nrhs, &info)) {
+        lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data(), b_working_ptr, n, &info);
+      }
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -205,34 +373,35 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  auto ipiv = at::empty({n}, self.options().dtype(kInt));
-  int lwork;
-  scalar_t wkopt;
-  Tensor work;
-
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv.data<int>(), &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
-
-    // Run twice, first to get the optimum work size
-    lwork = -1;
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data<int>(), &wkopt, lwork, &info);
-
+  // The optimum work size only depends on n, so query it once for all matrices
+  int lwork = 0;
+  if (n > kSmallMatrixSize) {
+    scalar_t wkopt;
+    int info;
+    std::vector<int> ipiv(n);
+    lapackGetri<scalar_t>(n, self_data, n, ipiv.data(), &wkopt, -1, &info);
     lwork = static_cast<int>(wkopt);
-    work = at::empty({lwork}, self.options());
+  }
 
-    // now to compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data<int>(), work.data<scalar_t>(), lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  at::parallel_for(0, batch_size, batchGrainSize(n), [&](int64_t start, int64_t end) {
+    std::vector<int> ipiv(n);
+    std::vector<scalar_t> work(lwork);
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      if (applySmall<scalar_t, SmallInverse>(n, self_working_ptr, &info)) {
+        infos[i] = info;
+        continue;
+      }
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv.data(), &info);
+      infos[i] = info;
+      if (info != 0) {
+        continue;
+      }
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data(), work.data(), lwork, &info);
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -343,15 +512,16 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  at::parallel_for(0, batch_size, batchGrainSize(n), [&](int64_t start, int64_t end) {
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      if (!applySmall<scalar_t, SmallCholesky>(n, self_working_ptr, upper, &info)) {
+        lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+      }
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -406,12 +576,16 @@ static void apply_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-1);
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
-    int* infos_working_ptr = &infos_data[i];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, pivots_working_ptr, infos_working_ptr);
-  }
+  at::parallel_for(0, batch_size, batchGrainSize(n), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
+      int* infos_working_ptr = &infos_data[i];
+      if (!applySmall<scalar_t, SmallLu>(n, self_working_ptr, pivots_working_ptr, infos_working_ptr)) {
+        lapackLu<scalar_t>(n, n, self_working_ptr, n, pivots_working_ptr, infos_working_ptr);
+      }
+    }
+  });
 #endif
 }
 
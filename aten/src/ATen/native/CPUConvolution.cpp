@@ -0,0 +1,74 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/CPUConvolution.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(cpu_convolution_im2col_stub);
+DEFINE_DISPATCH(cpu_convolution_depthwise_stub);
+DEFINE_DISPATCH(cpu_convolution_winograd_stub);
+
+// See Note [Native CPU convolution]
+Tensor _cpu_convolution(
+    const Tensor& input_, const Tensor& weight_, const Tensor& bias_,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const int64_t dim = input_.dim();
+  TORCH_CHECK(dim == 4 || dim == 5,
+      "_cpu_convolution: expected a 4D or 5D input, but got a ", dim, "D one");
+  TORCH_CHECK(weight_.dim() == dim,
+      "_cpu_convolution: expected a ", dim, "D weight, but got a ", weight_.dim(), "D one");
+  TORCH_CHECK(static_cast<int64_t>(stride.size()) == dim - 2 &&
+      static_cast<int64_t>(padding.size()) == dim - 2 &&
+      static_cast<int64_t>(dilation.size()) == dim - 2,
+      "_cpu_convolution: expected ", dim - 2, " element stride, padding and dilation");
+  TORCH_CHECK(weight_.scalar_type() == input_.scalar_type() &&
+      (!bias_.defined() || bias_.scalar_type() == input_.scalar_type()),
+      "_cpu_convolution: expected input, weight and bias of the same dtype");
+  TORCH_CHECK(groups > 0 && input_.size(1) == weight_.size(1) * groups &&
+      weight_.size(0) % groups == 0,
+      "_cpu_convolution: weight of size ", weight_.sizes(), " does not match an input with ",
+      input_.size(1), " channels in ", groups, " groups");
+
+  auto input = input_.contiguous();
+  auto weight = weight_.contiguous();
+  auto bias = bias_.defined() ? bias_.contiguous() : bias_;
+
+  std::vector<int64_t> output_size = {input.size(0), weight.size(0)};
+  for (int64_t d = 2; d < dim; d++) {
+    const int64_t size = (input.size(d) + 2 * padding[d - 2] -
+        dilation[d - 2] * (weight.size(d) - 1) - 1) / stride[d - 2] + 1;
+    TORCH_CHECK(size > 0,
+        "_cpu_convolution: the kernel of size ", weight.sizes().slice(2),
+        " is larger than the padded input of size ", input.sizes().slice(2));
+    output_size.push_back(size);
+  }
+  auto output = at::empty(output_size, input.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  if (dim == 4 && groups == input.size(1) && groups > 1) {
+    cpu_convolution_depthwise_stub(
+        kCPU, output, input, weight, bias, stride, padding, dilation, groups);
+  } else if (dim == 4 && groups == 1 && weight.size(2) == 3 && weight.size(3) == 3 &&
+             stride[0] == 1 && stride[1] == 1 && dilation[0] == 1 && dilation[1] == 1 &&
+             input.size(1) >= 16 && weight.size(0) >= 16) {
+    cpu_convolution_winograd_stub(
+        kCPU, output, input, weight, bias, stride, padding, dilation, groups);
+  } else if (dim == 4) {
+    // as a 3D convolution of depth 1
+    auto output_3d = output.unsqueeze(2);
+    const std::vector<int64_t> stride_3d = {1, stride[0], stride[1]};
+    const std::vector<int64_t> padding_3d = {0, padding[0], padding[1]};
+    const std::vector<int64_t> dilation_3d = {1, dilation[0], dilation[1]};
+    cpu_convolution_im2col_stub(
+        kCPU, output_3d, input.unsqueeze(2), weight.unsqueeze(2), bias,
+        stride_3d, padding_3d, dilation_3d, groups);
+  } else {
+    cpu_convolution_im2col_stub(
+        kCPU, output, input, weight, bias, stride, padding, dilation, groups);
+  }
+  return output;
+}
+
+}} // namespace at::native
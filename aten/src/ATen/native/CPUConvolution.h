@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Note [Native CPU convolution]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Without MKL-DNN or NNPACK, CPU convolutions used to go to THNN, which
+// unfolds the whole input of each sample into an im2col buffer (`finput`,
+// easily hundreds of MB for 3D) and is parallel only across the batch.
+// _cpu_convolution is used instead when no graph needs to be recorded
+// (THNN keeps `finput` for the backward). It picks one of three kernels:
+//
+//  - depthwise 2D convolutions (groups == in_channels) run directly on the
+//    input, vectorized along the output rows when the stride is 1;
+//  - 3x3 2D convolutions with unit stride and dilation and enough channels
+//    use Winograd F(2x2, 3x3), which needs 16 multiplications per 2x2 output
+//    tile and input channel instead of 36;
+//  - everything else, 2D as 3D with a depth of 1, multiplies the weights with
+//    the im2col columns of a tile of output pixels at a time. A tile's columns
+//    fit in kCPUConvolutionWorkspaceSize bytes, so they stay in cache, and
+//    tiles are processed in parallel, which keeps every thread busy for a
+//    batch of 1. 1x1 convolutions with unit stride and no padding multiply
+//    the input directly.
+//
+// The kernels take contiguous tensors and a preallocated output. The im2col
+// kernel takes 5D tensors and 3 element stride, padding and dilation, the
+// other two 4D tensors and 2 element ones.
+using cpu_convolution_fn = void(*)(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups);
+
+DECLARE_DISPATCH(cpu_convolution_fn, cpu_convolution_im2col_stub);
+DECLARE_DISPATCH(cpu_convolution_fn, cpu_convolution_depthwise_stub);
+DECLARE_DISPATCH(cpu_convolution_fn, cpu_convolution_winograd_stub);
+
+constexpr int64_t kCPUConvolutionWorkspaceSize = 512 * 1024;
+
+}} // namespace at::native
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Note [Channels last on CPU]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A channels last tensor has the sizes of an NCHW one, and the strides of
+// MemoryFormat::ChannelsLast: in memory, it is an [N * H * W, C] matrix, with
+// the C channels of each pixel next to each other. The CPU convolutions,
+// batch norm, max and average pooling, nearest upsampling and 2D grid
+// sampling return channels last outputs for channels last inputs, so that a
+// network can run in NHWC from the first layer to the last. All but the
+// convolutions that aren't 1x1 (which go through NCHW and convert their output
+// back) compute them without converting their input. The backward passes of
+// batch norm and max pooling return channels last gradients too; the others
+// return NCHW ones.
+
+// Whether `t` is a channels last tensor. Tensors that are contiguous too
+// (e.g. with C == 1, or H == W == 1) count as contiguous.
+static inline bool is_channels_last(const Tensor& t) {
+  return t.dim() == 4 && !t.is_contiguous() &&
+      t.is_contiguous(MemoryFormat::ChannelsLast);
+}
+
+// An uninitialized channels last tensor with the NCHW `sizes`
+static inline Tensor empty_channels_last(IntArrayRef sizes, const TensorOptions& options) {
+  AT_ASSERT(sizes.size() == 4);
+  return at::empty({sizes[0], sizes[2], sizes[3], sizes[1]}, options)
+      .permute({0, 3, 1, 2});
+}
+
+}} // namespace at::native
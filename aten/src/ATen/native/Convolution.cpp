@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/ChannelsLast.h>
 #include <ATen/native/utils/ParamUtils.h>
+#include <limits>
 
 #include <ATen/Config.h>
 #if AT_NNPACK_ENABLED()
@@ -34,7 +36,10 @@ struct ConvParams {
   bool use_miopen(const at::Tensor& input) const;
   bool use_mkldnn(const at::Tensor& input) const;
   bool use_nnpack(const at::Tensor& input) const;
+  bool use_channels_last_gemm(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cpu_convolution(const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cuda_depthwise_tiled(const at::Tensor& input, const at::Tensor& weight) const;
 };
 
 std::ostream& operator<<(std::ostream & out, const ConvParams& params) {
@@ -174,6 +179,36 @@ auto ConvParams::use_nnpack(const at::Tensor& input) const -> bool {
   return false;
 }
 
+// See Note [Native CPU convolution]. THNN saves the unfolded input for the
+// backward, so _cpu_convolution, which has none, is used only when no graph is
+// recorded. NNPACK is preferred where it applies.
+auto ConvParams::use_cpu_convolution(
+        const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) const -> bool {
+  auto no_grad = [](const at::Tensor& t) {
+    return !t.defined() || !(t.is_variable() && t.requires_grad());
+  };
+  return input.type().backend() == at::Backend::CPU &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         weight.type() == input.type() &&
+         (!bias.defined() || bias.type() == input.type()) &&
+         (input.dim() == 4 || input.dim() == 5) &&
+         !transposed &&
+         no_grad(input) && no_grad(weight) && no_grad(bias) &&
+         !(input.dim() == 4 && groups == 1 && !is_dilated() && use_nnpack(input));
+}
+
+// See Note [Channels last on CPU]. A 1x1 convolution of a channels last input
+// is the product of its [N * H * W, C] matrix of pixels with the weights, which
+// needs no copy of the input at all.
+auto ConvParams::use_channels_last_gemm(const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  return !input.is_cuda() && !input.is_mkldnn() && is_channels_last(input) &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         weight.type() == input.type() &&
+         weight.dim() == 4 && weight.size(2) == 1 && weight.size(3) == 1 &&
+         !transposed && groups == 1 &&
+         !is_strided() && !is_padded() && !is_dilated();
+}
+
 // We currently only have depthwise support for the case where groups ==
 // nInputPlane and nInputPlane == nOutputPlane (the latter due to the lack of
 // a depthwise multiplier)
@@ -187,6 +222,22 @@ auto ConvParams::is_depthwise(
          weight.size(0) % input.size(1) == 0; // output channels must be a multiple of input channels
 }
 
+// The tiled kernel of _cuda_depthwise_convolution covers the 3x3 and 5x5,
+// stride 1 and 2 depthwise convolutions of MobileNet-style networks (without
+// a depthwise multiplier) and reads every input element about once, where the
+// THCUNN kernel reads it once per filter tap.
+auto ConvParams::use_cuda_depthwise_tiled(
+        const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  const int64_t kernel = weight.size(2);
+  return weight.size(0) == input.size(1) &&
+         (kernel == 3 || kernel == 5) && weight.size(3) == kernel &&
+         (stride[0] == 1 || stride[0] == 2) && stride[1] == stride[0] &&
+         !is_dilated() &&
+         // the (sample, channel) planes index the first grid dimension
+         input.size(0) * input.size(1) <= std::numeric_limits<int32_t>::max() &&
+         input.size(2) <= 65535 && input.size(3) <= 65535;
+}
+
 static void check_shape_forward(const at::Tensor& input,
                                 const at::Tensor& weight, const at::Tensor& bias,
                                 const ConvParams& params, bool input_is_mkldnn) {
@@ -364,8 +415,9 @@ at::Tensor _convolution(
     bool benchmark, bool deterministic, bool cudnn_enabled) {
 
   const bool input_is_mkldnn = input_r.is_mkldnn();
+  const bool input_is_channels_last = !input_r.is_cuda() && is_channels_last(input_r);
   auto input = input_r;
-  if (!input_is_mkldnn) {
+  if (!input_is_mkldnn && !input_is_channels_last) {
     input = input.contiguous();
   }
   auto weight = weight_r;
@@ -393,6 +445,19 @@ at::Tensor _convolution(
 
   check_shape_forward(input, weight, bias, params, input_is_mkldnn);
 
+  if (params.use_channels_last_gemm(input, weight)) {
+    const int64_t channels = input.size(1);
+    const int64_t out_channels = weight.size(0);
+    auto pixels = input.permute({0, 2, 3, 1}).reshape({-1, channels});
+    auto weight_t = weight.reshape({out_channels, channels}).t();
+    auto output = bias.defined() ? at::addmm(bias, pixels, weight_t) : at::mm(pixels, weight_t);
+    return output.view({input.size(0), input.size(2), input.size(3), out_channels})
+        .permute({0, 3, 1, 2});
+  }
+  if (input_is_channels_last) {
+    input = input.contiguous();
+  }
+
   if (k == 3) {
     params.view1d_as_2d();
     input = view4d(input);
@@ -407,7 +472,11 @@ at::Tensor _convolution(
       auto stride = params.stride;
       auto padding = params.padding;
       auto dilation = params.dilation;
-      output = at::thnn_conv_depthwise2d(input, weight, kernel_size, bias, stride, padding, dilation);
+      if (params.use_cuda_depthwise_tiled(input, weight)) {
+        output = at::_cuda_depthwise_convolution(input, weight, kernel_size, bias, stride, padding, dilation);
+      } else {
+        output = at::thnn_conv_depthwise2d(input, weight, kernel_size, bias, stride, padding, dilation);
+      }
   } else if (params.use_cudnn(input)) {
     TORCH_CHECK(input.type() == weight.type(),
              "Input type (", input.type().toString(), ") and weight type (", weight.type().toString(),
@@ -459,6 +528,9 @@ at::Tensor _convolution(
                                       params.padding, params.stride, params.dilation, params.groups);
     }
 #endif
+  } else if (params.use_cpu_convolution(input, weight, bias)) {
+    output = at::_cpu_convolution(
+        input, weight, bias, params.stride, params.padding, params.dilation, params.groups);
   } else {
     if (params.groups == 1) {
       output = at::_convolution_nogroup(
@@ -479,6 +551,9 @@ at::Tensor _convolution(
   if (k == 3) {
     output = view3d(output);
   }
+  if (input_is_channels_last) {
+    output = output.contiguous(MemoryFormat::ChannelsLast);
+  }
 
   return output;
 }
@@ -1,9 +1,12 @@
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
 
 #include <ATen/native/Distance.h>
 
+#include <numeric>
+
 namespace at { namespace native {
 
 DEFINE_DISPATCH(pdist_forward_stub);
@@ -24,13 +27,26 @@ Tensor pdist(const Tensor& self, const double p) {
   return at::_pdist_forward(self.contiguous(), p);
 }
 
+// Computes Euclidean distances as sqrt(||x1||^2 + ||x2||^2 - 2 * x1 x2^T), which
+// replaces the pairwise kernel with a single batched GEMM. This loses some precision
+// for nearly coincident points, so it is only used when the matrices are big enough
+// for the GEMM to pay off. Clamping before the sqrt keeps the gradient of
+// coincident points at zero, matching _cdist_backward.
+static Tensor _euclidean_dist(const Tensor& x1, const Tensor& x2) {
+  Tensor x1_norm = x1.pow(2).sum(-1, /*keepdim=*/true);
+  Tensor x2_norm = x2.pow(2).sum(-1, /*keepdim=*/true);
+  Tensor result = at::bmm(x1, x2.transpose(-2, -1));
+  result.mul_(-2).add_(x1_norm).add_(x2_norm.transpose(-2, -1));
+  return result.clamp_min_(1e-30).sqrt_();
+}
+
 Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
-  TORCH_CHECK(x1.dim() == 2, "cdist only supports 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x1.dim() >= 2, "cdist only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
   TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist only supports floating-point dtypes, X1 got: ", x1.scalar_type());
   auto device1 = x1.type().device_type();
   TORCH_CHECK(device1 == kCPU || device1 == kCUDA, "cdist only supports CPU and CUDA devices, X1 got: ", device1);
-  TORCH_CHECK(x2.dim() == 2, "cdist only supports 2D tensors, X2 got: ", x2.dim(), "D");
-  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist only supports floating-point dtypes, X2 got: ", x2.scalar_type());
+  TORCH_CHECK(x2.dim() >= 2, "cdist only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(at::isFloatingType(x2.scalar_type()), "cdist only supports floating-point dtypes, X2 got: ", x2.scalar_type());
   auto device2 = x2.type().device_type();
   TORCH_CHECK(device2 == kCPU || device2 == kCUDA, "cdist only supports CPU and CUDA devices, X2 got: ", device2);
   TORCH_CHECK(p >= 0, "cdist only supports non-negative p values");
@@ -42,29 +58,95 @@ Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
 
   int64_t r1 = x1.size(-2);
   int64_t r2 = x2.size(-2);
-  Tensor result = at::empty({r1, r2}, x1.options());
-  if (r1 > 0 && r2 > 0) {
-    if (c1 == 0) {
+  // Leading dimensions are batch dimensions and broadcast against each other
+  std::vector<int64_t> expand_batch = infer_size(
+      x1.sizes().slice(0, x1.dim() - 2), x2.sizes().slice(0, x2.dim() - 2));
+  std::vector<int64_t> output_shape(expand_batch);
+  output_shape.insert(output_shape.end(), {r1, r2});
+  if (r1 == 0 || r2 == 0) {
+    return at::empty(output_shape, x1.options());
+  }
+  if (c1 == 0) {
+    return at::zeros(output_shape, x1.options());
+  }
+
+  int64_t batch_product = std::accumulate(
+      expand_batch.begin(), expand_batch.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+  std::vector<int64_t> x1_expand_size(expand_batch);
+  x1_expand_size.insert(x1_expand_size.end(), {r1, c1});
+  std::vector<int64_t> x2_expand_size(expand_batch);
+  x2_expand_size.insert(x2_expand_size.end(), {r2, c2});
+  Tensor x1_expanded = x1.expand(x1_expand_size).reshape({batch_product, r1, c1});
+  Tensor x2_expanded = x2.expand(x2_expand_size).reshape({batch_product, r2, c2});
+
+  Tensor result;
+  if (p == 2 && (r1 > 25 || r2 > 25)) {
+    result = _euclidean_dist(x1_expanded, x2_expanded);
+  } else {
+    result = at::_cdist_forward(x1_expanded.contiguous(), x2_expanded.contiguous(), p);
+  }
+  return result.view(output_shape);
+}
+
+// The kernels work on a single pair of matrices, so batched inputs are
+// processed one matrix at a time. Inputs must be contiguous and have
+// identical batch dimensions; cdist takes care of broadcasting.
+Tensor _cdist_forward(const Tensor& x1, const Tensor& x2, const double p) {
+  TORCH_CHECK(x1.is_contiguous(), "_cdist_forward requires X1 to be contiguous");
+  TORCH_CHECK(x2.is_contiguous(), "_cdist_forward requires X2 to be contiguous");
+  TORCH_CHECK(x1.dim() == x2.dim() && x1.sizes().slice(0, x1.dim() - 2).equals(x2.sizes().slice(0, x2.dim() - 2)),
+      "_cdist_forward requires X1 and X2 to have the same batch dimensions");
+  auto device = x1.type().device_type();
+  TORCH_CHECK(device == kCPU || device == kCUDA, "_cdist_forward only supports CPU and CUDA devices, got: ", device);
+  int64_t r1 = x1.size(-2);
+  int64_t r2 = x2.size(-2);
+  int64_t c = x1.size(-1);
+  std::vector<int64_t> output_shape(x1.sizes().begin(), x1.sizes().end() - 2);
+  output_shape.insert(output_shape.end(), {r1, r2});
+  Tensor result = at::empty(output_shape, x1.options());
+  if (result.numel() > 0) {
+    if (c == 0) {
       result.fill_(0);
     } else {
-      cdist_stub(device1, result, x1.contiguous(), x2.contiguous(), p);
+      int64_t batch_product = result.numel() / (r1 * r2);
+      Tensor x1_batched = x1.view({batch_product, r1, c});
+      Tensor x2_batched = x2.view({batch_product, r2, c});
+      Tensor result_batched = result.view({batch_product, r1, r2});
+      for (int64_t b = 0; b < batch_product; b++) {
+        Tensor result_b = result_batched[b];
+        cdist_stub(device, result_b, x1_batched[b], x2_batched[b], p);
+      }
     }
   }
   return result;
 }
 
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
+  TORCH_CHECK(grad.is_contiguous(), "_cdist_backward requires grad to be contiguous");
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
   TORCH_CHECK(cdist.is_contiguous(), "_cdist_backward requires dist to be contiguous");
-  int64_t n = x1.size(-2);
+  int64_t r1 = x1.size(-2);
+  int64_t r2 = x2.size(-2);
   int64_t m = x1.size(-1);
   auto device1 = x1.type().device_type();
   TORCH_CHECK(device1 == kCPU || device1 == kCUDA, "_cdist_backward only supports CPU and CUDA devices, X1 got: ", device1);
   auto device2 = x2.type().device_type();
   TORCH_CHECK(device2 == kCPU || device2 == kCUDA, "_cdist_backward only supports CPU and CUDA devices, X2 got: ", device2);
-  Tensor grad_x1 = at::empty({n, m}, x1.options());
-  cdist_backward_stub(device1, grad_x1, grad, x1, x2, p, cdist);
+  Tensor grad_x1 = at::empty_like(x1);
+  if (grad_x1.numel() == 0) {
+    return grad_x1;
+  }
+  int64_t batch_product = x1.numel() / (r1 * m);
+  Tensor grad_x1_batched = grad_x1.view({batch_product, r1, m});
+  Tensor grad_batched = grad.view({batch_product, r1, r2});
+  Tensor x1_batched = x1.view({batch_product, r1, m});
+  Tensor x2_batched = x2.view({batch_product, r2, m});
+  Tensor cdist_batched = cdist.view({batch_product, r1, r2});
+  for (int64_t b = 0; b < batch_product; b++) {
+    Tensor grad_x1_b = grad_x1_batched[b];
+    cdist_backward_stub(device1, grad_x1_b, grad_batched[b], x1_batched[b], x2_batched[b], p, cdist_batched[b]);
+  }
   return grad_x1;
 }
 
@@ -4,6 +4,9 @@
 #include <ATen/Dispatch.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/LegacyTHFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <c10/util/Exception.h>
 
 #include <ATen/CPUGenerator.h>
@@ -13,8 +16,10 @@
 #include <ATen/native/DispatchStub.h>
 #include <ATen/native/UnaryOps.h>
 
+#include <algorithm>
 #include <type_traits>
 #include <functional>
+#include <vector>
 #include <assert.h>
 #include <cpuinfo.h>
 
@@ -150,6 +155,51 @@ Tensor& bernoulli_tensor_cpu_(Tensor& self, const Tensor& p_, Generator* gen) {
   return self;
 }
 
+// Note [Parallel random fills on CPU]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Drawing from the Mersenne Twister of a CPUGenerator is serial, under the
+// lock of the generator. Large contiguous floating point tensors are instead
+// filled by uniform_, normal_ and bernoulli_(p) from a Philox4x32_10 stream
+// (see ATen/core/PhiloxRNGEngine.h) keyed by a single 64-bit draw from the
+// generator. Each group of elements draws from the stream at a counter derived
+// from its own index, so threads fill their parts of the tensor independently
+// and the values only depend on the state of the generator and the size of the
+// tensor, not on the number of threads. Smaller tensors keep drawing from the
+// generator itself, which keeps the values for a given seed the same as before
+// for them (e.g. when initializing small models).
+
+DEFINE_DISPATCH(uniform_stub);
+DEFINE_DISPATCH(normal_stub);
+DEFINE_DISPATCH(bernoulli_scalar_stub);
+
+static bool use_parallel_random(const Tensor& self) {
+  return (self.scalar_type() == kFloat || self.scalar_type() == kDouble) &&
+      self.is_contiguous() && self.numel() >= internal::GRAIN_SIZE;
+}
+
+static uint64_t parallel_random_seed(Generator* gen) {
+  THGenerator* generator = get_generator(gen);
+  std::lock_guard<std::mutex> lock(generator->mutex);
+  return THRandom_random64(generator);
+}
+
+Tensor& uniform_cpu_(Tensor& self, double from, double to, Generator* gen) {
+  if (!use_parallel_random(self)) {
+    return at::legacy::th::_th_uniform_(self, from, to, gen);
+  }
+  uniform_stub(kCPU, self, from, to, parallel_random_seed(gen));
+  return self;
+}
+
+Tensor& normal_cpu_(Tensor& self, double mean, double std, Generator* gen) {
+  if (!use_parallel_random(self)) {
+    return at::legacy::th::_th_normal_(self, mean, std, gen);
+  }
+  TORCH_CHECK(std > 0.0, "normal_ expects std > 0.0, but found std=", std);
+  normal_stub(kCPU, self, mean, std, parallel_random_seed(gen));
+  return self;
+}
+
 DEFINE_DISPATCH(bernoulli_mkl_stub);
 
 Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
@@ -160,6 +210,10 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
     return self;
   }
 #endif
+  if (use_parallel_random(self)) {
+    bernoulli_scalar_stub(kCPU, self, p, parallel_random_seed(gen));
+    return self;
+  }
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
     THGenerator* generator = get_generator(gen);
     std::lock_guard<std::mutex> lock(generator->mutex);
@@ -172,6 +226,185 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
 }
 
 
+// Note [Parallel multinomial sampling on CPU]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Like the parallel random fills, multinomial with replacement and the alias
+// draw take a single 64-bit draw from the generator and then sample from a
+// Philox4x32_10 stream keyed by it, at a counter derived from the index of
+// the sample, so the samples don't depend on the number of threads. Small
+// multinomial calls, and all calls without replacement, keep drawing from the
+// generator itself.
+
+// uniform on [0, 1) with 53 random bits
+static inline double philox_uniform_double(Philox4x32_10& engine) {
+  const uint64_t hi = engine();
+  const uint64_t lo = engine();
+  return ((hi << 21) ^ (lo >> 11)) * (1.0 / (1ull << 53));
+}
+
+template <typename scalar_t>
+static void multinomial_with_replacement_kernel(
+    const Tensor& probs,
+    Tensor& samples,
+    uint64_t seed) {
+  const int64_t n_dist = probs.size(0);
+  const int64_t n_categories = probs.size(1);
+  const int64_t n_sample = samples.size(1);
+  const scalar_t* probs_data = probs.data<scalar_t>();
+  int64_t* samples_data = samples.data<int64_t>();
+
+  // normalized cumulative distributions, in double like the TH implementation
+  Tensor cum_dist = at::empty({n_dist, n_categories}, probs.options().dtype(kDouble));
+  double* cum_data = cum_dist.data<double>();
+  parallel_for(0, n_dist, internal::GRAIN_SIZE / n_categories + 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const scalar_t* row = probs_data + i * n_categories;
+      double* cum_row = cum_data + i * n_categories;
+      double sum = 0;
+      for (int64_t j = 0; j < n_categories; ++j) {
+        const double val = row[j];
+        TORCH_CHECK(val >= 0,
+            "invalid multinomial distribution (encountering probability entry < 0)");
+        TORCH_CHECK(std::isfinite(val),
+            "invalid multinomial distribution (encountering probability entry = infinity or NaN)");
+        sum += val;
+        cum_row[j] = sum;
+      }
+      TORCH_CHECK(sum > 0, "invalid multinomial distribution (sum of probabilities <= 0)");
+      for (int64_t j = 0; j < n_categories; ++j) {
+        cum_row[j] /= sum;
+      }
+      // make sure the last bucket catches every draw
+      cum_row[n_categories - 1] = 1;
+    }
+  });
+
+  parallel_for(0, n_dist * n_sample, internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+    Philox4x32_10 engine(seed, /*subsequence=*/0, begin * 2);
+    for (int64_t k = begin; k < end; ++k) {
+      const double* cum_row = cum_data + (k / n_sample) * n_categories;
+      // the first bucket whose cumulative probability is above the draw,
+      // which never picks a category with zero probability
+      samples_data[k] =
+          std::upper_bound(cum_row, cum_row + n_categories, philox_uniform_double(engine)) - cum_row;
+    }
+  });
+}
+
+Tensor& multinomial_out_cpu(Tensor& result, const Tensor& self, int64_t n_sample, bool replacement, Generator* gen) {
+  const int64_t n_dist = self.dim() == 2 ? self.size(0) : 1;
+  if (!replacement || (self.dim() != 1 && self.dim() != 2) || self.numel() == 0 ||
+      n_sample <= 0 || n_dist * n_sample < internal::GRAIN_SIZE) {
+    return at::legacy::th::_th_multinomial_out(result, self, n_sample, replacement, gen);
+  }
+  TORCH_CHECK(result.scalar_type() == kLong,
+      "multinomial: expected result of type torch.int64, but got ", result.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "multinomial_cpu", [&] {
+    const Tensor probs = self.reshape({n_dist, -1}).contiguous();
+    Tensor samples = at::empty({n_dist, n_sample}, result.options());
+    multinomial_with_replacement_kernel<scalar_t>(probs, samples, parallel_random_seed(gen));
+    if (self.dim() == 1) {
+      samples.resize_({n_sample});
+    }
+    result.resize_as_(samples).copy_(samples);
+  });
+  return result;
+}
+
+Tensor multinomial_cpu(const Tensor& self, int64_t n_sample, bool replacement, Generator* gen) {
+  Tensor result = at::empty({0}, self.options().dtype(kLong));
+  multinomial_out_cpu(result, self, n_sample, replacement, gen);
+  return result;
+}
+
+// Vose's alias method: a draw picks a uniform category k and keeps it with
+// probability q[k], otherwise takes its alias J[k]. Categories that are left
+// without an alias at the end keep themselves with probability 1.
+std::tuple<Tensor, Tensor> _multinomial_alias_setup_cpu(const Tensor& probs) {
+  TORCH_CHECK(probs.dim() == 1,
+      "expected 1-D probability tensor, got ", probs.dim(), "-D probability tensor instead");
+  const int64_t K = probs.numel();
+  TORCH_CHECK(K > 0, "expected a non-empty probability tensor");
+  Tensor J = at::empty({K}, probs.options().dtype(kLong));
+  Tensor q = at::empty({K}, probs.options());
+  AT_DISPATCH_FLOATING_TYPES(probs.scalar_type(), "_multinomial_alias_setup_cpu", [&] {
+    const Tensor probs_contig = probs.contiguous();
+    const scalar_t* probs_data = probs_contig.data<scalar_t>();
+    int64_t* J_data = J.data<int64_t>();
+    scalar_t* q_data = q.data<scalar_t>();
+
+    double sum = 0;
+    for (int64_t i = 0; i < K; ++i) {
+      const double val = probs_data[i];
+      TORCH_CHECK(val >= 0 && std::isfinite(val),
+          "invalid multinomial distribution (encountering probability entry < 0, infinity or NaN)");
+      sum += val;
+    }
+    TORCH_CHECK(sum > 0, "invalid multinomial distribution (sum of probabilities <= 0)");
+
+    std::vector<double> scaled(K);
+    std::vector<int64_t> smaller;
+    std::vector<int64_t> larger;
+    for (int64_t i = 0; i < K; ++i) {
+      scaled[i] = probs_data[i] * K / sum;
+      J_data[i] = i;
+      (scaled[i] < 1.0 ? smaller : larger).push_back(i);
+    }
+    while (!smaller.empty() && !larger.empty()) {
+      const int64_t small = smaller.back();
+      const int64_t large = larger.back();
+      smaller.pop_back();
+      J_data[small] = large;
+      q_data[small] = static_cast<scalar_t>(scaled[small]);
+      scaled[large] -= 1.0 - scaled[small];
+      if (scaled[large] < 1.0) {
+        larger.pop_back();
+        smaller.push_back(large);
+      }
+    }
+    // whatever is left is 1 up to rounding
+    for (int64_t i : smaller) {
+      q_data[i] = 1;
+    }
+    for (int64_t i : larger) {
+      q_data[i] = 1;
+    }
+  });
+  return std::make_tuple(J, q);
+}
+
+Tensor _multinomial_alias_draw_cpu(const Tensor& q, const Tensor& J, int64_t n_sample, Generator* gen) {
+  TORCH_CHECK(q.dim() == 1,
+      "expected 1-D probability table, got ", q.dim(), "-D probability table instead");
+  TORCH_CHECK(J.dim() == 1,
+      "expected 1-D alias table, got ", J.dim(), "-D alias table instead");
+  TORCH_CHECK(n_sample > 0, "cannot sample <= 0 samples");
+  TORCH_CHECK(J.scalar_type() == kLong, "expected an alias table of type torch.int64");
+  TORCH_CHECK(J.numel() == q.numel() && q.numel() > 0,
+      "expected probability and alias tables of the same non-zero size, but got ",
+      q.numel(), " and ", J.numel());
+  const int64_t K = q.numel();
+  Tensor result = at::empty({n_sample}, J.options());
+  AT_DISPATCH_FLOATING_TYPES(q.scalar_type(), "_multinomial_alias_draw_cpu", [&] {
+    const Tensor q_contig = q.contiguous();
+    const Tensor J_contig = J.contiguous();
+    const scalar_t* q_data = q_contig.data<scalar_t>();
+    const int64_t* J_data = J_contig.data<int64_t>();
+    int64_t* result_data = result.data<int64_t>();
+    const uint64_t seed = parallel_random_seed(gen);
+    parallel_for(0, n_sample, internal::GRAIN_SIZE / 4, [&](int64_t begin, int64_t end) {
+      // one Philox block of four 32-bit values per sample
+      Philox4x32_10 engine(seed, /*subsequence=*/0, begin * 4);
+      for (int64_t i = begin; i < end; ++i) {
+        const uint64_t hi = engine();
+        const int64_t k = static_cast<int64_t>(((hi << 32) | engine()) % K);
+        result_data[i] = philox_uniform_double(engine) < q_data[k] ? k : J_data[k];
+      }
+    });
+  });
+  return result;
+}
+
 Tensor _standard_gamma_grad_cpu(const Tensor& self, const Tensor& output) {
   Tensor ret = at::empty(self.sizes(), self.options());
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "_standard_gamma_grad_cpu", [&] {
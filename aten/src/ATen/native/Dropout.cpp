@@ -1,5 +1,15 @@
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/native/Distributions.h>
+#include <ATen/native/Dropout.h>
+
+#include <TH/THRandom.h>
+
+#include <algorithm>
+#include <mutex>
 
 namespace at { namespace native {
 
@@ -21,7 +31,74 @@ Tensor make_feature_noise(const Tensor& input) {
 }
 
 bool is_fused_kernel_acceptable(const Tensor& input, double p) {
-  return input.is_cuda() && p > 0 && p < 1 && input.numel() > 0;
+  const bool fused_cpu = input.device().is_cpu() && input.layout() == kStrided &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble);
+  return (input.is_cuda() || fused_cpu) && p > 0 && p < 1 && input.numel() > 0;
+}
+
+// The CPU dropout kernel draws from a Philox4x32_10 stream keyed by one draw
+// from the generator, like the parallel random fills (see Note [Parallel
+// random fills on CPU]). Each word of the packed mask is drawn from the stream
+// at the counter of its first element, so the result doesn't depend on the
+// number of threads.
+uint64_t fused_dropout_seed(Generator* gen) {
+  THGenerator* generator = get_generator(gen);
+  std::lock_guard<std::mutex> lock(generator->mutex);
+  return THRandom_random64(generator);
+}
+
+template <typename scalar_t>
+void fused_dropout_cpu_kernel(
+    const Tensor& input,
+    const Tensor& bias,
+    const Tensor& residual,
+    Tensor& output,
+    Tensor& mask,
+    double p,
+    uint64_t seed) {
+  const scalar_t* input_data = input.data<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+  const int64_t bias_size = bias.defined() ? bias.numel() : 1;
+  const scalar_t* residual_data =
+      residual.defined() ? residual.data<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data<scalar_t>();
+  uint8_t* mask_data = mask.data<uint8_t>();
+  const int64_t numel = input.numel();
+  const float keep_p = static_cast<float>(p);
+  const scalar_t scale = static_cast<scalar_t>(1. / p);
+
+  const int64_t num_words =
+      (numel + kDropoutMaskWordBits - 1) / kDropoutMaskWordBits;
+  parallel_for(
+      0,
+      num_words,
+      internal::GRAIN_SIZE / kDropoutMaskWordBits,
+      [&](int64_t begin, int64_t end) {
+        Philox4x32_10 engine(seed, /*subsequence=*/0, begin * kDropoutMaskWordBits);
+        for (int64_t word = begin; word < end; ++word) {
+          const int64_t first = word * kDropoutMaskWordBits;
+          const int64_t last = std::min(first + kDropoutMaskWordBits, numel);
+          uint64_t bits = 0;
+          for (int64_t i = first; i < last; ++i) {
+            // uniform on [0, 1) from the top 24 bits
+            const bool keep = (engine() >> 8) * (1.0f / (1u << 24)) < keep_p;
+            scalar_t value = input_data[i];
+            if (bias_data) {
+              value += bias_data[i % bias_size];
+            }
+            value *= static_cast<scalar_t>(keep) * scale;
+            if (residual_data) {
+              value += residual_data[i];
+            }
+            output_data[i] = value;
+            bits |= static_cast<uint64_t>(keep) << (i - first);
+          }
+          for (int64_t byte = 0; byte < kDropoutMaskWordBits / 8; ++byte) {
+            mask_data[word * (kDropoutMaskWordBits / 8) + byte] =
+                static_cast<uint8_t>(bits >> (8 * byte));
+          }
+        }
+      });
 }
 
 // NB: sure, we could have used different overloads here, but I would feel insecure
@@ -81,6 +158,53 @@ ALIAS_SPECIALIZATION(_feature_alpha_dropout, true,  true )
 
 } // anomymous namepsace
 
+// p is the probability to keep an element, see Note [Packed dropout masks]
+// for the mask.
+std::tuple<Tensor, Tensor> fused_bias_dropout_add_cpu(
+    const Tensor& self,
+    const Tensor& bias,
+    const Tensor& residual,
+    double p,
+    Generator* gen) {
+  check_fused_dropout_inputs("_fused_bias_dropout_add", self, bias, residual);
+  auto input = self.contiguous();
+  auto output = at::empty_like(input);
+  auto mask = packed_dropout_mask(input);
+  if (input.numel() == 0) {
+    return std::make_tuple(output, mask);
+  }
+  auto bias_ = bias.defined() ? bias.contiguous() : bias;
+  auto residual_ = residual.defined() ? residual.contiguous() : residual;
+  const uint64_t seed = fused_dropout_seed(gen);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "fused_dropout_cpu", [&] {
+    fused_dropout_cpu_kernel<scalar_t>(input, bias_, residual_, output, mask, p, seed);
+  });
+  return std::make_tuple(output, mask);
+}
+
+std::tuple<Tensor, Tensor> fused_dropout_cpu(const Tensor& self, double p, Generator* gen) {
+  return fused_bias_dropout_add_cpu(self, Tensor(), Tensor(), p, gen);
+}
+
+Tensor masked_scale_cpu(const Tensor& self, const Tensor& mask, double scale) {
+  check_packed_dropout_mask(self, mask);
+  auto input = self.contiguous();
+  auto output = at::empty_like(input);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "masked_scale_cpu", [&] {
+    const scalar_t* input_data = input.data<scalar_t>();
+    const uint8_t* mask_data = mask.data<uint8_t>();
+    scalar_t* output_data = output.data<scalar_t>();
+    const scalar_t scale_ = static_cast<scalar_t>(scale);
+    parallel_for(0, input.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const bool keep = (mask_data[i >> 3] >> (i & 7)) & 1;
+        output_data[i] = static_cast<scalar_t>(keep) * input_data[i] * scale_;
+      }
+    });
+  });
+  return output;
+}
+
 Tensor dropout(const Tensor& input, double p, bool train) {
   if (train && is_fused_kernel_acceptable(input, p)) {
     return std::get<0>(at::_fused_dropout(input, 1 - p));
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Note [Packed dropout masks]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The masks returned by _fused_dropout and _fused_bias_dropout_add, and taken
+// by _masked_scale, hold one bit per element of the input: bit i % 8 of byte
+// i / 8 is set if element i, in the row-major order of the input, is kept.
+// Autograd keeps the mask of every dropout layer alive until backward, so this
+// is an eighth of the memory of a byte mask. The bytes are allocated in whole
+// 64-bit words, so that the CUDA kernels can store the ballot of a warp (a
+// wavefront on ROCm) at once.
+constexpr int64_t kDropoutMaskWordBits = 64;
+
+inline int64_t packed_dropout_mask_bytes(int64_t numel) {
+  return (numel + kDropoutMaskWordBits - 1) / kDropoutMaskWordBits *
+      (kDropoutMaskWordBits / 8);
+}
+
+inline Tensor packed_dropout_mask(const Tensor& self) {
+  return at::empty(
+      {packed_dropout_mask_bytes(self.numel())}, self.options().dtype(kByte));
+}
+
+inline void check_packed_dropout_mask(const Tensor& self, const Tensor& mask) {
+  TORCH_CHECK(mask.scalar_type() == kByte, "mask should be torch.uint8 dtype");
+  TORCH_CHECK(mask.dim() == 1 &&
+      mask.numel() == packed_dropout_mask_bytes(self.numel()),
+      "expected a packed dropout mask of ", packed_dropout_mask_bytes(self.numel()),
+      " bytes for ", self.numel(), " elements, but got one of size ", mask.sizes());
+}
+
+// `bias` is added along the last dimension of `self` before dropout, and
+// `residual`, of the size of `self`, after it. Both are optional.
+inline void check_fused_dropout_inputs(
+    const char* fn,
+    const Tensor& self,
+    const Tensor& bias,
+    const Tensor& residual) {
+  TORCH_CHECK(!bias.defined() ||
+      (self.dim() > 0 && bias.dim() == 1 && bias.size(0) == self.size(-1)),
+      fn, ": expected a bias of ", self.dim() > 0 ? self.size(-1) : 1,
+      " elements, the size of the last dimension of the input, but got one of size ",
+      bias.sizes());
+  TORCH_CHECK(!residual.defined() || residual.sizes() == self.sizes(),
+      fn, ": expected a residual of size ", self.sizes(), ", but got ",
+      residual.sizes());
+  TORCH_CHECK(!bias.defined() || bias.scalar_type() == self.scalar_type(),
+      fn, ": expected a bias of type ", self.scalar_type());
+  TORCH_CHECK(!residual.defined() || residual.scalar_type() == self.scalar_type(),
+      fn, ": expected a residual of type ", self.scalar_type());
+}
+
+}} // namespace at::native
@@ -11,11 +11,46 @@
 
 namespace at { namespace native {
 
+// index_select is implemented in TH, which has no BFloat16, so the rows of
+// BFloat16 CPU embeddings are gathered here.
+static Tensor embedding_bfloat16_cpu(const Tensor & weight_, const Tensor & indices) {
+  auto weight = weight_.contiguous();
+  auto indices_contig = indices.contiguous();
+  auto indices_data = indices_contig.data<int64_t>();
+  const int64_t numel = indices.numel();
+  const int64_t num_weights = weight.size(0);
+  const int64_t row_size = num_weights > 0 ? weight.numel() / num_weights : 0;
+
+  auto size = indices.sizes().vec();
+  for (auto d : weight.sizes().slice(1)) {
+    size.push_back(d);
+  }
+  auto output = at::empty(size, weight.options());
+  auto weight_data = weight.data<at::BFloat16>();
+  auto output_data = output.data<at::BFloat16>();
+
+  at::parallel_for(0, numel, internal::GRAIN_SIZE / std::max<int64_t>(row_size, 1),
+                   [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      const int64_t k = indices_data[i];
+      TORCH_CHECK(k >= 0 && k < num_weights, "embedding(): index ", k,
+                  " is out of range for a weight with ", num_weights, " rows");
+      std::memcpy(output_data + i * row_size, weight_data + k * row_size,
+                  row_size * sizeof(at::BFloat16));
+    }
+  });
+  return output;
+}
+
 Tensor embedding(const Tensor & weight, const Tensor & indices,
                  int64_t padding_idx, bool scale_grad_by_freq, bool sparse) {
   auto indices_arg = TensorArg(indices, "indices", 1);
   checkScalarType("embedding", indices_arg, kLong);
 
+  if (weight.scalar_type() == kBFloat16 && weight.type().backend() == Backend::CPU) {
+    return embedding_bfloat16_cpu(weight, indices);
+  }
+
   // TODO: use tensor.index() after improving perf
   if (indices.dim() == 1) {
     return weight.index_select(0, indices);
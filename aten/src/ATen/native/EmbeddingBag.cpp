@@ -5,11 +5,16 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <caffe2/perfkernels/adagrad.h>
 #include <caffe2/perfkernels/embedding_lookup.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <sstream>
 #include <vector>
 
@@ -40,6 +45,45 @@ bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor&
   return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
 }
 
+// The number of indices in each bag, as the perfkernels take them.
+std::vector<int> make_lengths(const Tensor& offsets, int64_t num_indices) {
+  auto accessor = offsets.accessor<int64_t, 1>();
+  std::vector<int> lengths;
+  lengths.reserve(offsets.numel());
+
+  int64_t lower = accessor[0];
+  for (int64_t i = 1; i < offsets.numel(); ++i) {
+    lengths.push_back(accessor[i] - lower);
+    lower = accessor[i];
+  }
+  lengths.push_back(num_indices - lower);
+  return lengths;
+}
+
+// Calls `lookup(bag_begin, bag_end, index_begin, index_end)` on ranges of the
+// bags in parallel. The perfkernels reduce each bag into its own row of the
+// output, so ranges of bags can be looked up independently as long as the
+// indices and lengths passed along are those of the range.
+template <typename F>
+void parallel_embedding_lookup(
+    const std::vector<int>& lengths,
+    int64_t ddim,
+    const F& lookup) {
+  const int64_t num_bags = lengths.size();
+  std::vector<int64_t> starts(num_bags + 1, 0);
+  for (int64_t i = 0; i < num_bags; ++i) {
+    starts[i + 1] = starts[i] + lengths[i];
+  }
+  // Aim at GRAIN_SIZE elements of the embeddings per task
+  const int64_t work_per_bag =
+      std::max<int64_t>(1, starts[num_bags] * ddim / std::max<int64_t>(1, num_bags));
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / work_per_bag);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    lookup(begin, end, starts[begin], starts[end]);
+  });
+}
+
 // This function combines index_select (using select_indices as the index) and
 // index_add (using add_indices as the index), without creating an intermediary
 // tensor to hold the selected embeddings
@@ -80,29 +124,23 @@ void index_select_add<float>(const Tensor &select_indices,
   auto output_data = output.data<float>();
 
   if (isFastPathIndexSelect(src, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
-
-    int64_t lower = accessor[0];
-    for (size_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/nullptr,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
+    auto lengths = make_lengths(offsets, select_indices.numel());
+    parallel_embedding_lookup(lengths, ddim,
+        [&](int64_t bag_begin, int64_t bag_end, int64_t index_begin, int64_t index_end) {
+      caffe2::EmbeddingLookup(
+        /*block_size=*/ddim,
+        /*output_size=*/bag_end - bag_begin,
+        /*index_size=*/index_end - index_begin,
+        /*data_size=*/src.size(0),
+        /*input=*/src_data,
+        /*indices=*/select_indices_data + index_begin,
+        /*lengths=*/lengths.data() + bag_begin,
+        /*weights=*/nullptr,
+        /*scale_bias=*/nullptr,
+        /*normalize_by_lengths=*/false,
+        /*out=*/output_data + ddim * bag_begin
+      );
+    });
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
     auto add_indices_data = add_indices.data<int64_t>();
@@ -169,29 +207,23 @@ void index_select_scale_add<float>(const Tensor &select_indices,
   auto output_data = output.data<float>();
 
   if (isFastPathIndexSelectScale(src, scale, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
-
-    int64_t lower = accessor[0];
-    for (size_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/scale_data,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
+    auto lengths = make_lengths(offsets, select_indices.numel());
+    parallel_embedding_lookup(lengths, ddim,
+        [&](int64_t bag_begin, int64_t bag_end, int64_t index_begin, int64_t index_end) {
+      caffe2::EmbeddingLookup(
+        /*block_size=*/ddim,
+        /*output_size=*/bag_end - bag_begin,
+        /*index_size=*/index_end - index_begin,
+        /*data_size=*/src.size(0),
+        /*input=*/src_data,
+        /*indices=*/select_indices_data + index_begin,
+        /*lengths=*/lengths.data() + bag_begin,
+        /*weights=*/scale_data + index_begin,
+        /*scale_bias=*/nullptr,
+        /*normalize_by_lengths=*/false,
+        /*out=*/output_data + ddim * bag_begin
+      );
+    });
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
     auto add_indices_data = add_indices.data<int64_t>();
@@ -312,6 +344,116 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
     return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
 }
 
+// Note [Fused 8-bit rowwise embeddings]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A fused 8-bit rowwise quantized embedding table is a uint8 tensor of
+// [num_embeddings, embedding_dim + 8], in the layout of caffe2's
+// FloatToFused8BitRowwiseQuantized: each row holds its quantized values
+// followed by the scale and the bias of the row as two floats,
+//
+//   | ... uint8 data ... | scale | bias |
+//
+// so that row i dequantizes to data * scale + bias. embedding_bag accepts such
+// tables as its weight (in 'sum' and 'mean' mode, on CPU) and reduces them with
+// the fused caffe2 perfkernels, without dequantizing the table. These tables
+// aren't differentiable, and neither are the per_sample_weights used with them.
+
+static constexpr int64_t kFused8BitRowwiseScaleBiasBytes = 2 * sizeof(float);
+
+Tensor _embedding_bag_pack_8bit_rowwise_cpu(const Tensor& weight_) {
+  auto weight_arg = TensorArg(weight_, "weight", 1);
+  checkDim("embedding_bag_pack_8bit_rowwise", weight_arg, 2);
+  checkScalarType("embedding_bag_pack_8bit_rowwise", weight_arg, kFloat);
+  auto weight = weight_.contiguous();
+  const int64_t num_rows = weight.size(0);
+  const int64_t ddim = weight.size(1);
+  const int64_t packed_ddim = ddim + kFused8BitRowwiseScaleBiasBytes;
+
+  auto packed = at::empty({num_rows, packed_ddim}, weight.options().dtype(kByte));
+  auto weight_data = weight.data<float>();
+  auto packed_data = packed.data<uint8_t>();
+  // Same epsilon as FloatToFused8BitRowwiseQuantizedOp, so that both produce
+  // the same tables.
+  constexpr float kEpsilon = 1e-8f;
+  parallel_for(0, num_rows, 1 + internal::GRAIN_SIZE / std::max<int64_t>(1, ddim),
+      [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const float* input_row = weight_data + row * ddim;
+      uint8_t* output_row = packed_data + row * packed_ddim;
+      float minimum = 0, maximum = 0;
+      if (ddim > 0) {
+        const auto minmax = std::minmax_element(input_row, input_row + ddim);
+        minimum = *minmax.first;
+        maximum = *minmax.second;
+      }
+      const float range = maximum - minimum;
+      const float scale_bias[2] = {range / 255.0f, minimum};
+      const float inverse_scale = 255.0f / (range + kEpsilon);
+      for (int64_t i = 0; i < ddim; ++i) {
+        output_row[i] = static_cast<uint8_t>(
+            std::round((input_row[i] - minimum) * inverse_scale));
+      }
+      std::memcpy(output_row + ddim, scale_bias, sizeof(scale_bias));
+    }
+  });
+  return packed;
+}
+
+static Tensor embedding_bag_fused_8bit_rowwise(
+    const Tensor& weight_,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const int64_t mode,
+    const Tensor& per_sample_weights) {
+  auto weight_arg = TensorArg(weight_, "weight", 1);
+  checkDim("embedding_bag", weight_arg, 2);
+  TORCH_CHECK(weight_.size(1) >= kFused8BitRowwiseScaleBiasBytes,
+      "embedding_bag: expected a fused 8-bit rowwise weight to have at least ",
+      kFused8BitRowwiseScaleBiasBytes, " columns for the scale and bias, but got ",
+      weight_.size(1));
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      "embedding_bag: fused 8-bit rowwise weights are only supported with "
+      "mode='sum' or mode='mean'");
+  auto weight = weight_.contiguous();
+  const int64_t ddim = weight.size(1) - kFused8BitRowwiseScaleBiasBytes;
+
+  const float* per_sample_weights_data = nullptr;
+  Tensor per_sample_weights_contig;
+  if (per_sample_weights.defined()) {
+    TORCH_CHECK(mode == MODE_SUM,
+        "embedding_bag: per_sample_weights only supported with mode='sum'");
+    auto per_sample_weights_arg = TensorArg(
+        per_sample_weights, "per_sample_weights", 1);
+    checkScalarType("embedding_bag", per_sample_weights_arg, kFloat);
+    checkNumel("embedding_bag", per_sample_weights_arg, indices.numel());
+    per_sample_weights_contig = per_sample_weights.contiguous();
+    per_sample_weights_data = per_sample_weights_contig.data<float>();
+  }
+
+  auto output = at::empty({offsets.size(0), ddim}, weight.options().dtype(kFloat));
+  auto weight_data = weight.data<uint8_t>();
+  auto indices_data = indices.data<int64_t>();
+  auto output_data = output.data<float>();
+  auto lengths = make_lengths(offsets, indices.numel());
+  parallel_embedding_lookup(lengths, ddim,
+      [&](int64_t bag_begin, int64_t bag_end, int64_t index_begin, int64_t index_end) {
+    caffe2::Fused8BitRowwiseEmbeddingLookup(
+      /*block_size=*/ddim,
+      /*output_size=*/bag_end - bag_begin,
+      /*index_size=*/index_end - index_begin,
+      /*data_size=*/weight.size(0),
+      /*input=*/weight_data,
+      /*indices=*/indices_data + index_begin,
+      /*lengths=*/lengths.data() + bag_begin,
+      /*weights=*/per_sample_weights_data
+          ? per_sample_weights_data + index_begin : nullptr,
+      /*normalize_by_lengths=*/mode == MODE_MEAN,
+      /*out=*/output_data + ddim * bag_begin
+    );
+  });
+  return output;
+}
+
 // embedding_bag wrapper to enforce contiguity in tensors other than `weight`.
 // This is created to save extra `.contiguous()` call in backward.
 // See NOTE [ embedding_bag Native Functions ] in native_functions.yaml for details
@@ -335,6 +477,16 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   checkScalarType("embedding_bag", indices_arg, kLong);
   auto offsets_arg = TensorArg(offsets, "offsets", 1);
   checkScalarType("embedding_bag", offsets_arg, kLong);
+  if (weight.scalar_type() == kByte) {
+    // See Note [Fused 8-bit rowwise embeddings]
+    auto bag_size = at::zeros(offsets.sizes(), indices.options());
+    make_bag_size(offsets, indices, mode, bag_size);
+    auto output = embedding_bag_fused_8bit_rowwise(
+        weight, indices, offsets, mode, per_sample_weights);
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(
+        output, at::empty({0}, offsets.options()), bag_size, bag_size);
+  }
+
   auto weight_arg = TensorArg(weight, "weight", 1);
   checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
 
@@ -627,6 +779,10 @@ Tensor _embedding_bag_per_sample_weights_backward_cpu_template(
   TORCH_CHECK(
       mode == MODE_SUM,
       "embedding_bag_backward: per_sample_weights only supported for mode='sum'");
+  TORCH_CHECK(
+      weight.scalar_type() == grad.scalar_type(),
+      "embedding_bag_backward: per_sample_weights can't be differentiated with "
+      "a weight of type ", weight.scalar_type(), " (e.g. a quantized one)");
 
   AT_ASSERT(grad.dim() == 2)
   auto embedding_features = grad.size(1);
@@ -722,5 +878,159 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+// Note [Fused embedding_bag Adagrad]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// _embedding_bag_sparse_adagrad_ applies an Adagrad step to `weight` for the
+// gradient of embedding_bag(weight, indices, offsets, ...), given the gradient
+// `grad` of its output, without ever forming the gradient of `weight`:
+// the indices are grouped by the row they refer to, and each group sums its
+// share of `grad` into a buffer of one row and updates that row of `weight`
+// and `sum` in place with the caffe2 perfkernels. Groups touch rows of their
+// own, so they are updated in parallel, and untouched rows are never read.
+//
+// If `sum` has the shape of `weight`, this is the update of torch.optim.Adagrad
+// (with `lr` its current learning rate), i.e. caffe2's SparseAdagrad. If `sum`
+// holds a single value per row, this is caffe2's RowWiseSparseAdagrad, which
+// accumulates the mean of the squared gradient of each row.
+Tensor& _embedding_bag_sparse_adagrad_cpu_(
+    Tensor& weight,
+    Tensor& sum,
+    const Tensor& grad_,
+    const Tensor& indices_,
+    const Tensor& offsets_,
+    int64_t mode,
+    const Tensor& per_sample_weights_,
+    double lr,
+    double eps,
+    bool scale_grad_by_freq) {
+  auto weight_arg = TensorArg(weight, "weight", 1);
+  auto sum_arg = TensorArg(sum, "sum", 2);
+  auto grad_arg = TensorArg(grad_, "grad", 3);
+  auto indices_arg = TensorArg(indices_, "indices", 4);
+  auto offsets_arg = TensorArg(offsets_, "offsets", 5);
+  const char* c = "embedding_bag_sparse_adagrad_";
+  checkDim(c, weight_arg, 2);
+  checkScalarType(c, weight_arg, kFloat);
+  checkContiguous(c, weight_arg);
+  checkScalarType(c, sum_arg, kFloat);
+  checkContiguous(c, sum_arg);
+  const bool rowwise = sum.dim() == 1;
+  if (rowwise) {
+    checkSize(c, sum_arg, 0, weight.size(0));
+  } else {
+    checkSameSize(c, sum_arg, weight_arg);
+  }
+  checkScalarType(c, indices_arg, kLong);
+  checkDim(c, indices_arg, 1);
+  checkScalarType(c, offsets_arg, kLong);
+  checkDim(c, offsets_arg, 1);
+  checkSameType(c, grad_arg, weight_arg);
+  checkDim(c, grad_arg, 2);
+  checkSize(c, grad_arg, 0, offsets_.size(0));
+  checkSize(c, grad_arg, 1, weight.size(1));
+  TORCH_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      "embedding_bag_sparse_adagrad_: only mode='sum' and mode='mean' are supported");
+
+  auto grad = grad_.contiguous();
+  auto indices = indices_.contiguous();
+  auto offsets = offsets_.contiguous();
+  Tensor per_sample_weights;
+  if (per_sample_weights_.defined()) {
+    TORCH_CHECK(mode == MODE_SUM,
+        "embedding_bag: per_sample_weights only supported with mode='sum'");
+    auto per_sample_weights_arg = TensorArg(
+        per_sample_weights_, "per_sample_weights", 7);
+    checkSameType(c, per_sample_weights_arg, weight_arg);
+    checkNumel(c, per_sample_weights_arg, indices.numel());
+    per_sample_weights = per_sample_weights_.contiguous();
+  }
+
+  const int64_t num_indices = indices.numel();
+  const int64_t num_bags = offsets.numel();
+  const int64_t num_weights = weight.size(0);
+  const int64_t ddim = weight.size(1);
+  if (num_indices == 0) {
+    return weight;
+  }
+  auto indices_data = indices.data<int64_t>();
+  auto offsets_data = offsets.data<int64_t>();
+  auto grad_data = grad.data<float>();
+  auto weight_data = weight.data<float>();
+  auto sum_data = sum.data<float>();
+  const float* per_sample_weights_data =
+      per_sample_weights.defined() ? per_sample_weights.data<float>() : nullptr;
+
+  // The bag of each index, and the positions of the indices grouped by row
+  std::vector<int64_t> bags(num_indices);
+  for (int64_t bag = 0; bag < num_bags; ++bag) {
+    const int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices;
+    for (int64_t i = offsets_data[bag]; i < end; ++i) {
+      bags[i] = bag;
+    }
+  }
+  std::vector<int64_t> order(num_indices);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return indices_data[a] < indices_data[b] ||
+        (indices_data[a] == indices_data[b] && a < b);
+  });
+  TORCH_CHECK(
+      indices_data[order.front()] >= 0 && indices_data[order.back()] < num_weights,
+      "embedding_bag_sparse_adagrad_: indices are out of range for ",
+      num_weights, " embeddings");
+  std::vector<int64_t> group_starts;
+  for (int64_t i = 0; i < num_indices; ++i) {
+    if (i == 0 || indices_data[order[i]] != indices_data[order[i - 1]]) {
+      group_starts.push_back(i);
+    }
+  }
+  const int64_t num_groups = group_starts.size();
+  group_starts.push_back(num_indices);
+
+  const float step = -lr;
+  const float epsilon = eps;
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, ddim));
+  parallel_for(0, num_groups, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<float> row_grad(ddim);
+    for (int64_t group = begin; group < end; ++group) {
+      const int64_t group_begin = group_starts[group];
+      const int64_t group_end = group_starts[group + 1];
+      const int64_t row = indices_data[order[group_begin]];
+      std::fill(row_grad.begin(), row_grad.end(), 0.f);
+      for (int64_t j = group_begin; j < group_end; ++j) {
+        const int64_t position = order[j];
+        const int64_t bag = bags[position];
+        float scale = 1;
+        if (per_sample_weights_data) {
+          scale = per_sample_weights_data[position];
+        }
+        if (scale_grad_by_freq) {
+          scale /= group_end - group_begin;
+        }
+        if (mode == MODE_MEAN) {
+          const int64_t bag_end =
+              bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices;
+          scale /= bag_end - offsets_data[bag];
+        }
+        THBlas_axpy<float>(ddim, scale, grad_data + bag * ddim, 1,
+                           row_grad.data(), 1);
+      }
+      float* weight_row = weight_data + row * ddim;
+      if (rowwise) {
+        caffe2::rowwise_adagrad_update(
+            ddim, weight_row, weight_row, row_grad.data(), sum_data + row,
+            sum_data + row, epsilon, step);
+      } else {
+        float* sum_row = sum_data + row * ddim;
+        caffe2::adagrad_update(
+            ddim, weight_row, row_grad.data(), sum_row, weight_row, sum_row,
+            epsilon, /*decay=*/1.0f, step);
+      }
+    }
+  });
+  return weight;
+}
 }
 } // namespace at::native
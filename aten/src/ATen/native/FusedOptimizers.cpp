@@ -0,0 +1,89 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/FusedOptimizers.h>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+// These update the tensors one at a time with the same ATen ops as the
+// optimizers of torch/optim. On CUDA, lists of contiguous tensors of the same
+// dtype are instead updated a chunk of many tensors per kernel (see
+// native/cuda/MultiTensorApply.cuh), and the others fall back to these.
+
+void _fused_adam_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    int64_t step) {
+  const bool amsgrad = !max_exp_avg_sqs.empty();
+  check_fused_list("_fused_adam_", params, grads, "grads");
+  check_fused_list("_fused_adam_", params, exp_avgs, "exp_avgs");
+  check_fused_list("_fused_adam_", params, exp_avg_sqs, "exp_avg_sqs");
+  if (amsgrad) {
+    check_fused_list("_fused_adam_", params, max_exp_avg_sqs, "max_exp_avg_sqs");
+  }
+  TORCH_CHECK(step > 0, "_fused_adam_: expected a positive step, but got ", step);
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr * std::sqrt(bias_correction2) / bias_correction1;
+
+  for (size_t i = 0; i < params.size(); i++) {
+    auto grad = grads[i];
+    if (weight_decay != 0) {
+      grad = grad + weight_decay * params[i];
+    }
+    exp_avgs[i].mul_(beta1).add_(grad, 1 - beta1);
+    exp_avg_sqs[i].mul_(beta2).addcmul_(grad, grad, 1 - beta2);
+    auto denom = exp_avg_sqs[i];
+    if (amsgrad) {
+      auto max_exp_avg_sq = max_exp_avg_sqs[i];
+      at::max_out(max_exp_avg_sq, max_exp_avg_sq, exp_avg_sqs[i]);
+      denom = max_exp_avg_sq;
+    }
+    params[i].addcdiv_(exp_avgs[i], denom.sqrt().add_(eps), -step_size);
+  }
+}
+
+void _fused_sgd_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov) {
+  const bool has_momentum = !momentum_buffers.empty();
+  check_fused_list("_fused_sgd_", params, grads, "grads");
+  if (has_momentum) {
+    check_fused_list("_fused_sgd_", params, momentum_buffers, "momentum_buffers");
+  }
+
+  for (size_t i = 0; i < params.size(); i++) {
+    auto update = grads[i];
+    if (weight_decay != 0) {
+      update = update + weight_decay * params[i];
+    }
+    if (has_momentum) {
+      momentum_buffers[i].mul_(momentum).add_(update, 1 - dampening);
+      if (nesterov) {
+        // See github.com/lisa-lab/pylearn2/pull/136#issuecomment-10381617
+        // for notes on this implementation of nesterov momentum.
+        update = update + momentum * momentum_buffers[i];
+      } else {
+        update = momentum_buffers[i];
+      }
+    }
+    params[i].add_(update, -lr);
+  }
+}
+
+}} // namespace at::native
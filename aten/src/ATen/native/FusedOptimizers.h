@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Checks that the state `list` of a fused optimizer step has a tensor of the
+// size of each one of `params`
+static inline void check_fused_list(const char* fn, TensorList params, TensorList list, const char* name) {
+  TORCH_CHECK(list.size() == params.size(),
+      fn, ": expected as many ", name, " as params (", params.size(), "), but got ", list.size());
+  for (size_t i = 0; i < params.size(); i++) {
+    TORCH_CHECK(list[i].sizes() == params[i].sizes(),
+        fn, ": expected ", name, "[", i, "] to have the sizes of params[", i, "] ",
+        params[i].sizes(), ", but got ", list[i].sizes());
+  }
+}
+
+}} // namespace at::native
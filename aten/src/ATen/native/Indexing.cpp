@@ -54,6 +54,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/LegacyTHFunctions.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/MemoryOverlap.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/native/TensorIterator.h>
 
 #include <algorithm>
@@ -65,6 +67,11 @@ namespace at { namespace native {
 
 DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
+DEFINE_DISPATCH(gather_stub);
+DEFINE_DISPATCH(scatter_stub);
+DEFINE_DISPATCH(scatter_fill_stub);
+DEFINE_DISPATCH(scatter_add_stub);
+DEFINE_DISPATCH(index_select_stub);
 
 [[noreturn]]
 static void invalid_mask(const Tensor & self, int64_t idx, const Tensor & mask, int64_t maskIdx) {
@@ -519,6 +526,132 @@ Tensor index_fill(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone().index_fill_(dim, index, source);
 }
 
+// Note [Native CPU scatter and gather]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// On CPU, gather, scatter_, scatter_add_ and index_select run natively for
+// the arguments TH accepts: a long index, with as many dimensions as `self`
+// (at most one for index_select) and fitting the other tensors apart from at
+// `dim`, and the dtypes TH implements. Everything else, including arguments
+// that are invalid, still goes to TH, so that the errors stay the same.
+//
+// gather and scatter visit the rows of `index` along `dim` in parallel. Two
+// rows never share an element of the output, since they differ outside of
+// `dim`, so that scatter_add_ is safe to parallelize too, unless the output
+// overlaps itself (those are left to TH). The rows are those of `index`, as
+// documented, whereas TH walked the rows of `self`.
+//
+// index_select copies whole slices of a contiguous `self` with memcpy, in
+// parallel over the slices of the result.
+
+static bool is_native_scatter_gather_type(ScalarType type) {
+  // the types TH has on CPU, and AT_DISPATCH_ALL_TYPES dispatches to
+  return isIntegralType(type) || type == ScalarType::Float || type == ScalarType::Double;
+}
+
+// Whether `index` can index `self` along `dim` natively, when it is no larger
+// than `self` in the other dimensions.
+static bool can_scatter_gather_cpu(const Tensor & self, int64_t dim, const Tensor & index) {
+  if (self.dim() == 0 || index.dim() != self.dim() || index.numel() == 0 ||
+      index.scalar_type() != ScalarType::Long || index.device().type() != kCPU ||
+      !is_native_scatter_gather_type(self.scalar_type())) {
+    return false;
+  }
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (d != dim && index.size(d) > self.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether `other` has the type of `self` and is at least as large as `index`
+static bool can_scatter_from_cpu(const Tensor & self, const Tensor & index, const Tensor & other) {
+  if (other.device().type() != kCPU || other.scalar_type() != self.scalar_type() ||
+      other.dim() != index.dim()) {
+    return false;
+  }
+  for (int64_t d = 0; d < index.dim(); d++) {
+    if (index.size(d) > other.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Tensor & gather_out_cpu(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  if (!can_scatter_gather_cpu(self, dim, index) || result.device().type() != kCPU ||
+      result.scalar_type() != self.scalar_type() ||
+      // TH wants the sizes to be the same apart from at `dim`
+      index.sizes().slice(0, dim) != self.sizes().slice(0, dim) ||
+      index.sizes().slice(dim + 1) != self.sizes().slice(dim + 1)) {
+    return at::legacy::th::_th_gather_out(result, self, dim, index);
+  }
+  result.resize_(index.sizes());
+  gather_stub(kCPU, result, self, dim, index);
+  return result;
+}
+
+Tensor gather_cpu(const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  Tensor result = at::empty({0}, self.options());
+  return gather_out_cpu(result, self, dim, index, sparse_grad);
+}
+
+Tensor & scatter_cpu_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  if (!can_scatter_gather_cpu(self, dim, index) || !can_scatter_from_cpu(self, index, src) ||
+      has_internal_overlap(self) == MemOverlap::YES) {
+    return at::legacy::th::_th_scatter_(self, dim, index, src);
+  }
+  scatter_stub(kCPU, self, dim, index, src);
+  return self;
+}
+
+Tensor & scatter_fill_cpu_(Tensor & self, int64_t dim, const Tensor & index, Scalar value) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  if (!can_scatter_gather_cpu(self, dim, index) || has_internal_overlap(self) == MemOverlap::YES) {
+    return at::legacy::th::_th_scatter_(self, dim, index, value);
+  }
+  scatter_fill_stub(kCPU, self, dim, index, value);
+  return self;
+}
+
+Tensor & scatter_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  if (!can_scatter_gather_cpu(self, dim, index) || !can_scatter_from_cpu(self, index, src) ||
+      has_internal_overlap(self) == MemOverlap::YES) {
+    return at::legacy::th::_th_scatter_add_(self, dim, index, src);
+  }
+  scatter_add_stub(kCPU, self, dim, index, src);
+  return self;
+}
+
+Tensor & index_select_out_cpu(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  if (self.dim() == 0 || !self.is_contiguous() || index.dim() > 1 ||
+      index.scalar_type() != ScalarType::Long || index.device().type() != kCPU ||
+      result.device().type() != kCPU || result.scalar_type() != self.scalar_type() ||
+      !is_native_scatter_gather_type(self.scalar_type())) {
+    return at::legacy::th::_th_index_select_out(result, self, dim, index);
+  }
+  auto result_sizes = self.sizes().vec();
+  result_sizes[dim] = index.numel();
+  result.resize_(result_sizes);
+  if (result.is_contiguous()) {
+    index_select_stub(kCPU, result, self, dim, index.contiguous());
+  } else {
+    Tensor contiguous_result = at::empty(result_sizes, self.options());
+    index_select_stub(kCPU, contiguous_result, self, dim, index.contiguous());
+    result.copy_(contiguous_result);
+  }
+  return result;
+}
+
+Tensor index_select_cpu(const Tensor & self, int64_t dim, const Tensor & index) {
+  Tensor result = at::empty({0}, self.options());
+  return index_select_out_cpu(result, self, dim, index);
+}
+
 Tensor scatter(const Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   return self.clone().scatter_(dim, index, source);
 }
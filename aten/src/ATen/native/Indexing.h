@@ -17,4 +17,16 @@ using index_put_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArr
 DECLARE_DISPATCH(index_fn, index_stub);
 DECLARE_DISPATCH(index_put_fn, index_put_stub);
 
+// See Note [Native CPU scatter and gather]
+using gather_fn = void(*)(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index);
+using scatter_fn = void(*)(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src);
+using scatter_fill_fn = void(*)(Tensor & self, int64_t dim, const Tensor & index, Scalar value);
+using index_select_fn = void(*)(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index);
+
+DECLARE_DISPATCH(gather_fn, gather_stub);
+DECLARE_DISPATCH(scatter_fn, scatter_stub);
+DECLARE_DISPATCH(scatter_fill_fn, scatter_fill_stub);
+DECLARE_DISPATCH(scatter_fn, scatter_add_stub);
+DECLARE_DISPATCH(index_select_fn, index_select_stub);
+
 }} // namespace at::native
@@ -56,6 +56,11 @@ Tensor& addmm_out(Tensor& result, const Tensor& self, const Tensor& mat1, const
     Tensor b_self;
     std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
     return s_native_addmm_out(result, b_self, mat1, mat2, beta, alpha);
+  } else if (mat1.scalar_type() == kBFloat16) {
+    // There is no BFloat16 BLAS, see at::native::mm
+    Tensor product = at::addmm(self.to(kFloat), mat1.to(kFloat), mat2.to(kFloat), beta, alpha);
+    result.resize_(product.sizes());
+    return result.copy_(product);
   } else {
     return legacy::th::_th_addmm_out(result, self, mat1, mat2, beta, alpha);
   }
@@ -68,6 +73,9 @@ Tensor addmm(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
     Tensor b_self;
     std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
     return s_native_addmm(b_self, mat1, mat2, beta, alpha);
+  } else if (mat1.scalar_type() == kBFloat16) {
+    // There is no BFloat16 BLAS, see at::native::mm
+    return at::addmm(self.to(kFloat), mat1.to(kFloat), mat2.to(kFloat), beta, alpha).to(kBFloat16);
   } else {
     return legacy::th::_th_addmm(self, mat1, mat2, beta, alpha);
   }
@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/LegacyTHFunctions.h>
+#include <ATen/InferSize.h>
+#include <TH/THTensor.hpp>
 
 #include <ATen/native/mkldnn/TensorShape.h>
 
@@ -32,10 +34,6 @@ bool is_set_to(const Tensor& self, const Tensor & tensor) {
   return at::legacy::th::_th_is_set_to(self, tensor);
 }
 
-Tensor clone(const Tensor& self) {
-  return legacy::th::_th_clone(self);
-}
-
 Tensor& resize_as_(Tensor& self, const Tensor& the_template) {
   return legacy::th::_th_resize_as_(self, the_template);
 }
@@ -49,6 +47,10 @@ Tensor pow(const Tensor& self, Scalar exponent) {
 }
 
 Tensor& zero_(Tensor& self) {
+  if (self.scalar_type() == kBFloat16) {
+    // TH has no BFloat16
+    return self.fill_(0);
+  }
   return legacy::th::_th_zero_(self);
 }
 
@@ -86,6 +88,15 @@ Tensor view(const Tensor& self, IntArrayRef size) {
   if (self.is_mkldnn()) {
     return mkldnn_view(self, size);
   }
+  if (self.is_quantized()) {
+    // TH doesn't know about quantized tensors, but a view is only strides
+    auto inferred_size = infer_size(size, self.numel());
+    auto stride = THTensor_compute_stride(self.sizes(), self.strides(), inferred_size);
+    TORCH_CHECK(stride.has_value(), "view size is "
+        "not compatible with input tensor's size and stride (at least one dimension"
+        " spans across two contiguous subspaces). Use .reshape(...) instead.");
+    return self.as_strided(inferred_size, *stride);
+  }
   return at::legacy::th::_th_view(self, size);
 }
 
@@ -105,15 +116,15 @@ Tensor & index_fill_(Tensor& self, int64_t dim, const Tensor & index, const Tens
   return at::legacy::th::_th_index_fill_(self, dim, index, value);
 }
 
-Tensor & scatter_(Tensor& self, int64_t dim, const Tensor & index, const Tensor & src) {
+Tensor & scatter_cuda_(Tensor& self, int64_t dim, const Tensor & index, const Tensor & src) {
   return at::legacy::th::_th_scatter_(self, dim, index, src);
 }
 
-Tensor & scatter_(Tensor& self, int64_t dim, const Tensor & index, Scalar value) {
+Tensor & scatter_fill_cuda_(Tensor& self, int64_t dim, const Tensor & index, Scalar value) {
   return at::legacy::th::_th_scatter_(self, dim, index, value);
 }
 
-Tensor & scatter_add_(Tensor& self, int64_t dim, const Tensor & index, const Tensor & src) {
+Tensor & scatter_add_cuda_(Tensor& self, int64_t dim, const Tensor & index, const Tensor & src) {
   return at::legacy::th::_th_scatter_add_(self, dim, index, src);
 }
 
@@ -249,11 +260,7 @@ Tensor & random_(Tensor& self, Generator * generator) {
   return at::legacy::th::_th_random_(self, generator);
 }
 
-Tensor & uniform_cpu_(Tensor& self, double from, double to, Generator * generator) {
-  return at::legacy::th::_th_uniform_(self, from, to, generator);
-}
-
-Tensor & normal_(Tensor& self, double mean, double std, Generator * generator) {
+Tensor & normal_cuda_(Tensor& self, double mean, double std, Generator * generator) {
   return at::legacy::th::_th_normal_(self, mean, std, generator);
 }
 
@@ -391,11 +398,11 @@ Tensor take(const Tensor & self, const Tensor & index) {
   return at::legacy::th::_th_take(self, index);
 }
 
-Tensor & index_select_out(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+Tensor & index_select_out_cuda(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
   return at::legacy::th::_th_index_select_out(result, self, dim, index);
 }
 
-Tensor index_select(const Tensor & self, int64_t dim, const Tensor & index) {
+Tensor index_select_cuda(const Tensor & self, int64_t dim, const Tensor & index) {
   return at::legacy::th::_th_index_select(self, dim, index);
 }
 
@@ -419,11 +426,11 @@ Tensor nonzero(const Tensor & self) {
   return at::legacy::th::_th_nonzero(self);
 }
 
-Tensor & gather_out(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+Tensor & gather_out_cuda(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
   return at::legacy::th::_th_gather_out(result, self, dim, index);
 }
 
-Tensor gather(const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+Tensor gather_cuda(const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
   return at::legacy::th::_th_gather(self, dim, index);
 }
 
@@ -531,19 +538,19 @@ Tensor lu_solve(const Tensor & self, const Tensor & LU_data, const Tensor & LU_p
   return at::legacy::th::_th_btrisolve(self, LU_data, LU_pivots);
 }
 
-std::tuple<Tensor,Tensor> _multinomial_alias_setup(const Tensor & probs) {
+std::tuple<Tensor,Tensor> _multinomial_alias_setup_cuda(const Tensor & probs) {
   return at::legacy::th::_th_multinomial_alias_setup(probs);
 }
 
-Tensor _multinomial_alias_draw(const Tensor & q, const Tensor & J, int64_t num_samples, Generator * generator) {
+Tensor _multinomial_alias_draw_cuda(const Tensor & q, const Tensor & J, int64_t num_samples, Generator * generator) {
   return at::legacy::th::_th_multinomial_alias_draw(q, J, num_samples, generator);
 }
 
-Tensor & multinomial_out(Tensor & result, const Tensor & self, int64_t num_samples, bool replacement, Generator * generator) {
+Tensor & multinomial_out_cuda(Tensor & result, const Tensor & self, int64_t num_samples, bool replacement, Generator * generator) {
   return at::legacy::th::_th_multinomial_out(result, self, num_samples, replacement, generator);
 }
 
-Tensor multinomial(const Tensor & self, int64_t num_samples, bool replacement, Generator * generator) {
+Tensor multinomial_cuda(const Tensor & self, int64_t num_samples, bool replacement, Generator * generator) {
   return at::legacy::th::_th_multinomial(self, num_samples, replacement, generator);
 }
 
@@ -590,14 +597,6 @@ Tensor atan2(const Tensor & self, const Tensor & other) {
   return at::legacy::th::_th_atan2(self, other);
 }
 
-Tensor & _histc_out_cpu(Tensor & result, const Tensor & self, int64_t bins, Scalar min, Scalar max) {
-  return at::legacy::th::_th_histc_out(result, self, bins, min, max);
-}
-
-Tensor _histc_cpu(const Tensor & self, int64_t bins, Scalar min, Scalar max) {
-  return at::legacy::th::_th_histc(self, bins, min, max);
-}
-
 Tensor & sign_out(Tensor & result, const Tensor & self) {
   return at::legacy::th::_th_sign_out(result, self);
 }
@@ -661,23 +660,19 @@ Tensor max(const Tensor & self) {
   return at::legacy::th::_th_max(self);
 }
 
-std::tuple<Tensor &,Tensor &> sort_out(Tensor & values, Tensor & indices, const Tensor & self, int64_t dim, bool descending) {
+std::tuple<Tensor &,Tensor &> sort_out_cuda(Tensor & values, Tensor & indices, const Tensor & self, int64_t dim, bool descending) {
   return at::legacy::th::_th_sort_out(values, indices, self, dim, descending);
 }
 
-std::tuple<Tensor,Tensor> sort(const Tensor & self, int64_t dim, bool descending) {
+std::tuple<Tensor,Tensor> sort_cuda(const Tensor & self, int64_t dim, bool descending) {
   return at::legacy::th::_th_sort(self, dim, descending);
 }
 
-Tensor argsort(const Tensor & self, int64_t dim, bool descending) {
-  return std::get<1>(at::legacy::th::_th_sort(self, dim, descending));
-}
-
-std::tuple<Tensor &,Tensor &> topk_out(Tensor & values, Tensor & indices, const Tensor & self, int64_t k, int64_t dim, bool largest, bool sorted) {
+std::tuple<Tensor &,Tensor &> topk_out_cuda(Tensor & values, Tensor & indices, const Tensor & self, int64_t k, int64_t dim, bool largest, bool sorted) {
   return at::legacy::th::_th_topk_out(values, indices, self, k, dim, largest, sorted);
 }
 
-std::tuple<Tensor,Tensor> topk(const Tensor & self, int64_t k, int64_t dim, bool largest, bool sorted) {
+std::tuple<Tensor,Tensor> topk_cuda(const Tensor & self, int64_t k, int64_t dim, bool largest, bool sorted) {
   return at::legacy::th::_th_topk(self, k, dim, largest, sorted);
 }
 
@@ -155,10 +155,19 @@ Tensor& ger_out(Tensor& result, const Tensor& self, const Tensor& vec2) {
   return at::legacy::th::_th_ger_out(result, self, vec2);
 }
 
+// There is no BFloat16 BLAS, so BFloat16 CPU matrix products are computed in
+// float and rounded once, which is what a bf16 GEMM accumulating in fp32 gives.
+static inline bool is_bfloat16_cpu(const Tensor& self) {
+  return self.scalar_type() == kBFloat16 && self.type().backend() == Backend::CPU;
+}
+
 Tensor mm(const Tensor& self, const Tensor& mat2) {
   if (self.is_sparse()) {
     return at::zeros({}, mat2.options()).addmm(self, mat2, 0, 1);
   }
+  if (is_bfloat16_cpu(self)) {
+    return at::mm(self.to(kFloat), mat2.to(kFloat)).to(kBFloat16);
+  }
   return at::legacy::th::_th_mm(self, mat2);
 }
 
@@ -166,6 +175,11 @@ Tensor& mm_out(Tensor& result, const Tensor& self, const Tensor& mat2) {
   if (self.is_sparse()) {
     return at::addmm_out(result, at::zeros({}, mat2.options()), self, mat2, 0, 1);
   }
+  if (is_bfloat16_cpu(self)) {
+    Tensor product = at::mm(self.to(kFloat), mat2.to(kFloat));
+    result.resize_(product.sizes());
+    return result.copy_(product);
+  }
   return at::legacy::th::_th_mm_out(result, self, mat2);
 }
 
@@ -212,6 +226,27 @@ Tensor& addr_out(Tensor &result, const Tensor& self, const Tensor& vec1, const T
   return at::legacy::th::_th_addr_out(result, self, vec1, vec2, beta, alpha);
 }
 
+// Adds s * row to the row of the result, for the inner loop of the kernel
+// below. The contiguous case is split out so that it's vectorized.
+template <typename scalar_t>
+inline void baddbmm_cpu_axpy(TensorAccessor<scalar_t, 1> r, TensorAccessor<scalar_t, 1> row, scalar_t s, int64_t js) {
+  if (r.stride(0) == 1 && row.stride(0) == 1) {
+    scalar_t* r_data = r.data();
+    const scalar_t* row_data = row.data();
+    for (int64_t j = 0; j < js; j++) {
+      r_data[j] += s * row_data[j];
+    }
+  } else {
+    for (int64_t j = 0; j < js; j++) {
+      r[j] += s * row[j];
+    }
+  }
+}
+
+// The kernel for small matrices: each thread multiplies whole matrices of the
+// batch, without calling BLAS or allocating anything. A row of the result is
+// accumulated from the rows of mat2, so the inner loop reads mat2 and writes
+// the result contiguously.
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
@@ -226,7 +261,7 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
   auto s0 = self.accessor<scalar_t, 3>();
   auto m0 = mat2.accessor<scalar_t, 3>();
 
-  int64_t grain_size = std::min(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+  int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
   parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t b = b_begin; b < b_end; b++) {
         auto r1 = r0[b];
@@ -236,19 +271,15 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
           auto r2 = r1[i];
           auto s2 = s1[i];
           for (int64_t j = 0; j < js; j++) {
-            scalar_t &r = r2[j];
             if (is_bmm) {
-              r = 0;
-              for (int64_t k = 0; k < ks; k++) {
-                r += s2[k] * m1[k][j];
-              }
+              r2[j] = 0;
             } else {
-              r *= beta;
-              for (int64_t k = 0; k < ks; k++) {
-                r += alpha * s2[k] * m1[k][j];
-              }
+              r2[j] *= beta;
             }
           }
+          for (int64_t k = 0; k < ks; k++) {
+            baddbmm_cpu_axpy<scalar_t>(r2, m1[k], is_bmm ? s2[k] : alpha * s2[k], js);
+          }
         }
       }
     });
@@ -258,6 +289,9 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 // - When the operand size is small, computation are parallelized over the batch
 //   dimension using OMP and naive matrix multiplication is applied.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
+// - Otherwise, the batch is still parallelized with the naive kernel while the
+//   matrices are up to 64x64x64, e.g. for the heads of attention layers, as one
+//   BLAS call per matrix costs more than the multiplication itself.
 // - Otherwise, we use a series of matrix multiplications.
 // The threshold of 400 for the first has not been thoroughly benchmarked yet and may have room for further
 // optimization, it likely depends on the characteristics of the CPU, MKL will be different from non-MKL etc.,
@@ -301,7 +335,13 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  const int64_t matrix_ops = contraction_size * res_rows * res_cols;
+  const bool use_mkl = at::hasMKL() && at::native::is_floating_point(self_or_result)
+            && batch_items_contiguous_or_transposed(batch1)
+            && batch_items_contiguous_or_transposed(batch2)
+            && self_or_result.is_contiguous();
+
+  if (matrix_ops < 400 || (!use_mkl && bs > 1 && matrix_ops <= 64 * 64 * 64)) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -311,10 +351,7 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
-            && batch_items_contiguous_or_transposed(batch1)
-            && batch_items_contiguous_or_transposed(batch2)
-            && self_or_result.is_contiguous()) {
+  } else if (use_mkl) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
   } else { // split along batch dimension
     if (is_bmm_out) {
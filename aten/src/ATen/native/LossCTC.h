@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// The alpha (forward) and beta/gradient (backward) recursions of the CPU CTC loss.
+// LossCTC.cpp checks the arguments, computes the offsets of the targets of every batch
+// item into targets and allocates the outputs; the kernels fill them.
+using ctc_loss_fn = void(*)(
+    const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+    const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK,
+    Tensor& neg_log_likelihood, Tensor& log_alpha);
+using ctc_loss_backward_fn = void(*)(
+    const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths,
+    IntArrayRef target_lengths, const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity, Tensor& grad);
+
+DECLARE_DISPATCH(ctc_loss_fn, ctc_loss_stub);
+DECLARE_DISPATCH(ctc_loss_backward_fn, ctc_loss_backward_stub);
+
+}} // namespace at::native
@@ -4,6 +4,8 @@
 #include <ATen/CPUApplyUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/Config.h>
+#include <ATen/native/ChannelsLast.h>
+#include <ATen/native/Normalization.h>
 
 #include <ATen/detail/CUDAHooksInterface.h>
 
@@ -125,6 +127,41 @@ void batch_norm_cpu_inference_contiguous(Tensor& output, const Tensor& input,
   }
 }
 
+/// Channels last inputs (see Note [Channels last on CPU]) are [n_row, n_channel]
+/// matrices in memory. Sums over the rows are computed for bands of channels in
+/// parallel, each walking over all of the rows, so that the inner loops run
+/// over contiguous channels, and no two threads add to the same sums.
+template<typename func_t>
+static void parallel_channel_bands(int64_t n_row, int64_t n_channel, const func_t& f) {
+  // bands of at least a cache line of floats
+  parallel_for(0, n_channel, 16, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t row = 0; row < n_row; ++row) {
+      f(row, c_begin, c_end);
+    }
+  });
+}
+
+/// output(row, c) = input(row, c) * alpha(c) + beta(c) for channels last
+/// input and output, see batch_norm_cpu_inference_contiguous.
+template<typename scalar_t>
+void batch_norm_cpu_transform_channels_last(Tensor& output, const Tensor& input,
+    const scalar_t* alpha_data, const scalar_t* beta_data) {
+  int64_t n_channel = input.size(1);
+  int64_t n_row = input.numel() / n_channel;
+  scalar_t* output_data = output.data<scalar_t>();
+  const scalar_t* input_data = input.data<scalar_t>();
+
+  parallel_for(0, n_row, std::max<int64_t>(internal::GRAIN_SIZE / n_channel, 1),
+      [&](int64_t r_begin, int64_t r_end) {
+    for (int64_t row = r_begin; row < r_end; ++row) {
+      for (int64_t c = 0; c < n_channel; ++c) {
+        int64_t offset = row * n_channel + c;
+        output_data[offset] = input_data[offset] * alpha_data[c] + beta_data[c];
+      }
+    }
+  });
+}
+
 template<typename scalar_t>
 std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& input, const Tensor& weight, const Tensor& bias,
@@ -132,6 +169,33 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
     bool train, double eps) {
 
+  if (is_channels_last(input)) {
+    Tensor output = empty_channels_last(input.sizes(), input.options());
+    int64_t n_input = input.size(1);
+    auto save_mean_a = conditional_accessor_1d<scalar_t>(save_mean);
+    auto save_invstd_a = conditional_accessor_1d<scalar_t>(save_invstd);
+    auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
+    auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
+
+    std::vector<scalar_t> alpha(n_input), beta(n_input);
+    for (int64_t f = 0; f < n_input; ++f) {
+      scalar_t mean, invstd;
+      if (train) {
+        mean = save_mean_a[f];
+        invstd = save_invstd_a[f];
+      } else {
+        mean = running_mean_a[f];
+        invstd = 1 / std::sqrt(running_var_a[f] + eps);
+      }
+      scalar_t w = weight.defined() ? weight.data<scalar_t>()[f * weight.stride(0)] : 1;
+      scalar_t b = bias.defined() ? bias.data<scalar_t>()[f * bias.stride(0)] : 0;
+      alpha[f] = invstd * w;
+      beta[f] = b - mean * invstd * w;
+    }
+    batch_norm_cpu_transform_channels_last<scalar_t>(output, input, alpha.data(), beta.data());
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
   Tensor output = at::empty_like(input);
 
   // Check if we should use the fast path.
@@ -196,6 +260,46 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  auto save_stats = [&](int64_t f, scalar_t mean, accscalar_t var_sum) {
+    save_mean_a[f] = mean;
+    save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum / n, eps);
+
+    // update running averages
+    if (running_mean.defined()) {
+      running_mean_a[f] = momentum * mean + (1 - momentum) * running_mean_a[f];
+    }
+    if (running_var.defined()) {
+      accscalar_t unbiased_var = var_sum / (n - 1);
+      running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
+    }
+  };
+
+  if (is_channels_last(input)) {
+    const scalar_t* input_data = input.data<scalar_t>();
+    std::vector<accscalar_t> sum(n_input, 0);
+    std::vector<accscalar_t> var_sum(n_input, 0);
+    std::vector<scalar_t> mean(n_input);
+    parallel_channel_bands(n, n_input, [&](int64_t row, int64_t c_begin, int64_t c_end) {
+      const scalar_t* x = input_data + row * n_input;
+      for (int64_t c = c_begin; c < c_end; ++c) {
+        sum[c] += x[c];
+      }
+    });
+    for (int64_t f = 0; f < n_input; ++f) {
+      mean[f] = sum[f] / n;
+    }
+    parallel_channel_bands(n, n_input, [&](int64_t row, int64_t c_begin, int64_t c_end) {
+      const scalar_t* x = input_data + row * n_input;
+      for (int64_t c = c_begin; c < c_end; ++c) {
+        var_sum[c] += (x[c] - mean[c]) * (x[c] - mean[c]);
+      }
+    });
+    for (int64_t f = 0; f < n_input; ++f) {
+      save_stats(f, mean[f], var_sum[f]);
+    }
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -206,23 +310,13 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
           sum += i;
         });
       scalar_t mean = sum / n;
-      save_mean_a[f] = mean;
 
       // compute variance per input
       accscalar_t var_sum = 0;
       CPU_tensor_apply1<scalar_t>(in, [&] (const scalar_t& i) {
         var_sum += (i - mean) * (i - mean);
       });
-      save_var_transform_a[f] = VarTransform<accscalar_t>{}(var_sum / n, eps);
-
-      // update running averages
-      if (running_mean.defined()) {
-        running_mean_a[f] = momentum * mean + (1 - momentum) * running_mean_a[f];
-      }
-      if (running_var.defined()) {
-        accscalar_t unbiased_var = var_sum / (n - 1);
-        running_var_a[f] = momentum * unbiased_var + (1 - momentum) * running_var_a[f];
-      }
+      save_stats(f, mean, var_sum);
     }
   });
   return std::make_tuple(save_mean, save_var_transform);
@@ -240,7 +334,9 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input);
+    grad_input = is_channels_last(input)
+        ? empty_channels_last(input.sizes(), input.options())
+        : at::empty_like(input);
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight);
@@ -262,6 +358,72 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (is_channels_last(input)) {
+    // the same as below, a band of channels at a time
+    Tensor grad_out = grad_out_.contiguous(MemoryFormat::ChannelsLast);
+    const scalar_t* input_data = input.data<scalar_t>();
+    const scalar_t* grad_out_data = grad_out.data<scalar_t>();
+    std::vector<scalar_t> mean(n_input), invstd(n_input), w(n_input);
+    for (int64_t f = 0; f < n_input; ++f) {
+      w[f] = weight.defined() ? weight_a[f] : 1;
+      if (train) {
+        mean[f] = save_mean_a[f];
+        invstd[f] = save_invstd_a[f];
+      } else {
+        mean[f] = running_mean_a[f];
+        invstd[f] = 1 / std::sqrt(running_var_a[f] + eps);
+      }
+    }
+
+    std::vector<accscalar_t> sum(n_input, 0);
+    std::vector<accscalar_t> dotp(n_input, 0);
+    parallel_channel_bands(n, n_input, [&](int64_t row, int64_t c_begin, int64_t c_end) {
+      const scalar_t* x = input_data + row * n_input;
+      const scalar_t* go = grad_out_data + row * n_input;
+      for (int64_t c = c_begin; c < c_end; ++c) {
+        sum[c] += go[c];
+        dotp[c] += (x[c] - mean[c]) * go[c];
+      }
+    });
+
+    if (grad_input_mask[0]) {
+      // grad_in(row, c) = go(row, c) * alpha(c) + x(row, c) * beta(c) + gamma(c)
+      std::vector<scalar_t> alpha(n_input), beta(n_input), gamma(n_input);
+      for (int64_t f = 0; f < n_input; ++f) {
+        if (train) {
+          scalar_t k = (scalar_t) dotp[f] * invstd[f] * invstd[f] / n;
+          scalar_t grad_mean = sum[f] / n;
+          alpha[f] = invstd[f] * w[f];
+          beta[f] = -k * invstd[f] * w[f];
+          gamma[f] = (mean[f] * k - grad_mean) * invstd[f] * w[f];
+        } else {
+          alpha[f] = invstd[f] * w[f];
+          beta[f] = 0;
+          gamma[f] = 0;
+        }
+      }
+      scalar_t* grad_input_data = grad_input.data<scalar_t>();
+      parallel_for(0, n, std::max<int64_t>(internal::GRAIN_SIZE / n_input, 1),
+          [&](int64_t r_begin, int64_t r_end) {
+        for (int64_t row = r_begin; row < r_end; ++row) {
+          for (int64_t c = 0; c < n_input; ++c) {
+            int64_t offset = row * n_input + c;
+            grad_input_data[offset] = grad_out_data[offset] * alpha[c] +
+                input_data[offset] * beta[c] + gamma[c];
+          }
+        }
+      });
+    }
+    for (int64_t f = 0; f < n_input; ++f) {
+      if (grad_input_mask[1]) {
+        grad_weight_a[f] = dotp[f] * invstd[f];
+      }
+      if (grad_input_mask[2]) {
+        grad_bias_a[f] = sum[f];
+      }
+    }
+    return std::make_tuple(grad_input, grad_weight, grad_bias);
+  }
 
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t f = b_begin; f < b_end; ++f) {
@@ -462,6 +624,148 @@ Tensor instance_norm(
   return out.view(input.sizes());
 }
 
+DEFINE_DISPATCH(layer_norm_stub);
+DEFINE_DISPATCH(layer_norm_backward_stub);
+DEFINE_DISPATCH(group_norm_stub);
+DEFINE_DISPATCH(group_norm_backward_stub);
+
+// Layer and group norm on CPU
+//
+// The composite layer_norm and group_norm make several passes and temporaries
+// on CPU: they normalize with batch_norm on a reshaped view, and apply the
+// affine parameters with a separate op. These functions call the kernels in
+// cpu/NormalizationKernel.cpp instead, which make two passes over each row.
+
+// Whether layer_norm and group_norm can use the CPU kernels
+static bool use_cpu_norm_kernel(const Tensor& input) {
+  return input.device().is_cpu() && input.layout() == c10::kStrided &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble);
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t M, int64_t N, double eps) {
+  auto X = input.contiguous();
+  auto Y = at::empty_like(X);
+  auto mean = at::empty({M}, X.options());
+  auto rstd = at::empty({M}, X.options());
+  if (M > 0) {
+    layer_norm_stub(kCPU, X, weight.defined() ? weight.contiguous() : weight,
+                    bias.defined() ? bias.contiguous() : bias, M, N, eps, Y, mean, rstd);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t M, int64_t N, std::array<bool, 3> output_mask) {
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::empty_like(input);
+  }
+  if (output_mask[1]) {
+    dgamma = at::empty({N}, input.options());
+  }
+  if (output_mask[2]) {
+    dbeta = at::empty({N}, input.options());
+  }
+  if (M > 0) {
+    layer_norm_backward_stub(kCPU, grad_out.contiguous(), input.contiguous(), mean, rstd,
+                             weight.defined() ? weight.contiguous() : weight, M, N,
+                             dX, dgamma, dbeta);
+  } else {
+    if (dgamma.defined()) dgamma.zero_();
+    if (dbeta.defined()) dbeta.zero_();
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_cpu(
+    const Tensor& input, const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps) {
+  auto X = input.contiguous();
+  auto Y = at::empty_like(X);
+  auto mean = at::empty({N, group}, X.options());
+  auto rstd = at::empty({N, group}, X.options());
+  if (N > 0 && C > 0) {
+    group_norm_stub(kCPU, X, weight.defined() ? weight.contiguous() : weight,
+                    bias.defined() ? bias.contiguous() : bias, N, C, HxW, group, eps,
+                    Y, mean, rstd);
+  }
+  return std::make_tuple(Y, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor> group_norm_backward_cpu(
+    const Tensor& grad_out, const Tensor& input, const Tensor& mean, const Tensor& rstd,
+    const Tensor& weight /* optional */, int64_t N, int64_t C, int64_t HxW, int64_t group,
+    std::array<bool, 3> output_mask) {
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    dX = at::empty_like(input);
+  }
+  if (output_mask[1]) {
+    dgamma = at::empty({C}, input.options());
+  }
+  if (output_mask[2]) {
+    dbeta = at::empty({C}, input.options());
+  }
+  if (N > 0 && C > 0) {
+    group_norm_backward_stub(kCPU, grad_out.contiguous(), input.contiguous(), mean, rstd,
+                             weight.defined() ? weight.contiguous() : weight, N, C, HxW, group,
+                             dX, dgamma, dbeta);
+  } else {
+    if (dgamma.defined()) dgamma.zero_();
+    if (dbeta.defined()) dbeta.zero_();
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
+// The backward of the CPU kernels with differentiable ops, for double
+// backward. The statistics are computed again from the input, so that the
+// gradient is differentiable with respect to it. The tensors are viewed as
+// [B, G, D, S], where the D * S elements of each of the B * G rows are
+// normalized together and the affine parameters are [G, D]: [M, 1, N, 1] for
+// layer norm, and [N, group, C / group, HxW] for group norm.
+static std::tuple<Tensor, Tensor, Tensor> norm_differentiable_backward(
+    const Tensor& grad_out, const Tensor& input, const Tensor& weight,
+    IntArrayRef view_shape, double eps, std::array<bool, 3> output_mask) {
+  auto dY = grad_out.reshape(view_shape);
+  auto X = input.reshape(view_shape);
+  auto centered = X - X.mean({2, 3}, true);
+  auto rstd = (centered.pow(2).mean({2, 3}, true) + eps).rsqrt();
+  auto x_hat = centered * rstd;
+
+  Tensor dX, dgamma, dbeta;
+  if (output_mask[0]) {
+    auto g = weight.defined()
+        ? dY * weight.view({1, view_shape[1], view_shape[2], 1})
+        : dY;
+    dX = rstd * (g - g.mean({2, 3}, true) - x_hat * (g * x_hat).mean({2, 3}, true));
+    dX = dX.view(input.sizes());
+  }
+  if (output_mask[1]) {
+    dgamma = (dY * x_hat).sum({0, 3}).view({-1});
+  }
+  if (output_mask[2]) {
+    dbeta = dY.sum({0, 3}).view({-1});
+  }
+  return std::make_tuple(dX, dgamma, dbeta);
+}
+
+std::tuple<Tensor, Tensor, Tensor> _layer_norm_differentiable_backward(
+    const Tensor& grad_out, const Tensor& input, const Tensor& weight /* optional */,
+    int64_t M, int64_t N, double eps, std::array<bool, 3> output_mask) {
+  return norm_differentiable_backward(grad_out, input, weight, {M, 1, N, 1}, eps, output_mask);
+}
+
+std::tuple<Tensor, Tensor, Tensor> _group_norm_differentiable_backward(
+    const Tensor& grad_out, const Tensor& input, const Tensor& weight /* optional */,
+    int64_t N, int64_t C, int64_t HxW, int64_t group, double eps,
+    std::array<bool, 3> output_mask) {
+  return norm_differentiable_backward(grad_out, input, weight,
+                                      {N, group, C / group, HxW}, eps, output_mask);
+}
+
 Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
     const Tensor& weight /* optional */, const Tensor& bias /* optional */,
     double eps, bool cudnn_enabled) {
@@ -502,6 +806,20 @@ Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
       n *= input_shape[i];
     }
 
+    if (use_cpu_norm_kernel(input)) {
+      // The parameters are flattened, so that their gradients are too
+      int64_t normalized_numel = 1;
+      for (auto size : normalized_shape) {
+        normalized_numel *= size;
+      }
+      auto out = std::get<0>(at::native_layer_norm(
+          input.contiguous(),
+          weight.defined() ? weight.reshape({-1}) : weight,
+          bias.defined() ? bias.reshape({-1}) : bias,
+          n, normalized_numel, eps));
+      return out.view(input_shape);
+    }
+
     // Apply layer norm
     auto input_reshaped = input.contiguous().view({1, n, -1});
 
@@ -542,6 +860,16 @@ Tensor group_norm(const Tensor& input, int64_t num_groups,
              "channels in input, but got bias of shape ", weight.sizes(),
              " and input of shape ", input.sizes());
 
+    if (use_cpu_norm_kernel(input)) {
+      int64_t HxW = 1;
+      for (int64_t i = 2; i < input.dim(); i++) {
+        HxW *= input_shape[i];
+      }
+      auto out = std::get<0>(at::native_group_norm(
+          input.contiguous(), weight, bias, b, c, HxW, num_groups, eps));
+      return out.view(input_shape);
+    }
+
     // Apply group norm
     auto input_reshaped = input.contiguous().view({1, b * num_groups, -1});
 
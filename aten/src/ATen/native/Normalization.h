@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Kernels of the CPU layer norm, see layer_norm_cpu. X and dY are contiguous
+// [M, N] matrices, normalized over their rows, and gamma and beta are
+// contiguous [N] vectors, which may be undefined. mean and rstd (the inverse
+// of the standard deviation) are [M]. The gradients that aren't needed are
+// undefined.
+using layer_norm_fn = void(*)(const Tensor& X, const Tensor& gamma, const Tensor& beta,
+                              int64_t M, int64_t N, double eps,
+                              Tensor& Y, Tensor& mean, Tensor& rstd);
+using layer_norm_backward_fn = void(*)(const Tensor& dY, const Tensor& X,
+                                       const Tensor& mean, const Tensor& rstd,
+                                       const Tensor& gamma, int64_t M, int64_t N,
+                                       Tensor& dX, Tensor& dgamma, Tensor& dbeta);
+
+// Kernels of the CPU group norm, see group_norm_cpu. X and dY are
+// contiguous [N, C, HxW] tensors, whose C channels are split in groups that
+// are normalized together, and gamma and beta are [C]. mean and rstd are
+// [N, group].
+using group_norm_fn = void(*)(const Tensor& X, const Tensor& gamma, const Tensor& beta,
+                              int64_t N, int64_t C, int64_t HxW, int64_t group, double eps,
+                              Tensor& Y, Tensor& mean, Tensor& rstd);
+using group_norm_backward_fn = void(*)(const Tensor& dY, const Tensor& X,
+                                       const Tensor& mean, const Tensor& rstd,
+                                       const Tensor& gamma, int64_t N, int64_t C,
+                                       int64_t HxW, int64_t group,
+                                       Tensor& dX, Tensor& dgamma, Tensor& dbeta);
+
+DECLARE_DISPATCH(layer_norm_fn, layer_norm_stub);
+DECLARE_DISPATCH(layer_norm_backward_fn, layer_norm_backward_stub);
+DECLARE_DISPATCH(group_norm_fn, group_norm_stub);
+DECLARE_DISPATCH(group_norm_backward_fn, group_norm_backward_stub);
+
+}} // namespace at::native
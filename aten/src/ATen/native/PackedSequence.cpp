@@ -180,4 +180,80 @@ std::tuple<Tensor, Tensor> _pad_packed_sequence(const Tensor& data, const Tensor
   return std::make_tuple(output, lengths_t);
 }
 
+// Calls `f(begin, end, batch_size)` on the maximal runs [begin, end) of time
+// steps that have the same batch size. The data of a run is a contiguous block
+// of (end - begin) * batch_size rows of the packed data.
+template <typename F>
+static void for_each_batch_size_run(const Tensor& batch_sizes_t, const F& f) {
+  int64_t * batch_sizes = batch_sizes_t.data<int64_t>();
+  int64_t max_seq_length = batch_sizes_t.size(0);
+  int64_t begin = 0;
+  while (begin < max_seq_length) {
+    int64_t end = begin + 1;
+    while (end < max_seq_length && batch_sizes[end] == batch_sizes[begin]) {
+      ++end;
+    }
+    f(begin, end, batch_sizes[begin]);
+    begin = end;
+  }
+}
+
+// Sums each sequence of a packed batch over time, without padding it first.
+// Returns a `[max_batch_size, *data.shape[1:]]` tensor whose rows are ordered
+// like the sequences of the packed batch (i.e. decreasingly by length).
+// See NOTE [ device and dtype of a PackedSequence ]
+Tensor _sum_packed_sequence(const Tensor& data, const Tensor& _batch_sizes) {
+  auto batch_sizes_t = _batch_sizes.contiguous();
+  checkLongTensor(batch_sizes_t);
+  TORCH_CHECK(batch_sizes_t.size(0) > 0, "Expected a non-empty `batch_sizes`");
+
+  std::vector<int64_t> output_size; // == [max_batch_size, *data.size()[1:]]
+  {
+    output_size.reserve(data.dim());
+    output_size.push_back(batch_sizes_t.data<int64_t>()[0]);
+    auto s_data_size = data.sizes().slice(1);
+    output_size.insert(output_size.end(), s_data_size.begin(), s_data_size.end());
+  }
+  auto output = at::zeros(output_size, data.options());
+
+  std::vector<int64_t> block_size = output_size; // == [-1, -1, *data.size()[1:]]
+  block_size.insert(block_size.begin(), -1);
+  int64_t data_offset = 0;
+  for_each_batch_size_run(batch_sizes_t, [&](int64_t begin, int64_t end, int64_t batch_size) {
+    // The lines below are equivalent to this:
+    // output[:batch_size] += data[data_offset:data_offset + l].view(end - begin, batch_size, *data.shape[1:]).sum(0)
+    int64_t l = (end - begin) * batch_size;
+    block_size[0] = end - begin;
+    block_size[1] = batch_size;
+    auto block = data.slice(0, data_offset, data_offset + l).view(block_size);
+    output.slice(0, 0, batch_size).add_(block.sum({0}, /*keepdim=*/false, data.scalar_type()));
+    data_offset += l;
+  });
+  TORCH_CHECK(data_offset == data.size(0),
+           "Expected the packed data to have ", data_offset, " rows, but got ", data.size(0));
+  return output;
+}
+
+// `grad` could be on arbitrary device and of arbitrary dtype, but `_batch_sizes`
+// is guaranteed to be a CPU int64 tensor.
+// See NOTE [ device and dtype of a PackedSequence ]
+Tensor _sum_packed_sequence_backward(const Tensor& grad, const Tensor& _batch_sizes) {
+  auto batch_sizes_t = _batch_sizes.contiguous();
+  checkLongTensor(batch_sizes_t);
+
+  std::vector<int64_t> block_size = grad.sizes().vec(); // == [-1, -1, *grad.size()[1:]]
+  block_size.insert(block_size.begin(), -1);
+  std::vector<int64_t> step_shape = block_size; // == [-1, *grad.size()[1:]]
+  step_shape.erase(step_shape.begin());
+  step_shape[0] = -1;
+
+  std::vector<Tensor> blocks;
+  for_each_batch_size_run(batch_sizes_t, [&](int64_t begin, int64_t end, int64_t batch_size) {
+    block_size[0] = end - begin;
+    block_size[1] = batch_size;
+    blocks.push_back(grad.slice(0, 0, batch_size).unsqueeze(0).expand(block_size).reshape(step_shape));
+  });
+  return at::cat(blocks);
+}
+
 }} // namespace at::native
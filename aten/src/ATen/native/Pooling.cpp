@@ -1,9 +1,17 @@
 #include <ATen/ATen.h>
 
+#include <ATen/LegacyTHFunctions.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/ChannelsLast.h>
+#include <ATen/native/Pooling.h>
+#include <ATen/quantized/Quantizer.h>
 #include <c10/util/Exception.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <tuple>
 
 namespace at { namespace native {
@@ -107,6 +115,14 @@ Tensor max_pool1d(
   return std::get<0>(output_and_indices);
 }
 
+static Tensor quantized_max_pool2d(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode);
+
 Tensor max_pool2d(
     const Tensor& self,
     IntArrayRef kernel_size,
@@ -118,11 +134,306 @@ Tensor max_pool2d(
     return at::mkldnn_max_pool2d(
         self, kernel_size, stride, padding, dilation, ceil_mode);
   }
+  if (self.is_quantized()) {
+    return quantized_max_pool2d(
+        self, kernel_size, stride, padding, dilation, ceil_mode);
+  }
   auto output_and_indices = at::max_pool2d_with_indices(
       self, kernel_size, stride, padding, dilation, ceil_mode);
   return std::get<0>(output_and_indices);
 }
 
+static int64_t pooling_output_shape(
+    int64_t input_size, int64_t kernel_size, int64_t pad, int64_t stride,
+    int64_t dilation, bool ceil_mode) {
+  // the same as THNN's pooling_output_shape
+  int64_t output_size = (input_size + 2 * pad - dilation * (kernel_size - 1) - 1 +
+      (ceil_mode ? stride - 1 : 0)) / stride + 1;
+  if (pad && (output_size - 1) * stride >= input_size + pad) {
+    // ensure that the last pooling starts inside the image
+    --output_size;
+  }
+  return output_size;
+}
+
+// Fills `p` for pooling the last `dims` dimensions of the (dims + 2)-d
+// `input`, returning false for invalid arguments
+static bool pooling_params(
+    const Tensor& input, int64_t dims, IntArrayRef kernel_size, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, bool ceil_mode, PoolingParams& p) {
+  if (stride.empty()) {
+    stride = kernel_size;
+  }
+  if (input.dim() != dims + 2 || kernel_size.size() != dims || stride.size() != dims ||
+      padding.size() != dims || dilation.size() != dims) {
+    return false;
+  }
+  // the depth of 2d pooling is 1
+  const bool pool3d = dims == 3;
+  p.nbatch = input.size(0);
+  p.channels = input.size(1);
+  p.input_depth = pool3d ? input.size(2) : 1;
+  p.input_height = input.size(-2);
+  p.input_width = input.size(-1);
+  p.kT = pool3d ? kernel_size[0] : 1;
+  p.kH = kernel_size[dims - 2];
+  p.kW = kernel_size[dims - 1];
+  p.dT = pool3d ? stride[0] : 1;
+  p.dH = stride[dims - 2];
+  p.dW = stride[dims - 1];
+  p.padT = pool3d ? padding[0] : 0;
+  p.padH = padding[dims - 2];
+  p.padW = padding[dims - 1];
+  p.dilationT = pool3d ? dilation[0] : 1;
+  p.dilationH = dilation[dims - 2];
+  p.dilationW = dilation[dims - 1];
+  if (p.kT <= 0 || p.kH <= 0 || p.kW <= 0 || p.dT <= 0 || p.dH <= 0 || p.dW <= 0 ||
+      p.dilationT <= 0 || p.dilationH <= 0 || p.dilationW <= 0 ||
+      p.padT < 0 || p.padH < 0 || p.padW < 0 ||
+      p.padT > p.kT / 2 || p.padH > p.kH / 2 || p.padW > p.kW / 2) {
+    return false;
+  }
+  p.output_depth = pooling_output_shape(p.input_depth, p.kT, p.padT, p.dT, p.dilationT, ceil_mode);
+  p.output_height = pooling_output_shape(p.input_height, p.kH, p.padH, p.dH, p.dilationH, ceil_mode);
+  p.output_width = pooling_output_shape(p.input_width, p.kW, p.padW, p.dW, p.dilationW, ceil_mode);
+  return p.output_depth >= 1 && p.output_height >= 1 && p.output_width >= 1;
+}
+
+static bool pool2d_params(
+    const Tensor& input, IntArrayRef kernel_size, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, bool ceil_mode, PoolingParams& p) {
+  return pooling_params(input, 2, kernel_size, stride, padding, dilation, ceil_mode, p);
+}
+
+// Whether the ATen kernels (see ATen/native/Pooling.h) apply to a batched
+// input. Anything they don't, including invalid arguments, goes to THNN,
+// which reports the errors.
+static bool use_native_pooling(
+    const Tensor& input, int64_t dims, IntArrayRef kernel_size, IntArrayRef stride,
+    IntArrayRef padding, IntArrayRef dilation, bool ceil_mode, PoolingParams& p) {
+  return input.numel() > 0 &&
+      (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+      pooling_params(input, dims, kernel_size, stride, padding, dilation, ceil_mode, p);
+}
+
+// Calls `f(n, oh, ow)` on the output pixels in parallel
+template <typename func_t>
+static void parallel_output_pixels(const PoolingParams& p, const func_t& f) {
+  const int64_t work_per_pixel = std::max<int64_t>(p.channels * p.kH * p.kW, 1);
+  parallel_for(
+      0,
+      p.nbatch * p.output_height * p.output_width,
+      std::max<int64_t>(internal::GRAIN_SIZE / work_per_pixel, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const int64_t ow = i % p.output_width;
+          const int64_t oh = i / p.output_width % p.output_height;
+          const int64_t n = i / p.output_width / p.output_height;
+          f(n, oh, ow);
+        }
+      });
+}
+
+template <typename scalar_t>
+static void max_pool2d_backward_channels_last(
+    const PoolingParams& p, const Tensor& grad_output, const Tensor& indices, Tensor& grad_input) {
+  const int64_t C = p.channels;
+  const int64_t output_image_size = p.output_height * p.output_width;
+  const int64_t input_image_size = p.input_height * p.input_width;
+  const scalar_t* grad_output_data = grad_output.data<scalar_t>();
+  const int64_t* indices_data = indices.data<int64_t>();
+  scalar_t* grad_input_data = grad_input.data<scalar_t>();
+  // overlapping windows add to the same elements, but only within an image
+  parallel_for(0, p.nbatch, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t n = begin; n < end; n++) {
+      const scalar_t* go = grad_output_data + n * output_image_size * C;
+      const int64_t* ind = indices_data + n * output_image_size * C;
+      scalar_t* gi = grad_input_data + n * input_image_size * C;
+      for (int64_t i = 0; i < output_image_size * C; i++) {
+        const int64_t index = ind[i];
+        if (index != -1) {
+          gi[index * C + i % C] += go[i];
+        }
+      }
+    }
+  });
+}
+
+// The maximum of quantized values dequantizes to the maximum of their float
+// values, so quantized tensors pool their integer values, and keep their
+// quantizer. The pooling runs in NHWC, like the channels last kernels, and
+// returns NCHW outputs for NCHW inputs.
+static Tensor quantized_max_pool2d(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  PoolingParams p;
+  TORCH_CHECK(
+      pool2d_params(self, kernel_size, stride, padding, dilation, ceil_mode, p),
+      "quantized max_pool2d expects a 4-d input, 2 positive values for the kernel size, "
+      "stride and dilation, padding of at most half the kernel size, and a non-empty output");
+  auto quantizer = get_qtensorimpl(self)->quantizer();
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      "quantized max_pool2d only supports per tensor affine quantized tensors");
+  const Tensor input = self.contiguous(MemoryFormat::ChannelsLast);
+  Tensor output = new_qtensor_cpu(
+      {p.nbatch, p.output_height, p.output_width, p.channels}, self.options(), quantizer)
+      .permute({0, 3, 1, 2});
+  const int64_t C = p.channels;
+  AT_DISPATCH_QINT_TYPES(self.scalar_type(), "quantized_max_pool2d", [&] {
+    using underlying_t = typename scalar_t::underlying;
+    const underlying_t* input_data = reinterpret_cast<const underlying_t*>(input.data<scalar_t>());
+    underlying_t* output_data = reinterpret_cast<underlying_t*>(output.data<scalar_t>());
+    parallel_output_pixels(p, [&](int64_t n, int64_t oh, int64_t ow) {
+      int64_t hstart = oh * p.dH - p.padH;
+      int64_t wstart = ow * p.dW - p.padW;
+      const int64_t hend = std::min(hstart + (p.kH - 1) * p.dilationH + 1, p.input_height);
+      const int64_t wend = std::min(wstart + (p.kW - 1) * p.dilationW + 1, p.input_width);
+      while (hstart < 0) {
+        hstart += p.dilationH;
+      }
+      while (wstart < 0) {
+        wstart += p.dilationW;
+      }
+      underlying_t* out = output_data + ((n * p.output_height + oh) * p.output_width + ow) * C;
+      std::fill(out, out + C, std::numeric_limits<underlying_t>::lowest());
+      for (int64_t y = hstart; y < hend; y += p.dilationH) {
+        for (int64_t x = wstart; x < wend; x += p.dilationW) {
+          const underlying_t* in = input_data + ((n * p.input_height + y) * p.input_width + x) * C;
+          for (int64_t c = 0; c < C; c++) {
+            out[c] = std::max(out[c], in[c]);
+          }
+        }
+      }
+    });
+  });
+  return is_channels_last(self) ? output : output.contiguous();
+}
+
+DEFINE_DISPATCH(max_pool_stub);
+DEFINE_DISPATCH(avg_pool2d_stub);
+
+// Channels last inputs keep their layout, others are made contiguous
+static Tensor pooling_input(const Tensor& self) {
+  return is_channels_last(self) ? self : self.contiguous();
+}
+
+static Tensor pooling_output(const PoolingParams& p, const Tensor& input, const TensorOptions& options) {
+  if (input.dim() == 5) {
+    return at::empty({p.nbatch, p.channels, p.output_depth, p.output_height, p.output_width}, options);
+  }
+  const std::vector<int64_t> sizes = {p.nbatch, p.channels, p.output_height, p.output_width};
+  return is_channels_last(input) ? empty_channels_last(sizes, options) : at::empty(sizes, options);
+}
+
+std::tuple<Tensor, Tensor> max_pool2d_with_indices_cpu(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  if (self.dim() == 3) {
+    Tensor output, indices;
+    std::tie(output, indices) = max_pool2d_with_indices_cpu(
+        self.unsqueeze(0), kernel_size, stride, padding, dilation, ceil_mode);
+    return std::make_tuple(output.squeeze(0), indices.squeeze(0));
+  }
+  PoolingParams p;
+  if (!use_native_pooling(self, 2, kernel_size, stride, padding, dilation, ceil_mode, p)) {
+    return at::legacy::th::_thnn_max_pool2d_with_indices_forward(
+        self, kernel_size, stride, padding, dilation, ceil_mode);
+  }
+  const Tensor input = pooling_input(self);
+  Tensor output = pooling_output(p, input, self.options());
+  Tensor indices = pooling_output(p, input, self.options().dtype(kLong));
+  max_pool_stub(kCPU, p, input, output, indices);
+  return std::make_tuple(output, indices);
+}
+
+Tensor max_pool2d_with_indices_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode,
+    const Tensor& indices) {
+  PoolingParams p;
+  if (!is_channels_last(self) ||
+      !use_native_pooling(self, 2, kernel_size, stride, padding, dilation, ceil_mode, p) ||
+      grad_output.sizes() != IntArrayRef{p.nbatch, p.channels, p.output_height, p.output_width} ||
+      indices.sizes() != grad_output.sizes() || indices.scalar_type() != kLong ||
+      grad_output.scalar_type() != self.scalar_type()) {
+    // THNN only reads contiguous indices
+    return at::legacy::th::_thnn_max_pool2d_with_indices_backward(
+        grad_output, self, kernel_size, stride, padding, dilation, ceil_mode,
+        indices.contiguous());
+  }
+  Tensor grad_input = empty_channels_last(self.sizes(), self.options()).zero_();
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "max_pool2d_with_indices_backward_cpu", [&] {
+    max_pool2d_backward_channels_last<scalar_t>(
+        p,
+        grad_output.contiguous(MemoryFormat::ChannelsLast),
+        indices.contiguous(MemoryFormat::ChannelsLast),
+        grad_input);
+  });
+  return grad_input;
+}
+
+Tensor avg_pool2d_cpu(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    bool ceil_mode,
+    bool count_include_pad) {
+  if (self.dim() == 3) {
+    return avg_pool2d_cpu(
+        self.unsqueeze(0), kernel_size, stride, padding, ceil_mode, count_include_pad)
+        .squeeze(0);
+  }
+  PoolingParams p;
+  if (!use_native_pooling(self, 2, kernel_size, stride, padding, {1, 1}, ceil_mode, p)) {
+    return at::legacy::th::_thnn_avg_pool2d_forward(
+        self, kernel_size, stride, padding, ceil_mode, count_include_pad);
+  }
+  const Tensor input = pooling_input(self);
+  Tensor output = pooling_output(p, input, self.options());
+  avg_pool2d_stub(kCPU, p, input, output, count_include_pad);
+  return output;
+}
+
+std::tuple<Tensor, Tensor> max_pool3d_with_indices_cpu(
+    const Tensor& self,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool ceil_mode) {
+  if (self.dim() == 4) {
+    Tensor output, indices;
+    std::tie(output, indices) = max_pool3d_with_indices_cpu(
+        self.unsqueeze(0), kernel_size, stride, padding, dilation, ceil_mode);
+    return std::make_tuple(output.squeeze(0), indices.squeeze(0));
+  }
+  PoolingParams p;
+  if (!use_native_pooling(self, 3, kernel_size, stride, padding, dilation, ceil_mode, p)) {
+    return at::legacy::th::_thnn_max_pool3d_with_indices_forward(
+        self, kernel_size, stride, padding, dilation, ceil_mode);
+  }
+  const Tensor input = self.contiguous();
+  Tensor output = pooling_output(p, input, self.options());
+  Tensor indices = pooling_output(p, input, self.options().dtype(kLong));
+  max_pool_stub(kCPU, p, input, output, indices);
+  return std::make_tuple(output, indices);
+}
+
 Tensor max_pool3d(
     const Tensor& self,
     IntArrayRef kernel_size,
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The shape of a max or average pooling over the 2 or 3 spatial dimensions of
+// a batch. A 2d pooling has a depth of 1, with kT = dT = dilationT = 1 and
+// padT = 0, so that NCHW inputs are NC1HW ones.
+struct PoolingParams {
+  int64_t nbatch, channels;
+  int64_t input_depth, input_height, input_width;
+  int64_t output_depth, output_height, output_width;
+  int64_t kT, kH, kW, dT, dH, dW, padT, padH, padW, dilationT, dilationH, dilationW;
+};
+
+// Both kernels take a contiguous float or double input, or a channels last
+// one for 2d pooling (see Note [Channels last on CPU]), and fill outputs of
+// the same layout. They compute the same values as the THNN kernels, with the
+// same index of the maximum in each window: the offset of the element in its
+// (depth x) height x width image, or -1 for a window of -inf.
+using max_pool_fn = void(*)(const PoolingParams& p, const Tensor& input, Tensor& output, Tensor& indices);
+using avg_pool2d_fn = void(*)(const PoolingParams& p, const Tensor& input, Tensor& output, bool count_include_pad);
+
+DECLARE_DISPATCH(max_pool_fn, max_pool_stub);
+DECLARE_DISPATCH(avg_pool2d_fn, avg_pool2d_stub);
+
+}} // namespace at::native
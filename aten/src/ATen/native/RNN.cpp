@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
 
 namespace at { namespace native {
 
@@ -57,6 +58,37 @@ struct CellParams {
   }
 };
 
+// CellParams whose weights and biases are MKLDNN tensors, as converted by
+// torch.utils.mkldnn.to_mkldnn. The weights are converted once, with the
+// module, and the linear layers run as MKLDNN inner products. The inputs and
+// the hidden states stay dense, so the pointwise math of the cells is the same.
+struct MkldnnCellParams : public CellParams {
+  using CellParams::CellParams;
+
+  Tensor matmul_ih(Tensor input) const {
+    TORCH_CHECK(false, "matmul is not supported with MKLDNN cell params");
+  }
+  Tensor matmul_hh(Tensor h) const {
+    TORCH_CHECK(false, "matmul is not supported with MKLDNN cell params");
+  }
+  Tensor linear_ih(Tensor input) const {
+    return linear(input, w_ih, b_ih);
+  }
+  Tensor linear_hh(Tensor h) const {
+    return linear(h, w_hh, b_hh);
+  }
+
+ private:
+  // mkldnn_linear only takes 2-d inputs, so the steps of a pre-computed input
+  // are flattened into the batch.
+  static Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+    auto output_sizes = input.sizes().vec();
+    output_sizes.back() = weight.size(0);
+    auto input_2d = input.reshape({-1, input.size(-1)});
+    return at::mkldnn_linear(input_2d.to_mkldnn(), weight, bias).to_dense().view(output_sizes);
+  }
+};
+
 // Run this Python script and pipe to clang-format to generate the constructor
 // and data members:
 //
@@ -129,6 +161,19 @@ struct QuantizedCellParams {
   }
 };
 
+// Whether the layers may apply linear_ih to the inputs of all steps at once,
+// and pass the result to the cells with pre_compute_input set. That's a single
+// large GEMM instead of one per step. Quantized cells quantize their inputs
+// dynamically, with the range of each step, so batching the steps would
+// change their results. The CUDA cells do their own matmuls, see LSTMCell.
+bool can_pre_compute_input(const CellParams&) { return true; }
+bool can_pre_compute_input(const QuantizedCellParams&) { return false; }
+
+template<typename cell_params>
+bool should_pre_compute_input(const Tensor& input, const cell_params& params) {
+  return input.device().is_cpu() && can_pre_compute_input(params);
+}
+
 // Gathers every two elements of a vector in a vector of pairs
 template<typename T>
 static std::vector<pair_of<T>> pair_vec(const std::vector<T>& vals) {
@@ -154,9 +199,10 @@ static std::vector<T> unpair_vec(std::vector<pair_of<T>>&& vals) {
 }
 
 // Parses a flat list of parameter tensors into a list of CellParams
-static std::vector<CellParams> gather_params(TensorList params, bool has_biases) {
+template<typename cell_params = CellParams>
+static std::vector<cell_params> gather_params(TensorList params, bool has_biases) {
   static at::Tensor undefined;
-  std::vector<CellParams> result;
+  std::vector<cell_params> result;
   if (has_biases) {
     TORCH_CHECK(params.size() % 4 == 0, "got an incorrect number of RNN parameters");
     for (size_t i = 0; i < params.size(); i += 4) {
@@ -171,6 +217,20 @@ static std::vector<CellParams> gather_params(TensorList params, bool has_biases)
   return result;
 }
 
+// Whether the RNN should run with MkldnnCellParams, i.e. whether its weights
+// are MKLDNN tensors. The weights can't be mixed, and the MKLDNN RNNs take
+// dense float inputs and hidden states.
+static bool use_mkldnn(const Tensor& input, TensorList params) {
+  if (params.empty() || !params[0].is_mkldnn()) {
+    return false;
+  }
+  TORCH_CHECK(std::all_of(params.begin(), params.end(), [](const Tensor& t) { return t.is_mkldnn(); }),
+              "RNN parameters must be either all dense or all MKLDNN tensors");
+  TORCH_CHECK(!input.is_mkldnn() && input.device().is_cpu() && input.scalar_type() == kFloat,
+              "RNN with MKLDNN parameters expects a dense float CPU input, but got ", input.type());
+  return true;
+}
+
 static std::vector<QuantizedCellParams> gather_quantized_params(TensorList params) {
   static at::Tensor undefined;
   std::vector<QuantizedCellParams> result;
@@ -231,32 +291,53 @@ tpair_of<Tensor> hidden_slice(const tpair_of<Tensor>& t, int64_t start, int64_t
 // which means that it consumes an input tensor, and updates the previous hidden state.
 // It's a struct only because functional programming in C++ is a pain, and it's easier
 // to pass around "vtable pointers" than actual function pointers.
+//
+// If pre_compute_input is set, input already is params.linear_ih(input) (see
+// can_pre_compute_input).
 
 template<typename hidden_type_tmpl, typename cell_params_tmpl>
 struct Cell {
   using hidden_type = hidden_type_tmpl;
   using cell_params = cell_params_tmpl;
   virtual ~Cell() {} // This is really dumb, but enables projects with -Wnon-virtual-dtor to compile...
-  virtual hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const = 0;
+  virtual hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                                 bool pre_compute_input = false) const = 0;
 };
 
 template<typename nonlinearity, typename cell_params>
 struct SimpleCell : Cell<Tensor, cell_params> {
   using hidden_type = Tensor;
-  Tensor operator()(const Tensor& input, const Tensor& hidden, const cell_params& params) const override {
-    return nonlinearity{}(params.linear_ih(input) + params.linear_hh(hidden));
+  Tensor operator()(const Tensor& input, const Tensor& hidden, const cell_params& params,
+                    bool pre_compute_input = false) const override {
+    auto igates = pre_compute_input ? input : params.linear_ih(input);
+    return nonlinearity{}(igates + params.linear_hh(hidden));
   }
 };
 
+// The CPU cells use the fused kernels only when no graph is recorded, e.g. in
+// inference or for quantized cells. Their backward isn't differentiable, so
+// using them for training would break double backward, which the unfused
+// cells support.
+static bool use_fused_cpu_cell(TensorList tensors) {
+  return std::all_of(tensors.begin(), tensors.end(), [](const Tensor& t) {
+    return !t.defined() ||
+        (t.device().is_cpu() && !t.is_sparse() &&
+         (t.scalar_type() == kFloat || t.scalar_type() == kDouble) &&
+         !(t.is_variable() && t.requires_grad()));
+  });
+}
+
 // TODO: can use inplace ops?
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
   using hidden_type = std::tuple<Tensor, Tensor>;
-  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const override {
+  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                         bool pre_compute_input = false) const override {
     auto hx = std::get<0>(hidden);
     auto cx = std::get<1>(hidden);
 
     if (input.is_cuda()) {
+      TORCH_INTERNAL_ASSERT(!pre_compute_input);
       auto igates = params.matmul_ih(input);
       auto hgates = params.matmul_hh(hx);
       auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx, params.b_ih, params.b_hh);
@@ -264,7 +345,15 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::get<0>(result), std::get<1>(result));
     }
 
-    auto gates = params.linear_ih(input) + params.linear_hh(hx);
+    auto igates = pre_compute_input ? input : params.linear_ih(input);
+    auto hgates = params.linear_hh(hx);
+    if (use_fused_cpu_cell({igates, hgates, cx})) {
+      // The biases are already added by the linear layers
+      auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx);
+      return std::make_tuple(std::get<0>(result), std::get<1>(result));
+    }
+
+    auto gates = igates + hgates;
     auto chunked_gates = gates.chunk(4, 1);
 
     auto ingate = chunked_gates[0].sigmoid();
@@ -282,8 +371,10 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
 template <typename cell_params>
 struct GRUCell : Cell<Tensor, cell_params> {
   using hidden_type = Tensor;
-  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const override {
+  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                         bool pre_compute_input = false) const override {
     if (input.is_cuda()) {
+      TORCH_INTERNAL_ASSERT(!pre_compute_input);
       auto igates = params.matmul_ih(input);
       auto hgates = params.matmul_hh(hidden);
       auto result = at::_thnn_fused_gru_cell(igates, hgates, hidden, params.b_ih, params.b_hh);
@@ -291,8 +382,13 @@ struct GRUCell : Cell<Tensor, cell_params> {
       return std::get<0>(result);
     }
 
-    auto igates = params.linear_ih(input);
+    auto igates = pre_compute_input ? input : params.linear_ih(input);
     auto hgates = params.linear_hh(hidden);
+    if (use_fused_cpu_cell({igates, hgates, hidden})) {
+      // The biases are already added by the linear layers
+      return std::get<0>(at::_thnn_fused_gru_cell(igates, hgates, hidden));
+    }
+
     auto chunked_igates = igates.chunk(3, 1);
     auto chunked_hgates = hgates.chunk(3, 1);
 
@@ -336,18 +432,21 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
   FullLayer(Cell<hidden_type, cell_params>& cell)
     : cell_(cell) {};
 
-  unstacked_output_type operator()(std::vector<Tensor> step_inputs, const hidden_type& input_hidden, const cell_params& params) const {
+  unstacked_output_type operator()(std::vector<Tensor> step_inputs, const hidden_type& input_hidden, const cell_params& params,
+                                   bool pre_compute_input = false) const {
     std::vector<Tensor> step_outputs;
     auto hidden = input_hidden;
     for (size_t i = 0; i < step_inputs.size(); i++) {
-      hidden = cell_(step_inputs[i], hidden, params);
+      hidden = cell_(step_inputs[i], hidden, params, pre_compute_input);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     return {step_outputs, hidden};
   }
 
   output_type operator()(const Tensor& inputs, const hidden_type& input_hidden, const cell_params& params) const override {
-    auto unstacked_output = (*this)(inputs.unbind(0), input_hidden, params);
+    auto unstacked_output = should_pre_compute_input(inputs, params)
+        ? (*this)(params.linear_ih(inputs).unbind(0), input_hidden, params, /*pre_compute_input=*/true)
+        : (*this)(inputs.unbind(0), input_hidden, params);
     return {at::stack(unstacked_output.outputs, 0), unstacked_output.final_hidden};
   }
 
@@ -364,12 +463,14 @@ struct FullBidirectionalLayer : Layer<Tensor, pair_of<dir_hidden_type>, pair_of<
     : layer_(cell) {};
 
   output_type operator()(const Tensor& input, const hidden_type& input_hidden, const param_type& params) const override {
-    auto step_inputs = input.unbind(0);
-    auto fw_result = layer_(step_inputs, input_hidden.first, params.first);
+    const bool pre_computed = should_pre_compute_input(input, params.first);
+    auto step_inputs = pre_computed ? params.first.linear_ih(input).unbind(0) : input.unbind(0);
+    auto fw_result = layer_(step_inputs, input_hidden.first, params.first, pre_computed);
     auto fw_output = at::stack(fw_result.outputs, 0);
 
-    auto rev_step_inputs = reverse(std::move(step_inputs));
-    auto rev_result = layer_(rev_step_inputs, input_hidden.second, params.second);
+    auto rev_step_inputs = reverse(pre_computed ? params.second.linear_ih(input).unbind(0)
+                                                : std::move(step_inputs));
+    auto rev_result = layer_(rev_step_inputs, input_hidden.second, params.second, pre_computed);
     std::reverse(rev_result.outputs.begin(), rev_result.outputs.end());
     auto rev_output = at::stack(rev_result.outputs, 0);
 
@@ -399,6 +500,8 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     int64_t num_steps = input.batch_sizes.size(0);
     int64_t* batch_sizes = input.batch_sizes.data<int64_t>();
     int64_t last_batch_size = batch_sizes[0];
+    const bool pre_computed = should_pre_compute_input(input.data, params);
+    const auto inputs = pre_computed ? params.linear_ih(input.data) : input.data;
 
     // Batch sizes is a sequence of decreasing lengths, which are offsets
     // into a 1D list of inputs. At every step we slice out batch_size elements,
@@ -409,7 +512,7 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     auto hidden = input_hidden;
     for (int64_t i = 0; i < num_steps; ++i) {
       int64_t batch_size = batch_sizes[i];
-      auto step_input = input.data.narrow(0, input_offset, batch_size);
+      auto step_input = inputs.narrow(0, input_offset, batch_size);
       input_offset += batch_size;
 
       int64_t dec = last_batch_size - batch_size;
@@ -419,7 +522,7 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
       }
 
       last_batch_size = batch_size;
-      hidden = cell_(step_input, hidden, params);
+      hidden = cell_(step_input, hidden, params, pre_computed);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     hiddens.push_back(hidden);
@@ -444,6 +547,8 @@ struct ReversedPackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     int64_t num_steps = input.batch_sizes.size(0);
     int64_t* batch_sizes = input.batch_sizes.data<int64_t>();
     int64_t last_batch_size = batch_sizes[num_steps - 1];
+    const bool pre_computed = should_pre_compute_input(input.data, params);
+    const auto inputs = pre_computed ? params.linear_ih(input.data) : input.data;
 
     // Here the situation is similar to that above, except we start out with
     // the smallest batch size (and a small set of hidden states we actually use),
@@ -457,11 +562,11 @@ struct ReversedPackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
         hidden = hidden_concat(ArrayRef<hidden_type>{hidden, hidden_slice(input_hidden, last_batch_size, batch_size)});
       }
 
-      auto step_input = input.data.narrow(0, input_offset - batch_size, batch_size);
+      auto step_input = inputs.narrow(0, input_offset - batch_size, batch_size);
       input_offset -= batch_size;
 
       last_batch_size = batch_size;
-      hidden = cell_(step_input, hidden, params);
+      hidden = cell_(step_input, hidden, params, pre_computed);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     std::reverse(step_outputs.begin(), step_outputs.end());
@@ -616,9 +721,16 @@ std::tuple<Tensor, Tensor> NAME(                                               \
   }                                                                            \
   check_device(_input, _params, hx);                                        \
   auto input = batch_first ? _input.transpose(0, 1) : _input;                  \
-  auto params = gather_params(_params, has_biases);                            \
-  auto results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>( \
-          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
+  std::tuple<Tensor, Tensor> results;                                          \
+  if (use_mkldnn(_input, _params)) {                                           \
+    auto params = gather_params<MkldnnCellParams>(_params, has_biases);       \
+    results = _rnn_impl_with_concat<CELL<MkldnnCellParams>, FullLayer, FullBidirectionalLayer>( \
+            input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
+  } else {                                                                     \
+    auto params = gather_params(_params, has_biases);                          \
+    results = _rnn_impl_with_concat<CELL<CellParams>, FullLayer, FullBidirectionalLayer>( \
+            input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
+  }                                                                            \
   if (batch_first) {                                                           \
     std::get<0>(results) = std::get<0>(results).transpose(0, 1);               \
   }                                                                            \
@@ -635,18 +747,22 @@ std::tuple<Tensor, Tensor> NAME(                                               \
             _params, has_biases, num_layers, dropout_p, train, bidirectional); \
     return std::make_tuple(output, hy);                                        \
   }                                                                            \
+  TORCH_CHECK(!use_mkldnn(data, _params),                                      \
+              "packed sequences are not supported with MKLDNN parameters");    \
   PackedSequence input { data, batch_sizes };                                  \
   auto params = gather_params(_params, has_biases);                            \
-  auto result = _rnn_impl_with_concat<CELL, PackedLayer, PackedBidirectionalLayer>( \
+  auto result = _rnn_impl_with_concat<CELL<CellParams>, PackedLayer, PackedBidirectionalLayer>( \
           input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
   auto & packed_output = std::get<0>(result);                                  \
   return std::make_tuple(packed_output.data, std::get<1>(result));             \
 }
 
-ONE_HIDDEN_RNN(gru, GRUCell<CellParams>)
-using tanf_cell_type = SimpleCell<tanh_f, CellParams>;
+ONE_HIDDEN_RNN(gru, GRUCell)
+template<typename cell_params>
+using tanf_cell_type = SimpleCell<tanh_f, cell_params>;
 ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
-using relu_cell_type = SimpleCell<relu_f, CellParams>;
+template<typename cell_params>
+using relu_cell_type = SimpleCell<relu_f, cell_params>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
 DEFINE_DISPATCH(lstm_cudnn_stub);
@@ -667,9 +783,16 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   }
   check_device(_input, _params, hx);
   auto input = batch_first ? _input.transpose(0, 1) : _input;
-  auto params = gather_params(_params, has_biases);
-  auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
-      input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
+  std::tuple<Tensor, Tensor, Tensor> results;
+  if (use_mkldnn(_input, _params)) {
+    auto params = gather_params<MkldnnCellParams>(_params, has_biases);
+    results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
+        input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
+  } else {
+    auto params = gather_params(_params, has_biases);
+    results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
+        input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
+  }
   if (batch_first) {
     std::get<0>(results) = std::get<0>(results).transpose(0, 1);
   }
@@ -687,6 +810,8 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
             _params, has_biases, num_layers, dropout_p, train, bidirectional);
     return std::make_tuple(output, hy, cy);
   }
+  TORCH_CHECK(!use_mkldnn(data, _params),
+              "packed sequences are not supported with MKLDNN parameters");
   PackedSequence input { data, batch_sizes };
   auto params = gather_params(_params, has_biases);
   auto result = _lstm_impl<PackedLayer, PackedBidirectionalLayer>(
@@ -695,6 +820,135 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   return std::make_tuple(packed_output.data, std::get<1>(result), std::get<2>(result));
 }
 
+// Fused cells
+//
+// The CPU versions of the fused CUDA cells in cuda/RNN.cu. They take the
+// gates computed by the linear layers, and do all pointwise math of a step in
+// a single pass over them (see cpu/RNNKernel.cpp). The workspaces have the
+// same layout as the CUDA ones.
+
+DEFINE_DISPATCH(fused_lstm_cell_stub);
+DEFINE_DISPATCH(fused_lstm_cell_backward_stub);
+DEFINE_DISPATCH(fused_gru_cell_stub);
+DEFINE_DISPATCH(fused_gru_cell_backward_stub);
+
+static constexpr int64_t GRU_WORKSPACE_MULTIPLIER = 5;
+
+// Factor will be 3 for GRU and 4 for LSTM
+static void check_fused_cell_sizes(CheckedFrom c,
+                                   const TensorArg& input_gates, const TensorArg& hidden_gates,
+                                   const TensorArg& input_bias, const TensorArg& hidden_bias,
+                                   int64_t factor, const TensorArg& prev_hidden) {
+  checkDim(c, input_gates, 2);
+  checkSameSize(c, input_gates, hidden_gates);
+  int64_t gates_size = input_gates->size(1);
+
+  if (input_bias->defined()) {
+    checkDim(c, input_bias, 1);
+    checkNumel(c, input_bias, gates_size);
+    checkSameSize(c, input_bias, hidden_bias);
+  }
+
+  checkDim(c, prev_hidden, 2);
+  checkNumel(c, prev_hidden, input_gates->size(0) * gates_size / factor);
+  checkScalarType(c, hidden_gates, input_gates->scalar_type());
+  checkScalarType(c, prev_hidden, input_gates->scalar_type());
+}
+
+// An undefined tensor stays undefined
+static Tensor contiguous_or_undefined(const Tensor& t) {
+  return t.defined() ? t.contiguous() : t;
+}
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& cx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_lstm_cell_cpu",
+                         {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+                         {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+                         /*factor=*/4, {cx, "prev_hidden", 5});
+
+  auto workspace = at::empty_like(input_gates);
+  auto hy = at::empty_like(cx);
+  auto cy = at::empty_like(cx);
+  fused_lstm_cell_stub(kCPU, input_gates.contiguous(), hidden_gates.contiguous(),
+                       contiguous_or_undefined(input_bias), contiguous_or_undefined(hidden_bias),
+                       cx.contiguous(), hy, cy, workspace);
+  return std::make_tuple(hy, cy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& grad_cy,
+      const Tensor& cx, const Tensor& cy,
+      const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_lstm_cell_backward_cpu";
+  TensorArg grad_hy_arg{grad_hy, "grad_hy", 1}, grad_cy_arg{grad_cy, "grad_cy", 2};
+  const TensorArg& defined_grad = grad_hy.defined() ? grad_hy_arg : grad_cy_arg;
+  checkDim(c, defined_grad, 2);
+  auto exp_size = defined_grad->sizes();
+  if (grad_hy.defined()) {
+    checkSize(c, grad_hy_arg, exp_size);
+  }
+  if (grad_cy.defined()) {
+    checkSize(c, grad_cy_arg, exp_size);
+  }
+  TensorArg cx_arg{cx, "cx", 3}, cy_arg{cy, "cy", 4}, workspace_arg{workspace, "workspace", 5};
+  checkSize(c, cx_arg, exp_size);
+  checkSize(c, cy_arg, exp_size);
+  checkDim(c, workspace_arg, 2);
+  checkNumel(c, workspace_arg, exp_size[0] * exp_size[1] * 4);
+
+  auto grad_gates = at::empty_like(workspace);
+  auto grad_cx = at::empty_like(cx);
+  fused_lstm_cell_backward_stub(kCPU, contiguous_or_undefined(grad_hy), contiguous_or_undefined(grad_cy),
+                                cx.contiguous(), cy.contiguous(), workspace.contiguous(),
+                                grad_gates, grad_cx);
+
+  auto grad_bias = has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(grad_gates, grad_gates, grad_cx, grad_bias, grad_bias);
+}
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& hx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_gru_cell_cpu",
+                         {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+                         {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+                         /*factor=*/3, {hx, "prev_hidden", 5});
+
+  auto workspace = at::empty({hx.size(0), hx.size(1) * GRU_WORKSPACE_MULTIPLIER}, hx.options());
+  auto hy = at::empty_like(hx);
+  fused_gru_cell_stub(kCPU, input_gates.contiguous(), hidden_gates.contiguous(),
+                      contiguous_or_undefined(input_bias), contiguous_or_undefined(hidden_bias),
+                      hx.contiguous(), hy, workspace);
+  return std::make_tuple(hy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_gru_cell_backward_cpu";
+  TensorArg grad_hy_arg{grad_hy, "grad_hy", 1}, workspace_arg{workspace, "workspace", 2};
+  checkDim(c, grad_hy_arg, 2);
+  checkSize(c, workspace_arg, {grad_hy.size(0), grad_hy.size(1) * GRU_WORKSPACE_MULTIPLIER});
+
+  int64_t hidden_size = workspace.size(1) / GRU_WORKSPACE_MULTIPLIER;
+  auto grad_input_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hidden_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hx = at::empty_like(grad_hy);
+  fused_gru_cell_backward_stub(kCPU, grad_hy.contiguous(), workspace.contiguous(),
+                               grad_input_gates, grad_hidden_gates, grad_hx);
+
+  at::Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+
+  return std::make_tuple(grad_input_gates, grad_hidden_gates, grad_hx, grad_input_bias, grad_hidden_bias);
+}
+
 std::tuple<Tensor, Tensor> lstm_cell(
     const Tensor& input, TensorList hx,
     const Tensor& w_ih, const Tensor& w_hh, const Tensor& b_ih, const Tensor& b_hh) {
@@ -19,6 +19,27 @@ DECLARE_DISPATCH(rnn_packed_fn, gru_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 
+// Pointwise parts of the fused CPU LSTM and GRU cells, see
+// _thnn_fused_lstm_cell_cpu. All tensors are contiguous, biases may be
+// undefined.
+using lstm_cell_fn = void(*)(const Tensor& input_gates, const Tensor& hidden_gates,
+                             const Tensor& input_bias, const Tensor& hidden_bias,
+                             const Tensor& cx, Tensor& hy, Tensor& cy, Tensor& workspace);
+using lstm_cell_backward_fn = void(*)(const Tensor& grad_hy, const Tensor& grad_cy,
+                                      const Tensor& cx, const Tensor& cy, const Tensor& workspace,
+                                      Tensor& grad_gates, Tensor& grad_cx);
+using gru_cell_fn = void(*)(const Tensor& input_gates, const Tensor& hidden_gates,
+                            const Tensor& input_bias, const Tensor& hidden_bias,
+                            const Tensor& hx, Tensor& hy, Tensor& workspace);
+using gru_cell_backward_fn = void(*)(const Tensor& grad_hy, const Tensor& workspace,
+                                     Tensor& grad_input_gates, Tensor& grad_hidden_gates,
+                                     Tensor& grad_hx);
+
+DECLARE_DISPATCH(lstm_cell_fn, fused_lstm_cell_stub);
+DECLARE_DISPATCH(lstm_cell_backward_fn, fused_lstm_cell_backward_stub);
+DECLARE_DISPATCH(gru_cell_fn, fused_gru_cell_stub);
+DECLARE_DISPATCH(gru_cell_backward_fn, fused_gru_cell_backward_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
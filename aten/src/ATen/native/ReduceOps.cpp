@@ -28,6 +28,7 @@ DEFINE_DISPATCH(mean_stub);
 DEFINE_DISPATCH(and_stub);
 DEFINE_DISPATCH(or_stub);
 DEFINE_DISPATCH(min_values_stub);
+DEFINE_DISPATCH(min_max_values_stub);
 DEFINE_DISPATCH(max_values_stub);
 
 static inline Tensor integer_upcast(const Tensor& self, optional<ScalarType> dtype) {
@@ -632,6 +633,18 @@ Tensor max_values(const Tensor& self, IntArrayRef dims, bool keepdim) {
   }
 }
 
+std::tuple<Tensor,Tensor> _min_max_values(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  if (self.type().backend() != Backend::CPU) {
+    return std::make_tuple(self.min_values(dims, keepdim), self.max_values(dims, keepdim));
+  }
+  Tensor result1 = at::empty({0}, self.options());
+  Tensor result2 = at::empty({0}, self.options());
+  auto iter = make_reduction("_min_max_values", result1, result2, self, dims, keepdim, self.scalar_type());
+  TORCH_CHECK(iter->numel() > 0, "_min_max_values on a tensor with no elements is not defined.");
+  min_max_values_stub(iter->device_type(), *iter);
+  return std::make_tuple(result1, result2);
+}
+
 static Tensor &std_var_out(Tensor &result, const Tensor &self, IntArrayRef dim, bool unbiased, bool keepdim, bool take_sqrt) {
   TORCH_CHECK(self.type().backend() == Backend::CPU || self.type().backend() == Backend::CUDA,
            "std and var only support CPU AND CUDA backend, got: ", toString(self.type().backend()));
@@ -19,6 +19,8 @@ DECLARE_DISPATCH(reduce_fn, and_stub);
 DECLARE_DISPATCH(reduce_fn, or_stub);
 DECLARE_DISPATCH(reduce_fn, min_values_stub);
 DECLARE_DISPATCH(reduce_fn, max_values_stub);
+// reduces into two outputs, the minimum and the maximum, in a single pass
+DECLARE_DISPATCH(reduce_fn, min_max_values_stub);
 
 using reduce_std_var_function =
   void (*)(TensorIterator&, bool unbiased, bool take_sqrt);
@@ -0,0 +1,32 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/ResizeCropNormalize.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(resize_crop_normalize_stub);
+
+Tensor resize_crop_normalize_cpu(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef crop,
+    const Tensor& mean,
+    const Tensor& stddev,
+    bool align_corners,
+    bool channels_last) {
+  resize_crop_normalize_check(self, size, crop, mean, stddev);
+
+  const int64_t nbatch = self.size(0);
+  const int64_t channels = self.size(3);
+  Tensor output = channels_last
+      ? at::empty({nbatch, crop[2], crop[3], channels}, self.options().dtype(kFloat))
+      : at::empty({nbatch, channels, crop[2], crop[3]}, self.options().dtype(kFloat));
+
+  resize_crop_normalize_stub(
+      kCPU, output, self.contiguous(), size[0], size[1], crop[0], crop[1],
+      mean.to(kFloat).contiguous(), stddev.to(kFloat).contiguous(),
+      align_corners, channels_last);
+  return output;
+}
+
+}} // namespace at::native
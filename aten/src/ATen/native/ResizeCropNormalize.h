@@ -0,0 +1,66 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// _resize_crop_normalize fuses the usual image preprocessing chain
+//
+//   x = upsample_bilinear2d(input.permute(0, 3, 1, 2).float(), size, align_corners)
+//   x = x[:, :, top:top + height, left:left + width]
+//   x = (x - mean.view(1, -1, 1, 1)) / std.view(1, -1, 1, 1)
+//
+// into a single pass over a uint8 NHWC input. Only the cropped part of the
+// resized image is ever interpolated, and no intermediate tensors are made.
+// mean and std are in the units of the uint8 input (fold a 1/255 scaling into
+// them). The output is float NCHW, or NHWC when channels_last is set.
+using resize_crop_normalize_fn = void(*)(
+    Tensor& output, const Tensor& input, int64_t resized_height, int64_t resized_width,
+    int64_t crop_top, int64_t crop_left, const Tensor& mean, const Tensor& stddev,
+    bool align_corners, bool channels_last);
+
+DECLARE_DISPATCH(resize_crop_normalize_fn, resize_crop_normalize_stub);
+
+static inline void resize_crop_normalize_check(
+    const Tensor& input,
+    IntArrayRef size,
+    IntArrayRef crop,
+    const Tensor& mean,
+    const Tensor& stddev) {
+  TORCH_CHECK(
+      input.dim() == 4 && input.scalar_type() == kByte,
+      "_resize_crop_normalize: expected a 4D uint8 NHWC input, but got a ",
+      input.dim(), "D ", input.scalar_type(), " tensor");
+  TORCH_CHECK(
+      input.numel() > 0,
+      "_resize_crop_normalize: expected a non-empty input, but got sizes ",
+      input.sizes());
+  TORCH_CHECK(
+      size.size() == 2 && size[0] > 0 && size[1] > 0,
+      "_resize_crop_normalize: size must be two positive integers, but got ",
+      size);
+  TORCH_CHECK(
+      crop.size() == 4,
+      "_resize_crop_normalize: crop must be (top, left, height, width), but got ",
+      crop);
+  TORCH_CHECK(
+      crop[0] >= 0 && crop[1] >= 0 && crop[2] > 0 && crop[3] > 0 &&
+          crop[0] + crop[2] <= size[0] && crop[1] + crop[3] <= size[1],
+      "_resize_crop_normalize: crop ", crop,
+      " does not lie within the resized image of size ", size);
+
+  const int64_t channels = input.size(3);
+  for (const Tensor* t : {&mean, &stddev}) {
+    TORCH_CHECK(
+        t->dim() == 1 && t->numel() == channels,
+        "_resize_crop_normalize: mean and std must be 1D tensors with one "
+        "value per input channel (", channels, "), but got sizes ", t->sizes());
+    TORCH_CHECK(
+        t->device() == input.device(),
+        "_resize_crop_normalize: mean and std must be on the device of the "
+        "input (", input.device(), "), but got ", t->device());
+  }
+}
+
+}} // namespace at::native
@@ -4,6 +4,12 @@
 #include <ATen/WrapDimUtils.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace at {
 namespace native {
 
@@ -125,6 +131,326 @@ void quick_select_template(
   } while (1);
 }
 
+// Note [CPU sort and topk]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// sort and topk work on the slices along dim, which are first copied to the
+// rows of a contiguous tensor. Many short rows are spread over the threads,
+// while a few long ones are each split into chunks handled by all threads:
+// sort sorts the chunks and merges them pairwise, topk selects the top k of
+// every chunk and then the top k among those.
+//
+// Elements are (value, index) pairs, ordered by value with NaN being the
+// largest value (for numpy compatibility), and by index for equal values. So
+// sorting is stable, and the results don't depend on the algorithm, which is
+// a radix sort for long rows of keys with at most 64 bits, a comparison sort
+// otherwise, and a partial selection for small k.
+
+constexpr int64_t RADIX_SORT_MIN_SIZE = 1024;
+// Rows of at least this size are split into chunks, if there are too few of
+// them to keep all threads busy
+constexpr int64_t PARALLEL_ROW_MIN_SIZE = 1 << 16;
+// topk keeps a heap of the top k elements if k is that much smaller than the
+// row, and does a full selection otherwise
+constexpr int64_t TOPK_HEAP_RATIO = 16;
+
+template <typename scalar_t>
+using elem_t = std::pair<scalar_t, int64_t>;
+
+template <typename scalar_t>
+inline bool lt_nan_last(scalar_t x, scalar_t y) {
+  return (!_isnan<scalar_t>(x) && _isnan<scalar_t>(y)) || x < y;
+}
+
+// Whether a comes before b, see Note [CPU sort and topk]
+template <typename scalar_t>
+struct ElemComp {
+  bool descending;
+  bool operator()(const elem_t<scalar_t>& a, const elem_t<scalar_t>& b) const {
+    const bool a_first = descending ? lt_nan_last(b.first, a.first)
+                                    : lt_nan_last(a.first, b.first);
+    const bool b_first = descending ? lt_nan_last(a.first, b.first)
+                                    : lt_nan_last(b.first, a.first);
+    return a_first || (!b_first && a.second < b.second);
+  }
+};
+
+// Unsigned keys with the same order as the values, NaN being the largest, and
+// -0 equal to 0.
+template <typename scalar_t>
+using radix_key_t =
+    typename std::conditional<sizeof(scalar_t) <= 4, uint32_t, uint64_t>::type;
+
+template <typename scalar_t>
+typename std::enable_if<std::is_integral<scalar_t>::value, radix_key_t<scalar_t>>::type
+radix_key(scalar_t x) {
+  using unsigned_t = typename std::make_unsigned<scalar_t>::type;
+  auto key = static_cast<radix_key_t<scalar_t>>(static_cast<unsigned_t>(x));
+  if (std::is_signed<scalar_t>::value) {
+    key ^= radix_key_t<scalar_t>(1) << (sizeof(scalar_t) * 8 - 1);
+  }
+  return key;
+}
+
+template <typename scalar_t>
+typename std::enable_if<std::is_floating_point<scalar_t>::value, radix_key_t<scalar_t>>::type
+radix_key(scalar_t x) {
+  using key_t = radix_key_t<scalar_t>;
+  static_assert(sizeof(key_t) == sizeof(scalar_t), "unexpected key size");
+  if (_isnan<scalar_t>(x)) {
+    return ~key_t(0);
+  }
+  if (x == 0) {
+    x = 0;
+  }
+  key_t bits;
+  std::memcpy(&bits, &x, sizeof(x));
+  const key_t sign = key_t(1) << (sizeof(key_t) * 8 - 1);
+  return (bits & sign) ? ~bits : (bits | sign);
+}
+
+// LSD radix sort of data[begin, end) into out, a byte per pass
+template <typename scalar_t>
+void radix_sort(
+    const scalar_t* data,
+    int64_t begin,
+    int64_t end,
+    bool descending,
+    elem_t<scalar_t>* out) {
+  using key_t = radix_key_t<scalar_t>;
+  const int64_t n = end - begin;
+  std::vector<key_t> keys(n), keys_tmp(n);
+  std::vector<int64_t> idx(n), idx_tmp(n);
+  for (int64_t i = 0; i < n; i++) {
+    const key_t key = radix_key(data[begin + i]);
+    keys[i] = descending ? ~key : key;
+    idx[i] = begin + i;
+  }
+  // Only the low bytes differ between keys of narrow types
+  for (size_t byte = 0; byte < sizeof(scalar_t); byte++) {
+    const int shift = byte * 8;
+    int64_t offsets[256] = {0};
+    for (int64_t i = 0; i < n; i++) {
+      offsets[(keys[i] >> shift) & 0xff]++;
+    }
+    if (offsets[(keys[0] >> shift) & 0xff] == n) {
+      continue; // all keys share this byte
+    }
+    int64_t offset = 0;
+    for (int64_t& o : offsets) {
+      const int64_t count = o;
+      o = offset;
+      offset += count;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      const int64_t pos = offsets[(keys[i] >> shift) & 0xff]++;
+      keys_tmp[pos] = keys[i];
+      idx_tmp[pos] = idx[i];
+    }
+    std::swap(keys, keys_tmp);
+    std::swap(idx, idx_tmp);
+  }
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = {data[idx[i]], idx[i]};
+  }
+}
+
+// Sorts data[begin, end) into out, with indices relative to data
+template <typename scalar_t>
+void sort_elems(
+    const scalar_t* data,
+    int64_t begin,
+    int64_t end,
+    bool descending,
+    elem_t<scalar_t>* out) {
+  if (end - begin >= RADIX_SORT_MIN_SIZE) {
+    radix_sort(data, begin, end, descending, out);
+    return;
+  }
+  for (int64_t i = begin; i < end; i++) {
+    out[i - begin] = {data[i], i};
+  }
+  std::sort(out, out + (end - begin), ElemComp<scalar_t>{descending});
+}
+
+// The boundaries of a row of size n split into about one chunk per thread
+std::vector<int64_t> row_chunks(int64_t n) {
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(get_num_threads(), n / (PARALLEL_ROW_MIN_SIZE / 4)));
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int64_t c = 0; c <= num_chunks; c++) {
+    bounds[c] = c * n / num_chunks;
+  }
+  return bounds;
+}
+
+// Sorts a row with all threads, see Note [CPU sort and topk]
+template <typename scalar_t>
+void parallel_sort_row(
+    const scalar_t* data,
+    int64_t n,
+    bool descending,
+    std::vector<elem_t<scalar_t>>& elems) {
+  auto bounds = row_chunks(n);
+  const int64_t num_chunks = bounds.size() - 1;
+  elems.resize(n);
+  parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      sort_elems(data, bounds[c], bounds[c + 1], descending, elems.data() + bounds[c]);
+    }
+  });
+  std::vector<elem_t<scalar_t>> merged(n);
+  for (int64_t width = 1; width < num_chunks; width *= 2) {
+    const int64_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    parallel_for(0, num_merges, 1, [&](int64_t m_begin, int64_t m_end) {
+      for (int64_t m = m_begin; m < m_end; m++) {
+        const int64_t first = bounds[2 * width * m];
+        const int64_t middle = bounds[std::min(2 * width * m + width, num_chunks)];
+        const int64_t last = bounds[std::min(2 * width * (m + 1), num_chunks)];
+        std::merge(
+            elems.begin() + first, elems.begin() + middle,
+            elems.begin() + middle, elems.begin() + last,
+            merged.begin() + first, ElemComp<scalar_t>{descending});
+      }
+    });
+    std::swap(elems, merged);
+  }
+}
+
+// The top k elements of data[begin, end) in elems, in the order of comp if
+// sorted is set, and in any order otherwise.
+template <typename scalar_t>
+void topk_elems(
+    const scalar_t* data,
+    int64_t begin,
+    int64_t end,
+    int64_t k,
+    bool largest,
+    bool sorted,
+    std::vector<elem_t<scalar_t>>& elems) {
+  const ElemComp<scalar_t> comp{largest};
+  const int64_t n = end - begin;
+  k = std::min(k, n);
+  elems.clear();
+  if (k == 0) {
+    return;
+  }
+  if (k * TOPK_HEAP_RATIO <= n) {
+    // Partial selection: elems is a heap of the top k so far, with the last
+    // of them in front
+    elems.reserve(k);
+    for (int64_t i = begin; i < begin + k; i++) {
+      elems.emplace_back(data[i], i);
+    }
+    std::make_heap(elems.begin(), elems.end(), comp);
+    for (int64_t i = begin + k; i < end; i++) {
+      const elem_t<scalar_t> elem{data[i], i};
+      if (comp(elem, elems.front())) {
+        std::pop_heap(elems.begin(), elems.end(), comp);
+        elems.back() = elem;
+        std::push_heap(elems.begin(), elems.end(), comp);
+      }
+    }
+    if (sorted) {
+      std::sort_heap(elems.begin(), elems.end(), comp);
+    }
+    return;
+  }
+  elems.reserve(n);
+  for (int64_t i = begin; i < end; i++) {
+    elems.emplace_back(data[i], i);
+  }
+  std::nth_element(elems.begin(), elems.begin() + (k - 1), elems.end(), comp);
+  elems.resize(k);
+  if (sorted) {
+    std::sort(elems.begin(), elems.end(), comp);
+  }
+}
+
+// Selects the top k of a row with all threads, see Note [CPU sort and topk]
+template <typename scalar_t>
+void parallel_topk_row(
+    const scalar_t* data,
+    int64_t n,
+    int64_t k,
+    bool largest,
+    bool sorted,
+    std::vector<elem_t<scalar_t>>& elems) {
+  auto bounds = row_chunks(n);
+  const int64_t num_chunks = bounds.size() - 1;
+  std::vector<std::vector<elem_t<scalar_t>>> chunk_elems(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      topk_elems(data, bounds[c], bounds[c + 1], k, largest, /*sorted=*/false, chunk_elems[c]);
+    }
+  });
+  elems.clear();
+  for (const auto& candidates : chunk_elems) {
+    elems.insert(elems.end(), candidates.begin(), candidates.end());
+  }
+  const ElemComp<scalar_t> comp{largest};
+  std::nth_element(elems.begin(), elems.begin() + (k - 1), elems.end(), comp);
+  elems.resize(k);
+  if (sorted) {
+    std::sort(elems.begin(), elems.end(), comp);
+  }
+}
+
+// Calls f(row, elems) to compute the elements of each row of rows, and writes
+// the first row_size of them to the rows of values and indices. f computes a
+// row with all threads if it is passed true as its last argument, see Note
+// [CPU sort and topk].
+template <typename scalar_t, typename Fn>
+void apply_rows(
+    const Tensor& rows,
+    Tensor& values,
+    Tensor& indices,
+    int64_t row_size,
+    Fn f) {
+  const int64_t n = rows.size(-1);
+  const int64_t num_rows = n == 0 ? 0 : rows.numel() / n;
+  const scalar_t* rows_data = rows.data<scalar_t>();
+  scalar_t* values_data = values.data<scalar_t>();
+  int64_t* indices_data = indices.data<int64_t>();
+  auto write_row = [&](int64_t r, const std::vector<elem_t<scalar_t>>& elems) {
+    for (int64_t i = 0; i < row_size; i++) {
+      values_data[r * row_size + i] = elems[i].first;
+      indices_data[r * row_size + i] = elems[i].second;
+    }
+  };
+
+  if (n >= PARALLEL_ROW_MIN_SIZE && num_rows < get_num_threads()) {
+    std::vector<elem_t<scalar_t>> elems;
+    for (int64_t r = 0; r < num_rows; r++) {
+      f(rows_data + r * n, elems, /*parallel=*/true);
+      write_row(r, elems);
+    }
+    return;
+  }
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, n));
+  parallel_for(0, num_rows, grain_size, [&](int64_t r_begin, int64_t r_end) {
+    std::vector<elem_t<scalar_t>> elems;
+    for (int64_t r = r_begin; r < r_end; r++) {
+      f(rows_data + r * n, elems, /*parallel=*/false);
+      write_row(r, elems);
+    }
+  });
+}
+
+// The slices of self along dim, as the rows of a contiguous tensor
+Tensor slices_as_rows(const Tensor& self, int64_t dim) {
+  return self.transpose(dim, -1).contiguous();
+}
+
+void check_sort_outputs(const Tensor& values, const Tensor& indices, const Tensor& self) {
+  TORCH_CHECK(
+      values.scalar_type() == self.scalar_type(),
+      "output values must be of the same type as input, expected ",
+      self.scalar_type(), " but got ", values.scalar_type());
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "output indices must be of scalar type Long, but got ", indices.scalar_type());
+}
+
 } // namespace
 
 std::tuple<Tensor&, Tensor&> kthvalue_out_cpu(
@@ -249,5 +575,120 @@ Tensor median_cpu(const Tensor& self) {
   return result.view({});
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  check_sort_outputs(values, indices, self);
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+  if (self.dim() == 0) {
+    values.copy_(self);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+
+  auto rows = slices_as_rows(self, dim);
+  auto tmp_values = at::empty(rows.sizes(), rows.options());
+  auto tmp_indices = at::empty(rows.sizes(), rows.options().dtype(kLong));
+  const int64_t n = rows.size(-1);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cpu", [&] {
+    apply_rows<scalar_t>(
+        rows,
+        tmp_values,
+        tmp_indices,
+        /*row_size=*/n,
+        [&](const scalar_t* row, std::vector<elem_t<scalar_t>>& elems, bool parallel) {
+          if (parallel) {
+            parallel_sort_row(row, n, descending, elems);
+          } else {
+            elems.resize(n);
+            sort_elems(row, 0, n, descending, elems.data());
+          }
+        });
+  });
+  values.transpose(dim, -1).copy_(tmp_values);
+  indices.transpose(dim, -1).copy_(tmp_indices);
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  return sort_out_cpu(values, indices, self, dim, descending);
+}
+
+Tensor argsort(const Tensor& self, int64_t dim, bool descending) {
+  return std::get<1>(at::sort(self, dim, descending));
+}
+
+std::tuple<Tensor&, Tensor&> topk_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool largest,
+    bool sorted) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  const int64_t slice_size = self.dim() > 0 ? self.size(dim) : 1;
+  TORCH_CHECK(k >= 0 && k <= slice_size, "selected index k out of range");
+  check_sort_outputs(values, indices, self);
+  auto result_sizes = self.sizes().vec();
+  if (self.dim() > 0) {
+    result_sizes[dim] = k;
+  }
+  values.resize_(result_sizes);
+  indices.resize_(result_sizes);
+  if (self.dim() == 0) {
+    values.copy_(self);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+
+  auto rows = slices_as_rows(self, dim);
+  auto tmp_sizes = rows.sizes().vec();
+  tmp_sizes.back() = k;
+  auto tmp_values = at::empty(tmp_sizes, rows.options());
+  auto tmp_indices = at::empty(tmp_sizes, rows.options().dtype(kLong));
+  if (k > 0) {
+    const int64_t n = rows.size(-1);
+    AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+      apply_rows<scalar_t>(
+          rows,
+          tmp_values,
+          tmp_indices,
+          /*row_size=*/k,
+          [&](const scalar_t* row, std::vector<elem_t<scalar_t>>& elems, bool parallel) {
+            if (parallel) {
+              parallel_topk_row(row, n, k, largest, sorted, elems);
+            } else {
+              topk_elems(row, 0, n, k, largest, sorted, elems);
+            }
+          });
+    });
+  }
+  values.transpose(dim, -1).copy_(tmp_values);
+  indices.transpose(dim, -1).copy_(tmp_indices);
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> topk_cpu(
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  return topk_out_cpu(values, indices, self, k, dim, largest, sorted);
+}
+
 } // namespace native
 } // namespace at
@@ -146,6 +146,26 @@ void _cufft_clear_plan_cache(int64_t device_index) {
   detail::getCUDAHooks().cuFFTClearPlanCache(device_index);
 }
 
+int64_t _cufft_get_plan_cache_max_workspace_size(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheMaxWorkspaceSize(device_index);
+}
+
+void _cufft_set_plan_cache_max_workspace_size(int64_t device_index, int64_t max_workspace_size) {
+  detail::getCUDAHooks().cuFFTSetPlanCacheMaxWorkspaceSize(device_index, max_workspace_size);
+}
+
+int64_t _cufft_get_plan_cache_workspace_size(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheWorkspaceSize(device_index);
+}
+
+int64_t _cufft_get_plan_cache_hits(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheHits(device_index);
+}
+
+int64_t _cufft_get_plan_cache_misses(int64_t device_index) {
+  return detail::getCUDAHooks().cuFFTGetPlanCacheMisses(device_index);
+}
+
 Tensor fft(const Tensor& self, const int64_t signal_ndim, const bool normalized) {
   return _fft(self, signal_ndim, /* complex_input */ true,
               /* complex_output */ true, /* inverse */ false, {}, normalized,
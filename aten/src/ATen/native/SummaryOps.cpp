@@ -2,6 +2,8 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/SummaryOps.h>
 
 #include <tuple>
 
@@ -36,18 +38,24 @@ Tensor _bincount_cpu_template(
 
   const input_t* self_p = self.data<input_t>();
   if (has_weights) {
-    output = native::zeros({nbins}, weights.options());
-    weights_t* output_p = output.data<weights_t>();
+    output = at::empty({nbins}, weights.options());
     const weights_t* weights_p = weights.data<weights_t>();
-    for (int64_t i = 0; i < self.size(0); i++) {
-      output_p[self_p[i]] += weights_p[i];
-    }
+    parallel_histogram(
+        output.data<weights_t>(), nbins, self.size(0),
+        [&](weights_t* output_p, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            output_p[self_p[i]] += weights_p[i];
+          }
+        });
   } else {
-    output = native::zeros({nbins}, kLong);
-    int64_t* output_p = output.data<int64_t>();
-    for (int64_t i = 0; i < self.size(0); i++) {
-      output_p[self_p[i]] += 1L;
-    }
+    output = at::empty({nbins}, kLong);
+    parallel_histogram(
+        output.data<int64_t>(), nbins, self.size(0),
+        [&](int64_t* output_p, int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            output_p[self_p[i]] += 1L;
+          }
+        });
   }
   return output;
 }
@@ -64,4 +72,35 @@ _bincount_cpu(const Tensor& self, const Tensor& weights, int64_t minlength) {
   });
 }
 
+///////////////// histc /////////////////
+DEFINE_DISPATCH(histc_stub);
+
+Tensor& _histc_out_cpu(Tensor& hist, const Tensor& self, int64_t nbins, Scalar min, Scalar max) {
+  if (nbins <= 0) {
+    AT_ERROR("bins must be > 0");
+  }
+  TORCH_CHECK(hist.scalar_type() == self.scalar_type(),
+      "histc: expected a result of type ", self.scalar_type(), ", but got ", hist.scalar_type());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    scalar_t minvalue = min.to<scalar_t>();
+    scalar_t maxvalue = max.to<scalar_t>();
+    if (minvalue == maxvalue && self.numel() > 0) {
+      minvalue = *self.min().data<scalar_t>();
+      maxvalue = *self.max().data<scalar_t>();
+    }
+    if (minvalue == maxvalue) {
+      minvalue = minvalue - 1;
+      maxvalue = maxvalue + 1;
+    }
+    hist.resize_({nbins});
+    histc_stub(kCPU, hist, self.contiguous(), nbins, minvalue, maxvalue);
+  });
+  return hist;
+}
+
+Tensor _histc_cpu(const Tensor& self, int64_t nbins, Scalar min, Scalar max) {
+  Tensor hist = at::empty({0}, self.options());
+  return _histc_out_cpu(hist, self, nbins, min, max);
+}
+
 }} // namespace at::native
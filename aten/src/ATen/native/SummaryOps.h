@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at { namespace native {
+
+using histc_fn = void(*)(Tensor& hist, const Tensor& self, int64_t nbins, Scalar min, Scalar max);
+
+DECLARE_DISPATCH(histc_fn, histc_stub);
+
+// Fills the `nbins` entries of `hist` by calling `loop(local_hist, begin, end)`
+// to count elements [begin, end) of an input of `numel` elements into
+// `local_hist`. Large inputs are split into one chunk per thread, each of
+// which counts into a private histogram, so that threads never write to
+// the same bins; the private histograms are summed at the end. A chunk is
+// at least `nbins` elements long, so the private histograms never cost more
+// than the input itself.
+template <typename count_t, typename loop_t>
+void parallel_histogram(count_t* hist, int64_t nbins, int64_t numel, const loop_t& loop) {
+  std::fill(hist, hist + nbins, count_t(0));
+  const int64_t num_chunks = std::max<int64_t>(1, std::min<int64_t>(
+      at::get_num_threads(), numel / std::max(internal::GRAIN_SIZE, nbins)));
+  if (num_chunks == 1) {
+    loop(hist, 0, numel);
+    return;
+  }
+  std::vector<count_t> local_hists(num_chunks * nbins, count_t(0));
+  parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = begin; chunk < end; ++chunk) {
+      loop(local_hists.data() + chunk * nbins,
+           numel * chunk / num_chunks,
+           numel * (chunk + 1) / num_chunks);
+    }
+  });
+  parallel_for(0, nbins, internal::GRAIN_SIZE / num_chunks, [&](int64_t begin, int64_t end) {
+    for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+      const count_t* local_hist = local_hists.data() + chunk * nbins;
+      for (int64_t bin = begin; bin < end; ++bin) {
+        hist[bin] += local_hist[bin];
+      }
+    }
+  });
+}
+
+}} // namespace at::native
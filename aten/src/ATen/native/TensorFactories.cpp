@@ -15,6 +15,7 @@
 #include <c10/util/Deprecated.h>
 #include <ATen/native/Resize.h>
 #include <ATen/native/TensorFactories.h>
+#include <ATen/quantized/Quantizer.h>
 #include <c10/core/TensorOptions.h>
 #include <TH/THRandom.h>
 #include <TH/THGenerator.hpp>
@@ -154,6 +155,10 @@ AT_FORALL_SCALAR_TYPES_AND_BOOL_EXCEPT_QINT(DEFINE_CAST_OP)
 #undef DEFINE_CAST_OP
 
 Tensor empty_like(const Tensor& self) {
+  if (self.is_quantized()) {
+    // quantized tensors keep their quantizer
+    return new_qtensor_cpu(self.sizes(), self.options(), get_qtensorimpl(self)->quantizer());
+  }
   return native::empty_like(self, self.options());
 }
 
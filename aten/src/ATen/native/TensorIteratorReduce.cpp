@@ -14,12 +14,17 @@ static void two_pass_reduction(TensorIterator& iter, const loop2d_t& loop);
 static void parallel_dim_reduction(TensorIterator& iter, const loop2d_t& loop);
 
 void TensorIterator::parallel_reduce(const loop2d_t& loop) {
-  TORCH_CHECK(ntensors() == 2, "parallel_reduce only supports one input and one output");
+  TORCH_CHECK(ninputs() == 1 && noutputs() >= 1, "parallel_reduce only supports one input");
   int64_t numel = this->numel();
   if (numel < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ||
       at::in_parallel_region()) {
     serial_for_each(loop, {0, numel});
   } else if (use_two_pass_reduction(*this)) {
+    // the final pass combines the per-thread partial results with `loop`
+    // itself, which only works when there is a single output.  Kernels with
+    // several outputs have to handle full reductions on their own (see
+    // binary_kernel_reduce_vec in native/cpu/Reduce.h).
+    TORCH_CHECK(noutputs() == 1, "parallel_reduce of a single element only supports one output");
     two_pass_reduction(*this, loop);
   } else {
     parallel_dim_reduction(*this, loop);
@@ -43,9 +48,13 @@ static void two_pass_reduction(TensorIterator& iter, const loop2d_t& loop) {
 
   at::parallel_for(0, iter.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
     int thread_num = at::get_thread_num();
-    written[thread_num] = true;
     auto slice = buffer[thread_num];
-    slice.copy_(dst);
+    // a thread may be handed more than one chunk, so only initialize its
+    // slice the first time
+    if (!written[thread_num]) {
+      slice.copy_(dst);
+      written[thread_num] = true;
+    }
 
     auto sub_iter = TensorIterator::reduce_op(slice, iter.input(0));
     sub_iter->serial_for_each(loop, {begin, end});
@@ -97,9 +106,10 @@ static void parallel_dim_reduction(TensorIterator& iter, const loop2d_t& loop) {
   AT_ASSERT(iter.ndim() >= 1);
   int dim = find_split_dim(iter);
   int64_t cols = iter.shape()[dim];
-  int element_size = iter.element_size(/*arg=*/1);
+  int input = iter.noutputs();
+  int element_size = iter.element_size(/*arg=*/input);
 
-  bool should_round_columns = iter.strides(1)[dim] == element_size;
+  bool should_round_columns = iter.strides(input)[dim] == element_size;
   at::parallel_for(0, cols, 1, [&](int64_t begin, int64_t end) {
     if (should_round_columns) {
       // round columns to multiples of 128 bytes if adjacent columns are
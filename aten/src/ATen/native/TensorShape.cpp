@@ -6,6 +6,7 @@
 #include <ATen/InferSize.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/LegacyTHFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -13,6 +14,9 @@
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
 #include <vector>
 
 namespace at {
@@ -45,12 +49,6 @@ static void check_cat_no_zero_dim(TensorList tensors) {
   }
 }
 
-Tensor & cat_out(Tensor & result, TensorList tensors, int64_t dim) {
-  check_cat_no_zero_dim(tensors);
-  dim = legacy_cat_wrap_dim(dim, tensors);
-  return at::legacy::th::_th_cat_out(result, tensors, dim);
-}
-
 static bool sizes_match_except(IntArrayRef s1, IntArrayRef s2, int64_t dim_except /* should already be wrapped */) {
   if (s1.size() != s2.size()) {
     return false;
@@ -171,6 +169,179 @@ static Tensor cat_sparse(TensorList tensors, int64_t dim) {
   }
 }
 
+// Note [CPU cat]
+// ~~~~~~~~~~~~~~
+// Dense CPU tensors are concatenated here rather than in TH, which copies the
+// inputs one after the other. The output is viewed as `outer` rows, each of
+// which holds a slice of every input at an offset computed upfront. All
+// slices of contiguous inputs are copied in parallel with memcpy. Other inputs
+// are copied with copy_, which is parallel itself. Cases this doesn't cover
+// (inputs of other types, invalid sizes, ...) still go to TH, which raises
+// the same errors as before.
+
+// The size [0] tensors that TH skips for backwards compatibility, see
+// THTensor_(catArray).
+static bool cat_should_skip(const Tensor& t) {
+  return t.dim() == 1 && t.size(0) == 0;
+}
+
+static bool can_cat_cpu(const Tensor& result, TensorList tensors, int64_t dim) {
+  auto is_dense_cpu = [](const Tensor& t) {
+    return t.type().backend() == Backend::CPU && !t.is_quantized();
+  };
+  if (!is_dense_cpu(result)) {
+    return false;
+  }
+  const Tensor* first = nullptr;
+  for (const auto& t : tensors) {
+    if (!is_dense_cpu(t) || t.scalar_type() != result.scalar_type() ||
+        t.is_same(result)) {
+      return false;
+    }
+    if (cat_should_skip(t)) {
+      continue;
+    }
+    if (!first) {
+      first = &t;
+      if (dim < 0 || dim >= t.dim()) {
+        return false;
+      }
+    } else if (!sizes_match_except(first->sizes(), t.sizes(), dim)) {
+      return false;
+    }
+  }
+  return first != nullptr;
+}
+
+static Tensor& cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
+  std::vector<Tensor> inputs;
+  for (const auto& t : tensors) {
+    if (!cat_should_skip(t)) {
+      inputs.push_back(t);
+    }
+  }
+  auto sizes = inputs[0].sizes().vec();
+  sizes[dim] = 0;
+  for (const auto& t : inputs) {
+    sizes[dim] += t.size(dim);
+  }
+  result.resize_(sizes);
+  if (result.numel() == 0) {
+    return result;
+  }
+
+  // offset of each input along `dim`
+  std::vector<int64_t> offsets(inputs.size());
+  for (size_t i = 1; i < inputs.size(); ++i) {
+    offsets[i] = offsets[i - 1] + inputs[i - 1].size(dim);
+  }
+
+  std::vector<size_t> copied;
+  if (result.is_contiguous()) {
+    std::vector<size_t> contiguous;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i].is_contiguous() && inputs[i].numel() > 0) {
+        contiguous.push_back(i);
+      }
+    }
+    const int64_t outer = std::accumulate(
+        sizes.begin(), sizes.begin() + dim, int64_t{1}, std::multiplies<int64_t>());
+    const int64_t inner = std::accumulate(
+        sizes.begin() + dim + 1, sizes.end(), int64_t{1}, std::multiplies<int64_t>());
+    const int64_t element_size = result.element_size();
+    const int64_t row_bytes = sizes[dim] * inner * element_size;
+    auto result_data = static_cast<char*>(result.data_ptr());
+
+    // One task per (input, row), averaging the number of elements of a task
+    // for the grain size.
+    const int64_t num_tasks = contiguous.size() * outer;
+    int64_t num_elements = 0;
+    for (auto i : contiguous) {
+      num_elements += inputs[i].numel();
+    }
+    const int64_t task_elements =
+        std::max<int64_t>(1, num_elements / std::max<int64_t>(1, num_tasks));
+    const int64_t grain_size =
+        std::max<int64_t>(1, internal::GRAIN_SIZE / task_elements);
+    parallel_for(0, num_tasks, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t task = begin; task < end; ++task) {
+        const auto& input = inputs[contiguous[task / outer]];
+        const int64_t row = task % outer;
+        const int64_t bytes = input.size(dim) * inner * element_size;
+        std::memcpy(
+            result_data + row * row_bytes +
+                offsets[contiguous[task / outer]] * inner * element_size,
+            static_cast<const char*>(input.data_ptr()) + row * bytes,
+            bytes);
+      }
+    });
+    copied = std::move(contiguous);
+  }
+
+  for (size_t i = 0, j = 0; i < inputs.size(); ++i) {
+    if (j < copied.size() && copied[j] == i) {
+      ++j;
+      continue;
+    }
+    if (inputs[i].numel() > 0) {
+      result.narrow(dim, offsets[i], inputs[i].size(dim)).copy_(inputs[i]);
+    }
+  }
+  return result;
+}
+
+Tensor & cat_out(Tensor & result, TensorList tensors, int64_t dim) {
+  check_cat_no_zero_dim(tensors);
+  dim = legacy_cat_wrap_dim(dim, tensors);
+  if (can_cat_cpu(result, tensors, dim)) {
+    return cat_out_cpu(result, tensors, dim);
+  }
+  return at::legacy::th::_th_cat_out(result, tensors, dim);
+}
+
+// Quantized tensors concatenate into a tensor with the quantizer of the first
+// one. The others are copied as they are when they have the same quantizer,
+// and requantized otherwise.
+static Tensor cat_quantized(TensorList tensors, int64_t dim) {
+  auto quantizer = get_qtensorimpl(tensors[0])->quantizer();
+  std::vector<Tensor> inputs;
+  for (const auto& t : tensors) {
+    TORCH_CHECK(t.is_quantized() && t.scalar_type() == tensors[0].scalar_type(),
+                "cat expects quantized tensors of the same type, got ",
+                tensors[0].type(), " and ", t.type());
+    if (cat_should_skip(t)) {
+      continue;
+    }
+    if (get_qtensorimpl(t)->quantizer()->equalTo(quantizer)) {
+      inputs.push_back(t);
+    } else {
+      TORCH_CHECK(quantizer->qscheme() == kPerTensorAffine,
+                  "cat only requantizes to per tensor affine quantized tensors, got ",
+                  toString(quantizer->qscheme()));
+      inputs.push_back(t.dequantize().quantize_linear(
+          tensors[0].q_scale().toDouble(), tensors[0].q_zero_point().toLong(), t.scalar_type()));
+    }
+  }
+  TORCH_CHECK(!inputs.empty(), "cat expects at least one non-empty tensor");
+  TORCH_CHECK(dim >= 0 && dim < inputs[0].dim(), "dimension out of range in cat");
+  auto sizes = inputs[0].sizes().vec();
+  sizes[dim] = 0;
+  for (const auto& t : inputs) {
+    TORCH_CHECK(sizes_match_except(inputs[0].sizes(), t.sizes(), dim),
+                "cat expects the sizes of the tensors to match except in dimension ", dim);
+    sizes[dim] += t.size(dim);
+  }
+  Tensor result = new_qtensor_cpu(sizes, tensors[0].options(), quantizer);
+  int64_t offset = 0;
+  for (const auto& t : inputs) {
+    if (t.numel() > 0) {
+      result.narrow(dim, offset, t.size(dim)).copy_(t);
+    }
+    offset += t.size(dim);
+  }
+  return result;
+}
+
 Tensor cat(TensorList tensors, int64_t dim) {
   if (tensors.size() > 0 &&
         tensors[0].is_sparse()) {
@@ -178,6 +349,15 @@ Tensor cat(TensorList tensors, int64_t dim) {
   }
   check_cat_no_zero_dim(tensors);
   dim = legacy_cat_wrap_dim(dim, tensors);
+  if (tensors.size() > 0 && tensors[0].is_quantized()) {
+    return cat_quantized(tensors, dim);
+  }
+  if (tensors.size() > 0 && tensors[0].type().backend() == Backend::CPU) {
+    Tensor result = at::empty({0}, tensors[0].options());
+    if (can_cat_cpu(result, tensors, dim)) {
+      return cat_out_cpu(result, tensors, dim);
+    }
+  }
   return at::legacy::th::_th_cat(tensors, dim);
 }
 
@@ -239,8 +419,8 @@ Tensor diagonal(const Tensor& self, int64_t offset, int64_t dim1_, int64_t dim2_
 
   // construct new size and stride: we drop dim1 and dim2 (maximum first for not changing the index of the minumum)
   // the new ("joint") dimension is appended to the end of the shape / stride to match numpy semantics
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes());
+  DimVector strides(self.strides());
   sizes.erase(sizes.begin() + std::max(dim1, dim2));
   strides.erase(strides.begin() + std::max(dim1, dim2));
   sizes.erase(sizes.begin() + std::min(dim1, dim2));
@@ -382,8 +562,8 @@ Tensor permute(const Tensor& self, IntArrayRef dims) {
            "number of dims don't match in permute");
   auto oldSizes = self.sizes();
   auto oldStrides = self.strides();
-  std::vector<int64_t> newSizes(nDims);
-  std::vector<int64_t> newStrides(nDims);
+  DimVector newSizes(static_cast<size_t>(nDims));
+  DimVector newStrides(static_cast<size_t>(nDims));
   std::vector<bool> seen(nDims);
   for (int64_t i = 0; i < nDims; i++) {
     auto dim = maybe_wrap_dim(dims[i], nDims);
@@ -460,8 +640,8 @@ Tensor select(const Tensor& self, int64_t dim, int64_t index) {
   if (index < 0) {
     index += size;
   }
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes());
+  DimVector strides(self.strides());
   auto storage_offset = self.storage_offset() + index * strides[dim];
   sizes.erase(sizes.begin() + dim);
   strides.erase(strides.begin() + dim);
@@ -474,8 +654,8 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
     AT_INDEX_ERROR("slice() cannot be applied to a 0-dim tensor.");
   }
   dim = maybe_wrap_dim(dim, ndim);
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes());
+  DimVector strides(self.strides());
   // TODO: support negative strides
   TORCH_CHECK(step > 0, "slice step must be positive");
   if (start < 0) {
@@ -613,8 +793,8 @@ Tensor & transpose_(Tensor & self, int64_t dim0, int64_t dim1) {
     return sparse_transpose_(self, dim0, dim1);
   }
 
-  auto strides = self.strides().vec();
-  auto sizes = self.sizes().vec();
+  DimVector strides(self.strides());
+  DimVector sizes(self.sizes());
   std::swap(strides[dim0], strides[dim1]);
   std::swap(sizes[dim0], sizes[dim1]);
   return self.as_strided_(sizes, strides);
@@ -633,8 +813,8 @@ Tensor transpose(const Tensor & self, int64_t dim0, int64_t dim1) {
     return sparse_transpose_(self_clone, dim0, dim1);
   }
 
-  auto strides = self.strides().vec();
-  auto sizes = self.sizes().vec();
+  DimVector strides(self.strides());
+  DimVector sizes(self.sizes());
   std::swap(strides[dim0], strides[dim1]);
   std::swap(sizes[dim0], sizes[dim1]);
   return self.as_strided(sizes, strides);
@@ -663,10 +843,10 @@ Tensor & t_(Tensor & self) {
   return self.transpose_(0, self.dim() < 2 ? 0 : 1);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferSqueezeGeometry(const Tensor &tensor) {
-  std::vector<int64_t> sizes;
-  std::vector<int64_t> strides;
+  DimVector sizes;
+  DimVector strides;
 
   for(int64_t d = 0; d < tensor.dim(); d++) {
     if(tensor.sizes()[d] != 1) {
@@ -678,10 +858,10 @@ inferSqueezeGeometry(const Tensor &tensor) {
   return std::make_tuple(sizes, strides);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferSqueezeGeometry(const Tensor& tensor, int64_t dim) {
-  std::vector<int64_t> sizes;
-  std::vector<int64_t> strides;
+  DimVector sizes;
+  DimVector strides;
 
   for(int64_t d = 0; d < tensor.dim(); d++) {
     if(d != dim || tensor.sizes()[dim] != 1) {
@@ -692,10 +872,10 @@ inferSqueezeGeometry(const Tensor& tensor, int64_t dim) {
   return std::make_tuple(sizes, strides);
 }
 
-std::tuple<std::vector<int64_t>, std::vector<int64_t> >
+std::tuple<DimVector, DimVector>
 inferUnsqueezeGeometry(const Tensor& tensor, int64_t dim) {
-  auto sizes = tensor.sizes().vec();
-  auto strides = tensor.strides().vec();
+  DimVector sizes(tensor.sizes());
+  DimVector strides(tensor.strides());
   int64_t new_stride = dim >= tensor.dim() ? 1 : sizes[dim] * strides[dim];
   sizes.insert(sizes.begin() + dim, 1);
   strides.insert(strides.begin() + dim, new_stride);
@@ -85,11 +85,37 @@ Tensor& _clamp_min_out_cpu(Tensor& result, const Tensor& self, Scalar min) {
   return legacy::th::_th_clamp_min_out(result, self, min);
 }
 
+// TH has no BFloat16, so its CPU tensors are filled here.
+static Tensor& fill_bfloat16_cpu_(Tensor& self, Scalar value) {
+  const auto fill_value = value.to<at::BFloat16>();
+  auto iter = TensorIterator::nullary_op(self);
+  iter->for_each([fill_value](int ntensors, char** data, const int64_t* strides, int64_t size) {
+    char* out = data[0];
+    for (int64_t i = 0; i < size; i++) {
+      *reinterpret_cast<at::BFloat16*>(out) = fill_value;
+      out += strides[0];
+    }
+  });
+  return self;
+}
+
+static inline bool is_bfloat16_cpu(const Tensor& self) {
+  return self.scalar_type() == kBFloat16 && self.type().backend() == Backend::CPU;
+}
+
 Tensor& fill_(Tensor& self, Scalar value) {
+  if (is_bfloat16_cpu(self)) {
+    return fill_bfloat16_cpu_(self, value);
+  }
   return at::legacy::th::_th_fill_(self, value);
 }
 
 Tensor& fill_(Tensor& self, const Tensor& value) {
+  if (is_bfloat16_cpu(self)) {
+    TORCH_CHECK(value.dim() == 0, "fill_ only supports 0-dimension value tensor but got tensor with ",
+                value.dim(), " dimensions.");
+    return fill_bfloat16_cpu_(self, value.item());
+  }
   return at::legacy::th::_th_fill_(self, value);
 }
 
@@ -42,6 +42,12 @@ DECLARE_DISPATCH(unary_fn, trunc_stub);
 
 DECLARE_DISPATCH(void(*)(Tensor&, const double, Generator *), bernoulli_mkl_stub);
 
+// Fill a contiguous tensor from the Philox stream of the given seed, see
+// Note [Parallel random fills on CPU]
+DECLARE_DISPATCH(void(*)(Tensor&, double, double, uint64_t), uniform_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, double, double, uint64_t), normal_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, double, uint64_t), bernoulli_scalar_stub);
+
 // Missing unary functions
 // digamma
 // lgamma
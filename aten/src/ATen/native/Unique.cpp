@@ -2,17 +2,60 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
+#include <algorithm>
+#include <numeric>
 #include <set>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Note [Parallel unique]
+// ~~~~~~~~~~~~~~~~~~~~~~
+// The input is split into a chunk per thread, and each thread builds a hash
+// table of the values of its chunk, numbering them in the order they're first
+// seen, and counting them. The ids of the values are written to the inverse
+// indices right away. The tables are then merged into shards of the unique
+// values, a shard per thread, by the hash of the values. Finally, the ids of
+// each chunk are translated to the position of their value in the output:
+// the unique values of the shards one after another, or sorted. So inverse
+// indices and counts take the same hash table lookups as the unique values
+// themselves.
+
+constexpr int64_t UNIQUE_CHUNK_MIN_SIZE = 1 << 16;
+
+// The unique values of a part of the input, in the order of their ids
+template <typename scalar_t>
+struct UniqueTable {
+  ska::flat_hash_map<scalar_t, int64_t> ids;
+  std::vector<scalar_t> values;
+  std::vector<int64_t> counts;
+
+  int64_t insert(scalar_t value, int64_t count) {
+    auto it = ids.emplace(value, values.size());
+    if (it.second) {
+      values.push_back(value);
+      counts.push_back(0);
+    }
+    counts[it.first->second] += count;
+    return it.first->second;
+  }
+};
+
+template <typename scalar_t>
+inline int64_t unique_shard(scalar_t value, int64_t num_shards) {
+  // Fibonacci hashing, so that similar hashes end up in different shards
+  const uint64_t hash = static_cast<uint64_t>(std::hash<scalar_t>{}(value));
+  return static_cast<int64_t>((hash * 11400714819323198485ull) >> 32) % num_shards;
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,50 +65,135 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data<scalar_t>();
+  // The ids of the values in their chunk, and then their positions in the
+  // output
+  int64_t* ids_data = nullptr;
+  if (return_inverse || return_counts) {
+    inverse_indices.resize_(input.sizes());
+    ids_data = inverse_indices.data<int64_t>();
+  }
 
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / UNIQUE_CHUNK_MIN_SIZE));
+  auto chunk_begin = [&](int64_t c) { return c * numel / num_chunks; };
+  const int64_t num_shards = num_chunks;
+  std::vector<UniqueTable<scalar_t>> chunks(num_chunks);
+  // shard_ids[c][s] are the ids of chunk c of the values in shard s
+  std::vector<std::vector<std::vector<int64_t>>> shard_ids(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      auto& table = chunks[c];
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+        const int64_t id = table.insert(input_data[i], 1);
+        if (ids_data) {
+          ids_data[i] = id;
+        }
+      }
+      if (num_shards > 1) {
+        shard_ids[c].resize(num_shards);
+        for (size_t id = 0; id < table.values.size(); id++) {
+          shard_ids[c][unique_shard(table.values[id], num_shards)].push_back(id);
+        }
+      }
+    }
+  });
+
+  // positions[c][id] is the position in the output of the value with the id
+  // in chunk c
+  std::vector<std::vector<int64_t>> positions(num_chunks);
+  std::vector<UniqueTable<scalar_t>> shards;
+  if (num_shards == 1) {
+    shards = std::move(chunks);
+    positions[0].resize(shards[0].values.size());
+    std::iota(positions[0].begin(), positions[0].end(), 0);
   } else {
-    std::copy(set.begin(), set.end(), output_data);
+    // See Note [Parallel unique]
+    shards.resize(num_shards);
+    for (int64_t c = 0; c < num_chunks; c++) {
+      positions[c].resize(chunks[c].values.size());
+    }
+    at::parallel_for(0, num_shards, 1, [&](int64_t s_begin, int64_t s_end) {
+      for (int64_t s = s_begin; s < s_end; s++) {
+        for (int64_t c = 0; c < num_chunks; c++) {
+          const auto& chunk = chunks[c];
+          for (auto id : shard_ids[c][s]) {
+            // The offset of the shard is added below
+            positions[c][id] = shards[s].insert(chunk.values[id], chunk.counts[id]);
+          }
+        }
+      }
+    });
+    std::vector<int64_t> shard_offsets(num_shards + 1, 0);
+    for (int64_t s = 0; s < num_shards; s++) {
+      shard_offsets[s + 1] = shard_offsets[s] + shards[s].values.size();
+    }
+    at::parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+      for (int64_t c = c_begin; c < c_end; c++) {
+        for (int64_t s = 0; s < num_shards; s++) {
+          for (auto id : shard_ids[c][s]) {
+            positions[c][id] += shard_offsets[s];
+          }
+        }
+      }
+    });
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  int64_t num_unique = 0;
+  for (const auto& shard : shards) {
+    num_unique += shard.values.size();
+  }
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data<scalar_t>();
+  if (return_counts) {
+    counts.resize_({num_unique});
+  }
+  int64_t* counts_data = return_counts ? counts.data<int64_t>() : nullptr;
+
+  // Sorting permutes the positions
+  std::vector<int64_t> order;
+  if (sorted) {
+    std::vector<std::pair<scalar_t, int64_t>> unique_values;
+    unique_values.reserve(num_unique);
+    for (const auto& shard : shards) {
+      for (auto value : shard.values) {
+        unique_values.emplace_back(value, unique_values.size());
+      }
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    std::sort(unique_values.begin(), unique_values.end());
+    order.resize(num_unique);
+    for (int64_t i = 0; i < num_unique; i++) {
+      order[unique_values[i].second] = i;
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
-      }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    for (auto& chunk_positions : positions) {
+      for (auto& position : chunk_positions) {
+        position = order[position];
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    }
+  }
+  int64_t position = 0;
+  for (const auto& shard : shards) {
+    for (size_t id = 0; id < shard.values.size(); id++, position++) {
+      const int64_t out = sorted ? order[position] : position;
+      output_data[out] = shard.values[id];
+      if (counts_data) {
+        counts_data[out] = shard.counts[id];
       }
     }
   }
+
+  if (ids_data) {
+    at::parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+      for (int64_t c = c_begin; c < c_end; c++) {
+        const auto& chunk_positions = positions[c];
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          ids_data[i] = chunk_positions[ids_data[i]];
+        }
+      }
+    });
+  }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
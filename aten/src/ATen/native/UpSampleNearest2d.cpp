@@ -1,6 +1,12 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/ChannelsLast.h>
 #include <ATen/native/UpSample.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace at {
 namespace native {
@@ -61,6 +67,48 @@ static void upsample_nearest2d_out_frame(
   }
 }
 
+// The same for channels last `odata` and `idata`, see
+// Note [Channels last on CPU]: each output pixel copies the C channels of its
+// input pixel at once.
+template <typename scalar_t>
+static void upsample_nearest2d_out_frame_channels_last(
+    scalar_t* odata,
+    const scalar_t* idata,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t nbatch,
+    int64_t channels) {
+  const float height_scale = (float)input_height / (float)output_height;
+  const float width_scale = (float)input_width / (float)output_width;
+  const int64_t row_size = std::max<int64_t>(output_width * channels, 1);
+
+  parallel_for(
+      0,
+      nbatch * output_height,
+      std::max<int64_t>(internal::GRAIN_SIZE / row_size, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t n = i / output_height;
+          const int64_t h2 = i % output_height;
+          const int64_t h1 =
+              nearest_neighbor_compute_source_index(height_scale, h2, input_height);
+          const scalar_t* irow = idata + (n * input_height + h1) * input_width * channels;
+          scalar_t* orow = odata + i * output_width * channels;
+
+          for (int64_t w2 = 0; w2 < output_width; ++w2) {
+            const int64_t w1 =
+                nearest_neighbor_compute_source_index(width_scale, w2, input_width);
+            std::memcpy(
+                orow + w2 * channels,
+                irow + w1 * channels,
+                channels * sizeof(scalar_t));
+          }
+        }
+      });
+}
+
 template <typename scalar_t>
 static void upsample_nearest2d_backward_out_frame(
     scalar_t* odata,
@@ -142,9 +190,25 @@ static void upsample_nearest2d_out_cpu_template(
       output_height,
       output_width);
 
+  output.resize_({nbatch, channels, output_height, output_width});
+
+  if (is_channels_last(input_) && is_channels_last(output)) {
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(input_.scalar_type(), "upsample_nearest2d", [&] {
+      upsample_nearest2d_out_frame_channels_last<scalar_t>(
+          output.data<scalar_t>(),
+          input_.data<scalar_t>(),
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          nbatch,
+          channels);
+    });
+    return;
+  }
+
   auto input = input_.contiguous();
 
-  output.resize_({nbatch, channels, output_height, output_width});
   output.zero_();
 
   AT_ASSERT(input_width > 0 && output_width > 0);
@@ -230,11 +294,83 @@ Tensor& upsample_nearest2d_out_cpu(
 }
 
 Tensor upsample_nearest2d_cpu(const Tensor& input, IntArrayRef output_size) {
-  auto output = at::empty({0}, input.options());
+  // channels last inputs upsample to channels last outputs
+  auto output = is_channels_last(input) && output_size.size() == 2 &&
+          output_size[0] > 0 && output_size[1] > 0
+      ? empty_channels_last(
+            {input.size(0), input.size(1), output_size[0], output_size[1]},
+            input.options())
+      : at::empty({0}, input.options());
   upsample_nearest2d_out_cpu_template(output, input, output_size);
   return output;
 }
 
+// Nearest upsampling only copies values, so quantized tensors upsample their
+// integer values and keep their quantizer.
+Tensor quantized_upsample_nearest2d_cpu(const Tensor& input, IntArrayRef output_size) {
+  TORCH_CHECK(
+      output_size.size() == 2,
+      "It is expected output_size equals to 2, but got size ",
+      output_size.size());
+  TORCH_CHECK(
+      input.dim() == 4,
+      "quantized upsample_nearest2d expects a 4-d input, but got ",
+      input.dim(), " dimensions");
+
+  int64_t output_height = output_size[0];
+  int64_t output_width = output_size[1];
+
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t input_height = input.size(2);
+  int64_t input_width = input.size(3);
+
+  upsample_2d_shape_check(
+      input,
+      Tensor(),
+      nbatch,
+      channels,
+      input_height,
+      input_width,
+      output_height,
+      output_width);
+
+  auto quantizer = get_qtensorimpl(input)->quantizer();
+  if (is_channels_last(input)) {
+    Tensor output = new_qtensor_cpu(
+        {nbatch, output_height, output_width, channels}, input.options(), quantizer)
+        .permute({0, 3, 1, 2});
+    AT_DISPATCH_QINT_TYPES(input.scalar_type(), "quantized_upsample_nearest2d", [&] {
+      upsample_nearest2d_out_frame_channels_last<scalar_t>(
+          output.data<scalar_t>(),
+          input.data<scalar_t>(),
+          input_height,
+          input_width,
+          output_height,
+          output_width,
+          nbatch,
+          channels);
+    });
+    return output;
+  }
+
+  auto input_contig = input.contiguous();
+  Tensor output = new_qtensor_cpu(
+      {nbatch, channels, output_height, output_width}, input.options(), quantizer);
+  AT_DISPATCH_QINT_TYPES(input.scalar_type(), "quantized_upsample_nearest2d", [&] {
+    upsample_nearest2d_out_frame<scalar_t>(
+        output.data<scalar_t>(),
+        input_contig.data<scalar_t>(),
+        input_height,
+        input_width,
+        output_height,
+        output_width,
+        nbatch,
+        channels);
+  });
+  return output;
+}
+
 Tensor& upsample_nearest2d_backward_out_cpu(
     Tensor& grad_input,
     const Tensor& grad_output,
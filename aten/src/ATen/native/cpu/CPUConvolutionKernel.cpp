@@ -0,0 +1,422 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/CPUConvolution.h>
+#include <TH/THBlasUtils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace at { namespace native { namespace {
+
+using namespace vec256;
+
+// Row major C[m x n] = A[m x k] * B[k x n] + beta * C, with leading
+// dimensions lda, ldb and ldc. BLAS is column major, so this computes
+// C^T = B^T * A^T instead.
+template <typename scalar_t>
+static inline void gemm_row_major(
+    int64_t m, int64_t n, int64_t k,
+    const scalar_t* a, int64_t lda,
+    const scalar_t* b, int64_t ldb,
+    scalar_t beta, scalar_t* c, int64_t ldc) {
+  THBlas_gemm<scalar_t>(
+      'n', 'n', n, m, k, 1,
+      const_cast<scalar_t*>(b), ldb, const_cast<scalar_t*>(a), lda,
+      beta, c, ldc);
+}
+
+// The geometry of a 3D convolution of one group, see cpu_convolution_im2col.
+struct ConvGeometry {
+  int64_t in_channels, id, ih, iw;
+  int64_t out_channels, od, oh, ow;
+  int64_t kd, kh, kw;
+  int64_t sd, sh, sw;
+  int64_t pd, ph, pw;
+  int64_t dd, dh, dw;
+};
+
+// Writes the im2col columns of the `len` output pixels starting at `p0` into
+// `columns`, a [in_channels * kd * kh * kw, len] matrix.
+template <typename scalar_t>
+static void im2col_tile(
+    const scalar_t* input, scalar_t* columns, int64_t p0, int64_t len,
+    const ConvGeometry& g) {
+  const int64_t in_plane = g.id * g.ih * g.iw;
+  scalar_t* col = columns;
+  for (int64_t c = 0; c < g.in_channels; c++) {
+    const scalar_t* in_c = input + c * in_plane;
+    for (int64_t a = 0; a < g.kd; a++) {
+      for (int64_t b = 0; b < g.kh; b++) {
+        for (int64_t e = 0; e < g.kw; e++, col += len) {
+          int64_t x = p0 % g.ow;
+          int64_t y = (p0 / g.ow) % g.oh;
+          int64_t z = p0 / (g.ow * g.oh);
+          int64_t i = 0;
+          // one output row at a time
+          while (i < len) {
+            const int64_t count = std::min(g.ow - x, len - i);
+            const int64_t iz = z * g.sd - g.pd + a * g.dd;
+            const int64_t iy = y * g.sh - g.ph + b * g.dh;
+            scalar_t* dst = col + i;
+            if (iz < 0 || iz >= g.id || iy < 0 || iy >= g.ih) {
+              std::fill(dst, dst + count, scalar_t(0));
+            } else {
+              const scalar_t* row = in_c + (iz * g.ih + iy) * g.iw;
+              const int64_t ix = x * g.sw - g.pw + e * g.dw;
+              if (g.sw == 1) {
+                const int64_t j_begin = std::min(std::max<int64_t>(-ix, 0), count);
+                const int64_t j_end = std::max(std::min(g.iw - ix, count), j_begin);
+                std::fill(dst, dst + j_begin, scalar_t(0));
+                std::memcpy(dst + j_begin, row + ix + j_begin, (j_end - j_begin) * sizeof(scalar_t));
+                std::fill(dst + j_end, dst + count, scalar_t(0));
+              } else {
+                for (int64_t j = 0; j < count; j++) {
+                  const int64_t jx = ix + j * g.sw;
+                  dst[j] = (jx >= 0 && jx < g.iw) ? row[jx] : scalar_t(0);
+                }
+              }
+            }
+            i += count;
+            x = 0;
+            if (++y == g.oh) {
+              y = 0;
+              z++;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename scalar_t>
+void cpu_convolution_im2col(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  ConvGeometry g;
+  g.in_channels = input.size(1) / groups;
+  g.id = input.size(2);
+  g.ih = input.size(3);
+  g.iw = input.size(4);
+  g.out_channels = output.size(1) / groups;
+  g.od = output.size(2);
+  g.oh = output.size(3);
+  g.ow = output.size(4);
+  g.kd = weight.size(2);
+  g.kh = weight.size(3);
+  g.kw = weight.size(4);
+  g.sd = stride[0];
+  g.sh = stride[1];
+  g.sw = stride[2];
+  g.pd = padding[0];
+  g.ph = padding[1];
+  g.pw = padding[2];
+  g.dd = dilation[0];
+  g.dh = dilation[1];
+  g.dw = dilation[2];
+
+  const int64_t nbatch = input.size(0);
+  const int64_t in_plane = g.id * g.ih * g.iw;
+  const int64_t out_plane = g.od * g.oh * g.ow;
+  const int64_t kernel = g.in_channels * g.kd * g.kh * g.kw;
+  const bool is_pointwise = g.kd * g.kh * g.kw == 1 &&
+      g.sd == 1 && g.sh == 1 && g.sw == 1 &&
+      g.pd == 0 && g.ph == 0 && g.pw == 0;
+
+  // See Note [Native CPU convolution]
+  int64_t tile = kCPUConvolutionWorkspaceSize / (kernel * sizeof(scalar_t));
+  tile = std::min(std::max<int64_t>(tile / 16 * 16, 16), out_plane);
+  const int64_t num_tiles = (out_plane + tile - 1) / tile;
+
+  const scalar_t* input_data = input.data<scalar_t>();
+  const scalar_t* weight_data = weight.data<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data<scalar_t>();
+
+  parallel_for(0, nbatch * groups * num_tiles, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> columns(is_pointwise ? 0 : kernel * tile);
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t t = task % num_tiles;
+      const int64_t ng = task / num_tiles;
+      const int64_t group = ng % groups;
+      const int64_t p0 = t * tile;
+      const int64_t len = std::min(tile, out_plane - p0);
+      const scalar_t* in = input_data + ng * g.in_channels * in_plane;
+      const scalar_t* w = weight_data + group * g.out_channels * kernel;
+      scalar_t* out = output_data + ng * g.out_channels * out_plane + p0;
+
+      const scalar_t* cols = in + p0;
+      int64_t ld_cols = in_plane;
+      if (!is_pointwise) {
+        im2col_tile(in, columns.data(), p0, len, g);
+        cols = columns.data();
+        ld_cols = len;
+      }
+      scalar_t beta = 0;
+      if (bias_data) {
+        for (int64_t oc = 0; oc < g.out_channels; oc++) {
+          std::fill(out + oc * out_plane, out + oc * out_plane + len,
+                    bias_data[group * g.out_channels + oc]);
+        }
+        beta = 1;
+      }
+      gemm_row_major(g.out_channels, len, kernel, w, kernel, cols, ld_cols, beta, out, out_plane);
+    }
+  });
+}
+
+template <typename scalar_t>
+void cpu_convolution_depthwise(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t ih = input.size(2);
+  const int64_t iw = input.size(3);
+  const int64_t out_channels = output.size(1);
+  const int64_t oh = output.size(2);
+  const int64_t ow = output.size(3);
+  const int64_t kh = weight.size(2);
+  const int64_t kw = weight.size(3);
+  const int64_t sh = stride[0];
+  const int64_t sw = stride[1];
+  const int64_t ph = padding[0];
+  const int64_t pw = padding[1];
+  const int64_t dh = dilation[0];
+  const int64_t dw = dilation[1];
+  const int64_t multiplier = out_channels / channels;
+
+  // blocks of output rows of one plane
+  const int64_t rows = std::min(
+      std::max<int64_t>(internal::GRAIN_SIZE / (ow * kh * kw), 1), oh);
+  const int64_t num_blocks = (oh + rows - 1) / rows;
+
+  const scalar_t* input_data = input.data<scalar_t>();
+  const scalar_t* weight_data = weight.data<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data<scalar_t>();
+
+  parallel_for(0, nbatch * out_channels * num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t block = task % num_blocks;
+      const int64_t plane = task / num_blocks;
+      const int64_t n = plane / out_channels;
+      const int64_t oc = plane % out_channels;
+      const scalar_t* in = input_data + (n * channels + oc / multiplier) * ih * iw;
+      const scalar_t* w = weight_data + oc * kh * kw;
+      scalar_t* out = output_data + plane * oh * ow;
+      const scalar_t b = bias_data ? bias_data[oc] : scalar_t(0);
+
+      for (int64_t y = block * rows; y < std::min((block + 1) * rows, oh); y++) {
+        scalar_t* out_row = out + y * ow;
+        std::fill(out_row, out_row + ow, b);
+        for (int64_t i = 0; i < kh; i++) {
+          const int64_t iy = y * sh - ph + i * dh;
+          if (iy < 0 || iy >= ih) {
+            continue;
+          }
+          const scalar_t* in_row = in + iy * iw;
+          for (int64_t j = 0; j < kw; j++) {
+            const scalar_t wv = w[i * kw + j];
+            // out_row[x] reads in_row[x * sw + offset]
+            const int64_t offset = j * dw - pw;
+            const int64_t x_begin = std::min(offset >= 0 ? 0 : (sw - 1 - offset) / sw, ow);
+            const int64_t x_end = iw - offset <= 0 ? x_begin :
+                std::max(std::min((iw - offset + sw - 1) / sw, ow), x_begin);
+            int64_t x = x_begin;
+            if (sw == 1) {
+              const Vec wvec(wv);
+              for (; x + Vec::size() <= x_end; x += Vec::size()) {
+                Vec acc = Vec::loadu(out_row + x);
+                acc = vec256::fmadd(Vec::loadu(in_row + x + offset), wvec, acc);
+                acc.store(out_row + x);
+              }
+            }
+            for (; x < x_end; x++) {
+              out_row[x] += wv * in_row[x * sw + offset];
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+// Winograd F(2x2, 3x3), see Note [Native CPU convolution]. With the usual
+// matrices B, G and A of Lavin and Gray, "Fast Algorithms for Convolutional
+// Neural Networks", a 2x2 output tile is A^T [(G g G^T) * (B^T d B)] A for a
+// 3x3 kernel g and the 4x4 input tile d around it. The elementwise product is
+// summed over the input channels, which makes it 16 matrix products.
+template <typename scalar_t>
+static inline void winograd_weight_transform(const scalar_t* g, scalar_t* u, int64_t u_stride) {
+  scalar_t t[4][3];
+  for (int j = 0; j < 3; j++) {
+    t[0][j] = g[j];
+    t[1][j] = scalar_t(0.5) * (g[j] + g[3 + j] + g[6 + j]);
+    t[2][j] = scalar_t(0.5) * (g[j] - g[3 + j] + g[6 + j]);
+    t[3][j] = g[6 + j];
+  }
+  for (int i = 0; i < 4; i++) {
+    u[(i * 4 + 0) * u_stride] = t[i][0];
+    u[(i * 4 + 1) * u_stride] = scalar_t(0.5) * (t[i][0] + t[i][1] + t[i][2]);
+    u[(i * 4 + 2) * u_stride] = scalar_t(0.5) * (t[i][0] - t[i][1] + t[i][2]);
+    u[(i * 4 + 3) * u_stride] = t[i][2];
+  }
+}
+
+template <typename scalar_t>
+static inline void winograd_input_transform(const scalar_t d[4][4], scalar_t* v, int64_t v_stride) {
+  scalar_t t[4][4];
+  for (int j = 0; j < 4; j++) {
+    t[0][j] = d[0][j] - d[2][j];
+    t[1][j] = d[1][j] + d[2][j];
+    t[2][j] = d[2][j] - d[1][j];
+    t[3][j] = d[1][j] - d[3][j];
+  }
+  for (int i = 0; i < 4; i++) {
+    v[(i * 4 + 0) * v_stride] = t[i][0] - t[i][2];
+    v[(i * 4 + 1) * v_stride] = t[i][1] + t[i][2];
+    v[(i * 4 + 2) * v_stride] = t[i][2] - t[i][1];
+    v[(i * 4 + 3) * v_stride] = t[i][1] - t[i][3];
+  }
+}
+
+template <typename scalar_t>
+static inline void winograd_output_transform(const scalar_t* m, int64_t m_stride, scalar_t y[2][2]) {
+  scalar_t t[2][4];
+  for (int j = 0; j < 4; j++) {
+    t[0][j] = m[j * m_stride] + m[(4 + j) * m_stride] + m[(8 + j) * m_stride];
+    t[1][j] = m[(4 + j) * m_stride] - m[(8 + j) * m_stride] - m[(12 + j) * m_stride];
+  }
+  for (int i = 0; i < 2; i++) {
+    y[i][0] = t[i][0] + t[i][1] + t[i][2];
+    y[i][1] = t[i][1] - t[i][2] - t[i][3];
+  }
+}
+
+template <typename scalar_t>
+void cpu_convolution_winograd(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t ih = input.size(2);
+  const int64_t iw = input.size(3);
+  const int64_t out_channels = output.size(1);
+  const int64_t oh = output.size(2);
+  const int64_t ow = output.size(3);
+  const int64_t ph = padding[0];
+  const int64_t pw = padding[1];
+  const int64_t tiles_h = (oh + 1) / 2;
+  const int64_t tiles_w = (ow + 1) / 2;
+  const int64_t num_tiles = tiles_h * tiles_w;
+
+  const scalar_t* input_data = input.data<scalar_t>();
+  const scalar_t* weight_data = weight.data<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data<scalar_t>();
+
+  // the transformed weights, as 16 [out_channels, channels] matrices
+  const int64_t u_stride = out_channels * channels;
+  std::vector<scalar_t> u(16 * u_stride);
+  parallel_for(0, u_stride, internal::GRAIN_SIZE / 32, [&](int64_t begin, int64_t end) {
+    for (int64_t k = begin; k < end; k++) {
+      winograd_weight_transform(weight_data + k * 9, u.data() + k, u_stride);
+    }
+  });
+
+  // the transformed inputs and the products of a block of tiles fit in the
+  // workspace
+  int64_t block = kCPUConvolutionWorkspaceSize /
+      (16 * (channels + out_channels) * sizeof(scalar_t));
+  block = std::min(std::max<int64_t>(block, 8), num_tiles);
+  const int64_t num_blocks = (num_tiles + block - 1) / block;
+
+  parallel_for(0, nbatch * num_blocks, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> v(16 * channels * block);
+    std::vector<scalar_t> m(16 * out_channels * block);
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t n = task / num_blocks;
+      const int64_t t0 = (task % num_blocks) * block;
+      const int64_t len = std::min(block, num_tiles - t0);
+      // v holds 16 [channels, len] matrices
+      const int64_t v_stride = channels * len;
+      for (int64_t c = 0; c < channels; c++) {
+        const scalar_t* in = input_data + (n * channels + c) * ih * iw;
+        for (int64_t t = 0; t < len; t++) {
+          const int64_t y0 = ((t0 + t) / tiles_w) * 2 - ph;
+          const int64_t x0 = ((t0 + t) % tiles_w) * 2 - pw;
+          scalar_t d[4][4];
+          for (int64_t i = 0; i < 4; i++) {
+            for (int64_t j = 0; j < 4; j++) {
+              const int64_t y = y0 + i;
+              const int64_t x = x0 + j;
+              d[i][j] = (y >= 0 && y < ih && x >= 0 && x < iw) ? in[y * iw + x] : scalar_t(0);
+            }
+          }
+          winograd_input_transform(d, v.data() + c * len + t, v_stride);
+        }
+      }
+      // m holds 16 [out_channels, len] matrices
+      const int64_t m_stride = out_channels * len;
+      for (int64_t xi = 0; xi < 16; xi++) {
+        gemm_row_major(
+            out_channels, len, channels,
+            u.data() + xi * u_stride, channels,
+            v.data() + xi * v_stride, len,
+            scalar_t(0), m.data() + xi * m_stride, len);
+      }
+      for (int64_t oc = 0; oc < out_channels; oc++) {
+        scalar_t* out = output_data + (n * out_channels + oc) * oh * ow;
+        const scalar_t b = bias_data ? bias_data[oc] : scalar_t(0);
+        for (int64_t t = 0; t < len; t++) {
+          const int64_t y0 = ((t0 + t) / tiles_w) * 2;
+          const int64_t x0 = ((t0 + t) % tiles_w) * 2;
+          scalar_t y[2][2];
+          winograd_output_transform(m.data() + oc * len + t, m_stride, y);
+          for (int64_t i = 0; i < 2 && y0 + i < oh; i++) {
+            for (int64_t j = 0; j < 2 && x0 + j < ow; j++) {
+              out[(y0 + i) * ow + x0 + j] = y[i][j] + b;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void cpu_convolution_im2col_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "cpu_convolution_im2col", [&] {
+    cpu_convolution_im2col<scalar_t>(output, input, weight, bias, stride, padding, dilation, groups);
+  });
+}
+
+void cpu_convolution_depthwise_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "cpu_convolution_depthwise", [&] {
+    cpu_convolution_depthwise<scalar_t>(output, input, weight, bias, stride, padding, dilation, groups);
+  });
+}
+
+void cpu_convolution_winograd_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation, int64_t groups) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "cpu_convolution_winograd", [&] {
+    cpu_convolution_winograd<scalar_t>(output, input, weight, bias, stride, padding, dilation, groups);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(cpu_convolution_im2col_stub, &cpu_convolution_im2col_kernel);
+REGISTER_DISPATCH(cpu_convolution_depthwise_stub, &cpu_convolution_depthwise_kernel);
+REGISTER_DISPATCH(cpu_convolution_winograd_stub, &cpu_convolution_winograd_kernel);
+
+}} // namespace at::native
@@ -1,19 +1,24 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/intrinsics.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
 
+#include <algorithm>
+
 namespace at {
 namespace native {
 namespace {
 
 template <typename self_T>
 void copy_kernel_cast(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND2(
+  AT_DISPATCH_ALL_TYPES_AND3(
       ScalarType::Half,
       ScalarType::Bool,
+      ScalarType::BFloat16,
       iter.dtype(1),
       "copy_kernel_cast",
       [&] {
@@ -24,11 +29,181 @@ void copy_kernel_cast(TensorIterator& iter) {
       });
 }
 
+// Note [Tiled transposing copies]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A copy between tensors of the same dtype whose innermost dimensions differ,
+// like x.permute(0, 2, 3, 1).contiguous() or x.t().contiguous(), is a batch
+// of matrix transposes: the dimension `a` along which `self` is contiguous and
+// the dimension `b` along which `src` is, both of the (coalesced) iterator.
+// Copied element by element, either every read or every write is a cache miss
+// for large matrices, so the matrices are copied in tiles of kTileSize x
+// kTileSize elements instead, transposed in registers where we can, going
+// through the matrices in blocks of kBlockSize rows of `self` (in parallel).
+// Only the bits are moved, so the dtype matters only through its size.
+
+constexpr int64_t kTileSize = 8;
+constexpr int64_t kBlockSize = 64;
+
+// Transposes the kTileSize x kTileSize tile of `src` with rows `ld_src`
+// elements apart into `dst`, with rows `ld_dst` elements apart.
+template <typename scalar_t>
+void transpose_tile(const scalar_t* src, int64_t ld_src, scalar_t* dst, int64_t ld_dst) {
+  for (int64_t i = 0; i < kTileSize; i++) {
+    for (int64_t j = 0; j < kTileSize; j++) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
+#if defined(__AVX__) && !defined(_MSC_VER)
+
+template <>
+void transpose_tile<uint32_t>(const uint32_t* src, int64_t ld_src, uint32_t* dst, int64_t ld_dst) {
+  __m256 r0 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 0 * ld_src));
+  __m256 r1 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 1 * ld_src));
+  __m256 r2 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 2 * ld_src));
+  __m256 r3 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 3 * ld_src));
+  __m256 r4 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 4 * ld_src));
+  __m256 r5 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 5 * ld_src));
+  __m256 r6 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 6 * ld_src));
+  __m256 r7 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 7 * ld_src));
+  // interleave pairs of rows, then pairs of pairs, within each 128-bit lane
+  __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+  __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+  __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+  __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+  __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+  __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+  __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+  __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+  r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+  // and swap the lanes of the upper and lower four rows
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 0 * ld_dst), _mm256_permute2f128_ps(r0, r4, 0x20));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 1 * ld_dst), _mm256_permute2f128_ps(r1, r5, 0x20));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 2 * ld_dst), _mm256_permute2f128_ps(r2, r6, 0x20));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 3 * ld_dst), _mm256_permute2f128_ps(r3, r7, 0x20));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 4 * ld_dst), _mm256_permute2f128_ps(r0, r4, 0x31));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 5 * ld_dst), _mm256_permute2f128_ps(r1, r5, 0x31));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 6 * ld_dst), _mm256_permute2f128_ps(r2, r6, 0x31));
+  _mm256_storeu_ps(reinterpret_cast<float*>(dst + 7 * ld_dst), _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+#endif
+
+// Finds the dimensions `a` and `b` of Note [Tiled transposing copies], if the
+// copy is a batch of transposes large enough to tile.
+static bool is_transposing_copy(const TensorIterator& iter, int& a, int& b) {
+  const int64_t element_size = iter.element_size(0);
+  if (iter.dtype(0) != iter.dtype(1) || iter.ndim() < 2 ||
+      iter.device_type(0) != kCPU || iter.device_type(1) != kCPU) {
+    return false;
+  }
+  auto shape = iter.shape();
+  auto dst_strides = iter.strides(0);
+  auto src_strides = iter.strides(1);
+  a = -1;
+  b = -1;
+  for (int dim = 0; dim < iter.ndim(); dim++) {
+    if (shape[dim] < kTileSize) {
+      continue;
+    }
+    if (a < 0 && dst_strides[dim] == element_size) {
+      a = dim;
+    }
+    if (b < 0 && src_strides[dim] == element_size) {
+      b = dim;
+    }
+  }
+  return a >= 0 && b >= 0 && a != b && src_strides[a] != element_size &&
+      dst_strides[b] != element_size;
+}
+
+template <typename scalar_t>
+void transpose_copy_kernel(TensorIterator& iter, int a, int b) {
+  auto shape = iter.shape();
+  auto dst_strides = iter.strides(0);
+  auto src_strides = iter.strides(1);
+  const int64_t a_size = shape[a];
+  const int64_t b_size = shape[b];
+  // the strides of the rows of `src` (along `a`) and of `self` (along `b`)
+  const int64_t ld_src = src_strides[a] / sizeof(scalar_t);
+  const int64_t ld_dst = dst_strides[b] / sizeof(scalar_t);
+  DimVector batch_sizes, dst_batch_strides, src_batch_strides;
+  for (int dim = 0; dim < iter.ndim(); dim++) {
+    if (dim != a && dim != b) {
+      batch_sizes.push_back(shape[dim]);
+      dst_batch_strides.push_back(dst_strides[dim]);
+      src_batch_strides.push_back(src_strides[dim]);
+    }
+  }
+  const int64_t num_blocks = (b_size + kBlockSize - 1) / kBlockSize;
+  const int64_t num_matrices = iter.numel() / (a_size * b_size);
+  char* dst_data = static_cast<char*>(iter.data_ptr(0));
+  const char* src_data = static_cast<const char*>(iter.data_ptr(1));
+
+  parallel_for(
+      0,
+      num_matrices * num_blocks,
+      std::max<int64_t>(internal::GRAIN_SIZE / (kBlockSize * a_size), 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; task++) {
+          int64_t matrix = task / num_blocks;
+          int64_t dst_offset = 0;
+          int64_t src_offset = 0;
+          for (size_t dim = 0; dim < batch_sizes.size(); dim++) {
+            const int64_t idx = matrix % batch_sizes[dim];
+            matrix /= batch_sizes[dim];
+            dst_offset += idx * dst_batch_strides[dim];
+            src_offset += idx * src_batch_strides[dim];
+          }
+          auto dst = reinterpret_cast<scalar_t*>(dst_data + dst_offset);
+          auto src = reinterpret_cast<const scalar_t*>(src_data + src_offset);
+          const int64_t b_begin = (task % num_blocks) * kBlockSize;
+          const int64_t b_end = std::min(b_begin + kBlockSize, b_size);
+          const int64_t b_tiled = b_begin + (b_end - b_begin) / kTileSize * kTileSize;
+          const int64_t a_tiled = a_size / kTileSize * kTileSize;
+          for (int64_t i = 0; i < a_tiled; i += kTileSize) {
+            for (int64_t j = b_begin; j < b_tiled; j += kTileSize) {
+              transpose_tile(src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+            }
+          }
+          // the partial tiles at the edges
+          for (int64_t i = 0; i < a_size; i++) {
+            for (int64_t j = (i < a_tiled ? b_tiled : b_begin); j < b_end; j++) {
+              dst[j * ld_dst + i] = src[i * ld_src + j];
+            }
+          }
+        }
+      });
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
+  int a, b;
+  if (is_transposing_copy(iter, a, b)) {
+    // See Note [Tiled transposing copies]
+    switch (iter.element_size(0)) {
+      case 1: return transpose_copy_kernel<uint8_t>(iter, a, b);
+      case 2: return transpose_copy_kernel<uint16_t>(iter, a, b);
+      case 4: return transpose_copy_kernel<uint32_t>(iter, a, b);
+      case 8: return transpose_copy_kernel<uint64_t>(iter, a, b);
+    }
+  }
   if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       unary_kernel(iter, [=](at::Half a) -> at::Half { return a; });
+    } else if (dtype == ScalarType::BFloat16) {
+      unary_kernel_vec(
+          iter,
+          [=](at::BFloat16 a) -> at::BFloat16 { return a; },
+          [=](Vec256<at::BFloat16> a) { return a; });
     } else {
       AT_DISPATCH_ALL_TYPES_AND(
           ScalarType::Bool, dtype, "copy_kernel", [&] {
@@ -39,7 +214,7 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
           });
     }
   } else {
-    AT_DISPATCH_ALL_TYPES_AND2(ScalarType::Half, ScalarType::Bool, dtype, "copy_", [&] {
+    AT_DISPATCH_ALL_TYPES_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       copy_kernel_cast<scalar_t>(iter);
     });
   }
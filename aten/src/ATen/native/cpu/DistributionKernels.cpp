@@ -0,0 +1,159 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/UnaryOps.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// See Note [Parallel random fills on CPU]. Each group of two vectors of the
+// output is drawn from 16 values (four blocks of the counter) of the Philox
+// stream, starting at the values of its own index.
+constexpr int64_t kValuesPerGroup = 16;
+
+// Uniform on [0, 1) from the top 24 (float) or 53 (double) bits
+template <typename scalar_t>
+struct UniformDraws;
+
+template <>
+struct UniformDraws<float> {
+  static float next(Philox4x32_10& engine) {
+    return (engine() >> 8) * (1.0f / (1u << 24));
+  }
+};
+
+template <>
+struct UniformDraws<double> {
+  static double next(Philox4x32_10& engine) {
+    const uint64_t high = engine();
+    const uint64_t bits = (high << 32 | engine()) >> 11;
+    return bits * (1.0 / (static_cast<uint64_t>(1) << 53));
+  }
+};
+
+// Calls `f(draws, group)` on the groups of `self` in parallel, with the
+// 2 * Vec256::size() uniform draws of the group. `self` is contiguous.
+template <typename scalar_t, typename F>
+void parallel_groups(Tensor& self, uint64_t seed, const F& f) {
+  using Vec = Vec256<scalar_t>;
+  constexpr int64_t group_size = 2 * Vec::size();
+  static_assert(
+      group_size * sizeof(scalar_t) == kValuesPerGroup * sizeof(uint32_t),
+      "groups draw 32 bits of the stream for every 4 bytes of the output");
+  const int64_t num_groups = (self.numel() + group_size - 1) / group_size;
+  parallel_for(
+      0,
+      num_groups,
+      internal::GRAIN_SIZE / group_size,
+      [&](int64_t begin, int64_t end) {
+        Philox4x32_10 engine(seed, /*subsequence=*/0, begin * kValuesPerGroup);
+        scalar_t draws[group_size];
+        for (int64_t group = begin; group < end; ++group) {
+          for (int64_t i = 0; i < group_size; ++i) {
+            draws[i] = UniformDraws<scalar_t>::next(engine);
+          }
+          f(draws, group);
+        }
+      });
+}
+
+// Stores the two vectors of group `group` of `data`, which has `numel`
+// elements.
+template <typename scalar_t>
+void store_group(
+    scalar_t* data,
+    int64_t numel,
+    int64_t group,
+    const Vec256<scalar_t>& first,
+    const Vec256<scalar_t>& second) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t offset = group * 2 * Vec::size();
+  const int64_t count = std::min<int64_t>(numel - offset, 2 * Vec::size());
+  if (count == 2 * Vec::size()) {
+    first.store(data + offset);
+    second.store(data + offset + Vec::size());
+  } else if (count > Vec::size()) {
+    first.store(data + offset);
+    second.store(data + offset + Vec::size(), count - Vec::size());
+  } else {
+    first.store(data + offset, count);
+  }
+}
+
+void uniform_kernel(Tensor& self, double from, double to, uint64_t seed) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "uniform_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    scalar_t* data = self.data<scalar_t>();
+    const int64_t numel = self.numel();
+    const Vec from_vec(static_cast<scalar_t>(from));
+    const Vec range_vec(static_cast<scalar_t>(to - from));
+    parallel_groups<scalar_t>(self, seed, [&](const scalar_t* draws, int64_t group) {
+      store_group(
+          data,
+          numel,
+          group,
+          from_vec + Vec::loadu(draws) * range_vec,
+          from_vec + Vec::loadu(draws + Vec::size()) * range_vec);
+    });
+  });
+}
+
+// Box-Muller, pairing the two vectors of each group
+void normal_kernel(Tensor& self, double mean, double std, uint64_t seed) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "normal_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    scalar_t* data = self.data<scalar_t>();
+    const int64_t numel = self.numel();
+    const Vec mean_vec(static_cast<scalar_t>(mean));
+    const Vec std_vec(static_cast<scalar_t>(std));
+    const Vec one(1);
+    const Vec minus_two(-2);
+    const Vec two_pi(static_cast<scalar_t>(2 * M_PI));
+    parallel_groups<scalar_t>(self, seed, [&](const scalar_t* draws, int64_t group) {
+      // 1 - u is in (0, 1], so that its log is finite
+      const Vec radius = (minus_two * (one - Vec::loadu(draws)).log()).sqrt();
+      const Vec theta = two_pi * Vec::loadu(draws + Vec::size());
+      store_group(
+          data,
+          numel,
+          group,
+          mean_vec + std_vec * radius * theta.cos(),
+          mean_vec + std_vec * radius * theta.sin());
+    });
+  });
+}
+
+void bernoulli_scalar_kernel(Tensor& self, double p, uint64_t seed) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "bernoulli_scalar_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    scalar_t* data = self.data<scalar_t>();
+    const int64_t numel = self.numel();
+    const Vec p_vec(static_cast<scalar_t>(p));
+    const Vec zero(0);
+    const Vec one(1);
+    parallel_groups<scalar_t>(self, seed, [&](const scalar_t* draws, int64_t group) {
+      store_group(
+          data,
+          numel,
+          group,
+          Vec::blendv(zero, one, Vec::loadu(draws) < p_vec),
+          Vec::blendv(zero, one, Vec::loadu(draws + Vec::size()) < p_vec));
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(uniform_stub, &uniform_kernel);
+REGISTER_DISPATCH(normal_stub, &normal_kernel);
+REGISTER_DISPATCH(bernoulli_scalar_stub, &bernoulli_scalar_kernel);
+
+}} // namespace at::native
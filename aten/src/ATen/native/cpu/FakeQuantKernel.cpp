@@ -0,0 +1,155 @@
+#include <ATen/native/quantized/fake_quant_affine.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// The quantized value and the rounded value of `x`, see
+// Note [Fake quantization]. Vectors and scalars alike.
+template <typename T>
+struct FakeQuant {
+  T inv_scale, scale, zero_point, quant_min, quant_max;
+
+  T quantize(const T& x) const {
+    return floor_of(x * inv_scale + T(0.5)) + zero_point;
+  }
+
+  T rounded(const T& q) const {
+    return (minimum(maximum(q, quant_min), quant_max) - zero_point) * scale;
+  }
+
+  static T floor_of(const T& x) {
+    return x.floor();
+  }
+};
+
+template <>
+float FakeQuant<float>::floor_of(const float& x) {
+  return std::floor(x);
+}
+
+template <>
+double FakeQuant<double>::floor_of(const double& x) {
+  return std::floor(x);
+}
+
+template <typename scalar_t>
+FakeQuant<scalar_t> make_fake_quant(float scale, float zero_point, int64_t quant_min, int64_t quant_max) {
+  return {static_cast<scalar_t>(1.0f / scale), static_cast<scalar_t>(scale),
+          static_cast<scalar_t>(zero_point), static_cast<scalar_t>(quant_min),
+          static_cast<scalar_t>(quant_max)};
+}
+
+template <typename scalar_t>
+FakeQuant<Vec256<scalar_t>> broadcast(const FakeQuant<scalar_t>& f) {
+  using Vec = Vec256<scalar_t>;
+  return {Vec(f.inv_scale), Vec(f.scale), Vec(f.zero_point), Vec(f.quant_min), Vec(f.quant_max)};
+}
+
+// Stores y and the mask of the `n` elements of x of a loop over (y, mask, x),
+// with vectors when the three are contiguous
+template <typename scalar_t>
+void fake_quant_loop(
+    char** data,
+    const int64_t* strides,
+    int64_t n,
+    const FakeQuant<scalar_t>& f) {
+  using Vec = Vec256<scalar_t>;
+  int64_t i = 0;
+  if (strides[0] == sizeof(scalar_t) && strides[1] == sizeof(scalar_t) &&
+      strides[2] == sizeof(scalar_t)) {
+    auto y = reinterpret_cast<scalar_t*>(data[0]);
+    auto mask = reinterpret_cast<scalar_t*>(data[1]);
+    auto x = reinterpret_cast<const scalar_t*>(data[2]);
+    const auto fv = broadcast(f);
+    const Vec one(1);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      const Vec q = fv.quantize(Vec::loadu(x + i));
+      fv.rounded(q).store(y + i);
+      ((q >= fv.quant_min) & (q <= fv.quant_max) & one).store(mask + i);
+    }
+  }
+  for (; i < n; i++) {
+    const scalar_t q = f.quantize(*reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]));
+    *reinterpret_cast<scalar_t*>(data[0] + i * strides[0]) = f.rounded(q);
+    *reinterpret_cast<scalar_t*>(data[1] + i * strides[1]) =
+        q >= f.quant_min && q <= f.quant_max ? 1 : 0;
+  }
+}
+
+void fake_quant_tensor_kernel(
+    TensorIterator& iter,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_tensor_cpu", [&] {
+    const auto f = make_fake_quant<scalar_t>(scale, zero_point, quant_min, quant_max);
+    iter.for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      fake_quant_loop<scalar_t>(data, strides, n, f);
+    });
+  });
+}
+
+void fake_quant_grad_tensor_kernel(
+    TensorIterator& iter,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_grad_tensor_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const auto f = make_fake_quant<scalar_t>(scale, zero_point, quant_min, quant_max);
+    const auto fv = broadcast(f);
+    binary_kernel_vec(
+        iter,
+        [=](scalar_t x, scalar_t dy) -> scalar_t {
+          const scalar_t q = f.quantize(x);
+          return q >= f.quant_min && q <= f.quant_max ? dy : 0;
+        },
+        [=](Vec x, Vec dy) {
+          const Vec q = fv.quantize(x);
+          return (q >= fv.quant_min) & (q <= fv.quant_max) & dy;
+        });
+  });
+}
+
+// Runs of elements of a channel have scales and zero points of stride 0, and
+// vectorize like the per tensor kernel.
+void fake_quant_channel_kernel(TensorIterator& iter, int64_t quant_min, int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_channel_cpu", [&] {
+    iter.for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      if (strides[3] == 0 && strides[4] == 0) {
+        const scalar_t scale = *reinterpret_cast<const scalar_t*>(data[3]);
+        const scalar_t zero_point = *reinterpret_cast<const scalar_t*>(data[4]);
+        fake_quant_loop<scalar_t>(
+            data, strides, n, make_fake_quant<scalar_t>(scale, zero_point, quant_min, quant_max));
+        return;
+      }
+      for (int64_t i = 0; i < n; i++) {
+        const scalar_t scale = *reinterpret_cast<const scalar_t*>(data[3] + i * strides[3]);
+        const scalar_t zero_point = *reinterpret_cast<const scalar_t*>(data[4] + i * strides[4]);
+        const auto f = make_fake_quant<scalar_t>(scale, zero_point, quant_min, quant_max);
+        const scalar_t q = f.quantize(*reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]));
+        *reinterpret_cast<scalar_t*>(data[0] + i * strides[0]) = f.rounded(q);
+        *reinterpret_cast<scalar_t*>(data[1] + i * strides[1]) =
+            q >= f.quant_min && q <= f.quant_max ? 1 : 0;
+      }
+    });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quant_tensor_kernel);
+REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quant_grad_tensor_kernel);
+REGISTER_DISPATCH(fake_quant_channel_stub, &fake_quant_channel_kernel);
+
+}} // namespace at::native
@@ -3,6 +3,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/ChannelsLast.h>
 #include <ATen/native/GridSampler.h>
 #include <ATen/native/cpu/GridSamplerKernel.h>
 #include <ATen/cpu/vml.h>
@@ -161,6 +162,15 @@ namespace at { namespace native { namespace {
  *  Now you should be able tp understand everything about the implementaion of
  *  2D forward kernel shown at the beginning of this note.
  *
+ *  The 3D kernels follow the same pattern, with a z location vector next to
+ *  the x and y ones, `TensorAccessor`s of one more dimension, and
+ *  `grid_sample_3d_grid_slice_iterator`.
+ *
+ *  For channels last 2D inputs (see Note [Channels last on CPU]), the forward
+ *  kernel returns a channels last output and uses `forward_channels_last`,
+ *  which interpolates all channels of one location at a time with contiguous
+ *  loads instead of gathering one channel of all locations at a time.
+ *
  **/
 
 
@@ -448,6 +458,55 @@ struct ApplyGridSample<scalar_t, 2, GridSamplerInterpolation::Bilinear, padding>
     }
   }
 
+  // Like `forward`, but for channels last input and output, where `out_ptr`
+  // points to the C channels of the first of the `len` output locations. The
+  // channels of each location are next to each other, so we vectorize the
+  // interpolation over channels rather than over locations.
+  inline void forward_channels_last(scalar_t* out_ptr, const scalar_t* inp_ptr,
+                                    const Vec& grid_x, const Vec& grid_y,
+                                    int64_t len) const {
+    auto x = compute_W.apply(grid_x);
+    auto y = compute_H.apply(grid_y);
+
+    auto interp_params = compute_interp_params(x, y);
+
+    auto i_y_n = std::get<12>(interp_params);
+    auto i_x_w = std::get<13>(interp_params);
+    auto i_nw_offset = i_y_n * iVec(inp_sH) + i_x_w * iVec(inp_sW);
+
+    // nw, ne, sw, se
+    integer_t i_offset_arr[4][iVec::size()];
+    integer_t i_mask_arr[4][iVec::size()];
+    scalar_t weight_arr[4][Vec::size()];
+    i_nw_offset.store(i_offset_arr[0]);
+    (i_nw_offset + iVec(inp_sW)).store(i_offset_arr[1]);
+    (i_nw_offset + iVec(inp_sH)).store(i_offset_arr[2]);
+    (i_nw_offset + iVec(inp_sH + inp_sW)).store(i_offset_arr[3]);
+    std::get<8>(interp_params).store(i_mask_arr[0]);
+    std::get<9>(interp_params).store(i_mask_arr[1]);
+    std::get<10>(interp_params).store(i_mask_arr[2]);
+    std::get<11>(interp_params).store(i_mask_arr[3]);
+    std::get<4>(interp_params).store(weight_arr[0]);
+    std::get<5>(interp_params).store(weight_arr[1]);
+    std::get<6>(interp_params).store(weight_arr[2]);
+    std::get<7>(interp_params).store(weight_arr[3]);
+
+    constexpr int64_t step = Vec::size();
+    for (int64_t i = 0; i < len; i++, out_ptr += C) {
+      for (int64_t c = 0; c < C; c += step) {
+        auto count = std::min(step, C - c);
+        auto interpolated = Vec(0);
+        for (int k = 0; k < 4; k++) {
+          if (i_mask_arr[k][i] & 0x01) {
+            auto val = Vec::loadu(inp_ptr + i_offset_arr[k][i] + c, count);
+            interpolated = interpolated + val * Vec(weight_arr[k][i]);
+          }
+        }
+        interpolated.store(out_ptr + c, count);
+      }
+    }
+  }
+
   inline void backward(TensorAccessor<scalar_t, 3>& gInp_slice,
                        TensorAccessor<scalar_t, 3>& gGrid_slice,
                        const TensorAccessor<scalar_t, 3>& gOut_slice,
@@ -605,6 +664,35 @@ struct ApplyGridSample<scalar_t, 2, GridSamplerInterpolation::Nearest, padding>
     }
   }
 
+  // See the Bilinear `forward_channels_last`.
+  inline void forward_channels_last(scalar_t* out_ptr, const scalar_t* inp_ptr,
+                                    const Vec& grid_x, const Vec& grid_y,
+                                    int64_t len) const {
+    auto x = compute_W.apply(grid_x);
+    auto y = compute_H.apply(grid_y);
+
+    auto i_x_nearest = convert_to_int_of_same_size(x.round());
+    auto i_y_nearest = convert_to_int_of_same_size(y.round());
+
+    auto i_mask = must_in_bound ? iVec(-1)
+                                : (i_x_nearest > iVec(-1)) & (i_x_nearest < iVec(inp_W)) &
+                                  (i_y_nearest > iVec(-1)) & (i_y_nearest < iVec(inp_H));
+    auto i_offset = i_y_nearest * iVec(inp_sH) + i_x_nearest * iVec(inp_sW);
+
+    integer_t mask_arr[iVec::size()];
+    i_mask.store(mask_arr);
+    integer_t offset_arr[iVec::size()];
+    i_offset.store(offset_arr);
+
+    for (int64_t i = 0; i < len; i++, out_ptr += C) {
+      if (mask_arr[i] & 0x01) {
+        std::memcpy(out_ptr, inp_ptr + offset_arr[i], sizeof(scalar_t) * C);
+      } else {
+        std::memset(out_ptr, 0, sizeof(scalar_t) * C);
+      }
+    }
+  }
+
   inline void backward(TensorAccessor<scalar_t, 3>& gInp_slice,
                        TensorAccessor<scalar_t, 3>& gGrid_slice,
                        const TensorAccessor<scalar_t, 3>& gOut_slice,
@@ -645,6 +733,299 @@ struct ApplyGridSample<scalar_t, 2, GridSamplerInterpolation::Nearest, padding>
   }
 };
 
+// In 3D, the eight corners of the cube around a location are, in order,
+//   tnw, tne, tsw, tse, bnw, bne, bsw, bse
+// i.e., corner k is (k >> 2) steps to the bottom (+z), ((k >> 1) & 1) steps to
+// the south (+y) and (k & 1) steps to the east (+x) of the top-north-west one.
+template<typename scalar_t, GridSamplerPadding padding>
+struct ApplyGridSample<scalar_t, 3, GridSamplerInterpolation::Bilinear, padding> {
+  using Vec = Vec256<scalar_t>;
+  using integer_t = int_same_size_t<scalar_t>;
+  using iVec = Vec256<integer_t>;
+
+  const int64_t inp_D;
+  const int64_t inp_H;
+  const int64_t inp_W;
+  const int64_t inp_sD;
+  const int64_t inp_sH;
+  const int64_t inp_sW;
+  const int64_t C;
+  const int64_t inp_sC;
+  const ComputeLocation<scalar_t, padding> compute_D;
+  const ComputeLocation<scalar_t, padding> compute_H;
+  const ComputeLocation<scalar_t, padding> compute_W;
+  const bool must_in_bound = padding != GridSamplerPadding::Zeros;
+
+  ApplyGridSample(const TensorAccessor<scalar_t, 5>& input)
+    : inp_D(input.size(2))
+    , inp_H(input.size(3))
+    , inp_W(input.size(4))
+    , inp_sD(input.stride(2))
+    , inp_sH(input.stride(3))
+    , inp_sW(input.stride(4))
+    , C(input.size(1))
+    , inp_sC(input.stride(1))
+    , compute_D(input.size(2))
+    , compute_H(input.size(3))
+    , compute_W(input.size(4)) {}
+
+  struct InterpParams {
+    // distances to the 6 faces, e.g., `n` along y from the north face
+    Vec t, b, n, s, w, e;
+    // interpolation weights and in_bound masks of the 8 corners
+    Vec weight[8];
+    Vec mask[8];
+    // z_t, y_n and x_w
+    iVec i_z_t, i_y_n, i_x_w;
+  };
+
+  inline InterpParams compute_interp_params(const Vec& x, const Vec& y, const Vec& z) const {
+    // See the 2D `compute_interp_params`.
+    InterpParams p;
+    auto x_w = x.floor();
+    auto y_n = y.floor();
+    auto z_t = z.floor();
+
+    p.w = x - x_w;
+    p.e = Vec(1) - p.w;
+    p.n = y - y_n;
+    p.s = Vec(1) - p.n;
+    p.t = z - z_t;
+    p.b = Vec(1) - p.t;
+
+    p.i_x_w = convert_to_int_of_same_size(x_w);
+    p.i_y_n = convert_to_int_of_same_size(y_n);
+    p.i_z_t = convert_to_int_of_same_size(z_t);
+    auto i_x_e = p.i_x_w + iVec(1);
+    auto i_y_s = p.i_y_n + iVec(1);
+    auto i_z_b = p.i_z_t + iVec(1);
+
+    // [0] for the lower corner along each dimension, [1] for the upper one
+    iVec x_mask[2] = {
+      must_in_bound ? iVec(-1) : (p.i_x_w > iVec(-1)) & (p.i_x_w < iVec(inp_W)),
+      must_in_bound ? (i_x_e < iVec(inp_W)) : (i_x_e > iVec(-1)) & (i_x_e < iVec(inp_W))};
+    iVec y_mask[2] = {
+      must_in_bound ? iVec(-1) : (p.i_y_n > iVec(-1)) & (p.i_y_n < iVec(inp_H)),
+      must_in_bound ? (i_y_s < iVec(inp_H)) : (i_y_s > iVec(-1)) & (i_y_s < iVec(inp_H))};
+    iVec z_mask[2] = {
+      must_in_bound ? iVec(-1) : (p.i_z_t > iVec(-1)) & (p.i_z_t < iVec(inp_D)),
+      must_in_bound ? (i_z_b < iVec(inp_D)) : (i_z_b > iVec(-1)) & (i_z_b < iVec(inp_D))};
+    Vec x_dist[2] = {p.e, p.w};
+    Vec y_dist[2] = {p.s, p.n};
+    Vec z_dist[2] = {p.b, p.t};
+
+    for (int k = 0; k < 8; k++) {
+      int dz = k >> 2, dy = (k >> 1) & 1, dx = k & 1;
+      p.weight[k] = z_dist[dz] * y_dist[dy] * x_dist[dx];
+      p.mask[k] = cast<scalar_t>(x_mask[dx] & y_mask[dy] & z_mask[dz]);
+    }
+    return p;
+  }
+
+  inline void forward(TensorAccessor<scalar_t, 4>& out_slice,
+                      const TensorAccessor<scalar_t, 4>& inp_slice,
+                      int64_t offset, const Vec& grid_x, const Vec& grid_y,
+                      const Vec& grid_z, int64_t len) const {
+    auto x = compute_W.apply(grid_x);
+    auto y = compute_H.apply(grid_y);
+    auto z = compute_D.apply(grid_z);
+
+    auto p = compute_interp_params(x, y, z);
+
+    auto i_tnw_offset = p.i_z_t * iVec(inp_sD) + p.i_y_n * iVec(inp_sH) + p.i_x_w * iVec(inp_sW);
+    iVec i_offset[8];
+    for (int k = 0; k < 8; k++) {
+      i_offset[k] = i_tnw_offset + iVec((k >> 2) * inp_sD + ((k >> 1) & 1) * inp_sH + (k & 1) * inp_sW);
+    }
+
+    auto out_ptr = out_slice.data() + offset;
+    auto out_sC = out_slice.stride(0);
+    auto inp_slice_ptr = inp_slice.data();
+    for (int64_t c = 0; c < C; ++c, out_ptr += out_sC, inp_slice_ptr += inp_sC) {
+      auto interpolated = Vec(0);
+      for (int k = 0; k < 8; k++) {
+        // mask_gather zeros out the mask, so we need to make a copy
+        Vec mask_copy = p.mask[k];
+        auto val = mask_gather<sizeof(scalar_t)>(Vec(0), inp_slice_ptr, i_offset[k], mask_copy);
+        interpolated = interpolated + val * p.weight[k];
+      }
+      interpolated.store(out_ptr, len);
+    }
+  }
+
+  inline void backward(TensorAccessor<scalar_t, 4>& gInp_slice,
+                       TensorAccessor<scalar_t, 4>& gGrid_slice,
+                       const TensorAccessor<scalar_t, 4>& gOut_slice,
+                       const TensorAccessor<scalar_t, 4>& inp_slice,
+                       int64_t offset, const Vec& grid_x, const Vec& grid_y,
+                       const Vec& grid_z, int64_t len) const {
+    Vec x, y, z, gx_mult, gy_mult, gz_mult;
+    std::tie(x, gx_mult) = compute_W.apply_get_grad(grid_x);
+    std::tie(y, gy_mult) = compute_H.apply_get_grad(grid_y);
+    std::tie(z, gz_mult) = compute_D.apply_get_grad(grid_z);
+
+    auto p = compute_interp_params(x, y, z);
+
+    auto i_tnw_offset = p.i_z_t * iVec(inp_sD) + p.i_y_n * iVec(inp_sH) + p.i_x_w * iVec(inp_sW);
+    // gInp is contiguous
+    auto i_gInp_tnw_offset = (p.i_z_t * iVec(inp_H) + p.i_y_n) * iVec(inp_W) + p.i_x_w;
+
+    // The derivatives of the corner weights wrt x, y and z, e.g., for the tnw
+    // corner, whose weight is `b * s * e`, they are -b * s, -b * e and -s * e.
+    Vec x_dist[2] = {p.e, p.w};
+    Vec y_dist[2] = {p.s, p.n};
+    Vec z_dist[2] = {p.b, p.t};
+    iVec i_offset[8];
+    Vec gx_weight[8], gy_weight[8], gz_weight[8];
+    // See the 2D `backward` for why we go through arrays here.
+    integer_t i_gInp_offset_arr[8][iVec::size()];
+    integer_t i_mask_arr[8][iVec::size()];
+    for (int k = 0; k < 8; k++) {
+      int dz = k >> 2, dy = (k >> 1) & 1, dx = k & 1;
+      i_offset[k] = i_tnw_offset + iVec(dz * inp_sD + dy * inp_sH + dx * inp_sW);
+      (i_gInp_tnw_offset + iVec((dz * inp_H + dy) * inp_W + dx)).store(i_gInp_offset_arr[k]);
+      p.mask[k].store(i_mask_arr[k]);
+      auto yz = y_dist[dy] * z_dist[dz];
+      auto xz = x_dist[dx] * z_dist[dz];
+      auto xy = x_dist[dx] * y_dist[dy];
+      gx_weight[k] = dx ? yz : Vec(0) - yz;
+      gy_weight[k] = dy ? xz : Vec(0) - xz;
+      gz_weight[k] = dz ? xy : Vec(0) - xy;
+    }
+
+    scalar_t gInp_corner_arr[Vec::size()];
+
+    auto gx = Vec(0), gy = Vec(0), gz = Vec(0);
+    for (int64_t c = 0; c < C; ++c) {
+      auto inp_slice_C_ptr = inp_slice[c].data();
+      auto gInp_slice_C_ptr = gInp_slice[c].data();
+      auto gOut = Vec::loadu(gOut_slice[c].data() + offset, len);
+
+      for (int k = 0; k < 8; k++) {
+        (p.weight[k] * gOut).store(gInp_corner_arr);
+        mask_scatter_add(gInp_corner_arr, gInp_slice_C_ptr, i_gInp_offset_arr[k], i_mask_arr[k], len);
+
+        // mask_gather zeros out the mask, so we need to make a copy
+        Vec mask_copy = p.mask[k];
+        auto val = mask_gather<sizeof(scalar_t)>(Vec(0), inp_slice_C_ptr, i_offset[k], mask_copy);
+        auto val_gOut = val * gOut;
+        gx = gx + gx_weight[k] * val_gOut;
+        gy = gy + gy_weight[k] * val_gOut;
+        gz = gz + gz_weight[k] * val_gOut;
+      }
+    }
+
+    scalar_t gx_arr[Vec::size()], gy_arr[Vec::size()], gz_arr[Vec::size()];
+    (gx * gx_mult).store(gx_arr);
+    (gy * gy_mult).store(gy_arr);
+    (gz * gz_mult).store(gz_arr);
+    // gGrid is contiguous
+    auto gGrid_ptr = gGrid_slice.data() + offset * 3;
+    for (int64_t i = 0; i < len; i++, gGrid_ptr += 3) {
+      gGrid_ptr[0] = gx_arr[i];
+      gGrid_ptr[1] = gy_arr[i];
+      gGrid_ptr[2] = gz_arr[i];
+    }
+  }
+};
+
+template<typename scalar_t, GridSamplerPadding padding>
+struct ApplyGridSample<scalar_t, 3, GridSamplerInterpolation::Nearest, padding> {
+  using Vec = Vec256<scalar_t>;
+  using integer_t = int_same_size_t<scalar_t>;
+  using iVec = Vec256<integer_t>;
+
+  const int64_t inp_D;
+  const int64_t inp_H;
+  const int64_t inp_W;
+  const int64_t inp_sD;
+  const int64_t inp_sH;
+  const int64_t inp_sW;
+  const int64_t C;
+  const int64_t inp_sC;
+  const ComputeLocation<scalar_t, padding> compute_D;
+  const ComputeLocation<scalar_t, padding> compute_H;
+  const ComputeLocation<scalar_t, padding> compute_W;
+  const bool must_in_bound = padding != GridSamplerPadding::Zeros;
+
+  ApplyGridSample(const TensorAccessor<scalar_t, 5>& input)
+    : inp_D(input.size(2))
+    , inp_H(input.size(3))
+    , inp_W(input.size(4))
+    , inp_sD(input.stride(2))
+    , inp_sH(input.stride(3))
+    , inp_sW(input.stride(4))
+    , C(input.size(1))
+    , inp_sC(input.stride(1))
+    , compute_D(input.size(2))
+    , compute_H(input.size(3))
+    , compute_W(input.size(4)) {}
+
+  inline std::tuple<iVec, iVec, iVec, iVec>  // mask, z, y and x
+  compute_nearest(const Vec& grid_x, const Vec& grid_y, const Vec& grid_z) const {
+    auto i_x_nearest = convert_to_int_of_same_size(compute_W.apply(grid_x).round());
+    auto i_y_nearest = convert_to_int_of_same_size(compute_H.apply(grid_y).round());
+    auto i_z_nearest = convert_to_int_of_same_size(compute_D.apply(grid_z).round());
+
+    auto i_mask = must_in_bound ? iVec(-1)
+                                : (i_x_nearest > iVec(-1)) & (i_x_nearest < iVec(inp_W)) &
+                                  (i_y_nearest > iVec(-1)) & (i_y_nearest < iVec(inp_H)) &
+                                  (i_z_nearest > iVec(-1)) & (i_z_nearest < iVec(inp_D));
+    return std::make_tuple(i_mask, i_z_nearest, i_y_nearest, i_x_nearest);
+  }
+
+  inline void forward(TensorAccessor<scalar_t, 4>& out_slice,
+                      const TensorAccessor<scalar_t, 4>& inp_slice,
+                      int64_t offset, const Vec& grid_x, const Vec& grid_y,
+                      const Vec& grid_z, int64_t len) const {
+    iVec i_mask, i_z, i_y, i_x;
+    std::tie(i_mask, i_z, i_y, i_x) = compute_nearest(grid_x, grid_y, grid_z);
+    auto mask = cast<scalar_t>(i_mask);
+    auto i_offset = i_z * iVec(inp_sD) + i_y * iVec(inp_sH) + i_x * iVec(inp_sW);
+
+    auto out_ptr = out_slice.data() + offset;
+    auto out_sC = out_slice.stride(0);
+    auto inp_slice_ptr = inp_slice.data();
+    #ifndef _MSC_VER
+    # pragma unroll
+    #endif
+    for (int c = 0; c < C; ++c, out_ptr += out_sC, inp_slice_ptr += inp_sC) {
+      // mask_gather zeros out the mask, so we need to make a copy
+      auto mask_copy = mask;
+      auto inp_val = mask_gather<sizeof(scalar_t)>(Vec(0), inp_slice_ptr, i_offset, mask_copy);
+      inp_val.store(static_cast<void*>(out_ptr), len);
+    }
+  }
+
+  inline void backward(TensorAccessor<scalar_t, 4>& gInp_slice,
+                       TensorAccessor<scalar_t, 4>& gGrid_slice,
+                       const TensorAccessor<scalar_t, 4>& gOut_slice,
+                       const TensorAccessor<scalar_t, 4>& inp_slice,
+                       int64_t offset, const Vec& grid_x, const Vec& grid_y,
+                       const Vec& grid_z, int64_t len) const {
+    iVec i_mask, i_z, i_y, i_x;
+    std::tie(i_mask, i_z, i_y, i_x) = compute_nearest(grid_x, grid_y, grid_z);
+    auto i_gInp_offset = (i_z * iVec(inp_H) + i_y) * iVec(inp_W) + i_x;  // gInp is contiguous
+
+    integer_t mask_arr[iVec::size()];
+    i_mask.store(mask_arr);
+    integer_t gInp_offset_arr[iVec::size()];
+    i_gInp_offset.store(gInp_offset_arr);
+
+    #ifndef _MSC_VER
+    # pragma unroll
+    #endif
+    for (int64_t c = 0; c < C; ++c) {
+      mask_scatter_add(gOut_slice[c].data() + offset, gInp_slice[c].data(),
+                       gInp_offset_arr, mask_arr, len);
+    }
+
+    // grid has zero 0 gradient in Nearest mode
+    auto gGrid_ptr = gGrid_slice.data() + offset * 3;
+    std::memset(gGrid_ptr, 0, sizeof(scalar_t) * len * 3);
+  }
+};
+
 // ~~~~~~~~~~~~~~~~~~ grid_sample_2d_grid_slice_iterator ~~~~~~~~~~~~~~~~~~~~~~
 // Function to apply a vectorized function on a grid slice tensor (without batch
 // dimension).
@@ -766,6 +1147,77 @@ static inline void grid_sample_2d_grid_slice_iterator(
   }
 }
 
+// ~~~~~~~~~~~~~~~~~~ grid_sample_3d_grid_slice_iterator ~~~~~~~~~~~~~~~~~~~~~~
+// The 3D version of `grid_sample_2d_grid_slice_iterator`, where `apply_fn`
+// also takes in the z location vector.
+// See NOTE [ Grid Sample CPU Kernels ] for details.
+
+template<typename scalar_t, typename ApplyFn>
+static inline void grid_sample_3d_grid_slice_iterator(
+    const TensorAccessor<scalar_t, 4>& grid_slice, const ApplyFn &apply_fn) {
+  int64_t out_D = grid_slice.size(0);
+  int64_t out_H = grid_slice.size(1);
+  int64_t out_W = grid_slice.size(2);
+  int64_t grid_sD = grid_slice.stride(0);
+  int64_t grid_sH = grid_slice.stride(1);
+  int64_t grid_sW = grid_slice.stride(2);
+  int64_t grid_sCoor = grid_slice.stride(3);
+  auto grid_ptr = grid_slice.data();
+
+  using Vec = Vec256<scalar_t>;
+  using iVec = Vec256<int_same_size_t<scalar_t>>;
+  constexpr int64_t step = Vec::size();
+
+  // Function to apply along a line of `total_size` grid locations that are
+  // `grid_sW` apart in memory, e.g., along the W dimension. If they are next
+  // to each other (e.g., grid is from a conv net output of shape
+  // [N, 3, D, H, W]), we load the x, y and z vectors sequentially, otherwise
+  // we use at::vec256::gather. In particular, a contiguous grid has
+  // grid_sW == 3.
+  auto line_fn = [&](const scalar_t *grid_ptr_line, int64_t out_base_offset,
+                     int64_t total_size) {
+    auto i_offsets = iVec::arange(0, grid_sW);
+    for (int64_t i = 0; i < total_size; i += step) {
+      auto len = std::min(step, total_size - i);
+      auto grid_ptr_x = grid_ptr_line + i * grid_sW;
+      Vec x, y, z;
+      if (grid_sW == 1) {
+        x = Vec::loadu(grid_ptr_x, len);
+        y = Vec::loadu(grid_ptr_x + grid_sCoor, len);
+        z = Vec::loadu(grid_ptr_x + 2 * grid_sCoor, len);
+      } else {
+        if (len < step) {
+          // prevents illegal memory access, sets the exceeding offsets to zero
+          i_offsets = iVec::set(iVec(0), i_offsets, len);
+        }
+        x = vec256::gather<sizeof(scalar_t)>(grid_ptr_x, i_offsets);
+        y = vec256::gather<sizeof(scalar_t)>(grid_ptr_x + grid_sCoor, i_offsets);
+        z = vec256::gather<sizeof(scalar_t)>(grid_ptr_x + 2 * grid_sCoor, i_offsets);
+      }
+      // make sure that x, y and z are valid grid sample locations
+      if (len < step) {
+        x = Vec::set(Vec(0), x, len);
+        y = Vec::set(Vec(0), y, len);
+        z = Vec::set(Vec(0), z, len);
+      }
+      apply_fn(x, y, z, out_base_offset + i, len);
+    }
+  };
+
+  if ((out_H == 1 || grid_sH == grid_sW * out_W) &&
+      (out_D == 1 || grid_sD == grid_sW * out_W * out_H)) {
+    // If [D, H, W] can be flattened into a line, apply line_fn once.
+    line_fn(grid_ptr, 0, out_D * out_H * out_W);
+  } else {
+    // Otherwise apply line_fn once for each (d, h) slice.
+    for (int64_t d = 0; d < out_D; d++) {
+      for (int64_t h = 0; h < out_H; h++) {
+        line_fn(grid_ptr + d * grid_sD + h * grid_sH, (d * out_H + h) * out_W, out_W);
+      }
+    }
+  }
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~ Grid Sample Kernels ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // Use the structs & functions defined above to calculate grid sample forward
 // and backward.
@@ -775,9 +1227,14 @@ Tensor grid_sampler_2d_cpu_kernel_impl(const Tensor& input, const Tensor& grid,
                                        int64_t interpolation_mode,
                                        int64_t padding_mode) {
   auto N = input.size(0);
+  auto C = input.size(1);
   auto H = grid.size(1);
   auto W = grid.size(2);
-  auto output = at::empty({N, input.size(1), H, W}, input.options());
+  // Channels last inputs give channels last outputs, see
+  // Note [Channels last on CPU].
+  auto channels_last = is_channels_last(input);
+  auto output = channels_last ? empty_channels_last({N, C, H, W}, input.options())
+                              : at::empty({N, C, H, W}, input.options());
   auto spatial_size = H * W;
   auto grain_size = spatial_size == 0 ? (N + 1)
                                       : at::divup(at::internal::GRAIN_SIZE, spatial_size * 4 /* 2d * 2 tensors*/);
@@ -793,8 +1250,14 @@ Tensor grid_sampler_2d_cpu_kernel_impl(const Tensor& input, const Tensor& grid,
           grid_acc[n],                                                         \
           [&](const Vec256<scalar_t>& grid_x, const Vec256<scalar_t>& grid_y,  \
               int64_t spatial_offset, int64_t len) {                           \
-            grid_sample.forward(out_slice, inp_slice, spatial_offset,          \
-                                grid_x, grid_y, len);                          \
+            if (channels_last) {                                               \
+              grid_sample.forward_channels_last(                               \
+                out_slice.data() + spatial_offset * C, inp_slice.data(),       \
+                grid_x, grid_y, len);                                          \
+            } else {                                                           \
+              grid_sample.forward(out_slice, inp_slice, spatial_offset,        \
+                                  grid_x, grid_y, len);                        \
+            }                                                                  \
           });                                                                  \
         }                                                                      \
       });                                                                      \
@@ -891,10 +1354,134 @@ grid_sampler_2d_backward_cpu_kernel_impl(const Tensor& grad_output_,
   return std::make_tuple(grad_input, grad_grid);
 }
 
+Tensor grid_sampler_3d_cpu_kernel_impl(const Tensor& input, const Tensor& grid,
+                                       int64_t interpolation_mode,
+                                       int64_t padding_mode) {
+  auto N = input.size(0);
+  auto D = grid.size(1);
+  auto H = grid.size(2);
+  auto W = grid.size(3);
+  auto output = at::empty({N, input.size(1), D, H, W}, input.options());
+  auto spatial_size = D * H * W;
+  auto grain_size = spatial_size == 0 ? (N + 1)
+                                      : at::divup(at::internal::GRAIN_SIZE, spatial_size * 6 /* 3d * 2 tensors*/);
+
+#define HANDLE_CASE(interp, padding)                                           \
+  case padding: {                                                              \
+    ApplyGridSample<scalar_t, 3, interp, padding> grid_sample(inp_acc);        \
+    parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {           \
+      for (int64_t n = begin; n < end; n++) {                                  \
+        auto out_slice = out_acc[n];                                           \
+        auto inp_slice = inp_acc[n];                                           \
+        grid_sample_3d_grid_slice_iterator(                                    \
+          grid_acc[n],                                                         \
+          [&](const Vec256<scalar_t>& grid_x, const Vec256<scalar_t>& grid_y,  \
+              const Vec256<scalar_t>& grid_z,                                  \
+              int64_t spatial_offset, int64_t len) {                           \
+            grid_sample.forward(out_slice, inp_slice, spatial_offset,          \
+                                grid_x, grid_y, grid_z, len);                  \
+          });                                                                  \
+        }                                                                      \
+      });                                                                      \
+    return;                                                                    \
+  }
+
+#define HANDLE_INTERP(interp)                                          \
+  case interp: {                                                       \
+    switch (static_cast<GridSamplerPadding>(padding_mode)) {           \
+      HANDLE_CASE(interp, GridSamplerPadding::Zeros);                  \
+      HANDLE_CASE(interp, GridSamplerPadding::Border);                 \
+      HANDLE_CASE(interp, GridSamplerPadding::Reflection);             \
+    }                                                                  \
+    return;                                                            \
+  }
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler_3d_cpu_kernel_impl", [&] {
+    auto out_acc = output.accessor<scalar_t, 5>();
+    auto inp_acc = input.accessor<scalar_t, 5>();
+    auto grid_acc = grid.accessor<scalar_t, 5>();
+    switch (static_cast<GridSamplerInterpolation>(interpolation_mode)) {
+      HANDLE_INTERP(GridSamplerInterpolation::Bilinear);
+      HANDLE_INTERP(GridSamplerInterpolation::Nearest);
+    }
+  });
+#undef HANDLE_CASE
+#undef HANDLE_INTERP
+
+  return output;
+}
+
+std::tuple<Tensor, Tensor>
+grid_sampler_3d_backward_cpu_kernel_impl(const Tensor& grad_output_,
+                                         const Tensor& input,
+                                         const Tensor& grid,
+                                         int64_t interpolation_mode,
+                                         int64_t padding_mode) {
+  // See the 2D backward.
+  auto grad_output = grad_output_.contiguous();
+
+  auto grad_input = at::zeros_like(input);
+  auto grad_grid = at::empty_like(grid);
+  auto N = input.size(0);
+  auto spatial_size = grid.size(1) * grid.size(2) * grid.size(3);
+  auto grain_size = spatial_size == 0 ? (N + 1)
+                                      : at::divup(at::internal::GRAIN_SIZE, spatial_size * 15 /* 3d * 5 tensors*/);
+
+#define HANDLE_CASE(interp, padding)                                             \
+  case padding: {                                                                \
+    ApplyGridSample<scalar_t, 3, interp, padding> grid_sample(inp_acc);          \
+    parallel_for(0, N, grain_size, [&](int64_t begin, int64_t end) {             \
+      for (int64_t n = begin; n < end; n++) {                                    \
+        auto gInp_slice = gInp_acc[n];                                           \
+        auto gGrid_slice = gGrid_acc[n];                                         \
+        auto gOut_slice = gOut_acc[n];                                           \
+        auto inp_slice = inp_acc[n];                                             \
+        grid_sample_3d_grid_slice_iterator(                                      \
+          grid_acc[n],                                                           \
+          [&](const Vec256<scalar_t>& grid_x, const Vec256<scalar_t>& grid_y,    \
+              const Vec256<scalar_t>& grid_z,                                    \
+              int64_t spatial_offset, int64_t len) {                             \
+            grid_sample.backward(gInp_slice, gGrid_slice, gOut_slice, inp_slice, \
+                                 spatial_offset, grid_x, grid_y, grid_z, len);   \
+          });                                                                    \
+      }                                                                          \
+    });                                                                          \
+    return;                                                                      \
+  }
+
+#define HANDLE_INTERP(interp)                                          \
+  case interp: {                                                       \
+    switch (static_cast<GridSamplerPadding>(padding_mode)) {           \
+      HANDLE_CASE(interp, GridSamplerPadding::Zeros);                  \
+      HANDLE_CASE(interp, GridSamplerPadding::Border);                 \
+      HANDLE_CASE(interp, GridSamplerPadding::Reflection);             \
+    }                                                                  \
+    return;                                                            \
+  }
+
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "grid_sampler_3d_backward_cpu_kernel_impl", [&] {
+    auto gInp_acc = grad_input.accessor<scalar_t, 5>();
+    auto gGrid_acc = grad_grid.accessor<scalar_t, 5>();
+    auto inp_acc = input.accessor<scalar_t, 5>();
+    auto grid_acc = grid.accessor<scalar_t, 5>();
+    auto gOut_acc = grad_output.accessor<scalar_t, 5>();
+    switch (static_cast<GridSamplerInterpolation>(interpolation_mode)) {
+      HANDLE_INTERP(GridSamplerInterpolation::Bilinear);
+      HANDLE_INTERP(GridSamplerInterpolation::Nearest);
+    }
+  });
+#undef HANDLE_CASE
+#undef HANDLE_INTERP
+
+  return std::make_tuple(grad_input, grad_grid);
+}
+
 }
 
 REGISTER_DISPATCH(grid_sampler_2d_cpu_kernel, &grid_sampler_2d_cpu_kernel_impl);
 REGISTER_DISPATCH(grid_sampler_2d_backward_cpu_kernel, &grid_sampler_2d_backward_cpu_kernel_impl);
+REGISTER_DISPATCH(grid_sampler_3d_cpu_kernel, &grid_sampler_3d_cpu_kernel_impl);
+REGISTER_DISPATCH(grid_sampler_3d_backward_cpu_kernel, &grid_sampler_3d_backward_cpu_kernel_impl);
 
 
 }}  // namespace at::native
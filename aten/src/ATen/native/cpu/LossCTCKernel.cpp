@@ -0,0 +1,317 @@
+// Copyright (c) 2018 MathInf GmbH, Thomas Viehmann
+// Licensed under the BSD-3-Clause license
+// The alpha and beta recursions of the CPU Connectionist Temporal Loss, see LossCTC.cpp.
+// We mostly follow Graves.
+// 1. Graves et al: http://www.cs.toronto.edu/~graves/icml_2006.pdf
+//
+// Both recursions only look one time step back, but each element of a row depends on up to three
+// elements of the previous row, one and two indices apart. So the rows are vectorized over s with
+// shifted loads of the previous row. The target dependent parts of eq (6) / (10), which targets
+// are allowed to skip the blank in between and which log_probs are picked up, are gathered into
+// contiguous per-item workspaces once, which every time step then reads with plain vector loads.
+// The beta recursion is the alpha recursion run backwards in s, so we compute it on reversed
+// rows and reuse the same step.
+
+#include <ATen/native/LossCTC.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// this ad-hoc converts from targets (l in [1]) to augmented targets (l' in [1]) note that no bound-checking is done
+template<typename target_t>
+static inline int64_t get_target_prime(const target_t* target, int64_t offset, int64_t stride, int64_t idx, int64_t BLANK) {
+  if (idx % 2 == 0) {
+    return BLANK;
+  } else {
+    return target[offset + stride * (idx / 2)];
+  }
+}
+
+// log(exp(a) + exp(b) + exp(c)), keeping track of the maximum to avoid overflow
+template<typename scalar_t>
+static inline scalar_t logsumexp3(scalar_t a, scalar_t b, scalar_t c) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  scalar_t m = std::max(a, std::max(b, c));
+  if (m == neginf) // cannot do neginf-neginf
+    m = 0;
+  return std::log(std::exp(a-m)+std::exp(b-m)+std::exp(c-m))+m;
+}
+
+// One time step of eq (6):
+//   out[s] = log(exp(prev[s]) + exp(prev[s-1]) + exp(prev[s-2] + skip[s])) + log_probs[s]
+// with prev[-1] = prev[-2] = -inf. skip[s] is 0 if the transition from s-2 is allowed and -inf if not.
+template<typename scalar_t>
+static void ctc_step(scalar_t* out, const scalar_t* prev, const scalar_t* skip, const scalar_t* log_probs, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  // the first two elements have fewer predecessors
+  out[0] = logsumexp3(prev[0], neginf, neginf) + log_probs[0];
+  if (n > 1) {
+    out[1] = logsumexp3(prev[1], prev[0], neginf) + log_probs[1];
+  }
+  const Vec vec_neginf(neginf);
+  const Vec zero(0);
+  for (int64_t s = 2; s < n; s += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - s);
+    Vec a = Vec::loadu(prev + s, count);
+    Vec b = Vec::loadu(prev + s - 1, count);
+    Vec c = Vec::loadu(prev + s - 2, count) + Vec::loadu(skip + s, count);
+    Vec m = maximum(a, maximum(b, c));
+    m = Vec::blendv(m, zero, m == vec_neginf);
+    Vec res = ((a - m).exp() + (b - m).exp() + (c - m).exp()).log() + m + Vec::loadu(log_probs + s, count);
+    res.store(out + s, count);
+  }
+}
+
+// Per thread workspaces, sized for the longest target and reused for every batch item of a task
+template<typename scalar_t>
+struct CTCWorkspace {
+  explicit CTCWorkspace(int64_t max_target_length)
+    : target_primes(2*max_target_length+1),
+      skip(2*max_target_length+1),
+      log_probs(2*max_target_length+1) {}
+
+  // Fills target_primes and skip for the augmented target of a batch item. If reversed, they are
+  // in descending order of s, as needed for the beta recursion.
+  template<typename target_t>
+  void set_target(const target_t* targets, int64_t tg_batch_offset, int64_t tg_target_stride, int64_t target_length,
+                  int64_t BLANK, bool reversed) {
+    constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+    const int64_t n = 2*target_length+1;
+    for (int64_t s = 0; s < n; s++) {
+      target_primes[s] = get_target_prime(targets, tg_batch_offset, tg_target_stride, reversed ? n-1-s : s, BLANK);
+    }
+    for (int64_t s = 0; s < n; s++) {
+      skip[s] = (s > 1 && target_primes[s-2] != target_primes[s]) ? 0 : neginf;
+    }
+  }
+
+  // Gathers the log_probs of the augmented target at one time step
+  void gather_log_probs(const scalar_t* log_probs_t, int64_t lp_char_stride, int64_t n) {
+    for (int64_t s = 0; s < n; s++) {
+      log_probs[s] = log_probs_t[target_primes[s] * lp_char_stride];
+    }
+  }
+
+  std::vector<int64_t> target_primes;
+  std::vector<scalar_t> skip;
+  std::vector<scalar_t> log_probs;
+};
+
+// This is a relatively straightforward implementation of the alpha calculation in the forward backward algorithm (section 4.1).
+// A (minor) twist is that we are using log-calculations to enhance numerical stability (log_probs and log_alpha).
+template<typename scalar_t, typename target_t>
+void ctc_loss_kernel_impl(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+                          const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK,
+                          Tensor& neg_log_likelihood, Tensor& log_alpha) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  // log_probs: input_len x batch_size x num_labels, log_alpha: batch_size x input_len x (2*max_target_length+1)
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t lp_input_stride = log_probs.stride(0);
+  const int64_t lp_batch_stride = log_probs.stride(1);
+  const int64_t lp_char_stride = log_probs.stride(2);
+  const int64_t la_batch_stride = log_alpha.stride(0);
+  const int64_t la_input_stride = log_alpha.stride(1);
+  const int64_t max_target_length = (log_alpha.size(2) - 1) / 2;
+  const scalar_t* log_probs_data = log_probs.data<scalar_t>();
+  scalar_t* log_alpha_data = log_alpha.data<scalar_t>();
+  const target_t* targets_data = targets.data<target_t>();
+  scalar_t* neg_log_likelihood_data = neg_log_likelihood.data<scalar_t>();
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    CTCWorkspace<scalar_t> workspace(max_target_length);
+    for (int64_t b = start; b < end; b++) {
+      const int64_t input_length = input_lengths[b];
+      const int64_t target_length = target_lengths[b];
+      const int64_t n = 2*target_length+1;
+      const scalar_t* log_probs_b = log_probs_data + b * lp_batch_stride;
+      scalar_t* log_alpha_b = log_alpha_data + b * la_batch_stride;
+      workspace.set_target(targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK, /*reversed=*/false);
+
+      // alpha calculation for the first row, the three equations for alpha_1 above eq (6)
+      // first the default
+      std::fill(log_alpha_b, log_alpha_b + log_alpha.size(2), neginf);
+      // the first two items of alpha_t above eq (6)
+      log_alpha_b[0] = log_probs_b[BLANK * lp_char_stride];
+      if (target_length > 0)
+        log_alpha_b[1] = log_probs_b[workspace.target_primes[1] * lp_char_stride];
+
+      // now the loop over the inputs, this is eq (6) and (7)
+      for (int64_t t=1; t<input_length; t++) {
+        workspace.gather_log_probs(log_probs_b + t * lp_input_stride, lp_char_stride, n);
+        ctc_step(log_alpha_b + t * la_input_stride, log_alpha_b + (t-1) * la_input_stride,
+                 workspace.skip.data(), workspace.log_probs.data(), n);
+      }
+      // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+      const scalar_t* log_alpha_last = log_alpha_b + (input_length-1) * la_input_stride;
+      scalar_t l1 = log_alpha_last[target_length*2];
+      scalar_t l2 = target_length > 0 ? log_alpha_last[target_length*2-1] : neginf;
+      neg_log_likelihood_data[b] = -logsumexp3(l1, l2, neginf);
+    }
+  });
+}
+
+// This is the backward. It consists of two phases:
+// a) computing the beta analogous to the alphas in the forward (backward half of the forward-backward algorithm) (eq (10) and (11))
+// b) collecting the per-activation characters for all s and wrapping the gradient (eq (16), the collection is the sum)
+template<typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_impl(const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths,
+                                   IntArrayRef target_lengths, const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride,
+                                   const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity, Tensor& grad) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+  const int64_t lp_input_stride = log_probs.stride(0);
+  const int64_t lp_batch_stride = log_probs.stride(1);
+  const int64_t lp_char_stride = log_probs.stride(2);
+  const int64_t gr_input_stride = grad.stride(0);
+  const int64_t gr_batch_stride = grad.stride(1);
+  const int64_t gr_char_stride = grad.stride(2);
+  const int64_t la_batch_stride = log_alpha.stride(0);
+  const int64_t la_input_stride = log_alpha.stride(1);
+  const int64_t max_target_length = (log_alpha.size(2) - 1) / 2;
+  const scalar_t* log_probs_data = log_probs.data<scalar_t>();
+  const scalar_t* log_alpha_data = log_alpha.data<scalar_t>();
+  const target_t* targets_data = targets.data<target_t>();
+  scalar_t* grad_data = grad.data<scalar_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    CTCWorkspace<scalar_t> workspace(max_target_length);
+    // Only two rows of beta are needed at a time. They are kept reversed, beta_next[n-1-s] is beta_{t+1}(s).
+    std::vector<scalar_t> beta_next(2*max_target_length+1);
+    std::vector<scalar_t> beta_current(2*max_target_length+1);
+    for (int64_t b = start; b < end; b++) {
+      const int64_t input_length = input_lengths[b];
+      const int64_t target_length = target_lengths[b];
+      const int64_t n = 2*target_length+1;
+      const scalar_t* log_probs_b = log_probs_data + b * lp_batch_stride;
+      const scalar_t* log_alpha_b = log_alpha_data + b * la_batch_stride;
+      scalar_t* grad_b = grad_data + b * gr_batch_stride;
+      auto grad_at = [&](int64_t t, int64_t c) -> scalar_t& {
+        return grad_b[t * gr_input_stride + c * gr_char_stride];
+      };
+
+      scalar_t nll = neg_log_likelihood_a[b];
+      if (zero_infinity &&  nll == std::numeric_limits<scalar_t>::infinity()) {
+        for (int64_t t = 0; t < max_input_length; t++) {
+          for (int64_t c = 0; c < num_labels; c++) {
+            grad_at(t, c) = 0;
+          }
+        }
+        continue;
+      }
+
+      workspace.set_target(targets_data, tg_batch_offsets[b], tg_target_stride, target_length, BLANK, /*reversed=*/true);
+      const int64_t* target_primes = workspace.target_primes.data();
+
+      // the initialization of beta before eq (10)
+      // here we do the fill for each batch item separately, as the input lengths will differ, so the t in which
+      // we start varies
+      if (input_length > 0) {
+        const scalar_t* log_probs_last = log_probs_b + (input_length-1) * lp_input_stride;
+        const scalar_t* log_alpha_last = log_alpha_b + (input_length-1) * la_input_stride;
+        std::fill(beta_next.begin(), beta_next.begin() + n, neginf);
+        beta_next[0] = log_probs_last[BLANK * lp_char_stride];
+        grad_at(input_length-1, BLANK) = log_alpha_last[2*target_length] + beta_next[0];
+
+        if (target_length > 0) {
+          auto current_target_prime = target_primes[1];
+          beta_next[1] = log_probs_last[current_target_prime * lp_char_stride];
+
+          // the first two are a blank and a non-blank, so we know they are different and we don't need to do log+
+          grad_at(input_length-1, current_target_prime) = log_alpha_last[2*target_length-1] + beta_next[1];
+        }
+      }
+
+      // now loop applying eq (10) / (11)
+      for (int64_t t=input_length-2; t>=0; t--) {
+        workspace.gather_log_probs(log_probs_b + t * lp_input_stride, lp_char_stride, n);
+        ctc_step(beta_current.data(), beta_next.data(), workspace.skip.data(), workspace.log_probs.data(), n);
+        // now that we have beta, we fill in the sum of alpha*beta in eq (16)
+        // we only parallelize over the batch, so we don't have a concurrency
+        // issue (several s can map to the same target character)
+        // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
+        const scalar_t* log_alpha_t = log_alpha_b + t * la_input_stride;
+        for (int64_t r = 0; r < n; r++) {
+          const int64_t s = n-1-r;
+          scalar_t log_alpha_beta =  log_alpha_t[s] + beta_current[r];
+          scalar_t &lcab = grad_at(t, target_primes[r]);
+          if (lcab == neginf) {
+            lcab = log_alpha_beta;
+          } else {
+            scalar_t max = std::max(lcab, log_alpha_beta);
+            lcab = std::log(std::exp(lcab-max)+std::exp(log_alpha_beta-max))+max;
+          }
+        }
+        std::swap(beta_current, beta_next);
+      }
+
+      // now grad has the sum of eq (16)
+      // now we wrap up the calculation by adding in the remaining items of eq (16)
+      // grad is the output gradient, nll is the loss. Note that the likelihood -nll is the Z of eq (16)
+      scalar_t gr = grad_out_a[b];
+      for (int64_t t = 0; t < input_length; t++) { // or go for the full thing?
+        const scalar_t* log_probs_t = log_probs_b + t * lp_input_stride;
+        for (int64_t c = 0; c < num_labels; c++) {
+          scalar_t& res = grad_at(t, c);
+          scalar_t lp = log_probs_t[c * lp_char_stride];
+          res = (std::exp(lp)-std::exp(res + nll - lp)) * gr;
+        }
+      }
+      // zero the remainder
+      for (int64_t t = input_length; t < max_input_length; t++) {
+        for (int64_t c = 0; c < num_labels; c++) {
+          grad_at(t, c) = 0;
+        }
+      }
+    }
+  });
+}
+
+void ctc_loss_kernel(const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths, IntArrayRef target_lengths,
+                     const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK,
+                     Tensor& neg_log_likelihood, Tensor& log_alpha) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_impl<scalar_t, int64_t>(log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+                                              tg_target_stride, BLANK, neg_log_likelihood, log_alpha);
+    } else {
+      ctc_loss_kernel_impl<scalar_t, int>(log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+                                          tg_target_stride, BLANK, neg_log_likelihood, log_alpha);
+    }
+  });
+}
+
+void ctc_loss_backward_kernel(const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets, IntArrayRef input_lengths,
+                              IntArrayRef target_lengths, const std::vector<int64_t>& tg_batch_offsets, int64_t tg_target_stride,
+                              const Tensor& neg_log_likelihood, const Tensor& log_alpha, int64_t BLANK, bool zero_infinity, Tensor& grad) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_impl<scalar_t, int64_t>(grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+                                                       tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity, grad);
+    } else {
+      ctc_loss_backward_kernel_impl<scalar_t, int>(grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+                                                   tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity, grad);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(ctc_loss_stub, &ctc_loss_kernel);
+REGISTER_DISPATCH(ctc_loss_backward_stub, &ctc_loss_backward_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,437 @@
+#include <ATen/native/Normalization.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+// Kernels of the layer and group norms. A task works on whole rows, i.e. on
+// the elements that are normalized together: it computes their sum and sum of
+// squares in one vectorized pass, and normalizes them in a second one. The
+// backward makes the same two passes over the gradients. The tensors are
+// contiguous, see Normalization.h for their shapes.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Rows per task so that a task touches roughly GRAIN_SIZE elements
+inline int64_t grain_size(int64_t row_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_size));
+}
+
+template <typename scalar_t>
+inline scalar_t vec_sum(const Vec256<scalar_t>& v) {
+  __at_align32__ scalar_t values[Vec256<scalar_t>::size()];
+  v.store(values);
+  scalar_t sum = 0;
+  for (int64_t k = 0; k < Vec256<scalar_t>::size(); ++k) {
+    sum += values[k];
+  }
+  return sum;
+}
+
+// The sum and the sum of squares of a row, shifted by its first element so
+// that the variance doesn't cancel out when the mean is large compared to it
+template <typename scalar_t>
+inline void row_sums(const scalar_t* x, int64_t n, scalar_t& shift, scalar_t& sum, scalar_t& sum_sq) {
+  using Vec = Vec256<scalar_t>;
+  shift = n > 0 ? x[0] : scalar_t(0);
+  const Vec shift_vec(shift);
+  Vec sum_vec(scalar_t(0));
+  Vec sum_sq_vec(scalar_t(0));
+  int64_t j = 0;
+  for (; j + Vec::size() <= n; j += Vec::size()) {
+    const auto v = Vec::loadu(x + j) - shift_vec;
+    sum_vec = sum_vec + v;
+    sum_sq_vec = sum_sq_vec + v * v;
+  }
+  sum = vec_sum(sum_vec);
+  sum_sq = vec_sum(sum_sq_vec);
+  for (; j < n; ++j) {
+    const scalar_t v = x[j] - shift;
+    sum += v;
+    sum_sq += v * v;
+  }
+}
+
+// The mean and the inverse standard deviation of a row, from the sums above.
+// Rounding can make the variance slightly negative, so it's clamped.
+template <typename scalar_t>
+inline void row_moments(const scalar_t* x, int64_t n, scalar_t eps, scalar_t& mean, scalar_t& rstd) {
+  scalar_t shift, sum, sum_sq;
+  row_sums(x, n, shift, sum, sum_sq);
+  const scalar_t shifted_mean = sum / n;
+  const scalar_t var = std::max(sum_sq / n - shifted_mean * shifted_mean, scalar_t(0));
+  mean = shift + shifted_mean;
+  rstd = scalar_t(1) / std::sqrt(var + eps);
+}
+
+// y = (x * scale + shift) * gamma + beta over a row, gamma and beta may be null
+template <typename scalar_t>
+inline void row_affine(const scalar_t* x, const scalar_t* gamma, const scalar_t* beta,
+                       int64_t n, scalar_t scale, scalar_t shift, scalar_t* y) {
+  using Vec = Vec256<scalar_t>;
+  const Vec scale_vec(scale);
+  const Vec shift_vec(shift);
+  for (int64_t j = 0; j < n; j += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - j);
+    auto v = Vec::loadu(x + j, count) * scale_vec + shift_vec;
+    if (gamma != nullptr) {
+      v = v * Vec::loadu(gamma + j, count);
+    }
+    if (beta != nullptr) {
+      v = v + Vec::loadu(beta + j, count);
+    }
+    v.store(y + j, count);
+  }
+}
+
+// The sums of dy * gamma * (x - mean) and of dy * gamma over a row, gamma may
+// be null
+template <typename scalar_t>
+inline void row_grad_sums(const scalar_t* dy, const scalar_t* x, const scalar_t* gamma,
+                          int64_t n, scalar_t mean, scalar_t& ds, scalar_t& db) {
+  using Vec = Vec256<scalar_t>;
+  const Vec mean_vec(mean);
+  Vec ds_vec(scalar_t(0));
+  Vec db_vec(scalar_t(0));
+  int64_t j = 0;
+  for (; j + Vec::size() <= n; j += Vec::size()) {
+    auto g = Vec::loadu(dy + j);
+    if (gamma != nullptr) {
+      g = g * Vec::loadu(gamma + j);
+    }
+    ds_vec = ds_vec + g * (Vec::loadu(x + j) - mean_vec);
+    db_vec = db_vec + g;
+  }
+  ds = vec_sum(ds_vec);
+  db = vec_sum(db_vec);
+  for (; j < n; ++j) {
+    const scalar_t g = gamma != nullptr ? dy[j] * gamma[j] : dy[j];
+    ds += g * (x[j] - mean);
+    db += g;
+  }
+}
+
+// dx = a * gamma * dy + b * x + c over a row, gamma may be null
+template <typename scalar_t>
+inline void row_grad_input(const scalar_t* dy, const scalar_t* x, const scalar_t* gamma,
+                           int64_t n, scalar_t a, scalar_t b, scalar_t c, scalar_t* dx) {
+  using Vec = Vec256<scalar_t>;
+  const Vec a_vec(a);
+  const Vec b_vec(b);
+  const Vec c_vec(c);
+  for (int64_t j = 0; j < n; j += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - j);
+    auto g = Vec::loadu(dy + j, count);
+    if (gamma != nullptr) {
+      g = g * Vec::loadu(gamma + j, count);
+    }
+    const auto v = a_vec * g + b_vec * Vec::loadu(x + j, count) + c_vec;
+    v.store(dx + j, count);
+  }
+}
+
+// With x_hat = (x - mean) * rstd, and ds and db the sums of
+// dy * gamma * (x - mean) and of dy * gamma over the n normalized elements,
+//   dx = rstd * (dy * gamma - db / n - x_hat * ds * rstd / n)
+// which is a * gamma * dy + b * x + c with the coefficients below.
+template <typename scalar_t>
+inline void grad_input_coefficients(scalar_t ds, scalar_t db, scalar_t mean, scalar_t rstd,
+                                    int64_t n, scalar_t& b, scalar_t& c) {
+  b = -ds * rstd * rstd * rstd / n;
+  c = -b * mean - db * rstd / n;
+}
+
+template <typename scalar_t>
+void layer_norm_kernel(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    scalar_t eps,
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd) {
+  const scalar_t* X_data = X.data<scalar_t>();
+  const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+  const scalar_t* beta_data = beta.defined() ? beta.data<scalar_t>() : nullptr;
+  scalar_t* Y_data = Y.data<scalar_t>();
+  scalar_t* mean_data = mean.data<scalar_t>();
+  scalar_t* rstd_data = rstd.data<scalar_t>();
+
+  parallel_for(0, M, grain_size(N), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const scalar_t* x = X_data + i * N;
+      scalar_t mean_val, rstd_val;
+      row_moments(x, N, eps, mean_val, rstd_val);
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+      row_affine(x, gamma_data, beta_data, N, rstd_val, -rstd_val * mean_val, Y_data + i * N);
+    }
+  });
+}
+
+template <typename scalar_t>
+void layer_norm_backward_kernel(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta) {
+  using Vec = Vec256<scalar_t>;
+  const scalar_t* dY_data = dY.data<scalar_t>();
+  const scalar_t* X_data = X.data<scalar_t>();
+  const scalar_t* mean_data = mean.data<scalar_t>();
+  const scalar_t* rstd_data = rstd.data<scalar_t>();
+  const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+
+  if (dX.defined()) {
+    scalar_t* dX_data = dX.data<scalar_t>();
+    parallel_for(0, M, grain_size(N), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const scalar_t* dy = dY_data + i * N;
+        const scalar_t* x = X_data + i * N;
+        scalar_t ds, db, b, c;
+        row_grad_sums(dy, x, gamma_data, N, mean_data[i], ds, db);
+        grad_input_coefficients(ds, db, mean_data[i], rstd_data[i], N, b, c);
+        row_grad_input(dy, x, gamma_data, N, rstd_data[i], b, c, dX_data + i * N);
+      }
+    });
+  }
+
+  // The parameter gradients are sums over the rows, so the tasks split the
+  // columns instead, and accumulate the rows in order.
+  if (dgamma.defined() || dbeta.defined()) {
+    scalar_t* dgamma_data = dgamma.defined() ? dgamma.data<scalar_t>() : nullptr;
+    scalar_t* dbeta_data = dbeta.defined() ? dbeta.data<scalar_t>() : nullptr;
+    parallel_for(0, N, grain_size(M), [&](int64_t begin, int64_t end) {
+      for (int64_t j = begin; j < end; j += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), end - j);
+        Vec dgamma_vec(scalar_t(0));
+        Vec dbeta_vec(scalar_t(0));
+        for (int64_t i = 0; i < M; ++i) {
+          const auto dy = Vec::loadu(dY_data + i * N + j, count);
+          if (dgamma_data != nullptr) {
+            const auto x_hat = (Vec::loadu(X_data + i * N + j, count) - Vec(mean_data[i])) * Vec(rstd_data[i]);
+            dgamma_vec = dgamma_vec + dy * x_hat;
+          }
+          dbeta_vec = dbeta_vec + dy;
+        }
+        if (dgamma_data != nullptr) {
+          dgamma_vec.store(dgamma_data + j, count);
+        }
+        if (dbeta_data != nullptr) {
+          dbeta_vec.store(dbeta_data + j, count);
+        }
+      }
+    });
+  }
+}
+
+template <typename scalar_t>
+void group_norm_kernel(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    scalar_t eps,
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd) {
+  const int64_t D = C / group;
+  const int64_t K = D * HxW;
+  const scalar_t* X_data = X.data<scalar_t>();
+  const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+  const scalar_t* beta_data = beta.defined() ? beta.data<scalar_t>() : nullptr;
+  scalar_t* Y_data = Y.data<scalar_t>();
+  scalar_t* mean_data = mean.data<scalar_t>();
+  scalar_t* rstd_data = rstd.data<scalar_t>();
+
+  // A row is a group of a sample, the affine parameters change every HxW
+  // elements, with the channel, so they're folded in the scale and the shift.
+  parallel_for(0, N * group, grain_size(K), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const scalar_t* x = X_data + i * K;
+      scalar_t mean_val, rstd_val;
+      row_moments(x, K, eps, mean_val, rstd_val);
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+      for (int64_t d = 0; d < D; ++d) {
+        const int64_t c = (i % group) * D + d;
+        const scalar_t scale = gamma_data != nullptr ? rstd_val * gamma_data[c] : rstd_val;
+        const scalar_t shift = (beta_data != nullptr ? beta_data[c] : scalar_t(0)) - scale * mean_val;
+        row_affine<scalar_t>(x + d * HxW, nullptr, nullptr, HxW, scale, shift, Y_data + i * K + d * HxW);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void group_norm_backward_kernel(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta) {
+  const int64_t D = C / group;
+  const int64_t K = D * HxW;
+  const scalar_t* dY_data = dY.data<scalar_t>();
+  const scalar_t* X_data = X.data<scalar_t>();
+  const scalar_t* mean_data = mean.data<scalar_t>();
+  const scalar_t* rstd_data = rstd.data<scalar_t>();
+  const scalar_t* gamma_data = gamma.defined() ? gamma.data<scalar_t>() : nullptr;
+  scalar_t* dX_data = dX.defined() ? dX.data<scalar_t>() : nullptr;
+
+  // The sums of dy * (x - mean) and of dy over the HxW elements of each channel
+  // of each sample, which both the input and the parameter gradients are made
+  // of.
+  Tensor ds = at::empty({N, C}, X.options());
+  Tensor db = at::empty({N, C}, X.options());
+  scalar_t* ds_data = ds.data<scalar_t>();
+  scalar_t* db_data = db.data<scalar_t>();
+
+  parallel_for(0, N * group, grain_size(K), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      scalar_t ds_group = 0;
+      scalar_t db_group = 0;
+      for (int64_t d = 0; d < D; ++d) {
+        const int64_t c = (i % group) * D + d;
+        const int64_t offset = i * K + d * HxW;
+        scalar_t ds_val, db_val;
+        row_grad_sums<scalar_t>(dY_data + offset, X_data + offset, nullptr, HxW,
+                                mean_data[i], ds_val, db_val);
+        ds_data[i * D + d] = ds_val;
+        db_data[i * D + d] = db_val;
+        const scalar_t gamma_val = gamma_data != nullptr ? gamma_data[c] : scalar_t(1);
+        ds_group += gamma_val * ds_val;
+        db_group += gamma_val * db_val;
+      }
+      if (dX_data != nullptr) {
+        scalar_t b, c;
+        grad_input_coefficients(ds_group, db_group, mean_data[i], rstd_data[i], K, b, c);
+        for (int64_t d = 0; d < D; ++d) {
+          const int64_t offset = i * K + d * HxW;
+          const scalar_t gamma_val = gamma_data != nullptr ? gamma_data[(i % group) * D + d] : scalar_t(1);
+          row_grad_input<scalar_t>(dY_data + offset, X_data + offset, nullptr, HxW,
+                                   rstd_data[i] * gamma_val, b, c, dX_data + offset);
+        }
+      }
+    }
+  });
+
+  if (dgamma.defined() || dbeta.defined()) {
+    scalar_t* dgamma_data = dgamma.defined() ? dgamma.data<scalar_t>() : nullptr;
+    scalar_t* dbeta_data = dbeta.defined() ? dbeta.data<scalar_t>() : nullptr;
+    for (int64_t c = 0; c < C; ++c) {
+      scalar_t dgamma_val = 0;
+      scalar_t dbeta_val = 0;
+      for (int64_t n = 0; n < N; ++n) {
+        const int64_t i = n * group + c / D;
+        dgamma_val += ds_data[n * C + c] * rstd_data[i];
+        dbeta_val += db_data[n * C + c];
+      }
+      if (dgamma_data != nullptr) {
+        dgamma_data[c] = dgamma_val;
+      }
+      if (dbeta_data != nullptr) {
+        dbeta_data[c] = dbeta_val;
+      }
+    }
+  }
+}
+
+void layer_norm_kernel_impl(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    double eps,
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "layer_norm", [&] {
+    layer_norm_kernel<scalar_t>(X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
+  });
+}
+
+void layer_norm_backward_kernel_impl(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t M,
+    int64_t N,
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "layer_norm_backward", [&] {
+    layer_norm_backward_kernel<scalar_t>(dY, X, mean, rstd, gamma, M, N, dX, dgamma, dbeta);
+  });
+}
+
+void group_norm_kernel_impl(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor& Y,
+    Tensor& mean,
+    Tensor& rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "group_norm", [&] {
+    group_norm_kernel<scalar_t>(X, gamma, beta, N, C, HxW, group, static_cast<scalar_t>(eps), Y, mean, rstd);
+  });
+}
+
+void group_norm_backward_kernel_impl(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor& dX,
+    Tensor& dgamma,
+    Tensor& dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "group_norm_backward", [&] {
+    group_norm_backward_kernel<scalar_t>(dY, X, mean, rstd, gamma, N, C, HxW, group, dX, dgamma, dbeta);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(layer_norm_stub, &layer_norm_kernel_impl);
+REGISTER_DISPATCH(layer_norm_backward_stub, &layer_norm_backward_kernel_impl);
+REGISTER_DISPATCH(group_norm_stub, &group_norm_kernel_impl);
+REGISTER_DISPATCH(group_norm_backward_stub, &group_norm_backward_kernel_impl);
+
+}} // namespace at::native
@@ -0,0 +1,357 @@
+#include <ATen/native/Pooling.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/ChannelsLast.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace at { namespace native { namespace {
+
+using namespace vec256;
+
+// The positions [start, end) of the max pooling window of output position `o`
+// along one dimension, stepping by the dilation, with `start` moved past the
+// padding like in THNN.
+struct MaxPoolWindow {
+  int64_t start, end, steps;
+};
+
+static inline MaxPoolWindow max_pool_window(
+    int64_t o, int64_t k, int64_t stride, int64_t pad, int64_t dilation, int64_t input_size) {
+  int64_t start = o * stride - pad;
+  const int64_t end = std::min(start + (k - 1) * dilation + 1, input_size);
+  while (start < 0) {
+    start += dilation;
+  }
+  return {start, end, end > start ? (end - start + dilation - 1) / dilation : 0};
+}
+
+// The maximum of `vmax` and `val`, updating `vpos` to `pos` in the lanes where
+// `val` wins: like THNN, the first maximum of a window wins, and NaNs win
+// over everything, the last one over the others.
+template <typename scalar_t>
+static inline void max_pool_update(
+    Vec256<scalar_t>& vmax, Vec256<scalar_t>& vpos, const Vec256<scalar_t>& val, int64_t pos) {
+  using Vec = Vec256<scalar_t>;
+  const Vec all_ones = Vec(0) == Vec(0);
+  const Vec mask = (val > vmax) | ((val == val) ^ all_ones);
+  vmax = Vec::blendv(vmax, val, mask);
+  vpos = Vec::blendv(vpos, Vec(static_cast<scalar_t>(pos)), mask);
+}
+
+// NC(D)HW: the output rows are computed in parallel. With a stride of 1 along
+// the width, the output columns whose windows lie within the input are
+// computed Vec256::size() at a time, keeping the position of the maximum in
+// the window in a vector of scalar_t (kernels are far smaller than 2^24).
+template <typename scalar_t>
+static void max_pool_contiguous(
+    const PoolingParams& p, const Tensor& input, Tensor& output, Tensor& indices) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t IT = p.input_depth, IH = p.input_height, IW = p.input_width;
+  const int64_t OT = p.output_depth, OH = p.output_height, OW = p.output_width;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* indices_data = indices.data<int64_t>();
+
+  const int64_t ow_begin = p.dW == 1 ? std::min(p.padW, OW) : OW;
+  const int64_t ow_end = p.dW == 1
+      ? std::min(OW, IW + p.padW - (p.kW - 1) * p.dilationW)
+      : OW;
+  const int64_t work_per_row = std::max<int64_t>(OW * p.kT * p.kH * p.kW, 1);
+
+  parallel_for(
+      0,
+      p.nbatch * p.channels * OT * OH,
+      std::max<int64_t>(internal::GRAIN_SIZE / work_per_row, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; row++) {
+          const int64_t oh = row % OH;
+          const int64_t ot = row / OH % OT;
+          const scalar_t* in = input_data + row / OH / OT * IT * IH * IW;
+          scalar_t* out = output_data + row * OW;
+          int64_t* ind = indices_data + row * OW;
+          const MaxPoolWindow tw = max_pool_window(ot, p.kT, p.dT, p.padT, p.dilationT, IT);
+          const MaxPoolWindow hw = max_pool_window(oh, p.kH, p.dH, p.padH, p.dilationH, IH);
+
+          auto scalar_column = [&](int64_t ow) {
+            const MaxPoolWindow ww = max_pool_window(ow, p.kW, p.dW, p.padW, p.dilationW, IW);
+            scalar_t maxval = -std::numeric_limits<scalar_t>::infinity();
+            int64_t maxindex = -1;
+            for (int64_t z = tw.start; z < tw.end; z += p.dilationT) {
+              for (int64_t y = hw.start; y < hw.end; y += p.dilationH) {
+                for (int64_t x = ww.start; x < ww.end; x += p.dilationW) {
+                  const int64_t index = (z * IH + y) * IW + x;
+                  const scalar_t val = in[index];
+                  if (val > maxval || std::isnan(val)) {
+                    maxval = val;
+                    maxindex = index;
+                  }
+                }
+              }
+            }
+            out[ow] = maxval;
+            ind[ow] = maxindex;
+          };
+
+          int64_t ow = 0;
+          for (; ow < ow_begin; ow++) {
+            scalar_column(ow);
+          }
+          for (; ow + Vec::size() <= ow_end; ow += Vec::size()) {
+            Vec vmax(-std::numeric_limits<scalar_t>::infinity());
+            Vec vpos(static_cast<scalar_t>(-1));
+            int64_t pos = 0;
+            for (int64_t z = tw.start; z < tw.end; z += p.dilationT) {
+              for (int64_t y = hw.start; y < hw.end; y += p.dilationH) {
+                const scalar_t* in_row = in + (z * IH + y) * IW + ow - p.padW;
+                for (int64_t kx = 0; kx < p.kW; kx++, pos++) {
+                  max_pool_update(vmax, vpos, Vec::loadu(in_row + kx * p.dilationW), pos);
+                }
+              }
+            }
+            vmax.store(out + ow);
+            scalar_t positions[Vec::size()];
+            vpos.store(positions);
+            for (int64_t i = 0; i < Vec::size(); i++) {
+              const int64_t k = static_cast<int64_t>(positions[i]);
+              if (k < 0) {
+                ind[ow + i] = -1;
+                continue;
+              }
+              const int64_t z = tw.start + k / p.kW / hw.steps * p.dilationT;
+              const int64_t y = hw.start + k / p.kW % hw.steps * p.dilationH;
+              const int64_t x = ow + i - p.padW + k % p.kW * p.dilationW;
+              ind[ow + i] = (z * IH + y) * IW + x;
+            }
+          }
+          for (; ow < OW; ow++) {
+            scalar_column(ow);
+          }
+        }
+      });
+}
+
+// Calls `f(n, oh, ow)` on the output pixels of a 2d pooling in parallel
+template <typename func_t>
+static void parallel_output_pixels(const PoolingParams& p, const func_t& f) {
+  const int64_t work_per_pixel = std::max<int64_t>(p.channels * p.kH * p.kW, 1);
+  parallel_for(
+      0,
+      p.nbatch * p.output_height * p.output_width,
+      std::max<int64_t>(internal::GRAIN_SIZE / work_per_pixel, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const int64_t ow = i % p.output_width;
+          const int64_t oh = i / p.output_width % p.output_height;
+          const int64_t n = i / p.output_width / p.output_height;
+          f(n, oh, ow);
+        }
+      });
+}
+
+// NHWC: the output pixels are computed in parallel, Vec256::size() channels
+// at a time.
+template <typename scalar_t>
+static void max_pool2d_channels_last(
+    const PoolingParams& p, const Tensor& input, Tensor& output, Tensor& indices) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t C = p.channels;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* indices_data = indices.data<int64_t>();
+  parallel_output_pixels(p, [&](int64_t n, int64_t oh, int64_t ow) {
+    const MaxPoolWindow hw = max_pool_window(oh, p.kH, p.dH, p.padH, p.dilationH, p.input_height);
+    const MaxPoolWindow ww = max_pool_window(ow, p.kW, p.dW, p.padW, p.dilationW, p.input_width);
+    const scalar_t* in = input_data + n * p.input_height * p.input_width * C;
+    const int64_t offset = ((n * p.output_height + oh) * p.output_width + ow) * C;
+    scalar_t* out = output_data + offset;
+    int64_t* ind = indices_data + offset;
+
+    int64_t c = 0;
+    for (; c + Vec::size() <= C; c += Vec::size()) {
+      Vec vmax(-std::numeric_limits<scalar_t>::infinity());
+      Vec vpos(static_cast<scalar_t>(-1));
+      int64_t pos = 0;
+      for (int64_t y = hw.start; y < hw.end; y += p.dilationH) {
+        for (int64_t x = ww.start; x < ww.end; x += p.dilationW, pos++) {
+          max_pool_update(vmax, vpos, Vec::loadu(in + (y * p.input_width + x) * C + c), pos);
+        }
+      }
+      vmax.store(out + c);
+      scalar_t positions[Vec::size()];
+      vpos.store(positions);
+      for (int64_t i = 0; i < Vec::size(); i++) {
+        const int64_t k = static_cast<int64_t>(positions[i]);
+        ind[c + i] = k < 0 ? -1
+            : (hw.start + k / ww.steps * p.dilationH) * p.input_width +
+                ww.start + k % ww.steps * p.dilationW;
+      }
+    }
+    for (; c < C; c++) {
+      scalar_t maxval = -std::numeric_limits<scalar_t>::infinity();
+      int64_t maxindex = -1;
+      for (int64_t y = hw.start; y < hw.end; y += p.dilationH) {
+        for (int64_t x = ww.start; x < ww.end; x += p.dilationW) {
+          const int64_t index = y * p.input_width + x;
+          const scalar_t val = in[index * C + c];
+          if (val > maxval || std::isnan(val)) {
+            maxval = val;
+            maxindex = index;
+          }
+        }
+      }
+      out[c] = maxval;
+      ind[c] = maxindex;
+    }
+  });
+}
+
+static void max_pool_kernel(
+    const PoolingParams& p, const Tensor& input, Tensor& output, Tensor& indices) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "max_pool_cpu", [&] {
+    if (is_channels_last(input)) {
+      max_pool2d_channels_last<scalar_t>(p, input, output, indices);
+    } else {
+      max_pool_contiguous<scalar_t>(p, input, output, indices);
+    }
+  });
+}
+
+// The window of an average pooling and the number of elements it is divided
+// by, computed like THNN
+struct AvgPoolWindow {
+  int64_t hstart, hend, wstart, wend, divide_factor;
+};
+
+static inline AvgPoolWindow avg_pool2d_window(
+    const PoolingParams& p, int64_t oh, int64_t ow, bool count_include_pad) {
+  int64_t hstart = oh * p.dH - p.padH;
+  int64_t wstart = ow * p.dW - p.padW;
+  int64_t hend = std::min(hstart + p.kH, p.input_height + p.padH);
+  int64_t wend = std::min(wstart + p.kW, p.input_width + p.padW);
+  const int64_t pool_size = (hend - hstart) * (wend - wstart);
+  hstart = std::max<int64_t>(hstart, 0);
+  wstart = std::max<int64_t>(wstart, 0);
+  hend = std::min(hend, p.input_height);
+  wend = std::min(wend, p.input_width);
+  return {hstart, hend, wstart, wend,
+          count_include_pad ? pool_size : (hend - hstart) * (wend - wstart)};
+}
+
+// NCHW, like max_pool_contiguous. The windows of the vectorized columns lie
+// within the input along the width, so they all have the same divisor.
+template <typename scalar_t>
+static void avg_pool2d_contiguous(
+    const PoolingParams& p, const Tensor& input, Tensor& output, bool count_include_pad) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t IH = p.input_height, IW = p.input_width;
+  const int64_t OH = p.output_height, OW = p.output_width;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+
+  const int64_t ow_begin = p.dW == 1 ? std::min(p.padW, OW) : OW;
+  const int64_t ow_end = p.dW == 1 ? std::min(OW, IW + p.padW - p.kW + 1) : OW;
+  const int64_t work_per_row = std::max<int64_t>(OW * p.kH * p.kW, 1);
+
+  parallel_for(
+      0,
+      p.nbatch * p.channels * OH,
+      std::max<int64_t>(internal::GRAIN_SIZE / work_per_row, 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; row++) {
+          const int64_t oh = row % OH;
+          const scalar_t* in = input_data + row / OH * IH * IW;
+          scalar_t* out = output_data + row * OW;
+
+          auto scalar_column = [&](int64_t ow) {
+            const AvgPoolWindow w = avg_pool2d_window(p, oh, ow, count_include_pad);
+            scalar_t sum = 0;
+            for (int64_t y = w.hstart; y < w.hend; y++) {
+              for (int64_t x = w.wstart; x < w.wend; x++) {
+                sum += in[y * IW + x];
+              }
+            }
+            out[ow] = sum / w.divide_factor;
+          };
+
+          int64_t ow = 0;
+          for (; ow < ow_begin; ow++) {
+            scalar_column(ow);
+          }
+          if (ow + Vec::size() <= ow_end) {
+            const AvgPoolWindow w = avg_pool2d_window(p, oh, ow, count_include_pad);
+            const Vec divide_factor(static_cast<scalar_t>(w.divide_factor));
+            for (; ow + Vec::size() <= ow_end; ow += Vec::size()) {
+              Vec sum(scalar_t(0));
+              for (int64_t y = w.hstart; y < w.hend; y++) {
+                const scalar_t* in_row = in + y * IW + ow - p.padW;
+                for (int64_t kx = 0; kx < p.kW; kx++) {
+                  sum = sum + Vec::loadu(in_row + kx);
+                }
+              }
+              (sum / divide_factor).store(out + ow);
+            }
+          }
+          for (; ow < OW; ow++) {
+            scalar_column(ow);
+          }
+        }
+      });
+}
+
+template <typename scalar_t>
+static void avg_pool2d_channels_last(
+    const PoolingParams& p, const Tensor& input, Tensor& output, bool count_include_pad) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t C = p.channels;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+  parallel_output_pixels(p, [&](int64_t n, int64_t oh, int64_t ow) {
+    const AvgPoolWindow w = avg_pool2d_window(p, oh, ow, count_include_pad);
+    const scalar_t* in = input_data + n * p.input_height * p.input_width * C;
+    scalar_t* out = output_data + ((n * p.output_height + oh) * p.output_width + ow) * C;
+
+    int64_t c = 0;
+    const Vec divide_factor(static_cast<scalar_t>(w.divide_factor));
+    for (; c + Vec::size() <= C; c += Vec::size()) {
+      Vec sum(scalar_t(0));
+      for (int64_t y = w.hstart; y < w.hend; y++) {
+        for (int64_t x = w.wstart; x < w.wend; x++) {
+          sum = sum + Vec::loadu(in + (y * p.input_width + x) * C + c);
+        }
+      }
+      (sum / divide_factor).store(out + c);
+    }
+    for (; c < C; c++) {
+      scalar_t sum = 0;
+      for (int64_t y = w.hstart; y < w.hend; y++) {
+        for (int64_t x = w.wstart; x < w.wend; x++) {
+          sum += in[(y * p.input_width + x) * C + c];
+        }
+      }
+      out[c] = sum / w.divide_factor;
+    }
+  });
+}
+
+static void avg_pool2d_kernel(
+    const PoolingParams& p, const Tensor& input, Tensor& output, bool count_include_pad) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "avg_pool2d_cpu", [&] {
+    if (is_channels_last(input)) {
+      avg_pool2d_channels_last<scalar_t>(p, input, output, count_include_pad);
+    } else {
+      avg_pool2d_contiguous<scalar_t>(p, input, output, count_include_pad);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(max_pool_stub, &max_pool_kernel);
+REGISTER_DISPATCH(avg_pool2d_stub, &avg_pool2d_kernel);
+
+}} // namespace at::native
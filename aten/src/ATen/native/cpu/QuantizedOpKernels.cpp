@@ -0,0 +1,106 @@
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/TensorIterator.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Adds the quantized values of `self` and `other` a vector of floats at a
+// time: each value is dequantized, summed and requantized in registers,
+// rounding the same way as quantize_val, so the result is the one of
+// dequantize(), add and quantize_linear() without the float tensors.
+template <bool ReLUFused>
+void qadd_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
+  using Vec = Vec256<float>;
+  const Vec self_scale(self.q_scale().toFloat());
+  const Vec self_zero_point(self.q_zero_point().toFloat());
+  const Vec other_scale(other.q_scale().toFloat());
+  const Vec other_zero_point(other.q_zero_point().toFloat());
+  const Vec out_scale(out.q_scale().toFloat());
+  const Vec out_zero_point(out.q_zero_point().toFloat());
+  const int64_t zero_point = out.q_zero_point().toLong();
+
+  auto iter = TensorIterator::binary_op(out, self, other);
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qadd", [&]() {
+    using underlying_t = typename scalar_t::underlying;
+    // requantizing max(x, 0) is the same as clamping the requantized x to
+    // the zero point from below
+    const int64_t qmin = ReLUFused
+        ? std::max<int64_t>(zero_point, std::numeric_limits<underlying_t>::min())
+        : std::numeric_limits<underlying_t>::min();
+    const int64_t qmax = std::numeric_limits<underlying_t>::max();
+
+    iter->for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      float self_buf[Vec::size()];
+      float other_buf[Vec::size()];
+      float out_buf[Vec::size()];
+      for (int64_t i = 0; i < n; i += Vec::size()) {
+        const int64_t count = std::min<int64_t>(n - i, Vec::size());
+        for (int64_t j = 0; j < count; j++) {
+          self_buf[j] = reinterpret_cast<const scalar_t*>(data[1] + (i + j) * strides[1])->val_;
+          other_buf[j] = reinterpret_cast<const scalar_t*>(data[2] + (i + j) * strides[2])->val_;
+        }
+        const Vec sum = (Vec::loadu(self_buf) - self_zero_point) * self_scale +
+            (Vec::loadu(other_buf) - other_zero_point) * other_scale;
+        (sum / out_scale + out_zero_point).round().store(out_buf);
+        for (int64_t j = 0; j < count; j++) {
+          const float value = std::min<float>(std::max<float>(out_buf[j], qmin), qmax);
+          const int64_t qvalue = std::min<int64_t>(
+              std::max<int64_t>(static_cast<int64_t>(value), qmin), qmax);
+          reinterpret_cast<scalar_t*>(data[0] + (i + j) * strides[0])->val_ =
+              static_cast<underlying_t>(qvalue);
+        }
+      }
+    });
+  });
+}
+
+// Each task counts a contiguous part of `self` into its own row of bins,
+// the rows are summed at the end.
+void histogram_kernel(Tensor& counts, const Tensor& self, double min, double max) {
+  const int64_t bins = counts.numel();
+  const int64_t numel = self.numel();
+  const int64_t num_tasks = std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), numel / internal::GRAIN_SIZE), 1);
+  auto task_counts = at::zeros({num_tasks, bins}, counts.options());
+  int64_t* task_counts_data = task_counts.data<int64_t>();
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histogram_cpu", [&] {
+    const scalar_t* self_data = self.data<scalar_t>();
+    const scalar_t lower = static_cast<scalar_t>(min);
+    const scalar_t bins_per_unit = static_cast<scalar_t>(bins / (max - min));
+    const scalar_t last_bin = static_cast<scalar_t>(bins - 1);
+    at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t task = begin; task < end; task++) {
+        int64_t* row = task_counts_data + task * bins;
+        const int64_t first = numel * task / num_tasks;
+        const int64_t last = numel * (task + 1) / num_tasks;
+        for (int64_t i = first; i < last; i++) {
+          // Clamp in floating point, so that the cast is defined (and NaNs
+          // count in the first bin)
+          scalar_t bin = (self_data[i] - lower) * bins_per_unit;
+          bin = bin > 0 ? bin : 0;
+          bin = bin < last_bin ? bin : last_bin;
+          row[static_cast<int64_t>(bin)]++;
+        }
+      }
+    });
+  });
+  counts.add_(task_counts.sum(0));
+}
+
+} // namespace
+
+REGISTER_DISPATCH(qadd_stub, &qadd_kernel</*ReLUFused=*/false>);
+REGISTER_DISPATCH(qadd_relu_stub, &qadd_kernel</*ReLUFused=*/true>);
+REGISTER_DISPATCH(histogram_stub, &histogram_kernel);
+
+}}  // namespace at::native
@@ -0,0 +1,295 @@
+#include <ATen/native/RNN.h>
+
+#include <algorithm>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+// Pointwise parts of the fused LSTM and GRU cells. They compute the same
+// values, and fill the same workspaces, as the kernels in cuda/RNN.cu, so
+// that the backward of _thnn_fused_lstm_cell and _thnn_fused_gru_cell works
+// the same way on both devices. All tensors are contiguous, the gates are laid
+// out as [batch, factor * hidden_size], every other tensor is [batch,
+// hidden_size]. A task works on whole rows of the batch, and vectorizes over
+// the hidden size, with a partial vector at the end of every row.
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Rows per task so that a task touches roughly GRAIN_SIZE elements
+inline int64_t grain_size(int64_t row_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_size));
+}
+
+template <typename scalar_t>
+void lstm_cell_kernel(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& cx,
+    Tensor& hy,
+    Tensor& cy,
+    Tensor& workspace) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  const bool has_bias = input_bias.defined();
+  const scalar_t* igates_data = input_gates.data<scalar_t>();
+  const scalar_t* hgates_data = hidden_gates.data<scalar_t>();
+  const scalar_t* b1_data = has_bias ? input_bias.data<scalar_t>() : nullptr;
+  const scalar_t* b2_data = has_bias ? hidden_bias.data<scalar_t>() : nullptr;
+  const scalar_t* cx_data = cx.data<scalar_t>();
+  scalar_t* hy_data = hy.data<scalar_t>();
+  scalar_t* cy_data = cy.data<scalar_t>();
+  scalar_t* ws_data = workspace.data<scalar_t>();
+
+  parallel_for(0, batch_size, grain_size(4 * hsz), [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* igates = igates_data + b * 4 * hsz;
+      const scalar_t* hgates = hgates_data + b * 4 * hsz;
+      scalar_t* ws = ws_data + b * 4 * hsz;
+      for (int64_t j = 0; j < hsz; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+        auto gate = [&](int64_t k) {
+          const int64_t offset = k * hsz + j;
+          auto g = Vec::loadu(igates + offset, n) + Vec::loadu(hgates + offset, n);
+          if (has_bias) {
+            g = g + Vec::loadu(b1_data + offset, n) + Vec::loadu(b2_data + offset, n);
+          }
+          return g;
+        };
+        const auto ig = gate(0).sigmoid();
+        const auto fg = gate(1).sigmoid();
+        const auto cg = gate(2).tanh();
+        const auto og = gate(3).sigmoid();
+
+        const auto c = fg * Vec::loadu(cx_data + b * hsz + j, n) + ig * cg;
+        const auto h = og * c.tanh();
+        c.store(cy_data + b * hsz + j, n);
+        h.store(hy_data + b * hsz + j, n);
+
+        ig.store(ws + 0 * hsz + j, n);
+        fg.store(ws + 1 * hsz + j, n);
+        cg.store(ws + 2 * hsz + j, n);
+        og.store(ws + 3 * hsz + j, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void lstm_cell_backward_kernel(
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace,
+    Tensor& grad_gates,
+    Tensor& grad_cx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  const scalar_t* ghy_data = grad_hy.defined() ? grad_hy.data<scalar_t>() : nullptr;
+  const scalar_t* gcy_data = grad_cy.defined() ? grad_cy.data<scalar_t>() : nullptr;
+  const scalar_t* cx_data = cx.data<scalar_t>();
+  const scalar_t* cy_data = cy.data<scalar_t>();
+  const scalar_t* ws_data = workspace.data<scalar_t>();
+  scalar_t* ggates_data = grad_gates.data<scalar_t>();
+  scalar_t* gcx_data = grad_cx.data<scalar_t>();
+
+  parallel_for(0, batch_size, grain_size(4 * hsz), [&](int64_t begin, int64_t end) {
+    const Vec one(1);
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* ws = ws_data + b * 4 * hsz;
+      scalar_t* ggates = ggates_data + b * 4 * hsz;
+      for (int64_t j = 0; j < hsz; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+        const int64_t offset = b * hsz + j;
+        const auto ig = Vec::loadu(ws + 0 * hsz + j, n);
+        const auto fg = Vec::loadu(ws + 1 * hsz + j, n);
+        const auto cg = Vec::loadu(ws + 2 * hsz + j, n);
+        const auto og = Vec::loadu(ws + 3 * hsz + j, n);
+        const auto go = ghy_data ? Vec::loadu(ghy_data + offset, n) : Vec(0);
+        const auto goc = gcy_data ? Vec::loadu(gcy_data + offset, n) : Vec(0);
+
+        const auto tanh_cy = Vec::loadu(cy_data + offset, n).tanh();
+        const auto gog = go * tanh_cy;
+        const auto gcx = go * og * (one - tanh_cy * tanh_cy) + goc;
+
+        const auto gig = gcx * cg * (one - ig) * ig;
+        const auto gfg = gcx * Vec::loadu(cx_data + offset, n) * (one - fg) * fg;
+        const auto gcg = gcx * ig * (one - cg * cg);
+
+        gig.store(ggates + 0 * hsz + j, n);
+        gfg.store(ggates + 1 * hsz + j, n);
+        gcg.store(ggates + 2 * hsz + j, n);
+        (gog * (one - og) * og).store(ggates + 3 * hsz + j, n);
+        (gcx * fg).store(gcx_data + offset, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void gru_cell_kernel(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& hx,
+    Tensor& hy,
+    Tensor& workspace) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = hx.size(0);
+  const int64_t hsz = hx.size(1);
+  const bool has_bias = input_bias.defined();
+  const scalar_t* igates_data = input_gates.data<scalar_t>();
+  const scalar_t* hgates_data = hidden_gates.data<scalar_t>();
+  const scalar_t* b1_data = has_bias ? input_bias.data<scalar_t>() : nullptr;
+  const scalar_t* b2_data = has_bias ? hidden_bias.data<scalar_t>() : nullptr;
+  const scalar_t* hx_data = hx.data<scalar_t>();
+  scalar_t* hy_data = hy.data<scalar_t>();
+  scalar_t* ws_data = workspace.data<scalar_t>();
+
+  parallel_for(0, batch_size, grain_size(5 * hsz), [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* igates = igates_data + b * 3 * hsz;
+      const scalar_t* hgates = hgates_data + b * 3 * hsz;
+      scalar_t* ws = ws_data + b * 5 * hsz;
+      for (int64_t j = 0; j < hsz; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+        auto input_gate = [&](int64_t k) {
+          auto g = Vec::loadu(igates + k * hsz + j, n);
+          return has_bias ? g + Vec::loadu(b1_data + k * hsz + j, n) : g;
+        };
+        auto hidden_gate = [&](int64_t k) {
+          auto g = Vec::loadu(hgates + k * hsz + j, n);
+          return has_bias ? g + Vec::loadu(b2_data + k * hsz + j, n) : g;
+        };
+        const auto rg = (input_gate(0) + hidden_gate(0)).sigmoid();
+        const auto ig = (input_gate(1) + hidden_gate(1)).sigmoid();
+        const auto hn = hidden_gate(2);
+        const auto ng = (input_gate(2) + rg * hn).tanh();
+        const auto h = Vec::loadu(hx_data + b * hsz + j, n);
+        (ng + ig * (h - ng)).store(hy_data + b * hsz + j, n);
+
+        rg.store(ws + 0 * hsz + j, n);
+        ig.store(ws + 1 * hsz + j, n);
+        ng.store(ws + 2 * hsz + j, n);
+        h.store(ws + 3 * hsz + j, n);
+        hn.store(ws + 4 * hsz + j, n);
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void gru_cell_backward_kernel(
+    const Tensor& grad_hy,
+    const Tensor& workspace,
+    Tensor& grad_input_gates,
+    Tensor& grad_hidden_gates,
+    Tensor& grad_hx) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t batch_size = grad_hy.size(0);
+  const int64_t hsz = grad_hy.size(1);
+  const scalar_t* ghy_data = grad_hy.data<scalar_t>();
+  const scalar_t* ws_data = workspace.data<scalar_t>();
+  scalar_t* gigates_data = grad_input_gates.data<scalar_t>();
+  scalar_t* ghgates_data = grad_hidden_gates.data<scalar_t>();
+  scalar_t* ghx_data = grad_hx.data<scalar_t>();
+
+  parallel_for(0, batch_size, grain_size(5 * hsz), [&](int64_t begin, int64_t end) {
+    const Vec one(1);
+    for (int64_t b = begin; b < end; ++b) {
+      const scalar_t* ws = ws_data + b * 5 * hsz;
+      scalar_t* gigates = gigates_data + b * 3 * hsz;
+      scalar_t* ghgates = ghgates_data + b * 3 * hsz;
+      for (int64_t j = 0; j < hsz; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+        const auto rg = Vec::loadu(ws + 0 * hsz + j, n);
+        const auto ig = Vec::loadu(ws + 1 * hsz + j, n);
+        const auto ng = Vec::loadu(ws + 2 * hsz + j, n);
+        const auto hx = Vec::loadu(ws + 3 * hsz + j, n);
+        const auto hn = Vec::loadu(ws + 4 * hsz + j, n);
+        const auto go = Vec::loadu(ghy_data + b * hsz + j, n);
+
+        const auto gig = go * (hx - ng) * (one - ig) * ig;
+        const auto gin = go * (one - ig) * (one - ng * ng);
+        const auto grg = gin * hn * (one - rg) * rg;
+
+        grg.store(gigates + 0 * hsz + j, n);
+        gig.store(gigates + 1 * hsz + j, n);
+        gin.store(gigates + 2 * hsz + j, n);
+        grg.store(ghgates + 0 * hsz + j, n);
+        gig.store(ghgates + 1 * hsz + j, n);
+        (gin * rg).store(ghgates + 2 * hsz + j, n);
+        (go * ig).store(ghx_data + b * hsz + j, n);
+      }
+    }
+  });
+}
+
+void lstm_cell_kernel_impl(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& cx,
+    Tensor& hy,
+    Tensor& cy,
+    Tensor& workspace) {
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_lstm_cell", [&] {
+    lstm_cell_kernel<scalar_t>(input_gates, hidden_gates, input_bias, hidden_bias, cx, hy, cy, workspace);
+  });
+}
+
+void lstm_cell_backward_kernel_impl(
+    const Tensor& grad_hy,
+    const Tensor& grad_cy,
+    const Tensor& cx,
+    const Tensor& cy,
+    const Tensor& workspace,
+    Tensor& grad_gates,
+    Tensor& grad_cx) {
+  AT_DISPATCH_FLOATING_TYPES(workspace.scalar_type(), "fused_lstm_cell_backward", [&] {
+    lstm_cell_backward_kernel<scalar_t>(grad_hy, grad_cy, cx, cy, workspace, grad_gates, grad_cx);
+  });
+}
+
+void gru_cell_kernel_impl(
+    const Tensor& input_gates,
+    const Tensor& hidden_gates,
+    const Tensor& input_bias,
+    const Tensor& hidden_bias,
+    const Tensor& hx,
+    Tensor& hy,
+    Tensor& workspace) {
+  AT_DISPATCH_FLOATING_TYPES(input_gates.scalar_type(), "fused_gru_cell", [&] {
+    gru_cell_kernel<scalar_t>(input_gates, hidden_gates, input_bias, hidden_bias, hx, hy, workspace);
+  });
+}
+
+void gru_cell_backward_kernel_impl(
+    const Tensor& grad_hy,
+    const Tensor& workspace,
+    Tensor& grad_input_gates,
+    Tensor& grad_hidden_gates,
+    Tensor& grad_hx) {
+  AT_DISPATCH_FLOATING_TYPES(grad_hy.scalar_type(), "fused_gru_cell_backward", [&] {
+    gru_cell_backward_kernel<scalar_t>(grad_hy, workspace, grad_input_gates, grad_hidden_gates, grad_hx);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_lstm_cell_stub, &lstm_cell_kernel_impl);
+REGISTER_DISPATCH(fused_lstm_cell_backward_stub, &lstm_cell_backward_kernel_impl);
+REGISTER_DISPATCH(fused_gru_cell_stub, &gru_cell_kernel_impl);
+REGISTER_DISPATCH(fused_gru_cell_backward_stub, &gru_cell_backward_kernel_impl);
+
+}} // namespace at::native
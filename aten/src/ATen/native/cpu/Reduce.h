@@ -5,6 +5,7 @@
 #include <c10/util/TypeList.h>
 
 #include <sstream>
+#include <tuple>
 
 namespace at { namespace native { namespace {
 
@@ -190,4 +191,184 @@ void binary_kernel_reduce_vec(TensorIterator& iter, func_t op, vec_func_t vop, d
   });
 }
 
+// Fused reductions
+// ~~~~~~~~~~~~~~~~
+// The overload of binary_kernel_reduce_vec below takes a tuple of ops and
+// reduces the single input of `iter` into each of its outputs in one
+// traversal, so that e.g. min and max, or sum and sum of squares, only read
+// the input once.  Each op must provide
+//
+//   using scalar_t = ...;
+//   scalar_t identity() const;
+//   scalar_t reduce(scalar_t acc, scalar_t data) const;
+//   Vec256<scalar_t> reduce(Vec256<scalar_t> acc, Vec256<scalar_t> data) const;
+//   scalar_t combine(scalar_t a, scalar_t b) const;
+//   Vec256<scalar_t> combine(Vec256<scalar_t> a, Vec256<scalar_t> b) const;
+//
+// where reduce adds one data point to an accumulated value and combine merges
+// two accumulated values.  Unlike the single-output version, the two need not
+// be the same function.  All ops and outputs must share the input's dtype.
+
+template <typename ops0_t, typename ops1_t>
+static inline void fused_inner_reduction(char** data, int64_t n, const ops0_t& op0, const ops1_t& op1) {
+  using scalar_t = typename ops0_t::scalar_t;
+  using Vec = Vec256<scalar_t>;
+  constexpr int64_t kStep = 4 * Vec::size();
+  const scalar_t* in = (const scalar_t*)data[2];
+  scalar_t acc0 = op0.identity();
+  scalar_t acc1 = op1.identity();
+  int64_t i = 0;
+  if (n >= kStep) {
+    Vec vacc0[4] = { Vec(acc0), Vec(acc0), Vec(acc0), Vec(acc0) };
+    Vec vacc1[4] = { Vec(acc1), Vec(acc1), Vec(acc1), Vec(acc1) };
+    for (; i + kStep <= n; i += kStep) {
+      for (int j = 0; j < 4; j++) {
+        Vec x = Vec::loadu(in + i + j * Vec::size());
+        vacc0[j] = op0.reduce(vacc0[j], x);
+        vacc1[j] = op1.reduce(vacc1[j], x);
+      }
+    }
+    scalar_t buffer[Vec::size()];
+    op0.combine(op0.combine(vacc0[0], vacc0[1]), op0.combine(vacc0[2], vacc0[3])).store(buffer);
+    for (int j = 0; j < Vec::size(); j++) {
+      acc0 = op0.combine(acc0, buffer[j]);
+    }
+    op1.combine(op1.combine(vacc1[0], vacc1[1]), op1.combine(vacc1[2], vacc1[3])).store(buffer);
+    for (int j = 0; j < Vec::size(); j++) {
+      acc1 = op1.combine(acc1, buffer[j]);
+    }
+  }
+  for (; i < n; i++) {
+    acc0 = op0.reduce(acc0, in[i]);
+    acc1 = op1.reduce(acc1, in[i]);
+  }
+  auto out0 = (scalar_t*)data[0];
+  auto out1 = (scalar_t*)data[1];
+  *out0 = op0.combine(*out0, acc0);
+  *out1 = op1.combine(*out1, acc1);
+}
+
+template <typename ops0_t, typename ops1_t>
+static inline void fused_outer_reduction(char** data, int64_t inner_stride, int64_t size0, int64_t size1, const ops0_t& op0, const ops1_t& op1) {
+  using scalar_t = typename ops0_t::scalar_t;
+  using Vec = Vec256<scalar_t>;
+  constexpr int64_t kStep = 4 * Vec::size();
+  auto out0 = (scalar_t*)data[0];
+  auto out1 = (scalar_t*)data[1];
+  const char* in = data[2];
+
+  // reduce down each column of 4 * Vec::size() elements (128 bytes)
+  int64_t j = 0;
+  for (; j + kStep <= size1; j += kStep) {
+    Vec vacc0[4], vacc1[4];
+    for (int k = 0; k < 4; k++) {
+      vacc0[k] = Vec(op0.identity());
+      vacc1[k] = Vec(op1.identity());
+    }
+    for (int64_t i = 0; i < size0; i++) {
+      auto row = (const scalar_t*)(in + i * inner_stride) + j;
+      for (int k = 0; k < 4; k++) {
+        Vec x = Vec::loadu(row + k * Vec::size());
+        vacc0[k] = op0.reduce(vacc0[k], x);
+        vacc1[k] = op1.reduce(vacc1[k], x);
+      }
+    }
+    for (int k = 0; k < 4; k++) {
+      scalar_t* dst0 = out0 + j + k * Vec::size();
+      scalar_t* dst1 = out1 + j + k * Vec::size();
+      op0.combine(Vec::loadu(dst0), vacc0[k]).store(dst0);
+      op1.combine(Vec::loadu(dst1), vacc1[k]).store(dst1);
+    }
+  }
+
+  // reduce down the remaining columns
+  for (; j < size1; j++) {
+    scalar_t acc0 = op0.identity();
+    scalar_t acc1 = op1.identity();
+    for (int64_t i = 0; i < size0; i++) {
+      scalar_t x = ((const scalar_t*)(in + i * inner_stride))[j];
+      acc0 = op0.reduce(acc0, x);
+      acc1 = op1.reduce(acc1, x);
+    }
+    out0[j] = op0.combine(out0[j], acc0);
+    out1[j] = op1.combine(out1[j], acc1);
+  }
+}
+
+template <typename ops0_t, typename ops1_t>
+void binary_kernel_reduce_vec(TensorIterator& iter, std::tuple<ops0_t, ops1_t> ops) {
+  using scalar_t = typename ops0_t::scalar_t;
+  static_assert(
+    std::is_same<scalar_t, typename ops1_t::scalar_t>::value,
+    "all types must match");
+  AT_ASSERT(iter.ninputs() == 1 && iter.noutputs() == 2);
+  const ops0_t& op0 = std::get<0>(ops);
+  const ops1_t& op1 = std::get<1>(ops);
+  constexpr int64_t size = sizeof(scalar_t);
+
+  iter.output(0).fill_(op0.identity());
+  iter.output(1).fill_(op1.identity());
+  // strides are laid out as {out0, out1, in} for dim 0, then for dim 1
+  auto loop = [&](int ntensor, char** data, const int64_t* strides, int64_t size0, int64_t size1) {
+    char* ptrs[3] = { data[0], data[1], data[2] };
+    if (strides[0] == 0 && strides[1] == 0 && strides[2] == size) {
+      // input is contiguous in dim 0, outputs are reduced in dim 0
+      for (int64_t j = 0; j < size1; j++) {
+        fused_inner_reduction(ptrs, size0, op0, op1);
+        for (int arg = 0; arg < 3; arg++) {
+          ptrs[arg] += strides[3 + arg];
+        }
+      }
+    } else if (strides[0] == 0 && strides[1] == 0 &&
+               strides[3] == size && strides[4] == size && strides[5] == size) {
+      // input and outputs are contiguous in dim 1
+      fused_outer_reduction(ptrs, strides[2], size0, size1, op0, op1);
+    } else {
+      for (int64_t j = 0; j < size1; j++) {
+        for (int64_t i = 0; i < size0; i++) {
+          scalar_t x = *(scalar_t*)(ptrs[2] + i * strides[2]);
+          auto out0 = (scalar_t*)(ptrs[0] + i * strides[0]);
+          auto out1 = (scalar_t*)(ptrs[1] + i * strides[1]);
+          *out0 = op0.reduce(*out0, x);
+          *out1 = op1.reduce(*out1, x);
+        }
+        for (int arg = 0; arg < 3; arg++) {
+          ptrs[arg] += strides[3 + arg];
+        }
+      }
+    }
+  };
+
+  int64_t numel = iter.numel();
+  if (iter.output(0).numel() != 1 || numel < at::internal::GRAIN_SIZE ||
+      at::get_num_threads() == 1 || at::in_parallel_region()) {
+    iter.parallel_reduce(loop);
+    return;
+  }
+
+  // Full reduction: TensorIterator's two-pass reduction only handles a single
+  // output, so reduce into per-thread slices here and combine them with the
+  // ops' own combine functions.
+  int max_threads = at::get_num_threads();
+  auto buffer_shape = DimVector(iter.output(0).sizes());
+  buffer_shape.insert(buffer_shape.begin(), max_threads);
+  Tensor buffer0 = at::empty(buffer_shape, iter.output(0).options()).fill_(op0.identity());
+  Tensor buffer1 = at::empty(buffer_shape, iter.output(1).options()).fill_(op1.identity());
+  at::parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int thread_num = at::get_thread_num();
+    auto slice0 = buffer0[thread_num];
+    auto slice1 = buffer1[thread_num];
+    auto sub_iter = TensorIterator::reduce_op(slice0, slice1, iter.input(0));
+    sub_iter->serial_for_each(loop, {begin, end});
+  });
+  auto out0 = (scalar_t*)iter.data_ptr(0);
+  auto out1 = (scalar_t*)iter.data_ptr(1);
+  auto partial0 = buffer0.data<scalar_t>();
+  auto partial1 = buffer1.data<scalar_t>();
+  for (int i = 0; i < max_threads; i++) {
+    *out0 = op0.combine(*out0, partial0[i]);
+    *out1 = op1.combine(*out1, partial1[i]);
+  }
+}
+
 }}}  // namespace at::native::<anonymous>
@@ -1,6 +1,7 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <limits>
 
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/vec256.h>
@@ -14,7 +15,28 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
+// BFloat16 has only 8 bits of mantissa, so summing in it loses everything
+// once the partial sum is a few hundred times the size of the elements. The
+// elements are accumulated in float instead and rounded once at the end.
+struct BFloat16SumOps {
+  inline float reduce(float acc, BFloat16 data) const {
+    return acc + static_cast<float>(data);
+  }
+
+  inline float combine(float a, float b) const {
+    return a + b;
+  }
+
+  inline BFloat16 project(float acc) const {
+    return static_cast<BFloat16>(acc);
+  }
+};
+
 static void sum_kernel_impl(TensorIterator& iter) {
+  if (iter.dtype() == kBFloat16) {
+    binary_kernel_reduce(iter, BFloat16SumOps(), 0.f);
+    return;
+  }
   AT_DISPATCH_ALL_TYPES(iter.dtype(), "sum_cpu", [&] {
     binary_kernel_reduce_vec(
       iter,
@@ -166,6 +188,45 @@ static void max_values_kernel_impl(TensorIterator& iter) {
   });
 }
 
+template <typename scalar_t>
+static inline scalar_t upper_bound() {
+  using lim = std::numeric_limits<scalar_t>;
+  return lim::has_infinity ? lim::infinity() : lim::max();
+}
+
+template <typename scalar_t>
+static inline scalar_t lower_bound() {
+  using lim = std::numeric_limits<scalar_t>;
+  return lim::has_infinity ? -lim::infinity() : lim::lowest();
+}
+
+template <typename scalar_t_>
+struct MinVecOps {
+  using scalar_t = scalar_t_;
+  scalar_t identity() const { return upper_bound<scalar_t>(); }
+  scalar_t reduce(scalar_t a, scalar_t b) const { return std::min(a, b); }
+  Vec256<scalar_t> reduce(Vec256<scalar_t> a, Vec256<scalar_t> b) const { return minimum(a, b); }
+  scalar_t combine(scalar_t a, scalar_t b) const { return reduce(a, b); }
+  Vec256<scalar_t> combine(Vec256<scalar_t> a, Vec256<scalar_t> b) const { return reduce(a, b); }
+};
+
+template <typename scalar_t_>
+struct MaxVecOps {
+  using scalar_t = scalar_t_;
+  scalar_t identity() const { return lower_bound<scalar_t>(); }
+  scalar_t reduce(scalar_t a, scalar_t b) const { return std::max(a, b); }
+  Vec256<scalar_t> reduce(Vec256<scalar_t> a, Vec256<scalar_t> b) const { return maximum(a, b); }
+  scalar_t combine(scalar_t a, scalar_t b) const { return reduce(a, b); }
+  Vec256<scalar_t> combine(Vec256<scalar_t> a, Vec256<scalar_t> b) const { return reduce(a, b); }
+};
+
+static void min_max_values_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "min_max_values_cpu", [&iter] {
+    binary_kernel_reduce_vec(
+      iter, std::make_tuple(MinVecOps<scalar_t>(), MaxVecOps<scalar_t>()));
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(sum_stub, &sum_kernel_impl);
@@ -177,5 +238,6 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(min_max_values_stub, &min_max_values_kernel_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,170 @@
+// The CPU kernel of _resize_crop_normalize, see ResizeCropNormalize.h.
+//
+// Bilinear interpolation is separable, so every output row is the blend of two
+// horizontally interpolated source rows. The horizontal pass gathers the uint8
+// pixels into a float row laid out as the output row is (channel planes for
+// NCHW, interleaved channels for NHWC); the vertical pass then blends the two
+// rows and normalizes with plain vector loads and stores. Consecutive output
+// rows mostly share their source rows, so each task keeps the last two
+// horizontally interpolated rows around. The order of the arithmetic is the one
+// of upsample_bilinear2d, so before normalization the results agree exactly.
+
+#include <ATen/native/ResizeCropNormalize.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/UpSample.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// out[i] = (l0 * r0[i] + l1 * r1[i] - mean[i]) / stddev[i]
+static inline void blend_normalize_row(
+    float* out,
+    const float* r0,
+    const float* r1,
+    const float* mean,
+    const float* stddev,
+    float l0,
+    float l1,
+    int64_t len) {
+  using Vec = Vec256<float>;
+  const Vec l0_vec(l0);
+  const Vec l1_vec(l1);
+  int64_t i = 0;
+  for (; i + Vec::size() <= len; i += Vec::size()) {
+    Vec val = l0_vec * Vec::loadu(r0 + i) + l1_vec * Vec::loadu(r1 + i);
+    ((val - Vec::loadu(mean + i)) / Vec::loadu(stddev + i)).store(out + i);
+  }
+  for (; i < len; i++) {
+    out[i] = (l0 * r0[i] + l1 * r1[i] - mean[i]) / stddev[i];
+  }
+}
+
+void resize_crop_normalize_kernel(
+    Tensor& output,
+    const Tensor& input,
+    int64_t resized_height,
+    int64_t resized_width,
+    int64_t crop_top,
+    int64_t crop_left,
+    const Tensor& mean,
+    const Tensor& stddev,
+    bool align_corners,
+    bool channels_last) {
+  const int64_t nbatch = input.size(0);
+  const int64_t input_height = input.size(1);
+  const int64_t input_width = input.size(2);
+  const int64_t channels = input.size(3);
+  const int64_t output_height = output.size(channels_last ? 1 : 2);
+  const int64_t output_width = output.size(channels_last ? 2 : 3);
+  const int64_t row_len = output_width * channels;
+
+  const float rheight = area_pixel_compute_scale<float>(
+      input_height, resized_height, align_corners);
+  const float rwidth = area_pixel_compute_scale<float>(
+      input_width, resized_width, align_corners);
+
+  // The source columns and weights of every output column, and mean and std
+  // spread out in the layout of an output row.
+  std::vector<int64_t> col0(output_width), col1(output_width);
+  std::vector<float> col0_lambda(output_width), col1_lambda(output_width);
+  for (int64_t x = 0; x < output_width; x++) {
+    const float w1r = area_pixel_compute_source_index<float>(
+        rwidth, x + crop_left, align_corners, /*cubic=*/false);
+    const int64_t w1 = w1r;
+    const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
+    col0[x] = w1 * channels;
+    col1[x] = (w1 + w1p) * channels;
+    col1_lambda[x] = w1r - w1;
+    col0_lambda[x] = 1.f - col1_lambda[x];
+  }
+  const float* mean_data = mean.data<float>();
+  const float* stddev_data = stddev.data<float>();
+  std::vector<float> mean_row(row_len), stddev_row(row_len);
+  for (int64_t x = 0; x < output_width; x++) {
+    for (int64_t c = 0; c < channels; c++) {
+      const int64_t i = channels_last ? x * channels + c : c * output_width + x;
+      mean_row[i] = mean_data[c];
+      stddev_row[i] = stddev_data[c];
+    }
+  }
+
+  const uint8_t* input_data = input.data<uint8_t>();
+  float* output_data = output.data<float>();
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / (4 * row_len));
+
+  at::parallel_for(0, nbatch * output_height, grain_size, [&](int64_t start, int64_t end) {
+    std::vector<float> rows(2 * row_len);
+    // The (batch item, source row) held by each of the two rows, -1 if none.
+    int64_t cached[2] = {-1, -1};
+
+    // Returns the horizontally interpolated source row `key`, computing it if
+    // it is not cached into the buffer that does not hold the row `other`.
+    auto source_row = [&](int64_t key, int64_t other) -> const float* {
+      for (int b = 0; b < 2; b++) {
+        if (cached[b] == key) {
+          return &rows[b * row_len];
+        }
+      }
+      const int b = (cached[0] == other) ? 1 : 0;
+      const uint8_t* src = input_data + key * input_width * channels;
+      float* dst = &rows[b * row_len];
+      for (int64_t x = 0; x < output_width; x++) {
+        const uint8_t* p0 = src + col0[x];
+        const uint8_t* p1 = src + col1[x];
+        const float l0 = col0_lambda[x];
+        const float l1 = col1_lambda[x];
+        for (int64_t c = 0; c < channels; c++) {
+          const int64_t i = channels_last ? x * channels + c : c * output_width + x;
+          dst[i] = l0 * p0[c] + l1 * p1[c];
+        }
+      }
+      cached[b] = key;
+      return dst;
+    };
+
+    for (int64_t row = start; row < end; row++) {
+      const int64_t n = row / output_height;
+      const int64_t y = row % output_height;
+      const float h1r = area_pixel_compute_source_index<float>(
+          rheight, y + crop_top, align_corners, /*cubic=*/false);
+      const int64_t h1 = h1r;
+      const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
+      const float h1lambda = h1r - h1;
+      const float h0lambda = 1.f - h1lambda;
+
+      const int64_t key0 = n * input_height + h1;
+      const int64_t key1 = key0 + h1p;
+      const float* r0 = source_row(key0, key1);
+      const float* r1 = source_row(key1, key0);
+
+      if (channels_last) {
+        float* out = output_data + row * row_len;
+        blend_normalize_row(
+            out, r0, r1, mean_row.data(), stddev_row.data(), h0lambda, h1lambda, row_len);
+      } else {
+        for (int64_t c = 0; c < channels; c++) {
+          const int64_t offset = c * output_width;
+          float* out = output_data +
+              ((n * channels + c) * output_height + y) * output_width;
+          blend_normalize_row(
+              out, r0 + offset, r1 + offset, mean_row.data() + offset,
+              stddev_row.data() + offset, h0lambda, h1lambda, output_width);
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(resize_crop_normalize_stub, &resize_crop_normalize_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,188 @@
+#include <ATen/native/Indexing.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/TensorIterator.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace at { namespace native {
+namespace {
+
+// Views `t` with the sizes of `index`, but for size 1 at `dim`, so that
+// iterating over the view visits the first element of each row of `index`
+// along `dim`.
+Tensor restride_dim(const Tensor& t, int64_t dim, IntArrayRef index_sizes) {
+  auto sizes = index_sizes.vec();
+  sizes[dim] = 1;
+  return t.as_strided(sizes, t.strides());
+}
+
+// Runs `loop` on the rows of `index` along `dim` in parallel. The operands of
+// the loop are the rows of `output`, of each of `inputs` and of `index`, in
+// that order.
+void parallel_rows(
+    const Tensor& output,
+    TensorList inputs,
+    int64_t dim,
+    const Tensor& index,
+    const TensorIterator::loop_t& loop) {
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(restride_dim(output, dim, index.sizes()));
+  for (const auto& input : inputs) {
+    builder.add_input(restride_dim(input, dim, index.sizes()));
+  }
+  builder.add_input(restride_dim(index, dim, index.sizes()));
+  auto iter = builder.build();
+  const int64_t elems_per_row = std::max<int64_t>(index.size(dim), 1);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / elems_per_row, 1);
+  parallel_for(0, iter->numel(), grain_size, [&](int64_t begin, int64_t end) {
+    iter->serial_for_each(loop, {begin, end});
+  });
+}
+
+// Calls `f(i, j)` on the elements j of the `n` rows i of a loop. Rows that are
+// contiguous are walked along and the others across, so that consecutive calls
+// read neighbouring elements of the index either way.
+template <typename func_t>
+void visit_rows(int64_t n, int64_t elems_per_row, bool contiguous_rows, const func_t& f) {
+  if (contiguous_rows) {
+    for (int64_t i = 0; i < n; i++) {
+      for (int64_t j = 0; j < elems_per_row; j++) {
+        f(i, j);
+      }
+    }
+  } else {
+    for (int64_t j = 0; j < elems_per_row; j++) {
+      for (int64_t i = 0; i < n; i++) {
+        f(i, j);
+      }
+    }
+  }
+}
+
+// Calls `f(output_element, input_element)` on the pairs of elements gather and
+// scatter copy between. `index` indexes `output` along `dim` when
+// `is_scatter_like`, and `input` otherwise.
+template <bool is_scatter_like, typename scalar_t, typename func_t>
+void cpu_scatter_gather_kernel(
+    const Tensor& output,
+    const Tensor& input,
+    int64_t dim,
+    const Tensor& index,
+    const char* method_name,
+    const func_t& f) {
+  const int64_t elems_per_row = index.size(dim);
+  const int64_t indexed_size = is_scatter_like ? output.size(dim) : input.size(dim);
+  const int64_t output_dim_stride = output.stride(dim);
+  const int64_t input_dim_stride = input.stride(dim);
+  const int64_t index_dim_stride = index.stride(dim);
+  parallel_rows(output, {input}, dim, index, [&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+    visit_rows(n, elems_per_row, index_dim_stride == 1, [&](int64_t i, int64_t j) {
+      auto output_row = (scalar_t*)(data[0] + i * strides[0]);
+      auto input_row = (scalar_t*)(data[1] + i * strides[1]);
+      int64_t idx = ((int64_t*)(data[2] + i * strides[2]))[j * index_dim_stride];
+      TORCH_CHECK(idx >= 0 && idx < indexed_size, "Invalid index in ", method_name);
+      if (is_scatter_like) {
+        f(output_row + idx * output_dim_stride, input_row + j * input_dim_stride);
+      } else {
+        f(output_row + j * output_dim_stride, input_row + idx * input_dim_stride);
+      }
+    });
+  });
+}
+
+void gather_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "gather_cpu", [&] {
+    cpu_scatter_gather_kernel</*is_scatter_like=*/false, scalar_t>(
+        result, self, dim, index, "gather", [](scalar_t* dst, const scalar_t* src) {
+      *dst = *src;
+    });
+  });
+}
+
+void scatter_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_cpu_", [&] {
+    cpu_scatter_gather_kernel</*is_scatter_like=*/true, scalar_t>(
+        self, src, dim, index, "scatter", [](scalar_t* dst, const scalar_t* src) {
+      *dst = *src;
+    });
+  });
+}
+
+void scatter_add_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_add_cpu_", [&] {
+    cpu_scatter_gather_kernel</*is_scatter_like=*/true, scalar_t>(
+        self, src, dim, index, "scatterAdd", [](scalar_t* dst, const scalar_t* src) {
+      *dst += *src;
+    });
+  });
+}
+
+void scatter_fill_kernel(Tensor& self, int64_t dim, const Tensor& index, Scalar value) {
+  const int64_t elems_per_row = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  const int64_t index_dim_stride = index.stride(dim);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_fill_cpu_", [&] {
+    const scalar_t fill_value = value.to<scalar_t>();
+    parallel_rows(self, {}, dim, index, [&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      visit_rows(n, elems_per_row, index_dim_stride == 1, [&](int64_t i, int64_t j) {
+        auto self_row = (scalar_t*)(data[0] + i * strides[0]);
+        int64_t idx = ((int64_t*)(data[1] + i * strides[1]))[j * index_dim_stride];
+        TORCH_CHECK(idx >= 0 && idx < self_dim_size, "Invalid index in scatter");
+        self_row[idx * self_dim_stride] = fill_value;
+      });
+    });
+  });
+}
+
+// `self` and `result` are contiguous and `index` is a contiguous long tensor
+// of at most one dimension. Viewed as [outer, size, inner] tensors, with
+// index.numel() for the size of `result`, the slices [o, i, :] of `result` are
+// copied from the slices [o, index[i], :] of `self` in parallel.
+void index_select_kernel(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  const int64_t numel = index.numel();
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t* index_data = index.data<int64_t>();
+  for (int64_t i = 0; i < numel; i++) {
+    TORCH_CHECK(index_data[i] >= 0 && index_data[i] < self_dim_size, "index out of range");
+  }
+  if (result.numel() == 0) {
+    return;
+  }
+  int64_t outer = 1;
+  for (int64_t d = 0; d < dim; d++) {
+    outer *= self.size(d);
+  }
+  const int64_t inner = result.numel() / (outer * numel);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "index_select_cpu", [&] {
+    const scalar_t* self_data = self.data<scalar_t>();
+    scalar_t* result_data = result.data<scalar_t>();
+    parallel_for(0, outer * numel, std::max<int64_t>(internal::GRAIN_SIZE / inner, 1), [&](int64_t begin, int64_t end) {
+      for (int64_t k = begin; k < end; k++) {
+        const scalar_t* src = self_data + ((k / numel) * self_dim_size + index_data[k % numel]) * inner;
+        scalar_t* dst = result_data + k * inner;
+        if (inner == 1) {
+          *dst = *src;
+        } else {
+          std::memcpy(dst, src, inner * sizeof(scalar_t));
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(gather_stub, &gather_kernel);
+REGISTER_DISPATCH(scatter_stub, &scatter_kernel);
+REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_kernel);
+REGISTER_DISPATCH(scatter_add_stub, &scatter_add_kernel);
+REGISTER_DISPATCH(index_select_stub, &index_select_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,73 @@
+#include <ATen/native/SummaryOps.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <vector>
+
+namespace at { namespace native { namespace {
+
+// The bin of x is (x - min) / (max - min) * nbins, computed in scalar_t like
+// the CUDA kernel, with the last bin closed at max. Elements outside of
+// [min, max], and NaNs, are not counted.
+template <typename scalar_t>
+static void histc_count(
+    int64_t* hist,
+    const scalar_t* data,
+    int64_t begin,
+    int64_t end,
+    int64_t nbins,
+    scalar_t minvalue,
+    scalar_t maxvalue) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const scalar_t range = maxvalue - minvalue;
+  const Vec vmin(minvalue);
+  const Vec vmax(maxvalue);
+  const Vec vrange(range);
+  const Vec vnbins(static_cast<scalar_t>(nbins));
+  const Vec vlast(static_cast<scalar_t>(nbins - 1));
+  const Vec vnone(static_cast<scalar_t>(-1));
+  scalar_t bins[Vec::size()];
+  int64_t i = begin;
+  for (; i + Vec::size() <= end; i += Vec::size()) {
+    const Vec x = Vec::loadu(data + i);
+    const Vec bin = vec256::minimum(((x - vmin) / vrange * vnbins).floor(), vlast);
+    Vec::blendv(vnone, bin, (x >= vmin) & (x <= vmax)).store(bins);
+    for (int64_t j = 0; j < Vec::size(); ++j) {
+      if (bins[j] >= 0) {
+        hist[static_cast<int64_t>(bins[j])] += 1;
+      }
+    }
+  }
+  for (; i < end; ++i) {
+    const scalar_t x = data[i];
+    if (x >= minvalue && x <= maxvalue) {
+      const int64_t bin = static_cast<int64_t>((x - minvalue) / range * nbins);
+      hist[std::min(bin, nbins - 1)] += 1;
+    }
+  }
+}
+
+static void histc_kernel(Tensor& hist, const Tensor& self, int64_t nbins, Scalar min, Scalar max) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "histc_cpu", [&] {
+    const scalar_t minvalue = min.to<scalar_t>();
+    const scalar_t maxvalue = max.to<scalar_t>();
+    const scalar_t* data = self.data<scalar_t>();
+    // counts are kept exact past 2^24 elements per bin for float histograms
+    std::vector<int64_t> counts(nbins);
+    parallel_histogram(
+        counts.data(), nbins, self.numel(), [&](int64_t* local_hist, int64_t begin, int64_t end) {
+          histc_count<scalar_t>(local_hist, data, begin, end, nbins, minvalue, maxvalue);
+        });
+    scalar_t* hist_data = hist.data<scalar_t>();
+    for (int64_t bin = 0; bin < nbins; ++bin) {
+      hist_data[bin] = static_cast<scalar_t>(counts[bin]);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(histc_stub, &histc_kernel);
+
+}} // namespace at::native
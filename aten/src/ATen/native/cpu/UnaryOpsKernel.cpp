@@ -35,13 +35,7 @@ static void sigmoid_kernel(TensorIterator& iter) {
     unary_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return (1 / (1 + std::exp((-a)))); },
-        [=](Vec256<scalar_t> a) {
-          a = Vec256<scalar_t>((scalar_t)(0)) - a;
-          a = a.exp();
-          a = Vec256<scalar_t>((scalar_t)(1)) + a;
-          a = a.reciprocal();
-          return a;
-        });
+        [=](Vec256<scalar_t> a) { return a.sigmoid(); });
   });
 }
 
@@ -357,6 +357,14 @@ static_assert(CUFFT_DEFAULT_CACHE_SIZE >= 0 && CUFFT_DEFAULT_CACHE_SIZE <= CUFFT
 // value returned from try_emplace_value.
 // The contract of using this cache is that try_emplace_value should only be
 // used when the max_size is positive.
+//
+// Besides the number of plans, the cache can bound the sum of the workspace
+// sizes of its plans (max_workspace_size, -1 for no bound): the least recently
+// used plans are evicted until the sum fits, but the plan just looked up is
+// always kept. The workspaces themselves are allocated from the caching
+// allocator for each execution, so they are shared by all the plans of a
+// device; the bound limits the workspace an execution may need. The cache also
+// counts the lookups that hit and missed since the program started.
 class CuFFTParamsLRUCache {
 public:
   using kv_t = typename std::pair<CuFFTParams, CuFFTConfig>;
@@ -376,12 +384,20 @@ public:
   CuFFTParamsLRUCache(CuFFTParamsLRUCache&& other) noexcept :
     _usage_list(std::move(other._usage_list)),
     _cache_map(std::move(other._cache_map)),
-    _max_size(other._max_size) {}
+    _max_size(other._max_size),
+    _workspace_size(other._workspace_size),
+    _max_workspace_size(other._max_workspace_size),
+    _hits(other._hits),
+    _misses(other._misses) {}
 
   CuFFTParamsLRUCache& operator=(CuFFTParamsLRUCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _workspace_size = other._workspace_size;
+    _max_workspace_size = other._max_workspace_size;
+    _hits = other._hits;
+    _misses = other._misses;
     return *this;
   }
 
@@ -397,17 +413,16 @@ public:
     map_kkv_iter_t map_it = _cache_map.find(key);
     // Hit, put to list front
     if (map_it != _cache_map.end()) {
+      _hits++;
       _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
       return map_it->second->second;
     }
 
     // Miss
+    _misses++;
     // remove if needed
     if (_usage_list.size() >= _max_size) {
-      auto last = _usage_list.end();
-      last--;
-      _cache_map.erase(last->first);
-      _usage_list.pop_back();
+      _pop_back();
     }
 
     // construct new plan at list front, then insert into _cache_map
@@ -418,31 +433,43 @@ public:
     _cache_map.emplace(std::piecewise_construct,
                 std::forward_as_tuple(kv_it->first),
                 std::forward_as_tuple(kv_it));
+    _workspace_size += kv_it->second.workspace_size();
+    _trim_workspace(/* keep */ 1);
     return kv_it->second;
   }
 
   void clear() {
     _cache_map.clear();
     _usage_list.clear();
+    _workspace_size = 0;
   }
 
   void resize(int64_t new_size) {
     _set_max_size(new_size);
-    auto cur_size = _usage_list.size();
-    if (cur_size > _max_size) {
-      auto delete_it = _usage_list.end();
-      for (size_t i = 0; i < cur_size - _max_size; i++) {
-        delete_it--;
-        _cache_map.erase(delete_it->first);
-      }
-      _usage_list.erase(delete_it, _usage_list.end());
+    while (_usage_list.size() > _max_size) {
+      _pop_back();
     }
   }
 
+  void set_max_workspace_size(int64_t new_size) {
+    TORCH_CHECK(new_size >= -1,
+             "cuFFT plan cache max workspace size must be non-negative or -1, but got ", new_size);
+    _max_workspace_size = new_size;
+    _trim_workspace(/* keep */ 0);
+  }
+
   size_t size() const { return _cache_map.size(); }
 
   size_t max_size() const noexcept { return _max_size; }
 
+  int64_t workspace_size() const noexcept { return _workspace_size; }
+
+  int64_t max_workspace_size() const noexcept { return _max_workspace_size; }
+
+  int64_t hits() const noexcept { return _hits; }
+
+  int64_t misses() const noexcept { return _misses; }
+
   std::mutex mutex;
 
 private:
@@ -458,9 +485,33 @@ private:
     _max_size = static_cast<size_t>(new_size);
   }
 
+  // Removes the least recently used plan
+  void _pop_back() {
+    auto last = _usage_list.end();
+    last--;
+    _workspace_size -= last->second.workspace_size();
+    _cache_map.erase(last->first);
+    _usage_list.pop_back();
+  }
+
+  // Removes the least recently used plans, but the `keep` most recently used
+  // ones, until the workspaces of the plans fit in _max_workspace_size
+  void _trim_workspace(size_t keep) {
+    if (_max_workspace_size < 0) {
+      return;
+    }
+    while (_workspace_size > _max_workspace_size && _usage_list.size() > keep) {
+      _pop_back();
+    }
+  }
+
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  int64_t _workspace_size = 0;
+  int64_t _max_workspace_size = -1;
+  int64_t _hits = 0;
+  int64_t _misses = 0;
 };
 
 // Since ATen is separated into CPU build and CUDA build, we need a way to call
@@ -468,10 +519,19 @@ private:
 // (at cuda/detail/CUDAHooks.cpp), and call the hooked functions from the actual
 // native function counterparts (at native/SpectralOps.cpp), i.e.,
 // _cufft_get_plan_cache_max_size, _cufft_set_plan_cache_max_size
-// _cufft_get_plan_cache_size, and _cufft_clear_plan_cache.
+// _cufft_get_plan_cache_size, _cufft_clear_plan_cache,
+// _cufft_get_plan_cache_max_workspace_size,
+// _cufft_set_plan_cache_max_workspace_size,
+// _cufft_get_plan_cache_workspace_size, _cufft_get_plan_cache_hits and
+// _cufft_get_plan_cache_misses.
 int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_max_workspace_size_impl(int64_t device_index);
+void cufft_set_plan_cache_max_workspace_size_impl(int64_t device_index, int64_t max_workspace_size);
+int64_t cufft_get_plan_cache_workspace_size_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_hits_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_misses_impl(int64_t device_index);
 
 }}} // namespace at::native::detail
@@ -0,0 +1,208 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAApplyUtils.cuh>
+
+namespace at {
+namespace native {
+namespace {
+
+// The THCUNN depthwise kernel uses one thread per output element and reads
+// kSize * kSize input elements from global memory for each of them, which
+// leaves it far from the bandwidth limit for the small feature maps and
+// batches of MobileNet-style inference. Here a block computes a
+// blockDim.y x blockDim.x tile of one output plane: it first stages the
+// input window of the tile and the plane's filter in shared memory, so
+// every input element is read from global memory about once.
+constexpr int kTileHeight = 8;
+
+inline int tile_width(int64_t output_width) {
+  // narrow tiles for small feature maps, so that fewer threads idle
+  return output_width > 16 ? 32 : (output_width > 8 ? 16 : 8);
+}
+
+template <int kSize, int kStride>
+inline int64_t shared_memory_elements(int tile_w) {
+  const int window_h = (kTileHeight - 1) * kStride + kSize;
+  const int window_w = (tile_w - 1) * kStride + kSize;
+  return window_h * window_w + kSize * kSize;
+}
+
+template <typename scalar_t, typename accscalar_t, int kSize, int kStride>
+C10_LAUNCH_BOUNDS_1(256)
+__global__ void depthwise_conv2d_tiled_kernel(
+    const scalar_t* __restrict__ input,
+    const scalar_t* __restrict__ weight,
+    const scalar_t* __restrict__ bias,
+    scalar_t* __restrict__ output,
+    const int channels,
+    const int input_height,
+    const int input_width,
+    const int output_height,
+    const int output_width,
+    const int pad_height,
+    const int pad_width) {
+  extern __shared__ unsigned char smem[];
+  accscalar_t* window = reinterpret_cast<accscalar_t*>(smem);
+
+  const int window_h = (blockDim.y - 1) * kStride + kSize;
+  const int window_w = (blockDim.x - 1) * kStride + kSize;
+  accscalar_t* filter = window + window_h * window_w;
+
+  // blockIdx.x is the (sample, channel) plane, y and z the tile in it
+  const int64_t plane = blockIdx.x;
+  const int c = plane % channels;
+  const int oy0 = blockIdx.y * blockDim.y;
+  const int ox0 = blockIdx.z * blockDim.x;
+  const int iy0 = oy0 * kStride - pad_height;
+  const int ix0 = ox0 * kStride - pad_width;
+
+  const scalar_t* input_plane = input + plane * input_height * input_width;
+  const int tid = threadIdx.y * blockDim.x + threadIdx.x;
+  const int num_threads = blockDim.x * blockDim.y;
+
+  for (int i = tid; i < window_h * window_w; i += num_threads) {
+    const int iy = iy0 + i / window_w;
+    const int ix = ix0 + i % window_w;
+    window[i] = (iy >= 0 && iy < input_height && ix >= 0 && ix < input_width)
+        ? static_cast<accscalar_t>(input_plane[iy * input_width + ix])
+        : accscalar_t(0);
+  }
+  for (int i = tid; i < kSize * kSize; i += num_threads) {
+    filter[i] = static_cast<accscalar_t>(weight[c * kSize * kSize + i]);
+  }
+  __syncthreads();
+
+  const int oy = oy0 + threadIdx.y;
+  const int ox = ox0 + threadIdx.x;
+  if (oy >= output_height || ox >= output_width) {
+    return;
+  }
+
+  accscalar_t value = bias ? static_cast<accscalar_t>(bias[c]) : accscalar_t(0);
+  const accscalar_t* window_row =
+      window + threadIdx.y * kStride * window_w + threadIdx.x * kStride;
+#pragma unroll
+  for (int kh = 0; kh < kSize; kh++) {
+#pragma unroll
+    for (int kw = 0; kw < kSize; kw++) {
+      value += filter[kh * kSize + kw] * window_row[kw];
+    }
+    window_row += window_w;
+  }
+  output[(plane * output_height + oy) * output_width + ox] =
+      static_cast<scalar_t>(value);
+}
+
+template <typename scalar_t, int kSize, int kStride>
+void depthwise_conv2d_tiled_out(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding) {
+  using accscalar_t = acc_type<scalar_t, true>;
+  const int64_t planes = input.size(0) * input.size(1);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+
+  const dim3 block(tile_width(output_width), kTileHeight);
+  const dim3 grid(
+      planes,
+      cuda::ATenCeilDiv(output_height, static_cast<int64_t>(block.y)),
+      cuda::ATenCeilDiv(output_width, static_cast<int64_t>(block.x)));
+  const size_t shared_memory =
+      shared_memory_elements<kSize, kStride>(block.x) * sizeof(accscalar_t);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  depthwise_conv2d_tiled_kernel<scalar_t, accscalar_t, kSize, kStride>
+      <<<grid, block, shared_memory, stream>>>(
+          input.data<scalar_t>(),
+          weight.data<scalar_t>(),
+          bias.defined() ? bias.data<scalar_t>() : nullptr,
+          output.data<scalar_t>(),
+          input.size(1),
+          input.size(2),
+          input.size(3),
+          output_height,
+          output_width,
+          padding[0],
+          padding[1]);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // namespace
+
+// Forward of a depthwise 2D convolution with one filter per input channel,
+// 3x3 or 5x5 kernels and a stride of 1 or 2 in both dimensions, see
+// ConvParams::use_cuda_depthwise_tiled. The backward is the THCUNN one of
+// thnn_conv_depthwise2d.
+Tensor cuda_depthwise_convolution_tiled(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  TORCH_CHECK(self.dim() == 4 && weight.dim() == 4,
+      "_cuda_depthwise_convolution: expected 4D input and weight, but got ",
+      self.dim(), "D and ", weight.dim(), "D");
+  TORCH_CHECK(weight.size(0) == self.size(1) && weight.size(1) == 1,
+      "_cuda_depthwise_convolution: expected a weight of size [", self.size(1),
+      ", 1, k, k], but got ", weight.sizes());
+  TORCH_CHECK(kernel_size.size() == 2 && kernel_size[0] == kernel_size[1] &&
+      (kernel_size[0] == 3 || kernel_size[0] == 5) &&
+      weight.size(2) == kernel_size[0] && weight.size(3) == kernel_size[1],
+      "_cuda_depthwise_convolution: only 3x3 and 5x5 kernels are supported, but got ",
+      kernel_size);
+  TORCH_CHECK(stride.size() == 2 && stride[0] == stride[1] &&
+      (stride[0] == 1 || stride[0] == 2),
+      "_cuda_depthwise_convolution: only strides of 1 and 2 are supported, but got ",
+      stride);
+  TORCH_CHECK(dilation.size() == 2 && dilation[0] == 1 && dilation[1] == 1,
+      "_cuda_depthwise_convolution: dilation is not supported, but got ", dilation);
+  TORCH_CHECK(padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "_cuda_depthwise_convolution: expected a non-negative 2 element padding, but got ",
+      padding);
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == self.size(1)),
+      "_cuda_depthwise_convolution: expected a bias of ", self.size(1), " elements");
+  checkAllSameGPU("_cuda_depthwise_convolution",
+      {{self, "self", 1}, {weight, "weight", 2}});
+
+  auto input = self.contiguous();
+  auto weight_ = weight.contiguous();
+  auto bias_ = bias.defined() ? bias.contiguous() : bias;
+
+  const int64_t k = kernel_size[0];
+  const int64_t s = stride[0];
+  const int64_t output_height = (input.size(2) + 2 * padding[0] - k) / s + 1;
+  const int64_t output_width = (input.size(3) + 2 * padding[1] - k) / s + 1;
+  TORCH_CHECK(output_height > 0 && output_width > 0,
+      "_cuda_depthwise_convolution: the kernel of size ", kernel_size,
+      " is larger than the padded input of size ", input.sizes().slice(2));
+  auto output = at::empty(
+      {input.size(0), input.size(1), output_height, output_width}, input.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      input.scalar_type(), "_cuda_depthwise_convolution", [&] {
+        if (k == 3 && s == 1) {
+          depthwise_conv2d_tiled_out<scalar_t, 3, 1>(output, input, weight_, bias_, padding);
+        } else if (k == 3) {
+          depthwise_conv2d_tiled_out<scalar_t, 3, 2>(output, input, weight_, bias_, padding);
+        } else if (s == 1) {
+          depthwise_conv2d_tiled_out<scalar_t, 5, 1>(output, input, weight_, bias_, padding);
+        } else {
+          depthwise_conv2d_tiled_out<scalar_t, 5, 2>(output, input, weight_, bias_, padding);
+        }
+      });
+  return output;
+}
+
+} // namespace native
+} // namespace at
@@ -3,9 +3,11 @@
 #include <ATen/cuda/CUDAApplyUtils.cuh>
 #include <ATen/cuda/detail/IndexUtils.cuh>
 #include <ATen/cuda/detail/TensorInfo.cuh>
+#include <ATen/native/Dropout.h>
 #include <c10/macros/Macros.h>
 #include <curand_kernel.h>
 
+#include <THC/THCDeviceUtils.cuh>
 #include <THC/THCGeneral.h>
 #include <THC/THCTensorRandom.h>
 #include <THC/THCGenerator.hpp>
@@ -28,6 +30,27 @@ std::pair<uint64_t, uint64_t> next_philox_seed(at::Generator* gen, uint64_t incr
   return std::make_pair(gen_->state.initial_seed, offset);
 }
 
+// The ballot of a warp, stored as one word of the packed mask, see
+// Note [Packed dropout masks]. The lanes of a warp handle consecutive
+// elements, starting at a multiple of the warp size, and all of them must
+// reach the ballot.
+#if defined(__HIP_PLATFORM_HCC__)
+using MaskWord = unsigned long long int;
+#else
+using MaskWord = unsigned int;
+#endif
+constexpr int kMaskWordBits = sizeof(MaskWord) * 8;
+static_assert(kDropoutMaskWordBits % kMaskWordBits == 0,
+              "packed dropout masks must be allocated in whole warp ballots");
+
+template <typename IndexType>
+__device__ __forceinline__ void store_mask_bits(MaskWord* mask, IndexType li, IndexType totalElements, bool keep) {
+  const MaskWord bits = WARP_BALLOT(keep && li < totalElements);
+  if (li % kMaskWordBits == 0 && li < totalElements) {
+    mask[li / kMaskWordBits] = bits;
+  }
+}
+
 
 template <
           typename scalar_t,
@@ -42,7 +65,8 @@ C10_LAUNCH_BOUNDS_2(256, 4)
 __global__ void
 fused_dropout_kernel(cuda::detail::TensorInfo<scalar_t, IndexType> a,
                       cuda::detail::TensorInfo<scalar_t, IndexType> b,
-                      cuda::detail::TensorInfo<uint8_t, IndexType> c,
+                      const scalar_t* bias, IndexType bias_size, const scalar_t* residual,
+                      MaskWord* mask,
                       IndexType totalElements, accscalar_t p, std::pair<uint64_t, uint64_t> seeds
                       ) {
 
@@ -81,29 +105,71 @@ fused_dropout_kernel(cuda::detail::TensorInfo<scalar_t, IndexType> a,
     // Convert `linearIndex` into an offset of `b`
                const IndexType bOffset =
                    cuda::detail::IndexToOffset<scalar_t, IndexType, 1>::get(li, b);
-               b.data[bOffset] = src[ii]*(&rand.x)[ii]*pinv;
-               c.data[bOffset] = (uint8_t)(&rand.x)[ii];
+               accscalar_t value = src[ii];
+               if (bias) {
+                   value += bias[li % bias_size];
+               }
+               value = value*(&rand.x)[ii]*pinv;
+               if (residual) {
+                   value += residual[li];
+               }
+               b.data[bOffset] = value;
            }
+           store_mask_bits(mask, li, totalElements, (&rand.x)[ii] != 0);
        }
        __syncthreads();
   }
 }
 
-template<typename scalar_t, typename accscalar_t>
-void masked_scale_kernel(at::Tensor& ret, const at::Tensor src, const at::Tensor mask, accscalar_t scale){
-   at::cuda::CUDA_tensor_apply3<scalar_t, scalar_t, uint8_t>(ret, src, mask, [scale]__device__(scalar_t& ret_val, const scalar_t& src_val, const uint8_t mask_val){
-       ret_val = (float)mask_val * src_val * scale;
-  });
+template <typename scalar_t, typename accscalar_t>
+__global__ void masked_scale_kernel(const scalar_t* src, const uint8_t* mask, scalar_t* ret,
+                                    int64_t totalElements, accscalar_t scale) {
+  for (int64_t li = blockIdx.x * static_cast<int64_t>(blockDim.x) + threadIdx.x;
+       li < totalElements;
+       li += static_cast<int64_t>(blockDim.x) * gridDim.x) {
+    const accscalar_t keep = (mask[li >> 3] >> (li & 7)) & 1;
+    ret[li] = keep * static_cast<accscalar_t>(src[li]) * scale;
+  }
+}
+
+template <typename scalar_t, typename IndexType>
+void fused_dropout_launch(const Tensor& self, const Tensor& bias, const Tensor& residual,
+                          Tensor& ret, Tensor& mask, double p, Generator* gen,
+                          dim3 grid, dim3 dim_block, int64_t counter_offset) {
+  using accscalar_t = acc_type<scalar_t, true>;
+  accscalar_t pa = (accscalar_t)(p);
+  auto self_info = cuda::detail::getTensorInfo<scalar_t, IndexType>(self);
+  auto ret_info = cuda::detail::getTensorInfo<scalar_t, IndexType>(ret);
+  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+  const IndexType bias_size = bias.defined() ? bias.numel() : 1;
+  const scalar_t* residual_data = residual.defined() ? residual.data<scalar_t>() : nullptr;
+  MaskWord* mask_data = reinterpret_cast<MaskWord*>(mask.data<uint8_t>());
+  self_info.collapseDims();
+  ret_info.collapseDims(); //ret is collapsed to 1d contiguous tensor
+  switch (self_info.dims) {
+    case 1:
+        fused_dropout_kernel<scalar_t, accscalar_t, IndexType, 1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            self_info, ret_info, bias_data, bias_size, residual_data, mask_data, self.numel(), pa, next_philox_seed(gen,counter_offset));
+        break;
+    default:
+        fused_dropout_kernel<scalar_t, accscalar_t, IndexType, -1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+            self_info, ret_info, bias_data, bias_size, residual_data, mask_data, self.numel(), pa, next_philox_seed(gen,counter_offset));
+  }
 }
 } //anonymous namespace
 
+// p is the probability to keep an element, see Note [Packed dropout masks]
+// for the mask.
 std::tuple<Tensor,Tensor>
-fused_dropout_cuda(const Tensor& self, double p, Generator * gen){
+fused_bias_dropout_add_cuda(const Tensor& self, const Tensor& bias, const Tensor& residual, double p, Generator * gen){
+  check_fused_dropout_inputs("_fused_bias_dropout_add", self, bias, residual);
   Tensor ret = at::empty_like(self);
-  Tensor mask = at::empty(self.sizes(), self.options().dtype(kByte));
+  Tensor mask = packed_dropout_mask(self);
   const int64_t nelem = self.numel();
 //empty tensors should not get here, but just in case, avoid FPE
-  if (nelem==0) return std::tuple<Tensor,Tensor>(self, mask);
+  if (nelem==0) return std::tuple<Tensor,Tensor>(ret, mask);
+  auto bias_ = bias.defined() ? bias.contiguous() : bias;
+  auto residual_ = residual.defined() ? residual.contiguous() : residual;
   const int64_t block_size = 256;
   unsigned int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor/block_size;
   dim3 dim_block(block_size);
@@ -111,56 +177,41 @@ fused_dropout_cuda(const Tensor& self, double p, Generator * gen){
   grid.x = std::min((unsigned int)at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm, grid.x);
 //number of times random will be generated per thread, to offset philox counter in thc random state
   int64_t counter_offset = ((nelem - 1)/(block_size*grid.x*UNROLL)+1)*UNROLL;
-  if (cuda::detail::canUse32BitIndexMath(self)){
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "fused_dropout", [&] {
-      using accscalar_t = acc_type<scalar_t, true>;
-      accscalar_t pa = (accscalar_t)(p);
-      auto self_info = cuda::detail::getTensorInfo<scalar_t, unsigned int>(self);
-      auto ret_info = cuda::detail::getTensorInfo<scalar_t, unsigned int>(ret);
-      auto mask_info = cuda::detail::getTensorInfo<uint8_t, unsigned int>(mask);
-      self_info.collapseDims();
-      ret_info.collapseDims();
-      mask_info.collapseDims(); //ret and mask are collapsed to 1d contiguous tensor
-      switch (self_info.dims) {
-        case 1:
-            fused_dropout_kernel<scalar_t, accscalar_t, unsigned int, 1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(self_info, ret_info, mask_info, nelem, pa, next_philox_seed(gen,counter_offset));
-            break;
-        default:
-            fused_dropout_kernel<scalar_t, accscalar_t, unsigned int, -1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(self_info, ret_info, mask_info, nelem, pa, next_philox_seed(gen,counter_offset));
-      }
-   });
-  } else {
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(self.scalar_type(), "fused_dropout", [&] {
-      using accscalar_t = acc_type<scalar_t, true>;
-      accscalar_t pa = (accscalar_t)(p);
-      auto self_info = cuda::detail::getTensorInfo<scalar_t, uint64_t>(self);
-      auto ret_info = cuda::detail::getTensorInfo<scalar_t, uint64_t>(ret);
-      auto mask_info = cuda::detail::getTensorInfo<uint8_t, uint64_t>(mask);
-      self_info.collapseDims();
-      ret_info.collapseDims();
-      mask_info.collapseDims(); //ret and mask are collapsed to 1d contiguous tensor
-      switch (self_info.dims) {
-        case 1:
-            fused_dropout_kernel<scalar_t, accscalar_t, uint64_t, 1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(self_info, ret_info, mask_info, nelem, pa, next_philox_seed(gen,counter_offset));
-            break;
-        default:
-            fused_dropout_kernel<scalar_t, accscalar_t, uint64_t, -1><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(self_info, ret_info, mask_info, nelem, pa, next_philox_seed(gen,counter_offset));
-      }
-   });
-  }
+    if (cuda::detail::canUse32BitIndexMath(self)){
+      fused_dropout_launch<scalar_t, unsigned int>(self, bias_, residual_, ret, mask, p, gen, grid, dim_block, counter_offset);
+    } else {
+      fused_dropout_launch<scalar_t, uint64_t>(self, bias_, residual_, ret, mask, p, gen, grid, dim_block, counter_offset);
+    }
+  });
   THCudaCheck(cudaGetLastError());
   return std::tuple<Tensor,Tensor>(ret, mask);
 }
 
+std::tuple<Tensor,Tensor>
+fused_dropout_cuda(const Tensor& self, double p, Generator * gen){
+  return fused_bias_dropout_add_cuda(self, Tensor(), Tensor(), p, gen);
+}
+
 Tensor masked_scale_cuda(const Tensor& self, const Tensor& mask, double scale){
-   Tensor ret = at::empty_like(self);
-   TORCH_CHECK(mask.scalar_type() == at::ScalarType::Byte, "mask should be torch.uint8 dtype");
+   check_packed_dropout_mask(self, mask);
+   Tensor src = self.contiguous();
+   Tensor ret = at::empty_like(src);
+   const int64_t nelem = src.numel();
+   if (nelem == 0) return ret;
+   const int64_t block_size = 256;
+   unsigned int blocks_per_sm = at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor/block_size;
+   dim3 dim_block(block_size);
+   dim3 grid(std::min<int64_t>((nelem + block_size - 1)/block_size,
+       at::cuda::getCurrentDeviceProperties()->multiProcessorCount * blocks_per_sm));
    AT_DISPATCH_FLOATING_TYPES_AND_HALF(ret.scalar_type(), "masked_scale", [&] {
       using accscalar_t = acc_type<scalar_t, true>;
       accscalar_t pa = (accscalar_t)(scale);
-    masked_scale_kernel<scalar_t>(ret, self, mask, pa);
-  });
-  return ret;
+      masked_scale_kernel<scalar_t, accscalar_t><<<grid, dim_block, 0, at::cuda::getCurrentCUDAStream()>>>(
+          src.data<scalar_t>(), mask.data<uint8_t>(), ret.data<scalar_t>(), nelem, pa);
+   });
+   THCudaCheck(cudaGetLastError());
+   return ret;
 }
 
 }
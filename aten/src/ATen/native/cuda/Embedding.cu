@@ -2,6 +2,7 @@
 #include <ATen/AccumulateType.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
 #include <c10/util/Exception.h>
 
 #include <THC/THCDeviceUtils.cuh>
@@ -115,67 +116,6 @@ __global__ void embedding_backward_feature_kernel
 }
 
 
-template <typename scalar_t>
-__global__ void embedding_backward_kernel(
-  int64_t* input, int64_t* indices, scalar_t* grad_output, scalar_t* grad_weight,
-  int64_t* count, int64_t numel, int64_t stride, int padding_idx) {
-
-  using accscalar_t = acc_type<scalar_t, true>;
-  int idx = blockIdx.x * 4 + threadIdx.y;
-
-  // Each warp is responsible for an input into the LookupTable.
-  // If the preceding input has the same as this input, then the warp
-  // exits immediately. The warp also processes subsequent inputs with the
-  // same value.
-  //
-  // Input Warp
-  // 1     <warp 1>
-  // 1     <warp 1> (<warp 2> exits without doing any work)
-  // 5     <warp 3>
-  // 8     <warp 4>
-
-  // Number of values proceessed by each thread (grain size)
-  const int SZ = 4;
-
-  if (idx < numel
-      && (idx == 0 || input[idx] != input[idx - 1])
-      && input[idx] != padding_idx) {
-    do {
-      const int start_feature = threadIdx.x + blockIdx.y * blockDim.x * SZ;
-      const int weight_row = ((int) input[idx]) * stride;
-      const int grad_row = ((int) indices[idx]) * stride;
-      const accscalar_t scale = count ? (accscalar_t)1.0 / count[idx] : 1.0;
-
-      accscalar_t gradient[SZ];
-      accscalar_t weight[SZ];
-
-      #pragma unroll
-      for (int ii = 0; ii < SZ; ii++) {
-        int feature_dim = start_feature + ii * WARP_SIZE;
-        if (feature_dim < stride) {
-          gradient[ii] = static_cast<accscalar_t>(grad_output[grad_row + feature_dim]);
-          weight[ii] = static_cast<accscalar_t>(grad_weight[weight_row + feature_dim]);
-        }
-      }
-
-      #pragma unroll
-      for (int ii = 0; ii < SZ; ii++) {
-        weight[ii] += gradient[ii] * scale;
-      }
-
-      #pragma unroll
-      for (int ii = 0; ii < SZ; ii++) {
-        int feature_dim = start_feature + ii * WARP_SIZE;
-        if (feature_dim < stride) {
-            grad_weight[weight_row + feature_dim] = static_cast<scalar_t>(weight[ii]);
-        }
-      }
-
-      idx++;
-    } while (idx < numel && input[idx] == input[idx - 1]);
-  }
-}
-
 /* Calculate norms of the rows of weight_ptr given by idx_ptr and capture them in norms */
 template <typename scalar_t, typename accscalar_t>
 __global__ void renorm_kernel(
@@ -231,12 +171,11 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
 
   auto num_indices = indices.numel();
   auto grad = grad_.contiguous().view({num_indices, grad_.size(-1)});
-  auto grad_weight = at::zeros({num_weights, grad_.size(-1)}, grad_.options());
-
-  int64_t stride = grad_weight.stride(0);
-  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
 
   if (num_indices <= 768 && !scale_grad_by_freq) {
+    auto grad_weight = at::zeros({num_weights, grad_.size(-1)}, grad_.options());
+    int64_t stride = grad_weight.stride(0);
+    cudaStream_t stream = at::cuda::getCurrentCUDAStream();
     auto indices_contig = indices.contiguous();
 
     dim3 grid(THCCeilDiv(stride, (int64_t)WARP_SIZE));
@@ -265,81 +204,10 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
     return grad_weight;
   }
 
-  auto sorted_indices = at::empty_like(indices);
-  auto orig_indices = at::empty_like(indices);
-  using device_ptr = thrust::device_ptr<int64_t>;
-
-  // Sort the inputs into sorted with the corresponding indices; we
-  // don't need a stable or multidimensional sort, so just use Thrust
-  // directly
-  {
-    sorted_indices.copy_(indices);
-
-    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
-    auto policy = thrust::cuda::par(allocator).on(stream);
-
-    // Fill sortedOrigIndices with sequential indices
-    auto count_iter = thrust::counting_iterator<int64_t>(0);
-    auto orig_data = device_ptr(orig_indices.data<int64_t>());
-    thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
-
-    // Sort; a stable sort is not required
-    auto sorted_data = device_ptr(sorted_indices.data<int64_t>());
-    thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data,
-                        ThrustLTOp<int64_t>());
-  }
-
-  Tensor count;
-  if (scale_grad_by_freq) {
-    count = at::empty_like(indices);
-
-    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
-    auto policy = thrust::cuda::par(allocator).on(stream);
-
-    // Compute an increasing sequence per unique item in sortedIndices:
-    // sorted: 2 5 5 5 7 7 8 9 9
-    //  count: 1 1 2 3 1 2 1 1 2
-    auto sorted_data = device_ptr(sorted_indices.data<int64_t>());
-    auto count_data = device_ptr(count.data<int64_t>());
-    thrust::inclusive_scan_by_key(
-      policy,
-      sorted_data,
-      sorted_data + num_indices,
-      thrust::make_constant_iterator(1),
-      count_data
-    );
-
-    // Take the maximum of each count per unique key in reverse:
-    // sorted: 2 5 5 5 7 7 8 9 9
-    //  count: 1 3 3 3 2 2 1 2 2
-    thrust::inclusive_scan_by_key(
-      policy,
-      thrust::make_reverse_iterator(sorted_data + num_indices),
-      thrust::make_reverse_iterator(sorted_data),
-      thrust::make_reverse_iterator(count_data + num_indices),
-      thrust::make_reverse_iterator(count_data + num_indices),
-      thrust::equal_to<int64_t>(),
-      thrust::maximum<int64_t>()
-    );
-  }
-
-  dim3 grid(THCCeilDiv(num_indices, (int64_t) 4), THCCeilDiv(stride, (int64_t) 128));
-  dim3 block(32, 4);
-
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad.scalar_type(), "embedding_backward", [&] {
-    embedding_backward_kernel<<<grid, block, 0, stream>>>(
-      sorted_indices.data<int64_t>(),
-      orig_indices.data<int64_t>(),
-      grad.data<scalar_t>(),
-      grad_weight.data<scalar_t>(),
-      count.defined() ? count.data<int64_t>() : nullptr,
-      num_indices,
-      stride,
-      padding_idx);
-  });
-  THCudaCheck(cudaGetLastError());
-
-  return grad_weight;
+  Tensor sorted_indices, orig_indices;
+  std::tie(sorted_indices, orig_indices) = embedding_sort_indices(indices);
+  return embedding_backward_cuda_kernel(grad, orig_indices, sorted_indices,
+      num_weights, padding_idx, scale_grad_by_freq);
 }
 
 Tensor & embedding_renorm_cuda_(Tensor & self, const Tensor & indices,
@@ -0,0 +1,280 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
+
+#include <THC/THCDeviceUtils.cuh>
+#include <THC/THCThrustAllocator.cuh>
+
+#include <thrust/copy.h>
+#include <thrust/device_ptr.h>
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/scan.h>
+#include <thrust/sort.h>
+#include <thrust/unique.h>
+
+namespace at { namespace native {
+
+namespace {
+
+#ifdef __HIP_PLATFORM_HCC__
+static const int WARP_SIZE = 64;
+#else
+static const int WARP_SIZE = 32;
+#endif
+
+static const int BLOCK_SIZE = 128;
+
+// The maximum number of lookups summed by a thread of compute_grad_weight.
+// See Note [Embedding backward segment reduction]
+static const int NROWS_PER_THREAD = 10;
+
+// Computes the number of partial segments of each segment
+__global__ void krn_partials_per_segment(
+    int64_t* ret, const int64_t* segment_offsets,
+    int64_t num_segments, int64_t numel) {
+  const int64_t id = blockIdx.x * blockDim.x + threadIdx.x;
+  if (id < num_segments) {
+    const int64_t idx_start = segment_offsets[id];
+    const int64_t idx_end = (id == num_segments - 1) ? numel : segment_offsets[id + 1];
+    ret[id] = THCCeilDiv(idx_end - idx_start, (int64_t)NROWS_PER_THREAD);
+  }
+}
+
+// Computes the offset in the sorted indices of each partial segment
+__global__ void krn_partial_segment_offset(
+    int64_t* ret, const int64_t* partials_per_segment,
+    const int64_t* partials_per_segment_offset,
+    const int64_t* segment_offsets, int64_t num_segments) {
+  const int64_t id = blockIdx.x * blockDim.x + threadIdx.x;
+  if (id < num_segments) {
+    int64_t idx = partials_per_segment_offset[id];
+    const int64_t num_partials = partials_per_segment[id];
+    const int64_t segment_offset = segment_offsets[id];
+    for (int64_t i = 0; i < num_partials; ++i) {
+      ret[idx++] = segment_offset + i * NROWS_PER_THREAD;
+    }
+  }
+}
+
+// Sums the scaled rows of grad_output of each partial segment into
+// grad_weight_per_segment, with a thread per feature of a partial segment
+template <typename scalar_t>
+__global__ void compute_grad_weight(
+    const int64_t* indices, const scalar_t* grad_output,
+    const int64_t* offset2bag, const int64_t* bag_size, bool mode_mean,
+    const scalar_t* per_sample_weights, int64_t per_sample_weights_stride,
+    int64_t numel, int64_t stride,
+    const int64_t* partial_segment_offsets, int64_t num_partial_segments,
+    acc_type<scalar_t, true>* grad_weight_per_segment,
+    int64_t stride_warped) {
+
+  using accscalar_t = acc_type<scalar_t, true>;
+  const int64_t gid = blockIdx.x * blockDim.x + threadIdx.x;
+  const int64_t id = gid / stride_warped;
+  const int64_t start_feature = gid % stride_warped;
+  if (start_feature >= stride || id >= num_partial_segments) {
+    return;
+  }
+  const int64_t idx_begin = partial_segment_offsets[id];
+  const int64_t idx_end = (id == num_partial_segments - 1) ? numel : partial_segment_offsets[id + 1];
+
+  accscalar_t weight = 0;
+  for (int64_t idx = idx_begin; idx < idx_end; ++idx) {
+    const int64_t orig_row = indices[idx];
+    const int64_t grad_row = offset2bag ? offset2bag[orig_row] : orig_row;
+    accscalar_t scale = 1;
+    if (per_sample_weights) {
+      scale = static_cast<accscalar_t>(per_sample_weights[orig_row * per_sample_weights_stride]);
+    }
+    if (mode_mean) {
+      scale /= bag_size[grad_row];
+    }
+    weight += static_cast<accscalar_t>(grad_output[grad_row * stride + start_feature]) * scale;
+  }
+  grad_weight_per_segment[id * stride + start_feature] = weight;
+}
+
+// Adds up the partial sums of each segment in order, and writes them to the
+// row of the segment in grad_weight, with a thread per feature of a segment
+template <typename scalar_t>
+__global__ void sum_and_scatter(
+    const int64_t* sorted_indices, scalar_t* grad_weight, int64_t stride,
+    const int64_t* segment_offsets, int64_t num_segments, int64_t numel,
+    const acc_type<scalar_t, true>* grad_weight_per_segment,
+    const int64_t* partials_per_segment_offset, int64_t num_partial_segments,
+    int64_t padding_idx, bool scale_grad_by_freq, int64_t stride_warped) {
+
+  using accscalar_t = acc_type<scalar_t, true>;
+  const int64_t gid = blockIdx.x * blockDim.x + threadIdx.x;
+  const int64_t id = gid / stride_warped;
+  const int64_t start_feature = gid % stride_warped;
+  if (start_feature >= stride || id >= num_segments) {
+    return;
+  }
+  const int64_t idx_begin = segment_offsets[id];
+  const int64_t weight_row = sorted_indices[idx_begin];
+  if (weight_row == padding_idx) {
+    return;
+  }
+  const int64_t idx_end = (id == num_segments - 1) ? numel : segment_offsets[id + 1];
+  const int64_t partial_begin = partials_per_segment_offset[id];
+  const int64_t partial_end = (id == num_segments - 1) ?
+      num_partial_segments : partials_per_segment_offset[id + 1];
+
+  accscalar_t weight = 0;
+  for (int64_t p = partial_begin; p < partial_end; ++p) {
+    weight += grad_weight_per_segment[p * stride + start_feature];
+  }
+  if (scale_grad_by_freq) {
+    weight /= static_cast<accscalar_t>(idx_end - idx_begin);
+  }
+  grad_weight[weight_row * stride + start_feature] = static_cast<scalar_t>(weight);
+}
+
+} // anonymous namespace
+
+std::tuple<Tensor, Tensor> embedding_sort_indices(const Tensor& indices) {
+  const int64_t numel = indices.numel();
+  auto sorted_indices = indices.contiguous().view(-1).clone();
+  auto orig_indices = at::empty_like(sorted_indices);
+  if (numel == 0) {
+    return std::make_tuple(sorted_indices, orig_indices);
+  }
+
+  using device_ptr = thrust::device_ptr<int64_t>;
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(at::cuda::getCurrentCUDAStream());
+
+  // Fill orig_indices with sequential indices
+  auto count_iter = thrust::counting_iterator<int64_t>(0);
+  auto orig_data = device_ptr(orig_indices.data<int64_t>());
+  thrust::copy(policy, count_iter, count_iter + numel, orig_data);
+
+  // Sorting with the default comparator lets thrust use a radix sort, and the
+  // stable sort keeps the lookups of each index in the order of the input
+  auto sorted_data = device_ptr(sorted_indices.data<int64_t>());
+  thrust::stable_sort_by_key(policy, sorted_data, sorted_data + numel, orig_data);
+  return std::make_tuple(sorted_indices, orig_indices);
+}
+
+Tensor embedding_backward_cuda_kernel(
+    const Tensor& grad,
+    const Tensor& orig_indices,
+    const Tensor& sorted_indices,
+    int64_t num_weights,
+    int64_t padding_idx,
+    bool scale_grad_by_freq,
+    bool mode_mean,
+    const Tensor& offset2bag,
+    const Tensor& bag_size,
+    const Tensor& per_sample_weights) {
+
+  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
+  const int64_t numel = sorted_indices.numel();
+  if (numel == 0) {
+    return grad_weight;
+  }
+  const int64_t stride = grad_weight.stride(0);
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+  using device_ptr = thrust::device_ptr<int64_t>;
+
+  // Compute the offset of each segment of equal sorted indices:
+  // sorted:  2 5 5 5 7 7 8 9 9
+  // offsets: 0 1 4 6 7
+  auto segment_offsets = at::empty({numel}, orig_indices.options());
+  int64_t num_segments;
+  {
+    auto sorted_data = device_ptr(sorted_indices.data<int64_t>());
+    auto dummy = at::empty_like(sorted_indices);
+    auto dummy_data = device_ptr(dummy.data<int64_t>());
+    auto offsets_data = device_ptr(segment_offsets.data<int64_t>());
+    auto ends = thrust::unique_by_key_copy(
+        policy, sorted_data, sorted_data + numel,
+        thrust::counting_iterator<int64_t>(0), dummy_data, offsets_data);
+    num_segments = ends.first - dummy_data;
+  }
+
+  // Cut the segments into partial segments of at most NROWS_PER_THREAD lookups
+  auto partials_per_segment = at::empty({num_segments}, orig_indices.options());
+  krn_partials_per_segment<<<THCCeilDiv(num_segments, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+      partials_per_segment.data<int64_t>(),
+      segment_offsets.data<int64_t>(),
+      num_segments,
+      numel);
+  THCudaCheck(cudaGetLastError());
+
+  // The offset of the first partial segment of each segment
+  auto partials_per_segment_offset = at::empty({num_segments}, orig_indices.options());
+  thrust::exclusive_scan(
+      policy,
+      device_ptr(partials_per_segment.data<int64_t>()),
+      device_ptr(partials_per_segment.data<int64_t>() + num_segments),
+      device_ptr(partials_per_segment_offset.data<int64_t>()));
+
+  const int64_t num_partial_segments =
+      partials_per_segment_offset[num_segments - 1].item<int64_t>() +
+      partials_per_segment[num_segments - 1].item<int64_t>();
+
+  auto partial_segment_offsets = at::empty({num_partial_segments}, orig_indices.options());
+  krn_partial_segment_offset<<<THCCeilDiv(num_segments, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+      partial_segment_offsets.data<int64_t>(),
+      partials_per_segment.data<int64_t>(),
+      partials_per_segment_offset.data<int64_t>(),
+      segment_offsets.data<int64_t>(),
+      num_segments);
+  THCudaCheck(cudaGetLastError());
+
+  const int64_t stride_warped = THCCeilDiv(stride, (int64_t)WARP_SIZE) * WARP_SIZE;
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad.scalar_type(), "embedding_backward_cuda_kernel", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    auto acc_type_ = grad.scalar_type() == kHalf ? kFloat : grad.scalar_type();
+    auto grad_weight_per_segment = at::empty(
+        {num_partial_segments, stride}, grad.options().dtype(acc_type_));
+
+    // Sum the partial segments
+    compute_grad_weight<scalar_t><<<
+        THCCeilDiv(num_partial_segments * stride_warped, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+        orig_indices.data<int64_t>(),
+        grad.data<scalar_t>(),
+        offset2bag.defined() ? offset2bag.data<int64_t>() : nullptr,
+        mode_mean ? bag_size.data<int64_t>() : nullptr,
+        mode_mean,
+        per_sample_weights.defined() ? per_sample_weights.data<scalar_t>() : nullptr,
+        per_sample_weights.defined() ? per_sample_weights.stride(0) : 0,
+        numel,
+        stride,
+        partial_segment_offsets.data<int64_t>(),
+        num_partial_segments,
+        grad_weight_per_segment.data<accscalar_t>(),
+        stride_warped);
+    THCudaCheck(cudaGetLastError());
+
+    // Add up the partial sums of each segment and write its row
+    sum_and_scatter<scalar_t><<<
+        THCCeilDiv(num_segments * stride_warped, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+        sorted_indices.data<int64_t>(),
+        grad_weight.data<scalar_t>(),
+        stride,
+        segment_offsets.data<int64_t>(),
+        num_segments,
+        numel,
+        grad_weight_per_segment.data<accscalar_t>(),
+        partials_per_segment_offset.data<int64_t>(),
+        num_partial_segments,
+        padding_idx,
+        scale_grad_by_freq,
+        stride_warped);
+    THCudaCheck(cudaGetLastError());
+  });
+
+  return grad_weight;
+}
+
+}} // namespace at::native
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <tuple>
+
+namespace at { namespace native {
+
+// Note [Embedding backward segment reduction]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The gradient of an embedding sums the rows of grad_output looked up by the
+// same index. Once the indices are sorted, the lookups of an index form a
+// contiguous segment of the sorted indices, so the gradient is a segmented
+// reduction: each row of grad_weight is computed by summing its segment, and
+// written once, without atomics. Since the sort is stable, a segment lists its
+// lookups in the order of the input, and the gradient is deterministic.
+//
+// A few indices can be looked up much more often than the others (e.g. the
+// padding or unknown token), and summing their segments serially would leave
+// most of the GPU idle. The segments are therefore cut into partial segments
+// of at most a few lookups, which are summed in parallel into a buffer, and
+// the partial sums of each segment are then added up in order.
+
+// Sorts the indices with a stable radix sort, and returns the sorted indices
+// and the position in `indices` of each of them
+std::tuple<Tensor, Tensor> embedding_sort_indices(const Tensor& indices);
+
+// Returns the [num_weights, grad.size(1)] gradient of the weight of an
+// embedding, given the sorted indices and their positions returned by
+// embedding_sort_indices. The lookup at position i uses the row i of `grad`,
+// or the row offset2bag[i] of a bag when `offset2bag` is defined, scaled by
+// per_sample_weights[i] when it is defined and divided by the size of its bag
+// when mode_mean is true. The rows of `padding_idx` are left zero, and the
+// rows are divided by the number of their lookups when scale_grad_by_freq is
+// true. See Note [Embedding backward segment reduction]
+Tensor embedding_backward_cuda_kernel(
+    const Tensor& grad,
+    const Tensor& orig_indices,
+    const Tensor& sorted_indices,
+    int64_t num_weights,
+    int64_t padding_idx = -1,
+    bool scale_grad_by_freq = false,
+    bool mode_mean = false,
+    const Tensor& offset2bag = Tensor(),
+    const Tensor& bag_size = Tensor(),
+    const Tensor& per_sample_weights = Tensor());
+
+}} // namespace at::native
@@ -0,0 +1,103 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/Array.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/quantized/fake_quant_affine.h>
+
+// NOTE: CUDA on Windows requires that the enclosing function
+// of a __device__ lambda not have internal linkage.
+
+namespace at { namespace native {
+
+// Calls `f(ptrs)` on each element of `iter`, with the addresses of the
+// element in its N operands. Unlike the kernels of Loops.cuh, this takes
+// several outputs.
+template <int N, typename func_t>
+void gpu_fake_quant_kernel(TensorIterator& iter, const func_t& f) {
+  if (!iter.can_use_32bit_indexing()) {
+    for (auto& sub_iter : iter.with_32bit_indexing()) {
+      gpu_fake_quant_kernel<N>(sub_iter, f);
+    }
+    return;
+  }
+  at::cuda::Array<char*, N> data;
+  for (int i = 0; i < N; i++) {
+    data[i] = (char*)iter.data_ptr(i);
+  }
+  auto offset_calc = make_offset_calculator<N>(iter);
+  launch_kernel<launch_size_nd, launch_bound2>(iter.numel(), [=]__device__(int idx) {
+    auto offsets = offset_calc.get(idx);
+    at::cuda::Array<char*, N> ptrs;
+    #pragma unroll
+    for (int i = 0; i < N; i++) {
+      ptrs[i] = data[i] + offsets[i];
+    }
+    f(ptrs);
+  });
+}
+
+// See Note [Fake quantization]
+template <typename scalar_t>
+__device__ __forceinline__ void fake_quant_element(
+    char* y, char* mask, const char* x,
+    scalar_t scale, scalar_t inv_scale, scalar_t zero_point, scalar_t quant_min, scalar_t quant_max) {
+  const scalar_t q = ::floor(*(const scalar_t*)x * inv_scale + scalar_t(0.5)) + zero_point;
+  *(scalar_t*)y = (::fmin(::fmax(q, quant_min), quant_max) - zero_point) * scale;
+  *(scalar_t*)mask = q >= quant_min && q <= quant_max ? 1 : 0;
+}
+
+void fake_quant_tensor_kernel_cuda(
+    TensorIterator& iter,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_tensor_cuda", [&] {
+    const scalar_t s = scale;
+    const scalar_t inv_s = 1.0f / scale;
+    const scalar_t zp = zero_point;
+    const scalar_t qmin = quant_min;
+    const scalar_t qmax = quant_max;
+    gpu_fake_quant_kernel<3>(iter, [=]__device__(at::cuda::Array<char*, 3> ptrs) {
+      fake_quant_element<scalar_t>(ptrs[0], ptrs[1], ptrs[2], s, inv_s, zp, qmin, qmax);
+    });
+  });
+}
+
+void fake_quant_grad_tensor_kernel_cuda(
+    TensorIterator& iter,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_grad_tensor_cuda", [&] {
+    const scalar_t inv_s = 1.0f / scale;
+    const scalar_t zp = zero_point;
+    const scalar_t qmin = quant_min;
+    const scalar_t qmax = quant_max;
+    gpu_binary_kernel(iter, [=]GPU_LAMBDA(scalar_t x, scalar_t dy) -> scalar_t {
+      const scalar_t q = ::floor(x * inv_s + scalar_t(0.5)) + zp;
+      return q >= qmin && q <= qmax ? dy : scalar_t(0);
+    });
+  });
+}
+
+void fake_quant_channel_kernel_cuda(TensorIterator& iter, int64_t quant_min, int64_t quant_max) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "fake_quantize_channel_cuda", [&] {
+    const scalar_t qmin = quant_min;
+    const scalar_t qmax = quant_max;
+    gpu_fake_quant_kernel<5>(iter, [=]__device__(at::cuda::Array<char*, 5> ptrs) {
+      const scalar_t scale = *(const scalar_t*)ptrs[3];
+      fake_quant_element<scalar_t>(
+          ptrs[0], ptrs[1], ptrs[2], scale, scalar_t(1) / scale,
+          *(const scalar_t*)ptrs[4], qmin, qmax);
+    });
+  });
+}
+
+REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quant_tensor_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_grad_tensor_stub, &fake_quant_grad_tensor_kernel_cuda);
+REGISTER_DISPATCH(fake_quant_channel_stub, &fake_quant_channel_kernel_cuda);
+
+}} // namespace at::native
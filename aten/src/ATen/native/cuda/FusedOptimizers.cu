@@ -0,0 +1,173 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/FusedOptimizers.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+// Whether the tensors of `lists` can be updated by multi_tensor_apply: they
+// must all be contiguous and have the dtype and device of the first param.
+// See Note [Multi-tensor apply]
+bool can_use_multi_tensor_apply(const std::vector<TensorList>& lists) {
+  const auto& first = lists[0][0];
+  for (const auto& list : lists) {
+    for (const auto& t : list) {
+      if (!t.is_cuda() || t.scalar_type() != first.scalar_type() ||
+          t.get_device() != first.get_device() || !t.is_contiguous()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Updates element i of the param, exp_avg and exp_avg_sq in data[0], data[2]
+// and data[3] with the grad in data[1], and the max_exp_avg_sq of AMSGrad when
+// it isn't null
+template <typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ void adam_update(
+    scalar_t** data,
+    int64_t i,
+    accscalar_t beta1,
+    accscalar_t beta2,
+    accscalar_t eps,
+    accscalar_t weight_decay,
+    accscalar_t step_size,
+    accscalar_t* max_exp_avg_sq) {
+  accscalar_t param = data[0][i];
+  accscalar_t grad = data[1][i];
+  if (weight_decay != 0) {
+    grad += weight_decay * param;
+  }
+  accscalar_t exp_avg = beta1 * data[2][i] + (1 - beta1) * grad;
+  accscalar_t exp_avg_sq = beta2 * data[3][i] + (1 - beta2) * grad * grad;
+  accscalar_t denom = exp_avg_sq;
+  if (max_exp_avg_sq) {
+    *max_exp_avg_sq = ::max(*max_exp_avg_sq, exp_avg_sq);
+    denom = *max_exp_avg_sq;
+  }
+  data[0][i] = param - step_size * exp_avg / (::sqrt(denom) + eps);
+  data[2][i] = exp_avg;
+  data[3][i] = exp_avg_sq;
+}
+
+} // anonymous namespace
+
+void _fused_adam_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    int64_t step) {
+  const bool amsgrad = !max_exp_avg_sqs.empty();
+  std::vector<TensorList> lists{params, grads, exp_avgs, exp_avg_sqs};
+  if (amsgrad) {
+    lists.push_back(max_exp_avg_sqs);
+  }
+  if (params.empty() || !can_use_multi_tensor_apply(lists)) {
+    return at::native::_fused_adam_(
+        params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+        lr, beta1, beta2, eps, weight_decay, step);
+  }
+  check_fused_list("_fused_adam_", params, grads, "grads");
+  check_fused_list("_fused_adam_", params, exp_avgs, "exp_avgs");
+  check_fused_list("_fused_adam_", params, exp_avg_sqs, "exp_avg_sqs");
+  if (amsgrad) {
+    check_fused_list("_fused_adam_", params, max_exp_avg_sqs, "max_exp_avg_sqs");
+  }
+  TORCH_CHECK(step > 0, "_fused_adam_: expected a positive step, but got ", step);
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr * std::sqrt(bias_correction2) / bias_correction1;
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params[0].scalar_type(), "_fused_adam_cuda_", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const auto beta1_ = static_cast<accscalar_t>(beta1);
+    const auto beta2_ = static_cast<accscalar_t>(beta2);
+    const auto eps_ = static_cast<accscalar_t>(eps);
+    const auto weight_decay_ = static_cast<accscalar_t>(weight_decay);
+    const auto step_size_ = static_cast<accscalar_t>(step_size);
+    if (amsgrad) {
+      multi_tensor_apply<scalar_t, 5>(lists, [=]__device__(scalar_t** data, int64_t i) {
+        accscalar_t max_exp_avg_sq = data[4][i];
+        adam_update<scalar_t, accscalar_t>(
+            data, i, beta1_, beta2_, eps_, weight_decay_, step_size_, &max_exp_avg_sq);
+        data[4][i] = max_exp_avg_sq;
+      });
+    } else {
+      multi_tensor_apply<scalar_t, 4>(lists, [=]__device__(scalar_t** data, int64_t i) {
+        adam_update<scalar_t, accscalar_t>(
+            data, i, beta1_, beta2_, eps_, weight_decay_, step_size_, nullptr);
+      });
+    }
+  });
+}
+
+void _fused_sgd_cuda_(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov) {
+  const bool has_momentum = !momentum_buffers.empty();
+  std::vector<TensorList> lists{params, grads};
+  if (has_momentum) {
+    lists.push_back(momentum_buffers);
+  }
+  if (params.empty() || !can_use_multi_tensor_apply(lists)) {
+    return at::native::_fused_sgd_(
+        params, grads, momentum_buffers, lr, weight_decay, momentum, dampening, nesterov);
+  }
+  check_fused_list("_fused_sgd_", params, grads, "grads");
+  if (has_momentum) {
+    check_fused_list("_fused_sgd_", params, momentum_buffers, "momentum_buffers");
+  }
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params[0].scalar_type(), "_fused_sgd_cuda_", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const auto lr_ = static_cast<accscalar_t>(lr);
+    const auto weight_decay_ = static_cast<accscalar_t>(weight_decay);
+    const auto momentum_ = static_cast<accscalar_t>(momentum);
+    const auto dampening_ = static_cast<accscalar_t>(dampening);
+    if (has_momentum) {
+      multi_tensor_apply<scalar_t, 3>(lists, [=]__device__(scalar_t** data, int64_t i) {
+        accscalar_t param = data[0][i];
+        accscalar_t update = data[1][i];
+        if (weight_decay_ != 0) {
+          update += weight_decay_ * param;
+        }
+        accscalar_t buf = momentum_ * data[2][i] + (1 - dampening_) * update;
+        data[2][i] = buf;
+        update = nesterov ? update + momentum_ * buf : buf;
+        data[0][i] = param - lr_ * update;
+      });
+    } else {
+      multi_tensor_apply<scalar_t, 2>(lists, [=]__device__(scalar_t** data, int64_t i) {
+        accscalar_t param = data[0][i];
+        accscalar_t update = data[1][i];
+        if (weight_decay_ != 0) {
+          update += weight_decay_ * param;
+        }
+        data[0][i] = param - lr_ * update;
+      });
+    }
+  });
+}
+
+}} // namespace at::native
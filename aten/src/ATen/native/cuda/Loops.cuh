@@ -7,6 +7,8 @@
 #include <ATen/native/TensorIterator.h>
 #include <c10/macros/Macros.h>
 
+#include <cstdint>
+
 // Marks a lambda as executable on both the host and device. The __host__
 // attribute is important so that we can access static type information from
 // the host, even if the function is typically only executed on the device.
@@ -72,6 +74,84 @@ static void launch_kernel(int64_t N, const func_t& f) {
   AT_CUDA_CHECK(cudaGetLastError());
 }
 
+// The contiguous kernels below load and store the operands of consecutive
+// elements with single 128-bit accesses when all the operands are contiguous
+// and their data pointers are aligned: each thread then computes vec_size
+// elements, where vec_size is the number of elements of the widest operand
+// that fit in 16 bytes (e.g. 4 floats or 8 halfs). The elements left over at
+// the end are computed one per thread by the same launch.
+template<typename scalar_t, int vec_size>
+struct alignas(sizeof(scalar_t) * vec_size) aligned_vector {
+  scalar_t val[vec_size];
+};
+
+template<typename T>
+constexpr int max_sizeof() {
+  return sizeof(T);
+}
+
+template<typename T, typename U, typename... Ts>
+constexpr int max_sizeof() {
+  return sizeof(T) > max_sizeof<U, Ts...>() ? sizeof(T) : max_sizeof<U, Ts...>();
+}
+
+template<typename... types>
+constexpr int vectorized_size() {
+  return 16 / max_sizeof<types...>() > 8 ? 8 : 16 / max_sizeof<types...>();
+}
+
+template<int vec_size, typename scalar_t>
+static bool can_vectorize(const char* data, int stride) {
+  return stride == static_cast<int>(sizeof(scalar_t)) &&
+      reinterpret_cast<uintptr_t>(data) % sizeof(aligned_vector<scalar_t, vec_size>) == 0;
+}
+
+template<int vec_size, typename arg0_t, typename arg1_t, typename func_t>
+static void launch_vectorized_unary_kernel(int numel, char* out_data, const char* in1_data, const func_t& f) {
+  using out_vec_t = aligned_vector<arg0_t, vec_size>;
+  using in1_vec_t = aligned_vector<arg1_t, vec_size>;
+  int nvec = numel / vec_size;
+  int remaining = numel - nvec * vec_size;
+  launch_kernel<launch_size_1d, 1>(nvec + remaining, [=]__device__(int idx) {
+    if (idx < nvec) {
+      in1_vec_t in1 = ((const in1_vec_t*)in1_data)[idx];
+      out_vec_t out;
+      #pragma unroll
+      for (int i = 0; i < vec_size; i++) {
+        out.val[i] = f(in1.val[i]);
+      }
+      ((out_vec_t*)out_data)[idx] = out;
+    } else {
+      int i = nvec * (vec_size - 1) + idx;
+      ((arg0_t*)out_data)[i] = f(((const arg1_t*)in1_data)[i]);
+    }
+  });
+}
+
+template<int vec_size, typename arg0_t, typename arg1_t, typename arg2_t, typename func_t>
+static void launch_vectorized_binary_kernel(int numel, char* out_data, const char* in1_data, const char* in2_data, const func_t& f) {
+  using out_vec_t = aligned_vector<arg0_t, vec_size>;
+  using in1_vec_t = aligned_vector<arg1_t, vec_size>;
+  using in2_vec_t = aligned_vector<arg2_t, vec_size>;
+  int nvec = numel / vec_size;
+  int remaining = numel - nvec * vec_size;
+  launch_kernel<launch_size_1d, 1>(nvec + remaining, [=]__device__(int idx) {
+    if (idx < nvec) {
+      in1_vec_t in1 = ((const in1_vec_t*)in1_data)[idx];
+      in2_vec_t in2 = ((const in2_vec_t*)in2_data)[idx];
+      out_vec_t out;
+      #pragma unroll
+      for (int i = 0; i < vec_size; i++) {
+        out.val[i] = f(in1.val[i], in2.val[i]);
+      }
+      ((out_vec_t*)out_data)[idx] = out;
+    } else {
+      int i = nvec * (vec_size - 1) + idx;
+      ((arg0_t*)out_data)[i] = f(((const arg1_t*)in1_data)[i], ((const arg2_t*)in2_data)[i]);
+    }
+  });
+}
+
 template<typename func_t>
 void gpu_nullary_kernel(TensorIterator& iter, const func_t& f) {
   ASSERT_HOST_DEVICE_LAMBDA(func_t);
@@ -141,6 +221,13 @@ void gpu_unary_kernel(TensorIterator& iter, const func_t& f) {
     auto strides = iter.get_inner_strides();
     int stride0 = strides[0];
     int stride1 = strides[1];
+    constexpr int vec_size = vectorized_size<arg0_t, arg1_t>();
+    if (vec_size > 1 &&
+        can_vectorize<vec_size, arg0_t>(out_data, stride0) &&
+        can_vectorize<vec_size, arg1_t>(in1_data, stride1)) {
+      launch_vectorized_unary_kernel<vec_size, arg0_t, arg1_t>(numel, out_data, in1_data, f);
+      return;
+    }
     launch_kernel<launch_size_1d, 1>(numel, [out_data, stride0, stride1, in1_data, f]__device__(int idx) {
       arg0_t* out = (arg0_t*)&out_data[stride0 * idx];
       arg1_t* in1 = (arg1_t*)&in1_data[stride1 * idx];
@@ -198,6 +285,14 @@ void gpu_binary_kernel(TensorIterator& iter, const func_t& f) {
     int stride0 = strides[0];
     int stride1 = strides[1];
     int stride2 = strides[2];
+    constexpr int vec_size = vectorized_size<arg0_t, arg1_t, arg2_t>();
+    if (vec_size > 1 &&
+        can_vectorize<vec_size, arg0_t>(out_data, stride0) &&
+        can_vectorize<vec_size, arg1_t>(in1_data, stride1) &&
+        can_vectorize<vec_size, arg2_t>(in2_data, stride2)) {
+      launch_vectorized_binary_kernel<vec_size, arg0_t, arg1_t, arg2_t>(numel, out_data, in1_data, in2_data, f);
+      return;
+    }
     launch_kernel<launch_size_1d, 1>(numel, [stride0, stride1, out_data, in1_data, f, stride2, in2_data]__device__(int idx) {
       arg0_t* out = (arg0_t*)&out_data[stride0 * idx];
       arg1_t* in1 = (arg1_t*)&in1_data[stride1 * idx];
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace at { namespace native {
+
+// Note [Multi-tensor apply]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// An optimizer step updates each of the parameters of a model with a few
+// elementwise ops, and a model can have hundreds of small parameters: updating
+// them one at a time takes thousands of tiny kernel launches. multi_tensor_apply
+// instead calls an elementwise function on the elements of lists of tensors
+// with a few launches: the tensors are cut into chunks of
+// kMultiTensorChunkSize elements, and each block of a launch computes a chunk
+// of one of them. The data pointers and sizes of the tensors of a launch are
+// passed by value, in a TensorListMetadata small enough for the 4KB limit of
+// kernel arguments, so a launch covers up to depth_to_max_tensors tensors and
+// depth_to_max_blocks chunks. A tensor whose chunks don't fit in a launch
+// carries over into the next one.
+//
+// The `depth` lists have the same length, and their tensors at the same index
+// are contiguous, have the same number of elements and the dtype scalar_t, and
+// are on the current device.
+
+constexpr int64_t kMultiTensorChunkSize = 65536;
+constexpr int kMultiTensorBlockSize = 512;
+
+// Indexed by depth - 1
+constexpr int depth_to_max_tensors[5] = {110, 64, 48, 36, 30};
+constexpr int depth_to_max_blocks[5] = {320, 320, 320, 320, 320};
+
+template <int depth>
+struct TensorListMetadata {
+  void* addresses[depth][depth_to_max_tensors[depth - 1]];
+  int64_t numel[depth_to_max_tensors[depth - 1]];
+  unsigned char block_to_tensor[depth_to_max_blocks[depth - 1]];
+  int block_to_chunk[depth_to_max_blocks[depth - 1]];
+};
+
+template <typename scalar_t, int depth, typename func_t>
+C10_LAUNCH_BOUNDS_1(kMultiTensorBlockSize)
+__global__ void multi_tensor_apply_kernel(TensorListMetadata<depth> meta, func_t f) {
+  const int tensor = meta.block_to_tensor[blockIdx.x];
+  const int64_t begin = meta.block_to_chunk[blockIdx.x] * kMultiTensorChunkSize;
+  const int64_t end = ::min(meta.numel[tensor], begin + kMultiTensorChunkSize);
+  scalar_t* data[depth];
+  #pragma unroll
+  for (int d = 0; d < depth; d++) {
+    data[d] = static_cast<scalar_t*>(meta.addresses[d][tensor]);
+  }
+  for (int64_t i = begin + threadIdx.x; i < end; i += blockDim.x) {
+    f(data, i);
+  }
+}
+
+// Calls `f(data, i)` on each element i of the tensors of `lists`, where
+// data[d] is the data pointer of the tensor of lists[d].
+// See Note [Multi-tensor apply]
+template <typename scalar_t, int depth, typename func_t>
+void multi_tensor_apply(const std::vector<TensorList>& lists, const func_t& f) {
+  static_assert(depth >= 1 && depth <= 5, "multi_tensor_apply supports 1 to 5 lists");
+  AT_ASSERT(lists.size() == depth);
+  constexpr int max_tensors = depth_to_max_tensors[depth - 1];
+  constexpr int max_blocks = depth_to_max_blocks[depth - 1];
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TensorListMetadata<depth> meta;
+  int ntensors = 0;
+  int nblocks = 0;
+  auto launch = [&] {
+    multi_tensor_apply_kernel<scalar_t, depth, func_t>
+        <<<nblocks, kMultiTensorBlockSize, 0, stream>>>(meta, f);
+    AT_CUDA_CHECK(cudaGetLastError());
+    nblocks = 0;
+  };
+
+  for (size_t t = 0; t < lists[0].size(); t++) {
+    const int64_t numel = lists[0][t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    for (int d = 0; d < depth; d++) {
+      meta.addresses[d][ntensors] = lists[d][t].data_ptr();
+    }
+    meta.numel[ntensors] = numel;
+    ntensors++;
+
+    const int64_t nchunks = (numel + kMultiTensorChunkSize - 1) / kMultiTensorChunkSize;
+    for (int64_t chunk = 0; chunk < nchunks; chunk++) {
+      meta.block_to_tensor[nblocks] = ntensors - 1;
+      meta.block_to_chunk[nblocks] = chunk;
+      nblocks++;
+      const bool last_chunk = chunk == nchunks - 1;
+      if (nblocks == max_blocks || (ntensors == max_tensors && last_chunk)) {
+        launch();
+        if (last_chunk) {
+          ntensors = 0;
+        } else {
+          // The rest of the chunks of this tensor go into the next launch
+          for (int d = 0; d < depth; d++) {
+            meta.addresses[d][0] = meta.addresses[d][ntensors - 1];
+          }
+          meta.numel[0] = numel;
+          ntensors = 1;
+        }
+      }
+    }
+  }
+  if (nblocks > 0) {
+    launch();
+  }
+}
+
+}} // namespace at::native
@@ -4,18 +4,26 @@
 #include <ATen/ATen.h>
 #include <ATen/cuda/Array.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <ATen/cuda/detail/OffsetCalculator.cuh>
 #include <ATen/detail/FunctionTraits.h>
 #include <THC/THCDeviceUtils.cuh>
 #include <THC/THCGeneral.hpp>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
+#include <ATen/native/utils/ParamsHash.h>
 #include <c10/macros/Macros.h>
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iosfwd>
+#include <limits>
+#include <mutex>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <thrust/tuple.h>
 
 namespace at { namespace native {
@@ -635,6 +643,204 @@ struct AccumulationBuffer {
   at::DataPtr buffer_;
 };
 
+// The number of thread blocks the inputs of each output can be split across:
+// at least 16 values per thread, and at most what fits in grid.y.
+static inline int max_ctas_per_output(const ReduceConfig& config) {
+  if (config.input_mult[1] == 0 || config.values_per_thread() < 256) {
+    return 1;
+  }
+  return static_cast<int>(std::min<int64_t>(div_up(config.values_per_thread(), 16), 65535));
+}
+
+// Divide the inputs across thread blocks only as far as it takes to fill the
+// device when the outputs alone don't: more blocks don't read memory any
+// faster, and the last block of each output has to combine all of them.
+static inline int default_ctas_per_output(const ReduceConfig& config) {
+  // Resident blocks per SM at full occupancy, times a couple of waves to
+  // absorb blocks that finish late
+  constexpr int num_waves = 2;
+  const auto* prop = at::cuda::getCurrentDeviceProperties();
+  int64_t blocks_per_sm = std::max(1, prop->maxThreadsPerMultiProcessor / config.num_threads);
+  int64_t target_grid_size = prop->multiProcessorCount * blocks_per_sm * num_waves;
+  return static_cast<int>(std::min<int64_t>(
+      max_ctas_per_output(config), div_up(target_grid_size, config.grid().x)));
+}
+
+// Picks the block and grid dimensions of the reduction of `iter`.
+// `ctas_per_output` sets the number of thread blocks each output is split
+// across (1 for none, clamped to max_ctas_per_output); 0 picks
+// default_ctas_per_output.
+template <typename scalar_t, typename arg_t>
+ReduceConfig setReduceConfig(const TensorIterator& iter, int ctas_per_output = 0) {
+  // Start by assuming that each thread handles a single output and all
+  // the inputs for that output.
+  int64_t num_outputs = iter.num_output_elements();
+  int64_t inputs_per_output = iter.numel() / num_outputs;
+  int input_index = iter.ntensors() - 1;
+
+  auto config = ReduceConfig(sizeof(arg_t), num_outputs, inputs_per_output);
+
+  int64_t dim0;
+  int64_t dim1;
+  // adjust block size to fit width to fast changing dimension
+  if (iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
+    dim0 = iter.shape()[0];
+    dim1 = num_outputs;
+  } else {
+    dim0 = iter.shape()[iter.num_reduce_dims()];
+    dim1 = inputs_per_output;
+  }
+
+  config.set_block_dimension(dim0, dim1);
+
+  int block_width = config.block_width;
+  int block_height = config.block_height;
+
+  if (iter.ndim() == 0 || iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
+    // Split the input across lanes if the input is contiguous in the reduced
+    // dimension. This will require reduction between threads using warp
+    // shuffle instructions and shared memory (if block_width > warpSize).
+    config.input_mult[0] = config.split_input(block_width);
+  } else {
+    // Otherwise split the output across lanes in a warp.
+    config.output_mult[0] = config.split_output(block_width);
+  }
+
+  if (config.values_per_thread() >= block_height * 16 || config.values_per_thread() >= 256) {
+    // Divide the input across warps in a thread-block, if that leaves at least
+    // 16 elements to be summed by each thread. This will require inter-warp
+    // reduction using shared memory.
+    config.input_mult[1] = config.split_input(block_height);
+  } else {
+    // Otherwise, each warp handles a separate output.
+    config.output_mult[1] = config.split_output(block_height);
+  }
+
+  // Divide the input across thread-blocks if the amount of work per-thread
+  // is large enough and the outputs don't fill the device by themselves.
+  // This will require a reduction using global memory.
+  if (ctas_per_output == 0) {
+    ctas_per_output = default_ctas_per_output(config);
+  }
+  ctas_per_output = std::min(ctas_per_output, max_ctas_per_output(config));
+  if (ctas_per_output > 1) {
+    config.ctas_per_output = ctas_per_output;
+    config.input_mult[2] = config.split_input(config.ctas_per_output);
+  }
+
+  return config;
+}
+
+// Note [Reduction autotuning]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The best split of a reduction across thread blocks depends on the device
+// and on how much of the reduction happens within a block, which the
+// heuristics above only estimate. With at::globalContext().benchmarkReductions()
+// (torch.backends.cuda.benchmark_reductions), the first reduction of each
+// geometry on a device times the candidate splits and caches the fastest for
+// the reductions that follow, like cudnn.benchmark does for convolutions.
+// Only reductions that overwrite their outputs are timed, since each
+// candidate writes them again; the others use the cache or the heuristics.
+struct ReduceParams {
+  int64_t device;
+  int64_t num_outputs;
+  int64_t inputs_per_output;
+  int64_t ndim;
+  int64_t num_reduce_dims;
+  // The stride pattern: the size of the fastest moving dimension of the
+  // input, and whether the reduction is along it
+  int64_t fast_dim_size;
+  int64_t reduces_fast_dim;
+};
+
+struct ReduceTuningCache {
+  std::mutex mutex;
+  std::unordered_map<ReduceParams, int, ParamsHash<ReduceParams>, ParamsEqual<ReduceParams>> map;
+
+  bool find(const ReduceParams& params, int* ctas_per_output) {
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = map.find(params);
+    if (it == map.end()) {
+      return false;
+    }
+    *ctas_per_output = it->second;
+    return true;
+  }
+
+  void insert(const ReduceParams& params, int ctas_per_output) {
+    std::lock_guard<std::mutex> guard(mutex);
+    map[params] = ctas_per_output;
+  }
+};
+
+template <typename scalar_t>
+ReduceParams getReduceParams(const TensorIterator& iter) {
+  ReduceParams params;
+  // ParamsHash reads the padding too
+  memset(&params, 0, sizeof(params));
+  int input_index = iter.ntensors() - 1;
+  params.device = at::cuda::current_device();
+  params.num_outputs = iter.num_output_elements();
+  params.inputs_per_output = iter.numel() / params.num_outputs;
+  params.ndim = iter.ndim();
+  params.num_reduce_dims = iter.num_reduce_dims();
+  params.reduces_fast_dim =
+      iter.ndim() == 0 || iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t);
+  params.fast_dim_size = iter.ndim() == 0 ? 1 : iter.shape()[0];
+  return params;
+}
+
+// The splits worth timing: none, the default, and a few around it.
+static inline std::vector<int> candidate_ctas_per_output(const ReduceConfig& config) {
+  int max_ctas = max_ctas_per_output(config);
+  int default_ctas = default_ctas_per_output(config);
+  std::vector<int> candidates = {1};
+  for (int64_t ctas : {(int64_t)default_ctas / 4, (int64_t)default_ctas / 2, (int64_t)default_ctas,
+                       (int64_t)default_ctas * 2, (int64_t)default_ctas * 4, (int64_t)max_ctas}) {
+    int c = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(ctas, max_ctas)));
+    if (std::find(candidates.begin(), candidates.end(), c) == candidates.end()) {
+      candidates.push_back(c);
+    }
+  }
+  return candidates;
+}
+
+// Runs `launch(config)` for each candidate config, and returns the
+// ctas_per_output of the fastest, leaving its results in the outputs.
+template <typename scalar_t, typename arg_t, typename launch_t>
+int tune_ctas_per_output(const TensorIterator& iter, const launch_t& launch) {
+  auto candidates = candidate_ctas_per_output(setReduceConfig<scalar_t, arg_t>(iter, 1));
+  if (candidates.size() == 1) {
+    launch(setReduceConfig<scalar_t, arg_t>(iter, 1));
+    return 1;
+  }
+
+  auto stream = at::cuda::getCurrentCUDAStream();
+  // An untimed run first, so that the first candidate doesn't pay for cold
+  // caches and lazy kernel loading
+  launch(setReduceConfig<scalar_t, arg_t>(iter, candidates[0]));
+  int best = candidates[0];
+  float best_time = std::numeric_limits<float>::infinity();
+  for (int ctas : candidates) {
+    at::cuda::CUDAEvent start(cudaEventDefault);
+    at::cuda::CUDAEvent stop(cudaEventDefault);
+    start.record(stream);
+    launch(setReduceConfig<scalar_t, arg_t>(iter, ctas));
+    stop.record(stream);
+    stop.synchronize();
+    float time = start.elapsed_time(stop);
+    if (time < best_time) {
+      best_time = time;
+      best = ctas;
+    }
+  }
+  // Leave the results of the config that later reductions will use
+  if (best != candidates.back()) {
+    launch(setReduceConfig<scalar_t, arg_t>(iter, best));
+  }
+  return best;
+}
+
 template <typename scalar_t, typename out_scalar_t, int vt0=4, typename ops_t, typename ident_t=double>
 inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t ident=0,
                               AccumulationBuffer* acc_buf_ptr=nullptr) {
@@ -686,92 +892,52 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   }
   char* acc_data = acc_buf_ptr->get_acc_slice(out_data);
 
-  // Start by assuming that each thread handles a single output and all
-  // the inputs for that output.
-  int64_t num_outputs = iter.num_output_elements();
-  int64_t inputs_per_output = iter.numel() / num_outputs;
-  int input_index = iter.ntensors() - 1;
-
-  auto config = ReduceConfig(sizeof(arg_t), num_outputs, inputs_per_output);
-
-  int64_t dim0;
-  int64_t dim1;
-  // adjust block size to fit width to fast changing dimension
-  if (iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
-    dim0 = iter.shape()[0];
-    dim1 = num_outputs;
-  } else {
-    dim0 = iter.shape()[iter.num_reduce_dims()];
-    dim1 = inputs_per_output;
-  }
-
-  config.set_block_dimension(dim0, dim1);
-
-  int block_width = config.block_width;
-  int block_height = config.block_height;
+  auto launch = [&](const ReduceConfig& config) {
+    at::DataPtr buffer;
+    at::DataPtr semaphores;
+    if (config.should_global_reduce()) {
+      auto& allocator = *at::globalContext().getTHCState()->cudaDeviceAllocator;
+      buffer = allocator.allocate(config.global_memory_size());
+      semaphores = allocator.allocate(config.semaphore_size());
 
-  if (iter.ndim() == 0 || iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
-    // Split the input across lanes if the input is contiguous in the reduced
-    // dimension. This will require reduction between threads using warp
-    // shuffle instructions and shared memory (if block_width > warpSize).
-    config.input_mult[0] = config.split_input(block_width);
-  } else {
-    // Otherwise split the output across lanes in a warp.
-    config.output_mult[0] = config.split_output(block_width);
-  }
+      auto stream = at::cuda::getCurrentCUDAStream();
+      AT_CUDA_CHECK(cudaMemsetAsync(semaphores.get(), 0, config.semaphore_size(), stream));
+    }
 
-  if (config.values_per_thread() >= block_height * 16 || config.values_per_thread() >= 256) {
-    // Divide the input across warps in a thread-block, if that leaves at least
-    // 16 elements to be summed by each thread. This will require inter-warp
-    // reduction using shared memory.
-    config.input_mult[1] = config.split_input(block_height);
-  } else {
-    // Otherwise, each warp handles a separate output.
-    config.output_mult[1] = config.split_output(block_height);
-  }
+    AT_ASSERT(can_use_32bit_indexing);
+    auto output_calc = make_output_calculator<uint32_t>(iter);
+    auto input_calc = make_input_calculator<uint32_t>(iter);
+    auto reduce = ReduceOp<scalar_t, ops_t, uint32_t, out_scalar_t, vt0>(
+        ops,
+        config,
+        input_calc,
+        output_calc,
+        in_data,
+        out_data,
+        out_data_extra,
+        acc_data,
+        buffer.get(),
+        (int*)semaphores.get(),
+        ident,
+        noutputs);
+    reduce.accumulate = iter.should_accumulate();
+    reduce.final_output = iter.is_final_output();
+
+    launch_reduce_kernel<ReduceConfig::MAX_NUM_THREADS>(config, reduce);
+  };
 
-  if (config.input_mult[1] != 0 && config.values_per_thread() >= 256 && num_outputs <= 4096) {
-    // Divide the input across thread-blocks if the amount of work per-thread
-    // is large enough and the size of the output is small enough. This will
-    // require a reduction using global memory.
-    config.ctas_per_output = div_up(config.values_per_thread(), 16);
-    if (config.ctas_per_output > 65535) {
-      config.ctas_per_output = 65535;
+  // One cache per reduction op and dtype; see Note [Reduction autotuning]
+  static ReduceTuningCache tuning_cache;
+  int ctas_per_output = 0;
+  if (at::globalContext().benchmarkReductions()) {
+    auto params = getReduceParams<scalar_t>(iter);
+    if (!tuning_cache.find(params, &ctas_per_output) && !iter.should_accumulate()) {
+      ctas_per_output = tune_ctas_per_output<scalar_t, arg_t>(iter, launch);
+      tuning_cache.insert(params, ctas_per_output);
+      return;
     }
-    config.input_mult[2] = config.split_input(config.ctas_per_output);
   }
-
-  at::DataPtr buffer;
-  at::DataPtr semaphores;
-  if (config.should_global_reduce()) {
-    auto& allocator = *at::globalContext().getTHCState()->cudaDeviceAllocator;
-    buffer = allocator.allocate(config.global_memory_size());
-    semaphores = allocator.allocate(config.semaphore_size());
-
-    auto stream = at::cuda::getCurrentCUDAStream();
-    AT_CUDA_CHECK(cudaMemsetAsync(semaphores.get(), 0, config.semaphore_size(), stream));
-  }
-
-  AT_ASSERT(can_use_32bit_indexing);
-  auto output_calc = make_output_calculator<uint32_t>(iter);
-  auto input_calc = make_input_calculator<uint32_t>(iter);
-  auto reduce = ReduceOp<scalar_t, ops_t, uint32_t, out_scalar_t, vt0>(
-      ops,
-      config,
-      input_calc,
-      output_calc,
-      in_data,
-      out_data,
-      out_data_extra,
-      acc_data,
-      buffer.get(),
-      (int*)semaphores.get(),
-      ident,
-      noutputs);
-  reduce.accumulate = iter.should_accumulate();
-  reduce.final_output = iter.is_final_output();
-
-  launch_reduce_kernel<ReduceConfig::MAX_NUM_THREADS>(config, reduce);
+  launch(setReduceConfig<scalar_t, arg_t>(iter, ctas_per_output));
 }
 
 }} // namespace at::native
@@ -0,0 +1,140 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/native/ResizeCropNormalize.h>
+#include <ATen/native/cuda/UpSample.cuh>
+
+namespace at {
+namespace native {
+namespace {
+
+// One thread per output element, see ResizeCropNormalize.h.
+C10_LAUNCH_BOUNDS_1(1024)
+__global__ void resize_crop_normalize_out_frame(
+    const int64_t n,
+    const uint8_t* __restrict__ idata,
+    float* __restrict__ odata,
+    const float* __restrict__ mean,
+    const float* __restrict__ stddev,
+    const int input_height,
+    const int input_width,
+    const int channels,
+    const int output_height,
+    const int output_width,
+    const int crop_top,
+    const int crop_left,
+    const float rheight,
+    const float rwidth,
+    const bool align_corners,
+    const bool channels_last) {
+  const int64_t index = threadIdx.x + static_cast<int64_t>(blockIdx.x) * blockDim.x;
+  if (index >= n) {
+    return;
+  }
+
+  int64_t rest = index;
+  int c, w2, h2;
+  if (channels_last) {
+    c = rest % channels;
+    rest /= channels;
+    w2 = rest % output_width;
+    rest /= output_width;
+    h2 = rest % output_height;
+    rest /= output_height;
+  } else {
+    w2 = rest % output_width;
+    rest /= output_width;
+    h2 = rest % output_height;
+    rest /= output_height;
+    c = rest % channels;
+    rest /= channels;
+  }
+  const int64_t b = rest;
+
+  const float h1r = area_pixel_compute_source_index<float>(
+      rheight, h2 + crop_top, align_corners, /*cubic=*/false);
+  const int h1 = h1r;
+  const int h1p = (h1 < input_height - 1) ? 1 : 0;
+  const float h1lambda = h1r - h1;
+  const float h0lambda = 1.f - h1lambda;
+
+  const float w1r = area_pixel_compute_source_index<float>(
+      rwidth, w2 + crop_left, align_corners, /*cubic=*/false);
+  const int w1 = w1r;
+  const int w1p = (w1 < input_width - 1) ? 1 : 0;
+  const float w1lambda = w1r - w1;
+  const float w0lambda = 1.f - w1lambda;
+
+  const uint8_t* row0 =
+      idata + ((b * input_height + h1) * input_width + w1) * channels + c;
+  const uint8_t* row1 = row0 + h1p * input_width * channels;
+  const int wstep = w1p * channels;
+  const float val = h0lambda * (w0lambda * row0[0] + w1lambda * row0[wstep]) +
+      h1lambda * (w0lambda * row1[0] + w1lambda * row1[wstep]);
+  odata[index] = (val - mean[c]) / stddev[c];
+}
+
+} // namespace
+
+Tensor resize_crop_normalize_cuda(
+    const Tensor& self,
+    IntArrayRef size,
+    IntArrayRef crop,
+    const Tensor& mean,
+    const Tensor& stddev,
+    bool align_corners,
+    bool channels_last) {
+  resize_crop_normalize_check(self, size, crop, mean, stddev);
+
+  Tensor input = self.contiguous();
+  Tensor mean_ = mean.to(kFloat).contiguous();
+  Tensor stddev_ = stddev.to(kFloat).contiguous();
+
+  const int nbatch = input.size(0);
+  const int input_height = input.size(1);
+  const int input_width = input.size(2);
+  const int channels = input.size(3);
+  const int output_height = crop[2];
+  const int output_width = crop[3];
+  Tensor output = channels_last
+      ? at::empty({nbatch, output_height, output_width, channels}, input.options().dtype(kFloat))
+      : at::empty({nbatch, channels, output_height, output_width}, input.options().dtype(kFloat));
+
+  const float rheight = area_pixel_compute_scale<float>(
+      input_height, size[0], align_corners);
+  const float rwidth = area_pixel_compute_scale<float>(
+      input_width, size[1], align_corners);
+
+  const int64_t num_kernels = output.numel();
+  const int num_threads = std::min(
+      at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock, 1024);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+  resize_crop_normalize_out_frame
+      <<<cuda::ATenCeilDiv(num_kernels, static_cast<int64_t>(num_threads)),
+         num_threads,
+         0,
+         stream>>>(
+          num_kernels,
+          input.data<uint8_t>(),
+          output.data<float>(),
+          mean_.data<float>(),
+          stddev_.data<float>(),
+          input_height,
+          input_width,
+          channels,
+          output_height,
+          output_width,
+          crop[0],
+          crop[1],
+          rheight,
+          rwidth,
+          align_corners,
+          channels_last);
+  AT_CUDA_CHECK(cudaGetLastError());
+  return output;
+}
+
+} // namespace native
+} // namespace at
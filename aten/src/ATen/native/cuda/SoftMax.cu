@@ -314,6 +314,43 @@ struct SumExpFloat
   const AccumT max_k;
 };
 
+// The max of (a part of) a row and the sum of the exponentials of its elements
+// minus that max. Both are computed in a single pass over the row: the sum so
+// far is rescaled whenever a larger max is found.
+template <typename AccumT>
+struct MaxSum
+{
+  AccumT max;
+  AccumT sum;
+};
+
+template <typename AccumT>
+__device__ __forceinline__ MaxSum<AccumT> initMaxSum()
+{
+  return {-at::numeric_limits<AccumT>::max(), static_cast<AccumT>(0)};
+}
+
+template<typename T, typename MaxSumT>
+struct MaxSumExpFloat
+{
+  __device__ __forceinline__ MaxSumT operator()(MaxSumT ms, T v) const {
+    const auto x = static_cast<decltype(ms.max)>(v);
+    if (x > ms.max) {
+      return {x, ms.sum * std::exp(ms.max - x) + 1};
+    }
+    return {ms.max, ms.sum + std::exp(x - ms.max)};
+  }
+};
+
+template<typename MaxSumT>
+struct CombineMaxSum
+{
+  __device__ __forceinline__ MaxSumT operator()(MaxSumT a, MaxSumT b) const {
+    const auto max = ::max(a.max, b.max);
+    return {max, a.sum * std::exp(a.max - max) + b.sum * std::exp(b.max - max)};
+  }
+};
+
 template <template<typename> class Reduction, typename AccumT>
 __device__ __forceinline__ AccumT
 blockReduce(AccumT* smem, AccumT val,
@@ -394,33 +431,14 @@ ilpReduce(T* data,
   return threadVal;
 }
 
-template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
-__global__ void
-cunn_SoftMaxForward(outscalar_t *output, scalar_t *input, int classes)
+// Writes epilogue(input[i]) to output[i] for the `size` elements of a row
+template <int ILP, typename scalar_t, typename outscalar_t, typename Epilogue>
+__device__ __forceinline__ void
+applyEpilogue(outscalar_t *output, const scalar_t *input, int size, const Epilogue& epilogue)
 {
-  extern __shared__ unsigned char smem[];
-  auto sdata = reinterpret_cast<accscalar_t*>(smem);
-  // forward pointers to batch[blockIdx.x]
-  // each block handles a sample in the mini-batch
-  input += blockIdx.x * classes;
-  output += blockIdx.x * classes;
-
-  // find the max
-  accscalar_t threadMax = ilpReduce<MaxFloat, ILP, scalar_t, accscalar_t>(
-      input, classes, MaxFloat<scalar_t, accscalar_t>(), -at::numeric_limits<accscalar_t>::max());
-  accscalar_t max_k = blockReduce<Max, accscalar_t>(
-      sdata, threadMax, Max<accscalar_t>(), -at::numeric_limits<accscalar_t>::max());
-
-  // reduce all values
-  accscalar_t threadExp = ilpReduce<SumExpFloat, ILP, scalar_t, accscalar_t>(
-      input, classes, SumExpFloat<scalar_t, accscalar_t>(max_k), static_cast<accscalar_t>(0));
-  accscalar_t sumAll = blockReduce<Add, accscalar_t>(
-      sdata, threadExp, Add<accscalar_t>(), static_cast<accscalar_t>(0));
-
-  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(max_k, sumAll);
   int offset = threadIdx.x;
-  int last = classes % (ILP * blockDim.x);
-  for (; offset < classes - last; offset += blockDim.x * ILP) {
+  int last = size % (ILP * blockDim.x);
+  for (; offset < size - last; offset += blockDim.x * ILP) {
     scalar_t tmp[ILP];
 
 #pragma unroll
@@ -432,10 +450,32 @@ cunn_SoftMaxForward(outscalar_t *output, scalar_t *input, int classes)
       output[offset + j * blockDim.x] = epilogue(tmp[j]);
   }
 
-  for (; offset < classes; offset += blockDim.x)
+  for (; offset < size; offset += blockDim.x)
     output[offset] = epilogue(input[offset]);
 }
 
+template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
+__global__ void
+cunn_SoftMaxForward(outscalar_t *output, scalar_t *input, int classes)
+{
+  using maxsum_t = MaxSum<accscalar_t>;
+  extern __shared__ unsigned char smem[];
+  auto sdata = reinterpret_cast<maxsum_t*>(smem);
+  // forward pointers to batch[blockIdx.x]
+  // each block handles a sample in the mini-batch
+  input += blockIdx.x * classes;
+  output += blockIdx.x * classes;
+
+  // find the max and the sum of the exponentials in one pass
+  maxsum_t threadMaxSum = ilpReduce<MaxSumExpFloat, ILP, scalar_t, maxsum_t>(
+      input, classes, MaxSumExpFloat<scalar_t, maxsum_t>(), initMaxSum<accscalar_t>());
+  maxsum_t maxSum = blockReduce<CombineMaxSum, maxsum_t>(
+      sdata, threadMaxSum, CombineMaxSum<maxsum_t>(), initMaxSum<accscalar_t>());
+
+  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(maxSum.max, maxSum.sum);
+  applyEpilogue<ILP>(output, input, classes, epilogue);
+}
+
 template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template<typename, typename, typename> class Epilogue>
 __global__ void
 cunn_SoftMaxBackward(scalar_t *gradInput, outscalar_t *output, outscalar_t *gradOutput, int classes)
@@ -478,6 +518,98 @@ cunn_SoftMaxBackward(scalar_t *gradInput, outscalar_t *output, outscalar_t *grad
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Split kernels (fast when dim_size is large and outer_size is small; requires
+// inner_size == 1)
+////////////////////////////////////////////////////////////////////////////////
+// A block per row leaves most of the GPU idle when there are only a few rows,
+// so each row is instead cut into gridDim.x slices of slice_size elements, and
+// the blocks of the 2d grid compute the slices (along x) of the rows (along
+// y). The first kernel writes the MaxSum of each slice, and the second one
+// combines the MaxSums of its row before writing its slice of the output.
+
+template <int ILP, typename scalar_t, typename accscalar_t>
+__global__ void
+cunn_SoftMaxForwardSplitMaxSum(MaxSum<accscalar_t> *partials, scalar_t *input, int classes, int slice_size)
+{
+  using maxsum_t = MaxSum<accscalar_t>;
+  extern __shared__ unsigned char smem[];
+  auto sdata = reinterpret_cast<maxsum_t*>(smem);
+  const int begin = blockIdx.x * slice_size;
+  input += static_cast<int64_t>(blockIdx.y) * classes + begin;
+
+  maxsum_t threadMaxSum = ilpReduce<MaxSumExpFloat, ILP, scalar_t, maxsum_t>(
+      input, ::min(slice_size, classes - begin), MaxSumExpFloat<scalar_t, maxsum_t>(),
+      initMaxSum<accscalar_t>());
+  maxsum_t maxSum = blockReduce<CombineMaxSum, maxsum_t>(
+      sdata, threadMaxSum, CombineMaxSum<maxsum_t>(), initMaxSum<accscalar_t>());
+  if (threadIdx.x == 0) {
+    partials[blockIdx.y * gridDim.x + blockIdx.x] = maxSum;
+  }
+}
+
+template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
+__global__ void
+cunn_SoftMaxForwardSplitEpilogue(outscalar_t *output, scalar_t *input, const MaxSum<accscalar_t> *partials, int classes, int slice_size)
+{
+  using maxsum_t = MaxSum<accscalar_t>;
+  extern __shared__ unsigned char smem[];
+  auto sdata = reinterpret_cast<maxsum_t*>(smem);
+  const int begin = blockIdx.x * slice_size;
+  input += static_cast<int64_t>(blockIdx.y) * classes + begin;
+  output += static_cast<int64_t>(blockIdx.y) * classes + begin;
+  partials += blockIdx.y * gridDim.x;
+
+  maxsum_t threadMaxSum = initMaxSum<accscalar_t>();
+  for (int i = threadIdx.x; i < gridDim.x; i += blockDim.x) {
+    threadMaxSum = CombineMaxSum<maxsum_t>()(threadMaxSum, partials[i]);
+  }
+  maxsum_t maxSum = blockReduce<CombineMaxSum, maxsum_t>(
+      sdata, threadMaxSum, CombineMaxSum<maxsum_t>(), initMaxSum<accscalar_t>());
+
+  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(maxSum.max, maxSum.sum);
+  applyEpilogue<ILP>(output, input, ::min(slice_size, classes - begin), epilogue);
+}
+
+// Rows with fewer elements than this are never split
+const int64_t split_min_slice_size = 8192;
+
+// The number of slices each row should be split into: enough for the blocks of
+// all the rows to fill the GPU, but 1 (no split) when the rows do already.
+inline int64_t SoftMax_getSplits(dim3 block, int64_t outer_size, int64_t dim_size) {
+  const auto props = at::cuda::getCurrentDeviceProperties();
+  const int64_t max_active_blocks =
+      props->multiProcessorCount * (props->maxThreadsPerMultiProcessor / block.x);
+  if (outer_size >= max_active_blocks) {
+    return 1;
+  }
+  const int64_t splits = std::min(
+      (max_active_blocks + outer_size - 1) / outer_size,
+      dim_size / split_min_slice_size);
+  return std::max<int64_t>(splits, 1);
+}
+
+template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
+void launch_softmax_forward_split(
+    outscalar_t *output, scalar_t *input, int64_t outer_size, int64_t dim_size,
+    dim3 block, int64_t splits, const TensorOptions& options, cudaStream_t stream) {
+  using maxsum_t = MaxSum<accscalar_t>;
+  const int64_t slice_size = (dim_size + splits - 1) / splits;
+  // Rounding the slices up can leave the last ones empty
+  splits = (dim_size + slice_size - 1) / slice_size;
+  auto partials = at::empty(
+      {static_cast<int64_t>(outer_size * splits * sizeof(maxsum_t))},
+      options.dtype(at::kByte));
+  auto partials_data = reinterpret_cast<maxsum_t*>(partials.data_ptr());
+  dim3 grid(splits, outer_size);
+  cunn_SoftMaxForwardSplitMaxSum<ILP, scalar_t, accscalar_t>
+    <<<grid, block, block.x * sizeof(maxsum_t), stream>>>(
+      partials_data, input, dim_size, slice_size);
+  cunn_SoftMaxForwardSplitEpilogue<ILP, scalar_t, accscalar_t, outscalar_t, Epilogue>
+    <<<grid, block, block.x * sizeof(maxsum_t), stream>>>(
+      output, input, partials_data, dim_size, slice_size);
+}
+
 template<template<typename, typename, typename> class Epilogue>
 Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_to_float){
   if (half_to_float) AT_ASSERTM(input_.scalar_type() == ScalarType::Half,"conversion is supported for Half type only");
@@ -503,16 +635,28 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
       const int ILP = 2;
       dim3 grid(outer_size);
       dim3 block = SoftMax_getBlockSize(ILP, dim_size);
+      // When there are too few rows to fill the GPU, they are split
+      const int64_t splits = SoftMax_getSplits(block, outer_size, dim_size);
       AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "host_softmax", [&] {
       using accscalar_t = acc_type<scalar_t, true>;
-      if (!half_to_float) {
+      if (splits > 1) {
+        if (!half_to_float) {
+          launch_softmax_forward_split<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>(
+              output.data<scalar_t>(), input.data<scalar_t>(), outer_size, dim_size,
+              block, splits, input.options(), stream);
+        } else {
+          launch_softmax_forward_split<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>(
+              output.data<accscalar_t>(), input.data<scalar_t>(), outer_size, dim_size,
+              block, splits, input.options(), stream);
+        }
+      } else if (!half_to_float) {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+            <<<grid, block, block.x * sizeof(MaxSum<accscalar_t>), stream>>>(
               output.data<scalar_t>(), input.data<scalar_t>(), dim_size
           );
       } else {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+            <<<grid, block, block.x * sizeof(MaxSum<accscalar_t>), stream>>>(
               output.data<accscalar_t>(), input.data<scalar_t>(), dim_size
           );
       }
@@ -317,6 +317,48 @@ void cufft_clear_plan_cache_impl(int64_t device_index) {
   return cufft_get_plan_cache(device_index).clear();
 }
 
+int64_t cufft_get_plan_cache_max_workspace_size_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_max_workspace_size: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  return cufft_get_plan_cache(device_index).max_workspace_size();
+}
+
+void cufft_set_plan_cache_max_workspace_size_impl(int64_t device_index, int64_t max_workspace_size) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_set_plan_cache_max_workspace_size: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  CuFFTParamsLRUCache& plan_cache = cufft_get_plan_cache(device_index);
+  std::lock_guard<std::mutex> guard(plan_cache.mutex);
+  plan_cache.set_max_workspace_size(max_workspace_size);
+}
+
+int64_t cufft_get_plan_cache_workspace_size_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_workspace_size: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  return cufft_get_plan_cache(device_index).workspace_size();
+}
+
+int64_t cufft_get_plan_cache_hits_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_hits: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  return cufft_get_plan_cache(device_index).hits();
+}
+
+int64_t cufft_get_plan_cache_misses_impl(int64_t device_index) {
+  TORCH_CHECK(0 <= device_index && device_index < at::detail::getCUDAHooks().getNumGPUs(),
+    "cufft_get_plan_cache_misses: expected 0 <= device_index < ",
+    at::detail::getCUDAHooks().getNumGPUs(), "], but got device_index=",
+    device_index);
+  return cufft_get_plan_cache(device_index).misses();
+}
+
 } // namespace at::native::detail
 
 // cuFFT
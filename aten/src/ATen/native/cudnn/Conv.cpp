@@ -84,11 +84,16 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
 
 #include <functional>
+#include <fstream>
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
@@ -367,6 +372,138 @@ BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// Note [persistent cudnn benchmark cache]
+// With cudnn.benchmark=True every new process re-runs cudnnFind* for every
+// convolution shape it sees, which for large models can take tens of seconds.
+// If TORCH_CUDNN_BENCHMARK_CACHE_DIR is set, the results of benchmarking are
+// additionally appended to a file in that directory, and the file is loaded
+// into the in-memory caches above the first time a convolution is run.
+//
+// The file is keyed by the device name and the cuDNN version (both are part of
+// the file name, and are checked again in the header), so that a directory can
+// be shared between heterogeneous machines.  Records are the raw bytes of
+// ConvolutionParams and the perf struct, which is OK because both are POD and
+// their layout is fixed for a given cuDNN version.  Truncated or corrupted
+// files are ignored from the first bad record onwards.
+//
+// NB: the in-memory caches are not keyed by device, so only the file for the
+// device that runs the first convolution of the process is loaded; results
+// from other devices are still written to their own files.
+
+enum class PersistentAlgoKind : uint8_t { Fwd = 0, BwdData = 1, BwdFilter = 2 };
+
+constexpr uint32_t kPersistentCacheMagic = 0x4e444355; // "UCDN"
+
+struct PersistentCacheHeader {
+  uint32_t magic;
+  uint32_t cudnn_version;
+  uint32_t params_size;
+  char device_name[256];
+};
+
+static const char* persistentCacheDir() {
+  static const char* dir = std::getenv("TORCH_CUDNN_BENCHMARK_CACHE_DIR");
+  return dir;
+}
+
+static PersistentCacheHeader persistentCacheHeader() {
+  PersistentCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kPersistentCacheMagic;
+  header.cudnn_version = static_cast<uint32_t>(CUDNN_VERSION);
+  header.params_size = static_cast<uint32_t>(sizeof(ConvolutionParams));
+  strncpy(header.device_name, at::cuda::getCurrentDeviceProperties()->name,
+          sizeof(header.device_name) - 1);
+  return header;
+}
+
+static std::string persistentCachePath(const PersistentCacheHeader& header) {
+  std::string name = header.device_name;
+  for (auto& c : name) {
+    if (!isalnum(static_cast<unsigned char>(c))) {
+      c = '_';
+    }
+  }
+  std::ostringstream ss;
+  ss << persistentCacheDir() << "/cudnn_conv_algos_" << name << "_" << header.cudnn_version << ".bin";
+  return ss.str();
+}
+
+template <typename perf_t>
+static bool readPersistentRecord(std::istream& in, BenchmarkCache<perf_t>& cache) {
+  ConvolutionParams params;
+  perf_t perf;
+  if (!in.read(reinterpret_cast<char*>(&params), sizeof(params)) ||
+      !in.read(reinterpret_cast<char*>(&perf), sizeof(perf))) {
+    return false;
+  }
+  cache.insert(params, perf);
+  return true;
+}
+
+static std::mutex persistent_cache_mutex;
+
+static void loadPersistentCache() {
+  static std::once_flag once;
+  std::call_once(once, [] {
+    if (!persistentCacheDir()) {
+      return;
+    }
+    auto expected = persistentCacheHeader();
+    std::ifstream in(persistentCachePath(expected), std::ios::binary);
+    if (!in) {
+      return;
+    }
+    PersistentCacheHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(&header, &expected, sizeof(header)) != 0) {
+      return;
+    }
+    uint8_t kind;
+    while (in.read(reinterpret_cast<char*>(&kind), sizeof(kind))) {
+      bool ok = false;
+      switch (static_cast<PersistentAlgoKind>(kind)) {
+        case PersistentAlgoKind::Fwd:
+          ok = readPersistentRecord(in, fwd_algos);
+          break;
+        case PersistentAlgoKind::BwdData:
+          ok = readPersistentRecord(in, bwd_data_algos);
+          break;
+        case PersistentAlgoKind::BwdFilter:
+          ok = readPersistentRecord(in, bwd_filter_algos);
+          break;
+      }
+      if (!ok) {
+        break;
+      }
+    }
+  });
+}
+
+template <typename perf_t>
+static void storePersistentRecord(PersistentAlgoKind kind, const ConvolutionParams& params, const perf_t& perf) {
+  if (!persistentCacheDir()) {
+    return;
+  }
+  auto header = persistentCacheHeader();
+  auto path = persistentCachePath(header);
+
+  std::lock_guard<std::mutex> guard(persistent_cache_mutex);
+  bool exists = static_cast<bool>(std::ifstream(path, std::ios::binary));
+  std::ofstream out(path, std::ios::binary | std::ios::app);
+  if (!out) {
+    // The cache is an optimization only; failing to write it is not an error.
+    return;
+  }
+  if (!exists) {
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  auto k = static_cast<uint8_t>(kind);
+  out.write(reinterpret_cast<const char*>(&k), sizeof(k));
+  out.write(reinterpret_cast<const char*>(&params), sizeof(params));
+  out.write(reinterpret_cast<const char*>(&perf), sizeof(perf));
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
@@ -508,6 +645,7 @@ struct algorithm_search<cudnnConvolutionFwdAlgoPerf_t> {
 
   static constexpr auto DEFAULT_ALGO = CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_PRECOMP_GEMM;
   static BenchmarkCache<perf_t>& cache() { return fwd_algos; }
+  static constexpr auto PERSISTENT_KIND = PersistentAlgoKind::Fwd;
 
   static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
     static const algo_t algos[] = {
@@ -575,6 +713,7 @@ struct algorithm_search<cudnnConvolutionBwdDataAlgoPerf_t> {
 
   static constexpr auto DEFAULT_ALGO = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
   static BenchmarkCache<perf_t>& cache() { return bwd_data_algos; }
+  static constexpr auto PERSISTENT_KIND = PersistentAlgoKind::BwdData;
 
   static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
     static const algo_t algos[] = {
@@ -641,6 +780,7 @@ struct algorithm_search<cudnnConvolutionBwdFilterAlgoPerf_t> {
   static constexpr auto DEFAULT_ALGO = CUDNN_CONVOLUTION_BWD_FILTER_ALGO_1;
 
   static BenchmarkCache<perf_t>& cache() { return bwd_filter_algos; }
+  static constexpr auto PERSISTENT_KIND = PersistentAlgoKind::BwdFilter;
 
   static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
     static const algo_t algos[] = {
@@ -703,6 +843,9 @@ void findAlgorithm(const ConvolutionArgs& args, bool benchmark, perf_t* algoPerf
   using search = algorithm_search<perf_t>;
   auto& cache = search::cache();
 
+  // See Note [persistent cudnn benchmark cache]
+  loadPersistentCache();
+
   if (cache.find(args.params, algoPerf)) {
     return;
   }
@@ -734,6 +877,7 @@ void findAlgorithm(const ConvolutionArgs& args, bool benchmark, perf_t* algoPerf
       // if benchmarking, map the original params with the found algo+math type for re-use
       if (benchmark) {
         cache.insert(args.params, perfResults);
+        storePersistentRecord(search::PERSISTENT_KIND, args.params, perfResults);
 
         // Free the cached blocks in our caching allocator. They are
         // needed here because the above benchmarking uses a huge amount of memory,
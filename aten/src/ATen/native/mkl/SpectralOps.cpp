@@ -15,6 +15,30 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
   AT_ERROR("fft: ATen not compiled with MKL support");
 }
 
+int64_t _mkl_fft_get_plan_cache_size() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+void _mkl_fft_clear_plan_cache() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+int64_t _mkl_fft_get_plan_cache_hits() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
+int64_t _mkl_fft_get_plan_cache_misses() {
+  AT_ERROR("fft: ATen not compiled with MKL support");
+}
+
 }}
 
 #else // AT_MKL_ENABLED
@@ -25,11 +49,17 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
+#include <ATen/native/utils/ParamsHash.h>
 
 #include <algorithm>
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include <mkl_dfti.h>
 #include <ATen/mkl/Exceptions.h>
@@ -39,6 +69,9 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
 
 namespace at { namespace native {
 
+// signal_ndim of torch.fft and friends is at most 3
+constexpr int kMaxFFTRank = 3;
+
 // In real-to-complex transform, MKL FFT only fills half of the values due to
 // conjugate symmetry. See native/SpectralUtils.h for more details.
 // The following structs are used to fill in the other half with symmetry in
@@ -144,13 +177,221 @@ static inline void _fft_fill_with_conjugate_symmetry_(Tensor& input,
   });
 }
 
+// Note [MKL FFT plan cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// Creating and committing a DFTI descriptor costs far more than running it on
+// the small signals of e.g. audio processing, so committed descriptors are
+// kept in a process-wide LRU cache keyed by everything they are configured
+// with, like the cuFFT plans in native/cuda/CuFFTPlanCache.h.  Committed
+// descriptors may be used by several threads at once, and are handed out as
+// shared_ptr so that a plan evicted by another thread stays valid until the
+// current transform finishes.
+
+// The **key** to the plan cache.
+struct MKLFFTParams {
+  ScalarType scalar_type;
+  int64_t signal_sizes[kMaxFFTRank];
+  // batch dim (distance between signals) followed by signal dims
+  int64_t input_strides[kMaxFFTRank + 1];
+  int64_t output_strides[kMaxFFTRank + 1];
+  int64_t num_transforms;
+  uint8_t signal_ndim;
+  bool complex_input;
+  bool complex_output;
+  bool inverse;
+  bool normalized;
+  bool single_threaded;
+};
+
+// default capacity, chosen to cover the few shapes a pipeline typically uses
+constexpr int64_t kDefaultMKLFFTPlanCacheSize = 64;
+
+class MKLFFTPlanCache {
+ public:
+  using Plan = std::shared_ptr<DftiDescriptor>;
+
+  template <typename F>
+  Plan get_or_create(const MKLFFTParams& key, const F& create) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = map_.find(key);
+      if (it != map_.end()) {
+        hits_++;
+        usage_list_.splice(usage_list_.begin(), usage_list_, it->second);
+        return it->second->second;
+      }
+      misses_++;
+    }
+    // committing may take a while, so do it without holding the lock
+    Plan plan = create();
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (max_size_ == 0 || map_.count(key)) {
+      return plan;
+    }
+    if (static_cast<int64_t>(usage_list_.size()) >= max_size_) {
+      pop_back();
+    }
+    usage_list_.emplace_front(key, plan);
+    map_.emplace(std::cref(usage_list_.front().first), usage_list_.begin());
+    return plan;
+  }
+
+  int64_t size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return map_.size();
+  }
+
+  int64_t max_size() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return max_size_;
+  }
+
+  void set_max_size(int64_t max_size) {
+    TORCH_CHECK(max_size >= 0,
+             "MKL FFT plan cache size must be non-negative, but got ", max_size);
+    std::lock_guard<std::mutex> guard(mutex_);
+    max_size_ = max_size;
+    while (static_cast<int64_t>(usage_list_.size()) > max_size_) {
+      pop_back();
+    }
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    map_.clear();
+    usage_list_.clear();
+  }
+
+  int64_t hits() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return hits_;
+  }
+
+  int64_t misses() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return misses_;
+  }
+
+ private:
+  void pop_back() {
+    map_.erase(usage_list_.back().first);
+    usage_list_.pop_back();
+  }
+
+  using kv_t = std::pair<MKLFFTParams, Plan>;
+  std::mutex mutex_;
+  std::list<kv_t> usage_list_;
+  std::unordered_map<std::reference_wrapper<const MKLFFTParams>,
+                     std::list<kv_t>::iterator,
+                     ParamsHash<MKLFFTParams>,
+                     ParamsEqual<MKLFFTParams>> map_;
+  int64_t max_size_ = kDefaultMKLFFTPlanCacheSize;
+  int64_t hits_ = 0;
+  int64_t misses_ = 0;
+};
+
+static MKLFFTPlanCache& plan_cache() {
+  static MKLFFTPlanCache cache;
+  return cache;
+}
+
+static std::shared_ptr<DftiDescriptor> create_descriptor(const MKLFFTParams& params) {
+  // precision
+  DFTI_CONFIG_VALUE prec = params.scalar_type == ScalarType::Double ? DFTI_DOUBLE : DFTI_SINGLE;
+  // signal type
+  DFTI_CONFIG_VALUE signal_type;
+  if (!params.inverse) {
+    signal_type = params.complex_input ? DFTI_COMPLEX : DFTI_REAL;
+  } else {
+    signal_type = params.complex_output ? DFTI_COMPLEX : DFTI_REAL;
+  }
+  int64_t signal_ndim = params.signal_ndim;
+  // create descriptor with signal size
+  std::vector<MKL_LONG> mkl_signal_sizes(params.signal_sizes, params.signal_sizes + signal_ndim);
+  auto descriptor = std::make_shared<DftiDescriptor>();
+  descriptor->init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
+  // out of place FFT
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+  // batch mode
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_NUMBER_OF_TRANSFORMS,
+                              static_cast<MKL_LONG>(params.num_transforms)));
+  // batch dim stride, i.e., dist between each data
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_DISTANCE,
+                              static_cast<MKL_LONG>(params.input_strides[0])));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_DISTANCE,
+                              static_cast<MKL_LONG>(params.output_strides[0])));
+  // signal strides
+  // first val is offset, set to zero (ignored)
+  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
+  for (int64_t i = 1; i <= signal_ndim; i++) {
+    mkl_istrides[i] = params.input_strides[i];
+    mkl_ostrides[i] = params.output_strides[i];
+  }
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
+  // if conjugate domain of real is involved, set standard CCE storage type
+  // this will become default in MKL in future
+  if (!params.complex_input || !params.complex_output) {
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+  }
+  // rescale if needed by normalized flag or inverse transform
+  if (params.normalized || params.inverse) {
+    int64_t signal_numel = 1;
+    for (int64_t i = 0; i < signal_ndim; i++) {
+      signal_numel *= params.signal_sizes[i];
+    }
+    double double_scale;
+    if (params.normalized) {
+      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+    } else {
+      double_scale = 1.0 / static_cast<double>(signal_numel);
+    }
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(),
+      params.inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
+      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+  }
+  if (params.single_threaded) {
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_THREAD_LIMIT, 1));
+  }
+  // finalize
+  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor->get()));
+  return descriptor;
+}
+
+static std::shared_ptr<DftiDescriptor> get_descriptor(const MKLFFTParams& params) {
+  return plan_cache().get_or_create(params, [&]() { return create_descriptor(params); });
+}
+
+int64_t _mkl_fft_get_plan_cache_size() {
+  return plan_cache().size();
+}
+
+int64_t _mkl_fft_get_plan_cache_max_size() {
+  return plan_cache().max_size();
+}
+
+void _mkl_fft_set_plan_cache_max_size(int64_t max_size) {
+  plan_cache().set_max_size(max_size);
+}
+
+void _mkl_fft_clear_plan_cache() {
+  plan_cache().clear();
+}
+
+int64_t _mkl_fft_get_plan_cache_hits() {
+  return plan_cache().hits();
+}
+
+int64_t _mkl_fft_get_plan_cache_misses() {
+  return plan_cache().misses();
+}
+
 // MKL DFTI
 Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
                 bool complex_input, bool complex_output,
                 bool inverse, IntArrayRef checked_signal_sizes,
                 bool normalized, bool onesided,
                 IntArrayRef output_sizes) {
-  int64_t batch = self.size(0);
   Tensor input = self;
   // real/imag dimension must aligned when viewed as of complex type
   if (complex_input) {
@@ -194,75 +435,55 @@ Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
   }
   Tensor output = at::empty(output_sizes, input.options());
 
-  // precision
-  DFTI_CONFIG_VALUE prec;
-  if (input.scalar_type() == ScalarType::Float) {
-    prec = DFTI_SINGLE;
-  } else if (input.scalar_type() == ScalarType::Double) {
-    prec = DFTI_DOUBLE;
-  } else {
-    std::ostringstream ss;
-    ss << "MKL FFT doesn't support tensor of type: "
-       << toString(input.scalar_type());
-    AT_ERROR(ss.str());
-  }
-  // signal type
-  DFTI_CONFIG_VALUE signal_type;
-  if (!inverse) {
-    signal_type = complex_input ? DFTI_COMPLEX : DFTI_REAL;
-  } else {
-    signal_type = complex_output ? DFTI_COMPLEX : DFTI_REAL;
-  }
-  // create descriptor with signal size
-  std::vector<MKL_LONG> mkl_signal_sizes(checked_signal_sizes.begin(), checked_signal_sizes.end());
-  DftiDescriptor descriptor;
-  descriptor.init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
-  // out of place FFT
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
-  // batch mode
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_NUMBER_OF_TRANSFORMS, batch));
+  TORCH_CHECK(input.scalar_type() == ScalarType::Float ||
+              input.scalar_type() == ScalarType::Double,
+              "MKL FFT doesn't support tensor of type: ", toString(input.scalar_type()));
 
+  MKLFFTParams params;
+  memset(&params, 0, sizeof(MKLFFTParams));
+  params.scalar_type = input.scalar_type();
+  params.signal_ndim = static_cast<uint8_t>(signal_ndim);
+  params.complex_input = complex_input;
+  params.complex_output = complex_output;
+  params.inverse = inverse;
+  params.normalized = normalized;
   auto istrides = input.strides();
   auto ostrides = output.strides();
-  // batch dim stride, i.e., dist between each data
-  MKL_LONG idist = complex_input ? istrides[0] >> 1 : istrides[0];
-  MKL_LONG odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_DISTANCE, idist));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_DISTANCE, odist));
-  // signal strides
-  // first val is offset, set to zero (ignored)
-  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
-  for (int64_t i = 1; i <= signal_ndim; i++) {
-    mkl_istrides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
-    mkl_ostrides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
+  // strides of the batch dim (i.e., the distance between signals) and of the
+  // signal dims, in units of the complex type where applicable
+  for (int64_t i = 0; i <= signal_ndim; i++) {
+    params.input_strides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
+    params.output_strides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
   }
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
-  // if conjugate domain of real is involved, set standard CCE storage type
-  // this will become default in MKL in future
-  if (!complex_input || !complex_output) {
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+  for (int64_t i = 0; i < signal_ndim; i++) {
+    params.signal_sizes[i] = checked_signal_sizes[i];
   }
-  // rescale if needed by normalized flag or inverse transform
-  if (normalized || inverse) {
-    auto signal_numel = at::prod_intlist(checked_signal_sizes);
-    double double_scale;
-    if (normalized) {
-      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+
+  auto run = [&](int64_t begin, int64_t end) {
+    MKLFFTParams part_params = params;
+    part_params.num_transforms = end - begin;
+    auto descriptor = get_descriptor(part_params);
+    char* input_ptr = static_cast<char*>(input.data_ptr()) +
+        begin * istrides[0] * input.element_size();
+    char* output_ptr = static_cast<char*>(output.data_ptr()) +
+        begin * ostrides[0] * output.element_size();
+    if (!inverse) {
+      MKL_DFTI_CHECK(DftiComputeForward(descriptor->get(), input_ptr, output_ptr));
     } else {
-      double_scale = 1.0 / static_cast<double>(signal_numel);
+      MKL_DFTI_CHECK(DftiComputeBackward(descriptor->get(), input_ptr, output_ptr));
     }
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(),
-      inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
-      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
-  }
-  // finalize
-  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor.get()));
-  // run
-  if (!inverse) {
-    MKL_DFTI_CHECK(DftiComputeForward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+  };
+
+  // With at least one signal per thread, run single threaded transforms on
+  // parts of the batch in parallel rather than letting MKL split every
+  // (possibly small) signal over the threads.
+  int64_t batch = input.size(0);
+  if (!at::in_parallel_region() && at::get_num_threads() > 1 &&
+      batch >= at::get_num_threads()) {
+    params.single_threaded = true;
+    at::parallel_for(0, batch, 1, run);
   } else {
-    MKL_DFTI_CHECK(DftiComputeBackward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+    run(0, batch);
   }
   // now if needed, fill out the other half using Hermitian symmetry dim
   if (!complex_input && complex_output && !onesided) {
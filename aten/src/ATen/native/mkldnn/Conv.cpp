@@ -12,6 +12,13 @@ at::Tensor mkldnn_convolution(
   AT_ERROR("mkldnn_convolution_forward: ATen not compiled with MKLDNN support");
 }
 
+at::Tensor mkldnn_convolution_fused(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias,
+    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups,
+    const at::Tensor& sum, bool relu) {
+  AT_ERROR("mkldnn_convolution_fused: ATen not compiled with MKLDNN support");
+}
+
 at::Tensor mkldnn_convolution_backward_input(
     IntArrayRef input_size, const at::Tensor& grad_output, const at::Tensor& weight,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined) {
@@ -57,6 +64,8 @@ inline ideep::tensor get_mkldnn_tensor(const at::Tensor& tensor) {
 
 namespace at { namespace native {
 
+// With a sum post-op in attr, y must be initialized with the tensor the
+// convolution is added to.
 ideep::tensor _mkldnn_conv2d(
     const ideep::tensor& x,
     const ideep::tensor& w,
@@ -64,7 +73,9 @@ ideep::tensor _mkldnn_conv2d(
     at::IntArrayRef padding,
     at::IntArrayRef stride,
     at::IntArrayRef dilation,
-    int64_t groups) {
+    int64_t groups,
+    const ideep::descriptor_group::attr_t& attr = {},
+    ideep::tensor y = {}) {
   std::vector<int64_t> kernel_size(x.ndims());
   // mkldnn conv2d weights could have been re-ordered to 5d by
   // mkldnn_reorder_conv2d_weight
@@ -84,7 +95,6 @@ ideep::tensor _mkldnn_conv2d(
   std::vector<int64_t> output_sizes =
       conv_output_size(input_size, kernel_size, padding, stride, dilation);
 
-  ideep::tensor y;
   if (b.has_value()) {
     ideep::convolution_forward::compute<AllocForMKLDNN>(
         x,
@@ -97,7 +107,7 @@ ideep::tensor _mkldnn_conv2d(
         {padding.begin(), padding.end()},
         {padding.begin(), padding.end()},
         groups,
-        ideep::descriptor_group::attr_t{},
+        attr,
         ideep::algorithm::convolution_direct,
         ideep::prop_kind::forward);
   } else {
@@ -111,7 +121,7 @@ ideep::tensor _mkldnn_conv2d(
       {padding.begin(), padding.end()},
       {padding.begin(), padding.end()},
       groups,
-      ideep::descriptor_group::attr_t{},
+      attr,
       ideep::algorithm::convolution_direct,
       ideep::prop_kind::forward);
   }
@@ -150,6 +160,57 @@ at::Tensor mkldnn_convolution(
   }
 }
 
+at::Tensor mkldnn_convolution_fused(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias,
+    IntArrayRef padding,
+    IntArrayRef stride,
+    IntArrayRef dilation,
+    int64_t groups,
+    const at::Tensor& sum,
+    bool relu) {
+  TORCH_CHECK(
+      input.is_mkldnn(),
+      "mkldnn_convolution_fused: expects an MKLDNN input tensor");
+  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
+  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight);
+  c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
+  if (bias.defined()) {
+    mkldnn_bias = get_mkldnn_tensor(bias);
+  }
+
+  // The relu and the addition of sum are applied by the convolution as it
+  // writes its output, instead of by separate passes over the output.
+  ideep::descriptor_group::attr_t attr;
+  ideep::tensor mkldnn_output;
+  if (sum.defined()) {
+    TORCH_CHECK(
+        sum.is_mkldnn(),
+        "mkldnn_convolution_fused: expects an MKLDNN sum tensor");
+    // The sum post-op accumulates into the output, so it starts as a copy of
+    // sum, which may still be used by other ops.
+    ideep::direct_copy::compute<AllocForMKLDNN>(
+        itensor_from_mkldnn(sum), mkldnn_output);
+    attr = relu ? ideep::descriptor_group::attr_t::residual()
+                : ideep::descriptor_group::attr_t::fuse_sum();
+  } else if (relu) {
+    attr = ideep::descriptor_group::attr_t::fuse_relu();
+  }
+
+  mkldnn_output = _mkldnn_conv2d(
+      mkldnn_input,
+      mkldnn_weight,
+      mkldnn_bias,
+      padding,
+      stride,
+      dilation,
+      groups,
+      attr,
+      std::move(mkldnn_output));
+  return new_with_itensor_mkldnn(std::move(mkldnn_output), input.options());
+}
+
 Tensor mkldnn_convolution_backward_input(
     IntArrayRef input_size, const at::Tensor& grad_output, const at::Tensor& weight,
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups, bool bias_defined)
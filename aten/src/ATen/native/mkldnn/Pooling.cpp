@@ -75,7 +75,9 @@ static Tensor _mkldnn_pool2d(
     ideep::algorithm algo) {
   TORCH_CHECK(!ceil_mode, "Currently Mkldnn Pooling operators do not support ceil_mode.");
   auto kernel_size_vec = expand_param_if_needed(kernel_size, "kernel_size", 2);
-  auto stride_vec = expand_param_if_needed(stride, "stride", 2);
+  // An empty stride defaults to the kernel size, like for dense tensors.
+  auto stride_vec = expand_param_if_needed(
+      stride.empty() ? kernel_size : stride, "stride", 2);
   auto padding_vec = expand_param_if_needed(padding, "padding", 2);
   auto dilation_vec = expand_param_if_needed(dilation, "dilation", 2);
 
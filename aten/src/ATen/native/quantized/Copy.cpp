@@ -1,8 +1,11 @@
 #include <ATen/native/quantized/Copy.h>
 
 #include <ATen/ATen.h>
+#include <ATen/native/TensorIterator.h>
 #include <ATen/quantized/Quantizer.h>
 
+#include <cstring>
+
 namespace at {
 namespace native {
 Tensor& quantized_copy_(Tensor& self, const Tensor& src) {
@@ -25,5 +28,34 @@ Tensor& quantized_copy_(Tensor& self, const Tensor& src) {
   });
   return self;
 }
+
+Tensor& quantized_copy_from_quantized_(Tensor& self, const Tensor& src) {
+  TORCH_CHECK(
+      get_qtensorimpl(self)->quantizer()->equalTo(get_qtensorimpl(src)->quantizer()),
+      "Quantized copy only works between tensors with the same quantizer, "
+      "requantize the source with dequantize() and quantize_linear()");
+  TORCH_CHECK(self.sizes().equals(src.sizes()),
+      "Quantized copy only works with Tensors with the same shape");
+  auto builder = TensorIterator::Builder();
+  builder.add_output(self);
+  builder.add_input(src);
+  builder.dont_resize_outputs();
+  builder.dont_compute_common_dtype();
+  auto iter = builder.build();
+  if (iter->numel() == 0) {
+    return self;
+  }
+  const int64_t element_size = self.element_size();
+  iter->for_each([element_size](int ntensor, char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == element_size && strides[1] == element_size) {
+      std::memcpy(data[0], data[1], n * element_size);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      std::memcpy(data[0] + i * strides[0], data[1] + i * strides[1], element_size);
+    }
+  });
+  return self;
+}
 } // namespace native
 } // namespace at
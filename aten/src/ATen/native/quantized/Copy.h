@@ -7,5 +7,9 @@ namespace native {
 
 Tensor& quantized_copy_(Tensor& self, const Tensor& src);
 
+// Copies the values of the quantized `src` to `self`, which has the same
+// quantizer, without dequantizing them.
+Tensor& quantized_copy_from_quantized_(Tensor& self, const Tensor& src);
+
 }
 }
@@ -12,26 +12,84 @@ Tensor quantize_linear_cpu(const Tensor& self, double scale, int64_t zero_point,
   return quantizer->quantize(self);
 }
 
+Tensor quantize_linear_per_channel_cpu(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    IntArrayRef axis,
+    ScalarType dtype) {
+  TORCH_CHECK(scales.dim() == 1, "scale tensor must have dimension 1");
+  TORCH_CHECK(
+      zero_points.dim() == 1, "zero_points tensor must have dimension 1");
+  TORCH_CHECK(
+      scales.numel() == zero_points.numel(),
+      "number of elements in scales and zero_points must match");
+  TORCH_CHECK(axis.size() == 1, "only axis of size 1 is supported right now");
+  auto scales_contig = scales.to(kFloat).contiguous();
+  auto zero_points_contig = zero_points.to(kInt).contiguous();
+  const float* scales_data = scales_contig.data<float>();
+  const int32_t* zero_points_data = zero_points_contig.data<int32_t>();
+  std::vector<float> scale_vals(scales_data, scales_data + scales.numel());
+  std::vector<int32_t> zero_point_vals(
+      zero_points_data, zero_points_data + zero_points.numel());
+  auto quantizer = make_per_channel_affine_quantizer(
+      scale_vals, zero_point_vals, axis.vec(), dtype);
+  return quantizer->quantize(self);
+}
+
 Tensor dequantize_quant(const Tensor& self) {
   return get_qtensorimpl(self)->quantizer()->dequantize(self);
 }
 
 Scalar q_scale_quant(const Tensor& self) {
   auto quantizer = get_qtensorimpl(self)->quantizer();
-  AT_ASSERT(quantizer->qscheme() == kPerTensorAffine);
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      "q_scale is only defined for per tensor affine quantized tensors, "
+      "use q_per_channel_scales for ", toString(quantizer->qscheme()));
   return Scalar(static_cast<PerTensorAffineQuantizer*>(quantizer.get())->scale());
 }
 
 Scalar q_zero_point_quant(const Tensor& self) {
   auto quantizer = get_qtensorimpl(self)->quantizer();
-  AT_ASSERT(quantizer->qscheme() == kPerTensorAffine);
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      "q_zero_point is only defined for per tensor affine quantized tensors, "
+      "use q_per_channel_zero_points for ", toString(quantizer->qscheme()));
   return Scalar(static_cast<PerTensorAffineQuantizer*>(quantizer.get())->zero_point());
 }
 
+Tensor q_per_channel_scales_quant(const Tensor& self) {
+  auto quantizer = get_qtensorimpl(self)->quantizer();
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerChannelAffine,
+      "q_per_channel_scales is only defined for per channel affine quantized tensors");
+  auto scales = static_cast<PerChannelAffineQuantizer*>(quantizer.get())->scales();
+  return at::tensor(
+      std::vector<double>(scales.begin(), scales.end()),
+      at::device(kCPU).dtype(kDouble));
+}
+
+Tensor q_per_channel_zero_points_quant(const Tensor& self) {
+  auto quantizer = get_qtensorimpl(self)->quantizer();
+  TORCH_CHECK(
+      quantizer->qscheme() == kPerChannelAffine,
+      "q_per_channel_zero_points is only defined for per channel affine quantized tensors");
+  auto zero_points = static_cast<PerChannelAffineQuantizer*>(quantizer.get())->zero_points();
+  return at::tensor(
+      std::vector<int64_t>(zero_points.begin(), zero_points.end()),
+      at::device(kCPU).dtype(kLong));
+}
+
 Quantizer* quantizer(const Tensor& self) {
   return get_qtensorimpl(self)->quantizer().get();
 }
 
+Tensor quantized_clone(const Tensor& self) {
+  Tensor dst = at::empty_like(self);
+  return dst.copy_(self);
+}
+
 Tensor int_repr_quant(const Tensor& self) {
   Tensor dst = at::empty(self.sizes(), self.options().dtype(at::kByte));
   uint8_t* self_data = reinterpret_cast<uint8_t *>(self.data<quint8>());
@@ -1,9 +1,99 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/quantized/fake_quant_affine.h>
 
-/* FakeQuantize Op for PerTensorAffine quantization scheme */
+#include <tuple>
+
+/* FakeQuantize Ops for the PerTensorAffine and PerChannelAffine quantization
+   schemes. See Note [Fake quantization] for what the kernels compute. */
 namespace at { namespace native {
+
+DEFINE_DISPATCH(fake_quant_tensor_stub);
+DEFINE_DISPATCH(fake_quant_grad_tensor_stub);
+DEFINE_DISPATCH(fake_quant_channel_stub);
+
 namespace {
+
+void check_fake_quant_args(
+    int64_t num_bits,
+    int64_t quant_delay,
+    int64_t iter) {
+  if (num_bits > 32 || num_bits < 1) {
+    throw std::invalid_argument("`num_bits` should be in the [1, 32] range.");
+  }
+  if (quant_delay < 0) {
+    throw std::invalid_argument("`quant_delay` must be a positive integer.");
+  }
+  if (quant_delay != 0 && iter < 0) {
+    throw std::invalid_argument(
+      "`iter` must be >=0 for non-zero `quant_delay`");
+  }
+}
+
+// The outputs and inputs of a fake quantization kernel, with the sizes of X
+std::unique_ptr<TensorIterator> make_fake_quant_iter(
+    std::initializer_list<Tensor> outputs,
+    std::initializer_list<Tensor> inputs) {
+  auto builder = TensorIterator::Builder();
+  for (const auto& output : outputs) {
+    builder.add_output(output);
+  }
+  for (const auto& input : inputs) {
+    builder.add_input(input);
+  }
+  return builder.build();
+}
+
+// Y and the mask of the gradient of a per tensor fake quantization
+std::tuple<Tensor, Tensor> fake_quant_per_tensor(
+    const Tensor& X,
+    double scale,
+    int64_t zero_point,
+    int64_t num_bits) {
+  auto Y = at::empty_like(X);
+  auto mask = at::empty_like(X);
+  auto iter = make_fake_quant_iter({Y, mask}, {X});
+  fake_quant_tensor_stub(
+      X.type().device_type(), *iter, scale, zero_point, 0,
+      (int64_t(1) << num_bits) - 1);
+  return std::make_tuple(Y, mask);
+}
+
+// Y and the mask of the gradient of a per channel fake quantization, with
+// scale and zero_point the 1-dim tensors of the qparams along `axis`
+std::tuple<Tensor, Tensor> fake_quant_per_channel(
+    const Tensor& X,
+    const Tensor& scale,
+    const Tensor& zero_point,
+    int64_t axis,
+    int64_t num_bits) {
+  if (axis < 0 || axis >= X.dim()) {
+    throw std::invalid_argument("`axis` must be a dimension of `X`.");
+  }
+  if (scale.dim() != 1 || scale.numel() != X.size(axis) ||
+      zero_point.dim() != 1 || zero_point.numel() != X.size(axis)) {
+    throw std::invalid_argument(
+      "`scale` and `zero_point` must have one element per channel of `X`.");
+  }
+  if (zero_point.lt(0).any().item<uint8_t>()) {
+    throw std::invalid_argument("`zero_point` must be a positive integer.");
+  }
+  // The qparams of the channel of each element of X, with strides 0 but
+  // along `axis`
+  std::vector<int64_t> channel_sizes(X.dim(), 1);
+  channel_sizes[axis] = X.size(axis);
+  auto expand = [&](const Tensor& t) {
+    return t.to(X.options()).view(channel_sizes).expand(X.sizes());
+  };
+  auto Y = at::empty_like(X);
+  auto mask = at::empty_like(X);
+  auto iter = make_fake_quant_iter(
+      {Y, mask}, {X, expand(scale), expand(zero_point)});
+  fake_quant_channel_stub(
+      X.type().device_type(), *iter, 0, (int64_t(1) << num_bits) - 1);
+  return std::make_tuple(Y, mask);
+}
 /* Fake-quantizes the 'inputs' tensor.
 Args:
   X: Forward input tensor.
@@ -33,35 +123,15 @@ class FakeQuantizePerTensorAffineOp_forward : public c10::OperatorKernel {
       int64_t quant_delay = 0,
       int64_t iter = 0
     ) {
-    // Sanity checks.
-    if (num_bits > 32 || num_bits < 1) {
-      throw std::invalid_argument("`num_bits` should be in the [1, 32] range.");
-    }
+    check_fake_quant_args(num_bits, quant_delay, iter);
     if (zero_point < 0) {
       throw std::invalid_argument("`zero_point` must be a positive integer.");
     }
-    if (quant_delay < 0) {
-      throw std::invalid_argument("`quant_delay` must be a positive integer.");
-    }
-
-    if (quant_delay != 0 && iter < 0) {
-      throw std::invalid_argument(
-        "`iter` must be >=0 for non-zero `quant_delay`");
-    }
-
-    auto Y = at::empty_like(X);
 
     if (quant_delay > 0 && iter <= quant_delay) {
-      Y.copy_(X);  // We might want to just return the input here.
-      return Y;
+      return X.clone();  // We might want to just return the input here.
     }
-
-    double inv_scale = 1.0f / scale;
-    const auto quant_min = 0;
-    const auto quant_max = (1 << num_bits) - 1;
-    Y = (((X * inv_scale + 0.5f).floor() + zero_point)
-      .clamp_min(quant_min).clamp_max(quant_max) - zero_point) * scale;
-    return Y;
+    return std::get<0>(fake_quant_per_tensor(X, scale, zero_point, num_bits));
   }
 };
 
@@ -94,16 +164,10 @@ class FakeQuantizePerTensorAffineOp_backward : public c10::OperatorKernel {
       int64_t num_bits = 8,
       int64_t quant_delay = 0,
       int64_t iter = 0) {
-    // Sanity checks.
-    if (num_bits > 32 || num_bits < 1) {
-      throw std::invalid_argument("`num_bits` should be in the [1, 32] range.");
-    }
+    check_fake_quant_args(num_bits, quant_delay, iter);
     if (zero_point < 0) {
       throw std::invalid_argument("`zero_point` must be a positive integer.");
     }
-    if (quant_delay < 0) {
-      throw std::invalid_argument("`quant_delay` must be a positive integer.");
-    }
     if (X.numel() <= 0) {
       throw std::length_error("`X` is empty");
     }
@@ -111,38 +175,156 @@ class FakeQuantizePerTensorAffineOp_backward : public c10::OperatorKernel {
       throw std::invalid_argument("`X` and `dY` are not the same size");
     }
 
-    if (quant_delay != 0 && iter < 0) {
-      throw std::invalid_argument(
-        "`iter` must be >=0 for non-zero `quant_delay`");
+    if (quant_delay > 0 && iter <= quant_delay) {
+      return dY.clone();
+    }
+
+    auto dX = at::empty_like(dY);
+    auto tensor_iter = make_fake_quant_iter({dX}, {X.reshape_as(dY), dY});
+    fake_quant_grad_tensor_stub(
+        X.type().device_type(), *tensor_iter, scale, zero_point, 0,
+        (int64_t(1) << num_bits) - 1);
+    return dX;
+  }
+};
+
+/* Fake-quantizes the 'inputs' tensor, and returns the mask of the gradient
+along with it: the backward pass is then dX = dY * mask, without running the
+quantization again. The mask has the dtype of X, with 1 where the quantized
+value of X is in the quantization range and 0 elsewhere. See the forward op for
+the arguments.
+*/
+class FakeQuantizePerTensorAffineOp_forward_and_mask : public c10::OperatorKernel {
+ public:
+  std::tuple<at::Tensor, at::Tensor> operator()(
+      at::Tensor X,
+      double scale,
+      int64_t zero_point,
+      int64_t num_bits = 8,
+      int64_t quant_delay = 0,
+      int64_t iter = 0) {
+    check_fake_quant_args(num_bits, quant_delay, iter);
+    if (zero_point < 0) {
+      throw std::invalid_argument("`zero_point` must be a positive integer.");
+    }
+
+    if (quant_delay > 0 && iter <= quant_delay) {
+      return std::make_tuple(X.clone(), at::ones_like(X));
     }
+    return fake_quant_per_tensor(X, scale, zero_point, num_bits);
+  }
+};
 
-    auto dX = at::zeros_like(dY);
+/* Fake-quantizes the 'inputs' tensor with a scale and a zero point per channel.
+Args:
+  X: Forward input tensor.
+  dY: Backward input tensor (_backward op only).
+  scale: 1-dim tensor of the scales of the channels of X along `axis`
+  zero_point: 1-dim tensor of the zero points of the channels
+  axis: The dimension of the channels of X.
+  num_bits, quant_delay, iter: As for the per tensor ops.
+Returns:
+  Fake-quantized tensor (the dtype of X), or the mask of its gradient as well
+  (_forward_and_mask op only).
+*/
+class FakeQuantizePerChannelAffineOp_forward : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor X,
+      at::Tensor scale,
+      at::Tensor zero_point,
+      int64_t axis,
+      int64_t num_bits = 8,
+      int64_t quant_delay = 0,
+      int64_t iter = 0) {
+    check_fake_quant_args(num_bits, quant_delay, iter);
     if (quant_delay > 0 && iter <= quant_delay) {
-      dX.copy_(dY);
-      return dX;
+      return X.clone();
     }
+    return std::get<0>(
+        fake_quant_per_channel(X, scale, zero_point, axis, num_bits));
+  }
+};
 
-    double inv_scale = 1.0f / scale;
-    const auto quant_min = 0;
-    const auto quant_max = (1 << num_bits) - 1;
-    at::Tensor Xq = (X * inv_scale + 0.5).floor() + zero_point;
-    at::Tensor mask_min = (Xq >= quant_min);
-    at::Tensor mask_max = (Xq <= quant_max);
-    at::Tensor mask = mask_min * mask_max;
-    dX = mask.type_as(dY) * dY;
-    return dX;
+class FakeQuantizePerChannelAffineOp_forward_and_mask : public c10::OperatorKernel {
+ public:
+  std::tuple<at::Tensor, at::Tensor> operator()(
+      at::Tensor X,
+      at::Tensor scale,
+      at::Tensor zero_point,
+      int64_t axis,
+      int64_t num_bits = 8,
+      int64_t quant_delay = 0,
+      int64_t iter = 0) {
+    check_fake_quant_args(num_bits, quant_delay, iter);
+    if (quant_delay > 0 && iter <= quant_delay) {
+      return std::make_tuple(X.clone(), at::ones_like(X));
+    }
+    return fake_quant_per_channel(X, scale, zero_point, axis, num_bits);
+  }
+};
+
+class FakeQuantizePerChannelAffineOp_backward : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor X,
+      at::Tensor dY,
+      at::Tensor scale,
+      at::Tensor zero_point,
+      int64_t axis,
+      int64_t num_bits = 8,
+      int64_t quant_delay = 0,
+      int64_t iter = 0) {
+    check_fake_quant_args(num_bits, quant_delay, iter);
+    if (X.sizes() != dY.sizes()) {
+      throw std::invalid_argument("`X` and `dY` are not the same size");
+    }
+    if (quant_delay > 0 && iter <= quant_delay) {
+      return dY.clone();
+    }
+    auto mask = std::get<1>(
+        fake_quant_per_channel(X, scale, zero_point, axis, num_bits));
+    return dY * mask;
   }
 };
 
+#define FAKE_QUANT_REGISTER(name, schema, kernel)      \
+  .op("quantized::" name schema,                       \
+      c10::RegisterOperators::options()                \
+        .kernel<kernel>()                              \
+        .dispatchKey(CPUTensorId()))                   \
+  .op("quantized::" name schema,                       \
+      c10::RegisterOperators::options()                \
+        .kernel<kernel>()                              \
+        .dispatchKey(CUDATensorId()))
+
 static auto registry = c10::RegisterOperators()
-.op("quantized::fake_quantize_per_tensor_affine_forward(Tensor X, float scale, int zero_point, int num_bits = 8, int quant_delay = 0, int iter = 0) -> Tensor",
-    c10::RegisterOperators::options()
-      .kernel<FakeQuantizePerTensorAffineOp_forward>()
-      .dispatchKey(CPUTensorId()))
-.op("quantized::fake_quantize_per_tensor_affine_backward(Tensor X, Tensor dY, float scale, int zero_point, int num_bits=8, int quant_delay=0, int iter = 0) -> Tensor",
-    c10::RegisterOperators::options()
-      .kernel<FakeQuantizePerTensorAffineOp_backward>()
-      .dispatchKey(CPUTensorId()));
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_tensor_affine_forward",
+    "(Tensor X, float scale, int zero_point, int num_bits = 8, int quant_delay = 0, int iter = 0) -> Tensor",
+    FakeQuantizePerTensorAffineOp_forward)
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_tensor_affine_backward",
+    "(Tensor X, Tensor dY, float scale, int zero_point, int num_bits=8, int quant_delay=0, int iter = 0) -> Tensor",
+    FakeQuantizePerTensorAffineOp_backward)
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_tensor_affine_forward_and_mask",
+    "(Tensor X, float scale, int zero_point, int num_bits = 8, int quant_delay = 0, int iter = 0) -> (Tensor Y, Tensor mask)",
+    FakeQuantizePerTensorAffineOp_forward_and_mask)
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_channel_affine_forward",
+    "(Tensor X, Tensor scale, Tensor zero_point, int axis, int num_bits = 8, int quant_delay = 0, int iter = 0) -> Tensor",
+    FakeQuantizePerChannelAffineOp_forward)
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_channel_affine_backward",
+    "(Tensor X, Tensor dY, Tensor scale, Tensor zero_point, int axis, int num_bits = 8, int quant_delay = 0, int iter = 0) -> Tensor",
+    FakeQuantizePerChannelAffineOp_backward)
+FAKE_QUANT_REGISTER(
+    "fake_quantize_per_channel_affine_forward_and_mask",
+    "(Tensor X, Tensor scale, Tensor zero_point, int axis, int num_bits = 8, int quant_delay = 0, int iter = 0) -> (Tensor Y, Tensor mask)",
+    FakeQuantizePerChannelAffineOp_forward_and_mask);
+
+#undef FAKE_QUANT_REGISTER
 
 }  // namespace
 }}  // namespace at::native
@@ -4,6 +4,8 @@
 #include "fbgemm/Fbgemm.h"
 #include "fbgemm/QuantUtils.h"
 
+#include <c10/core/QScheme.h>
+
 // The struct for the packed weight matrix (PackBMatrix) and the corresponding
 // column offsets used for the fully connect layer, which are both prepared in
 // the prepacking step to save the computations in the inference. Note the
@@ -13,11 +15,30 @@
 // of the A rows. The column offsets are needed for the asymmetric quantization
 // (affine quantization) of input matrix.
 // Note that in JIT mode we can think of a way to fuse col_offsets with bias.
+// Per channel quantized weights have a scale and a zero point for each output
+// channel, per tensor quantized ones a single one.
 struct FBGEMM_API PackedFCWeight {
   std::unique_ptr<fbgemm::PackBMatrix<int8_t>> w;
   std::vector<int32_t> col_offsets;
+  std::vector<float> w_scale;
+  std::vector<int32_t> w_zp;
+  c10::QScheme q_scheme;
+};
+
+// The struct for the packed convolution weights (PackWeightsForConv) and the
+// column offsets, as for the fully connected layer above. PackWeightsForConv
+// picks the depthwise, groupwise or im2col kernel of fbgemmConv for the
+// convolution parameters, so these are prepacked together with the weights.
+struct FBGEMM_API PackedConvWeight {
+  std::unique_ptr<fbgemm::PackWeightsForConv<2>> w;
+  std::vector<int32_t> col_offsets;
+  std::vector<int64_t> kernel;
+  std::vector<int64_t> stride;
+  std::vector<int64_t> padding;
+  int64_t groups;
+  int64_t input_channels;
   float w_scale;
-  int w_zp;
+  int32_t w_zp;
 };
 
 // Convert the weight from uint8 to int8.
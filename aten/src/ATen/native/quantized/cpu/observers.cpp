@@ -0,0 +1,80 @@
+#include <ATen/ATen.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+
+#include <tuple>
+#include <vector>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(histogram_stub);
+
+// Observers collect the range of the values of a tensor over calibration
+// batches, to choose its quantization parameters. The running statistics are
+// passed in and returned rather than kept in modules, empty ones start the
+// observation.
+
+// The min and max of `self`, along `axis` (per channel) or over the whole
+// tensor, combined with the running ones: an averaging constant of 1 keeps
+// the smallest min and largest max seen, a smaller one moves the running
+// values towards the batch ones by that fraction. The min and max come out of
+// a single pass over `self`.
+std::tuple<Tensor, Tensor> _min_max_observer_cpu(
+    const Tensor& self,
+    const Tensor& running_min,
+    const Tensor& running_max,
+    c10::optional<int64_t> axis,
+    double averaging_constant) {
+  TORCH_CHECK(self.is_floating_point(), "_min_max_observer expects a floating point tensor");
+  TORCH_CHECK(self.numel() > 0, "_min_max_observer on a tensor with no elements is not defined.");
+  TORCH_CHECK(
+      averaging_constant > 0 && averaging_constant <= 1,
+      "_min_max_observer expects an averaging constant in (0, 1], got ", averaging_constant);
+  Tensor batch_min, batch_max;
+  if (!axis.has_value()) {
+    std::tie(batch_min, batch_max) = at::_min_max_values(self);
+  } else {
+    const int64_t channel_dim = maybe_wrap_dim(*axis, self.dim());
+    std::vector<int64_t> dims;
+    for (int64_t d = 0; d < self.dim(); d++) {
+      if (d != channel_dim) {
+        dims.push_back(d);
+      }
+    }
+    if (dims.empty()) {
+      batch_min = self.clone();
+      batch_max = self.clone();
+    } else {
+      std::tie(batch_min, batch_max) = at::_min_max_values(self, dims);
+    }
+  }
+  if (running_min.numel() == 0 && running_max.numel() == 0) {
+    return std::make_tuple(batch_min, batch_max);
+  }
+  TORCH_CHECK(
+      running_min.sizes() == batch_min.sizes() && running_max.sizes() == batch_max.sizes(),
+      "_min_max_observer expects running min and max of sizes ", batch_min.sizes(),
+      ", got ", running_min.sizes(), " and ", running_max.sizes());
+  if (averaging_constant == 1) {
+    return std::make_tuple(at::min(running_min, batch_min), at::max(running_max, batch_max));
+  }
+  return std::make_tuple(
+      running_min + (batch_min - running_min) * averaging_constant,
+      running_max + (batch_max - running_max) * averaging_constant);
+}
+
+// `histogram` with the counts of histogram_stub added. Unlike histc, the
+// bins are counted on each thread separately and then summed.
+Tensor _histogram_observer_cpu(const Tensor& self, const Tensor& histogram, double min, double max) {
+  TORCH_CHECK(self.is_floating_point(), "_histogram_observer expects a floating point tensor");
+  TORCH_CHECK(histogram.dim() == 1 && histogram.numel() > 0,
+      "_histogram_observer expects a 1-d histogram with at least one bin");
+  TORCH_CHECK(min < max, "_histogram_observer expects min < max, got min ", min, " and max ", max);
+  auto counts = at::zeros({histogram.numel()}, histogram.options().dtype(kLong));
+  if (self.numel() > 0) {
+    histogram_stub(kCPU, counts, self.contiguous(), min, max);
+  }
+  return histogram + counts.to(histogram.scalar_type());
+}
+
+}}  // namespace at::native
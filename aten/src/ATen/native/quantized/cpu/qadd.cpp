@@ -1,13 +1,14 @@
 #include <ATen/ATen.h>
 #include <ATen/core/Type.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/native/TensorIterator.h>
-#include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/Quantizer.h>
 
-#include <algorithm>
-
 namespace at { namespace native {
+
+DEFINE_DISPATCH(qadd_stub);
+DEFINE_DISPATCH(qadd_relu_stub);
+
 namespace {
 template <bool ReLUFused = false>
 class QAddInt8 final : public c10::OperatorKernel {
@@ -16,21 +17,16 @@ class QAddInt8 final : public c10::OperatorKernel {
                     double scale, int64_t zero_point) {
     AT_ASSERTM(qa.numel() == qb.numel(), "Add operands must be the same size!");
     TORCH_CHECK(qa.scalar_type() == qb.scalar_type(), "Add operands should have same data type.");
-    auto a = qa.dequantize();
-    auto b = qb.dequantize();
-    auto c = at::empty_like(a);
-    auto iter = TensorIterator::binary_op(c, a, b);
-
+    auto qc = at::_empty_affine_quantized(qa.sizes(),
+                                          at::device(kCPU).dtype(qa.scalar_type()),
+                                          scale,
+                                          zero_point);
     if (ReLUFused) {
-      binary_kernel(*iter, [&](float a_val, float b_val) -> float {
-        return std::max<float>(a_val + b_val, 0);
-      });
+      qadd_relu_stub(kCPU, qc, qa, qb);
     } else {
-      binary_kernel(*iter, [&](float a_val, float b_val) -> float {
-        return a_val + b_val;
-      });
+      qadd_stub(kCPU, qc, qa, qb);
     }
-    return c.quantize_linear(scale, zero_point, qa.scalar_type());  // Requantize
+    return qc;
   }
 };
 
@@ -0,0 +1,164 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+template <bool ReluFused>
+class QConvInt8 final : public c10::OperatorKernel {
+ public:
+#ifdef USE_FBGEMM
+  // The input and the output are in NHWC layout, the packed weight comes from
+  // quantized::conv_prepack, which also fixes the stride, the padding and the
+  // groups.
+  at::Tensor operator()(
+      at::Tensor act,
+      at::Tensor packed_weight,
+      at::Tensor bias,
+      double output_scale,
+      int64_t output_zero_point) {
+    // uint8 * int8 -> uint8 (no quantization/dequantization)
+
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
+
+    TORCH_CHECK(
+        act.dim() == 4,
+        "quantized::conv2d expects a 4-d input in NHWC layout");
+
+    // Pull out the packed weight and col_offsets instance from the owning
+    // tensor.
+    auto& pack_ptr = cpp_custom_type_hack::cast<PackedConvWeight>(packed_weight);
+    auto packB = pack_ptr.w.get();
+    auto& col_offsets = pack_ptr.col_offsets;
+    auto& kernel = pack_ptr.kernel;
+    auto& stride = pack_ptr.stride;
+    auto& padding = pack_ptr.padding;
+
+    const int64_t N = act.size(0);
+    const int64_t H = act.size(1);
+    const int64_t W = act.size(2);
+    const int64_t C = act.size(3);
+    const int64_t K = static_cast<int64_t>(col_offsets.size());
+    TORCH_CHECK(
+        C == pack_ptr.input_channels,
+        "The number of input channels of quantized::conv2d (", C,
+        ") doesn't match its weight (", pack_ptr.input_channels, ")");
+    AT_ASSERT(bias.dim() == 1);
+    AT_ASSERT(bias.size(0) == K);
+
+    fbgemm::conv_param_t<> conv_p(
+        /*mb=*/N,
+        /*ic=*/C,
+        /*oc=*/K,
+        /*in_dim=*/{static_cast<int>(H), static_cast<int>(W)},
+        /*g=*/pack_ptr.groups,
+        /*k=*/{static_cast<int>(kernel[0]), static_cast<int>(kernel[1])},
+        /*strd=*/{static_cast<int>(stride[0]), static_cast<int>(stride[1])},
+        /*pd=*/{static_cast<int>(padding[0]),
+                static_cast<int>(padding[1]),
+                static_cast<int>(padding[0]),
+                static_cast<int>(padding[1])});
+    TORCH_CHECK(
+        conv_p.OUT_DIM[0] > 0 && conv_p.OUT_DIM[1] > 0,
+        "The input of quantized::conv2d is too small for its kernel");
+
+    // TODO: contiguous is called for further jit optimizations.
+    auto act_contig = act.contiguous();
+    const auto* act_ptr =
+        reinterpret_cast<uint8_t*>(act_contig.data<c10::quint8>());
+
+    float act_scale_float = act.q_scale().toFloat();
+    int32_t act_zero_point_int32 = act.q_zero_point().toInt();
+
+    float weight_scale_float = pack_ptr.w_scale;
+    int32_t weight_zero_point_int32 = pack_ptr.w_zp;
+
+    float output_multiplier_float = (act_scale_float * weight_scale_float) /
+        static_cast<float>(output_scale);
+    int32_t output_zero_point_int32 = static_cast<int32_t>(output_zero_point);
+
+    // This is the end of the pipeline, pass the resulting matrix through.
+    fbgemm::DoNothing<> doNothingObj{};
+
+    // TODO: contiguous is called for further jit optimizations.
+    auto bias_contig = bias.contiguous();
+
+    // After the uint8 * int8 convolution is performed, this operation does:
+    //  1) Add in row and column offsets to the rows and columns, respectively.
+    //     fbgemmConv computes the row offsets itself for the kernel it runs.
+    //  2) Add in the bias term.
+    fbgemm::ReQuantizeOutput<ReluFused> outputProcObj(
+        /*nextop=*/doNothingObj,
+        /*C_multiplier=*/&output_multiplier_float,
+        /*C_zero_point=*/output_zero_point_int32,
+        /*Aq_zero_point=*/act_zero_point_int32,
+        /*Bq_zero_point=*/&weight_zero_point_int32,
+        /*row_offsets=*/nullptr,
+        /*col_offsets=*/col_offsets.data(),
+        /*bias=*/bias_contig.data<int32_t>(),
+        /*nCol=*/K,
+        /*groups=*/pack_ptr.groups);
+
+    // Allocate output Tensor and a buffer for fbgemmConv to use
+    auto output = _empty_affine_quantized(
+        {N, conv_p.OUT_DIM[0], conv_p.OUT_DIM[1], K},
+        at::device(kCPU).dtype(kQUInt8),
+        output_scale,
+        output_zero_point);
+
+    auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
+
+    // Do the convolution. fbgemmConv takes the depthwise or groupwise fast
+    // path when the weights were packed for one.
+    fbgemm::fbgemmConv(
+        /*conv_p=*/conv_p,
+        /*activations=*/act_ptr,
+        /*packed_weights=*/*packB,
+        /*out=*/reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
+        /*outBuffer=*/buffer.data<int32_t>(),
+        /*outProcess=*/outputProcObj,
+        /*thread_id=*/0,
+        /*num_threads=*/1);
+
+    return output;
+  }
+#else // USE_FBGEMM
+  at::Tensor operator()(
+      at::Tensor /* act */,
+      at::Tensor /* packed_weight */,
+      at::Tensor /* bias */,
+      double /* output_scale */,
+      int64_t /* output_zero_point */) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        false, "This PyTorch installation was not built with FBGEMM operators");
+  }
+#endif // USE_FBGEMM
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::conv2d(Tensor X, Tensor W_prepack, Tensor b, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            c10::RegisterOperators::options()
+              .kernel<QConvInt8<false>>()
+              .dispatchKey(QuantizedCPUTensorId()))
+        .op("quantized::conv2d_relu(Tensor X, Tensor W_prepack, Tensor b, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            c10::RegisterOperators::options()
+              .kernel<QConvInt8<true>>()
+              .dispatchKey(QuantizedCPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,124 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace caffe2 {
+#ifdef USE_FBGEMM
+// Required for cpp_custom_type_hack to work
+CAFFE_KNOWN_TYPE(PackedConvWeight);
+#endif // USE_FBGEMM
+} // namespace caffe2
+
+namespace at {
+namespace native {
+namespace {
+
+class QConvPackWeightInt8 final : public c10::OperatorKernel {
+ public:
+#ifdef USE_FBGEMM
+  // The weight is in KRSC layout: [output channels, kernel height,
+  // kernel width, input channels / groups].
+  at::Tensor operator()(
+      at::Tensor weight,
+      const std::vector<int64_t>& stride,
+      const std::vector<int64_t>& padding,
+      int64_t groups) {
+    TORCH_CHECK(
+        weight.dim() == 4,
+        "quantized::conv_prepack expects a 4-d weight in KRSC layout");
+    TORCH_CHECK(
+        stride.size() == 2 && padding.size() == 2,
+        "quantized::conv_prepack expects 2 values for stride and padding");
+    TORCH_CHECK(groups > 0, "quantized::conv_prepack expects positive groups");
+    const int64_t output_channels = weight.size(0);
+    const int64_t kernel_h = weight.size(1);
+    const int64_t kernel_w = weight.size(2);
+    const int64_t channels_per_group = weight.size(3);
+    TORCH_CHECK(
+        output_channels % groups == 0,
+        "The number of output channels of quantized::conv_prepack must be "
+        "divisible by groups");
+
+    int32_t weight_zero_point_int32 = weight.q_zero_point().toInt() - 128;
+
+    // TODO: contiguous is called for further JIT optimizations.
+    auto weight_contig = weight.contiguous();
+
+    const int64_t kernel_size = kernel_h * kernel_w * channels_per_group;
+    std::vector<int8_t> weight_int8(output_channels * kernel_size);
+    int8_t* weight_ptr_int8 = weight_int8.data();
+    uint8_t* weight_ptr_uint8 =
+        reinterpret_cast<uint8_t*>(weight_contig.data<c10::quint8>());
+    convert_uint8_int8(
+        kernel_size, output_channels, weight_ptr_uint8, weight_ptr_int8);
+
+    // The column offsets of each output channel, as in qfc_prepack.cpp
+    std::vector<int32_t> col_offsets(output_channels);
+    for (int64_t k = 0; k < output_channels; ++k) {
+      int32_t sum = 0;
+      for (int64_t j = 0; j < kernel_size; ++j) {
+        sum += weight_ptr_int8[k * kernel_size + j];
+      }
+      col_offsets[k] = sum - weight_zero_point_int32 * kernel_size;
+    }
+
+    // The batch size and the input size don't change how the weights are
+    // packed, but the rest of the parameters pick the kernel.
+    fbgemm::conv_param_t<> conv_p(
+        /*mb=*/1,
+        /*ic=*/channels_per_group * groups,
+        /*oc=*/output_channels,
+        /*in_dim=*/{std::max<int>(kernel_h, 1), std::max<int>(kernel_w, 1)},
+        /*g=*/groups,
+        /*k=*/{static_cast<int>(kernel_h), static_cast<int>(kernel_w)},
+        /*strd=*/{static_cast<int>(stride[0]), static_cast<int>(stride[1])},
+        /*pd=*/{static_cast<int>(padding[0]),
+                static_cast<int>(padding[1]),
+                static_cast<int>(padding[0]),
+                static_cast<int>(padding[1])});
+
+    auto ret_ptr = guts::make_unique<PackedConvWeight>(PackedConvWeight{
+        guts::make_unique<fbgemm::PackWeightsForConv<2>>(
+            conv_p, weight_ptr_int8),
+        col_offsets,
+        {kernel_h, kernel_w},
+        stride,
+        padding,
+        groups,
+        channels_per_group * groups,
+        weight.q_scale().toFloat(),
+        weight_zero_point_int32});
+
+    // TODO: we will need to replace this with torchscript classes at a later
+    // point.
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
+  }
+#else // USE_FBGEMM
+  at::Tensor operator()(
+      at::Tensor /* weight */,
+      const std::vector<int64_t>& /* stride */,
+      const std::vector<int64_t>& /* padding */,
+      int64_t /* groups */) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        false, "This PyTorch installation was not built with FBGEMM operators");
+  }
+#endif // USE_FBGEMM
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::conv_prepack(Tensor W, int[] stride, int[] padding, int groups) -> Tensor W_prepack",
+    c10::RegisterOperators::options()
+      .kernel<QConvPackWeightInt8>()
+      .dispatchKey(QuantizedCPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,272 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace at { namespace native {
+namespace {
+
+// Rowwise quantized embedding tables, with the parameters of each row stored
+// at its end:
+//
+//  - byte: the tables of Note [Fused 8-bit rowwise embeddings] (see
+//    EmbeddingBag.cpp), [num_embeddings, embedding_dim + 8] uint8 tensors with
+//    a float scale and bias per row. They are looked up with the fused caffe2
+//    perfkernels of embedding_bag.
+//  - 4bit: [num_embeddings, embedding_dim / 2 + 4] uint8 tensors, with two
+//    values per byte (the even element of each pair in the low nibble)
+//    followed by the scale and the bias of the row as two halfs. The
+//    embedding_dim is thus even.
+//
+// Both dequantize to value * scale + bias.
+
+constexpr int64_t kMode_Sum = 0;
+constexpr int64_t kMode_Mean = 1;
+
+constexpr int64_t k4BitScaleBiasBytes = 2 * sizeof(at::Half);
+
+void check_packed_weight(const Tensor& packed, int64_t scale_bias_bytes, const char* name) {
+  TORCH_CHECK(packed.dim() == 2 && packed.scalar_type() == kByte,
+      name, ": expected a 2-dim uint8 packed weight");
+  TORCH_CHECK(packed.size(1) >= scale_bias_bytes,
+      name, ": expected the packed weight to have at least ", scale_bias_bytes,
+      " columns for the scale and bias, but got ", packed.size(1));
+}
+
+class QEmbeddingBagBytePrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight) {
+    return at::_embedding_bag_pack_8bit_rowwise(weight);
+  }
+};
+
+class QEmbeddingBagByteUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_) {
+    constexpr int64_t scale_bias_bytes = 2 * sizeof(float);
+    check_packed_weight(packed_, scale_bias_bytes, "embedding_bag_byte_unpack");
+    auto packed = packed_.contiguous();
+    const int64_t num_rows = packed.size(0);
+    const int64_t packed_ddim = packed.size(1);
+    const int64_t ddim = packed_ddim - scale_bias_bytes;
+    auto output = at::empty({num_rows, ddim}, packed.options().dtype(kFloat));
+    const uint8_t* packed_data = packed.data<uint8_t>();
+    float* output_data = output.data<float>();
+    parallel_for(0, num_rows, 1 + internal::GRAIN_SIZE / std::max<int64_t>(1, ddim),
+        [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const uint8_t* input_row = packed_data + row * packed_ddim;
+        float scale_bias[2];
+        std::memcpy(scale_bias, input_row + ddim, sizeof(scale_bias));
+        float* output_row = output_data + row * ddim;
+        for (int64_t i = 0; i < ddim; ++i) {
+          output_row[i] = input_row[i] * scale_bias[0] + scale_bias[1];
+        }
+      }
+    });
+    return output;
+  }
+};
+
+// Quantizes each row to [0, 15] over its [min, max] range. The scale is
+// rounded to half before quantizing, so that the values are those the stored
+// scale dequantizes.
+class QEmbeddingBag4BitPrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight_) {
+    TORCH_CHECK(weight_.dim() == 2 && weight_.scalar_type() == kFloat,
+        "embedding_bag_4bit_prepack: expected a 2-dim float weight");
+    TORCH_CHECK(weight_.size(1) % 2 == 0,
+        "embedding_bag_4bit_prepack: expected an even embedding_dim, but got ",
+        weight_.size(1));
+    auto weight = weight_.contiguous();
+    const int64_t num_rows = weight.size(0);
+    const int64_t ddim = weight.size(1);
+    const int64_t packed_ddim = ddim / 2 + k4BitScaleBiasBytes;
+    auto packed = at::empty({num_rows, packed_ddim}, weight.options().dtype(kByte));
+    const float* weight_data = weight.data<float>();
+    uint8_t* packed_data = packed.data<uint8_t>();
+    parallel_for(0, num_rows, 1 + internal::GRAIN_SIZE / std::max<int64_t>(1, ddim),
+        [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const float* input_row = weight_data + row * ddim;
+        uint8_t* output_row = packed_data + row * packed_ddim;
+        float minimum = 0, maximum = 0;
+        if (ddim > 0) {
+          const auto minmax = std::minmax_element(input_row, input_row + ddim);
+          minimum = *minmax.first;
+          maximum = *minmax.second;
+        }
+        const at::Half bias = minimum;
+        const at::Half scale = (maximum - static_cast<float>(bias)) / 15.0f;
+        const float inverse_scale =
+            static_cast<float>(scale) == 0 ? 0 : 1.0f / static_cast<float>(scale);
+        for (int64_t i = 0; i < ddim; i += 2) {
+          uint8_t pair = 0;
+          for (int64_t j = 0; j < 2; ++j) {
+            const float q = std::nearbyint(
+                (input_row[i + j] - static_cast<float>(bias)) * inverse_scale);
+            pair |= static_cast<uint8_t>(std::min(std::max(q, 0.0f), 15.0f)) << (4 * j);
+          }
+          output_row[i / 2] = pair;
+        }
+        const at::Half scale_bias[2] = {scale, bias};
+        std::memcpy(output_row + ddim / 2, scale_bias, sizeof(scale_bias));
+      }
+    });
+    return packed;
+  }
+};
+
+class QEmbeddingBag4BitUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_) {
+    check_packed_weight(packed_, k4BitScaleBiasBytes, "embedding_bag_4bit_unpack");
+    auto packed = packed_.contiguous();
+    const int64_t num_rows = packed.size(0);
+    const int64_t packed_ddim = packed.size(1);
+    const int64_t ddim = 2 * (packed_ddim - k4BitScaleBiasBytes);
+    auto output = at::empty({num_rows, ddim}, packed.options().dtype(kFloat));
+    const uint8_t* packed_data = packed.data<uint8_t>();
+    float* output_data = output.data<float>();
+    parallel_for(0, num_rows, 1 + internal::GRAIN_SIZE / std::max<int64_t>(1, ddim),
+        [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const uint8_t* input_row = packed_data + row * packed_ddim;
+        at::Half scale_bias[2];
+        std::memcpy(scale_bias, input_row + ddim / 2, sizeof(scale_bias));
+        const float scale = scale_bias[0];
+        const float bias = scale_bias[1];
+        float* output_row = output_data + row * ddim;
+        for (int64_t i = 0; i < ddim; ++i) {
+          output_row[i] = ((input_row[i / 2] >> (4 * (i % 2))) & 0xF) * scale + bias;
+        }
+      }
+    });
+    return output;
+  }
+};
+
+// Same arguments as F.embedding_bag, with 'sum' (0) and 'mean' (1) modes
+class QEmbeddingBagByte final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor weight,
+      Tensor indices,
+      Tensor offsets,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights) {
+    check_packed_weight(weight, 2 * sizeof(float), "embedding_bag_byte");
+    return std::get<0>(at::embedding_bag(
+        weight, indices, offsets, /*scale_grad_by_freq=*/false, mode,
+        /*sparse=*/false,
+        per_sample_weights.has_value() ? *per_sample_weights : Tensor()));
+  }
+};
+
+class QEmbeddingBag4Bit final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor weight_,
+      Tensor indices_,
+      Tensor offsets_,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights_) {
+    check_packed_weight(weight_, k4BitScaleBiasBytes, "embedding_bag_4bit");
+    TORCH_CHECK(mode == kMode_Sum || mode == kMode_Mean,
+        "embedding_bag_4bit: only supported with mode='sum' or mode='mean'");
+    TORCH_CHECK(indices_.dim() == 1 && indices_.scalar_type() == kLong &&
+        offsets_.dim() == 1 && offsets_.scalar_type() == kLong,
+        "embedding_bag_4bit: expected 1-dim long indices and offsets");
+    auto weight = weight_.contiguous();
+    auto indices = indices_.contiguous();
+    auto offsets = offsets_.contiguous();
+    const float* per_sample_weights_data = nullptr;
+    Tensor per_sample_weights;
+    if (per_sample_weights_.has_value()) {
+      TORCH_CHECK(mode == kMode_Sum,
+          "embedding_bag_4bit: per_sample_weights only supported with mode='sum'");
+      per_sample_weights = per_sample_weights_->contiguous();
+      TORCH_CHECK(per_sample_weights.scalar_type() == kFloat &&
+          per_sample_weights.numel() == indices.numel(),
+          "embedding_bag_4bit: expected a float per_sample_weight per index");
+      per_sample_weights_data = per_sample_weights.data<float>();
+    }
+
+    const int64_t num_rows = weight.size(0);
+    const int64_t packed_ddim = weight.size(1);
+    const int64_t ddim = 2 * (packed_ddim - k4BitScaleBiasBytes);
+    const int64_t num_bags = offsets.numel();
+    const int64_t num_indices = indices.numel();
+    const uint8_t* weight_data = weight.data<uint8_t>();
+    const int64_t* indices_data = indices.data<int64_t>();
+    const int64_t* offsets_data = offsets.data<int64_t>();
+    for (int64_t i = 0; i < num_indices; ++i) {
+      TORCH_CHECK(indices_data[i] >= 0 && indices_data[i] < num_rows,
+          "embedding_bag_4bit: index ", indices_data[i], " out of range");
+    }
+    auto output = at::zeros({num_bags, ddim}, weight.options().dtype(kFloat));
+    float* output_data = output.data<float>();
+    const int64_t average_bag = std::max<int64_t>(1, num_indices / std::max<int64_t>(1, num_bags));
+    parallel_for(0, num_bags, 1 + internal::GRAIN_SIZE / (average_bag * std::max<int64_t>(1, ddim)),
+        [&](int64_t begin, int64_t end) {
+      for (int64_t bag = begin; bag < end; ++bag) {
+        const int64_t start = offsets_data[bag];
+        const int64_t stop = bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices;
+        float* output_row = output_data + bag * ddim;
+        for (int64_t j = start; j < stop; ++j) {
+          const uint8_t* input_row = weight_data + indices_data[j] * packed_ddim;
+          at::Half scale_bias[2];
+          std::memcpy(scale_bias, input_row + ddim / 2, sizeof(scale_bias));
+          const float weight = per_sample_weights_data ? per_sample_weights_data[j] : 1.0f;
+          const float scale = weight * static_cast<float>(scale_bias[0]);
+          const float bias = weight * static_cast<float>(scale_bias[1]);
+          for (int64_t i = 0; i < ddim / 2; ++i) {
+            const uint8_t pair = input_row[i];
+            output_row[2 * i] += (pair & 0xF) * scale + bias;
+            output_row[2 * i + 1] += (pair >> 4) * scale + bias;
+          }
+        }
+        if (mode == kMode_Mean && stop > start) {
+          const float inverse_length = 1.0f / (stop - start);
+          for (int64_t i = 0; i < ddim; ++i) {
+            output_row[i] *= inverse_length;
+          }
+        }
+      }
+    });
+    return output;
+  }
+};
+
+static auto registry = c10::RegisterOperators()
+.op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagBytePrepack>()
+      .dispatchKey(CPUTensorId()))
+.op("quantized::embedding_bag_byte_unpack(Tensor packed_weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagByteUnpack>()
+      .dispatchKey(CPUTensorId()))
+.op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4BitPrepack>()
+      .dispatchKey(CPUTensorId()))
+.op("quantized::embedding_bag_4bit_unpack(Tensor packed_weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4BitUnpack>()
+      .dispatchKey(CPUTensorId()))
+.op("quantized::embedding_bag_byte(Tensor weight, Tensor indices, Tensor offsets, int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagByte>()
+      .dispatchKey(CPUTensorId()))
+.op("quantized::embedding_bag_4bit(Tensor weight, Tensor indices, Tensor offsets, int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4Bit>()
+      .dispatchKey(CPUTensorId()));
+
+}  // namespace
+}}  // namespace at::native
@@ -57,11 +57,13 @@ class QFCInt8 final : public c10::OperatorKernel {
     float input_scale_float = input.q_scale().toFloat();
     int32_t input_zero_point_int32 = input.q_zero_point().toInt();
 
-    float weight_scale_float = pack_ptr.w_scale;
-    int32_t weight_zero_point_int32 = pack_ptr.w_zp;
-
-    float output_multiplier_float = (input_scale_float * weight_scale_float) /
-        static_cast<float>(output_scale);
+    // One multiplier and weight zero point for per tensor quantized weights,
+    // and one per output channel for per channel quantized ones.
+    std::vector<float> output_multiplier_float(pack_ptr.w_scale.size());
+    for (size_t i = 0; i < pack_ptr.w_scale.size(); ++i) {
+      output_multiplier_float[i] = (input_scale_float * pack_ptr.w_scale[i]) /
+          static_cast<float>(output_scale);
+    }
     int32_t output_zero_point_int32 = static_cast<int32_t>(output_zero_point);
 
     // This operation does the following:
@@ -96,21 +98,6 @@ class QFCInt8 final : public c10::OperatorKernel {
     // TODO: contiguous is called for further jit optimizations.
     auto bias_contig = bias.contiguous();
 
-    // After the uint8 * int8 matrix multiplication is performed, this operation
-    // does:
-    //  1) Add in row and column offsets to the rows and columns, respectively.
-    //  2) Add in the bias term.
-    fbgemm::ReQuantizeOutput<ReluFused> outputProcObj(
-        /*nextop=*/doNothingObj,
-        /*C_multiplier=*/&output_multiplier_float,
-        /*C_zero_point=*/output_zero_point_int32,
-        /*Aq_zero_point=*/input_zero_point_int32,
-        /*Bq_zero_point=*/&weight_zero_point_int32,
-        /*row_offsets=*/packA.getRowOffsetBuffer(),
-        /*col_offsets=*/col_offsets.data(),
-        /*bias=*/bias_contig.data<int32_t>(),
-        /*nCol=*/N);
-
     // Allocate output Tensor and a buffer for fbgemmPacked to use
     auto output = _empty_affine_quantized(
         {M, N},
@@ -120,16 +107,60 @@ class QFCInt8 final : public c10::OperatorKernel {
 
     auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
 
-    // Do the GEMM
-    fbgemm::fbgemmPacked(
-        /*packA=*/packA,
-        /*packB=*/*packB,
-        /*C=*/reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
-        /*C_buffer=*/buffer.data<int32_t>(),
-        /*ldc=*/N,
-        /*outProcess=*/outputProcObj,
-        /*thread_id=*/0,
-        /*num_threads=*/1);
+    // After the uint8 * int8 matrix multiplication is performed, this operation
+    // does:
+    //  1) Add in row and column offsets to the rows and columns, respectively.
+    //  2) Add in the bias term.
+    if (pack_ptr.q_scheme == kPerTensorAffine) {
+      fbgemm::ReQuantizeOutput<ReluFused> outputProcObj(
+          /*nextop=*/doNothingObj,
+          /*C_multiplier=*/output_multiplier_float.data(),
+          /*C_zero_point=*/output_zero_point_int32,
+          /*Aq_zero_point=*/input_zero_point_int32,
+          /*Bq_zero_point=*/pack_ptr.w_zp.data(),
+          /*row_offsets=*/packA.getRowOffsetBuffer(),
+          /*col_offsets=*/col_offsets.data(),
+          /*bias=*/bias_contig.data<int32_t>(),
+          /*nCol=*/N);
+
+      // Do the GEMM
+      fbgemm::fbgemmPacked(
+          /*packA=*/packA,
+          /*packB=*/*packB,
+          /*C=*/reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
+          /*C_buffer=*/buffer.data<int32_t>(),
+          /*ldc=*/N,
+          /*outProcess=*/outputProcObj,
+          /*thread_id=*/0,
+          /*num_threads=*/1);
+    } else {
+      // The same, with the multiplier and the weight zero point of each
+      // output channel
+      fbgemm::ReQuantizeOutput<
+          ReluFused,
+          fbgemm::QuantizationGranularity::OUT_CHANNEL>
+          outputProcObj(
+              /*nextop=*/doNothingObj,
+              /*C_multiplier=*/output_multiplier_float.data(),
+              /*C_zero_point=*/output_zero_point_int32,
+              /*Aq_zero_point=*/input_zero_point_int32,
+              /*Bq_zero_point=*/pack_ptr.w_zp.data(),
+              /*row_offsets=*/packA.getRowOffsetBuffer(),
+              /*col_offsets=*/col_offsets.data(),
+              /*bias=*/bias_contig.data<int32_t>(),
+              /*nCol=*/N);
+
+      // Do the GEMM
+      fbgemm::fbgemmPacked(
+          /*packA=*/packA,
+          /*packB=*/*packB,
+          /*C=*/reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
+          /*C_buffer=*/buffer.data<int32_t>(),
+          /*ldc=*/N,
+          /*outProcess=*/outputProcObj,
+          /*thread_id=*/0,
+          /*num_threads=*/1);
+    }
 
     return output;
   }
@@ -0,0 +1,199 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+
+namespace at {
+namespace native {
+namespace {
+
+template <bool ReluFused>
+class QFCDynamicInt8 final : public c10::OperatorKernel {
+ public:
+#ifdef USE_FBGEMM
+  // Quantizes and packs the rows of `input` and multiplies them with the
+  // prepacked weight, dequantizing the results into `output`. The work is
+  // split across the threads, each one with its own packed input.
+  template <fbgemm::QuantizationGranularity Q_GRAN>
+  static void run_dynamic_gemm(
+      const float* input_ptr,
+      int64_t M,
+      int64_t K,
+      int64_t N,
+      const fbgemm::TensorQuantizationParams& q_params,
+      const PackedFCWeight& pack_ptr,
+      const float* bias_ptr,
+      float* output_ptr,
+      int32_t* buffer_ptr) {
+    const int num_tasks = at::get_num_threads();
+    at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t task_id = begin; task_id < end; ++task_id) {
+        // This operation does the following:
+        // 1) Quantizes the input matrix given the statistics we've calculated
+        //    beforehand, in the same pass as the packing
+        // 2) Creates a "row buffer" vector with offset values that must be
+        //    added to the integer matrix multiplication operation to ensure
+        //    correctness
+        // 3) Packs the resulting quantized matrix into vector-register and
+        //    cache friendly tiles.
+        //
+        //  Note this is not executed eagerly, but rather within the
+        //  fbgemmPacked call below.
+        fbgemm::PackAWithQuantRowOffset<uint8_t> packA(
+            /*trans=*/fbgemm::matrix_op_t::NoTranspose,
+            /*nRow=*/M,
+            /*nCol=*/K,
+            /*smat=*/input_ptr,
+            /*ld=*/K,
+            /*pmat=*/nullptr, // packA manages ownership of `pmat`
+            /*scale=*/q_params.scale,
+            /*zero_pt=*/q_params.zero_point);
+
+        // This is the end of the pipeline, pass the resulting matrix through
+        fbgemm::DoNothing<float, float> doNothingObj{};
+
+        // After the uint8 * int8 matrix multiplication is performed, this
+        // operation does:
+        //  1) Add in row and column offsets to the rows and columns,
+        //     respectively
+        //  2) Dequantize the results into floating point
+        //  3) Add in the bias term
+        fbgemm::ReQuantizeForFloat<ReluFused, Q_GRAN> outputProcObj(
+            /*nextop=*/doNothingObj,
+            /*Aq_scale=*/q_params.scale,
+            /*Bq_scale=*/pack_ptr.w_scale.data(),
+            /*Aq_zero_point=*/q_params.zero_point,
+            /*Bq_zero_point=*/pack_ptr.w_zp.data(),
+            /*row_offsets=*/packA.getRowOffsetBuffer(),
+            /*col_offsets=*/pack_ptr.col_offsets.data(),
+            /*bias=*/bias_ptr,
+            /*nCol=*/N);
+
+        // Do the GEMM
+        fbgemm::fbgemmPacked(
+            /*packA=*/packA,
+            /*packB=*/*pack_ptr.w,
+            /*C=*/output_ptr,
+            /*C_buffer=*/buffer_ptr,
+            /*ldc=*/N,
+            /*outProcess=*/outputProcObj,
+            /*thread_id=*/task_id,
+            /*num_threads=*/num_tasks);
+      }
+    });
+  }
+
+  at::Tensor operator()(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      at::Tensor bias) {
+    // fp32 * int8 -> fp32, quantizing the input on the fly
+
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
+
+    // TODO: contiguous is called for further jit optimizations.
+    auto input_contig = input.contiguous();
+    const auto* input_ptr = input_contig.data<float>();
+
+    AT_ASSERT(input.dim() >= 2);
+    // C(output) = A(input) x B(weight), where C, A, B are M x N, M x K, K x N
+    // matrices, respectively.
+    int64_t M = 1;
+    for (size_t i = 0; i < input.dim() - 1; ++i) {
+      M *= input.size(i);
+    }
+
+    // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
+    auto& pack_ptr = cpp_custom_type_hack::cast<PackedFCWeight>(packed_weight);
+    auto packB = pack_ptr.w.get();
+
+    int64_t N = static_cast<int64_t>(packB->numCols());
+    int64_t K = input.size(input.dim() - 1);
+    AT_ASSERT(K == static_cast<int64_t>(packB->numRows()));
+    AT_ASSERT(bias.size(0) == N);
+    AT_ASSERT(bias.dim() == 1);
+
+    // Calculate statistics for quantization of the input Tensor
+    float x_min, x_max;
+    fbgemm::FindMinMax(
+        /*m=*/input_ptr,
+        /*min=*/&x_min,
+        /*max=*/&x_max,
+        /*len=*/input.numel());
+
+    // Input tensor is quantized as 8-bit unsigned values
+    static constexpr int precision = 8;
+    static constexpr bool is_signed = false;
+
+    // Calculate scale and zero point for quantization of input tensor
+    auto q_params = fbgemm::ChooseQuantizationParams(
+        /*min=*/x_min,
+        /*max=*/x_max,
+        /*qmin=*/is_signed ? -(1 << (precision - 1)) : 0,
+        /*qmax=*/is_signed ? ((1 << (precision - 1)) - 1) : (1 << precision) - 1,
+        /*preserve_sparsity=*/false);
+    q_params.precision = precision;
+
+    // TODO: contiguous is called for further jit optimizations.
+    auto bias_contig = bias.contiguous();
+
+    // Allocate output Tensor and a buffer for fbgemmPacked to use
+    auto output = at::zeros({M, N}, bias.options().dtype(at::kFloat));
+    auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
+
+    if (pack_ptr.q_scheme == kPerTensorAffine) {
+      run_dynamic_gemm<fbgemm::QuantizationGranularity::TENSOR>(
+          input_ptr, M, K, N, q_params, pack_ptr, bias_contig.data<float>(),
+          output.data<float>(), buffer.data<int32_t>());
+    } else {
+      // The scale and the zero point of each output channel
+      run_dynamic_gemm<fbgemm::QuantizationGranularity::OUT_CHANNEL>(
+          input_ptr, M, K, N, q_params, pack_ptr, bias_contig.data<float>(),
+          output.data<float>(), buffer.data<int32_t>());
+    }
+
+    // The resulting matrix here is 2-D, let's view it with the original
+    // left hand dimensions of the input.
+    std::vector<int64_t> out_sizes = input.sizes().vec();
+    out_sizes.back() = N;
+    return output.view(out_sizes);
+  }
+#else // USE_FBGEMM
+  at::Tensor operator()(
+      at::Tensor /* input */,
+      at::Tensor /* packed_weight */,
+      at::Tensor /* bias */) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        false, "This PyTorch installation was not built with FBGEMM operators");
+  }
+#endif // USE_FBGEMM
+};
+
+// The input and the output are float tensors, the weight comes from
+// quantized::fbgemm_linear_prepack. The input is quantized with the range it
+// has on each call, so no calibration is needed.
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::linear_dynamic(Tensor X, Tensor W_prepack, Tensor b) -> Tensor Y",
+            c10::RegisterOperators::options()
+              .kernel<QFCDynamicInt8<false>>()
+              .dispatchKey(CPUTensorId()))
+        .op("quantized::linear_relu_dynamic(Tensor X, Tensor W_prepack, Tensor b) -> Tensor Y",
+            c10::RegisterOperators::options()
+              .kernel<QFCDynamicInt8<true>>()
+              .dispatchKey(CPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
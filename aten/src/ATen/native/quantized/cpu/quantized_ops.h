@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// out = requantize(dequantize(self) + dequantize(other)), with the scale and
+// zero point of `out`, computed without materializing the float tensors
+using qbinary_fn = void(*)(Tensor& /*out*/, const Tensor& /*self*/, const Tensor& /*other*/);
+
+DECLARE_DISPATCH(qbinary_fn, qadd_stub);
+DECLARE_DISPATCH(qbinary_fn, qadd_relu_stub);
+
+// Adds to `counts`, a long tensor of bins evenly dividing [min, max], the
+// number of the elements of the contiguous `self` in each bin. Elements out
+// of the range count in the first or last bin.
+using histogram_fn = void(*)(Tensor& /*counts*/, const Tensor& /*self*/, double /*min*/, double /*max*/);
+
+DECLARE_DISPATCH(histogram_fn, histogram_stub);
+
+}}  // namespace at::native
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at { namespace native {
+
+// Note [Fake quantization]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// Fake quantization rounds x to the grid of affine quantization, and
+// dequantizes it again:
+//   q = floor(x / scale + 0.5) + zero_point
+//   y = (clamp(q, quant_min, quant_max) - zero_point) * scale
+// The gradient passes straight through where q is within [quant_min,
+// quant_max] and is 0 elsewhere. The forward kernels also return that mask
+// (1 or 0, in the dtype of x), so that the backward pass of a training step is
+// one multiplication instead of a second fake quantization.
+
+// Operands: y, mask, x; or dx, x, dy for the gradient
+using fake_quant_tensor_fn = void (*)(
+    TensorIterator& iter,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max);
+
+// Operands: y, mask, x, scale, zero_point; with the float scales and zero
+// points of the channels broadcast to the sizes of x
+using fake_quant_channel_fn = void (*)(
+    TensorIterator& iter,
+    int64_t quant_min,
+    int64_t quant_max);
+
+DECLARE_DISPATCH(fake_quant_tensor_fn, fake_quant_tensor_stub);
+DECLARE_DISPATCH(fake_quant_tensor_fn, fake_quant_grad_tensor_stub);
+DECLARE_DISPATCH(fake_quant_channel_fn, fake_quant_channel_stub);
+
+}} // namespace at::native
@@ -10,6 +10,9 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -347,6 +350,111 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+namespace {
+
+// Splits [0, n) into at most one chunk per thread. Both the radix sort and the
+// run detection below iterate over chunks instead of letting parallel_for pick
+// the ranges, because their scatter phases must see the same chunks as their
+// counting phases.
+struct Chunks {
+  explicit Chunks(int64_t n, int64_t min_chunk_size) : n(n) {
+    num = std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), n / min_chunk_size));
+    size = (n + num - 1) / num;
+  }
+  int64_t begin(int64_t c) const { return std::min(n, c * size); }
+  int64_t end(int64_t c) const { return std::min(n, (c + 1) * size); }
+
+  int64_t n;
+  int64_t num;
+  int64_t size;
+};
+
+// Stable LSD radix sort of keys in [0, max_key] that applies the same permutation
+// to perm. Every pass histograms one digit per chunk in parallel, turns the
+// histograms into scatter offsets, and scatters all chunks in parallel. Keeping the
+// chunks in order keeps the sort stable, which is what makes LSD passes compose.
+void radix_sort_by_key(int64_t* keys, int64_t* perm, int64_t n, int64_t max_key) {
+  constexpr int kRadixBits = 8;
+  constexpr int64_t kRadix = 1 << kRadixBits;
+  Chunks chunks(n, kRadix);
+  std::vector<int64_t> keys_buffer(n);
+  std::vector<int64_t> perm_buffer(n);
+  std::vector<int64_t> offsets(chunks.num * kRadix);
+  int64_t* keys_in = keys;
+  int64_t* perm_in = perm;
+  int64_t* keys_out = keys_buffer.data();
+  int64_t* perm_out = perm_buffer.data();
+
+  for (int shift = 0; shift < 64 && (max_key >> shift) != 0; shift += kRadixBits) {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    at::parallel_for(0, chunks.num, 1, [&](int64_t c_begin, int64_t c_end) {
+      for (int64_t c = c_begin; c < c_end; c++) {
+        int64_t* histogram = &offsets[c * kRadix];
+        for (int64_t j = chunks.begin(c); j < chunks.end(c); j++) {
+          histogram[(keys_in[j] >> shift) & (kRadix - 1)]++;
+        }
+      }
+    });
+    // Exclusive scan in (digit, chunk) order gives every chunk its slots for every digit
+    int64_t total = 0;
+    for (int64_t d = 0; d < kRadix; d++) {
+      for (int64_t c = 0; c < chunks.num; c++) {
+        int64_t count = offsets[c * kRadix + d];
+        offsets[c * kRadix + d] = total;
+        total += count;
+      }
+    }
+    at::parallel_for(0, chunks.num, 1, [&](int64_t c_begin, int64_t c_end) {
+      for (int64_t c = c_begin; c < c_end; c++) {
+        int64_t* offset = &offsets[c * kRadix];
+        for (int64_t j = chunks.begin(c); j < chunks.end(c); j++) {
+          int64_t pos = offset[(keys_in[j] >> shift) & (kRadix - 1)]++;
+          keys_out[pos] = keys_in[j];
+          perm_out[pos] = perm_in[j];
+        }
+      }
+    });
+    std::swap(keys_in, keys_out);
+    std::swap(perm_in, perm_out);
+  }
+
+  if (keys_in != keys) {
+    std::copy(keys_in, keys_in + n, keys);
+    std::copy(perm_in, perm_in + n, perm);
+  }
+}
+
+// Returns the start of every run of equal keys in the sorted keys, followed by n.
+std::vector<int64_t> find_runs(const int64_t* keys, int64_t n) {
+  Chunks chunks(n, internal::GRAIN_SIZE);
+  std::vector<int64_t> chunk_offsets(chunks.num + 1, 0);
+  at::parallel_for(0, chunks.num, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      int64_t count = 0;
+      for (int64_t j = chunks.begin(c); j < chunks.end(c); j++) {
+        count += (j == 0 || keys[j] != keys[j - 1]);
+      }
+      chunk_offsets[c + 1] = count;
+    }
+  });
+  std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  std::vector<int64_t> run_starts(chunk_offsets.back() + 1);
+  at::parallel_for(0, chunks.num, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      int64_t i = chunk_offsets[c];
+      for (int64_t j = chunks.begin(c); j < chunks.end(c); j++) {
+        if (j == 0 || keys[j] != keys[j - 1]) {
+          run_starts[i++] = j;
+        }
+      }
+    }
+  });
+  run_starts.back() = n;
+  return run_starts;
+}
+
+} // namespace
+
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   AT_ASSERT(!self.is_variable());  // TODO: change this to check `.requires_grad()` and `GradMode::is_enabled()` when Variable and Tensor are merged
@@ -369,53 +477,52 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  // Sort the linearized indices, then sum every run of equal indices into one entry
+  LongTensor indicesBuffer = flatten_indices(indices, self.sizes(), /*force_clone=*/true).contiguous();
+  LongTensor indicesPermutation = at::arange(nnz, indices.options());
+  int64_t* indicesBuffer_ptr = indicesBuffer.data<int64_t>();
+  int64_t* indicesPermutation_ptr = indicesPermutation.data<int64_t>();
+  radix_sort_by_key(indicesBuffer_ptr, indicesPermutation_ptr, nnz, indicesBuffer.max().item<int64_t>());
+  std::vector<int64_t> runStarts = find_runs(indicesBuffer_ptr, nnz);
+  int64_t newNnz = runStarts.size() - 1;
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
   // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = at::empty(indices.sizes(), indices.options());
-  Tensor newValues = at::empty(values.sizes(), values.options());
-  alias_into_sparse(dst, newIndices, newValues);
-
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
+  LongTensor newIndices = at::empty({sparse_dim, newNnz}, indices.options());
+  std::vector<int64_t> newValuesSize = values.sizes().vec();
+  newValuesSize[0] = newNnz;
+  Tensor newValues = at::empty(newValuesSize, values.options());
   // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
 
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data<scalar_t>();
         scalar_t* newValues_ptr = newValues.data<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, sparse_dim + blockSize));
+        at::parallel_for(0, newNnz, grain_size, [&](int64_t start, int64_t end) {
+          for (int64_t i = start; i < end; i++) {
+            int64_t first = indicesPermutation_ptr[runStarts[i]];
             for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][i] = indicesAccessor[d][first];
             }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            if (values.numel() == 0) {  // if values is an empty tensor, there are no elements to copy
+              continue;
+            }
+            THBlas_copy<scalar_t>(blockSize, values_ptr + first * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            for (int64_t j = runStarts[i] + 1; j < runStarts[i + 1]; j++) {
+              int64_t pos = indicesPermutation_ptr[j];
+              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
             }
           }
-          prev = curr;
-        }
+        });
     });
 
+  alias_into_sparse(dst, newIndices, newValues);
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
 
   return dst;
 }
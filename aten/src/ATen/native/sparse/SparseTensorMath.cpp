@@ -482,8 +482,6 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 
 template <typename scalar_t>
 void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
-
   // r_ = alpha * sparse * dense
   scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
@@ -497,8 +495,12 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
-  auto indices_accessor = indices.accessor<int64_t, 2>();
+  // The indices are coalesced, so the nonzeros of each row are next to each
+  // other, and the rows of r can be computed in parallel.
+  LongTensor csr = _to_csr(indices.data<int64_t>(), dim_i, nnz);
+  auto csr_accessor = csr.accessor<int64_t, 1>();
 
+  auto indices_accessor = indices.accessor<int64_t, 2>();
   auto values_accessor = values.accessor<scalar_t, 1>();
   scalar_t* dense_ptr = dense.data<scalar_t>();
   scalar_t* r_ptr = r.data<scalar_t>();
@@ -507,23 +509,17 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
-    int64_t row = indices_accessor[0][i];
-    int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+  int64_t row_cost = std::max<int64_t>(nnz / dim_i * dim_k, 1);
+  at::parallel_for(0, dim_i, std::max<int64_t>(at::internal::GRAIN_SIZE / row_cost, 1), [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      for (int64_t i = csr_accessor[row]; i < csr_accessor[row + 1]; i++) {
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * values_accessor[i],
+              dense_ptr + indices_accessor[1][i] * dense_stride0, dense_stride1,
+              r_ptr + row * r_stride0, r_stride1);
       }
     }
-  }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -565,8 +561,23 @@ Tensor& s_addmm_out_sparse_dense_cpu(
     return r;
   }
 
-  LongTensor indices = sparse_._indices();
-  Tensor values      = sparse_._values();
+  // Coalescing flattens the indices, so out of bound indices are reported
+  // before they could alias in bound ones
+  auto indices_accessor = sparse_._indices().accessor<int64_t, 2>();
+  for (int64_t i = 0; i < nnz; i++) {
+    int64_t row = indices_accessor[0][i];
+    int64_t col = indices_accessor[1][i];
+    if (col < 0 || col >= dim_j) {
+      AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+    } else if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+    }
+  }
+
+  SparseTensor sparse = sparse_.coalesce();
+  nnz                = sparse._nnz();
+  LongTensor indices = sparse._indices().contiguous();
+  Tensor values      = sparse._values();
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
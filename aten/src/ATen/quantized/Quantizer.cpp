@@ -1,6 +1,7 @@
 #include <ATen/quantized/Quantizer.h>
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/Type.h>
 #include <ATen/native/TensorFactories.h>
 #include <ATen/quantized/QTensorImpl.h>
@@ -64,42 +65,39 @@ T quantize_val(float scale, int32_t zero_point, float value) {
   return static_cast<T>(qvalue);
 }
 
+// Quantizes/dequantizes `count` contiguous values with the same parameters
 template <typename T>
-Tensor quantize_tensor(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point) {
-  auto fn_name = "quantize_tensor";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const float* rd = rtensor.data<float>();
-  auto qd = reinterpret_cast<typename T::underlying*>(qtensor.data<T>());
+void quantize_vec(
+    const float* src,
+    typename T::underlying* dst,
+    int64_t count,
+    float scale,
+    int32_t zero_point) {
   fbgemm::TensorQuantizationParams qparams;
   qparams.scale = scale;
   qparams.zero_point = zero_point;
   qparams.precision = std::numeric_limits<typename T::underlying>::digits;
-  fbgemm::Quantize<typename T::underlying>(/*src=*/rd,
-                             /*dst=*/qd,
-                             /*len=*/rtensor.numel(),
+  fbgemm::Quantize<typename T::underlying>(/*src=*/src,
+                             /*dst=*/dst,
+                             /*len=*/count,
                              /*qparams=*/qparams);
-  return qtensor;
 }
 
 template <typename T>
-Tensor dequantize_tensor(Tensor qtensor, Tensor rtensor, float scale, int32_t zero_point) {
-  auto fn_name = "dequantize_tensor";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const auto* qd = reinterpret_cast<const typename T::underlying*>(qtensor.data<T>());
+void dequantize_vec(
+    const typename T::underlying* src,
+    float* dst,
+    int64_t count,
+    float scale,
+    int32_t zero_point) {
   fbgemm::TensorQuantizationParams qparams;
   qparams.scale = scale;
   qparams.zero_point = zero_point;
   qparams.precision = std::numeric_limits<typename T::underlying>::digits;
-  float* rd = rtensor.data<float>();
-  fbgemm::Dequantize<typename T::underlying>(/*src=*/qd,
-                              /*dst=*/rd,
-                              /*len=*/qtensor.numel(),
+  fbgemm::Dequantize<typename T::underlying>(/*src=*/src,
+                              /*dst=*/dst,
+                              /*len=*/count,
                               /*qparams=*/qparams);
-  return rtensor;
 }
 #else
 
@@ -122,17 +120,54 @@ T quantize_val(float scale, int32_t zero_point, float value) {
   return static_cast<T>(qvalue);
 }
 
+// Quantizes/dequantizes `count` contiguous values with the same parameters.
+// The same as quantize_val, without checking the zero point again for every
+// element, so that the loop can be vectorized.
+template <typename T>
+void quantize_vec(
+    const float* src,
+    typename T::underlying* dst,
+    int64_t count,
+    float scale,
+    int32_t zero_point) {
+  constexpr int64_t qmin = std::numeric_limits<typename T::underlying>::min();
+  constexpr int64_t qmax = std::numeric_limits<typename T::underlying>::max();
+  for (int64_t i = 0; i < count; ++i) {
+    float value = std::nearbyint(src[i] / scale + zero_point);
+    value = std::max(value, static_cast<float>(qmin));
+    value = std::min(value, static_cast<float>(qmax));
+    // the float qmax of qint32 is rounded up to 2^31
+    int64_t qvalue = std::min(static_cast<int64_t>(value), qmax);
+    dst[i] = static_cast<typename T::underlying>(qvalue);
+  }
+}
+
+template <typename T>
+void dequantize_vec(
+    const typename T::underlying* src,
+    float* dst,
+    int64_t count,
+    float scale,
+    int32_t zero_point) {
+  for (int64_t i = 0; i < count; ++i) {
+    // We need to convert the qint8 value to float to ensure the subtraction
+    // subexpression returns a float
+    dst[i] = (static_cast<float>(src[i]) - zero_point) * scale;
+  }
+}
+#endif
+
 template <typename T>
 Tensor quantize_tensor(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point) {
   auto fn_name = "quantize_tensor";
   checkFloatCPUTensor(fn_name, rtensor);
   checkQuantizedCPUTensor<T>(fn_name, qtensor);
   checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const float* rdata = rtensor.data<float>();
-  auto qdata = qtensor.data<T>();
-  for (int i = 0; i < rtensor.numel(); ++i) {
-    qdata[i] = quantize_val<T>(scale, zero_point, rdata[i]);
-  }
+  const float* rd = rtensor.data<float>();
+  auto qd = reinterpret_cast<typename T::underlying*>(qtensor.data<T>());
+  at::parallel_for(0, rtensor.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    quantize_vec<T>(rd + begin, qd + begin, end - begin, scale, zero_point);
+  });
   return qtensor;
 }
 
@@ -142,16 +177,94 @@ Tensor dequantize_tensor(Tensor qtensor, Tensor rtensor, float scale, int32_t ze
   checkFloatCPUTensor(fn_name, rtensor);
   checkQuantizedCPUTensor<T>(fn_name, qtensor);
   checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const auto* qd = qtensor.data<T>();
+  const auto* qd = reinterpret_cast<const typename T::underlying*>(qtensor.data<T>());
   float* rd = rtensor.data<float>();
-  for (auto i = 0; i < qtensor.numel(); ++i) {
-    // We need to convert the qint8 value to float to ensure the subtraction
-    // subexpression returns a float
-    rd[i] = (static_cast<float>(qd[i].val_) - zero_point) * scale;
+  at::parallel_for(0, qtensor.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    dequantize_vec<T>(qd + begin, rd + begin, end - begin, scale, zero_point);
+  });
+  return rtensor;
+}
+
+// Calls `f(offset, count, c)` in parallel on the runs of `count` elements of
+// the contiguous tensor `t` that are in the same slice c of `axis`
+template <typename F>
+void parallel_channel_runs(const Tensor& t, int64_t axis, const F& f) {
+  int64_t outer = 1;
+  for (int64_t d = 0; d < axis; ++d) {
+    outer *= t.size(d);
+  }
+  const int64_t channels = t.size(axis);
+  const int64_t inner = t.numel() / std::max<int64_t>(outer * channels, 1);
+  at::parallel_for(
+      0,
+      outer * channels,
+      std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(inner, 1), 1),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t run = begin; run < end; ++run) {
+          f(run * inner, inner, run % channels);
+        }
+      });
+}
+
+template <typename T>
+void checkPerChannelParams(
+    std::string fn_name,
+    const Tensor& t,
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    int64_t axis) {
+  TORCH_CHECK(
+      axis >= 0 && axis < t.dim(),
+      fn_name,
+      " axis is out of range.");
+  TORCH_CHECK(
+      static_cast<int64_t>(scales.size()) == t.size(axis) &&
+          static_cast<int64_t>(zero_points.size()) == t.size(axis),
+      fn_name,
+      " expects as many scales and zero_points as the size of the axis.");
+  for (int32_t zero_point : zero_points) {
+    checkZeroPoint<typename T::underlying>(fn_name, zero_point);
   }
+}
+
+template <typename T>
+Tensor quantize_tensor_per_channel_affine(
+    Tensor rtensor,
+    Tensor qtensor,
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    int64_t axis) {
+  auto fn_name = "quantize_tensor_per_channel_affine";
+  checkFloatCPUTensor(fn_name, rtensor);
+  checkQuantizedCPUTensor<T>(fn_name, qtensor);
+  checkPerChannelParams<T>(fn_name, rtensor, scales, zero_points, axis);
+  const float* rd = rtensor.data<float>();
+  auto qd = reinterpret_cast<typename T::underlying*>(qtensor.data<T>());
+  parallel_channel_runs(rtensor, axis, [&](int64_t offset, int64_t count, int64_t c) {
+    quantize_vec<T>(rd + offset, qd + offset, count, scales[c], zero_points[c]);
+  });
+  return qtensor;
+}
+
+template <typename T>
+Tensor dequantize_tensor_per_channel_affine(
+    Tensor qtensor,
+    Tensor rtensor,
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    int64_t axis) {
+  auto fn_name = "dequantize_tensor_per_channel_affine";
+  checkFloatCPUTensor(fn_name, rtensor);
+  checkQuantizedCPUTensor<T>(fn_name, qtensor);
+  checkPerChannelParams<T>(fn_name, qtensor, scales, zero_points, axis);
+  const auto* qd = reinterpret_cast<const typename T::underlying*>(qtensor.data<T>());
+  float* rd = rtensor.data<float>();
+  parallel_channel_runs(qtensor, axis, [&](int64_t offset, int64_t count, int64_t c) {
+    dequantize_vec<T>(qd + offset, rd + offset, count, scales[c], zero_points[c]);
+  });
   return rtensor;
 }
-#endif
+
 template CAFFE2_API qint8 quantize_val<qint8>(float scale, int32_t zero_point, float value);
 template CAFFE2_API quint8 quantize_val<quint8>(float scale, int32_t zero_point, float value);
 template CAFFE2_API qint32 quantize_val<qint32>(float scale, int32_t zero_point, float value);
@@ -161,6 +274,12 @@ template CAFFE2_API Tensor quantize_tensor<qint32>(Tensor rtensor, Tensor qtenso
 template CAFFE2_API Tensor dequantize_tensor<qint8>(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point);
 template CAFFE2_API Tensor dequantize_tensor<quint8>(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point);
 template CAFFE2_API Tensor dequantize_tensor<qint32>(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point);
+template CAFFE2_API Tensor quantize_tensor_per_channel_affine<qint8>(Tensor rtensor, Tensor qtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
+template CAFFE2_API Tensor quantize_tensor_per_channel_affine<quint8>(Tensor rtensor, Tensor qtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
+template CAFFE2_API Tensor quantize_tensor_per_channel_affine<qint32>(Tensor rtensor, Tensor qtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
+template CAFFE2_API Tensor dequantize_tensor_per_channel_affine<qint8>(Tensor qtensor, Tensor rtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
+template CAFFE2_API Tensor dequantize_tensor_per_channel_affine<quint8>(Tensor qtensor, Tensor rtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
+template CAFFE2_API Tensor dequantize_tensor_per_channel_affine<qint32>(Tensor qtensor, Tensor rtensor, const std::vector<float>& scales, const std::vector<int32_t>& zero_points, int64_t axis);
 
 QuantizerPtr make_per_tensor_affine_quantizer(
     double scale,
@@ -170,6 +289,15 @@ QuantizerPtr make_per_tensor_affine_quantizer(
       static_cast<float>(scale), static_cast<int32_t>(zero_point));
 }
 
+QuantizerPtr make_per_channel_affine_quantizer(
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    const std::vector<int64_t>& axis,
+    ScalarType scalar_type) {
+  return c10::make_intrusive<PerChannelAffineQuantizer>(scalar_type,
+      scales, zero_points, axis);
+}
+
 QTensorImpl* get_qtensorimpl(const Tensor& self) {
   // TODO: remove this when Variable and Tensor are merged
   AT_ASSERTM(
@@ -242,6 +370,61 @@ Tensor PerTensorAffineQuantizer::dequantize(Tensor qtensor) {
   return rtensor;
 }
 
+Tensor PerChannelAffineQuantizer::quantize(Tensor rtensor) {
+  TORCH_CHECK(
+      rtensor.scalar_type() == kFloat,
+      "quantize only works on Float Tensor.");
+  TORCH_CHECK(
+      rtensor.device() == kCPU,
+      "quantize only works for CPU backend right now.");
+  Tensor qtensor = new_qtensor_cpu(
+      rtensor.sizes(),
+      rtensor.options().dtype(scalar_type_),
+      intrusive_from_this());
+
+  rtensor = rtensor.contiguous();
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor_per_channel_affine", [&]() {
+    qtensor = quantize_tensor_per_channel_affine<scalar_t>(
+        rtensor, qtensor, scales_, zero_points_, axis_[0]);
+  });
+  return qtensor;
+}
+
+Tensor PerChannelAffineQuantizer::dequantize(Tensor qtensor) {
+  TORCH_CHECK(qtensor.is_quantized(),
+           "dequantize is only supported in quantized Tensor.");
+  TORCH_CHECK(
+      qtensor.device() == kCPU,
+      "dequantize only works for CPU backend right now.");
+  Tensor rtensor = at::empty(qtensor.sizes(), qtensor.options().dtype(at::kFloat));
+  qtensor = qtensor.contiguous();
+
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "dequantize_tensor_per_channel_affine", [&]() {
+    rtensor = dequantize_tensor_per_channel_affine<scalar_t>(
+        qtensor, rtensor, scales_, zero_points_, axis_[0]);
+  });
+
+  return rtensor;
+}
+
+bool PerTensorAffineQuantizer::equalTo(QuantizerPtr other) {
+  if (other->qscheme() != kPerTensorAffine || other->scalar_type() != scalar_type_) {
+    return false;
+  }
+  auto* other_affine = static_cast<PerTensorAffineQuantizer*>(other.get());
+  return other_affine->scale() == scale_ && other_affine->zero_point() == zero_point_;
+}
+
+bool PerChannelAffineQuantizer::equalTo(QuantizerPtr other) {
+  if (other->qscheme() != kPerChannelAffine || other->scalar_type() != scalar_type_) {
+    return false;
+  }
+  auto* other_affine = static_cast<PerChannelAffineQuantizer*>(other.get());
+  return other_affine->scales() == scales_ &&
+      other_affine->zero_points() == zero_points_ &&
+      other_affine->axis() == axis_;
+}
+
 Quantizer::~Quantizer() {}
 
 } // namespace at
@@ -73,6 +73,12 @@ struct CAFFE2_API Quantizer : public c10::intrusive_ptr_target {
    * dequantize a quantized Tensor into a float Tensor.
    */
   virtual Tensor dequantize(Tensor t) = 0;
+
+  /**
+   * Whether `other` maps the quantized values to the same float values, in
+   * which case the values of tensors quantized by either can be copied as is.
+   */
+  virtual bool equalTo(QuantizerPtr other) = 0;
 };
 
 /**
@@ -177,6 +183,7 @@ struct CAFFE2_API PerTensorAffineQuantizer : public AffineQuantizer {
 
   Tensor quantize(Tensor tensor) override;
   Tensor dequantize(Tensor tensor) override;
+  bool equalTo(QuantizerPtr other) override;
 
   float scale() const {
     return scale_;
@@ -210,8 +217,15 @@ struct CAFFE2_API PerChannelAffineQuantizer : public AffineQuantizer {
     TORCH_CHECK(
         axis_.size() == 1,
         "Per channel affine quantization in multiple axis is not supported yet.");
+    TORCH_CHECK(
+        scales_.size() == zero_points_.size(),
+        "Per channel affine quantization expects as many scales as zero_points.");
   }
 
+  Tensor quantize(Tensor tensor) override;
+  Tensor dequantize(Tensor tensor) override;
+  bool equalTo(QuantizerPtr other) override;
+
   std::vector<float> scales() const {
     return scales_;
   }
@@ -244,12 +258,33 @@ template <typename T>
 CAFFE2_API Tensor quantize_tensor(Tensor rtensor, Tensor qtensor, float scale, int32_t zero_point);
 template <typename T>
 CAFFE2_API Tensor dequantize_tensor(Tensor qtensor, Tensor rtensor, float scale, int32_t zero_point);
+// The same, with scales[c] and zero_points[c] for the slice c of `axis`
+template <typename T>
+CAFFE2_API Tensor quantize_tensor_per_channel_affine(
+    Tensor rtensor,
+    Tensor qtensor,
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    int64_t axis);
+template <typename T>
+CAFFE2_API Tensor dequantize_tensor_per_channel_affine(
+    Tensor qtensor,
+    Tensor rtensor,
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    int64_t axis);
 
 // double and int64_t are because of the native function API, we only have these
 // argument types right now in native functions
 CAFFE2_API QuantizerPtr
 make_per_tensor_affine_quantizer(double scale, int64_t zero_point, ScalarType scalar_type);
 
+CAFFE2_API QuantizerPtr make_per_channel_affine_quantizer(
+    const std::vector<float>& scales,
+    const std::vector<int32_t>& zero_points,
+    const std::vector<int64_t>& axis,
+    ScalarType scalar_type);
+
 // Create a Quantized Tensor given arguments for normal Tensor and a quantizer
 CAFFE2_API Tensor new_qtensor_cpu(
     IntArrayRef sizes,
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <vector>
+
+using namespace at;
+
+// The intra-op backend is chosen once per process, so select the native
+// work-stealing backend before anything in ATen queries it.
+#ifndef _WIN32
+static int select_native_backend = setenv("ATEN_INTRAOP_BACKEND", "native", 1);
+#endif
+
+TEST(TestNativeParallel, CoversRangeExactlyOnce) {
+  if (!internal::use_native_intraop()) {
+    return;
+  }
+  std::vector<std::atomic<int>> counts(100000);
+  for (auto& count : counts) {
+    count = 0;
+  }
+  at::parallel_for(0, counts.size(), 1, [&](int64_t begin, int64_t end) {
+    ASSERT_LT(at::get_thread_num(), at::get_num_threads());
+    for (int64_t i = begin; i < end; i++) {
+      counts[i]++;
+    }
+  });
+  for (auto& count : counts) {
+    ASSERT_EQ(count.load(), 1);
+  }
+}
+
+TEST(TestNativeParallel, NestedParallelFor) {
+  if (!internal::use_native_intraop()) {
+    return;
+  }
+  std::atomic<int64_t> total{0};
+  at::parallel_for(0, 64, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      // uneven inner work, as with ragged bags
+      at::parallel_for(0, i * 1000, 1, [&](int64_t inner_begin, int64_t inner_end) {
+        ASSERT_TRUE(at::in_parallel_region());
+        total += inner_end - inner_begin;
+      });
+    }
+  });
+  ASSERT_EQ(total.load(), 1000 * (63 * 64 / 2));
+}
+
+TEST(TestNativeParallel, Reductions) {
+  Tensor a = ones({1024, 1024});
+  ASSERT_EQ(a.sum().item<float>(), 1024 * 1024);
+  ASSERT_TRUE(a.sum(0).equal(full({1024}, 1024)));
+  auto result = at::parallel_reduce(
+      0, 100000, 1000, (int64_t)0,
+      [](int64_t begin, int64_t end, int64_t ident) { return ident + (end - begin); },
+      [](int64_t x, int64_t y) { return x + y; });
+  ASSERT_EQ(result, 100000);
+}
+
+TEST(TestNativeParallel, Exceptions) {
+  ASSERT_THROW(
+    at::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+      throw std::runtime_error("exception");
+    }),
+    std::runtime_error);
+}
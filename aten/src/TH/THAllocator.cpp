@@ -19,14 +19,68 @@
 #include <fcntl.h>
 #include <unistd.h>
 #endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 /* end of stuff for mapped files */
 
+#include <vector>
+
 at::Allocator* getTHDefaultAllocator() {
   return c10::GetCPUAllocator();
 }
 
 #define TH_ALLOC_ALIGNMENT 64
 
+namespace {
+std::atomic<bool> shared_memory_huge_pages{false};
+std::atomic<int> shared_memory_numa_node{-1};
+
+#if HAVE_MMAP
+// Applies the THSharedMemoryPlacement to a fresh shared mapping. Failures are
+// ignored, the mapping is just as usable with the default placement.
+void applySharedMemoryPlacement(void* ptr, size_t size) {
+#if defined(__linux__)
+#ifdef MADV_HUGEPAGE
+  if (shared_memory_huge_pages.load()) {
+    madvise(ptr, size, MADV_HUGEPAGE);
+  }
+#endif
+#ifdef SYS_mbind
+  const int numa_node = shared_memory_numa_node.load();
+  if (numa_node >= 0) {
+    // From <numaif.h>, which we don't want to depend on for this
+    constexpr int kMpolPreferred = 1;
+    constexpr int kBitsPerMask = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> nodemask(numa_node / kBitsPerMask + 1, 0);
+    nodemask[numa_node / kBitsPerMask] |= 1UL << (numa_node % kBitsPerMask);
+    syscall(
+        SYS_mbind,
+        ptr,
+        size,
+        kMpolPreferred,
+        nodemask.data(),
+        nodemask.size() * kBitsPerMask + 1,
+        0);
+  }
+#endif
+#endif
+}
+#endif
+} // namespace
+
+void THSetSharedMemoryPlacement(THSharedMemoryPlacement placement) {
+  shared_memory_huge_pages = placement.huge_pages;
+  shared_memory_numa_node = placement.numa_node;
+}
+
+THSharedMemoryPlacement THGetSharedMemoryPlacement() {
+  THSharedMemoryPlacement placement;
+  placement.huge_pages = shared_memory_huge_pages.load();
+  placement.numa_node = shared_memory_numa_node.load();
+  return placement;
+}
+
 #if defined(_WIN32) || defined(HAVE_MMAP)
 
 typedef struct {
@@ -288,6 +342,8 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
 
     if (base_ptr_ == MAP_FAILED) {
       base_ptr_ = nullptr; /* let's be sure it is NULL */
+    } else if (flags_ & (TH_ALLOCATOR_MAPPED_SHARED | TH_ALLOCATOR_MAPPED_SHAREDMEM)) {
+      applySharedMemoryPlacement(base_ptr_, size_);
     }
 
     if (flags_ & TH_ALLOCATOR_MAPPED_KEEPFD) {
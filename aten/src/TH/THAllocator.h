@@ -17,6 +17,24 @@
  */
 TH_API c10::Allocator* getTHDefaultAllocator(void);
 
+// Where the pages of shared memory mappings (that is, of THMapAllocators with
+// TH_ALLOCATOR_MAPPED_SHARED or TH_ALLOCATOR_MAPPED_SHAREDMEM) are placed.
+// This is a process-wide setting that only affects mappings made afterwards,
+// and is best effort: it is ignored where the OS doesn't support it.
+struct THSharedMemoryPlacement {
+  // Ask for transparent huge pages (madvise(MADV_HUGEPAGE)). For shm segments
+  // this requires shmem_enabled to be "advise" (or "always") in
+  // /sys/kernel/mm/transparent_hugepage.
+  bool huge_pages = false;
+  // Prefer allocating the pages on this NUMA node (mbind(MPOL_PREFERRED)), or
+  // leave them to the default policy if negative. The policy of a shared
+  // segment is shared by all processes that map it.
+  int numa_node = -1;
+};
+
+CAFFE2_API void THSetSharedMemoryPlacement(THSharedMemoryPlacement placement);
+CAFFE2_API THSharedMemoryPlacement THGetSharedMemoryPlacement();
+
 // Sentinel value/type to help distinguish the file descriptor constructor from
 // the non-file descriptor constructor
 enum WithFd { WITH_FD };
@@ -13,6 +13,10 @@
 
 namespace {
 
+constexpr size_t kMinBlockSize = 512;       // all sizes are rounded to at least 512 bytes
+constexpr size_t kSmallSize = 1048576;      // largest "small" allocation is 1 MiB
+constexpr size_t kSmallBuffer = 2097152;    // "small" allocations are packed in 2 MiB blocks
+
 struct BlockSize
 {
   size_t  size; // allocation size
@@ -24,11 +28,15 @@ struct BlockSize
 struct Block : public BlockSize
 {
   bool  allocated;    // true if the block is currently allocated
+  bool  small;        // true if the block was split from a "small" buffer
   int   event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
+  Block* prev;        // prev block if split from a larger allocation
+  Block* next;        // next block if split from a larger allocation
 
-  Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+  Block(size_t size, void* ptr, bool allocated, bool small) :
+      BlockSize(size, ptr), allocated(allocated), small(small), event_count(0),
+      streams(), prev(nullptr), next(nullptr) {}
 };
 
 static bool BlockComparator(const BlockSize& a, const BlockSize& b)
@@ -40,6 +48,14 @@ static bool BlockComparator(const BlockSize& a, const BlockSize& b)
   return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
 }
 
+static size_t roundSize(size_t size)
+{
+  if (size < kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
+}
+
 struct HostAllocator
 {
   typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
@@ -50,13 +66,22 @@ struct HostAllocator
   // blocks by pointer
   std::unordered_map<void*, Block> blocks;
 
-  // pointers that are ready to be allocated (event_count=0)
-  std::set<BlockSize, Comparison> available;
+  // pointers that are ready to be allocated (event_count=0), split from
+  // "small" buffers, and from larger allocations
+  std::set<BlockSize, Comparison> available_small;
+  std::set<BlockSize, Comparison> available_large;
 
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
-  HostAllocator() : available(BlockComparator) {}
+  THCCachingHostAllocatorStats stats;
+
+  HostAllocator() : available_small(BlockComparator), available_large(BlockComparator), stats() {}
+
+  std::set<BlockSize, Comparison>& availableFor(bool small)
+  {
+    return small ? available_small : available_large;
+  }
 
   cudaError_t malloc(void** ptr, size_t size)
   {
@@ -68,28 +93,54 @@ struct HostAllocator
       return err;
     }
 
+    size = roundSize(size);
+    bool small = size <= kSmallSize;
+    auto& available = availableFor(small);
+    stats.num_allocs++;
+
     // search for the smallest block which can hold this allocation
     BlockSize search_key(size);
     auto it = available.lower_bound(search_key);
+    Block* block = nullptr;
     if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
+      block = &blocks.at(it->ptr);
+      THAssert(!block->allocated && block->event_count == 0);
       available.erase(it);
-      return cudaSuccess;
-    }
+    } else {
+      // note that cudaHostAlloc may not touch pointer if size is 0
+      void* new_ptr = 0;
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
+      // allocate a new block if no cached allocation is found
+      size_t alloc_size = small ? kSmallBuffer : size;
+      err = cudaHostAlloc(&new_ptr, alloc_size, cudaHostAllocDefault);
+      if (err != cudaSuccess) {
+        return err;
+      }
+      stats.num_host_allocs++;
+      stats.cached_bytes += alloc_size;
+      block = &blocks.emplace(new_ptr, Block(alloc_size, new_ptr, false, small)).first->second;
+    }
 
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
-    if (err != cudaSuccess) {
-      return err;
+    // split the block if the rest of it can serve another allocation
+    size_t remaining = block->size - size;
+    if (small ? remaining >= kMinBlockSize : remaining > kSmallSize) {
+      void* rest_ptr = static_cast<char*>(block->ptr) + size;
+      Block* rest = &blocks.emplace(rest_ptr, Block(remaining, rest_ptr, false, small)).first->second;
+      rest->prev = block;
+      rest->next = block->next;
+      if (rest->next) {
+        rest->next->prev = rest;
+      }
+      block->next = rest;
+      block->size = size;
+      available.insert(*rest);
+      stats.num_splits++;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    block->allocated = true;
+    *ptr = block->ptr;
+    stats.allocated_bytes += block->size;
+    c10::reportMemoryUsage(block->ptr, block->size, at::kCPU);
     return cudaSuccess;
   }
 
@@ -116,6 +167,9 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    stats.allocated_bytes -= block.size;
+    c10::reportMemoryUsage(
+        ptr, -static_cast<int64_t>(block.size), at::kCPU);
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -125,7 +179,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      makeAvailable(&block);
     }
     return cudaSuccess;
   }
@@ -147,6 +201,12 @@ struct HostAllocator
     return cudaSuccess;
   }
 
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
   cudaError_t processEvents()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
@@ -172,7 +232,7 @@ struct HostAllocator
       Block& block = blocks.at(e.second);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
+        makeAvailable(&block);
       }
       cuda_events.pop_front();
     }
@@ -190,25 +250,63 @@ struct HostAllocator
       if (!block.allocated) {
         THCudaCheckWarn(cudaEventDestroy(event));
         block.event_count--;
+        if (block.event_count == 0) {
+          makeAvailable(&block);
+        }
       }
     }
 
     // all cuda_events have been processed
     cuda_events.clear();
 
-    // clear list of available blocks
-    available.clear();
+    // free the allocations that aren't split into blocks that are still in use
+    for (auto* available : {&available_small, &available_large}) {
+      for (auto it = available->begin(); it != available->end();) {
+        void* ptr = it->ptr;
+        Block& block = blocks.at(ptr);
+        if (!block.prev && !block.next) {
+          THCudaCheckWarn(cudaFreeHost(ptr));
+          stats.num_host_frees++;
+          stats.cached_bytes -= block.size;
+          blocks.erase(ptr);
+          it = available->erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
 
-    // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
-      } else {
-        ++it;
+  // Makes a block that is neither allocated nor used by pending work
+  // available, merged with its available neighbours
+  void makeAvailable(Block* block)
+  {
+    THAssert(!block->allocated && block->event_count == 0);
+    auto& available = availableFor(block->small);
+    Block* next = block->next;
+    if (next && !next->allocated && next->event_count == 0) {
+      available.erase(*next);
+      block->size += next->size;
+      block->next = next->next;
+      if (block->next) {
+        block->next->prev = block;
+      }
+      blocks.erase(next->ptr);
+      stats.num_merges++;
+    }
+    Block* prev = block->prev;
+    if (prev && !prev->allocated && prev->event_count == 0) {
+      available.erase(*prev);
+      prev->size += block->size;
+      prev->next = block->next;
+      if (prev->next) {
+        prev->next->prev = prev;
       }
+      blocks.erase(block->ptr);
+      block = prev;
+      stats.num_merges++;
     }
+    available.insert(*block);
   }
 
   cudaError_t insertEvents(Block& block)
@@ -254,6 +352,11 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
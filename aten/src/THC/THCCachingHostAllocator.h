@@ -6,6 +6,8 @@
 
 #include <c10/cuda/CUDAStream.h>
 
+#include <cstdint>
+
 //
 // A caching allocator for CUDA host allocations (pinned memory).
 //
@@ -18,8 +20,10 @@
 // call between host and device. We implement this for storages and tensors in
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
-// Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// Like the caching device allocator, the allocator rounds sizes to multiples
+// of 512 bytes, packs allocations of at most 1 MiB into 2 MiB blocks, and
+// splits cached blocks that are larger than requested. Freed blocks are merged
+// with their free neighbours once the events recorded for them have occurred.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
@@ -30,4 +34,17 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Statistics of the allocator since the beginning of the program
+struct THCCachingHostAllocatorStats {
+  uint64_t allocated_bytes;  // bytes currently allocated
+  uint64_t cached_bytes;     // bytes currently obtained from cudaHostAlloc
+  uint64_t num_allocs;       // calls to malloc
+  uint64_t num_host_allocs;  // calls to cudaHostAlloc
+  uint64_t num_host_frees;   // calls to cudaFreeHost
+  uint64_t num_splits;       // cached blocks split to serve a request
+  uint64_t num_merges;       // free blocks merged with a neighbour
+};
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
 #endif
@@ -45,7 +45,7 @@ multinomialAliasDrawKernel(int size, int64_t *output, int64_t *J, T *q, int64_t
     int64_t rand_ind = ScalarConvert<T, int64_t>::to(uniform[idx]);
     T bern_uniform = bernoulli[idx];
     int _mask = (int) THCNumerics<T>::lt(bern_uniform, q[rand_ind]);
-    output[idx] = J[rand_ind]*(1 -_mask) + (rand_ind+1L) * _mask;
+    output[idx] = _mask ? rand_ind : J[rand_ind];
   }
 }
 
@@ -56,7 +56,7 @@ aliasMultinomialFilter(T *q, T *probs, int64_t *smaller, int64_t *larger, int64_
   if (idx < inputsize) {
     larger_short_data[idx] = 0;
     smaller_short_data[idx] = 0;
-    J_data[idx]= 0;
+    J_data[idx] = -1;
     T val = THCNumerics<T>::mul(probs[idx], ScalarConvert<int64_t, T>::to(inputsize));
     if (THCNumerics<T>::lt(val, one)) {
       smaller[idx] =  idx+1;
@@ -75,7 +75,8 @@ condDiv(T *q, int64_t *J, int64_t inputsize, T q_max) {
   int64_t idx = blockIdx.x * BLOCK_SIZE + threadIdx.x;
   T one = ScalarConvert<int, T>::to(1);
   if (idx < inputsize) {
-    if (J[idx] <= 0) {
+    // entries without an alias always keep themselves
+    if (J[idx] < 0) {
       q[idx] = one;
     } else {
       if (THCNumerics<T>::gt(q_max, one)) {
@@ -395,16 +396,17 @@ aliasMultinomialSetup(int64_t *J, T*q, int64_t inputsize, int64_t * smaller, int
   int64_t large = 0;
   int64_t small = 0;
   while (small_c > 0 && large_c > 0) {
-    large = larger[large_c-1]-1;
-    small = smaller[small_c-1]-1;
+    // the lists hold the 0-based indices returned by nonzero()
+    large = larger[large_c-1];
+    small = smaller[small_c-1];
     J[small] = large;
     T q_sub = THCNumerics<T>::sub(one, q[small]);
     q[large] = THCNumerics<T>::sub(q[large], q_sub);
     if (THCNumerics<T>::le(q[large], one)) {
-      smaller[small_c-1] = large+1;
+      smaller[small_c-1] = large;
       large_c -= 1;
     } else {
-      larger[large_c-1] = large+1;
+      larger[large_c-1] = large;
       small_c -= 1;
     }
   }
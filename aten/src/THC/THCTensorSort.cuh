@@ -10,7 +10,9 @@
 
 #include <THC/THCThrustAllocator.cuh>
 #include <thrust/device_ptr.h>
+#include <thrust/functional.h>
 #include <thrust/sort.h>
+#include <thrust/transform.h>
 #if CUDA_VERSION >= 7000 || defined(__HIP_PLATFORM_HCC__)
 #include <thrust/system/cuda/execution_policy.h>
 #endif
@@ -97,6 +99,81 @@ struct GlobalIndexToPerSliceIndex {
   const int64_t sliceSize;
 };
 
+// For radix sorting in Thrust; converts a value to an integer of the same
+// order. -0 is converted like 0, and NaNs to the largest integer, so that
+// they are greater than everything else (like with handleNaN above).
+template <typename T>
+struct ThrustRadixKeyOp {
+  typedef T RadixType;
+
+  __device__ inline RadixType operator()(const T& v) const {
+    return v;
+  }
+};
+
+template <>
+struct ThrustRadixKeyOp<float> {
+  typedef uint32_t RadixType;
+
+  __device__ inline RadixType operator()(const float& v) const {
+    RadixType x = v == 0 ? 0 : __float_as_uint(v);
+    RadixType mask = (x & 0x80000000) ? 0xffffffff : 0x80000000;
+    return ::isnan(v) ? 0xffffffff : (x ^ mask);
+  }
+};
+
+template <>
+struct ThrustRadixKeyOp<double> {
+  typedef uint64_t RadixType;
+
+  __device__ inline RadixType operator()(const double& v) const {
+    RadixType x = v == 0 ? 0 : __double_as_longlong(v);
+    RadixType mask = (x & 0x8000000000000000) ? 0xffffffffffffffff : 0x8000000000000000;
+    return ::isnan(v) ? 0xffffffffffffffff : (x ^ mask);
+  }
+};
+
+template <>
+struct ThrustRadixKeyOp<at::Half> {
+  typedef uint16_t RadixType;
+
+  __device__ inline RadixType operator()(const at::Half& v) const {
+    RadixType x = (v.x & 0x7fff) == 0 ? 0 : v.x;
+    RadixType mask = (x & 0x8000) ? 0xffff : 0x8000;
+    return THCNumerics<at::Half>::isnan(v) ? 0xffff : (x ^ mask);
+  }
+};
+
+// For sorting in Thrust; extracts the slice of a linear index
+template <typename SegmentT>
+struct GlobalIndexToSlice {
+  GlobalIndexToSlice(int64_t size) : sliceSize(size) {}
+
+  __device__ inline SegmentT operator()(int64_t v) const {
+    return v / sliceSize;
+  }
+
+  const int64_t sliceSize;
+};
+
+// Stable sorts the `values` of the linear `indices` into slices of `sliceSize`
+// elements by slice, which keeps the values of each slice in the order they
+// were sorted in.
+template <typename SegmentT, typename Policy, typename ValueIter>
+void THCThrust_stableSortBySlice(THCState* state,
+                                 const Policy& policy,
+                                 thrust::device_ptr<int64_t> indices,
+                                 ValueIter values,
+                                 ptrdiff_t n,
+                                 int64_t sliceSize) {
+  thrust::device_ptr<SegmentT> segments(
+    static_cast<SegmentT*>(THCudaMalloc(state, n * sizeof(SegmentT))));
+  thrust::transform(policy, indices, indices + n, segments,
+                    GlobalIndexToSlice<SegmentT>(sliceSize));
+  thrust::stable_sort_by_key(policy, segments, segments + n, values);
+  THCudaFree(state, segments.get());
+}
+
 void THCudaLongTensor_fillSliceWithIndex(THCState* state,
                                          THCudaLongTensor* t,
                                          int dim);
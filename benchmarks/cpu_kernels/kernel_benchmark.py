@@ -0,0 +1,287 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import timeit
+
+import torch
+
+
+"""Bandwidth benchmarks of the TensorIterator CPU kernels.
+
+The kernels in aten/src/ATen/native/cpu are compiled once per CPU capability,
+and DispatchStub picks the variant for the capability of the machine, unless
+ATEN_CPU_CAPABILITY overrides it. The capability is read once per process, so
+every capability is benchmarked in its own worker process, and the results are
+collected into one table of GB/s per op, dtype, layout and size.
+"""
+
+
+CAPABILITIES = ['default', 'avx', 'avx2', 'avx512']
+
+# The ops of the stubs, by the number of tensor inputs. Every op writes to a
+# preallocated output where it has an out variant, so that only the kernel is
+# timed and not the allocation of the result.
+UNARY_OPS = {
+    'abs': lambda a, out: torch.abs(a, out=out),
+    'neg': lambda a, out: torch.neg(a, out=out),
+    'reciprocal': lambda a, out: torch.reciprocal(a, out=out),
+    'rsqrt': lambda a, out: torch.rsqrt(a, out=out),
+    'sigmoid': lambda a, out: torch.sigmoid(a, out=out),
+    'frac': lambda a, out: torch.frac(a, out=out),
+    'exp': lambda a, out: torch.exp(a, out=out),
+    'log': lambda a, out: torch.log(a, out=out),
+    'sqrt': lambda a, out: torch.sqrt(a, out=out),
+    'tanh': lambda a, out: torch.tanh(a, out=out),
+    'sin': lambda a, out: torch.sin(a, out=out),
+    'threshold': lambda a, out: torch.threshold(a, 0.5, 0.0),
+    'copy': lambda a, out: out.copy_(a),
+}
+BINARY_OPS = {
+    'add': lambda a, b, out: torch.add(a, b, out=out),
+    'sub': lambda a, b, out: torch.sub(a, b, out=out),
+    'mul': lambda a, b, out: torch.mul(a, b, out=out),
+    'div': lambda a, b, out: torch.div(a, b, out=out),
+}
+REDUCTION_OPS = {
+    'sum': lambda a: torch.sum(a),
+    'prod': lambda a: torch.prod(a),
+    'mean': lambda a: torch.mean(a),
+    'norm': lambda a: torch.norm(a),
+    'std': lambda a: torch.std(a),
+    'max': lambda a: torch.max(a),
+    'min': lambda a: torch.min(a),
+}
+# The ops that are only defined for floating point types.
+FLOAT_OPS = {
+    'reciprocal', 'rsqrt', 'sigmoid', 'frac', 'exp', 'log', 'sqrt', 'tanh',
+    'sin', 'mean', 'norm', 'std',
+}
+
+# contiguous: dense inputs.
+# strided: every other element of a tensor twice as large.
+# broadcast: the second input of a binary op is a row broadcast over the
+#   first, whose rows are 1024 elements long.
+# promote: the inputs of a binary op have different dtypes, so the iterator
+#   converts them to float64.
+LAYOUTS = ['contiguous', 'strided', 'broadcast', 'promote']
+
+
+def make_tensor(size, dtype, strided=False):
+    n = size * 2 if strided else size
+    if dtype.is_floating_point:
+        # Positive, so that log, sqrt and rsqrt stay finite.
+        t = torch.rand(n, dtype=dtype) + 0.5
+    else:
+        t = torch.randint(1, 100, (n,), dtype=dtype)
+    return t[::2] if strided else t
+
+
+def promoting_dtype(dtype):
+    """Returns a dtype that promotes dtype to float64."""
+    return torch.float64 if dtype != torch.float64 else torch.int64
+
+
+def bytes_of(*tensors):
+    return sum(t.numel() * t.element_size() for t in tensors)
+
+
+def make_case(op, kind, size, dtype, layout):
+    """Returns the function to time and the number of bytes it reads and
+    writes, or None if the layout doesn't apply to the op."""
+    if kind != 'binary' and layout in ['broadcast', 'promote']:
+        return None
+    a = make_tensor(size, dtype, strided=(layout == 'strided'))
+    if kind == 'unary':
+        out = torch.empty(size, dtype=dtype)
+        return (lambda: op(a, out)), bytes_of(a, out)
+    if kind == 'reduction':
+        return (lambda: op(a)), bytes_of(a)
+
+    if layout == 'broadcast':
+        if size % 1024:
+            return None
+        a = a.view(-1, 1024)
+        b = make_tensor(1024, dtype)
+        out = torch.empty_like(a)
+    elif layout == 'promote':
+        b = make_tensor(size, promoting_dtype(dtype))
+        out = torch.empty(size, dtype=torch.float64)
+    else:
+        b = make_tensor(size, dtype, strided=(layout == 'strided'))
+        out = torch.empty(size, dtype=dtype)
+    return (lambda: op(a, b, out)), bytes_of(a, b, out)
+
+
+def time_case(func, min_time):
+    """Returns the best time of one call in seconds."""
+    func()
+    number = 1
+    while True:
+        elapsed = timeit.timeit(func, number=number)
+        if elapsed >= min_time / 5:
+            break
+        number *= 2
+    return min(timeit.repeat(func, number=number, repeat=5)) / number
+
+
+def all_ops():
+    for name, op in UNARY_OPS.items():
+        yield name, op, 'unary'
+    for name, op in BINARY_OPS.items():
+        yield name, op, 'binary'
+    for name, op in REDUCTION_OPS.items():
+        yield name, op, 'reduction'
+
+
+def run_worker(args):
+    """Benchmarks all the cases with the capability of this process, and
+    prints one JSON object per case."""
+    torch.set_num_threads(args.num_threads)
+    torch.manual_seed(0)
+    for name, op, kind in all_ops():
+        if args.ops and name not in args.ops:
+            continue
+        for dtype_name in args.dtypes:
+            dtype = getattr(torch, dtype_name)
+            if name in FLOAT_OPS and not dtype.is_floating_point:
+                continue
+            for layout in args.layouts:
+                for size in args.sizes:
+                    try:
+                        case = make_case(op, kind, size, dtype, layout)
+                        if case is None:
+                            continue
+                        func, nbytes = case
+                        seconds = time_case(func, args.min_time)
+                        gbps = nbytes / seconds / 1e9
+                    except RuntimeError as e:
+                        # e.g. type promotion isn't supported by an op.
+                        gbps = None
+                        print("# {} {} {} {}: {}".format(
+                            name, dtype_name, layout, size, e), file=sys.stderr)
+                    print(json.dumps({
+                        'op': name, 'dtype': dtype_name, 'layout': layout,
+                        'size': size, 'gbps': gbps,
+                    }))
+                    sys.stdout.flush()
+
+
+def run_capability(capability, args):
+    """Runs a worker process with the capability, and returns its results by
+    case, or None if the worker failed, e.g. with an illegal instruction on a
+    machine without the capability."""
+    env = dict(os.environ, ATEN_CPU_CAPABILITY=capability)
+    command = [sys.executable, os.path.abspath(__file__), '--worker']
+    command += ['--sizes'] + [str(s) for s in args.sizes]
+    command += ['--dtypes'] + args.dtypes
+    command += ['--layouts'] + args.layouts
+    command += ['--min_time', str(args.min_time)]
+    command += ['--num_threads', str(args.num_threads)]
+    if args.ops:
+        command += ['--ops'] + args.ops
+    process = subprocess.Popen(command, env=env, stdout=subprocess.PIPE)
+    output, _ = process.communicate()
+    if process.returncode != 0:
+        print("# Capability {} failed with exit code {}".format(
+            capability, process.returncode), file=sys.stderr)
+        return None
+    results = {}
+    for line in output.decode('utf-8').splitlines():
+        result = json.loads(line)
+        key = (result['op'], result['dtype'], result['layout'], result['size'])
+        results[key] = result['gbps']
+    return results
+
+
+def print_table(capabilities, results, threshold):
+    """Prints GB/s per case and capability. A result is marked with '!' when
+    it is slower than a lower capability by more than the threshold, which is
+    usually a vectorization regression."""
+    keys = []
+    for capability in capabilities:
+        for key in results[capability]:
+            if key not in keys:
+                keys.append(key)
+    header = ['op', 'dtype', 'layout', 'size'] + capabilities
+    print(','.join(header))
+    regressions = 0
+    for key in keys:
+        row = [str(k) for k in key]
+        best_lower = None
+        for capability in capabilities:
+            gbps = results[capability].get(key)
+            if gbps is None:
+                row.append('n/a')
+                continue
+            cell = '{:.2f}'.format(gbps)
+            if best_lower is not None and gbps < best_lower * (1 - threshold):
+                cell += '!'
+                regressions += 1
+            best_lower = max(best_lower or 0, gbps)
+            row.append(cell)
+        print(','.join(row))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Benchmark the TensorIterator CPU kernels of every CPU "
+        "capability.",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    parser.add_argument(
+        '--capabilities', nargs='+', choices=CAPABILITIES,
+        default=['default', 'avx', 'avx2'],
+        help='The values of ATEN_CPU_CAPABILITY to compare, from the lowest')
+    parser.add_argument(
+        '--ops', nargs='+', default=None,
+        help='Only benchmark these ops')
+    parser.add_argument(
+        '--sizes', nargs='+', type=int, default=[1024, 65536, 1048576, 16777216],
+        help='The numbers of elements of the inputs')
+    parser.add_argument(
+        '--dtypes', nargs='+', default=['float32', 'float64', 'int32', 'int64'])
+    parser.add_argument(
+        '--layouts', nargs='+', choices=LAYOUTS, default=LAYOUTS)
+    parser.add_argument(
+        '--min_time', type=float, default=0.2,
+        help='The minimum time of a measurement in seconds')
+    parser.add_argument(
+        '--num_threads', type=int, default=1,
+        help='The number of intra-op threads')
+    parser.add_argument(
+        '--threshold', type=float, default=0.1,
+        help='The relative slowdown against a lower capability that is '
+        'reported as a regression')
+    parser.add_argument(
+        '--worker', action='store_true',
+        help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        run_worker(args)
+        return
+
+    capabilities = []
+    results = {}
+    for capability in args.capabilities:
+        capability_results = run_capability(capability, args)
+        if capability_results is not None:
+            capabilities.append(capability)
+            results[capability] = capability_results
+    regressions = print_table(capabilities, results, args.threshold)
+    if regressions:
+        print("# {} results are slower than with a lower capability".format(
+            regressions), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -6,12 +6,13 @@ import gc
 import sys
 import json
 import copy
+import timeit
 
 from .runner import get_nn_runners
 
 
 BenchResult = namedtuple('BenchResult', [
-    'name', 'avg_fwd', 'std_fwd', 'avg_bwd', 'std_bwd',
+    'name', 'avg_fwd', 'std_fwd', 'avg_bwd', 'std_bwd', 'avg_fwd_step',
 ])
 
 
@@ -42,15 +43,31 @@ def pretty_print(benchresult, colwidth=16, sep=' '):
     return sep.join(items)
 
 
+class CPUEvent(object):
+    # Mimics the timing interface of torch.cuda.Event on CPU, where the ops
+    # are synchronous.
+    def record(self):
+        self.time = timeit.default_timer()
+
+    def elapsed_time(self, end_event):
+        return (end_event.time - self.time) * 1000
+
+
 def trainbench(name, rnn_creator, nloops=100, warmup=10,
                seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
                miniBatch=64, device='cuda', seed=None):
     def train_batch(modeldef):
-        # CUDA events for timing
-        fwd_start_event = torch.cuda.Event(enable_timing=True)
-        fwd_end_event = torch.cuda.Event(enable_timing=True)
-        bwd_start_event = torch.cuda.Event(enable_timing=True)
-        bwd_end_event = torch.cuda.Event(enable_timing=True)
+        # CUDA events for timing on CUDA, the wall clock on CPU
+        if device == 'cuda':
+            fwd_start_event = torch.cuda.Event(enable_timing=True)
+            fwd_end_event = torch.cuda.Event(enable_timing=True)
+            bwd_start_event = torch.cuda.Event(enable_timing=True)
+            bwd_end_event = torch.cuda.Event(enable_timing=True)
+        else:
+            fwd_start_event = CPUEvent()
+            fwd_end_event = CPUEvent()
+            bwd_start_event = CPUEvent()
+            bwd_end_event = CPUEvent()
 
         gc.collect()
 
@@ -78,13 +95,14 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
                 assert param.grad is not None
                 param.grad.data.zero_()
 
-        torch.cuda.synchronize()
+        if device == 'cuda':
+            torch.cuda.synchronize()
 
         fwd_time = fwd_start_event.elapsed_time(fwd_end_event)
         bwd_time = bwd_start_event.elapsed_time(bwd_end_event)
         return fwd_time, bwd_time
 
-    assert device == 'cuda'
+    assert device in ['cuda', 'cpu']
     creator_args = dict(seqLength=seqLength, numLayers=numLayers,
                         inputSize=inputSize, hiddenSize=hiddenSize,
                         miniBatch=miniBatch, device=device, seed=seed)
@@ -102,7 +120,8 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
                        avg_fwd=fwd_times.mean().item(),
                        std_fwd=fwd_times.std().item(),
                        avg_bwd=bwd_times.mean().item(),
-                       std_bwd=bwd_times.std().item())
+                       std_bwd=bwd_times.std().item(),
+                       avg_fwd_step=fwd_times.mean().item() / seqLength)
 
 
 def print_stderr(*args, **kwargs):
@@ -156,13 +175,31 @@ def bench(rnn_runners, group_name, print_json=False, sep=' ', **params):
     return {
         group_name: {k: {"avg": v.avg_fwd, "std": v.std_fwd} for k, v in results.items()},
         group_name + '-backward': {k: {"avg": v.avg_bwd, "std": v.std_bwd} for k, v in results.items()},
+        group_name + '-step': {k: {"avg": v.avg_fwd_step, "std": v.std_fwd / params['seqLength']}
+                               for k, v in results.items()},
     }
 
 
-def bench_group(model_list, bench_name, bench_group, bench_args):
-    print_stderr('Benchmarking {}s...'.format(bench_name))
-    nn_results = bench(get_nn_runners(*model_list), bench_group, **bench_args)
-    print_stderr('')
+def bench_group(model_list, bench_name, bench_group, bench_args, threads=None):
+    if not threads:
+        print_stderr('Benchmarking {}s...'.format(bench_name))
+        nn_results = bench(get_nn_runners(*model_list), bench_group, **bench_args)
+        print_stderr('')
+        return nn_results
+
+    # Sweeps the number of intra-op threads, with one group per count.
+    nn_results = {}
+    saved = torch.get_num_threads()
+    try:
+        for num_threads in threads:
+            torch.set_num_threads(num_threads)
+            print_stderr('Benchmarking {}s with {} threads...'.format(bench_name, num_threads))
+            nn_results.update(bench(get_nn_runners(*model_list),
+                                    '{}-{}threads'.format(bench_group, num_threads),
+                                    **bench_args))
+            print_stderr('')
+    finally:
+        torch.set_num_threads(saved)
     return nn_results
 
 
@@ -181,7 +218,11 @@ if __name__ == '__main__':
     parser.add_argument('--miniBatch', default='64', type=int)
     parser.add_argument('--warmup', default='10', type=int)
     parser.add_argument('--nloops', default='100', type=int)
-    parser.add_argument('--device', default='cuda', type=str)
+    parser.add_argument('--device', default='cuda', type=str,
+                        help='cuda or cpu')
+    parser.add_argument('--threads', nargs='*', type=int,
+                        help='The numbers of intra-op threads to sweep, '
+                        'e.g. --threads 1 2 4. Mostly useful on CPU.')
     parser.add_argument('--variable_lstms', action='store_true',
                         help='Also benchmark variable sequence length lstms '
                         'Note that some of these run really slowly '
@@ -195,8 +236,11 @@ if __name__ == '__main__':
     parser.add_argument('--group', nargs='*', default=default_groups, help='Which group to run. cnns, rnns, etc.')
 
     args = parser.parse_args()
-    rnns = args.rnns or ['cudnn', 'aten', 'jit', 'jit_premul', 'jit_premul_bias', 'jit_simple',
-                         'jit_multilayer', 'py']
+    if args.device == 'cpu':
+        rnns = args.rnns or ['aten', 'jit', 'jit_fused_cpu', 'quantized']
+    else:
+        rnns = args.rnns or ['cudnn', 'aten', 'jit', 'jit_premul', 'jit_premul_bias', 'jit_simple',
+                             'jit_multilayer', 'py']
     cnns = args.cnns or ['resnet18', 'resnet18_jit', 'resnet50', 'resnet50_jit']
     # TODO: Maybe add a separate section for the layernorm/dropout lstms
     # 'cudnn_layernorm', jit_layernorm', 'jit_layernom_decom',
@@ -213,6 +257,7 @@ if __name__ == '__main__':
     del bench_args['rnns']
     del bench_args['cnns']
     del bench_args['variable_lstms']
+    del bench_args['threads']
 
     results = dict()
     if should_bench_varlen_lstms:
@@ -220,12 +265,13 @@ if __name__ == '__main__':
             print_stderr(
                 'WARNING: some of the variable sequence length lstms are '
                 'very unoptimized and therefore take forever to run.')
-        results.update(bench_group(vlrnns, 'variable-length sequence LSTM', 'vl_lstm', bench_args))
+        results.update(bench_group(vlrnns, 'variable-length sequence LSTM', 'vl_lstm', bench_args,
+                                   args.threads))
 
     if 'rnns' in args.group:
-        results.update(bench_group(rnns, 'LSTM', 'lstm', bench_args))
+        results.update(bench_group(rnns, 'LSTM', 'lstm', bench_args, args.threads))
     if 'cnns' in args.group:
-        results.update(bench_group(cnns, 'ResNet', 'resnet', bench_args))
+        results.update(bench_group(cnns, 'ResNet', 'resnet', bench_args, args.threads))
 
     if args.print_json == 'oss':
         print_json_oss_format(results)
@@ -62,6 +62,19 @@ def pytorch_lstm_creator(**kwargs):
         backward=simple_backward)
 
 
+def quantized_lstm_creator(dtype=torch.int8, **kwargs):
+    # The quantized LSTM only runs on CPU (with FBGEMM) and has no backward.
+    assert kwargs.get('device', 'cpu') == 'cpu'
+    from torch.jit.quantized import QuantizedLSTM
+    input, hidden, _, module = lstm_inputs(return_module=True, **kwargs)
+    return ModelDef(
+        inputs=[input, hidden],
+        params=[],
+        forward=QuantizedLSTM(module, dtype=dtype),
+        backward_setup=None,
+        backward=None)
+
+
 def lstm_creator(script=True, **kwargs):
     input, hidden, params, _ = lstm_inputs(return_module=False, **kwargs)
     inputs = [input, hidden] + params[0]
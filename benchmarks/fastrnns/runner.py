@@ -23,6 +23,14 @@ class DummyContext():
         pass
 
 
+class EnableCPUFusion():
+    def __enter__(self):
+        torch._C._jit_override_can_fuse_on_cpu(True)
+
+    def __exit__(self, *args, **kwargs):
+        torch._C._jit_override_can_fuse_on_cpu(False)
+
+
 class AssertNoJIT():
     def __enter__(self):
         import os
@@ -51,6 +59,8 @@ nn_runners = {
     'vl_py': RNNRunner('vl_py', varlen_lstm_creator, DummyContext),
     'aten': RNNRunner('aten', pytorch_lstm_creator, DisableCuDNN),
     'jit': RNNRunner('jit', lstm_creator, DummyContext),
+    'jit_fused_cpu': RNNRunner('jit_fused_cpu', lstm_creator, EnableCPUFusion),
+    'quantized': RNNRunner('quantized', quantized_lstm_creator, DummyContext),
     'jit_premul': RNNRunner('jit_premul', lstm_premul_creator, DummyContext),
     'jit_premul_bias': RNNRunner('jit_premul_bias', lstm_premul_bias_creator, DummyContext),
     'jit_simple': RNNRunner('jit_simple', lstm_simple_creator, DummyContext),
@@ -25,6 +25,9 @@ This module contains core functionalities for performance microbenchmark tests.
 # on long-mode.
 RUN_MODES = {'short': 0, 'long': 1}
 BENCHMARK_TESTER = [{} for _ in range(len(RUN_MODES))]
+# The op names, input shapes and args of the test cases, by test case id, so
+# that the test cases can be exported to the C++ benchmark binary.
+BENCHMARK_CONFIGS = [{} for _ in range(len(RUN_MODES))]
 BENCHMARK_TEST_GROUP = {}
 
 
@@ -38,6 +41,7 @@ def add_benchmark_tester(framework, op_name, input_shapes, op_args, run_mode, fu
         if (mode < run_mode):
             continue
         BENCHMARK_TESTER[mode][func_name] = func
+        BENCHMARK_CONFIGS[mode][func_name] = (op_name, input_shapes, op_args)
 
 
 def register_test(func):
@@ -127,6 +131,29 @@ class BenchmarkRunner(object):
         return (iters > self.max_iters or
                 run_time > 5 * self.min_time)
 
+    def _export_native_configs(self, run_mode):
+        """Writes the PyTorch test cases in the format read by
+        binaries/aten_op_benchmark.cc: one line per test case, with the op
+        name, the input shapes, the dtype and whether the inputs are
+        contiguous, separated by tabs.
+        """
+        with open(self.args.export_native_configs, 'w') as f:
+            f.write("# op_name\tinput_shapes\tdtype\tcontig\n")
+            for full_test_id, config in BENCHMARK_CONFIGS[run_mode].items():
+                if not full_test_id.startswith("PyTorch__"):
+                    continue
+                if self.args.operator and (self.args.operator not in full_test_id):
+                    continue
+                op_name, input_shapes, op_args = config
+                dtype = op_args.get('dtype', 'torch.float32')
+                contig = op_args.get('contig', True)
+                f.write("\t".join([
+                    op_name,
+                    ";".join(",".join(str(s) for s in shape) for shape in input_shapes),
+                    str(dtype).replace("torch.", ""),
+                    "1" if contig else "0",
+                ]) + "\n")
+
     def run(self):
         run_mode = RUN_MODES[self.args.run_mode]
         self._print_header(run_mode)
@@ -134,6 +161,10 @@ class BenchmarkRunner(object):
         if self.args.list_tests:
             return
 
+        if self.args.export_native_configs:
+            self._export_native_configs(run_mode)
+            return
+
         for tester in BENCHMARK_TESTER[run_mode].items():
             full_test_id = tester[0]
             benchmark_func = tester[1]
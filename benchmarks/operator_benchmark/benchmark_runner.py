@@ -71,6 +71,12 @@ def main():
         type=bool
     )
 
+    parser.add_argument(
+        "--export_native_configs",
+        help="Write the PyTorch test cases to this file for "
+        "binaries/aten_op_benchmark instead of running them",
+        default=None)
+
     parser.add_argument(
         '--framework',
         help='Comma-delimited list of frameworks to test (Caffe2, PyTorch)',
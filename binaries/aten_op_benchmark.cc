@@ -0,0 +1,332 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Times ATen ops from C++, without the Python binding overhead of
+// benchmarks/operator_benchmark. The test cases are exported from the
+// PyTorch tests of operator_benchmark with
+//
+//   python -m operator_benchmark.ops.add_test --export_native_configs add.tsv
+//
+// and run with
+//
+//   aten_op_benchmark --configs add.tsv --cpu 0 --flush_cache
+//
+// With --overhead, every op is also called through the native function
+// without the dispatch, and on autograd variables through VariableType, to
+// report the cost of each layer separately from the kernel.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "ATen/ATen.h"
+#include "ATen/NativeFunctions.h"
+#include "ATen/Parallel.h"
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/utils/string_utils.h"
+#include "torch/csrc/autograd/variable.h"
+
+C10_DEFINE_string(
+    configs,
+    "",
+    "The test cases exported by operator_benchmark with "
+    "--export_native_configs.");
+C10_DEFINE_string(
+    operator_filter,
+    "",
+    "Only run the test cases whose op name contains this string.");
+C10_DEFINE_int(warmup_iterations, 10, "The number of untimed iterations.");
+C10_DEFINE_int(iterations, 200, "The number of timed iterations.");
+C10_DEFINE_int(cpu, -1, "If not negative, pins the benchmark to this CPU.");
+C10_DEFINE_int(
+    num_threads,
+    -1,
+    "If positive, the number of intra-op threads of ATen.");
+C10_DEFINE_bool(
+    flush_cache,
+    false,
+    "If set, the caches are flushed before every timed iteration.");
+C10_DEFINE_int(
+    flush_cache_mb,
+    64,
+    "The size of the buffer written to flush the caches, which should be "
+    "larger than the last level cache.");
+C10_DEFINE_bool(
+    overhead,
+    false,
+    "If set, also times the native functions and the autograd variables, to "
+    "report the dispatch and VariableType overheads.");
+
+namespace {
+
+struct TestCase {
+  std::string op_name;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::string dtype;
+  bool contig;
+};
+
+// The ops of the PyTorch tests of operator_benchmark. `call` goes through the
+// dispatch like a call from Python would, and `kernel` calls the native
+// function of the CPU backend directly. Some ops are still implemented in TH
+// and have no native function.
+struct Op {
+  std::function<void(std::vector<at::Tensor>&)> call;
+  std::function<void(std::vector<at::Tensor>&)> kernel;
+};
+
+const std::map<std::string, Op>& ops() {
+  static const std::map<std::string, Op> ops = {
+      {"add",
+       {[](std::vector<at::Tensor>& in) { at::add(in[0], in[1]); },
+        [](std::vector<at::Tensor>& in) {
+          at::native::add(in[0], in[1], 1);
+        }}},
+      {"matmul",
+       {[](std::vector<at::Tensor>& in) { at::matmul(in[0], in[1]); },
+        [](std::vector<at::Tensor>& in) {
+          at::native::matmul(in[0], in[1]);
+        }}},
+      {"bitor",
+       {[](std::vector<at::Tensor>& in) { in[0].__ior__(42); }, nullptr}},
+      {"cbitor",
+       {[](std::vector<at::Tensor>& in) { in[0].__ior__(in[1]); }, nullptr}},
+      {"tanh",
+       {[](std::vector<at::Tensor>& in) { in[0].tanh_(); },
+        [](std::vector<at::Tensor>& in) {
+          at::native::_tanh_out_cpu(in[0], in[0]);
+        }}},
+      {"sigmoid",
+       {[](std::vector<at::Tensor>& in) { in[0].sigmoid_(); },
+        [](std::vector<at::Tensor>& in) {
+          at::native::_sigmoid_out_cpu(in[0], in[0]);
+        }}},
+      {"sumall",
+       {[](std::vector<at::Tensor>& in) { at::sum(in[0]); },
+        [](std::vector<at::Tensor>& in) { at::native::sum(in[0]); }}},
+  };
+  return ops;
+}
+
+// Parses the lines "<op name>\t<shape>;<shape>...\t<dtype>\t<contig>", where
+// a shape is a comma-separated list of sizes.
+std::vector<TestCase> ReadTestCases(const std::string& path) {
+  std::ifstream file(path);
+  CAFFE_ENFORCE(file, "Cannot open ", path);
+  std::vector<TestCase> test_cases;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    const auto fields = caffe2::split('\t', line);
+    CAFFE_ENFORCE_EQ(fields.size(), 4, "Malformed test case: ", line);
+    TestCase test_case;
+    test_case.op_name = fields[0];
+    for (const auto& shape : caffe2::split(';', fields[1])) {
+      std::vector<int64_t> sizes;
+      for (const auto& size : caffe2::split(',', shape)) {
+        sizes.push_back(std::stoll(size));
+      }
+      test_case.input_shapes.push_back(sizes);
+    }
+    test_case.dtype = fields[2];
+    test_case.contig = fields[3] == "1";
+    test_cases.push_back(test_case);
+  }
+  return test_cases;
+}
+
+// Creates the inputs like operator_benchmark does: uniform floats, integers
+// in [0, 100), and for non-contiguous inputs, every other element of a tensor
+// twice as large in every dimension.
+std::vector<at::Tensor> CreateInputs(const TestCase& test_case) {
+  at::ScalarType dtype;
+  if (test_case.dtype == "float32") {
+    dtype = at::kFloat;
+  } else if (test_case.dtype == "float64") {
+    dtype = at::kDouble;
+  } else if (test_case.dtype == "int32") {
+    dtype = at::kInt;
+  } else if (test_case.dtype == "int64") {
+    dtype = at::kLong;
+  } else {
+    CAFFE_THROW("Unsupported dtype ", test_case.dtype);
+  }
+
+  std::vector<at::Tensor> inputs;
+  for (const auto& shape : test_case.input_shapes) {
+    std::vector<int64_t> sizes(shape);
+    if (!test_case.contig) {
+      for (auto& size : sizes) {
+        size *= 2;
+      }
+    }
+    at::Tensor input = at::isFloatingType(dtype)
+        ? at::rand(sizes, at::TensorOptions(dtype))
+        : at::randint(0, 100, sizes, at::TensorOptions(dtype));
+    if (!test_case.contig) {
+      for (size_t dim = 0; dim < sizes.size(); ++dim) {
+        input = input.slice(dim, 0, sizes[dim], 2);
+      }
+    }
+    inputs.push_back(input);
+  }
+  return inputs;
+}
+
+void FlushCache() {
+  static std::vector<char> buffer(
+      static_cast<size_t>(std::max(1, FLAGS_flush_cache_mb)) << 20);
+  for (size_t i = 0; i < buffer.size(); i += 64) {
+    buffer[i]++;
+  }
+}
+
+struct Stats {
+  double p50;
+  double p90;
+  double p99;
+  double mean;
+};
+
+// Returns the percentiles of the iteration times in microseconds.
+Stats Time(
+    const std::function<void(std::vector<at::Tensor>&)>& call,
+    std::vector<at::Tensor>& inputs) {
+  for (int i = 0; i < FLAGS_warmup_iterations; ++i) {
+    call(inputs);
+  }
+  std::vector<double> times;
+  times.reserve(FLAGS_iterations);
+  for (int i = 0; i < FLAGS_iterations; ++i) {
+    if (FLAGS_flush_cache) {
+      FlushCache();
+    }
+    const auto start = std::chrono::steady_clock::now();
+    call(inputs);
+    const auto end = std::chrono::steady_clock::now();
+    times.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  std::sort(times.begin(), times.end());
+  const auto percentile = [&times](int p) {
+    return times[std::min(times.size() - 1, times.size() * p / 100)];
+  };
+  double total = 0;
+  for (const auto time : times) {
+    total += time;
+  }
+  return {percentile(50), percentile(90), percentile(99), total / times.size()};
+}
+
+void PrintStats(const std::string& name, const Stats& stats) {
+  std::cout << name << " (us) : p50 " << stats.p50 << ", p90 " << stats.p90
+            << ", p99 " << stats.p99 << ", mean " << stats.mean << std::endl;
+}
+
+std::string ShapesToString(const TestCase& test_case) {
+  std::string result;
+  for (const auto& shape : test_case.input_shapes) {
+    result += result.empty() ? "(" : ", (";
+    for (size_t i = 0; i < shape.size(); ++i) {
+      result += (i ? ", " : "") + std::to_string(shape[i]);
+    }
+    result += ")";
+  }
+  return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+  CAFFE_ENFORCE(!FLAGS_configs.empty(), "--configs is required");
+  CAFFE_ENFORCE_GT(FLAGS_iterations, 0);
+
+  if (FLAGS_cpu >= 0) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(FLAGS_cpu, &cpus);
+    CAFFE_ENFORCE_EQ(
+        sched_setaffinity(0, sizeof(cpus), &cpus),
+        0,
+        "Cannot pin to CPU ",
+        FLAGS_cpu);
+#else
+    LOG(WARNING) << "Pinning to a CPU is only supported on Linux.";
+#endif
+  }
+  if (FLAGS_num_threads > 0) {
+    at::set_num_threads(FLAGS_num_threads);
+  }
+  at::manual_seed(0);
+
+  std::cout << "# PyTorch Operator Micro-benchmarks (C++)" << std::endl;
+  for (const auto& test_case : ReadTestCases(FLAGS_configs)) {
+    if (test_case.op_name.find(FLAGS_operator_filter) == std::string::npos) {
+      continue;
+    }
+    const auto it = ops().find(test_case.op_name);
+    if (it == ops().end()) {
+      LOG(WARNING) << "Skipping unsupported op " << test_case.op_name;
+      continue;
+    }
+    const auto& op = it->second;
+
+    std::cout << "# Benchmarking PyTorch " << test_case.op_name << std::endl;
+    std::cout << "# Input Shape: " << ShapesToString(test_case) << std::endl;
+    std::cout << "Args: dtype " << test_case.dtype << ", contig "
+              << test_case.contig << std::endl;
+    auto inputs = CreateInputs(test_case);
+    const auto dispatched = Time(op.call, inputs);
+    PrintStats("Execution Time", dispatched);
+    if (FLAGS_overhead) {
+      std::vector<at::Tensor> variables;
+      for (const auto& input : inputs) {
+        // Shares the storage and the strides of the input.
+        variables.push_back(
+            torch::autograd::make_variable(input, /* requires_grad */ false));
+      }
+      const auto variable = Time(op.call, variables);
+      PrintStats("Variable Time", variable);
+      std::cout << "VariableType Overhead (us) : "
+                << variable.p50 - dispatched.p50 << std::endl;
+      if (op.kernel) {
+        const auto kernel = Time(op.kernel, inputs);
+        PrintStats("Kernel Time", kernel);
+        std::cout << "Dispatch Overhead (us) : "
+                  << dispatched.p50 - kernel.p50 << std::endl;
+      } else {
+        std::cout << "Dispatch Overhead (us) : n/a, " << test_case.op_name
+                  << " has no native function" << std::endl;
+      }
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks the inference of a TorchScript model, like speed_benchmark does
+// for caffe2 nets:
+//
+//   speed_benchmark_torch --model model.pt --input_dims "1,3,224,224" \
+//       --input_type float --warmup 10 --iter 100 --threads 4
+//
+// It reports the latency percentiles, the throughput over all threads, the
+// peak memory of the CPU allocator and, with --profile_iter, the time spent
+// in every op.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ATen/ATen.h"
+#include "ATen/Parallel.h"
+#include "c10/core/CPUAllocator.h"
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/utils/string_utils.h"
+#include "torch/csrc/autograd/grad_mode.h"
+#include "torch/csrc/autograd/profiler.h"
+#include "torch/script.h"
+
+C10_DEFINE_string(model, "", "The TorchScript model to benchmark.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the inputs of the model, as comma separated numbers. "
+    "If the model has several inputs, separate them with semicolons.");
+C10_DEFINE_string(
+    input_type,
+    "float",
+    "The types of the inputs (float, double, int64, int32, uint8), separated "
+    "by semicolons.");
+C10_DEFINE_int(warmup, 10, "The number of untimed iterations of every thread.");
+C10_DEFINE_int(iter, 100, "The number of timed iterations of every thread.");
+C10_DEFINE_int(
+    threads,
+    1,
+    "The number of threads running the model concurrently.");
+C10_DEFINE_int(
+    num_intra_op_threads,
+    -1,
+    "If positive, the number of intra-op threads of ATen.");
+C10_DEFINE_int(
+    profile_iter,
+    0,
+    "The number of iterations to run with the profiler, on one thread after "
+    "the timed iterations, to report the time spent in every op.");
+
+namespace {
+
+// Wraps the CPU allocator to track the current and the peak number of bytes
+// allocated through it.
+class TrackingCPUAllocator final : public at::Allocator {
+ public:
+  explicit TrackingCPUAllocator(at::Allocator* allocator)
+      : allocator_(allocator) {}
+
+  at::DataPtr allocate(size_t nbytes) const override {
+    auto* context = new Context{allocator_->allocate(nbytes), nbytes, this};
+    void* data = context->data_ptr.get();
+    const auto current = current_ += nbytes;
+    auto peak = peak_.load();
+    while (current > peak && !peak_.compare_exchange_weak(peak, current)) {
+    }
+    return {data, context, &Delete, at::Device(at::DeviceType::CPU)};
+  }
+
+  size_t peak() const {
+    return peak_;
+  }
+
+  // Starts tracking the peak from the memory in use now.
+  void ResetPeak() {
+    peak_ = current_.load();
+  }
+
+ private:
+  struct Context {
+    at::DataPtr data_ptr;
+    size_t nbytes;
+    const TrackingCPUAllocator* allocator;
+  };
+
+  static void Delete(void* ptr) {
+    auto* context = static_cast<Context*>(ptr);
+    context->allocator->current_ -= context->nbytes;
+    delete context;
+  }
+
+  at::Allocator* allocator_;
+  mutable std::atomic<size_t> current_{0};
+  mutable std::atomic<size_t> peak_{0};
+};
+
+std::vector<c10::IValue> CreateInputs() {
+  CAFFE_ENFORCE(!FLAGS_input_dims.empty(), "--input_dims is required");
+  const auto dims_list = caffe2::split(';', FLAGS_input_dims);
+  const auto type_list = caffe2::split(';', FLAGS_input_type);
+  CAFFE_ENFORCE_EQ(
+      dims_list.size(),
+      type_list.size(),
+      "--input_dims and --input_type must have the same number of inputs");
+
+  std::vector<c10::IValue> inputs;
+  for (size_t i = 0; i < dims_list.size(); ++i) {
+    std::vector<int64_t> dims;
+    for (const auto& dim : caffe2::split(',', dims_list[i])) {
+      dims.push_back(std::stoll(dim));
+    }
+    const auto& type = type_list[i];
+    at::Tensor input;
+    if (type == "float") {
+      input = torch::randn(dims, at::kFloat);
+    } else if (type == "double") {
+      input = torch::randn(dims, at::kDouble);
+    } else if (type == "int64") {
+      input = torch::randint(0, 100, dims, at::kLong);
+    } else if (type == "int32") {
+      input = torch::randint(0, 100, dims, at::kInt);
+    } else if (type == "uint8") {
+      input = torch::randint(0, 256, dims, at::kByte);
+    } else {
+      CAFFE_THROW("Unsupported input type ", type);
+    }
+    inputs.push_back(input);
+  }
+  return inputs;
+}
+
+double Percentile(const std::vector<double>& sorted, int p) {
+  return sorted[std::min(sorted.size() - 1, sorted.size() * p / 100)];
+}
+
+// Prints the time of every op over the profiled iterations, from the range
+// events of the profiler. The times of nested ops are included in the ops
+// that call them.
+void PrintProfile(
+    torch::autograd::profiler::thread_event_lists event_lists,
+    int iterations) {
+  struct OpStats {
+    double total_us = 0;
+    int64_t count = 0;
+  };
+  std::map<std::string, OpStats> stats;
+  for (auto& events : event_lists) {
+    std::vector<torch::autograd::profiler::Event*> stack;
+    for (auto& event : events) {
+      if (event.kind() == "push") {
+        stack.push_back(&event);
+      } else if (event.kind() == "pop" && !stack.empty()) {
+        auto* push = stack.back();
+        stack.pop_back();
+        auto& op_stats = stats[push->name()];
+        op_stats.total_us += push->cpu_elapsed_us(event);
+        op_stats.count++;
+      }
+    }
+  }
+
+  std::vector<std::pair<std::string, OpStats>> sorted(
+      stats.begin(), stats.end());
+  std::sort(
+      sorted.begin(),
+      sorted.end(),
+      [](const std::pair<std::string, OpStats>& a,
+         const std::pair<std::string, OpStats>& b) {
+        return a.second.total_us > b.second.total_us;
+      });
+  std::cout << "Per-op profile over " << iterations
+            << " iterations (us per iteration, calls per iteration):"
+            << std::endl;
+  for (const auto& entry : sorted) {
+    std::cout << "  " << entry.first << ": "
+              << entry.second.total_us / iterations << " us, "
+              << static_cast<double>(entry.second.count) / iterations
+              << " calls" << std::endl;
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+  CAFFE_ENFORCE(!FLAGS_model.empty(), "--model is required");
+  CAFFE_ENFORCE_GT(FLAGS_iter, 0);
+  CAFFE_ENFORCE_GT(FLAGS_threads, 0);
+  if (FLAGS_num_intra_op_threads > 0) {
+    at::set_num_threads(FLAGS_num_intra_op_threads);
+  }
+
+  // Never freed, since tensors allocated through it may outlive main.
+  auto* allocator = new TrackingCPUAllocator(c10::GetCPUAllocator());
+  c10::SetCPUAllocator(allocator);
+
+  auto module = torch::jit::load(FLAGS_model);
+  const auto inputs = CreateInputs();
+  const size_t model_bytes = allocator->peak();
+  allocator->ResetPeak();
+
+  std::vector<std::vector<double>> latencies(FLAGS_threads);
+  std::atomic<int> ready{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < FLAGS_threads; ++t) {
+    threads.emplace_back([&, t] {
+      torch::autograd::AutoGradMode no_grad(false);
+      for (int i = 0; i < FLAGS_warmup; ++i) {
+        module->forward(inputs);
+      }
+      // The timed iterations of all threads start together, so that the
+      // throughput is measured while all threads are running.
+      ready++;
+      while (!start) {
+        std::this_thread::yield();
+      }
+      auto& thread_latencies = latencies[t];
+      thread_latencies.reserve(FLAGS_iter);
+      for (int i = 0; i < FLAGS_iter; ++i) {
+        const auto iter_begin = std::chrono::steady_clock::now();
+        module->forward(inputs);
+        thread_latencies.push_back(
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - iter_begin)
+                .count());
+      }
+    });
+  }
+  while (ready < FLAGS_threads) {
+    std::this_thread::yield();
+  }
+  const auto begin = std::chrono::steady_clock::now();
+  start = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+
+  std::vector<double> all_latencies;
+  for (const auto& thread_latencies : latencies) {
+    all_latencies.insert(
+        all_latencies.end(), thread_latencies.begin(), thread_latencies.end());
+  }
+  std::sort(all_latencies.begin(), all_latencies.end());
+  std::cout << "Threads: " << FLAGS_threads
+            << ", iterations per thread: " << FLAGS_iter << std::endl;
+  std::cout << "Latency (ms): p50 " << Percentile(all_latencies, 50)
+            << ", p90 " << Percentile(all_latencies, 90) << ", p99 "
+            << Percentile(all_latencies, 99) << ", max "
+            << all_latencies.back() << std::endl;
+  std::cout << "Throughput: " << all_latencies.size() / seconds
+            << " iterations per second" << std::endl;
+  std::cout << "Memory (MB): model and inputs " << model_bytes / 1e6
+            << ", peak during inference " << allocator->peak() / 1e6
+            << std::endl;
+
+  if (FLAGS_profile_iter > 0) {
+    torch::autograd::AutoGradMode no_grad(false);
+    torch::autograd::profiler::enableProfiler(
+        torch::autograd::profiler::ProfilerConfig(
+            torch::autograd::profiler::ProfilerState::CPU,
+            /* report_input_shapes */ false));
+    for (int i = 0; i < FLAGS_profile_iter; ++i) {
+      module->forward(inputs);
+    }
+    PrintProfile(
+        torch::autograd::profiler::disableProfiler(), FLAGS_profile_iter);
+  }
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <c10/core/Allocator.h>
 
+#include <atomic>
+
 namespace c10 {
 
 static void deleteInefficientStdFunctionContext(void* ptr) {
@@ -28,4 +30,17 @@ at::Allocator* GetAllocator(const at::DeviceType& t) {
   return alloc;
 }
 
+static std::atomic<MemoryReporter> memory_reporter{nullptr};
+
+void SetMemoryReporter(MemoryReporter reporter) {
+  memory_reporter.store(reporter);
+}
+
+void reportMemoryUsage(void* ptr, int64_t size, Device device) {
+  auto reporter = memory_reporter.load(std::memory_order_relaxed);
+  if (reporter) {
+    reporter(ptr, size, device);
+  }
+}
+
 } // namespace c10
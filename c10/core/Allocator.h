@@ -214,4 +214,17 @@ struct AllocatorRegisterer {
   static AllocatorRegisterer<t> g_allocator_d(f); \
   }
 
+/** Caching allocators report the memory they hand out to and take back
+ *  from their users to the memory reporter, if one is set. `size` is
+ *  positive for allocations and negative for frees. The autograd profiler
+ *  uses this to record memory events.
+ *
+ *  The reporter may be called from any thread, from inside the critical
+ *  section of the allocator, so it must not allocate memory from the
+ *  device it is told about.
+ */
+using MemoryReporter = void (*)(void* ptr, int64_t size, Device device);
+C10_API void SetMemoryReporter(MemoryReporter reporter);
+C10_API void reportMemoryUsage(void* ptr, int64_t size, Device device);
+
 } // namespace c10
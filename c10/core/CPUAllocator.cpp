@@ -1,6 +1,8 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#include <vector>
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -17,6 +19,21 @@ C10_DEFINE_bool(
     false,
     "If set, fill memory with deterministic junk when allocating on CPU");
 
+C10_DEFINE_bool(
+    caffe2_cpu_allocator_use_caching,
+    false,
+    "If set, freed CPU allocations are cached per thread and reused");
+
+C10_DEFINE_int64(
+    caffe2_cpu_allocator_max_cached_size,
+    1 << 20,
+    "Largest CPU allocation in bytes that is cached for reuse");
+
+C10_DEFINE_int64(
+    caffe2_cpu_allocator_thread_cache_bytes,
+    32 << 20,
+    "Maximum number of bytes held in the CPU allocation cache of each thread");
+
 namespace c10 {
 
 void memset_junk(void* data, size_t num) {
@@ -71,8 +88,11 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  // move data to a thread's NUMA node, unless the thread asked for its pages
+  // to be interleaved over all nodes
+  if (GetThreadNUMAPolicy() != NUMAPolicy::INTERLEAVE) {
+    NUMAMove(data, nbytes, GetCurrentNUMANode());
+  }
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -94,6 +114,169 @@ void free_cpu(void* data) {
 #endif
 }
 
+// Note [Caching CPU allocator]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Small temporaries are allocated and freed at a very high rate during CPU
+// inference, and going through posix_memalign every time shows up in
+// profiles.  With caffe2_cpu_allocator_use_caching, allocations up to
+// caffe2_cpu_allocator_max_cached_size bytes are rounded up to a power of two
+// and, once freed, kept in a free list of the freeing thread, to be reused by
+// the next allocation of the same size class on that thread.
+//
+// Every allocation made in this mode is prefixed by a header of gAlignment
+// bytes recording its size class and NUMA node, so that a single deleter can
+// handle both cached and uncached blocks (which keeps raw_deleter() valid).
+// Blocks are only cached by a thread running on the NUMA node they were
+// placed on, and each thread caches at most
+// caffe2_cpu_allocator_thread_cache_bytes bytes; everything else is returned
+// to the system right away.
+
+namespace {
+
+struct CachedBlockHeader {
+  // log2 of the block size, or kUncachedSizeClass
+  int size_class;
+  // NUMA node the block was placed on, or -1 if NUMA is disabled
+  int numa_node;
+};
+
+constexpr size_t kCachedHeaderSize = gAlignment;
+static_assert(
+    sizeof(CachedBlockHeader) <= kCachedHeaderSize,
+    "CachedBlockHeader must fit in the alignment padding");
+
+constexpr int kMinSizeClass = 6; // 64 bytes
+constexpr int kNumSizeClasses = 64;
+constexpr int kUncachedSizeClass = -1;
+
+int size_class_for(size_t nbytes) {
+  int size_class = kMinSizeClass;
+  while ((static_cast<size_t>(1) << size_class) < nbytes) {
+    size_class++;
+  }
+  return size_class;
+}
+
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+
+struct ThreadCache {
+  // free blocks of each size class, as pointers to their header
+  std::vector<void*> free_lists[kNumSizeClasses];
+  size_t cached_bytes = 0;
+
+  ~ThreadCache();
+  void release();
+};
+
+// Set once the cache of this thread is destroyed, so that memory freed by
+// other thread local destructors running later doesn't touch it.
+thread_local bool thread_cache_destroyed = false;
+thread_local ThreadCache thread_cache;
+
+void ThreadCache::release() {
+  for (auto& free_list : free_lists) {
+    for (void* base : free_list) {
+      free_cpu(base);
+    }
+    free_list.clear();
+  }
+  cached_bytes = 0;
+}
+
+ThreadCache::~ThreadCache() {
+  release();
+  thread_cache_destroyed = true;
+}
+
+void* pop_cached_block(int size_class) {
+  if (thread_cache_destroyed) {
+    return nullptr;
+  }
+  auto& free_list = thread_cache.free_lists[size_class];
+  if (free_list.empty()) {
+    return nullptr;
+  }
+  void* base = free_list.back();
+  free_list.pop_back();
+  thread_cache.cached_bytes -= static_cast<size_t>(1) << size_class;
+  return base;
+}
+
+bool push_cached_block(void* base, int size_class) {
+  size_t block_size = static_cast<size_t>(1) << size_class;
+  if (thread_cache_destroyed ||
+      thread_cache.cached_bytes + block_size >
+          static_cast<size_t>(FLAGS_caffe2_cpu_allocator_thread_cache_bytes)) {
+    return false;
+  }
+  thread_cache.free_lists[size_class].push_back(base);
+  thread_cache.cached_bytes += block_size;
+  return true;
+}
+
+#else // defined(CAFFE2_FB_LIMITED_MOBILE_CAPABILITY)
+
+void* pop_cached_block(int size_class) {
+  return nullptr;
+}
+
+bool push_cached_block(void* base, int size_class) {
+  return false;
+}
+
+#endif // CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+
+} // namespace
+
+void* alloc_cpu_cached(size_t nbytes) {
+  if (nbytes == 0) {
+    return nullptr;
+  }
+  int size_class = kUncachedSizeClass;
+  size_t block_size = nbytes;
+  if (nbytes <= static_cast<size_t>(FLAGS_caffe2_cpu_allocator_max_cached_size)) {
+    size_class = size_class_for(nbytes);
+    block_size = static_cast<size_t>(1) << size_class;
+    void* base = pop_cached_block(size_class);
+    if (base) {
+      void* data = static_cast<char*>(base) + kCachedHeaderSize;
+      if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+        memset(data, 0, nbytes);
+      } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+        memset_junk(data, nbytes);
+      }
+      return data;
+    }
+  }
+  void* base = alloc_cpu(block_size + kCachedHeaderSize);
+  auto header = static_cast<CachedBlockHeader*>(base);
+  header->size_class = size_class;
+  header->numa_node = IsNUMAEnabled() ? GetCurrentNUMANode() : -1;
+  return static_cast<char*>(base) + kCachedHeaderSize;
+}
+
+void free_cpu_cached(void* data) {
+  if (!data) {
+    return;
+  }
+  void* base = static_cast<char*>(data) - kCachedHeaderSize;
+  auto header = static_cast<CachedBlockHeader*>(base);
+  if (header->size_class != kUncachedSizeClass &&
+      (header->numa_node < 0 || header->numa_node == GetCurrentNUMANode()) &&
+      push_cached_block(base, header->size_class)) {
+    return;
+  }
+  free_cpu(base);
+}
+
+void ReleaseCPUAllocatorThreadCache() {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  if (!thread_cache_destroyed) {
+    thread_cache.release();
+  }
+#endif
+}
+
 // A virtual struct that is used to report C10's memory allocation and
 // deallocation status
 class C10_API MemoryAllocationReporter {
@@ -112,6 +295,15 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
+    // See Note [Caching CPU allocator]
+    if (FLAGS_caffe2_cpu_allocator_use_caching) {
+      void* data = alloc_cpu_cached(nbytes);
+      if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
+        getMemoryAllocationReporter().New(data, nbytes);
+        return {data, data, &ReportAndCachingDelete, at::Device(at::DeviceType::CPU)};
+      }
+      return {data, data, &free_cpu_cached, at::Device(at::DeviceType::CPU)};
+    }
     void* data = alloc_cpu(nbytes);
     if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
       getMemoryAllocationReporter().New(data, nbytes);
@@ -128,7 +320,21 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     free_cpu(ptr);
   }
 
+  static void ReportAndCachingDelete(void* ptr) {
+    if (!ptr) {
+      return;
+    }
+    getMemoryAllocationReporter().Delete(ptr);
+    free_cpu_cached(ptr);
+  }
+
   at::DeleterFnPtr raw_deleter() const override {
+    if (FLAGS_caffe2_cpu_allocator_use_caching) {
+      if (FLAGS_caffe2_report_cpu_memory_usage) {
+        return &ReportAndCachingDelete;
+      }
+      return &free_cpu_cached;
+    }
     if (FLAGS_caffe2_report_cpu_memory_usage) {
       return &ReportAndDelete;
     }
@@ -11,6 +11,9 @@
 C10_DECLARE_bool(caffe2_report_cpu_memory_usage);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_zero_fill);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_junk_fill);
+C10_DECLARE_bool(caffe2_cpu_allocator_use_caching);
+C10_DECLARE_int64(caffe2_cpu_allocator_max_cached_size);
+C10_DECLARE_int64(caffe2_cpu_allocator_thread_cache_bytes);
 
 namespace c10 {
 
@@ -30,6 +33,15 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// Like alloc_cpu/free_cpu, but freed blocks are kept in a cache of the
+// calling thread and reused by later allocations of a similar size.  Memory
+// obtained from alloc_cpu_cached must be freed with free_cpu_cached.
+C10_API void* alloc_cpu_cached(size_t nbytes);
+C10_API void free_cpu_cached(void* data);
+
+// Returns all memory cached by the calling thread to the system.
+C10_API void ReleaseCPUAllocatorThreadCache();
+
 // Get the CPU Alloctor.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
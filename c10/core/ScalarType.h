@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/util/ArrayRef.h>
+#include <c10/util/BFloat16.h>
 #include <c10/util/Half.h>
 #include <c10/util/Optional.h>
 #include <c10/util/typeid.h>
@@ -31,7 +32,8 @@ namespace c10 {
   _(bool, Bool, i) /* 11 */                          \
   _(c10::qint8, QInt8, i) /* 12 */                   \
   _(c10::quint8, QUInt8, i) /* 13 */                 \
-  _(c10::qint32, QInt32, i) /* 14 */
+  _(c10::qint32, QInt32, i) /* 14 */                 \
+  _(at::BFloat16, BFloat16, d) /* 15 */
 
 // If you want to support ComplexHalf for real, replace occurrences
 // of this macro with AT_FORALL_SCALAR_TYPES_WITH_COMPLEX.  But
@@ -50,7 +52,8 @@ namespace c10 {
   _(bool, Bool, i)                                                 \
   _(c10::qint8, QInt8, i)                                          \
   _(c10::quint8, QUInt8, i)                                        \
-  _(c10::qint32, QInt32, i)
+  _(c10::qint32, QInt32, i)                                        \
+  _(at::BFloat16, BFloat16, d)
 
 #define AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_EXCEPT_COMPLEX_HALF_AND_QINT(_) \
   _(uint8_t, Byte, i)                                                       \
@@ -63,7 +66,8 @@ namespace c10 {
   _(double, Double, d)                                                      \
   _(std::complex<float>, ComplexFloat, z)                                   \
   _(std::complex<double>, ComplexDouble, z)                                 \
-  _(bool, Bool, i)
+  _(bool, Bool, i)                                                          \
+  _(at::BFloat16, BFloat16, d)
 
 #define AT_FORALL_SCALAR_TYPES(_) \
   _(uint8_t, Byte, i)             \
@@ -220,7 +224,7 @@ static inline bool isIntegralType(ScalarType t) {
 static inline bool isFloatingType(ScalarType t) {
   return (
       t == ScalarType::Double || t == ScalarType::Float ||
-      t == ScalarType::Half);
+      t == ScalarType::Half || t == ScalarType::BFloat16);
 }
 
 static inline bool isComplexType(ScalarType t) {
@@ -264,6 +268,18 @@ static inline ScalarType promoteTypes(ScalarType a, ScalarType b) {
         "promoteTypes with quantized numbers is not handled yet; figure out what the correct rules should be");
   }
 
+  // BFloat16 comes after the types of the lookup table below. Neither it nor
+  // Half can represent all the values of the other, so together they promote
+  // to Float
+  constexpr auto bf = ScalarType::BFloat16;
+  if (a == bf || b == bf) {
+    auto other = a == bf ? b : a;
+    if (other == bf || isIntegralType(other) || other == b1) {
+      return bf;
+    }
+    return other == f8 ? f8 : f4;
+  }
+
   // this matrix has to be consistent with AT_FORALL_SCALAR_TYPES_WITH_COMPLEX
   // so that's why we have to add undefined as we are not sure what is the
   // corrent values for the type promotions in complex type cases.
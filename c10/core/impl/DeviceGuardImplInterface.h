@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/Allocator.h>
 #include <c10/core/Device.h>
 #include <c10/core/DeviceType.h>
 #include <c10/core/Stream.h>
@@ -87,6 +88,29 @@ struct C10_API DeviceGuardImplInterface {
    */
   virtual DeviceIndex deviceCount() const noexcept = 0;
 
+  /**
+   * Get a stream from the pool of streams of a given device, to queue work
+   * that may run concurrently with the work of its current stream.  Devices
+   * without such a pool return their current stream.
+   */
+  virtual Stream getStreamFromPool(Device d) const {
+    return getStream(d);
+  }
+
+  /**
+   * Make the work queued on `stream` from now on wait for the work queued on
+   * `other` so far.  Devices which run all their work in order don't need to
+   * do anything.
+   */
+  virtual void blockStream(const Stream& stream, const Stream& other) const {}
+
+  /**
+   * Record that the memory of `data_ptr`, which may have been allocated for
+   * another stream, is used by the work queued on `stream`, so that it isn't
+   * reused before that work is done.
+   */
+  virtual void recordDataPtrOnStream(const DataPtr& data_ptr, const Stream& stream) const {}
+
   /**
    * Intended use of this class is to leak the DeviceGuardImpl at program end.
    * So you better not call the destructor, buster!
@@ -43,6 +43,15 @@ public:
   DeviceIndex deviceCount() const noexcept override {
     return impl_->deviceCount();
   }
+  Stream getStreamFromPool(Device d) const override {
+    return impl_->getStreamFromPool(d);
+  }
+  void blockStream(const Stream& stream, const Stream& other) const override {
+    impl_->blockStream(stream, other);
+  }
+  void recordDataPtrOnStream(const DataPtr& data_ptr, const Stream& stream) const override {
+    impl_->recordDataPtrOnStream(data_ptr, stream);
+  }
 private:
   const DeviceGuardImplInterface* impl_ = nullptr;
 };
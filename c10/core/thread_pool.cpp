@@ -1,14 +1,87 @@
 #include <c10/core/thread_pool.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
 namespace c10 {
 
-ThreadPool::ThreadPool(int pool_size, int numa_node_id)
+namespace {
+
+size_t budgetFromEnv() {
+  const char* value = std::getenv("TORCH_THREAD_BUDGET");
+  if (!value) {
+    return 0;
+  }
+  int budget = std::atoi(value);
+  return budget > 0 ? static_cast<size_t>(budget) : 0;
+}
+
+std::atomic<size_t>& threadBudget() {
+  static std::atomic<size_t> budget{budgetFromEnv()};
+  return budget;
+}
+
+std::atomic<size_t> num_pool_threads{0};
+
+std::atomic<NUMAPolicy>& numaPolicy(ThreadPoolKind kind) {
+  auto fromEnv = [](const char* name) {
+    const char* value = std::getenv(name);
+    return value ? ParseNUMAPolicy(value) : NUMAPolicy::NONE;
+  };
+  static std::atomic<NUMAPolicy> intra_op{fromEnv("TORCH_INTRAOP_NUMA_POLICY")};
+  static std::atomic<NUMAPolicy> inter_op{fromEnv("TORCH_INTEROP_NUMA_POLICY")};
+  return kind == ThreadPoolKind::INTRA_OP ? intra_op : inter_op;
+}
+
+} // namespace
+
+NUMAPolicy getNUMAPolicy(ThreadPoolKind kind) {
+  return numaPolicy(kind).load();
+}
+
+void setNUMAPolicy(ThreadPoolKind kind, NUMAPolicy policy) {
+  numaPolicy(kind).store(policy);
+}
+
+size_t getThreadBudget() {
+  return threadBudget().load();
+}
+
+void setThreadBudget(size_t budget) {
+  threadBudget().store(budget);
+}
+
+size_t threadBudgetShare(size_t num_workers) {
+  size_t budget = getThreadBudget();
+  if (budget == 0) {
+    return 0;
+  }
+  return std::max<size_t>(1, budget / std::max<size_t>(1, num_workers));
+}
+
+size_t TaskThreadPoolBase::defaultNumThreads() {
+  size_t budget = getThreadBudget();
+  if (budget > 0) {
+    return budget;
+  }
+  return std::thread::hardware_concurrency();
+}
+
+ThreadPool::ThreadPool(
+    int pool_size,
+    int numa_node_id,
+    NUMAPolicy numa_policy)
     : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
       running_(true),
       complete_(true),
       available_(threads_.size()),
       total_(threads_.size()),
-      numa_node_id_(numa_node_id) {
+      numa_node_id_(numa_node_id),
+      numa_policy_(numa_policy),
+      home_numa_node_(
+          numa_policy == NUMAPolicy::FOLLOW ? GetCurrentCPUNUMANode() : -1) {
+  num_pool_threads += threads_.size();
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread(std::bind(&ThreadPool::main_loop, this, i));
   }
@@ -28,6 +101,11 @@ ThreadPool::~ThreadPool() {
     } catch (const std::exception&) {
     }
   }
+  num_pool_threads -= threads_.size();
+}
+
+size_t ThreadPool::numPoolThreads() {
+  return num_pool_threads.load();
 }
 
 size_t ThreadPool::size() const {
@@ -68,6 +146,8 @@ void ThreadPool::waitWorkComplete() {
 }
 
 void ThreadPool::main_loop(std::size_t index) {
+  // See Note [NUMA policies of thread pools]
+  ApplyNUMAPolicy(numa_policy_, index, total_, home_numa_node_);
   init_thread();
 
   std::unique_lock<std::mutex> lock(mutex_);
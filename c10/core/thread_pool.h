@@ -18,6 +18,62 @@ namespace ivalue {
 struct Future;
 } // namespace ivalue
 
+// Note [Thread budget]
+// ~~~~~~~~~~~~~~~~~~~~
+// A process may run several thread pools at once: the intra-op pool used by
+// at::parallel_for (OpenMP), the inter-op pool behind at::launch, and the
+// caffe2 async executor pools.  Each of them defaults to one thread per core,
+// and since every inter-op worker can start its own intra-op parallel
+// region, the process easily ends up with many times more busy threads than
+// cores.
+//
+// Setting a thread budget (with setThreadBudget() or the TORCH_THREAD_BUDGET
+// environment variable) makes the pools share it instead: pools that are not
+// given an explicit size get `budget` threads, and the intra-op parallelism
+// of each inter-op worker is limited to its share of the budget, so that the
+// number of threads doing work stays close to the budget.  Explicitly
+// requested sizes (e.g. at::set_num_threads) always take precedence.
+
+// Returns the process-wide thread budget, or 0 if none was set.
+C10_API size_t getThreadBudget();
+
+// Sets the process-wide thread budget; 0 disables it. Only affects pools
+// created afterwards.
+C10_API void setThreadBudget(size_t budget);
+
+// Returns the number of threads each of `num_workers` concurrent workers
+// may use for its own parallel work, i.e. their share of the thread budget.
+// Returns 0 if no budget is set.
+C10_API size_t threadBudgetShare(size_t num_workers);
+
+// Note [NUMA policies of thread pools]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// On machines with several NUMA nodes the OS is free to move pool workers
+// across sockets, so parallel kernels end up reading memory of a remote node.
+// Each kind of pool can be given a NUMAPolicy (see c10/util/numa.h), with
+// setNUMAPolicy() or the TORCH_INTRAOP_NUMA_POLICY and
+// TORCH_INTEROP_NUMA_POLICY environment variables ("none", "pin",
+// "interleave" or "follow"):
+//
+// - the intra-op policy applies to the workers of the OpenMP teams and of
+//   the native intra-op pool, but not to the thread that starts the parallel
+//   regions; "follow" keeps them on the node of that thread (for the shared
+//   native pool, of the thread that first used it), so that kernels run next
+//   to the tensors it allocated.
+// - the inter-op policy applies to the workers of the at::launch pool;
+//   "follow" keeps them on the node of the thread that created the pool.
+//
+// Policies only affect pools (and OpenMP teams) created afterwards.
+
+enum class ThreadPoolKind {
+  INTRA_OP,
+  INTER_OP,
+};
+
+C10_API NUMAPolicy getNUMAPolicy(ThreadPoolKind kind);
+
+C10_API void setNUMAPolicy(ThreadPoolKind kind, NUMAPolicy policy);
+
 // TODO: move this to C10 and make it C10_API
 class C10_API TaskThreadPoolBase {
  public:
@@ -37,9 +93,9 @@ class C10_API TaskThreadPoolBase {
 
   virtual ~TaskThreadPoolBase() noexcept {}
 
-  static size_t defaultNumThreads() {
-    return std::thread::hardware_concurrency();
-  }
+  // The thread budget if set, see Note [Thread budget], or the number of
+  // cores otherwise.
+  static size_t defaultNumThreads();
 };
 
 class C10_API ThreadPool : public c10::TaskThreadPoolBase {
@@ -65,13 +121,17 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
   std::size_t available_;
   std::size_t total_;
   int numa_node_id_;
+  NUMAPolicy numa_policy_;
+  // node of the thread that created the pool, for NUMAPolicy::FOLLOW
+  int home_numa_node_;
 
  public:
   ThreadPool() = delete;
 
   explicit ThreadPool(
       int pool_size,
-      int numa_node_id = -1);
+      int numa_node_id = -1,
+      NUMAPolicy numa_policy = NUMAPolicy::NONE);
 
   ~ThreadPool();
 
@@ -81,6 +141,9 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
 
   bool inThreadPool() const override;
 
+  // Total number of threads of all live ThreadPools in the process.
+  static size_t numPoolThreads();
+
   void run(const std::function<void()>& func) override;
 
   template <typename Task>
@@ -3,10 +3,14 @@
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/Backtrace.h>
+#include <c10/util/static_tracepoint.h>
 #include <c10/util/UniqueVoidPtr.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <map>
 #include <memory>
@@ -16,6 +20,15 @@
 #include <unordered_set>
 #include <vector>
 
+// Expandable segments are built on the CUDA virtual memory management driver
+// API, which first appeared in CUDA 10.2.  We dlopen libcuda rather than
+// linking against it, so that c10_cuda keeps depending on cudart only.
+#if CUDART_VERSION >= 10020 && !defined(_WIN32) && !defined(__HIP_PLATFORM_HCC__)
+#define C10_CUDA_EXPANDABLE_SEGMENTS 1
+#include <cuda.h>
+#include <dlfcn.h>
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -38,6 +51,13 @@ namespace CUDACachingAllocator {
 //   smallest available free block or allocate a new block using cudaMalloc.
 //   To reduce fragmentation, requests between 1MB and 10MB will allocate and
 //   split a 20MB block, if no free block of sufficient size is available.
+// - If PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1 is set, large requests are instead
+//   served from a single "expandable segment" per device and stream: a
+//   virtual address range as large as the device memory is reserved up front,
+//   and physical pages are mapped at its end on demand.  All large blocks of
+//   a stream are then adjacent, so free blocks can always be coalesced, and
+//   free memory at the end of the segment is unmapped by emptyCache() or on
+//   OOM.  Memory from expandable segments cannot be shared through CUDA IPC.
 //
 // With this allocator, allocations and frees should logically be considered
 // "usages" of the memory segment associated with streams, just like kernel
@@ -49,6 +69,15 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Note [Capture pools]
+// ~~~~~~~~~~~~~~~~~~~~
+// A CUDA graph captured from a stream replays its kernels on the addresses
+// they used during capture. The blocks allocated or freed between
+// beginCapturePool() and endCapturePool() therefore belong to a capture pool:
+// when they are freed, they are not reused by any allocation until the pool is
+// released with releaseCapturePool(), which the owner of the graph does when
+// the graph is destroyed.
+//
 
 
 
@@ -68,10 +97,11 @@ struct DeviceStats {
   uint64_t   max_amount_allocated;  // max total amount allocated in bytes
   uint64_t   amount_cached;         // total amount in cache in bytes
   uint64_t   max_amount_cached;     // max total amount in cache in bytes
+  AllocatorEventCounts events;      // counters of allocator events
 
   DeviceStats() :
       amount_allocated(0), max_amount_allocated(0),
-      amount_cached(0), max_amount_cached(0) { }
+      amount_cached(0), max_amount_cached(0), events() { }
 
   void increaseAllocated(size_t delta) {
     amount_allocated += delta;
@@ -93,6 +123,7 @@ struct DeviceStats {
 };
 
 struct Block;
+struct ExpandableSegment;
 typedef bool (*Comparison)(const Block*, const Block*);
 typedef std::set<Block*, Comparison> BlockPool;
 
@@ -107,17 +138,192 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* segment; // owning expandable segment, if any
+  std::unique_ptr<std::string> history; // backtrace of the allocation
+  uint64_t      capture_pool; // capture pool the block was allocated in, or 0
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    segment(nullptr), capture_pool(0) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    segment(nullptr), capture_pool(0) { }
+};
+
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+
+// Entry points of the driver API used by expandable segments, resolved at
+// runtime from libcuda.
+struct DriverAPI {
+#define C10_FORALL_DRIVER_FUNCTIONS(_) \
+  _(cuMemAddressReserve)               \
+  _(cuMemAddressFree)                  \
+  _(cuMemCreate)                       \
+  _(cuMemRelease)                      \
+  _(cuMemMap)                          \
+  _(cuMemUnmap)                        \
+  _(cuMemSetAccess)                    \
+  _(cuMemGetAllocationGranularity)     \
+  _(cuGetErrorString)
+
+#define C10_DECLARE_DRIVER_FUNCTION(name) decltype(&name) name##_;
+  C10_FORALL_DRIVER_FUNCTIONS(C10_DECLARE_DRIVER_FUNCTION)
+#undef C10_DECLARE_DRIVER_FUNCTION
+
+  // Returns nullptr if libcuda or any of the entry points is unavailable.
+  static DriverAPI* get() {
+    static DriverAPI* api = []() -> DriverAPI* {
+      void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_NOLOAD);
+      if (!handle) {
+        handle = dlopen("libcuda.so.1", RTLD_LAZY);
+      }
+      if (!handle) {
+        return nullptr;
+      }
+      auto result = new DriverAPI();
+#define C10_LOOKUP_DRIVER_FUNCTION(name)                              \
+      result->name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+      if (!result->name##_) {                                         \
+        delete result;                                                \
+        return nullptr;                                               \
+      }
+      C10_FORALL_DRIVER_FUNCTIONS(C10_LOOKUP_DRIVER_FUNCTION)
+#undef C10_LOOKUP_DRIVER_FUNCTION
+      return result;
+    }();
+    return api;
+  }
+#undef C10_FORALL_DRIVER_FUNCTIONS
+};
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                  \
+  do {                                                               \
+    CUresult __err = EXPR;                                           \
+    if (__err != CUDA_SUCCESS) {                                     \
+      const char* err_str = nullptr;                                 \
+      DriverAPI::get()->cuGetErrorString_(__err, &err_str);          \
+      AT_ERROR("CUDA driver error: ", err_str ? err_str : "unknown"); \
+    }                                                                \
+  } while (0)
+
+// A reserved range of virtual addresses on one device, of which a prefix is
+// backed by physical memory.  Physical memory is allocated in units of the
+// device's allocation granularity, one handle per unit, so that it can be
+// released again from the end of the segment.
+struct ExpandableSegment {
+  int device;
+  cudaStream_t stream;
+  CUdeviceptr base;
+  size_t reserved_size;
+  size_t granularity;
+  std::vector<CUmemGenericAllocationHandle> handles;
+  // the block that ends at base + mapped_size(), if any memory is mapped
+  Block* tail;
+
+  ExpandableSegment(int device, cudaStream_t stream) :
+      device(device), stream(stream), base(0), reserved_size(0),
+      granularity(0), handles(), tail(nullptr) {
+    auto api = DriverAPI::get();
+    AT_CHECK(api, "PYTORCH_CUDA_EXPANDABLE_SEGMENTS requires the CUDA driver "
+             "library (libcuda.so.1) to be available");
+    CUmemAllocationProp prop = allocation_prop();
+    C10_CUDA_DRIVER_CHECK(api->cuMemGetAllocationGranularity_(
+        &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    reserved_size = granularity * ((device_total + granularity - 1) / granularity);
+    C10_CUDA_DRIVER_CHECK(api->cuMemAddressReserve_(&base, reserved_size, 0, 0, 0));
+  }
+
+  size_t mapped_size() const {
+    return handles.size() * granularity;
+  }
+
+  size_t round_size(size_t size) const {
+    return granularity * ((size + granularity - 1) / granularity);
+  }
+
+  void* ptr_at(size_t offset) const {
+    return reinterpret_cast<void*>(base + offset);
+  }
+
+  // Maps `size` (a multiple of the granularity) more bytes at the end of the
+  // segment. Returns false, leaving the segment unchanged, if the device is
+  // out of memory.
+  bool grow(size_t size) {
+    auto api = DriverAPI::get();
+    size_t begin = mapped_size();
+    if (begin + size > reserved_size) {
+      return false;
+    }
+    CUmemAllocationProp prop = allocation_prop();
+    size_t num_pages = size / granularity;
+    for (size_t i = 0; i < num_pages; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = api->cuMemCreate_(&handle, granularity, &prop, 0);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        unmap(begin, mapped_size());
+        return false;
+      }
+      C10_CUDA_DRIVER_CHECK(err);
+      C10_CUDA_DRIVER_CHECK(api->cuMemMap_(
+          base + mapped_size(), granularity, 0, handle, 0));
+      handles.push_back(handle);
+    }
+    CUmemAccessDesc desc;
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(api->cuMemSetAccess_(base + begin, size, &desc, 1));
+    return true;
+  }
+
+  // Releases the physical memory backing [begin, mapped_size()).
+  void shrink_to(size_t begin) {
+    unmap(begin, mapped_size());
+  }
+
+ private:
+  CUmemAllocationProp allocation_prop() const {
+    CUmemAllocationProp prop;
+    memset(&prop, 0, sizeof(prop));
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    return prop;
+  }
+
+  void unmap(size_t begin, size_t end) {
+    auto api = DriverAPI::get();
+    AT_ASSERT(begin % granularity == 0 && end == mapped_size());
+    if (begin == end) {
+      return;
+    }
+    // The memory may still be in use by kernels in flight on the stream.
+    C10_CUDA_CHECK(cudaStreamSynchronize(stream));
+    C10_CUDA_DRIVER_CHECK(api->cuMemUnmap_(base + begin, end - begin));
+    while (mapped_size() > begin) {
+      C10_CUDA_DRIVER_CHECK(api->cuMemRelease_(handles.back()));
+      handles.pop_back();
+    }
+  }
+};
+
+#else
+
+// Stub so that the allocator compiles where the driver API is unavailable;
+// expandable segments are never created in that case.
+struct ExpandableSegment {
+  Block* tail;
 };
 
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->device != b->device) {
@@ -176,9 +382,36 @@ struct THCCachingAllocator
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
 
+  // whether large allocations are served from expandable segments
+  bool use_expandable_segments;
+
+  // whether to record a backtrace for each allocation
+  bool record_history;
+
+  // expandable segments by device and stream
+  std::map<std::pair<int, cudaStream_t>, std::unique_ptr<ExpandableSegment>> expandable_segments;
+
+  // the capture pool new allocations are made in, or 0
+  uint64_t active_capture_pool;
+
+  // the last capture pool id handed out
+  uint64_t last_capture_pool;
+
+  // blocks freed while they belong to a capture pool, by pool
+  std::unordered_map<uint64_t, std::vector<Block*>> capture_pool_frees;
+
   THCCachingAllocator() :
       large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      small_blocks(BlockComparator),
+      use_expandable_segments(false),
+      record_history(false),
+      active_capture_pool(0),
+      last_capture_pool(0) {
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    const char* env = std::getenv("PYTORCH_CUDA_EXPANDABLE_SEGMENTS");
+    use_expandable_segments = env != nullptr && strcmp(env, "1") == 0;
+#endif
+  }
 
   DeviceStats &get_stats_for_device(int device) {
     AT_ASSERT(device >= 0);
@@ -202,6 +435,7 @@ struct THCCachingAllocator
     size = round_size(size);
 
     DeviceStats &stats = get_stats_for_device(device);
+    stats.events.num_allocs++;
 
     Block search_key(device, stream, size);
     auto& pool = get_pool(size);
@@ -228,13 +462,31 @@ struct THCCachingAllocator
         block = find_free_block();
       }
     }
+    if (block == nullptr && use_expandable_segments && &pool == &large_blocks) {
+      block = expand_segment_retry(device, stream, size);
+      if (block == nullptr) {
+        stats.events.num_ooms++;
+        size_t device_free;
+        size_t device_total;
+        C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+        AT_ERROR(
+          "CUDA out of memory. Tried to allocate ", format_size(size),
+          " (GPU ", device, "; ",
+          format_size(device_total), " total capacity; ",
+          format_size(stats.amount_allocated), " already allocated; ",
+          format_size(device_free), " free; ",
+          format_size(stats.amount_cached - stats.amount_allocated), " cached)");
+      }
+    }
     if (block == nullptr) {
       void* ptr;
       size_t alloc_size = get_allocation_size(size);
+      C10_SDT(cuda_cache_miss, device, size, alloc_size);
       cudaError_t err = cuda_malloc_retry(device, &ptr, alloc_size);
       if (err != cudaSuccess) {
         if (err == cudaErrorMemoryAllocation) {
           cudaGetLastError();  // clear CUDA error
+          stats.events.num_ooms++;
 
           size_t device_free;
           size_t device_total;
@@ -270,6 +522,7 @@ struct THCCachingAllocator
         }
       }
       stats.increaseCached(alloc_size);
+      stats.events.num_cuda_mallocs++;
       block = new Block(device, stream, alloc_size, &pool, ptr);
     }
 
@@ -277,9 +530,11 @@ struct THCCachingAllocator
     AT_ASSERT(block);
     if (should_split(block, size)) {
 
+      stats.events.num_splits++;
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->segment = remaining->segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -293,11 +548,18 @@ struct THCCachingAllocator
     }
 
     block->allocated = true;
+    block->capture_pool = active_capture_pool;
     allocated_blocks[block->ptr] = block;
+    if (record_history) {
+      block->history.reset(new std::string(c10::get_backtrace(1)));
+    }
 
     *devPtr = block->ptr;
+    C10_SDT(cuda_malloc, device, block->ptr, block->size, stream);
 
     stats.increaseAllocated(block->size);
+    c10::reportMemoryUsage(
+        block->ptr, block->size, c10::Device(c10::DeviceType::CUDA, device));
   }
 
   void free(void* ptr)
@@ -314,9 +576,28 @@ struct THCCachingAllocator
 
     Block* block = it->second;
     allocated_blocks.erase(it);
-    block->allocated = false;
+    block->history.reset();
+    C10_SDT(cuda_free, block->device, block->ptr, block->size, block->stream);
+
+    DeviceStats& stats = get_stats_for_device(block->device);
+    stats.events.num_frees++;
+    stats.decreaseAllocated(block->size);
+    c10::reportMemoryUsage(
+        block->ptr,
+        -static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, block->device));
+
+    // A captured graph may still read or write the block when it is replayed,
+    // so it stays allocated until its capture pool is released
+    // (see Note [Capture pools])
+    uint64_t capture_pool = block->capture_pool ? block->capture_pool : active_capture_pool;
+    if (capture_pool != 0) {
+      block->capture_pool = capture_pool;
+      capture_pool_frees[capture_pool].push_back(block);
+      return;
+    }
 
-    get_stats_for_device(block->device).decreaseAllocated(block->size);
+    block->allocated = false;
     if (!block->stream_uses.empty()) {
       insert_events(block);
     } else {
@@ -324,6 +605,47 @@ struct THCCachingAllocator
     }
   }
 
+  /** makes the blocks allocated or freed until endCapturePool() part of a new capture pool */
+  uint64_t beginCapturePool()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    AT_CHECK(active_capture_pool == 0, "beginCapturePool: a capture pool is already active");
+    active_capture_pool = ++last_capture_pool;
+    return active_capture_pool;
+  }
+
+  void endCapturePool()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    active_capture_pool = 0;
+  }
+
+  /** frees the blocks of a capture pool that were freed, and detaches the others from it */
+  void releaseCapturePool(uint64_t capture_pool)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    AT_ASSERT(capture_pool != active_capture_pool);
+    for (auto& entry : allocated_blocks) {
+      if (entry.second->capture_pool == capture_pool) {
+        entry.second->capture_pool = 0;
+      }
+    }
+    auto it = capture_pool_frees.find(capture_pool);
+    if (it == capture_pool_frees.end()) {
+      return;
+    }
+    for (Block* block : it->second) {
+      block->capture_pool = 0;
+      block->allocated = false;
+      if (!block->stream_uses.empty()) {
+        insert_events(block);
+      } else {
+        free_block(block);
+      }
+    }
+    capture_pool_frees.erase(it);
+  }
+
   /** returns cached blocks to the system allocator */
   void emptyCache()
   {
@@ -395,6 +717,63 @@ struct THCCachingAllocator
     }
   }
 
+  /** returns a description of every segment and block of the allocator */
+  std::vector<SegmentInfo> snapshot()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    // Every block is either allocated, cached in one of the pools, or waiting
+    // for events recorded by recordStream(); collect the first block of every
+    // segment from all of them.
+    std::set<Block*, Comparison> heads(BlockComparator);
+    auto add_head = [&](Block* block) {
+      while (block->prev) {
+        block = block->prev;
+      }
+      heads.insert(block);
+    };
+    for (auto& entry : allocated_blocks) {
+      add_head(entry.second);
+    }
+    for (Block* block : large_blocks) {
+      add_head(block);
+    }
+    for (Block* block : small_blocks) {
+      add_head(block);
+    }
+    for (auto& entry : cuda_events) {
+      add_head(entry.second);
+    }
+
+    std::vector<SegmentInfo> result;
+    result.reserve(heads.size());
+    for (Block* head : heads) {
+      result.emplace_back();
+      SegmentInfo& segment_info = result.back();
+      segment_info.device = head->device;
+      segment_info.address = reinterpret_cast<uintptr_t>(head->ptr);
+      segment_info.stream = reinterpret_cast<uintptr_t>(head->stream);
+      segment_info.is_large = (head->pool == &large_blocks);
+      segment_info.is_expandable = (head->segment != nullptr);
+      for (Block* block = head; block != nullptr; block = block->next) {
+        segment_info.blocks.emplace_back();
+        BlockInfo& block_info = segment_info.blocks.back();
+        block_info.size = block->size;
+        block_info.allocated = block->allocated;
+        block_info.event_count = block->event_count;
+        block_info.stream_uses = block->stream_uses.size();
+        if (block->history) {
+          block_info.history = *block->history;
+        }
+        segment_info.total_size += block->size;
+        if (block->allocated) {
+          segment_info.allocated_size += block->size;
+        }
+      }
+    }
+    return result;
+  }
+
   /** moves a block into a pool of cached free blocks */
   void free_block(Block* block)
   {
@@ -424,10 +803,107 @@ struct THCCachingAllocator
       }
     }
     dst->size += src->size;
+    get_stats_for_device(dst->device).events.num_merges++;
+    if (src->segment && src->segment->tail == src) {
+      src->segment->tail = dst;
+    }
     pool.erase(src);
     delete src;
   }
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+  ExpandableSegment* get_expandable_segment(int device, cudaStream_t stream)
+  {
+    auto& segment = expandable_segments[std::make_pair(device, stream)];
+    if (!segment) {
+      segment.reset(new ExpandableSegment(device, stream));
+    }
+    return segment.get();
+  }
+
+  /** returns a free block of at least `size` bytes at the end of the
+   *  expandable segment for (device, stream), mapping more memory into the
+   *  segment as needed, or nullptr if the device is out of memory */
+  Block* expand_segment(int device, cudaStream_t stream, size_t size)
+  {
+    ExpandableSegment* segment = get_expandable_segment(device, stream);
+    Block* tail = segment->tail;
+    if (tail && !tail->allocated && tail->event_count == 0) {
+      // The free block at the end of the segment is too small; extend it
+      // rather than creating a new block next to it.
+      size_t grow_size = segment->round_size(size - tail->size);
+      if (!segment->grow(grow_size)) {
+        return nullptr;
+      }
+      large_blocks.erase(tail);
+      tail->size += grow_size;
+      DeviceStats& stats = get_stats_for_device(device);
+      stats.increaseCached(grow_size);
+      stats.events.num_cuda_mallocs++;
+      return tail;
+    }
+    size_t grow_size = segment->round_size(size);
+    void* ptr = segment->ptr_at(segment->mapped_size());
+    if (!segment->grow(grow_size)) {
+      return nullptr;
+    }
+    Block* block = new Block(device, stream, grow_size, &large_blocks, ptr);
+    block->segment = segment;
+    block->prev = tail;
+    if (tail) {
+      tail->next = block;
+    }
+    segment->tail = block;
+    DeviceStats& stats = get_stats_for_device(device);
+    stats.increaseCached(grow_size);
+    stats.events.num_cuda_mallocs++;
+    return block;
+  }
+
+  Block* expand_segment_retry(int device, cudaStream_t stream, size_t size)
+  {
+    Block* block = expand_segment(device, stream, size);
+    if (!block) {
+      get_stats_for_device(device).events.num_alloc_retries++;
+      free_cached_blocks(device);
+      block = expand_segment(device, stream, size);
+    }
+    return block;
+  }
+
+  /** unmaps the pages of a free block at the end of its segment; returns
+   *  true if the whole block was released and deleted */
+  bool release_segment_tail(Block* block)
+  {
+    ExpandableSegment* segment = block->segment;
+    size_t offset = static_cast<char*>(block->ptr) - reinterpret_cast<char*>(segment->base);
+    size_t begin = segment->round_size(offset);
+    size_t released = segment->mapped_size() - begin;
+    if (released == 0) {
+      return false;
+    }
+    segment->shrink_to(begin);
+    DeviceStats& stats = get_stats_for_device(block->device);
+    stats.decreaseCached(released);
+    stats.events.num_cuda_frees++;
+    block->size -= released;
+    if (block->size > 0) {
+      return false;
+    }
+    segment->tail = block->prev;
+    if (block->prev) {
+      block->prev->next = nullptr;
+    }
+    delete block;
+    return true;
+  }
+#else
+  Block* expand_segment_retry(int device, cudaStream_t stream, size_t size)
+  {
+    return nullptr;
+  }
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS
+
   BlockPool& get_pool(size_t size) {
     if (size <= kSmallSize) {
       return small_blocks;
@@ -472,6 +948,7 @@ struct THCCachingAllocator
     cudaError_t err = cudaMalloc(devPtr, size);
     if (err != cudaSuccess) {
       cudaGetLastError();  // reset the last CUDA error
+      get_stats_for_device(device).events.num_alloc_retries++;
       free_cached_blocks(device);
       err = cudaMalloc(devPtr, size);
       if (err != cudaSuccess) {
@@ -503,13 +980,36 @@ struct THCCachingAllocator
 
   void free_blocks(BlockPool& blocks, BlockPool::iterator it, BlockPool::iterator end)
   {
-    // Frees all non-split blocks between `it` and `end`
+    // Frees all non-split blocks between `it` and `end`, and unmaps the free
+    // memory at the end of expandable segments
     std::lock_guard<std::mutex> lock(cuda_free_mutex);
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    std::vector<Block*> shrunk_blocks;
+#endif
     while (it != end) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (block->segment) {
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+        if (block->segment->tail == block) {
+          // releasing changes the size of the block, and with it its position
+          // in the pool, so take it out and put it back afterwards
+          auto cur = it;
+          ++it;
+          blocks.erase(cur);
+          if (!release_segment_tail(block)) {
+            shrunk_blocks.push_back(block);
+          }
+        } else {
+          ++it;
+        }
+#else
+        ++it;
+#endif
+      } else if (!block->prev && !block->next) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
-        get_stats_for_device(block->device).decreaseCached(block->size);
+        DeviceStats& stats = get_stats_for_device(block->device);
+        stats.decreaseCached(block->size);
+        stats.events.num_cuda_frees++;
         auto cur = it;
         ++it;
         blocks.erase(cur);
@@ -518,6 +1018,11 @@ struct THCCachingAllocator
         ++it;
       }
     }
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS
+    for (Block* block : shrunk_blocks) {
+      blocks.insert(block);
+    }
+#endif
   }
 
   void synchronize_and_free_events(optional<int> device) {
@@ -656,6 +1161,32 @@ void recordStream(void *ptr, cuda::CUDAStream stream)
   caching_allocator.recordStream(ptr, stream);
 }
 
+uint64_t beginCapturePool()
+{
+  return caching_allocator.beginCapturePool();
+}
+
+void endCapturePool()
+{
+  caching_allocator.endCapturePool();
+}
+
+void releaseCapturePool(uint64_t capture_pool)
+{
+  caching_allocator.releaseCapturePool(capture_pool);
+}
+
+std::vector<SegmentInfo> snapshot()
+{
+  return caching_allocator.snapshot();
+}
+
+void recordHistory(bool enabled)
+{
+  std::lock_guard<std::recursive_mutex> lock(caching_allocator.mutex);
+  caching_allocator.record_history = enabled;
+}
+
 std::mutex* getFreeMutex()
 {
   return &caching_allocator.cuda_free_mutex;
@@ -683,6 +1214,13 @@ void resetMaxMemoryAllocated(int device) {
   stats.max_amount_allocated = stats.amount_allocated;
 }
 
+AllocatorEventCounts eventCounts(int device)
+{
+  assertValidDevice(device);
+  std::lock_guard<std::recursive_mutex> lock(caching_allocator.mutex);
+  return caching_allocator.get_stats_for_device(device).events;
+}
+
 uint64_t currentMemoryCached(int device)
 {
   assertValidDevice(device);
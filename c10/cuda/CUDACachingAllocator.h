@@ -7,6 +7,8 @@
 #include <c10/util/Registry.h>
 
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace c10 {
 
@@ -39,6 +41,45 @@ namespace cuda {
 
 namespace CUDACachingAllocator {
 
+// Struct containing info of an allocation block (i.e. a fractional part of a
+// cudaMalloc'd segment).
+struct BlockInfo {
+  int64_t size = 0;
+  bool allocated = false;
+  // number of pending events recorded by recordStream() before the block can
+  // be reused
+  int64_t event_count = 0;
+  // number of streams recorded by recordStream() for a live allocation
+  int64_t stream_uses = 0;
+  // backtrace of the allocation, only filled in if recordHistory(true)
+  std::string history;
+};
+
+// Struct containing info of a memory segment (i.e. one contiguous cudaMalloc,
+// or an expandable segment).
+struct SegmentInfo {
+  int64_t device = 0;
+  uintptr_t address = 0;
+  uintptr_t stream = 0;
+  int64_t total_size = 0;
+  int64_t allocated_size = 0;
+  bool is_large = false;
+  bool is_expandable = false;
+  std::vector<BlockInfo> blocks;
+};
+
+// Counters of allocator events on one device, since the start of the program.
+struct AllocatorEventCounts {
+  uint64_t num_allocs = 0;         // calls to malloc
+  uint64_t num_frees = 0;          // calls to free
+  uint64_t num_cuda_mallocs = 0;   // segments obtained from the driver
+  uint64_t num_cuda_frees = 0;     // segments returned to the driver
+  uint64_t num_alloc_retries = 0;  // mallocs that had to free the cache first
+  uint64_t num_ooms = 0;           // mallocs that failed
+  uint64_t num_splits = 0;         // blocks split to serve a request
+  uint64_t num_merges = 0;         // free blocks merged with a neighbour
+};
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void raw_delete(void* ptr);
 
@@ -47,6 +88,10 @@ C10_CUDA_API void emptyCache();
 C10_CUDA_API void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock);
 C10_CUDA_API void* getBaseAllocation(void *ptr, size_t *size);
 C10_CUDA_API void recordStream(void *ptr, CUDAStream stream);
+// See Note [Capture pools] in CUDACachingAllocator.cpp
+C10_CUDA_API uint64_t beginCapturePool();
+C10_CUDA_API void endCapturePool();
+C10_CUDA_API void releaseCapturePool(uint64_t capture_pool);
 C10_CUDA_API uint64_t currentMemoryAllocated(int device);
 C10_CUDA_API uint64_t maxMemoryAllocated(int device);
 C10_CUDA_API void     resetMaxMemoryAllocated(int device);
@@ -54,6 +99,10 @@ C10_CUDA_API uint64_t currentMemoryCached(int device);
 C10_CUDA_API uint64_t maxMemoryCached(int device);
 C10_CUDA_API void     resetMaxMemoryCached(int device);
 
+C10_CUDA_API std::vector<SegmentInfo> snapshot();
+C10_CUDA_API AllocatorEventCounts eventCounts(int device);
+C10_CUDA_API void recordHistory(bool enabled);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
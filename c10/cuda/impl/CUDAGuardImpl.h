@@ -3,6 +3,7 @@
 #include <c10/core/impl/DeviceGuardImplInterface.h>
 #include <c10/macros/Macros.h>
 
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAStream.h>
 #include <c10/cuda/CUDAFunctions.h>
@@ -58,6 +59,29 @@ struct CUDAGuardImpl final : public c10::impl::DeviceGuardImplInterface {
   DeviceIndex deviceCount() const noexcept override {
     return device_count();
   }
+  Stream getStreamFromPool(Device d) const override {
+    return cuda::getStreamFromPool(/*isHighPriority=*/false, d.index()).unwrap();
+  }
+  void blockStream(const Stream& stream, const Stream& other) const override {
+    if (stream == other) {
+      return;
+    }
+    // The event must be created on the device of the stream it is recorded on
+    Device old_device = exchangeDevice(other.device());
+    cudaEvent_t event;
+    C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    C10_CUDA_CHECK(cudaEventRecord(event, CUDAStream(other).stream()));
+    C10_CUDA_CHECK(cudaStreamWaitEvent(CUDAStream(stream).stream(), event, 0));
+    // Destroying the event doesn't cancel the wait
+    C10_CUDA_CHECK(cudaEventDestroy(event));
+    setDevice(old_device);
+  }
+  void recordDataPtrOnStream(const DataPtr& data_ptr, const Stream& stream) const override {
+    // Only the memory of the caching allocator can be reused early
+    if (data_ptr.get_deleter() == CUDACachingAllocator::get()->raw_deleter()) {
+      CUDACachingAllocator::recordStream(data_ptr.get(), CUDAStream(stream));
+    }
+  }
 };
 
 }}} // namespace c10::cuda::impl
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+#include <cstdint>
+
+using namespace c10;
+
+namespace {
+
+bool isAligned(void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % gAlignment == 0;
+}
+
+} // namespace
+
+TEST(CPUAllocatorTest, CachedAllocationsAreReused) {
+  ReleaseCPUAllocatorThreadCache();
+  void* a = alloc_cpu_cached(1000);
+  ASSERT_TRUE(isAligned(a));
+  free_cpu_cached(a);
+  // 1000 and 1024 bytes fall into the same size class
+  void* b = alloc_cpu_cached(1024);
+  ASSERT_EQ(a, b);
+  void* c = alloc_cpu_cached(1024);
+  ASSERT_NE(b, c);
+  free_cpu_cached(b);
+  free_cpu_cached(c);
+  ReleaseCPUAllocatorThreadCache();
+}
+
+TEST(CPUAllocatorTest, LargeAllocationsAreNotCached) {
+  ReleaseCPUAllocatorThreadCache();
+  size_t nbytes = FLAGS_caffe2_cpu_allocator_max_cached_size + 1;
+  void* a = alloc_cpu_cached(nbytes);
+  ASSERT_TRUE(isAligned(a));
+  static_cast<char*>(a)[nbytes - 1] = 1;
+  free_cpu_cached(a);
+  free_cpu_cached(nullptr);
+  ASSERT_EQ(alloc_cpu_cached(0), nullptr);
+}
+
+TEST(CPUAllocatorTest, DefaultAllocatorUsesCache) {
+  bool use_caching = FLAGS_caffe2_cpu_allocator_use_caching;
+  FLAGS_caffe2_cpu_allocator_use_caching = true;
+  ReleaseCPUAllocatorThreadCache();
+  Allocator* allocator = GetDefaultCPUAllocator();
+  void* first;
+  {
+    DataPtr ptr = allocator->allocate(256);
+    first = ptr.get();
+  }
+  {
+    DataPtr ptr = allocator->allocate(200);
+    ASSERT_EQ(ptr.get(), first);
+  }
+  void* raw = allocator->raw_allocate(128);
+  allocator->raw_deallocate(raw);
+  ReleaseCPUAllocatorThreadCache();
+  FLAGS_caffe2_cpu_allocator_use_caching = use_caching;
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace c10;
+
+TEST(ThreadBudgetTest, BudgetControlsDefaultPoolSize) {
+  size_t old_budget = getThreadBudget();
+
+  setThreadBudget(0);
+  ASSERT_EQ(TaskThreadPoolBase::defaultNumThreads(), std::thread::hardware_concurrency());
+  ASSERT_EQ(threadBudgetShare(4), 0);
+
+  setThreadBudget(8);
+  ASSERT_EQ(TaskThreadPoolBase::defaultNumThreads(), 8);
+  ASSERT_EQ(threadBudgetShare(1), 8);
+  ASSERT_EQ(threadBudgetShare(3), 2);
+  ASSERT_EQ(threadBudgetShare(16), 1);
+  {
+    size_t before = ThreadPool::numPoolThreads();
+    ThreadPool pool(-1);
+    ASSERT_EQ(pool.size(), 8);
+    ASSERT_EQ(ThreadPool::numPoolThreads(), before + 8);
+  }
+
+  setThreadBudget(old_budget);
+}
+
+TEST(NUMAPolicyTest, PolicyIsAppliedToPoolWorkers) {
+  ASSERT_EQ(ParseNUMAPolicy("pin"), NUMAPolicy::PIN);
+  ASSERT_STREQ(NUMAPolicyName(ParseNUMAPolicy("interleave")), "interleave");
+  ASSERT_ANY_THROW(ParseNUMAPolicy("spread"));
+
+  NUMAPolicy old_policy = getNUMAPolicy(ThreadPoolKind::INTER_OP);
+  setNUMAPolicy(ThreadPoolKind::INTER_OP, NUMAPolicy::FOLLOW);
+  ASSERT_EQ(getNUMAPolicy(ThreadPoolKind::INTER_OP), NUMAPolicy::FOLLOW);
+  setNUMAPolicy(ThreadPoolKind::INTER_OP, old_policy);
+
+  // the policy is only recorded where it could be applied
+  NUMAPolicy expected =
+      GetCurrentCPUNUMANode() >= 0 ? NUMAPolicy::FOLLOW : NUMAPolicy::NONE;
+  ThreadPool pool(2, -1, NUMAPolicy::FOLLOW);
+  std::atomic<int> matches{0};
+  for (int i = 0; i < 2; ++i) {
+    pool.run([&]() {
+      if (GetThreadNUMAPolicy() == expected) {
+        ++matches;
+      }
+    });
+  }
+  pool.waitWorkComplete();
+  ASSERT_EQ(matches.load(), 2);
+}
@@ -0,0 +1,190 @@
+#include <c10/util/CopyOnWrite.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using c10::CopyOnWrite;
+using std::vector;
+
+TEST(CopyOnWriteTest, givenInt_whenWritingAndReading_thenChangesArePresent) {
+    CopyOnWrite<int> obj;
+
+    obj.write([] (int& obj) {obj = 5;});
+    int read = obj.read([] (const int& obj) {return obj;});
+    EXPECT_EQ(5, read);
+
+    // check changes are also present in the next copy
+    obj.write([] (int&) {});
+    read = obj.read([] (const int& obj) {return obj;});
+    EXPECT_EQ(5, read);
+}
+
+TEST(CopyOnWriteTest, givenVector_whenWritingAndReading_thenChangesArePresent) {
+    CopyOnWrite<vector<int>> obj;
+
+    obj.write([] (vector<int>& obj) {obj.push_back(5);});
+    vector<int> read = obj.read([] (const vector<int>& obj) {return obj;});
+    EXPECT_EQ((vector<int>{5}), read);
+
+    obj.write([] (vector<int>& obj) {obj.push_back(6);});
+    read = obj.read([] (const vector<int>& obj) {return obj;});
+    EXPECT_EQ((vector<int>{5, 6}), read);
+}
+
+TEST(CopyOnWriteTest, givenVector_whenWritingReturnsValue_thenValueIsReturned) {
+    CopyOnWrite<vector<int>> obj;
+
+    auto a = obj.write([] (vector<int>&) -> int {return 5;});
+    static_assert(std::is_same<int, decltype(a)>::value, "");
+    EXPECT_EQ(5, a);
+}
+
+TEST(CopyOnWriteTest, givenConstructorArguments_whenReading_thenInitialValueIsPresent) {
+    CopyOnWrite<vector<int>> obj(3, 7);
+
+    vector<int> read = obj.read([] (const vector<int>& obj) {return obj;});
+    EXPECT_EQ((vector<int>{3, 7}), read);
+}
+
+TEST(CopyOnWriteTest, givenReferenceFromRead_whenWriting_thenReferenceStaysValidAndUnchanged) {
+    CopyOnWrite<vector<int>> obj;
+    obj.write([] (vector<int>& obj) {obj.push_back(5);});
+
+    const vector<int>& old = obj.read([] (const vector<int>& obj) -> const vector<int>& {return obj;});
+    obj.write([] (vector<int>& obj) {obj[0] = 6;});
+
+    EXPECT_EQ((vector<int>{5}), old);
+    int read = obj.read([] (const vector<int>& obj) {return obj[0];});
+    EXPECT_EQ(6, read);
+}
+
+TEST(CopyOnWriteTest, readsCanBeConcurrent) {
+    CopyOnWrite<int> obj;
+    std::atomic<int> num_running_readers{0};
+
+    std::thread reader1([&] () {
+        obj.read([&] (const int&) {
+            ++num_running_readers;
+            while(num_running_readers.load() < 2) {}
+        });
+    });
+
+    std::thread reader2([&] () {
+        obj.read([&] (const int&) {
+            ++num_running_readers;
+            while(num_running_readers.load() < 2) {}
+        });
+    });
+
+    // the threads only finish after both entered the read function.
+    // if CopyOnWrite didn't allow concurrency, this would cause a deadlock.
+    reader1.join();
+    reader2.join();
+}
+
+TEST(CopyOnWriteTest, writesCanBeConcurrentWithReads) {
+    CopyOnWrite<int> obj;
+    std::atomic<bool> reader_running{false};
+    std::atomic<bool> writer_finished{false};
+
+    std::thread reader([&] () {
+        obj.read([&] (const int& value) {
+            reader_running = true;
+            while(!writer_finished.load()) {}
+            // the write went to a copy
+            EXPECT_EQ(0, value);
+        });
+    });
+
+    std::thread writer([&] () {
+        while (!reader_running.load()) {}
+
+        obj.write([&] (int& obj) {obj = 5;});
+        writer_finished = true;
+    });
+
+    // the threads only finish if the writer didn't wait for the reader.
+    reader.join();
+    writer.join();
+    EXPECT_EQ(5, obj.read([] (const int& obj) {return obj;}));
+}
+
+TEST(CopyOnWriteTest, writesCannotBeConcurrentWithWrites) {
+    CopyOnWrite<int> obj;
+    std::atomic<bool> first_writer_started{false};
+    std::atomic<bool> first_writer_finished{false};
+
+    std::thread writer1([&] () {
+        obj.write([&] (int&) {
+            first_writer_started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            first_writer_finished = true;
+        });
+    });
+
+    std::thread writer2([&] () {
+        // make sure the other writer runs first
+        while (!first_writer_started.load()) {}
+
+        obj.write([&] (int&) {
+            // expect the other writer finished before this one starts
+            EXPECT_TRUE(first_writer_finished.load());
+        });
+    });
+
+    writer1.join();
+    writer2.join();
+}
+
+TEST(CopyOnWriteTest, concurrentWritesAreAllApplied) {
+    CopyOnWrite<vector<int>> obj;
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([&obj] () {
+            for (int j = 0; j < 100; ++j) {
+                obj.write([] (vector<int>& obj) {obj.push_back(0);});
+                obj.read([] (const vector<int>& obj) {return obj.size();});
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    EXPECT_EQ(400, obj.read([] (const vector<int>& obj) {return obj.size();}));
+}
+
+namespace {
+class MyException : public std::exception {};
+}
+
+TEST(CopyOnWriteTest, whenReadThrowsException_thenThrowsThrough) {
+    CopyOnWrite<int> obj;
+
+    EXPECT_THROW(
+        obj.read([](const int&) {throw MyException();}),
+        MyException
+    );
+}
+
+TEST(CopyOnWriteTest, givenInt_whenWriteThrowsException_thenKeepsOldState) {
+    CopyOnWrite<int> obj;
+
+    obj.write([](int& obj) {obj = 5;});
+
+    EXPECT_THROW(
+        obj.write([](int& obj) {
+            obj = 6;
+            throw MyException();
+        }),
+        MyException
+    );
+
+    int read = obj.read([] (const int& obj) {return obj;});
+    EXPECT_EQ(5, read);
+
+    // and the next write starts from the old state
+    obj.write([] (int& obj) {obj += 1;});
+    read = obj.read([] (const int& obj) {return obj;});
+    EXPECT_EQ(6, read);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+/// Defines the BFloat16 type (brain floating-point): the upper 16 bits of an
+/// IEEE float32, with its 8 bit exponent and 7 (instead of 23) mantissa bits.
+/// It has the range of float32 at the precision of about 3 decimal digits, so
+/// unlike Half it can be used in training without loss scaling, and converting
+/// from and to float32 is just a shift. As for Half, arithmetic is implemented
+/// by converting to float and performing the operation in float32; see
+/// vec256_bfloat16.h for the vectorized conversions used by the CPU kernels.
+
+#include <c10/macros/Macros.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <limits>
+
+namespace c10 {
+
+namespace detail {
+
+inline C10_HOST_DEVICE float f32_from_bits(uint16_t src) {
+  float res = 0;
+  uint32_t tmp = src;
+  tmp <<= 16;
+  std::memcpy(&res, &tmp, sizeof(tmp));
+  return res;
+}
+
+inline C10_HOST_DEVICE uint16_t bits_from_f32(float src) {
+  uint32_t res = 0;
+  std::memcpy(&res, &src, sizeof(res));
+  return res >> 16;
+}
+
+// Rounds to the nearest BFloat16, ties to even, as the hardware conversions
+// do. NaNs stay (quiet) NaNs instead of being rounded to infinity.
+inline C10_HOST_DEVICE uint16_t round_to_nearest_even(float src) {
+  if (src != src) {
+    return UINT16_C(0x7FC0);
+  }
+  uint32_t bits = 0;
+  std::memcpy(&bits, &src, sizeof(bits));
+  const uint32_t rounding_bias = ((bits >> 16) & 1) + UINT32_C(0x7FFF);
+  return static_cast<uint16_t>((bits + rounding_bias) >> 16);
+}
+
+} // namespace detail
+
+struct alignas(2) BFloat16 {
+  uint16_t x;
+
+  struct from_bits_t {};
+  static constexpr from_bits_t from_bits() {
+    return from_bits_t();
+  }
+
+  // HIP wants __host__ __device__ tag, CUDA does not
+#ifdef __HIP_PLATFORM_HCC__
+  C10_HOST_DEVICE BFloat16() = default;
+#else
+  BFloat16() = default;
+#endif
+
+  constexpr C10_HOST_DEVICE BFloat16(uint16_t bits, from_bits_t) : x(bits){};
+  inline C10_HOST_DEVICE BFloat16(float value);
+  inline C10_HOST_DEVICE operator float() const;
+};
+
+C10_API std::ostream& operator<<(std::ostream& out, const BFloat16& value);
+
+} // namespace c10
+
+#include <c10/util/BFloat16-inl.h>
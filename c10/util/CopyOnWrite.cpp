@@ -0,0 +1 @@
+#include <c10/util/CopyOnWrite.h>
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// CopyOnWrite wait-free readers synchronization primitive for data that is
+// written rarely and read very often, like the kernel tables of the dispatcher.
+//
+// A write copies the current version, modifies the copy and publishes it
+// by swapping a single pointer. Reads only load that pointer, so unlike in
+// LeftRight, readers don't write to any shared memory and concurrent readers
+// on many cores never contend for a cache line.
+//
+// Since readers aren't tracked, it isn't known when a replaced version is
+// no longer read. Replaced versions are therefore kept alive until the
+// CopyOnWrite is destroyed, which makes every write cost a copy of T for the
+// lifetime of the object. Don't use this for data that is written often.
+template <class T>
+class CopyOnWrite final {
+public:
+    template<class... Args>
+    explicit CopyOnWrite(const Args& ...args)
+    : _writeMutex()
+    , _versions()
+    , _current(nullptr)
+    {
+        _versions.emplace_back(new T{args...});
+        _current.store(_versions.back().get(), std::memory_order_release);
+    }
+
+    // Copying and moving would not be threadsafe.
+    CopyOnWrite(const CopyOnWrite&) = delete;
+    CopyOnWrite(CopyOnWrite&&) noexcept = delete;
+    CopyOnWrite& operator=(const CopyOnWrite&) = delete;
+    CopyOnWrite& operator=(CopyOnWrite&&) noexcept = delete;
+
+    // References into the data handed to readFunc stay valid until the
+    // CopyOnWrite is destroyed, but they don't see later writes.
+    template <typename F>
+    auto read(F&& readFunc) const -> typename std::result_of<F(const T&)>::type {
+        return readFunc(*_current.load(std::memory_order_acquire));
+    }
+
+    // Throwing an exception in writeFunc is ok and leaves the old state.
+    // Concurrent readers see either the old or the new state, never a
+    // partially written one.
+    template <typename F>
+    auto write(F&& writeFunc) -> typename std::result_of<F(T&)>::type {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        std::unique_ptr<T> next(new T(*_current.load(std::memory_order_relaxed)));
+        return _write(writeFunc, std::move(next),
+            std::is_void<typename std::result_of<F(T&)>::type>());
+    }
+
+private:
+    template <class F>
+    void _write(const F& writeFunc, std::unique_ptr<T> next, std::true_type /* returns void */) {
+        writeFunc(*next);
+        _publish(std::move(next));
+    }
+
+    template <class F>
+    auto _write(const F& writeFunc, std::unique_ptr<T> next, std::false_type /* returns void */)
+        -> typename std::result_of<F(T&)>::type {
+        auto result = writeFunc(*next);
+        _publish(std::move(next));
+        return result;
+    }
+
+    void _publish(std::unique_ptr<T> next) {
+        // precondition: _writeMutex is locked
+        _versions.push_back(std::move(next));
+        _current.store(_versions.back().get(), std::memory_order_release);
+    }
+
+    std::mutex _writeMutex;
+    std::vector<std::unique_ptr<T>> _versions;
+    std::atomic<const T*> _current;
+};
+
+}
@@ -1,5 +1,8 @@
 #include "c10/util/numa.h"
 
+#include <algorithm>
+#include <vector>
+
 C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 
 #if defined(__linux__) && !defined(C10_DISABLE_NUMA) && !defined(C10_MOBILE)
@@ -14,6 +17,44 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 
 namespace c10 {
 
+namespace {
+thread_local NUMAPolicy thread_numa_policy = NUMAPolicy::NONE;
+} // namespace
+
+NUMAPolicy ParseNUMAPolicy(const std::string& name) {
+  if (name == "none") {
+    return NUMAPolicy::NONE;
+  } else if (name == "pin") {
+    return NUMAPolicy::PIN;
+  } else if (name == "interleave") {
+    return NUMAPolicy::INTERLEAVE;
+  } else if (name == "follow") {
+    return NUMAPolicy::FOLLOW;
+  }
+  AT_ERROR(
+      "Unknown NUMA policy '",
+      name,
+      "', expected one of 'none', 'pin', 'interleave' or 'follow'");
+}
+
+const char* NUMAPolicyName(NUMAPolicy policy) {
+  switch (policy) {
+    case NUMAPolicy::NONE:
+      return "none";
+    case NUMAPolicy::PIN:
+      return "pin";
+    case NUMAPolicy::INTERLEAVE:
+      return "interleave";
+    case NUMAPolicy::FOLLOW:
+      return "follow";
+  }
+  return "unknown";
+}
+
+NUMAPolicy GetThreadNUMAPolicy() {
+  return thread_numa_policy;
+}
+
 #ifdef C10_ENABLE_NUMA
 bool IsNUMAEnabled() {
   return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
@@ -103,6 +144,68 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+int GetCurrentCPUNUMANode() {
+  if (numa_available() < 0) {
+    return -1;
+  }
+  return numa_node_of_cpu(sched_getcpu());
+}
+
+namespace {
+
+// Runs the calling thread on the CPUs of `numa_node_id` and prefers
+// allocating its pages there. Both are hints, so failures are ignored.
+void PinToNUMANode(int numa_node_id) {
+  numa_run_on_node(numa_node_id);
+  numa_set_preferred(numa_node_id);
+}
+
+} // namespace
+
+void ApplyNUMAPolicy(
+    NUMAPolicy policy,
+    size_t worker_index,
+    size_t num_workers,
+    int home_node) {
+  if (numa_available() < 0) {
+    return;
+  }
+  switch (policy) {
+    case NUMAPolicy::NONE:
+      break;
+    case NUMAPolicy::PIN: {
+      // node ids need not be contiguous
+      std::vector<int> nodes;
+      for (int node = 0; node <= numa_max_node(); ++node) {
+        if (numa_bitmask_isbitset(numa_all_nodes_ptr, node)) {
+          nodes.push_back(node);
+        }
+      }
+      if (nodes.empty()) {
+        return;
+      }
+      // consecutive workers share a node, as they tend to work on
+      // neighbouring data
+      size_t index = worker_index * nodes.size() / std::max<size_t>(1, num_workers);
+      PinToNUMANode(nodes[std::min(index, nodes.size() - 1)]);
+      break;
+    }
+    case NUMAPolicy::INTERLEAVE:
+      numa_run_on_node(-1);
+      numa_set_interleave_mask(numa_all_nodes_ptr);
+      break;
+    case NUMAPolicy::FOLLOW: {
+      int node = home_node >= 0 ? home_node : GetCurrentCPUNUMANode();
+      if (node < 0) {
+        return;
+      }
+      PinToNUMANode(node);
+      break;
+    }
+  }
+  thread_numa_policy = policy;
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +230,17 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+int GetCurrentCPUNUMANode() {
+  return -1;
+}
+
+void ApplyNUMAPolicy(
+    NUMAPolicy policy,
+    size_t worker_index,
+    size_t num_workers,
+    int home_node) {
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
@@ -3,6 +3,8 @@
 #include <c10/util/Logging.h>
 #include <c10/util/Optional.h>
 
+#include <string>
+
 C10_DECLARE_bool(caffe2_cpu_numa_enabled);
 
 namespace c10 {
@@ -37,4 +39,52 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * How the workers of a thread pool are placed on NUMA nodes, see
+ * Note [NUMA policies of thread pools] in c10/core/thread_pool.h
+ */
+enum class NUMAPolicy {
+  // leave the placement of threads and of their memory to the OS
+  NONE,
+  // pin the workers to the CPUs of one node each, spreading them evenly over
+  // the nodes, and prefer allocating their memory on that node
+  PIN,
+  // interleave the pages allocated by the workers over all nodes
+  INTERLEAVE,
+  // pin the workers to the node of the thread that hands them work, so that
+  // they run close to the data it allocated
+  FOLLOW,
+};
+
+/**
+ * Parse a policy name ("none", "pin", "interleave" or "follow")
+ */
+C10_API NUMAPolicy ParseNUMAPolicy(const std::string& name);
+
+C10_API const char* NUMAPolicyName(NUMAPolicy policy);
+
+/**
+ * Apply `policy` to the calling thread, which is worker `worker_index` of
+ * `num_workers`. `home_node` is the node FOLLOW pins the thread to; if it is
+ * negative, the thread stays on the node it currently runs on. Unlike the
+ * functions above this does not require caffe2_cpu_numa_enabled, as the
+ * policy is an explicit request; it is a no-op without libnuma.
+ */
+C10_API void ApplyNUMAPolicy(
+    NUMAPolicy policy,
+    size_t worker_index,
+    size_t num_workers,
+    int home_node = -1);
+
+/**
+ * The policy last applied to the calling thread
+ */
+C10_API NUMAPolicy GetThreadNUMAPolicy();
+
+/**
+ * The node the calling thread runs on, or -1 without libnuma. Unlike
+ * GetCurrentNUMANode this does not require caffe2_cpu_numa_enabled.
+ */
+C10_API int GetCurrentCPUNUMANode();
+
 } // namespace c10
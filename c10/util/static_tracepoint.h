@@ -0,0 +1,26 @@
+#pragma once
+
+// Userland statically defined tracepoints (USDT/SDT probes).
+//
+// A probe compiles to a single nop plus an entry in the .note.stapsdt ELF
+// section, so it costs nothing until a tracer such as bpftrace, perf or
+// SystemTap attaches to it, e.g.
+//
+//   bpftrace -l 'usdt:/path/to/libc10.so:pytorch:*'
+//
+// The arguments are still evaluated at the probe site, so keep them cheap
+// (integers and pointers). Up to 8 arguments are supported.
+//
+// C10_SDT(name, ...) emits a probe of the "pytorch" provider.
+
+#if defined(__ELF__) && (defined(__x86_64__) || defined(__i386__))
+#include <c10/util/static_tracepoint_elfx86.h>
+
+#define C10_SDT_WITH_PROVIDER(provider, name, ...)                   \
+  C10_SDT_PROBE_N(                                                   \
+    provider, name, C10_SDT_NARG(0, ##__VA_ARGS__), ##__VA_ARGS__)
+#else
+#define C10_SDT_WITH_PROVIDER(provider, name, ...) do {} while(0)
+#endif
+
+#define C10_SDT(name, ...) C10_SDT_WITH_PROVIDER(pytorch, name, ##__VA_ARGS__)
@@ -85,6 +85,7 @@ CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(28, at::Half*)
 CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(29, c10::qint8)
 CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(30, c10::quint8)
 CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(31, c10::qint32)
-CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(32, _CaffeHighestPreallocatedTypeId)
+CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(32, at::BFloat16)
+CAFFE_DEFINE_PREALLOCATED_KNOWN_TYPE(33, _CaffeHighestPreallocatedTypeId)
 
 } // namespace caffe2
@@ -21,6 +21,7 @@
 #include <c10/util/Backtrace.h>
 #include <c10/util/C++17.h>
 #include <c10/util/Exception.h>
+#include <c10/util/BFloat16.h>
 #include <c10/util/Half.h>
 #include <c10/util/IdWrapper.h>
 #include <c10/util/qint8.h>
@@ -44,10 +45,12 @@
 // called.  This requires us to fix all of the call-sites, which I want to do
 // later.  So the namespace is not fixed at the moment.
 
-// Make at::Half a fundamental type.
+// Make at::Half and at::BFloat16 fundamental types.
 namespace std {
 template <>
 struct is_fundamental<at::Half> : std::true_type {};
+template <>
+struct is_fundamental<at::BFloat16> : std::true_type {};
 } // namespace std
 
 namespace caffe2 {
@@ -629,6 +632,7 @@ CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(28, at::Half*)
 CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(29, c10::qint8)
 CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(30, c10::quint8)
 CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(31, c10::qint32)
-CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(32, _CaffeHighestPreallocatedTypeId)
+CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(32, at::BFloat16)
+CAFFE_DECLARE_PREALLOCATED_KNOWN_TYPE(33, _CaffeHighestPreallocatedTypeId)
 
 } // namespace caffe2
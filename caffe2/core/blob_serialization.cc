@@ -16,6 +16,12 @@ C10_DEFINE_int(
     16,
     "Maximal number of threads that can be used for tensor serialization");
 
+C10_DEFINE_int(
+    caffe2_max_tensor_deserializer_threads,
+    16,
+    "Maximal number of threads that can be used by the Load operator to "
+    "deserialize tensors on CPU");
+
 C10_DEFINE_bool(
     caffe2_serialize_fp16_as_bytes,
     false,
@@ -454,8 +460,25 @@ Tensor EmptyTensorFromProto(const TensorProto& tensor_proto) {
   }
 }
 
+Tensor* BlobGetMutableTensorFromProto(
+    Blob* blob,
+    const TensorProto& tensor_proto) {
+  return BlobGetMutableTensor(
+      blob,
+      DimsFromTensorProto(tensor_proto),
+      TensorOptionsFromProto(tensor_proto));
+}
+
+bool CanDeserializeTensorConcurrently(const BlobProto& blob_proto) {
+  return blob_proto.type() == kTensorBlobType && blob_proto.has_tensor() &&
+      !blob_proto.has_content_num_chunks() &&
+      blob_proto.tensor().data_type() != TensorProto_DataType_UNDEFINED &&
+      blob_proto.tensor().device_detail().device_type() == PROTO_CPU;
+}
+
 void TensorDeserializer::Deserialize(const BlobProto& blob_proto, Blob* blob) {
-  auto tensor_proto = blob_proto.tensor();
+  // a reference, since copying the proto would copy all of its data
+  const auto& tensor_proto = blob_proto.tensor();
   auto context = ContextFromProto(tensor_proto);
   context->SwitchToDevice();
   if (NumelFromTensorProto(tensor_proto) == 0 &&
@@ -469,11 +492,7 @@ void TensorDeserializer::Deserialize(const BlobProto& blob_proto, Blob* blob) {
             OptionToDevice(tensor_proto.device_detail())));
   } else {
     DeserializeToTensor(
-        tensor_proto,
-        BlobGetMutableTensor(
-            blob,
-            DimsFromTensorProto(tensor_proto),
-            TensorOptionsFromProto(tensor_proto)));
+        tensor_proto, BlobGetMutableTensorFromProto(blob, tensor_proto));
   }
 }
 
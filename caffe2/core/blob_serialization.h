@@ -15,6 +15,7 @@
 
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_int(caffe2_max_tensor_serializer_threads);
+C10_DECLARE_int(caffe2_max_tensor_deserializer_threads);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
 
 namespace caffe2 {
@@ -77,6 +78,27 @@ CAFFE2_API void DeserializeBlob(const BlobProto& proto, Blob* result);
  */
 CAFFE2_API Tensor EmptyTensorFromProto(const TensorProto& proto);
 
+/**
+ * Returns the Tensor of the blob with the size, data type and device of the
+ * proto, allocating it unless the blob already holds such a Tensor.
+ *
+ * Together with TensorDeserializer::DeserializeToTensor, this splits the
+ * deserialization of a tensor into allocating the destination, which has to
+ * be serialized with other calls on the same blob, and copying the data (of
+ * one segment), which doesn't. See CanDeserializeTensorConcurrently.
+ */
+CAFFE2_API Tensor* BlobGetMutableTensorFromProto(
+    Blob* blob,
+    const TensorProto& proto);
+
+/**
+ * Whether the tensor of the proto can be deserialized in the two steps of
+ * BlobGetMutableTensorFromProto, so that the segments of a chunked tensor can
+ * be copied into the blob concurrently. That is the case for tensors of a
+ * fundamental (or string) data type on CPU.
+ */
+CAFFE2_API bool CanDeserializeTensorConcurrently(const BlobProto& proto);
+
 /**
  * @brief TensorSerializer is the serializer for Tensors.
  *
@@ -0,0 +1,315 @@
+#include "caffe2/core/engine_autotune.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include "caffe2/core/logging.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/utils/proto_utils.h"
+
+C10_DEFINE_bool(
+    caffe2_engine_autotune,
+    false,
+    "If set, the engines of the ops are taken from the autotuning cache when "
+    "nets are created, and predictors time the registered engines of the ops "
+    "that aren't in the cache on their first run.");
+C10_DEFINE_string(
+    caffe2_engine_autotune_cache,
+    "",
+    "The file the engines chosen by autotuning are loaded from and saved to. "
+    "If empty, they are only kept in memory.");
+C10_DEFINE_int(
+    caffe2_engine_autotune_runs,
+    5,
+    "The number of timed runs of every engine of an op when autotuning.");
+
+namespace caffe2 {
+
+namespace {
+
+DeviceType GetDeviceType(const OperatorDef& def) {
+  return ProtoToType(
+      static_cast<DeviceTypeProto>(def.device_option().device_type()));
+}
+
+// FNV-1a, which is stable across processes, unlike std::hash.
+uint64_t HashArguments(const OperatorDef& def) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const auto& arg : def.arg()) {
+    for (const char c : ProtoDebugString(arg)) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+bool WritesInput(const OperatorDef& def) {
+  for (const auto& output : def.output()) {
+    for (const auto& input : def.input()) {
+      if (output == input) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Returns the fastest of the timed runs in microseconds, after a warm-up run,
+// or a negative time if the op fails to run.
+float TimeOperator(OperatorBase* op, int runs) {
+  float best = std::numeric_limits<float>::max();
+  try {
+    if (!op->Run()) {
+      return -1;
+    }
+    for (int i = 0; i < runs; ++i) {
+      Timer timer;
+      if (!op->Run()) {
+        return -1;
+      }
+      best = std::min(best, timer.MicroSeconds());
+    }
+  } catch (const std::exception& e) {
+    VLOG(1) << "Operator failed while autotuning: " << e.what();
+    return -1;
+  }
+  return best;
+}
+
+// Returns the fastest of the engines, or an empty string if none of them
+// runs.
+std::string FastestEngine(
+    const OperatorDef& def,
+    const std::vector<std::string>& engines,
+    Workspace* ws) {
+  OperatorRegistry* registry = gDeviceTypeRegistry()->at(GetDeviceType(def));
+  std::string fastest;
+  float fastest_time = std::numeric_limits<float>::max();
+  for (const auto& engine : engines) {
+    OperatorDef engine_def(def);
+    engine_def.set_engine(engine);
+    unique_ptr<OperatorBase> op;
+    try {
+      op = registry->Create(OpRegistryKey(def.type(), engine), engine_def, ws);
+    } catch (const std::exception& e) {
+      VLOG(1) << "Engine " << engine << " of " << def.type()
+              << " is not supported: " << e.what();
+      continue;
+    }
+    if (!op) {
+      continue;
+    }
+    const float time =
+        TimeOperator(op.get(), std::max(1, FLAGS_caffe2_engine_autotune_runs));
+    VLOG(1) << "Engine " << engine << " of " << def.type() << " took " << time
+            << " us";
+    if (time >= 0 && time < fastest_time) {
+      fastest = engine;
+      fastest_time = time;
+    }
+  }
+  return fastest;
+}
+
+} // namespace
+
+EngineAutotuneCache& EngineAutotuneCache::Global() {
+  static EngineAutotuneCache* cache = [] {
+    auto* cache = new EngineAutotuneCache();
+    if (!FLAGS_caffe2_engine_autotune_cache.empty()) {
+      cache->Load(FLAGS_caffe2_engine_autotune_cache);
+    }
+    return cache;
+  }();
+  return *cache;
+}
+
+bool EngineAutotuneCache::Lookup(const std::string& key, std::string* engine)
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = engines_.find(key);
+  if (it == engines_.end()) {
+    return false;
+  }
+  *engine = it->second;
+  return true;
+}
+
+void EngineAutotuneCache::Insert(
+    const std::string& key,
+    const std::string& engine) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  engines_[key] = engine;
+}
+
+void EngineAutotuneCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  engines_.clear();
+}
+
+void EngineAutotuneCache::Load(const std::string& path) {
+  std::ifstream file(path);
+  if (!file) {
+    VLOG(1) << "No engine autotuning cache at " << path;
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto pos = line.rfind('\t');
+    if (pos == std::string::npos || pos == 0 || pos + 1 == line.size()) {
+      LOG(WARNING) << "Skipping a malformed line of " << path << ": " << line;
+      continue;
+    }
+    engines_[line.substr(0, pos)] = line.substr(pos + 1);
+  }
+  VLOG(1) << "Loaded " << engines_.size() << " autotuned engines from "
+          << path;
+}
+
+void EngineAutotuneCache::Save(const std::string& path) const {
+  // Written to a temporary file first, so that other processes never read a
+  // partial cache.
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    CAFFE_ENFORCE(file, "Cannot write the engine autotuning cache ", tmp_path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : engines_) {
+      file << entry.first << '\t' << entry.second << '\n';
+    }
+  }
+  CAFFE_ENFORCE_EQ(
+      std::rename(tmp_path.c_str(), path.c_str()),
+      0,
+      "Cannot write the engine autotuning cache ",
+      path);
+}
+
+std::string EngineAutotuneKey(
+    const OperatorDef& def,
+    const std::vector<TensorShape>& input_shapes) {
+  std::stringstream ss;
+  ss << def.type() << ';' << DeviceTypeName(GetDeviceType(def)) << ';'
+     << std::hex << HashArguments(def) << std::dec;
+  for (const auto& shape : input_shapes) {
+    if (shape.unknown_shape()) {
+      return "";
+    }
+    ss << ';' << shape.data_type() << ':';
+    for (int i = 0; i < shape.dims_size(); ++i) {
+      ss << (i ? "," : "") << shape.dims(i);
+    }
+  }
+  return ss.str();
+}
+
+std::vector<std::string> GetRegisteredEngines(const OperatorDef& def) {
+  std::vector<std::string> engines;
+  const auto device_type = GetDeviceType(def);
+  if (!gDeviceTypeRegistry()->count(device_type)) {
+    return engines;
+  }
+  const std::string prefix = def.type() + "_ENGINE_";
+  for (const auto& key : gDeviceTypeRegistry()->at(device_type)->Keys()) {
+    if (key == def.type()) {
+      engines.push_back("DEFAULT");
+    } else if (key.compare(0, prefix.size(), prefix) == 0) {
+      engines.push_back(key.substr(prefix.size()));
+    }
+  }
+  return engines;
+}
+
+bool AutotuneEngines(NetDef* net_def, Workspace* ws) {
+  auto& cache = EngineAutotuneCache::Global();
+  bool changed = false;
+  bool added = false;
+  for (auto& def : *net_def->mutable_op()) {
+    std::string key;
+    std::vector<TensorShape> input_shapes;
+    for (const auto& input : def.input()) {
+      const Blob* blob = ws->GetBlob(input);
+      if (!blob) {
+        break;
+      }
+      input_shapes.push_back(GetTensorShapeOfBlob(blob));
+    }
+    if (input_shapes.size() == static_cast<size_t>(def.input_size())) {
+      key = EngineAutotuneKey(def, input_shapes);
+    }
+
+    const auto engines = GetRegisteredEngines(def);
+    std::string engine;
+    if (!key.empty() && engines.size() > 1 && !WritesInput(def) &&
+        !cache.Lookup(key, &engine)) {
+      engine = FastestEngine(def, engines, ws);
+      if (!engine.empty()) {
+        VLOG(1) << "Autotuned engine " << engine << " for " << key;
+        cache.Insert(key, engine);
+        added = true;
+      }
+    }
+    if (!engine.empty() && engine != def.engine()) {
+      def.set_engine(engine);
+      changed = true;
+    }
+
+    // Runs the op with its engine, so that the next ops see its outputs.
+    auto op = CreateOperator(def, ws);
+    CAFFE_ENFORCE(
+        op->Run(),
+        "Failed to run ",
+        def.type(),
+        " while autotuning the engines of net ",
+        net_def->name());
+  }
+  if (added && !FLAGS_caffe2_engine_autotune_cache.empty()) {
+    cache.Save(FLAGS_caffe2_engine_autotune_cache);
+  }
+  return changed;
+}
+
+bool ApplyAutotunedEngines(NetDef* net_def, Workspace* ws) {
+  TensorShapes shapes;
+  try {
+    shapes = InferBlobShapesAndTypesFromWorkspace(ws, {net_def});
+  } catch (const std::exception& e) {
+    VLOG(1) << "Cannot infer the shapes of net " << net_def->name()
+            << " to apply the autotuned engines: " << e.what();
+    return false;
+  }
+  std::unordered_map<std::string, const TensorShape*> blob_shapes;
+  for (const auto& shape : shapes.shapes()) {
+    blob_shapes[shape.name()] = &shape;
+  }
+
+  const auto& cache = EngineAutotuneCache::Global();
+  bool changed = false;
+  for (auto& def : *net_def->mutable_op()) {
+    std::vector<TensorShape> input_shapes;
+    for (const auto& input : def.input()) {
+      const auto it = blob_shapes.find(input);
+      if (it == blob_shapes.end()) {
+        break;
+      }
+      input_shapes.push_back(*it->second);
+    }
+    if (input_shapes.size() != static_cast<size_t>(def.input_size())) {
+      continue;
+    }
+    const auto key = EngineAutotuneKey(def, input_shapes);
+    std::string engine;
+    if (!key.empty() && cache.Lookup(key, &engine) && engine != def.engine()) {
+      def.set_engine(engine);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+} // namespace caffe2
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/flags.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+C10_DECLARE_bool(caffe2_engine_autotune);
+C10_DECLARE_string(caffe2_engine_autotune_cache);
+C10_DECLARE_int(caffe2_engine_autotune_runs);
+
+namespace caffe2 {
+
+// The engines chosen by autotuning, keyed by EngineAutotuneKey. The global
+// cache is loaded from the file set by caffe2_engine_autotune_cache on first
+// use, and saved back to it after every autotuning pass that added entries.
+// The file has one "<key>\t<engine>" entry per line.
+class CAFFE2_API EngineAutotuneCache {
+ public:
+  static EngineAutotuneCache& Global();
+
+  bool Lookup(const std::string& key, std::string* engine) const;
+  void Insert(const std::string& key, const std::string& engine);
+  void Clear();
+
+  // Adds the entries of the file, if it exists.
+  void Load(const std::string& path);
+  void Save(const std::string& path) const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::string> engines_;
+};
+
+// Returns the key of the op in the autotuning cache, made of the op type, the
+// device type, a hash of the arguments, and the types and shapes of the
+// inputs. Returns an empty string if the shape of an input is unknown.
+CAFFE2_API std::string EngineAutotuneKey(
+    const OperatorDef& def,
+    const std::vector<TensorShape>& input_shapes);
+
+// Returns the engines registered for the type and the device of the op, with
+// "DEFAULT" for the implementation without an engine.
+CAFFE2_API std::vector<std::string> GetRegisteredEngines(
+    const OperatorDef& def);
+
+// Runs the ops of the net once, in order, on the blobs of the workspace, so
+// the external inputs have to be fed, like for the first run of the net.
+// Every op with more than one registered engine is timed with each of them
+// caffe2_engine_autotune_runs times on its actual inputs, unless its key is
+// in the cache already, and the fastest engine is set in `net_def` and added
+// to the cache. Ops that write to one of their inputs are only run once,
+// with the engine they would be created with anyway.
+//
+// Returns true if the engine of any op was changed.
+CAFFE2_API bool AutotuneEngines(NetDef* net_def, Workspace* ws);
+
+// Sets the engines of the ops whose key is in the cache, using the shapes
+// that can be inferred from the blobs of the workspace. CreateNet calls it
+// when caffe2_engine_autotune is set.
+//
+// Returns true if the engine of any op was changed.
+CAFFE2_API bool ApplyAutotunedEngines(NetDef* net_def, Workspace* ws);
+
+} // namespace caffe2
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "caffe2/core/engine_autotune.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+template <int kSleepMs>
+class AutotuneTestOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  using Operator<CPUContext>::Operator;
+  bool RunOnDevice() override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSleepMs));
+    Output(0)->CopyFrom(Input(0));
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(AutotuneTest, AutotuneTestOp<5>);
+REGISTER_CPU_OPERATOR_WITH_ENGINE(AutotuneTest, FAST, AutotuneTestOp<0>);
+REGISTER_CPU_OPERATOR_WITH_ENGINE(AutotuneTest, SLOW, AutotuneTestOp<10>);
+OPERATOR_SCHEMA(AutotuneTest).NumInputs(1).NumOutputs(1);
+
+NetDef CreateNetDef() {
+  NetDef net_def;
+  net_def.set_name("autotune_test");
+  auto& op = *net_def.add_op();
+  op.set_type("AutotuneTest");
+  op.set_engine("SLOW");
+  op.add_input("in");
+  op.add_output("out");
+  net_def.add_external_input("in");
+  net_def.add_external_output("out");
+  return net_def;
+}
+
+void FeedInput(Workspace* ws, int size) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob("in"), CPU);
+  tensor->Resize(size);
+  tensor->mutable_data<float>();
+}
+
+} // namespace
+
+TEST(EngineAutotuneTest, RegisteredEngines) {
+  OperatorDef def;
+  def.set_type("AutotuneTest");
+  auto engines = GetRegisteredEngines(def);
+  std::sort(engines.begin(), engines.end());
+  EXPECT_EQ(engines, (std::vector<std::string>{"DEFAULT", "FAST", "SLOW"}));
+}
+
+TEST(EngineAutotuneTest, PicksFastestEngineAndAppliesIt) {
+  EngineAutotuneCache::Global().Clear();
+  Workspace ws;
+  FeedInput(&ws, 3);
+  NetDef net_def = CreateNetDef();
+  EXPECT_TRUE(AutotuneEngines(&net_def, &ws));
+  EXPECT_EQ(net_def.op(0).engine(), "FAST");
+  EXPECT_EQ(
+      BlobGetTensor(*ws.GetBlob("out"), CPU).sizes(), std::vector<int64_t>{3});
+
+  // The choice is cached for the shape, and applied when nets are created.
+  FLAGS_caffe2_engine_autotune = true;
+  auto net = CreateNet(CreateNetDef(), &ws);
+  FLAGS_caffe2_engine_autotune = false;
+  ASSERT_EQ(net->GetOperators().size(), 1);
+  EXPECT_EQ(net->GetOperators()[0]->engine(), "FAST");
+
+  // Other shapes are autotuned separately.
+  FeedInput(&ws, 4);
+  FLAGS_caffe2_engine_autotune = true;
+  net = CreateNet(CreateNetDef(), &ws);
+  FLAGS_caffe2_engine_autotune = false;
+  EXPECT_EQ(net->GetOperators()[0]->engine(), "SLOW");
+  EngineAutotuneCache::Global().Clear();
+}
+
+TEST(EngineAutotuneTest, CacheRoundTrip) {
+  const std::string path = "engine_autotune_test_cache";
+  EngineAutotuneCache cache;
+  cache.Insert("AutotuneTest;CPU;0;1:3", "FAST");
+  cache.Insert("AutotuneTest;CPU;0;1:4", "DEFAULT");
+  cache.Save(path);
+
+  EngineAutotuneCache loaded;
+  loaded.Load(path);
+  std::string engine;
+  EXPECT_TRUE(loaded.Lookup("AutotuneTest;CPU;0;1:3", &engine));
+  EXPECT_EQ(engine, "FAST");
+  EXPECT_TRUE(loaded.Lookup("AutotuneTest;CPU;0;1:4", &engine));
+  EXPECT_EQ(engine, "DEFAULT");
+  EXPECT_FALSE(loaded.Lookup("AutotuneTest;CPU;0;1:5", &engine));
+  std::remove(path.c_str());
+}
+
+} // namespace caffe2
@@ -1,5 +1,6 @@
 #include "caffe2/core/memonger.h"
 
+#include <algorithm>
 #include <set>
 #include <unordered_set>
 
@@ -8,9 +9,240 @@
 namespace caffe2 {
 namespace memonger {
 
+namespace {
+
+// Net types whose executors only order the operators by the dependencies of
+// dag_utils::prepareOperatorNodes.
+bool isDagNetType(const string& type) {
+  static const std::set<string> kDagNetTypes{"dag",
+                                             "prof_dag",
+                                             "async_dag",
+                                             "async_polling",
+                                             "async_scheduling",
+                                             "async_simple"};
+  return kDagNetTypes.count(type) > 0;
+}
+
+bool hasSubnets(const OperatorDef& op) {
+  for (const auto& arg : op.arg()) {
+    if (arg.has_n() || arg.nets_size() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+NetDef optimize_inference_dag_net(
+    const NetDef& net,
+    const std::set<string>& static_blobs) {
+  const int num_ops = net.op_size();
+  for (const auto& op : net.op()) {
+    if (hasSubnets(op)) {
+      LOG(INFO) << "Memonger does not support ops with subnets yet: "
+                << op.type();
+      return net;
+    }
+  }
+
+  // Step 1: compute the dependencies of the operators, as the executors do
+  // (read after write, write after write and write after read), and the
+  // transitive closure of the parents, as one bitset of ancestors per op.
+  // Since an op only depends on earlier ops, the closure is a single pass.
+  const int num_words = (num_ops + 63) / 64;
+  std::vector<std::vector<uint64_t>> ancestors(
+      num_ops, std::vector<uint64_t>(num_words, 0));
+  auto is_ancestor = [&ancestors](int op, int ancestor) {
+    return (ancestors[op][ancestor / 64] >> (ancestor % 64)) & 1;
+  };
+
+  struct BlobInfo {
+    int first_writer;
+    // All ops that read or write the blob.
+    std::vector<int> users;
+    bool shareable;
+  };
+  std::unordered_map<string, BlobInfo> blob_infos;
+  // The blobs written by the net, in the order of their first writer.
+  std::vector<string> written_blobs;
+  std::unordered_map<string, int> blob_writer;
+  std::unordered_map<string, std::vector<int>> blob_readers;
+
+  std::set<string> pinned_blobs(static_blobs);
+  pinned_blobs.insert(net.external_input().begin(), net.external_input().end());
+  pinned_blobs.insert(
+      net.external_output().begin(), net.external_output().end());
+
+  for (int i = 0; i < num_ops; ++i) {
+    const auto& op = net.op(i);
+    std::set<int> parents;
+    auto read = [&](const string& blob) {
+      auto wit = blob_writer.find(blob);
+      if (wit != blob_writer.end()) {
+        parents.insert(wit->second);
+      }
+      blob_readers[blob].push_back(i);
+      auto bit = blob_infos.find(blob);
+      if (bit == blob_infos.end()) {
+        // Read before being written: the blob exists before the net runs.
+        blob_infos[blob] = BlobInfo{-1, {i}, false};
+      } else {
+        bit->second.users.push_back(i);
+      }
+    };
+    for (const auto& input : op.input()) {
+      read(input);
+    }
+    for (const auto& input : op.control_input()) {
+      read(input);
+    }
+    for (const auto& output : op.output()) {
+      auto wit = blob_writer.find(output);
+      if (wit != blob_writer.end()) {
+        parents.insert(wit->second);
+      }
+      for (const int reader : blob_readers[output]) {
+        parents.insert(reader);
+      }
+      blob_readers[output].clear();
+      blob_writer[output] = i;
+      auto bit = blob_infos.find(output);
+      if (bit == blob_infos.end()) {
+        blob_infos[output] =
+            BlobInfo{i, {i}, pinned_blobs.count(output) == 0};
+        written_blobs.push_back(output);
+      } else {
+        bit->second.users.push_back(i);
+      }
+    }
+    parents.erase(i);
+    for (const int parent : parents) {
+      for (int w = 0; w < num_words; ++w) {
+        ancestors[i][w] |= ancestors[parent][w];
+      }
+      ancestors[i][parent / 64] |= uint64_t(1) << (parent % 64);
+    }
+  }
+
+  // The storage of a blob lives on the device of its writers.
+  auto device_of = [&net](const OperatorDef& op) {
+    DeviceOption device = op.has_device_option() ? op.device_option()
+                                                 : net.device_option();
+    // CopyGPUToCPU has a CUDA device option, but writes a CPU blob.
+    if (op.type() == "CopyGPUToCPU") {
+      device.set_device_type(PROTO_CPU);
+      device.set_device_id(0);
+    }
+    return device;
+  };
+
+  // Step 2: assign the blobs to shared slots. Two blobs may share a slot if
+  // every op using the first one is an ancestor of the op first writing the
+  // second one: all ops using the second blob depend on its first writer, so
+  // whatever order the executor picks, the uses of the two blobs never
+  // overlap. The renamed net then gets a write after read dependency that is
+  // implied already, so sharing doesn't remove any parallelism.
+  struct Slot {
+    DeviceOption device;
+    // The users of the last blob assigned to the slot.
+    std::vector<int> users;
+    std::vector<string> blobs;
+  };
+  std::vector<Slot> slots;
+  for (const auto& blob : written_blobs) {
+    auto& info = blob_infos[blob];
+    if (!info.shareable) {
+      continue;
+    }
+    const auto device = device_of(net.op(info.first_writer));
+    bool same_device_writers = true;
+    for (const int user : info.users) {
+      const auto& op = net.op(user);
+      if (std::find(op.output().begin(), op.output().end(), blob) !=
+              op.output().end() &&
+          !IsSameDevice(device_of(op), device)) {
+        same_device_writers = false;
+      }
+    }
+    if (!same_device_writers) {
+      continue;
+    }
+
+    Slot* slot = nullptr;
+    for (auto& candidate : slots) {
+      if (!IsSameDevice(candidate.device, device)) {
+        continue;
+      }
+      bool disjoint = true;
+      for (const int user : candidate.users) {
+        if (!is_ancestor(info.first_writer, user)) {
+          disjoint = false;
+          break;
+        }
+      }
+      if (disjoint) {
+        slot = &candidate;
+        break;
+      }
+    }
+    if (!slot) {
+      slots.push_back(Slot{device, {}, {}});
+      slot = &slots.back();
+    }
+    slot->users = info.users;
+    slot->blobs.push_back(blob);
+  }
+
+  // Step 3: rename the blobs of the slots shared by several blobs.
+  std::unordered_map<string, string> renaming;
+  for (const auto& slot : slots) {
+    if (slot.blobs.size() < 2) {
+      continue;
+    }
+    string shared_blob = "__m" + c10::to_string(renaming.size()) + "_shared";
+    // Safety check to prevent double-memongering nets.
+    if (blob_infos.count(shared_blob)) {
+      LOG(INFO) << "Net was already memongered!";
+      return net;
+    }
+    for (const auto& blob : slot.blobs) {
+      renaming[blob] = shared_blob;
+    }
+  }
+
+  NetDef optim_net = net;
+  for (auto& op : *optim_net.mutable_op()) {
+    for (int i = 0; i < op.input_size(); i++) {
+      auto it = renaming.find(op.input(i));
+      if (it != renaming.end()) {
+        op.set_input(i, it->second);
+      }
+    }
+    for (int i = 0; i < op.control_input_size(); i++) {
+      auto it = renaming.find(op.control_input(i));
+      if (it != renaming.end()) {
+        op.set_control_input(i, it->second);
+      }
+    }
+    for (int i = 0; i < op.output_size(); i++) {
+      auto it = renaming.find(op.output(i));
+      if (it != renaming.end()) {
+        op.set_output(i, it->second);
+      }
+    }
+  }
+
+  VLOG(1) << "optimized dag net by sharing " << renaming.size() << " blobs";
+  return optim_net;
+}
+
 NetDef optimize_inference_net(
     const NetDef& net,
     const std::set<string>& static_blobs) {
+  if (isDagNetType(net.type())) {
+    return optimize_inference_dag_net(net, static_blobs);
+  }
   if (net.type() != "" && net.type() != "simple") {
     LOG(INFO) << "Cannot optimize memory for nets of type: " << net.type();
     return net;
@@ -10,10 +10,22 @@
 namespace caffe2 {
 namespace memonger {
 
+// Shares the blobs of an inference net, except for static_blobs. Nets of the
+// dag and async types (e.g. async_scheduling) go through
+// optimize_inference_dag_net.
 CAFFE2_API NetDef optimize_inference_net(
     const NetDef& net,
     const std::set<string>& static_blobs);
 
+// Shares the blobs of an inference net whose ops may run in any order
+// consistent with their dependencies, except for static_blobs and the
+// external inputs and outputs of the net. Two blobs only share a name if all
+// uses of one happen before the first write of the other in every legal
+// schedule, i.e. the dependencies computed by the executor already order them.
+CAFFE2_API NetDef optimize_inference_dag_net(
+    const NetDef& net,
+    const std::set<string>& static_blobs);
+
 CAFFE2_API NetDef compute_blob_recycling_for_dag(
     const NetDef& net,
     const std::vector<string>& heads,
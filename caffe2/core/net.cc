@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "caffe2/core/engine_autotune.h"
 #include "caffe2/core/init.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
@@ -154,8 +155,15 @@ unique_ptr<NetBase> CreateNet(const NetDef& net_def, Workspace* ws) {
 }
 
 unique_ptr<NetBase> CreateNet(
-    const std::shared_ptr<const NetDef>& net_def,
+    const std::shared_ptr<const NetDef>& original_net_def,
     Workspace* ws) {
+  std::shared_ptr<const NetDef> net_def = original_net_def;
+  if (FLAGS_caffe2_engine_autotune) {
+    auto tuned_net_def = std::make_shared<NetDef>(*original_net_def);
+    if (ApplyAutotunedEngines(tuned_net_def.get(), ws)) {
+      net_def = tuned_net_def;
+    }
+  }
   std::string net_type;
   if (net_def->has_type() && !net_def->type().empty()) {
     net_type = net_def->type();
@@ -1,5 +1,7 @@
 #include "caffe2/core/net_async_base.h"
 
+#include <algorithm>
+
 #include "caffe2/core/net_async_tracing.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/timer.h"
@@ -51,6 +53,12 @@ C10_DEFINE_bool(
     false,
     "Run root tasks in current thread instread of scheduling to threadpool");
 
+C10_DEFINE_int(
+    caffe2_net_async_dedicated_pool_size,
+    0,
+    "Number of threads in each dedicated pool (executor_pool op argument), "
+    "uses the net's number of workers by default");
+
 namespace caffe2 {
 
 std::vector<int>& AsyncNetBase::getStreamCounters() {
@@ -81,6 +89,7 @@ AsyncNetBase::AsyncNetBase(
     chains_.push_back(kv.second);
   }
   chain_nodes_ = dag_utils::prepareChainGraphNodes(operator_nodes_, chains_);
+  initSchedulingPriorities();
 
   events_.reserve(chains_.size());
   for (const auto& chain : chains_) {
@@ -106,6 +115,81 @@ AsyncNetBase::AsyncNetBase(
   }
 }
 
+// Note [Async scheduling priorities]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Thread pools run their tasks in FIFO order, so a chain that becomes ready
+// is only ever delayed by the work that was queued before it. The executor
+// controls what it queues first: root chains, and the children a chain
+// readies when it finishes, are scheduled in decreasing order of priority.
+// A chain inherits the highest priority of its descendants, so the whole path
+// leading to a latency-critical chain is scheduled ahead of other work, not
+// just the chain itself.
+//
+// This doesn't help once a pool is busy with long-running low priority
+// chains, which is what dedicated pools are for: chains whose operators have
+// an `executor_pool` argument run in a pool of their own, per net and per
+// pool name, that no other chains are queued in.
+void AsyncNetBase::initSchedulingPriorities() {
+  chain_priorities_.assign(tasksNum(), 0);
+  chain_pools_.assign(tasksNum(), "");
+  for (int task_id = 0; task_id < tasksNum(); ++task_id) {
+    for (auto op_id : chains_[task_id]) {
+      chain_priorities_[task_id] = std::max(
+          chain_priorities_[task_id],
+          dag_utils::executorPriority(*operators_[op_id]));
+    }
+    const auto* first_op = firstTaskOp(task_id);
+    const auto pool_name = dag_utils::executorPool(*first_op);
+    if (!pool_name.empty()) {
+      auto device_type = options_.use_single_pool_
+          ? PROTO_CPU
+          : first_op->device_option().device_type();
+      chain_pools_[task_id] = pool_name + "/" + DeviceTypeName(device_type);
+      // created upfront, so that taskPool() doesn't modify the map
+      dedicated_pools_[chain_pools_[task_id]];
+    }
+  }
+
+  // chain ids are not in topological order, sort them first
+  std::vector<int> order;
+  order.reserve(tasksNum());
+  std::vector<int> pending_parents(tasksNum());
+  for (int task_id = 0; task_id < tasksNum(); ++task_id) {
+    pending_parents[task_id] = parents(task_id).size();
+    if (pending_parents[task_id] == 0) {
+      order.push_back(task_id);
+    }
+  }
+  for (size_t idx = 0; idx < order.size(); ++idx) {
+    for (auto child_id : children(order[idx])) {
+      if (--pending_parents[child_id] == 0) {
+        order.push_back(child_id);
+      }
+    }
+  }
+  CAFFE_ENFORCE_EQ(order.size(), (size_t)tasksNum(), "Cycle in chain graph");
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    for (auto child_id : children(*it)) {
+      chain_priorities_[*it] =
+          std::max(chain_priorities_[*it], chain_priorities_[child_id]);
+    }
+  }
+
+  auto by_priority = [this](int a, int b) {
+    return chain_priorities_[a] > chain_priorities_[b];
+  };
+  for (auto& chain_node : chain_nodes_) {
+    std::stable_sort(
+        chain_node.children_.begin(), chain_node.children_.end(), by_priority);
+  }
+  for (int task_id = 0; task_id < tasksNum(); ++task_id) {
+    if (parents(task_id).empty()) {
+      root_chains_.push_back(task_id);
+    }
+  }
+  std::stable_sort(root_chains_.begin(), root_chains_.end(), by_priority);
+}
+
 bool AsyncNetBase::handleRunError() {
 #ifdef CAFFE2_USE_EXCEPTION_PTR
   // Check net's events for exceptions and rethrow chronologically the first one
@@ -147,15 +231,13 @@ TaskThreadPoolBase* AsyncNetBase::poolGetter(
     PoolsMap& pools,
     int device_type,
     int device_id,
-    int pool_size) {
+    int pool_size,
+    bool create_new) {
   std::unique_lock<std::mutex> pools_lock(pools_mutex_);
   auto pool = pools[device_id][pool_size];
   if (!pool) {
     pool = c10::ThreadPoolRegistry()->Create(
-        DeviceTypeName(device_type),
-        device_id,
-        pool_size,
-        options_.use_per_net_pools_);
+        DeviceTypeName(device_type), device_id, pool_size, create_new);
     pools[device_id][pool_size] = pool;
   }
   return pool.get();
@@ -170,7 +252,8 @@ TaskThreadPoolBase* AsyncNetBase::pool() {
 
 TaskThreadPoolBase* AsyncNetBase::pool(const DeviceOption& device_option) {
   if (options_.use_single_pool_) {
-    return poolGetter(cpu_pools_, PROTO_CPU, -1, num_workers_);
+    return poolGetter(
+        cpu_pools_, PROTO_CPU, -1, num_workers_, options_.use_per_net_pools_);
   }
   const auto device_type = device_option.device_type();
   if (IsCPUDeviceType(device_type)) {
@@ -184,18 +267,59 @@ TaskThreadPoolBase* AsyncNetBase::pool(const DeviceOption& device_option) {
         FLAGS_caffe2_net_async_max_numa_nodes,
         "Invalid NUMA node id: ",
         numa_node_id);
-    return poolGetter(cpu_pools_, device_type, numa_node_id, num_workers_);
+    return poolGetter(
+        cpu_pools_,
+        device_type,
+        numa_node_id,
+        num_workers_,
+        options_.use_per_net_pools_);
   } else if (IsGPUDeviceType(device_type)) {
     auto gpu_id = device_option.device_id();
     CAFFE_ENFORCE(
         gpu_id >= 0 && gpu_id < FLAGS_caffe2_net_async_max_gpus,
         "Invalid GPU id: " + c10::to_string(gpu_id));
-    return poolGetter(gpu_pools_, device_type, gpu_id, num_workers_);
+    return poolGetter(
+        gpu_pools_,
+        device_type,
+        gpu_id,
+        num_workers_,
+        options_.use_per_net_pools_);
   } else {
     CAFFE_THROW("Unsupported device type " + c10::to_string(device_type));
   }
 }
 
+TaskThreadPoolBase* AsyncNetBase::taskPool(int task_id) {
+  const auto& device_option = event(task_id).GetDeviceOption();
+  const auto& pool_key = chain_pools_[task_id];
+  if (pool_key.empty()) {
+    return pool(device_option);
+  }
+  auto device_type = device_option.device_type();
+  auto device_id = -1;
+  if (options_.use_single_pool_) {
+    device_type = PROTO_CPU;
+  } else if (IsGPUDeviceType(device_type)) {
+    device_id = device_option.device_id();
+  } else if (device_option.has_numa_node_id()) {
+    device_id = device_option.numa_node_id();
+  }
+  auto pool_size = FLAGS_caffe2_net_async_dedicated_pool_size > 0
+      ? FLAGS_caffe2_net_async_dedicated_pool_size
+      : num_workers_;
+  // dedicated pools are never shared with other nets
+  return poolGetter(
+      dedicated_pools_.at(pool_key),
+      device_type,
+      device_id,
+      pool_size,
+      /* create_new */ true);
+}
+
+bool AsyncNetBase::isSamePool(int task_id, int other_task_id) const {
+  return chain_pools_[task_id] == chain_pools_[other_task_id];
+}
+
 int AsyncNetBase::stream(int task_id) {
   const auto& device_option = event(task_id).GetDeviceOption();
   int stream_id = 0;
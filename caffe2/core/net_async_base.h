@@ -22,6 +22,7 @@ C10_DECLARE_bool(caffe2_net_async_check_stream_status);
 C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
+C10_DECLARE_int(caffe2_net_async_dedicated_pool_size);
 
 namespace caffe2 {
 
@@ -110,6 +111,9 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   int stream(int task_id);
   TaskThreadPoolBase* pool(const DeviceOption& device_option);
   TaskThreadPoolBase* pool();
+  // the pool to run the task in, its dedicated pool if it has one
+  TaskThreadPoolBase* taskPool(int task_id);
+  bool isSamePool(int task_id, int other_task_id) const;
 
   void finishTasks(const std::unordered_set<int>& task_ids);
   void finalizeEvents();
@@ -126,6 +130,11 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   std::vector<std::vector<int>> chains_;
   std::vector<dag_utils::OpGraphNode> chain_nodes_; // chains' parents/children
   dag_utils::ExecutionChains execution_chains_; // for testing
+  // Scheduling priorities of chains, including the ones inherited from their
+  // descendants; children of each chain are sorted by decreasing priority
+  std::vector<int> chain_priorities_;
+  // Chains without parents, by decreasing priority
+  std::vector<int> root_chains_;
 
   // Pools and streams
   std::mutex pools_mutex_;
@@ -136,6 +145,11 @@ class CAFFE2_API AsyncNetBase : public NetBase {
       PoolsMap;
   PoolsMap cpu_pools_;
   PoolsMap gpu_pools_;
+  // Dedicated pools by name and device type, see executor_pool in
+  // net_dag_utils.h; chain_pools_ holds the key of each chain's dedicated
+  // pool, or an empty string
+  std::unordered_map<std::string, PoolsMap> dedicated_pools_;
+  std::vector<std::string> chain_pools_;
   static std::vector<int>& getStreamCounters();
   int num_workers_;
 
@@ -158,8 +172,13 @@ class CAFFE2_API AsyncNetBase : public NetBase {
   C10_DISABLE_COPY_AND_ASSIGN(AsyncNetBase);
 
  private:
-  TaskThreadPoolBase*
-  poolGetter(PoolsMap& pools, int device_type, int device_id, int pool_size);
+  TaskThreadPoolBase* poolGetter(
+      PoolsMap& pools,
+      int device_type,
+      int device_id,
+      int pool_size,
+      bool create_new);
+  void initSchedulingPriorities();
 
   std::unique_ptr<AsyncNetExecutorHelper> helper_;
 
@@ -195,7 +214,8 @@ GetAsyncNetThreadPool(int device_id, int pool_size, bool create_new) {
       LOG(INFO) << "Using default " << device_type_name
                 << " pool size: " << pool_size << "; device id: " << device_id;
     } else {
-      auto num_cores = std::thread::hardware_concurrency();
+      // number of cores, or the thread budget if one is set
+      auto num_cores = TaskThreadPoolBase::defaultNumThreads();
       CAFFE_ENFORCE(num_cores > 0, "Failed to get number of CPU cores");
       LOG(INFO) << "Using estimated " << device_type_name
                 << " pool size: " << num_cores << "; device id: " << device_id;
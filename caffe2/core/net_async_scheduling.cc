@@ -27,9 +27,11 @@ bool AsyncSchedulingNet::isInlineTask(int parent_id, int child_id) const {
   }
   const auto* last_parent_op = lastTaskOp(parent_id);
   const auto* first_child_op = firstTaskOp(child_id);
-  // check that we do not cross device boundary
+  // check that we do not cross device or dedicated pool boundary
   return IsSameDevice(
-      last_parent_op->device_option(), first_child_op->device_option());
+             last_parent_op->device_option(),
+             first_child_op->device_option()) &&
+      isSamePool(parent_id, child_id);
 }
 
 // schedule() is not supposed to throw, all exceptions in the ops are caught
@@ -127,11 +129,8 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
             } else if (parent_needs_polling) {
               // some parents are blocking us from scheduling a child and don't
               // support callbacks, using polling
-              const auto& child_device_option =
-                  event(child_id).GetDeviceOption();
-              pool(child_device_option)
-                  ->run(std::bind(
-                      &AsyncSchedulingNet::pollAndSchedule, this, child_id));
+              taskPool(child_id)->run(std::bind(
+                  &AsyncSchedulingNet::pollAndSchedule, this, child_id));
             } else if (!parents_with_callback.empty()) {
               // some parents are blocking us from scheduling a child and they
               // support callbacks
@@ -185,8 +184,7 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
   if (run_inline) {
     schedule_func();
   } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    taskPool(task_id)->run(schedule_func);
   }
 }
 
@@ -217,9 +215,8 @@ void AsyncSchedulingNet::pollAndSchedule(int task_id) {
   if (can_schedule || !success_ || parent_failed) {
     schedule(task_id);
   } else {
-    const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)
-        ->run(std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id));
+    taskPool(task_id)->run(
+        std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id));
   }
 }
 
@@ -262,11 +259,11 @@ bool AsyncSchedulingNet::RunAsync() {
   }
 
   // schedule() is not expected to throw, at this moment all the initial tasks
-  // will be scheduled and the full graph of tasks will be executed
-  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
-    if (parents(task_id).empty()) {
-      schedule(task_id, options_.run_root_tasks_inline_);
-    }
+  // will be scheduled and the full graph of tasks will be executed;
+  // root tasks are scheduled in the order of their priority, see
+  // Note [Async scheduling priorities]
+  for (auto task_id : root_chains_) {
+    schedule(task_id, options_.run_root_tasks_inline_);
   }
 
   if (tasksNum() == 0) {
@@ -120,6 +120,22 @@ void updateOperatorNodes(
 }
 } // namespace
 
+int executorPriority(const OperatorBase& op) {
+  if (!op.has_debug_def()) {
+    return 0;
+  }
+  return ArgumentHelper::GetSingleArgument<OperatorDef, int>(
+      op.debug_def(), "executor_priority", 0);
+}
+
+std::string executorPool(const OperatorBase& op) {
+  if (!op.has_debug_def()) {
+    return "";
+  }
+  return ArgumentHelper::GetSingleArgument<OperatorDef, std::string>(
+      op.debug_def(), "executor_pool", "");
+}
+
 ExecutionChains computeChains(std::vector<OperatorNode>& orig_nodes) {
   const std::vector<OpGraphNode> nodes = pruneOpNodeGraph(orig_nodes);
   vector<int> initial_frontier;
@@ -186,6 +202,8 @@ ExecutionChains computeChains(std::vector<OperatorNode>& orig_nodes) {
              IsSameDevice(
                  orig_nodes[cur.first].operator_->device_option(),
                  orig_nodes[chain.back()].operator_->device_option()) &&
+             executorPool(*orig_nodes[cur.first].operator_) ==
+                 executorPool(*orig_nodes[chain.back()].operator_) &&
              (!orig_nodes[chain.back()].operator_->HasAsyncPart() ||
               orig_nodes[cur.first].operator_->SupportsAsyncScheduling()))));
   };
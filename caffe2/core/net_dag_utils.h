@@ -43,6 +43,14 @@ struct OpGraphNode {
 
 using ExecutionChains = std::unordered_map<int, std::vector<int>>;
 
+// Operator arguments that tune how the async executors schedule the chain an
+// operator ends up in: a chain gets the highest `executor_priority` of its
+// operators (0 by default), and runs in the dedicated thread pool named by the
+// `executor_pool` argument of its operators, if any. Operators assigned to
+// different pools are never put into the same chain.
+C10_EXPORT int executorPriority(const OperatorBase& op);
+C10_EXPORT std::string executorPool(const OperatorBase& op);
+
 C10_EXPORT ExecutionChains computeChains(std::vector<OperatorNode>& orig_nodes);
 
 // Instead of breaking down the DAG into chains, we partition it into clusters
@@ -7,6 +7,10 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -1101,4 +1105,129 @@ TEST(NetTest, ProfDAGNetErrorTest) {
   testProfDAGNetErrorCase(/*test_error=*/true);
 }
 
+// Records the order and the threads ops ran in
+class NetTestRecordOp final : public Operator<CPUContext> {
+ public:
+  NetTestRecordOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws),
+        name_(OperatorBase::GetSingleArgument<std::string>("name", "")) {}
+
+  bool RunOnDevice() override {
+    std::lock_guard<std::mutex> lock(mutex());
+    records().emplace_back(name_, std::this_thread::get_id());
+    return true;
+  }
+
+  static std::mutex& mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::vector<std::pair<std::string, std::thread::id>>& records() {
+    static std::vector<std::pair<std::string, std::thread::id>> records;
+    return records;
+  }
+
+ private:
+  std::string name_;
+};
+
+REGISTER_CPU_OPERATOR(NetTestRecord, NetTestRecordOp);
+OPERATOR_SCHEMA(NetTestRecord).NumInputs(0, INT_MAX).NumOutputs(0, INT_MAX);
+
+TEST(NetTest, AsyncSchedulingPriorities) {
+  // a single worker runs the chains in the order they are scheduled in;
+  // "c" inherits the priority of its child "d"
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        num_workers: 1
+        op {
+          type: "NetTestRecord"
+          arg { name: "name" s: "a" }
+        }
+        op {
+          type: "NetTestRecord"
+          arg { name: "name" s: "b" }
+        }
+        op {
+          output: "x"
+          type: "NetTestRecord"
+          arg { name: "name" s: "c" }
+        }
+        op {
+          input: "x"
+          output: "y"
+          type: "NetTestRecord"
+          arg { name: "name" s: "e" }
+        }
+        op {
+          input: "x"
+          output: "z"
+          type: "NetTestRecord"
+          arg { name: "name" s: "d" }
+          arg { name: "executor_priority" i: 1 }
+        }
+)DOC";
+
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  Workspace ws;
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  NetTestRecordOp::records().clear();
+  ASSERT_TRUE(net->Run());
+
+  std::vector<std::string> order;
+  for (const auto& record : NetTestRecordOp::records()) {
+    order.push_back(record.first);
+  }
+  ASSERT_EQ(order.size(), 5U);
+  ASSERT_EQ(order.front(), "c");
+  auto d = std::find(order.begin(), order.end(), "d");
+  auto e = std::find(order.begin(), order.end(), "e");
+  ASSERT_LT(d, e);
+}
+
+TEST(NetTest, AsyncSchedulingDedicatedPool) {
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        num_workers: 1
+        op {
+          output: "x"
+          type: "NetTestRecord"
+          arg { name: "name" s: "sparse" }
+        }
+        op {
+          input: "x"
+          output: "y"
+          type: "NetTestRecord"
+          arg { name: "name" s: "dense" }
+          arg { name: "executor_pool" s: "dense" }
+        }
+        op {
+          input: "y"
+          output: "z"
+          type: "NetTestRecord"
+          arg { name: "name" s: "sparse" }
+        }
+)DOC";
+
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  Workspace ws;
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  // ops in different pools are not chained together
+  auto* async_net = dynamic_cast_if_rtti<AsyncNetBase*>(net.get());
+  CHECK_NOTNULL(async_net);
+  ASSERT_EQ(async_net->TEST_execution_chains().size(), 3U);
+
+  NetTestRecordOp::records().clear();
+  ASSERT_TRUE(net->Run());
+  const auto& records = NetTestRecordOp::records();
+  ASSERT_EQ(records.size(), 3U);
+  ASSERT_EQ(records[0].second, records[2].second);
+  ASSERT_NE(records[0].second, records[1].second);
+}
+
 } // namespace caffe2
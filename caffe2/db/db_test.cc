@@ -5,10 +5,14 @@
 
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/core/db.h"
+#include "caffe2/core/flags.h"
 #include "caffe2/core/logging.h"
 #include "caffe2/proto/caffe2_pb.h"
 #include <gtest/gtest.h>
 
+C10_DECLARE_int(caffe2_prefetch_db_num_threads);
+C10_DECLARE_int(caffe2_prefetch_db_read_ahead);
+
 namespace caffe2 {
 namespace db {
 
@@ -196,5 +200,40 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(PrefetchDBTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  for (int num_threads : {1, 3, kMaxItems + 1}) {
+    FLAGS_caffe2_prefetch_db_num_threads = num_threads;
+    FLAGS_caffe2_prefetch_db_read_ahead = 2;
+    std::unique_ptr<DB> db(CreateDB("prefetch", "leveldb:" + name, READ));
+    std::unique_ptr<Cursor> cursor(db->NewCursor());
+    // The records come in the order of the underlying db, twice to test
+    // SeekToFirst().
+    for (int pass = 0; pass < 2; ++pass) {
+      cursor->SeekToFirst();
+      for (int i = 0; i < kMaxItems; ++i) {
+        std::stringstream ss;
+        ss << std::setw(2) << std::setfill('0') << i;
+        EXPECT_TRUE(cursor->Valid());
+        EXPECT_EQ(cursor->key(), ss.str());
+        EXPECT_EQ(cursor->value(), ss.str());
+        cursor->Next();
+      }
+      EXPECT_FALSE(cursor->Valid());
+    }
+    // DBReader wraps around at the end of the db.
+    cursor.reset();
+    DBReader reader(std::move(db));
+    string key;
+    string value;
+    for (int i = 0; i < kMaxItems; ++i) {
+      reader.Read(&key, &value);
+    }
+    reader.Read(&key, &value);
+    EXPECT_EQ(key, "00");
+  }
+}
+
 }  // namespace db
 }  // namespace caffe2
@@ -0,0 +1,242 @@
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "caffe2/core/db.h"
+#include "caffe2/core/flags.h"
+#include "caffe2/core/logging.h"
+
+C10_DEFINE_int(
+    caffe2_prefetch_db_num_threads,
+    4,
+    "The number of cursor threads of a prefetch db.");
+C10_DEFINE_int(
+    caffe2_prefetch_db_read_ahead,
+    256,
+    "The number of records a prefetch db reads ahead, over all threads.");
+
+namespace caffe2 {
+namespace db {
+
+/**
+ * A cursor that reads the records of another db on multiple threads.
+ *
+ * The records are striped across the threads: the thread i opens its own
+ * cursor of the underlying db and reads the records i, i + N, i + 2N... into a
+ * bounded queue. The cursor pops the records from the queues in turn, so it
+ * returns the records in the order of the underlying db, while the threads
+ * read ahead of it concurrently. Reading the values (e.g. from the memory
+ * mapped pages of an LMDB, or the decompressed blocks of a LevelDB) is done by
+ * the threads, so that the reading thread only waits for records that aren't
+ * read yet.
+ */
+class PrefetchDBCursor : public Cursor {
+ public:
+  PrefetchDBCursor(DB* db, int num_threads, int read_ahead)
+      : db_(db),
+        stripes_(num_threads),
+        capacity_(std::max(1, read_ahead / num_threads)) {
+    Start();
+  }
+  ~PrefetchDBCursor() override {
+    Stop();
+  }
+
+  void Seek(const string& /*key*/) override {
+    CAFFE_THROW("PrefetchDB does not support seeking.");
+  }
+
+  void SeekToFirst() override {
+    Stop();
+    Start();
+  }
+
+  void Next() override {
+    Current();
+    auto& stripe = stripes_[current_];
+    {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      stripe.records.pop_front();
+    }
+    stripe.not_full.notify_one();
+    current_ = (current_ + 1) % stripes_.size();
+  }
+
+  string key() override {
+    return Current().key;
+  }
+  string value() override {
+    return Current().value;
+  }
+  bool Valid() override {
+    return !Current().end;
+  }
+
+ private:
+  struct Record {
+    string key;
+    string value;
+    // Marks the end of the records of a thread.
+    bool end{false};
+  };
+
+  struct Stripe {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<Record> records;
+    std::exception_ptr exception;
+    std::thread thread;
+  };
+
+  // Waits for the record the cursor points to, and returns it. Only the
+  // reading thread pops records, and pushing to a deque doesn't invalidate
+  // references to its elements, so the record stays valid until the next call
+  // to Next().
+  const Record& Current() {
+    auto& stripe = stripes_[current_];
+    std::unique_lock<std::mutex> lock(stripe.mutex);
+    stripe.not_empty.wait(lock, [&stripe] {
+      return !stripe.records.empty() || stripe.exception;
+    });
+    if (stripe.records.empty()) {
+      std::rethrow_exception(stripe.exception);
+    }
+    return stripe.records.front();
+  }
+
+  void Start() {
+    stop_ = false;
+    current_ = 0;
+    for (size_t i = 0; i < stripes_.size(); ++i) {
+      stripes_[i].thread = std::thread(&PrefetchDBCursor::Prefetch, this, i);
+    }
+  }
+
+  void Stop() {
+    stop_ = true;
+    for (auto& stripe : stripes_) {
+      // Taking the mutex makes sure that the thread either sees stop_ or
+      // waits already.
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      stripe.not_full.notify_all();
+    }
+    for (auto& stripe : stripes_) {
+      if (stripe.thread.joinable()) {
+        stripe.thread.join();
+      }
+      stripe.records.clear();
+      stripe.exception = nullptr;
+    }
+  }
+
+  // Adds a record to the queue of the stripe, and returns false if the cursor
+  // is being stopped.
+  bool Push(Stripe& stripe, Record record) {
+    {
+      std::unique_lock<std::mutex> lock(stripe.mutex);
+      stripe.not_full.wait(lock, [this, &stripe] {
+        return stripe.records.size() < capacity_ || stop_;
+      });
+      if (stop_) {
+        return false;
+      }
+      stripe.records.push_back(std::move(record));
+    }
+    stripe.not_empty.notify_one();
+    return true;
+  }
+
+  void Prefetch(size_t index) {
+    auto& stripe = stripes_[index];
+    try {
+      // The cursor is created on the thread that uses it, since some dbs
+      // (e.g. LMDB) tie read transactions to threads.
+      auto cursor = db_->NewCursor();
+      cursor->SeekToFirst();
+      for (size_t i = 0; i < index && cursor->Valid(); ++i) {
+        cursor->Next();
+      }
+      while (cursor->Valid()) {
+        Record record;
+        record.key = cursor->key();
+        record.value = cursor->value();
+        if (!Push(stripe, std::move(record))) {
+          return;
+        }
+        for (size_t i = 0; i < stripes_.size() && cursor->Valid(); ++i) {
+          cursor->Next();
+        }
+      }
+      Record end;
+      end.end = true;
+      Push(stripe, std::move(end));
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.exception = std::current_exception();
+      }
+      stripe.not_empty.notify_all();
+    }
+  }
+
+  DB* db_;
+  std::vector<Stripe> stripes_;
+  const size_t capacity_;
+  size_t current_{0};
+  std::atomic<bool> stop_{false};
+};
+
+/**
+ * A read-only db that wraps another db, whose cursors read the records on
+ * multiple threads ahead of the reader. It is opened with a source of the form
+ * "<db_type>:<source>" of the underlying db, e.g. "lmdb:/path/to/db", so any
+ * op reading a db (e.g. through CreateDB and a DBReader) can use it by only
+ * changing the db type and source. The number of threads and the number of
+ * records read ahead are set by the caffe2_prefetch_db_num_threads and
+ * caffe2_prefetch_db_read_ahead flags.
+ */
+class PrefetchDB : public DB {
+ public:
+  PrefetchDB(const string& source, Mode mode) : DB(source, mode) {
+    CAFFE_ENFORCE(mode == READ, "PrefetchDB only supports reading.");
+    const auto pos = source.find(':');
+    CAFFE_ENFORCE(
+        pos != string::npos,
+        "PrefetchDB expects a source of the form <db_type>:<source>, got ",
+        source);
+    db_ = CreateDB(source.substr(0, pos), source.substr(pos + 1), READ);
+    CAFFE_ENFORCE(
+        db_, "Cannot find db implementation of type ", source.substr(0, pos));
+    CAFFE_ENFORCE_GT(FLAGS_caffe2_prefetch_db_num_threads, 0);
+    CAFFE_ENFORCE_GT(FLAGS_caffe2_prefetch_db_read_ahead, 0);
+    VLOG(1) << "Opened prefetch db " << source;
+  }
+
+  void Close() override {
+    db_.reset();
+  }
+  unique_ptr<Cursor> NewCursor() override {
+    CAFFE_ENFORCE(db_, "PrefetchDB is closed.");
+    return make_unique<PrefetchDBCursor>(
+        db_.get(),
+        FLAGS_caffe2_prefetch_db_num_threads,
+        FLAGS_caffe2_prefetch_db_read_ahead);
+  }
+  unique_ptr<Transaction> NewTransaction() override {
+    CAFFE_THROW("PrefetchDB does not support writing.");
+  }
+
+ private:
+  unique_ptr<DB> db_;
+};
+
+REGISTER_CAFFE2_DB(PrefetchDB, PrefetchDB);
+// For lazy-minded, one can also call with lower-case name.
+REGISTER_CAFFE2_DB(prefetch, PrefetchDB);
+
+} // namespace db
+} // namespace caffe2
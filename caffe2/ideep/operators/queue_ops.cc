@@ -1,5 +1,6 @@
 #include <caffe2/ideep/ideep_utils.h>
 #include <caffe2/queue/blobs_queue.h>
+#include <caffe2/queue/lock_free_blobs_queue.h>
 
 using namespace caffe2;
 
@@ -20,6 +21,7 @@ class IDEEPCreateBlobsQueueOp final : public IDEEPOperator {
     const auto numBlobs = GetSingleArgument("num_blobs", 1);
     const auto enforceUniqueName =
         GetSingleArgument("enforce_unique_name", false);
+    const auto lockFree = GetSingleArgument("lock_free", false);
     const auto fieldNames =
         OperatorBase::template GetRepeatedArgument<std::string>("field_names");
     CAFFE_ENFORCE_EQ(this->OutputSize(), 1);
@@ -27,8 +29,13 @@ class IDEEPCreateBlobsQueueOp final : public IDEEPOperator {
                         ->template GetMutable<std::shared_ptr<BlobsQueue>>();
 
     CAFFE_ENFORCE(queuePtr);
-    *queuePtr = std::make_shared<BlobsQueue>(
-        ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    if (lockFree) {
+      *queuePtr = std::make_shared<LockFreeBlobsQueue>(
+          ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    } else {
+      *queuePtr = std::make_shared<BlobsQueue>(
+          ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    }
     return true;
   }
 
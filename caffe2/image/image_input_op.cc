@@ -135,6 +135,15 @@ The dimension of the output image will always be cropxcrop
         "Number of CPU decode/transform threads."
         " Defaults to 4")
     .Arg("output_type", "If gpu_transform, can set to FLOAT or FLOAT16.")
+    .Arg(
+        "output_order",
+        "Order of the images output by the CPU transform, NHWC or NCHW."
+        " Defaults to NHWC. The GPU transform always outputs NCHW")
+    .Arg(
+        "reduced_decode",
+        "If 1, JPEG images that are resized to scale are decoded at 1/2, 1/4"
+        " or 1/8 of their size when that is still larger than scale, which is"
+        " much faster. Defaults to 0")
     .Arg("db", "Name of the database (if not passed as input)")
     .Arg(
         "db_type",
@@ -10,6 +10,7 @@
 #include "c10/core/thread_pool.h"
 #include "caffe2/core/common.h"
 #include "caffe2/core/db.h"
+#include "caffe2/core/types.h"
 #include "caffe2/image/transform_gpu.h"
 #include "caffe2/operators/prefetch_op.h"
 #include "caffe2/proto/caffe2_legacy.pb.h"
@@ -95,6 +96,9 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool ApplyTransformOnGPU(
       const std::vector<std::int64_t>& dims,
       const c10::Device& type);
+  // The shorter side an encoded image may be downscaled to while decoding, or
+  // 0 if it must be decoded at full size
+  int ReducedDecodeMinSize(const PerImageArg& info) const;
 
   unique_ptr<db::DBReader> owned_reader_;
   const db::DBReader* reader_;
@@ -136,6 +140,9 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool use_caffe_datum_;
   bool gpu_transform_;
   bool mean_std_copied_ = false;
+  // Layout of the images of the CPU transform path
+  StorageOrder order_;
+  bool reduced_decode_;
 
   // thread pool for parse + decode
   int num_decode_threads_;
@@ -205,6 +212,12 @@ ImageInputOp<Context>::ImageInputOp(
       gpu_transform_(OperatorBase::template GetSingleArgument<int>(
           "use_gpu_transform",
           0)),
+      order_(StringToStorageOrder(
+          OperatorBase::template GetSingleArgument<string>(
+              "output_order",
+              "NHWC"))),
+      reduced_decode_(
+          OperatorBase::template GetSingleArgument<int>("reduced_decode", 0)),
       num_decode_threads_(
           OperatorBase::template GetSingleArgument<int>("decode_threads", 4)),
       additional_output_sizes_(
@@ -296,6 +309,13 @@ ImageInputOp<Context>::ImageInputOp(
       (scale_ > 0) != (minsize_ > 0),
       "Must provide one and only one of scaling or minsize");
   CAFFE_ENFORCE_GT(crop_, 0, "Must provide the cropping value.");
+  CAFFE_ENFORCE(
+      order_ == StorageOrder::NHWC || order_ == StorageOrder::NCHW,
+      "output_order must be NHWC or NCHW");
+  CAFFE_ENFORCE(
+      !gpu_transform_ || order_ == StorageOrder::NHWC,
+      "The GPU transform always outputs NCHW from NHWC, leave output_order ",
+      "to its default");
   CAFFE_ENFORCE_GE(
       scale_ > 0 ? scale_ : minsize_,
       crop_,
@@ -369,6 +389,13 @@ ImageInputOp<Context>::ImageInputOp(
   LOG(INFO) << "    " << (is_test_ ? "Central" : "Random")
             << " cropping image to " << crop_
             << (mirror_ ? " with " : " without ") << "random mirroring;";
+  if (reduced_decode_) {
+    LOG(INFO) << "    Downscaling JPEG images while decoding when possible;";
+  }
+  if (!gpu_transform_) {
+    LOG(INFO) << "    Outputting images in "
+              << (order_ == StorageOrder::NCHW ? "NCHW" : "NHWC") << " order;";
+  }
   LOG(INFO) << "Label Type: " << label_type_;
   LOG(INFO) << "Num Labels: " << num_labels_;
 
@@ -390,12 +417,12 @@ ImageInputOp<Context>::ImageInputOp(
   for (int i = 0; i < num_decode_threads_; ++i) {
     randgen_per_thread_.emplace_back(meta_randgen());
   }
+  const int64_t channels = color_ ? 3 : 1;
   ReinitializeTensor(
       &prefetched_image_,
-      {int64_t(batch_size_),
-       int64_t(crop_),
-       int64_t(crop_),
-       int64_t(color_ ? 3 : 1)},
+      order_ == StorageOrder::NCHW
+          ? std::vector<int64_t>{batch_size_, channels, crop_, crop_}
+          : std::vector<int64_t>{batch_size_, crop_, crop_, channels},
       at::dtype<uint8_t>().device(CPU));
   std::vector<int64_t> sizes;
   if (label_type_ != SINGLE_LABEL && label_type_ != SINGLE_LABEL_WEIGHTED) {
@@ -412,6 +439,90 @@ ImageInputOp<Context>::ImageInputOp(
   }
 }
 
+// Reads the size of a JPEG image from the frame header, without decoding it.
+// Returns false if the data isn't a JPEG image.
+inline bool GetJpegSize(const char* data, int size, int* height, int* width) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  if (size < 4 || bytes[0] != 0xFF || bytes[1] != 0xD8) {
+    return false;
+  }
+  int pos = 2;
+  while (pos + 4 <= size) {
+    if (bytes[pos] != 0xFF) {
+      return false;
+    }
+    const uint8_t marker = bytes[pos + 1];
+    if (marker == 0xFF) {
+      // Fill byte
+      ++pos;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+      // Markers without a payload
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      // End of image or start of scan before any frame header
+      return false;
+    }
+    const int length = (bytes[pos + 2] << 8) | bytes[pos + 3];
+    // Start of frame markers, except DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      if (pos + 9 > size) {
+        return false;
+      }
+      *height = (bytes[pos + 5] << 8) | bytes[pos + 6];
+      *width = (bytes[pos + 7] << 8) | bytes[pos + 8];
+      return *height > 0 && *width > 0;
+    }
+    pos += 2 + length;
+  }
+  return false;
+}
+
+// Decodes an encoded image. When min_size is positive, a JPEG image is decoded
+// at 1/2, 1/4 or 1/8 of its size if its shorter side stays at least min_size.
+// libjpeg then computes a smaller inverse DCT per block, which is much cheaper
+// than decoding at full size and resizing.
+inline cv::Mat DecodeImage(
+    const char* data,
+    int size,
+    const bool color,
+    const int min_size) {
+  int flags = color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+#if CV_MAJOR_VERSION >= 3
+  int height, width;
+  if (min_size > 0 && GetJpegSize(data, size, &height, &width)) {
+    const int shorter_side = std::min(height, width);
+    if (shorter_side >= 8 * min_size) {
+      flags = color ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+    } else if (shorter_side >= 4 * min_size) {
+      flags = color ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+    } else if (shorter_side >= 2 * min_size) {
+      flags = color ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+    }
+  }
+#endif
+  // We use a cv::Mat to wrap the encoded str so we do not need a copy.
+  return cv::imdecode(
+      cv::Mat(1, &size, CV_8UC1, const_cast<char*>(data)), flags);
+}
+
+template <class Context>
+int ImageInputOp<Context>::ReducedDecodeMinSize(
+    const PerImageArg& info) const {
+  // Only images that are always resized to scale_ can be decoded at a smaller
+  // size; the bounding boxes and the inception-style crops are relative to the
+  // full size image.
+  if (!reduced_decode_ || scale_ <= 0 || random_scaling_ ||
+      scale_jitter_type_ != NO_SCALE_JITTER || info.bounding_params.valid) {
+    return 0;
+  }
+  return scale_;
+}
+
 // Inception-stype scale jittering
 template <class Context>
 bool RandomSizedCropping(cv::Mat* img, const int crop, std::mt19937* randgen) {
@@ -471,13 +582,11 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
       // encoded image in datum.
       // count the number of exceptions from opencv imdecode
       try {
-        src = cv::imdecode(
-            cv::Mat(
-                1,
-                datum.data().size(),
-                CV_8UC1,
-                const_cast<char*>(datum.data().data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+        src = DecodeImage(
+            datum.data().data(),
+            datum.data().size(),
+            color_,
+            ReducedDecodeMinSize(info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
@@ -542,17 +651,13 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
       // encoded image string.
       DCHECK_EQ(image_proto.string_data_size(), 1);
       const string& encoded_image_str = image_proto.string_data(0);
-      int encoded_size = encoded_image_str.size();
-      // We use a cv::Mat to wrap the encoded str so we do not need a copy.
       // count the number of exceptions from opencv imdecode
       try {
-        src = cv::imdecode(
-            cv::Mat(
-                1,
-                &encoded_size,
-                CV_8UC1,
-                const_cast<char*>(encoded_image_str.data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+        src = DecodeImage(
+            encoded_image_str.data(),
+            encoded_image_str.size(),
+            color_,
+            ReducedDecodeMinSize(info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
@@ -944,6 +1049,9 @@ void ColorNormalization(
 }
 
 // Factored out image transformation
+// The image is written to image_data in the given order. Without color jitter
+// and color lighting, cropping, mirroring, normalization and the layout are
+// fused in a single pass over the pixels of the crop.
 template <class Context>
 void TransformImage(
     const cv::Mat& scaled_img,
@@ -963,7 +1071,8 @@ void TransformImage(
     const std::vector<float>& std,
     std::mt19937* randgen,
     std::bernoulli_distribution* mirror_this_image,
-    bool is_test = false) {
+    bool is_test = false,
+    const StorageOrder order = StorageOrder::NHWC) {
   CAFFE_ENFORCE_GE(
       scaled_img.rows, crop, "Image height must be bigger than crop.");
   CAFFE_ENFORCE_GE(
@@ -980,9 +1089,41 @@ void TransformImage(
     height_offset =
         std::uniform_int_distribution<>(0, scaled_img.rows - crop)(*randgen);
   }
+  const bool mirror_image =
+      !is_test && mirror && (*mirror_this_image)(*randgen);
+
+  const bool jitter =
+      (color_jitter || color_lighting) && channels == 3 && !is_test;
+  if (!jitter) {
+    const int pixel_stride = order == StorageOrder::NCHW ? 1 : channels;
+    const int channel_stride = order == StorageOrder::NCHW ? crop * crop : 1;
+    for (int h = 0; h < crop; ++h) {
+      const uint8_t* cv_row =
+          scaled_img.ptr(height_offset + h) + width_offset * channels;
+      float* image_data_ptr = image_data + h * crop * pixel_stride;
+      for (int w = 0; w < crop; ++w) {
+        const uint8_t* cv_data =
+            cv_row + (mirror_image ? crop - 1 - w : w) * channels;
+        for (int c = 0; c < channels; ++c) {
+          image_data_ptr[c * channel_stride] =
+              (static_cast<float>(cv_data[c]) - mean[c]) * std[c];
+        }
+        image_data_ptr += pixel_stride;
+      }
+    }
+    return;
+  }
 
-  float* image_data_ptr = image_data;
-  if (!is_test && mirror && (*mirror_this_image)(*randgen)) {
+  // The color transforms work on HWC images
+  std::vector<float> hwc_buffer;
+  float* hwc_data = image_data;
+  if (order == StorageOrder::NCHW) {
+    hwc_buffer.resize(crop * crop * channels);
+    hwc_data = hwc_buffer.data();
+  }
+
+  float* image_data_ptr = hwc_data;
+  if (mirror_image) {
     // Copy mirrored image.
     for (int h = height_offset; h < height_offset + crop; ++h) {
       for (int w = width_offset + crop - 1; w >= width_offset; --w) {
@@ -1004,13 +1145,13 @@ void TransformImage(
     }
   }
 
-  if (color_jitter && channels == 3 && !is_test) {
+  if (color_jitter) {
     ColorJitter<Context>(
-        image_data, crop, saturation, brightness, contrast, randgen);
+        hwc_data, crop, saturation, brightness, contrast, randgen);
   }
-  if (color_lighting && channels == 3 && !is_test) {
+  if (color_lighting) {
     ColorLighting<Context>(
-        image_data,
+        hwc_data,
         crop,
         color_lighting_std,
         color_lighting_eigvecs,
@@ -1020,7 +1161,15 @@ void TransformImage(
 
   // Color normalization
   // Mean subtraction and scaling.
-  ColorNormalization<Context>(image_data, crop, channels, mean, std);
+  ColorNormalization<Context>(hwc_data, crop, channels, mean, std);
+
+  if (order == StorageOrder::NCHW) {
+    for (int c = 0; c < channels; ++c) {
+      for (int i = 0; i < crop * crop; ++i) {
+        image_data[c * crop * crop + i] = hwc_data[i * channels + c];
+      }
+    }
+  }
 }
 
 // Only crop / transose the image
@@ -1113,7 +1262,8 @@ void ImageInputOp<Context>::DecodeAndTransform(
       std_,
       randgen,
       &mirror_this_image,
-      is_test_);
+      is_test_,
+      order_);
 }
 
 template <class Context>
@@ -0,0 +1,242 @@
+#include "caffe2/observers/latency_histogram_observer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CAFFE2_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CAFFE2_HAS_TSC 1
+#endif
+
+#include "caffe2/core/logging.h"
+
+C10_DEFINE_int(
+    caffe2_latency_histogram_sampling_period,
+    16,
+    "LatencyHistogramObserver times one of every this many runs of an op.");
+
+namespace caffe2 {
+
+namespace {
+
+#ifdef CAFFE2_HAS_TSC
+
+inline uint64_t ticks() {
+  return __rdtsc();
+}
+
+// Measures the ticks of the time stamp counter against the steady clock.
+// Modern x86 CPUs have an invariant counter, which ticks at a constant rate
+// regardless of frequency scaling.
+double measureNanosPerTick() {
+  using clock = std::chrono::steady_clock;
+  const auto begin = clock::now();
+  const auto begin_ticks = ticks();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  const auto end_ticks = ticks();
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         clock::now() - begin)
+                         .count();
+  return end_ticks > begin_ticks
+      ? static_cast<double>(nanos) / (end_ticks - begin_ticks)
+      : 1.0;
+}
+
+#else
+
+inline uint64_t ticks() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double measureNanosPerTick() {
+  return 1.0;
+}
+
+#endif // CAFFE2_HAS_TSC
+
+double nanosPerTick() {
+  static const double nanos_per_tick = measureNanosPerTick();
+  return nanos_per_tick;
+}
+
+// Returns the midpoint of the bucket in microseconds.
+double bucketMidpoint(int index) {
+  const auto lower = LatencyHistogram::bucketLowerBound(index);
+  const auto upper = index + 1 < LatencyHistogram::kNumBuckets
+      ? LatencyHistogram::bucketLowerBound(index + 1)
+      : lower;
+  return (lower + (upper - lower) / 2.0) / 1000.0;
+}
+
+} // namespace
+
+int LatencyHistogram::bucketIndex(uint64_t nanos) {
+  if (nanos < kSubBuckets) {
+    return static_cast<int>(nanos);
+  }
+  int exponent = 63;
+  while (!((nanos >> exponent) & 1)) {
+    --exponent;
+  }
+  // The bits after the leading one select the sub-bucket.
+  const int sub_bucket =
+      (nanos >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(int index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  const int exponent = index / kSubBuckets + kSubBucketBits - 1;
+  const uint64_t sub_bucket = index % kSubBuckets;
+  return (uint64_t(1) << exponent) |
+      (sub_bucket << (exponent - kSubBucketBits));
+}
+
+std::vector<uint64_t> LatencyHistogram::counts() const {
+  std::vector<uint64_t> counts(kNumBuckets);
+  for (int i = 0; i < kNumBuckets; ++i) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+void LatencyHistogram::reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+LatencyHistogramSet::LatencyHistogramSet(size_t size, int sampling_period)
+    : sampling_period_(sampling_period),
+      size_(size),
+      histograms_(new LatencyHistogram[size]) {
+  CAFFE_ENFORCE_GT(sampling_period_, 0, "The sampling period must be positive");
+  // Calibrates the time stamp counter before the first run.
+  nanosPerTick();
+}
+
+LatencyHistogram* LatencyHistogramSet::attach() {
+  CAFFE_ENFORCE_LT(attached_, size_, "All histograms are attached already");
+  return &histograms_[attached_++];
+}
+
+LatencyHistogramOperatorObserver::LatencyHistogramOperatorObserver(
+    OperatorBase* subject,
+    LatencyHistogramObserver* netObserver)
+    : LatencyHistogramOperatorObserver(
+          subject,
+          netObserver->attach(),
+          netObserver->sampling_period()) {}
+
+LatencyHistogramOperatorObserver::LatencyHistogramOperatorObserver(
+    OperatorBase* subject,
+    LatencyHistogram* histogram,
+    int sampling_period)
+    : ObserverBase<OperatorBase>(subject),
+      histogram_(histogram),
+      sampling_period_(sampling_period) {}
+
+void LatencyHistogramOperatorObserver::Start() {
+  sampled_ = runs_++ % sampling_period_ == 0;
+  if (sampled_) {
+    start_ = ticks();
+  }
+}
+
+void LatencyHistogramOperatorObserver::Stop() {
+  if (sampled_) {
+    const auto elapsed = ticks() - start_;
+    histogram_->record(static_cast<uint64_t>(elapsed * nanosPerTick()));
+  }
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>>
+LatencyHistogramOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int /* rnn_order */) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyHistogramOperatorObserver(
+          subject, histogram_, sampling_period_));
+}
+
+LatencyHistogramObserver::LatencyHistogramObserver(
+    NetBase* subject,
+    int sampling_period)
+    : LatencyHistogramSet(subject->GetOperators().size(), sampling_period),
+      OperatorAttachingNetObserver<
+          LatencyHistogramOperatorObserver,
+          LatencyHistogramObserver>(subject, this) {}
+
+std::vector<OperatorLatencyStats> LatencyHistogramObserver::snapshot() const {
+  const auto& operators = subject_->GetOperators();
+  std::vector<OperatorLatencyStats> stats(size_);
+  for (size_t i = 0; i < size_; ++i) {
+    auto& op_stats = stats[i];
+    if (operators[i]->has_debug_def()) {
+      op_stats.type = operators[i]->debug_def().type();
+      op_stats.name = operators[i]->debug_def().name();
+    }
+
+    const auto counts = histograms_[i].counts();
+    for (const auto count : counts) {
+      op_stats.count += count;
+    }
+    if (op_stats.count == 0) {
+      continue;
+    }
+    // The ranks of the percentiles, starting at 1.
+    const uint64_t p50_rank = std::max<uint64_t>(1, op_stats.count * 50 / 100);
+    const uint64_t p90_rank = std::max<uint64_t>(1, op_stats.count * 90 / 100);
+    const uint64_t p99_rank = std::max<uint64_t>(1, op_stats.count * 99 / 100);
+    uint64_t seen = 0;
+    for (int b = 0; b < LatencyHistogram::kNumBuckets; ++b) {
+      if (counts[b] == 0) {
+        continue;
+      }
+      const auto previous = seen;
+      seen += counts[b];
+      const auto midpoint = bucketMidpoint(b);
+      if (previous < p50_rank && seen >= p50_rank) {
+        op_stats.p50 = midpoint;
+      }
+      if (previous < p90_rank && seen >= p90_rank) {
+        op_stats.p90 = midpoint;
+      }
+      if (previous < p99_rank && seen >= p99_rank) {
+        op_stats.p99 = midpoint;
+      }
+      op_stats.max = midpoint;
+    }
+  }
+  return stats;
+}
+
+void LatencyHistogramObserver::reset() {
+  for (size_t i = 0; i < size_; ++i) {
+    histograms_[i].reset();
+  }
+}
+
+std::string LatencyHistogramObserver::debugInfo() {
+  std::stringstream ss;
+  ss << "Operator latencies in us, sampled once every " << sampling_period_
+     << " runs:";
+  for (const auto& op_stats : snapshot()) {
+    ss << "\n"
+       << op_stats.type << " " << op_stats.name << ": count " << op_stats.count
+       << ", p50 " << op_stats.p50 << ", p90 " << op_stats.p90 << ", p99 "
+       << op_stats.p99 << ", max " << op_stats.max;
+  }
+  return ss.str();
+}
+
+} // namespace caffe2
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/flags.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+C10_DECLARE_int(caffe2_latency_histogram_sampling_period);
+
+namespace caffe2 {
+
+class LatencyHistogramObserver;
+
+// A histogram of latencies in nanoseconds, with log-linear buckets: every
+// power of two is split into kSubBuckets buckets, so that a bucket is at most
+// 1 / kSubBuckets of its lower bound wide. Recording is a relaxed atomic
+// increment, so a snapshot can be taken from another thread while the
+// histogram is being recorded into.
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 2;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kNumBuckets = 64 * kSubBuckets;
+
+  LatencyHistogram() {
+    reset();
+  }
+
+  void record(uint64_t nanos) {
+    buckets_[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns the counts of all buckets.
+  std::vector<uint64_t> counts() const;
+
+  void reset();
+
+  static int bucketIndex(uint64_t nanos);
+  // Returns the smallest latency of the bucket.
+  static uint64_t bucketLowerBound(int index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+};
+
+struct CAFFE2_API OperatorLatencyStats {
+  std::string type;
+  std::string name;
+  // The number of sampled runs.
+  uint64_t count{0};
+  // The percentiles in microseconds, i.e. the midpoints of the buckets that
+  // hold them. They are zero when no run was sampled.
+  double p50{0.0};
+  double p90{0.0};
+  double p99{0.0};
+  double max{0.0};
+};
+
+// The histograms of the operators of a net. It is a base of
+// LatencyHistogramObserver that is constructed before the operator observers,
+// which take their histograms from it.
+class CAFFE2_API LatencyHistogramSet {
+ public:
+  LatencyHistogramSet(size_t size, int sampling_period);
+
+  int sampling_period() const {
+    return sampling_period_;
+  }
+
+ protected:
+  // Returns the histogram of the next operator observer.
+  LatencyHistogram* attach();
+
+  const int sampling_period_;
+  const size_t size_;
+  // Not a vector, since atomics are neither copyable nor movable.
+  std::unique_ptr<LatencyHistogram[]> histograms_;
+  size_t attached_{0};
+
+  friend class LatencyHistogramOperatorObserver;
+};
+
+class CAFFE2_API LatencyHistogramOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyHistogramOperatorObserver(OperatorBase* subject) = delete;
+  LatencyHistogramOperatorObserver(
+      OperatorBase* subject,
+      LatencyHistogramObserver* netObserver);
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+ private:
+  LatencyHistogramOperatorObserver(
+      OperatorBase* subject,
+      LatencyHistogram* histogram,
+      int sampling_period);
+
+  void Start() override;
+  void Stop() override;
+
+  LatencyHistogram* histogram_;
+  const uint32_t sampling_period_;
+  // An operator doesn't run on several threads at once, so the counter and
+  // the start time don't need to be atomic.
+  uint32_t runs_{0};
+  uint64_t start_{0};
+  bool sampled_{false};
+};
+
+// Keeps a latency histogram per operator of the net, to compute percentiles
+// of the operator latencies over many runs. The time is read from the time
+// stamp counter where there is one, and a run of an operator is only timed
+// once every `sampling_period` runs, so that the observer can stay attached
+// in production. The steps of a recurrent network add their latencies to
+// the histogram of the RecurrentNetwork op.
+//
+// For asynchronous operators, the latency is the time of RunAsync, like for
+// TimeObserver.
+class CAFFE2_API LatencyHistogramObserver final
+    : public LatencyHistogramSet,
+      public OperatorAttachingNetObserver<
+          LatencyHistogramOperatorObserver,
+          LatencyHistogramObserver> {
+ public:
+  explicit LatencyHistogramObserver(
+      NetBase* subject,
+      int sampling_period = FLAGS_caffe2_latency_histogram_sampling_period);
+
+  // Returns the latency percentiles of every operator of the net, in the
+  // order of the operators. Can be called while the net is running.
+  std::vector<OperatorLatencyStats> snapshot() const;
+
+  // Clears the histograms of all operators.
+  void reset();
+
+  std::string debugInfo() override;
+
+ private:
+  void Start() override {}
+  void Stop() override {}
+};
+
+} // namespace caffe2
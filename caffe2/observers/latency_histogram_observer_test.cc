@@ -0,0 +1,108 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/observers/latency_histogram_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencySleepOp final : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(GetSingleArgument<int>("ms", 1)));
+    StopAllObservers();
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(LatencySleepOp, LatencySleepOp);
+
+OPERATOR_SCHEMA(LatencySleepOp)
+    .NumInputs(0, INT_MAX)
+    .NumOutputs(0, INT_MAX)
+    .AllowInplace({{0, 0}, {1, 1}});
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  NetDef net_def;
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencySleepOp");
+    op.set_name("short");
+    op.add_input("in");
+    op.add_output("hidden");
+    auto* arg = op.add_arg();
+    arg->set_name("ms");
+    arg->set_i(1);
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("LatencySleepOp");
+    op.set_name("long");
+    op.add_input("hidden");
+    op.add_output("out");
+    auto* arg = op.add_arg();
+    arg->set_name("ms");
+    arg->set_i(20);
+  }
+  net_def.add_external_input("in");
+  net_def.add_external_output("out");
+
+  return CreateNet(net_def, ws);
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, BucketBounds) {
+  for (uint64_t nanos : {0, 1, 3, 4, 5, 7, 8, 1000, 123456, 1 << 30}) {
+    const auto index = LatencyHistogram::bucketIndex(nanos);
+    EXPECT_LE(LatencyHistogram::bucketLowerBound(index), nanos);
+    EXPECT_GT(LatencyHistogram::bucketLowerBound(index + 1), nanos);
+  }
+  // The buckets are at most a quarter of their lower bound wide.
+  const auto index = LatencyHistogram::bucketIndex(1000000);
+  EXPECT_LE(
+      LatencyHistogram::bucketLowerBound(index + 1) -
+          LatencyHistogram::bucketLowerBound(index),
+      1000000 / LatencyHistogram::kSubBuckets);
+}
+
+TEST(LatencyHistogramObserverTest, Percentiles) {
+  Workspace ws;
+  ws.CreateBlob("in");
+  unique_ptr<NetBase> net(CreateNetTestHelper(&ws));
+  auto net_ob = caffe2::make_unique<LatencyHistogramObserver>(
+      net.get(), /* sampling_period */ 2);
+  auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+  for (int i = 0; i < 6; ++i) {
+    net->Run();
+  }
+
+  const auto stats = ob->snapshot();
+  ASSERT_EQ(stats.size(), 2);
+  EXPECT_EQ(stats[0].name, "short");
+  EXPECT_EQ(stats[1].name, "long");
+  for (const auto& op_stats : stats) {
+    EXPECT_EQ(op_stats.count, 3);
+    EXPECT_LE(op_stats.p50, op_stats.p90);
+    EXPECT_LE(op_stats.p90, op_stats.p99);
+    EXPECT_LE(op_stats.p99, op_stats.max);
+  }
+  // Sleeping may take longer, but never shorter.
+  EXPECT_GE(stats[0].p50, 1000 * 0.75);
+  EXPECT_GE(stats[1].p50, 20000 * 0.75);
+  EXPECT_LT(stats[0].p50, stats[1].p50);
+
+  ob->reset();
+  EXPECT_EQ(ob->snapshot()[0].count, 0);
+}
+
+} // namespace caffe2
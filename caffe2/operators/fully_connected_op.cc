@@ -184,6 +184,9 @@ Y:
     .Arg(
         "float16_compute",
         "*(type: bool; default: False)* Whether to use float-16 compute kernel.")
+    .Arg(
+        "activation",
+        "*(type: string; default: \"\")* Activation applied to the output after adding the bias. Only \"Relu\" (on float outputs) is supported; it is set by the FC fusion passes in caffe2/opt.")
     .Input(
         0,
         "X",
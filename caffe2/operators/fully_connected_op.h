@@ -13,6 +13,22 @@
 
 namespace caffe2 {
 
+namespace fc_internal {
+
+// Applies the activation fused into FC, which is only implemented for float
+// outputs.
+template <typename T, class Context>
+void FusedRelu(const int /* N */, T* /* Y */, Context* /* context */) {
+  CAFFE_THROW("The fused Relu of FC only supports float outputs");
+}
+
+template <class Context>
+void FusedRelu(const int N, float* Y, Context* context) {
+  math::Maximum<float, Context>(N, 0.f, Y, Y, context);
+}
+
+} // namespace fc_internal
+
 // This is Caffe's InnerProductOp, with a name that fits its purpose better.
 template <
     class Context,
@@ -27,7 +43,15 @@ class FullyConnectedOp final : public Operator<Context> {
         axis_(this->template GetSingleArgument<int32_t>("axis", 1)),
         axis_w_(this->template GetSingleArgument<int32_t>("axis_w", 1)),
         float16_compute_(
-            this->template GetSingleArgument<bool>("float16_compute", false)) {}
+            this->template GetSingleArgument<bool>("float16_compute", false)) {
+    const auto activation =
+        this->template GetSingleArgument<std::string>("activation", "");
+    CAFFE_ENFORCE(
+        activation.empty() || activation == "Relu",
+        "Unsupported activation for FC: ",
+        activation);
+    fuse_relu_ = activation == "Relu";
+  }
   ~FullyConnectedOp() {}
 
   template <
@@ -180,6 +204,10 @@ class FullyConnectedOp final : public Operator<Context> {
       t_begin = std::chrono::system_clock::now();
     }
 #endif
+    if (fuse_relu_) {
+      fc_internal::FusedRelu(
+          M * N, Y->template mutable_data<T_Y>(), &context_);
+    }
     return true;
   }
 
@@ -201,6 +229,8 @@ class FullyConnectedOp final : public Operator<Context> {
   c10::optional<Tensor> bias_multiplier_;
 
   bool float16_compute_;
+  // Set by the FuseFCRelu pass of caffe2/opt
+  bool fuse_relu_;
 };
 
 template <
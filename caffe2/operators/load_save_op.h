@@ -1,8 +1,15 @@
 #ifndef CAFFE2_OPERATORS_LOAD_SAVE_OP_H_
 #define CAFFE2_OPERATORS_LOAD_SAVE_OP_H_
 
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
 
 #include "caffe2/core/blob_serialization.h"
@@ -30,6 +37,93 @@ struct BlobState {
         current_size(current_size),
         is_tensor(is_tensor) {}
 };
+
+// Runs the deserialization of db records on up to max_threads threads, which
+// are started as records come in. Run blocks while two records per thread
+// are pending, so that the records read from the db don't pile up in memory.
+// With at most one thread, Run deserializes the record right away.
+class RecordLoader {
+ public:
+  explicit RecordLoader(int max_threads) : max_threads_(max_threads) {}
+
+  ~RecordLoader() {
+    Join();
+  }
+
+  void Run(std::function<void()> task) {
+    if (max_threads_ <= 1) {
+      task();
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    has_room_.wait(lock, [this] {
+      return tasks_.size() < 2 * static_cast<size_t>(max_threads_);
+    });
+    tasks_.push_back(std::move(task));
+    if (idle_threads_ == 0 &&
+        threads_.size() < static_cast<size_t>(max_threads_)) {
+      threads_.emplace_back([this] { Work(); });
+    }
+    has_task_.notify_one();
+  }
+
+  // Waits for all records, and rethrows the first error of any of them.
+  void Wait() {
+    Join();
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  void Work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ++idle_threads_;
+      has_task_.wait(lock, [this] { return !tasks_.empty() || done_; });
+      --idle_threads_;
+      if (tasks_.empty()) {
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop_front();
+      lock.unlock();
+      has_room_.notify_one();
+      try {
+        task();
+      } catch (...) {
+        lock.lock();
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+        continue;
+      }
+      lock.lock();
+    }
+  }
+
+  void Join() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    has_task_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+    threads_.clear();
+  }
+
+  const int max_threads_;
+  std::mutex mutex_;
+  std::condition_variable has_task_;
+  std::condition_variable has_room_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  size_t idle_threads_ = 0;
+  bool done_ = false;
+  std::exception_ptr error_;
+};
 } // namespace
 
 using db::Cursor;
@@ -228,6 +322,7 @@ class LoadOp final : public Operator<Context> {
       int* total_loaded_blobs) {
     CAFFE_ENFORCE(cursor, "cursor is not valid");
     int loaded_blobs = 0;
+    RecordLoader loader(maxLoaderThreads());
     for (; cursor->Valid(); cursor->Next()) {
       const auto key = buildBlobNameFromDbKey(cursor->key());
       if (key_to_dbid_.count(key) && key_to_dbid_[key] != db_id) {
@@ -236,17 +331,11 @@ class LoadOp final : public Operator<Context> {
         key_to_dbid_[key] = db_id;
       }
 
-      BlobProto proto;
-      CAFFE_ENFORCE(
-          proto.ParseFromString(cursor->value()), "Couldn't parse Proto");
-      if (!keep_device_) {
-        // If we are not keeping the device as the one specified in the
-        // proto, we will set the current device.
-        SetCurrentDevice(&proto);
-      }
       Blob* blob = ws_->CreateBlob(key);
-      ProcessBlob(blob, proto, blob_states, key, &loaded_blobs);
+      loadRecord(
+          &loader, blob, cursor->value(), blob_states, key, &loaded_blobs);
     }
+    loader.Wait();
     *total_loaded_blobs += loaded_blobs;
   }
 
@@ -258,6 +347,7 @@ class LoadOp final : public Operator<Context> {
       int* total_loaded_blobs) {
     CAFFE_ENFORCE(cursor);
     int loaded_blobs = 0;
+    RecordLoader loader(maxLoaderThreads());
     for (; cursor->Valid(); cursor->Next()) {
       const auto key = buildBlobNameFromDbKey(cursor->key());
       if (!output_indices_.count(key)) {
@@ -270,23 +360,19 @@ class LoadOp final : public Operator<Context> {
         }
 
         VLOG(2) << "Deserializing blob " << key;
-        BlobProto proto;
-        CAFFE_ENFORCE(proto.ParseFromString(cursor->value()));
-        if (!keep_device_) {
-          // If we are not keeping the device as the one specified in the
-          // proto, we will set the current device.
-          SetCurrentDevice(&proto);
-        }
         auto blobIndex = output_indices_[key];
         Blob* blob = outputs.at(blobIndex);
-        ProcessBlob(blob, proto, blob_states, key, &loaded_blobs);
+        loadRecord(
+            &loader, blob, cursor->value(), blob_states, key, &loaded_blobs);
 
+        std::lock_guard<std::mutex> guard(blob_states_mutex_);
         if (*total_loaded_blobs + loaded_blobs == OutputSize()) {
           break;
         }
       }
     }
 
+    loader.Wait();
     *total_loaded_blobs += loaded_blobs;
   }
 
@@ -303,15 +389,55 @@ class LoadOp final : public Operator<Context> {
   }
 
  private:
-  // We are tracking sizes of already read tensor parts while reading data
-  // chunks. This way we can make sure that all chunks were loaded in the end.
-  void ProcessBlob(
+  // Records are deserialized on several threads on CPU only, since the
+  // current device of the other contexts is per thread.
+  int maxLoaderThreads() const {
+    return std::is_same<Context, CPUContext>::value
+        ? FLAGS_caffe2_max_tensor_deserializer_threads
+        : 1;
+  }
+
+  // Parses and deserializes one db record into the blob, on one of the
+  // threads of the loader. Records are parsed concurrently, and so are the
+  // copies of the tensors that allow it (see CanDeserializeTensorConcurrently),
+  // including those of the chunks of one tensor. Everything else, and the
+  // allocation of the tensors, happens under blob_states_mutex_.
+  void loadRecord(
+      RecordLoader* loader,
       Blob* blob,
-      const BlobProto& proto,
-      std::unordered_map<string, BlobState>* blob_states_ptr,
+      string value,
+      std::unordered_map<string, BlobState>* blob_states,
       const string& key,
       int* loaded_blobs) {
-    auto& blob_states = *blob_states_ptr;
+    auto record = std::make_shared<string>(std::move(value));
+    loader->Run([this, record, blob, blob_states, key, loaded_blobs] {
+      BlobProto proto;
+      CAFFE_ENFORCE(proto.ParseFromString(*record), "Couldn't parse Proto");
+      if (!keep_device_) {
+        // If we are not keeping the device as the one specified in the
+        // proto, we will set the current device.
+        SetCurrentDevice(&proto);
+      }
+      if (!CanDeserializeTensorConcurrently(proto)) {
+        std::lock_guard<std::mutex> guard(blob_states_mutex_);
+        ProcessBlob(blob, proto, blob_states, key, loaded_blobs);
+        return;
+      }
+      Tensor* tensor;
+      {
+        std::lock_guard<std::mutex> guard(blob_states_mutex_);
+        ResetNewBlob(blob, *blob_states, key);
+        tensor = BlobGetMutableTensorFromProto(blob, proto.tensor());
+        UpdateBlobState(proto, blob_states, key, loaded_blobs);
+      }
+      TensorDeserializer().DeserializeToTensor(proto.tensor(), tensor);
+    });
+  }
+
+  void ResetNewBlob(
+      Blob* blob,
+      const std::unordered_map<string, BlobState>& blob_states,
+      const string& key) {
     if (blob_states.count(key) == 0) {
       // We reset the blob so that any existing content is destroyed. This
       // is to guaranee correct device placement: if we are deserializing
@@ -320,7 +446,27 @@ class LoadOp final : public Operator<Context> {
       // different GPU.
       blob->Reset();
     }
+  }
+
+  void ProcessBlob(
+      Blob* blob,
+      const BlobProto& proto,
+      std::unordered_map<string, BlobState>* blob_states,
+      const string& key,
+      int* loaded_blobs) {
+    ResetNewBlob(blob, *blob_states, key);
     DeserializeBlob(proto, blob);
+    UpdateBlobState(proto, blob_states, key, loaded_blobs);
+  }
+
+  // We are tracking sizes of already read tensor parts while reading data
+  // chunks. This way we can make sure that all chunks were loaded in the end.
+  void UpdateBlobState(
+      const BlobProto& proto,
+      std::unordered_map<string, BlobState>* blob_states_ptr,
+      const string& key,
+      int* loaded_blobs) {
+    auto& blob_states = *blob_states_ptr;
     if (proto.has_content_num_chunks()) {
       if (!blob_states.count(key)) {
         blob_states[key] = BlobState(proto.content_num_chunks());
@@ -424,6 +570,9 @@ class LoadOp final : public Operator<Context> {
   std::map<string, int> output_indices_;
   std::map<string, int> key_to_dbid_;
   std::vector<std::string> blob_names_;
+  // Guards the blob states and the allocation of blobs while records are
+  // deserialized concurrently
+  std::mutex blob_states_mutex_;
 };
 
 template <class Context>
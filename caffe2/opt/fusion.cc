@@ -121,5 +121,143 @@ void fuseConvBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
 
 REGISTER_WS_OPT_PASS_FROM_FUNC(FuseConvBN, fuseConvBN);
 
+namespace {
+
+const caffe2::OperatorDef* getOperatorDef(const repr::NeuralNetOperator& op) {
+  const auto annotation = op.getAnnotation();
+  if (!annotation || !isa<caffe2::Caffe2Annotation>(annotation)) {
+    return nullptr;
+  }
+  return &dyn_cast<caffe2::Caffe2Annotation>(annotation)->getOperatorDef();
+}
+
+const caffe2::Argument* getArgument(
+    const caffe2::OperatorDef& op,
+    const std::string& name) {
+  for (const auto& arg : op.arg()) {
+    if (arg.name() == name) {
+      return &arg;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+// Same as fuseConvBNHelper, with the rows of the [N, K] weights of FC taking
+// the place of the output channels of the filter. The channels of BN must be
+// the last dimension of the FC output, which holds the N outputs.
+bool fuseFCBNHelper(repr::NNModule* nn, caffe2::Workspace* ws) {
+  for (auto node_pair : repr::nn::dataIterator<repr::FC>(nn->dataFlow)) {
+    repr::NNGraph::NodeRef fcNode;
+    repr::FC* fc;
+    std::tie(fc, fcNode) = node_pair;
+    NOM_REQUIRE_OR_CONT(fc->getAxisW() == 1);
+
+    auto fcOp = getOperatorDef(*fc);
+    NOM_REQUIRE_OR_CONT(fcOp != nullptr);
+    // The fused activation would have to be applied after BN.
+    NOM_REQUIRE_OR_CONT(getArgument(*fcOp, "activation") == nullptr);
+
+    auto output = repr::nn::getOutputs(fcNode).front();
+    auto consumers = repr::nn::getConsumers(output);
+    NOM_REQUIRE_OR_CONT(consumers.size() == 1);
+
+    auto bnNode = consumers.front();
+    NOM_REQUIRE_OR_CONT(repr::nn::is<repr::BatchNormalization>(bnNode));
+    auto bnOutputs = nn::getOutputs(bnNode);
+    NOM_REQUIRE_OR_CONT(bnOutputs.size() == 1);
+    auto bnOutput = bnOutputs.front();
+
+    auto bnOp = getOperatorDef(*repr::nn::get<repr::BatchNormalization>(bnNode));
+    NOM_REQUIRE_OR_CONT(bnOp != nullptr);
+    auto orderArg = getArgument(*bnOp, "order");
+    auto isNHWC = orderArg && orderArg->s() == "NHWC";
+    // In NCHW the channels are the second dimension, which is only the last
+    // one of a 2D output.
+    NOM_REQUIRE_OR_CONT(isNHWC || fc->getAxis() == 1);
+    auto epsilonArg = getArgument(*bnOp, "epsilon");
+    float epsilon = epsilonArg ? epsilonArg->f() : 1e-5f;
+
+    auto fcInputs = repr::nn::getInputs(fcNode);
+    NOM_REQUIRE_OR_CONT(fcInputs.size() == 3);
+    auto bnInputs = repr::nn::getInputs(bnNode);
+    CAFFE_ENFORCE(
+        bnInputs.size() >= 5, "Invalid batch normalization input size");
+
+#define EXPOSE_TENSOR_DATA(name, index, inputs)                                \
+  auto name = repr::nn::get<repr::Tensor>(inputs[index]);                      \
+  assert(ws->HasBlob(name->getName()) && "Blob not in workspace");             \
+  auto name##Tensor = BlobGetMutableTensor(ws->GetBlob(name->getName()), CPU); \
+  auto name##Data = name##Tensor->mutable_data<float>();
+
+    EXPOSE_TENSOR_DATA(weight, 1, fcInputs);
+    EXPOSE_TENSOR_DATA(biasFC, 2, fcInputs);
+
+    EXPOSE_TENSOR_DATA(scale, 1, bnInputs);
+    EXPOSE_TENSOR_DATA(biasBN, 2, bnInputs);
+    EXPOSE_TENSOR_DATA(mean, 3, bnInputs);
+    EXPOSE_TENSOR_DATA(variance, 4, bnInputs);
+
+#undef EXPOSE_TENSOR_DATA
+
+    const auto N = weightTensor->dim32(0);
+    NOM_REQUIRE_OR_CONT(biasFCTensor->numel() == N && scaleTensor->numel() == N);
+    const auto K = weightTensor->size_from_dim(1);
+    for (auto n = 0; n < N; ++n) {
+      float coeff = scaleData[n] / std::sqrt(varianceData[n] + epsilon);
+      for (auto k = 0; k < K; ++k) {
+        weightData[n * K + k] *= coeff;
+      }
+      biasFCData[n] = (biasFCData[n] - meanData[n]) * coeff + biasBNData[n];
+    }
+
+    nn->dataFlow.deleteNode(output);
+    nn->dataFlow.createEdge(fcNode, bnOutput);
+    nn->dataFlow.deleteNode(bnNode);
+    return true;
+  }
+  return false;
+}
+
+void fuseFCBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
+  while (fuseFCBNHelper(nn, ws)) {
+  }
+}
+
+REGISTER_WS_OPT_PASS_FROM_FUNC(FuseFCBN, fuseFCBN);
+
+void fuseFCRelu(repr::NNModule* nn) {
+  auto should_fuse = [](const repr::FC& fc) {
+    const auto op = getOperatorDef(fc);
+    if (!op || op->type() != "FC" || getArgument(*op, "activation")) {
+      return false;
+    }
+    // Other engines (e.g. the quantized ones) don't read the activation.
+    if (!op->engine().empty() && op->engine() != "TENSORCORE") {
+      return false;
+    }
+    const auto deviceType = op->device_option().device_type();
+    return deviceType == caffe2::PROTO_CPU || deviceType == caffe2::PROTO_CUDA;
+  };
+
+  auto postprocess = [](repr::NNGraph::NodeRef fc_node) {
+    auto fc = repr::nn::get<repr::FC>(fc_node);
+    auto annotation = fc->getMutableAnnotation();
+    if (!annotation || !isa<caffe2::Caffe2Annotation>(annotation)) {
+      return;
+    }
+    auto* op =
+        dyn_cast<caffe2::Caffe2Annotation>(annotation)->getMutableOperatorDef();
+    auto* arg = op->add_arg();
+    arg->set_name("activation");
+    arg->set_s("Relu");
+  };
+
+  fuseActivation<repr::FC, repr::Relu>(nn, should_fuse, postprocess);
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseFCRelu, fuseFCRelu);
+
 } // namespace opt
 } // namespace caffe2
@@ -26,6 +26,11 @@ namespace opt {
 using namespace nom;
 
 CAFFE2_API void fuseConvBN(repr::NNModule* nn, caffe2::Workspace* ws);
+// Folds a BatchNormalization into the weights and bias of the preceding FC.
+CAFFE2_API void fuseFCBN(repr::NNModule* nn, caffe2::Workspace* ws);
+// Fuses a Relu into the preceding FC on CPU and CUDA, through its
+// "activation" argument.
+CAFFE2_API void fuseFCRelu(repr::NNModule* nn);
 
 // Generic activation fusion helper.
 //
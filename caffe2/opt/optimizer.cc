@@ -11,6 +11,9 @@ void workspaceOptimizations(nom::repr::NNModule* nn, Workspace* ws, int level) {
   switch (level) {
     case 1:
       opt::fuseConvBN(nn, ws);
+      opt::fuseFCBN(nn, ws);
+      // Runs again, since BN might have separated FC from Relu.
+      opt::fuseFCRelu(nn);
     case 0:
     default:
       break;
@@ -24,6 +27,7 @@ void graphOptimzations(nom::repr::NNModule* nn, int level) {
       opt::addNNPACK(nn, false);
       opt::fuseNNPACKConvRelu(nn);
 #endif
+      opt::fuseFCRelu(nn);
     case 0:
     default:
       break;
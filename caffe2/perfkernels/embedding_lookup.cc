@@ -1,11 +1,25 @@
 #include "caffe2/perfkernels/embedding_lookup.h"
 
+#include "caffe2/core/flags.h"
 #include "caffe2/core/types.h"
 #include "caffe2/perfkernels/common.h"
+#include "caffe2/perfkernels/embedding_lookup_sorted_gather.h"
 #include "caffe2/perfkernels/typed_axpy.h"
 #include "caffe2/utils/eigen_utils.h"
 #include "caffe2/utils/math.h"
 
+C10_DEFINE_int64(
+    caffe2_embedding_lookup_prefetch_distance,
+    16,
+    "The number of indices the embedding lookup kernels prefetch rows ahead.");
+C10_DEFINE_bool(
+    caffe2_embedding_lookup_sorted_gather,
+    false,
+    "If set, the embedding lookups gather the rows in the order of their "
+    "indices, reading every distinct row once, which helps with large tables "
+    "and repeated indices. The results only differ by the order of the "
+    "additions.");
+
 namespace caffe2 {
 
 /**
@@ -28,6 +42,7 @@ static bool EmbeddingLookupGenericSlow(
     const float* weights, // optional, can be null for sum reducer
     const float* scale_bias, // optional scale & bias params for uint8 input
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     OutType* out) {
   int64_t current = 0;
   for (int m = 0; m < output_size; ++m) {
@@ -42,8 +57,9 @@ static bool EmbeddingLookupGenericSlow(
         return false;
       }
 #ifdef __GNUC__
-      if (current + 1 < index_size) {
-        __builtin_prefetch(input + block_size * indices[current + 1], 0, 1);
+      if (current + prefetch_distance < index_size) {
+        __builtin_prefetch(
+            input + block_size * indices[current + prefetch_distance], 0, 1);
       }
 #endif // __GNUC__
 
@@ -90,6 +106,7 @@ static bool EmbeddingLookupGenericSlow(
           const float* weights,                                                                    \
           const float* scale_bias,                                                                 \
           bool normalize_by_lengths,                                                               \
+          const int64_t prefetch_distance,                                                         \
           OutType* out) {                                                                          \
     return EmbeddingLookupGenericSlow<                                                             \
         IndexType,                                                                                 \
@@ -106,11 +123,15 @@ static bool EmbeddingLookupGenericSlow(
         weights,                                                                                   \
         scale_bias,                                                                                \
         normalize_by_lengths,                                                                      \
+        prefetch_distance,                                                                         \
         out);                                                                                      \
   }                                                                                                \
   decltype(                                                                                        \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx2_fma; \
+  decltype(                                                                                        \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__base)     \
+      EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL##__avx512;   \
   bool                                                                                             \
       EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL(             \
           const int64_t block_size,                                                                \
@@ -123,12 +144,30 @@ static bool EmbeddingLookupGenericSlow(
           const float* weights,                                                                    \
           const float* scale_bias,                                                                 \
           bool normalize_by_lengths,                                                               \
+          const int64_t prefetch_distance,                                                         \
           OutType* out) {                                                                          \
     if (std::is_same<InType, uint8_t>::value) {                                                    \
       CAFFE_ENFORCE(scale_bias != nullptr, "scale_bias must not be nullptr");                      \
     } else {                                                                                       \
       CAFFE_ENFORCE(scale_bias == nullptr, "scale_bias must be nullptr");                          \
     }                                                                                              \
+    /* The AVX-512 kernels have no vector loop for the rest of a row. */                           \
+    if (block_size % 16 == 0) {                                                                    \
+      AVX512_DO(                                                                                   \
+          EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,         \
+          block_size,                                                                              \
+          output_size,                                                                             \
+          index_size,                                                                              \
+          data_size,                                                                               \
+          input,                                                                                   \
+          indices,                                                                                 \
+          lengths,                                                                                 \
+          weights,                                                                                 \
+          scale_bias,                                                                              \
+          normalize_by_lengths,                                                                    \
+          prefetch_distance,                                                                       \
+          out);                                                                                    \
+    }                                                                                              \
     AVX2_FMA_DO(                                                                                   \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
         block_size,                                                                                \
@@ -141,6 +180,7 @@ static bool EmbeddingLookupGenericSlow(
         weights,                                                                                   \
         scale_bias,                                                                                \
         normalize_by_lengths,                                                                      \
+        prefetch_distance,                                                                         \
         out);                                                                                      \
     BASE_DO(                                                                                       \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL,           \
@@ -154,6 +194,7 @@ static bool EmbeddingLookupGenericSlow(
         weights,                                                                                   \
         scale_bias,                                                                                \
         normalize_by_lengths,                                                                      \
+        prefetch_distance,                                                                         \
         out);                                                                                      \
   }                                                                                                \
   template <>                                                                                      \
@@ -169,6 +210,34 @@ static bool EmbeddingLookupGenericSlow(
       const float* scale_bias,                                                                     \
       bool normalize_by_lengths,                                                                   \
       OutType* out) {                                                                              \
+    if (FLAGS_caffe2_embedding_lookup_sorted_gather &&                                             \
+        EmbeddingLookupSortedGather<IndexType, IS_WEIGHT_POSITIONAL>(                              \
+            block_size,                                                                            \
+            output_size,                                                                           \
+            index_size,                                                                            \
+            data_size,                                                                             \
+            input,                                                                                 \
+            block_size * sizeof(InType),                                                           \
+            indices,                                                                               \
+            lengths,                                                                               \
+            weights,                                                                               \
+            normalize_by_lengths,                                                                  \
+            FLAGS_caffe2_embedding_lookup_prefetch_distance,                                       \
+            out,                                                                                   \
+            [=](IndexType idx, float* row) {                                                       \
+              std::memset(row, 0, sizeof(float) * block_size);                                     \
+              TypedAxpy<InType, float>(                                                            \
+                  block_size, 1.f, input + block_size * idx, row);                                 \
+              if (scale_bias) {                                                                    \
+                const float scale = scale_bias[2 * idx];                                           \
+                const float bias = scale_bias[2 * idx + 1];                                        \
+                for (int64_t j = 0; j < block_size; ++j) {                                         \
+                  row[j] = row[j] * scale + bias;                                                  \
+                }                                                                                  \
+              }                                                                                    \
+            })) {                                                                                  \
+      return;                                                                                      \
+    }                                                                                              \
     bool success =                                                                                 \
         EmbeddingLookup_##IndexType##_##InTypeName##_##OutType##_##IS_WEIGHT_POSITIONAL(           \
             block_size,                                                                            \
@@ -181,6 +250,7 @@ static bool EmbeddingLookupGenericSlow(
             weights,                                                                               \
             scale_bias,                                                                            \
             normalize_by_lengths,                                                                  \
+            FLAGS_caffe2_embedding_lookup_prefetch_distance,                                       \
             out);                                                                                  \
     if (success) {                                                                                 \
       return;                                                                                      \
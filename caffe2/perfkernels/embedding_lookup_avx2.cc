@@ -21,8 +21,10 @@ static bool EmbeddingLookup_int32_t_float_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -396,6 +398,7 @@ bool EmbeddingLookup_int32_t_float_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_float_float__avx2_fma<false>(
       block_size,
@@ -408,6 +411,7 @@ bool EmbeddingLookup_int32_t_float_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int32_t_float_float_true__avx2_fma(
@@ -421,6 +425,7 @@ bool EmbeddingLookup_int32_t_float_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_float_float__avx2_fma<true>(
       block_size,
@@ -433,6 +438,7 @@ bool EmbeddingLookup_int32_t_float_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -448,8 +454,10 @@ static bool EmbeddingLookup_int64_t_float_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -823,6 +831,7 @@ bool EmbeddingLookup_int64_t_float_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_float_float__avx2_fma<false>(
       block_size,
@@ -835,6 +844,7 @@ bool EmbeddingLookup_int64_t_float_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int64_t_float_float_true__avx2_fma(
@@ -848,6 +858,7 @@ bool EmbeddingLookup_int64_t_float_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_float_float__avx2_fma<true>(
       block_size,
@@ -860,6 +871,7 @@ bool EmbeddingLookup_int64_t_float_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -875,8 +887,10 @@ static bool EmbeddingLookup_int32_t_half_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -1370,6 +1384,7 @@ bool EmbeddingLookup_int32_t_half_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_half_float__avx2_fma<false>(
       block_size,
@@ -1382,6 +1397,7 @@ bool EmbeddingLookup_int32_t_half_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int32_t_half_float_true__avx2_fma(
@@ -1395,6 +1411,7 @@ bool EmbeddingLookup_int32_t_half_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_half_float__avx2_fma<true>(
       block_size,
@@ -1407,6 +1424,7 @@ bool EmbeddingLookup_int32_t_half_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -1422,8 +1440,10 @@ static bool EmbeddingLookup_int64_t_half_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -1917,6 +1937,7 @@ bool EmbeddingLookup_int64_t_half_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_half_float__avx2_fma<false>(
       block_size,
@@ -1929,6 +1950,7 @@ bool EmbeddingLookup_int64_t_half_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int64_t_half_float_true__avx2_fma(
@@ -1942,6 +1964,7 @@ bool EmbeddingLookup_int64_t_half_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_half_float__avx2_fma<true>(
       block_size,
@@ -1954,6 +1977,7 @@ bool EmbeddingLookup_int64_t_half_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -1969,8 +1993,10 @@ static bool EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -2477,6 +2503,7 @@ bool EmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_uint8_t_float__avx2_fma<false>(
       block_size,
@@ -2489,6 +2516,7 @@ bool EmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
@@ -2502,6 +2530,7 @@ bool EmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int32_t_uint8_t_float__avx2_fma<true>(
       block_size,
@@ -2514,6 +2543,7 @@ bool EmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -2529,8 +2559,10 @@ static bool EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -3037,6 +3069,7 @@ bool EmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_uint8_t_float__avx2_fma<false>(
       block_size,
@@ -3049,6 +3082,7 @@ bool EmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool EmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
@@ -3062,6 +3096,7 @@ bool EmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
     const float* weights,
     const float* scale_bias,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return EmbeddingLookup_int64_t_uint8_t_float__avx2_fma<true>(
       block_size,
@@ -3074,6 +3109,7 @@ bool EmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
       weights,
       scale_bias,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
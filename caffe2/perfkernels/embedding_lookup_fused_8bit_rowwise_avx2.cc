@@ -20,8 +20,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 2;
   int dataInd = 0;
   if (block_size == 128) {
@@ -394,6 +396,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma<false>(
       block_size,
@@ -405,6 +408,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_true__avx2_fma(
@@ -417,6 +421,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma<true>(
       block_size,
@@ -428,6 +433,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -442,8 +448,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 2;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -816,6 +824,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma<false>(
       block_size,
@@ -827,6 +836,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_true__avx2_fma(
@@ -839,6 +849,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma<true>(
       block_size,
@@ -850,6 +861,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -864,8 +876,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 4;
   int dataInd = 0;
   if (block_size == 128) {
@@ -1358,6 +1372,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx2_fma<false>(
       block_size,
@@ -1369,6 +1384,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_true__avx2_fma(
@@ -1381,6 +1397,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx2_fma<true>(
       block_size,
@@ -1392,6 +1409,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -1406,8 +1424,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 4;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -1900,6 +1920,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx2_fma<false>(
       block_size,
@@ -1911,6 +1932,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_true__avx2_fma(
@@ -1923,6 +1945,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx2_fma<true>(
       block_size,
@@ -1934,6 +1957,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -1948,8 +1972,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int>(prefetch_distance) : 0;
   const int fused_block_size = block_size + 8;
   int dataInd = 0;
   if (block_size == 128) {
@@ -2465,6 +2491,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<false>(
       block_size,
@@ -2476,6 +2503,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
@@ -2488,6 +2516,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<true>(
       block_size,
@@ -2499,6 +2528,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
@@ -2513,8 +2543,10 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 =
+      prefetch_distance > 0 ? static_cast<int64_t>(prefetch_distance) : 0;
   const int64_t fused_block_size = block_size + 8;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -3030,6 +3062,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<false>(
       block_size,
@@ -3041,6 +3074,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
@@ -3053,6 +3087,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
     const int* lengths,
     const float* weights,
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     float* out) {
   return Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<true>(
       block_size,
@@ -3064,6 +3099,7 @@ bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
       lengths,
       weights,
       normalize_by_lengths,
+      prefetch_distance,
       out);
 }
 
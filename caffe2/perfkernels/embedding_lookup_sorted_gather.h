@@ -0,0 +1,113 @@
+#pragma once
+
+// Only included by the common (non-AVX) files of the embedding lookups.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "caffe2/perfkernels/typed_axpy.h"
+
+namespace caffe2 {
+
+/**
+ * Embedding lookup that reads the rows in the order of their indices instead
+ * of the order of the segments, and reads every distinct row only once.
+ *
+ * The (index, position) pairs are sorted, so that the rows of a large table
+ * are gathered in increasing address order, where the hardware prefetcher and
+ * the prefetches `prefetch_distance` rows ahead can keep up, and the rows used
+ * by several positions are loaded (and dequantized) once. Every row is then
+ * added to the segments that use it, so the output keeps the order of the
+ * segments. The output differs from the segment order lookup only by the
+ * order of the floating point additions.
+ *
+ * `load_row(idx, row)` writes the row `idx` of the table as `block_size`
+ * floats to `row`, and `input + idx * row_bytes` is the address of the row.
+ *
+ * @return false if the lengths or the indices are out of bounds
+ */
+template <typename IndexType, bool IS_WEIGHT_POSITIONAL, typename LoadRow>
+bool EmbeddingLookupSortedGather(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const void* input,
+    const int64_t row_bytes,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    const int64_t prefetch_distance,
+    float* out,
+    LoadRow load_row) {
+  // The segment of every position, and the position within the segment.
+  std::vector<int> segments(index_size);
+  std::vector<int> offsets(IS_WEIGHT_POSITIONAL ? index_size : 0);
+  int64_t current = 0;
+  for (int m = 0; m < output_size; ++m) {
+    if (lengths[m] < 0 || current + lengths[m] > index_size) {
+      return false;
+    }
+    for (int i = 0; i < lengths[m]; ++i, ++current) {
+      segments[current] = m;
+      if (IS_WEIGHT_POSITIONAL) {
+        offsets[current] = i;
+      }
+    }
+  }
+  if (current != index_size) {
+    return false;
+  }
+
+  std::vector<std::pair<IndexType, int64_t>> order(index_size);
+  for (int64_t pos = 0; pos < index_size; ++pos) {
+    if (indices[pos] < 0 || indices[pos] >= data_size) {
+      return false;
+    }
+    order[pos] = std::make_pair(indices[pos], pos);
+  }
+  std::sort(order.begin(), order.end());
+
+  std::fill(out, out + output_size * block_size, 0.f);
+  std::vector<float> row(block_size);
+  for (int64_t k = 0; k < index_size;) {
+    const IndexType idx = order[k].first;
+#ifdef __GNUC__
+    if (k + prefetch_distance < index_size) {
+      __builtin_prefetch(
+          static_cast<const char*>(input) +
+              row_bytes * order[k + prefetch_distance].first,
+          0,
+          1);
+    }
+#endif // __GNUC__
+    load_row(idx, row.data());
+    for (; k < index_size && order[k].first == idx; ++k) {
+      const int64_t pos = order[k].second;
+      const float weight = weights
+          ? weights[IS_WEIGHT_POSITIONAL ? offsets[pos] : pos]
+          : 1.f;
+      TypedAxpy<float, float>(
+          block_size, weight, row.data(), out + segments[pos] * block_size);
+    }
+  }
+
+  if (normalize_by_lengths) {
+    for (int m = 0; m < output_size; ++m) {
+      if (lengths[m]) {
+        const float len_inv = 1.f / lengths[m];
+        float* op = out + m * block_size;
+        for (int64_t j = 0; j < block_size; ++j) {
+          op[j] *= len_inv;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace caffe2
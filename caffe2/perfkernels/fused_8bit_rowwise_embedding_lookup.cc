@@ -1,12 +1,17 @@
 #include "caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h"
 
+#include "caffe2/core/flags.h"
 #include "caffe2/core/types.h"
 #include "caffe2/perfkernels/common.h"
+#include "caffe2/perfkernels/embedding_lookup_sorted_gather.h"
 #include "caffe2/perfkernels/typed_axpy.h"
 #include "caffe2/utils/cpuid.h"
 #include "caffe2/utils/eigen_utils.h"
 #include "caffe2/utils/math.h"
 
+C10_DECLARE_int64(caffe2_embedding_lookup_prefetch_distance);
+C10_DECLARE_bool(caffe2_embedding_lookup_sorted_gather);
+
 namespace caffe2 {
 
 /**
@@ -28,6 +33,7 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
     const int* lengths,
     const float* weights, // optional, can be null for sum reducer
     bool normalize_by_lengths,
+    const int64_t prefetch_distance,
     OutType* out) {
   // block_size is the number of elements and fused_block_size is the size of
   // an entire row, including scale and bias.
@@ -46,9 +52,11 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         return false;
       }
 #ifdef __GNUC__
-      if (current + 1 < index_size) {
+      if (current + prefetch_distance < index_size) {
         __builtin_prefetch(
-            input + fused_block_size * indices[current + 1], 0, 1);
+            input + fused_block_size * indices[current + prefetch_distance],
+            0,
+            1);
       }
 #endif // __GNUC__
 
@@ -92,6 +100,7 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
           const int* lengths,                                                            \
           const float* weights,                                                          \
           bool normalize_by_lengths,                                                     \
+          const int64_t prefetch_distance,                                               \
           OutType* out) {                                                                \
     return Fused8BitRowwiseEmbeddingLookupGenericSlow<                                   \
         IndexType,                                                                       \
@@ -107,11 +116,15 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         lengths,                                                                         \
         weights,                                                                         \
         normalize_by_lengths,                                                            \
+        prefetch_distance,                                                               \
         out);                                                                            \
   }                                                                                      \
   decltype(                                                                              \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
+  decltype(                                                                              \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx512;   \
   bool Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(                  \
       const int64_t block_size,                                                          \
       const int64_t output_size,                                                         \
@@ -122,12 +135,29 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
       const int* lengths,                                                                \
       const float* weights,                                                              \
       bool normalize_by_lengths,                                                         \
+      const int64_t prefetch_distance,                                                   \
       OutType* out) {                                                                    \
     const int32_t one = 1;                                                               \
     CAFFE_ENFORCE_EQ(                                                                    \
         reinterpret_cast<const uint8_t*>(&one)[0],                                       \
         1,                                                                               \
         "Fused8BitRowwiseEmbeddingLookup is not supported on this platform");            \
+    /* The AVX-512 kernels have no vector loop for the rest of a row. */                 \
+    if (block_size % 16 == 0) {                                                          \
+      AVX512_DO(                                                                         \
+          Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,       \
+          block_size,                                                                    \
+          output_size,                                                                   \
+          index_size,                                                                    \
+          data_size,                                                                     \
+          input,                                                                         \
+          indices,                                                                       \
+          lengths,                                                                       \
+          weights,                                                                       \
+          normalize_by_lengths,                                                          \
+          prefetch_distance,                                                             \
+          out);                                                                          \
+    }                                                                                    \
     AVX2_FMA_DO(                                                                         \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                      \
@@ -139,6 +169,7 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         lengths,                                                                         \
         weights,                                                                         \
         normalize_by_lengths,                                                            \
+        prefetch_distance,                                                               \
         out);                                                                            \
     BASE_DO(                                                                             \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
@@ -151,6 +182,7 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         lengths,                                                                         \
         weights,                                                                         \
         normalize_by_lengths,                                                            \
+        prefetch_distance,                                                               \
         out);                                                                            \
   }                                                                                      \
   template <>                                                                            \
@@ -165,6 +197,33 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
       const float* weights,                                                              \
       bool normalize_by_lengths,                                                         \
       OutType* out) {                                                                    \
+    if (FLAGS_caffe2_embedding_lookup_sorted_gather &&                                   \
+        EmbeddingLookupSortedGather<IndexType, false>(                                   \
+            block_size,                                                                  \
+            output_size,                                                                 \
+            index_size,                                                                  \
+            data_size,                                                                   \
+            input,                                                                       \
+            block_size + 8,                                                              \
+            indices,                                                                     \
+            lengths,                                                                     \
+            weights,                                                                     \
+            normalize_by_lengths,                                                        \
+            FLAGS_caffe2_embedding_lookup_prefetch_distance,                             \
+            out,                                                                         \
+            [=](IndexType idx, float* row) {                                             \
+              const uint8_t* input_row = input + (block_size + 8) * idx;                 \
+              const float* scale_bias =                                                  \
+                  reinterpret_cast<const float*>(input_row + block_size);                \
+              std::memset(row, 0, sizeof(float) * block_size);                           \
+              TypedAxpy<uint8_t, float>(                                                 \
+                  block_size, scale_bias[0], input_row, row);                            \
+              for (int64_t j = 0; j < block_size; ++j) {                                 \
+                row[j] += scale_bias[1];                                                 \
+              }                                                                          \
+            })) {                                                                        \
+      return;                                                                            \
+    }                                                                                    \
     bool success =                                                                       \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(                 \
             block_size,                                                                  \
@@ -176,6 +235,7 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
             lengths,                                                                     \
             weights,                                                                     \
             normalize_by_lengths,                                                        \
+            FLAGS_caffe2_embedding_lookup_prefetch_distance,                             \
             out);                                                                        \
     if (success) {                                                                       \
       return;                                                                            \
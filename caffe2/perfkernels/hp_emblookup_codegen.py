@@ -6,6 +6,59 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# The vector type, the number of floats per vector and the intrinsics of every
+# instruction set. load_half and load_uint8 are the conversion to floats, the
+# load of `width` elements, and the pointer type of the load.
+isas = {
+    "avx2": {
+        "suffix": "__avx2_fma",
+        "vec": "__m256",
+        "width": 8,
+        "zero": "_mm256_setzero_ps()",
+        "set1": "_mm256_set1_ps",
+        "fmadd": "_mm256_fmadd_ps",
+        "add": "_mm256_add_ps",
+        "mul": "_mm256_mul_ps",
+        "loadu": "_mm256_loadu_ps",
+        "storeu": "_mm256_storeu_ps",
+        "load_half": ("_mm256_cvtph_ps(", "_mm_loadu_si128(", "__m128i"),
+        "load_uint8": (
+            "_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(",
+            "_mm_loadl_epi64(",
+            "__m128i",
+        ),
+    },
+    "avx512": {
+        "suffix": "__avx512",
+        "vec": "__m512",
+        "width": 16,
+        "zero": "_mm512_setzero_ps()",
+        "set1": "_mm512_set1_ps",
+        "fmadd": "_mm512_fmadd_ps",
+        "add": "_mm512_add_ps",
+        "mul": "_mm512_mul_ps",
+        "loadu": "_mm512_loadu_ps",
+        "storeu": "_mm512_storeu_ps",
+        "load_half": ("_mm512_cvtph_ps(", "_mm256_loadu_si256(", "__m256i"),
+        "load_uint8": (
+            "_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(",
+            "_mm_loadu_si128(",
+            "__m128i",
+        ),
+    },
+}
+
+
+def load(isa, InType, ptr, generic):
+    convert, load, pointer_type = isa[
+        "load_half" if InType == "at::Half" else "load_uint8"
+    ]
+    cast = "reinterpret_cast<const {}*>({})".format(pointer_type, ptr)
+    close = ")" * (convert.count("(") + load.count("("))
+    if generic:
+        return convert + load + "\n                      " + cast + close
+    return convert + "\n                " + load + cast + close
+
 
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     def compute(regid, InType, use_weights, isa, prefetch):
@@ -13,24 +66,35 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
 
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s(vwgt, %s(ip + (%d)), vop%d);"  # noqa
+                % (regid, isa["fmadd"], isa["loadu"], regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s,\n"
+                "            vop%d);"
+                % (
+                    regid,
+                    isa["fmadd"],
+                    load(isa, InType, "ip + (%d)" % regid, False),
+                    regid,
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s,\n"
+                "            %s(vop%d, vbio));"
+                % (
+                    regid,
+                    isa["fmadd"],
+                    load(isa, InType, "ip + (%d)" % regid, False),
+                    isa["add"],
+                    regid,
+                )
             )
         else:
             assert False
@@ -57,8 +121,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     )
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa["width"] * i
+        code.append(
+            "      " + isa["vec"] + " vop" + str(j) + " = " + isa["zero"] + ";"
+        )
 
     # inner loop
     code.append(
@@ -96,7 +162,9 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append(
+            "        " + isa["vec"] + " vbio = " + isa["set1"] + "(bio);"
+        )
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -104,7 +172,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa["vec"] + " vwgt = " + isa["set1"] + "(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -126,7 +194,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     )
 
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         cachelinesize = 64
         byteoffset = sizeof[InType] * j
         prefetch = (byteoffset % cachelinesize) == 0
@@ -135,17 +203,29 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
 
     code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa["width"] * i
+        code.append(
+            "        " + isa["storeu"] + "(&op[" + str(j) + "], vop" + str(j) + ");"
+        )
     code.append("      } else {")
     # inv of length
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+    code.append(
+        "        "
+        + isa["vec"]
+        + " vlen_inv = "
+        + isa["set1"]
+        + "(1.0f / lengths[rangeIndex]);"
+    )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         code.append(
-            "        _mm256_storeu_ps(&op["
+            "        "
+            + isa["storeu"]
+            + "(&op["
             + str(j)
-            + "], _mm256_mul_ps("
+            + "], "
+            + isa["mul"]
+            + "("
             + "vop"
             + str(j)
             + ", vlen_inv));"
@@ -161,30 +241,42 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s(\n"
+                "                  vwgt, %s(&ip[j]), %s(&op[j])));"  # noqa
+                % (isa["storeu"], isa["fmadd"], isa["loadu"], isa["loadu"])
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  %s,\n"
+                "                  %s(&op[j])));"
+                % (
+                    isa["storeu"],
+                    isa["fmadd"],
+                    load(isa, InType, "&ip[j]", True),
+                    isa["loadu"],
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  %s,\n"
+                "                  %s(%s(&op[j]), vbio)));"
+                % (
+                    isa["storeu"],
+                    isa["fmadd"],
+                    load(isa, InType, "&ip[j]", True),
+                    isa["add"],
+                    isa["loadu"],
+                )
             )
         else:
             assert False
@@ -208,8 +300,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
+    code.append(
+        "        {}(op + j, {});".format(isa["storeu"], isa["zero"])
+    )
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -251,7 +347,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append(
+            "        " + isa["vec"] + " vbio = " + isa["set1"] + "(bio);"
+        )
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -259,7 +357,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        " + isa["vec"] + " vwgt = " + isa["set1"] + "(wgt);")
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -281,7 +379,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -306,12 +406,18 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
     code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append(
+        "        " + isa["vec"] + " vlen_inv = " + isa["set1"] + "(len_inv);"
+    )
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
+    code.append(
+        "          {}(\n"
+        "              &op[j], {}({}(&op[j]), vlen_inv));".format(
+            isa["storeu"], isa["mul"], isa["loadu"]
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -328,13 +434,15 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
 opts = parser.parse_args()
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
-    filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+    filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
-    filename = "embedding_lookup_avx2.cc"
+    filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -366,7 +474,7 @@ for o in options:
     fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
         prefix, IndexTypeName, InTypeName, OutTypeName
     )
-    suffix = "__avx2_fma"
+    suffix = isa["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -382,10 +490,16 @@ for o in options:
     if not opts.fused:
         args.append("    const float* scale_bias,")
     args.append("    bool normalize_by_lengths,")
+    args.append("    const int64_t prefetch_distance,")
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const {} prefdist_T0 =\n"
+        "      prefetch_distance > 0 ? static_cast<{}>(prefetch_distance) : 0;".format(
+            IndexType, IndexType
+        )
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -396,17 +510,22 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused)
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // isa["width"],
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
@@ -427,6 +546,7 @@ for o in options:
         if not opts.fused:
             code.append("      scale_bias,")
         code.append("      normalize_by_lengths,")
+        code.append("      prefetch_distance,")
         code.append("      out);")
         code.append("}")
 
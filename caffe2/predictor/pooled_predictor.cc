@@ -0,0 +1,201 @@
+#include "caffe2/predictor/pooled_predictor.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "caffe2/core/scope_guard.h"
+
+namespace caffe2 {
+
+PooledPredictor::PooledPredictor(
+    const NetDef& init_net,
+    const NetDef& run_net,
+    Workspace* parent,
+    bool run_init,
+    int optimization)
+    : PooledPredictor(makePredictorConfig(
+          init_net,
+          run_net,
+          parent,
+          run_init,
+          optimization)) {}
+
+PooledPredictor::PooledPredictor(PredictorConfig config, size_t num_instances)
+    : config_(std::move(config)) {
+  const auto& net = *config_.predict_net;
+  // Instances only ever read the parameters, which is what makes it safe to
+  // share them between concurrent requests.
+  for (const auto& op : net.op()) {
+    for (const auto& output : op.output()) {
+      const bool is_input = std::find(
+                                net.external_input().begin(),
+                                net.external_input().end(),
+                                output) != net.external_input().end();
+      CAFFE_ENFORCE(
+          !config_.ws->HasBlob(output) || is_input,
+          "Operator ",
+          op.type(),
+          " writes to parameter ",
+          output,
+          ", parameters of a PooledPredictor have to be read-only");
+    }
+  }
+
+  std::vector<std::unique_ptr<Instance>> instances;
+  for (size_t i = 0; i < num_instances; ++i) {
+    instances.push_back(createInstance());
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_instances_ = instances.size();
+  free_instances_ = std::move(instances);
+}
+
+PooledPredictor::~PooledPredictor() {
+  // instances have to be destroyed before the workspace they refer to
+  free_instances_.clear();
+}
+
+size_t PooledPredictor::num_instances() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_instances_;
+}
+
+std::unique_ptr<PooledPredictor::Instance> PooledPredictor::createInstance()
+    const {
+  const auto& net = *config_.predict_net;
+  const std::unordered_set<std::string> input_names{
+      config_.input_names.begin(), config_.input_names.end()};
+  auto instance = caffe2::make_unique<Instance>();
+  instance->ws = caffe2::make_unique<Workspace>(config_.ws.get());
+  for (const auto& name : net.external_input()) {
+    // Anything the parameter workspace has is a parameter, unless it is
+    // declared as an input of the model.
+    if (config_.ws->HasBlob(name) && !input_names.count(name)) {
+      continue;
+    }
+    auto* blob = instance->ws->CreateLocalBlob(name);
+    BlobGetMutableTensor(blob, CPU);
+    instance->inputs.emplace(name, blob);
+  }
+  instance->net = instance->ws->CreateNet(config_.predict_net);
+  CAFFE_ENFORCE(instance->net, "Failed to create net ", net.name());
+  return instance;
+}
+
+std::unique_ptr<PooledPredictor::Instance> PooledPredictor::acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_instances_.empty()) {
+      auto instance = std::move(free_instances_.back());
+      free_instances_.pop_back();
+      return instance;
+    }
+  }
+  // created without holding the lock, creating a net can be slow
+  auto instance = createInstance();
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++num_instances_;
+  return instance;
+}
+
+void PooledPredictor::release(std::unique_ptr<Instance> instance) {
+  // don't keep the inputs of the request alive while the instance is unused
+  for (auto& input : instance->inputs) {
+    BlobSetTensor(input.second, Tensor(CPU));
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_instances_.push_back(std::move(instance));
+}
+
+void PooledPredictor::setInput(
+    Instance& instance,
+    const std::string& name,
+    const Tensor& t) const {
+  auto it = instance.inputs.find(name);
+  CAFFE_ENFORCE(
+      it != instance.inputs.end(),
+      "Input can't be found: ",
+      name,
+      " (parameters of a PooledPredictor can't be fed)");
+  // This is evil and shares the same underlying tensor
+  BlobSetTensor(it->second, t.UnsafeSharedInstance());
+}
+
+TensorCPU PooledPredictor::takeOutput(
+    Instance& instance,
+    const std::string& name) const {
+  auto* blob = instance.ws->GetBlob(name);
+  CAFFE_ENFORCE(blob, "Blob: ", name, " does not exist");
+  CAFFE_ENFORCE(
+      BlobIsTensorType(*blob, CPU), "Blob is not a CPU Tensor: ", name);
+  auto output = BlobGetMutableTensor(blob, CPU)->UnsafeSharedInstance();
+  // Outputs produced by the net are handed over to the caller, the next
+  // request running in this instance writes into a new tensor. Inputs and
+  // parameters are never written to, so they can be shared as they are.
+  if (!instance.inputs.count(name) && !config_.ws->HasBlob(name)) {
+    BlobSetTensor(blob, Tensor(CPU));
+  }
+  return output;
+}
+
+bool PooledPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  const auto& net = *config_.predict_net;
+  CAFFE_ENFORCE(
+      inputs.size() <= static_cast<unsigned>(net.external_input_size()));
+  auto instance = acquire();
+  auto guard = MakeGuard([&] { release(std::move(instance)); });
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    setInput(*instance, net.external_input(i), inputs[i]);
+  }
+  if (!instance->net->Run()) {
+    return false;
+  }
+  outputs->clear();
+  for (const auto& name : net.external_output()) {
+    outputs->push_back(takeOutput(*instance, name));
+  }
+  return true;
+}
+
+bool PooledPredictor::operator()(
+    const TensorMap& inputs,
+    TensorList* outputs) {
+  if (!config_.input_names.empty()) {
+    CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
+  }
+  auto instance = acquire();
+  auto guard = MakeGuard([&] { release(std::move(instance)); });
+  for (const auto& input : inputs) {
+    setInput(*instance, input.first, input.second);
+  }
+  if (!instance->net->Run()) {
+    return false;
+  }
+  outputs->clear();
+  for (const auto& name : config_.predict_net->external_output()) {
+    outputs->push_back(takeOutput(*instance, name));
+  }
+  return true;
+}
+
+bool PooledPredictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
+  if (!config_.input_names.empty()) {
+    CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
+  }
+  auto instance = acquire();
+  auto guard = MakeGuard([&] { release(std::move(instance)); });
+  for (const auto& input : inputs) {
+    setInput(*instance, input.first, input.second);
+  }
+  if (!instance->net->Run()) {
+    return false;
+  }
+  for (const std::string& name : output_names()) {
+    outputs->emplace(name, takeOutput(*instance, name));
+  }
+  return true;
+}
+
+} // namespace caffe2
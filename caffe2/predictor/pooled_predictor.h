@@ -0,0 +1,99 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "caffe2/core/net.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+/**
+ * A predictor that serves concurrent requests with a single copy of the
+ * parameters.
+ *
+ * The parameters live in the workspace of the config (e.g. after running the
+ * init net in it), which is only ever read from. Each request runs in an
+ * instance of its own: a child workspace of that workspace, holding just the
+ * inputs and activations, with an instance of `predict_net` in it. Instances
+ * are taken from a pool and returned to it after the request, so there are
+ * only ever as many of them as there were concurrent requests.
+ *
+ * Unlike Predictor, all operator() overloads are thread-safe, and the outputs
+ * own their memory, so they remain valid after the call. Since each instance
+ * has a net of its own, nets that share their thread pools across nets (e.g.
+ * simple or async_scheduling ones) scale best to many instances.
+ */
+class CAFFE2_API PooledPredictor {
+ public:
+  using TensorList = std::vector<TensorCPU>;
+  using TensorMap = std::unordered_map<std::string, TensorCPU>;
+
+  PooledPredictor(
+      const NetDef& init_net,
+      const NetDef& run_net,
+      Workspace* parent = nullptr,
+      bool run_init = true,
+      int optimization = 1);
+
+  // Creates `num_instances` instances upfront, more are created on demand.
+  explicit PooledPredictor(PredictorConfig config, size_t num_instances = 0);
+
+  ~PooledPredictor();
+
+  // Executes `run_net` on the inputs, see Predictor::operator().
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+
+  // Similar to run, but consumes a map of name to tensor as input
+  bool operator()(const TensorMap& inputs, TensorList* outputs);
+
+  // Similar to the other run fns, except inputs and outputs are both maps of
+  // string name to tensor.
+  bool operator()(const TensorMap& inputs, TensorMap* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  };
+
+  // The workspace holding the parameters
+  Workspace* ws() {
+    return config_.ws.get();
+  };
+
+  const std::vector<std::string>& input_names() const {
+    return config_.input_names;
+  }
+
+  const std::vector<std::string>& output_names() const {
+    return config_.output_names;
+  }
+
+  // Number of instances created so far
+  size_t num_instances() const;
+
+ private:
+  struct Instance {
+    std::unique_ptr<Workspace> ws;
+    NetBase* net = nullptr;
+    // Blobs of the inputs that are not parameters, by name
+    std::unordered_map<std::string, Blob*> inputs;
+  };
+
+  std::unique_ptr<Instance> createInstance() const;
+  std::unique_ptr<Instance> acquire();
+  void release(std::unique_ptr<Instance> instance);
+
+  void setInput(Instance& instance, const std::string& name, const Tensor& t)
+      const;
+  TensorCPU takeOutput(Instance& instance, const std::string& name) const;
+
+  PredictorConfig config_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Instance>> free_instances_;
+  size_t num_instances_ = 0;
+};
+} // namespace caffe2
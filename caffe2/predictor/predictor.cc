@@ -1,5 +1,6 @@
 #include "caffe2/predictor/predictor.h"
 #include <unordered_set>
+#include "caffe2/core/engine_autotune.h"
 #include "caffe2/core/init.h"
 
 namespace caffe2 {
@@ -64,6 +65,7 @@ bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
         inputs[i].UnsafeSharedInstance());
   }
 
+  autotuneEngines();
   if (!config_.ws->RunNet(config_.predict_net->name())) {
     return false;
   }
@@ -94,9 +96,20 @@ bool Predictor::run_map_workspace(const TensorMap& inputs) {
         input.second.UnsafeSharedInstance());
   }
 
+  autotuneEngines();
   return config_.ws->RunNet(config_.predict_net->name());
 }
 
+void Predictor::autotuneEngines() {
+  if (!FLAGS_caffe2_engine_autotune || autotuned_) {
+    return;
+  }
+  autotuned_ = true;
+  if (AutotuneEngines(config_.predict_net.get(), config_.ws.get())) {
+    CAFFE_ENFORCE(config_.ws->CreateNet(config_.predict_net, true));
+  }
+}
+
 bool Predictor::operator()(const TensorMap& inputs, TensorList* outputs) {
   if (!run_map_workspace(inputs)) {
     return false;
@@ -64,6 +64,11 @@ class CAFFE2_API Predictor {
 
  private:
   bool run_map_workspace(const TensorMap& inputs);
+  // With caffe2_engine_autotune, autotunes the engines of the ops of the
+  // predict net on the inputs of the first run, and recreates the net.
+  void autotuneEngines();
+
+  bool autotuned_{false};
 
  protected:
   PredictorConfig config_;
@@ -1,11 +1,14 @@
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
+#include "caffe2/predictor/pooled_predictor.h"
 #include "caffe2/predictor/predictor.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
 
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +208,53 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, PooledConcurrentRequests) {
+  PooledPredictor p(
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec)));
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  const auto& tensor = *BlobGetMutableTensor(inputData.get(), CPU);
+
+  std::vector<std::thread> threads;
+  std::vector<Predictor::TensorList> outputs(4);
+  for (auto& output : outputs) {
+    threads.emplace_back([&p, &tensor, &output] {
+      Predictor::TensorList input;
+      input.emplace_back(tensor.Alias());
+      for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(p(input, &output));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // one instance per concurrent request at most, sharing the parameters
+  EXPECT_LE(p.num_instances(), outputs.size());
+  for (const auto& output : outputs) {
+    EXPECT_EQ(output.size(), 1);
+    EXPECT_EQ(output.front().size(0), 1);
+    EXPECT_EQ(output.front().size(1), 10);
+    EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
+  }
+  // outputs are owned by the caller
+  EXPECT_NE(
+      outputs[0].front().data<float>(), outputs[1].front().data<float>());
+}
+
+TEST_F(PredictorTest, PooledParametersAreReadOnly) {
+  auto predictNet = parseNetDef(predictSpec);
+  predictNet.mutable_op(0)->set_output(0, "W");
+  EXPECT_THROW(
+      PooledPredictor(makePredictorConfig(parseNetDef(initSpec), predictNet)),
+      EnforceNotMet);
+
+  PooledPredictor p(
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec)));
+  auto inputData = randomTensor({10, 4}, ctx_.get());
+  Predictor::TensorMap input;
+  input.emplace("W", BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList output;
+  EXPECT_THROW(p(input, &output), EnforceNotMet);
+}
+
 } // namespace caffe2
@@ -17,12 +17,9 @@ def image_input(
             outputs = model.net.ImageInput(blob_in, blob_out, **kwargs)
             pass
         else:
-            outputs = model.net.ImageInput(
-                blob_in, [blob_out[0] + '_nhwc'] + blob_out[1:], **kwargs
-            )
-            outputs_list = list(outputs)
-            outputs_list[0] = model.net.NHWC2NCHW(outputs_list[0], blob_out[0])
-            outputs = tuple(outputs_list)
+            # The CPU transform writes the images in NCHW order directly
+            kwargs['output_order'] = "NCHW"
+            outputs = model.net.ImageInput(blob_in, blob_out, **kwargs)
     else:
         outputs = model.net.ImageInput(blob_in, blob_out, **kwargs)
     return outputs
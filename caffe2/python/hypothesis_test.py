@@ -1292,12 +1292,14 @@ class TestOperators(hu.HypothesisTestCase):
            num_consumers=st.integers(1, 10),
            capacity=st.integers(1, 5),
            num_blobs=st.integers(1, 3),
+           lock_free=st.booleans(),
            do=st.sampled_from(hu.device_options))
     def test_safe_blobs_queue(self, num_producers, num_consumers,
-                              capacity, num_blobs, do):
+                              capacity, num_blobs, lock_free, do):
         init_net = core.Net('init_net')
         queue = init_net.CreateBlobsQueue(
-            [], 1, capacity=capacity, num_blobs=num_blobs)
+            [], 1, capacity=capacity, num_blobs=num_blobs,
+            lock_free=lock_free)
         producer_steps = []
         truth = 0
         for i in range(num_producers):
@@ -128,6 +128,46 @@ class MemongerTest(hu.HypothesisTestCase):
 
         self.assertLess(count_blobs(optimized_net), count_blobs(m.Proto()))
 
+    @given(input_dim=st.integers(min_value=1, max_value=10),
+           batch_size=st.integers(min_value=1, max_value=10),
+           net_type=st.sampled_from(["dag", "async_scheduling"]))
+    @settings(max_examples=5, timeout=120)
+    def test_fast_memonger_dag(self, input_dim, batch_size, net_type):
+        net = core.Net("dag_memonger")
+        net.Proto().type = net_type
+        net.Proto().num_workers = 4
+        # The two branches may run concurrently, so they can't share blobs,
+        # but the chain after the join can reuse them.
+        net.Relu(["data"], ["a1"])
+        net.Relu(["a1"], ["a2"])
+        net.Sigmoid(["data"], ["b1"])
+        net.Sigmoid(["b1"], ["b2"])
+        net.Sum(["a2", "b2"], ["c1"])
+        net.Relu(["c1"], ["c2"])
+        net.Tanh(["c2"], ["c3"])
+        net.Relu(["c3"], ["out"])
+
+        data = np.random.randn(batch_size, input_dim).astype(np.float32)
+        workspace.FeedBlob("data", data)
+        workspace.RunNetOnce(net)
+        out = workspace.FetchBlob("out")
+
+        optimized_net = memonger.optimize_inference_fast(
+            net.Proto(), ["data", "out"])
+        self.assertLess(count_blobs(optimized_net), count_blobs(net.Proto()))
+        renamed = {}
+        for op, optimized_op in zip(net.Proto().op, optimized_net.op):
+            for name, new_name in zip(op.output, optimized_op.output):
+                renamed[name] = new_name
+        for a in ["a1", "a2"]:
+            for b in ["b1", "b2"]:
+                self.assertNotEqual(renamed[a], renamed[b])
+
+        workspace.ResetWorkspace()
+        workspace.FeedBlob("data", data)
+        workspace.RunNetOnce(optimized_net)
+        np.testing.assert_almost_equal(out, workspace.FetchBlob("out"))
+
     def test_fast_memonger_unique_outputs(self):
         m = model_helper.ModelHelper()
         fc = []
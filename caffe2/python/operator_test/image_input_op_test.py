@@ -237,7 +237,8 @@ def create_test(output_dir, width, height, default_bound, minsize, crop, means,
 
 def run_test(
         size_tuple, means, stds, label_type, num_labels, is_test, scale_jitter_type,
-        color_jitter, color_lighting, dc, validator, output1=None, output2_size=None):
+        color_jitter, color_lighting, dc, validator, output1=None, output2_size=None,
+        output_order="NHWC"):
     # TODO: Does not test on GPU and does not test use_gpu_transform
     # WARNING: Using ModelHelper automatically does NHWC to NCHW
     # transformation if needed.
@@ -279,6 +280,10 @@ def run_test(
             if output2_size:
                 outputs.append('output2')
                 output_sizes.append(output2_size)
+            kwargs = {}
+            if device_option.device_type != 1:
+                # The GPU transform always outputs NCHW
+                kwargs['output_order'] = output_order
             imageop = core.CreateOperator(
                 'ImageInput',
                 ['DB'],
@@ -300,7 +305,8 @@ def run_test(
                 output_sizes=output_sizes,
                 scale_jitter_type=scale_jitter_type,
                 color_jitter=color_jitter,
-                color_lighting=color_lighting
+                color_lighting=color_lighting,
+                **kwargs
             )
 
             imageop.device_option.CopyFrom(device_option)
@@ -320,12 +326,13 @@ def run_test(
 class TestImport(hu.HypothesisTestCase):
     def validate_image_and_label(
             self, expected_images, device_option, count_images, label_type,
-            is_test, scale_jitter_type, color_jitter, color_lighting):
+            is_test, scale_jitter_type, color_jitter, color_lighting,
+            output_order="NHWC"):
         l = workspace.FetchBlob('label')
         result = workspace.FetchBlob('data').astype(np.int32)
-        # If we don't use_gpu_transform, the output is in NHWC
+        # If we don't use_gpu_transform, the output is in output_order
         # Our reference output is CHW so we swap
-        if device_option.device_type != 1:
+        if device_option.device_type != 1 and output_order == "NHWC":
             expected = [img.swapaxes(0, 1).swapaxes(1, 2) for
                         (img, _, _, _) in expected_images]
         else:
@@ -365,20 +372,23 @@ class TestImport(hu.HypothesisTestCase):
         scale_jitter_type=st.integers(min_value=0, max_value=1),
         color_jitter=st.integers(min_value=0, max_value=1),
         color_lighting=st.integers(min_value=0, max_value=1),
+        output_order=st.sampled_from(["NHWC", "NCHW"]),
         **hu.gcs)
     @settings(verbosity=Verbosity.verbose)
     def test_imageinput(
             self, size_tuple, means, stds, label_type,
             num_labels, is_test, scale_jitter_type, color_jitter, color_lighting,
-            gc, dc):
+            output_order, gc, dc):
         def validator(expected_images, device_option, count_images):
             self.validate_image_and_label(
                 expected_images, device_option, count_images, label_type,
-                is_test, scale_jitter_type, color_jitter, color_lighting)
+                is_test, scale_jitter_type, color_jitter, color_lighting,
+                output_order)
         # End validator
         run_test(
             size_tuple, means, stds, label_type, num_labels, is_test,
-            scale_jitter_type, color_jitter, color_lighting, dc, validator)
+            scale_jitter_type, color_jitter, color_lighting, dc, validator,
+            output_order=output_order)
     # End test_imageinput
 
     @given(size_tuple=st.tuples(
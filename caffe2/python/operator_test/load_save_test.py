@@ -481,6 +481,38 @@ class TestLoadSave(TestLoadSaveBase):
             if e.errno != errno.ENOENT:
                 raise
 
+    def testLoadChunkedTensors(self):
+        # the chunks of a tensor are deserialized concurrently into it
+        workspace.ResetWorkspace()
+        arrays = [np.random.rand(100, 13).astype(np.float32),
+                  np.arange(1000, dtype=np.int64),
+                  np.random.randint(0, 255, size=300).astype(np.uint8),
+                  np.random.rand(5).astype(np.float16)]
+        for i, arr in enumerate(arrays):
+            workspace.FeedBlob(str(i), arr)
+        tmp_folder = tempfile.mkdtemp()
+        tmp_file = os.path.join(tmp_folder, "db")
+        try:
+            workspace.RunOperatorOnce(core.CreateOperator(
+                "Save",
+                [str(i) for i in range(len(arrays))], [],
+                absolute_path=1,
+                db=tmp_file, db_type=self._db_type,
+                chunk_size=7))
+            for load_all in [False, True]:
+                workspace.ResetWorkspace()
+                workspace.RunOperatorOnce(core.CreateOperator(
+                    "Load",
+                    [], [] if load_all else [str(i) for i in range(len(arrays))],
+                    absolute_path=1,
+                    db=tmp_file, db_type=self._db_type,
+                    load_all=load_all))
+                for i, arr in enumerate(arrays):
+                    np.testing.assert_array_equal(
+                        workspace.FetchBlob(str(i)), arr)
+        finally:
+            shutil.rmtree(tmp_folder)
+
 
 if __name__ == '__main__':
     unittest.main()
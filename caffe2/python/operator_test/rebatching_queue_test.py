@@ -117,6 +117,36 @@ class TestReBatchingQueue(TestCase):
         with self.assertRaises(RuntimeError):
             workspace.RunNetOnce(net)
 
+    def test_rebatching_queue_slab_mode(self):
+        net = core.Net('net')
+        workspace.FeedBlob(
+            "tensors", np.array([x for x in range(8)], np.int32)
+        )
+        workspace.FeedBlob("tensor", np.array(8, np.int32))
+
+        queue = net.CreateRebatchingQueue(
+            [], 1, capacity=8, num_blobs=1, batch_size=4
+        )
+
+        net.EnqueueRebatchingQueue([queue, "tensors"], [], enqueue_batch=True)
+        results = [
+            net.DequeueRebatchingQueue([queue], 1, num_elements=4),
+            net.DequeueRebatchingQueue([queue], 1, num_elements=4),
+        ]
+        net.EnqueueRebatchingQueue([queue, "tensor"], [])
+        net.CloseRebatchingQueue([queue], 0)
+        # The last batch is partial, since the queue is closed
+        results.append(
+            net.DequeueRebatchingQueue([queue], 1, num_elements=4)
+        )
+
+        workspace.RunNetOnce(net)
+
+        expected = list(range(9))
+        npt.assert_array_equal(workspace.FetchBlob(results[0]), expected[:4])
+        npt.assert_array_equal(workspace.FetchBlob(results[1]), expected[4:8])
+        npt.assert_array_equal(workspace.FetchBlob(results[2]), expected[8:])
+
     def test_rebatching_queue_multiple_components(self):
         NUM_BLOBS = 4
         NUM_ELEMENTS = 10
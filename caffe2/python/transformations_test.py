@@ -320,6 +320,85 @@ class TestTransformations(tu.TestCase):
             atol=1e-04
         )
 
+    @given(
+        batch_size=st.integers(1, 4),
+        seq_len=st.integers(1, 4),
+        input_dim=st.integers(1, 10),
+        output_dim=st.integers(1, 10),
+        seed=st.integers(0, 65535),
+        epsilon=st.floats(min_value=1e-5, max_value=1e-2),
+    )
+    def test_transformer_FuseFCBN(
+        self, batch_size, seq_len, input_dim, output_dim, seed, epsilon
+    ):
+        workspace.ResetWorkspace()
+        net = core.Net("net")
+        # SpatialBN needs 3 dimensions, of which the last one holds the FC
+        # outputs in NHWC.
+        net.FC(["X", "w", "b"], ["Y"], axis=2)
+        net.SpatialBN(
+            ["Y", "scale", "bias", "mean", "var"],
+            ["Y2"],
+            is_test=True,
+            order="NHWC",
+            epsilon=epsilon,
+        )
+
+        np.random.seed(seed)
+        tu.randBlobFloat32("X", batch_size, seq_len, input_dim)
+        tu.randBlobFloat32("w", output_dim, input_dim)
+        tu.randBlobsFloat32(["b", "scale", "bias", "mean"], output_dim)
+        tu.randBlobFloat32("var", output_dim, offset=0.5)
+        workspace.RunNetOnce(net)
+        preTransformOutput = workspace.FetchBlob("Y2").flatten()
+        workspace.FeedBlob("Y2", np.zeros((1, 1)))
+        transformer.FuseFCBN(net)
+
+        # Ensure fusion
+        assert tu.numOps(net) == 1
+        workspace.RunNetOnce(net)
+        postTransformOutput = workspace.FetchBlob("Y2").flatten()
+        # Check that there is no numerical difference
+        assert np.allclose(
+            preTransformOutput,
+            postTransformOutput,
+            rtol=1e-02,
+            atol=1e-04
+        )
+
+    @given(
+        batch_size=st.integers(1, 8),
+        input_dim=st.integers(1, 10),
+        output_dim=st.integers(1, 10),
+        seed=st.integers(0, 65535),
+    )
+    def test_transformer_FuseFCRelu(
+        self, batch_size, input_dim, output_dim, seed
+    ):
+        workspace.ResetWorkspace()
+        net = core.Net("net")
+        net.FC(["X", "w", "b"], ["Y"])
+        net.Relu(["Y"], ["Y2"])
+
+        np.random.seed(seed)
+        tu.randBlobFloat32("X", batch_size, input_dim)
+        tu.randBlobFloat32("w", output_dim, input_dim)
+        tu.randBlobFloat32("b", output_dim)
+        workspace.RunNetOnce(net)
+        preTransformOutput = workspace.FetchBlob("Y2").flatten()
+        workspace.FeedBlob("Y2", np.zeros((1, 1)))
+        transformer.FuseFCRelu(net)
+
+        # Ensure fusion
+        assert tu.numOps(net) == 1
+        assert any(
+            arg.name == "activation" and arg.s == b"Relu"
+            for arg in net.Proto().op[0].arg
+        )
+        workspace.RunNetOnce(net)
+        postTransformOutput = workspace.FetchBlob("Y2").flatten()
+        assert np.allclose(preTransformOutput, postTransformOutput)
+
     def test_converterDontEnforceUnusedInputs(self):
         net = core.Net("net")
         net.Relu(["X"], ["Y"])
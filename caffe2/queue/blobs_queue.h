@@ -30,16 +30,16 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
       bool enforceUniqueName,
       const std::vector<std::string>& fieldNames = {});
 
-  ~BlobsQueue() {
+  virtual ~BlobsQueue() {
     close();
   }
 
-  bool blockingRead(
+  virtual bool blockingRead(
       const std::vector<Blob*>& inputs,
       float timeout_secs = 0.0f);
-  bool tryWrite(const std::vector<Blob*>& inputs);
-  bool blockingWrite(const std::vector<Blob*>& inputs);
-  void close();
+  virtual bool tryWrite(const std::vector<Blob*>& inputs);
+  virtual bool blockingWrite(const std::vector<Blob*>& inputs);
+  virtual void close();
   size_t getNumBlobs() const {
     return numBlobs_;
   }
@@ -48,6 +48,7 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   bool canWrite();
   void doWrite(const std::vector<Blob*>& inputs);
 
+ protected:
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
@@ -55,6 +56,7 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   std::condition_variable cv_;
   int64_t reader_{0};
   int64_t writer_{0};
+  // The blobs of the slots, owned by the workspace.
   std::vector<std::vector<Blob*>> queue_;
   const std::string name_;
 
@@ -0,0 +1,246 @@
+#include "caffe2/queue/lock_free_blobs_queue.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "caffe2/core/blob_stats.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/timer.h"
+
+namespace caffe2 {
+
+// Constants for user tracepoints
+static constexpr int SDT_NONBLOCKING_OP = 0;
+static constexpr int SDT_BLOCKING_OP = 1;
+static constexpr uint64_t SDT_TIMEOUT = (uint64_t)-1;
+static constexpr uint64_t SDT_ABORT = (uint64_t)-2;
+static constexpr uint64_t SDT_CANCEL = (uint64_t)-3;
+
+// Number of attempts of a blocking read or write before it waits on the
+// condition variable.
+static constexpr int kSpinCount = 64;
+
+LockFreeBlobsQueue::LockFreeBlobsQueue(
+    Workspace* ws,
+    const std::string& queueName,
+    size_t capacity,
+    size_t numBlobs,
+    bool enforceUniqueName,
+    const std::vector<std::string>& fieldNames)
+    : BlobsQueue(
+          ws,
+          queueName,
+          capacity,
+          numBlobs,
+          enforceUniqueName,
+          fieldNames),
+      capacity_(capacity),
+      sequences_(new std::atomic<uint64_t>[capacity]) {
+  CAFFE_ENFORCE_GT(capacity, 0, "Lock-free queue needs a positive capacity");
+  for (size_t i = 0; i < capacity_; ++i) {
+    sequences_[i].store(i, std::memory_order_relaxed);
+  }
+}
+
+bool LockFreeBlobsQueue::tryReadOnce(const std::vector<Blob*>& inputs) {
+  uint64_t pos = readPos_.load(std::memory_order_relaxed);
+  std::atomic<uint64_t>* sequence;
+  for (;;) {
+    sequence = &sequences_[pos % capacity_];
+    const auto diff = static_cast<int64_t>(
+        sequence->load(std::memory_order_acquire) - (pos + 1));
+    if (diff == 0) {
+      if (readPos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot wasn't written yet: the queue is empty.
+      return false;
+    } else {
+      pos = readPos_.load(std::memory_order_relaxed);
+    }
+  }
+  auto& result = queue_[pos % capacity_];
+  for (auto i = 0; i < result.size(); ++i) {
+    auto bytes = BlobStat::sizeBytes(*result[i]);
+    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+    using std::swap;
+    swap(*(inputs[i]), *(result[i]));
+  }
+  sequence->store(pos + capacity_, std::memory_order_release);
+  CAFFE_SDT(
+      queue_read_end,
+      name_.c_str(),
+      (void*)this,
+      writePos_.load(std::memory_order_relaxed) - (pos + 1));
+  CAFFE_EVENT(stats_, queue_dequeued_records);
+  return true;
+}
+
+bool LockFreeBlobsQueue::tryWriteOnce(const std::vector<Blob*>& inputs) {
+  uint64_t pos = writePos_.load(std::memory_order_relaxed);
+  std::atomic<uint64_t>* sequence;
+  for (;;) {
+    sequence = &sequences_[pos % capacity_];
+    const auto diff =
+        static_cast<int64_t>(sequence->load(std::memory_order_acquire) - pos);
+    if (diff == 0) {
+      if (writePos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot wasn't read yet: the queue is full.
+      return false;
+    } else {
+      pos = writePos_.load(std::memory_order_relaxed);
+    }
+  }
+  auto& result = queue_[pos % capacity_];
+  for (auto i = 0; i < result.size(); ++i) {
+    using std::swap;
+    swap(*(inputs[i]), *(result[i]));
+  }
+  sequence->store(pos + 1, std::memory_order_release);
+  CAFFE_SDT(
+      queue_write_end,
+      name_.c_str(),
+      (void*)this,
+      readPos_.load(std::memory_order_relaxed) + capacity_ - (pos + 1));
+  return true;
+}
+
+template <typename Attempt>
+bool LockFreeBlobsQueue::waitFor(
+    Attempt attempt,
+    std::atomic<int>& waiters,
+    std::condition_variable& cv,
+    float timeout_secs) {
+  for (int i = 0; i < kSpinCount; ++i) {
+    if (attempt()) {
+      return true;
+    }
+    if (closing_) {
+      return false;
+    }
+    std::this_thread::yield();
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(int(timeout_secs * 1000));
+  // The waiter is counted before the last attempt, and the other side checks
+  // the count after publishing its slot, so that either the attempt sees the
+  // slot or the other side sees the waiter and notifies it. The notification
+  // can't be lost between the attempt and the wait, since it takes the mutex.
+  waiters.fetch_add(1);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  std::unique_lock<std::mutex> g(mutex_);
+  bool success = false;
+  for (;;) {
+    if ((success = attempt()) || closing_) {
+      break;
+    }
+    if (timeout_secs > 0) {
+      if (cv.wait_until(g, deadline) == std::cv_status::timeout) {
+        success = attempt();
+        break;
+      }
+    } else {
+      cv.wait(g);
+    }
+  }
+  waiters.fetch_sub(1);
+  return success;
+}
+
+void LockFreeBlobsQueue::notify(
+    std::atomic<int>& waiters,
+    std::condition_variable& cv) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> g(mutex_);
+    cv.notify_all();
+  }
+}
+
+bool LockFreeBlobsQueue::blockingRead(
+    const std::vector<Blob*>& inputs,
+    float timeout_secs) {
+  Timer readTimer;
+  auto keeper = this->shared_from_this();
+  const auto& name = name_.c_str();
+  CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
+  // Check the inputs before claiming a slot, which can't be given back.
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
+  // Decrease queue balance before reading to indicate queue read pressure
+  // is being increased (-ve queue balance indicates more reads than writes)
+  CAFFE_EVENT(stats_, queue_balance, -1);
+  if (!waitFor(
+          [this, &inputs]() { return tryReadOnce(inputs); },
+          waitingReaders_,
+          readCv_,
+          timeout_secs)) {
+    if (timeout_secs > 0 && !closing_) {
+      LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
+      CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
+    } else {
+      CAFFE_SDT(queue_read_end, name, (void*)this, SDT_CANCEL);
+    }
+    return false;
+  }
+  notify(waitingWriters_, writeCv_);
+  CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
+  return true;
+}
+
+bool LockFreeBlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
+  Timer writeTimer;
+  auto keeper = this->shared_from_this();
+  const auto& name = name_.c_str();
+  CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
+  if (!tryWriteOnce(inputs)) {
+    CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
+    return false;
+  }
+  notify(waitingReaders_, readCv_);
+  // Increase queue balance to indicate queue write pressure is being
+  // increased (+ve queue balance indicates more writes than reads)
+  CAFFE_EVENT(stats_, queue_balance, 1);
+  CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
+  return true;
+}
+
+bool LockFreeBlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
+  Timer writeTimer;
+  auto keeper = this->shared_from_this();
+  const auto& name = name_.c_str();
+  CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
+  // Increase queue balance before writing to indicate queue write pressure is
+  // being increased (+ve queue balance indicates more writes than reads)
+  CAFFE_EVENT(stats_, queue_balance, 1);
+  if (!waitFor(
+          [this, &inputs]() { return tryWriteOnce(inputs); },
+          waitingWriters_,
+          writeCv_,
+          /*timeout_secs=*/0.0f)) {
+    CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
+    return false;
+  }
+  notify(waitingReaders_, readCv_);
+  CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
+  return true;
+}
+
+void LockFreeBlobsQueue::close() {
+  closing_ = true;
+
+  std::lock_guard<std::mutex> g(mutex_);
+  readCv_.notify_all();
+  writeCv_.notify_all();
+}
+
+} // namespace caffe2
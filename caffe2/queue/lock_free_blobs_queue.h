@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+
+#include "caffe2/queue/blobs_queue.h"
+
+namespace caffe2 {
+
+// A BlobsQueue whose reads and writes don't take a lock unless they have to
+// block, for queues shared by many producer and consumer threads.
+//
+// The slots form a bounded multi-producer multi-consumer ring, where each slot
+// has a sequence number telling which position of the queue it holds. A
+// writer of position `pos` claims it by incrementing the write position with a
+// CAS, once the slot of `pos` is free (its sequence is `pos`), swaps its blobs
+// into the slot and publishes them by setting the sequence to `pos + 1`. A
+// reader claims the position once the slot is full (its sequence is
+// `pos + 1`), swaps the blobs out, and frees the slot for the position
+// `pos + capacity`. Since the swaps happen after a position is claimed, the
+// slots are never read and written at the same time.
+//
+// A read from an empty queue or a write to a full one spins for a while, and
+// then waits on a condition variable, which the other side only notifies when
+// someone waits. The blocking and close semantics are those of BlobsQueue.
+class CAFFE2_API LockFreeBlobsQueue : public BlobsQueue {
+ public:
+  LockFreeBlobsQueue(
+      Workspace* ws,
+      const std::string& queueName,
+      size_t capacity,
+      size_t numBlobs,
+      bool enforceUniqueName,
+      const std::vector<std::string>& fieldNames = {});
+
+  ~LockFreeBlobsQueue() override {
+    close();
+  }
+
+  bool blockingRead(
+      const std::vector<Blob*>& inputs,
+      float timeout_secs = 0.0f) override;
+  bool tryWrite(const std::vector<Blob*>& inputs) override;
+  bool blockingWrite(const std::vector<Blob*>& inputs) override;
+  void close() override;
+
+ private:
+  // Reads or writes a position if the queue isn't empty or full, without
+  // blocking. The caller notifies the other side on success, once it doesn't
+  // hold the mutex anymore.
+  bool tryReadOnce(const std::vector<Blob*>& inputs);
+  bool tryWriteOnce(const std::vector<Blob*>& inputs);
+
+  // Retries `attempt` until it succeeds, the queue is closed or the timeout
+  // (if positive) expires, waiting on `cv` once spinning didn't help.
+  template <typename Attempt>
+  bool waitFor(
+      Attempt attempt,
+      std::atomic<int>& waiters,
+      std::condition_variable& cv,
+      float timeout_secs);
+
+  // Wakes up the threads waiting on `cv`, if any.
+  void notify(std::atomic<int>& waiters, std::condition_variable& cv);
+
+  const size_t capacity_;
+  std::unique_ptr<std::atomic<uint64_t>[]> sequences_;
+
+  // The positions are padded to their own cache lines, so that readers and
+  // writers don't invalidate each other's.
+  static constexpr size_t kCacheLineSize = 64;
+  char pad0_[kCacheLineSize];
+  std::atomic<uint64_t> readPos_{0};
+  char pad1_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+  std::atomic<uint64_t> writePos_{0};
+  char pad2_[kCacheLineSize - sizeof(std::atomic<uint64_t>)];
+
+  std::atomic<int> waitingReaders_{0};
+  std::atomic<int> waitingWriters_{0};
+  std::condition_variable readCv_;
+  std::condition_variable writeCv_;
+};
+
+} // namespace caffe2
@@ -17,7 +17,24 @@ REGISTER_CPU_OPERATOR(
     WeightedSampleDequeueBlobs,
     WeightedSampleDequeueBlobsOp<CPUContext>);
 
-OPERATOR_SCHEMA(CreateBlobsQueue).NumInputs(0).NumOutputs(1);
+OPERATOR_SCHEMA(CreateBlobsQueue)
+    .NumInputs(0)
+    .NumOutputs(1)
+    .SetDoc(R"DOC(
+  Create a bounded, blocking queue of blobs, whose slots are blobs of the
+  workspace.
+  )DOC")
+    .Arg("capacity", "Number of slots of the queue, default: 1")
+    .Arg("num_blobs", "Number of blobs of an entry, default: 1")
+    .Arg(
+        "enforce_unique_name",
+        "Fail if the blobs of the slots already exist, default: false")
+    .Arg("field_names", "Names of the blobs of an entry, for the stats")
+    .Arg(
+        "lock_free",
+        "Use a lock-free ring, which scales better with many concurrent "
+        "readers and writers, default: false")
+    .Output(0, "queue", "The shared pointer for the BlobsQueue");
 OPERATOR_SCHEMA(EnqueueBlobs)
     .NumInputsOutputs([](int inputs, int outputs) {
       return inputs >= 2 && outputs >= 1 && inputs == outputs + 1;
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include "blobs_queue.h"
+#include "lock_free_blobs_queue.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/utils/math.h"
 
@@ -22,14 +23,20 @@ class CreateBlobsQueueOp final : public Operator<Context> {
     const auto numBlobs = GetSingleArgument("num_blobs", 1);
     const auto enforceUniqueName =
         GetSingleArgument("enforce_unique_name", false);
+    const auto lockFree = GetSingleArgument("lock_free", false);
     const auto fieldNames =
         OperatorBase::template GetRepeatedArgument<std::string>("field_names");
     CAFFE_ENFORCE_EQ(this->OutputSize(), 1);
     auto queuePtr = Operator<Context>::Outputs()[0]
                         ->template GetMutable<std::shared_ptr<BlobsQueue>>();
     CAFFE_ENFORCE(queuePtr);
-    *queuePtr = std::make_shared<BlobsQueue>(
-        ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    if (lockFree) {
+      *queuePtr = std::make_shared<LockFreeBlobsQueue>(
+          ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    } else {
+      *queuePtr = std::make_shared<BlobsQueue>(
+          ws_, name, capacity, numBlobs, enforceUniqueName, fieldNames);
+    }
     return true;
   }
 
@@ -97,8 +97,21 @@ std::vector<std::vector<TensorCPU>> split(
 }
 } // anonymous namespace
 
-RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
-    : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
+RebatchingQueue::RebatchingQueue(
+    size_t capacity,
+    size_t numBlobs,
+    size_t batchSize)
+    : capacity_(capacity),
+      numBlobs_(numBlobs),
+      batchSize_(batchSize),
+      queue_(batchSize > 0 ? 0 : capacity),
+      slabs_(batchSize > 0 ? capacity / batchSize : 0) {
+  CAFFE_ENFORCE(
+      batchSize == 0 || capacity >= batchSize,
+      "The capacity must hold at least one batch of ",
+      batchSize,
+      " elements");
+}
 
 RebatchingQueue::~RebatchingQueue() {
   close();
@@ -112,6 +125,10 @@ bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
+  if (batchSize_ > 0) {
+    return dequeueSlab(numElements, outputs);
+  }
+
   std::vector<std::vector<TensorCPU>> results;
   results.reserve(numElements);
 
@@ -156,8 +173,12 @@ bool RebatchingQueue::canWrite() const {
 }
 
 bool RebatchingQueue::enqueueOne(
-    CPUContext& /*context*/,
+    CPUContext& context,
     const std::vector<const TensorCPU*>& inputs) {
+  if (batchSize_ > 0) {
+    return enqueueSlab(context, inputs, /*batched=*/false);
+  }
+
   std::vector<std::vector<TensorCPU>> splittedInputs;
   splittedInputs.emplace_back();
   auto& tensorVector = splittedInputs.back();
@@ -174,6 +195,10 @@ bool RebatchingQueue::enqueueMany(
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
 
+  if (batchSize_ > 0) {
+    return enqueueSlab(context, inputs, /*batched=*/true);
+  }
+
   std::vector<std::vector<TensorCPU>> splittedInputs;
   splittedInputs = split(context, inputs);
   return enqueue(std::move(splittedInputs));
@@ -209,6 +234,164 @@ bool RebatchingQueue::enqueue(
   return true;
 }
 
+bool RebatchingQueue::canWriteSlab() const {
+  // The batches between tail_ and head_ are fully reserved
+  return head_ - tail_ < slabs_.size();
+}
+
+bool RebatchingQueue::canReadSlab() const {
+  const auto& slab = slabs_[tail_ % slabs_.size()];
+  // Once the queue is closed, the last batch is read as soon as the rows
+  // reserved so far are written
+  return slab.written == batchSize_ ||
+      (isClosed_ && slab.written == slab.reserved);
+}
+
+bool RebatchingQueue::enqueueSlab(
+    CPUContext& context,
+    const std::vector<const TensorCPU*>& inputs,
+    bool batched) {
+  CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
+  CAFFE_ENFORCE(!inputs.empty());
+  const int64_t numRows = batched ? inputs[0]->size(0) : 1;
+  for (const auto* input : inputs) {
+    CAFFE_ENFORCE(input);
+    if (batched) {
+      CAFFE_ENFORCE_GE(input->dim(), 1);
+      CAFFE_ENFORCE_EQ(input->size(0), numRows);
+    }
+  }
+
+  std::vector<char*> destinations(inputs.size());
+  int64_t row = 0;
+  while (row < numRows) {
+    Slab* slab;
+    size_t numWritten;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      cvOverflow_.wait(lock, [this] { return canWriteSlab() || isClosed_; });
+
+      if (isClosed_) {
+        // Same as in enqueue, a batch that was partially enqueued when the
+        // queue got closed is a non-success
+        return false;
+      }
+
+      slab = &slabs_[head_ % slabs_.size()];
+      if (slab->reserved == 0) {
+        // The first element of a batch allocates its tensors
+        slab->tensors.clear();
+        for (const auto* input : inputs) {
+          auto dims = input->sizes().vec();
+          if (batched) {
+            dims.erase(dims.begin());
+          }
+          dims.insert(dims.begin(), batchSize_);
+          slab->tensors.emplace_back(dims, CPU);
+          slab->tensors.back().raw_mutable_data(input->dtype());
+        }
+      } else {
+        for (size_t j = 0; j < inputs.size(); ++j) {
+          const auto& input = *inputs[j];
+          const auto& tensor = slab->tensors[j];
+          const int offset = batched ? 0 : 1;
+          CAFFE_ENFORCE(tensor.dtype() == input.dtype());
+          CAFFE_ENFORCE_EQ(tensor.dim(), input.dim() + offset);
+          for (int k = 1; k < tensor.dim(); ++k) {
+            CAFFE_ENFORCE_EQ(tensor.size(k), input.size(k - offset));
+          }
+        }
+      }
+
+      numWritten = std::min<size_t>(numRows - row, batchSize_ - slab->reserved);
+      for (size_t j = 0; j < inputs.size(); ++j) {
+        auto& tensor = slab->tensors[j];
+        destinations[j] = static_cast<char*>(tensor.raw_mutable_data()) +
+            slab->reserved * tensor.size_from_dim(1) * tensor.itemsize();
+      }
+      slab->reserved += numWritten;
+      if (slab->reserved == batchSize_) {
+        ++head_;
+      }
+    }
+
+    // Copy the rows into the batch without holding the lock, so that
+    // producers copy concurrently
+    for (size_t j = 0; j < inputs.size(); ++j) {
+      const auto& input = *inputs[j];
+      const auto rowSize = input.size_from_dim(batched ? 1 : 0);
+      if (rowSize == 0) {
+        continue;
+      }
+      context.CopyItemsToCPU(
+          input.dtype(),
+          numWritten * rowSize,
+          static_cast<const char*>(input.raw_data()) +
+              row * rowSize * input.itemsize() /* src */,
+          destinations[j] /* dst */);
+    }
+    row += numWritten;
+
+    bool ready;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      slab->written += numWritten;
+      ready = slab->written == batchSize_ || isClosed_;
+    }
+    if (ready) {
+      cvEmpty_.notify_all();
+    }
+  }
+
+  return true;
+}
+
+bool RebatchingQueue::dequeueSlab(
+    size_t numElements,
+    const std::vector<TensorCPU*>& outputs) {
+  CAFFE_ENFORCE_EQ(
+      numElements,
+      batchSize_,
+      "A queue in slab mode only dequeues batches of its batch size");
+  CAFFE_ENFORCE_EQ(outputs.size(), numBlobs_);
+
+  std::vector<TensorCPU> tensors;
+  size_t numRows;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    cvEmpty_.wait(lock, [this] { return canReadSlab(); });
+
+    auto& slab = slabs_[tail_ % slabs_.size()];
+    numRows = slab.written;
+    // The queue is empty and closed
+    if (numRows == 0) {
+      return false;
+    }
+    tensors = std::move(slab.tensors);
+    slab.tensors.clear();
+    slab.reserved = 0;
+    slab.written = 0;
+    // A partial batch is still the one being filled, and reusing its slab
+    // doesn't move head_
+    if (numRows == batchSize_) {
+      ++tail_;
+    }
+  }
+  cvOverflow_.notify_all();
+
+  // Hand out the tensors of the batch, which no writer references anymore
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (numRows < batchSize_) {
+      tensors[i].ShrinkTo(numRows);
+    }
+    *outputs[i] = std::move(tensors[i]);
+  }
+
+  return true;
+}
+
 size_t RebatchingQueue::capacity() const {
   return capacity_;
 }
@@ -217,6 +400,10 @@ size_t RebatchingQueue::numBlobs() const {
   return numBlobs_;
 }
 
+size_t RebatchingQueue::batchSize() const {
+  return batchSize_;
+}
+
 bool RebatchingQueue::isClosed() const {
   std::lock_guard<std::mutex> g(mutex_);
   return isClosed_;
@@ -17,9 +17,15 @@ namespace caffe2 {
 // atomic index + circular queue optimizations or pull something more
 // heavy-weight later
 
+// When batchSize is positive, the queue runs in slab mode: it holds batches of
+// batchSize elements, whose tensors are allocated once, enqueue writes the
+// elements straight into the batch being filled, and dequeue hands out whole
+// batches without concatenating them. Dequeue must then ask for exactly
+// batchSize elements, except that the last, partial batch is returned once the
+// queue is closed.
 class RebatchingQueue {
  public:
-  RebatchingQueue(size_t capacity, size_t numBlobs);
+  RebatchingQueue(size_t capacity, size_t numBlobs, size_t batchSize = 0);
 
   ~RebatchingQueue();
 
@@ -40,6 +46,8 @@ class RebatchingQueue {
 
   size_t numBlobs() const;
 
+  size_t batchSize() const;
+
   bool isClosed() const;
 
   void close();
@@ -50,8 +58,27 @@ class RebatchingQueue {
   bool canWrite() const;
   bool canRead() const;
 
+  // A batch of slab mode. Writers reserve rows of the batch under the mutex,
+  // and copy into them without holding it, so the batch is ready once all its
+  // rows are written.
+  struct Slab {
+    std::vector<TensorCPU> tensors;
+    size_t reserved{0};
+    size_t written{0};
+  };
+
+  bool enqueueSlab(
+      CPUContext& context,
+      const std::vector<const TensorCPU*>& inputs,
+      bool batched);
+  bool dequeueSlab(size_t numElements, const std::vector<TensorCPU*>& outputs);
+
+  bool canWriteSlab() const;
+  bool canReadSlab() const;
+
   const size_t capacity_;
   const size_t numBlobs_;
+  const size_t batchSize_;
 
   mutable std::mutex mutex_;
 
@@ -64,5 +91,9 @@ class RebatchingQueue {
   std::condition_variable cvOverflow_;
 
   std::vector<std::vector<TensorCPU>> queue_;
+
+  // In slab mode, head_ is the batch being filled and tail_ the next batch to
+  // dequeue.
+  std::vector<Slab> slabs_;
 };
 } // caffe2
@@ -26,7 +26,12 @@ Creates the Queue.
     .Arg("num_blobs", "Number of input tensors the queue will support")
     .Arg(
         "capacity",
-        "Maximal number of elements the queue can hold at any given point");
+        "Maximal number of elements the queue can hold at any given point")
+    .Arg(
+        "batch_size",
+        "If positive, the queue stores batches of batch_size elements, which \
+        elements are enqueued into in place, and dequeues them without a \
+        copy. Dequeue must then ask for batch_size elements.");
 
 OPERATOR_SCHEMA(CloseRebatchingQueue)
     .NumInputs(1)
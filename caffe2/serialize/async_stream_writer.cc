@@ -0,0 +1,147 @@
+#include "caffe2/serialize/async_stream_writer.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <c10/util/Exception.h>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+namespace serialize {
+
+AsyncPyTorchStreamWriter::AsyncPyTorchStreamWriter(
+    std::string archive_name,
+    std::ostream* out,
+    size_t max_pending_bytes)
+    : writer_(std::move(archive_name), out),
+      max_pending_bytes_(max_pending_bytes),
+      thread_([this] { run(); }) {}
+
+void AsyncPyTorchStreamWriter::writeRecord(
+    const std::string& name,
+    const void* data,
+    size_t size) {
+  void* copy = malloc(size);
+  if (size > 0 && copy == nullptr) {
+    CAFFE_THROW("AsyncPyTorchStreamWriter failed to snapshot ", size, " bytes");
+  }
+  if (size > 0) {
+    memcpy(copy, data, size);
+  }
+  writeRecord(name, at::DataPtr(copy, copy, free, at::kCPU), size);
+}
+
+void AsyncPyTorchStreamWriter::writeRecord(
+    const std::string& name,
+    at::DataPtr data,
+    size_t size) {
+  AT_ASSERT(!finalized_);
+  push({name, std::move(data), size, /*end_of_file=*/false});
+}
+
+void AsyncPyTorchStreamWriter::writeEndOfFile() {
+  AT_ASSERT(!finalized_);
+  finalized_ = true;
+  push({"", at::DataPtr(), 0, /*end_of_file=*/true});
+}
+
+void AsyncPyTorchStreamWriter::push(Record record) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (max_pending_bytes_ > 0) {
+    // A record that is larger than the limit on its own still gets written,
+    // once everything before it is.
+    written_cv_.wait(lock, [&] {
+      return error_ || pending_bytes_ == 0 ||
+          pending_bytes_ + record.size <= max_pending_bytes_;
+    });
+  }
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  pending_bytes_ += record.size;
+  queue_.push_back(std::move(record));
+  lock.unlock();
+  queued_cv_.notify_one();
+}
+
+void AsyncPyTorchStreamWriter::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  written_cv_.wait(
+      lock, [this] { return error_ || (queue_.empty() && !writing_); });
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void AsyncPyTorchStreamWriter::run() {
+  while (true) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queued_cv_.wait(lock, [this] { return !queue_.empty() || shutdown_; });
+    if (queue_.empty()) {
+      return;
+    }
+    Record record = std::move(queue_.front());
+    queue_.pop_front();
+    writing_ = true;
+    lock.unlock();
+
+    std::exception_ptr error;
+    try {
+      if (record.end_of_file) {
+        writer_.writeEndOfFile();
+      } else {
+        writer_.writeRecord(record.name, record.data.get(), record.size);
+      }
+    } catch (...) {
+      error = std::current_exception();
+      // Don't let the destructor of writer_ try to finish the archive again.
+      if (!writer_.finalized()) {
+        try {
+          writer_.writeEndOfFile();
+        } catch (...) {
+        }
+      }
+    }
+    // Free the snapshot before waking up writers blocked on the limit
+    record.data.clear();
+
+    lock.lock();
+    writing_ = false;
+    pending_bytes_ -= record.size;
+    if (error && !error_) {
+      error_ = error;
+    }
+    if (error_) {
+      // The archive is unusable after an error, drop everything else.
+      for (const auto& queued : queue_) {
+        pending_bytes_ -= queued.size;
+      }
+      queue_.clear();
+    }
+    lock.unlock();
+    written_cv_.notify_all();
+  }
+}
+
+AsyncPyTorchStreamWriter::~AsyncPyTorchStreamWriter() {
+  try {
+    if (!finalized_) {
+      writeEndOfFile();
+    }
+    wait();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "AsyncPyTorchStreamWriter failed writing "
+               << writer_.archiveName() << ": " << e.what();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  queued_cv_.notify_one();
+  thread_.join();
+}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include <c10/core/Allocator.h>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/inline_container.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// A PyTorchStreamWriter that writes its records from a background thread.
+//
+// writeRecord only takes a snapshot of the record and queues it, so that
+// writing a large checkpoint only blocks the caller for as long as it takes
+// to copy its data in memory, and the CRCs and the writes to the file or
+// stream all happen in the background. The archives it writes are the same as
+// those of PyTorchStreamWriter, whose file format requires records to be
+// written one after the other, so a single thread writes them in the order
+// they were queued.
+//
+// If max_pending_bytes is not zero, writeRecord blocks while the snapshots
+// that were not written yet would take more than that much memory, which
+// bounds the memory overhead of the snapshots at the expense of blocking the
+// caller for part of the writes.
+class CAFFE2_API AsyncPyTorchStreamWriter final {
+ public:
+  AsyncPyTorchStreamWriter(
+      std::string archive_name,
+      std::ostream* out = nullptr,
+      size_t max_pending_bytes = 0);
+  C10_DISABLE_COPY_AND_ASSIGN(AsyncPyTorchStreamWriter);
+
+  // Copies the size bytes at data, and queues them to be written.
+  void writeRecord(const std::string& name, const void* data, size_t size);
+  // Queues the size bytes of data to be written, without copying them. The
+  // caller must not change them until they are written, e.g. because data is
+  // a snapshot already.
+  void writeRecord(const std::string& name, at::DataPtr data, size_t size);
+  // Queues the end of the archive, and returns. No records can be written
+  // afterwards.
+  void writeEndOfFile();
+  // Blocks until everything queued so far is written, and rethrows the first
+  // error the background thread ran into, if any.
+  void wait();
+
+  bool finalized() const {
+    return finalized_;
+  }
+
+  const std::string& archiveName() {
+    return writer_.archiveName();
+  }
+
+  // Finishes writing the archive, logging any errors.
+  ~AsyncPyTorchStreamWriter();
+
+ private:
+  struct Record {
+    std::string name;
+    at::DataPtr data;
+    size_t size;
+    bool end_of_file;
+  };
+
+  void push(Record record);
+  void run();
+
+  PyTorchStreamWriter writer_;
+  const size_t max_pending_bytes_;
+  // Only accessed by the caller's thread
+  bool finalized_ = false;
+
+  // Guards everything below
+  std::mutex mutex_;
+  // Signaled when a record is queued, or the writer is shutting down
+  std::condition_variable queued_cv_;
+  // Signaled when a record was written
+  std::condition_variable written_cv_;
+  std::deque<Record> queue_;
+  // The bytes of the records that are queued or being written
+  size_t pending_bytes_ = 0;
+  // Whether the background thread is writing a record
+  bool writing_ = false;
+  bool shutdown_ = false;
+  std::exception_ptr error_;
+
+  std::thread thread_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -13,6 +13,7 @@
 #include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 #include "caffe2/serialize/read_adapter_interface.h"
 
 #include "miniz.h"
@@ -72,6 +73,7 @@ void PyTorchStreamReader::init() {
   AT_ASSERT(in_ != nullptr);
   AT_ASSERT(ar_ != nullptr);
   memset(ar_.get(), 0, sizeof(mz_zip_archive));
+  mmap_in_ = dynamic_cast<const MmapFileAdapter*>(in_.get());
 
   size_t size = in_->size();
 
@@ -194,6 +196,16 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data");
+  if (mmap_in_ && stat.m_method == 0 &&
+      stat.m_comp_size == stat.m_uncomp_size) {
+    size_t offset = getRecordOffset(name);
+    // Records aren't aligned in archives written before kFieldAlignment was
+    // introduced, in which case they are copied out like without mmap.
+    if (offset % kFieldAlignment == 0) {
+      return std::make_tuple(
+          mmap_in_->alias(offset, stat.m_uncomp_size), stat.m_uncomp_size);
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file");
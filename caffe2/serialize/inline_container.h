@@ -98,10 +98,15 @@ constexpr uint64_t kFileFormatVersion = 0x2L;
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+class MmapFileAdapter;
+
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
   explicit PyTorchStreamReader(std::istream* in);
+  // If `in` is a MmapFileAdapter, records that are stored uncompressed at an
+  // aligned offset (as PyTorchStreamWriter writes them) are returned by
+  // getRecord as DataPtrs aliasing the mapped file, without copying them.
   explicit PyTorchStreamReader(std::unique_ptr<ReadAdapterInterface> in);
 
   // return dataptr, size
@@ -122,6 +127,8 @@ class CAFFE2_API PyTorchStreamReader final {
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
   std::unique_ptr<ReadAdapterInterface> in_;
+  // in_, if it is a MmapFileAdapter
+  const MmapFileAdapter* mmap_in_ = nullptr;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
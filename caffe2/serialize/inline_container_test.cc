@@ -1,10 +1,16 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <algorithm>
+#include <fstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "caffe2/core/common.h"
+#include "caffe2/serialize/async_stream_writer.h"
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -60,6 +66,84 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(AsyncPyTorchStreamWriter, WritesSameArchiveAsPyTorchStreamWriter) {
+  std::vector<std::vector<char>> records;
+  for (size_t size : {127, 64, 0, 1000}) {
+    std::vector<char> record(size);
+    for (size_t i = 0; i < size; ++i) {
+      record[i] = static_cast<char>(size - i);
+    }
+    records.push_back(std::move(record));
+  }
+
+  for (size_t max_pending_bytes : {0, 100}) {
+    std::ostringstream oss;
+    {
+      AsyncPyTorchStreamWriter writer("archive", &oss, max_pending_bytes);
+      for (size_t i = 0; i < records.size(); ++i) {
+        std::vector<char> snapshot = records[i];
+        writer.writeRecord(
+            "key" + std::to_string(i), snapshot.data(), snapshot.size());
+        // The record was copied, so the caller can reuse its memory.
+        std::fill(snapshot.begin(), snapshot.end(), 0);
+      }
+      writer.writeEndOfFile();
+      writer.wait();
+    }
+
+    std::istringstream iss(oss.str());
+    PyTorchStreamReader reader(&iss);
+    for (size_t i = 0; i < records.size(); ++i) {
+      at::DataPtr data_ptr;
+      int64_t size;
+      std::tie(data_ptr, size) = reader.getRecord("key" + std::to_string(i));
+      ASSERT_EQ(size, records[i].size());
+      ASSERT_EQ(memcmp(data_ptr.get(), records[i].data(), size), 0);
+      ASSERT_EQ(reader.getRecordOffset("key" + std::to_string(i)) % 64, 0);
+    }
+  }
+}
+
+#ifndef _WIN32
+TEST(PyTorchStreamWriterAndReader, LoadFromMmapFileAdapter) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer(&oss);
+  std::array<char, 127> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = data1.size() - i;
+  }
+  writer.writeRecord("key1", data1.data(), data1.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  const char* file_name = "output_mmap.zip";
+  std::ofstream foo(file_name, std::ios::binary);
+  foo.write(the_file.c_str(), the_file.size());
+  foo.close();
+
+  at::DataPtr data_ptr, other_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(make_unique<MmapFileAdapter>(file_name));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(size, data1.size());
+    ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+    // Records alias the mapping instead of being copied out of it.
+    std::tie(other_ptr, size) = reader.getRecord("key1");
+    ASSERT_EQ(data_ptr.get(), other_ptr.get());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % kFieldAlignment, 0);
+  }
+  // The records keep the mapping alive after the reader is gone, and writing
+  // to them doesn't change the file.
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  ASSERT_EQ(static_cast<char*>(other_ptr.get())[0], 0);
+  PyTorchStreamReader reader(make_unique<MmapFileAdapter>(file_name));
+  std::tie(other_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(other_ptr.get(), data1.data(), data1.size()), 0);
+  std::remove(file_name);
+}
+#endif // _WIN32
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
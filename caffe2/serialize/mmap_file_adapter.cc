@@ -0,0 +1,98 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapFileAdapter::Mapping {
+  void* base = nullptr;
+  size_t size = 0;
+
+  ~Mapping() {
+#ifndef _WIN32
+    if (base != nullptr) {
+      munmap(base, size);
+    }
+#endif
+  }
+};
+
+namespace {
+// The context of a DataPtr aliasing a mapping, which keeps it alive.
+struct MappingRef {
+  std::shared_ptr<void> mapping;
+};
+
+void deleteMappingRef(void* ctx) {
+  delete static_cast<MappingRef*>(ctx);
+}
+} // namespace
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name)
+    : mapping_(std::make_shared<Mapping>()) {
+#ifdef _WIN32
+  AT_ERROR("memory-mapping files is not supported on Windows, file path: ",
+           file_name);
+#else
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    close(fd);
+    AT_ERROR("unable to stat the file, file path: ", file_name);
+  }
+  mapping_->size = file_stat.st_size;
+  if (mapping_->size > 0) {
+    void* base = mmap(
+        nullptr, mapping_->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+      close(fd);
+      AT_ERROR("unable to mmap the file, file path: ", file_name, ": ",
+               std::strerror(errno));
+    }
+    mapping_->base = base;
+  }
+  // The mapping doesn't need the file descriptor.
+  close(fd);
+#endif
+}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  AT_ASSERTM(
+      pos <= mapping_->size && n <= mapping_->size - pos,
+      "reading past the end of the mapped file while ", what);
+  memcpy(buf, static_cast<char*>(mapping_->base) + pos, n);
+  return n;
+}
+
+at::DataPtr MmapFileAdapter::alias(uint64_t pos, size_t n) const {
+  AT_ASSERTM(
+      pos <= mapping_->size && n <= mapping_->size - pos,
+      "aliasing past the end of the mapped file");
+  void* data = static_cast<char*>(mapping_->base) + pos;
+  return at::DataPtr(
+      data, new MappingRef{mapping_}, deleteMappingRef, at::kCPU);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
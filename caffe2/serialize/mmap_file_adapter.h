@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <c10/core/Allocator.h>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// A reader that memory-maps its file instead of reading it through a stream.
+//
+// Besides the ReadAdapterInterface, it can hand out DataPtrs that alias the
+// mapped pages, which PyTorchStreamReader::getRecord returns for records it
+// doesn't need to decompress. Loading a module from such an adapter then
+// doesn't read its tensors until they are used, and their pages are shared
+// through the page cache with every other process that maps the same file.
+//
+// The mapping is private (copy-on-write): writing to an aliased DataPtr
+// copies the page it writes to, and never changes the file. The mapping lives
+// as long as the adapter or any DataPtr aliasing it does. Changing or
+// truncating the file while it is mapped is undefined behavior, as with any
+// mmap.
+//
+// Only supported on platforms with mmap (i.e. not on Windows).
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  // Returns a CPU DataPtr to the n bytes at pos in the mapping.
+  at::DataPtr alias(uint64_t pos, size_t n) const;
+  ~MmapFileAdapter();
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
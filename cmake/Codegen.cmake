@@ -119,6 +119,14 @@ if (INTERN_BUILD_ATEN_OPS)
     ENDIF(MSVC)
   ENDIF(CXX_AVX2_FOUND)
 
+  # The AVX-512 specializations of Vec256 rely on GCC-style intrinsics, so
+  # there is no AVX512 capability on MSVC.
+  IF(CXX_AVX512_FOUND AND CXX_AVX2_FOUND AND NOT MSVC)
+    SET(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DHAVE_AVX512_CPU_DEFINITION")
+    LIST(APPEND CPU_CAPABILITY_NAMES "AVX512")
+    LIST(APPEND CPU_CAPABILITY_FLAGS "${OPT_FLAG} -mavx512f -mavx512dq -mavx512vl -mavx512bw -mfma")
+  ENDIF()
+
   list(LENGTH CPU_CAPABILITY_NAMES NUM_CPU_CAPABILITY_NAMES)
   math(EXPR NUM_CPU_CAPABILITY_NAMES "${NUM_CPU_CAPABILITY_NAMES}-1")
 
@@ -25,6 +25,20 @@ SET(AVX2_CODE "
   }
 ")
 
+SET(AVX512_CODE "
+  #include <immintrin.h>
+
+  int main()
+  {
+    __m512i a = _mm512_set1_epi16(1);
+    __mmask32 m = _mm512_cmpeq_epi16_mask(a, a); // avx512bw
+    __m512i b = _mm512_movm_epi64((__mmask8)m); // avx512dq
+    __m256i c = _mm256_abs_epi64(_mm512_extracti64x4_epi64(b, 0)); // avx512vl
+    (void)c;
+    return 0;
+  }
+")
+
 MACRO(CHECK_SSE lang type flags)
   SET(__FLAG_I 1)
   SET(CMAKE_REQUIRED_FLAGS_SAVE ${CMAKE_REQUIRED_FLAGS})
@@ -59,3 +73,4 @@ CHECK_SSE(C "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
 
 CHECK_SSE(CXX "AVX" " ;-mavx;/arch:AVX")
 CHECK_SSE(CXX "AVX2" " ;-mavx2 -mfma;/arch:AVX2")
+CHECK_SSE(CXX "AVX512" " ;-mavx512f -mavx512dq -mavx512vl -mavx512bw -mfma")
@@ -798,6 +798,7 @@ if __name__ == '__main__':
                 'include/torch/csrc/cuda/*.h',
                 'include/torch/csrc/jit/*.h',
                 'include/torch/csrc/jit/generated/*.h',
+                'include/torch/csrc/jit/mobile/*.h',
                 'include/torch/csrc/jit/passes/*.h',
                 'include/torch/csrc/jit/passes/utils/*.h',
                 'include/torch/csrc/jit/script/*.h',
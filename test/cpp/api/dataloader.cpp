@@ -8,9 +8,11 @@
 #include <test/cpp/api/support.h>
 
 #include <c10/util/ArrayRef.h>
+#include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -221,6 +223,36 @@ TEST(DataTest, OrderedSequencerReOrdersValues) {
   }
 }
 
+TEST(DataTest, BoundedSequencerReturnsValuesWithinWindow) {
+  using namespace torch::data::detail::sequencers; // NOLINT
+  struct S {
+    size_t sequence_number;
+  };
+  const size_t kMaxJobs = 5;
+  BoundedSequencer<S> sequencer(kMaxJobs, /*window=*/1);
+  ASSERT_EQ(sequencer.buffer_.size(), kMaxJobs + 1);
+
+  std::vector<size_t> v = {1, 3, 2, 4, 0};
+  size_t index = 0;
+  auto getter = [&v, &index]() { return S{v.at(index++)}; };
+
+  // 0 is missing, but 1 is within the window, so it is returned right away.
+  ASSERT_EQ(1, sequencer.next(getter).value().sequence_number);
+  ASSERT_EQ(index, 1);
+
+  // 2, 3 and 4 are too far ahead while 0 is missing.
+  ASSERT_EQ(0, sequencer.next(getter).value().sequence_number);
+  ASSERT_EQ(index, 5);
+  ASSERT_EQ(sequencer.oldest_sequence_number_, 2);
+
+  // The rest come in order from the buffer.
+  for (size_t i = 2; i <= 4; ++i) {
+    ASSERT_EQ(i, sequencer.next(getter).value().sequence_number);
+    ASSERT_EQ(index, 5);
+  }
+  ASSERT_EQ(sequencer.oldest_sequence_number_, 5);
+}
+
 TEST(DataTest, BatchLambdaAppliesFunctionToBatch) {
   using InputBatch = std::vector<int>;
   using OutputBatch = std::string;
@@ -479,6 +511,67 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+TEST(DataTest, StackedDatasetWritesExamplesIntoBatch) {
+  struct D : public datasets::StackedDataset<D> {
+    Example<> example_layout() override {
+      return {torch::empty(4), torch::empty({}, torch::kLong)};
+    }
+
+    void get_into(size_t index, Example<> slot) override {
+      slot.data.copy_(tensor[index]);
+      slot.target.fill_(static_cast<int64_t>(index));
+    }
+
+    torch::optional<size_t> size() const override {
+      return tensor.size(0);
+    }
+
+    torch::Tensor tensor{torch::eye(4)};
+  };
+
+  D d;
+  Example<> batch = d.get_batch({3, 1, 2});
+  ASSERT_EQ(batch.data.sizes().vec(), std::vector<int64_t>({3, 4}));
+  ASSERT_TRUE(batch.data.allclose(torch::eye(4).index_select(
+      0, torch::tensor({3, 1, 2}, torch::kLong))));
+  ASSERT_TRUE(batch.target.equal(torch::tensor({3, 1, 2}, torch::kLong)));
+
+  // The DataLoader gets its batches without any collation transform.
+  auto data_loader = torch::data::make_data_loader(
+      D(), samplers::SequentialSampler(4), DataLoaderOptions(2).workers(2));
+  int64_t index = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.allclose(torch::eye(4).slice(0, index, index + 2)));
+    index += 2;
+  }
+  ASSERT_EQ(index, 4);
+}
+
+TEST(DataTest, StackedDatasetWorksForTensorExample) {
+  struct D : public datasets::StackedDataset<D, TensorExample> {
+    TensorExample example_layout() override {
+      return torch::empty({2, 2}, torch::kInt);
+    }
+
+    void get_into(size_t index, TensorExample slot) override {
+      slot.data.fill_(static_cast<int64_t>(index));
+    }
+
+    torch::optional<size_t> size() const override {
+      return 100;
+    }
+  };
+
+  std::vector<size_t> indices(64);
+  std::iota(indices.begin(), indices.end(), size_t(10));
+  TensorExample batch = D().get_batch(indices);
+  ASSERT_EQ(batch.data.sizes().vec(), std::vector<int64_t>({64, 2, 2}));
+  ASSERT_EQ(batch.data.scalar_type(), torch::kInt);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    ASSERT_TRUE(batch.data[i].equal(torch::full({2, 2}, 10 + i, torch::kInt)));
+  }
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -1449,6 +1542,48 @@ TEST(DataLoaderTest, TestExceptionsArePropagatedFromWorkers) {
   }
 }
 
+TEST(DataLoaderTest, MovesBatchesToDevice) {
+  auto dataset = datasets::TensorDataset(torch::arange(10, torch::kFloat))
+                     .map(transforms::Stack<TensorExample>());
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        dataset,
+        samplers::SequentialSampler(10),
+        DataLoaderOptions(5).workers(workers).device(torch::kCPU));
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.device().is_cpu());
+      ASSERT_EQ(batch.data.size(0), 5);
+      ASSERT_EQ(batch.data[0].item<float>(), expected);
+      expected += 5;
+    }
+    ASSERT_EQ(expected, 10);
+  }
+}
+
+TEST(DataLoaderTest, PrefetchesBatchesToDevice_CUDA) {
+  const int64_t kExamples = 64;
+  auto dataset =
+      datasets::TensorDataset(torch::arange(kExamples, torch::kFloat))
+          .map(transforms::Stack<TensorExample>());
+  for (size_t workers : {0, 1, 3}) {
+    auto data_loader = torch::data::make_data_loader(
+        dataset,
+        samplers::SequentialSampler(kExamples),
+        DataLoaderOptions(8).workers(workers).device(torch::kCUDA));
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.device().is_cuda());
+      // Reading the batch on the current stream has to see the copy that was
+      // issued on the side stream of the worker.
+      auto sum = batch.data.sum().item<float>();
+      ASSERT_EQ(sum, 8 * expected + 28);
+      expected += 8;
+    }
+    ASSERT_EQ(expected, kExamples);
+  }
+}
+
 TEST(DataLoaderTest, StatefulDatasetWithNoWorkers) {
   const int kNumberOfExamplesAfterWhichTheDatasetExhausts = 10;
 
@@ -1880,4 +2015,102 @@ TEST(DataLoaderTest, ChunkDatasetDoesNotHang) {
   // to fill the batch buffer but it is not draining. Still we need to exit
   // cleanly.
   auto iterator = data_loader->begin();
-}
\ No newline at end of file
+}
+namespace {
+void write_tensor(const std::string& path, const torch::Tensor& tensor) {
+  std::ofstream file(path, std::ios::binary);
+  file.write(
+      reinterpret_cast<const char*>(tensor.data_ptr()),
+      tensor.numel() * tensor.element_size());
+}
+} // namespace
+
+TEST(DataLoaderTest, MappedChunkDataReaderWithFixedShape) {
+  auto first = c10::make_tempfile();
+  auto second = c10::make_tempfile();
+  write_tensor(first.name, torch::arange(0, 12, torch::kFloat));
+  write_tensor(second.name, torch::arange(12, 20, torch::kFloat));
+
+  datasets::MappedChunkDataReader reader(
+      {first.name, second.name}, torch::kFloat, {2, 2});
+  ASSERT_EQ(reader.chunk_count(), 2);
+  ASSERT_EQ(reader.example_count(0), 3);
+  ASSERT_EQ(reader.example_count(1), 2);
+
+  auto chunk = reader.read_chunk(1);
+  ASSERT_EQ(chunk.size(), 2);
+  ASSERT_EQ(chunk[0].sizes().vec(), std::vector<int64_t>({2, 2}));
+  ASSERT_TRUE(chunk[1].equal(
+      torch::arange(16, 20, torch::kFloat).view({2, 2})));
+  // Examples are views of the same mapping rather than copies.
+  ASSERT_EQ(
+      static_cast<float*>(chunk[1].data_ptr()),
+      static_cast<float*>(chunk[0].data_ptr()) + 4);
+  ASSERT_TRUE(
+      reader.get(0, 2).equal(torch::arange(8, 12, torch::kFloat).view({2, 2})));
+  ASSERT_THROWS_WITH(reader.get(1, 2), "out of range");
+
+  auto unaligned = c10::make_tempfile();
+  write_tensor(unaligned.name, torch::arange(0, 6, torch::kFloat));
+  ASSERT_THROWS_WITH(
+      datasets::MappedChunkDataReader({unaligned.name}, torch::kFloat, {4}),
+      "whole number of examples");
+}
+
+TEST(DataLoaderTest, MappedChunkDataReaderWithIndex) {
+  auto shard = c10::make_tempfile();
+  auto index = c10::make_tempfile();
+  write_tensor(shard.name, torch::arange(0, 10, torch::kInt));
+  write_tensor(index.name, torch::tensor({0, 1, 4, 4, 9}, torch::kLong));
+
+  datasets::MappedChunkDataReader reader(
+      {shard.name}, {index.name}, torch::kInt);
+  ASSERT_EQ(reader.chunk_count(), 1);
+  ASSERT_EQ(reader.example_count(0), 4);
+  auto chunk = reader.read_chunk(0);
+  ASSERT_EQ(chunk.size(), 4);
+  ASSERT_EQ(chunk[0].numel(), 1);
+  ASSERT_TRUE(chunk[1].equal(torch::arange(1, 4, torch::kInt)));
+  ASSERT_EQ(chunk[2].numel(), 0);
+  ASSERT_TRUE(chunk[3].equal(torch::arange(4, 9, torch::kInt)));
+
+  auto bad_index = c10::make_tempfile();
+  write_tensor(bad_index.name, torch::tensor({0, 11}, torch::kLong));
+  ASSERT_THROWS_WITH(
+      datasets::MappedChunkDataReader(
+          {shard.name}, {bad_index.name}, torch::kInt),
+      "only holds 10");
+}
+
+TEST(DataLoaderTest, ChunkDatasetWithMappedChunkDataReader) {
+  std::vector<c10::TempFile> shards;
+  std::vector<std::string> paths;
+  // TempFile unlinks its file when destroyed, so don't let shards reallocate.
+  shards.reserve(3);
+  for (int64_t i = 0; i < 3; ++i) {
+    shards.push_back(c10::make_tempfile());
+    paths.push_back(shards.back().name);
+    write_tensor(
+        paths.back(), torch::arange(i * 10, (i + 1) * 10, torch::kLong));
+  }
+
+  datasets::MappedChunkDataReader reader(paths, torch::kLong, {1});
+  samplers::SequentialSampler sampler(0);
+  auto dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+      datasets::MappedChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>(
+      reader, sampler, sampler, datasets::ChunkDatasetOptions(2, 4));
+
+  auto data_loader = torch::data::make_data_loader(
+      dataset.map(transforms::BatchLambda<std::vector<torch::Tensor>, int64_t>(
+          [](std::vector<torch::Tensor> batch) {
+            return torch::stack(batch).sum().item<int64_t>();
+          })),
+      DataLoaderOptions(4).workers(0));
+  int64_t sum = 0;
+  for (auto batch : *data_loader) {
+    sum += batch;
+  }
+  ASSERT_EQ(sum, 435); // sum([0, 30))
+}
@@ -5,6 +5,9 @@
 #include <torch/types.h>
 #include <torch/utils.h>
 
+#include <torch/csrc/autograd/functions/checkpoint.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
 #include <test/cpp/api/support.h>
 
 TEST(NoGradTest, SetsGradModeCorrectly) {
@@ -41,4 +44,36 @@ TEST_F(AutogradTest, CanTakeDerivativesOfZeroDimTensors) {
 TEST_F(AutogradTest, CanPassCustomGradientInputs) {
   z.sum().backward(torch::ones({}) * 2);
   ASSERT_TRUE(x.grad().allclose(y * 2));
-}
\ No newline at end of file
+}
+
+TEST_F(AutogradTest, CheckpointRecomputesForward) {
+  using torch::autograd::as_variable_ref;
+  using torch::autograd::variable_list;
+  auto w = torch::randn({3, 3}, torch::requires_grad());
+  int calls = 0;
+  auto fn = [&](const variable_list& inputs) -> variable_list {
+    ++calls;
+    return {as_variable_ref(inputs[0].mm(w).tanh())};
+  };
+  auto outputs = torch::autograd::checkpoint(fn, {as_variable_ref(x)});
+  ASSERT_EQ(calls, 1);
+  outputs[0].sum().backward();
+  ASSERT_EQ(calls, 2);
+
+  auto x2 = x.detach().requires_grad_();
+  auto w2 = w.detach().requires_grad_();
+  x2.mm(w2).tanh().sum().backward();
+  ASSERT_TRUE(x.grad().allclose(x2.grad()));
+  ASSERT_TRUE(w.grad().allclose(w2.grad()));
+}
+
+TEST_F(AutogradTest, OffloadsSavedVariables_CUDA) {
+  auto a = torch::randn({3, 3}, torch::device(torch::kCUDA).requires_grad(true));
+  torch::Tensor b;
+  {
+    torch::autograd::AutoOffloadSavedVariables offload(true);
+    b = a.exp().exp();
+  }
+  b.sum().backward();
+  ASSERT_TRUE(a.grad().allclose(a.exp() * a.exp().exp()));
+}
@@ -647,6 +647,74 @@ TEST_F(ModuleTest, NamedBuffersReturnsExpectedTensorsForFlatModel) {
   ASSERT_EQ(buffers[1]->data<float>(), module.b2.data<float>());
 }
 
+TEST_F(ModuleTest, RecursiveAccessorsSeeLaterRegistrations) {
+  struct Growing : torch::nn::Module {
+    void add_parameter(const std::string& name) {
+      register_parameter(name, torch::ones(2));
+    }
+    void add_buffer(const std::string& name) {
+      register_buffer(name, torch::ones(2));
+    }
+    std::shared_ptr<Growing> add_child(const std::string& name) {
+      return register_module(name, std::make_shared<Growing>());
+    }
+  };
+
+  auto root = std::make_shared<Growing>();
+  auto child = root->add_child("child");
+  ASSERT_EQ(root->parameters().size(), 0);
+  ASSERT_EQ(root->named_buffers().size(), 0);
+
+  child->add_parameter("a");
+  ASSERT_EQ(root->parameters().size(), 1);
+  ASSERT_EQ(root->named_parameters()[0].key(), "child.a");
+
+  auto grandchild = child->add_child("grandchild");
+  grandchild->add_buffer("b");
+  ASSERT_EQ(root->buffers().size(), 1);
+  ASSERT_EQ(root->named_buffers()[0].key(), "child.grandchild.b");
+
+  // Repeated calls return the same tensors
+  auto first = root->parameters();
+  auto second = root->parameters();
+  ASSERT_TRUE(first[0].is_same(second[0]));
+}
+
+TEST_F(ModuleTest, FlattenParameterStorage) {
+  torch::nn::Sequential model(Linear(3, 4), Linear(4, 2));
+  auto input = torch::randn({5, 3});
+  auto expected = model->forward(input);
+
+  auto flat = model->flatten_parameter_storage();
+  auto parameters = model->parameters();
+  int64_t numel = 0;
+  for (const auto& parameter : parameters) {
+    // Every parameter is a view into the flat tensor
+    ASSERT_EQ(parameter.data<float>(), flat.data<float>() + numel);
+    numel += parameter.numel();
+  }
+  ASSERT_EQ(flat.numel(), numel);
+  ASSERT_TRUE(model->forward(input).allclose(expected));
+
+  model->forward(input).sum().backward();
+  std::vector<torch::Tensor> grads;
+  for (const auto& parameter : parameters) {
+    grads.push_back(parameter.grad().flatten());
+  }
+  ASSERT_TRUE(flat.grad().allclose(torch::cat(grads)));
+  ASSERT_NE(flat.grad().abs().sum().item<float>(), 0);
+
+  {
+    torch::NoGradGuard no_grad;
+    flat.zero_();
+  }
+  for (const auto& parameter : parameters) {
+    ASSERT_EQ(parameter.abs().sum().item<float>(), 0);
+  }
+  model->zero_grad();
+  ASSERT_EQ(flat.grad().abs().sum().item<float>(), 0);
+}
+
 struct TestContainer : torch::nn::Module {
   TestContainer(int64_t number, std::vector<TestContainer> modules = {})
       : tensor(torch::tensor(number)) {
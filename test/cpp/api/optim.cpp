@@ -271,6 +271,62 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+template <typename OptimizerClass, typename Options>
+void check_cuda_matches_cpu(Options options) {
+  torch::manual_seed(0);
+
+  // More parameters than fit in one launch of the fused kernels, and one that
+  // spans several chunks
+  std::vector<torch::Tensor> cpu_parameters;
+  for (int64_t i = 0; i < 150; ++i) {
+    cpu_parameters.push_back(torch::randn({i + 1}, torch::kFloat64));
+  }
+  cpu_parameters.push_back(torch::randn({300, 700}, torch::kFloat64));
+  std::vector<torch::Tensor> cuda_parameters;
+  for (auto& parameter : cpu_parameters) {
+    cuda_parameters.push_back(parameter.to(torch::kCUDA).set_requires_grad(true));
+    parameter.set_requires_grad(true);
+  }
+
+  OptimizerClass cpu_optimizer(cpu_parameters, options);
+  OptimizerClass cuda_optimizer(cuda_parameters, options);
+  for (int step = 0; step < 3; ++step) {
+    cpu_optimizer.zero_grad();
+    cuda_optimizer.zero_grad();
+    for (size_t p = 0; p < cpu_parameters.size(); ++p) {
+      // Leave some parameters without a gradient at the first step
+      if (step == 0 && p % 7 == 0) {
+        continue;
+      }
+      auto grad = torch::randn_like(cpu_parameters[p]);
+      (cpu_parameters[p] * grad).sum().backward();
+      (cuda_parameters[p] * grad.to(torch::kCUDA)).sum().backward();
+    }
+    cpu_optimizer.step();
+    cuda_optimizer.step();
+    for (size_t p = 0; p < cpu_parameters.size(); ++p) {
+      ASSERT_TRUE(cuda_parameters[p].cpu().allclose(cpu_parameters[p]));
+    }
+  }
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_Adam_CUDA) {
+  check_cuda_matches_cpu<Adam>(AdamOptions(0.1).weight_decay(1e-2));
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_AdamWithAmsgrad_CUDA) {
+  check_cuda_matches_cpu<Adam>(AdamOptions(0.1).amsgrad(true));
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_SGD_CUDA) {
+  check_cuda_matches_cpu<SGD>(SGDOptions(0.1).weight_decay(1e-2));
+}
+
+TEST(OptimTest, FusedStepMatchesCPU_SGDWithNesterovMomentum_CUDA) {
+  check_cuda_matches_cpu<SGD>(
+      SGDOptions(0.1).momentum(0.9).dampening(0.1).nesterov(true));
+}
+
 TEST(OptimTest, ZeroGrad) {
   torch::manual_seed(0);
 
@@ -298,6 +354,55 @@ TEST(OptimTest, ZeroGrad) {
   }
 }
 
+TEST(OptimTest, ZeroGradSetToNone) {
+  torch::manual_seed(0);
+
+  Linear model(2, 8);
+  SGD optimizer(model->parameters(), 0.1);
+  std::vector<torch::Tensor> before;
+  for (const auto& parameter : model->parameters()) {
+    before.push_back(parameter.clone());
+  }
+
+  model->forward(torch::ones({5, 2})).sum().backward();
+  optimizer.zero_grad(/*set_to_none=*/true);
+  for (const auto& parameter : model->parameters()) {
+    ASSERT_FALSE(parameter.grad().defined());
+  }
+
+  // Nothing to step on, and the next backward allocates fresh gradients
+  optimizer.step();
+  auto parameters = model->parameters();
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    ASSERT_TRUE(parameters[i].allclose(before[i]));
+  }
+  model->forward(torch::ones({5, 2})).sum().backward();
+  for (const auto& parameter : model->parameters()) {
+    ASSERT_TRUE(parameter.grad().defined());
+    ASSERT_GT(parameter.grad().sum().item<float>(), 0);
+  }
+}
+
+TEST(OptimTest, ZeroGradFlatStorage) {
+  torch::manual_seed(0);
+
+  Sequential model(Linear(2, 8), Linear(8, 1));
+  auto flat = model->flatten_parameter_storage();
+  SGD optimizer(model->parameters(), 0.1);
+
+  model->forward(torch::ones({5, 2})).sum().backward();
+  ASSERT_NE(flat.grad().abs().sum().item<float>(), 0);
+  optimizer.zero_grad();
+  ASSERT_EQ(flat.grad().abs().sum().item<float>(), 0);
+  for (const auto& parameter : model->parameters()) {
+    ASSERT_EQ(parameter.grad().abs().sum().item<float>(), 0);
+  }
+
+  // The views still share the flat gradient
+  model->forward(torch::ones({5, 2})).sum().backward();
+  ASSERT_NE(flat.grad().abs().sum().item<float>(), 0);
+}
+
 TEST(OptimTest, ExternalVectorOfParameters) {
   torch::manual_seed(0);
 
@@ -338,3 +443,35 @@ TEST(OptimTest, AddParameter_LBFGS) {
 
   // REQUIRE this doesn't throw
 }
+
+TEST(OptimTest, StepEmbeddingBag_Adagrad) {
+  torch::manual_seed(0);
+
+  const auto indices = torch::randint(10, {12}, torch::kLong);
+  const auto offsets = torch::tensor({0, 3, 3, 8}, torch::kLong);
+  for (int64_t mode : {0, 1}) {
+    auto dense_weight = torch::randn({10, 4}).set_requires_grad(true);
+    auto fused_weight = dense_weight.detach().clone().set_requires_grad(true);
+    Adagrad dense(
+        std::vector<torch::Tensor>{dense_weight},
+        AdagradOptions(0.1).lr_decay(1e-2));
+    Adagrad fused(
+        std::vector<torch::Tensor>{fused_weight},
+        AdagradOptions(0.1).lr_decay(1e-2));
+
+    for (int step = 0; step < 3; ++step) {
+      const auto grad = torch::randn({offsets.size(0), 4});
+      dense.zero_grad();
+      std::get<0>(torch::embedding_bag(
+                      dense_weight, indices, offsets, false, mode))
+          .backward(grad);
+      dense.step();
+
+      fused.step_embedding_bag(fused_weight, grad, indices, offsets, mode);
+      ASSERT_TRUE(fused_weight.allclose(dense_weight, 1e-5, 1e-6));
+      ASSERT_TRUE(fused.sum_buffers[0].allclose(dense.sum_buffers[0]));
+    }
+    // The gradient of the weight is never formed
+    ASSERT_FALSE(fused_weight.grad().defined());
+  }
+}
@@ -3,7 +3,9 @@
 #include <torch/csrc/autograd/functions/comm.h>
 #include <torch/nn/module.h>
 #include <torch/nn/modules/linear.h>
+#include <torch/nn/modules/sequential.h>
 #include <torch/nn/parallel/data_parallel.h>
+#include <torch/nn/parallel/pipeline.h>
 #include <torch/nn/pimpl.h>
 #include <torch/types.h>
 
@@ -104,6 +106,28 @@ TEST_F(ParallelTest, Replicate_MultiCUDA) {
   }
 }
 
+TEST_F(ParallelTest, ReplicaCacheCopiesModifiedParameters_MultiCUDA) {
+  Linear linear(3, 4);
+  parallel::ReplicaCache<Linear> cache(
+      linear, {{torch::Device(torch::kCUDA, 0), torch::Device(torch::kCUDA, 1)}});
+  auto* replica = cache.replicas()[1].get();
+
+  {
+    torch::NoGradGuard guard;
+    linear->weight.fill_(2);
+  }
+  auto& replicas = cache.replicas();
+  ASSERT_EQ(replicas[1].get(), replica);
+  for (auto& replica : replicas) {
+    ASSERT_TRUE(replica->weight.cpu().allclose(linear->weight));
+    ASSERT_TRUE(replica->bias.cpu().allclose(linear->bias));
+  }
+
+  auto output = parallel::data_parallel(cache, torch::ones({10, 3}));
+  ASSERT_EQ(output.device(), torch::Device(torch::kCUDA, 0));
+  ASSERT_TRUE(output.cpu().allclose(linear(torch::ones({10, 3}))));
+}
+
 TEST_F(ParallelTest, ParallelApply_MultiCUDA) {
   Linear a(3, 4);
 
@@ -223,3 +247,46 @@ TEST_F(ParallelTest, DataParallelUsesAllAvailableCUDADevices_CUDA) {
     ASSERT_EQ(output[i].item<int32_t>(), i);
   }
 }
+
+TEST_F(ParallelTest, PipelineMatchesSequential) {
+  Sequential sequential(Linear(3, 4), Linear(4, 5), Linear(5, 2));
+  auto input = torch::randn({10, 3});
+  auto expected = sequential->forward(input);
+
+  parallel::Pipeline pipeline(
+      sequential,
+      /*devices=*/{torch::Device(torch::kCPU), torch::Device(torch::kCPU)},
+      /*balance=*/{2, 1},
+      /*chunks=*/3);
+  ASSERT_EQ(pipeline.stages().size(), 2);
+  ASSERT_EQ(pipeline.stages()[0]->size(), 2);
+  ASSERT_EQ(pipeline.stages()[1]->size(), 1);
+  ASSERT_TRUE(pipeline.forward(input).allclose(expected));
+
+  ASSERT_THROWS_WITH(
+      parallel::Pipeline(
+          sequential, {torch::Device(torch::kCPU)}, {2}, /*chunks=*/1),
+      "The balance must sum up to the number of modules");
+}
+
+TEST_F(ParallelTest, Pipeline_MultiCUDA) {
+  Sequential sequential(Linear(3, 4), Linear(4, 5), Linear(5, 2));
+  auto input = torch::randn({10, 3});
+  auto expected = sequential->forward(input);
+
+  parallel::Pipeline pipeline(
+      sequential,
+      /*devices=*/
+      {torch::Device(torch::kCUDA, 0), torch::Device(torch::kCUDA, 1)},
+      /*balance=*/{1, 2},
+      /*chunks=*/4);
+  auto output = pipeline.forward(input);
+  ASSERT_EQ(output.device(), torch::Device(torch::kCUDA, 1));
+  ASSERT_TRUE(output.cpu().allclose(expected));
+
+  output.sum().backward();
+  for (auto& parameter : pipeline.stages()[0]->parameters()) {
+    ASSERT_TRUE(parameter.grad().defined());
+    ASSERT_EQ(parameter.grad().device(), torch::Device(torch::kCUDA, 0));
+  }
+}
@@ -400,3 +400,77 @@ TEST(SerializeTest, UnserializableSubmoduleIsIgnoredWhenLoadingModule) {
   // serialization.
   ASSERT_EQ(output, 5);  
 }
+
+TEST(SerializeTest, ShardedCheckpointReshardsOntoDifferentWorldSize) {
+  torch::manual_seed(0);
+  auto weight = torch::randn({10, 3});
+  auto bias = torch::randn({10});
+  auto step = torch::full({}, 7, torch::kInt64);
+
+  auto tempfile = c10::make_tempfile();
+  const int64_t world_size = 3;
+  auto weight_shards = weight.chunk(world_size);
+  int64_t offset = 0;
+  for (int64_t rank = 0; rank < world_size; ++rank) {
+    ShardWriter writer(tempfile.name, rank);
+    writer.write("weight", weight_shards[rank], offset, weight.sizes());
+    // Every rank holds all of `bias` and `step`.
+    writer.write("bias", bias);
+    writer.write("step", step);
+    writer.finish();
+    offset += weight_shards[rank].size(0);
+  }
+  write_sharded_manifest(tempfile.name, world_size);
+
+  ShardedCheckpoint checkpoint(tempfile.name);
+  ASSERT_EQ(checkpoint.world_size(), world_size);
+  ASSERT_EQ(
+      checkpoint.keys(), std::vector<std::string>({"bias", "step", "weight"}));
+  ASSERT_EQ(checkpoint.sizes("weight"), std::vector<int64_t>({10, 3}));
+  ASSERT_FALSE(checkpoint.contains("missing"));
+
+  ASSERT_TRUE(checkpoint.read("weight").equal(weight));
+  ASSERT_TRUE(checkpoint.read("bias").equal(bias));
+  ASSERT_EQ(checkpoint.read("step").item<int64_t>(), 7);
+  // Rows that span the shards of several ranks
+  ASSERT_TRUE(checkpoint.read("weight", 2, 9).equal(weight.slice(0, 2, 9)));
+
+  auto resharded = weight.chunk(2);
+  ASSERT_TRUE(checkpoint.read_shard("weight", 0, 2).equal(resharded[0]));
+  ASSERT_TRUE(checkpoint.read_shard("weight", 1, 2).equal(resharded[1]));
+
+  ASSERT_THROWS_WITH(
+      checkpoint.read("weight", 5, 11), "are out of bounds for 'weight'");
+  ASSERT_THROWS_WITH(
+      checkpoint.read("missing"), "No tensor named 'missing' in the checkpoint");
+
+  for (int64_t rank = 0; rank < world_size; ++rank) {
+    std::remove((tempfile.name + "." + std::to_string(rank)).c_str());
+  }
+}
+
+TEST(SerializeTest, ShardedCheckpointDetectsMissingRows) {
+  auto tensor = torch::arange(8);
+  auto tempfile = c10::make_tempfile();
+  {
+    ShardWriter writer(tempfile.name, 0);
+    writer.write("tensor", tensor.slice(0, 0, 3), 0, tensor.sizes());
+    writer.finish();
+  }
+  {
+    ShardWriter writer(tempfile.name, 1);
+    writer.write("tensor", tensor.slice(0, 5, 8), 5, tensor.sizes());
+    writer.finish();
+  }
+  write_sharded_manifest(tempfile.name, 2);
+
+  ShardedCheckpoint checkpoint(tempfile.name);
+  ASSERT_TRUE(checkpoint.read("tensor", 5, 8).equal(tensor.slice(0, 5, 8)));
+  ASSERT_THROWS_WITH(
+      checkpoint.read("tensor"),
+      "The rows [3, 5) of 'tensor' are missing from the checkpoint");
+
+  for (int64_t rank = 0; rank < 2; ++rank) {
+    std::remove((tempfile.name + "." + std::to_string(rank)).c_str());
+  }
+}
@@ -12,6 +12,7 @@
 #include <test/cpp/jit/test_alias_analysis.h>
 #include <test/cpp/jit/test_argument_spec.h>
 #include <test/cpp/jit/test_autodiff.h>
+#include <test/cpp/jit/test_batching_scheduler.h>
 #include <test/cpp/jit/test_class_import.h>
 #include <test/cpp/jit/test_class_parser.h>
 #include <test/cpp/jit/test_code_template.h>
@@ -68,6 +69,7 @@ namespace jit {
   _(WriteTracking)                 \
   _(Wildcards)                     \
   _(MemoryDAG)                     \
+  _(AliasDbUpdates)                \
   _(IRParser)                      \
   _(ConstantPooling)               \
   _(NetDefConverter)               \
@@ -79,11 +81,13 @@ namespace jit {
   _(InsertGuards)                  \
   _(PeepholeOptimize)              \
   _(RecordFunction)                \
+  _(SamplingProfiler)              \
   _(SubgraphMatching)              \
   _(ModuleDefine)                  \
   _(QualifiedName)                 \
   _(ClassImport)                   \
-  _(ScriptObject)
+  _(ScriptObject)                  \
+  _(BatchingScheduler)
 
 #define TH_FORALL_TESTS_CUDA(_) \
   _(ArgumentSpec)               \
@@ -849,6 +849,69 @@ void testMemoryDAG() {
       AT_ASSERT(!t.mayContainAlias(e, elem));
     }
   }
+
+  {
+    // Memory locations are cached, so make sure that pointers added after a
+    // query are seen by everything that points to the updated element.
+    //
+    // b -> a, then a -> c
+    MemoryDAG t;
+    auto a = t.makeFreshValue(aValue);
+    auto b = t.makeFreshValue(bValue);
+    auto c = t.makeFreshValue(cValue);
+    t.makePointerTo(b, a);
+    ASSERT_TRUE(t.mayAlias(a, b));
+    ASSERT_FALSE(t.mayAlias(b, c));
+
+    t.makePointerTo(a, c);
+    ASSERT_TRUE(t.mayAlias(a, c));
+    ASSERT_TRUE(t.mayAlias(b, c));
+    ASSERT_EQ(b->getMemoryLocations().size(), 1);
+    ASSERT_EQ(*b->getMemoryLocations().begin(), c);
+  }
+}
+
+void testAliasDbUpdates() {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  script::parseIR(
+      R"IR(
+graph(%x : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %y : Tensor = aten::relu(%x)
+  %z : Tensor = aten::add_(%y, %x, %one)
+  return (%z)
+)IR",
+      &*graph,
+      vmap);
+  auto x = vmap["x"];
+  auto y = vmap["y"];
+  auto z = vmap["z"];
+
+  AliasDb aliasDb(graph);
+  ASSERT_TRUE(aliasDb.mayAlias(y, z));
+  ASSERT_TRUE(aliasDb.hasWriters(y->node()));
+
+  // Replace %y with an equivalent value, keeping its aliasing and writes
+  Value* w = nullptr;
+  {
+    WithInsertPoint guard(y->node());
+    w = graph->insert(aten::relu, {x});
+  }
+  y->replaceAllUsesWith(w);
+  aliasDb.replaceWithNewValue(y, w);
+  y->node()->destroy();
+  graph->lint();
+  ASSERT_TRUE(aliasDb.mayAlias(w, z));
+  ASSERT_FALSE(aliasDb.mayAlias(w, x));
+  ASSERT_TRUE(aliasDb.hasWriters(w->node()));
+
+  // A new value gets a fresh memory location that nothing writes to
+  auto v = graph->insert(aten::relu, {x});
+  aliasDb.createValue(v);
+  ASSERT_FALSE(aliasDb.mayAlias(v, w));
+  ASSERT_FALSE(aliasDb.mayAlias(v, x));
+  ASSERT_FALSE(aliasDb.hasWriters(v->node()));
 }
 
 void testAliasRegistration() {
@@ -181,9 +181,10 @@ void testDifferentiate() {
   graph->registerOutput(c.value());
 
   auto grad_spec = differentiate(graph);
+  // a * b is recomputed from the captured inputs instead of being saved
   std::vector<size_t> expected_captured_inputs = {0, 1};
-  std::vector<size_t> expected_captured_outputs = {1, 2};
-  std::vector<size_t> expected_input_vjps = {0, 1};
+  std::vector<size_t> expected_captured_outputs = {1};
+  std::vector<size_t> expected_input_vjps = {0};
   std::vector<size_t> expected_output_vjps = {0, 1};
   ASSERT_EQ(grad_spec.f_real_outputs, 1);
   ASSERT_EQ(grad_spec.df_input_captured_inputs, expected_captured_inputs);
@@ -196,7 +197,8 @@ void testDifferentiate() {
       ->check("aten::add")
       ->run(*grad_spec.f);
   testing::FileCheck()
-      .check("prim::GradOf[name=\"aten::add\"]")
+      .check("aten::mul")
+      ->check("prim::GradOf[name=\"aten::add\"]")
       ->check_count("prim::GradOf[name=\"aten::mul\"]", 2)
       ->check_count("AutogradAdd", 2)
       ->run(*grad_spec.df);
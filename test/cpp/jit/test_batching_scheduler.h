@@ -0,0 +1,112 @@
+#pragma once
+
+#include <test/cpp/jit/test_base.h>
+#include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/jit/batching_scheduler.h>
+
+#include <atomic>
+#include <chrono>
+
+namespace torch {
+namespace jit {
+namespace test {
+
+void testBatchingScheduler() {
+  {
+    // Requests that fill a batch run together, and get their own rows back
+    std::vector<int64_t> batch_sizes;
+    BatchingOptions options;
+    options.max_batch_size = 4;
+    options.max_latency = std::chrono::seconds(60);
+    BatchingScheduler scheduler(
+        [&](std::vector<at::Tensor> inputs) {
+          batch_sizes.push_back(inputs[0].size(0));
+          return std::vector<at::Tensor>{inputs[0] * 2, inputs[1].sum(1)};
+        },
+        options);
+    std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+    for (int i = 0; i < 3; ++i) {
+      futures.push_back(scheduler.schedule(
+          {torch::full({1, 2}, i), torch::full({1, 3}, 1)}));
+    }
+    futures.push_back(scheduler.schedule(
+        {torch::full({1, 2}, 3), torch::full({1, 3}, 1)}));
+    for (int i = 0; i < 4; ++i) {
+      futures[i]->wait();
+      auto outputs = futures[i]->value().toTensorListRef();
+      ASSERT_EQ(outputs.size(), 2);
+      ASSERT_TRUE(outputs[0].equal(torch::full({1, 2}, 2 * i)));
+      ASSERT_TRUE(outputs[1].equal(torch::full({1}, 3)));
+    }
+    ASSERT_EQ(batch_sizes, std::vector<int64_t>({4}));
+  }
+  {
+    // Incomplete batches run after max_latency, and requests of different
+    // sizes only share batches with padding
+    for (bool pad : {false, true}) {
+      std::atomic<int> num_batches{0};
+      BatchingOptions options;
+      options.max_latency = std::chrono::milliseconds(50);
+      options.pad = pad;
+      options.padding_value = -1;
+      BatchingScheduler scheduler(
+          [&](std::vector<at::Tensor> inputs) {
+            num_batches++;
+            return inputs;
+          },
+          options);
+      auto a = scheduler.schedule({torch::ones({1, 2})});
+      auto b = scheduler.schedule({torch::ones({2, 3})});
+      a->wait();
+      b->wait();
+      auto a_outputs = a->value().toTensorListRef();
+      auto b_outputs = b->value().toTensorListRef();
+      ASSERT_EQ(num_batches.load(), pad ? 1 : 2);
+      ASSERT_TRUE(b_outputs[0].equal(torch::ones({2, 3})));
+      if (pad) {
+        ASSERT_TRUE(
+            a_outputs[0].equal(torch::tensor({1.f, 1.f, -1.f}).view({1, 3})));
+      } else {
+        ASSERT_TRUE(a_outputs[0].equal(torch::ones({1, 2})));
+      }
+    }
+  }
+  {
+    // The queue is bounded, errors reach every request of the batch, and
+    // queued requests run when the scheduler stops
+    BatchingOptions options;
+    options.max_latency = std::chrono::seconds(60);
+    options.max_queue_size = 2;
+    c10::intrusive_ptr<c10::ivalue::Future> a, b;
+    {
+      BatchingScheduler scheduler(
+          [](std::vector<at::Tensor> inputs) -> std::vector<at::Tensor> {
+            AT_ERROR("bad batch");
+          },
+          options);
+      a = scheduler.schedule({torch::ones({1})});
+      b = scheduler.schedule({torch::ones({1})});
+      ASSERT_THROWS_WITH(
+          scheduler.schedule({torch::ones({1})}), "queue is full");
+    }
+    ASSERT_TRUE(a->completed() && b->completed());
+    ASSERT_THROWS_WITH(a->value(), "bad batch");
+    ASSERT_THROWS_WITH(b->value(), "bad batch");
+  }
+  {
+    // Batches of a script module
+    auto module = std::make_shared<script::Module>();
+    module->define(R"(
+      def forward(self, x):
+        return x + 1, x.sum(1)
+    )");
+    BatchingScheduler scheduler(module);
+    auto outputs = scheduler.run({torch::zeros({2, 3})});
+    ASSERT_TRUE(outputs[0].equal(torch::ones({2, 3})));
+    ASSERT_TRUE(outputs[1].equal(torch::zeros({2})));
+  }
+}
+
+} // namespace test
+} // namespace jit
+} // namespace torch
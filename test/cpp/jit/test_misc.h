@@ -36,6 +36,7 @@
 #include "torch/csrc/utils/memory.h"
 
 #include "torch/csrc/autograd/engine.h"
+#include "torch/csrc/autograd/sampling_profiler.h"
 #include "torch/csrc/autograd/variable.h"
 
 #include <torch/csrc/jit/testing/file_check.h>
@@ -716,6 +717,42 @@ void testRecordFunction() {
   checkTracedInputs(jit_inputs);
 }
 
+uint64_t sampledCount(const std::string& name) {
+  for (const auto& histogram : autograd::profiler::sampledOpLatencies()) {
+    if (histogram.name == name) {
+      uint64_t in_buckets = 0;
+      for (auto count : histogram.buckets) {
+        in_buckets += count;
+      }
+      TORCH_CHECK(in_buckets == histogram.count);
+      return histogram.count;
+    }
+  }
+  return 0;
+}
+
+void testSamplingProfiler() {
+  auto t = torch::randn({1, 2, 3}, at::kCPU);
+
+  autograd::profiler::enableSamplingProfiler(1.0);
+  for (size_t i = 0; i < 100; ++i) {
+    invokeTestRecordFunction(t);
+  }
+  TORCH_CHECK(sampledCount("test") == 100);
+  TORCH_CHECK(sampledCount("pow") == 100);
+  autograd::profiler::disableSamplingProfiler();
+
+  autograd::profiler::enableSamplingProfiler(0.5);
+  TORCH_CHECK(sampledCount("test") == 0);
+  for (size_t i = 0; i < 1000; ++i) {
+    invokeTestRecordFunction(t);
+  }
+  auto sampled = sampledCount("test");
+  TORCH_CHECK(sampled > 300 && sampled < 700);
+  autograd::profiler::disableSamplingProfiler();
+  TORCH_CHECK(autograd::profiler::getSamplingProbability() == 1.0);
+}
+
 void testAutogradProfiler() {
   constexpr int batch_size = 4;
   constexpr int input_size = 256;
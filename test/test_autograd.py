@@ -1,5 +1,7 @@
 import contextlib
 import gc
+import os
+import subprocess
 import sys
 import math
 import tempfile
@@ -1979,6 +1981,26 @@ class TestAutograd(TestCase):
         self.assertEqual(x.grad, torch.ones(5, 5) * 34)
         self.assertEqual(y.grad, torch.ones(5, 5) * 17)
 
+    def test_backward_accumulate_inplace(self):
+        # Gradients of a variable with many consumers are summed in-place
+        # when nobody else can see them, but never into grad_outputs, into
+        # gradients returned several times, or when create_graph=True.
+        x = torch.ones(5, 5, requires_grad=True)
+        a = x * 2
+        out = sum(a * i for i in range(10)) + a + a
+        grad_output = torch.ones(5, 5)
+        out.backward(grad_output)
+        self.assertEqual(x.grad, torch.ones(5, 5) * 94)
+        self.assertEqual(grad_output, torch.ones(5, 5))
+
+        x.grad = None
+        a = x * x
+        out = sum(a * i for i in range(10))
+        grad_x, = torch.autograd.grad(out.sum(), x, create_graph=True)
+        self.assertEqual(grad_x, torch.ones(5, 5) * 90)
+        grad_x.sum().backward()
+        self.assertEqual(x.grad, torch.ones(5, 5) * 90)
+
     def test_save_none_for_backward(self):
         test_case = self
 
@@ -2068,6 +2090,72 @@ class TestAutograd(TestCase):
             y = x * 2
         self.assertTrue(y.requires_grad)
 
+    def test_cache_factories(self):
+        with torch.autograd.cache_factories():
+            a = torch.ones(2, 3)
+            self.assertIs(a, torch.ones(2, 3))
+            self.assertIsNot(a, torch.ones(3, 2))
+            self.assertIsNot(a, torch.ones(2, 3, dtype=torch.double))
+            self.assertIsNot(a, torch.zeros(2, 3))
+            # the dtype arange infers depends on the kind of its arguments
+            self.assertEqual(torch.arange(5).dtype, torch.int64)
+            self.assertEqual(torch.arange(5.).dtype, torch.get_default_dtype())
+            self.assertEqual(torch.arange(5, dtype=torch.get_default_dtype()).dtype,
+                             torch.get_default_dtype())
+            # in-place modifications, also through views, invalidate the cache
+            a[0].add_(1)
+            b = torch.ones(2, 3)
+            self.assertIsNot(a, b)
+            self.assertEqual(b, torch.full((2, 3), 1))
+            # tensors that require grad are never cached
+            c = torch.ones(3, requires_grad=True)
+            self.assertIsNot(c, torch.ones(3, requires_grad=True))
+            d = torch.ones(3)
+            d.requires_grad_()
+            self.assertIsNot(d, torch.ones(3))
+            with torch.autograd.cache_factories():
+                self.assertIs(b, torch.ones(2, 3))
+            self.assertIs(b, torch.ones(2, 3))
+        self.assertIsNot(b, torch.ones(2, 3))
+
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_autocast(self):
+        a = torch.randn(4, 4, device='cuda')
+        w = torch.randn(4, 4, device='cuda', requires_grad=True)
+        expected = a.mm(w.detach())
+        self.assertFalse(torch._C._is_autocast_enabled())
+        with torch.autograd.autocast():
+            self.assertTrue(torch._C._is_autocast_enabled())
+            b = torch.mm(a, w)
+            self.assertEqual(b.dtype, torch.half)
+            self.assertEqual(b.float(), expected, prec=1e-2)
+            # composite functions see the types chosen for them
+            self.assertEqual(torch.nn.functional.linear(a, w).dtype, torch.half)
+            c = torch.softmax(b, 1)
+            self.assertEqual(c.dtype, torch.float)
+            self.assertEqual(torch.cat([b, a]).dtype, torch.float)
+            self.assertEqual(torch.cat([b, b]).dtype, torch.half)
+            # integer and CPU tensors are never cast
+            self.assertEqual(torch.ones(3, dtype=torch.long, device='cuda').sum().dtype, torch.long)
+            self.assertEqual(torch.mm(a.cpu(), a.cpu()).dtype, torch.float)
+            # in-place functions are never cast
+            self.assertEqual(a.clone().addmm_(a, a).dtype, torch.float)
+            with torch.autograd.autocast(enabled=False):
+                self.assertEqual(torch.mm(a, w).dtype, torch.float)
+            # the cast of the weight is reused...
+            d = torch.mm(a, w)
+            self.assertIs(b.grad_fn.next_functions[1][0], d.grad_fn.next_functions[1][0])
+            # ...until it is modified in-place
+            with torch.no_grad():
+                w.add_(1)
+            e = torch.mm(a, w)
+            self.assertIsNot(b.grad_fn.next_functions[1][0], e.grad_fn.next_functions[1][0])
+        self.assertFalse(torch._C._is_autocast_enabled())
+        self.assertEqual(torch.mm(a, w).dtype, torch.float)
+        (c.sum() + d.float().sum()).backward()
+        self.assertEqual(w.grad.dtype, torch.float)
+        self.assertEqual(w.grad.size(), w.size())
+
     def test_reentrant(self):
         y_data = torch.randn(2, 2)
 
@@ -2091,6 +2179,31 @@ class TestAutograd(TestCase):
         out.sum().backward()
         self.assertEqual(x.grad.data, y_data)
 
+    def test_multiple_cpu_workers(self):
+        # The number of CPU workers is fixed when the engine starts, so this
+        # runs in a fresh process.
+        script = """
+import torch
+from torch.utils.checkpoint import checkpoint
+
+x = torch.randn(8, 8, requires_grad=True)
+towers = [torch.randn(8, 8) for _ in range(16)]
+with torch.no_grad():
+    expected = sum((1 - x.mm(w).tanh() ** 2).mm(w.t()) for w in towers)
+
+for use_checkpoint in [False, True]:
+    x.grad = None
+    # checkpoint runs a reentrant backward for every tower
+    outs = [(checkpoint(torch.mm, x, w) if use_checkpoint else x.mm(w)).tanh().sum()
+            for w in towers]
+    sum(outs).backward()
+    assert torch.allclose(x.grad, expected, atol=1e-5), use_checkpoint
+print('ok')
+"""
+        env = dict(os.environ, TORCH_AUTOGRAD_CPU_THREADS='4')
+        output = subprocess.check_output([sys.executable, '-c', script], env=env)
+        self.assertEqual(output.decode().strip(), 'ok')
+
     def test_broadcast_tensors(self):
         f_args_variable = (torch.randn(3, requires_grad=True),
                            torch.randn(1, 2, 1, requires_grad=True),
@@ -2162,6 +2275,24 @@ class TestAutograd(TestCase):
             run_functional_checks(self, "test_cdist", "cdist", f,
                                   True, f_args_variable, f_args_tensor)
 
+    def test_cdist_batched(self):
+        for p in [0, 1, 2, 3, 1.5, 2.5, float('inf')]:
+            a = torch.randn(2, 1, S, S, requires_grad=True)
+            b = torch.randn(3, S - 1, S, requires_grad=True)
+            self.assertTrue(gradcheck(lambda a, b: torch.cdist(a, b, p), (a, b)))
+
+        # large enough inputs take the matrix multiplication path for p=2
+        a = torch.randn(2, 30, 3, requires_grad=True)
+        b = torch.randn(2, 27, 3, requires_grad=True)
+        self.assertTrue(gradcheck(lambda a, b: torch.cdist(a, b), (a, b)))
+        self.assertTrue(gradgradcheck(lambda a, b: torch.cdist(a, b), (a, b)))
+
+        # coincident points have zero gradient on both paths
+        for r in [S, 30]:
+            a = torch.randn(r, 3, requires_grad=True)
+            torch.cdist(a, a.detach()).diagonal().sum().backward()
+            self.assertEqual(a.grad, torch.zeros_like(a))
+
     def test_var_mean_differentiable(self):
         dim = [2, 4]
         keepdim = False
@@ -2491,6 +2622,33 @@ class TestAutograd(TestCase):
         print(prof.table())
         print(prof.key_averages(group_by_input_shape=True).table())
 
+    def test_profiler_chrome_trace(self):
+        import json
+        x = torch.randn(10, 10)
+        with profile(record_shapes=True) as prof:
+            y = x * 2 + 4
+
+        with tempfile.NamedTemporaryFile(mode='w+') as f:
+            prof.export_chrome_trace(f.name)
+            trace = json.load(f)
+        ids = [evt['args']['correlation'] for evt in trace]
+        self.assertEqual(len(set(ids)), len(ids))
+        self.assertEqual(ids, [evt.correlation_id for evt in prof.function_events])
+        self.assertEqual(trace[0]['args']['input_shapes'], [[10, 10], []])
+
+    @unittest.skipIf(not TEST_CUDA, "need the CUDA caching allocator")
+    def test_profiler_memory(self):
+        x = torch.randn(10, 10, device='cuda')
+        with profile(profile_memory=True) as prof:
+            y = x * 2
+            del y
+        alloc_sizes = [m.alloc_size for m in prof.function_events.memory_events]
+        self.assertEqual(len(alloc_sizes), 2)
+        self.assertGreaterEqual(alloc_sizes[0], 10 * 10 * 4)
+        self.assertEqual(alloc_sizes[1], -alloc_sizes[0])
+        self.assertTrue(all(m.device == x.get_device()
+                            for m in prof.function_events.memory_events))
+
     def test_profiler_aggregation_lstm(self):
         print("")
         rnn = torch.nn.LSTM(10, 20, 2)
@@ -20,7 +20,7 @@ from torch import nn
 import torch.nn.functional as F
 import torch.distributed as c10d
 import torch.distributed as dist
-from torch.nn.parallel import DistributedDataParallel
+from torch.nn.parallel import DistributedDataParallel, ShardedDataParallel
 
 from common_utils import TestCase, load_tests, run_tests
 from common_utils import retry_on_address_already_in_use_error
@@ -183,6 +183,16 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1"], ["value0", "value1"])
+        fs.set("key2", "value2")
+        self.assertEqual(
+            [b"value0", b"value1", b"value2"],
+            fs.multi_get(["key0", "key1", "key2"]))
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -241,6 +251,13 @@ class TCPStoreTest(TestCase, StoreTestBase):
             store1 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
             store2 = c10d.TCPStore(addr, port, 1, True)  # noqa: F841
 
+    def test_compare_set(self):
+        store = self._create_store()
+        self.assertEqual(b"value0", store.compare_set("key", "", "value0"))
+        self.assertEqual(b"value0", store.compare_set("key", "wrong", "value1"))
+        self.assertEqual(b"value1", store.compare_set("key", "value0", "value1"))
+        self.assertEqual(b"value1", store.get("key"))
+
 
 class PrefixTCPStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -764,6 +781,59 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_allreduce_basics_cuda(self):
         self._test_allreduce_basics(lambda t: t.clone().cuda())
 
+    def test_allreduce_multiple_devices(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        opts = self.opts(threads=4)
+        opts.devices = opts.devices * 3
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Small tensors use the devices in turn, large ones are striped
+        # over all of them.
+        numels = [1, 10, 1000, 1024 * 1024 + 1]
+        inputs = [torch.full([numel], self.rank + 1.0) for numel in numels]
+        work_handles = [pg.allreduce(input) for input in inputs]
+        for input, work_handle in zip(inputs, work_handles):
+            work_handle.wait()
+            expected = float(self.world_size * (self.world_size + 1) / 2)
+            self.assertEqual(torch.full_like(input, expected), input)
+
+        # Other collectives use the contexts in turn as well.
+        xs = [torch.Tensor([self.rank])]
+        pg.broadcast(xs).wait()
+        self.assertEqual(torch.Tensor([0]), xs[0])
+
+    def _test_sparse_allreduce_basics(self, fn):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Every rank sets the rows up to its own rank, so the ranks
+        # have a different number of nonzero entries.
+        size = [self.world_size, 2]
+        indices = torch.arange(self.rank + 1).unsqueeze(0)
+        values = torch.ones([self.rank + 1, 2]) * (self.rank + 1)
+        tensors = [fn(torch.sparse_coo_tensor(indices, values, size)) for _ in range(2)]
+        work = pg.allreduce(tensors)
+        work.wait()
+
+        expected = torch.zeros(size)
+        for rank in range(self.world_size):
+            expected[:rank + 1] += 2 * (rank + 1)
+        for tensor in tensors:
+            self.assertTrue(tensor.is_sparse)
+            self.assertEqual(expected, tensor.to_dense().cpu())
+
+        with self.assertRaisesRegex(ValueError, "only works with ReduceOp.SUM"):
+            opts = c10d.AllreduceOptions()
+            opts.reduceOp = c10d.ReduceOp.MAX
+            pg.allreduce(tensors, opts)
+
+    def test_sparse_allreduce_basics(self):
+        self._test_sparse_allreduce_basics(lambda t: t)
+
+    @skip_if_not_multigpu
+    def test_sparse_allreduce_basics_cuda(self):
+        self._test_sparse_allreduce_basics(lambda t: t.clone().cuda())
+
     def _test_allreduce_stress(self, inputs):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -931,6 +1001,77 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         ]
         self._test_scatter_stress(inputs, lambda t: t.clone().cuda())
 
+    def _test_reduce_scatter_basics(self, fn):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Process r contributes r + i to the output of process i
+        input = [fn(torch.Tensor([self.rank + i])) for i in range(self.world_size)]
+        output = fn(torch.Tensor([-1]))
+        pg.reduce_scatter([output], [input]).wait()
+        expected = sum(range(self.world_size)) + self.world_size * self.rank
+        self.assertEqual(torch.Tensor([expected]), output)
+
+        opts = c10d.ReduceScatterOptions()
+        opts.reduceOp = c10d.ReduceOp.MAX
+        pg.reduce_scatter([output], [input], opts).wait()
+        self.assertEqual(torch.Tensor([self.world_size - 1 + self.rank]), output)
+
+    def test_reduce_scatter_basics(self):
+        self._test_reduce_scatter_basics(lambda t: t.clone())
+
+    @skip_if_not_multigpu
+    def test_reduce_scatter_basics_cuda(self):
+        self._test_reduce_scatter_basics(lambda t: t.clone().cuda())
+
+    def _test_alltoall_basics(self, fn):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Even splits: process r sends r * 10 + i to process i
+        input = fn(torch.Tensor([self.rank * 10 + i for i in range(self.world_size)]))
+        output = fn(torch.zeros(self.world_size))
+        pg.alltoall_base(output, input, [], []).wait()
+        expected = torch.Tensor([i * 10 + self.rank for i in range(self.world_size)])
+        self.assertEqual(expected, output)
+
+        # Uneven splits: process r sends i + 1 rows of r * 10 + i to process i
+        input_split_sizes = [i + 1 for i in range(self.world_size)]
+        output_split_sizes = [self.rank + 1] * self.world_size
+        input = fn(torch.cat([
+            torch.full([i + 1, 2], self.rank * 10 + i)
+            for i in range(self.world_size)
+        ]))
+        output = fn(torch.zeros(sum(output_split_sizes), 2))
+        pg.alltoall_base(output, input, output_split_sizes, input_split_sizes).wait()
+        expected = torch.cat([
+            torch.full([self.rank + 1, 2], i * 10 + self.rank)
+            for i in range(self.world_size)
+        ])
+        self.assertEqual(expected, output)
+
+    def test_alltoall_basics(self):
+        self._test_alltoall_basics(lambda t: t.clone())
+
+    @skip_if_not_multigpu
+    def test_alltoall_basics_cuda(self):
+        self._test_alltoall_basics(lambda t: t.clone().cuda())
+
+    def test_alltoall_checks(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        t1 = torch.zeros([self.world_size + 1])
+        with self.assertRaisesRegex(ValueError, "divisible by the group size"):
+            pg.alltoall_base(t1, t1, [], [])
+
+        t2 = torch.zeros([self.world_size])
+        with self.assertRaisesRegex(ValueError, "number of split sizes"):
+            pg.alltoall_base(t2, t2, [1], [])
+
+        with self.assertRaisesRegex(ValueError, "must sum up"):
+            pg.alltoall_base(t2, t2, [], [2] * self.world_size)
+
     def test_gather_checks(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -1334,6 +1475,84 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
             self.assertEqual(torch.full(size, float(i * self.world_size)), tensor)
 
 
+class ProcessGroupHierarchicalTest(MultiProcessTestCase):
+    # Simulate 2 nodes with 2 processes each.
+    intra_size = 2
+
+    def _create_group(self, intra_backend="gloo"):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        node = self.rank // self.intra_size
+        local_rank = self.rank % self.intra_size
+        inter_size = self.world_size // self.intra_size
+        opts = c10d.ProcessGroupGloo.Options()
+        opts.devices = [c10d.ProcessGroupGloo.create_tcp_device(interface="lo")]
+        opts.timeout = 5.0
+        intra_store = c10d.PrefixStore("intra/{}".format(node), store)
+        if intra_backend == "nccl":
+            intra = c10d.ProcessGroupNCCL(intra_store, local_rank, self.intra_size)
+        else:
+            intra = c10d.ProcessGroupGloo(intra_store, local_rank, self.intra_size, opts)
+        inter_store = c10d.PrefixStore("inter/{}".format(local_rank), store)
+        inter = c10d.ProcessGroupGloo(inter_store, node, inter_size, opts)
+        pg = c10d.ProcessGroupHierarchical(intra, inter)
+        self.assertEqual(self.rank, pg.rank())
+        self.assertEqual(self.world_size, pg.size())
+        return pg
+
+    def test_broadcast(self):
+        pg = self._create_group()
+        for root in range(self.world_size):
+            x = torch.Tensor([self.rank + 1, -1])
+            opts = c10d.BroadcastOptions()
+            opts.rootRank = root
+            pg.broadcast([x], opts).wait()
+            self.assertEqual(torch.Tensor([root + 1, -1]), x)
+
+    def test_reduce(self):
+        pg = self._create_group()
+        for root in range(self.world_size):
+            x = torch.Tensor([self.rank + 1])
+            opts = c10d.ReduceOptions()
+            opts.rootRank = root
+            opts.reduceOp = c10d.ReduceOp.SUM
+            pg.reduce([x], opts).wait()
+            if self.rank == root:
+                self.assertEqual(torch.Tensor([10]), x)
+
+    def test_allgather(self):
+        pg = self._create_group()
+        x = torch.Tensor([[self.rank, -self.rank]])
+        outputs = [[torch.zeros(1, 2) for _ in range(self.world_size)]]
+        pg.allgather(outputs, [x]).wait()
+        for i, output in enumerate(outputs[0]):
+            self.assertEqual(torch.Tensor([[i, -i]]), output)
+
+    def test_barrier(self):
+        pg = self._create_group()
+        pg.barrier().wait()
+
+    def test_allreduce_requires_reduce_scatter(self):
+        pg = self._create_group()
+        x = torch.Tensor([self.rank])
+        with self.assertRaisesRegex(RuntimeError, "does not support reduce_scatter"):
+            pg.allreduce([x]).wait()
+
+    @skip_if_not_nccl
+    @skip_if_lt_x_gpu(4)
+    def test_allreduce_nccl(self):
+        pg = self._create_group(intra_backend="nccl")
+        # The number of elements is not a multiple of the node size.
+        x = torch.full([7], self.rank + 1).cuda(self.rank)
+        pg.allreduce([x]).wait()
+        self.assertEqual(torch.full([7], 10), x.cpu())
+
+        x = torch.arange(7, dtype=torch.float).cuda(self.rank) * (self.rank + 1)
+        opts = c10d.AllreduceOptions()
+        opts.reduceOp = c10d.ReduceOp.MAX
+        pg.allreduce([x], opts).wait()
+        self.assertEqual(torch.arange(7, dtype=torch.float) * 4, x.cpu())
+
+
 class ProcessGroupNCCLTest(TestCase):
     MAIN_PROCESS_RANK = 0
 
@@ -1452,6 +1671,28 @@ class ProcessGroupNCCLTest(TestCase):
         for i in range(self.num_gpus):
             self.assertEqual(torch.Tensor([self.num_gpus]), tensors[i])
 
+    def test_allreduce_coalesced_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        def allreduce_coalesced(tensors, op):
+            opts = c10d.AllreduceOptions()
+            opts.reduceOp = op
+            work = pg.allreduce_coalesced(tensors, opts)
+            work.wait()
+
+        tensors = [torch.full((i + 1, 3), i + 1).cuda(0) for i in range(5)]
+        expected = [t.clone() for t in tensors]
+
+        allreduce_coalesced(tensors, c10d.ReduceOp.SUM)
+        self.assertEqual(expected, tensors)
+
+        allreduce_coalesced(tensors, c10d.ReduceOp.MAX)
+        self.assertEqual(expected, tensors)
+
+        with self.assertRaisesRegex(RuntimeError, "same GPU device"):
+            allreduce_coalesced([tensors[0], tensors[1].cuda(1)], c10d.ReduceOp.SUM)
+
     def test_reduce_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -1939,6 +2180,38 @@ class DistributedDataParallelTest(MultiProcessTestCase):
             self.assertEqual(tensors, target)
 
     @skip_if_not_multigpu
+    def test_sharded_data_parallel_gloo(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        options = c10d.ProcessGroupGloo.Options()
+        options.devices = [c10d.ProcessGroupGloo.create_tcp_device(interface="lo")]
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size, options)
+
+        torch.manual_seed(1337)
+        model = nn.Sequential(nn.Linear(2, 3), nn.ReLU(), nn.Linear(3, 4, bias=False))
+        reference = copy.deepcopy(model)
+        sharded = ShardedDataParallel(model, process_group=process_group)
+
+        # Every process only keeps a shard of the padded parameters.
+        self.assertEqual([5, 6], [p.numel() for p in sharded.parameters()])
+
+        optimizer = torch.optim.SGD(sharded.parameters(), lr=0.1)
+        reference_optimizer = torch.optim.SGD(reference.parameters(), lr=0.1)
+        local_batch_size = 4
+        for _ in range(3):
+            input = torch.randn(self.world_size * local_batch_size, 2)
+            target = torch.randn(self.world_size * local_batch_size, 4)
+            local = slice(self.rank * local_batch_size, (self.rank + 1) * local_batch_size)
+            for m, o, i, t in ((sharded, optimizer, input[local], target[local]),
+                               (reference, reference_optimizer, input, target)):
+                o.zero_grad()
+                F.mse_loss(m(i), t).backward()
+                o.step()
+
+        state_dict = sharded.gathered_state_dict()
+        self.assertEqual(set(reference.state_dict().keys()), set(state_dict.keys()))
+        for key, value in reference.state_dict().items():
+            self.assertEqual(value, state_dict[key])
+
     def test_sync_params_no_buffers(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         options = c10d.ProcessGroupGloo.Options()
@@ -2623,6 +2896,96 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def _run_iteration(self, model, reducer, input, target):
+        output = nn.CrossEntropyLoss()(model(input), target)
+        reducer.prepare_for_backward(output)
+        output.backward()
+
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = ReducerModule()
+        parameters = list(model.parameters())
+        # One bucket per parameter, in the order in which they are defined.
+        # This is the opposite of the order in which gradients are computed.
+        buckets = [[i] for i in range(len(parameters))]
+        reducer = dist.Reducer(
+            [parameters], buckets, self.process_group, bucket_size_limits=[1])
+        self.assertEqual(buckets, reducer.get_bucket_indices())
+
+        input = torch.rand([batch_size, 2])
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        self._run_iteration(model, reducer, input, target)
+        self.assertEqual(buckets, reducer.get_bucket_indices())
+
+        # The buckets are rebuilt at the start of the next iteration,
+        # following the order in which the gradients became ready.
+        for _ in range(2):
+            self._run_iteration(model, reducer, input, target)
+            self.assertEqual(
+                list(reversed(buckets)), reducer.get_bucket_indices())
+
+    def test_fp16_compression(self):
+        batch_size = 10
+        models = [self._create_mixed_precision_model() for _ in range(2)]
+        models[1].load_state_dict(models[0].state_dict())
+        parameters = [list(model.parameters()) for model in models]
+        buckets = [[i] for i in range(len(parameters[0]))]
+        reducers = [
+            dist.Reducer([parameters[0]], buckets, self.process_group),
+            dist.Reducer([parameters[1]], buckets, self.process_group,
+                         fp16_compression=True),
+        ]
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        for model, reducer in zip(models, reducers):
+            self._run_iteration(model, reducer, input, target)
+
+        # Compression loses precision, but keeps the parameter dtype.
+        for p0, p1 in zip(*parameters):
+            self.assertEqual(p0.grad.dtype, p1.grad.dtype)
+            self.assertEqual(p0.grad, p1.grad, prec=1e-3)
+
+
+    def test_sparse_gradient(self):
+        model = nn.Embedding(10, 3, sparse=True)
+        parameters = [list(model.parameters())]
+        reducer = dist.Reducer(
+            parameters, [[0]], self.process_group,
+            expect_sparse_gradients=[[True]])
+        output = model(torch.LongTensor([1, 3, 3])).sum()
+        reducer.prepare_for_backward(output)
+        output.backward()
+
+        # The gradient is reduced without being densified.
+        grad = parameters[0][0].grad
+        self.assertTrue(grad.is_sparse)
+        expected = torch.zeros([10, 3])
+        expected[1] = 1
+        expected[3] = 2
+        self.assertEqual(expected, grad.to_dense())
+
+    def test_comm_hook(self):
+        torch.manual_seed(1337)
+        model = nn.Linear(2, 4, bias=False).double()
+        reference = copy.deepcopy(model)
+
+        def hook(tensors):
+            for tensor in tensors:
+                tensor.mul_(2)
+            return self.process_group.allreduce(tensors)
+
+        reducer = self._create_reducer_for_models([model])
+        reducer._register_comm_hook(hook)
+        reference_reducer = self._create_reducer_for_models([reference])
+        input = torch.rand([10, 2], dtype=torch.double)
+        for m, r in ((model, reducer), (reference, reference_reducer)):
+            output = m(input).sum()
+            r.prepare_for_backward(output)
+            output.backward()
+
+        # The hook replaces the averaging allreduce of the reducer.
+        self.assertEqual(2 * reference.weight.grad, model.weight.grad)
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -2669,6 +3032,16 @@ class ComputeBucketAssignmentTest(TestCase):
         result = dist._compute_bucket_assignment_by_size(tensors, [200, 400])
         self.assertEqual([[0], [1], [2, 4], [3, 5]], result)
 
+    def test_sparse_gradient_buckets(self):
+        tensors = [
+            torch.empty([50], dtype=torch.float),
+            torch.empty([50], dtype=torch.float),
+            torch.empty([50], dtype=torch.float),
+        ]
+        result = dist._compute_bucket_assignment_by_size(
+            tensors, [400], [False, True, False])
+        self.assertEqual([[0, 2], [1]], result)
+
 
 class CommTest(MultiProcessTestCase):
     def tearDown(self):
@@ -2718,6 +3091,32 @@ class CommTest(MultiProcessTestCase):
         device = torch.device('cuda:%d' % self.rank)
         self._test_broadcast_coalesced(process_group, device)
 
+    @skip_if_not_multigpu
+    @skip_if_not_nccl
+    def test_nccl_timeout(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        process_group = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size,
+            timeout=timedelta(seconds=1))
+        device = torch.device('cuda:%d' % self.rank)
+        process_group.allreduce([torch.ones(10, device=device)]).wait()
+        torch.cuda.synchronize(device)
+
+        # Rank 1 never joins the second allreduce, which the watchdog
+        # thread of rank 0 must abort instead of hanging.
+        if self.rank == 0:
+            work = process_group.allreduce([torch.ones(10, device=device)])
+            while not work.is_completed():
+                time.sleep(0.1)
+            self.assertFalse(work.is_success())
+            with self.assertRaisesRegex(RuntimeError, "timed out"):
+                work.wait()
+            with self.assertRaisesRegex(RuntimeError, "aborted"):
+                process_group.allreduce([torch.ones(10, device=device)])
+            store.set("done", "1")
+        else:
+            store.wait(["done"])
+
     @skip_if_not_multigpu
     def test_broadcast_coalesced_gloo_cuda(self):
         store = c10d.FileStore(self.file.name, self.world_size)
@@ -2736,6 +3135,54 @@ class CommTest(MultiProcessTestCase):
         self._test_broadcast_coalesced(process_group, device)
 
 
+class RpcTest(MultiProcessTestCase):
+    def tearDown(self):
+        super(RpcTest, self).tearDown()
+        try:
+            os.remove(self.file.name)
+        except OSError:
+            pass
+
+    def _process_group(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        options = c10d.ProcessGroupGloo.Options()
+        options.devices = [c10d.ProcessGroupGloo.create_tcp_device(interface="lo")]
+        options.timeout = 30.0
+        return c10d.ProcessGroupGloo(store, self.rank, self.world_size, options)
+
+    def test_sharded_embedding(self):
+        process_group = self._process_group()
+        agent = c10d.ProcessGroupAgent(process_group)
+
+        # ranks 1 and 2 serve the table, and every rank uses it
+        servers = [1, 2]
+        weight = torch.arange(60, dtype=torch.float).view(15, 4)
+        shard = None
+        if self.rank in servers:
+            shard = c10d._embedding_shard(weight, servers.index(self.rank), len(servers))
+            c10d._register_embedding_shard(agent, "table", shard)
+        process_group.barrier().wait()
+
+        embedding = c10d.ShardedEmbedding(agent, "table", servers, 4)
+        indices = torch.tensor([[3, 0, 14], [7, 7, 2]])
+        self.assertEqual(embedding.lookup(indices), weight[indices])
+        self.assertEqual(embedding.lookup(torch.tensor([], dtype=torch.long)).size(), (0, 4))
+        with self.assertRaisesRegex(RuntimeError, "out of range"):
+            embedding.lookup(torch.tensor([15]))
+
+        # the gradients of repeated rows add up, across calls and ranks
+        embedding.update(torch.tensor([3, 0, 7, 7]), torch.ones(4, 4), lr=0.5)
+        process_group.barrier().wait()
+        expected = weight.clone()
+        expected[[0, 3]] -= 0.5 * self.world_size
+        expected[7] -= self.world_size
+        self.assertEqual(embedding.lookup(torch.arange(15)), expected)
+        if shard is not None:
+            self.assertEqual(shard, c10d._embedding_shard(expected, servers.index(self.rank), len(servers)))
+
+        agent.join()
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
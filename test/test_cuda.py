@@ -11,6 +11,7 @@ import queue
 import torch
 import torch.cuda
 import torch.cuda.comm as comm
+from torch.utils.dlpack import from_dlpack, to_dlpack
 from torch import multiprocessing as mp
 from torch._six import inf, nan
 
@@ -38,6 +39,8 @@ if not TEST_CUDA:
 
 TEST_MAGMA = TEST_CUDA
 TEST_LARGE_TENSOR = TEST_CUDA
+TEST_CUDA_GRAPH = TEST_CUDA and torch.version.cuda is not None and \
+    tuple(int(v) for v in torch.version.cuda.split('.')[:2]) >= (10, 1)
 if TEST_CUDA:
     torch.ones(1).cuda()  # has_magma shows up after cuda is initialized
     TEST_MAGMA = torch.cuda.has_magma
@@ -808,6 +811,23 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             pass
 
+    def test_memory_snapshot(self):
+        torch.cuda.empty_cache()
+        before = torch.cuda.memory_event_counts()
+        x = torch.empty(1024 * 1024 * 5, dtype=torch.uint8, device='cuda')
+        segments = [s for s in torch.cuda.memory_snapshot()
+                    if any(b['state'] == 'active_allocated' and b['size'] == x.numel()
+                           for b in s['blocks'])]
+        self.assertEqual(len(segments), 1)
+        segment = segments[0]
+        self.assertEqual(segment['segment_type'], 'large')
+        self.assertEqual(segment['total_size'], sum(b['size'] for b in segment['blocks']))
+        self.assertGreaterEqual(segment['allocated_size'], x.numel())
+        after = torch.cuda.memory_event_counts()
+        self.assertEqual(after['num_allocs'], before['num_allocs'] + 1)
+        del x
+        self.assertEqual(torch.cuda.memory_event_counts()['num_frees'], after['num_frees'] + 1)
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1106,10 +1126,10 @@ class TestCuda(TestCase):
         x /= 2
         self.assertEqual(x.sum(), 2**29)
 
-    def _test_broadcast(self, input):
+    def _test_broadcast(self, input, devices=(0, 1)):
         if not TEST_MULTIGPU:
             raise unittest.SkipTest("only one GPU detected")
-        result = comm.broadcast(input, (0, 1))
+        result = comm.broadcast(input, devices)
         for i, t in enumerate(result):
             self.assertEqual(t.get_device(), i)
             self.assertEqual(t, input)
@@ -1122,6 +1142,12 @@ class TestCuda(TestCase):
     def test_broadcast_gpu(self):
         self._test_broadcast(torch.randn(5, 5).cuda())
 
+    def test_broadcast_all_gpus(self):
+        # Non-contiguous inputs are broadcast without NCCL, in rounds of copies.
+        devices = tuple(range(torch.cuda.device_count()))
+        self._test_broadcast(torch.randn(5, 5, 2)[:, :, 0], devices)
+        self._test_broadcast(torch.randn(5, 5, 2).cuda()[:, :, 0], devices)
+
     def test_min_max_nan(self):
         tests = [(lambda x: x.min(), 'min'),
                  (lambda x: x.max(), 'max'),
@@ -2007,6 +2033,26 @@ class TestCuda(TestCase):
         with torch.cuda.device(d1):
             self.assertGreater(e0.elapsed_time(e2), 0)
 
+    def test_dlpack_streams(self):
+        producer = torch.cuda.Stream()
+        consumer = torch.cuda.Stream()
+        with torch.cuda.stream(producer):
+            torch.cuda._sleep(int(50 * get_cycles_per_ms()))
+            x = torch.ones(1000, device='cuda')[::2]
+            dlpack = to_dlpack(x, stream=consumer)
+        with torch.cuda.stream(consumer):
+            z = from_dlpack(dlpack)
+            self.assertEqual(z.data_ptr(), x.data_ptr())
+            self.assertEqual(z.sum().item(), 500)
+
+        # the producer stream can also be given as a raw handle
+        with torch.cuda.stream(producer):
+            torch.cuda._sleep(int(50 * get_cycles_per_ms()))
+            x.fill_(2)
+        with torch.cuda.stream(consumer):
+            y = from_dlpack(to_dlpack(x), stream=producer.cuda_stream)
+            self.assertEqual(y.sum().item(), 1000)
+
     def test_record_stream(self):
         cycles_per_ms = get_cycles_per_ms()
 
@@ -2039,6 +2085,30 @@ class TestCuda(TestCase):
             tmp3 = torch.cuda.FloatTensor(t.size())
             self.assertEqual(tmp3.data_ptr(), ptr[0], 'allocation not re-used')
 
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA graphs require CUDA 10.1")
+    def test_cuda_graph(self):
+        x = torch.zeros(1000, device='cuda')
+        s = torch.cuda.Stream()
+        with torch.cuda.stream(s):
+            (x * 2) + 1  # warm up
+            graph = torch.cuda.CUDAGraph()
+            graph.capture_begin()
+            tmp = x * 2
+            tmp_ptr = tmp.data_ptr()
+            y = tmp + 1
+            del tmp
+            graph.capture_end()
+            # the memory freed while capturing is not reused
+            self.assertNotEqual(torch.empty(1000, device='cuda').data_ptr(), tmp_ptr)
+
+            for i in range(3):
+                x.fill_(i)
+                graph.replay()
+                self.assertEqual(y, torch.full_like(y, 2 * i + 1))
+
+            graph.reset()
+            self.assertRaises(RuntimeError, lambda: graph.replay())
+
     def test_noncontiguous_pinned_memory(self):
         # See issue #3266
         x = torch.arange(0, 10).view((2, 5))
@@ -2063,6 +2133,21 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, 'allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_split(self):
+        # small allocations are packed into the same cudaHostAlloc
+        torch.cuda.synchronize()
+        a = torch.empty(1000, pin_memory=True)
+        stats = torch.cuda.host_memory_stats()
+        b = torch.empty(1000, pin_memory=True)
+        self.assertEqual(torch.cuda.host_memory_stats()['num_host_allocs'], stats['num_host_allocs'])
+        self.assertEqual(torch.cuda.host_memory_stats()['allocated_bytes'],
+                         stats['allocated_bytes'] + 4096)
+        self.assertNotEqual(a.data_ptr(), b.data_ptr())
+
+        # freed blocks are merged with their free neighbours
+        del a, b
+        self.assertGreater(torch.cuda.host_memory_stats()['num_merges'], stats['num_merges'])
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -2108,6 +2193,31 @@ class TestCuda(TestCase):
         # cached blocks in case it affects future tests.
         torch.cuda.empty_cache()
 
+    @unittest.skipIf(IS_WINDOWS, "expandable segments are not supported on Windows")
+    def test_caching_allocator_expandable_segments(self):
+        # the allocator reads its configuration once, so run in a fresh process
+        script = """
+import torch
+sizes = [(i * 7919) % 23 + 3 for i in range(200)]
+tensors = []
+for i, mb in enumerate(sizes):
+    tensors.append(torch.empty(mb * 1024 * 1024, dtype=torch.uint8, device='cuda'))
+    if i % 3 == 0:
+        tensors = tensors[len(tensors) // 2:]
+    tensors[-1].fill_(i % 256)
+    assert tensors[-1].max().item() == i % 256
+del tensors
+allocated = torch.cuda.memory_allocated()
+torch.cuda.empty_cache()
+assert torch.cuda.memory_cached() == allocated, (torch.cuda.memory_cached(), allocated)
+print('OK')
+"""
+        env = os.environ.copy()
+        env['PYTORCH_CUDA_EXPANDABLE_SEGMENTS'] = '1'
+        import subprocess
+        out = subprocess.check_output([sys.executable, '-c', script], env=env)
+        self.assertIn('OK', out.decode('ascii'))
+
     def test_reduction_gpu_memory_accessing(self):
         x = torch.ones(512, 8, dtype=torch.float32, device='cuda')
         torch.sum(x, 0)
@@ -2163,6 +2273,25 @@ class TestCuda(TestCase):
         x = torch.ones(240000, device='cuda', dtype=torch.float32)
         self.assertEqual(x.prod(), 1)
 
+    def test_reduction_benchmark(self):
+        # small integers keep the float sums exact whatever the order of the reduction
+        shapes = [((1 << 20, 16), 0), ((16, 1 << 20), 1), ((8192, 4096), 0), ((300, 7, 500), (0, 2))]
+        old = torch.backends.cuda.benchmark_reductions
+        try:
+            for benchmark in [False, True, True]:
+                torch.backends.cuda.benchmark_reductions = benchmark
+                self.assertEqual(torch.backends.cuda.benchmark_reductions, benchmark)
+                for shape, dim in shapes:
+                    a = torch.randint(-3, 4, shape, dtype=torch.float32)
+                    x = a.cuda()
+                    self.assertEqual(x.sum(dim).cpu(), a.sum(dim), 0)
+                    if isinstance(dim, int):
+                        values, indices = x.max(dim)
+                        self.assertEqual(values.cpu(), a.max(dim)[0], 0)
+                        self.assertEqual(x.gather(dim, indices.unsqueeze(dim)).squeeze(dim), values, 0)
+        finally:
+            torch.backends.cuda.benchmark_reductions = old
+
     @staticmethod
     def _select_broadcastable_dims(dims_full=None):
         return _TestTorchMixin._select_broadcastable_dims(dims_full)
@@ -2271,6 +2400,33 @@ class TestCuda(TestCase):
         with self.assertRaisesRegex(RuntimeError, r"read-only property"):
             torch.backends.cuda.cufft_plan_cache.size = -1
 
+        # lookups are counted, and the workspace of the cached plans is bounded
+        plan_cache = torch.backends.cuda.cufft_plan_cache
+        plan_cache.clear()
+        x = torch.randn(64, 64, 64, 2, device='cuda')
+        hits, misses = plan_cache.hits, plan_cache.misses
+        x.fft(3)
+        x.fft(3)
+        self.assertEqual(plan_cache.misses, misses + 1)
+        self.assertEqual(plan_cache.hits, hits + 1)
+        self.assertEqual(plan_cache.size, 1)
+        self.assertGreaterEqual(plan_cache.workspace_size, 0)
+        original = plan_cache.max_workspace_size
+        self.assertEqual(original, -1)
+        try:
+            plan_cache.max_workspace_size = 0
+            x.ifft(3)
+            # the plan just used is kept even if it doesn't fit
+            misses = plan_cache.misses
+            x.ifft(3)
+            self.assertEqual(plan_cache.misses, misses)
+            with self.assertRaisesRegex(RuntimeError, r"non-negative or -1"):
+                plan_cache.max_workspace_size = -2
+        finally:
+            plan_cache.max_workspace_size = original
+        with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+            plan_cache.hits = 0
+
         with self.assertRaisesRegex(RuntimeError, r"but got device with index"):
             torch.backends.cuda.cufft_plan_cache[torch.cuda.device_count() + 10]
 
@@ -600,6 +600,19 @@ class TestDataLoader(TestCase):
             self.assertEqual(12345, batch[0])
             self.assertEqual(12345, batch[1])
 
+    def test_shared_memory_rings(self):
+        # See NOTE [ Data Loader Shared Memory Rings ]
+        loader = DataLoader(self.dataset, batch_size=2, num_workers=2)
+        # batches that are dropped right away let the rings be reused
+        self._test_sequential(loader)
+        # batches that are held on to fill them up, and the workers have to
+        # fall back to segments of their own
+        batches = list(loader)
+        for i, (sample, target) in enumerate(batches):
+            self.assertEqual(sample, self.data[2 * i:2 * i + 2])
+            self.assertEqual(target, self.labels[2 * i:2 * i + 2])
+        self.assertEqual(_utils.shm_ring._main_rings, {})
+
     def test_shuffle(self):
         self._test_shuffle(DataLoader(self.dataset, shuffle=True))
 
@@ -23,6 +23,20 @@ def _fake_quantize_per_tensor_affine_grad_reference(X, dY, scale, zero_point, nu
     res = dY[mask].reshape(dY.shape)
     return res
 
+
+# Reference method for fake quantizing with a scale and zero point per channel
+# of `X` along `axis`.
+def _fake_quantize_per_channel_affine_reference(X, scale, zero_point, axis, num_bits):
+    shape = [1] * X.ndim
+    shape[axis] = X.shape[axis]
+    scale = scale.reshape(shape)
+    zero_point = zero_point.reshape(shape)
+    quant_min, quant_max = 0, 2 ** num_bits - 1
+    Xq = np.floor(X / scale + 0.5) + zero_point
+    Y = (np.clip(Xq, quant_min, quant_max) - zero_point) * scale
+    mask = np.logical_and(Xq >= quant_min, Xq <= quant_max)
+    return Y, mask
+
 NP_RANDOM_SEED = 19
 
 
@@ -81,6 +95,84 @@ class TestFakeQuantizePerTensorAffine(unittest.TestCase):
         tolerance = 1e-6
         np.testing.assert_allclose(Y, Y_prime, rtol=tolerance, atol=tolerance)
 
+    """Tests that the mask of the fused forward gives the gradient of the
+    backward op."""
+    def test_forward_and_mask(self):
+        np.random.seed(NP_RANDOM_SEED)
+        forward = torch.ops.quantized.fake_quantize_per_tensor_affine_forward
+        forward_and_mask = torch.ops.quantized.fake_quantize_per_tensor_affine_forward_and_mask
+        backward = torch.ops.quantized.fake_quantize_per_tensor_affine_backward
+
+        scale = 3
+        zero_point = 2
+        num_bits = 8
+        # Large enough for the vectorized loops and their tails, with values
+        # on both sides of the quantization range
+        X = torch.from_numpy(np.random.rand(37, 41) * 1000 - 100).float()
+        dY = torch.randn(37, 41)
+        Y, mask = forward_and_mask(X, scale, zero_point, num_bits)
+        self.assertEqual(mask.dtype, X.dtype)
+        np.testing.assert_allclose(Y, forward(X, scale, zero_point, num_bits))
+        np.testing.assert_allclose(
+            dY * mask, backward(X, dY, scale, zero_point, num_bits))
+        self.assertTrue(((mask == 0) | (mask == 1)).all())
+        self.assertTrue((mask == 0).any() and (mask == 1).any())
+
+        # The strided path gives the same values
+        Yt, maskt = forward_and_mask(X.t(), scale, zero_point, num_bits)
+        np.testing.assert_allclose(Yt, Y.t())
+        np.testing.assert_allclose(maskt, mask.t())
+
+    def test_quant_delay(self):
+        forward_and_mask = torch.ops.quantized.fake_quantize_per_tensor_affine_forward_and_mask
+        X = torch.randn(10) * 100
+        Y, mask = forward_and_mask(X, 3., 2, 8, quant_delay=5, iter=2)
+        self.assertTrue(torch.equal(X, Y))
+        self.assertTrue(torch.equal(mask, torch.ones_like(X)))
+
+
+class TestFakeQuantizePerChannelAffine(unittest.TestCase):
+    def test_forward_and_backward(self):
+        np.random.seed(NP_RANDOM_SEED)
+        forward = torch.ops.quantized.fake_quantize_per_channel_affine_forward
+        forward_and_mask = torch.ops.quantized.fake_quantize_per_channel_affine_forward_and_mask
+        backward = torch.ops.quantized.fake_quantize_per_channel_affine_backward
+
+        num_bits = 8
+        X = np.random.rand(6, 5, 7, 9) * 300 - 30
+        dY = np.random.randn(*X.shape)
+        for axis in range(X.ndim):
+            scale = np.random.rand(X.shape[axis]) + 0.5
+            zero_point = np.random.randint(0, 20, size=X.shape[axis])
+            Y, mask = _fake_quantize_per_channel_affine_reference(
+                X, scale, zero_point, axis, num_bits)
+            X_torch = torch.from_numpy(X).float()
+            scale_torch = torch.from_numpy(scale).float()
+            zero_point_torch = torch.from_numpy(zero_point)
+            Y_prime = forward(X_torch, scale_torch, zero_point_torch, axis, num_bits)
+            np.testing.assert_allclose(Y, Y_prime, rtol=1e-5, atol=1e-4)
+            Y_prime, mask_prime = forward_and_mask(
+                X_torch, scale_torch, zero_point_torch, axis, num_bits)
+            np.testing.assert_allclose(mask, mask_prime)
+            dX_prime = backward(X_torch, torch.from_numpy(dY).float(), scale_torch,
+                               zero_point_torch, axis, num_bits)
+            np.testing.assert_allclose(dY * mask, dX_prime, rtol=1e-6, atol=1e-6)
+
+    def test_matches_per_tensor(self):
+        forward = torch.ops.quantized.fake_quantize_per_channel_affine_forward
+        per_tensor = torch.ops.quantized.fake_quantize_per_tensor_affine_forward
+        X = torch.randn(4, 16) * 100
+        Y = forward(X, torch.full((4,), 3.), torch.full((4,), 2, dtype=torch.long), 0, 8)
+        self.assertTrue(torch.equal(Y, per_tensor(X, 3., 2, 8)))
+
+    def test_bad_qparams(self):
+        forward = torch.ops.quantized.fake_quantize_per_channel_affine_forward
+        X = torch.randn(4, 16)
+        with self.assertRaises(RuntimeError):
+            forward(X, torch.ones(3), torch.zeros(3, dtype=torch.long), 0, 8)
+        with self.assertRaises(RuntimeError):
+            forward(X, torch.ones(4), torch.zeros(4, dtype=torch.long), 2, 8)
+
 
 if __name__ == '__main__':
     run_tests()
@@ -308,6 +308,32 @@ class TestIndexing(TestCase):
         self.assertEqual(x[idx, ...].tolist(), [[0, 1, 2],
                                                 [6, 7, 8]])
 
+    def test_int_list_and_mask(self):
+        # int lists and full masks take the index_select and masked_select
+        # fast paths; compare them with indexing by index tensors
+        x = torch.randn(4, 5, 6, requires_grad=True)
+        idx = [1, -1, 3, 1]
+        t = torch.tensor(idx)
+        self.assertEqual(x[idx], x[t])
+        self.assertEqual(x[:, idx], x[:, t])
+        self.assertEqual(x[1:3, :, idx], x[1:3, :, t])
+        self.assertEqual(x[..., idx], x[..., t])
+        self.assertEqual(x[:, idx, ...], x[:, t, ...])
+        self.assertEqual(x[::2, idx, 1:], x[::2, t, 1:])
+        self.assertEqual(x[[]], x[torch.tensor([], dtype=torch.long)])
+        self.assertRaisesRegex(IndexError, 'index 6 is out of bounds for dimension 2 with size 6',
+                               lambda: x[:, :, [0, 6]])
+
+        mask = x > 0
+        self.assertEqual(x[mask], x.masked_select(mask))
+        self.assertEqual(x[mask.byte()], x.masked_select(mask))
+
+        x[:, idx, 1:].sum().backward()
+        grad = torch.zeros(4, 5, 6)
+        grad[:, t, 1:] += 1
+        grad[:, 1, 1:] += 1
+        self.assertEqual(x.grad, grad)
+
     def test_invalid_index(self):
         x = torch.arange(0, 16).view(4, 4)
         self.assertRaisesRegex(TypeError, 'slice indices', lambda: x["0":"1"])
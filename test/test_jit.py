@@ -35,6 +35,7 @@ import math
 import types
 import pickle
 import pickletools
+import threading
 import copy
 import zipfile
 
@@ -967,6 +968,40 @@ class TestJit(JitTestCase):
 
         test_device()
 
+    def test_algebraic_simplification(self):
+        def fn(x):
+            a = x.permute(1, 2, 0).permute(2, 0, 1)
+            b = a.transpose(0, 1).transpose(0, 1)
+            c = b.unsqueeze(1).squeeze(1)
+            d = c.view(6, 4).view(24)
+            e = torch.cat([d], 0)
+            return torch.dropout(e, 0.5, False) * 2
+
+        scripted = torch.jit.script(fn)
+        graph = scripted.graph.copy()
+        self.run_pass('constant_propagation', graph)
+        self.run_pass('constant_pooling', graph)
+        self.run_pass('algebraic_simplification', graph)
+        for op in ["aten::permute", "aten::transpose", "aten::squeeze", "aten::cat", "aten::dropout"]:
+            FileCheck().check_not(op).run(str(graph))
+        FileCheck().check_count("aten::view", 1, exactly=True).run(str(graph))
+        x = torch.randn(2, 3, 4)
+        self.assertEqual(fn(x), scripted(x))
+
+        # the copy made by cat can't be removed if it is mutated
+        @torch.jit.script
+        def mutated(x):
+            y = torch.cat([x], 0)
+            y.add_(1)
+            return y
+
+        graph = mutated.graph.copy()
+        self.run_pass('algebraic_simplification', graph)
+        FileCheck().check("aten::cat").run(str(graph))
+        x = torch.zeros(3)
+        self.assertEqual(mutated(x), torch.ones(3))
+        self.assertEqual(x, torch.zeros(3))
+
     def test_index(self):
         x = torch.tensor([0.4], requires_grad=True)
         y = torch.tensor([0], dtype=torch.int64)
@@ -1297,6 +1332,122 @@ graph(%x : Tensor,
         self.assertEqual(value_stats['p'][1], x2 + y2)
         self.assertEqual(value_stats['z'][1], x2 - y2)
 
+    def test_freeze_module(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv = nn.Conv2d(3, 4, 3)
+                self.bn = nn.BatchNorm2d(4)
+                self.dropout = nn.Dropout(0.5)
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return self.dropout(self.bn(self.conv(x)))
+
+        m = M()
+        with torch.no_grad():
+            m.bn.running_mean.uniform_()
+            m.bn.running_var.uniform_(1, 2)
+            m.bn.weight.uniform_()
+            m.bn.bias.uniform_()
+        x = torch.randn(2, 3, 8, 8)
+
+        with self.assertRaisesRegex(RuntimeError, "eval mode"):
+            torch._C._jit_pass_freeze_module(m._c)
+
+        m.eval()
+        frozen = torch._C._jit_pass_freeze_module(m._c)
+        FileCheck().check("aten::conv2d").check_not("aten::batch_norm") \
+            .check_not("aten::dropout").run(str(frozen.graph))
+        self.assertEqual(len(list(frozen.graph.inputs())), 1)
+        self.assertEqual(frozen(x), m(x))
+
+    def test_batch_mm_horizontal(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.w1 = nn.Parameter(torch.randn(4, 3))
+                self.w2 = nn.Parameter(torch.randn(4, 5))
+                self.conv1 = nn.Conv2d(3, 2, 3)
+                self.conv2 = nn.Conv2d(3, 6, 3)
+
+            @torch.jit.script_method
+            def forward(self, x, y):
+                return torch.mm(x, self.w1), torch.mm(x, self.w2), self.conv1(y), self.conv2(y)
+
+        m = M().eval()
+        x = torch.randn(2, 4)
+        y = torch.randn(1, 3, 8, 8)
+        frozen = torch._C._jit_pass_freeze_module(m._c)
+        torch._C._jit_pass_batch_mm(frozen.graph)
+        # the sibling ops on the same input are computed by a single op
+        # on concatenated weights
+        graph_str = str(frozen.graph)
+        FileCheck().check_count("aten::mm", 1, exactly=True).run(graph_str)
+        FileCheck().check_count("aten::conv2d", 1, exactly=True).run(graph_str)
+        FileCheck().check_count("aten::split_with_sizes", 2, exactly=True).run(graph_str)
+        self.assertEqual(frozen(x, y), m(x, y))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_convert_frozen_ops_to_mkldnn(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv1 = nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = nn.Conv2d(8, 8, 3, padding=1)
+                self.weight = nn.Parameter(torch.randn(4, 8))
+                self.bias = nn.Parameter(torch.randn(4))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                x = F.relu(self.conv1(x), inplace=True)
+                y = self.conv2(x) + x
+                y = F.max_pool2d(y, 2)
+                z = F.adaptive_avg_pool2d(y, [1, 1])
+                # nn.Linear is decomposed into addmm/matmul in TorchScript
+                z = torch._C._nn.linear(z.view(z.size(0), -1), self.weight, self.bias)
+                return z, torch.sigmoid(y)
+
+        m = M().eval()
+        x = torch.randn(2, 3, 8, 8)
+        frozen = torch._C._jit_pass_freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(frozen.graph)
+        # the input is only reordered once, and the outputs of the MKLDNN
+        # subgraph are reordered where dense ops or the return need them
+        FileCheck().check_count("aten::to_mkldnn", 1, exactly=True) \
+            .check("aten::mkldnn_convolution_fused").check_not("aten::relu_") \
+            .check_not("aten::view").run(str(frozen.graph))
+        FileCheck().check_count("aten::to_dense", 2, exactly=True).run(str(frozen.graph))
+        self.assertEqual(frozen(x), m(x))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_fuse_mkldnn_conv_sum_relu(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.conv1 = nn.Conv2d(4, 4, 3, padding=1)
+                self.conv2 = nn.Conv2d(4, 4, 3, padding=1)
+                self.conv3 = nn.Conv2d(4, 4, 1)
+
+            @torch.jit.script_method
+            def forward(self, x):
+                x = self.conv1(x)
+                y = F.relu(self.conv2(x))
+                # a residual block: the sum and the relu are fused
+                return F.relu(self.conv3(y) + x)
+
+        m = M().eval()
+        x = torch.randn(2, 4, 8, 8)
+        frozen = torch._C._jit_pass_freeze_module(m._c)
+        torch._C._jit_pass_convert_frozen_ops_to_mkldnn(frozen.graph)
+        graph_str = str(frozen.graph)
+        # conv1 is used twice, so it is the only convolution left
+        FileCheck().check_count("aten::conv2d", 1, exactly=True).run(graph_str)
+        FileCheck().check_count("aten::mkldnn_convolution_fused", 2, exactly=True) \
+            .run(graph_str)
+        FileCheck().check_not("aten::add").check_not("aten::relu").run(graph_str)
+        self.assertEqual(frozen(x), m(x))
+
     def test_insert_quantdequant_consecutive_qnodes_script(self):
         input_data = torch.ones([1, 1, 5, 5])
 
@@ -1466,6 +1617,70 @@ graph(%x : Tensor,
                    .check_next("dequantize_linear") \
                    .check("conv2d").run(str(scriptModule.graph))
 
+    def test_quant_fusion(self):
+        input_str = """
+graph(%x, %w, %b, %y):
+    %x_scale = prim::Constant[value=0.5]()
+    %x_zp = prim::Constant[value=1]()
+    %dtype = prim::Constant[value=13]()
+    %w_scale = prim::Constant[value=0.5]()
+    %w_zp = prim::Constant[value=128]()
+    %alpha = prim::Constant[value=1]()
+    %x_quant = aten::quantize_linear(%x, %x_scale, %x_zp, %dtype)
+    %x_intrepr = aten::int_repr(%x_quant)
+    %x_dequant = aten::dequantize_linear(%x_intrepr, %x_scale, %x_zp, %dtype)
+    %w_quant = aten::quantize_linear(%w, %w_scale, %w_zp, %dtype)
+    %w_intrepr = aten::int_repr(%w_quant)
+    %w_dequant = aten::dequantize_linear(%w_intrepr, %w_scale, %w_zp, %dtype)
+    %y_quant = aten::quantize_linear(%y, %x_scale, %x_zp, %dtype)
+    %y_intrepr = aten::int_repr(%y_quant)
+    %y_dequant = aten::dequantize_linear(%y_intrepr, %x_scale, %x_zp, %dtype)
+    # CHECK: quantized::fbgemm_linear_prepack
+    # CHECK: quantized::fbgemm_linear
+    %l = aten::linear(%x_dequant, %w_dequant, %b)
+    %l_quant = aten::quantize_linear(%l, %x_scale, %x_zp, %dtype)
+    %l_intrepr = aten::int_repr(%l_quant)
+    %l_dequant = aten::dequantize_linear(%l_intrepr, %x_scale, %x_zp, %dtype)
+    # CHECK: quantized::add
+    %a = aten::add(%l_dequant, %y_dequant, %alpha)
+    %a_quant = aten::quantize_linear(%a, %x_scale, %x_zp, %dtype)
+    %a_intrepr = aten::int_repr(%a_quant)
+    %a_dequant = aten::dequantize_linear(%a_intrepr, %x_scale, %x_zp, %dtype)
+    # CHECK: quantized::relu
+    %r = aten::relu(%a_dequant)
+    %r_quant = aten::quantize_linear(%r, %x_scale, %x_zp, %dtype)
+    %r_intrepr = aten::int_repr(%r_quant)
+    %r_dequant = aten::dequantize_linear(%r_intrepr, %x_scale, %x_zp, %dtype)
+    # CHECK-NOT: aten::linear
+    # CHECK-NOT: aten::relu
+    # CHECK: aten::dequantize_linear
+    # CHECK-NEXT: return
+    return (%r_dequant)"""
+        graph = parse_ir(input_str)
+        torch._C._jit_pass_quant_fusion(graph)
+        FileCheck().run(input_str, graph)
+        FileCheck().check_count("aten::dequantize_linear", 1, exactly=True) \
+                   .run(str(graph))
+
+        # Quant-dequant pairs with different qparams around relu are kept
+        input_str = """
+graph(%x):
+    %x_scale = prim::Constant[value=0.5]()
+    %r_scale = prim::Constant[value=0.25]()
+    %zp = prim::Constant[value=1]()
+    %dtype = prim::Constant[value=13]()
+    %x_quant = aten::quantize_linear(%x, %x_scale, %zp, %dtype)
+    %x_intrepr = aten::int_repr(%x_quant)
+    %x_dequant = aten::dequantize_linear(%x_intrepr, %x_scale, %zp, %dtype)
+    # CHECK-NOT: quantized::relu
+    # CHECK: aten::relu
+    %r = aten::relu(%x_dequant)
+    %r_quant = aten::quantize_linear(%r, %r_scale, %zp, %dtype)
+    return (%r_quant)"""
+        graph = parse_ir(input_str)
+        torch._C._jit_pass_quant_fusion(graph)
+        FileCheck().run(input_str, graph)
+
     def test_pattern_based_rewrite(self):
         # mul(mul(mul(mul(x,y),z),x),y) --> mul(mul(mulmul(x,y,z), x), y) -->
         # --> mulmul(mulmul(x,y,z), x, y)
@@ -1595,6 +1810,60 @@ graph(%Ra, %Rb):
         torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
         FileCheck().check("Double(4, 3, 8, 5)").run(str(graph))
 
+    def test_symbolic_shape_analysis(self):
+        graph = parse_ir("""
+            graph(%x : Tensor, %w : Tensor, %b : Tensor):
+              %0 : int = prim::Constant[value=0]()
+              %1 : int = prim::Constant[value=1]()
+              %minus_one : int = prim::Constant[value=-1]()
+              %batch : int = aten::size(%x, %0)
+              %sizes : int[] = prim::ListConstruct(%batch, %minus_one)
+              %flat : Tensor = aten::view(%x, %sizes)
+              %out : Tensor = aten::matmul(%flat, %w)
+              %broadcast : Tensor = aten::add(%out, %b, %1)
+              %unsqueezed : Tensor = aten::unsqueeze(%broadcast, %1)
+              return (%unsqueezed)""")
+        # Symbols are negative, and -1 stands for the batch size
+        shapes = torch._C._jit_pass_propagate_symbolic_shapes(graph, [[-1, 3, 4], [12, 5], [5]])
+        self.assertEqual(shapes['flat'], [-1, 12])
+        self.assertEqual(shapes['out'], [-1, 5])
+        self.assertEqual(shapes['broadcast'], [-1, 5])
+        self.assertEqual(shapes['unsqueezed'], [-1, 1, 5])
+
+        def grow(x, n):
+            # type: (Tensor, int) -> Tensor
+            y = x
+            for _ in range(n):
+                y = torch.cat([y, x], 1)
+            return y
+
+        graph = torch.jit.script(grow).graph
+        shapes = torch._C._jit_pass_propagate_symbolic_shapes(graph, [[-1, 3], None])
+        output_shape = shapes[next(graph.outputs()).uniqueName()]
+        # the batch size is the same at every iteration, but not the columns
+        self.assertEqual(output_shape[0], -1)
+        self.assertLess(output_shape[1], -1)
+
+    def test_plan_memory(self):
+        def fn(x, y):
+            a = x + y
+            b = a * y
+            c = b.tanh()
+            return c - x
+
+        x = torch.randn(3, 4)
+        y = torch.randn(3, 4)
+
+        graph = torch.jit.script(fn).graph
+        torch._C._jit_pass_complete_shape_analysis(graph, (x, y), False)
+        torch._C._jit_pass_plan_memory(graph)
+        # a and c are never live at the same time, so they share an offset
+        FileCheck().check("prim::Constant[value=128]").check("prim::AllocateArena") \
+            .check_count("prim::ArenaTensor", 3, exactly=True) \
+            .check_count("aten::sub", 1, exactly=True).run(str(graph))
+        planned = self.createFunctionFromGraph(graph)
+        self.assertEqual(planned(x, y), fn(x, y))
+
     # TODO: update verify to work with GraphExecutors
     @unittest.skip("verify needs to be updated to work with GraphExecutors")
     def test_verify(self):
@@ -4654,6 +4923,44 @@ a")
             return a == [0, 1, 2, 3]
         self.checkScript(test_append, ())
 
+    def test_list_ops_reuse_dead_lists(self):
+        # list ops take over lists nothing else refers to; the ones still in
+        # use must not change
+        def add_in_loop(n):
+            # type: (int) -> List[int]
+            l = torch.jit.annotate(List[int], [])
+            for i in range(n):
+                l = l + [i]
+            return l
+        self.checkScript(add_in_loop, (5,))
+
+        def add_keeps_operands(x):
+            # type: (List[Tensor]) -> Tuple[List[Tensor], List[Tensor], List[Tensor]]
+            a = x + [x[0]]
+            b = a + a
+            return x, a, b
+        self.checkScript(add_keeps_operands, ([torch.ones(2), torch.zeros(2)],))
+
+        def extend(x):
+            # type: (List[int]) -> Tuple[List[int], List[int]]
+            y = [4, 5]
+            x.extend(y)
+            x.extend(x)
+            return x, y
+        self.checkScript(extend, ([1, 2],))
+
+        def unpack(x):
+            # type: (Tuple[Tensor, List[int]]) -> Tuple[Tensor, List[int], Tuple[Tensor, List[int]]]
+            a, b = x
+            return a, b, x
+        self.checkScript(unpack, ((torch.ones(2), [1, 2]),))
+
+        def dict_int_keys():
+            d = {2 ** 40: 1, 2 ** 41: 2}
+            d[2 ** 40 + 1] = 3
+            return d[2 ** 40], d[2 ** 41], d[2 ** 40 + 1]
+        self.checkScript(dict_int_keys, ())
+
     def test_comprehensions_basic(self):
         def comp(l):
             # type: (List[int]) -> List[int]
@@ -5083,8 +5390,7 @@ a")
         self.checkScript(script, [alpha, beta, x, y], optimize=False, outputs=outputs)
 
     def test_profiling_graph_executor(self):
-        @torch.jit.script
-        def basic(x, y):
+        def basic_fn(x, y):
             a = x + y
             b = x * y
             c = x + 1
@@ -5092,6 +5398,7 @@ a")
             e = b - c
             return d + e
 
+        basic = torch.jit.script(basic_fn)
         a = torch.rand(2, 3)
         b = torch.rand(2, 3)
 
@@ -5100,12 +5407,18 @@ a")
             basic(a, b)
             basic(a, b)
 
-            # this tests that a profiling count is being decrement by
-            # a profile instruction.
-            # this is the easiest way to test that a graph was instrumented
-            # from python
-            with self.assertRaisesRegex(RuntimeError, "Not yet implemented"):
-                basic(a, b)
+            # once profiling is done, the inputs are specialized to the
+            # profiled types
+            self.assertEqual(basic(a, b), basic_fn(a, b))
+            g = torch.jit.last_executed_optimized_graph()
+            FileCheck().check("Float(2, 3)").run(str(g))
+
+            # inputs that don't match the profiled types run the fallback
+            c = torch.rand(4, 5)
+            d = torch.rand(4, 5)
+            self.assertEqual(basic(c, d), basic_fn(c, d))
+            g = torch.jit.last_executed_optimized_graph()
+            FileCheck().check_not("Float(2, 3)").run(str(g))
 
     def test_resize_input_ops(self):
         # resize_ and resize_as resize the input tensor. because our shape analysis
@@ -7436,6 +7749,46 @@ a")
         with self.assertRaisesRegex(RuntimeError, "cannot re-assign"):
             m.sub = nn.Linear(5, 5)
 
+    def test_script_module_share_compiled_methods(self):
+        class Layer(torch.jit.ScriptModule):
+            __constants__ = ['scale']
+
+            def __init__(self, scale):
+                super(Layer, self).__init__()
+                self.linear = nn.Linear(3, 3)
+                self.scale = scale
+
+            @torch.jit.script_method
+            def forward(self, x):
+                if self.training:
+                    x = x * 2
+                return self.linear(x) * self.scale
+
+        class Net(torch.jit.ScriptModule):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.a = Layer(2)
+                self.b = Layer(2)
+                self.c = Layer(3)
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return self.c(self.b(self.a(x)))
+
+        net = Net()
+        # identical layers share the lowered graph, but not when their
+        # constants differ
+        graph = net.a.forward.graph
+        self.assertIs(graph, net.b.forward.graph)
+        self.assertIsNot(graph, net.c.forward.graph)
+
+        # each layer still binds its own parameters and training flag
+        x = torch.randn(2, 3)
+        net.b.eval()
+        self.assertEqual(net.a(x), net.a.linear(x * 2) * 2)
+        self.assertEqual(net.b(x), net.b.linear(x) * 2)
+        self.assertEqual(net(x), net.c.linear(net.b.linear(net.a.linear(x * 2) * 2) * 4) * 3)
+
     def test_script_inline_trace_multiple_args(self):
         class M(torch.jit.ScriptModule):
             def __init__(self):
@@ -9750,6 +10103,61 @@ a")
         self.checkScript(fn, (torch.tensor(1),))
         self.checkScript(fn, (torch.tensor(2),))
 
+    def test_loop_invariant_code_motion(self):
+        def fn(x, w, n):
+            # type: (Tensor, Tensor, int) -> Tensor
+            for _ in range(n):
+                x = x + w.t()
+            return x
+
+        graph = torch.jit.script(fn).graph.copy()
+        self.run_pass('licm', graph)
+        FileCheck().check("aten::gt").check("prim::If").check("aten::t").check("prim::Loop").run(str(graph))
+        x, w = torch.randn(3, 3), torch.randn(3, 3)
+        for n in [-1, 0, 3]:
+            self.checkScript(fn, (x, w, n))
+
+        def mutated(x, n):
+            # type: (Tensor, int) -> Tensor
+            x = x.clone()
+            y = x
+            for _ in range(n):
+                y = x.t()
+                x.add_(1)
+            return y
+
+        graph = torch.jit.script(mutated).graph.copy()
+        self.run_pass('licm', graph)
+        FileCheck().check("prim::Loop").check("aten::t").run(str(graph))
+        self.checkScript(mutated, (torch.randn(3, 3), 3))
+
+    def test_strength_reduction(self):
+        def offsets(n, stride):
+            # type: (int, int) -> List[int]
+            result = []
+            for i in range(n):
+                result.append(i * stride)
+            return result
+
+        graph = torch.jit.script(offsets).graph.copy()
+        self.run_pass('strength_reduction', graph)
+        FileCheck().check_not("aten::mul").run(str(graph))
+        self.checkScript(offsets, (5, 3))
+
+        def last(x, n):
+            # type: (Tensor, int) -> Tensor
+            xs = [x]
+            y = x
+            for _ in range(n):
+                xs.append(y + 1)
+                y = xs[-1]
+            return y
+
+        graph = torch.jit.script(last).graph.copy()
+        self.run_pass('strength_reduction', graph)
+        FileCheck().check("aten::append").check_not("aten::select").run(str(graph))
+        self.checkScript(last, (torch.randn(2), 3))
+
     def test_where(self):
         def fn(x, y):
             return torch.where(x > 0.0, x, y)
@@ -9859,6 +10267,64 @@ a")
             return b + 1
         self.checkScript(foo, (torch.rand(3),))
 
+    def test_interpreter_specialized_opcodes(self):
+        def foo(xs, t, n):
+            # type: (List[int], Tuple[Tensor, int], int) -> Tuple[List[int], Tensor]
+            a, b = xs
+            y, c = t
+            for i in range(n):
+                if i < a:
+                    c = c * 2 + b
+                else:
+                    y = y + c
+            return [a, c], y
+
+        inputs = ([3, 1], (torch.zeros(2), 1), 5)
+        self.checkScript(foo, inputs)
+
+        scripted = torch.jit.script(foo)
+        scripted(*inputs)
+        code = str(get_execution_plan(scripted.get_debug_state()).code)
+        FileCheck().check("# LIST_UNPACK").check("# TUPLE_UNPACK") \
+            .check("# JF").check("# INT_LT").check("# JT").check("# JMP") \
+            .check("# INT_MUL").check("# INT_ADD").check("# LIST_CONSTRUCT") \
+            .check("# TUPLE_CONSTRUCT").run(code)
+
+        with self.assertRaisesRegex(RuntimeError, "Expected 2 elements in a list but found 3"):
+            scripted([1, 2, 3], *inputs[1:])
+
+    def test_frozen_executor(self):
+        class M(torch.jit.ScriptModule):
+            @torch.jit.script_method
+            def forward(self, x):
+                return torch.tanh(x) * 2 + 1
+
+        m = M()
+        x = torch.randn(4, 4)
+        with torch.no_grad():
+            m(x)
+            m._c._freeze_executors()
+            self.assertEqual(len(m.get_debug_state().execution_plans), 1)
+
+            results = [None] * 8
+
+            def run(i):
+                for _ in range(20):
+                    results[i] = m(x)
+
+            threads = [threading.Thread(target=run, args=(i,)) for i in range(len(results))]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            for r in results:
+                self.assertEqual(r, torch.tanh(x) * 2 + 1)
+
+            # inputs that don't match the compiled plan don't get a new one
+            y = torch.randn(2, 3, 4)
+            self.assertEqual(m(y), torch.tanh(y) * 2 + 1)
+            self.assertEqual(len(m.get_debug_state().execution_plans), 1)
+
     def test_multi_reduction(self):
         with self.assertRaisesRegex(
                 RuntimeError,
@@ -10172,6 +10638,45 @@ a")
             .check_next("aten::neg").check("scope: TracedModule/traced_fn") \
             .run(str(tm.graph))
 
+    def test_trace_reuse_module_traces(self):
+        class Block(nn.Module):
+            def __init__(self):
+                super(Block, self).__init__()
+                self.linear = nn.Linear(4, 4)
+                self.bn = nn.BatchNorm1d(4)
+
+            def forward(self, x):
+                return torch.relu(self.bn(self.linear(x))) + x
+
+        class Net(nn.Module):
+            def __init__(self):
+                super(Net, self).__init__()
+                self.blocks = nn.Sequential(*[Block() for _ in range(8)])
+                self.head = nn.Linear(4, 2)
+
+            def forward(self, x):
+                return self.head(self.blocks(x))
+
+        net = Net()
+        x = torch.randn(3, 4)
+        traced = torch.jit.trace(copy.deepcopy(net), x)
+        reused = torch.jit.trace(copy.deepcopy(net), x, _reuse_module_traces=True)
+
+        def canonical(graph):
+            graph = torch._C._jit_pass_canonicalize(graph)
+            torch._C._jit_pass_erase_shape_information(graph)
+            return str(graph)
+
+        self.assertEqual(canonical(traced.graph), canonical(reused.graph))
+        self.assertEqual(traced(x), reused(x))
+        # the running stats of the batch norms are updated by replayed calls too
+        self.assertEqual(traced.blocks[7].bn.running_mean, reused.blocks[7].bn.running_mean)
+
+        # modules with different shapes aren't reused
+        net.blocks[3] = nn.Linear(4, 4, bias=False)
+        reused = torch.jit.trace(net, x, _reuse_module_traces=True)
+        self.assertEqual(canonical(torch.jit.trace(net, x).graph), canonical(reused.graph))
+
     def test_trace_hierarchy(self):
         # Test that we preserve the module hierarchy for a ScriptModule
         # submodule during tracing
@@ -12085,6 +12590,86 @@ a")
         self.assertEqual(loaded.submodule.buffer1, torch.ones(2, 2) + 10)
         self.assertEqual(loaded.submodule.buffer2, torch.ones(2, 2) + 10)
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
+    def test_load_lazily(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.weight = nn.Parameter(torch.randn(3, 4))
+                self.register_buffer('buffer', torch.arange(5.))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return torch.mm(x, self.weight)
+
+        m = M()
+        x = torch.randn(2, 3)
+        with TemporaryFileName() as fname:
+            m.save(fname)
+            loaded = torch.jit.load(fname, lazy=True)
+            self.assertEqual(loaded.weight, m.weight)
+            self.assertEqual(loaded.buffer, m.buffer)
+            self.assertEqual(loaded(x), m(x))
+
+            # writes to a lazily loaded module don't reach the file
+            with torch.no_grad():
+                loaded.weight.add_(1)
+            self.assertEqual(loaded.weight, m.weight + 1)
+            self.assertEqual(torch.jit.load(fname).weight, m.weight)
+
+            with self.assertRaisesRegex(ValueError, "onto CPU"):
+                torch.jit.load(fname, map_location='cuda', lazy=True)
+            with open(fname, 'rb') as f:
+                with self.assertRaisesRegex(ValueError, "file name"):
+                    torch.jit.load(f, lazy=True)
+
+    def test_reload_parameters(self):
+        class Sub(torch.jit.ScriptModule):
+            def __init__(self):
+                super(Sub, self).__init__()
+                self.bias = nn.Parameter(torch.randn(4))
+                self.register_buffer('scale', torch.randn(4))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return x * self.scale + self.bias
+
+        class M(torch.jit.ScriptModule):
+            def __init__(self, n=3):
+                super(M, self).__init__()
+                self.weight = nn.Parameter(torch.randn(n, 4))
+                self.sub = Sub()
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return self.sub(torch.mm(x, self.weight))
+
+        m = M()
+        x = torch.randn(2, 3)
+        loaded = self.getExportImportCopy(m)
+        loaded(x)
+        graph = loaded.graph_for(x)
+
+        retrained = M()
+        buffer = io.BytesIO()
+        torch.jit.save(retrained, buffer)
+        buffer.seek(0)
+        torch.jit.reload_parameters(loaded, buffer)
+        self.assertEqual(loaded.weight, retrained.weight)
+        self.assertEqual(loaded.sub.bias, retrained.sub.bias)
+        self.assertEqual(loaded.sub.scale, retrained.sub.scale)
+        self.assertEqual(loaded(x), retrained(x))
+        self.assertEqual(str(loaded.graph_for(x)), str(graph))
+
+        # a mismatch leaves every tensor in place
+        buffer = io.BytesIO()
+        torch.jit.save(M(n=5), buffer)
+        buffer.seek(0)
+        with self.assertRaisesRegex(RuntimeError, "'weight' of module"):
+            torch.jit.reload_parameters(loaded, buffer)
+        self.assertEqual(loaded.sub.bias, retrained.sub.bias)
+        self.assertEqual(loaded(x), retrained(x))
+
 
     def test_string_slicing(self):
         def fn1(x):
@@ -12754,6 +13339,23 @@ a")
                 .check_count(s2, 1, exactly=True) \
                 .check_count("BINGET", 2, exactly=True).run(out.getvalue())
 
+    def test_serialization_large_containers(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.dict = torch.jit.Attribute({str(i): i for i in range(1000)}, Dict[str, int])
+                self.int_list = torch.jit.Attribute(list(range(-500, 500)) + [2 ** 40], List[int])
+                self.float_list = torch.jit.Attribute([i / 3. for i in range(1000)], List[float])
+                self.bool_list = torch.jit.Attribute([i % 3 == 0 for i in range(1000)], List[bool])
+                self.tuple = torch.jit.Attribute((1, 2), Tuple[int, int])
+
+            @torch.jit.script_method
+            def forward(self):
+                return self.dict, self.int_list, self.float_list, self.bool_list, self.tuple
+
+        m = M()
+        self.assertEqual(m(), self.getExportImportCopy(m)())
+
     def test_optional_tuple(self):
         def fn(x=None):
             # type: (Optional[Tuple[int, int]]) -> Tuple[int, int]
@@ -13417,6 +14019,22 @@ class TestPytorchExportModes(JitTestCase):
                            export_type=torch.onnx.ExportTypes.DIRECTORY)
         shutil.rmtree(d)
 
+    def test_directory_matches_zipfile(self):
+        torch_model = nn.Sequential(nn.Linear(4, 8), nn.ReLU(), nn.Linear(8, 2))
+        fake_input = torch.randn(3, 4)
+        f = io.BytesIO()
+        torch.onnx._export(torch_model, (fake_input), f, export_type=torch.onnx.ExportTypes.ZIP_ARCHIVE)
+        d = tempfile.mkdtemp()
+        try:
+            torch.onnx._export(torch_model, (fake_input), d, export_type=torch.onnx.ExportTypes.DIRECTORY)
+            with zipfile.ZipFile(f) as z:
+                self.assertEqual(sorted(z.namelist()), sorted(os.listdir(d)))
+                for name in z.namelist():
+                    with open(os.path.join(d, name), 'rb') as weight_file:
+                        self.assertEqual(z.read(name), weight_file.read())
+        finally:
+            shutil.rmtree(d)
+
     def test_onnx_multiple_return(self):
         @torch.jit.script
         def foo(a):
@@ -14750,6 +15368,55 @@ class TestAsync(JitTestCase):
         self.assertEqual(y2, foo2(x1, x2))
         self.assertEqual(y3, foo3(x1, x2, x3))
 
+    def test_fork_independent_nodes(self):
+        def towers(x, w1, w2):
+            a = torch.mm(x, w1).tanh()
+            b = torch.mm(x, w2).tanh()
+            return torch.cat([a, b], 1)
+
+        scripted = torch.jit.script(towers)
+        # the types of the script graph aren't complete, so the costs aren't known
+        graph = scripted.graph.copy()
+        torch._C._jit_pass_fork_independent_nodes(graph, min_cost=0)
+        FileCheck().check_not("aten::mm").check_count("prim::fork", 1, exactly=True) \
+            .check("aten::mm").check("aten::wait").check("aten::cat").run(str(graph))
+        graph = scripted.graph.copy()
+        torch._C._jit_pass_fork_independent_nodes(graph, min_cost=1)
+        FileCheck().check_not("prim::fork").run(str(graph))
+
+        x, w1, w2 = torch.randn(64, 64), torch.randn(64, 64), torch.randn(64, 64)
+        torch._C._jit_set_automatic_fork_mode(True)
+        try:
+            scripted = torch.jit.script(towers)
+            self.assertEqual(scripted(x, w1, w2), towers(x, w1, w2))
+            FileCheck().check("prim::fork").run(str(torch._C._last_executed_optimized_graph()))
+        finally:
+            torch._C._jit_set_automatic_fork_mode(False)
+
+    @unittest.skipIf(not RUN_CUDA, "requires CUDA")
+    def test_async_script_cuda_streams(self):
+        # The forks run on streams of their own, which must wait for the
+        # inputs queued on the current stream, and be waited for at the wait
+        @torch.jit.script
+        def tower(x, w):
+            for _ in range(10):
+                x = torch.mm(x, w).tanh()
+            return x
+
+        @torch.jit.script
+        def wait_script(x, w1, w2):
+            x = x * 2
+            f1 = torch.jit._fork(tower, x, w1)
+            f2 = torch.jit._fork(tower, x, w2)
+            return torch.jit._wait(f1) + torch.jit._wait(f2)
+
+        x = torch.randn(512, 512, device='cuda')
+        w1 = torch.randn(512, 512, device='cuda') / 32
+        w2 = torch.randn(512, 512, device='cuda') / 32
+        expected = tower(x * 2, w1) + tower(x * 2, w2)
+        for _ in range(3):
+            self.assertEqual(wait_script(x, w1, w2), expected)
+
     def test_async_script_trace(self):
         class Traced(nn.Module):
             def __init__(self):
@@ -14941,6 +15608,59 @@ class TestAsync(JitTestCase):
         f = io.BytesIO()
         torch.onnx.export(MyMod(), (torch.rand(3, 4),), f)
 
+    def test_save_for_mobile(self):
+        class MyMod(torch.jit.ScriptModule):
+            def __init__(self):
+                super(MyMod, self).__init__()
+                self.weight = torch.nn.Parameter(torch.rand(3, 4))
+                self.register_buffer('offset', torch.rand(4))
+
+            @torch.jit.script_method
+            def forward(self, x, n):
+                # type: (Tensor, int) -> Tuple[Tensor, List[int]]
+                y = x.mm(self.weight.t())
+                sizes = []
+                for i in range(n):
+                    if i % 2 == 0:
+                        y = y * 2
+                    else:
+                        y = y.relu() - 1
+                    sizes.append(i)
+                return y, sizes
+
+            @torch.jit.script_method
+            def shifted(self, x):
+                a, b = x.chunk(2, 1)
+                return torch.cat([b, a], 1) + self.offset
+
+        m = MyMod()
+        x = torch.randn(2, 4)
+        mobile_m = torch._C._load_for_mobile_from_buffer(m._save_to_buffer_for_mobile())
+        for n in range(4):
+            self.assertEqual(mobile_m.forward(x, n), m(x, n))
+        self.assertEqual(mobile_m.run_method('shifted', x), m.shifted(x))
+        with self.assertRaisesRegex(RuntimeError, "expected 2 inputs"):
+            mobile_m.forward(x)
+        with self.assertRaisesRegex(RuntimeError, "is not defined"):
+            mobile_m.run_method('backward', x)
+
+        with TemporaryFileName() as fname:
+            m._save_for_mobile(fname)
+            self.assertEqual(torch._C._load_for_mobile(fname).forward(x, 3), m(x, 3))
+
+        @torch.jit.script
+        def fork_body(x):
+            return torch.neg(x)
+
+        class ForkMod(torch.jit.ScriptModule):
+            @torch.jit.script_method
+            def forward(self, x):
+                fut = torch.jit._fork(fork_body, x)
+                return torch.jit._wait(fut)
+
+        with self.assertRaisesRegex(RuntimeError, "can't be serialized to bytecode"):
+            ForkMod()._save_to_buffer_for_mobile()
+
     def test_save_load_with_extra_files(self):
         class MyMod(torch.jit.ScriptModule):
             @torch.jit.script_method
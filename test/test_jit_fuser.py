@@ -3,6 +3,9 @@ from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
 
+import os
+import shutil
+import tempfile
 import unittest
 import torch
 import torch.nn as nn
@@ -42,6 +45,73 @@ class TestFuser(JitTestCase):
     def test_abs_cpu(self):
         self._test_fused_abs()
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_contiguous_codegen_cpu(self):
+        graph = torch._C.parse_ir('''
+            graph(%x : Float(*, *),
+                  %y : Float(*, *)):
+                %a : int = prim::Constant[value=1]()
+                %b : Float(*, *) = aten::mul(%x, %y)
+                %c : Float(*, *) = aten::add(%b, %x, %a)
+                return (%c)
+        ''')
+        x = torch.randn(8, 16)
+        code = torch._C._jit_fuser_get_fused_kernel_code(graph, [x, x])
+        FileCheck().check('omp parallel for simd').check_not('.sizes[').run(code)
+
+        # non-contiguous inputs take the general path
+        y = torch.randn(16, 8).t()
+        code = torch._C._jit_fuser_get_fused_kernel_code(graph, [x, y])
+        FileCheck().check('omp parallel for if').check('.sizes[').run(code)
+
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_reduction_fusion_cpu(self):
+        def sum_relu(x, y):
+            return (x * y + x).relu().sum(-1)
+
+        def mean_keepdim(x, y):
+            return (x - y).mean(dim=1, keepdim=True)
+
+        x = torch.randn(8, 65)
+        y = torch.randn(8, 65)
+        for fn in (sum_relu, mean_keepdim):
+            s = self.checkScript(fn, (x, y))
+            self.assertAllFused(s.graph_for(x, y))
+            s = self.checkScript(fn, (x.t().contiguous().t(), y))
+            self.assertAllFused(s.graph_for(x.t().contiguous().t(), y))
+
+        # the reduced values are not fused with their consumers
+        def sum_mul(x, y):
+            return (x * y).sum(-1) * 2
+
+        s = self.checkScript(sum_mul, (x, y))
+        FileCheck().check("prim::FusionGroup").check("aten::mul").run(str(s.graph_for(x, y)))
+
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_kernel_cache_dir_cpu(self):
+        @torch.jit.script
+        def func(x, y):
+            return (x * y + x).sigmoid()
+
+        old_dir = torch._C._jit_get_cpu_fusion_cache_dir()
+        cache_dir = tempfile.mkdtemp()
+        torch._C._jit_set_cpu_fusion_cache_dir(cache_dir)
+        try:
+            x = torch.randn(4, 4)
+            y = torch.randn(4, 4)
+            self.assertEqual(func(x, y), (x * y + x).sigmoid())
+            self.assertAllFused(func.graph_for(x, y))
+            files = sorted(os.listdir(cache_dir))
+            self.assertEqual(len(files), 2)
+            self.assertTrue(files[0].endswith('.cpp'))
+            self.assertEqual(files[1], files[0][:-4] + '.so')
+        finally:
+            torch._C._jit_set_cpu_fusion_cache_dir(old_dir)
+            shutil.rmtree(cache_dir)
+
     @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
     @unittest.skipIf(not RUN_CUDA, "requires CUDA")
     @skipIfRocm
@@ -1,5 +1,6 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import copy
+import itertools
 import unittest
 
 import torch
@@ -237,6 +238,20 @@ class TestMkldnn(TestCase):
                 linear(x),
                 mkldnn_linear(x.to_mkldnn()).to_dense())
 
+    def _test_rnn(self, module):
+        x = torch.randn(5, 3, 10, dtype=torch.float32)
+        for bias, bidirectional in itertools.product([True, False], repeat=2):
+            rnn = module(10, 20, num_layers=2, bias=bias, bidirectional=bidirectional).float()
+            mkldnn_rnn = mkldnn_utils.to_mkldnn(copy.deepcopy(rnn))
+            with torch.no_grad():
+                self.assertEqual(rnn(x), mkldnn_rnn(x))
+
+    def test_lstm(self):
+        self._test_rnn(torch.nn.LSTM)
+
+    def test_gru(self):
+        self._test_rnn(torch.nn.GRU)
+
 
 if __name__ == '__main__':
     run_tests()
@@ -92,6 +92,15 @@ def sum_tensors(inq, outq):
                       tensor.numel(), tensor.storage().size()))
 
 
+def sum_tensors_until_none(inq, outq):
+    while True:
+        tensors = inq.get()
+        if tensors is None:
+            break
+        outq.put([tensor.sum().item() for tensor in tensors])
+        del tensors
+
+
 def queue_get_exception(inqueue, outqueue):
     os.close(2)  # hide expected error message
     try:
@@ -334,6 +343,22 @@ class TestMultiprocessing(TestCase):
         with fs_sharing():
             self._test_pool(repeat=TEST_REPEATS)
 
+    @unittest.skipIf(platform == 'darwin', "file descriptor strategy is not supported on macOS")
+    def test_shared_memory_placement(self):
+        self.assertEqual(mp.get_shared_memory_placement(), (False, None))
+        with self.assertRaisesRegex(ValueError, "numa_node"):
+            mp.set_shared_memory_placement(numa_node=-1)
+        mp.set_shared_memory_placement(huge_pages=True, numa_node=0)
+        try:
+            self.assertEqual(mp.get_shared_memory_placement(), (True, 0))
+            # placement is best effort, sharing has to work either way
+            self._test_sharing()
+            with fs_sharing():
+                self._test_sharing()
+        finally:
+            mp.set_shared_memory_placement()
+        self.assertEqual(mp.get_shared_memory_placement(), (False, None))
+
     @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
     def test_fs(self):
         def queue_put():
@@ -455,6 +480,28 @@ class TestMultiprocessing(TestCase):
         # memory 'file' for performance reason
         torch.cuda.ipc_collect()
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_reuse_ipc_handles(self):
+        # Many small tensors from the same segments, sent in several rounds,
+        # with the segments returned to the driver in between so that new
+        # ones may start at the same addresses
+        ctx = mp.get_context('spawn')
+        inq = ctx.Queue()
+        outq = ctx.Queue()
+        p = ctx.Process(target=sum_tensors_until_none, args=(inq, outq))
+        p.start()
+        for i in range(5):
+            tensors = [torch.full((5,), i * 100 + j, device='cuda') for j in range(100)]
+            inq.put(tensors)
+            self.assertEqual(outq.get(), [5. * (i * 100 + j) for j in range(100)])
+            del tensors
+            torch.cuda.ipc_collect()
+            torch.cuda.empty_cache()
+        inq.put(None)
+        p.join()
+
     @unittest.skipIf(IS_WINDOWS, 'not applicable to Windows (only fails with fork)')
     @unittest.skipIf(not torch.cuda.is_available(), 'CUDA not available')
     def test_cuda_bad_call(self):
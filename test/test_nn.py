@@ -207,6 +207,21 @@ class PackedSequenceTest(TestCase):
                     self.assertIs(b, b.to(dtype=torch.int32))
                     self.assertEqual(b.long(), b.to(dtype=torch.int64))
 
+    def test_sum_packed_sequence(self):
+        lengths = [random.randint(1, self.max_length) for _ in range(self.batch_size)]
+        sequences = [torch.randn(l, 3, dtype=torch.double, requires_grad=True) for l in lengths]
+        packed = rnn_utils.pack_sequence(sequences, enforce_sorted=False)
+        expected = torch.stack([s.sum(0) for s in sequences])
+        self.assertEqual(rnn_utils.sum_packed_sequence(packed), expected)
+
+        ordered = self._ordered_sequence(torch.LongTensor)
+        packed = rnn_utils.pack_sequence(ordered)
+        self.assertEqual(rnn_utils.sum_packed_sequence(packed), torch.stack([s.sum() for s in ordered]))
+
+        data = packed.data.double().requires_grad_()
+        _assertGradAndGradgradChecks(self, lambda data: torch._C._VariableFunctions._sum_packed_sequence(
+            data, packed.batch_sizes), (data,))
+
 
 def default_tensor_type(type):
     type_str = torch.typename(type)
@@ -2070,6 +2085,41 @@ class TestNN(NNTestCase):
     def test_embedding_dense_grad_cuda(self):
         self._test_embedding_dense_grad("cuda")
 
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_embedding_backward_duplicates_cuda(self):
+        # A few heavily repeated indices are summed into partial segments
+        # that are added up in order, so the gradient is deterministic
+        indices = torch.cat([torch.zeros(5000, dtype=torch.long),
+                             torch.randint(1, 50, (1000,)),
+                             torch.full((3000,), 7, dtype=torch.long)])
+        indices = indices[torch.randperm(indices.numel())]
+        grad = torch.randn(indices.numel(), 33, dtype=torch.double)
+        weight = torch.randn(50, 33, dtype=torch.double, requires_grad=True)
+        weight_cuda = weight.detach().cuda().requires_grad_()
+        for padding_idx, scale_grad_by_freq in [(None, False), (7, False), (None, True)]:
+            F.embedding(indices, weight, padding_idx=padding_idx,
+                        scale_grad_by_freq=scale_grad_by_freq).backward(grad)
+            results = []
+            for _ in range(2):
+                F.embedding(indices.cuda(), weight_cuda, padding_idx=padding_idx,
+                            scale_grad_by_freq=scale_grad_by_freq).backward(grad.cuda())
+                results.append(weight_cuda.grad)
+                weight_cuda.grad = None
+            self.assertEqual(results[0], weight.grad)
+            self.assertTrue(torch.equal(results[0], results[1]))
+            weight.grad = None
+
+        offsets = torch.arange(0, indices.numel(), 40)
+        input = (indices.cuda(), offsets.cuda())
+        bag_grad = torch.randn(offsets.numel(), 33, dtype=torch.double)
+        for mode in ['sum', 'mean']:
+            es = nn.EmbeddingBag(50, 33, mode=mode).double()
+            es_cuda = nn.EmbeddingBag(50, 33, mode=mode).double().cuda()
+            es_cuda.weight.data.copy_(es.weight.data)
+            es(indices, offsets).backward(bag_grad)
+            es_cuda(*input).backward(bag_grad.cuda())
+            self.assertEqual(es_cuda.weight.grad, es.weight.grad)
+
     def test_move_sparse_half_embedding(self):
         embedding = nn.Embedding(10, 3, sparse=True)
         self.assertEqual(embedding.weight.device.type, 'cpu')
@@ -2250,6 +2300,17 @@ class TestNN(NNTestCase):
         # should be bitwise equal
         self.assertEqual(input.grad, inputf.grad.to(dtype), prec=0)
 
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_softmax_wide_rows_cuda(self):
+        # few rows of many elements are split across blocks
+        for size in [(1, 1000003), (3, 100000)]:
+            input = torch.randn(size, dtype=torch.double) * 10
+            input[0, 12345] = 1000
+            for fn in [F.softmax, F.log_softmax]:
+                self.assertEqual(fn(input.cuda(), dim=1), fn(input, dim=1))
+                out = fn(input.cuda().float(), dim=1)
+                self.assertEqual(out, fn(input.float(), dim=1), prec=1e-3)
+
     def _test_softmax_backward(self, device):
         if device.type == 'cuda':
             dtypes = [torch.float, torch.half]
@@ -2612,6 +2673,45 @@ class TestNN(NNTestCase):
             self._test_EmbeddingBag(False, 'sum', True, test_backward=test_backward, dtype=dtype)
             self._test_EmbeddingBag(False, 'mean', True, test_backward=test_backward, dtype=dtype)
 
+    def test_embedding_bag_parallel(self):
+        # enough bags to be split between threads; the strided weight goes
+        # down the single-threaded path, which serves as the reference
+        weight = torch.randn(1000, 64)
+        strided_weight = weight.t().contiguous().t()
+        lengths = torch.randint(0, 20, (4000,), dtype=torch.long)
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long), lengths.cumsum(0)[:-1]])
+        input = torch.randint(0, 1000, (int(lengths.sum()),), dtype=torch.long)
+        per_sample_weights = torch.randn(input.size())
+        for mode in ('sum', 'mean'):
+            self.assertEqual(F.embedding_bag(input, weight, offsets, mode=mode),
+                             F.embedding_bag(input, strided_weight, offsets, mode=mode))
+        self.assertEqual(
+            F.embedding_bag(input, weight, offsets, mode='sum', per_sample_weights=per_sample_weights),
+            F.embedding_bag(input, strided_weight, offsets, mode='sum', per_sample_weights=per_sample_weights))
+
+    @unittest.skipIf(not TEST_NUMPY, "numpy not found")
+    def test_embedding_bag_8bit_rowwise(self):
+        weight = torch.randn(100, 16)
+        packed = torch._embedding_bag_pack_8bit_rowwise(weight)
+        self.assertEqual(packed.dtype, torch.uint8)
+        self.assertEqual(packed.size(), (100, 16 + 8))
+        scale_bias = torch.from_numpy(packed[:, -8:].numpy().copy().view(np.float32))
+        dequantized = packed[:, :-8].float() * scale_bias[:, :1] + scale_bias[:, 1:]
+        self.assertEqual(dequantized, weight, prec=1e-2)
+
+        input = torch.randint(0, 100, (50,), dtype=torch.long)
+        offsets = torch.tensor([0, 0, 3, 10, 10, 31], dtype=torch.long)
+        per_sample_weights = torch.randn(50)
+        for mode in ('sum', 'mean'):
+            self.assertEqual(F.embedding_bag(input, packed, offsets, mode=mode),
+                             F.embedding_bag(input, dequantized, offsets, mode=mode), prec=1e-4)
+        self.assertEqual(
+            F.embedding_bag(input, packed, offsets, mode='sum', per_sample_weights=per_sample_weights),
+            F.embedding_bag(input, dequantized, offsets, mode='sum', per_sample_weights=per_sample_weights),
+            prec=1e-4)
+        with self.assertRaisesRegex(RuntimeError, "only supported with mode='sum' or mode='mean'"):
+            F.embedding_bag(input, packed, offsets, mode='max')
+
     @staticmethod
     def _embedding_bag_reference_impl(input, weight, offsets=None, mode='sum',
                                       per_sample_weights=None):
@@ -2855,6 +2955,53 @@ class TestNN(NNTestCase):
         input = torch.randn(num_features, b, d, w, h)
         self._test_alpha_dropout(nn.FeatureAlphaDropout, input)
 
+    def test_fused_dropout_packed_mask(self):
+        def unpack(mask, numel):
+            bits = torch.tensor([1, 2, 4, 8, 16, 32, 64, 128], device=mask.device)
+            return mask.long().unsqueeze(-1).div(bits).remainder(2).view(-1)[:numel]
+
+        devices = ['cpu'] + (['cuda'] if TEST_CUDA else [])
+        for device, shape in itertools.product(devices, [(3, 50), (1000, 7), (0, 5)]):
+            p = 0.7
+            x = torch.randn(*shape, dtype=torch.double, device=device).transpose(0, 1).requires_grad_()
+            bias = torch.randn(shape[0], dtype=torch.double, device=device, requires_grad=True)
+            residual = torch.randn(x.size(), dtype=torch.double, device=device, requires_grad=True)
+            grad = torch.randn(x.size(), dtype=torch.double, device=device)
+
+            out, mask = torch._fused_dropout(x, p)
+            # one bit per element, in whole 64-bit words
+            self.assertEqual(mask.dtype, torch.uint8)
+            self.assertEqual(mask.numel(), (x.numel() + 63) // 64 * 8)
+            keep = unpack(mask, x.numel()).view(x.size()).double()
+            self.assertEqual(out, x * keep / p)
+            x_grad, = torch.autograd.grad(out, x, grad)
+            self.assertEqual(x_grad, grad * keep / p)
+
+            out, mask = torch._fused_bias_dropout_add(x, bias, residual, p)
+            keep = unpack(mask, x.numel()).view(x.size()).double()
+            self.assertEqual(out, (x + bias) * keep / p + residual)
+            x_grad, bias_grad, residual_grad = torch.autograd.grad(out, (x, bias, residual), grad)
+            self.assertEqual(x_grad, grad * keep / p)
+            self.assertEqual(bias_grad, (grad * keep / p).sum(0))
+            self.assertEqual(residual_grad, grad)
+
+        # the CPU masks don't depend on the number of threads
+        x = torch.randn(100000)
+        num_threads = torch.get_num_threads()
+        try:
+            with torch.random.fork_rng(devices=[]):
+                expected = torch._fused_dropout(x, 0.5)
+            torch.set_num_threads(1)
+            with torch.random.fork_rng(devices=[]):
+                self.assertEqual(torch._fused_dropout(x, 0.5), expected)
+        finally:
+            torch.set_num_threads(num_threads)
+
+        with self.assertRaisesRegex(RuntimeError, "packed dropout mask"):
+            torch._masked_scale(x, torch.zeros(x.numel(), dtype=torch.uint8), 2.)
+        with self.assertRaisesRegex(RuntimeError, "expected a bias"):
+            torch._fused_bias_dropout_add(x.view(10, -1), torch.randn(10), None, 0.5)
+
     def _test_InstanceNorm_general(self, cls, input, device="cpu", dtype=torch.float):
         # default case track_running_stats=False
         b, c = input.size(0), input.size(1)
@@ -3110,6 +3257,31 @@ class TestNN(NNTestCase):
         self._test_GroupNorm_general("cuda", torch.float)
         self._test_GroupNorm_cuda_half()
 
+    def test_LayerNorm_GroupNorm_cpu_kernels(self):
+        # the CPU kernels match the normalization with batch_norm, also when
+        # the mean of the input is large compared to its variance
+        def normalize(x, rows):
+            return F.batch_norm(x.contiguous().view(1, rows, -1), None, None, training=True).view_as(x)
+
+        for offset in [0, 1000]:
+            x = (torch.randn(4, 6, 5, 3, dtype=torch.double) + offset).requires_grad_()
+            weight = torch.randn(5, 3, dtype=torch.double, requires_grad=True)
+            bias = torch.randn(5, 3, dtype=torch.double, requires_grad=True)
+            out = F.layer_norm(x, [5, 3], weight, bias)
+            ref = normalize(x, 24) * weight + bias
+            grad = torch.randn_like(out)
+            self.assertEqual(out, ref)
+            self.assertEqual(torch.autograd.grad(out, (x, weight, bias), grad),
+                             torch.autograd.grad(ref, (x, weight, bias), grad))
+
+            weight = torch.randn(6, dtype=torch.double, requires_grad=True)
+            bias = torch.randn(6, dtype=torch.double, requires_grad=True)
+            out = F.group_norm(x, 3, weight, bias)
+            ref = normalize(x, 12) * weight.view(6, 1, 1) + bias.view(6, 1, 1)
+            self.assertEqual(out, ref)
+            self.assertEqual(torch.autograd.grad(out, (x, weight, bias), grad),
+                             torch.autograd.grad(ref, (x, weight, bias), grad))
+
     def test_pad(self):
         inputs = torch.randn(1, 3, 4, 4, requires_grad=True)
         _assertGradAndGradgradChecks(self, lambda x: F.pad(x, (1, 1, 1, 1)), (inputs,))
@@ -3582,6 +3754,31 @@ class TestNN(NNTestCase):
             with torch.backends.cudnn.flags(enabled=False):
                 self._test_batchnorm_eval("cuda", dtype)
 
+    def test_channels_last_cpu(self):
+        def check(module, x, backward=True):
+            nchw = x.detach().clone().requires_grad_()
+            nhwc = x.detach().contiguous(memory_format=torch.channels_last).requires_grad_()
+            out_nchw = module(nchw)
+            out_nhwc = module(nhwc)
+            self.assertTrue(out_nhwc.is_contiguous(memory_format=torch.channels_last))
+            self.assertEqual(out_nchw, out_nhwc)
+            if backward:
+                grad = torch.randn_like(out_nchw)
+                out_nchw.backward(grad)
+                out_nhwc.backward(grad)
+                self.assertEqual(nchw.grad, nhwc.grad)
+
+        x = torch.randn(2, 8, 7, 9, dtype=torch.double)
+        bn = nn.BatchNorm2d(8).double()
+        check(bn, x)
+        check(bn.eval(), x)
+        check(nn.MaxPool2d(3, stride=2, padding=1), x)
+        check(nn.MaxPool2d(2, dilation=2, ceil_mode=True), x)
+        check(nn.AvgPool2d(3, stride=2, padding=1, count_include_pad=False), x, backward=False)
+        check(nn.Upsample(scale_factor=2, mode='nearest'), x, backward=False)
+        check(nn.Conv2d(8, 4, 1).double(), x)
+        check(nn.Conv2d(8, 4, 3, padding=1).double(), x)
+
     def test_batchnorm_simple_average(self):
         self._test_batchnorm_simple_average()
 
@@ -3658,6 +3855,29 @@ class TestNN(NNTestCase):
     def test_max_pool_nan(self, dtype=torch.float):
         self._test_max_pool_nan(self, device="cpu")
 
+    def test_pool2d_unfold_reference_cpu(self):
+        for dtype, kernel_size, stride, padding, dilation in product(
+                [torch.float, torch.double], [2, 3], [1, 2], [0, 1], [1, 2]):
+            x = torch.randn(2, 5, 11, 19, dtype=dtype)
+            x_nc = x.transpose(2, 3).contiguous().transpose(2, 3)
+            x_cl = x.contiguous(memory_format=torch.channels_last)
+
+            # padding with -inf keeps the padded elements out of the maxima
+            padded = F.pad(x, 4 * [padding], value=-inf)
+            cols = F.unfold(padded, kernel_size, dilation=dilation, stride=stride)
+            cols = cols.view(2, 5, kernel_size ** 2, -1)
+            for inp in [x, x_nc, x_cl]:
+                out, idx = F.max_pool2d(inp, kernel_size, stride, padding, dilation, return_indices=True)
+                self.assertEqual(out.flatten(2), cols.max(2)[0])
+                self.assertEqual(out.flatten(2), x.flatten(2).gather(2, idx.flatten(2)))
+
+            if dilation == 1:
+                cols = F.unfold(x, kernel_size, padding=padding, stride=stride)
+                cols = cols.view(2, 5, kernel_size ** 2, -1)
+                for inp in [x, x_nc, x_cl]:
+                    out = F.avg_pool2d(inp, kernel_size, stride, padding, count_include_pad=True)
+                    self.assertEqual(out.flatten(2), cols.mean(2))
+
     @staticmethod
     def _test_pool_large_size(self, device, dtype=torch.float):
         for op in ('max', 'avg'):
@@ -4625,6 +4845,34 @@ class TestNN(NNTestCase):
         self.assertRaisesRegex(RuntimeError, 'Specify retain_graph=True',
                                lambda: o1.sum().backward())
 
+    def test_conv_cpu_inference(self):
+        # Without requires_grad, convolutions take the native CPU kernels of
+        # _cpu_convolution; compare them with the THNN path used for training.
+        def check(input_size, weight_size, **kwargs):
+            conv = F.conv3d if len(input_size) == 5 else F.conv2d
+            input = torch.randn(input_size, dtype=torch.double)
+            weight = torch.randn(weight_size, dtype=torch.double)
+            bias = torch.randn(weight_size[0], dtype=torch.double)
+            expected = conv(input, weight.requires_grad_(), bias, **kwargs)
+            weight.requires_grad_(False)
+            self.assertEqual(conv(input, weight, bias, **kwargs), expected)
+            bias = bias.view(-1, *[1] * (len(input_size) - 2))
+            self.assertEqual(conv(input, weight, None, **kwargs), expected - bias)
+
+        # depthwise
+        check((2, 8, 17, 23), (8, 1, 3, 3), padding=1, groups=8)
+        check((1, 4, 12, 31), (8, 1, 5, 3), stride=(2, 1), padding=(2, 0), dilation=(1, 2), groups=4)
+        # Winograd
+        check((2, 16, 8, 10), (16, 16, 3, 3), padding=1)
+        check((1, 17, 9, 13), (20, 17, 3, 3))
+        # im2col
+        check((2, 16, 7, 9), (8, 16, 1, 1))
+        check((2, 16, 7, 9), (8, 16, 1, 1), stride=2)
+        check((1, 4, 13, 17), (6, 4, 3, 5), stride=2, padding=(2, 1), dilation=2)
+        check((2, 6, 8, 8), (9, 2, 3, 3), stride=(1, 3), padding=(0, 2), groups=3)
+        check((1, 256, 20, 20), (4, 256, 3, 3), stride=2, padding=1)
+        check((2, 3, 5, 6, 7), (4, 3, 3, 3, 3), stride=(2, 1, 2), padding=(1, 1, 0), dilation=(1, 2, 1))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @repeat_test_for_types(ALL_TENSORTYPES)
     def test_Conv2d_large_workspace(self, dtype=torch.float):
@@ -4812,6 +5060,28 @@ class TestNN(NNTestCase):
                                         m2.weight.grad.data], 0),
                              prec=dtype2prec[dtype])
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @repeat_test_for_types(ALL_TENSORTYPES)
+    def test_Conv2d_depthwise_tiled_cuda(self, dtype=torch.float):
+        # 3x3 and 5x5 depthwise convolutions with a stride of 1 or 2 use the
+        # tiled kernel of _cuda_depthwise_convolution
+        for kernel_size, stride, size in product([3, 5], [1, 2], [(1, 7, 7), (4, 14, 14), (2, 33, 21)]):
+            batch, height, width = size
+            m = nn.Conv2d(8, 8, kernel_size, stride=stride, padding=kernel_size // 2, groups=8)
+            m_cuda = deepcopy(m).to("cuda", dtype)
+            i = torch.randn(batch, 8, height, width).div_(2)
+            i_cuda = i.to("cuda", dtype).requires_grad_()
+            output = m(i.requires_grad_())
+            output_cuda = m_cuda(i_cuda)
+            self.assertEqual(output_cuda.cpu().float(), output, prec=dtype2prec[dtype])
+
+            grad_output = torch.randn_like(output).div_(2)
+            output.backward(grad_output)
+            output_cuda.backward(grad_output.to("cuda", dtype))
+            self.assertEqual(i_cuda.grad.cpu().float(), i.grad, prec=dtype2prec[dtype])
+            self.assertEqual(m_cuda.weight.grad.cpu().float(), m.weight.grad, prec=dtype2prec[dtype] * 10)
+            self.assertEqual(m_cuda.bias.grad.cpu().float(), m.bias.grad, prec=dtype2prec[dtype] * 10)
+
     def test_MaxUnpool2d_output_size(self):
         m = nn.MaxPool2d(3, stride=2, return_indices=True)
         mu = nn.MaxUnpool2d(3, stride=2)
@@ -4978,6 +5248,30 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_cpu_matches_reference(self):
+        # few labels, so that many targets repeat and may not skip the blank in between,
+        # and target lengths that give full and partial vectors in the recursions
+        for dtype in [torch.float, torch.double]:
+            for target_length in [1, 3, 8, 21]:
+                input_lengths = [50, 40, 50]
+                target_lengths = [target_length, max(target_length - 2, 1), target_length]
+                targets = torch.randint(1, 4, (sum(target_lengths),), dtype=torch.long)
+                # a non-contiguous log_probs
+                log_probs = torch.randn(5, 50, 3, dtype=dtype).log_softmax(0).permute(1, 2, 0)
+                log_probs.requires_grad_()
+                res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths, reduction='none')
+                expected = ctcloss_reference(log_probs, targets, input_lengths, target_lengths, reduction='none')
+                self.assertEqual(res, expected, prec=1e-4)
+                grad, = torch.autograd.grad(res.sum(), log_probs)
+                expected_grad, = torch.autograd.grad(expected.sum(), log_probs)
+                self.assertEqual(grad, expected_grad, prec=1e-4)
+
+        # with empty targets, the only path is all blanks
+        log_probs = torch.randn(10, 2, 5, dtype=torch.double).log_softmax(2)
+        targets = torch.zeros(0, dtype=torch.long)
+        res = torch.nn.functional.ctc_loss(log_probs, targets, [10, 7], [0, 0], reduction='none')
+        self.assertEqual(res, -torch.stack([log_probs[:10, 0, 0].sum(), log_probs[:7, 1, 0].sum()]))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_zero_infinity(self):
         target_lengths = [60, 25, 20]
@@ -5498,6 +5792,44 @@ class TestNN(NNTestCase):
                     else:
                         self.assertEqual(hx.grad.data, hx_cuda.grad.data)
 
+    def test_rnn_fused_cpu(self):
+        # Without a graph to record, the CPU cells take the fused kernels
+        input_size = 10
+        hidden_size = 6
+        num_layers = 2
+        seq_length = 7
+        batch = 5
+        input = torch.randn(seq_length, batch, input_size)
+        lengths = [7, 7, 5, 3, 1]
+        for module in (nn.GRU, nn.LSTM):
+            for bias, bidirectional in product((True, False), repeat=2):
+                rnn = module(input_size, hidden_size, num_layers, bias=bias,
+                             bidirectional=bidirectional)
+                num_directions = 2 if bidirectional else 1
+                hx = torch.randn(num_layers * num_directions, batch, hidden_size)
+                if module is nn.LSTM:
+                    hx = (hx, torch.randn_like(hx))
+                for inp in (input, rnn_utils.pack_padded_sequence(input, lengths)):
+                    output, hy = rnn(inp, hx)
+                    with torch.no_grad():
+                        output_fused, hy_fused = rnn(inp, hx)
+                    if isinstance(inp, rnn_utils.PackedSequence):
+                        output, output_fused = output.data, output_fused.data
+                    self.assertEqual(output, output_fused)
+                    self.assertEqual(hy, hy_fused)
+
+        gates = torch.randn(batch, 4 * hidden_size, dtype=torch.double, requires_grad=True)
+        hgates = torch.randn_like(gates, requires_grad=True)
+        bias = torch.randn(4 * hidden_size, dtype=torch.double, requires_grad=True)
+        cx = torch.randn(batch, hidden_size, dtype=torch.double, requires_grad=True)
+        self.assertTrue(gradcheck(
+            lambda *args: torch._thnn_fused_lstm_cell(*args)[:2], (gates, hgates, cx, bias, bias)))
+        gates = gates[:, :3 * hidden_size].detach().requires_grad_()
+        hgates = hgates[:, :3 * hidden_size].detach().requires_grad_()
+        bias = bias[:3 * hidden_size].detach().requires_grad_()
+        self.assertTrue(gradcheck(
+            lambda *args: torch._thnn_fused_gru_cell(*args)[0], (gates, hgates, cx, bias, bias)))
+
     def test_rnn_args_check(self):
         input_size = 3
         hidden_size = 5
@@ -6857,6 +7189,45 @@ class TestNN(NNTestCase):
 
                 test(N, C, D, H, W, mode, padding_mode)
 
+    def test_grid_sample_3d_flat_input_matches_2d(self):
+        # Sampling a depth 1 volume ignores the z locations, so it is the same
+        # as sampling the image.
+        for mode, padding_mode in product(('bilinear', 'nearest'), ('zeros', 'border', 'reflection')):
+            for grid_layout in ('contiguous', 'channels_first', 'strided_h', 'strided_w'):
+                input = torch.randn(3, 5, 7, 11, requires_grad=True)
+                if grid_layout == 'contiguous':
+                    grid = torch.randn(3, 1, 13, 17, 3) * 1.2
+                elif grid_layout == 'channels_first':
+                    grid = (torch.randn(3, 3, 1, 13, 17) * 1.2).permute(0, 2, 3, 4, 1)
+                elif grid_layout == 'strided_h':
+                    grid = (torch.randn(3, 1, 26, 17, 3) * 1.2)[:, :, ::2]
+                else:
+                    grid = (torch.randn(3, 1, 13, 34, 3) * 1.2)[:, :, :, ::2]
+                grid.requires_grad_()
+
+                out_2d = F.grid_sample(input, grid[:, 0, :, :, :2], mode=mode, padding_mode=padding_mode)
+                out_3d = F.grid_sample(input.unsqueeze(2), grid, mode=mode, padding_mode=padding_mode)
+                self.assertEqual(out_3d.squeeze(2), out_2d, prec=1e-5)
+
+                gradients = torch.randn_like(out_2d)
+                grad_input_2d, grad_grid_2d = torch.autograd.grad(out_2d, (input, grid), gradients)
+                grad_input_3d, grad_grid_3d = torch.autograd.grad(out_3d, (input, grid), gradients.unsqueeze(2))
+                self.assertEqual(grad_input_3d, grad_input_2d, prec=1e-5)
+                self.assertEqual(grad_grid_3d[..., :2], grad_grid_2d[..., :2], prec=1e-5)
+                self.assertEqual(grad_grid_3d[..., 2], torch.zeros_like(grad_grid_3d[..., 2]))
+
+    def test_grid_sample_channels_last(self):
+        for mode, padding_mode in product(('bilinear', 'nearest'), ('zeros', 'border', 'reflection')):
+            for C in (1, 3, 19):
+                input = torch.randn(2, C, 9, 10)
+                input_channels_last = input.contiguous(memory_format=torch.channels_last)
+                grid = torch.randn(2, 6, 7, 2) * 1.2
+                out = F.grid_sample(input, grid, mode=mode, padding_mode=padding_mode)
+                out_channels_last = F.grid_sample(input_channels_last, grid, mode=mode, padding_mode=padding_mode)
+                self.assertEqual(out_channels_last, out)
+                if C > 1:
+                    self.assertTrue(out_channels_last.is_contiguous(memory_format=torch.channels_last))
+
     def test_affine_grid(self):
         # test known input on CPU
         input = torch.arange(1., 7).view(1, 2, 3)
@@ -7214,6 +7585,34 @@ class TestNN(NNTestCase):
             out_t_5 = m(in_t_9[:, :, :5, :5])
         self.assertEqual(out_t_9[:, :, :15, :15], out_t_5)
 
+    def test_resize_crop_normalize(self):
+        device_list = ['cpu']
+        if TEST_CUDA:
+            device_list.append('cuda')
+
+        for device, align_corners, channels_last in product(device_list, [True, False], [True, False]):
+            for in_size, size, crop in [((17, 23), (31, 29), (3, 5, 24, 19)),
+                                        ((40, 36), (13, 11), (0, 0, 13, 11)),
+                                        ((9, 9), (9, 9), (2, 1, 5, 7))]:
+                input = torch.randint(0, 256, (2,) + in_size + (3,), dtype=torch.uint8, device=device)
+                mean = torch.tensor([123.7, 116.3, 103.5], device=device)
+                std = torch.tensor([58.4, 57.1, 57.4], device=device)
+                out = torch._resize_crop_normalize(input, size, crop, mean, std,
+                                                   align_corners=align_corners, channels_last=channels_last)
+
+                top, left, height, width = crop
+                expected = F.interpolate(input.permute(0, 3, 1, 2).float(), size,
+                                         mode='bilinear', align_corners=align_corners)
+                expected = expected[:, :, top:top + height, left:left + width]
+                expected = (expected - mean.view(1, -1, 1, 1)) / std.view(1, -1, 1, 1)
+                if channels_last:
+                    expected = expected.permute(0, 2, 3, 1)
+                self.assertEqual(out, expected, prec=1e-4)
+
+            input = torch.zeros(1, 8, 8, 3, dtype=torch.uint8, device=device)
+            with self.assertRaisesRegex(RuntimeError, "does not lie within"):
+                torch._resize_crop_normalize(input, (8, 8), (4, 4, 5, 4), mean, std)
+
     def test_upsamplingNearest3d(self):
         m = nn.Upsample(size=4, mode='nearest')
         in_t = torch.ones(1, 1, 2, 2, 2)
@@ -191,6 +191,72 @@ class TestQuantizedOps(unittest.TestCase):
                                 "Quantized addition with ReLU failed.")
 
 
+    """Tests add and add_relu on sizes that are not a multiple of the vector
+    size, against the dequantized float sum."""
+    def test_qadd_relu_large(self):
+        add_relu = torch.ops.quantized.add_relu
+        add = torch.ops.quantized.add
+
+        A = torch.randn(7, 37, dtype=torch.float) * 20
+        B = torch.randn(7, 37, dtype=torch.float) * 20
+        qA = A.quantize_linear(scale=0.3, zero_point=100, dtype=torch.quint8)
+        qB = B.quantize_linear(scale=0.7, zero_point=20, dtype=torch.quint8)
+        scale_C = 0.4
+        zero_point_C = 128
+
+        C = (qA.dequantize() + qB.dequantize()).numpy()
+        qC = _quantize(C, scale_C, zero_point_C)
+        qC_hat = add(qA, qB, scale=scale_C, zero_point=zero_point_C)
+        np.testing.assert_equal(qC, qC_hat.int_repr(),
+                                "Quantized addition failed.")
+
+        Crelu = C.copy()
+        Crelu[C < 0] = 0
+        qCrelu = _quantize(Crelu, scale_C, zero_point_C)
+        qCrelu_hat = add_relu(qA, qB, scale=scale_C, zero_point=zero_point_C)
+        np.testing.assert_equal(qCrelu, qCrelu_hat.int_repr(),
+                                "Quantized addition with ReLU failed.")
+
+
+class TestObservers(unittest.TestCase):
+    """Tests the _min_max_observer op, per tensor and per channel."""
+    def test_min_max_observer(self):
+        X = torch.randn(4, 3, 5)
+        empty = torch.tensor([])
+        X_min, X_max = torch._min_max_observer(X, empty, empty)
+        self.assertEqual(X_min.item(), X.min().item())
+        self.assertEqual(X_max.item(), X.max().item())
+
+        Y = torch.randn(4, 3, 5) * 2
+        Y_min, Y_max = torch._min_max_observer(Y, X_min, X_max)
+        self.assertEqual(Y_min.item(), min(X.min().item(), Y.min().item()))
+        self.assertEqual(Y_max.item(), max(X.max().item(), Y.max().item()))
+
+        c = 0.25
+        Y_min, Y_max = torch._min_max_observer(Y, X_min, X_max, averaging_constant=c)
+        np.testing.assert_allclose(Y_min.item(), X_min.item() + (Y.min().item() - X_min.item()) * c, rtol=1e-5)
+        np.testing.assert_allclose(Y_max.item(), X_max.item() + (Y.max().item() - X_max.item()) * c, rtol=1e-5)
+
+        X_min, X_max = torch._min_max_observer(X, empty, empty, axis=1)
+        X_channels = X.transpose(0, 1).reshape(3, -1)
+        np.testing.assert_equal(X_min.numpy(), X_channels.min(1)[0].numpy())
+        np.testing.assert_equal(X_max.numpy(), X_channels.max(1)[0].numpy())
+
+    """Tests the _histogram_observer op against numpy."""
+    def test_histogram_observer(self):
+        bins = 64
+        X = torch.randn(100000)
+        histogram = torch._histogram_observer(X, torch.zeros(bins), -2., 2.)
+        # Out of range values count in the edge bins
+        X_clamped = X.clamp(-2., 2.).numpy()
+        ref, _ = np.histogram(X_clamped, bins=bins, range=(-2., 2.))
+        self.assertEqual(histogram.sum().item(), X.numel())
+        np.testing.assert_allclose(histogram.numpy(), ref, atol=2)
+
+        histogram = torch._histogram_observer(X, histogram, -2., 2.)
+        np.testing.assert_allclose(histogram.numpy(), 2 * ref, atol=4)
+
+
 @unittest.skipIf(
     TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
     " Quantized FC requires FBGEMM. FBGEMM does not play"
@@ -356,6 +422,193 @@ class TestQuantizedFC(unittest.TestCase):
         # Assert equal
         np.testing.assert_equal(Y_q_ref2.int_repr().numpy(), Y_q.int_repr().numpy())
 
+    """Tests the quantized::fc op with per channel quantized weights."""
+    def test_qfc_per_channel(self):
+        qfc_prepack = torch.ops.quantized.fbgemm_linear_prepack
+        qfc = torch.ops.quantized.fbgemm_linear
+
+        batch_size = 4
+        input_channels = 16
+        output_channels = 8
+
+        X_scale = 1.5
+        X_zp = 5
+        # Small enough values that no pair of products overflows vpmaddubsw
+        X_q0 = np.random.randint(0, 64, (batch_size, input_channels)).astype(np.uint8)
+        W_scales = np.random.rand(output_channels) * 0.5 + 0.1
+        # W_zps are the zero points for int8 quantization.
+        W_zps = np.random.randint(-5, 5, output_channels)
+        W_q0 = np.random.randint(-64, 64, (output_channels, input_channels)).astype(np.int8)
+
+        X = torch.from_numpy(_dequantize(X_q0, X_scale, X_zp)).to(dtype=torch.float)
+        W = torch.from_numpy(
+            (W_q0.astype(np.float) - W_zps.reshape(-1, 1)) * W_scales.reshape(-1, 1)).to(dtype=torch.float)
+        X_q = X.quantize_linear(scale=X_scale, zero_point=X_zp, dtype=torch.quint8)
+        # W_zps + 128 are the zero points for uint8 quantization.
+        W_q = W.quantize_linear_per_channel(
+            torch.from_numpy(W_scales), torch.from_numpy(W_zps + 128), [0], torch.quint8)
+        b_q = torch.randint(-10, 10, (output_channels,), dtype=torch.int32)
+
+        Y_scale = 12.5
+        Y_zp = 5
+
+        W_prepack = qfc_prepack(W_q)
+        Y_q = qfc(X_q, W_prepack, b_q, Y_scale, Y_zp)
+
+        # Reference from the float linear, with the bias of each channel in
+        # its own scale
+        X_fp32 = X_q.dequantize()
+        W_fp32 = W_q.dequantize()
+        b_fp32 = b_q.to(dtype=torch.float) * X_scale * torch.from_numpy(W_scales).float()
+        Y_q_ref = _quantize(F.linear(X_fp32, W_fp32, b_fp32).numpy(), Y_scale, Y_zp)
+
+        # the float reference can round the other way
+        np.testing.assert_array_less(
+            np.abs(Y_q_ref.astype(np.int32) - Y_q.int_repr().numpy().astype(np.int32)), 2)
+
+
+    """Tests the quantized::linear_dynamic and linear_relu_dynamic ops."""
+    def test_qlinear_dynamic(self):
+        qfc_prepack = torch.ops.quantized.fbgemm_linear_prepack
+
+        batch_size = 10
+        input_channels = 16
+        output_channels = 8
+
+        W_scale = 0.01
+        W_zp = 0
+        W_q0 = np.random.randint(-64, 64, (output_channels, input_channels)).astype(np.int8)
+        W = torch.from_numpy(_dequantize(W_q0, W_scale, W_zp)).to(dtype=torch.float)
+        # W_zp + 128 is the zero point for uint8 quantization.
+        W_q = W.quantize_linear(scale=W_scale, zero_point=W_zp + 128, dtype=torch.quint8)
+        W_prepack = qfc_prepack(W_q)
+
+        X = torch.randn(2, batch_size, input_channels)
+        b = torch.randn(output_channels)
+        # The input is quantized to 8 bits with its own range, so each of its
+        # elements is off by at most half a step.
+        X_step = (max(X.max().item(), 0) - min(X.min().item(), 0)) / 255
+        atol = X_step * W.abs().sum(1).max().item()
+
+        Y_ref = F.linear(X, W_q.dequantize(), b)
+        Y = torch.ops.quantized.linear_dynamic(X, W_prepack, b)
+        self.assertEqual(Y.shape, Y_ref.shape)
+        np.testing.assert_allclose(Y.numpy(), Y_ref.numpy(), atol=atol)
+
+        Y_relu = torch.ops.quantized.linear_relu_dynamic(X, W_prepack, b)
+        np.testing.assert_allclose(Y_relu.numpy(), F.relu(Y_ref).numpy(), atol=atol)
+
+
+
+@unittest.skipIf(
+    TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
+    " Quantized convolution requires FBGEMM. FBGEMM does not play"
+    " well with UBSAN at the moment, so we skip the test if"
+    " we are in a UBSAN environment.",
+)
+class TestQuantizedConv(unittest.TestCase):
+    """Tests the correctness of the quantized::conv2d and conv2d_relu ops."""
+
+    def _test_qconv(self, groups, relu):
+        qconv_prepack = torch.ops.quantized.conv_prepack
+        qconv = torch.ops.quantized.conv2d_relu if relu else torch.ops.quantized.conv2d
+
+        batch_size = 2
+        channels_per_group = 1 if groups > 1 else 4
+        input_channels = channels_per_group * groups
+        output_channels = 8 if groups == 1 else groups
+        stride = [1, 1]
+        padding = [1, 1]
+
+        # Small enough values that no pair of products overflows vpmaddubsw
+        X_scale = 0.5
+        X_zp = 3
+        X_q0 = np.random.randint(0, 64, (batch_size, 7, 6, input_channels)).astype(np.uint8)
+        W_scale = 0.25
+        # W_zp is the zero point for int8 quantization.
+        W_zp = -2
+        W_q0 = np.random.randint(-64, 64, (output_channels, 3, 3, channels_per_group)).astype(np.int8)
+
+        X = torch.from_numpy(_dequantize(X_q0, X_scale, X_zp)).to(dtype=torch.float)
+        W = torch.from_numpy(_dequantize(W_q0, W_scale, W_zp)).to(dtype=torch.float)
+        X_q = X.quantize_linear(scale=X_scale, zero_point=X_zp, dtype=torch.quint8)
+        # W_zp + 128 is the zero point for uint8 quantization.
+        W_q = W.quantize_linear(scale=W_scale, zero_point=W_zp + 128, dtype=torch.quint8)
+        b_q = torch.randint(-10, 10, (output_channels,), dtype=torch.int32)
+
+        Y_scale = 4.0
+        Y_zp = 100
+
+        W_prepack = qconv_prepack(W_q, stride, padding, groups)
+        Y_q = qconv(X_q, W_prepack, b_q, Y_scale, Y_zp)
+
+        # Reference from the float NCHW convolution
+        X_fp32 = X_q.dequantize().permute(0, 3, 1, 2)
+        W_fp32 = W_q.dequantize().permute(0, 3, 1, 2)
+        b_fp32 = b_q.to(dtype=torch.float) * (X_scale * W_scale)
+        Y_fp32 = F.conv2d(X_fp32, W_fp32, b_fp32, stride, padding, groups=groups)
+        if relu:
+            Y_fp32 = F.relu(Y_fp32)
+        Y_q_ref = _quantize(Y_fp32.permute(0, 2, 3, 1).numpy(), Y_scale, Y_zp)
+
+        self.assertEqual(Y_q.int_repr().shape, torch.Size([batch_size, 7, 6, output_channels]))
+        # the float reference can round the other way
+        np.testing.assert_array_less(
+            np.abs(Y_q_ref.astype(np.int32) - Y_q.int_repr().numpy().astype(np.int32)), 2)
+
+    def test_qconv(self):
+        self._test_qconv(groups=1, relu=False)
+
+    def test_qconv_relu(self):
+        self._test_qconv(groups=1, relu=True)
+
+    def test_qconv_depthwise(self):
+        self._test_qconv(groups=8, relu=False)
+
+
+class TestQuantizedEmbeddingBag(unittest.TestCase):
+    """Tests the rowwise quantized quantized::embedding_bag ops against
+    F.embedding_bag on the dequantized tables."""
+    def _test_embedding_bag(self, bits, prepack, unpack, embedding_bag):
+        num_embeddings, embedding_dim = 100, 18
+        weight = torch.randn(num_embeddings, embedding_dim)
+        packed = prepack(weight)
+        self.assertEqual(packed.dtype, torch.uint8)
+        dequantized = unpack(packed)
+        # Each value is off by at most half a step of its row
+        step = (weight.max(1)[0] - weight.min(1)[0]) / (2 ** bits - 1)
+        self.assertTrue(((dequantized - weight).abs() <= step.unsqueeze(1) / 2 + 1e-2).all())
+
+        indices = torch.randint(0, num_embeddings, (50,), dtype=torch.long)
+        offsets = torch.tensor([0, 0, 3, 10, 10, 31], dtype=torch.long)
+        per_sample_weights = torch.randn(50)
+        for mode_name, mode in (('sum', 0), ('mean', 1)):
+            np.testing.assert_allclose(
+                embedding_bag(packed, indices, offsets, mode),
+                F.embedding_bag(indices, dequantized, offsets, mode=mode_name),
+                rtol=1e-4, atol=1e-4)
+        np.testing.assert_allclose(
+            embedding_bag(packed, indices, offsets, 0, per_sample_weights),
+            F.embedding_bag(indices, dequantized, offsets, mode='sum',
+                            per_sample_weights=per_sample_weights),
+            rtol=1e-4, atol=1e-4)
+        with self.assertRaises(RuntimeError):
+            embedding_bag(packed, indices, offsets, 2)
+
+    def test_embedding_bag_byte(self):
+        self._test_embedding_bag(
+            8, torch.ops.quantized.embedding_bag_byte_prepack,
+            torch.ops.quantized.embedding_bag_byte_unpack,
+            torch.ops.quantized.embedding_bag_byte)
+
+    def test_embedding_bag_4bit(self):
+        self._test_embedding_bag(
+            4, torch.ops.quantized.embedding_bag_4bit_prepack,
+            torch.ops.quantized.embedding_bag_4bit_unpack,
+            torch.ops.quantized.embedding_bag_4bit)
+        packed = torch.ops.quantized.embedding_bag_4bit_prepack(torch.randn(7, 10))
+        self.assertEqual(packed.size(), (7, 10 // 2 + 4))
+
 
 if __name__ == "__main__":
     run_tests()
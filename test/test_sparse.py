@@ -1447,6 +1447,27 @@ class TestSparse(TestCase):
 
         self.assertFalse(z._indices().numel() != 2 and z.is_coalesced())
 
+    def test_coalesce_many_duplicates(self):
+        # large enough to split the sort and the reduction across threads
+        for shape in [(50,), (30, 4000), (2 ** 20, 2 ** 21, 3)]:
+            for dense_size in [(), (3,), (0,)]:
+                nnz = 100000
+                i = torch.stack([torch.randint(n, (nnz,), device=self.device) for n in shape])
+                v = torch.randn((nnz,) + dense_size, dtype=self.value_dtype, device=self.device)
+                x = self.sparse_tensor(i, v, torch.Size(shape + dense_size))
+                y = x.coalesce()
+                self.assertTrue(y.is_coalesced())
+                self.assertEqual(y._indices().size(1), y._values().size(0))
+                flat = y._indices()[0]
+                for d in range(1, len(shape)):
+                    flat = flat * shape[d] + y._indices()[d]
+                # indices come out sorted and unique
+                self.assertTrue((flat[1:] > flat[:-1]).all())
+                if len(shape) < 3:
+                    self.assertEqual(y.to_dense(), x.to_dense())
+                else:
+                    self.assertEqual(torch.sparse.sum(y), torch.sparse.sum(x))
+
     @cuda_only
     def test_storage_not_null(self):
         x = torch.cuda.sparse.FloatTensor(2)
@@ -820,6 +820,22 @@ class _TestTorchMixin(object):
         checkType(torch.FloatTensor)
         checkType(torch.DoubleTensor)
 
+    def test_fast_transcendentals(self):
+        self.assertFalse(torch._C._get_fast_transcendentals())
+        x = torch.rand(10000) * 2 - 1
+        try:
+            for fn in ['exp', 'erf', 'log', 'sigmoid', 'sin', 'cos', 'tan', 'tanh']:
+                for dtype in [torch.float, torch.double]:
+                    inp = x.abs() + 0.1 if fn == 'log' else x
+                    inp = inp.to(dtype)
+                    expected = getattr(inp, fn)()
+                    torch._C._set_fast_transcendentals(True)
+                    self.assertEqual(getattr(inp, fn)(), expected, 1e-5)
+                    torch._C._set_fast_transcendentals(False)
+                    self.assertEqual(getattr(inp, fn)(), expected, 0)
+        finally:
+            torch._C._set_fast_transcendentals(False)
+
     def test_frac(self):
         self._test_math(torch.frac, lambda x: math.fmod(x, 1))
 
@@ -1306,6 +1322,27 @@ class _TestTorchMixin(object):
             self.assertTrue(y.is_contiguous())
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_batched(self):
+        for device in torch.testing.get_all_device_types():
+            for r1, r2 in [(5, 7), (40, 30)]:
+                for p in [0, 1, 2, 3, 1.5, 2.5, float('inf')]:
+                    x = torch.randn(2, 3, r1, 4, device=device)
+                    y = torch.randn(2, 3, r2, 4, device=device)
+                    actual = torch.cdist(x, y, p=p)
+                    expected = brute_cdist(x, y, p=p)
+                    self.assertEqual(actual.shape, (2, 3, r1, r2))
+                    self.assertTrue(torch.allclose(expected, actual, atol=1e-5))
+
+                    # batch dimensions broadcast
+                    y = torch.randn(3, r2, 4, device=device)
+                    actual = torch.cdist(x, y, p=p)
+                    expected = brute_cdist(x, y.expand(2, 3, r2, 4), p=p)
+                    self.assertTrue(torch.allclose(expected, actual, atol=1e-5))
+
+            x = torch.randn(2, 0, 4, device=device)
+            y = torch.randn(1, 3, 4, device=device)
+            self.assertEqual(torch.empty(2, 0, 3, device=device), torch.cdist(x, y))
+
     @unittest.skipIf(not TEST_SCIPY, "Scipy not found")
     def test_logsumexp(self):
         from scipy.special import logsumexp
@@ -1854,6 +1891,17 @@ class _TestTorchMixin(object):
         for i in range(num_batches):
             r = torch.mm(b1[i], b2[i])
             self.assertEqual(r, res[i])
+        # small matrices, which use the kernel parallelized over the batch,
+        # with transposed and non-contiguous operands
+        for M, N, O in [(5, 4, 3), (64, 64, 64)]:
+            b1 = torch.randn(num_batches, N, M).transpose(1, 2)
+            b2 = torch.randn(num_batches, O, N * 2)[:, :, ::2].transpose(1, 2)
+            res = torch.bmm(b1, b2)
+            for i in range(num_batches):
+                self.assertEqual(torch.mm(b1[i], b2[i]), res[i])
+        b1 = torch.randint(0, 10, (num_batches, 4, 5), dtype=torch.long)
+        b2 = torch.randint(0, 10, (num_batches, 5, 3), dtype=torch.long)
+        self.assertEqual(torch.bmm(b1, b2), torch.bmm(b1.double(), b2.double()).long())
         if torch.cuda.is_available():
             # check that mixed arguments are rejected
             self.assertRaises(RuntimeError, lambda: torch.bmm(b1, b2.cuda()))
@@ -2477,6 +2525,31 @@ class _TestTorchMixin(object):
                 self.assertEqual(var1, var2)
                 self.assertEqual(mean1, mean2)
 
+    def test_min_max_values(self):
+        def reference(x, dims, keepdim):
+            mn, mx = x, x
+            for d in sorted(dims, reverse=True):
+                mn = mn.min(d, keepdim=True)[0]
+                mx = mx.max(d, keepdim=True)[0]
+            if not keepdim:
+                for d in sorted(dims, reverse=True):
+                    mn, mx = mn.squeeze(d), mx.squeeze(d)
+            return mn, mx
+
+        for device in torch.testing.get_all_device_types():
+            for dtype in [torch.float, torch.double, torch.long]:
+                x = torch.randn(100, 300, 50, device=device).mul(100).to(dtype)
+                for t in [x, x.transpose(0, 2)]:
+                    for dims in [(0,), (1,), (2,), (0, 1), (1, 2), (0, 2)]:
+                        for keepdim in [False, True]:
+                            mn1, mx1 = torch._min_max_values(t, dims, keepdim)
+                            mn2, mx2 = reference(t, dims, keepdim)
+                            self.assertEqual(mn1, mn2)
+                            self.assertEqual(mx1, mx2)
+                    mn, mx = torch._min_max_values(t)
+                    self.assertEqual(mn, t.min())
+                    self.assertEqual(mx, t.max())
+
     def test_zeros_like(self):
         expected = torch.zeros(100, 100)
 
@@ -2596,6 +2669,24 @@ class _TestTorchMixin(object):
             expanded = torch.randn(1, 5, 1, 2, device=device).expand(3, 5, 7, 2)
             test_against_np(expanded)
 
+            # large inputs are counted into per-thread histograms
+            large = torch.randn(1000003, dtype=torch.double)
+            large[7] = nan
+            test_against_np(large, bins=37, min=-2, max=2)
+            test_against_np(large.float()[1:], bins=1000, min=-1, max=1)
+
+    def test_bincount_large(self):
+        input = torch.randint(0, 11, (1000001,))
+        weights = torch.randn(1000001, dtype=torch.double)
+        expected = torch.zeros(20, dtype=torch.long)
+        expected.index_add_(0, input, torch.ones_like(input))
+        self.assertEqual(torch.bincount(input, minlength=20), expected)
+        expected = torch.zeros(11, dtype=torch.double).index_add_(0, input, weights)
+        self.assertEqual(torch.bincount(input, weights), expected)
+        # more bins than elements per thread
+        input = torch.randint(0, 1000000, (100000,))
+        self.assertEqual(torch.bincount(input).sum(), 100000)
+
     def test_ones(self):
         res1 = torch.ones(100, 100)
         res2 = torch.Tensor()
@@ -2781,6 +2872,70 @@ class _TestTorchMixin(object):
         rqr = qr.dequantize()
         self.assertTrue(np.allclose(r.numpy(), rqr.numpy(), atol=2 / scale))
 
+    def test_qtensor_quant_dequant_large(self):
+        # large enough to be split across threads
+        r = torch.randn(100003) * 50
+        scale = 0.5
+        for dtype, zero_point, qmin, qmax in [(torch.quint8, 128, 0, 255),
+                                              (torch.qint8, 3, -128, 127),
+                                              (torch.qint32, 10, -2 ** 31, 2 ** 31 - 1)]:
+            qr = r.quantize_linear(scale, zero_point, dtype)
+            expected = torch.clamp(torch.round(r / scale + zero_point), qmin, qmax)
+            self.assertEqual(qr.int_repr().double(), expected.double())
+            self.assertEqual(qr.dequantize(), (expected - zero_point) * scale)
+
+    def test_qtensor_per_channel_affine(self):
+        r = torch.randn(3, 4, 5) * 10
+        scales = torch.tensor([0.2, 0.5, 1.0, 0.1], dtype=torch.double)
+        zero_points = torch.tensor([5, 10, 0, 128], dtype=torch.long)
+        qr = r.quantize_linear_per_channel(scales, zero_points, [1], torch.quint8)
+        self.assertEqual(qr.q_per_channel_scales(), scales)
+        self.assertEqual(qr.q_per_channel_zero_points(), zero_points)
+        s = scales.float().view(1, 4, 1)
+        z = zero_points.float().view(1, 4, 1)
+        expected = torch.clamp(torch.round(r / s + z), 0, 255)
+        self.assertEqual(qr.int_repr().double(), expected.double())
+        self.assertEqual(qr.dequantize(), (expected - z) * s)
+        with self.assertRaisesRegex(RuntimeError, "per tensor affine"):
+            qr.q_scale()
+        with self.assertRaisesRegex(RuntimeError, "size of the axis"):
+            r.quantize_linear_per_channel(scales, zero_points, [0], torch.quint8)
+
+    def test_qtensor_shape_ops(self):
+        F = torch.nn.functional
+        r = torch.randn(2, 3, 4, 5) * 10
+        scale = 0.5
+        zero_point = 128
+        qr = r.quantize_linear(scale, zero_point, torch.quint8)
+        rqr = qr.dequantize()
+
+        def check(q, expected):
+            self.assertTrue(q.is_quantized)
+            self.assertEqual(q.q_scale(), scale)
+            self.assertEqual(q.q_zero_point(), zero_point)
+            self.assertEqual(q.dequantize(), expected)
+
+        check(qr.view(6, 20), rqr.view(6, 20))
+        check(qr.permute(0, 2, 3, 1), rqr.permute(0, 2, 3, 1))
+        check(qr.permute(0, 2, 3, 1).reshape(-1), rqr.permute(0, 2, 3, 1).reshape(-1))
+        check(qr.flatten(1), rqr.flatten(1))
+        check(qr.transpose(1, 2).contiguous(), rqr.transpose(1, 2))
+        check(qr.clone(), rqr)
+        check(F.max_pool2d(qr, 2), F.max_pool2d(rqr, 2))
+        check(F.max_pool2d(qr, 3, 1, 1), F.max_pool2d(rqr, 3, 1, 1))
+        check(F.max_pool2d(qr.contiguous(memory_format=torch.channels_last), 2),
+              F.max_pool2d(rqr, 2))
+        check(F.interpolate(qr, scale_factor=2, mode='nearest'),
+              F.interpolate(rqr, scale_factor=2, mode='nearest'))
+        check(F.interpolate(qr.contiguous(memory_format=torch.channels_last), size=(7, 3), mode='nearest'),
+              F.interpolate(rqr, size=(7, 3), mode='nearest'))
+
+        # cat requantizes the tensors with other qparams than the first one
+        qs = r.quantize_linear(scale * 2, zero_point - 10, torch.quint8)
+        expected = torch.cat([rqr, qs.dequantize().quantize_linear(scale, zero_point, torch.quint8).dequantize()], 1)
+        check(torch.cat([qr, qr], 1), torch.cat([rqr, rqr], 1))
+        check(torch.cat([qr, qs], 1), expected)
+
     def test_qtensor_creation(self):
         scale = 0.5
         zero_point = 10
@@ -3656,6 +3811,38 @@ class _TestTorchMixin(object):
     def test_multinomial_alias(self):
         self._test_multinomial_alias(self, lambda t: t)
 
+    def test_multinomial_alias_and_parallel_distribution(self):
+        probs = torch.tensor([0.5, 0., 0.1, 0.25, 0.15], dtype=torch.double)
+        n_samples = 200000
+
+        def check_frequencies(samples):
+            self.assertEqual(samples.dtype, torch.long)
+            freqs = torch.bincount(samples.view(-1), minlength=5).double() / samples.numel()
+            self.assertEqual(freqs[1], 0)
+            self.assertEqual(freqs, probs, prec=1e-2)
+
+        sampler = torch.functional.AliasMultinomial(probs * 3)
+        self.assertEqual(sampler.num_categories, 5)
+        check_frequencies(sampler.draw(n_samples))
+
+        # large calls with replacement are drawn in parallel
+        check_frequencies(torch.multinomial(probs, n_samples, True))
+        check_frequencies(torch.multinomial(probs.expand(4, 5).float(), n_samples // 4, True))
+
+        num_threads = torch.get_num_threads()
+        try:
+            results = []
+            for threads in [1, num_threads]:
+                torch.set_num_threads(threads)
+                torch.manual_seed(123)
+                results.append((sampler.draw(n_samples), torch.multinomial(probs, n_samples, True)))
+        finally:
+            torch.set_num_threads(num_threads)
+        self.assertEqual(results[0], results[1])
+
+        with self.assertRaisesRegex(RuntimeError, "invalid multinomial distribution"):
+            torch.multinomial(torch.tensor([1., -1.]).expand(2, 2), n_samples, True)
+
     def _spawn_method(self, method, arg):
         try:
             mp.set_start_method('spawn')
@@ -4228,6 +4415,22 @@ class _TestTorchMixin(object):
         torch.zeros(5, 6).copy_(torch.zeros(6))
         self.assertRaises(RuntimeError, lambda: torch.zeros(5, 6).copy_(torch.zeros(30)))
 
+    def test_copy_transpose(self):
+        N, C, H, W = 2, 19, 13, 17
+        n = torch.arange(N).view(N, 1, 1, 1)
+        c = torch.arange(C).view(1, 1, 1, C)
+        h = torch.arange(H).view(1, H, 1, 1)
+        w = torch.arange(W).view(1, 1, W, 1)
+        # the elements of an NCHW arange, in NHWC order
+        nhwc = ((n * C + c) * H + h) * W + w
+        for dtype in [torch.uint8, torch.int16, torch.float, torch.double]:
+            x = torch.arange(N * C * H * W).view(N, C, H, W).to(dtype)
+            self.assertEqual(x.permute(0, 2, 3, 1).contiguous(), nhwc.to(dtype), 0)
+            self.assertEqual(nhwc.to(dtype).permute(0, 3, 1, 2).contiguous(), x, 0)
+            y = x.view(N * C, H * W)
+            self.assertEqual(y.t().contiguous(), y.t(), 0)
+            self.assertEqual(torch.empty(H * W, N * C, dtype=dtype).t().copy_(y), y, 0)
+
     def test_randperm(self):
         _RNGState = torch.get_rng_state()
         res1 = torch.randperm(100)
@@ -4371,6 +4574,47 @@ class _TestTorchMixin(object):
         self.assertIsOrdered('descending', x, res2val, res2ind,
                              'random with NaNs')
 
+    def test_sort_large(self):
+        # Long rows are radix sorted, and a few long rows are sorted in chunks
+        # by all threads (on CUDA, all the rows are radix sorted together).
+        # Either way, sorting is stable.
+        def expected_indices(row, descending):
+            def key(i):
+                x = row[i]
+                if descending:
+                    return (x == x, -x if x == x else 0, i)
+                return (x != x, x if x == x else 0, i)
+            return sorted(range(len(row)), key=key)
+
+        for device, dtype, shape in product(torch.testing.get_all_device_types(),
+                                            (torch.uint8, torch.short, torch.int, torch.long, torch.float, torch.double),
+                                            ((3, 5000), (1 << 17,))):
+            if len(shape) == 1 and dtype not in (torch.long, torch.float):
+                continue
+            if dtype.is_floating_point:
+                x = torch.randn(shape, dtype=dtype).mul_(10).round_()
+                x.view(-1)[::7] = float('nan')
+                x.view(-1)[1::11] = -0.
+            else:
+                x = torch.randint(0, 100, shape, dtype=dtype)
+            x = x.to(device)
+            for descending in (False, True):
+                values, indices = x.sort(descending=descending)
+                self.assertEqual(values, x.gather(-1, indices))
+                for row, row_indices in zip(x.view(-1, x.size(-1)), indices.view(-1, x.size(-1))):
+                    self.assertEqual(row_indices.tolist(), expected_indices(row.tolist(), descending))
+
+    def test_topk_large(self):
+        for largest, is_sorted in product((True, False), repeat=2):
+            for x in (torch.randn(3, 5000), torch.randn(1 << 17), torch.randint(0, 10, (1 << 17,), dtype=torch.long)):
+                for k in (1, 10, 1000):
+                    values, indices = x.topk(k, largest=largest, sorted=is_sorted)
+                    self.assertEqual(values, x.gather(-1, indices), 0)
+                    expected = x.sort(descending=largest)[0].narrow(-1, 0, k)
+                    if not is_sorted:
+                        values = values.sort(descending=largest)[0]
+                    self.assertEqual(values, expected, 0)
+
     @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
     def test_tensordot(self):
         for d in torch.testing.get_all_device_types():
@@ -4692,6 +4936,34 @@ class _TestTorchMixin(object):
             self.assertRaises(RuntimeError, lambda: torch.cat([]))
             self.assertRaisesRegex(TypeError, 'got None', lambda: torch.cat([x, None]))
 
+    def test_cat_many_inputs(self):
+        # thousands of small features into a wide batch, some of them strided
+        features = [torch.randn(64, torch.randint(1, 5, ()).item()) for _ in range(2000)]
+        features[::7] = [torch.randn(f.size(1), 64).t() for f in features[::7]]
+        res = torch.cat(features, 1)
+        offset = 0
+        for f in features:
+            self.assertEqual(res.narrow(1, offset, f.size(1)), f, 0)
+            offset += f.size(1)
+        self.assertEqual(res.size(), (64, offset))
+        self.assertEqual(torch.cat([f.t() for f in features], 0), res.t(), 0)
+
+        # the same out= buffer is reused across calls
+        out = torch.empty(0)
+        torch.cat(features, 1, out=out)
+        data_ptr = out.data_ptr()
+        torch.cat(features[::-1], 1, out=out)
+        self.assertEqual(out.data_ptr(), data_ptr)
+        self.assertEqual(out.narrow(1, 0, features[-1].size(1)), features[-1], 0)
+
+        # a strided out= buffer
+        out = torch.empty(offset, 64).t()
+        torch.cat(features, 1, out=out)
+        self.assertEqual(out, res, 0)
+
+        # legacy size [0] tensors are skipped
+        self.assertEqual(torch.cat([torch.empty(0)] + features + [torch.empty(0)], 1), res, 0)
+
     def test_cat_bad_input_sizes(self):
         x = torch.randn(2, 1)
         y = torch.randn(2, 1, 1)
@@ -5088,6 +5360,38 @@ class _TestTorchMixin(object):
     def test_solve_batched_dims(self):
         self._test_solve_batched_dims(self, lambda t: t)
 
+    @skipIfNoLapack
+    def test_linalg_batched_small_matrices(self):
+        from common_utils import random_fullrank_matrix_distinct_singular_value as fullrank
+        from common_utils import random_symmetric_pd_matrix
+        # sizes up to 8 use the direct kernels, larger ones go through LAPACK
+        for n in range(1, 11):
+            A = fullrank(n, 100).double()
+            b = torch.randn(100, n, 3, dtype=torch.double)
+            x, _ = torch.solve(b, A)
+            self.assertEqual(torch.matmul(A, x), b)
+
+            A_inv = torch.inverse(A)
+            self.assertEqual(torch.matmul(A, A_inv), torch.eye(n, dtype=torch.double).expand_as(A))
+
+            A_LU, pivots = torch.lu(A)
+            P, L, U = torch.lu_unpack(A_LU, pivots)
+            self.assertEqual(torch.matmul(P, torch.matmul(L, U)), A)
+
+            S = random_symmetric_pd_matrix(n, 100).double()
+            L = torch.cholesky(S)
+            self.assertEqual(torch.matmul(L, L.transpose(-2, -1)), S)
+            U = torch.cholesky(S, upper=True)
+            self.assertEqual(torch.matmul(U.transpose(-2, -1), U), S)
+
+            # errors are reported for the first failing matrix
+            A[37].zero_()
+            A[52].zero_()
+            with self.assertRaisesRegex(RuntimeError, 'For batch 37: U\\(1,1\\) is zero'):
+                torch.inverse(A)
+            _, _, infos = torch._lu_with_info(A, check_errors=False)
+            self.assertEqual(infos.nonzero().view(-1).tolist(), [37, 52])
+
     def test_solve_methods_arg_device(self):
         if not torch.cuda.is_available():
             return
@@ -6159,6 +6463,43 @@ class _TestTorchMixin(object):
     def test_fft_ifft_rfft_irfft(self):
         self._test_fft_ifft_rfft_irfft(self)
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_fft_plan_cache_mkl(self):
+        plan_cache = torch.backends.mkl.fft_plan_cache
+        original = plan_cache.max_size
+        try:
+            plan_cache.clear()
+            x = torch.randn(4, 64, 2, dtype=torch.double)
+            hits, misses = plan_cache.hits, plan_cache.misses
+            expected = x.fft(1)
+            self.assertGreater(plan_cache.misses, misses)
+            self.assertGreater(plan_cache.size, 0)
+            misses = plan_cache.misses
+            self.assertEqual(x.fft(1), expected, 0)
+            self.assertEqual(plan_cache.misses, misses)
+            self.assertGreater(plan_cache.hits, hits)
+
+            # batches split over threads give the same result
+            x = torch.randn(37, 3, 10, dtype=torch.double)
+            nthreads = torch.get_num_threads()
+            try:
+                torch.set_num_threads(1)
+                single = x.rfft(2, onesided=False)
+            finally:
+                torch.set_num_threads(nthreads)
+            self.assertEqual(x.rfft(2, onesided=False), single)
+
+            plan_cache.max_size = 0
+            self.assertEqual(plan_cache.size, 0)
+            self.assertEqual(x.rfft(2, onesided=False), single)
+            self.assertEqual(plan_cache.size, 0)
+            with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+                plan_cache.max_size = -1
+            with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+                plan_cache.size = 1
+        finally:
+            plan_cache.max_size = original
+
     @staticmethod
     def _test_stft(self, device='cpu'):
         if not TEST_LIBROSA:
@@ -6220,6 +6561,45 @@ class _TestTorchMixin(object):
     def test_stft(self):
         self._test_stft(self)
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_stft_stream_and_istft(self):
+        def chunks(x, sizes, dim=-1):
+            begin = 0
+            for size in sizes:
+                yield x.narrow(dim, begin, size)
+                begin += size
+            yield x.narrow(dim, begin, x.size(dim) - begin)
+
+        for center, shape, hop, win_length in [(False, (300,), 40, None), (True, (300,), 40, 100),
+                                               (True, (3, 257), 64, None), (False, (2, 250), 128, 128)]:
+            x = torch.randn(*shape, dtype=torch.double)
+            window = torch.hann_window(win_length or 128, dtype=torch.double)
+            kwargs = dict(hop_length=hop, win_length=win_length, window=window, center=center)
+            expected = torch.stft(x, 128, **kwargs)
+
+            # streamed frames match the STFT of the whole signal
+            stream = torch.functional.STFTStream(128, **kwargs)
+            frames = [stream.push(chunk) for chunk in chunks(x, [1, 70, 3, 100])]
+            frames.append(stream.flush())
+            self.assertEqual(torch.cat(frames, -2), expected)
+
+            # and so are the samples recovered from them
+            signal = torch.istft(expected, 128, length=x.size(-1), **kwargs)
+            stream = torch.functional.ISTFTStream(128, **kwargs)
+            samples = [stream.push(chunk) for chunk in chunks(expected, [2, 0, 1], dim=-2)]
+            samples.append(stream.flush())
+            streamed = torch.cat(samples, -1)
+            self.assertEqual(streamed, signal[..., :streamed.size(-1)])
+            # all samples covered by a window are recovered
+            if center:
+                self.assertEqual(signal, x)
+            else:
+                covered = 128 + hop * (expected.size(-2) - 1)
+                self.assertEqual(signal[..., 1:covered - 1], x[..., 1:covered - 1])
+
+        with self.assertRaisesRegex(ValueError, "hop_length"):
+            torch.functional.ISTFTStream(128, hop_length=0)
+
     @unittest.skip("Not implemented yet")
     def test_conv2(self):
         x = torch.rand(math.floor(torch.uniform(50, 100)), math.floor(torch.uniform(50, 100)))
@@ -7671,6 +8051,34 @@ class _TestTorchMixin(object):
     def test_scatterFill(self):
         self._test_scatter_base(self, lambda t: t, 'scatter_', True)
 
+    def test_scatter_gather_large(self):
+        # large enough for the CPU kernels to split the rows between threads
+        m, n = 300, 200
+        for src in [torch.randn(m, n, dtype=torch.double), torch.randn(n, m, dtype=torch.double).t()]:
+            rows = torch.arange(m).unsqueeze(1)
+            idx = torch.randint(n, (m, 2 * n))
+            self.assertEqual(src.gather(1, idx), src[rows, idx], 0)
+            idx0 = torch.randint(m, (2 * m, n))
+            self.assertEqual(src.gather(0, idx0), src[idx0, torch.arange(n)], 0)
+
+            # values that add up exactly in any order
+            values = torch.randint(-8, 8, (m, 2 * n), dtype=torch.double)
+            expected = src.clone().index_put_((rows.expand(m, 2 * n), idx), values, accumulate=True)
+            self.assertEqual(src.clone().scatter_add_(1, idx, values), expected, 0)
+
+            # an index smaller than self and src only writes its own rows
+            perm = torch.stack([torch.randperm(n)[:n // 2] for _ in range(m // 2)])
+            actual = src.clone().scatter_(1, perm, values)
+            expected = src.clone()
+            expected[rows[:m // 2], perm] = values[:m // 2, :n // 2]
+            self.assertEqual(actual, expected, 0)
+            expected[rows[:m // 2], perm] = 2.5
+            self.assertEqual(src.clone().scatter_(1, perm, 2.5), expected, 0)
+
+            for dim in range(2):
+                idx = torch.randint(src.size(dim), (5 * m,))
+                self.assertEqual(src.index_select(dim, idx), src[idx] if dim == 0 else src[:, idx], 0)
+
     def test_masked_scatter(self):
         for dtype in [torch.uint8, torch.bool]:
             num_copy, num_dest = 3, 10
@@ -9197,6 +9605,38 @@ class _TestTorchMixin(object):
         self.assertEqual(r[:, :50].std(), 4, 0.3)
         self.assertEqual(r[:, 50:].std(), 1, 0.2)
 
+    def test_parallel_random_fills(self):
+        # tensors of 100003 elements are large enough to be filled in parallel
+        fills = [lambda t: t.uniform_(-2, 3), lambda t: t.normal_(2, 3),
+                 lambda t: t.bernoulli_(0.3)]
+
+        num_threads = torch.get_num_threads()
+        try:
+            for dtype in (torch.float, torch.double):
+                for fill in fills:
+                    # the values only depend on the seed, not on the number of threads
+                    torch.manual_seed(123)
+                    t = fill(torch.empty(100003, dtype=dtype))
+                    torch.set_num_threads(1)
+                    torch.manual_seed(123)
+                    self.assertEqual(fill(torch.empty(100003, dtype=dtype)), t, 0)
+                    torch.set_num_threads(num_threads)
+                    # and tensors drawn one after the other differ
+                    self.assertNotEqual(fill(torch.empty(100003, dtype=dtype)), t)
+
+                t = torch.empty(100003, dtype=dtype).uniform_(-2, 3)
+                self.assertGreaterEqual(t.min(), -2)
+                self.assertLess(t.max(), 3)
+                self.assertEqual(t.mean(), 0.5, 0.05)
+                t = torch.empty(100003, dtype=dtype).normal_(2, 3)
+                self.assertEqual(t.mean(), 2, 0.05)
+                self.assertEqual(t.std(), 3, 0.05)
+                t = torch.empty(100003, dtype=dtype).bernoulli_(0.3)
+                self.assertEqual(set(t.unique().tolist()), {0, 1})
+                self.assertEqual(t.mean(), 0.3, 0.01)
+        finally:
+            torch.set_num_threads(num_threads)
+
     def test_sobolengine_unscrambled_lowdim(self):
         engine_1d = torch.quasirandom.SobolEngine(1)
         expected_1d = torch.tensor([0.5, 0.75, 0.25, 0.375, 0.875, 0.625, 0.125, 0.1875, 0.6875, 0.9375])
@@ -9327,6 +9767,23 @@ class _TestTorchMixin(object):
         self.assertRaisesRegex(TypeError,
                                "received an invalid combination of arguments",
                                lambda: torch.LongTensor((6, 0), 1, 1, 0))
+
+    def test_parsing_overload_cache(self):
+        # calls with arguments of different kinds bind to different overloads,
+        # whatever the order of the calls
+        x = torch.ones(3)
+        for _ in range(2):
+            self.assertEqual(x.add(x), torch.full((3,), 2))
+            self.assertEqual(x.add(2), torch.full((3,), 3))
+            self.assertEqual(x.add(torch.tensor(3.)), torch.full((3,), 4))
+            y = torch.tensor(4., requires_grad=True)
+            self.assertEqual(x.add(y), torch.full((3,), 5))
+            self.assertTrue(x.add(y).requires_grad)
+            self.assertEqual(x.add(x, alpha=2), torch.full((3,), 3))
+        for _ in range(2):
+            self.assertEqual(torch.ones(2, 3).shape, torch.Size([2, 3]))
+            self.assertEqual(torch.ones(torch.tensor(2), torch.tensor(3)).shape, torch.Size([2, 3]))
+            self.assertRaises(TypeError, lambda: torch.ones(torch.tensor(3.), torch.tensor(4)))
         self.assertRaisesRegex(TypeError,
                                "missing 1 required positional arguments",
                                lambda: torch.tensor().new_zeros((5, 5), 0))
@@ -9461,6 +9918,23 @@ class _TestTorchMixin(object):
         self.assertEqual(i, i_loaded)
         self.assertEqual(j, j_loaded)
 
+    def test_serialization_offset_large_storage(self):
+        # storages of more than one block are read by several threads
+        a = torch.arange(17 * 1024 * 1024 + 5, dtype=torch.int32)
+        b = torch.randn(3)
+        j = 43
+        with tempfile.NamedTemporaryFile() as f:
+            torch.save(b, f)
+            torch.save(a, f)
+            pickle.dump(j, f)
+            f.seek(0)
+            b_loaded = torch.load(f)
+            a_loaded = torch.load(f)
+            j_loaded = pickle.load(f)
+        self.assertTrue(torch.equal(a, a_loaded))
+        self.assertTrue(torch.equal(b, b_loaded))
+        self.assertEqual(j, j_loaded)
+
     def test_serialization_offset_filelike(self):
         a = torch.randn(5, 5)
         b = torch.randn(2, 3)
@@ -9513,6 +9987,35 @@ class _TestTorchMixin(object):
             xh2 = torch.load(f)
             self.assertEqual(xh.float(), xh2.float())
 
+    def test_bfloat16_cpu(self):
+        x = torch.randn(5, 5)
+        y = torch.randn(5, 5)
+        xb, yb = x.bfloat16(), y.bfloat16()
+        self.assertEqual(xb.dtype, torch.bfloat16)
+        self.assertTrue(torch.bfloat16.is_floating_point)
+        self.assertEqual(xb.float(), x, 1e-2)
+        # values with 8 bits of mantissa round-trip exactly
+        self.assertEqual(xb.float().bfloat16().float(), xb.float(), 0)
+
+        self.assertEqual((xb + yb).float(), xb.float() + yb.float(), 1e-1)
+        self.assertEqual(xb.add(yb, alpha=2).float(), xb.float() + 2 * yb.float(), 1e-1)
+        self.assertEqual((xb * yb).float(), xb.float() * yb.float(), 1e-1)
+        self.assertEqual(torch.mm(xb, yb).float(), torch.mm(xb.float(), yb.float()), 1e-1)
+        self.assertEqual(torch.addmm(xb, xb, yb).float(),
+                         torch.addmm(xb.float(), xb.float(), yb.float()), 1e-1)
+
+        # sums are accumulated in float
+        self.assertEqual(torch.ones(4096).bfloat16().sum().item(), 4096)
+        self.assertEqual(torch.zeros(3, 3, dtype=torch.bfloat16).float(), torch.zeros(3, 3))
+        self.assertEqual(xb.clone().fill_(2.5).float(), torch.full((5, 5), 2.5))
+
+        weight = xb.clone().requires_grad_()
+        indices = torch.tensor([[0, 2], [4, 2]])
+        out = torch.nn.functional.embedding(indices, weight)
+        self.assertEqual(out.float(), torch.nn.functional.embedding(indices, xb.float()))
+        out.sum().backward()
+        self.assertEqual(weight.grad.float()[2], torch.full((5,), 2))
+
     def test_serialize_device(self):
         device_str = ['cpu', 'cpu:0', 'cuda', 'cuda:0']
         device_obj = [torch.device(d) for d in device_str]
@@ -10443,6 +10946,13 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         z = from_dlpack(to_dlpack(x))
         self.assertEqual(z, x)
 
+    def test_dlpack_strided(self):
+        x = torch.randn(4, 6)[1:, ::2].t()
+        z = from_dlpack(to_dlpack(x))
+        self.assertEqual(z, x)
+        self.assertEqual(z.stride(), x.stride())
+        self.assertEqual(z.data_ptr(), x.data_ptr())
+
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_from_numpy(self):
         dtypes = [
@@ -10496,6 +11006,52 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         x.strides = (3,)
         self.assertRaises(ValueError, lambda: torch.from_numpy(x))
 
+        # check negative strides, which are flipped into a copy
+        x = np.arange(24.).reshape(2, 3, 4)
+        expected = torch.arange(24.).view(2, 3, 4)
+        self.assertEqual(torch.from_numpy(x[::-1]), expected.flip(0))
+        self.assertEqual(torch.from_numpy(x[:, ::-2, 1:]), expected[:, ::2, 1:].flip(1))
+        self.assertEqual(torch.from_numpy(x.T[::-1]), expected.permute(2, 1, 0).flip(0))
+        self.assertEqual(torch.from_numpy(np.zeros((0, 2))[::-1]).shape, (0, 2))
+
+        # check read-only arrays, which are shared with a warning
+        x = np.arange(6.)
+        x.setflags(write=False)
+        with warnings.catch_warnings(record=True) as w:
+            warnings.simplefilter("always")
+            t = torch.from_numpy(x)
+            self.assertEqual(len(w), 1)
+            self.assertIn('not writeable', str(w[0].message))
+        self.assertEqual(t.data_ptr(), x.__array_interface__['data'][0])
+        self.assertEqual(t, torch.arange(6.))
+
+    @unittest.skipIf(not PY3, "the buffer protocol of tensors needs Python 3")
+    def test_buffer_protocol(self):
+        x = torch.arange(24, dtype=torch.int32).view(4, 6)
+        m = memoryview(x)
+        self.assertEqual(m.format, 'i')
+        self.assertEqual(m.shape, (4, 6))
+        self.assertEqual(m.strides, (24, 4))
+        self.assertEqual(m.tolist(), x.tolist())
+        m[1, 2] = -1
+        self.assertEqual(x[1, 2], -1)
+
+        # non-contiguous tensors export strides
+        m = memoryview(x.t())
+        self.assertEqual(m.shape, (6, 4))
+        self.assertEqual(m.strides, (4, 24))
+        self.assertFalse(m.c_contiguous)
+        self.assertEqual(m.tolist(), x.t().tolist())
+
+        for dtype, fmt in [(torch.float64, 'd'), (torch.float32, 'f'), (torch.int64, 'q'),
+                           (torch.uint8, 'B'), (torch.bool, '?')]:
+            self.assertEqual(memoryview(torch.zeros(3, dtype=dtype)).format, fmt)
+        self.assertEqual(memoryview(torch.tensor(5.)).shape, ())
+
+        self.assertRaises(BufferError, lambda: memoryview(torch.zeros(3, requires_grad=True)))
+        if torch.cuda.is_available():
+            self.assertRaises(BufferError, lambda: memoryview(torch.zeros(3, device='cuda')))
+
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_ctor_with_numpy_array(self):
         correct_dtypes = [
@@ -10987,6 +11543,22 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         if torch.cuda.is_available():
             run_test(torch.device('cuda'))
 
+    @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
+    def test_unique_large(self):
+        # Large inputs are deduplicated in chunks by all threads
+        x = torch.randint(-1000, 1000, (1 << 20,), dtype=torch.long)
+        expected_unique, expected_inverse, expected_counts = [
+            torch.from_numpy(t) for t in np.unique(x.numpy(), return_inverse=True, return_counts=True)]
+        x_unique, x_inverse, x_counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(expected_unique, x_unique)
+        self.assertEqual(expected_inverse, x_inverse)
+        self.assertEqual(expected_counts, x_counts)
+
+        x_unique, x_inverse, x_counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(expected_unique, x_unique.sort()[0])
+        self.assertEqual(x, x_unique[x_inverse])
+        self.assertEqual(x_counts, torch.bincount(x_inverse))
+
     def test_unique_dim(self):
         self.assertFalse(hasattr(torch, 'unique_dim'))
 
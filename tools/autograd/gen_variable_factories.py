@@ -20,6 +20,37 @@ inline at::Tensor ${name}(${formals}) {
 """)
 
 
+# See Note [Factory cache] in torch/csrc/autograd/factory_cache.h
+CACHED_FUNCTION_TEMPLATE = CodeTemplate("""\
+inline at::Tensor ${name}(${formals}) {
+  const bool use_cache =
+    autograd::FactoryCache::is_enabled() && !jit::tracer::isTracing() && !${requires_grad};
+  ${pre_record_trace}
+  at::Tensor result;
+  if (use_cache) {
+    autograd::FactoryCache::Key key("${name}");
+    ${add_to_key}
+    result = autograd::FactoryCache::lookup(key);
+    if (!result.defined()) {
+      at::Tensor tensor = at::${name}(${actuals});
+      result = autograd::make_variable_consuming(std::move(tensor), /*requires_grad=*/false);
+      autograd::FactoryCache::insert(std::move(key), result);
+    }
+  } else {
+    at::Tensor tensor = at::${name}(${actuals});
+    result = autograd::make_variable_consuming(std::move(tensor), /*requires_grad=*/${requires_grad});
+  }
+  ${post_record_trace}
+  return result;
+}
+""")
+
+# Factories whose result only depends on their arguments, and the types of the
+# arguments FactoryCache::Key can hold
+CACHED_FACTORIES = {'arange', 'eye', 'full', 'linspace', 'logspace', 'ones', 'zeros'}
+CACHED_ARGUMENT_TYPES = {'IntArrayRef', 'Scalar', 'int64_t', 'double', 'TensorOptions'}
+
+
 TYPE_PATTERN = re.compile(r"(?:const\s+)?([A-Z]\w+)")
 
 
@@ -64,6 +95,15 @@ def process_function(decl, has_tensor_options):
 
     pre_record_trace, post_record_trace = format_trace(decl)
 
+    if decl['name'] in CACHED_FACTORIES and has_tensor_options and \
+            all(a['simple_type'] in CACHED_ARGUMENT_TYPES for a in decl['arguments']):
+        add_to_key = ['key.add({});'.format(a['name']) for a in decl['arguments']]
+        return CACHED_FUNCTION_TEMPLATE.substitute(
+            name=decl["name"], formals=formals, actuals=actuals, requires_grad=requires_grad,
+            pre_record_trace=pre_record_trace, post_record_trace=post_record_trace,
+            add_to_key=add_to_key
+        )
+
     return FUNCTION_TEMPLATE.substitute(
         name=decl["name"], formals=formals, actuals=actuals, requires_grad=requires_grad,
         pre_record_trace=pre_record_trace, post_record_trace=post_record_trace
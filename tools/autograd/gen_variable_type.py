@@ -45,6 +45,34 @@ DONT_RECORD_TRACE = {
     '_coalesced_',
 }
 
+# These functions cast their inputs while autocast is enabled, see
+# Note [Autocast] in torch/csrc/autograd/autocast_mode.h. Only their functional
+# namespace variants are listed; in-place and out= variants run in the types of
+# their arguments.
+AUTOCAST_LOWER_PRECISION = {
+    '_convolution', 'conv1d', 'conv2d', 'conv3d', 'conv_transpose1d',
+    'conv_transpose2d', 'conv_transpose3d', 'convolution', 'prelu',
+    'addmm', 'addmv', 'addr', 'matmul', 'mm', 'mv', 'linear', 'addbmm',
+    'baddbmm', 'bmm', 'chain_matmul', 'lstm_cell', 'gru_cell', 'rnn_tanh_cell',
+    'rnn_relu_cell',
+}
+
+AUTOCAST_FP32 = {
+    'acos', 'asin', 'cosh', 'erfinv', 'exp', 'log', 'log10', 'log2', 'log1p',
+    'reciprocal', 'rsqrt', 'sinh', 'tan', 'pow', 'softplus', 'softmax',
+    'log_softmax', 'sum', 'prod', 'cumsum', 'cumprod', 'norm', 'renorm',
+    'layer_norm', 'group_norm', 'cosine_similarity', 'dist', 'pdist', 'cdist',
+    'nll_loss', 'nll_loss2d', 'mse_loss', 'kl_div', 'l1_loss', 'smooth_l1_loss',
+    'binary_cross_entropy', 'binary_cross_entropy_with_logits',
+    'poisson_nll_loss', 'cosine_embedding_loss', 'hinge_embedding_loss',
+    'margin_ranking_loss', 'soft_margin_loss', 'multilabel_margin_loss',
+}
+
+AUTOCAST_PROMOTE = {
+    'addcdiv', 'addcmul', 'atan2', 'bilinear', 'cat', 'cross', 'dot', 'stack',
+    'tensordot',
+}
+
 # These functions have their names recorded under trace renamed,
 RENAME_TRACE = {
     'zero': 'zeros_like',
@@ -195,6 +223,25 @@ DISPATCH_TO_NON_VAR_TYPE_WITHOUT_RETURN_VALUES = CodeTemplate("""\
 }
 """)
 
+# See NOTE [ Inference fast path ] in VariableType.cpp
+INFERENCE_FAST_PATH = CodeTemplate("""\
+if (!GradMode::is_enabled() && !jit::tracer::isTracing()) {
+  ${declare_returned_variables}
+  ${call}
+  ${increment_version}
+  ${return_statement}
+}
+""")
+
+# See Note [Autocast] in torch/csrc/autograd/autocast_mode.h
+AUTOCAST = CodeTemplate("""\
+if (AutocastMode::is_enabled()) {
+  ${declare_autocast_type}
+  AutoCastMode autocast_mode(false);
+  return at::${api_name}(${casted_args});
+}
+""")
+
 SET_HISTORY = CodeTemplate("""\
 if (grad_fn) {
     ${fn}_history(${differentiable_outputs}, grad_fn);
@@ -208,6 +255,7 @@ if (${cond}) {
 """)
 
 RECORD_FUNCTION = CodeTemplate("""\
+RECORD_OP_DISPATCH("${name}");
 RECORD_FUNCTION("${name}", std::vector<c10::IValue>({${input_names}}), Function::peek_at_next_sequence_nr());
 """)
 
@@ -781,7 +829,7 @@ def emit_body(declaration):
             # See NOTE [ Treating Variables as non-Variables in type dispatch ] for details.
             base_type_call = CALL_VIA_DERIVED.substitute(combined)
             if not modifies_arguments and not returns_void:
-                rhs_value, extra_wrapping_stmts = wrap_output('tmp')
+                rhs_value, extra_wrapping_stmts = wrap_output('std::move(tmp)')
                 call = DISPATCH_TO_NON_VAR_TYPE_WITH_RETURN_VALUES.substitute(
                     base_type_call=base_type_call,
                     return_values=tie_return_values(),
@@ -821,6 +869,45 @@ def emit_body(declaration):
         moved = ['std::move({})'.format(r['name']) for r in returns]
         return 'std::make_tuple({})'.format(', '.join(moved))
 
+    def emit_inference_fast_path(env):
+        return INFERENCE_FAST_PATH.substitute(
+            declare_returned_variables=declare_returned_variables(),
+            call=emit_call(env),
+            increment_version=emit_increment_version(),
+            return_statement='return;' if returns_void else 'return {};'.format(get_return_value()))
+
+    def emit_autocast():
+        if modifies_arguments or 'namespace' not in declaration['method_of']:
+            return []
+        if name in AUTOCAST_LOWER_PRECISION:
+            autocast_type = 'at::kHalf'
+            declare_autocast_type = []
+        elif name in AUTOCAST_FP32:
+            autocast_type = 'at::kFloat'
+            declare_autocast_type = []
+        elif name in AUTOCAST_PROMOTE:
+            tensor_args = [arg for arg in arguments if arg['simple_type'] in {'Tensor', 'TensorList'}]
+            if len(tensor_args) == 1 and tensor_args[0]['simple_type'] == 'TensorList':
+                promoted = tensor_args[0]['name']
+            else:
+                assert all(arg['simple_type'] == 'Tensor' for arg in tensor_args), name
+                promoted = '{{{}}}'.format(', '.join(arg['name'] for arg in tensor_args))
+            autocast_type = 'autocast_type'
+            declare_autocast_type = ['auto autocast_type = AutocastMode::promote_type({});'.format(promoted)]
+        else:
+            return []
+
+        casted_args = []
+        for arg in arguments:
+            if arg['simple_type'] in {'Tensor', 'TensorList'}:
+                casted_args.append('AutocastMode::cast({}, {})'.format(autocast_type, arg['name']))
+            else:
+                casted_args.append(arg['name'])
+        return [AUTOCAST.substitute(
+            declare_autocast_type=declare_autocast_type,
+            api_name=declaration['api_name'],
+            casted_args=casted_args)]
+
     def emit_history():
         fn = 'rebase' if modifies_arguments and view_info is None else 'set'
         output_names = [r['name'] for r in differentiable_outputs]
@@ -862,6 +949,7 @@ def emit_body(declaration):
     combined = nested_dict(env, declaration)
 
     body = []
+    body.extend(emit_autocast())
     if base_name not in DONT_PROFILE:
         input_names = record_function_input_names()
         body.append(
@@ -869,6 +957,7 @@ def emit_body(declaration):
     if strategy != 'use_type':
         body.extend(unpack_args(env, declaration))
     if requires_derivative:
+        body.append(emit_inference_fast_path(env))
         body.extend(emit_check_inplace())
         body.extend(setup_derivative(differentiable_inputs))
     body.append(declare_returned_variables())
@@ -604,13 +604,32 @@ Tensor repeat_backward(Tensor grad, int64_t input_dims, IntArrayRef repeats) {
 // p1m == 1 - p
 Tensor _fused_dropout_backward(Tensor grad, Tensor mask, double p1m) {
   if (grad.requires_grad()) {
-    // Use autograd-friendly backward if double backward is required
-    return grad * (mask.type_as(grad) * (1. / p1m));
+    // Use autograd-friendly backward if double backward is required. The mask
+    // is packed, so unpack it by scaling ones.
+    return grad * at::_masked_scale(at::ones_like(grad), mask, 1. / p1m);
   } else {
     return at::_masked_scale(grad, mask, 1. / p1m);
   }
 }
 
+std::tuple<Tensor, Tensor, Tensor> _fused_bias_dropout_add_backward(
+    const Tensor& grad, const Tensor& mask, double p1m, const Tensor& bias,
+    std::array<bool, 3> grad_input_mask) {
+  Tensor grad_self, grad_bias, grad_residual;
+  if (grad_input_mask[0] || grad_input_mask[1]) {
+    grad_self = _fused_dropout_backward(grad, mask, p1m);
+  }
+  if (grad_input_mask[1]) {
+    grad_bias = bias.numel() == 0
+        ? at::zeros_like(bias)
+        : grad_self.reshape({-1, bias.numel()}).sum(0);
+  }
+  if (grad_input_mask[2]) {
+    grad_residual = grad;
+  }
+  return std::make_tuple(grad_input_mask[0] ? grad_self : Tensor(), grad_bias, grad_residual);
+}
+
 Tensor select_equals_backward(Tensor grad, const Tensor & input, const Tensor & value) {
   auto grad_input = zeros_like(input);
   grad_input.masked_fill_(input == value, grad);
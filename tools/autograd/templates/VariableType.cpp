@@ -22,6 +22,16 @@
 // may want to switch over to the Everything variant to make you
 // grepping smoother.
 
+// NOTE [ Inference fast path ]
+//
+// With grad mode off and no tracer active, none of the autograd bookkeeping
+// of a differentiable function runs: no grad_fn is created, no history is
+// set and nothing is saved or traced. Such functions check for that once,
+// right after unpacking their arguments, and then only call the base type
+// and wrap its outputs. The version counters of modified arguments are still
+// bumped, since these Variables may have been saved for backward by an
+// earlier forward with grad mode on.
+
 using namespace at;
 using namespace torch::autograd::generated;
 
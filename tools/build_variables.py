@@ -36,17 +36,21 @@ libtorch_sources = [
     ":generate-code=VariableType_4.cpp",
     "torch/csrc/autograd/VariableTypeManual.cpp",
     "torch/csrc/autograd/anomaly_mode.cpp",
+    "torch/csrc/autograd/autocast_mode.cpp",
     "torch/csrc/autograd/engine.cpp",
+    "torch/csrc/autograd/factory_cache.cpp",
     "torch/csrc/autograd/function.cpp",
     "torch/csrc/autograd/function_hook.cpp",
     "torch/csrc/autograd/functions/accumulate_grad.cpp",
     "torch/csrc/autograd/functions/basic_ops.cpp",
+    "torch/csrc/autograd/functions/checkpoint.cpp",
     "torch/csrc/autograd/functions/tensor.cpp",
     "torch/csrc/autograd/functions/utils.cpp",
     "torch/csrc/autograd/grad_mode.cpp",
     "torch/csrc/autograd/input_buffer.cpp",
     "torch/csrc/autograd/profiler.cpp",
     "torch/csrc/autograd/record_function.cpp",
+    "torch/csrc/autograd/sampling_profiler.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
     "torch/csrc/autograd/variable.cpp",
     "torch/csrc/Exceptions.cpp",
@@ -60,8 +64,12 @@ libtorch_sources = [
     "torch/csrc/jit/pickler.cpp",
     "torch/csrc/jit/graph_executor.cpp",
     "torch/csrc/jit/import.cpp",
+    "torch/csrc/jit/batching_scheduler.cpp",
     "torch/csrc/jit/import_export_helpers.cpp",
     "torch/csrc/jit/interpreter.cpp",
+    "torch/csrc/jit/mobile/import.cpp",
+    "torch/csrc/jit/mobile/interpreter.cpp",
+    "torch/csrc/jit/mobile/module.cpp",
     "torch/csrc/jit/ir.cpp",
     "torch/csrc/jit/irparser.cpp",
     "torch/csrc/jit/netdef_converter.cpp",
@@ -71,6 +79,7 @@ libtorch_sources = [
     "torch/csrc/jit/profiling_graph_executor_impl.cpp",
     "torch/csrc/jit/profiling_record.cpp",
     "torch/csrc/jit/operator.cpp",
+    "torch/csrc/jit/passes/algebraic_simplification.cpp",
     "torch/csrc/jit/passes/alias_analysis.cpp",
     "torch/csrc/jit/passes/batch_mm.cpp",
     "torch/csrc/jit/passes/canonicalize_ops.cpp",
@@ -82,13 +91,18 @@ libtorch_sources = [
     "torch/csrc/jit/passes/create_autodiff_subgraphs.cpp",
     "torch/csrc/jit/passes/dead_code_elimination.cpp",
     "torch/csrc/jit/passes/erase_number_types.cpp",
+    "torch/csrc/jit/passes/fork_independent_nodes.cpp",
+    "torch/csrc/jit/passes/freeze_module.cpp",
     "torch/csrc/jit/passes/graph_fuser.cpp",
     "torch/csrc/jit/passes/inline_autodiff_subgraphs.cpp",
     "torch/csrc/jit/passes/inplace_check.cpp",
     "torch/csrc/jit/passes/insert_guards.cpp",
+    "torch/csrc/jit/passes/loop_invariant_code_motion.cpp",
     "torch/csrc/jit/passes/loop_unrolling.cpp",
     "torch/csrc/jit/passes/lower_grad_of.cpp",
     "torch/csrc/jit/passes/lower_tuples.cpp",
+    "torch/csrc/jit/passes/memory_planning.cpp",
+    "torch/csrc/jit/passes/mkldnn_rewrite.cpp",
     "torch/csrc/jit/passes/peephole.cpp",
     "torch/csrc/jit/passes/python_print.cpp",
     "torch/csrc/jit/passes/quantization.cpp",
@@ -96,7 +110,9 @@ libtorch_sources = [
     "torch/csrc/jit/passes/requires_grad_analysis.cpp",
     "torch/csrc/jit/passes/shape_analysis.cpp",
     "torch/csrc/jit/passes/specialize_autogradzero.cpp",
+    "torch/csrc/jit/passes/strength_reduction.cpp",
     "torch/csrc/jit/passes/subgraph_rewrite.cpp",
+    "torch/csrc/jit/passes/symbolic_shape_analysis.cpp",
     "torch/csrc/jit/passes/utils/subgraph_utils.cpp",
     "torch/csrc/jit/passes/utils/memory_dag.cpp",
     "torch/csrc/jit/register_prim_ops.cpp",
@@ -139,7 +155,8 @@ libtorch_cuda_sources = [
     "torch/csrc/jit/fuser/cuda/fused_kernel.cpp",
     "torch/csrc/jit/fuser/cuda/thnvrtc.cpp",
     "torch/csrc/autograd/profiler_cuda.cpp",
-    "torch/csrc/autograd/functions/comm.cpp"
+    "torch/csrc/autograd/functions/comm.cpp",
+    "torch/csrc/api/src/data/detail/device_copy_cuda.cpp",
 ]
 
 
@@ -165,7 +182,9 @@ def add_torch_libs():
         "torch/csrc/Storage.cpp",
         "torch/csrc/TypeInfo.cpp",
         "torch/csrc/api/src/cuda.cpp",
+        "torch/csrc/api/src/data/datasets/mapped_chunk.cpp",
         "torch/csrc/api/src/data/datasets/mnist.cpp",
+        "torch/csrc/api/src/data/detail/device_copy.cpp",
         "torch/csrc/api/src/data/samplers/distributed.cpp",
         "torch/csrc/api/src/data/samplers/random.cpp",
         "torch/csrc/api/src/data/samplers/sequential.cpp",
@@ -190,6 +209,7 @@ def add_torch_libs():
         "torch/csrc/api/src/python/init.cpp",
         "torch/csrc/api/src/serialize/input-archive.cpp",
         "torch/csrc/api/src/serialize/output-archive.cpp",
+        "torch/csrc/api/src/serialize/sharded.cpp",
         "torch/csrc/autograd/functions/init.cpp",
         "torch/csrc/autograd/init.cpp",
         "torch/csrc/autograd/python_anomaly_mode.cpp",
@@ -205,6 +225,10 @@ def add_torch_libs():
         "torch/csrc/distributed/c10d/comm.cpp",
         "torch/csrc/distributed/c10d/init.cpp",
         "torch/csrc/distributed/c10d/reducer.cpp",
+        "torch/csrc/distributed/rpc/message.cpp",
+        "torch/csrc/distributed/rpc/process_group_agent.cpp",
+        "torch/csrc/distributed/rpc/rpc_agent.cpp",
+        "torch/csrc/distributed/rpc/sharded_embedding.cpp",
         "torch/csrc/jit/init.cpp",
         "torch/csrc/jit/passes/inline_fork_wait.cpp",
         "torch/csrc/jit/passes/onnx.cpp",
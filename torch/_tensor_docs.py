@@ -1791,6 +1791,16 @@ zero_point.
 returns the quantized Tensor.
 """)
 
+add_docstr_all('quantize_linear_per_channel',
+               r"""
+quantize_linear_per_channel(scales, zero_points, axis, dtype) -> Tensor
+
+Quantize a float Tensor using per channel affine quantization scheme, with
+``scales[c]`` and ``zero_points[c]`` for the slice ``c`` along dimension
+``axis[0]``.
+returns the quantized Tensor.
+""")
+
 add_docstr_all('q_scale',
                r"""
 q_scale() -> float
@@ -1807,6 +1817,22 @@ Given a Tensor quantized by linear(affine) quantization,
 returns the zero_point of the underlying quantizer().
 """)
 
+add_docstr_all('q_per_channel_scales',
+               r"""
+q_per_channel_scales() -> Tensor
+
+Given a Tensor quantized by per channel linear(affine) quantization,
+returns a Tensor of the scales of the underlying quantizer().
+""")
+
+add_docstr_all('q_per_channel_zero_points',
+               r"""
+q_per_channel_zero_points() -> Tensor
+
+Given a Tensor quantized by per channel linear(affine) quantization,
+returns a Tensor of the zero_points of the underlying quantizer().
+""")
+
 add_docstr_all('random_',
                r"""
 random_(from=0, to=None, *, generator=None) -> Tensor
@@ -2498,6 +2524,13 @@ byte() -> Tensor
 ``self.byte()`` is equivalent to ``self.to(torch.uint8)``. See :func:`to`.
 """)
 
+add_docstr_all('bfloat16',
+               r"""
+bfloat16() -> Tensor
+
+``self.bfloat16()`` is equivalent to ``self.to(torch.bfloat16)``. See :func:`to`.
+""")
+
 add_docstr_all('bool',
                r"""
 bool() -> Tensor
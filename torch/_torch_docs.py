@@ -1860,6 +1860,11 @@ The returned tensor and :attr:`ndarray` share the same memory. Modifications to
 the tensor will be reflected in the :attr:`ndarray` and vice versa. The returned
 tensor is not resizable.
 
+Read-only arrays, like read-only memory maps, are shared too, with a warning:
+writing to their tensor is undefined behavior. Arrays with negative strides,
+like ``a[::-1]``, are the exception: tensors cannot have negative strides, so
+their elements are copied.
+
 Example::
 
     >>> a = numpy.array([1, 2, 3])
@@ -12,6 +12,8 @@ from .function import Function, NestedIOFunction  # noqa: F401
 from .gradcheck import gradcheck, gradgradcheck  # noqa: F401
 from .grad_mode import no_grad, enable_grad, set_grad_enabled  # noqa: F401
 from .anomaly_mode import detect_anomaly, set_detect_anomaly  # noqa: F401
+from .factory_cache import cache_factories  # noqa: F401
+from .autocast_mode import autocast  # noqa: F401
 from . import profiler  # noqa: F401
 
 __all__ = ['Variable', 'Function', 'backward', 'grad_mode']
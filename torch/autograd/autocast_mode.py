@@ -0,0 +1,66 @@
+import torch
+import functools
+
+
+class autocast(object):
+    r"""Context-manager that runs CUDA operations in mixed precision.
+
+    Inside this context, matrix multiplications, convolutions and RNN cells
+    (e.g. :func:`torch.mm`, :func:`torch.addmm`, :func:`torch.matmul`,
+    :func:`torch.nn.functional.linear`, :func:`torch.nn.functional.conv2d`)
+    cast their floating point CUDA inputs to ``torch.half`` so they can use
+    tensor cores, while numerically sensitive operations (reductions,
+    :func:`torch.softmax`, :func:`torch.log_softmax`, norms and losses) cast
+    them to ``torch.float``. Operations of several inputs that must agree on
+    their type (e.g. :func:`torch.cat`) use the widest of the input types. All
+    other operations run in the types of their inputs, and in-place and
+    ``out=`` operations are never cast.
+
+    The casts are differentiable, so a model with ``torch.float`` parameters
+    needs no other changes: its gradients are computed in ``torch.float``. The
+    casts of leaf tensors that require grad (the parameters of a model) are
+    cached until the outermost context is exited, and remade once a parameter
+    is modified in-place. The forward pass should run inside the context and
+    the backward pass and optimizer step outside of it.
+
+    ``autocast(enabled=False)`` disables autocasting in a region of an
+    enabled context. Autocasting is thread local, it doesn't affect
+    computation in other threads.
+
+    Also functions as a decorator.
+
+    Arguments:
+        enabled (bool): whether to enable autocasting (default: ``True``)
+
+    Example::
+
+        >>> a = torch.randn(4, 4, device='cuda')
+        >>> w = torch.randn(4, 4, device='cuda', requires_grad=True)
+        >>> with torch.autograd.autocast():
+        ...     b = torch.mm(a, w)
+        ...     c = torch.softmax(b, 1)
+        >>> b.dtype, c.dtype
+        (torch.float16, torch.float32)
+        >>> c.sum().backward()
+        >>> w.grad.dtype
+        torch.float32
+    """
+    def __init__(self, enabled=True):
+        self.enabled = enabled
+
+    def __enter__(self):
+        self.prev = torch._C._is_autocast_enabled()
+        torch._C._set_autocast_enabled(self.enabled)
+
+    def __exit__(self, *args):
+        torch._C._set_autocast_enabled(self.prev)
+        if not self.prev:
+            torch._C._clear_autocast_cache()
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_autocast(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_autocast
@@ -0,0 +1,50 @@
+import torch
+import functools
+
+
+class cache_factories(object):
+    r"""Context-manager that reuses the results of deterministic tensor factories.
+
+    Inside this context, :func:`torch.arange`, :func:`torch.eye`,
+    :func:`torch.full`, :func:`torch.linspace`, :func:`torch.logspace`,
+    :func:`torch.ones` and :func:`torch.zeros` return the tensor they returned
+    the last time they were called with the same arguments on this thread,
+    instead of allocating and filling a new one. This saves time in code that
+    builds the same constant tensors (e.g. masks) over and over.
+
+    The tensors are shared, so they should be treated as read-only. Once one
+    of them is modified in-place, the next call returns a new tensor, but the
+    modification is visible through all the tensors returned so far. Calls
+    that create tensors with ``requires_grad=True``, or that are traced, are
+    never cached. The cached tensors are released when the outermost context
+    is exited.
+
+    Also functions as a decorator.
+
+    Example::
+
+        >>> with torch.autograd.cache_factories():
+        ...     a = torch.ones(3)
+        ...     b = torch.ones(3)
+        >>> a is b
+        True
+        >>> with torch.autograd.cache_factories():
+        ...     a = torch.ones(3)
+        ...     a.add_(1)
+        ...     b = torch.ones(3)
+        >>> b
+        tensor([1., 1., 1.])
+    """
+    def __enter__(self):
+        torch._C._enter_factory_cache()
+
+    def __exit__(self, *args):
+        torch._C._exit_factory_cache()
+        return False
+
+    def __call__(self, func):
+        @functools.wraps(func)
+        def decorate_cache_factories(*args, **kwargs):
+            with self:
+                return func(*args, **kwargs)
+        return decorate_cache_factories
@@ -8,6 +8,7 @@ from operator import attrgetter
 class EventList(list):
     """A list of Events (for pretty printing)"""
     def __init__(self, *args, **kwargs):
+        self.memory_events = kwargs.pop('memory_events', [])
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
 
@@ -102,8 +103,10 @@ class EventList(list):
         import json
         with open(path, 'w') as f:
             chrome_events = []
-            next_id = 0
             for evt in self:
+                args = dict(correlation=evt.correlation_id)
+                if evt.input_shapes:
+                    args['input_shapes'] = evt.input_shapes
                 chrome_events.append(dict(
                     name=evt.name,
                     ph='X',
@@ -111,7 +114,7 @@ class EventList(list):
                     dur=evt.cpu_interval.elapsed_us(),
                     tid=evt.thread,
                     pid='CPU functions',
-                    args={},
+                    args=args,
                 ))
                 for k in evt.kernels:
                     # 's' and 'f' draw Flow arrows from
@@ -122,7 +125,7 @@ class EventList(list):
                         ts=evt.cpu_interval.start,
                         tid=evt.thread,
                         pid='CPU functions',
-                        id=next_id,
+                        id=evt.correlation_id,
                         cat='cpu_to_cuda',
                         args={},
                     ))
@@ -132,7 +135,7 @@ class EventList(list):
                         ts=k.interval.start,
                         tid=k.device,
                         pid='CUDA functions',
-                        id=next_id,
+                        id=evt.correlation_id,
                         cat='cpu_to_cuda',
                         args={},
                     ))
@@ -143,9 +146,22 @@ class EventList(list):
                         dur=k.interval.elapsed_us(),
                         tid=k.device,
                         pid='CUDA functions',
-                        args={},
+                        args=dict(stream=k.stream,
+                                  correlation=evt.correlation_id),
                     ))
-                    next_id += 1
+
+            # 'C' events draw the memory allocated on every device over time
+            allocated = defaultdict(int)
+            for m in self.memory_events:
+                device = 'cuda:{}'.format(m.device) if m.device >= 0 else 'cpu (pinned)'
+                allocated[device] += m.alloc_size
+                chrome_events.append(dict(
+                    name='memory ' + device,
+                    ph='C',
+                    ts=m.time,
+                    pid='Memory',
+                    args=dict(allocated=allocated[device]),
+                ))
 
             json.dump(chrome_events, f)
 
@@ -212,6 +228,11 @@ class profile(object):
         self cpu time might be artificially increased because of the shape
         collection.
 
+        profile_memory (bool, optional): Records every allocation and free of
+        the CUDA caching allocator and of the pinned memory allocator, which
+        :meth:`export_chrome_trace` draws as the memory allocated on each
+        device over time. Default: ``False``
+
     .. warning:
         This context managers should not be called recursively, i.e. at most one
         instance should be enabled at any given time.
@@ -235,7 +256,7 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, profile_memory=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -243,6 +264,7 @@ class profile(object):
             return
         self.entered = False
         self.record_shapes = record_shapes
+        self.profile_memory = profile_memory
 
     def __enter__(self):
         if not self.enabled:
@@ -253,14 +275,15 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
         torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes))
+            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory))
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records))
+        self.function_events = EventList(parse_cpu_trace(records),
+                                         memory_events=parse_memory_trace(records))
         return False
 
     def __repr__(self):
@@ -472,14 +495,20 @@ class Interval(object):
         return self.end - self.start
 
 
-Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
+Kernel = namedtuple('Kernel', ['name', 'device', 'interval', 'stream'])
+
+
+# alloc_size is negative for frees, device is -1 for pinned host memory
+MemoryEvent = namedtuple('MemoryEvent', ['device', 'alloc_size', 'time'])
 
 
 # TODO: record TID too
 class FunctionEvent(FormattedTimesMixin):
     """Profiling information about a single function."""
-    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None):
+    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None,
+                 correlation_id=None):
         self.id = id
+        self.correlation_id = id if correlation_id is None else correlation_id
         self.name = name
         self.cpu_interval = Interval(cpu_start, cpu_end)
         self.thread = thread
@@ -488,8 +517,8 @@ class FunctionEvent(FormattedTimesMixin):
         self.cpu_children = []
         self.input_shapes = input_shapes
 
-    def append_kernel(self, name, device, start, end):
-        self.kernels.append(Kernel(name, device, Interval(start, end)))
+    def append_kernel(self, name, device, start, end, stream=0):
+        self.kernels.append(Kernel(name, device, Interval(start, end), stream))
 
     def append_cpu_child(self, child):
         """Append a CPU child of type FunctionEvent.
@@ -629,20 +658,40 @@ def parse_cpu_trace(thread_records):
                 thread=start.thread_id(),
                 cpu_start=start_record.cpu_elapsed_us(start),
                 cpu_end=start_record.cpu_elapsed_us(record),
-                input_shapes=start.shapes())
+                input_shapes=start.shapes(),
+                correlation_id=start.correlation_id())
             if start.has_cuda():
                 cuda_start = adjusted_time(start)
                 cuda_end = adjusted_time(record)
                 fe.append_kernel(start.name(),
                                  start.device(),
                                  cuda_start,
-                                 cuda_end)
+                                 cuda_end,
+                                 start.stream())
             functions.append(fe)
 
     functions.sort(key=lambda evt: evt.cpu_interval.start)
     return functions
 
 
+def parse_memory_trace(thread_records):
+    start_record = None
+    for record in itertools.chain(*thread_records):
+        if record.name() == '__start_profile':
+            start_record = record
+    assert start_record is not None
+
+    memory_events = [
+        MemoryEvent(device=record.device(),
+                    alloc_size=record.alloc_size(),
+                    time=start_record.cpu_elapsed_us(record))
+        for record in itertools.chain(*thread_records)
+        if record.kind() == 'memory_alloc'
+    ]
+    memory_events.sort(key=attrgetter('time'))
+    return memory_events
+
+
 ################################################################################
 # CUDA checkpoints
 
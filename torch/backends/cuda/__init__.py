@@ -29,8 +29,9 @@ class cuFFTPlanCacheAttrContextProp(object):
 class cuFFTPlanCache(object):
     r"""
     Represents a specific plan cache for a specific `device_index`. The
-    attributes `size` and `max_size`, and method `clear`, can fetch and/ or
-    change properties of the C++ cuFFT plan cache.
+    attributes `size`, `max_size`, `workspace_size`, `max_workspace_size`,
+    `hits` and `misses`, and method `clear`, can fetch and/ or change
+    properties of the C++ cuFFT plan cache.
     """
     def __init__(self, device_index):
         self.device_index = device_index
@@ -43,6 +44,22 @@ class cuFFTPlanCache(object):
     max_size = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_size,
                                              torch._cufft_set_plan_cache_max_size)
 
+    workspace_size = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_workspace_size,
+        '.workspace_size is a read-only property showing the workspace bytes of the plans '
+        'currently in the cache. To bound it, set cufft_plan_cache.max_workspace_size.')
+
+    max_workspace_size = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_workspace_size,
+                                                       torch._cufft_set_plan_cache_max_workspace_size)
+
+    hits = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_hits,
+        '.hits is a read-only property showing the number of lookups that found a plan in the cache.')
+
+    misses = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_misses,
+        '.misses is a read-only property showing the number of lookups that created a plan.')
+
     def clear(self):
         return torch._cufft_clear_plan_cache(self.device_index)
 
@@ -83,6 +100,18 @@ class cuFFTPlanCacheManager(object):
             return super(cuFFTPlanCacheManager, self).__setattr__(name, value)
 
 
+class ContextProp(object):
+    def __init__(self, getter, setter):
+        self.getter = getter
+        self.setter = setter
+
+    def __get__(self, obj, objtype):
+        return self.getter()
+
+    def __set__(self, obj, val):
+        self.setter(val)
+
+
 class CUDAModule(object):
     def __init__(self, m):
         self.__dict__ = m.__dict__
@@ -92,6 +121,7 @@ class CUDAModule(object):
         self.__old_mod = m
 
     cufft_plan_cache = cuFFTPlanCacheManager()
+    benchmark_reductions = ContextProp(torch._C._get_reduction_benchmark, torch._C._set_reduction_benchmark)
 
 # This is the sys.modules replacement trick, see
 # https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
@@ -4,3 +4,48 @@ import torch
 def is_available():
     r"""Returns whether PyTorch is built with MKL support."""
     return torch._C.has_mkl
+
+
+class _FFTPlanCacheProp(object):
+    def __init__(self, getter, setter):
+        self.getter = getter
+        self.setter = setter
+
+    def __get__(self, obj, objtype):
+        return self.getter()
+
+    def __set__(self, obj, val):
+        if isinstance(self.setter, str):
+            raise RuntimeError(self.setter)
+        self.setter(val)
+
+
+class FFTPlanCache(object):
+    r"""
+    Represents the cache of committed MKL FFT descriptors used by the CPU
+    implementation of :func:`torch.fft` and friends. The attributes `size`,
+    `max_size`, `hits` and `misses`, and method `clear`, can fetch and/ or
+    change properties of the C++ plan cache.
+    """
+
+    size = _FFTPlanCacheProp(
+        torch._mkl_fft_get_plan_cache_size,
+        '.size is a read-only property showing the number of plans currently in the '
+        'cache. To change the cache capacity, set fft_plan_cache.max_size.')
+
+    max_size = _FFTPlanCacheProp(torch._mkl_fft_get_plan_cache_max_size,
+                                 torch._mkl_fft_set_plan_cache_max_size)
+
+    hits = _FFTPlanCacheProp(
+        torch._mkl_fft_get_plan_cache_hits,
+        '.hits is a read-only property showing the number of lookups that found a plan in the cache.')
+
+    misses = _FFTPlanCacheProp(
+        torch._mkl_fft_get_plan_cache_misses,
+        '.misses is a read-only property showing the number of lookups that created a plan.')
+
+    def clear(self):
+        return torch._mkl_fft_clear_plan_cache()
+
+
+fft_plan_cache = FFTPlanCache()
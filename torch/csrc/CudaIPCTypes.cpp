@@ -1,9 +1,13 @@
 #ifdef USE_CUDA
 #include <torch/csrc/CudaIPCTypes.h>
 #include <TH/THAllocator.h>
+#include <algorithm>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <random>
+#include <utility>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -32,6 +36,24 @@ struct CudaIPCGlobalEntities {
       ref_counters_files_;
   std::shared_ptr<CudaIPCRefCountersFile> next_available_ref_counters_file_;
   CudaIPCSentDataLimbo CudaIPCSentDataLimbo_;
+
+  // See Note [Reusing CUDA IPC resources]
+  std::mutex events_mutex_;
+  // Released interprocess events, by device. They are never destroyed, like
+  // the events still in use at exit.
+  std::map<int64_t, std::vector<cudaEvent_t>> free_events_;
+
+  std::mutex mem_handles_mutex_;
+  // The segments shared so far, by device, and the number of segments the
+  // caching allocator freed when they were cached
+  std::map<int64_t, std::pair<uint64_t, std::map<void*, std::string>>>
+      mem_handles_;
+
+  std::mutex received_ref_counters_mutex_;
+  // The reference counter files of producers mapped by this process, least
+  // recently used first
+  std::deque<std::pair<std::string, at::DataPtr>> received_ref_counters_files_;
+
   CudaIPCGlobalEntities() : ref_counters_files_() {}
   ~CudaIPCGlobalEntities() {
     CudaIPCSentDataLimbo_.collect();
@@ -40,6 +62,20 @@ struct CudaIPCGlobalEntities {
       warnProducerTerminatedBeforeSharedTensorsReleased();
     }
   }
+  bool take_free_event(int64_t device, cudaEvent_t* event) {
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    auto& events = free_events_[device];
+    if (events.empty()) {
+      return false;
+    }
+    *event = events.back();
+    events.pop_back();
+    return true;
+  }
+  void return_event(int64_t device, cudaEvent_t event) {
+    std::lock_guard<std::mutex> lock(events_mutex_);
+    free_events_[device].push_back(event);
+  }
   void safe_clean_current_file() {
     std::lock_guard<std::mutex> lock(ref_counters_mutex_);
     if (next_available_ref_counters_file_ &&
@@ -134,23 +170,28 @@ CudaIPCSentData::CudaIPCSentData(
   //  [i.record() for i in a]
   //  ```
   //
-  if (cuda_ipc_global_entities.sync_events_used_.load() < CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
-    // TODO: More efficient would be to create event inside of main thread (at
-    // the moment of the queue.put). The reason this is more efficient is
-    // because the main thread may have queued extra work on the stream, which
-    // this event will consequently wait for (uselessly).
+  // TODO: More efficient would be to create event inside of main thread (at
+  // the moment of the queue.put). The reason this is more efficient is
+  // because the main thread may have queued extra work on the stream, which
+  // this event will consequently wait for (uselessly).
+  event_sync_required_ =
+      cuda_ipc_global_entities.take_free_event(device.index(), &event_);
+  if (!event_sync_required_ &&
+      cuda_ipc_global_entities.sync_events_used_.load() <
+          CUDA_IPC_MAXIMUM_EVENTS_TO_USE) {
     cuda_ipc_global_entities.sync_events_used_ ++;
     C10_CUDA_CHECK(cudaEventCreateWithFlags(
         &event_,
         cudaEventDisableTiming | cudaEventInterprocess |
             cudaEventBlockingSync));
+    event_sync_required_ = true;
+  }
+  if (event_sync_required_) {
     C10_CUDA_CHECK(cudaEventRecord(
         event_, c10::cuda::getCurrentCUDAStream(device.index())));
-    event_sync_required_ = true;
   } else {
     auto stream = c10::cuda::getCurrentCUDAStream(device.index());
     C10_CUDA_CHECK(cudaStreamSynchronize(stream));
-    event_sync_required_ = false;
   }
 #else
   // cuIpcGetEventHandle with HIP is not supported, so we have to sync
@@ -164,11 +205,12 @@ CudaIPCSentData::CudaIPCSentData(
 CudaIPCSentData::~CudaIPCSentData() {
   ReturnRefCounter(handle_, offset_);
 #ifndef __HIP_PLATFORM_HCC__
+  // All consumers released the storage, so none of them waits on the event
+  // anymore, and it can be recorded again for another one. See Note [Reusing
+  // CUDA IPC resources].
   try {
     if (event_sync_required_) {
-      at::cuda::CUDAGuard device_guard(device_.index());
-      cudaEventDestroy(event_);
-      cuda_ipc_global_entities.sync_events_used_ --;
+      cuda_ipc_global_entities.return_event(device_.index(), event_);
     }
   } catch (...) { /* No throw */
   }
@@ -221,6 +263,62 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+std::string GetIpcMemHandle(void* base_ptr, at::Device device) {
+  // Read before taking the lock, any segment that is freed afterwards can't
+  // be the live one at base_ptr
+  const auto cuda_frees =
+      c10::cuda::CUDACachingAllocator::eventCounts(device.index())
+          .num_cuda_frees;
+  std::lock_guard<std::mutex> lock(
+      cuda_ipc_global_entities.mem_handles_mutex_);
+  auto& cached = cuda_ipc_global_entities.mem_handles_[device.index()];
+  if (cached.first != cuda_frees) {
+    cached.first = cuda_frees;
+    cached.second.clear();
+  }
+  auto it = cached.second.find(base_ptr);
+  if (it == cached.second.end()) {
+    at::cuda::CUDAGuard device_guard(device.index());
+    cudaIpcMemHandle_t handle;
+    C10_CUDA_CHECK(cudaIpcGetMemHandle(&handle, base_ptr));
+    it = cached.second
+             .emplace(
+                 base_ptr,
+                 std::string(reinterpret_cast<char*>(&handle), sizeof(handle)))
+             .first;
+  }
+  return it->second;
+}
+
+void ReleaseRefCounter(const std::string& handle, int64_t offset) {
+  std::lock_guard<std::mutex> lock(
+      cuda_ipc_global_entities.received_ref_counters_mutex_);
+  auto& files = cuda_ipc_global_entities.received_ref_counters_files_;
+  auto it = std::find_if(
+      files.begin(),
+      files.end(),
+      [&handle](const std::pair<std::string, at::DataPtr>& file) {
+        return file.first == handle;
+      });
+  if (it == files.end()) {
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+    at::DataPtr sptr = THRefcountedMapAllocator::makeDataPtr(
+        handle.c_str(),
+        flags,
+        sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+        nullptr);
+    if (files.size() == CUDA_IPC_RECEIVED_REF_COUNTER_FILES_TO_KEEP) {
+      files.pop_front();
+    }
+    files.emplace_back(handle, std::move(sptr));
+  } else if (it + 1 != files.end()) {
+    auto file = std::move(*it);
+    files.erase(it);
+    files.push_back(std::move(file));
+  }
+  *(static_cast<int64_t*>(files.back().second.get()) + offset) -= 1;
+}
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
@@ -49,6 +49,36 @@ struct CudaIPCSentData final {
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
 
+// Note [Reusing CUDA IPC resources]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sharing a storage always shares the whole caching allocator segment it
+// lives in, along with the offset of the storage in it, and the consumer
+// opens every segment only once while any of its storages are alive (see
+// getIpcDevPtr). To make sharing many small storages cheap, the other
+// per-storage resources are reused as well:
+//
+// - The producer caches the cudaIpcMemHandle_t of every segment it shared,
+//   instead of calling cudaIpcGetMemHandle for every storage. The cache of a
+//   device is dropped whenever the caching allocator returned any memory of
+//   that device to the driver, since a new segment may then start at the same
+//   address.
+// - The interprocess event of a storage is put back into a pool once all
+//   consumers released it, and recorded again for a later storage, instead of
+//   creating a new event each time. The pool counts towards
+//   CUDA_IPC_MAXIMUM_EVENTS_TO_USE.
+// - The consumer keeps the last few reference counter files it released
+//   counters in mapped, instead of mapping a file for every release. This
+//   delays the removal of a file until it is evicted, or the consumer exits.
+
+// Returns the cudaIpcMemHandle_t of the segment at `base_ptr`, as bytes. See
+// Note [Reusing CUDA IPC resources].
+std::string GetIpcMemHandle(void* base_ptr, at::Device device);
+
+// Decrements the reference counter at `offset` in the producer's reference
+// counter file `handle`, from a consumer process. Throws if the producer has
+// already removed the file. See Note [Reusing CUDA IPC resources].
+void ReleaseRefCounter(const std::string& handle, int64_t offset);
+
 namespace {
 
 constexpr int64_t CUDA_IPC_REF_COUNTER_FILE_SIZE = 10000;
@@ -58,6 +88,8 @@ constexpr int64_t CUDA_IPC_WARN_AFTER_X_BLOCKS_IN_LIMBO = 1000;
 // And to give us leeway, we picked 1000 as it gives us enough events to share
 // tensors effectively.
 constexpr int64_t CUDA_IPC_MAXIMUM_EVENTS_TO_USE = 1000;
+// The number of reference counter files a consumer keeps mapped.
+constexpr size_t CUDA_IPC_RECEIVED_REF_COUNTER_FILES_TO_KEEP = 8;
 
 // All to be deleted data blocks with non zero reference counter goes there
 struct CudaIPCSentDataLimbo final {
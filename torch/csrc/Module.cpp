@@ -427,6 +427,34 @@ PyObject *THPModule_benchmarkCuDNN(PyObject *_unused)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setBenchmarkReductions(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_benchmark_reductions expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setBenchmarkReductions(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_benchmarkReductions(PyObject *_unused)
+{
+  if (at::globalContext().benchmarkReductions()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setFastTranscendentals(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_fast_transcendentals expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setFastTranscendentals(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_fastTranscendentals(PyObject *_unused)
+{
+  if (at::globalContext().fastTranscendentals()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -483,6 +511,10 @@ static PyMethodDef TorchMethods[] = {
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_get_reduction_benchmark", (PyCFunction)THPModule_benchmarkReductions, METH_NOARGS,     nullptr},
+  {"_set_reduction_benchmark", (PyCFunction)THPModule_setBenchmarkReductions, METH_O,  nullptr},
+  {"_get_fast_transcendentals", (PyCFunction)THPModule_fastTranscendentals, METH_NOARGS,     nullptr},
+  {"_set_fast_transcendentals", (PyCFunction)THPModule_setFastTranscendentals, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -2,6 +2,7 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/device_copy.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
@@ -126,6 +127,9 @@ class DataLoaderBase {
         : Sequenced(sqn), exception(std::move(exception)) {}
     optional<Batch> batch;
     std::exception_ptr exception;
+    /// The fence of the asynchronous copy of `batch` to the device, if any.
+    /// See Note [Prefetching batches to a device].
+    std::shared_ptr<detail::DeviceCopyFence> device_copy_fence;
   };
 
   /// Subclass hook for getting the next batch request. The stateless case will
@@ -169,17 +173,28 @@ class DataLoaderBase {
           throw WorkerException(result->exception);
         } else if (result->batch) {
           prefetch(1);
+          if (result->device_copy_fence) {
+            detail::wait_for_device_copy(
+                *result->batch, *result->device_copy_fence);
+          }
           return std::move(result->batch);
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      auto batch =
+          this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      if (batch && options_.device) {
+        detail::move_to_device(*batch, *options_.device);
+      }
+      return batch;
     }
     return nullopt;
   }
 
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
+    // The side stream this worker copies its batches to the device on.
+    std::unique_ptr<detail::DeviceCopyStream> device_copy_stream;
     while (true) {
       auto job = shuttle_.pop_job();
       if (job.quit) {
@@ -187,7 +202,20 @@ class DataLoaderBase {
       }
       try {
         auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        Result result(std::move(batch), job.sequence_number);
+        if (result.batch && options_.device) {
+          if (!options_.device->is_cuda()) {
+            detail::move_to_device(*result.batch, *options_.device);
+          } else {
+            if (!device_copy_stream) {
+              device_copy_stream =
+                  detail::make_device_copy_stream(*options_.device);
+            }
+            result.device_copy_fence =
+                detail::copy_to_device(*result.batch, *device_copy_stream);
+          }
+        }
+        shuttle_.push_result(std::move(result));
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
@@ -208,8 +236,12 @@ class DataLoaderBase {
   }
 
   /// Convenience method that creates a new sequencer based on the
-  /// `enforce_ordering` option.
+  /// `enforce_ordering` and `out_of_order_window` options.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> new_sequencer() {
+    if (options_.enforce_ordering && options_.out_of_order_window > 0) {
+      return torch::make_unique<detail::sequencers::BoundedSequencer<Result>>(
+          options_.max_jobs, options_.out_of_order_window);
+    }
     if (options_.enforce_ordering) {
       return torch::make_unique<detail::sequencers::OrderedSequencer<Result>>(
           options_.max_jobs);
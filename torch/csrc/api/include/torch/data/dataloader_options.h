@@ -34,9 +34,22 @@ struct DataLoaderOptions {
   /// you do not care about determinism.
   TORCH_ARG(bool, enforce_ordering) = true;
 
+  /// When `enforce_ordering` is set, the number of positions a batch may be
+  /// returned ahead of its order while the batches before it are still being
+  /// loaded. This keeps a single slow batch from stalling all batches behind
+  /// it, while bounding how far the order of batches may deviate. Zero (the
+  /// default) means strict ordering.
+  TORCH_ARG(size_t, out_of_order_window) = 0;
+
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// An optional device to move every batch to before it is returned. For a
+  /// CUDA device, worker threads copy the batches they fetched through pinned
+  /// memory on a side stream, so that the next batch is usually on the device
+  /// already when it is requested.
+  TORCH_ARG(optional<Device>, device);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,14 +65,18 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs_.value_or(2 * workers)),
         timeout(options.timeout_),
         enforce_ordering(options.enforce_ordering_),
-        drop_last(options.drop_last_) {}
+        out_of_order_window(options.out_of_order_window_),
+        drop_last(options.drop_last_),
+        device(options.device_) {}
 
   size_t batch_size;
   size_t workers;
   size_t max_jobs;
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
+  size_t out_of_order_window;
   bool drop_last;
+  optional<Device> device;
 };
 } // namespace data
 } // namespace torch
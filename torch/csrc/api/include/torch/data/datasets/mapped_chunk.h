@@ -0,0 +1,84 @@
+#pragma once
+
+#include <torch/data/datasets/chunk.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// A `ChunkDataReader` over binary shard files, one chunk per shard, which
+/// memory-maps the shards instead of reading them.
+///
+/// A shard holds the data of its examples back to back, as raw elements of a
+/// `dtype` in native byte order. The examples returned by the reader are
+/// views into the (private, copy-on-write) mapping of the shard, so reading a
+/// chunk doesn't copy any data, and the pages of a shard are only read from
+/// disk when its examples are first accessed. The mapping of a shard lives as
+/// long as any of its examples do, including while they are in the batch
+/// buffer of a `ChunkDataset`.
+///
+/// Examples are located either by a fixed `example_shape`, or by an index per
+/// shard. An index file holds the element offsets at which the examples of
+/// its shard start, followed by the total number of elements in them, all as
+/// int64 in native byte order. Examples located by an index are
+/// one-dimensional and may have different sizes.
+class TORCH_API MappedChunkDataReader : public ChunkDataReader<Tensor> {
+ public:
+  using BatchType = ChunkType;
+  using DataType = ExampleType;
+
+  /// Maps the shards at `paths`, each of which holds a whole number of
+  /// examples of shape `example_shape`.
+  MappedChunkDataReader(
+      const std::vector<std::string>& paths,
+      ScalarType dtype,
+      IntArrayRef example_shape);
+
+  /// Maps the shards at `paths` with the indices at `index_paths`, which has
+  /// to have one index per shard.
+  MappedChunkDataReader(
+      const std::vector<std::string>& paths,
+      const std::vector<std::string>& index_paths,
+      ScalarType dtype);
+
+  /// Returns views of all examples in the shard at `chunk_index`.
+  ChunkType read_chunk(size_t chunk_index) override;
+
+  /// Returns the number of shards.
+  size_t chunk_count() override;
+
+  /// The mappings are immutable, so there is no state to reset.
+  void reset() override;
+
+  /// Returns a view of a single example, without touching the other examples
+  /// of its shard.
+  Tensor get(size_t chunk_index, size_t example_index) const;
+
+  /// Returns the number of examples in the shard at `chunk_index`.
+  size_t example_count(size_t chunk_index) const;
+
+ private:
+  struct Shard {
+    /// The whole shard, as a flat tensor of its elements.
+    Tensor data;
+    /// The index of the shard, if examples are located by an index.
+    Tensor offsets;
+  };
+
+  const Shard& shard(size_t chunk_index) const;
+
+  std::vector<Shard> shards_;
+  /// The shape of each example, if examples have a fixed shape.
+  std::vector<int64_t> example_shape_;
+  int64_t example_numel_ = 0;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
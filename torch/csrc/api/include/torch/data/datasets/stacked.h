@@ -0,0 +1,89 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/ArrayRef.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace detail {
+inline Tensor allocate_stacked(const Tensor& prototype, size_t batch_size) {
+  std::vector<int64_t> sizes = {static_cast<int64_t>(batch_size)};
+  sizes.insert(sizes.end(), prototype.sizes().begin(), prototype.sizes().end());
+  return torch::empty(sizes, prototype.options());
+}
+
+inline Example<> allocate_batch(const Example<>& prototype, size_t batch_size) {
+  return {allocate_stacked(prototype.data, batch_size),
+          allocate_stacked(prototype.target, batch_size)};
+}
+
+inline TensorExample allocate_batch(
+    const TensorExample& prototype,
+    size_t batch_size) {
+  return allocate_stacked(prototype.data, batch_size);
+}
+
+inline Example<> batch_slot(const Example<>& batch, int64_t index) {
+  return {batch.data[index], batch.target[index]};
+}
+
+inline TensorExample batch_slot(const TensorExample& batch, int64_t index) {
+  return batch.data[index];
+}
+} // namespace detail
+
+/// A dataset of examples with a fixed shape, which yields its batches already
+/// stacked like the `Stack` transform does, without materializing each
+/// example on its own first.
+///
+/// Instead of returning an example from `get()`, a `StackedDataset` writes
+/// the example at an index into the slot of a batch tensor it is given, e.g.
+/// with `copy_()`, `fill_()` or through `data_ptr()`. `get_batch()` allocates
+/// the batch tensors once, and fills all slots of a batch in parallel using
+/// the intra-op thread pool, so `get_into()` has to be safe to call
+/// concurrently for different indices. Compared to a `Dataset` mapped with
+/// `Stack`, this saves an allocation per example and a full copy of every
+/// batch.
+///
+/// `ExampleType` can be `Example<>` or `TensorExample`.
+template <typename Self, typename SingleExample = Example<>>
+class StackedDataset : public BatchDataset<Self, SingleExample> {
+ public:
+  using ExampleType = SingleExample;
+
+  /// Returns an example whose tensors have the shape and options of the
+  /// tensors of every example. Only their metadata is used.
+  virtual ExampleType example_layout() = 0;
+
+  /// Writes the example at the given `index` into `slot`, whose tensors are
+  /// views of the batch tensors.
+  virtual void get_into(size_t index, ExampleType slot) = 0;
+
+  /// Returns a batch of data. Allocates the batch tensors and calls
+  /// `get_into()` for every requested index in the batch.
+  ExampleType get_batch(ArrayRef<size_t> indices) override {
+    auto batch = detail::allocate_batch(example_layout(), indices.size());
+    at::parallel_for(
+        /*begin=*/0,
+        /*end=*/indices.size(),
+        /*grain_size=*/1,
+        [this, &batch, &indices](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            get_into(indices[i], detail::batch_slot(batch, i));
+          }
+        });
+    return batch;
+  }
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
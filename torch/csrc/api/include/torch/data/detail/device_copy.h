@@ -0,0 +1,149 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+// Note [Prefetching batches to a device]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// When a DataLoader is configured with a CUDA `device`, every worker thread
+// copies the batches it fetched to that device itself, so that the copy of a
+// batch overlaps with the training step on the previous one instead of
+// running synchronously on the main thread. To do so, the worker
+//
+// - copies each tensor of the batch into pinned memory from the caching host
+//   allocator, which the CUDA copy needs to be asynchronous,
+// - issues the host-to-device copy with `non_blocking` on a side stream of its
+//   own, taken from the stream pool,
+// - records an event on that side stream after the last copy of the batch.
+//
+// When the main thread takes the batch out of `next()`, it makes the current
+// stream wait on that event (which does not block the host), and records the
+// current stream on the memory of the copied tensors, so that the caching
+// allocator doesn't hand their blocks out to the side stream again before the
+// work the main thread queued on them is done.
+//
+// The CUDA parts of this are only available when torch is built with CUDA,
+// and are registered at runtime, the same way the profiler's CUDA stubs are.
+
+/// The event marking that the copies of one batch are done.
+struct TORCH_API DeviceCopyFence {
+  virtual ~DeviceCopyFence() = default;
+
+  /// Makes the current stream wait for the copies, and marks the memory of
+  /// `tensors` as in use by the current stream.
+  virtual void wait(const std::vector<Tensor>& tensors) = 0;
+};
+
+/// The side stream that one worker thread copies its batches to the device
+/// on. Only ever used from that worker thread.
+struct TORCH_API DeviceCopyStream {
+  virtual ~DeviceCopyStream() = default;
+
+  /// Returns a copy of `tensor` on the device, coming from pinned memory.
+  /// The copy may still be in flight.
+  virtual Tensor copy(const Tensor& tensor) = 0;
+
+  /// Returns a fence for all the copies issued so far.
+  virtual std::unique_ptr<DeviceCopyFence> record() = 0;
+};
+
+using DeviceCopyStreamFactory = std::unique_ptr<DeviceCopyStream> (*)(Device);
+
+/// Registers the function that creates `DeviceCopyStream`s for CUDA devices.
+TORCH_API void register_device_copy_stream_factory(
+    DeviceCopyStreamFactory factory);
+
+/// Creates a `DeviceCopyStream` for the CUDA `device`. Throws if torch was
+/// not built with CUDA.
+TORCH_API std::unique_ptr<DeviceCopyStream> make_device_copy_stream(
+    Device device);
+
+// `for_each_tensor` calls `function` on each tensor of a batch, which may be a
+// tensor, an `Example` or a vector of either. Other batch types hold no
+// tensors as far as the DataLoader is concerned. These are all declared before
+// being defined so that they can find each other for nested batch types.
+
+template <typename Function>
+void for_each_tensor(Tensor& tensor, Function& function);
+template <typename Data, typename Target, typename Function>
+void for_each_tensor(Example<Data, Target>& example, Function& function);
+template <typename Data, typename Function>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    Function& function);
+template <typename T, typename Function>
+void for_each_tensor(std::vector<T>& batch, Function& function);
+template <typename T, typename Function>
+void for_each_tensor(T& batch, Function& function);
+
+template <typename Function>
+void for_each_tensor(Tensor& tensor, Function& function) {
+  if (tensor.defined()) {
+    function(tensor);
+  }
+}
+
+template <typename Data, typename Target, typename Function>
+void for_each_tensor(Example<Data, Target>& example, Function& function) {
+  for_each_tensor(example.data, function);
+  for_each_tensor(example.target, function);
+}
+
+template <typename Data, typename Function>
+void for_each_tensor(
+    Example<Data, example::NoTarget>& example,
+    Function& function) {
+  for_each_tensor(example.data, function);
+}
+
+template <typename T, typename Function>
+void for_each_tensor(std::vector<T>& batch, Function& function) {
+  for (auto& element : batch) {
+    for_each_tensor(element, function);
+  }
+}
+
+template <typename T, typename Function>
+void for_each_tensor(T& /*batch*/, Function& /*function*/) {}
+
+/// Moves all tensors of `batch` to `device`, synchronously.
+template <typename Batch>
+void move_to_device(Batch& batch, Device device) {
+  auto move = [device](Tensor& tensor) {
+    tensor = tensor.to(device, tensor.scalar_type());
+  };
+  for_each_tensor(batch, move);
+}
+
+/// Copies all tensors of `batch` to the device of `stream` asynchronously,
+/// and returns the fence the consumer of the batch has to wait on. See Note
+/// [Prefetching batches to a device].
+template <typename Batch>
+std::unique_ptr<DeviceCopyFence> copy_to_device(
+    Batch& batch,
+    DeviceCopyStream& stream) {
+  auto copy = [&stream](Tensor& tensor) { tensor = stream.copy(tensor); };
+  for_each_tensor(batch, copy);
+  return stream.record();
+}
+
+/// Waits on `fence` for the copies of all tensors of `batch`.
+template <typename Batch>
+void wait_for_device_copy(Batch& batch, DeviceCopyFence& fence) {
+  std::vector<Tensor> tensors;
+  auto collect = [&tensors](Tensor& tensor) { tensors.push_back(tensor); };
+  for_each_tensor(batch, collect);
+  fence.wait(tensors);
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -107,6 +107,102 @@ struct OrderedSequencer : public Sequencer<Result> {
   /// A fixed-size buffer (after construction).
   std::vector<optional<Result>> buffer_;
 };
+
+/// A `Sequencer` that returns results in order of their sequence number, but
+/// may return a result up to `window` positions before the results preceding
+/// it if those are not available yet. With a window of zero, this is the
+/// `OrderedSequencer`.
+///
+/// Let `s` be the lowest sequence number that was not returned yet. While the
+/// result for `s` is missing (e.g. because its batch was slow to load), any
+/// result with a sequence number in `[s, s + window]` is returned as soon as
+/// it is received, lowest sequence number first. Results further ahead are
+/// buffered. This bounds the head-of-line blocking of a single slow result to
+/// `window` results, while no result is ever returned more than `window`
+/// positions early.
+///
+/// Implementation note: Results that are returned early allow the
+/// `DataLoader` to schedule new jobs before `s` is received. All sequence
+/// numbers that are in flight or buffered are nevertheless within
+/// `[s, s + m + window)` (with `m` the maximum number of jobs), because at
+/// most `window` results after `s` were returned and at most `m` results are
+/// outstanding. A fixed-size buffer of `m + window` elements therefore never
+/// has collisions, like in the `OrderedSequencer`.
+template <typename Result>
+struct BoundedSequencer : public Sequencer<Result> {
+  using typename Sequencer<Result>::ResultProducer;
+
+  /// Constructs the `BoundedSequencer` with the maximum number of jobs in the
+  /// `DataLoader` and the maximum number of positions a result may be
+  /// returned early.
+  BoundedSequencer(size_t max_jobs, size_t window)
+      : window_(window),
+        buffer_(max_jobs + window),
+        returned_(max_jobs + window, false) {}
+
+  /// Returns the earliest result within the window, waiting for one if
+  /// necessary.
+  optional<Result> next(ResultProducer next_result) override {
+    // If we already have a result within the window, return it.
+    for (size_t sqn = oldest_sequence_number_;
+         sqn <= oldest_sequence_number_ + window_;
+         ++sqn) {
+      if (auto& maybe_result = buffer(sqn)) {
+        auto result = std::move(maybe_result);
+        maybe_result.reset();
+        mark_returned(sqn);
+        return result;
+      }
+    }
+    // Otherwise wait for the next result.
+    while (true) {
+      auto result = next_result();
+      if (!result) {
+        AT_ASSERT(!detail::buffer_contains_result(buffer_));
+        break;
+      }
+      const size_t sqn = result->sequence_number;
+      if (sqn <= oldest_sequence_number_ + window_) {
+        mark_returned(sqn);
+        return result;
+      }
+      // Stash the result for later.
+      AT_ASSERT(!buffer(sqn).has_value());
+      buffer(sqn) = std::move(result);
+    }
+    // The result was an empty optional, so we are done with this epoch.
+    return nullopt;
+  }
+
+  /// Records that the result for `sqn` was returned, and advances the oldest
+  /// sequence number past the results that were.
+  void mark_returned(size_t sqn) {
+    AT_ASSERT(sqn >= oldest_sequence_number_);
+    returned_.at(sqn % returned_.size()) = true;
+    while (returned_.at(oldest_sequence_number_ % returned_.size())) {
+      returned_.at(oldest_sequence_number_ % returned_.size()) = false;
+      ++oldest_sequence_number_;
+    }
+  }
+
+  /// Accesses the buffer at the `index` modulo the buffer size.
+  optional<Result>& buffer(size_t index) {
+    return buffer_.at(index % buffer_.size());
+  }
+
+  /// The maximum number of positions a result may be returned early.
+  size_t window_;
+
+  /// The lowest sequence number whose result was not returned yet.
+  size_t oldest_sequence_number_ = 0;
+
+  /// A fixed-size buffer (after construction).
+  std::vector<optional<Result>> buffer_;
+
+  /// Whether the result for a sequence number after
+  /// `oldest_sequence_number_` was already returned, indexed like `buffer_`.
+  std::vector<bool> returned_;
+};
 } // namespace sequencers
 } // namespace detail
 } // namespace data
@@ -16,6 +16,8 @@ struct Stack;
 
 /// A `Collation` for `Example<Tensor, Tensor>` types that stacks all data
 /// tensors into one tensor, and all target (label) tensors into one tensor.
+/// For datasets whose examples have a fixed shape, `datasets::StackedDataset`
+/// produces the same batches without allocating each example separately.
 template <>
 struct Stack<Example<>> : public Collation<Example<>> {
   Example<> apply_batch(std::vector<Example<>> examples) override {
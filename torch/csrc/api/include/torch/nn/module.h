@@ -7,10 +7,12 @@
 
 #include <ATen/ATen.h>
 
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <type_traits>
 
@@ -302,6 +304,23 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   /// Recursively zeros out the `grad` value of each registered parameter.
   virtual void zero_grad();
 
+  /// Moves the parameters of this `Module` and all its submodules into one
+  /// contiguous buffer, in the order of `parameters()`, and makes every
+  /// parameter a view into it. Their gradients become views into a second
+  /// buffer, which is attached as the `grad()` of the returned flat tensor.
+  /// An optimizer over the flat tensor then updates all parameters with single
+  /// kernels, and the gradients can be reduced in one collective. All
+  /// parameters must have the same dtype and device. Moving the module with
+  /// `to()` gives every parameter its own storage again.
+  ///
+  /// \rst
+  /// .. code-block:: cpp
+  ///
+  ///   auto flat = model->flatten_parameter_storage();
+  ///   torch::optim::SGD optimizer({flat}, /*lr=*/0.1);
+  /// \endrst
+  Tensor flatten_parameter_storage();
+
   /// Attempts to cast this `Module` to the given `ModuleType`.
   ///
   /// This method is useful when calling `apply()`.
@@ -510,6 +529,37 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   /// Returns a shared_ptr to `this` in a safe (checked) way.
   std::shared_ptr<Module> shared_from_this_checked() const;
 
+  /// Invalidates the cached results of the recursive accessors of every
+  /// `Module`. Must be called whenever parameters, buffers or submodules are
+  /// added or replaced.
+  static void invalidate_caches();
+
+  /// The cached results of the recursive `parameters()`, `named_parameters()`,
+  /// `buffers()` and `named_buffers()` calls. See Note [Module caches].
+  struct Cache {
+    Cache() = default;
+    // Copying a `Module` (as `Cloneable` does) replaces its state, so the
+    // copied-to cache starts out empty and every other cache is invalidated.
+    Cache(const Cache&) {
+      invalidate_caches();
+    }
+    Cache& operator=(const Cache&) {
+      invalidate_caches();
+      return *this;
+    }
+
+    std::mutex mutex;
+    /// The generation the cached values were computed in, 0 if never.
+    uint64_t generation = 0;
+    std::vector<Tensor> parameters;
+    OrderedDict<std::string, Tensor> named_parameters;
+    std::vector<Tensor> buffers;
+    OrderedDict<std::string, Tensor> named_buffers;
+  };
+
+  /// Recomputes `cache_` if it is stale. Requires `cache_.mutex` to be held.
+  void update_cache() const;
+
   /// The registered parameters of this `Module`.
   OrderedDict<std::string, Tensor> parameters_;
 
@@ -524,6 +574,8 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
 
   /// Whether the module is in training mode.
   bool is_training_{true};
+
+  mutable Cache cache_;
 };
 
 /// Serialize a `Module` pointer into an `OutputArchive`.
@@ -573,6 +625,7 @@ std::shared_ptr<ModuleType> Module::register_module(
       name,
       "')");
   auto& base_module = children_.insert(std::move(name), std::move(module));
+  invalidate_caches();
   return std::dynamic_pointer_cast<ModuleType>(base_module);
 }
 
@@ -4,8 +4,10 @@
 #include <torch/nn/module.h>
 #include <torch/nn/pimpl.h>
 #include <torch/types.h>
+#include <torch/utils.h>
 
 #include <torch/csrc/autograd/functions/comm.h>
+#include <torch/csrc/autograd/variable.h>
 #ifdef USE_CUDA
 #include <torch/csrc/cuda/comm.h>
 #endif
@@ -17,9 +19,11 @@
 #include <c10/util/Exception.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace torch {
@@ -54,6 +58,110 @@ std::vector<ModuleHolder<ModuleType>> replicate(
   return std::vector<ModuleHolder<ModuleType>>(ptrs.begin(), ptrs.end());
 }
 
+namespace detail {
+/// Returns the list of all available CUDA devices.
+inline std::vector<Device> all_cuda_devices() {
+  const auto device_count = torch::cuda::device_count();
+  TORCH_CHECK(
+      device_count > 0, "Expected at least one CUDA device to be available");
+  std::vector<Device> devices;
+  devices.reserve(device_count);
+  for (size_t index = 0; index < device_count; ++index) {
+    devices.emplace_back(kCUDA, index);
+  }
+  return devices;
+}
+} // namespace detail
+
+/// Keeps the replicas of a module on the given list of devices alive across
+/// calls to `data_parallel()`, instead of cloning the module on every call.
+/// If `devices` is not supplied, the module is replicated on all available
+/// CUDA devices.
+///
+/// The parameters and buffers of the module are copied into the replicas
+/// when `replicas()` is called, but only those that were modified since the
+/// previous call, which is detected with their version counters. Modifying
+/// the structure of the module (e.g. registering new parameters) after the
+/// cache was created is not supported.
+template <typename ModuleType>
+class ReplicaCache {
+ public:
+  using Replicas = decltype(replicate(
+      std::declval<const ModuleType&>(),
+      std::declval<const std::vector<Device>&>()));
+
+  explicit ReplicaCache(
+      ModuleType module,
+      optional<std::vector<Device>> devices = nullopt)
+      : module_(std::move(module)),
+        devices_(devices ? std::move(*devices) : detail::all_cuda_devices()) {
+    TORCH_CHECK(!devices_.empty(), "Expected at least one device");
+    replicas_ = replicate(module_, devices_);
+    versions_ = current_versions();
+  }
+
+  /// Returns the replicas, after copying the parameters and buffers of the
+  /// module that were modified since the previous call into them.
+  Replicas& replicas() {
+    auto versions = current_versions();
+    auto tensors = module_tensors(*module_);
+    std::vector<size_t> modified;
+    for (size_t i = 0; i < versions.size(); ++i) {
+      if (versions[i] != versions_[i]) {
+        modified.push_back(i);
+      }
+    }
+    if (!modified.empty()) {
+      NoGradGuard guard;
+      for (auto& replica : replicas_) {
+        auto replica_tensors = module_tensors(*replica);
+        for (const auto i : modified) {
+          replica_tensors[i].copy_(tensors[i], /*non_blocking=*/true);
+        }
+      }
+    }
+    versions_ = std::move(versions);
+    return replicas_;
+  }
+
+  const ModuleType& module() const noexcept {
+    return module_;
+  }
+
+  const std::vector<Device>& devices() const noexcept {
+    return devices_;
+  }
+
+ private:
+  /// Returns the parameters followed by the buffers of a module, which are in
+  /// the same order for the module and its replicas.
+  static std::vector<Tensor> module_tensors(const Module& module) {
+    auto tensors = module.parameters();
+    auto buffers = module.buffers();
+    tensors.insert(tensors.end(), buffers.begin(), buffers.end());
+    return tensors;
+  }
+
+  std::vector<uint32_t> current_versions() const {
+    auto tensors = module_tensors(*module_);
+    TORCH_CHECK(
+        versions_.empty() || tensors.size() == versions_.size(),
+        "The parameters or buffers of a module were changed after its "
+        "ReplicaCache was created");
+    std::vector<uint32_t> versions;
+    versions.reserve(tensors.size());
+    for (auto& tensor : tensors) {
+      versions.push_back(autograd::as_variable_ref(tensor).current_version());
+    }
+    return versions;
+  }
+
+  ModuleType module_;
+  std::vector<Device> devices_;
+  Replicas replicas_;
+  std::vector<uint32_t> versions_;
+};
+
 /// Applies the given inputs to the given modules in a parallel fashion.
 /// Conceptually, a thread is spawned for each `(module, input)` pair, in which
 /// `forward()` is called on the module with its corresponding input. The
@@ -139,14 +247,7 @@ Tensor data_parallel(
     optional<Device> output_device = nullopt,
     int64_t dim = 0) {
   if (!devices) {
-    const auto device_count = torch::cuda::device_count();
-    TORCH_CHECK(
-        device_count > 0, "Expected at least one CUDA device to be available");
-    devices = std::vector<Device>();
-    devices->reserve(device_count);
-    for (size_t index = 0; index < device_count; ++index) {
-      devices->emplace_back(kCUDA, index);
-    }
+    devices = detail::all_cuda_devices();
   }
   if (!output_device) {
     output_device = devices->front();
@@ -173,6 +274,40 @@ Tensor data_parallel(
 #endif
 }
 
+/// Evaluates `module(input)` in parallel across the devices of the given
+/// `ReplicaCache`, like the `data_parallel()` overload above, but with the
+/// replicas kept by the cache instead of replicas cloned for this call.
+template <typename ModuleType>
+Tensor data_parallel(
+    ReplicaCache<ModuleType>& cache,
+    Tensor input,
+    optional<Device> output_device = nullopt,
+    int64_t dim = 0) {
+  const auto& devices = cache.devices();
+  if (!output_device) {
+    output_device = devices.front();
+  }
+
+  if (devices.size() == 1) {
+    auto& replica = cache.replicas().front();
+    input = input.to(devices.front());
+    return replica->forward(std::move(input)).to(*output_device);
+  }
+
+#ifdef USE_CUDA
+  autograd::Scatter scatter(devices, /*chunk_sizes=*/nullopt, dim);
+  auto scattered_inputs = fmap<Tensor>(scatter.apply({std::move(input)}));
+
+  auto outputs = parallel_apply(cache.replicas(), scattered_inputs, devices);
+  return autograd::Gather(*output_device, dim)
+      .apply(fmap<autograd::Variable>(std::move(outputs)))
+      .front();
+#else
+  AT_ERROR("data_parallel not supported without CUDA");
+  return Tensor();
+#endif
+}
+
 } // namespace parallel
 } // namespace nn
 } // namespace torch
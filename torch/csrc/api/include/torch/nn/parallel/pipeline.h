@@ -0,0 +1,135 @@
+#pragma once
+
+#include <torch/nn/modules/sequential.h>
+#include <torch/types.h>
+
+#include <ATen/Device.h>
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace nn {
+namespace parallel {
+
+/// Evaluates a `Sequential` that is split into stages on different devices,
+/// pipelining micro-batches through the stages.
+///
+/// The modules of the `Sequential` are split into consecutive stages, where
+/// stage `i` holds the next `balance[i]` modules and is moved to `devices[i]`.
+/// `forward()` splits its input into `chunks` micro-batches along the first
+/// dimension and feeds every micro-batch through the stages. While a stage
+/// computes a micro-batch, the previous stage already computes the next one,
+/// so all devices but the first and the last are busy once the pipeline is
+/// full. With `N` stages and `M` micro-batches, a device is busy during `M` of
+/// the `M + N - 1` steps of the pipeline, so more micro-batches mean a higher
+/// utilization, at the cost of smaller kernels. The outputs of the
+/// micro-batches are concatenated on the device of the last stage.
+///
+/// Pipelining does not need one thread per stage. Kernels and copies between
+/// devices are enqueued asynchronously on the current stream of every device,
+/// so the micro-batches are issued from the calling thread, and the devices
+/// execute them concurrently. The backward pass is pipelined as well, since
+/// the autograd engine executes the backward functions of every device on a
+/// thread of its own.
+///
+/// Modules that depend on the whole batch (e.g. `BatchNorm`) only see a
+/// micro-batch at a time.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   torch::nn::Sequential sequential(
+///     torch::nn::Linear(3, 4),
+///     torch::nn::Functional(torch::relu),
+///     torch::nn::Linear(4, 5));
+///
+///   torch::nn::parallel::Pipeline pipeline(
+///     sequential,
+///     /*devices=*/{torch::Device("cuda:0"), torch::Device("cuda:1")},
+///     /*balance=*/{2, 1},
+///     /*chunks=*/4);
+///
+///   auto output = pipeline.forward(torch::ones({64, 3}));
+///
+/// \endrst
+class Pipeline {
+ public:
+  Pipeline(
+      const Sequential& sequential,
+      std::vector<Device> devices,
+      const std::vector<size_t>& balance,
+      size_t chunks)
+      : devices_(std::move(devices)), chunks_(chunks) {
+    TORCH_CHECK(!devices_.empty(), "Expected at least one pipeline stage");
+    TORCH_CHECK(
+        balance.size() == devices_.size(),
+        "Must have as many balance entries as devices");
+    TORCH_CHECK(
+        std::accumulate(balance.begin(), balance.end(), size_t(0)) ==
+            sequential->size(),
+        "The balance must sum up to the number of modules in the Sequential ",
+        "(expected ",
+        sequential->size(),
+        ")");
+    TORCH_CHECK(chunks_ > 0, "Expected at least one micro-batch");
+
+    auto module = sequential->begin();
+    for (size_t stage = 0; stage < devices_.size(); ++stage) {
+      TORCH_CHECK(balance[stage] > 0, "Every stage must hold a module");
+      Sequential stage_modules;
+      for (size_t i = 0; i < balance[stage]; ++i, ++module) {
+        stage_modules->push_back(*module);
+      }
+      stage_modules->to(devices_[stage]);
+      stages_.push_back(std::move(stage_modules));
+    }
+  }
+
+  /// Evaluates the stages on `input`, one micro-batch at a time, and returns
+  /// the concatenated outputs on the device of the last stage.
+  Tensor forward(const Tensor& input) {
+    auto micro_batches = input.chunk(chunks_, /*dim=*/0);
+    const size_t num_micro_batches = micro_batches.size();
+    const size_t num_stages = stages_.size();
+
+    // At every step of the pipeline, stage `i` computes micro-batch
+    // `step - i`, whose input the previous stage computed at the previous
+    // step.
+    for (size_t step = 0; step < num_micro_batches + num_stages - 1; ++step) {
+      for (size_t stage = 0; stage < num_stages; ++stage) {
+        if (step < stage || step - stage >= num_micro_batches) {
+          continue;
+        }
+        auto& micro_batch = micro_batches[step - stage];
+        micro_batch = stages_[stage]->forward(micro_batch.to(
+            devices_[stage],
+            micro_batch.scalar_type(),
+            /*non_blocking=*/true));
+      }
+    }
+    return torch::cat(micro_batches, /*dim=*/0);
+  }
+
+  /// Returns the stages, each of which is a `Sequential` that shares its
+  /// modules with the `Sequential` the pipeline was created from.
+  const std::vector<Sequential>& stages() const noexcept {
+    return stages_;
+  }
+
+  const std::vector<Device>& devices() const noexcept {
+    return devices_;
+  }
+
+ private:
+  std::vector<Sequential> stages_;
+  std::vector<Device> devices_;
+  size_t chunks_;
+};
+
+} // namespace parallel
+} // namespace nn
+} // namespace torch
@@ -36,6 +36,21 @@ class TORCH_API Adagrad : public Optimizer {
 
   void step() override;
 
+  /// Takes a step for the parameter `weight` as `step()` would for the
+  /// gradient of `embedding_bag(weight, indices, offsets, mode,
+  /// per_sample_weights)` (`mode` 0 for sum and 1 for mean), given the
+  /// gradient `grad` of its output. The gradient of `weight` is never formed:
+  /// only the rows of `weight` used by the bags are read and updated, in
+  /// place. This is the sparse Adagrad of caffe2, and requires a float CPU
+  /// `weight` and no weight decay.
+  void step_embedding_bag(
+      const Tensor& weight,
+      const Tensor& grad,
+      const Tensor& indices,
+      const Tensor& offsets,
+      int64_t mode = 0,
+      const Tensor& per_sample_weights = {});
+
   AdagradOptions options;
 
   void save(serialize::OutputArchive& archive) const override;
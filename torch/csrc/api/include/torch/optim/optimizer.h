@@ -44,6 +44,16 @@ class TORCH_API OptimizerBase {
   /// Zeros out the gradients of all parameters.
   virtual void zero_grad();
 
+  /// Zeros out the gradients of all parameters, or resets them to undefined
+  /// tensors if `set_to_none` is true. With undefined gradients the next
+  /// backward pass writes its gradients instead of adding them to zeros,
+  /// which saves a pass over the gradient memory per step, and steps skip
+  /// parameters whose gradients are still undefined. Gradients that are views
+  /// into a shared buffer (see `Module::flatten_parameter_storage()`) lose
+  /// that sharing when reset, so keep `set_to_none` false for those; adjacent
+  /// views of one buffer are zeroed with a single kernel.
+  void zero_grad(bool set_to_none);
+
   /// Provides a const reference to the parameters this optimizer holds.
   const std::vector<Tensor>& parameters() const noexcept;
 
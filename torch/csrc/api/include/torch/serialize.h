@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/serialize/archive.h>
+#include <torch/serialize/sharded.h>
 #include <torch/serialize/tensor.h>
 
 #include <utility>
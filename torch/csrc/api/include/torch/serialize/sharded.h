@@ -0,0 +1,148 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace caffe2 {
+namespace serialize {
+class AsyncPyTorchStreamWriter;
+class PyTorchStreamReader;
+} // namespace serialize
+} // namespace caffe2
+
+namespace torch {
+namespace serialize {
+
+// Note [Sharded checkpoints]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// A sharded checkpoint at `path` consists of one shard file per rank, at
+// `path + "." + rank`, and a manifest at `path` itself. Every rank writes its
+// own shard file with a `ShardWriter`, independently of and in parallel with
+// the other ranks, so no rank ever has to gather the whole state in memory.
+//
+// A shard file is a regular PyTorchStreamWriter archive. It holds each tensor
+// the rank wrote as a record with its raw data, in native byte order, and an
+// `index` record describing where each of these tensors lies in its full
+// (global) tensor. Tensors are split along their first dimension: a rank holds
+// a contiguous range of rows of a tensor. A tensor that every rank holds all of
+// is simply a range that covers all rows, on every rank.
+//
+// Once all ranks have finished writing, `write_sharded_manifest` (e.g. called
+// on rank 0 after a barrier) merges the indices of all shard files into the
+// manifest. This only reads the small index records.
+//
+// `ShardedCheckpoint` reads a checkpoint from its manifest. It can return any
+// range of rows of a tensor, and only reads the shards that overlap with that
+// range, so a job can load a checkpoint onto any number of ranks, not just the
+// number it was saved from.
+
+/// Where the tensor one rank wrote lies in its full tensor.
+struct TORCH_API ShardMetadata {
+  /// The rank that wrote the shard.
+  int64_t rank = 0;
+  /// The sizes of the full tensor.
+  std::vector<int64_t> sizes;
+  ScalarType dtype = ScalarType::Float;
+  /// The first row of the full tensor the shard holds.
+  int64_t offset = 0;
+  /// The number of rows the shard holds.
+  int64_t length = 0;
+};
+
+/// Writes the shard file of one rank of a sharded checkpoint. See Note
+/// [Sharded checkpoints].
+///
+/// The records are written from a background thread, so `write()` only blocks
+/// for as long as it takes to copy the tensor to (CPU) memory.
+class TORCH_API ShardWriter final {
+ public:
+  /// Creates the shard file for `rank` of the checkpoint at `path`.
+  ShardWriter(const std::string& path, int64_t rank);
+  ~ShardWriter();
+
+  ShardWriter(const ShardWriter&) = delete;
+  ShardWriter& operator=(const ShardWriter&) = delete;
+
+  /// Writes `shard` as the rows `[offset, offset + shard.size(0))` of the
+  /// tensor `key`, whose full sizes are `sizes`.
+  void write(
+      const std::string& key,
+      const Tensor& shard,
+      int64_t offset,
+      IntArrayRef sizes);
+
+  /// Writes all of the tensor `key`.
+  void write(const std::string& key, const Tensor& tensor);
+
+  /// Writes the index and finishes the shard file, waiting for all records to
+  /// be written.
+  void finish();
+
+ private:
+  std::unique_ptr<caffe2::serialize::AsyncPyTorchStreamWriter> writer_;
+  int64_t rank_;
+  std::map<std::string, ShardMetadata> index_;
+};
+
+/// Writes the manifest of the checkpoint at `path`, from the shard files that
+/// ranks `0` to `world_size - 1` finished writing.
+TORCH_API void write_sharded_manifest(
+    const std::string& path,
+    int64_t world_size);
+
+/// Reads tensors, or rows of tensors, from a sharded checkpoint. See Note
+/// [Sharded checkpoints].
+class TORCH_API ShardedCheckpoint final {
+ public:
+  /// Reads the manifest of the checkpoint at `path`.
+  explicit ShardedCheckpoint(std::string path);
+  ~ShardedCheckpoint();
+
+  ShardedCheckpoint(const ShardedCheckpoint&) = delete;
+  ShardedCheckpoint& operator=(const ShardedCheckpoint&) = delete;
+
+  /// Returns the number of ranks the checkpoint was written by.
+  int64_t world_size() const;
+
+  /// Returns the keys of all tensors in the checkpoint, in sorted order.
+  std::vector<std::string> keys() const;
+
+  /// Returns whether the checkpoint has a tensor at `key`.
+  bool contains(const std::string& key) const;
+
+  /// Returns the sizes of the full tensor at `key`.
+  std::vector<int64_t> sizes(const std::string& key) const;
+
+  /// Reads the rows `[begin, end)` of the tensor at `key`.
+  Tensor read(const std::string& key, int64_t begin, int64_t end);
+
+  /// Reads all of the tensor at `key`.
+  Tensor read(const std::string& key);
+
+  /// Reads the rows of the tensor at `key` that `rank` holds when the tensor
+  /// is split into `world_size` parts the way `torch::chunk` splits it, which
+  /// may differ from the number of ranks the checkpoint was written by. Like
+  /// `torch::chunk`, this may return no rows for the last ranks.
+  Tensor read_shard(const std::string& key, int64_t rank, int64_t world_size);
+
+ private:
+  caffe2::serialize::PyTorchStreamReader& shard_reader(int64_t rank);
+
+  std::string path_;
+  int64_t world_size_ = 0;
+  /// The shards of each tensor, ordered by their offset.
+  std::map<std::string, std::vector<ShardMetadata>> shards_;
+  /// The shard files opened so far, by rank.
+  std::map<int64_t, std::unique_ptr<caffe2::serialize::PyTorchStreamReader>>
+      readers_;
+};
+} // namespace serialize
+} // namespace torch
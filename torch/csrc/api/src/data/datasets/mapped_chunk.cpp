@@ -0,0 +1,168 @@
+#include <torch/data/datasets/mapped_chunk.h>
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+/// Maps the file at `path` as a flat tensor of `dtype` elements.
+Tensor map_file(const std::string& path, ScalarType dtype) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  TORCH_CHECK(file, "Error opening shard file at ", path);
+  const int64_t bytes = file.tellg();
+  const int64_t element_size = c10::elementSize(dtype);
+  TORCH_CHECK(
+      bytes % element_size == 0,
+      "Expected the size of ",
+      path,
+      " to be a multiple of ",
+      element_size,
+      " bytes, but it is ",
+      bytes,
+      " bytes");
+  if (bytes == 0) {
+    // Empty files can't be mapped.
+    return torch::empty({0}, torch::dtype(dtype));
+  }
+  return torch::from_file(
+      path, /*shared=*/false, bytes / element_size, torch::dtype(dtype));
+}
+} // namespace
+
+MappedChunkDataReader::MappedChunkDataReader(
+    const std::vector<std::string>& paths,
+    ScalarType dtype,
+    IntArrayRef example_shape)
+    : example_shape_(example_shape.vec()) {
+  example_numel_ = 1;
+  for (auto size : example_shape_) {
+    TORCH_CHECK(size >= 0, "Invalid example shape ", example_shape);
+    example_numel_ *= size;
+  }
+  TORCH_CHECK(example_numel_ > 0, "Examples can't be empty");
+  shards_.reserve(paths.size());
+  for (const auto& path : paths) {
+    auto data = map_file(path, dtype);
+    TORCH_CHECK(
+        data.numel() % example_numel_ == 0,
+        "Shard ",
+        path,
+        " doesn't hold a whole number of examples of shape ",
+        example_shape);
+    shards_.push_back({std::move(data), Tensor()});
+  }
+}
+
+MappedChunkDataReader::MappedChunkDataReader(
+    const std::vector<std::string>& paths,
+    const std::vector<std::string>& index_paths,
+    ScalarType dtype) {
+  TORCH_CHECK(
+      paths.size() == index_paths.size(),
+      "Expected one index per shard, but got ",
+      paths.size(),
+      " shards and ",
+      index_paths.size(),
+      " indices");
+  shards_.reserve(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto data = map_file(paths[i], dtype);
+    auto offsets = map_file(index_paths[i], kLong);
+    TORCH_CHECK(
+        offsets.numel() > 0,
+        "The index ",
+        index_paths[i],
+        " needs to end with the number of elements in its examples");
+    const int64_t end = offsets[offsets.numel() - 1].item<int64_t>();
+    TORCH_CHECK(
+        end >= 0 && end <= data.numel(),
+        "The index ",
+        index_paths[i],
+        " refers to ",
+        end,
+        " elements, but shard ",
+        paths[i],
+        " only holds ",
+        data.numel());
+    shards_.push_back({std::move(data), std::move(offsets)});
+  }
+}
+
+MappedChunkDataReader::ChunkType MappedChunkDataReader::read_chunk(
+    size_t chunk_index) {
+  const auto count = example_count(chunk_index);
+  ChunkType examples;
+  examples.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    examples.push_back(get(chunk_index, i));
+  }
+  return examples;
+}
+
+size_t MappedChunkDataReader::chunk_count() {
+  return shards_.size();
+}
+
+void MappedChunkDataReader::reset() {}
+
+Tensor MappedChunkDataReader::get(size_t chunk_index, size_t example_index)
+    const {
+  const auto& shard = this->shard(chunk_index);
+  TORCH_CHECK(
+      example_index < example_count(chunk_index),
+      "Example ",
+      example_index,
+      " is out of range for chunk ",
+      chunk_index);
+  const int64_t index = example_index;
+  if (!shard.offsets.defined()) {
+    return shard.data.narrow(0, index * example_numel_, example_numel_)
+        .view(example_shape_);
+  }
+  // The index is mapped too, so this only reads the two offsets we need.
+  const auto* offsets = shard.offsets.data<int64_t>();
+  const int64_t begin = offsets[index];
+  const int64_t end = offsets[index + 1];
+  TORCH_CHECK(
+      0 <= begin && begin <= end && end <= shard.data.numel(),
+      "Invalid offsets [",
+      begin,
+      ", ",
+      end,
+      ") for example ",
+      example_index,
+      " of chunk ",
+      chunk_index);
+  return shard.data.narrow(0, begin, end - begin);
+}
+
+size_t MappedChunkDataReader::example_count(size_t chunk_index) const {
+  const auto& shard = this->shard(chunk_index);
+  if (!shard.offsets.defined()) {
+    return shard.data.numel() / example_numel_;
+  }
+  return shard.offsets.numel() - 1;
+}
+
+const MappedChunkDataReader::Shard& MappedChunkDataReader::shard(
+    size_t chunk_index) const {
+  TORCH_CHECK(
+      chunk_index < shards_.size(),
+      "Chunk ",
+      chunk_index,
+      " is out of range for ",
+      shards_.size(),
+      " shards");
+  return shards_[chunk_index];
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,35 @@
+#include <torch/data/detail/device_copy.h>
+
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <memory>
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+std::atomic<DeviceCopyStreamFactory> device_copy_stream_factory{nullptr};
+} // namespace
+
+void register_device_copy_stream_factory(DeviceCopyStreamFactory factory) {
+  device_copy_stream_factory.store(factory);
+}
+
+std::unique_ptr<DeviceCopyStream> make_device_copy_stream(Device device) {
+  TORCH_CHECK(
+      device.is_cuda(),
+      "DataLoader can only prefetch batches asynchronously to CUDA devices, "
+      "but got device ",
+      device);
+  auto factory = device_copy_stream_factory.load();
+  TORCH_CHECK(
+      factory != nullptr,
+      "DataLoader was configured to prefetch batches to ",
+      device,
+      ", but torch was not compiled with CUDA");
+  return factory(device);
+}
+} // namespace detail
+} // namespace data
+} // namespace torch
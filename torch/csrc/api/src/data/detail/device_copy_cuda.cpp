@@ -0,0 +1,83 @@
+#include <torch/data/detail/device_copy.h>
+
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+
+// See Note [Prefetching batches to a device]
+struct CUDACopyFence : public DeviceCopyFence {
+  explicit CUDACopyFence(const c10::cuda::CUDAStream& stream) {
+    event_.record(stream);
+  }
+
+  void wait(const std::vector<Tensor>& tensors) override {
+    c10::cuda::CUDAGuard device_guard(event_.device_index());
+    auto stream = c10::cuda::getCurrentCUDAStream();
+    event_.block(stream);
+    for (const auto& tensor : tensors) {
+      if (tensor.is_cuda()) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            tensor.storage().data(), stream);
+      }
+    }
+  }
+
+  at::cuda::CUDAEvent event_;
+};
+
+struct CUDACopyStream : public DeviceCopyStream {
+  explicit CUDACopyStream(Device device)
+      : device_(device),
+        stream_(c10::cuda::getStreamFromPool(
+            /*isHighPriority=*/false,
+            device.index())) {}
+
+  Tensor copy(const Tensor& tensor) override {
+    if (tensor.device() == device_) {
+      return tensor;
+    }
+    // The copies allocate their memory on the side stream.
+    c10::cuda::CUDAStreamGuard stream_guard(stream_);
+    if (tensor.is_cuda()) {
+      return tensor.to(device_, tensor.scalar_type(), /*non_blocking=*/true);
+    }
+    return tensor.pin_memory().to(
+        device_, tensor.scalar_type(), /*non_blocking=*/true);
+  }
+
+  std::unique_ptr<DeviceCopyFence> record() override {
+    return std::unique_ptr<DeviceCopyFence>(new CUDACopyFence(stream_));
+  }
+
+  Device device_;
+  c10::cuda::CUDAStream stream_;
+};
+
+std::unique_ptr<DeviceCopyStream> make_cuda_copy_stream(Device device) {
+  if (!device.has_index()) {
+    device = Device(kCUDA, c10::cuda::current_device());
+  }
+  return std::unique_ptr<DeviceCopyStream>(new CUDACopyStream(device));
+}
+
+struct RegisterCUDACopyStream {
+  RegisterCUDACopyStream() {
+    register_device_copy_stream_factory(make_cuda_copy_stream);
+  }
+};
+RegisterCUDACopyStream reg;
+
+} // namespace
+} // namespace detail
+} // namespace data
+} // namespace torch
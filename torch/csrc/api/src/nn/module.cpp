@@ -7,6 +7,7 @@
 #include <c10/util/Exception.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <map>
 #include <ostream>
@@ -41,6 +42,22 @@ void extend(
     vector.push_back(item.value());
   }
 }
+
+// Note [Module caches]
+// ~~~~~~~~~~~~~~~~~~~~
+// The recursive accessors (`parameters()`, `named_parameters()`, `buffers()`
+// and `named_buffers()`) walk the whole submodule tree and rebuild their
+// result, joining every key, on each call. Each module caches these results
+// instead, tagged with the value of a global generation counter at the time
+// they were computed. A module doesn't know its parents, so rather than
+// invalidating the caches along the path to the root, every change to any
+// module's parameters, buffers or submodules bumps the global counter, which
+// invalidates all caches at once. Such changes are rare after construction, so
+// the spurious invalidations of unrelated modules are cheap.
+//
+// Replacing the *data* of a parameter (e.g. through `to()` or `set_data()`)
+// keeps the same Variable, so it doesn't need to invalidate anything.
+std::atomic<uint64_t> cache_generation{1};
 } // namespace
 
 Module::Module()
@@ -144,44 +161,35 @@ std::vector<Tensor> Module::parameters(bool recurse) const {
   if (!recurse) {
     return parameters_.values();
   }
-  std::vector<Tensor> result;
-  apply(
-      [&result](const Module& module) { extend(result, module.parameters_); });
-  return result;
+  std::lock_guard<std::mutex> guard(cache_.mutex);
+  update_cache();
+  return cache_.parameters;
 }
 
 OrderedDict<std::string, Tensor> Module::named_parameters(bool recurse) const {
   if (!recurse) {
     return parameters_;
   }
-  OrderedDict<std::string, Tensor> result;
-  apply([&result](const std::string& name, const Module& module) {
-    for (const auto& parameter : module.parameters_) {
-      result.insert(join_name(name, parameter.key()), parameter.value());
-    }
-  });
-  return result;
+  std::lock_guard<std::mutex> guard(cache_.mutex);
+  update_cache();
+  return cache_.named_parameters;
 }
 
 std::vector<Tensor> Module::buffers(bool recurse) const {
   if (!recurse) {
     return buffers_.values();
   }
-  std::vector<Tensor> result;
-  apply([&result](const Module& module) { extend(result, module.buffers_); });
-  return result;
+  std::lock_guard<std::mutex> guard(cache_.mutex);
+  update_cache();
+  return cache_.buffers;
 }
 OrderedDict<std::string, Tensor> Module::named_buffers(bool recurse) const {
   if (!recurse) {
     return buffers_;
   }
-  OrderedDict<std::string, Tensor> result;
-  apply([&result](const std::string& name, const Module& module) {
-    for (const auto& buffer : module.buffers_) {
-      result.insert(join_name(name, buffer.key()), buffer.value());
-    }
-  });
-  return result;
+  std::lock_guard<std::mutex> guard(cache_.mutex);
+  update_cache();
+  return cache_.named_buffers;
 }
 
 std::vector<std::shared_ptr<Module>> Module::modules(bool include_self) const {
@@ -270,6 +278,41 @@ void Module::zero_grad() {
   }
 }
 
+Tensor Module::flatten_parameter_storage() {
+  NoGradGuard no_grad;
+  const auto parameters = this->parameters();
+  if (parameters.empty()) {
+    return Tensor();
+  }
+  int64_t numel = 0;
+  for (const auto& parameter : parameters) {
+    TORCH_CHECK(
+        parameter.dtype() == parameters.front().dtype() &&
+            parameter.device() == parameters.front().device(),
+        "flatten_parameter_storage() requires all parameters to have the same "
+        "dtype and device");
+    numel += parameter.numel();
+  }
+  auto options = parameters.front().options().requires_grad(false);
+  auto flat = torch::empty({numel}, options);
+  auto flat_grad = torch::zeros({numel}, options);
+  int64_t offset = 0;
+  for (auto parameter : parameters) {
+    const auto size = parameter.numel();
+    auto data = flat.narrow(0, offset, size).view(parameter.sizes());
+    data.copy_(parameter);
+    auto grad = flat_grad.narrow(0, offset, size).view(parameter.sizes());
+    if (parameter.grad().defined()) {
+      grad.copy_(parameter.grad());
+    }
+    parameter.set_data(autograd::Variable(data).data());
+    parameter.grad() = grad;
+    offset += size;
+  }
+  flat.grad() = flat_grad;
+  return flat;
+}
+
 void Module::save(serialize::OutputArchive& archive) const {
   for (const auto& parameter : parameters_) {
     archive.write(parameter.key(), parameter.value());
@@ -300,6 +343,8 @@ void Module::load(serialize::InputArchive& archive) {
       child.value()->load(child_archive);
     }
   }
+  // Reading into an undefined tensor replaces it.
+  invalidate_caches();
 }
 
 bool Module::is_serializable() const {
@@ -317,7 +362,9 @@ Tensor& Module::register_parameter(
       name,
       "')");
   tensor.set_requires_grad(requires_grad);
-  return parameters_.insert(std::move(name), std::move(tensor));
+  auto& parameter = parameters_.insert(std::move(name), std::move(tensor));
+  invalidate_caches();
+  return parameter;
 }
 
 Tensor& Module::register_buffer(std::string name, Tensor tensor) {
@@ -327,7 +374,9 @@ Tensor& Module::register_buffer(std::string name, Tensor tensor) {
       "Buffer name must not contain a dot (got '",
       name,
       "')");
-  return buffers_.insert(std::move(name), std::move(tensor));
+  auto& buffer = buffers_.insert(std::move(name), std::move(tensor));
+  invalidate_caches();
+  return buffer;
 }
 
 void Module::pretty_print(std::ostream& stream) const {
@@ -362,6 +411,36 @@ void Module::apply_to_submodules(
   }
 }
 
+void Module::invalidate_caches() {
+  ++cache_generation;
+}
+
+void Module::update_cache() const {
+  const uint64_t generation = cache_generation.load();
+  if (cache_.generation == generation) {
+    return;
+  }
+  cache_.parameters.clear();
+  cache_.named_parameters.clear();
+  cache_.buffers.clear();
+  cache_.named_buffers.clear();
+  apply([this](const std::string& name, const Module& module) {
+    extend(cache_.parameters, module.parameters_);
+    for (const auto& parameter : module.parameters_) {
+      cache_.named_parameters.insert(
+          join_name(name, parameter.key()), parameter.value());
+    }
+    extend(cache_.buffers, module.buffers_);
+    for (const auto& buffer : module.buffers_) {
+      cache_.named_buffers.insert(
+          join_name(name, buffer.key()), buffer.value());
+    }
+  });
+  // Tag with the generation read before the walk, so that concurrent changes
+  // leave the cache stale instead of silently missing them.
+  cache_.generation = generation;
+}
+
 std::shared_ptr<Module> Module::shared_from_this_checked() const {
   std::shared_ptr<const Module> ptr;
   try {
@@ -6,6 +6,7 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <functional>
 
 namespace torch {
@@ -40,6 +41,43 @@ void Adagrad::step() {
   }
 }
 
+void Adagrad::step_embedding_bag(
+    const Tensor& weight,
+    const Tensor& grad,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const Tensor& per_sample_weights) {
+  const auto it = std::find_if(
+      parameters_.begin(), parameters_.end(), [&](const Tensor& p) {
+        return p.is_same(weight);
+      });
+  TORCH_CHECK(
+      it != parameters_.end(),
+      "step_embedding_bag expects a parameter of the optimizer as its weight");
+  TORCH_CHECK(
+      options.weight_decay_ == 0,
+      "step_embedding_bag doesn't support weight decay");
+  const size_t i = it - parameters_.begin();
+
+  buffer_at(step_buffers, i) += 1.0;
+  const auto clr = options.learning_rate_ /
+      (1.0 + (buffer_at(step_buffers, i) - 1.0) * options.lr_decay_);
+
+  NoGradGuard guard;
+  Tensor p = parameters_.at(i);
+  at::_embedding_bag_sparse_adagrad_(
+      p,
+      buffer_at(sum_buffers, i),
+      grad,
+      indices,
+      offsets,
+      mode,
+      per_sample_weights,
+      clr,
+      /*eps=*/1e-10);
+}
+
 void Adagrad::save(serialize::OutputArchive& archive) const {
   serialize(*this, archive);
 }
@@ -7,8 +7,9 @@
 
 #include <ATen/ATen.h>
 
-#include <cmath>
 #include <functional>
+#include <map>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -16,41 +17,50 @@ AdamOptions::AdamOptions(double learning_rate)
     : learning_rate_(learning_rate) {}
 
 void Adam::step() {
+  // The parameters are updated together by fused steps, one per number of
+  // steps taken so far (they only differ for parameters that didn't always
+  // have a gradient).
+  std::map<int64_t, std::vector<size_t>> indices_by_step;
   for (size_t i = 0; i < parameters_.size(); ++i) {
-    Tensor p = parameters_.at(i);
-    if (!p.grad().defined()) {
+    if (!parameters_.at(i).grad().defined()) {
       continue;
     }
-
-    if (options.weight_decay_ > 0) {
-      p.grad() = p.grad() + options.weight_decay_ * p;
-    }
-
-    auto& exp_average = buffer_at(exp_average_buffers, i);
-    auto& exp_average_sq = buffer_at(exp_average_sq_buffers, i);
-
-    buffer_at(step_buffers, i) += 1;
-
-    exp_average.mul_(options.beta1_).add_(p.grad(), 1 - options.beta1_);
-    exp_average_sq.mul_(options.beta2_)
-        .addcmul_(p.grad(), p.grad(), 1 - options.beta2_);
-
-    Tensor denom = exp_average_sq;
+    buffer_at(exp_average_buffers, i);
+    buffer_at(exp_average_sq_buffers, i);
     if (options.amsgrad_) {
-      auto& max_exp_average_sq = buffer_at(max_exp_average_sq_buffers, i);
-      max_exp_average_sq = torch::max(max_exp_average_sq, exp_average_sq);
-      denom = max_exp_average_sq;
+      buffer_at(max_exp_average_sq_buffers, i);
     }
+    indices_by_step[buffer_at(step_buffers, i) += 1].push_back(i);
+  }
 
-    const auto bias_correction1 =
-        1 - std::pow(options.beta1_, buffer_at(step_buffers, i));
-    const auto bias_correction2 =
-        1 - std::pow(options.beta2_, buffer_at(step_buffers, i));
-    const auto step_size =
-        options.learning_rate_ * std::sqrt(bias_correction2) / bias_correction1;
-
-    NoGradGuard guard;
-    p.addcdiv_(exp_average, denom.sqrt() + options.eps_, -step_size);
+  NoGradGuard guard;
+  for (const auto& step_and_indices : indices_by_step) {
+    std::vector<Tensor> params, grads, exp_averages, exp_average_sqs,
+        max_exp_average_sqs;
+    for (size_t i : step_and_indices.second) {
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+      exp_averages.push_back(exp_average_buffers[i]);
+      exp_average_sqs.push_back(exp_average_sq_buffers[i]);
+      if (options.amsgrad_) {
+        max_exp_average_sqs.push_back(max_exp_average_sq_buffers[i]);
+      }
+    }
+    torch::_fused_adam_(
+        params,
+        grads,
+        exp_averages,
+        exp_average_sqs,
+        max_exp_average_sqs,
+        options.learning_rate_,
+        options.beta1_,
+        options.beta2_,
+        options.eps_,
+        options.weight_decay_,
+        step_and_indices.first);
+    for (auto& p : params) {
+      autograd::as_variable_ref(p).bump_version();
+    }
   }
 }
 
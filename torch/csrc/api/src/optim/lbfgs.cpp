@@ -20,7 +20,12 @@ LBFGSOptions::LBFGSOptions(double learning_rate)
 Tensor LBFGS::gather_flat_grad() {
   std::vector<Tensor> views;
   for (auto& parameter : parameters_) {
-    views.push_back(parameter.grad().view(-1));
+    if (!parameter.grad().defined()) {
+      // e.g. after zero_grad(/*set_to_none=*/true)
+      views.push_back(torch::zeros({parameter.numel()}, parameter.options()));
+    } else {
+      views.push_back(parameter.grad().view(-1));
+    }
   }
   return torch::cat(views);
 }
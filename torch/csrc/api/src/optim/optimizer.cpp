@@ -4,8 +4,11 @@
 #include <torch/ordered_dict.h>
 #include <torch/serialize/archive.h>
 #include <torch/types.h>
+#include <torch/utils.h>
 
+#include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -20,10 +23,63 @@ void OptimizerBase::add_parameters(const std::vector<Tensor>& parameters) {
 }
 
 void OptimizerBase::zero_grad() {
+  zero_grad(/*set_to_none=*/false);
+}
+
+void OptimizerBase::zero_grad(bool set_to_none) {
+  if (set_to_none) {
+    for (auto& parameter : parameters_) {
+      parameter.grad() = Tensor();
+    }
+    return;
+  }
+
+  // Contiguous gradients are grouped by their storage, and each run of
+  // adjacent or overlapping ones is zeroed as a single tensor. Gradients
+  // that are views into one flat buffer thus cost one kernel in total.
+  struct Extent {
+    int64_t begin;
+    int64_t end;
+    Tensor grad;
+  };
+  std::unordered_map<const c10::StorageImpl*, std::vector<Extent>> extents;
   for (auto& parameter : parameters_) {
-    if (parameter.grad().defined()) {
-      parameter.grad().detach_();
-      parameter.grad().zero_();
+    auto& grad = parameter.grad();
+    if (!grad.defined()) {
+      continue;
+    }
+    grad.detach_();
+    if (grad.is_sparse() || !grad.is_contiguous()) {
+      grad.zero_();
+      continue;
+    }
+    const auto begin = grad.storage_offset();
+    extents[grad.storage().unsafeGetStorageImpl()].push_back(
+        {begin, begin + grad.numel(), grad});
+  }
+
+  NoGradGuard guard;
+  for (auto& storage_extents : extents) {
+    auto& runs = storage_extents.second;
+    std::sort(runs.begin(), runs.end(), [](const Extent& a, const Extent& b) {
+      return a.begin < b.begin;
+    });
+    size_t first = 0;
+    while (first < runs.size()) {
+      auto end = runs[first].end;
+      auto last = first + 1;
+      while (last < runs.size() && runs[last].begin <= end) {
+        end = std::max(end, runs[last].end);
+        ++last;
+      }
+      if (last == first + 1) {
+        runs[first].grad.zero_();
+      } else {
+        runs[first]
+            .grad.as_strided({end - runs[first].begin}, {1}, runs[first].begin)
+            .zero_();
+      }
+      first = last;
     }
   }
 }
@@ -10,40 +10,40 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
 SGDOptions::SGDOptions(double learning_rate) : learning_rate_(learning_rate) {}
 
 void SGD::step() {
+  std::vector<Tensor> params, grads, momentums;
   for (size_t i = 0; i < parameters_.size(); ++i) {
-    Tensor p = parameters_.at(i);
-
-    if (!p.grad().defined()) {
+    if (!parameters_.at(i).grad().defined()) {
       continue;
     }
-
-    auto update = p.grad();
-
-    if (options.weight_decay_ > 0) {
-      update += options.weight_decay_ * p;
-    }
-
+    params.push_back(parameters_[i]);
+    grads.push_back(parameters_[i].grad());
     if (options.momentum_ != 0) {
-      const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening_;
-      auto& momentum = buffer_at(momentum_buffers, i);
-      momentum = (options.momentum_ * momentum) + (dampening * update);
-      if (options.nesterov_) {
-        // See github.com/lisa-lab/pylearn2/pull/136#issuecomment-10381617
-        // for notes on this implementation of nesterov momentum.
-        update += options.momentum_ * momentum;
-      } else {
-        update = momentum;
-      }
+      momentums.push_back(buffer_at(momentum_buffers, i));
     }
+  }
 
-    NoGradGuard guard;
-    p.add_(-options.learning_rate_ * update);
+  // The momentum buffers start at zero, so not dampening the first update
+  // initializes them to it.
+  const auto dampening = iteration_ == 0 ? 0 : options.dampening_;
+  NoGradGuard guard;
+  torch::_fused_sgd_(
+      params,
+      grads,
+      momentums,
+      options.learning_rate_,
+      options.weight_decay_,
+      options.momentum_,
+      dampening,
+      options.nesterov_);
+  for (auto& p : params) {
+    autograd::as_variable_ref(p).bump_version();
   }
   iteration_ += 1;
 }
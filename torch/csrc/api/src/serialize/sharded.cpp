@@ -0,0 +1,382 @@
+#include <torch/serialize/sharded.h>
+
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <c10/util/C++17.h>
+#include <c10/util/Exception.h>
+#include <caffe2/serialize/async_stream_writer.h>
+#include <caffe2/serialize/inline_container.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace serialize {
+namespace {
+const char* const kIndexRecord = "index";
+
+std::string shard_path(const std::string& path, int64_t rank) {
+  return path + "." + std::to_string(rank);
+}
+
+std::string data_record(const std::string& key) {
+  return "data/" + key;
+}
+
+// The rows a tensor of the given `sizes` is split into. Zero-dimensional
+// tensors are a single row of their own.
+int64_t rows(const std::vector<int64_t>& sizes) {
+  return sizes.empty() ? 1 : sizes[0];
+}
+
+// Indices and manifests are text, one shard per line, as
+//   <key> <offset> <length> <dtype> <dim> <sizes>...
+// which is why keys can't contain whitespace.
+
+void check_key(const std::string& key) {
+  TORCH_CHECK(!key.empty(), "Keys of a sharded checkpoint must not be empty");
+  TORCH_CHECK(
+      std::none_of(
+          key.begin(),
+          key.end(),
+          [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
+      "Keys of a sharded checkpoint must not contain whitespace, but got '",
+      key,
+      "'");
+}
+
+void write_shard_line(
+    std::ostream& stream,
+    const std::string& key,
+    const ShardMetadata& shard) {
+  stream << key << ' ' << shard.offset << ' ' << shard.length << ' '
+         << static_cast<int>(shard.dtype) << ' ' << shard.sizes.size();
+  for (auto size : shard.sizes) {
+    stream << ' ' << size;
+  }
+  stream << '\n';
+}
+
+bool read_shard_line(
+    std::istream& stream,
+    std::string& key,
+    ShardMetadata& shard) {
+  int dtype = 0;
+  size_t dim = 0;
+  if (!(stream >> key >> shard.offset >> shard.length >> dtype >> dim)) {
+    return false;
+  }
+  shard.dtype = static_cast<ScalarType>(dtype);
+  shard.sizes.resize(dim);
+  for (auto& size : shard.sizes) {
+    TORCH_CHECK(stream >> size, "Truncated index for '", key, "'");
+  }
+  return true;
+}
+} // namespace
+
+ShardWriter::ShardWriter(const std::string& path, int64_t rank)
+    : writer_(
+          c10::guts::make_unique<caffe2::serialize::AsyncPyTorchStreamWriter>(
+              shard_path(path, rank))),
+      rank_(rank) {
+  TORCH_CHECK(rank >= 0, "Expected a non-negative rank, but got ", rank);
+}
+
+ShardWriter::~ShardWriter() = default;
+
+void ShardWriter::write(
+    const std::string& key,
+    const Tensor& shard,
+    int64_t offset,
+    IntArrayRef sizes) {
+  check_key(key);
+  TORCH_CHECK(!writer_->finalized(), "The shard file was already finished");
+  TORCH_CHECK(
+      index_.count(key) == 0,
+      "A shard of '",
+      key,
+      "' was already written by this rank");
+  ShardMetadata metadata;
+  metadata.rank = rank_;
+  metadata.sizes = sizes.vec();
+  metadata.dtype = shard.scalar_type();
+  metadata.offset = offset;
+  metadata.length = sizes.empty() ? 1 : shard.size(0);
+  if (sizes.empty()) {
+    TORCH_CHECK(
+        shard.dim() == 0 && offset == 0,
+        "Zero-dimensional tensors can't be split into shards");
+  } else {
+    TORCH_CHECK(
+        shard.dim() == static_cast<int64_t>(sizes.size()) &&
+            std::equal(
+                sizes.begin() + 1, sizes.end(), shard.sizes().begin() + 1),
+        "Expected the shard of '",
+        key,
+        "' to have the sizes of rows of ",
+        sizes,
+        ", but got ",
+        shard.sizes());
+    TORCH_CHECK(
+        offset >= 0 && offset + metadata.length <= sizes[0],
+        "The rows [",
+        offset,
+        ", ",
+        offset + metadata.length,
+        ") of '",
+        key,
+        "' are out of bounds for its sizes ",
+        sizes);
+  }
+
+  // The writer copies the data, so this is a snapshot of the shard even if it
+  // is modified right after.
+  auto data = shard.to(kCPU).contiguous();
+  writer_->writeRecord(
+      data_record(key), data.data_ptr(), data.numel() * data.element_size());
+  index_.emplace(key, std::move(metadata));
+}
+
+void ShardWriter::write(const std::string& key, const Tensor& tensor) {
+  write(key, tensor, /*offset=*/0, tensor.sizes());
+}
+
+void ShardWriter::finish() {
+  TORCH_CHECK(!writer_->finalized(), "The shard file was already finished");
+  std::ostringstream index;
+  for (const auto& entry : index_) {
+    write_shard_line(index, entry.first, entry.second);
+  }
+  const auto text = index.str();
+  writer_->writeRecord(kIndexRecord, text.data(), text.size());
+  writer_->writeEndOfFile();
+  writer_->wait();
+}
+
+void write_sharded_manifest(const std::string& path, int64_t world_size) {
+  TORCH_CHECK(
+      world_size > 0, "Expected a positive world size, but got ", world_size);
+  std::ostringstream manifest;
+  manifest << "world_size " << world_size << '\n';
+  for (int64_t rank = 0; rank < world_size; ++rank) {
+    caffe2::serialize::PyTorchStreamReader reader(shard_path(path, rank));
+    at::DataPtr data;
+    size_t size;
+    std::tie(data, size) = reader.getRecord(kIndexRecord);
+    std::istringstream index(
+        std::string(static_cast<const char*>(data.get()), size));
+    std::string key;
+    ShardMetadata shard;
+    while (read_shard_line(index, key, shard)) {
+      manifest << rank << ' ';
+      write_shard_line(manifest, key, shard);
+    }
+  }
+
+  // Write to a temporary file first, so that the manifest only ever exists
+  // once it is complete.
+  const auto temporary_path = path + ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+    TORCH_CHECK(file, "Unable to open ", temporary_path, " for writing");
+    file << manifest.str();
+    file.close();
+    TORCH_CHECK(file, "Failed to write the manifest to ", temporary_path);
+  }
+  TORCH_CHECK(
+      std::rename(temporary_path.c_str(), path.c_str()) == 0,
+      "Failed to move the manifest to ",
+      path);
+}
+
+ShardedCheckpoint::ShardedCheckpoint(std::string path)
+    : path_(std::move(path)) {
+  std::ifstream manifest(path_, std::ios::binary);
+  TORCH_CHECK(manifest, "Unable to open the manifest at ", path_);
+  std::string header;
+  TORCH_CHECK(
+      manifest >> header >> world_size_ && header == "world_size",
+      path_,
+      " is not the manifest of a sharded checkpoint");
+  int64_t rank = 0;
+  while (manifest >> rank) {
+    std::string key;
+    ShardMetadata shard;
+    TORCH_CHECK(
+        read_shard_line(manifest, key, shard),
+        "Truncated manifest at ",
+        path_);
+    shard.rank = rank;
+    auto& shards = shards_[key];
+    TORCH_CHECK(
+        shards.empty() ||
+            (shards.front().sizes == shard.sizes &&
+             shards.front().dtype == shard.dtype),
+        "The shards of '",
+        key,
+        "' disagree on its sizes or dtype");
+    shards.push_back(std::move(shard));
+  }
+  TORCH_CHECK(manifest.eof(), "Malformed manifest at ", path_);
+  for (auto& entry : shards_) {
+    std::stable_sort(
+        entry.second.begin(),
+        entry.second.end(),
+        [](const ShardMetadata& a, const ShardMetadata& b) {
+          return a.offset < b.offset;
+        });
+  }
+}
+
+ShardedCheckpoint::~ShardedCheckpoint() = default;
+
+int64_t ShardedCheckpoint::world_size() const {
+  return world_size_;
+}
+
+std::vector<std::string> ShardedCheckpoint::keys() const {
+  std::vector<std::string> keys;
+  keys.reserve(shards_.size());
+  for (const auto& entry : shards_) {
+    keys.push_back(entry.first);
+  }
+  return keys;
+}
+
+bool ShardedCheckpoint::contains(const std::string& key) const {
+  return shards_.count(key) != 0;
+}
+
+std::vector<int64_t> ShardedCheckpoint::sizes(const std::string& key) const {
+  auto it = shards_.find(key);
+  TORCH_CHECK(
+      it != shards_.end(), "No tensor named '", key, "' in the checkpoint");
+  return it->second.front().sizes;
+}
+
+Tensor ShardedCheckpoint::read(
+    const std::string& key,
+    int64_t begin,
+    int64_t end) {
+  auto it = shards_.find(key);
+  TORCH_CHECK(
+      it != shards_.end(), "No tensor named '", key, "' in the checkpoint");
+  const auto& shards = it->second;
+  auto sizes = shards.front().sizes;
+  const auto dtype = shards.front().dtype;
+  TORCH_CHECK(
+      0 <= begin && begin <= end && end <= rows(sizes),
+      "The rows [",
+      begin,
+      ", ",
+      end,
+      ") are out of bounds for '",
+      key,
+      "' with sizes ",
+      IntArrayRef(sizes));
+
+  torch::NoGradGuard guard;
+  if (!sizes.empty()) {
+    sizes[0] = end - begin;
+  }
+  auto result = torch::empty(sizes, TensorOptions(dtype));
+  // The rows before `next` are read already. Ranks that hold the same rows
+  // (e.g. of a replicated tensor) are only read from once.
+  int64_t next = begin;
+  for (const auto& shard : shards) {
+    const int64_t shard_end = shard.offset + shard.length;
+    if (next == end) {
+      break;
+    }
+    if (shard_end <= next) {
+      continue;
+    }
+    TORCH_CHECK(
+        shard.offset <= next,
+        "The rows [",
+        next,
+        ", ",
+        shard.offset,
+        ") of '",
+        key,
+        "' are missing from the checkpoint");
+    at::DataPtr data;
+    size_t size;
+    std::tie(data, size) = shard_reader(shard.rank).getRecord(data_record(key));
+    const auto meta = at::CPU(dtype).typeMeta();
+    std::vector<int64_t> shard_sizes = shard.sizes;
+    if (!shard_sizes.empty()) {
+      shard_sizes[0] = shard.length;
+    }
+    auto shard_tensor = at::empty({0}, at::CPU(dtype).options())
+                            .set_(at::Storage(
+                                meta,
+                                size / meta.itemsize(),
+                                std::move(data),
+                                /*allocator=*/nullptr,
+                                /*resizable=*/false))
+                            .view(shard_sizes);
+    const int64_t copy_end = std::min(end, shard_end);
+    if (sizes.empty()) {
+      result.copy_(shard_tensor);
+    } else {
+      result.narrow(0, next - begin, copy_end - next)
+          .copy_(shard_tensor.narrow(0, next - shard.offset, copy_end - next));
+    }
+    next = copy_end;
+  }
+  TORCH_CHECK(
+      next == end,
+      "The rows [",
+      next,
+      ", ",
+      end,
+      ") of '",
+      key,
+      "' are missing from the checkpoint");
+  return result;
+}
+
+Tensor ShardedCheckpoint::read(const std::string& key) {
+  return read(key, /*begin=*/0, /*end=*/rows(sizes(key)));
+}
+
+Tensor ShardedCheckpoint::read_shard(
+    const std::string& key,
+    int64_t rank,
+    int64_t world_size) {
+  TORCH_CHECK(
+      0 <= rank && rank < world_size,
+      "Expected a rank in [0, ",
+      world_size,
+      "), but got ",
+      rank);
+  const auto total = rows(sizes(key));
+  const auto chunk = (total + world_size - 1) / world_size;
+  const auto begin = std::min(total, rank * chunk);
+  const auto end = std::min(total, begin + chunk);
+  return read(key, begin, end);
+}
+
+caffe2::serialize::PyTorchStreamReader& ShardedCheckpoint::shard_reader(
+    int64_t rank) {
+  auto& reader = readers_[rank];
+  if (!reader) {
+    reader = c10::guts::make_unique<caffe2::serialize::PyTorchStreamReader>(
+        shard_path(path_, rank));
+  }
+  return *reader;
+}
+} // namespace serialize
+} // namespace torch
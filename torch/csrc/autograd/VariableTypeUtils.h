@@ -1,6 +1,7 @@
 #include <torch/csrc/autograd/generated/VariableType.h>
 
 #include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/autograd/autocast_mode.h>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/edge.h>
 #include <torch/csrc/autograd/grad_mode.h>
@@ -165,7 +166,7 @@ std::tuple<Tensors...> as_variable_impl(
   // constructions. This turns into (boolean omitted):
   // Variable(std::get<0>(tensors)), Variable(std::get<1>(tensors)), ...
   return std::tuple<Tensors...>(
-      as_variable(std::get<Is>(tensors))...);
+      as_variable(std::get<Is>(std::move(tensors)))...);
 }
 
 // NB: Because this was not forward declared, recursive std::tuple won't work.
@@ -177,7 +178,7 @@ std::tuple<Tensors...> as_variable(std::tuple<Tensors...> tensors) {
   // expand into an Indices object containing the numbers 0 to
   // sizeof...(Tensors) - 1.
   return as_variable_impl(
-      tensors, typename MakeIndices<sizeof...(Tensors)>::indices());
+      std::move(tensors), typename MakeIndices<sizeof...(Tensors)>::indices());
 }
 
 inline std::vector<std::vector<int64_t>> to_args_sizes(TensorList tensors) {
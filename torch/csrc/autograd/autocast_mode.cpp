@@ -0,0 +1,86 @@
+#include <torch/csrc/autograd/autocast_mode.h>
+
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <unordered_map>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+struct Entry {
+  // Keeps the TensorImpl the entry is keyed by alive
+  Variable source;
+  Variable casted;
+  // The version of `source` when it was cast
+  uint32_t version;
+  bool grad_enabled;
+};
+
+thread_local bool AutocastMode_enabled = false;
+thread_local std::unordered_map<c10::TensorImpl*, Entry> AutocastMode_cache;
+
+bool is_eligible(const at::Tensor& arg) {
+  return arg.defined() && arg.is_cuda() && at::isFloatingType(arg.scalar_type());
+}
+
+} // anonymous namespace
+
+bool AutocastMode::is_enabled() {
+  return AutocastMode_enabled;
+}
+
+void AutocastMode::set_enabled(bool enabled) {
+  AutocastMode_enabled = enabled;
+}
+
+void AutocastMode::clear_cache() {
+  AutocastMode_cache.clear();
+}
+
+at::Tensor AutocastMode::cast(at::ScalarType to, const at::Tensor& arg) {
+  if (!is_eligible(arg) || arg.scalar_type() == to) {
+    return arg;
+  }
+  auto& var = as_variable_ref(arg);
+  if (!var.is_leaf() || !var.requires_grad()) {
+    return arg.to(to);
+  }
+
+  const bool grad_enabled = GradMode::is_enabled();
+  auto it = AutocastMode_cache.find(var.unsafeGetTensorImpl());
+  if (it != AutocastMode_cache.end()) {
+    const auto& entry = it->second;
+    if (entry.version == var.current_version() &&
+        entry.grad_enabled == grad_enabled &&
+        entry.casted.scalar_type() == to) {
+      return entry.casted;
+    }
+  }
+  auto casted = arg.to(to);
+  AutocastMode_cache[var.unsafeGetTensorImpl()] =
+      Entry{var, as_variable_ref(casted), var.current_version(), grad_enabled};
+  return casted;
+}
+
+std::vector<at::Tensor> AutocastMode::cast(at::ScalarType to, at::TensorList args) {
+  std::vector<at::Tensor> result;
+  result.reserve(args.size());
+  for (const auto& arg : args) {
+    result.push_back(cast(to, arg));
+  }
+  return result;
+}
+
+at::ScalarType AutocastMode::promote_type(at::TensorList args) {
+  at::ScalarType result = at::kHalf;
+  for (const auto& arg : args) {
+    if (is_eligible(arg)) {
+      result = at::promoteTypes(result, arg.scalar_type());
+    }
+  }
+  return result;
+}
+
+}}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <vector>
+
+namespace torch { namespace autograd {
+
+// Note [Autocast]
+// ~~~~~~~~~~~~~~~
+// While autocast is enabled on a thread, the functions of VariableType listed
+// in the AUTOCAST_* sets of tools/autograd/gen_variable_type.py cast their
+// floating point CUDA inputs before running, so that a model written in fp32
+// gets the tensor core throughput of fp16 where that is numerically safe:
+//
+//   - AUTOCAST_LOWER_PRECISION (GEMMs, convolutions, RNN cells) run in fp16,
+//   - AUTOCAST_FP32 (reductions, softmax, norms, losses, pointwise functions
+//     with a large output range) run in fp32,
+//   - AUTOCAST_PROMOTE (functions of several inputs that must agree on their
+//     type) run in the widest type among their inputs.
+//
+// The casted function then runs with autocast disabled, so that the functions
+// it is composed of see the types chosen for it. All other functions run in
+// the types of their inputs.
+//
+// The casts are regular differentiable `to()` calls, so gradients flow back
+// to the fp32 inputs in their own type. Since the weights of a model are cast
+// by every function using them, the casts of leaf Variables that require grad
+// are cached on the thread until AutocastMode::clear_cache() is called (the
+// Python context manager does so when it exits its outermost region). A
+// cached cast is only reused while the version counter of its source is
+// unchanged and for calls made with the same grad mode, so an optimizer step
+// in the region makes a new one.
+struct TORCH_API AutocastMode {
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+  static void clear_cache();
+
+  // Casts `arg` to `to` if it is a defined, floating point CUDA tensor of
+  // another type, and returns it unchanged otherwise
+  static at::Tensor cast(at::ScalarType to, const at::Tensor& arg);
+  static std::vector<at::Tensor> cast(at::ScalarType to, at::TensorList args);
+
+  // The widest floating point type among `args`, which are cast to it by the
+  // functions of AUTOCAST_PROMOTE. Defaults to Half
+  static at::ScalarType promote_type(at::TensorList args);
+};
+
+// A RAII, thread local (!) guard that enables or disables autocast upon
+// construction, and sets it back to the original value upon destruction. It
+// doesn't clear the cache. See Note [Autocast]
+struct TORCH_API AutoCastMode {
+  AutoCastMode(bool enabled) : prev_mode(AutocastMode::is_enabled()) {
+    AutocastMode::set_enabled(enabled);
+  }
+  ~AutoCastMode() {
+    AutocastMode::set_enabled(prev_mode);
+  }
+  bool prev_mode;
+};
+
+}}
@@ -11,10 +11,12 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <c10/util/Exception.h>
+#include <c10/util/static_tracepoint.h>
 
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -39,17 +41,41 @@ static constexpr int NO_DEVICE = -2;
 // handling reentrant backwards calls; see Note [Reentrant backwards]
 static thread_local int worker_device = NO_DEVICE;
 
+// The index of the ready queue the current thread processes, or NO_DEVICE if
+// it isn't a worker. The CPU device can have several workers (see
+// Note [Multiple CPU workers]), so unlike worker_device, this identifies a
+// single thread.
+static thread_local int worker_queue = NO_DEVICE;
+
 // This variable is true if ALL invocations in the stack of re-entrant engine
 // invocations are imperative backwards. This special variable is needed for the
 // gradient checkpointing feature only.
 static thread_local bool checkpoint_valid = true;
 
 // XXX: Changes to the way multithreading works in execute should be done with
-// great care. Right now the implementation guarantees that a single function's
-// apply will never be entered concurrently (even if multiple graphs are
-// executed at the same time). Adding multiple threads per-device or removing
-// engine thread affinity to the device can break this invariant, and we depend
-// on it in a few places (e.g. AccumulateGrad function).
+// great care. With a single CPU worker (the default), the implementation
+// guarantees that a single function's apply will never be entered concurrently
+// (even if multiple graphs are executed at the same time). With several CPU
+// workers, this only holds within a single graph: a function that is part of
+// several graphs executed at the same time can be applied by two CPU workers
+// at once. AccumulateGrad, which is shared by every graph that uses a leaf,
+// serializes its applications itself.
+
+// Note [Multiple CPU workers]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, all CPU functions run on a single worker thread. Setting the
+// TORCH_AUTOGRAD_CPU_THREADS environment variable to N > 1 gives the CPU
+// device N workers, each with its own ready queue, and ready CPU tasks are
+// handed out to them in turn, so that independent branches of the graph are
+// differentiated in parallel. The dependency counts and input buffers of a
+// graph are only accessed under its GraphTask mutex, so its tasks can be
+// evaluated concurrently.
+//
+// Every worker only pops from its own queue, which is what makes reentrant
+// backwards work with several CPU workers: GraphTask::owner is the queue of
+// the thread that waits for the task, so that the thread which finishes the
+// last function of the task can wake up exactly that one. See
+// Note [Reentrant backwards].
 
 struct FunctionTask {
   GraphTask* base;
@@ -110,7 +136,7 @@ struct ReadyQueue {
 //
 // Here's our cunning idea: instead of blocking, just get back to work
 // on whatever task queue you should have been working on previously
-// (this is saved via the thread local variable worker_device)!  There are
+// (this is saved via the thread local variable worker_queue)!  There are
 // "simply" two things you have to arrange for:
 //
 //  - We have to promptly kick ourselves out of the thread_main() loop
@@ -166,7 +192,7 @@ struct GraphTask {
 
   void init_to_execute(Function& graph_root, const edge_list& outputs);
 
-  // The value of worker_device in the thread that created this task.
+  // The value of worker_queue in the thread that created this task.
   // See Note [Reentrant backwards]
   int owner;
 
@@ -266,18 +292,20 @@ auto Engine::thread_init(int device) -> void {
 // It's all ok and is handled right now, but it should be accounted for
 // in case this code is to be changed.
 auto Engine::thread_main(GraphTask *graph_task) -> void {
-  auto queue = ready_queues[worker_device + 1];
+  auto queue = ready_queues[worker_queue];
   // Why the test on graph_task->outstanding_tasks?  See
   // Note [Reentrant backwards]
   while (!graph_task || graph_task->outstanding_tasks > 0) {
     FunctionTask task = queue->pop();
     if (task.fn && !task.base->has_error.load()) {
       GradMode::set_enabled(task.base->grad_mode);
+      C10_SDT(autograd_task_start, task.fn.get(), task.fn->sequence_nr(), worker_queue);
       try {
         evaluate_function(task);
       } catch (std::exception& e) {
         thread_on_exception(task, e);
       }
+      C10_SDT(autograd_task_end, task.fn.get());
     }
     // Notify downstream about the completion of tasks depending
     // on both where the task was executed, and who owned the overall
@@ -292,13 +320,13 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
     } else {
       // If it's a task initiated from this thread, decrease the counter, but
       // don't do anything - loop condition will do all checks for us next.
-      if (base_owner == worker_device) {
+      if (base_owner == worker_queue) {
         --task.base->outstanding_tasks;
       // Otherwise send a dummy function task to the owning thread just to
       // ensure that it's not sleeping. If it has work, it might see that
       // graph_task->outstanding_tasks == 0 before it gets to the task, but
       // it's a no-op anyway.
-      } else if (base_owner != worker_device) {
+      } else if (base_owner != worker_queue) {
         if (--task.base->outstanding_tasks == 0) {
           // Synchronize outstanding_tasks with queue mutex
           std::atomic_thread_fence(std::memory_order_release);
@@ -586,7 +614,7 @@ auto Engine::execute(const edge_list& roots,
   ready_queue(at::kCPU).push(FunctionTask(&graph_task, std::move(graph_root), InputBuffer(0)));
 
   // Not a worker
-  if (worker_device == NO_DEVICE) {
+  if (worker_queue == NO_DEVICE) {
     // Wait for all tasks to complete
     graph_task.not_done.wait(lock, [&graph_task]{
       return graph_task.outstanding_tasks.load() == 0;
@@ -595,7 +623,7 @@ auto Engine::execute(const edge_list& roots,
     // Get back to work while we wait for our new graph_task to
     // complete!
     // See Note [Reentrant backwards]
-    graph_task.owner = worker_device;
+    graph_task.owner = worker_queue;
     lock.unlock();
     thread_main(&graph_task);
   }
@@ -656,17 +684,28 @@ bool Engine::is_checkpoint_valid() {
 auto Engine::ready_queue(at::Device device) -> ReadyQueue& {
   // See Note [Allocating GPUs to autograd threads]
   if (device.type() == at::kCPU) {
-    return *ready_queues.at(0);
+    // See Note [Multiple CPU workers]
+    if (num_cpu_threads == 1) {
+      return *ready_queues.at(0);
+    }
+    return *ready_queues.at(next_cpu_queue++ % num_cpu_threads);
   } else {
-    return *ready_queues.at(device.index() + 1);
+    return *ready_queues.at(num_cpu_threads + device.index());
   }
 }
 
-// See Note [Allocating GPUs to autograd threads]
-// NB: This would become obsolete if we truly allocated a CPU thread
-// per device, rather than colocate.
-auto Engine::ready_queue_by_index(int device_index) -> ReadyQueue& {
-  return *ready_queues.at(device_index + 1);
+auto Engine::ready_queue_by_index(int queue_index) -> ReadyQueue& {
+  return *ready_queues.at(queue_index);
+}
+
+// The number of CPU workers, see Note [Multiple CPU workers]
+static int num_cpu_threads_from_env() {
+  const char* value = std::getenv("TORCH_AUTOGRAD_CPU_THREADS");
+  if (!value) {
+    return 1;
+  }
+  int num_threads = std::atoi(value);
+  return num_threads > 0 ? num_threads : 1;
 }
 
 auto Engine::start_threads() -> void {
@@ -679,14 +718,19 @@ auto Engine::start_threads() -> void {
     }
   }
 
-  // One for CPU, plus one for every GPU device (but colocate GPUs of different
-  // types)
-  int num_threads = num_devices + 1;
+  // One for every CPU worker, plus one for every GPU device (but colocate GPUs
+  // of different types)
+  num_cpu_threads = num_cpu_threads_from_env();
+  int num_threads = num_cpu_threads + num_devices;
   ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
   for (auto& queue : ready_queues)
     queue.reset(new ReadyQueue());
   for (int i = 0; i < num_threads; ++i) {
-    std::thread t(&Engine::thread_init, this, i - 1);
+    int device = i < num_cpu_threads ? -1 : i - num_cpu_threads;
+    std::thread t([this, i, device] {
+      worker_queue = i;
+      thread_init(device);
+    });
     t.detach();
   }
 }
@@ -8,6 +8,7 @@
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 
+#include <atomic>
 #include <deque>
 #include <exception>
 #include <functional>
@@ -55,14 +56,18 @@ protected:
   void compute_dependencies(Function* root, GraphTask& task);
   void evaluate_function(FunctionTask& task);
   ReadyQueue& ready_queue(at::Device device);
-  ReadyQueue& ready_queue_by_index(int device_index);
+  ReadyQueue& ready_queue_by_index(int queue_index);
   void start_threads();
   virtual void thread_init(int device);
   virtual void thread_main(GraphTask *graph_task);
   virtual void thread_on_exception(FunctionTask& task, std::exception& e);
 
   std::once_flag start_threads_flag;
+  // The first num_cpu_threads queues belong to the CPU workers, followed by
+  // one for every device. See Note [Multiple CPU workers]
   std::vector<std::shared_ptr<ReadyQueue>> ready_queues;
+  int num_cpu_threads = 1;
+  std::atomic<unsigned> next_cpu_queue{0};
   std::vector<std::function<void()>> final_callbacks;
   std::mutex post_callbacks_lock;
 };
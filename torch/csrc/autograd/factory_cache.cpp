@@ -0,0 +1,117 @@
+#include <torch/csrc/autograd/factory_cache.h>
+
+#include <torch/csrc/autograd/variable.h>
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+struct KeyHash {
+  size_t operator()(const FactoryCache::Key& key) const {
+    size_t hash = 0;
+    for (const char* c = key.name; *c; ++c) {
+      hash = hash * 31 + *c;
+    }
+    for (int64_t value : key.values) {
+      hash = hash * 31 + std::hash<int64_t>()(value);
+    }
+    return hash;
+  }
+};
+
+struct Entry {
+  Variable variable;
+  // The version of `variable` when it was cached
+  uint32_t version;
+};
+
+thread_local int64_t FactoryCache_depth = 0;
+thread_local std::unordered_map<FactoryCache::Key, Entry, KeyHash> FactoryCache_entries;
+
+} // anonymous namespace
+
+void FactoryCache::Key::add(int64_t value) {
+  values.push_back(value);
+}
+
+void FactoryCache::Key::add(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  values.push_back(bits);
+}
+
+void FactoryCache::Key::add(at::IntArrayRef values_) {
+  values.push_back(values_.size());
+  values.insert(values.end(), values_.begin(), values_.end());
+}
+
+void FactoryCache::Key::add(at::Scalar value) {
+  // Scalars that compare equal can still make different tensors (e.g. the
+  // dtype arange infers from integer and floating point ends), so the kind of
+  // the scalar is part of the key.
+  if (value.isFloatingPoint()) {
+    add(static_cast<int64_t>(0));
+    add(value.toDouble());
+  } else if (value.isComplex()) {
+    auto complex = value.toComplexDouble();
+    add(static_cast<int64_t>(1));
+    add(complex.real());
+    add(complex.imag());
+  } else {
+    add(static_cast<int64_t>(2));
+    add(value.toLong());
+  }
+}
+
+void FactoryCache::Key::add(const at::TensorOptions& options) {
+  // Some factories infer the dtype of their result when it isn't given
+  add(static_cast<int64_t>(options.has_dtype()));
+  add(static_cast<int64_t>(at::typeMetaToScalarType(options.dtype())));
+  add(static_cast<int64_t>(options.layout()));
+  add(static_cast<int64_t>(options.device().type()));
+  add(static_cast<int64_t>(options.device().index()));
+  add(static_cast<int64_t>(options.pinned_memory()));
+}
+
+bool FactoryCache::Key::operator==(const Key& other) const {
+  return std::strcmp(name, other.name) == 0 && values == other.values;
+}
+
+bool FactoryCache::is_enabled() {
+  return FactoryCache_depth > 0;
+}
+
+void FactoryCache::enter() {
+  FactoryCache_depth++;
+}
+
+void FactoryCache::exit() {
+  AT_ASSERT(FactoryCache_depth > 0);
+  if (--FactoryCache_depth == 0) {
+    FactoryCache_entries.clear();
+  }
+}
+
+at::Tensor FactoryCache::lookup(const Key& key) {
+  auto it = FactoryCache_entries.find(key);
+  if (it == FactoryCache_entries.end()) {
+    return at::Tensor();
+  }
+  const auto& variable = it->second.variable;
+  if (variable.current_version() != it->second.version || variable.requires_grad()) {
+    FactoryCache_entries.erase(it);
+    return at::Tensor();
+  }
+  return variable;
+}
+
+void FactoryCache::insert(Key&& key, const at::Tensor& variable) {
+  auto& var = as_variable_ref(variable);
+  FactoryCache_entries[std::move(key)] = Entry{var, var.current_version()};
+}
+
+}}
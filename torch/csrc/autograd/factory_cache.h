@@ -0,0 +1,68 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+// Note [Factory cache]
+// ~~~~~~~~~~~~~~~~~~~~
+// Code that builds the same constant tensors over and over (e.g. an arange, or
+// a mask of ones of the same shape, on every call) can opt in to reusing them:
+// while a FactoryCacheGuard is alive on a thread, the deterministic factories
+// of variable_factories.h (see CACHED_FACTORIES in
+// tools/autograd/gen_variable_factories.py) called on that thread return the
+// Variable they returned the last time they were called with the same
+// arguments, instead of allocating and filling a new one.
+//
+// A cached Variable is only returned while its version counter is unchanged:
+// once it, or a view of it, is modified in place, the next call makes a new
+// one. Callers share the cached Variables, so they should treat them as
+// read-only, since modifying one in place is visible through the other results
+// of the same call (and modifying one through `.data` isn't even detected).
+//
+// Calls that make Variables that require grad, and calls made while tracing,
+// are never cached. The cache of a thread is emptied when its outermost guard
+// is destroyed.
+struct TORCH_API FactoryCache {
+  // The name of a factory and its arguments, flattened to integers
+  struct Key {
+    explicit Key(const char* name) : name(name) {}
+
+    void add(int64_t value);
+    void add(double value);
+    void add(at::IntArrayRef values);
+    void add(at::Scalar value);
+    void add(const at::TensorOptions& options);
+
+    bool operator==(const Key& other) const;
+
+    const char* name;
+    std::vector<int64_t> values;
+  };
+
+  static bool is_enabled();
+  static void enter();
+  static void exit();
+
+  // Returns the Variable cached for `key`, or an undefined tensor
+  static at::Tensor lookup(const Key& key);
+  static void insert(Key&& key, const at::Tensor& variable);
+};
+
+// A RAII, thread local (!) guard that enables the factory cache for its
+// lifetime. See Note [Factory cache]
+struct TORCH_API FactoryCacheGuard {
+  FactoryCacheGuard() {
+    FactoryCache::enter();
+  }
+  ~FactoryCacheGuard() {
+    FactoryCache::exit();
+  }
+};
+
+}}
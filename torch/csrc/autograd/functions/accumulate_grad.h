@@ -4,6 +4,8 @@
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <mutex>
+
 namespace torch { namespace autograd {
 
 struct TORCH_API AccumulateGrad : public Function {
@@ -12,6 +14,12 @@ struct TORCH_API AccumulateGrad : public Function {
   variable_list apply(variable_list&& grads) override;
 
   Variable variable;
+
+ private:
+  // Several CPU workers of the engine may apply this function at the same
+  // time, if the variable is used by several graphs that are differentiated
+  // concurrently. See Note [Multiple CPU workers] in engine.cpp
+  std::mutex mutex_;
 };
 
 }} // namespace torch::autograd
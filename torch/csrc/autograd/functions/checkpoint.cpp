@@ -0,0 +1,108 @@
+#include <torch/csrc/autograd/functions/checkpoint.h>
+
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/functions/utils.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <ATen/ATen.h>
+
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+variable_list checkpoint(checkpoint_function fn, const variable_list& inputs) {
+  if (!GradMode::is_enabled()) {
+    return fn(inputs);
+  }
+
+  variable_list outputs;
+  {
+    AutoGradMode no_grad(false);
+    outputs = fn(inputs);
+  }
+
+  tensor_list output_data;
+  output_data.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    output_data.push_back(
+        output.defined() ? output.data() : at::Tensor());
+  }
+  std::shared_ptr<CheckpointBackward> grad_fn;
+  auto result = wrap_outputs(
+      inputs, std::move(output_data), [&](edge_list&& next_edges) {
+        grad_fn = std::make_shared<CheckpointBackward>(
+            std::move(fn), std::move(next_edges));
+        return grad_fn;
+      });
+  if (grad_fn) {
+    grad_fn->saved_inputs.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      grad_fn->saved_inputs.emplace_back(input, /*is_output=*/false);
+    }
+  }
+  return result;
+}
+
+// See Note [Checkpointing]
+auto CheckpointBackward::apply(variable_list&& grads) -> variable_list {
+  auto& engine = Engine::get_default_engine();
+  if (!engine.is_checkpoint_valid()) {
+    throw std::runtime_error(
+        "Checkpointing is not compatible with .grad(), please use "
+        ".backward() if possible");
+  }
+
+  variable_list inputs;
+  inputs.reserve(saved_inputs.size());
+  for (const auto& saved : saved_inputs) {
+    auto input = saved.unpack();
+    if (input.defined()) {
+      bool requires_grad = input.requires_grad();
+      input = input.detach();
+      input.set_requires_grad(requires_grad);
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  variable_list outputs;
+  {
+    AutoGradMode enable_grad(true);
+    outputs = fn(inputs);
+  }
+  if (outputs.size() != grads.size()) {
+    std::stringstream ss;
+    ss << "CheckpointBackward: the checkpointed function returned "
+       << outputs.size() << " outputs when recomputed, but " << grads.size()
+       << " in the forward pass";
+    throw std::runtime_error(ss.str());
+  }
+
+  edge_list roots;
+  variable_list root_grads;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (outputs[i].defined() && outputs[i].requires_grad() &&
+        grads[i].defined()) {
+      roots.push_back(outputs[i].gradient_edge());
+      root_grads.push_back(std::move(grads[i]));
+    }
+  }
+  if (!roots.empty()) {
+    engine.execute(
+        roots, root_grads, /*keep_graph=*/false, /*create_graph=*/false);
+  }
+
+  variable_list grad_inputs;
+  grad_inputs.reserve(inputs.size());
+  for (auto& input : inputs) {
+    grad_inputs.push_back(
+        input.defined() ? as_variable_ref(input.grad()) : Variable());
+  }
+  return grad_inputs;
+}
+
+}} // namespace torch::autograd
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <functional>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+using checkpoint_function = std::function<variable_list(const variable_list&)>;
+
+// Note [Checkpointing]
+// ~~~~~~~~~~~~~~~~~~~~
+// checkpoint() trades compute for memory: it runs `fn` without recording a
+// graph, so none of the intermediate values `fn` computes are saved for
+// backward. Only the inputs are saved, by a single CheckpointBackward, which
+// runs `fn` again with grad mode enabled when its gradients are needed and
+// backpropagates through the recomputed graph with a reentrant call to the
+// engine. This is the C++ counterpart of torch.utils.checkpoint, and has the
+// same restrictions:
+//
+// - `fn` has to compute the same thing both times. The RNG state isn't
+//   restored before recomputing it, so it shouldn't use random ops.
+// - The gradients of parameters `fn` uses are accumulated into their .grad
+//   by the reentrant backward, so checkpointing is not compatible with
+//   autograd::grad() (i.e. calls to the engine that specify outputs).
+// - There is no double backward through a checkpointed region.
+TORCH_API variable_list checkpoint(
+    checkpoint_function fn,
+    const variable_list& inputs);
+
+struct TORCH_API CheckpointBackward : public Function {
+  CheckpointBackward(checkpoint_function fn, edge_list&& next_edges)
+    : Function(std::move(next_edges))
+    , fn(std::move(fn)) {}
+
+  variable_list apply(variable_list&& grads) override;
+
+  void release_variables() override {
+    for (auto& input : saved_inputs) {
+      input.reset_data();
+    }
+  }
+
+  checkpoint_function fn;
+  std::vector<SavedVariable> saved_inputs;
+};
+
+}}
@@ -2,9 +2,12 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/pybind.h>
+#include <torch/csrc/autograd/autocast_mode.h>
+#include <torch/csrc/autograd/factory_cache.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/python_function.h>
+#include <torch/csrc/autograd/sampling_profiler.h>
 #include <torch/csrc/autograd/function.h>
 
 PyObject* THPAutograd_initExtension(PyObject* _unused) {
@@ -36,7 +39,11 @@ PyObject* THPAutograd_initExtension(PyObject* _unused) {
       .value("NVTX", ProfilerState::NVTX);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool>());
+      .def(
+          py::init<ProfilerState, bool, bool>(),
+          py::arg("state"),
+          py::arg("report_input_shapes"),
+          py::arg("profile_memory") = false);
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -46,7 +53,10 @@ PyObject* THPAutograd_initExtension(PyObject* _unused) {
       .def("cpu_elapsed_us", &Event::cpu_elapsed_us)
       .def("cuda_elapsed_us", &Event::cuda_elapsed_us)
       .def("has_cuda", &Event::has_cuda)
-      .def("shapes", &Event::shapes);
+      .def("shapes", &Event::shapes)
+      .def("stream", &Event::stream)
+      .def("correlation_id", &Event::correlation_id)
+      .def("alloc_size", &Event::alloc_size);
 
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
@@ -54,6 +64,18 @@ PyObject* THPAutograd_initExtension(PyObject* _unused) {
   m.def("_push_range", [](std::string name) { pushRange(std::move(name)); });
   m.def("_pop_range", []() { popRange(); });
 
+  py::class_<OpLatencyHistogram>(m, "OpLatencyHistogram")
+      .def_readonly("name", &OpLatencyHistogram::name)
+      .def_readonly("count", &OpLatencyHistogram::count)
+      .def_readonly("total_ns", &OpLatencyHistogram::total_ns)
+      .def_readonly("buckets", &OpLatencyHistogram::buckets);
+
+  m.def("_enable_sampling_profiler", enableSamplingProfiler);
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_is_sampling_profiler_enabled", isSamplingProfilerEnabled);
+  m.def("_sampled_op_latencies", sampledOpLatencies);
+  m.def("_dropped_op_samples", droppedOpSamples);
+
   Py_RETURN_TRUE;
 }
 
@@ -99,12 +121,58 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * enter_factory_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  FactoryCache::enter();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * exit_factory_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  FactoryCache::exit();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  AutocastMode::set_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (AutocastMode::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  AutocastMode::clear_cache();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 // autograd methods on torch._C
 static PyMethodDef methods[] = {
   {"set_grad_enabled", (PyCFunction)set_grad_enabled, METH_O, nullptr},
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
   {"set_anomaly_enabled", (PyCFunction)set_anomaly_mode_enabled, METH_O, nullptr},
   {"is_anomaly_enabled", (PyCFunction)is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_enter_factory_cache", (PyCFunction)enter_factory_cache, METH_NOARGS, nullptr},
+  {"_exit_factory_cache", (PyCFunction)exit_factory_cache, METH_NOARGS, nullptr},
+  {"_set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
+  {"_is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"_clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -1,5 +1,7 @@
 #include <torch/csrc/autograd/input_buffer.h>
 
+#include <torch/csrc/autograd/grad_mode.h>
+
 #include <ATen/DeviceGuard.h>
 
 #include <cstddef>
@@ -8,6 +10,27 @@
 
 namespace torch { namespace autograd {
 
+// Note [Accumulating gradients in place]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// When a variable has several consumers, its gradient is summed here, once
+// per consumer. Allocating a new tensor for every sum is wasteful when one of
+// the operands isn't visible to anybody else: then we can steal it and add
+// the other one into it. That is only safe if
+//
+// - we're not building a graph of the backward pass (create_graph=False),
+//   because the in-place add would not be differentiable,
+// - nobody else holds the tensor (a function may return the same gradient
+//   several times, and the caller of backward() may hold grad_outputs), and
+//   no other tensor shares its storage (it's not a view or a base of one),
+// - it has the size and type of the sum, so add_ won't have to broadcast.
+static bool can_accumulate_into(const Variable& self, const Variable& other) {
+  return !GradMode::is_enabled() &&
+      !self.is_sparse() &&
+      self.use_count() == 1 &&
+      self.storage().use_count() == 1 &&
+      self.sizes().equals(other.sizes()) &&
+      self.type() == other.type();
+}
 
 void InputBuffer::add(size_t pos, Variable var) {
   AT_ASSERT(pos < buffer.size());
@@ -31,6 +54,11 @@ void InputBuffer::add(size_t pos, Variable var) {
     } else {
       if (var.is_sparse() && !old_var.is_sparse() && old_var.is_contiguous() && old_var.storage().use_count() == 1) {
           buffer[pos] = old_var.add_(var);
+      } else if (!var.is_sparse() && can_accumulate_into(old_var, var)) {
+          // See Note [Accumulating gradients in place]
+          old_var.add_(var);
+      } else if (!var.is_sparse() && can_accumulate_into(var, old_var)) {
+          buffer[pos] = var.add_(old_var);
       } else {
           buffer[pos] = old_var + var;
       }
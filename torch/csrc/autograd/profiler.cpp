@@ -1,6 +1,7 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/code_template.h>
 
+#include <atomic>
 #include <fstream>
 #include <list>
 #include <mutex>
@@ -26,6 +27,7 @@ std::mutex all_event_lists_mutex;
 std::list<std::shared_ptr<RangeEventList>> all_event_lists;
 thread_local std::shared_ptr<RangeEventList> event_list;
 thread_local uint16_t thread_id;
+std::atomic<uint64_t> next_correlation_id{1};
 
 ProfilerConfig::~ProfilerConfig() = default;
 
@@ -76,7 +78,8 @@ void pushRangeImpl(
         name,
         thread_id,
         state == ProfilerState::CUDA,
-        std::move(shapes));
+        std::move(shapes),
+        next_correlation_id++);
   }
 }
 
@@ -99,6 +102,19 @@ void popRange() {
   }
 }
 
+// Installed as the c10 memory reporter while profiling memory
+void reportMemoryEvent(void* /* unused */, int64_t alloc_size, at::Device device) {
+  if (state == ProfilerState::Disabled || state == ProfilerState::NVTX) {
+    return;
+  }
+  getEventList().record(
+      EventKind::MemoryAlloc,
+      StringView(""),
+      thread_id,
+      alloc_size,
+      device);
+}
+
 void enableProfiler(ProfilerConfig config) {
   ProfilerState new_state = config.state;
   AT_ASSERT(new_state != ProfilerState::Disabled);
@@ -134,6 +150,9 @@ void enableProfiler(ProfilerConfig config) {
       [](const RecordFunction& /* unused */) { popRange(); },
       config.report_input_shapes);
   state = new_state;
+  if (config.profile_memory && state != ProfilerState::NVTX) {
+    c10::SetMemoryReporter(reportMemoryEvent);
+  }
 
   if(state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
@@ -163,6 +182,7 @@ thread_event_lists disableProfiler() {
   mark("__stop_profile");
 
   popCallback();
+  c10::SetMemoryReporter(nullptr);
   state = ProfilerState::Disabled;
 
   if (old_state == ProfilerState::NVTX) {
@@ -188,7 +208,7 @@ thread_event_lists disableProfiler() {
 
 void Event::record(bool record_cuda) {
   if (record_cuda) {
-    cuda_stubs->record(&device_, &event, &cpu_ns_);
+    cuda_stubs->record(&device_, &event, &cpu_ns_, &stream_);
     return;
   }
   cpu_ns_ = getTime();
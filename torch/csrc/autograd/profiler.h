@@ -26,7 +26,11 @@ struct Function;
 namespace profiler {
 
 struct TORCH_API CUDAStubs {
-  virtual void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) {
+  virtual void record(
+      int* device,
+      CUDAEventStub* event,
+      int64_t* cpu_ns,
+      int64_t* stream) {
     fail();
   }
   virtual float elapsed(CUDAEventStub event, CUDAEventStub event2) {
@@ -102,17 +106,26 @@ enum class TORCH_API ProfilerState {
 };
 
 struct TORCH_API ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      bool profile_memory = false)
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        profile_memory(profile_memory) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
+  // Record a MemoryAlloc event for every allocation and free of the caching
+  // allocators, see c10::reportMemoryUsage
+  bool profile_memory;
 };
 
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
-  PopRange
+  PopRange,
+  MemoryAlloc
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -124,20 +137,38 @@ struct TORCH_API Event final {
       StringView name,
       uint16_t thread_id,
       bool record_cuda,
-      std::vector<std::vector<int64_t>>&& shapes = {})
+      std::vector<std::vector<int64_t>>&& shapes = {},
+      uint64_t correlation_id = 0)
       : name_(std::move(name)),
         kind_(kind),
         thread_id_(thread_id),
-        shapes_(shapes) {
+        shapes_(shapes),
+        correlation_id_(correlation_id) {
     record(record_cuda);
   }
 
+  // A MemoryAlloc event, `alloc_size` is negative for frees
+  Event(
+      EventKind kind,
+      StringView name,
+      uint16_t thread_id,
+      int64_t alloc_size,
+      at::Device device)
+      : name_(std::move(name)),
+        kind_(kind),
+        thread_id_(thread_id),
+        alloc_size_(alloc_size),
+        device_(device.is_cuda() ? device.index() : -1) {
+    record(/*record_cuda=*/false);
+  }
+
   void record(bool record_cuda);
   std::string kind() const {
     switch(kind_) {
       case EventKind::Mark: return "mark";
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
+      case EventKind::MemoryAlloc: return "memory_alloc";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -160,6 +191,18 @@ struct TORCH_API Event final {
   int device() const {
     return device_;
   }
+  // The id of the CUDA stream the event was recorded on
+  int64_t stream() const {
+    return stream_;
+  }
+  // Set on PushRange events, unique across all threads and the same for the
+  // CPU and CUDA sides of the range
+  uint64_t correlation_id() const {
+    return correlation_id_;
+  }
+  int64_t alloc_size() const {
+    return alloc_size_;
+  }
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -167,7 +210,10 @@ private:
   EventKind kind_;
   uint16_t thread_id_;
   std::vector<std::vector<int64_t>> shapes_;
+  uint64_t correlation_id_ = 0;
+  int64_t alloc_size_ = 0;
   int device_ = -1;
+  int64_t stream_ = 0;
   struct CUevent_st* event = nullptr;
 };
 
@@ -18,10 +18,15 @@ static inline void cudaCheck(cudaError_t result, const char * file, int line) {
 #define TORCH_CUDA_CHECK(result) cudaCheck(result,__FILE__,__LINE__);
 
 struct CUDAMethods : public CUDAStubs {
-  void record(int* device, CUDAEventStub* event, int64_t* cpu_ns) override {
+  void record(
+      int* device,
+      CUDAEventStub* event,
+      int64_t* cpu_ns,
+      int64_t* stream_id) override {
     TORCH_CUDA_CHECK(cudaGetDevice(device));
     TORCH_CUDA_CHECK(cudaEventCreate(event));
     auto stream = at::cuda::getCurrentCUDAStream();
+    *stream_id = stream.id();
     *cpu_ns = getTime();
     TORCH_CUDA_CHECK(cudaEventRecord(*event, stream));
   }
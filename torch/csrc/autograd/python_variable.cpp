@@ -460,6 +460,104 @@ static PyMappingMethods THPVariable_as_mapping = {
   THPVariable_setitem,
 };
 
+#if PY_MAJOR_VERSION >= 3
+// Buffer protocol export of CPU tensors, so that memoryview(t) or
+// np.frombuffer(t, ...) share the memory of the tensor without a copy. As with
+// Tensor.numpy(), the storage of an exported tensor is no longer resizable.
+struct THPVariableBufferInfo {
+  std::vector<Py_ssize_t> shape;
+  std::vector<Py_ssize_t> strides;
+};
+
+static const char* buffer_format(ScalarType scalar_type) {
+  switch (scalar_type) {
+    case kDouble: return "d";
+    case kFloat: return "f";
+    case kHalf: return "e";
+    case kLong: return "q";
+    case kInt: return "i";
+    case kShort: return "h";
+    case kChar: return "b";
+    case kByte: return "B";
+    case kBool: return "?";
+    default: return nullptr;
+  }
+}
+
+static bool is_fortran_contiguous(const Tensor& tensor) {
+  int64_t expected = 1;
+  for (int64_t d = 0; d < tensor.dim(); d++) {
+    if (tensor.size(d) != 1 && tensor.stride(d) != expected) {
+      return false;
+    }
+    expected *= tensor.size(d);
+  }
+  return true;
+}
+
+static int THPVariable_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+  HANDLE_TH_ERRORS
+  view->obj = nullptr;
+  auto& self_ = reinterpret_cast<THPVariable*>(self)->cdata;
+  const char* format = buffer_format(self_.scalar_type());
+  if (self_.type().backend() != Backend::CPU || !format) {
+    PyErr_Format(PyExc_BufferError, "the buffer protocol is not supported for %s",
+                 self_.type().toString().c_str());
+    return -1;
+  }
+  if (self_.requires_grad()) {
+    PyErr_SetString(PyExc_BufferError,
+        "can't export the buffer of a Variable that requires grad. "
+        "Use var.detach() instead.");
+    return -1;
+  }
+  bool c_contiguous = self_.is_contiguous();
+  bool f_contiguous = is_fortran_contiguous(self_);
+  if (((flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS && !c_contiguous) ||
+      ((flags & PyBUF_F_CONTIGUOUS) == PyBUF_F_CONTIGUOUS && !f_contiguous) ||
+      ((flags & PyBUF_ANY_CONTIGUOUS) == PyBUF_ANY_CONTIGUOUS && !c_contiguous && !f_contiguous) ||
+      ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !c_contiguous)) {
+    PyErr_SetString(PyExc_BufferError,
+        "the tensor is not contiguous in the way the buffer request needs. "
+        "Use tensor.contiguous() first.");
+    return -1;
+  }
+
+  auto info = new THPVariableBufferInfo();
+  const auto element_size = self_.element_size();
+  for (int64_t d = 0; d < self_.dim(); d++) {
+    info->shape.push_back(self_.size(d));
+    info->strides.push_back(self_.stride(d) * element_size);
+  }
+  // Use the private storage API
+  self_.storage().unsafeGetStorageImpl()->set_resizable(false);
+
+  view->buf = self_.data_ptr();
+  view->obj = self;
+  Py_INCREF(self);
+  view->len = self_.numel() * element_size;
+  view->readonly = 0;
+  view->itemsize = element_size;
+  view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(format) : nullptr;
+  view->ndim = self_.dim();
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? info->shape.data() : nullptr;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? info->strides.data() : nullptr;
+  view->suboffsets = nullptr;
+  view->internal = info;
+  return 0;
+  END_HANDLE_TH_ERRORS_RET(-1)
+}
+
+static void THPVariable_releasebuffer(PyObject* self, Py_buffer* view) {
+  delete static_cast<THPVariableBufferInfo*>(view->internal);
+}
+
+static PyBufferProcs THPVariable_as_buffer = {
+  (getbufferproc)THPVariable_getbuffer,
+  (releasebufferproc)THPVariable_releasebuffer,
+};
+#endif
+
 static PyMethodDef extra_methods[] = {
   {"_make_subclass", (PyCFunction)THPVariable_make_subclass, METH_STATIC | METH_VARARGS | METH_KEYWORDS, nullptr},
   {nullptr}
@@ -484,7 +582,11 @@ PyTypeObject THPVariableType = {
   nullptr,                                     /* tp_str */
   nullptr,                                     /* tp_getattro */
   nullptr,                                     /* tp_setattro */
+#if PY_MAJOR_VERSION >= 3
+  &THPVariable_as_buffer,                /* tp_as_buffer */
+#else
   nullptr,                                     /* tp_as_buffer */
+#endif
   Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /* tp_flags */
   nullptr,                               /* tp_doc */
   (traverseproc)THPVariable_traverse,    /* tp_traverse */
@@ -14,6 +14,7 @@
 
 #include <ATen/DeviceGuard.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/InitialTensorOptions.h>
 #include <c10/core/TensorOptions.h>
 #include <ATen/core/LegacyTypeDispatch.h>
 
@@ -270,6 +271,113 @@ static THPObjectPtr wrapTuple(PyObject* index) {
   return res;
 }
 
+static bool isIntList(PyObject* obj) {
+  if (!PyList_Check(obj)) {
+    return false;
+  }
+  auto size = PyList_GET_SIZE(obj);
+  for (Py_ssize_t i = 0; i < size; i++) {
+    if (!THPUtils_checkLong(PyList_GET_ITEM(obj, i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Converts a list of Python ints indexing dimension `dim` of `self` to a
+// kLong index on the device of `self`, wrapping negative indices so that the
+// result can be passed to index_select.
+static Variable intListToIndex(const Variable& self, int64_t dim, PyObject* list, int64_t real_dim) {
+  auto size = PyList_GET_SIZE(list);
+  auto length = self.size(dim);
+  auto index = at::empty({size}, at::initialTensorOptions().dtype(kLong));
+  auto index_data = index.data<int64_t>();
+  for (Py_ssize_t i = 0; i < size; i++) {
+    int64_t value = THPUtils_unpackLong(PyList_GET_ITEM(list, i));
+    if (value < -length || value >= length) {
+      throw IndexError("index %lld is out of bounds for dimension %lld with size %lld",
+        value, real_dim, length);
+    }
+    index_data[i] = value < 0 ? value + length : value;
+  }
+  auto index_var = autograd::make_variable(index, /*requires_grad=*/false);
+  return self.is_cuda() ? index_var.to(self.device()) : index_var;
+}
+
+// Fast paths for the most common advanced indexing patterns, which skip the
+// index tensors that applySlicing builds for them and the broadcasting of
+// index():
+//
+//   x[mask]                    mask of the size of x     -> masked_select
+//   x[[1, 5, 9]]               list of Python ints       -> index_select
+//   x[:, 1:3, [1, 5, 9], ...]  slices, an ellipsis and a single int list
+//
+// Returns an undefined Variable when `index` is anything else. The tracer
+// always takes the general path, so that traces do not depend on the pattern.
+static Variable applyFastIndexing(const Variable& self, PyObject* index) {
+  if (jit::tracer::isTracing() || self.dim() == 0) {
+    return Variable();
+  }
+  if (THPVariable_Check(index)) {
+    auto& mask = THPVariable_Unpack(index);
+    auto scalar_type = mask.scalar_type();
+    if ((scalar_type == kByte || scalar_type == kBool) &&
+        mask.sizes().equals(self.sizes()) && mask.device() == self.device()) {
+      AutoNoGIL no_gil;
+      return self.masked_select(mask);
+    }
+    return Variable();
+  }
+  if (isIntList(index)) {
+    auto list_index = intListToIndex(self, 0, index, 0);
+    AutoNoGIL no_gil;
+    return self.index_select(0, list_index);
+  }
+  if (!PyTuple_Check(index)) {
+    return Variable();
+  }
+
+  // a tuple of slices, at most one ellipsis and exactly one int list
+  auto size = PyTuple_GET_SIZE(index);
+  int64_t list_pos = -1;
+  bool has_ellipsis = false;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i);
+    if (PySlice_Check(obj)) {
+      continue;
+    } else if (obj == Py_Ellipsis && !has_ellipsis) {
+      has_ellipsis = true;
+    } else if (list_pos < 0 && isIntList(obj)) {
+      list_pos = i;
+    } else {
+      return Variable();
+    }
+  }
+  int64_t specified_dims = size - (has_ellipsis ? 1 : 0);
+  if (list_pos < 0 || specified_dims > self.dim()) {
+    return Variable();
+  }
+
+  Variable result = self;
+  int64_t dim = 0;
+  int64_t list_dim = 0;
+  for (Py_ssize_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i);
+    if (PySlice_Check(obj)) {
+      result = applySlice(result, dim, obj);
+      dim++;
+    } else if (obj == Py_Ellipsis) {
+      dim += self.dim() - specified_dims;
+    } else {
+      list_dim = dim;
+      dim++;
+    }
+  }
+  auto list_index = intListToIndex(result, list_dim, PyTuple_GET_ITEM(index, list_pos), list_dim);
+  AutoNoGIL no_gil;
+  return result.index_select(list_dim, list_index);
+}
+
 PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
   HANDLE_TH_ERRORS
   auto& self_ = reinterpret_cast<THPVariable*>(self)->cdata;
@@ -286,6 +394,12 @@ PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
     return wrap(applySlice(self_, 0, index, true));
   }
 
+  // handle simple advanced indexing: masks and int lists
+  Variable fast_result = applyFastIndexing(self_, index);
+  if (fast_result.defined()) {
+    return wrap(fast_result);
+  }
+
   // wrap index in a tuple if it's not already one
   THPObjectPtr holder = wrapTuple(index);
 
@@ -2,6 +2,7 @@
 #include <torch/csrc/autograd/function.h>
 
 #include <cstdlib>
+#include <random>
 
 namespace torch { namespace autograd { namespace profiler {
 
@@ -34,6 +35,29 @@ bool checkCallbacksSampled() {
   return is_sampled_callbacks;
 }
 
+// Instead of flipping a coin for every call, draws the number of calls to
+// skip before the next sampled one from the geometric distribution, so that
+// a call that isn't sampled only decrements a thread local counter.
+bool sampleNextCall() {
+  thread_local std::minstd_rand generator{std::random_device{}()};
+  thread_local double generator_prob = -1.0;
+  thread_local int64_t calls_to_skip = 0;
+  double prob = sampling_prob;
+  if (prob < kEps) {
+    return false;
+  }
+  if (generator_prob != prob) {
+    generator_prob = prob;
+    calls_to_skip = std::geometric_distribution<int64_t>(prob)(generator);
+  }
+  if (calls_to_skip > 0) {
+    --calls_to_skip;
+    return false;
+  }
+  calls_to_skip = std::geometric_distribution<int64_t>(prob)(generator);
+  return true;
+}
+
 void pushCallback(
     RecordFunctionCallback start,
     RecordFunctionCallback end,
@@ -2,6 +2,7 @@
 
 #include <ATen/core/ivalue.h>
 #include <c10/util/SmallVector.h>
+#include <c10/util/static_tracepoint.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
 namespace torch { namespace autograd {
@@ -96,9 +97,10 @@ TORCH_API void setSamplingProbability(double);
 TORCH_API double getSamplingProbability();
 TORCH_API bool checkCallbacksSampled();
 
+TORCH_API bool sampleNextCall();
+
 inline bool checkCallbacksEnabled() {
-  return !checkCallbacksSampled() ||
-      (((double) std::rand() / RAND_MAX) < getSamplingProbability());
+  return !checkCallbacksSampled() || sampleNextCall();
 }
 
 // optional argument - function's seq_no
@@ -114,6 +116,24 @@ inline bool checkCallbacksEnabled() {
     } \
   }
 
+// Fires the pytorch:op_dispatch_entry and pytorch:op_dispatch_exit static
+// tracepoints (see c10/util/static_tracepoint.h) with the operator name on
+// construction and destruction. Unlike RecordFunction it does not need any
+// callbacks to be registered, and costs a nop when no tracer is attached.
+struct OpDispatchTracepoints {
+  explicit OpDispatchTracepoints(const char* name) : name_(name) {
+    C10_SDT(op_dispatch_entry, name_);
+  }
+  ~OpDispatchTracepoints() {
+    C10_SDT(op_dispatch_exit, name_);
+  }
+ private:
+  const char* name_;
+};
+
+#define RECORD_OP_DISPATCH(name) \
+  torch::autograd::profiler::OpDispatchTracepoints op_dispatch_tracepoints(name)
+
 // WARNING: all calls to pushCallback/popCallback are not thread safe and
 // must not overlap with other code execution
 using RecordFunctionCallback = std::function<void(const RecordFunction&)>;
@@ -0,0 +1,186 @@
+#include <torch/csrc/autograd/sampling_profiler.h>
+
+#include <torch/csrc/autograd/profiler.h>
+#include <torch/csrc/autograd/record_function.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Must be a power of two
+constexpr size_t kRingBufferSize = 4096;
+
+struct Sample {
+  uint32_t name_id;
+  uint64_t latency_ns;
+};
+
+// The samples of one thread, see Note [Sampling profiler]. The ring buffer
+// has a single writer (the owning thread) and a single reader (whoever
+// holds state_mutex), so head and tail are enough to synchronize them.
+struct ThreadSamples {
+  std::array<Sample, kRingBufferSize> ring;
+  // The next slot the owning thread writes to
+  std::atomic<size_t> head{0};
+  // The next slot the reader reads from
+  std::atomic<size_t> tail{0};
+
+  // Only used by the owning thread
+  std::vector<int64_t> start_times;
+  std::unordered_map<std::string, uint32_t> name_ids;
+};
+
+// Guards everything below, except dropped_samples
+std::mutex state_mutex;
+bool enabled = false;
+double prev_sampling_prob = 1.0;
+std::vector<std::shared_ptr<ThreadSamples>> all_thread_samples;
+std::vector<std::string> interned_names;
+std::unordered_map<std::string, uint32_t> interned_ids;
+// Indexed by name id
+std::vector<OpLatencyHistogram> histograms;
+
+std::atomic<uint64_t> dropped_samples{0};
+
+ThreadSamples& threadSamples() {
+  thread_local std::shared_ptr<ThreadSamples> samples;
+  if (!samples) {
+    samples = std::make_shared<ThreadSamples>();
+    samples->start_times.reserve(64);
+    std::lock_guard<std::mutex> guard(state_mutex);
+    all_thread_samples.push_back(samples);
+  }
+  return *samples;
+}
+
+uint32_t internName(ThreadSamples& samples, const char* name) {
+  std::string key(name);
+  auto it = samples.name_ids.find(key);
+  if (it != samples.name_ids.end()) {
+    return it->second;
+  }
+  uint32_t id;
+  {
+    std::lock_guard<std::mutex> guard(state_mutex);
+    auto interned = interned_ids.emplace(key, interned_names.size());
+    if (interned.second) {
+      interned_names.push_back(key);
+    }
+    id = interned.first->second;
+  }
+  samples.name_ids.emplace(std::move(key), id);
+  return id;
+}
+
+void onStart(const RecordFunction&) {
+  threadSamples().start_times.push_back(getTime());
+}
+
+void onEnd(const RecordFunction& fn) {
+  auto& samples = threadSamples();
+  // ops that started before the profiler was enabled
+  if (samples.start_times.empty()) {
+    return;
+  }
+  int64_t latency = getTime() - samples.start_times.back();
+  samples.start_times.pop_back();
+  uint32_t name_id = internName(samples, fn.name().str());
+
+  size_t head = samples.head.load(std::memory_order_relaxed);
+  size_t tail = samples.tail.load(std::memory_order_acquire);
+  if (head - tail == kRingBufferSize) {
+    dropped_samples.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  samples.ring[head & (kRingBufferSize - 1)] =
+      Sample{name_id, static_cast<uint64_t>(std::max<int64_t>(latency, 0))};
+  samples.head.store(head + 1, std::memory_order_release);
+}
+
+size_t latencyBucket(uint64_t latency_ns) {
+  size_t bucket = 0;
+  while (latency_ns >>= 1) {
+    ++bucket;
+  }
+  return std::min(bucket, kNumLatencyBuckets - 1);
+}
+
+// Must be called with state_mutex held
+void drainThreadSamples() {
+  histograms.resize(interned_names.size());
+  for (auto& samples : all_thread_samples) {
+    size_t tail = samples->tail.load(std::memory_order_relaxed);
+    size_t head = samples->head.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      const Sample& sample = samples->ring[tail & (kRingBufferSize - 1)];
+      auto& histogram = histograms.at(sample.name_id);
+      ++histogram.count;
+      histogram.total_ns += sample.latency_ns;
+      ++histogram.buckets[latencyBucket(sample.latency_ns)];
+    }
+    samples->tail.store(head, std::memory_order_release);
+  }
+}
+
+} // namespace
+
+void enableSamplingProfiler(double sampling_prob) {
+  {
+    std::lock_guard<std::mutex> guard(state_mutex);
+    if (enabled) {
+      throw std::runtime_error("the sampling profiler is already enabled");
+    }
+    enabled = true;
+    // drop the samples of a previous session
+    drainThreadSamples();
+    histograms.clear();
+  }
+  dropped_samples = 0;
+  prev_sampling_prob = getSamplingProbability();
+  setSamplingProbability(sampling_prob);
+  pushCallback(onStart, onEnd);
+}
+
+void disableSamplingProfiler() {
+  {
+    std::lock_guard<std::mutex> guard(state_mutex);
+    if (!enabled) {
+      throw std::runtime_error(
+          "can't disable the sampling profiler when it's not running");
+    }
+    enabled = false;
+  }
+  popCallback();
+  setSamplingProbability(prev_sampling_prob);
+}
+
+bool isSamplingProfilerEnabled() {
+  std::lock_guard<std::mutex> guard(state_mutex);
+  return enabled;
+}
+
+std::vector<OpLatencyHistogram> sampledOpLatencies() {
+  std::lock_guard<std::mutex> guard(state_mutex);
+  drainThreadSamples();
+  std::vector<OpLatencyHistogram> result;
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    if (histograms[i].count > 0) {
+      result.push_back(histograms[i]);
+      result.back().name = interned_names[i];
+    }
+  }
+  return result;
+}
+
+uint64_t droppedOpSamples() {
+  return dropped_samples.load(std::memory_order_relaxed);
+}
+
+}}} // namespace torch::autograd::profiler
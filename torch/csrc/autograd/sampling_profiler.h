@@ -0,0 +1,52 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Note [Sampling profiler]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// The sampling profiler is meant to be left on in production. It records
+// the latency of a random sample of the ops that go through RecordFunction
+// (see setSamplingProbability), and aggregates them into per-op latency
+// histograms. To keep the overhead of a sampled op low:
+//
+// - every thread writes its samples into its own preallocated ring buffer,
+//   which sampledOpLatencies() drains. Samples are dropped rather than
+//   blocking the thread when its buffer is full.
+// - op names are interned, so that a sample is just a name id and a latency.
+//
+// While the sampling profiler is enabled, the sampling probability applies
+// to all RecordFunction callbacks, including the ones of the regular
+// profiler. Like pushCallback/popCallback, enabling and disabling it is not
+// thread safe, and callbacks pushed after enabling it have to be popped
+// before disabling it.
+
+constexpr size_t kNumLatencyBuckets = 32;
+
+struct TORCH_API OpLatencyHistogram {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  // buckets[i] counts the samples that took [2^i, 2^(i+1)) ns, except that
+  // the first bucket also counts samples under 1ns, and the last one all
+  // samples above its lower bound.
+  std::array<uint64_t, kNumLatencyBuckets> buckets{};
+};
+
+TORCH_API void enableSamplingProfiler(double sampling_prob);
+TORCH_API void disableSamplingProfiler();
+TORCH_API bool isSamplingProfilerEnabled();
+
+// Returns the histograms of all ops sampled since the sampling profiler was
+// last enabled, one per op name.
+TORCH_API std::vector<OpLatencyHistogram> sampledOpLatencies();
+// The number of samples dropped because a ring buffer was full.
+TORCH_API uint64_t droppedOpSamples();
+
+}}} // namespace torch::autograd::profiler
@@ -14,6 +14,16 @@
 
 namespace torch { namespace autograd {
 
+thread_local bool OffloadSavedVariablesMode_enabled = false;
+
+bool OffloadSavedVariablesMode::is_enabled() {
+  return OffloadSavedVariablesMode_enabled;
+}
+
+void OffloadSavedVariablesMode::set_enabled(bool enabled) {
+  OffloadSavedVariablesMode_enabled = enabled;
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -23,6 +33,16 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output) {
     // These copies are all shared_ptr copies, so slightly more expensive.
     // Do them here instead of in the init list in case data is undefined.
     data_ = variable.data();
+    // See Note [Offloading saved variables]
+    if (OffloadSavedVariablesMode::is_enabled() && data_.is_cuda() &&
+        !variable.is_leaf()) {
+      auto host_data = at::empty(
+          data_.sizes(),
+          data_.options().device(at::kCPU).pinned_memory(true));
+      host_data.copy_(data_, /*non_blocking=*/true);
+      offload_device_ = data_.device();
+      data_ = std::move(host_data);
+    }
     if (variable.is_leaf()) {
       grad_accumulator_ = variable.grad_accumulator();
     } else if (!is_output) {
@@ -75,14 +95,20 @@ Variable SavedVariable::unpack(std::shared_ptr<Function> saved_for) const {
     throw std::runtime_error(message.str());
   }
 
+  // See Note [Offloading saved variables]
+  at::Tensor data = data_;
+  if (offload_device_) {
+    data = data_.to(*offload_device_, data_.scalar_type(), /*non_blocking=*/true);
+  }
+
   // NB: saved views are unpacked as normal Variables (not views) even though
   // they still share the same storage. This works only because we never call
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   var.set_version_counter(saved_version_);
 
@@ -14,6 +14,33 @@ struct Function;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+// Note [Offloading saved variables]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// While offloading is enabled, SavedVariables created on the current thread
+// copy the data of CUDA tensors to pinned host memory and drop their
+// reference to the device memory, which is copied back when the variable is
+// unpacked in the backward pass. Both copies are asynchronous on the current
+// stream. This only frees device memory if nothing else holds the saved
+// tensor, so leaves (e.g. parameters, which stay alive anyway) are never
+// offloaded.
+struct TORCH_API OffloadSavedVariablesMode {
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+};
+
+// A RAII, thread local (!) guard that enables or disables offloading upon
+// construction, and sets it back to the original value upon destruction.
+struct TORCH_API AutoOffloadSavedVariables {
+  AutoOffloadSavedVariables(bool enabled)
+    : prev_mode(OffloadSavedVariablesMode::is_enabled()) {
+    OffloadSavedVariablesMode::set_enabled(enabled);
+  }
+  ~AutoOffloadSavedVariables() {
+    OffloadSavedVariablesMode::set_enabled(prev_mode);
+  }
+  bool prev_mode;
+};
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -38,6 +65,9 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // The device data_ was on if it has been offloaded to the host, see
+  // Note [Offloading saved variables]
+  c10::optional<at::Device> offload_device_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -176,7 +176,7 @@ void Variable::Impl::set_data(const at::Tensor &new_data) {
   auto new_data_impl_copy = new_data.getIntrusivePtr()->shallow_copy_and_detach(
     /*version_counter=*/data_.unsafeGetTensorImpl()->version_counter(),
     /*allow_tensor_metadata_change=*/true);
-  data_ = std::move(at::Tensor(new_data_impl_copy));
+  data_ = at::Tensor(std::move(new_data_impl_copy));
 }
 
 void Variable::Impl::release_resources() {
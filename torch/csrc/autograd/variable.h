@@ -549,7 +549,7 @@ inline Variable make_variable_view(
       auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
         /*version_counter=*/0,
         /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
-      auto data_copy = at::Tensor(data_impl_copy);
+      auto data_copy = at::Tensor(std::move(data_impl_copy));
       auto diff_view_meta = c10::guts::make_unique<Variable::DifferentiableViewMeta>();
       return Variable(c10::make_intrusive<Variable::DifferentiableViewImpl>(
               std::move(base), std::move(data_copy), std::move(gradient_edge), std::move(diff_view_meta)));
@@ -558,7 +558,7 @@ inline Variable make_variable_view(
       auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
         /*version_counter=*/base.version_counter(),
         /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
-      auto data_copy = at::Tensor(data_impl_copy);
+      auto data_copy = at::Tensor(std::move(data_impl_copy));
       auto autograd_meta = c10::guts::make_unique<Variable::AutogradMeta>();
       auto var = Variable(c10::make_intrusive<Variable::Impl>(
               std::move(data_copy), std::move(autograd_meta), false, std::move(gradient_edge)));
@@ -579,9 +579,9 @@ inline Variable make_variable(
     auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
       /*version_counter=*/0,
       /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
-    auto data_copy = at::Tensor(data_impl_copy);
+    auto data_copy = at::Tensor(std::move(data_impl_copy));
     auto autograd_meta = c10::guts::make_unique<Variable::AutogradMeta>();
-    return Variable(c10::make_intrusive<Variable::Impl>(data_copy, std::move(autograd_meta), requires_grad));
+    return Variable(c10::make_intrusive<Variable::Impl>(std::move(data_copy), std::move(autograd_meta), requires_grad));
   }
   return Variable();
 }
@@ -613,9 +613,9 @@ inline Variable make_variable(
     auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
       /*version_counter=*/0,
       /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
-    auto data_copy = at::Tensor(data_impl_copy);
+    auto data_copy = at::Tensor(std::move(data_impl_copy));
     auto autograd_meta = c10::guts::make_unique<Variable::AutogradMeta>();
-    return Variable(c10::make_intrusive<Variable::Impl>(data_copy, std::move(autograd_meta), false, std::move(gradient_edge)));
+    return Variable(c10::make_intrusive<Variable::Impl>(std::move(data_copy), std::move(autograd_meta), false, std::move(gradient_edge)));
   }
   return Variable();
 }
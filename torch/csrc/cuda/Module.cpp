@@ -7,7 +7,9 @@
 #include <TH/TH.h>
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraph.h>
 #include <c10/cuda/CUDACachingAllocator.h>
+#include <THC/THCCachingHostAllocator.h>
 #ifdef USE_NCCL
 #include <nccl.h>
 #endif
@@ -230,6 +232,35 @@ PyObject * THCPModule_cudaSleep(PyObject *_unused, PyObject *cycles)
   END_HANDLE_TH_ERRORS
 }
 
+// Makes all future work on the `consumer` stream wait for the work queued on
+// the `producer` stream so far. Both are raw cudaStream_t handles on the
+// current device, so that they can come from other libraries, e.g. when
+// exchanging tensors through DLPack.
+PyObject * THCPModule_cudaStreamWaitStream(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *consumer_obj = nullptr;
+  PyObject *producer_obj = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &consumer_obj, &producer_obj)) {
+    return nullptr;
+  }
+  THPUtils_assert(THPUtils_checkLong(consumer_obj) && THPUtils_checkLong(producer_obj),
+      "torch.cuda._stream_wait_stream(): expected raw stream handles as 'int'");
+  auto consumer = static_cast<cudaStream_t>(PyLong_AsVoidPtr(consumer_obj));
+  auto producer = static_cast<cudaStream_t>(PyLong_AsVoidPtr(producer_obj));
+  if (consumer != producer) {
+    cudaEvent_t event;
+    THCudaCheck(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    THCudaCheck(cudaEventRecord(event, producer));
+    THCudaCheck(cudaStreamWaitEvent(consumer, event, 0));
+    // Destroying a recorded event is fine, its resources are released once the
+    // wait on it completes.
+    THCudaCheck(cudaEventDestroy(event));
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 // We need to ensure that as long as a thread will NEVER loose the GIL as long as
 // it holds the CUDA mutex. Otherwise another thread might be scheduled and try to
 // e.g. allocate a new tensor which will cause a deadlock. It's enough to have a
@@ -334,6 +365,86 @@ PyObject * THCPModule_resetMaxMemoryCached(PyObject *_unused, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+PyObject * THCPModule_memorySnapshot(PyObject *_unused)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::SegmentInfo;
+  using c10::cuda::CUDACachingAllocator::BlockInfo;
+  std::vector<SegmentInfo> snapshot = c10::cuda::CUDACachingAllocator::snapshot();
+  py::list result;
+  for (const SegmentInfo& segment_info : snapshot) {
+    py::dict segment;
+    segment["device"] = segment_info.device;
+    segment["address"] = segment_info.address;
+    segment["stream"] = segment_info.stream;
+    segment["total_size"] = segment_info.total_size;
+    segment["allocated_size"] = segment_info.allocated_size;
+    segment["segment_type"] = segment_info.is_large ? "large" : "small";
+    segment["is_expandable"] = segment_info.is_expandable;
+    py::list blocks;
+    for (const BlockInfo& block_info : segment_info.blocks) {
+      py::dict block;
+      block["size"] = block_info.size;
+      block["state"] = block_info.allocated ? "active_allocated" :
+          (block_info.event_count > 0 ? "active_pending_free" : "inactive");
+      block["stream_uses"] = block_info.stream_uses;
+      block["event_count"] = block_info.event_count;
+      if (!block_info.history.empty()) {
+        block["history"] = block_info.history;
+      }
+      blocks.append(block);
+    }
+    segment["blocks"] = blocks;
+    result.append(segment);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_memoryEventCounts(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to memory_event_counts");
+  int device = (int) THPUtils_unpackLong(arg);
+  auto counts = c10::cuda::CUDACachingAllocator::eventCounts(device);
+  py::dict result;
+  result["num_allocs"] = counts.num_allocs;
+  result["num_frees"] = counts.num_frees;
+  result["num_cuda_mallocs"] = counts.num_cuda_mallocs;
+  result["num_cuda_frees"] = counts.num_cuda_frees;
+  result["num_alloc_retries"] = counts.num_alloc_retries;
+  result["num_ooms"] = counts.num_ooms;
+  result["num_splits"] = counts.num_splits;
+  result["num_merges"] = counts.num_merges;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  auto stats = THCCachingHostAllocator_getStats();
+  py::dict result;
+  result["allocated_bytes"] = stats.allocated_bytes;
+  result["cached_bytes"] = stats.cached_bytes;
+  result["num_allocs"] = stats.num_allocs;
+  result["num_host_allocs"] = stats.num_host_allocs;
+  result["num_host_frees"] = stats.num_host_frees;
+  result["num_splits"] = stats.num_splits;
+  result["num_merges"] = stats.num_merges;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(PyBool_Check(arg), "invalid argument to _record_memory_history");
+  c10::cuda::CUDACachingAllocator::recordHistory(arg == Py_True);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -361,6 +472,18 @@ static void bindCudaDeviceProperties(PyObject* module) {
   }, py::return_value_policy::reference);
 }
 
+static void bindCUDAGraph(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<at::cuda::CUDAGraph>(m, "_CUDAGraph")
+    .def(py::init<>())
+    .def("capture_begin", &at::cuda::CUDAGraph::capture_begin)
+    .def("capture_end", &at::cuda::CUDAGraph::capture_end)
+    .def("replay", &at::cuda::CUDAGraph::replay,
+         py::call_guard<py::gil_scoped_release>())
+    .def("reset", &at::cuda::CUDAGraph::reset,
+         py::call_guard<py::gil_scoped_release>());
+}
+
 // Callback for python part. Used for additional initialization of python classes
 static PyObject * THCPModule_initExtension(PyObject *self)
 {
@@ -398,6 +521,7 @@ static PyObject * THCPModule_initExtension(PyObject *self)
   set_module_attr("_state_cdata", _state_cdata.get());
 
   bindCudaDeviceProperties(m);
+  bindCUDAGraph(m);
 
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
@@ -445,6 +569,10 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_memoryCached", (PyCFunction) THCPModule_memoryCached, METH_O,  nullptr},
   {"_cuda_maxMemoryCached", (PyCFunction) THCPModule_maxMemoryCached, METH_O,  nullptr},
   {"_cuda_resetMaxMemoryCached", (PyCFunction) THCPModule_resetMaxMemoryCached, METH_O,  nullptr},
+  {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS,  nullptr},
+  {"_cuda_memoryEventCounts", (PyCFunction) THCPModule_memoryEventCounts, METH_O,  nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS,  nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_O,  nullptr},
   {"_cuda_manualSeed",  (PyCFunction)THCPModule_manualSeed,       METH_O,       nullptr},
   {"_cuda_manualSeedAll", (PyCFunction)THCPModule_manualSeedAll,  METH_O,       nullptr},
   {"_cuda_seed",        (PyCFunction)THCPModule_seed,             METH_NOARGS,  nullptr},
@@ -454,6 +582,7 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
   {"_cuda_sleep", (PyCFunction)THCPModule_cudaSleep, METH_O, nullptr},
+  {"_cuda_streamWaitStream", (PyCFunction)THCPModule_cudaStreamWaitStream, METH_VARARGS, nullptr},
   {"_cuda_lock_mutex",   (PyCFunction)THCPModule_cudaLockMutex,   METH_NOARGS,  nullptr},
   {"_cuda_unlock_mutex", (PyCFunction)THCPModule_cudaUnlockMutex, METH_NOARGS,  nullptr},
 #ifdef USE_NCCL
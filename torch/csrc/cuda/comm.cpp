@@ -46,6 +46,15 @@ struct unique_type_checker {
   bool unique = true;
 };
 
+// NOTE [ Tree broadcast ]
+//
+// A copy between two devices runs on the current stream of the source device,
+// so copying a tensor from devices[0] to every other device would serialize
+// all the copies on a single stream. Without NCCL, the devices that already
+// hold the tensor instead copy it to the devices that don't, in rounds. Every
+// round doubles the number of devices holding the tensor, and the copies of a
+// round run on the streams of different source devices, in parallel. The
+// broadcast to N devices takes ceil(log2(N)) rounds instead of N - 1 copies.
 std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
   if (tensor.is_cuda() && tensor.get_device() != devices[0])
     throw std::runtime_error("device of broadcasted tensor must appear as the "
@@ -65,16 +74,20 @@ std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
 #else
   {
 #endif
-    if (tensor.is_cuda()) {
-      tensors.push_back(tensor);
-    }
-    IntArrayRef loop_devices = tensor.is_cuda() ? devices.slice(1) : devices;
-    for (auto device : loop_devices) {
-      tensors.push_back(tensor.to(
+    // See NOTE [ Tree broadcast ]
+    auto copy_to = [](const Tensor& src, int64_t device) {
+      return src.to(
           at::Device(kCUDA, device),
-          tensor.scalar_type(),
+          src.scalar_type(),
           /*non_blocking=*/true,
-          /*copy=*/true));
+          /*copy=*/true);
+    };
+    tensors.push_back(tensor.is_cuda() ? tensor : copy_to(tensor, devices[0]));
+    tensors.resize(devices.size());
+    for (size_t have = 1; have < devices.size(); have *= 2) {
+      for (size_t src = 0; src < have && have + src < devices.size(); ++src) {
+        tensors[have + src] = copy_to(tensors[src], devices[have + src]);
+      }
     }
   }
   return tensors;
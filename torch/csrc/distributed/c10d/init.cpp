@@ -3,6 +3,7 @@
 #include <c10d/FileStore.hpp>
 #include <c10d/ProcessGroup.hpp>
 #include <c10d/ProcessGroupGloo.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
 
 #ifdef USE_C10D_NCCL
 #include <c10d/ProcessGroupNCCL.hpp>
@@ -21,6 +22,9 @@
 #include <torch/csrc/distributed/c10d/comm.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/distributed/rpc/process_group_agent.h>
+#include <torch/csrc/distributed/rpc/sharded_embedding.h>
+#include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -35,6 +39,28 @@ constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
 template <typename T>
 using shared_ptr_class_ = py::class_<T, std::shared_ptr<T>>;
 
+// A communication hook implemented by a Python callable, which takes the list
+// of bucket replica tensors and returns the work that reduces them.
+class PythonCommHook : public ::c10d::CommHookInterface {
+ public:
+  explicit PythonCommHook(py::object hook) : hook_(std::move(hook)) {}
+
+  ~PythonCommHook() override {
+    py::gil_scoped_acquire acquire;
+    hook_ = py::object();
+  }
+
+  std::shared_ptr<::c10d::ProcessGroup::Work> runHook(
+      std::vector<at::Tensor>& tensors) override {
+    py::gil_scoped_acquire acquire;
+    py::object work = hook_(tensors);
+    return work.cast<std::shared_ptr<::c10d::ProcessGroup::Work>>();
+  }
+
+ private:
+  py::object hook_;
+};
+
 PyObject* c10d_init(PyObject* _unused) {
   auto c10d_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
   if (!c10d_module) {
@@ -44,10 +70,21 @@ PyObject* c10d_init(PyObject* _unused) {
   auto module = py::handle(c10d_module).cast<py::module>();
 
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
-      .def(py::init<
-           std::vector<std::vector<torch::autograd::Variable>>,
-           std::vector<std::vector<size_t>>,
-           std::shared_ptr<::c10d::ProcessGroup>>())
+      .def(
+          py::init<
+              std::vector<std::vector<torch::autograd::Variable>>,
+              std::vector<std::vector<size_t>>,
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::vector<size_t>,
+              bool,
+              std::vector<std::vector<bool>>>(),
+          py::arg("replicas"),
+          py::arg("bucket_indices"),
+          py::arg("process_group"),
+          py::arg("bucket_size_limits") = std::vector<size_t>(),
+          py::arg("fp16_compression") = false,
+          py::arg("expect_sparse_gradients") =
+              std::vector<std::vector<bool>>())
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
@@ -61,7 +98,15 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def("get_bucket_indices", &::c10d::Reducer::get_bucket_indices)
+      .def(
+          "_register_comm_hook",
+          [](::c10d::Reducer& reducer, py::object hook) {
+            reducer.register_comm_hook(
+                torch::make_unique<PythonCommHook>(std::move(hook)));
+          },
+          py::arg("hook"));
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class of available reduce operations: ``SUM``, ``PRODUCT``,
@@ -112,6 +157,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def_readwrite("reduceOp", &::c10d::ReduceScatterOptions::reduceOp)
       .def_readwrite("timeout", &::c10d::ReduceScatterOptions::timeout);
 
+  py::class_<::c10d::AllToAllOptions>(module, "AllToAllOptions")
+      .def(py::init<>())
+      .def_readwrite("timeout", &::c10d::AllToAllOptions::timeout);
+
   py::class_<::c10d::BarrierOptions>(module, "BarrierOptions")
       .def(py::init<>())
       .def_readwrite("timeout", &::c10d::BarrierOptions::timeout);
@@ -159,7 +208,55 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                std::vector<py::bytes> result;
+                result.reserve(values.size());
+                for (auto& value : values) {
+                  result.emplace_back(
+                      reinterpret_cast<char*>(value.data()), value.size());
+                }
+                return result;
+              })
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) -> py::bytes {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<char*>(value.data()), value.size());
+              });
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -226,6 +323,17 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("op") = ::c10d::ReduceOp::SUM,
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "allreduce_coalesced",
+              [](::c10d::ProcessGroup& pg,
+                 std::vector<at::Tensor>& xs,
+                 ::c10d::AllreduceOptions opts) {
+                return pg.allreduce_coalesced(xs, opts);
+              },
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::AllreduceOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "reduce",
               &::c10d::ProcessGroup::reduce,
@@ -344,6 +452,16 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "alltoall_base",
+              &::c10d::ProcessGroup::alltoall_base,
+              py::arg("output_tensor"),
+              py::arg("input_tensor"),
+              py::arg("output_split_sizes"),
+              py::arg("input_split_sizes"),
+              py::arg("opts") = ::c10d::AllToAllOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "send",
               &::c10d::ProcessGroup::send,
@@ -450,13 +568,25 @@ They are used in specifying strategies for reduction collectives, e.g.,
               const std::shared_ptr<::c10d::Store>&,
               int,
               int,
-              const std::string&>(),
+              const std::string&,
+              const std::chrono::milliseconds&>(),
           py::arg("store"),
           py::arg("rank"),
           py::arg("size"),
-          py::arg("groupName") = "");
+          py::arg("groupName") = "",
+          py::arg("timeout") = ::c10d::Store::kNoTimeout,
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
+  shared_ptr_class_<::c10d::ProcessGroupHierarchical>(
+      module, "ProcessGroupHierarchical", processGroup)
+      .def(
+          py::init<
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("intra_group"),
+          py::arg("inter_group"));
+
 #ifdef USE_C10D_MPI
   auto processGroupMPI = shared_ptr_class_<::c10d::ProcessGroupMPI>(
       module, "ProcessGroupMPI", processGroup);
@@ -482,6 +612,65 @@ They are used in specifying strategies for reduction collectives, e.g.,
           &::c10d::ProcessGroup::Work::wait,
           py::call_guard<py::gil_scoped_release>());
 
+  auto rpcAgent =
+      shared_ptr_class_<::torch::distributed::rpc::RpcAgent>(module, "RpcAgent")
+          .def(
+              "join",
+              &::torch::distributed::rpc::RpcAgent::join,
+              py::call_guard<py::gil_scoped_release>());
+
+  shared_ptr_class_<::torch::distributed::rpc::ProcessGroupAgent>(
+      module, "ProcessGroupAgent", rpcAgent)
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, int>(),
+          py::arg("process_group"),
+          py::arg("num_threads") = 4,
+          py::call_guard<py::gil_scoped_release>());
+
+  shared_ptr_class_<::torch::distributed::rpc::ShardedEmbedding>(
+      module, "ShardedEmbedding")
+      .def(
+          py::init<
+              std::shared_ptr<::torch::distributed::rpc::RpcAgent>,
+              std::string,
+              std::vector<int>,
+              int64_t>(),
+          py::arg("agent"),
+          py::arg("name"),
+          py::arg("servers"),
+          py::arg("embedding_dim"))
+      .def(
+          "lookup",
+          &::torch::distributed::rpc::ShardedEmbedding::lookup,
+          py::arg("indices"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "update",
+          &::torch::distributed::rpc::ShardedEmbedding::update,
+          py::arg("indices"),
+          py::arg("grad"),
+          py::arg("lr"),
+          py::call_guard<py::gil_scoped_release>());
+
+  module.def(
+      "_embedding_shard",
+      &::torch::distributed::rpc::embeddingShard,
+      py::arg("weight"),
+      py::arg("shard"),
+      py::arg("num_shards"));
+
+  module.def(
+      "_register_embedding_shard",
+      [](const std::shared_ptr<::torch::distributed::rpc::RpcAgent>& agent,
+         const std::string& name,
+         at::Tensor shard) {
+        ::torch::distributed::rpc::registerEmbeddingShard(
+            *agent, name, std::move(shard));
+      },
+      py::arg("agent"),
+      py::arg("name"),
+      py::arg("shard"));
+
 #ifdef USE_CUDA
   module.def(
       "_dist_bucket_tensors",
@@ -533,6 +722,7 @@ They are used in specifying strategies for reduction collectives, e.g.,
       &::c10d::compute_bucket_assignment_by_size,
       py::arg("tensors"),
       py::arg("bucket_size"),
+      py::arg("expect_sparse_gradient") = std::vector<bool>(),
       py::call_guard<py::gil_scoped_release>());
 
   module.def(
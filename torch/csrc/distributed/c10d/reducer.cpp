@@ -38,20 +38,81 @@ inline int64_t current_time_in_nanos() {
 
 } // namespace
 
+// Note [Rebuilding buckets]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// Buckets are reduced strictly in order, so a bucket that is complete has to
+// wait for all buckets before it. The initial assignment guesses that
+// gradients become ready in reverse order of the parameter definitions.
+// When the guess is wrong, communication does not overlap with the rest of
+// the backward pass. If the reducer is given bucket size limits, it records
+// the order in which variables of the first replica are marked ready during
+// the first iteration. At the start of the second iteration it recomputes the
+// bucket assignment over that order. Hook order is not guaranteed to be the
+// same across processes, so the order recorded by rank 0 is broadcast first.
+// Every process then computes the same assignment. This happens only once.
+//
+// Note [FP16 gradient compression]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// With fp16 compression, a bucket replica holding float or double gradients
+// also holds a half precision `compressed` tensor. Once the bucket is ready,
+// its (already prescaled) contents are cast into this tensor. The half
+// precision tensor is what gets allreduced, which halves the bytes sent
+// compared to float. After the reduction has completed, the result is cast
+// back into the contents before they are copied to the gradients. Because
+// the prescaling happens before the cast, the values summed in half
+// precision are averages rather than sums, which keeps them in range.
+//
+// Note [Sparse gradient buckets]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Sparse gradients cannot be flattened into the contents of a bucket, so a
+// variable that gets sparse gradients (e.g. the weight of an embedding with
+// `sparse=True`) is alone in its bucket. Such a bucket allocates no contents:
+// once the gradient is ready, the gradient itself becomes the contents and is
+// allreduced in place by the process group, which must support sparse
+// tensors. This sends the nonzero rows only, instead of the densified table.
+//
+// Note [Communication hooks]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// By default, the contents of a dense bucket are divided by the number of
+// processes and allreduced, which averages the gradients. A registered
+// communication hook replaces both steps: it gets the contents as they were
+// copied from the gradients, and is responsible for turning them into the
+// gradients to use, in place, by the time its work completes. It can thereby
+// send less than the full contents (e.g. a low-rank approximation or the
+// largest entries), or skip the communication in some iterations. Sparse
+// buckets are always allreduced.
+
 Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
-    std::shared_ptr<c10d::ProcessGroup> process_group)
+    std::shared_ptr<c10d::ProcessGroup> process_group,
+    std::vector<size_t> bucket_size_limits,
+    bool fp16_compression,
+    std::vector<std::vector<bool>> expect_sparse_gradients)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_autograd_hooks_(false),
       require_finalize_(false),
       has_marked_unused_parameters_(false),
       next_bucket_(0),
+      bucket_size_limits_(std::move(bucket_size_limits)),
+      should_rebuild_buckets_(!bucket_size_limits_.empty()),
+      fp16_compression_(fp16_compression),
+      expect_sparse_gradients_(std::move(expect_sparse_gradients)),
       backward_stats_base_(0) {
   AT_ASSERTM(replicas_.size() >= 1, "Expected at least one model replica.");
   AT_ASSERTM(replicas_[0].size() >= 1, "Expected at least one parameter.");
 
+  // If `expect_sparse_gradients` is not specified, no variable is expected
+  // to get sparse gradients.
+  if (expect_sparse_gradients_.empty()) {
+    expect_sparse_gradients_ = std::vector<std::vector<bool>>(
+        replicas_.size(), std::vector<bool>(replicas_[0].size(), false));
+  }
+  AT_ASSERTM(
+      expect_sparse_gradients_.size() == replicas_.size(),
+      "Expected a sparse gradient flag list for every model replica.");
+
   // Verify that all specified variables require gradients,
   // and that they have the same size across replicas.
   {
@@ -75,6 +136,11 @@ Reducer::Reducer(
             replicas_[replica_index][variable_index].dtype() ==
                 replicas_[0][variable_index].dtype(),
             "Variables across model replicas must have identical dtype.");
+        AT_ASSERTM(
+            expect_sparse_gradients_[replica_index].size() == variable_count &&
+                expect_sparse_gradients_[replica_index][variable_index] ==
+                    expect_sparse_gradients_[0][variable_index],
+            "Expected the same sparse gradient flags across model replicas.");
       }
     }
   }
@@ -198,25 +264,41 @@ void Reducer::mark_variable_ready(
   auto& variable = replica.variables[bucket_index.intra_bucket_index];
   const auto offset = replica.offsets[bucket_index.intra_bucket_index];
   const auto length = replica.lengths[bucket_index.intra_bucket_index];
-
-  // Copy contents of gradient tensor to bucket tensor.
-  // If the gradient is not set, we assume it wasn't computed
-  // as part of the current backwards pass, and zero the part
-  // of the bucket it would otherwise hold.
-  auto bucket_view = replica.contents.narrow(0, offset, length);
   auto& grad = variable.grad();
-  if (grad.defined()) {
+
+  if (bucket.expect_sparse_gradient) {
+    // The gradient is reduced in place. See Note [Sparse gradient buckets].
+    AT_ASSERTM(
+        grad.defined() && grad.is_sparse(),
+        "Expected a sparse gradient for a variable in a sparse bucket. ",
+        "This error is caused by a parameter that is expected to get sparse ",
+        "gradients but was unused or got a dense gradient.");
+    replica.contents = grad;
+  } else {
+    // Copy contents of gradient tensor to bucket tensor.
+    // If the gradient is not set, we assume it wasn't computed
+    // as part of the current backwards pass, and zero the part
+    // of the bucket it would otherwise hold.
+    auto bucket_view = replica.contents.narrow(0, offset, length);
+    if (grad.defined()) {
     // Assert that the grad tensor and the bucket don't share storage.
     // If they did, we could avoid the copy altogether.
     // The reason for not doing this is that existing code calls
     // `detach_` from `zero_grad`, which is incompatible with views.
-    AT_ASSERT(!grad.is_alias_of(bucket_view));
-    AT_ASSERT(grad.type() == variable.type());
-    AT_ASSERT(grad.device() == variable.device());
-    AT_ASSERT(grad.numel() == length);
-    bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
-  } else {
-    bucket_view.zero_();
+      AT_ASSERT(!grad.is_alias_of(bucket_view));
+      AT_ASSERT(grad.type() == variable.type());
+      AT_ASSERT(grad.device() == variable.device());
+      AT_ASSERT(grad.numel() == length);
+      bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
+    } else {
+      bucket_view.zero_();
+    }
+  }
+
+  // Record the order in which gradients are ready to rebuild the buckets.
+  // See Note [Rebuilding buckets].
+  if (should_rebuild_buckets_ && replica_index == 0) {
+    rebuilt_param_indices_.push_back(variable_index);
   }
 
   // TODO(@pietern): Make this work for both CPU/CUDA tensors.
@@ -228,7 +310,11 @@ void Reducer::mark_variable_ready(
   // Check if this was the final gradient for this bucket.
   if (--replica.pending == 0) {
     // Prescale bucket contents to turn the global sum into the global average.
-    replica.contents.div_(process_group_->getSize());
+    // A communication hook does its own scaling.
+    // See Note [Communication hooks].
+    if (!comm_hook_ || bucket.expect_sparse_gradient) {
+      replica.contents.div_(process_group_->getSize());
+    }
     // Kick off reduction if all replicas for this bucket are ready.
     if (--bucket.pending == 0) {
       mark_bucket_ready(bucket_index.bucket_index);
@@ -276,16 +362,46 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       // these operations are implicitly sequenced, and we don't need to
       // do any extra synchronization here.
       //
-      tensors.push_back(replica.contents);
+      if (replica.compressed.defined()) {
+        // See Note [FP16 gradient compression].
+        replica.compressed.copy_(replica.contents, /* non_blocking */ true);
+        tensors.push_back(replica.compressed);
+      } else {
+        tensors.push_back(replica.contents);
+      }
+    }
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      // See Note [Communication hooks].
+      bucket.work = comm_hook_->runHook(tensors);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
     }
-    bucket.work = process_group_->allreduce(tensors);
   }
 }
 
+void Reducer::register_comm_hook(
+    std::unique_ptr<CommHookInterface> comm_hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AT_ASSERTM(
+      comm_hook_ == nullptr,
+      "A communication hook can only be registered once.");
+  AT_ASSERTM(
+      !expect_autograd_hooks_ && !require_finalize_,
+      "A communication hook must be registered before the backward pass.");
+  AT_ASSERTM(
+      !fp16_compression_,
+      "A communication hook cannot be combined with fp16 compression.");
+  comm_hook_ = std::move(comm_hook);
+}
+
 void Reducer::initialize_buckets(
     std::vector<std::vector<size_t>> bucket_indices) {
   std::lock_guard<std::mutex> lock(mutex_);
+  initialize_buckets_locked(std::move(bucket_indices));
+}
 
+void Reducer::initialize_buckets_locked(
+    std::vector<std::vector<size_t>> bucket_indices) {
   // This shouldn't be called if we're expecting autograd hooks to fire.
   AT_ASSERTM(
       !expect_autograd_hooks_,
@@ -310,6 +426,21 @@ void Reducer::initialize_buckets(
     AT_ASSERTM(
         bucket_indices[bucket_index].size() > 0, "Empty bucket specified.");
 
+    // Variables that get sparse gradients must be alone in their bucket.
+    // See Note [Sparse gradient buckets].
+    for (const auto variable_index : bucket_indices[bucket_index]) {
+      AT_ASSERTM(
+          variable_index < expect_sparse_gradients_[0].size(),
+          "Out of range variable index specified.");
+      if (expect_sparse_gradients_[0][variable_index]) {
+        AT_ASSERTM(
+            bucket_indices[bucket_index].size() == 1,
+            "Expected a variable that gets sparse gradients to be the only ",
+            "variable in its bucket.");
+        bucket.expect_sparse_gradient = true;
+      }
+    }
+
     // Iterate over model replicas.
     for (size_t replica_index = 0; replica_index < replica_count;
          replica_index++) {
@@ -344,6 +475,13 @@ void Reducer::initialize_buckets(
         offset += length;
       }
 
+      // The contents of a sparse bucket are its gradient.
+      // See Note [Sparse gradient buckets].
+      if (bucket.expect_sparse_gradient) {
+        bucket.replicas.push_back(std::move(replica));
+        continue;
+      }
+
       // Allocate bucket contents tensor.
       // This must be a Variable because as of Apr 2019 there is still
       // a distinction between the Tensor and Variable types, and it
@@ -351,6 +489,15 @@ void Reducer::initialize_buckets(
       replica.contents = torch::autograd::make_variable_consuming(
           at::empty({static_cast<long>(offset)}, options));
 
+      // Allocate the half precision copy that is reduced instead.
+      // See Note [FP16 gradient compression].
+      const auto scalar_type = c10::typeMetaToScalarType(options.dtype());
+      if (fp16_compression_ &&
+          (scalar_type == at::kFloat || scalar_type == at::kDouble)) {
+        replica.compressed = torch::autograd::make_variable_consuming(
+            at::empty({static_cast<long>(offset)}, options.dtype(at::kHalf)));
+      }
+
       // Add bucket replica to enclosing bucket.
       bucket.replicas.push_back(std::move(replica));
     }
@@ -372,6 +519,69 @@ void Reducer::initialize_buckets(
   }
 }
 
+std::vector<std::vector<size_t>> Reducer::get_bucket_indices() const {
+  std::vector<std::vector<size_t>> bucket_indices(buckets_.size());
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    bucket_indices[bucket_index].resize(
+        buckets_[bucket_index].replicas[0].variables.size());
+  }
+  for (size_t variable_index = 0; variable_index < variable_locators_.size();
+       variable_index++) {
+    const auto& locator = variable_locators_[variable_index];
+    bucket_indices[locator.bucket_index][locator.intra_bucket_index] =
+        variable_index;
+  }
+  return bucket_indices;
+}
+
+// Recompute the bucket assignment from the order in which gradients were
+// marked ready in the previous iteration. See Note [Rebuilding buckets].
+// The caller must hold `mutex_`.
+void Reducer::rebuild_buckets() {
+  const auto variable_count = replicas_[0].size();
+  AT_ASSERT(rebuilt_param_indices_.size() == variable_count);
+
+  // Use the order observed by rank 0 on all processes. The broadcast has to
+  // run on the device of the parameters, for backends like NCCL that only
+  // support CUDA tensors.
+  auto local_order = at::empty({static_cast<long>(variable_count)}, at::kLong);
+  auto local_order_accessor = local_order.accessor<int64_t, 1>();
+  for (size_t i = 0; i < variable_count; i++) {
+    local_order_accessor[i] = rebuilt_param_indices_[i];
+  }
+  std::vector<at::Tensor> tensors = {local_order.to(replicas_[0][0].device())};
+  process_group_->broadcast(tensors)->wait();
+  const auto order = tensors[0].cpu();
+  auto order_accessor = order.accessor<int64_t, 1>();
+
+  std::vector<size_t> variable_indices(variable_count);
+  std::vector<at::Tensor> variables;
+  std::vector<bool> expect_sparse_gradient;
+  variables.reserve(variable_count);
+  expect_sparse_gradient.reserve(variable_count);
+  for (size_t i = 0; i < variable_count; i++) {
+    variable_indices[i] = order_accessor[i];
+    AT_ASSERTM(
+        variable_indices[i] < variable_count,
+        "Out of range variable index in rebuilt bucket order.");
+    variables.push_back(replicas_[0][variable_indices[i]]);
+    expect_sparse_gradient.push_back(
+        expect_sparse_gradients_[0][variable_indices[i]]);
+  }
+
+  // The assignment is computed over the variables in ready order, so the
+  // resulting buckets index into that order and are sorted by it.
+  auto bucket_indices = compute_bucket_assignment_by_size(
+      variables, bucket_size_limits_, expect_sparse_gradient);
+  for (auto& bucket : bucket_indices) {
+    for (auto& index : bucket) {
+      index = variable_indices[index];
+    }
+  }
+  initialize_buckets_locked(std::move(bucket_indices));
+}
+
 // Traverse the autograd graph starting at the specified output.
 // All parameters for which we have a pointer to their gradient accumulation
 // functions and don't show up in this graph can be marked as ready
@@ -410,6 +620,16 @@ void Reducer::prepare_for_backward(
         "list, dict, iterable).");
   }
 
+  // Rebuild the buckets once the order of a complete iteration is known.
+  // See Note [Rebuilding buckets].
+  if (should_rebuild_buckets_) {
+    if (rebuilt_param_indices_.size() == replicas_[0].size()) {
+      rebuild_buckets();
+      should_rebuild_buckets_ = false;
+    }
+    rebuilt_param_indices_.clear();
+  }
+
   // Reset accounting.
   has_marked_unused_parameters_ = true;
   expect_autograd_hooks_ = true;
@@ -483,7 +703,16 @@ void Reducer::finalize_backward() {
   for (auto& bucket : buckets_) {
     AT_ASSERT(bucket.work);
     bucket.work->wait();
+    // Sparse gradients were reduced in place.
+    // See Note [Sparse gradient buckets].
+    if (bucket.expect_sparse_gradient) {
+      continue;
+    }
     for (auto& replica : bucket.replicas) {
+      if (replica.compressed.defined()) {
+        // See Note [FP16 gradient compression].
+        replica.contents.copy_(replica.compressed);
+      }
       for (size_t intra_bucket_index = 0;
            intra_bucket_index < replica.variables.size();
            intra_bucket_index++) {
@@ -531,7 +760,12 @@ inline bool operator==(const BucketKey& lhs, const BucketKey& rhs) {
 // of device placement and will not allow buckets to span devices.
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
     const std::vector<at::Tensor>& tensors,
-    std::vector<size_t> bucket_size_limits) {
+    std::vector<size_t> bucket_size_limits,
+    const std::vector<bool>& expect_sparse_gradient) {
+  AT_ASSERTM(
+      expect_sparse_gradient.empty() ||
+          expect_sparse_gradient.size() == tensors.size(),
+      "Expected a sparse gradient flag for every tensor.");
   std::vector<std::vector<size_t>> result;
   result.reserve(tensors.size());
 
@@ -556,6 +790,14 @@ std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
   for (size_t i = 0; i < tensors.size(); i++) {
     const auto& tensor = tensors[i];
     AT_ASSERTM(!tensor.is_sparse(), "No support for sparse tensors.");
+
+    // Tensors that get sparse gradients get a bucket of their own.
+    // See Note [Sparse gradient buckets].
+    if (!expect_sparse_gradient.empty() && expect_sparse_gradient[i]) {
+      result.push_back({i});
+      continue;
+    }
+
     auto key = BucketKey(tensor.scalar_type(), tensor.device());
     auto& bucket = buckets[key];
     bucket.indices.push_back(i);
@@ -13,16 +13,48 @@
 
 namespace c10d {
 
+// A communication hook replaces the allreduce of the dense buckets of a
+// `Reducer`, e.g. to compress gradients before they are sent, or to average
+// them only every few iterations. See Note [Communication hooks].
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() = default;
+
+  // Kicks off the reduction of a bucket, given the flattened contents of its
+  // replicas, and returns the work that completes it. Once the work has
+  // completed, the tensors must hold the reduced gradients, which replace the
+  // gradients of the variables in the bucket.
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(
+      std::vector<at::Tensor>& tensors) = 0;
+};
+
 class Reducer {
  public:
   // The constructor takes a list of variables for every model replica.
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  //
+  // If `bucket_size_limits` is non-empty, the buckets are rebuilt once after
+  // the first iteration, using `compute_bucket_assignment_by_size` with these
+  // limits on the order in which gradients became ready in that iteration.
+  // See Note [Rebuilding buckets].
+  //
+  // If `fp16_compression` is set, the contents of floating point buckets are
+  // cast to half precision before they are reduced.
+  // See Note [FP16 gradient compression].
+  //
+  // If `expect_sparse_gradients` is non-empty, it holds a flag for every
+  // variable of every replica that is set if the variable gets sparse
+  // gradients. Such a variable must be alone in its bucket.
+  // See Note [Sparse gradient buckets].
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
-      std::shared_ptr<c10d::ProcessGroup> process_group);
+      std::shared_ptr<c10d::ProcessGroup> process_group,
+      std::vector<size_t> bucket_size_limits = {},
+      bool fp16_compression = false,
+      std::vector<std::vector<bool>> expect_sparse_gradients = {});
 
   // To (re-)initialize bucket assignment, pass a list of buckets, each
   // of which is specified by a list of indices in the variables list.
@@ -44,6 +76,16 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Returns the current bucket assignment, as a list of buckets of indices
+  // into the variables list of a single replica, in reduction order.
+  std::vector<std::vector<size_t>> get_bucket_indices() const;
+
+  // Registers a hook that reduces the dense buckets instead of an allreduce
+  // of the process group. It can only be registered once, before the first
+  // backward pass, and is incompatible with fp16 compression.
+  // See Note [Communication hooks].
+  void register_comm_hook(std::unique_ptr<CommHookInterface> comm_hook);
+
  protected:
   std::mutex mutex_;
   std::vector<std::vector<torch::autograd::Variable>> replicas_;
@@ -58,6 +100,25 @@ class Reducer {
   bool has_marked_unused_parameters_;
   size_t next_bucket_;
 
+  // Bucket size limits to rebuild the buckets with after the first iteration.
+  const std::vector<size_t> bucket_size_limits_;
+  // Set until the buckets have been rebuilt.
+  bool should_rebuild_buckets_;
+  // Indices of variables of the first replica, in the order they were marked
+  // ready during the current iteration (only recorded until rebuilt).
+  std::vector<size_t> rebuilt_param_indices_;
+
+  const bool fp16_compression_;
+
+  std::unique_ptr<CommHookInterface> comm_hook_;
+
+  std::vector<std::vector<bool>> expect_sparse_gradients_;
+
+  void initialize_buckets_locked(
+      std::vector<std::vector<size_t>> bucket_indices);
+
+  void rebuild_buckets();
+
   void mark_variable_ready(
       size_t replica_index,
       size_t variable_index,
@@ -82,6 +143,11 @@ class Reducer {
     // Flattened (1 dimensional) contents of bucket.
     at::Tensor contents;
 
+    // Half precision copy of `contents` that is reduced in its place if
+    // fp16 compression is enabled and `contents` is float or double.
+    // Undefined otherwise.
+    at::Tensor compressed;
+
     // Variables that contribute to this bucket replica. Use refcounted value
     // here so that we can easily unflatten the bucket contents into the
     // participating variables after reduction has completed.
@@ -115,6 +181,10 @@ class Reducer {
 
     // Keep work handle around when this set of buckets is being reduced.
     std::shared_ptr<c10d::ProcessGroup::Work> work;
+
+    // Set if this bucket holds a single variable that gets sparse gradients.
+    // See Note [Sparse gradient buckets].
+    bool expect_sparse_gradient = false;
   };
 
   std::vector<Bucket> buckets_;
@@ -142,6 +212,7 @@ class Reducer {
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
     const std::vector<at::Tensor>& tensors,
-    std::vector<size_t> bucket_size);
+    std::vector<size_t> bucket_size,
+    const std::vector<bool>& expect_sparse_gradient = {});
 
 } // namespace c10d
@@ -0,0 +1,112 @@
+#include <torch/csrc/distributed/rpc/message.h>
+
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/pickler.h>
+
+#include <cstring>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+void writeInt(std::vector<char>& buffer, int64_t value) {
+  const char* begin = reinterpret_cast<const char*>(&value);
+  buffer.insert(buffer.end(), begin, begin + sizeof(value));
+}
+
+int64_t readInt(const char*& data, const char* end) {
+  TORCH_CHECK(data + sizeof(int64_t) <= end, "Truncated RPC message");
+  int64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  data += sizeof(value);
+  return value;
+}
+
+} // namespace
+
+Message::Message(
+    MessageType type,
+    int64_t id,
+    const std::vector<c10::IValue>& values)
+    : type(type), id(id) {
+  jit::Pickler pickler(&tensors);
+  pickler.start();
+  pickler.startTuple();
+  for (const auto& value : values) {
+    pickler.addIValue(value);
+  }
+  pickler.endTuple();
+  pickler.finish();
+  payload = pickler.stack();
+}
+
+std::vector<c10::IValue> Message::values() const {
+  jit::Unpickler unpickler(
+      const_cast<char*>(payload.data()), payload.size(), &tensors);
+  return unpickler.parse_ivalue_list();
+}
+
+// The buffer holds the type, id, payload size and number of tensors of the
+// message, then the payload, then for each tensor its dtype, its number of
+// dimensions, its sizes and its data.
+std::vector<char> Message::serialize() const {
+  std::vector<at::Tensor> contiguous;
+  contiguous.reserve(tensors.size());
+  size_t size = (4 + tensors.size() * 2) * sizeof(int64_t) + payload.size();
+  for (const auto& tensor : tensors) {
+    contiguous.push_back(tensor.cpu().contiguous());
+    size += tensor.dim() * sizeof(int64_t) + contiguous.back().nbytes();
+  }
+
+  std::vector<char> buffer;
+  buffer.reserve(size);
+  writeInt(buffer, static_cast<int64_t>(type));
+  writeInt(buffer, id);
+  writeInt(buffer, payload.size());
+  writeInt(buffer, tensors.size());
+  buffer.insert(buffer.end(), payload.begin(), payload.end());
+  for (const auto& tensor : contiguous) {
+    writeInt(buffer, static_cast<int64_t>(tensor.scalar_type()));
+    writeInt(buffer, tensor.dim());
+    for (auto s : tensor.sizes()) {
+      writeInt(buffer, s);
+    }
+    const char* data = static_cast<const char*>(tensor.data_ptr());
+    buffer.insert(buffer.end(), data, data + tensor.nbytes());
+  }
+  return buffer;
+}
+
+Message Message::deserialize(const char* data, size_t size) {
+  const char* end = data + size;
+  Message message;
+  message.type = static_cast<MessageType>(readInt(data, end));
+  message.id = readInt(data, end);
+  int64_t payload_size = readInt(data, end);
+  int64_t num_tensors = readInt(data, end);
+  TORCH_CHECK(payload_size <= end - data, "Truncated RPC message");
+  message.payload.assign(data, data + payload_size);
+  data += payload_size;
+  message.tensors.reserve(num_tensors);
+  for (int64_t i = 0; i < num_tensors; ++i) {
+    auto scalar_type = static_cast<at::ScalarType>(readInt(data, end));
+    std::vector<int64_t> sizes(readInt(data, end));
+    for (auto& s : sizes) {
+      s = readInt(data, end);
+    }
+    auto tensor = at::empty(sizes, at::device(at::kCPU).dtype(scalar_type));
+    TORCH_CHECK(
+        tensor.nbytes() <= static_cast<size_t>(end - data),
+        "Truncated RPC message");
+    std::memcpy(tensor.data_ptr(), data, tensor.nbytes());
+    data += tensor.nbytes();
+    message.tensors.push_back(autograd::make_variable(std::move(tensor)));
+  }
+  return message;
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
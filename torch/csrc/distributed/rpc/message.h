@@ -0,0 +1,48 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+enum class MessageType : int64_t {
+  // A call of the handler named by the first value, with the other values as
+  // arguments.
+  REQUEST = 0,
+  // The value returned by the handler of the request with the same id.
+  RESPONSE = 1,
+  // The error message of a request with the same id that failed.
+  EXCEPTION = 2,
+  // Stops the agent that receives it, see RpcAgent::join.
+  SHUTDOWN = 3,
+};
+
+// The unit of communication between RPC agents. The values of a message are
+// pickled with the JIT pickler, with the tensors they hold kept apart in
+// `tensors`, so that transports can send their data without copying it
+// into the pickle.
+struct Message {
+  Message() = default;
+  Message(MessageType type, int64_t id, const std::vector<c10::IValue>& values);
+
+  // Unpickles the values of the message.
+  std::vector<c10::IValue> values() const;
+
+  // Packs the message into a single buffer, and back. Tensors are sent as
+  // contiguous CPU tensors of the same dtype and sizes.
+  std::vector<char> serialize() const;
+  static Message deserialize(const char* data, size_t size);
+
+  MessageType type = MessageType::SHUTDOWN;
+  int64_t id = -1;
+  std::vector<char> payload;
+  std::vector<at::Tensor> tensors;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,99 @@
+#include <torch/csrc/distributed/rpc/process_group_agent.h>
+
+#include <cstring>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+constexpr int ProcessGroupAgent::kDefaultTag;
+
+ProcessGroupAgent::ProcessGroupAgent(
+    std::shared_ptr<c10d::ProcessGroup> process_group,
+    int num_threads,
+    int tag)
+    : RpcAgent(process_group->getRank(), process_group->getSize()),
+      process_group_(std::move(process_group)),
+      tag_(tag),
+      thread_pool_(num_threads) {
+  for (int i = 0; i < worldSize(); ++i) {
+    send_mutexes_.emplace_back(new std::mutex());
+  }
+  if (worldSize() > 1) {
+    listener_ = std::thread(&ProcessGroupAgent::listen, this);
+  }
+}
+
+ProcessGroupAgent::~ProcessGroupAgent() {
+  if (!joined_) {
+    join();
+  }
+}
+
+void ProcessGroupAgent::join() {
+  TORCH_CHECK(!joined_, "The RPC agent was already joined");
+  joined_ = true;
+  waitForPendingCalls();
+  // Once every worker got its responses, no more messages are in flight, and
+  // each worker stops the listener of the next one.
+  process_group_->barrier()->wait();
+  if (worldSize() > 1) {
+    send((rank() + 1) % worldSize(), Message());
+    listener_.join();
+  }
+  thread_pool_.waitWorkComplete();
+}
+
+void ProcessGroupAgent::send(int to, Message&& message) {
+  if (to == rank()) {
+    auto shared_message = std::make_shared<Message>(std::move(message));
+    thread_pool_.run([this, shared_message] {
+      processMessage(rank(), std::move(*shared_message));
+    });
+    return;
+  }
+
+  std::vector<char> buffer = message.serialize();
+  std::vector<at::Tensor> size = {at::empty({1}, at::kLong)};
+  size[0].data<int64_t>()[0] = buffer.size();
+  std::vector<at::Tensor> data = {at::from_blob(
+      buffer.data(), {static_cast<int64_t>(buffer.size())}, at::kChar)};
+
+  std::lock_guard<std::mutex> lock(*send_mutexes_[to]);
+  process_group_->send(size, to, tag_)->wait();
+  process_group_->send(data, to, tag_)->wait();
+}
+
+void ProcessGroupAgent::listen() {
+  while (true) {
+    std::vector<at::Tensor> size = {at::empty({1}, at::kLong)};
+    auto work = process_group_->recvAnysource(size, tag_);
+    work->wait();
+    const int from = work->sourceRank();
+
+    std::vector<at::Tensor> data = {
+        at::empty({size[0].data<int64_t>()[0]}, at::kChar)};
+    process_group_->recv(data, from, tag_)->wait();
+
+    // Message buffers start with the type, see Message::serialize.
+    int64_t type;
+    std::memcpy(&type, data[0].data_ptr(), sizeof(type));
+    if (static_cast<MessageType>(type) == MessageType::SHUTDOWN) {
+      return;
+    }
+
+    // Deserialization copies the tensors out of the buffer, so it is left to
+    // the pool as well.
+    at::Tensor buffer = data[0];
+    thread_pool_.run([this, from, buffer] {
+      processMessage(
+          from,
+          Message::deserialize(
+              static_cast<const char*>(buffer.data_ptr()), buffer.numel()));
+    });
+  }
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <c10/core/thread_pool.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// An RpcAgent that sends its messages with the point-to-point operations of a
+// c10d ProcessGroup, e.g. ProcessGroupGloo, with one worker per rank.
+//
+// Each message goes out as two sends to its destination: its size, then the
+// buffer of Message::serialize. A listener thread receives the sizes from
+// any source and then the buffers, and a pool of `num_threads` threads runs
+// the handlers, so that long handlers don't hold up other calls. Messages
+// between two workers are sent one at a time, and calls to the worker
+// itself don't go through the process group. The agent must be the only
+// user of `tag` on the process group, and the timeout of the process group
+// bounds how long a worker can go without receiving a message.
+class ProcessGroupAgent : public RpcAgent {
+ public:
+  explicit ProcessGroupAgent(
+      std::shared_ptr<c10d::ProcessGroup> process_group,
+      int num_threads = 4,
+      int tag = kDefaultTag);
+
+  // Joins if join() wasn't called. Like join(), this has to happen on every
+  // worker.
+  ~ProcessGroupAgent() override;
+
+  void join() override;
+
+  static constexpr int kDefaultTag = 0x72706300;
+
+ protected:
+  void send(int to, Message&& message) override;
+
+ private:
+  void listen();
+
+  std::shared_ptr<c10d::ProcessGroup> process_group_;
+  const int tag_;
+  // One lock per destination, held while the two parts of a message are sent
+  std::vector<std::unique_ptr<std::mutex>> send_mutexes_;
+  c10::ThreadPool thread_pool_;
+  std::thread listener_;
+  bool joined_ = false;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
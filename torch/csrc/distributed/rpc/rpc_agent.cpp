@@ -0,0 +1,131 @@
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+
+#include <c10/util/Exception.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+RpcAgent::RpcAgent(int rank, int world_size)
+    : rank_(rank), world_size_(world_size) {}
+
+void RpcAgent::registerHandler(const std::string& name, RpcHandler handler) {
+  std::lock_guard<std::mutex> lock(handlers_mutex_);
+  TORCH_CHECK(
+      handlers_.emplace(name, std::move(handler)).second,
+      "RPC handler '",
+      name,
+      "' is already registered");
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> RpcAgent::callAsync(
+    int to,
+    const std::string& name,
+    std::vector<c10::IValue> args) {
+  TORCH_CHECK(
+      to >= 0 && to < world_size_,
+      "Invalid RPC destination ",
+      to,
+      " for a group of ",
+      world_size_,
+      " workers");
+  args.insert(args.begin(), name);
+  const int64_t id = next_id_++;
+  auto future = c10::make_intrusive<c10::ivalue::Future>();
+  {
+    std::lock_guard<std::mutex> lock(futures_mutex_);
+    futures_.emplace(id, future);
+  }
+  try {
+    send(to, Message(MessageType::REQUEST, id, args));
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(futures_mutex_);
+    futures_.erase(id);
+    futures_cv_.notify_all();
+    throw;
+  }
+  return future;
+}
+
+c10::IValue RpcAgent::call(
+    int to,
+    const std::string& name,
+    std::vector<c10::IValue> args) {
+  auto future = callAsync(to, name, std::move(args));
+  future->wait();
+  return future->value();
+}
+
+void RpcAgent::processMessage(int from, Message&& message) {
+  switch (message.type) {
+    case MessageType::REQUEST:
+      send(from, runHandler(message));
+      break;
+    case MessageType::RESPONSE:
+    case MessageType::EXCEPTION: {
+      c10::intrusive_ptr<c10::ivalue::Future> future;
+      {
+        std::lock_guard<std::mutex> lock(futures_mutex_);
+        auto it = futures_.find(message.id);
+        TORCH_INTERNAL_ASSERT(
+            it != futures_.end(), "RPC response to an unknown request");
+        future = std::move(it->second);
+        futures_.erase(it);
+      }
+      std::vector<c10::IValue> values;
+      try {
+        values = message.values();
+      } catch (const std::exception& e) {
+        future->markCompleted(c10::ivalue::Future::FutureError(e.what()));
+        futures_cv_.notify_all();
+        break;
+      }
+      if (message.type == MessageType::RESPONSE) {
+        future->markCompleted(std::move(values.at(0)));
+      } else {
+        future->markCompleted(
+            c10::ivalue::Future::FutureError(
+                std::string(values.at(0).toStringRef())));
+      }
+      futures_cv_.notify_all();
+      break;
+    }
+    default:
+      TORCH_INTERNAL_ASSERT(false, "Unexpected RPC message type");
+  }
+}
+
+Message RpcAgent::runHandler(const Message& request) {
+  try {
+    auto args = request.values();
+    std::string name = args.at(0).toStringRef();
+    args.erase(args.begin());
+    RpcHandler handler;
+    {
+      std::lock_guard<std::mutex> lock(handlers_mutex_);
+      auto it = handlers_.find(name);
+      TORCH_CHECK(
+          it != handlers_.end(),
+          "Worker ",
+          rank_,
+          " has no RPC handler named '",
+          name,
+          "'");
+      handler = it->second;
+    }
+    return Message(
+        MessageType::RESPONSE, request.id, {handler(std::move(args))});
+  } catch (const std::exception& e) {
+    return Message(
+        MessageType::EXCEPTION, request.id, {std::string(e.what())});
+  }
+}
+
+void RpcAgent::waitForPendingCalls() {
+  std::unique_lock<std::mutex> lock(futures_mutex_);
+  futures_cv_.wait(lock, [this] { return futures_.empty(); });
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// A function that workers can call remotely. It runs on a thread of the
+// agent that received the call, and may run concurrently with other handlers
+// and with itself.
+using RpcHandler = std::function<c10::IValue(std::vector<c10::IValue>)>;
+
+// Note [RPC agents]
+// ~~~~~~~~~~~~~~~~~
+// An RpcAgent lets the workers of a group call functions on each other. Each
+// worker registers handlers under names, and `callAsync(to, name, args)`
+// returns a future that completes with the value returned by handler `name`
+// of worker `to`, or with its error. The arguments and results are any
+// IValues the JIT pickler can serialize, which includes tensors, strings,
+// numbers and (nested) lists and tuples of them.
+//
+// Subclasses implement the transport, by sending messages with `send` and
+// passing the messages they receive to `processMessage`. Handlers must be
+// registered before other workers can call them, so workers usually register
+// them all and synchronize before any call.
+class RpcAgent {
+ public:
+  RpcAgent(int rank, int world_size);
+  virtual ~RpcAgent() = default;
+
+  int rank() const {
+    return rank_;
+  }
+
+  int worldSize() const {
+    return world_size_;
+  }
+
+  void registerHandler(const std::string& name, RpcHandler handler);
+
+  c10::intrusive_ptr<c10::ivalue::Future> callAsync(
+      int to,
+      const std::string& name,
+      std::vector<c10::IValue> args);
+
+  // Blocks until the call completes, and returns its value or throws its
+  // error.
+  c10::IValue call(
+      int to,
+      const std::string& name,
+      std::vector<c10::IValue> args);
+
+  // Waits for the calls made by this worker to complete, then for every
+  // other worker to get there, and stops the agent. This is a collective
+  // call: every worker must join, and no calls may be made afterwards.
+  virtual void join() = 0;
+
+ protected:
+  virtual void send(int to, Message&& message) = 0;
+
+  // Runs the handler of a request and sends back its response, or completes
+  // the future of a response.
+  void processMessage(int from, Message&& message);
+
+  // Blocks until every call made by this worker has completed.
+  void waitForPendingCalls();
+
+ private:
+  Message runHandler(const Message& request);
+
+  const int rank_;
+  const int world_size_;
+
+  std::mutex handlers_mutex_;
+  std::unordered_map<std::string, RpcHandler> handlers_;
+
+  std::atomic<int64_t> next_id_{0};
+  std::mutex futures_mutex_;
+  std::condition_variable futures_cv_;
+  std::unordered_map<int64_t, c10::intrusive_ptr<c10::ivalue::Future>>
+      futures_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,141 @@
+#include <torch/csrc/distributed/rpc/sharded_embedding.h>
+
+#include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <mutex>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+std::string lookupHandler(const std::string& name) {
+  return "embedding_lookup/" + name;
+}
+
+std::string updateHandler(const std::string& name) {
+  return "embedding_update/" + name;
+}
+
+} // namespace
+
+at::Tensor embeddingShard(
+    const at::Tensor& weight,
+    int64_t shard,
+    int64_t num_shards) {
+  TORCH_CHECK(
+      shard >= 0 && shard < num_shards,
+      "Invalid shard ",
+      shard,
+      " of ",
+      num_shards);
+  return weight.slice(0, shard, weight.size(0), num_shards).clone();
+}
+
+void registerEmbeddingShard(
+    RpcAgent& agent,
+    const std::string& name,
+    at::Tensor shard) {
+  TORCH_CHECK(shard.dim() == 2, "Embedding shards must be 2-D");
+  auto update_mutex = std::make_shared<std::mutex>();
+  agent.registerHandler(
+      lookupHandler(name), [shard](std::vector<c10::IValue> args) {
+        autograd::AutoGradMode no_grad(false);
+        return c10::IValue(shard.index_select(0, args.at(0).toTensor()));
+      });
+  agent.registerHandler(
+      updateHandler(name),
+      [shard, update_mutex](std::vector<c10::IValue> args) mutable {
+        autograd::AutoGradMode no_grad(false);
+        auto step = args.at(1).toTensor().mul(-args.at(2).toDouble());
+        std::lock_guard<std::mutex> lock(*update_mutex);
+        shard.index_add_(0, args.at(0).toTensor(), step);
+        return c10::IValue();
+      });
+}
+
+ShardedEmbedding::ShardedEmbedding(
+    std::shared_ptr<RpcAgent> agent,
+    std::string name,
+    std::vector<int> servers,
+    int64_t embedding_dim)
+    : agent_(std::move(agent)),
+      name_(std::move(name)),
+      servers_(std::move(servers)),
+      embedding_dim_(embedding_dim) {
+  TORCH_CHECK(!servers_.empty(), "A sharded embedding needs servers");
+}
+
+std::vector<ShardedEmbedding::Part> ShardedEmbedding::partition(
+    const at::Tensor& indices) const {
+  auto flat = indices.reshape({-1}).to(at::kLong);
+  if (flat.numel() > 0) {
+    TORCH_CHECK(flat.min().item<int64_t>() >= 0, "Negative embedding index");
+  }
+  const int64_t num_servers = servers_.size();
+  auto shard_of = flat.remainder(num_servers);
+  std::vector<Part> parts;
+  for (int64_t s = 0; s < num_servers; ++s) {
+    auto positions = shard_of.eq(s).nonzero().view({-1});
+    if (positions.numel() == 0) {
+      continue;
+    }
+    parts.push_back(Part{servers_[s],
+                         positions,
+                         flat.index_select(0, positions).div(num_servers)});
+  }
+  return parts;
+}
+
+at::Tensor ShardedEmbedding::lookup(const at::Tensor& indices) {
+  autograd::AutoGradMode no_grad(false);
+  auto parts = partition(indices);
+  std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+  for (const auto& part : parts) {
+    futures.push_back(
+        agent_->callAsync(part.server, lookupHandler(name_), {part.rows}));
+  }
+
+  auto sizes = indices.sizes().vec();
+  sizes.push_back(embedding_dim_);
+  at::Tensor result;
+  for (size_t i = 0; i < parts.size(); ++i) {
+    futures[i]->wait();
+    auto rows = futures[i]->value().toTensor();
+    if (!result.defined()) {
+      result = torch::empty({indices.numel(), embedding_dim_}, rows.options());
+    }
+    result.index_copy_(0, parts[i].positions, rows);
+  }
+  if (!result.defined()) {
+    return torch::empty(sizes);
+  }
+  return result.view(sizes);
+}
+
+void ShardedEmbedding::update(
+    const at::Tensor& indices,
+    const at::Tensor& grad,
+    double lr) {
+  autograd::AutoGradMode no_grad(false);
+  auto flat_grad = grad.reshape({indices.numel(), embedding_dim_});
+  auto parts = partition(indices);
+  std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+  for (const auto& part : parts) {
+    futures.push_back(agent_->callAsync(
+        part.server,
+        updateHandler(name_),
+        {part.rows, flat_grad.index_select(0, part.positions), lr}));
+  }
+  for (auto& future : futures) {
+    future->wait();
+    // Throws the error of the call, if it failed
+    future->value();
+  }
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
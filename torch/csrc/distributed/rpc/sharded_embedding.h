@@ -0,0 +1,79 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Note [Sharded embeddings]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// A sharded embedding keeps the rows of a table on a list of servers, so that
+// tables too large for the memory of a worker can be looked up and trained
+// in parameter server style. Row r of the table is row r / S of the shard on
+// servers[r % S], for S servers, which spreads the rows of consecutive ids
+// evenly.
+//
+// Each server serves its shard with registerEmbeddingShard, and workers go
+// through a ShardedEmbedding, which makes one call per server involved in a
+// lookup or an update, and sends them all before waiting for any. Updates
+// are sparse SGD steps, applied on the servers one at a time. Lookups don't
+// wait for updates, so that with concurrent workers a row may be read while
+// it is being updated, as in asynchronous SGD.
+
+// Returns the rows of `weight` that the server `shard` of `num_shards` keeps.
+at::Tensor embeddingShard(
+    const at::Tensor& weight,
+    int64_t shard,
+    int64_t num_shards);
+
+// Registers the handlers that read and update `shard` on `agent`, under
+// `name`.
+void registerEmbeddingShard(
+    RpcAgent& agent,
+    const std::string& name,
+    at::Tensor shard);
+
+class ShardedEmbedding {
+ public:
+  // `servers` are the ranks that serve the shards of table `name`, in order.
+  ShardedEmbedding(
+      std::shared_ptr<RpcAgent> agent,
+      std::string name,
+      std::vector<int> servers,
+      int64_t embedding_dim);
+
+  // Returns the rows of `indices`, in a tensor of size
+  // indices.sizes() + [embedding_dim].
+  at::Tensor lookup(const at::Tensor& indices);
+
+  // Subtracts `lr` times the rows of `grad`, which has the size of the
+  // result of lookup(indices), from the rows of `indices`. Repeated indices
+  // have all their gradients applied. Returns once every server has applied
+  // its part.
+  void update(const at::Tensor& indices, const at::Tensor& grad, double lr);
+
+ private:
+  struct Part {
+    int server;
+    // The positions in the flattened indices of the rows on `server`, and
+    // their rows within its shard.
+    at::Tensor positions;
+    at::Tensor rows;
+  };
+  std::vector<Part> partition(const at::Tensor& indices) const;
+
+  std::shared_ptr<RpcAgent> agent_;
+  std::string name_;
+  std::vector<int> servers_;
+  int64_t embedding_dim_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
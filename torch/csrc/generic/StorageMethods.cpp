@@ -262,23 +262,26 @@ static PyObject *THPStorage_(setFromFile)(THPStorage *self, PyObject *args)
 
   // file is backed by a fd
   const int fd = PyObject_AsFileDescriptor(file);
-  const auto fd_original_pos = lseek(fd, 0, SEEK_CUR);
-  if (offset != Py_None) {
-    lseek(fd, THPUtils_unpackLong(offset), SEEK_SET);
-  }
   THPUtils_assert(fd != -1, "_set_from_file couldn't retrieve a file "
       "descriptor from given object");
-  THWStorage *storage = THPStorage_(readFileRaw<int>)(fd, self->cdata);
+  THPPreadFile pread_file{fd, offset != Py_None
+      ? static_cast<int64_t>(THPUtils_unpackLong(offset))
+      : static_cast<int64_t>(lseek(fd, 0, SEEK_CUR))};
+  THWStorage *storage;
+  {
+    // the storage is read with pread, which leaves the file position alone,
+    // from several threads for large storages
+    AutoNoGIL no_gil;
+    storage = THPStorage_(readFileRaw<THPPreadFile*>)(&pread_file, self->cdata);
+  }
   if (storage == nullptr)
     return nullptr;
   Py_INCREF(self);
 
-  // the file descriptor is returned to original position and
   // the file handle at python call-site needs updating to the
   // advanced postion
-  const auto fd_current_pos = lseek(fd, 0, SEEK_CUR);
-  lseek(fd, fd_original_pos, SEEK_SET);
-  const auto seek_return = PyObject_CallMethod(file, "seek", "li", fd_current_pos, 0);
+  const auto seek_return = PyObject_CallMethod(file, "seek", "Li",
+      static_cast<long long>(pread_file.offset), 0);
   if (seek_return == nullptr) {
       return nullptr;
   }
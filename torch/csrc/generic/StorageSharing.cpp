@@ -241,10 +241,10 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self)
     void *base_ptr = c10::cuda::CUDACachingAllocator::getBaseAllocation(THWStorage_(data)(LIBRARY_STATE storage), &base_size);
     ptrdiff_t offset_bytes = (char*)storage->data<scalar_t>() - (char*)base_ptr;
 
-    cudaIpcMemHandle_t handle;
-    THCudaCheck(cudaIpcGetMemHandle(&handle, base_ptr));
+    // See Note [Reusing CUDA IPC resources]
+    std::string handle = torch::GetIpcMemHandle(base_ptr, storage->device());
 
-    _handle = PyBytes_FromStringAndSize((char *)&handle, CUDA_IPC_HANDLE_SIZE);
+    _handle = PyBytes_FromStringAndSize(handle.data(), CUDA_IPC_HANDLE_SIZE);
     _offset_bytes = PyLong_FromSsize_t((Py_ssize_t)offset_bytes);
 
     // Put Storage Data behind new ref counting context
@@ -315,15 +315,8 @@ static PyObject * THPStorage_(releaseIPCCounter)(PyObject *_unused, PyObject *ar
   // We don't want to break existing code, so resource deletion is best
   // effort basis. Exception expected if producer process terminated
   // before consumer released data.
-  int flags =
-      TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
   try {
-    auto sptr = THRefcountedMapAllocator::makeDataPtr(
-        ref_counter_handle.c_str(),
-        flags,
-        sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-        nullptr);
-    *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
+    torch::ReleaseRefCounter(ref_counter_handle, ref_counter_offset);
   } catch (c10::Error) {
     // Already warned inside of producer process
   }
@@ -384,6 +377,8 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
     cudaIpcOpenEventHandle(&event, *ipc_event_handle);
     AT_CUDA_CHECK(
         cudaStreamWaitEvent(c10::cuda::getCurrentCUDAStream(device), event, 0));
+    // The wait is already queued, so the handle is no longer needed
+    AT_CUDA_CHECK(cudaEventDestroy(event));
   }
 #else
   // Already synchronized inside producer stream
@@ -421,15 +416,8 @@ static PyObject * THPStorage_(newSharedCuda)(PyObject *_unused, PyObject *args)
         // We don't want to break existing code, so resource deletion is best
         // effort basis. Exception expected if producer process terminated
         // before consumer released data.
-        int flags =
-            TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
         try {
-          auto sptr = THRefcountedMapAllocator::makeDataPtr(
-              ref_counter_handle.c_str(),
-              flags,
-              sizeof(int64_t) * torch::CUDA_IPC_REF_COUNTER_FILE_SIZE,
-              nullptr);
-          *(static_cast<int64_t*>(sptr.get()) + ref_counter_offset) -= 1;
+          torch::ReleaseRefCounter(ref_counter_handle, ref_counter_offset);
         } catch (c10::Error) {
           // Already warned inside of producer process
         }
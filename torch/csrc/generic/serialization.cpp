@@ -124,5 +124,6 @@ THWStorage * THPStorage_(readFileRaw)(io file, THWStorage *_storage)
 
 template THWStorage* THPStorage_(readFileRaw<int>)(int fd, THWStorage* storage);
 template THWStorage* THPStorage_(readFileRaw<PyObject*>)(PyObject* fd, THWStorage* storage);
+template THWStorage* THPStorage_(readFileRaw<THPPreadFile*>)(THPPreadFile* fd, THWStorage* storage);
 
 #endif
@@ -670,6 +670,74 @@ static void deduplicateSizeCaptures(
   }
 }
 
+// Saving an intermediate for the reverse graph keeps it alive until the
+// backward pass runs. Cheap pointwise values that can be computed from values
+// that are saved anyway (inputs of f, other captures and constants) are
+// recomputed at the start of the reverse graph instead, which doesn't save
+// anything more, and typically saves a tensor the size of the output.
+// Real outputs of f are left alone, since saving them is free.
+static void recomputeCheapCaptures(
+    Gradient& grad_desc,
+    ReverseDetails& rev_info) {
+  static const OperatorSet cheap_pointwise_ops = {
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::mul(Tensor self, Scalar other) -> Tensor",
+      "aten::div(Tensor self, Tensor other) -> Tensor",
+      "aten::div(Tensor self, Scalar other) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::relu(Tensor self) -> Tensor",
+  };
+  auto& graph = *grad_desc.f;
+  Block* primal_block = graph.block();
+  Block* reverse_block = rev_info.reverse_block;
+  static const auto err = [](Value*) -> Value* {
+    throw std::runtime_error("unexpected input");
+  };
+
+  auto captures = getReverseCaptures(grad_desc);
+  value_set saved(captures.begin(), captures.end());
+  saved.insert(graph.inputs().begin(), graph.inputs().end());
+  const value_set real_outputs(graph.outputs().begin(), graph.outputs().end());
+
+  value_map recomputed;
+  WithInsertPoint insert_guard{*reverse_block->nodes().begin()};
+  // captures are topologically sorted, so values recomputed from other
+  // recomputed values come after them
+  for (Value* capture : captures) {
+    Node* node = capture->node();
+    if (node->owningBlock() != primal_block || real_outputs.count(capture) ||
+        !cheap_pointwise_ops.find(node)) {
+      continue;
+    }
+    const auto inputs = node->inputs();
+    const bool inputs_saved =
+        std::all_of(inputs.begin(), inputs.end(), [&](Value* input) {
+          return saved.count(input) ||
+              input->node()->kind() == prim::Constant;
+        });
+    if (!inputs_saved) {
+      continue;
+    }
+    Node* clone = graph.insertNode(graph.createClone(node, [&](Value* v) {
+      if (v->node()->kind() == prim::Constant) {
+        return graph.insertNode(graph.createClone(v->node(), err))->output();
+      }
+      auto it = recomputed.find(v);
+      return it == recomputed.end() ? v : it->second;
+    }));
+    recomputed[capture] = clone->output();
+    for (const Use& use : std::vector<Use>(capture->uses())) {
+      if (use.user->owningBlock() != primal_block) {
+        use.user->replaceInput(use.offset, clone->output());
+      }
+    }
+  }
+}
+
 static void eliminateDeadCode(ReverseDetails& rev_info) {
   // addReverseInline has to call gradientForNode if *any* of the inputs
   // require grad, but it will emit vjps for *all* inputs. Use DCE to remove
@@ -709,6 +777,7 @@ static void Optimize(Gradient& grad_desc, ReverseDetails& rev_info) {
   // multiple times. Make sure we deduplicate them before lifting.
   EliminateCommonSubexpression(grad_desc.f);
   deduplicateSizeCaptures(grad_desc, rev_info);
+  recomputeCheapCaptures(grad_desc, rev_info);
   eliminateDeadCode(rev_info);
 }
 
@@ -0,0 +1,233 @@
+#include <torch/csrc/jit/batching_scheduler.h>
+
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace torch {
+namespace jit {
+
+BatchingScheduler::BatchingScheduler(BatchFunction fn, BatchingOptions options)
+    : fn_(std::move(fn)), options_(options) {
+  TORCH_CHECK(options_.max_batch_size > 0, "max_batch_size must be positive");
+  thread_ = std::thread(&BatchingScheduler::loop, this);
+}
+
+BatchingScheduler::BatchingScheduler(
+    std::shared_ptr<script::Module> module,
+    BatchingOptions options,
+    const std::string& method_name)
+    : BatchingScheduler(
+          [module, method_name](std::vector<at::Tensor> inputs) {
+            autograd::AutoGradMode no_grad(false);
+            std::vector<IValue> stack(inputs.begin(), inputs.end());
+            IValue result = module->get_method(method_name)(std::move(stack));
+            if (result.isTensor()) {
+              return std::vector<at::Tensor>{result.toTensor()};
+            }
+            TORCH_CHECK(
+                result.isTuple(),
+                "Batched methods must return a tensor or a tuple of tensors");
+            std::vector<at::Tensor> outputs;
+            for (const auto& element : result.toTuple()->elements()) {
+              outputs.push_back(element.toTensor());
+            }
+            return outputs;
+          },
+          options) {}
+
+BatchingScheduler::~BatchingScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> BatchingScheduler::schedule(
+    std::vector<at::Tensor> inputs) {
+  TORCH_CHECK(!inputs.empty(), "Batched requests need inputs");
+  for (const auto& input : inputs) {
+    TORCH_CHECK(
+        input.dim() > 0 && input.size(0) == inputs[0].size(0),
+        "The inputs of a batched request must have the same size in their "
+        "first dimension");
+  }
+
+  Request request{std::move(inputs),
+                  c10::make_intrusive<c10::ivalue::Future>(),
+                  std::chrono::steady_clock::now()};
+  auto future = request.future;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TORCH_CHECK(!stopping_, "The batching scheduler is stopping");
+    TORCH_CHECK(
+        queue_.size() < options_.max_queue_size,
+        "The batching queue is full, with ",
+        queue_.size(),
+        " requests");
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+std::vector<at::Tensor> BatchingScheduler::run(
+    std::vector<at::Tensor> inputs) {
+  auto future = schedule(std::move(inputs));
+  future->wait();
+  return future->value().toTensorListRef();
+}
+
+size_t BatchingScheduler::queue_size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size();
+}
+
+bool BatchingScheduler::fits(const Request& first, const Request& request)
+    const {
+  if (request.inputs.size() != first.inputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < first.inputs.size(); ++i) {
+    const auto& a = first.inputs[i];
+    const auto& b = request.inputs[i];
+    if (a.scalar_type() != b.scalar_type() || a.device() != b.device() ||
+        a.dim() != b.dim()) {
+      return false;
+    }
+    if (!options_.pad && a.sizes().slice(1) != b.sizes().slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<BatchingScheduler::Request> BatchingScheduler::takeBatch() {
+  std::vector<Request> batch;
+  batch.push_back(std::move(queue_.front()));
+  queue_.pop_front();
+  int64_t rows = batch[0].inputs[0].size(0);
+  // Requests that don't fit the batch keep their place, but one that fits
+  // and is too large ends the batch, so that requests run in order.
+  auto it = queue_.begin();
+  while (it != queue_.end() && rows < options_.max_batch_size) {
+    if (!fits(batch[0], *it)) {
+      ++it;
+      continue;
+    }
+    int64_t request_rows = it->inputs[0].size(0);
+    if (rows + request_rows > options_.max_batch_size) {
+      break;
+    }
+    rows += request_rows;
+    batch.push_back(std::move(*it));
+    it = queue_.erase(it);
+  }
+  return batch;
+}
+
+void BatchingScheduler::runBatch(std::vector<Request> batch) {
+  std::vector<int64_t> rows;
+  for (const auto& request : batch) {
+    rows.push_back(request.inputs[0].size(0));
+  }
+  const int64_t total_rows =
+      std::accumulate(rows.begin(), rows.end(), int64_t(0));
+
+  std::vector<at::Tensor> outputs;
+  try {
+    std::vector<at::Tensor> inputs;
+    for (size_t i = 0; i < batch[0].inputs.size(); ++i) {
+      std::vector<at::Tensor> parts;
+      for (const auto& request : batch) {
+        parts.push_back(request.inputs[i]);
+      }
+      if (options_.pad) {
+        std::vector<int64_t> sizes = parts[0].sizes().vec();
+        for (const auto& part : parts) {
+          for (int64_t d = 1; d < part.dim(); ++d) {
+            sizes[d] = std::max(sizes[d], part.size(d));
+          }
+        }
+        for (auto& part : parts) {
+          // constant_pad_nd takes pairs of paddings from the last dimension
+          std::vector<int64_t> padding;
+          bool padded = false;
+          for (int64_t d = part.dim() - 1; d > 0; --d) {
+            padding.push_back(0);
+            padding.push_back(sizes[d] - part.size(d));
+            padded |= sizes[d] != part.size(d);
+          }
+          if (padded) {
+            part = at::constant_pad_nd(part, padding, options_.padding_value);
+          }
+        }
+      }
+      inputs.push_back(parts.size() == 1 ? parts[0] : at::cat(parts, 0));
+    }
+
+    outputs = fn_(std::move(inputs));
+    for (const auto& output : outputs) {
+      TORCH_CHECK(
+          output.dim() > 0 && output.size(0) == total_rows,
+          "The outputs of a batch must have the size of the batch (",
+          total_rows,
+          ") in their first dimension, but got an output of size ",
+          output.sizes());
+    }
+  } catch (const std::exception& e) {
+    for (auto& request : batch) {
+      request.future->markCompleted(
+          c10::ivalue::Future::FutureError(e.what()));
+    }
+    return;
+  }
+
+  int64_t offset = 0;
+  for (size_t r = 0; r < batch.size(); ++r) {
+    std::vector<at::Tensor> request_outputs;
+    for (const auto& output : outputs) {
+      request_outputs.push_back(output.narrow(0, offset, rows[r]));
+    }
+    offset += rows[r];
+    batch[r].future->markCompleted(IValue(std::move(request_outputs)));
+  }
+}
+
+void BatchingScheduler::loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // Wait for the batch of the oldest request to fill up, or for its
+    // deadline. Requests still queued when stopping run right away.
+    const auto deadline = queue_.front().arrival + options_.max_latency;
+    while (!stopping_ && std::chrono::steady_clock::now() < deadline) {
+      int64_t rows = 0;
+      for (const auto& request : queue_) {
+        if (fits(queue_.front(), request)) {
+          rows += request.inputs[0].size(0);
+        }
+      }
+      if (rows >= options_.max_batch_size) {
+        break;
+      }
+      cv_.wait_until(lock, deadline);
+    }
+
+    auto batch = takeBatch();
+    lock.unlock();
+    runBatch(std::move(batch));
+    lock.lock();
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/script/module.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+struct BatchingOptions {
+  // The largest number of rows (sizes of the first dimension of the inputs)
+  // a batch gathers. A request with more rows runs as a batch of its own.
+  int64_t max_batch_size = 32;
+  // How long the first request of a batch may wait for others to join it.
+  std::chrono::microseconds max_latency{1000};
+  // The largest number of requests waiting for a batch; schedule() throws
+  // beyond it.
+  size_t max_queue_size = 1024;
+  // If set, requests whose inputs differ in sizes other than the first are
+  // batched together: each input is padded with `padding_value` at the end
+  // of every other dimension, up to the largest size in the batch.
+  // Otherwise, only requests with the same sizes are batched together.
+  bool pad = false;
+  double padding_value = 0;
+};
+
+// Note [Dynamic batching]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// Models served one request at a time run at batch size 1, which leaves most
+// of a GPU idle. A BatchingScheduler queues the requests made to a model
+// from any number of threads, and runs them in batches on a thread of its
+// own: it concatenates the inputs of the requests along their first
+// dimension, runs the model once, and splits the outputs back along their
+// first dimension, which must be the size of the batch.
+//
+// A batch starts with the oldest request in the queue, and takes the
+// following requests that fit, with the same number, dtypes and devices of
+// inputs and (unless padding) the same sizes. It runs as soon as it is full,
+// or when its first request has waited for `max_latency`. With padding, the
+// outputs of a request keep the sizes of the batch, e.g. the largest
+// sequence length in it.
+class TORCH_API BatchingScheduler {
+ public:
+  // Runs a batch: takes the batched inputs and returns the batched outputs.
+  using BatchFunction =
+      std::function<std::vector<at::Tensor>(std::vector<at::Tensor>)>;
+
+  BatchingScheduler(BatchFunction fn, BatchingOptions options = {});
+
+  // Runs the method `method_name` of `module`, which takes the inputs as
+  // tensor arguments and returns a tensor or a tuple of them, under no grad
+  // mode.
+  BatchingScheduler(
+      std::shared_ptr<script::Module> module,
+      BatchingOptions options = {},
+      const std::string& method_name = "forward");
+
+  // Runs the requests that are still queued, and stops.
+  ~BatchingScheduler();
+
+  // Queues a request, and returns the future of its outputs: an IValue
+  // holding a list of tensors, or the error of its batch.
+  c10::intrusive_ptr<c10::ivalue::Future> schedule(
+      std::vector<at::Tensor> inputs);
+
+  // Like schedule(), but waits for the outputs.
+  std::vector<at::Tensor> run(std::vector<at::Tensor> inputs);
+
+  size_t queue_size() const;
+
+ private:
+  struct Request {
+    std::vector<at::Tensor> inputs;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+    std::chrono::steady_clock::time_point arrival;
+  };
+
+  bool fits(const Request& first, const Request& request) const;
+  // Removes the next batch from the queue; queue_ must not be empty.
+  std::vector<Request> takeBatch();
+  void runBatch(std::vector<Request> batch);
+  void loop();
+
+  BatchFunction fn_;
+  const BatchingOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stopping_ = false;
+  std::thread thread_;
+};
+
+} // namespace jit
+} // namespace torch
@@ -8,7 +8,14 @@
 #include <ATen/core/functional.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/import_export_helpers.h>
+#include <torch/csrc/jit/interpreter.h>
+#include <torch/csrc/jit/mobile/import.h>
+#include <torch/csrc/jit/passes/common_subexpression_elimination.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/lower_grad_of.h>
+#include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/python_print.h>
 #include <torch/csrc/jit/pickler.h>
 
@@ -19,6 +26,7 @@
 #include <onnx/onnx_pb.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <c10/util/Optional.h>
 
 #include <fstream>
@@ -107,7 +115,7 @@ class EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       bool strip_doc);
 
-  onnx::ModelProto get_model_proto() {
+  const onnx::ModelProto& get_model_proto() const {
     return model_proto_;
   }
 
@@ -397,7 +405,7 @@ class GraphEncoder : public EncoderBase {
       bool defer_weight_export,
       bool strip_doc);
 
-  RawDataExportMap get_raw_data_export_map() {
+  const RawDataExportMap& get_raw_data_export_map() const {
     return raw_data_export_map_;
   }
 
@@ -445,8 +453,6 @@ void GraphEncoder::EncodeTensor(
     tensor_proto->add_dims(d);
   }
   tensor_proto->set_data_type(ATenTypeToOnnxType(tensor.scalar_type()));
-  // CPU's HalfTensor doesn't have contiguous(), so first calling contiguous()
-  auto t = tensor.contiguous().cpu();
   // Add a buffer to the raw_data_export_map for the caller to dump into an
   // external data store. If external_ref is not specified, we instead dump
   // the contiguous data into the protobuf itself
@@ -455,9 +461,13 @@ void GraphEncoder::EncodeTensor(
     // avoid ONNX protobuf changes.
     AT_ASSERT(external_ref.value() == tensor_proto->name());
     AT_ASSERT(raw_data_export_map_.count(external_ref.value()) == 0);
-    raw_data_export_map_[external_ref.value()] = t;
+    // the tensor is only made contiguous and copied to the CPU when it is
+    // written, so that the exported weights aren't all copied at once
+    raw_data_export_map_[external_ref.value()] = tensor;
     tensor_proto->set_raw_data("__EXTERNAL");
   } else {
+    // CPU's HalfTensor doesn't have contiguous(), so first calling contiguous()
+    auto t = tensor.contiguous().cpu();
     AT_ASSERT(t.is_contiguous());
     tensor_proto->set_raw_data(std::string(
         static_cast<char*>(t.data_ptr()), t.element_size() * t.numel()));
@@ -1069,6 +1079,94 @@ std::string prettyPrint(const onnx::ModelProto& model) {
   return ss.str();
 }
 
+// Writes the archives loaded by mobile::_load_for_mobile, see
+// Note [Bytecode archive format] in torch/csrc/jit/mobile/import.h
+class BytecodeSerializer final {
+ public:
+  explicit BytecodeSerializer(const std::string& filename)
+      : writer_(filename.c_str()) {}
+
+  explicit BytecodeSerializer(std::ostream* ofs) : writer_(ofs) {}
+
+  void serialize(const script::Module& module) {
+    std::vector<IValue> methods = {mobile::kBytecodeVersion};
+    for (const auto& method : module.get_methods()) {
+      methods.emplace_back(serializeMethod(*method));
+    }
+    // bytecode.pkl first fills the tensor table that tensors.pkl describes
+    writeArchive("bytecode.pkl", methods, &tensor_table_);
+    writeTensorTable();
+  }
+
+ private:
+  IValue serializeMethod(const script::Method& method) {
+    // The passes that the graph executor would run on the device are run
+    // ahead of time instead, except for the ones that need the input types,
+    // and the ones that create nodes whose operation depends on the node,
+    // like CanonicalizeOps and the fuser.
+    auto graph = method.graph()->copy();
+    LowerGradOf(*graph);
+    EliminateCommonSubexpression(graph);
+    ConstantPooling(graph);
+    PeepholeOptimize(graph);
+    ConstantPropagation(graph);
+    EliminateDeadCode(graph);
+
+    std::vector<IValue> initial_ivalues;
+    for (const auto& slot : method.initial_ivalues()) {
+      initial_ivalues.push_back(slot.value());
+    }
+    return Tuple::create(
+        {method.name(),
+         Code(graph).toBytecode(),
+         static_cast<int64_t>(method.num_inputs()),
+         std::move(initial_ivalues)});
+  }
+
+  void writeArchive(
+      const std::string& name,
+      const std::vector<IValue>& ivalues,
+      std::vector<at::Tensor>* tensor_table) {
+    Pickler pickler(tensor_table);
+    pickler.start();
+    pickler.startTuple();
+    for (const IValue& ivalue : ivalues) {
+      pickler.addIValue(ivalue);
+    }
+    pickler.endTuple();
+    pickler.finish();
+    writer_.writeRecord(name, pickler.stack().data(), pickler.stack().size());
+  }
+
+  void writeTensorTable() {
+    std::unordered_map<const void*, std::string> storage_keys;
+    std::vector<IValue> tensors;
+    for (const at::Tensor& tensor : tensor_table_) {
+      auto* storage = tensor.storage().unsafeGetStorageImpl();
+      auto it = storage_keys.find(storage);
+      if (it == storage_keys.end()) {
+        at::Tensor storage_tensor;
+        uint64_t record_size;
+        std::tie(storage_tensor, record_size) = getWriteableTensor(tensor);
+        std::string key = "tensors/" + std::to_string(storage_keys.size());
+        writer_.writeRecord(
+            key, storage_tensor.storage().data(), record_size);
+        it = storage_keys.emplace(storage, std::move(key)).first;
+      }
+      tensors.emplace_back(Tuple::create(
+          {it->second,
+           static_cast<int64_t>(tensor.scalar_type()),
+           tensor.sizes().vec(),
+           tensor.strides().vec(),
+           tensor.storage_offset()}));
+    }
+    writeArchive("tensors.pkl", tensors, /*tensor_table=*/nullptr);
+  }
+
+  caffe2::serialize::PyTorchStreamWriter writer_;
+  std::vector<at::Tensor> tensor_table_;
+};
+
 } // namespace
 
 std::string pretty_print_onnx(
@@ -1115,6 +1213,47 @@ std::tuple<std::string, RawDataExportMap> export_onnx(
       graph_encoder.get_raw_data_export_map());
 }
 
+void export_onnx_to_directory(
+    const std::shared_ptr<Graph>& graph,
+    const std::map<std::string, at::Tensor>& initializers,
+    int64_t onnx_opset_version,
+    const std::string& directory,
+    ::torch::onnx::OperatorExportTypes operator_export_type,
+    bool strip_doc_string) {
+  auto graph_encoder = GraphEncoder(
+      graph,
+      onnx_opset_version,
+      operator_export_type,
+      initializers,
+      /*defer_weight_export=*/true,
+      strip_doc_string);
+  const auto& export_map = graph_encoder.get_raw_data_export_map();
+  std::vector<std::pair<std::string, at::Tensor>> raw_data(
+      export_map.begin(), export_map.end());
+
+  // Each initializer is written to its own file, so they can be written in
+  // parallel, and only the ones being written are copied to the CPU.
+  at::parallel_for(0, raw_data.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const auto& name = raw_data[i].first;
+      auto t = raw_data[i].second.contiguous().cpu();
+      std::ofstream out(directory + "/" + name, std::ofstream::binary);
+      out.write(
+          static_cast<const char*>(t.data_ptr()),
+          t.element_size() * t.numel());
+      AT_CHECK(
+          out.good(), "Failed to write the data of ", name, " to ", directory);
+    }
+  });
+
+  // the name is ONNX_ARCHIVE_MODEL_PROTO_NAME in torch/onnx/__init__.py
+  std::ofstream out(directory + "/__MODEL_PROTO", std::ofstream::binary);
+  AT_CHECK(
+      graph_encoder.get_model_proto().SerializeToOstream(&out),
+      "Failed to write the model to ",
+      directory);
+}
+
 void ExportModule(
     const script::Module& module,
     std::ostream& out,
@@ -1131,5 +1270,17 @@ void ExportModule(
   serializer.serialize(module, extra_files);
 }
 
+void ExportModuleForMobile(const script::Module& module, std::ostream& out) {
+  BytecodeSerializer serializer(&out);
+  serializer.serialize(module);
+}
+
+void ExportModuleForMobile(
+    const script::Module& module,
+    const std::string& filename) {
+  BytecodeSerializer serializer(filename);
+  serializer.serialize(module);
+}
+
 } // namespace jit
 } // namespace torch
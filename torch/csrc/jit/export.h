@@ -30,6 +30,21 @@ TORCH_API std::tuple<std::string, RawDataExportMap> export_onnx(
         ::torch::onnx::OperatorExportTypes::ONNX,
     bool strip_doc_string = true);
 
+// Exports the graph to 'directory', which must exist, in the layout of
+// ExportTypes.DIRECTORY: the ModelProto is written to '__MODEL_PROTO', and
+// each initializer to a file named after it. The initializers are written in
+// parallel and are only copied to the CPU one at a time, and the ModelProto
+// is serialized directly to its file, so the memory used is proportional to
+// the size of the graph rather than the size of the weights.
+TORCH_API void export_onnx_to_directory(
+    const std::shared_ptr<Graph>& graph,
+    const std::map<std::string, at::Tensor>& initializers,
+    int64_t onnx_opset_version,
+    const std::string& directory,
+    ::torch::onnx::OperatorExportTypes operator_export_type =
+        ::torch::onnx::OperatorExportTypes::ONNX,
+    bool strip_doc_string = true);
+
 // For testing purposes
 TORCH_API std::string pretty_print_onnx(
     const std::shared_ptr<Graph>& graph,
@@ -50,5 +65,17 @@ TORCH_API void ExportModule(
     const std::string& filename,
     const script::ExtraFilesMap& metadata = script::ExtraFilesMap());
 
+// Saves the bytecode of the methods of `module`, with the parameters and
+// attributes they use, in an archive that is loaded by
+// `torch::jit::mobile::_load_for_mobile`, without the compiler. Throws if a
+// method calls an operator that the bytecode runtime can't run.
+TORCH_API void ExportModuleForMobile(
+    const script::Module& module,
+    std::ostream& out);
+
+TORCH_API void ExportModuleForMobile(
+    const script::Module& module,
+    const std::string& filename);
+
 } // namespace jit
 } // namespace torch
@@ -328,8 +328,17 @@ std::string generateKernel(
 
   std::stringstream body;
   std::stringstream tensorOffsets;
+  std::stringstream contiguousOffsets;
   std::vector<std::string> formals;
   std::vector<std::string> argument_loads;
+  // True iff every tensor is indexed by linearIndex itself (or is 0-dim)
+  bool all_contiguous = true;
+  // Accumulators of fused reductions, see Note [Fused reductions] in
+  // graph_fuser.cpp
+  std::stringstream reductionInits;
+  std::stringstream reductionWrites;
+  std::vector<std::string> reductions;
+  std::string numRows;
 
   // Lambda for writing arguments
   auto emitFormal = [&](const Value* n, const TensorDesc& desc) {
@@ -344,6 +353,11 @@ std::string generateKernel(
       const auto nDim = desc.nDim();
       emitIndexingFor(tensorOffsets, tensor, nDim, desc.lastIsContiguous());
       env.s("tensor", tensor);
+      all_contiguous &= nDim <= 1 && desc.lastIsContiguous();
+      contiguousOffsets << format(
+          nDim == 0 ? "IndexType ${tensor}_offset = 0;\n"
+                    : "IndexType ${tensor}_offset = linearIndex;\n",
+          env);
       env.d("nDim", nDim);
       env.s("scalar_type", scalarTypeName(desc.scalar_type));
       formals.push_back(
@@ -440,6 +454,23 @@ std::string generateKernel(
       AT_ASSERT(use_cuda);
       has_random = true;
     }
+    // Note: int[] constants only occur as the dims of fused reductions,
+    //  which are always over the last dimension
+    if (n->kind() == prim::Constant &&
+        n->output()->type()->isSubtypeOf(ListType::ofInts()))
+      continue;
+    // Note: Reductions are only supported for CPU kernels. The accumulators
+    //  live outside of the loop over a row.
+    if (n->kind() == aten::sum || n->kind() == aten::mean) {
+      AT_ASSERT(!use_cuda);
+      env.s("node", valueName(n->output()));
+      env.s("input", valueName(n->input(0)));
+      env.s("lhs_type", variableType(n->input(0)->type()));
+      reductionInits << format("${lhs_type} ${node} = 0;\n", env);
+      body << format("${node} += ${input};\n", env);
+      reductions.push_back(valueName(n->output()));
+      continue;
+    }
     // Always emit double for prim::Constant. This will be narrowed later based
     // on either:
     //  - Tensor-Scalar operator type rules
@@ -473,6 +504,22 @@ std::string generateKernel(
     env.s("access", format("t${formal}.data[t${formal}_offset]", env));
     env.s("node", valueName(output.first));
 
+    // Reduced values are written once per row. The outputs are contiguous,
+    // so the rows are numbered by the linear index into any of them.
+    const Node* producer = output.first->node();
+    if (producer->kind() == aten::sum || producer->kind() == aten::mean) {
+      if (numRows.empty()) {
+        numRows = output.second.nDim() == 0 ? "1"
+                                            : format("t${formal}.sizes[0]", env);
+      }
+      reductionWrites << format(
+          producer->kind() == aten::mean
+              ? "t${formal}.data[row] = ${node} / rowSize;\n"
+              : "t${formal}.data[row] = ${node};\n",
+          env);
+      continue;
+    }
+
     // Acquires and converts (if needed) outputs
     // Note: conversion to half is only supported for CUDA kernels.
     const auto is_half = (output.second.scalar_type == at::ScalarType::Half);
@@ -504,7 +551,23 @@ std::string generateKernel(
   }
 
   // Insantiates the CUDA or CPU-specific templates
-  env.s("tensorOffsets", tensorOffsets.str());
+  // Note: If all tensors are contiguous, the CPU kernel skips the per-element
+  //  index computation and lets the compiler vectorize the loop. Outputs are
+  //  freshly allocated and never overlap the inputs, so there are no loop
+  //  carried dependencies and `omp simd` is safe.
+  // Note: With reductions, the loop is over rows, and the loop over a row is
+  //  the one that is vectorized (see below).
+  if (!use_cuda && all_contiguous) {
+    env.s("tensorOffsets", contiguousOffsets.str());
+    env.s(
+        "loopPragma",
+        reductions.empty()
+            ? "#pragma omp parallel for simd if(totalElements > OMP_THRESHOLD)"
+            : "#pragma omp parallel for if(totalElements > OMP_THRESHOLD)");
+  } else {
+    env.s("tensorOffsets", tensorOffsets.str());
+    env.s("loopPragma", "#pragma omp parallel for if(totalElements > OMP_THRESHOLD)");
+  }
   env.s("kernelBody", body.str());
   env.v("formals", formals);
   env.v("argument_loads", argument_loads);
@@ -513,6 +576,23 @@ std::string generateKernel(
     env.s("type_declarations", cuda::type_declarations_template.format(env));
     code_string = cuda::cuda_compilation_unit_template.format(env);
   } else {
+    if (reductions.empty()) {
+      env.s("kernelLoop", cpu::cpu_pointwise_loop_template.format(env));
+    } else {
+      AT_ASSERT(!numRows.empty());
+      std::string accumulators;
+      for (const auto& r : reductions) {
+        accumulators += (accumulators.empty() ? "" : ",") + r;
+      }
+      env.s("numRows", numRows);
+      env.s("reductionInits", reductionInits.str());
+      env.s("reductionWrites", reductionWrites.str());
+      env.s(
+          "rowLoopPragma",
+          all_contiguous ? "#pragma omp simd reduction(+:" + accumulators + ")"
+                         : "");
+      env.s("kernelLoop", cpu::cpu_reduction_loop_template.format(env));
+    }
     env.s("type_declarations", cpu::type_declarations_template.format(env));
     code_string = cpu::cpu_compilation_unit_template.format(env);
   }
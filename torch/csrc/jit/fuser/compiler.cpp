@@ -222,6 +222,36 @@ void processGradSumToSize(KernelSpec& spec) {
   }
 }
 
+// Records which kernel outputs are the results of fused reductions.
+// Note: relies on processGradSumToSize having deduplicated the outputs, so
+//  that there is one graph output per kernel output.
+static void setOutputReductions(KernelSpec& spec) {
+  auto& reductions = spec.outputReductions();
+  AT_ASSERT(reductions.empty());
+  for (const Value* output : spec.graph()->outputs()) {
+    const Node* node = output->node();
+    if (node->kind() != aten::sum && node->kind() != aten::mean) {
+      reductions.push_back(OutputReduction::None);
+    } else if (node->get<bool>(attr::keepdim).value()) {
+      reductions.push_back(OutputReduction::ReduceKeepDim);
+    } else {
+      reductions.push_back(OutputReduction::Reduce);
+    }
+  }
+}
+
+std::vector<int64_t> outputSizes(
+    at::IntArrayRef map_size,
+    OutputReduction reduction) {
+  std::vector<int64_t> sizes = map_size.vec();
+  if (reduction == OutputReduction::Reduce) {
+    sizes.pop_back();
+  } else if (reduction == OutputReduction::ReduceKeepDim) {
+    sizes.back() = 1;
+  }
+  return sizes;
+}
+
 // Performs "upfront" compilation where storage is known but shapes are not.
 // Currently identifies how to expand all tensors so that all intermediate
 // tensors are the same shape, simplifying code generation.
@@ -235,6 +265,7 @@ static void upfrontCompilation(KernelSpec& spec) {
   setInputBroadcastGroups(spec);
   setInputChunkDescriptors(spec);
   processGradSumToSize(spec);
+  setOutputReductions(spec);
 }
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -308,13 +339,18 @@ std::shared_ptr<FusedKernel> compileKernel(
   std::vector<TensorDesc> output_desc;
   std::vector<PartitionDesc> concat_desc;
   std::vector<std::pair<const Value*, const TensorDesc>> flat_outputs;
-  for (const Value* o : graph->outputs()) {
+  for (size_t i = 0; i < graph->outputs().size(); ++i) {
+    const Value* o = graph->outputs()[i];
     // Creates output description
-    std::vector<int64_t> sizes = map_size;
+    const auto reduction = spec.outputReductions()[i];
+    std::vector<int64_t> sizes = outputSizes(map_size, reduction);
     if (o->node()->kind() == prim::FusedConcat) {
       sizes.at(o->node()->i(attr::dim)) *= o->node()->inputs().size();
     }
-    auto scalar_type = o->type()->expect<c10::DimensionedTensorType const>()->scalarType();
+    // Note: shape propagation can't type reductions over the collapsed
+    //  dimensions set above, but they preserve the (floating) scalar type
+    const Value* typed = reduction == OutputReduction::None ? o : o->node()->input(0);
+    auto scalar_type = typed->type()->expect<c10::DimensionedTensorType const>()->scalarType();
     auto type = CompleteTensorType::create(scalar_type, device, sizes);
     output_desc.emplace_back(type);
     const auto& desc = output_desc.back();
@@ -29,6 +29,11 @@ TORCH_API std::shared_ptr<FusedKernel> compileKernel(
     const std::vector<int64_t>& map_size,
     const at::Device device);
 
+// Returns the sizes of a kernel output, given the map size.
+TORCH_API std::vector<int64_t> outputSizes(
+    at::IntArrayRef map_size,
+    OutputReduction reduction);
+
 TORCH_API size_t nCompiledKernels();
 
 TORCH_API int debugFuser();
@@ -1,12 +1,22 @@
 #include <torch/csrc/jit/fuser/cpu/fused_kernel.h>
+#include <ATen/native/DispatchStub.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/compiler.h>
 #include <torch/csrc/jit/fuser/cpu/dynamic_library.h>
 #include <torch/csrc/jit/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -38,15 +48,18 @@ struct CompilerConfig {
       cxx = cxx_env;
     }
 
-    if (!programExists(cxx)) {
-      cxx = "";
-    }
+    cxx_found = programExists(cxx);
   }
 
   ~CompilerConfig() = default;
 
   std::string cxx = "g++"; // compiler location
+  // NB: the cache is keyed by `cxx` even if it is not found, so that
+  // kernels compiled elsewhere can be loaded without a compiler. See
+  // Note [Persistent CPU kernel cache].
+  bool cxx_found = false;
   bool openmp = true;
+  bool vectorize = true;
 };
 
 static CompilerConfig& getConfig() {
@@ -54,30 +67,45 @@ static CompilerConfig& getConfig() {
   return config;
 }
 
-// NB: -march=native not supported on PPC64 g++.  It's a bit annoying
-// to do a configure-style test to decide whether or not the g++
-// actually supports it or not, so we heuristically use the host
-// compiler to predict if the runtime compiler supports the option we
-// want.  This probably won't work if you're cross-compiling.
-// NB: -march=native is disabled because it has caused problems where
-// compiler and assembler do not agree on what native instruction they
-// understand for AVX512. When we need better CPU performance this
-// optimization can be re-enabled by tracking down the platforms where
-// this error occurs and only selectively disabling it.
+// NB: -march=native is not used because it has caused problems where
+// compiler and assembler do not agree on what native instructions they
+// understand for AVX512, and because a kernel compiled with it may not run
+// on another machine sharing the same kernel cache. Instead, kernels are
+// compiled for the instruction set ATen's own kernels dispatch to on this
+// machine (see aten/src/ATen/native/DispatchStub.h), with the same flags as
+// the corresponding ATen build of the kernels (see cmake/Codegen.cmake), so
+// that the fused loops are vectorized for the host. If the compiler rejects
+// these flags, we fall back to compiling without them.
+static std::string vectorizeFlags() {
+  switch (at::native::get_cpu_capability()) {
+    case at::native::CPUCapability::AVX512:
+      return "-mavx512f -mavx512dq -mavx512vl -mavx512bw -mfma";
+    case at::native::CPUCapability::AVX2:
+      return "-mavx2 -mfma";
+    case at::native::CPUCapability::AVX:
+      return "-mavx";
+    default:
+      return "";
+  }
+}
+
 static const std::string compile_string =
-    "\"${cxx}\" -O3 -g "
-#ifndef __PPC64__
-//  "-march=native "
-#endif
+    "\"${cxx}\" -O3 -g ${vectorize} "
     "-std=c++11 -fPIC ${fopenmp} -shared \"${cpp_file}\" -o \"${so_file}\" -lm";
 
 static void runCompiler(
     const std::string& cpp_file,
     const std::string& so_file) {
   auto& config = getConfig();
+  TORCH_CHECK(
+      config.cxx_found,
+      "Failed to compile a fused CPU kernel: compiler '",
+      config.cxx,
+      "' not found");
   TemplateEnv env;
   env.s("cxx", config.cxx);
   env.s("fopenmp", config.openmp ? "-fopenmp" : "");
+  env.s("vectorize", config.vectorize ? vectorizeFlags() : "");
   env.s("cpp_file", cpp_file);
   env.s("so_file", so_file);
   std::string result = format(compile_string, env);
@@ -88,6 +116,13 @@ static void runCompiler(
     config.openmp = false; // disable for future compiles
     return runCompiler(cpp_file, so_file);
   }
+  if (config.vectorize && r != 0 && !vectorizeFlags().empty()) {
+    std::cerr
+        << "warning: pytorch jit fuser failed to compile with '"
+        << vectorizeFlags() << "', trying without it...\n";
+    config.vectorize = false; // disable for future compiles
+    return runCompiler(cpp_file, so_file);
+  }
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
 }
 
@@ -100,6 +135,169 @@ static void disas(const std::string& so_file) {
   AT_ASSERT(r == 0);
 }
 
+// Note [Persistent CPU kernel cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// If a cache directory is set (see setCPUFusionCacheDir), compiled kernels
+// are kept there, so that restarted processes, or other machines the
+// directory is copied to, load them without running the compiler (which
+// need not even be installed there). Kernel names depend on the order in
+// which fusions are compiled, so they are replaced by a name derived from
+// the rest of the code. An entry consists of two files named after the hash
+// of the compiler command and the normalized code:
+//
+//   <hash>.cpp: the compiler command in a comment, followed by the code, and
+//   <hash>.so:  the compiled kernel.
+//
+// The .cpp file is compared in full before an entry is used, so hash
+// collisions only cost a compilation. Files are written under temporary
+// names and renamed into place, so concurrent processes can share a
+// directory. The .cpp file is renamed first, so an existing .so is always
+// complete and has its .cpp next to it.
+
+// 64-bit FNV-1a, which unlike std::hash is stable across builds
+static uint64_t hashString(const std::string& str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static std::string replaceAll(
+    std::string str,
+    const std::string& from,
+    const std::string& to) {
+  for (size_t pos = str.find(from); pos != std::string::npos;
+       pos = str.find(from, pos + to.size())) {
+    str.replace(pos, from.size(), to);
+  }
+  return str;
+}
+
+static bool readFile(const std::string& path, std::string* contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  *contents = ss.str();
+  return true;
+}
+
+static bool fileExists(const std::string& path) {
+  struct stat buf;
+  return stat(path.c_str(), &buf) == 0;
+}
+
+// Creates an empty file with a unique name in `dir` and returns its name.
+static std::string makeTempFile(const std::string& dir, const char* suffix) {
+  const std::string prefix = dir + "/tmp";
+  std::string t = prefix + "XXXXXX" + suffix;
+  std::vector<char> tt(t.c_str(), t.c_str() + t.size() + 1);
+  int fd = mkstemps(tt.data(), strlen(suffix));
+  if (fd == -1) {
+    return "";
+  }
+  close(fd);
+  return std::string(tt.begin(), tt.end() - 1);
+}
+
+static bool writeFileAtomic(
+    const std::string& dir,
+    const std::string& path,
+    const std::string& contents) {
+  const auto tmp = makeTempFile(dir, ".cpp");
+  if (tmp.empty()) {
+    return false;
+  }
+  {
+    std::ofstream file(tmp, std::ios::binary);
+    file << contents;
+    if (!file.flush()) {
+      unlink(tmp.c_str());
+      return false;
+    }
+  }
+  if (rename(tmp.c_str(), path.c_str()) != 0) {
+    unlink(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Loads the kernel from the cache in `dir`, compiling and adding it first if
+// necessary. Returns false if the cache cannot be used for this kernel.
+// See Note [Persistent CPU kernel cache].
+static bool loadCachedKernel(
+    const std::string& dir,
+    const std::string& name,
+    const std::string& code,
+    std::unique_ptr<DynamicLibrary>* so_lib,
+    std::string* symbol) {
+  auto& config = getConfig();
+  TemplateEnv env;
+  env.s("cxx", config.cxx);
+  env.s("fopenmp", config.openmp ? "-fopenmp" : "");
+  env.s("vectorize", config.vectorize ? vectorizeFlags() : "");
+  env.s("cpp_file", "<source>");
+  env.s("so_file", "<library>");
+  const std::string command = format(compile_string, env);
+
+  static const std::string kernel_placeholder = "${kernel}";
+  const std::string normalized = replaceAll(code, name, kernel_placeholder);
+  std::stringstream hash;
+  hash << std::hex << std::setfill('0') << std::setw(16)
+       << hashString(command + "\n" + normalized);
+  *symbol = "kernel_" + hash.str();
+  const std::string source = "// " + command + "\n" +
+      replaceAll(normalized, kernel_placeholder, *symbol);
+
+  const std::string cpp_file = dir + "/" + hash.str() + ".cpp";
+  const std::string so_file = dir + "/" + hash.str() + ".so";
+  std::string cached_source;
+  if (readFile(cpp_file, &cached_source)) {
+    if (cached_source != source) {
+      // hash collision, compile this kernel without the cache
+      return false;
+    }
+    if (fileExists(so_file)) {
+      *so_lib = make_unique<DynamicLibrary>(so_file.c_str());
+      return true;
+    }
+  }
+
+  if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    std::cerr << "warning: pytorch jit fuser cannot create kernel cache "
+              << "directory '" << dir << "', compiling without it...\n";
+    return false;
+  }
+  if (!writeFileAtomic(dir, cpp_file, source)) {
+    std::cerr << "warning: pytorch jit fuser cannot write to kernel cache "
+              << "directory '" << dir << "', compiling without it...\n";
+    return false;
+  }
+  const auto tmp_so_file = makeTempFile(dir, ".so");
+  if (tmp_so_file.empty()) {
+    return false;
+  }
+  try {
+    runCompiler(cpp_file, tmp_so_file);
+  } catch (...) {
+    unlink(tmp_so_file.c_str());
+    throw;
+  }
+  if (debugFuser() >= 2)
+    disas(tmp_so_file);
+  if (rename(tmp_so_file.c_str(), so_file.c_str()) != 0) {
+    unlink(tmp_so_file.c_str());
+    return false;
+  }
+  *so_lib = make_unique<DynamicLibrary>(so_file.c_str());
+  return true;
+}
+
 FusedKernelCPU::FusedKernelCPU(
     std::string name,
     std::string code,
@@ -116,17 +314,23 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, 3);
-  TempFile cpp_file(cpp_template, 4);
-  cpp_file.write(code_);
-  cpp_file.sync();
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<DynamicLibrary>(so_file.name().c_str());
+  std::string symbol = name_;
+  const auto cache_dir = getCPUFusionCacheDir();
+  if (cache_dir.empty() ||
+      !loadCachedKernel(cache_dir, name_, code_, &so_lib, &symbol)) {
+    symbol = name_;
+    TempFile so_file(so_template, 3);
+    TempFile cpp_file(cpp_template, 4);
+    cpp_file.write(code_);
+    cpp_file.sync();
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    so_lib = make_unique<DynamicLibrary>(so_file.name().c_str());
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
-      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
+      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(symbol.c_str()));
 #pragma GCC diagnostic pop
 }
 
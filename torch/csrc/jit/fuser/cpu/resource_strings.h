@@ -55,20 +55,44 @@ ${type_declarations}
 
 #define OMP_THRESHOLD 100000
 static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
-  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
-  for (IndexType linearIndex = 0;
-        linearIndex < totalElements;
+  ${kernelLoop}
+}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
+static auto cpu_pointwise_loop_template = CodeTemplate(R"(
+${loopPragma}
+for (IndexType linearIndex = 0;
+      linearIndex < totalElements;
+      linearIndex += 1) {
+    // Convert `linearIndex` into an offset of tensor:
+    ${tensorOffsets}
+    // calculate the results
+    ${kernelBody}
+  }
+)");
+
+// See Note [Fused reductions] in graph_fuser.cpp
+static auto cpu_reduction_loop_template = CodeTemplate(R"(
+const IndexType numRows = ${numRows};
+const IndexType rowSize = numRows > 0 ? totalElements / numRows : 0;
+${loopPragma}
+for (IndexType row = 0; row < numRows; row += 1) {
+  ${reductionInits}
+  ${rowLoopPragma}
+  for (IndexType linearIndex = row * rowSize;
+        linearIndex < (row + 1) * rowSize;
         linearIndex += 1) {
       // Convert `linearIndex` into an offset of tensor:
       ${tensorOffsets}
       // calculate the results
       ${kernelBody}
     }
-}
-
-extern "C"
-void ${kernelName}(IndexType totalElements, void ** args) {
-  ${kernelName}_kernel(totalElements ${,argument_loads});
+  ${reductionWrites}
 }
 )");
 
@@ -90,6 +90,10 @@ static c10::optional<std::vector<int64_t>> canRunKernel(
     }
   }
 
+  // Fused reductions are over the last dimension of the map size
+  if (spec.hasReduction() && map_size && map_size->empty())
+    return c10::nullopt;
+
   return map_size;
 }
 
@@ -188,6 +192,7 @@ static void compressContiguous(
 // Launches the requested fusion on the given device with the given inputs.
 // Output pointers are stored in outputs (to be put on the stack later).
 void launchFusion(
+    const KernelSpec& spec,
     const FusedKernel& fusion,
     const at::Device device,
     const at::ArrayRef<at::Tensor>& inputs,
@@ -294,7 +299,8 @@ void launchFusion(
     const auto& c = fusion.concatDesc()[i];
     if (c.isNoop()) {
       outputs.push_back(at::empty(
-          map_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
+          outputSizes(map_size, spec.outputReductions()[i]),
+          ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
       addTensorInfo(fusion.outputDesc()[i], outputs[i]);
     } else {
       size_t small_size = map_size[c.dim()];
@@ -350,6 +356,9 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
     return false;
   if (device.is_cpu() && !canFuseOnCPU())
     return false;
+  // Reductions are only fused on the CPU, see Note [Fused reductions]
+  if (device.is_cuda() && spec.hasReduction())
+    return false;
 
   // Validates sizes and expands inputs as needed
   auto maybe_map_size = canRunKernel(spec, inputs);
@@ -379,7 +388,7 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
 
   // Launches fusion
   std::vector<at::Tensor> raw_outputs;
-  launchFusion(*(*maybe_kernel), device, inputs, all_inputs, raw_outputs);
+  launchFusion(spec, *(*maybe_kernel), device, inputs, all_inputs, raw_outputs);
 
   auto outputs = fmap(spec.outputMapAndSizes(), [&](const OutputMapAndSize& omap) {
     if (omap.needsSumToSize()) {
@@ -5,6 +5,8 @@
 #include <torch/csrc/jit/fuser/fallback.h>
 #include <torch/csrc/jit/fuser/kernel_cache.h>
 
+#include <cstdlib>
+#include <mutex>
 #include <stdexcept>
 
 namespace torch {
@@ -15,6 +17,16 @@ namespace detail {
 // Note: CPU fusion is currently disabled due to test flakiness
 bool cpu_fuser_enabled = false;
 
+std::mutex cpu_fusion_cache_dir_mutex;
+
+std::string& cpuFusionCacheDir() {
+  static std::string dir = []() -> std::string {
+    const char* dir_env = getenv("PYTORCH_FUSION_CACHE_DIR");
+    return dir_env ? dir_env : "";
+  }();
+  return dir;
+}
+
 } // namespace detail
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -40,6 +52,16 @@ void overrideCanFuseOnCPU(bool value) {
   detail::cpu_fuser_enabled = value;
 }
 
+void setCPUFusionCacheDir(std::string dir) {
+  std::lock_guard<std::mutex> guard(detail::cpu_fusion_cache_dir_mutex);
+  detail::cpuFusionCacheDir() = std::move(dir);
+}
+
+std::string getCPUFusionCacheDir() {
+  std::lock_guard<std::mutex> guard(detail::cpu_fusion_cache_dir_mutex);
+  return detail::cpuFusionCacheDir();
+}
+
 // Uses the above interface by stuffing the graph into a node and treating that
 // node as a fusion group.
 std::vector<at::Tensor> debugLaunchGraph(
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace torch {
@@ -32,6 +33,13 @@ TORCH_API bool canFuseOnGPU();
 // flakiness)
 TORCH_API void overrideCanFuseOnCPU(bool value);
 
+// Sets the directory in which the CPU fuser keeps the kernels it compiles,
+// so that later processes can load them instead of invoking the compiler
+// again. Defaults to the PYTORCH_FUSION_CACHE_DIR environment variable.
+// An empty string disables the cache.
+TORCH_API void setCPUFusionCacheDir(std::string dir);
+TORCH_API std::string getCPUFusionCacheDir();
+
 // Treats the given graph as a fusion group and launches it on the
 // specified device with the given inputs.
 // Returns the outputs.
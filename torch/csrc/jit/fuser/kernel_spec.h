@@ -67,6 +67,11 @@ struct TORCH_API OutputMapAndSize {
   int64_t sizeInput_;
 };
 
+// Records how the sizes of a kernel output relate to the map size. Outputs
+// of fused reductions drop its last dimension, or keep it with size 1.
+// See Note [Fused reductions] in graph_fuser.cpp.
+enum class OutputReduction { None, Reduce, ReduceKeepDim };
+
 // "Kernel Specification." - Contains device-independent fusion information.
 // Each kernel specification contains a map of instantiated generated functions
 // that implement some or most of its functionality. Multiple generated
@@ -91,12 +96,15 @@ struct TORCH_API KernelSpec {
         inputBroadcastGroups_{},
         inputChunks_{},
         outputMapAndSizes_{},
+        outputReductions_{},
         has_random_{false},
+        has_reduction_{false},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
       if (n->kind() == aten::rand_like) {
         has_random_ = true;
-        break;
+      } else if (n->kind() == aten::sum || n->kind() == aten::mean) {
+        has_reduction_ = true;
       }
     }
     nTensorInputs_ = std::count_if(
@@ -140,10 +148,21 @@ struct TORCH_API KernelSpec {
     return outputMapAndSizes_;
   }
 
+  std::vector<OutputReduction>& outputReductions() {
+    return outputReductions_;
+  }
+  const std::vector<OutputReduction>& outputReductions() const {
+    return outputReductions_;
+  }
+
   bool hasRandom() const {
     return has_random_;
   }
 
+  bool hasReduction() const {
+    return has_reduction_;
+  }
+
   // Cache functions
   c10::optional<std::shared_ptr<FusedKernel>> findKernel(
       const ArgSpec& arg_spec) const {
@@ -172,7 +191,10 @@ struct TORCH_API KernelSpec {
   // element per fusion group output (which may be larger than the
   // number of kernel outputs).
   std::vector<OutputMapAndSize> outputMapAndSizes_;
+  // One element per kernel output, filled in during upfront compilation.
+  std::vector<OutputReduction> outputReductions_;
   bool has_random_;
+  bool has_reduction_;
   mutable std::mutex mutex_;
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
@@ -2,6 +2,7 @@
 
 #include <ATen/core/ivalue.h>
 #include <c10/util/Exception.h>
+#include <c10/util/LeftRight.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/jit/argument_spec.h>
 #include <torch/csrc/jit/autodiff.h>
@@ -10,6 +11,8 @@
 #include <torch/csrc/jit/interpreter.h>
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/pass_manager.h>
+#include <torch/csrc/jit/passes/algebraic_simplification.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
 #include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -18,9 +21,11 @@
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
+#include <torch/csrc/jit/passes/fork_independent_nodes.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/inplace_check.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
 #include <torch/csrc/jit/passes/peephole.h>
@@ -28,6 +33,7 @@
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/strength_reduction.h>
 #include <torch/csrc/jit/profiling_graph_executor_impl.h>
 #include <torch/csrc/jit/profiling_record.h>
 #include <torch/csrc/jit/resource_guard.h>
@@ -37,6 +43,7 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/jit/script/logging.h>
 
+#include <atomic>
 #include <cstdint>
 #include <iterator>
 #include <memory>
@@ -56,6 +63,13 @@ void debugSetAutodiffSubgraphInlining(bool state) {
   autodiff_subgraph_inlining = state;
 }
 
+// when set, independent computations in optimized graphs are forked, so that
+// they run concurrently on the inter-op thread pool
+thread_local bool automatic_fork_mode = false;
+bool& getAutomaticForkMode() {
+  return automatic_fork_mode;
+}
+
 thread_local std::weak_ptr<Graph> last_executed_optimized_graph;
 std::shared_ptr<Graph> lastExecutedOptimizedGraph() {
   return last_executed_optimized_graph.lock();
@@ -467,6 +481,127 @@ GraphExecutor* getGradExecutor(Operation& op) {
 }
 } // namespace detail
 
+namespace {
+
+void runOptimization(std::shared_ptr<Graph>& graph) {
+  // Basic graph preprocessing to eliminate noise. These passes only remove
+  // and move nodes, so they can share their alias analysis, which is the most
+  // expensive part of them on large graphs.
+  {
+    AliasDb aliasDb(graph);
+    EliminateDeadCode(graph, aliasDb);
+    EliminateCommonSubexpression(graph, aliasDb);
+    ConstantPooling(graph, aliasDb);
+  }
+
+  PeepholeOptimize(graph);
+  ConstantPropagation(graph);
+  AlgebraicSimplification(graph);
+
+  // Unroll small loops, and eliminate expressions that are the same at every
+  // iteration.
+  UnrollLoops(graph);
+  EliminateCommonSubexpression(graph);
+  // Compute the loop invariants of the remaining loops once, and replace
+  // multiplications of induction variables with additions.
+  LoopInvariantCodeMotion(graph);
+  StrengthReduction(graph);
+
+  CheckInplace(graph);
+}
+
+void runNondiffOptimization(std::shared_ptr<Graph>& graph) {
+  // run custom passes that different backends can register
+  for (const auto& pass : getCustomPasses()) {
+    pass(graph);
+  }
+  // decomposition pass, decompose certain ops that will be used in the following
+  // passes (like batchmm and jit fusion)
+  DecomposeOps(graph);
+  // Rewrite subgraphs with many MMs into expressions that batch them.
+  BatchMM(graph);
+
+  FuseGraph(graph);
+
+  // This goes last, so that the cost of fusion groups is known and the
+  // other passes don't have to look into the forked subgraphs.
+  if (getAutomaticForkMode()) {
+    ForkIndependentNodes(graph);
+  }
+}
+
+bool mayIntroduceGradient(const Block* b) {
+  for (const Node* n : b->nodes()) {
+    if (n->kind() == prim::PythonOp)
+      return true;
+    for (const Block* bb : n->blocks()) {
+      if (mayIntroduceGradient(bb))
+        return true;
+    }
+  }
+  return false;
+}
+
+bool needsGradient(const std::shared_ptr<const Graph>& graph) {
+  if (!autograd::GradMode::is_enabled())
+    return false;
+  if (mayIntroduceGradient(graph->block()))
+    return true;
+  for (const Value* input : graph->inputs()) {
+    if (input->type()->requires_grad())
+      return true;
+  }
+  return false;
+}
+
+} // namespace
+
+void runSpecializedOptimizations(std::shared_ptr<Graph>& opt_graph) {
+  // Phase 2. Propagate detailed information about the spec through the
+  //          graph (enabled more specializations in later passes).
+  //          Shape propagation sometimes depends on certain arguments being
+  //          constants, and constant propagation doesn't need shape
+  //          information anyway, so it's better to run it first.
+  ConstantPropagation(opt_graph);
+  PropagateInputShapes(opt_graph);
+  PropagateRequiresGrad(opt_graph);
+
+  // Phase 3. Run differentiable optimizations (i.e. simple graph rewrites
+  //          that we can still execute using autograd).
+  runOptimization(opt_graph);
+
+  // Phase 4. If this graph will be differentiated, we need to slice out the
+  //          symbolically differentiable subgraphs for further optimizations.
+  // Phase 5. Apply non-differentiable optimizations to the graphs we've found
+  //          (or the whole grpah if we know we won't need its derivative).
+  if (needsGradient(opt_graph)) {
+    auto diff_nodes = CreateAutodiffSubgraphs(
+        opt_graph,
+        autodiff_subgraph_inlining ? autodiffSubgraphNodeThreshold : 1);
+    for (Node* dnode : diff_nodes) {
+      auto diff_graph = std::move(dnode->g(attr::Subgraph));
+      Gradient gradient = differentiate(diff_graph);
+      // Run post differentiation optimizations, Autodiff will replace some
+      // parts of graph with new graph, these new graphs usually consists of
+      // control flows and miss shape information on nodes, so we run shape
+      // prop and differentiable optimizations to ensure the graph is
+      // optimized
+      PropagateInputShapes(gradient.f);
+      runOptimization(gradient.f);
+      // run non diff optimization on the forward graph
+      runNondiffOptimization(gradient.f);
+      packGradient(gradient, dnode);
+    }
+    InlineAutodiffSubgraphs(
+        opt_graph,
+        autodiff_subgraph_inlining ? autodiffSubgraphInlineThreshold : 1);
+  } else {
+    runNondiffOptimization(opt_graph);
+  }
+  // Make sure there are no leftovers from any passes.
+  EliminateDeadCode(opt_graph);
+}
+
 // a Graph can be created via tracing, or via a language-based frontend
 // GraphExecutor runs it. It can run the same graph on many different sizes
 // and different requires_grad states, and handles specializations for each
@@ -506,44 +641,74 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     if (fallback) {
       state.fallback = fallback.getDebugState();
     }
-    for (auto& entry : plan_cache) {
-      state.execution_plans.emplace(entry.first, entry.second.getDebugState());
-    }
+    plan_cache.read([&](const PlanCache& cache) {
+      for (auto& entry : cache) {
+        state.execution_plans.emplace(
+            entry.first, entry.second->getDebugState());
+      }
+    });
     return state;
   }
 
+  void freeze() override {
+    // compile the plan for the inputs that have no specialization up front,
+    // so that getOrCompileFallback doesn't need the lock any more either
+    getOrCompileFallback();
+    frozen = true;
+  }
+
  protected:
   friend struct GraphExecutor;
 
   const ExecutionPlan& getOrCompileFallback() {
-    std::lock_guard<std::mutex> lock(compile_mutex);
-    if (!fallback) {
-      auto graph_ = graph->copy();
-      runRequiredPasses(graph_);
-      fallback = ExecutionPlan(graph_);
+    if (!fallback_ready.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(compile_mutex);
+      if (!fallback) {
+        auto graph_ = graph->copy();
+        runRequiredPasses(graph_);
+        fallback = ExecutionPlan(graph_);
+        fallback_ready.store(true, std::memory_order_release);
+      }
     }
     return fallback;
   }
 
+  std::shared_ptr<ExecutionPlan> findPlan(const ArgumentSpec& spec) const {
+    return plan_cache.read(
+        [&](const PlanCache& cache) -> std::shared_ptr<ExecutionPlan> {
+          auto it = cache.find(spec);
+          return it != cache.end() ? it->second : nullptr;
+        });
+  }
+
   const ExecutionPlan& getOrCompile(const Stack& stack) {
-    // outside lock guard, to minimize the time holding the lock on the fast
-    // path ArgumentSpec even computes its hashCode here.
+    // The plan cache is read-mostly: lookups never block each other, and
+    // compile_mutex is only taken to compile a new specialization. Plans are
+    // never removed from the cache, so they stay alive for as long as this
+    // executor does.
     ArgumentSpec spec =
         arg_spec_creator_.create(autograd::GradMode::is_enabled(), stack);
-    {
-      std::lock_guard<std::mutex> lock(compile_mutex);
-      auto it = plan_cache.find(spec);
-      if (it != plan_cache.end()) {
-        logging::getLogger()->addStatValue(
-            logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
-        return it->second;
-      }
-      auto plan = compileSpec(spec);
-      auto r = plan_cache.emplace(std::move(spec), std::move(plan));
+    if (auto plan = findPlan(spec)) {
       logging::getLogger()->addStatValue(
-          logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
-      return r.first->second;
+          logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+      return *plan;
     }
+    if (frozen) {
+      return getOrCompileFallback();
+    }
+    std::lock_guard<std::mutex> lock(compile_mutex);
+    // another thread may have compiled it while we were waiting for the lock
+    if (auto plan = findPlan(spec)) {
+      logging::getLogger()->addStatValue(
+          logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+      return *plan;
+    }
+    auto plan = std::make_shared<ExecutionPlan>(compileSpec(spec));
+    plan_cache.write(
+        [&](PlanCache& cache) { cache.emplace(spec, plan); });
+    logging::getLogger()->addStatValue(
+        logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
+    return *plan;
   }
 
   ExecutionPlan compileSpec(const ArgumentSpec& spec) {
@@ -555,108 +720,10 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     //          to an executable form.
     runRequiredPasses(opt_graph);
 
-    // Phase 2. Propagate detailed information about the spec through the
-    //          graph (enabled more specializations in later passes).
-    //          Shape propagation sometimes depends on certain arguments being
-    //          constants, and constant propagation doesn't need shape
-    //          information anyway, so it's better to run it first.
-    ConstantPropagation(opt_graph);
-    PropagateInputShapes(opt_graph);
-    PropagateRequiresGrad(opt_graph);
-
-    // Phase 3. Run differentiable optimizations (i.e. simple graph rewrites
-    //          that we can still execute using autograd).
-    runOptimization(opt_graph);
-
-    // Phase 4. If this graph will be differentiated, we need to slice out the
-    //          symbolically differentiable subgraphs for further optimizations.
-    // Phase 5. Apply non-differentiable optimizations to the graphs we've found
-    //          (or the whole grpah if we know we won't need its derivative).
-    if (needsGradient(opt_graph)) {
-      auto diff_nodes = CreateAutodiffSubgraphs(
-          opt_graph,
-          autodiff_subgraph_inlining ? autodiffSubgraphNodeThreshold : 1);
-      for (Node* dnode : diff_nodes) {
-        auto diff_graph = std::move(dnode->g(attr::Subgraph));
-        Gradient gradient = differentiate(diff_graph);
-        // Run post differentiation optimizations, Autodiff will replace some
-        // parts of graph with new graph, these new graphs usually consists of
-        // control flows and miss shape information on nodes, so we run shape
-        // prop and differentiable optimizations to ensure the graph is
-        // optimized
-        PropagateInputShapes(gradient.f);
-        runOptimization(gradient.f);
-        // run non diff optimization on the forward graph
-        runNondiffOptimization(gradient.f);
-        packGradient(gradient, dnode);
-      }
-      InlineAutodiffSubgraphs(
-          opt_graph,
-          autodiff_subgraph_inlining ? autodiffSubgraphInlineThreshold : 1);
-    } else {
-      runNondiffOptimization(opt_graph);
-    }
-    // Make sure there are no leftovers from any passes.
-    EliminateDeadCode(opt_graph);
+    runSpecializedOptimizations(opt_graph);
     return ExecutionPlan(opt_graph);
   }
 
-  void runOptimization(
-      std::shared_ptr<Graph>& graph) {
-    // Basic graph preprocessing to eliminate noise.
-    EliminateDeadCode(graph);
-    EliminateCommonSubexpression(graph);
-    ConstantPooling(graph);
-
-    PeepholeOptimize(graph);
-    ConstantPropagation(graph);
-
-    // Unroll small loops, and eliminate expressions that are the same at every
-    // iteration.
-    UnrollLoops(graph);
-    EliminateCommonSubexpression(graph);
-
-    CheckInplace(graph);
-  }
-
-  void runNondiffOptimization(std::shared_ptr<Graph>& graph) {
-    // run custom passes that different backends can register
-    for (const auto& pass : getCustomPasses()) {
-      pass(graph);
-    }
-    // decomposition pass, decompose certain ops that will be used in the following
-    // passes (like batchmm and jit fusion)
-    DecomposeOps(graph);
-    // Rewrite subgraphs with many MMs into expressions that batch them.
-    BatchMM(graph);
-
-    FuseGraph(graph);
-  }
-
-  static bool needsGradient(const std::shared_ptr<const Graph>& graph) {
-    if (!autograd::GradMode::is_enabled())
-      return false;
-    if (mayIntroduceGradient(graph->block()))
-      return true;
-    for (const Value* input : graph->inputs()) {
-      if (input->type()->requires_grad())
-        return true;
-    }
-    return false;
-  }
-
-  static bool mayIntroduceGradient(const Block* b) {
-    for (const Node* n : b->nodes()) {
-      if (n->kind() == prim::PythonOp)
-        return true;
-      for (const Block* bb : n->blocks()) {
-        if (mayIntroduceGradient(bb))
-          return true;
-      }
-    }
-    return false;
-  }
-
   void runTraced(Stack& stack) {
     const auto& state = tracer::getTracingState();
     auto inputs = last(stack, num_inputs);
@@ -695,13 +762,16 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   ~GraphExecutorImpl() override = default;
 
   ArgumentSpecCreator arg_spec_creator_;
-  // Populated only when optimize is false (and in that case plan_cache will be
-  // unused). The compiled version of graph.
+  // Populated when optimize is false (and in that case plan_cache will be
+  // unused), or when the executor is frozen. The compiled version of graph.
   ExecutionPlan fallback;
+  std::atomic<bool> fallback_ready{false};
 
   // Mapping from argument configurations to optimized versions of the graph
   // that are specialized to the spec.
-  std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+  using PlanCache =
+      std::unordered_map<ArgumentSpec, std::shared_ptr<ExecutionPlan>>;
+  c10::LeftRight<PlanCache> plan_cache;
 };
 
 GraphExecutor::GraphExecutor(std::shared_ptr<Graph> graph, bool optimize)
@@ -724,6 +794,10 @@ GraphExecutorState GraphExecutor::getDebugState() {
   return pImpl->getDebugState();
 }
 
+void GraphExecutor::freeze() {
+  pImpl->freeze();
+}
+
 void runRequiredPasses(const std::shared_ptr<Graph>& g) {
   specializeAutogradZero(*g);
   LowerGradOf(*g);
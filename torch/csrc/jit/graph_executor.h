@@ -36,6 +36,11 @@ struct TORCH_API GraphExecutor {
   }
   std::shared_ptr<Graph> graph() const;
   GraphExecutorState getDebugState();
+  // Stops compiling new specializations. Inputs that match an already
+  // compiled plan keep running it, all others run the unspecialized graph.
+  // Afterwards, run() never takes an exclusive lock, so a warmed up executor
+  // can be shared by many threads without contention.
+  void freeze();
 
  private:
   std::shared_ptr<GraphExecutorImplBase> pImpl;
@@ -50,6 +55,10 @@ TORCH_API std::shared_ptr<Graph> lastExecutedOptimizedGraph();
 
 TORCH_API bool& getProfilingMode();
 
+// Whether to run ForkIndependentNodes on optimized graphs that don't need
+// gradients, see passes/fork_independent_nodes.h
+TORCH_API bool& getAutomaticForkMode();
+
 namespace detail {
 
 GraphExecutor* getGradExecutor(Operation& op);
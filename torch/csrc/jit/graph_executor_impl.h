@@ -19,6 +19,7 @@
 #include <torch/csrc/jit/script/compiler.h>
 #include <torch/csrc/jit/script/logging.h>
 
+#include <atomic>
 #include <cstdint>
 #include <iterator>
 #include <memory>
@@ -52,6 +53,11 @@ struct ExecutionPlan {
   std::shared_ptr<Graph> graph;
 };
 
+// Runs the optimizations GraphExecutorImpl applies once the input types of
+// a graph have been specialized (shape propagation, autodiff subgraphs,
+// fusion, ...). The graph must already have gone through runRequiredPasses.
+void runSpecializedOptimizations(std::shared_ptr<Graph>& graph);
+
 // a Graph can be created via tracing, or via a language-based frontend
 // GraphExecutor runs it. It can run the same graph on many different sizes
 // and different requires_grad states, and handles specializations for each
@@ -76,6 +82,10 @@ struct GraphExecutorImplBase {
   // entry point where execution begins
   virtual void run(Stack& stack) = 0;
   virtual GraphExecutorState getDebugState() = 0;
+  // see GraphExecutor::freeze
+  virtual void freeze() {
+    frozen = true;
+  }
   virtual ~GraphExecutorImplBase() = default;
 
  protected:
@@ -92,8 +102,11 @@ struct GraphExecutorImplBase {
   const size_t num_inputs;
   const size_t num_outputs;
 
-  // GraphExecutors can be accessed from multiple threads, so this thread needs
-  // to be held every time we access the fallback or plan_cache.
+  // If true, no new specializations are compiled any more.
+  std::atomic<bool> frozen{false};
+
+  // GraphExecutors can be accessed from multiple threads, so this mutex needs
+  // to be held every time a plan is compiled.
   std::mutex compile_mutex;
 };
 
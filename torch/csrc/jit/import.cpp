@@ -17,12 +17,14 @@
 #include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 #include <ATen/ATen.h>
 
 #include <fstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
@@ -30,6 +32,7 @@ namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::ReadAdapterInterface;
 
 namespace {
@@ -49,13 +52,21 @@ class ScriptModuleDeserializer final {
       script::ModuleLookup module_lookup,
       c10::optional<at::Device> device,
       script::ExtraFilesMap& extra_files);
+  void reloadParameters(
+      script::Module& module,
+      c10::optional<at::Device> device);
 
  private:
+  void readModelDef(torch::ModelDef* model_def);
   at::Tensor loadTensor(
       const torch::TensorDef& tensor_proto,
       std::unordered_map<std::string, at::Storage>& storageMap);
 
   void convertModule(const torch::ModuleDef& module_def);
+  void matchParameters(
+      const torch::ModuleDef& module_def,
+      script::Module& module,
+      std::vector<std::pair<script::Slot, at::Tensor>>& updates);
 
   void loadTensorTable(torch::ModelDef* model_def);
   std::vector<IValue> loadPickleArchive(const std::string& name);
@@ -91,11 +102,7 @@ ScriptModuleDeserializer::ScriptModuleDeserializer(
     std::unique_ptr<ReadAdapterInterface> rai)
     : reader_(std::move(rai)) {}
 
-void ScriptModuleDeserializer::deserialize(
-    script::ModuleLookup module_lookup,
-    c10::optional<at::Device> device,
-    script::ExtraFilesMap& extra_files) {
-  torch::ModelDef model_def;
+void ScriptModuleDeserializer::readModelDef(torch::ModelDef* model_def) {
   at::DataPtr data_ptr;
   size_t data_size;
   std::tie(data_ptr, data_size) = reader_.getRecord("model.json");
@@ -104,7 +111,7 @@ void ScriptModuleDeserializer::deserialize(
   std::string url_prefix = "type.googleapis.com";
   std::unique_ptr<::google::protobuf::util::TypeResolver> resolver(
       ::google::protobuf::util::NewTypeResolverForDescriptorPool(
-          url_prefix, model_def.GetDescriptor()->file()->pool()));
+          url_prefix, model_def->GetDescriptor()->file()->pool()));
   std::string json_string = std::string(
       static_cast<char*>(data_ptr.get()),
       static_cast<char*>(data_ptr.get()) + data_size);
@@ -113,7 +120,7 @@ void ScriptModuleDeserializer::deserialize(
   opts.ignore_unknown_fields = true;
   auto convert_result = ::google::protobuf::util::JsonToBinaryString(
       resolver.get(),
-      url_prefix + "/" + model_def.GetDescriptor()->full_name(),
+      url_prefix + "/" + model_def->GetDescriptor()->full_name(),
       json_string,
       &binary_string,
       opts);
@@ -123,8 +130,16 @@ void ScriptModuleDeserializer::deserialize(
     AT_ERROR(ss.str());
   }
   AT_ASSERTM(
-      model_def.ParseFromString(binary_string),
+      model_def->ParseFromString(binary_string),
       "JSON transcoder produced invalid protobuf output.");
+}
+
+void ScriptModuleDeserializer::deserialize(
+    script::ModuleLookup module_lookup,
+    c10::optional<at::Device> device,
+    script::ExtraFilesMap& extra_files) {
+  torch::ModelDef model_def;
+  readModelDef(&model_def);
   moduleLookup_ = module_lookup;
   device_ = device;
   main_module_ = module_lookup({});
@@ -153,6 +168,135 @@ void ScriptModuleDeserializer::deserialize(
   convertModule(module_def);
 }
 
+void ScriptModuleDeserializer::reloadParameters(
+    script::Module& module,
+    c10::optional<at::Device> device) {
+  torch::ModelDef model_def;
+  readModelDef(&model_def);
+  device_ = device;
+  // Only the tensors are read: the code of the archive is neither parsed
+  // nor compiled.
+  loadTensorTable(&model_def);
+  if (model_def.proto_version() >= 2) {
+    pickled_ivalues_ = loadPickleArchive("attributes.pkl");
+  }
+
+  // Check every tensor before replacing any of them, so that the module is
+  // either fully updated or left unchanged.
+  std::vector<std::pair<script::Slot, at::Tensor>> updates;
+  matchParameters(model_def.main_module(), module, updates);
+  for (auto& update : updates) {
+    update.first.setValue(std::move(update.second));
+  }
+}
+
+void ScriptModuleDeserializer::matchParameters(
+    const torch::ModuleDef& module_def,
+    script::Module& module,
+    std::vector<std::pair<script::Slot, at::Tensor>>& updates) {
+  AT_CHECK(
+      static_cast<size_t>(module_def.submodules_size()) ==
+          module.get_modules().size(),
+      "module '",
+      module.name(),
+      "' has ",
+      module.get_modules().size(),
+      " submodules, but the archive has ",
+      module_def.submodules_size());
+  for (int i = 0; i < module_def.submodules_size(); ++i) {
+    const torch::ModuleDef& sub_def = module_def.submodules(i);
+    auto submodule = module.find_module(sub_def.name());
+    AT_CHECK(
+        submodule != nullptr,
+        "the archive has a submodule '",
+        sub_def.name(),
+        "' that module '",
+        module.name(),
+        "' doesn't have");
+    matchParameters(sub_def, *submodule, updates);
+  }
+  AT_CHECK(
+      !module_def.has_get_state_attribute_id(),
+      "module '",
+      module.name(),
+      "' was saved with __getstate__, and its tensors can only be restored by "
+      "loading it");
+
+  std::unordered_set<std::string> matched;
+  auto match = [&](const std::string& name,
+                   script::Slot* slot,
+                   at::Tensor tensor) {
+    AT_CHECK(
+        slot != nullptr,
+        "the archive has a tensor '",
+        name,
+        "' that module '",
+        module.name(),
+        "' doesn't have");
+    at::Tensor current = slot->value().toTensor();
+    // The graph executors specialize their plans on these properties, so
+    // keeping them lets the new tensors reuse the optimized graphs.
+    AT_CHECK(
+        tensor.scalar_type() == current.scalar_type() &&
+            tensor.device() == current.device() &&
+            tensor.sizes() == current.sizes() &&
+            tensor.requires_grad() == current.requires_grad(),
+        "'",
+        name,
+        "' of module '",
+        module.name(),
+        "' is a ",
+        current.type().toString(),
+        " of size ",
+        current.sizes(),
+        current.requires_grad() ? " requiring grad" : "",
+        ", but the archive has a ",
+        tensor.type().toString(),
+        " of size ",
+        tensor.sizes(),
+        tensor.requires_grad() ? " requiring grad" : "");
+    updates.emplace_back(*slot, std::move(tensor));
+    matched.insert(name);
+  };
+  for (int i = 0; i < module_def.parameters_size(); ++i) {
+    const torch::ParameterDef& param_def = module_def.parameters(i);
+    match(
+        param_def.name(),
+        param_def.is_buffer() ? module.find_buffer(param_def.name())
+                              : module.find_parameter(param_def.name()),
+        tensor_table_.at(param_def.tensor_id()));
+  }
+  for (int i = 0; i < module_def.attributes_size(); ++i) {
+    const torch::AttributeDef& attr_def = module_def.attributes(i);
+    // The "training" buffer is the mode of the module rather than state, so
+    // the module keeps its own
+    if (attr_def.id() < 0 || attr_def.name() == "training" ||
+        matched.count(attr_def.name())) {
+      continue;
+    }
+    const IValue& ivalue = pickled_ivalues_.at(attr_def.id());
+    if (ivalue.isTensor()) {
+      match(
+          attr_def.name(),
+          module.find_buffer(attr_def.name()),
+          ivalue.toTensor());
+    }
+  }
+
+  size_t num_buffers = 0;
+  for (const auto& attr : module.get_attributes()) {
+    num_buffers += attr.value().isTensor() && attr.name() != "training";
+  }
+  AT_CHECK(
+      matched.size() == module.get_parameters().size() + num_buffers,
+      "module '",
+      module.name(),
+      "' has ",
+      module.get_parameters().size() + num_buffers,
+      " parameters and buffers, but the archive has ",
+      matched.size());
+}
+
 void ScriptModuleDeserializer::loadTensorTable(torch::ModelDef* model_def) {
   std::unordered_map<std::string, at::Storage> storageMap;
   for (const torch::TensorDef& tensor : model_def->tensors()) {
@@ -381,6 +525,31 @@ void import_ir_module(
   deserializer.deserialize(module_lookup, device, extra_files);
 }
 
+void reload_parameters(
+    script::Module& module,
+    std::istream& in,
+    c10::optional<at::Device> device) {
+  ScriptModuleDeserializer deserializer(&in);
+  deserializer.reloadParameters(module, device);
+}
+
+void reload_parameters(
+    script::Module& module,
+    const std::string& filename,
+    c10::optional<at::Device> device) {
+  ScriptModuleDeserializer deserializer(
+      caffe2::make_unique<FileAdapter>(filename));
+  deserializer.reloadParameters(module, device);
+}
+
+void reload_parameters(
+    script::Module& module,
+    std::unique_ptr<ReadAdapterInterface> rai,
+    c10::optional<at::Device> device) {
+  ScriptModuleDeserializer deserializer(std::move(rai));
+  deserializer.reloadParameters(module, device);
+}
+
 std::shared_ptr<script::Module> load(
     std::istream& in,
     c10::optional<at::Device> device,
@@ -400,6 +569,16 @@ std::shared_ptr<script::Module> load(
   return module;
 }
 
+std::shared_ptr<script::Module> load_lazily(
+    const std::string& filename,
+    script::ExtraFilesMap& extra_files) {
+  // Mapped records only stay lazy if they aren't copied to another device.
+  return load(
+      caffe2::make_unique<MmapFileAdapter>(filename),
+      at::Device(at::kCPU),
+      extra_files);
+}
+
 std::shared_ptr<script::Module> load(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device,
@@ -53,15 +53,65 @@ TORCH_API std::shared_ptr<script::Module> load(
     c10::optional<c10::Device> device = c10::nullopt,
     script::ExtraFilesMap& extra_files = default_extra_files);
 
+/// Loads a serialized `script::Module` from the given `filename`, with its
+/// tensors materialized lazily on the CPU.
+///
+/// Instead of reading the tensors of the module, this maps the file and makes
+/// the tensors alias the mapped pages, so they are only read from disk (or
+/// the page cache) when they are first accessed. Load time and memory use are
+/// then proportional to the part of the module that is actually used, and
+/// the unmodified pages of tensors are shared with every other process that
+/// loads the same file this way. Writing to a tensor copies the pages it
+/// writes to, and never changes the file. The file must not be changed while
+/// the module is alive. Not supported on Windows.
+TORCH_API std::shared_ptr<script::Module> load_lazily(
+    const std::string& filename,
+    script::ExtraFilesMap& extra_files = default_extra_files);
+
 /// Loads a serialized `script::Module` from the given `rai`.
 ///
 /// The reader adapter, which is for customized input stream, must contain a
 /// serialized `script::Module`, exported either via `ScriptModule.save()` in
 /// Python or `torch::jit::ExportModule` in C++.
+///
+/// Passing a `caffe2::serialize::MmapFileAdapter` maps the file, and lets the
+/// tensors loaded to the CPU alias the mapped pages instead of being copied
+/// out of the file.
 TORCH_API std::shared_ptr<script::Module> load(
     std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt,
     script::ExtraFilesMap& extra_files = default_extra_files);
 
+/// Replaces the parameters and buffers of `module` with the tensors of the
+/// serialized `script::Module` in `filename`, without compiling the module
+/// again.
+///
+/// The archive must have the same structure as `module`: the same
+/// submodules, and parameters and buffers with the same names, dtypes, sizes
+/// and `requires_grad`, and on the same devices once `device` is applied.
+/// Its code, its other attributes and its `training` flag are not read.
+/// Everything is checked before any tensor is replaced, so that on error
+/// `module` is left unchanged. The methods of `module` keep their graph
+/// executors, and so their optimized graphs and fused kernels. The tensors
+/// are replaced, not copied into, so tensors previously returned by
+/// `get_parameter` are unaffected. The swap must not race with calls to the
+/// methods of `module`.
+TORCH_API void reload_parameters(
+    script::Module& module,
+    const std::string& filename,
+    c10::optional<c10::Device> device = c10::nullopt);
+
+/// Like `reload_parameters` above, for a module serialized in `in`.
+TORCH_API void reload_parameters(
+    script::Module& module,
+    std::istream& in,
+    c10::optional<c10::Device> device = c10::nullopt);
+
+/// Like `reload_parameters` above, for a module read through `rai`.
+TORCH_API void reload_parameters(
+    script::Module& module,
+    std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
+    c10::optional<c10::Device> device = c10::nullopt);
+
 } // namespace jit
 } // namespace torch
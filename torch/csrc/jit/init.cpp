@@ -10,6 +10,8 @@
 #include <torch/csrc/jit/import.h>
 #include <torch/csrc/jit/irparser.h>
 #include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/algebraic_simplification.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -19,10 +21,15 @@
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/erase_number_types.h>
+#include <torch/csrc/jit/passes/fork_independent_nodes.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
+#include <torch/csrc/jit/passes/mkldnn_rewrite.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/constant_fold.h>
 #include <torch/csrc/jit/passes/onnx/fixup_onnx_loop.h>
@@ -34,7 +41,9 @@
 #include <torch/csrc/jit/passes/remove_inplace_ops.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/strength_reduction.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
 #include <torch/csrc/jit/passes/utils/check_alias_annotation.h>
 #include <torch/csrc/jit/pybind_utils.h>
 #include <torch/csrc/jit/python_arg_flatten.h>
@@ -187,9 +196,34 @@ void initJITBindings(PyObject* module) {
                   at::ScalarType::QInt8);
             }
           })
+      .def(
+          "_jit_pass_quant_fusion",
+          [](std::shared_ptr<Graph>& g) { return QuantFusion(g); })
       .def(
           "_jit_pass_quantlint",
           [](std::shared_ptr<Graph>& g) { return QuantLinting(g); })
+      .def(
+          "_jit_pass_freeze_module",
+          [](std::shared_ptr<script::Module>& moduleObj,
+             const std::string& methodName) {
+            return FreezeMethod(moduleObj->get_method(methodName));
+          },
+          py::arg("module"),
+          py::arg("method_name") = "forward")
+      .def(
+          "_jit_pass_fold_conv_bn",
+          [](std::shared_ptr<Graph>& g) { return FoldConvBatchNorm(g); })
+      .def(
+          "_jit_pass_convert_frozen_ops_to_mkldnn",
+          [](std::shared_ptr<Graph>& g) {
+            return ConvertFrozenOpsToMKLDNN(g);
+          })
+      .def(
+          "_jit_pass_plan_memory",
+          [](std::shared_ptr<Graph>& g) { return PlanMemory(g); })
+      .def(
+          "_jit_pass_batch_mm",
+          [](std::shared_ptr<Graph>& g) { return BatchMM(g); })
       .def(
           "_jit_pass_pattern_based_rewrite",
           [](std::shared_ptr<script::Module>& m) {
@@ -260,6 +294,50 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_inline_fork_wait", InlineForkWait)
       .def("_jit_pass_prepare_division_for_onnx", PrepareDivisionForONNX)
       .def("_jit_pass_loop_unrolling", UnrollLoops)
+      .def("_jit_pass_licm", LoopInvariantCodeMotion)
+      .def("_jit_pass_strength_reduction", StrengthReduction)
+      .def(
+          "_jit_pass_algebraic_simplification",
+          [](std::shared_ptr<Graph> g) { AlgebraicSimplification(g); })
+      .def(
+          "_jit_pass_fork_independent_nodes",
+          [](std::shared_ptr<Graph> g, int64_t min_cost) {
+            ForkIndependentNodes(g, min_cost);
+          },
+          py::arg("graph"),
+          py::arg("min_cost") = kDefaultMinForkCost)
+      .def(
+          "_jit_pass_propagate_symbolic_shapes",
+          [](const std::shared_ptr<Graph>& graph,
+             const std::vector<c10::optional<std::vector<int64_t>>>&
+                 input_shapes) {
+            // shapes are lists of ints on the Python side, with symbols as
+            // negative values
+            std::vector<c10::optional<SymbolicShape>> symbolic_inputs;
+            for (const auto& input_shape : input_shapes) {
+              if (!input_shape) {
+                symbolic_inputs.emplace_back(c10::nullopt);
+                continue;
+              }
+              SymbolicShape shape;
+              for (int64_t dim : *input_shape) {
+                shape.push_back(ShapeSymbol::fromValue(dim));
+              }
+              symbolic_inputs.emplace_back(std::move(shape));
+            }
+            auto shapes = PropagateSymbolicShapes(graph, symbolic_inputs);
+            std::unordered_map<std::string, std::vector<int64_t>> result;
+            for (const auto& entry : shapes.shapes) {
+              auto& dims = result[entry.first->uniqueName()];
+              for (ShapeSymbol dim : entry.second) {
+                dims.push_back(dim.value());
+              }
+            }
+            return result;
+          },
+          py::arg("graph"),
+          py::arg("input_shapes") =
+              std::vector<c10::optional<std::vector<int64_t>>>())
       .def(
           "_jit_pass_constant_propagation",
           [](std::shared_ptr<Graph>& g) { return ConstantPropagation(g); })
@@ -296,6 +374,8 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_decompose_ops", DecomposeOps)
       .def("_jit_pass_specialize_autogradzero", specializeAutogradZero)
       .def("_jit_override_can_fuse_on_cpu", &overrideCanFuseOnCPU)
+      .def("_jit_set_cpu_fusion_cache_dir", &setCPUFusionCacheDir)
+      .def("_jit_get_cpu_fusion_cache_dir", &getCPUFusionCacheDir)
       .def(
           "_jit_differentiate",
           [](Graph& g) {
@@ -316,6 +396,9 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_set_profiling_mode",
           [](bool profiling_flag) { getProfilingMode() = profiling_flag; })
+      .def(
+          "_jit_set_automatic_fork_mode",
+          [](bool enabled) { getAutomaticForkMode() = enabled; })
       .def(
           "_jit_fuser_get_fused_kernel_code",
           [](Graph& g, std::vector<at::Tensor> inps) {
@@ -331,13 +414,21 @@ void initJITBindings(PyObject* module) {
       });
   // NOLINTNEXTLINE(bugprone-unused-raii)
   py::class_<ArgumentSpec>(m, "ArgumentSpec");
-  py::class_<Code>(m, "Code").def("grad_executor_states", [](Code& c) {
-    std::vector<GraphExecutorState> states;
-    for (auto& e : c.grad_executors()) {
-      states.emplace_back(e->getDebugState());
-    }
-    return states;
-  });
+  py::class_<Code>(m, "Code")
+      .def(
+          "grad_executor_states",
+          [](Code& c) {
+            std::vector<GraphExecutorState> states;
+            for (auto& e : c.grad_executors()) {
+              states.emplace_back(e->getDebugState());
+            }
+            return states;
+          })
+      .def("__str__", [](Code& c) {
+        std::ostringstream s;
+        s << c;
+        return s.str();
+      });
 
   py::class_<ExecutionPlanState>(m, "ExecutionPlanState")
       .def_property_readonly(
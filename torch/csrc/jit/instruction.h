@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace torch {
+namespace jit {
+
+// Note [Interpreter opcodes]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Most instructions call an Operation: their inputs are pushed from the
+// registers onto the stack, the Operation is called through std::function,
+// and the outputs are popped back into the registers.  For the small
+// prim ops that dominate scripted control flow and list/tuple handling,
+// that is where most of the time goes, so these get their own opcode and
+// are run directly by the interpreter loop, reading their inputs from and
+// writing their outputs to the registers without going through the stack.
+//
+// Inputs of specialized instructions follow the same move flags as
+// everything else, except that the int and bool ops ignore them: scalars
+// don't own any memory, so there is nothing to be released early.
+//
+// The opcodes are shared by the interpreter and the bytecode runtime
+// (torch/csrc/jit/mobile), which runs the instructions of the interpreter
+// that were serialized ahead of time. Opcodes are serialized by name, so new
+// ones can be added anywhere in the list.
+#define FORALL_OPCODES(_)                                                  \
+  _(OP) /* call operation X, inputs and outputs are passed on the stack */ \
+  _(ASSIGN) /* push inputs onto the stack, then pop outputs from it */     \
+  _(DROP) /* release the inputs that are moved */                          \
+  _(JMP) /* relative jump by X */                                          \
+  _(JF) /* relative jump by X if the input is false */                     \
+  _(JT) /* relative jump by X if the input is true */                      \
+  _(LOADC) /* load constant X into the output */                           \
+  _(TUPLE_CONSTRUCT)                                                       \
+  _(TUPLE_UNPACK)                                                          \
+  _(LIST_CONSTRUCT) /* X is the ListKind of the list */                    \
+  _(LIST_UNPACK) /* X is the ListKind of the list */                       \
+  _(INT_ADD)                                                               \
+  _(INT_SUB)                                                               \
+  _(INT_MUL)                                                               \
+  _(INT_EQ)                                                                \
+  _(INT_NE)                                                                \
+  _(INT_LT)                                                                \
+  _(INT_LE)                                                                \
+  _(INT_GT)                                                                \
+  _(INT_GE)                                                                \
+  _(BOOL_AND)                                                              \
+  _(BOOL_OR)                                                               \
+  _(BOOL_NOT)
+
+enum OpCode : uint8_t {
+#define DEFINE_OPCODE(op) op,
+  FORALL_OPCODES(DEFINE_OPCODE)
+#undef DEFINE_OPCODE
+};
+
+inline const char* toString(OpCode op) {
+  switch (op) {
+#define OPCODE_STRING(op) \
+  case op:                \
+    return #op;
+    FORALL_OPCODES(OPCODE_STRING)
+#undef OPCODE_STRING
+  }
+  return nullptr;
+}
+
+// Returns false if name isn't the name of an opcode.
+inline bool parseOpCode(const char* name, OpCode* op) {
+#define PARSE_OPCODE(opcode)             \
+  if (std::strcmp(name, #opcode) == 0) { \
+    *op = opcode;                        \
+    return true;                         \
+  }
+  FORALL_OPCODES(PARSE_OPCODE)
+#undef PARSE_OPCODE
+  return false;
+}
+
+// element representation of the lists handled by LIST_CONSTRUCT/LIST_UNPACK
+enum ListKind : int {
+  IntListKind,
+  DoubleListKind,
+  BoolListKind,
+  TensorListKind,
+  GenericListKind
+};
+
+} // namespace jit
+} // namespace torch
@@ -2,13 +2,16 @@
 
 #include <ATen/core/ivalue.h>
 #include <ATen/Parallel.h>
+#include <c10/core/StreamGuard.h>
 #include <c10/core/thread_pool.h>
+#include <c10/core/impl/DeviceGuardImplInterface.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/edge.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/jit/constants.h>
 #include <torch/csrc/jit/graph_executor.h>
+#include <torch/csrc/jit/instruction.h>
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/script/jit_exception.h>
@@ -18,6 +21,7 @@
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
 #include <typeinfo>
 #include <unordered_map>
@@ -324,9 +328,27 @@ struct UseList {
   ListHandle<bool> free_flags;
 };
 
+ListKind listKindOf(const TypePtr& type) {
+  auto elem = type->expect<ListType>()->getElementType();
+  if (elem == IntType::get()) {
+    return IntListKind;
+  } else if (elem == FloatType::get()) {
+    return DoubleListKind;
+  } else if (elem == BoolType::get()) {
+    return BoolListKind;
+  } else if (elem->isSubtypeOf(TensorType::get())) {
+    return TensorListKind;
+  }
+  return GenericListKind;
+}
+
 // one instruction plus meta-data
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
 struct Instruction {
+  OpCode op = OP;
+  // jump offset, constant index, ListKind or index of the node of the
+  // operation, depending on op
+  int X = 0;
   Operation callback;
   UseList inputs;
   ListHandle<int> outputs;
@@ -348,11 +370,8 @@ struct CodeImpl {
   void createJumpFalse(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [offset](Stack& stack) {
-      auto t = pop(stack).toBool();
-      return t ? 0 : offset;
-    };
+    inst.op = JF;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::JumpZ;
   }
 
@@ -360,19 +379,16 @@ struct CodeImpl {
   void createJumpTrue(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [offset](Stack& stack) {
-      auto t = pop(stack).toBool();
-      return t ? offset : 0;
-    };
+    inst.op = JT;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::JumpNZ;
   }
 
   void createJump(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [=](Stack& stack) { return offset; };
+    inst.op = JMP;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::Jump;
   }
 
@@ -437,36 +453,42 @@ struct CodeImpl {
           // JumpZ c, end
           // begin:
           //   <body>
-          //   c, l0 = v0, v1
-          //   JumpNZ c, begin
+          //   l0 = v1
+          //   JumpNZ v0, begin
           // end:
 
+          // The jumps read the condition from its register after the assign,
+          // which is fine because desugarTripCounts makes both conditions
+          // fresh values that are not also loop-carried.
           auto body_block = node->blocks()[0];
+          auto loop_flags = moveFlags(node);
+          auto body_flags = moveFlags(body_block);
 
-          // before assign op: stack: ... <cond> <loop-carried-depdencies>
           insertAssign(
               source_location,
-              node->inputs(),
-              moveFlags(node),
+              node->inputs().slice(1),
+              loop_flags.slice(1),
               body_block->inputs());
-          // after assign op: stack: ... <cond>
-          // cond_branch consumes <cond> from top of the stack
-          auto cond_branch =
-              insertInstruction(prim::Placeholder, source_location, {}, {}, {});
-          // after branch: stack: ...
+          auto cond_branch = insertInstruction(
+              prim::Placeholder,
+              source_location,
+              node->inputs().slice(0, 1),
+              loop_flags.slice(0, 1),
+              {});
 
           auto entry = instructions.size();
           insertNodesFromBlock(body_block);
-          // before assign op: stack: ... <cond> <loop-carried-depdencies>
           insertAssign(
               source_location,
-              body_block->outputs(),
-              moveFlags(body_block),
+              body_block->outputs().slice(1),
+              body_flags.slice(1),
               body_block->inputs());
-          // after assign op: stack: ... <cond>
-          auto cond_branch_end =
-              insertInstruction(prim::Placeholder, source_location, {}, {}, {});
-          // after branch: stack: ...
+          auto cond_branch_end = insertInstruction(
+              prim::Placeholder,
+              source_location,
+              body_block->outputs().slice(0, 1),
+              body_flags.slice(0, 1),
+              {});
 
           aliasRegistersTo(node->outputs(), body_block->inputs());
           createJumpFalse(cond_branch, instructions.size());
@@ -486,9 +508,70 @@ struct CodeImpl {
         n->inputs(),
         moveFlags(n),
         n->outputs());
-    instructions[inst].callback = getOperation(n);
+    specialize(n, instructions[inst]);
+    if (instructions[inst].op == OP) {
+      instructions[inst].callback = getOperation(n);
+      instructions[inst].X = op_nodes.size();
+      op_nodes.push_back(n);
+    }
     return inst;
   }
+
+  // Picks a specialized opcode for n, if there is one.
+  // See Note [Interpreter opcodes]
+  void specialize(Node* n, Instruction& inst) {
+    switch (n->kind()) {
+      case prim::Load:
+      case prim::Store:
+        // the stack manipulation is fully encoded in inputs and outputs
+        inst.op = ASSIGN;
+        return;
+      case prim::Drop:
+        inst.op = DROP;
+        return;
+      case prim::Constant:
+        inst.op = LOADC;
+        inst.X = constant_table.size();
+        constant_table.push_back(*toIValue(n->output()));
+        return;
+      case prim::TupleConstruct:
+        inst.op = TUPLE_CONSTRUCT;
+        return;
+      case prim::TupleUnpack:
+        inst.op = TUPLE_UNPACK;
+        return;
+      case prim::ListConstruct:
+        inst.op = LIST_CONSTRUCT;
+        inst.X = listKindOf(n->output()->type());
+        return;
+      case prim::ListUnpack:
+        inst.op = LIST_UNPACK;
+        inst.X = listKindOf(n->input()->type());
+        return;
+      default:
+        break;
+    }
+    static const std::vector<std::pair<const char*, OpCode>> scalar_ops = {
+        {"aten::add(int a, int b) -> int", INT_ADD},
+        {"aten::sub(int a, int b) -> int", INT_SUB},
+        {"aten::mul(int a, int b) -> int", INT_MUL},
+        {"aten::eq(int a, int b) -> bool", INT_EQ},
+        {"aten::ne(int a, int b) -> bool", INT_NE},
+        {"aten::lt(int a, int b) -> bool", INT_LT},
+        {"aten::le(int a, int b) -> bool", INT_LE},
+        {"aten::gt(int a, int b) -> bool", INT_GT},
+        {"aten::ge(int a, int b) -> bool", INT_GE},
+        {"aten::__and__(bool a, bool b) -> bool", BOOL_AND},
+        {"aten::__or__(bool a, bool b) -> bool", BOOL_OR},
+        {"aten::__not__(bool self) -> bool", BOOL_NOT},
+    };
+    for (const auto& entry : scalar_ops) {
+      if (n->matches(entry.first)) {
+        inst.op = entry.second;
+        return;
+      }
+    }
+  }
   size_t insertInstruction(
       Symbol sym,
       const SourceRange& debug_location,
@@ -528,10 +611,9 @@ struct CodeImpl {
     auto inst = insertInstruction(
         prim::Assign, std::move(debug_location), inputs, move_flags, outputs);
     // This node effectively forwards its inputs into different places in a
-    // register list. We don't need to manipulate the stack in any way, because
-    // all inputs are also outputs, and the interpreter will take care of
-    // putting them in correct places.
-    instructions[inst].callback = [](Stack& stack) { return 0; };
+    // register list. Going through the stack makes sure that the outputs are
+    // assigned all at once, even if some of them are also inputs.
+    instructions[inst].op = ASSIGN;
     return inst;
   }
 
@@ -623,6 +705,13 @@ struct CodeImpl {
     // dispatch
     out << " = " << inst.debug_name.toUnqualString() << " ";
     writeUseList(inst.inputs);
+    if (inst.op != OP) {
+      out << " # " << toString(inst.op);
+      if (inst.op == JMP || inst.op == JF || inst.op == JT ||
+          inst.op == LOADC) {
+        out << " " << inst.X;
+      }
+    }
   }
   void dump(std::ostream& out) const {
     for (size_t i = 0; i < instructions.size(); ++i) {
@@ -631,6 +720,49 @@ struct CodeImpl {
     }
   }
 
+  // See Note [Bytecode format] in torch/csrc/jit/mobile/interpreter.h
+  IValue toBytecode() const {
+    std::vector<IValue> serialized_instructions;
+    serialized_instructions.reserve(instructions.size());
+    for (const Instruction& inst : instructions) {
+      std::vector<int64_t> inputs;
+      std::vector<bool> free_flags;
+      for (int i = 0; i < inst.inputs.values.size; i++) {
+        inputs.push_back(get(inst.inputs.values, i));
+        free_flags.push_back(get(inst.inputs.free_flags, i));
+      }
+      std::vector<int64_t> outputs;
+      for (int i = 0; i < inst.outputs.size; i++) {
+        outputs.push_back(get(inst.outputs, i));
+      }
+      serialized_instructions.emplace_back(Tuple::create(
+          {std::string(toString(inst.op)),
+           static_cast<int64_t>(inst.X),
+           std::move(inputs),
+           std::move(free_flags),
+           std::move(outputs)}));
+    }
+    std::vector<IValue> operators;
+    operators.reserve(op_nodes.size());
+    for (Node* node : op_nodes) {
+      const Operator& op = getOperatorFor(node);
+      if (!op.hasOperation()) {
+        std::stringstream ss;
+        ss << "Operator " << node->kind().toQualString()
+           << " can't be serialized to bytecode, since its operation depends"
+           << " on the node it is called for:\n"
+           << *node;
+        AT_ERROR(ss.str());
+      }
+      operators.emplace_back(canonicalSchemaString(op.schema()));
+    }
+    return Tuple::create(
+        {std::move(serialized_instructions),
+         std::move(operators),
+         constant_table,
+         static_cast<int64_t>(register_size)});
+  }
+
   // We MUST hold onto graph here because some Operators stored in the
   // instruction lists have dependencies on meta-data stored in the graph
   // that would be dead otherwise.
@@ -646,11 +778,15 @@ struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions;
   int register_size = 0;
+  // the nodes of the OP instructions, indexed by their X
+  std::vector<Node*> op_nodes;
 
   // all memory ArrayRef<int> are slices of this, to make sure
   // the interpreter is mostly linearly scanning through memory
   std::vector<int> int_data;
   std::vector<bool> bool_data;
+  // the values loaded by LOADC instructions
+  std::vector<IValue> constant_table;
 };
 
 // InterpreterState state that and used to compute a Code
@@ -668,6 +804,8 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   }
 
   bool runImpl(Stack& stack) {
+    // See Note [Streams of forked interpreters]
+    c10::OptionalStreamGuard stream_guard(stream);
     auto& instructions = function->instructions;
     size_t last = instructions.size();
 
@@ -677,14 +815,118 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
       // std::cout << "\n";
       auto& inst = instructions[pc];
       try {
-        loadTensorsFromRegisters(inst.inputs, stack);
-        size_t new_pc = pc + 1 + inst.callback(stack);
-        for (int i = inst.outputs.size - 1; i >= 0; --i) {
-          int reg = get(inst.outputs, i);
-          registers[reg] = pop(stack);
-          // std::cout << "pop reg[" << reg << "];\n" << registers[reg] << "\n";
+        switch (inst.op) {
+          case OP: {
+            loadTensorsFromRegisters(inst.inputs, stack);
+            size_t new_pc = pc + 1 + inst.callback(stack);
+            storeOutputsToRegisters(inst.outputs, stack);
+            pc = new_pc;
+          } break;
+          case ASSIGN:
+            loadTensorsFromRegisters(inst.inputs, stack);
+            storeOutputsToRegisters(inst.outputs, stack);
+            ++pc;
+            break;
+          case DROP:
+            for (int i = 0; i < inst.inputs.values.size; i++) {
+              if (get(inst.inputs.free_flags, i)) {
+                registers[get(inst.inputs.values, i)] = IValue();
+              }
+            }
+            ++pc;
+            break;
+          case JMP:
+            pc += 1 + inst.X;
+            break;
+          case JF:
+            pc += 1 + (input(inst, 0).toBool() ? 0 : inst.X);
+            break;
+          case JT:
+            pc += 1 + (input(inst, 0).toBool() ? inst.X : 0);
+            break;
+          case LOADC:
+            output(inst, 0) = function->constant_table[inst.X];
+            ++pc;
+            break;
+          case TUPLE_CONSTRUCT: {
+            std::vector<IValue> elems;
+            elems.reserve(inst.inputs.values.size);
+            for (int i = 0; i < inst.inputs.values.size; i++) {
+              elems.emplace_back(takeInput(inst, i));
+            }
+            output(inst, 0) = Tuple::create(std::move(elems));
+            ++pc;
+          } break;
+          case TUPLE_UNPACK: {
+            auto t = takeInput(inst, 0).toTuple();
+            const auto& elems = t->elements();
+            if (elems.size() != static_cast<size_t>(inst.outputs.size)) {
+              AT_ERROR(
+                  "Expected a tuple of ",
+                  inst.outputs.size,
+                  " elements, but got ",
+                  elems.size());
+            }
+            storeElements(inst, elems);
+            ++pc;
+          } break;
+          case LIST_CONSTRUCT:
+            output(inst, 0) = constructList(inst);
+            ++pc;
+            break;
+          case LIST_UNPACK: {
+            auto list = takeInput(inst, 0);
+            switch (inst.X) {
+              case IntListKind:
+                storeElements(inst, list.toIntList()->elements());
+                break;
+              case DoubleListKind:
+                storeElements(inst, list.toDoubleList()->elements());
+                break;
+              case BoolListKind:
+                storeElements(inst, list.toBoolList()->elements());
+                break;
+              case TensorListKind:
+                storeElements(inst, list.toTensorList()->elements());
+                break;
+              default:
+                storeElements(inst, list.toGenericList()->elements());
+                break;
+            }
+            ++pc;
+          } break;
+#define INT_BINARY_OP(opcode, result)   \
+  case opcode: {                        \
+    int64_t a = input(inst, 0).toInt(); \
+    int64_t b = input(inst, 1).toInt(); \
+    output(inst, 0) = result;           \
+    ++pc;                               \
+  } break;
+          INT_BINARY_OP(INT_ADD, a + b)
+          INT_BINARY_OP(INT_SUB, a - b)
+          INT_BINARY_OP(INT_MUL, a * b)
+          INT_BINARY_OP(INT_EQ, a == b)
+          INT_BINARY_OP(INT_NE, a != b)
+          INT_BINARY_OP(INT_LT, a < b)
+          INT_BINARY_OP(INT_LE, a <= b)
+          INT_BINARY_OP(INT_GT, a > b)
+          INT_BINARY_OP(INT_GE, a >= b)
+#undef INT_BINARY_OP
+          case BOOL_AND:
+            output(inst, 0) =
+                input(inst, 0).toBool() && input(inst, 1).toBool();
+            ++pc;
+            break;
+          case BOOL_OR:
+            output(inst, 0) =
+                input(inst, 0).toBool() || input(inst, 1).toBool();
+            ++pc;
+            break;
+          case BOOL_NOT:
+            output(inst, 0) = !input(inst, 0).toBool();
+            ++pc;
+            break;
         }
-        pc = new_pc;
       } catch (Suspend& e) {
         // wait() expects a single input
         AT_ASSERT(inst.inputs.values.size == 1);
@@ -723,6 +965,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
     if (future) {
       auto num_outputs = function->preprocess.n_outputs;
+      if (parent_stream) {
+        joinParentStream(jit::last(stack, num_outputs));
+      }
       if (num_outputs == 1) {
         future->markCompleted(stack.back());
       } else {
@@ -734,6 +979,21 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return false;
   }
 
+  // Makes the work queued on the parent stream from now on wait for the work
+  // of this interpreter. See Note [Streams of forked interpreters]
+  void joinParentStream(at::ArrayRef<IValue> outputs) {
+    const auto* impl = c10::impl::getDeviceGuardImpl(stream->device_type());
+    impl->blockStream(*parent_stream, *stream);
+    for (const auto& output : outputs) {
+      if (output.isTensor()) {
+        const auto& tensor = output.toTensor();
+        if (tensor.defined() && tensor.device() == stream->device()) {
+          impl->recordDataPtrOnStream(tensor.storage().data_ptr(), *parent_stream);
+        }
+      }
+    }
+  }
+
   void handleError(std::string&& error_msg, bool is_jit_exception) {
     if (future) {
       future->markCompleted(Future::FutureError(std::move(error_msg)));
@@ -752,6 +1012,28 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     return future;
   }
 
+  void useForkedStream(at::ArrayRef<IValue> inputs) {
+    for (const auto& input : inputs) {
+      if (!input.isTensor() || !input.toTensor().defined() ||
+          !input.toTensor().is_cuda()) {
+        continue;
+      }
+      const auto device = input.toTensor().device();
+      const auto* impl = c10::impl::getDeviceGuardImpl(device.type());
+      parent_stream = impl->getStream(device);
+      stream = impl->getStreamFromPool(device);
+      impl->blockStream(*stream, *parent_stream);
+      for (const auto& other : inputs) {
+        if (other.isTensor() && other.toTensor().defined() &&
+            other.toTensor().device() == device) {
+          impl->recordDataPtrOnStream(
+              other.toTensor().storage().data_ptr(), *stream);
+        }
+      }
+      return;
+    }
+  }
+
   c10::intrusive_ptr<Future> runAsync(Stack& stack) {
     getOrCreateFuture();
     runImpl(stack);
@@ -780,6 +1062,73 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   bool get(const ListHandle<bool>& list, int i) {
     return bool_data[list.start + i];
   }
+  void storeOutputsToRegisters(const ListHandle<int>& outputs, Stack& stack) {
+    for (int i = outputs.size - 1; i >= 0; --i) {
+      int reg = get(outputs, i);
+      registers[reg] = pop(stack);
+      // std::cout << "pop reg[" << reg << "];\n" << registers[reg] << "\n";
+    }
+  }
+
+  // register access for specialized instructions, see
+  // Note [Interpreter opcodes]
+  const IValue& input(const Instruction& inst, int i) {
+    return registers[get(inst.inputs.values, i)];
+  }
+  IValue takeInput(const Instruction& inst, int i) {
+    IValue& reg = registers[get(inst.inputs.values, i)];
+    if (get(inst.inputs.free_flags, i)) {
+      return std::move(reg);
+    }
+    return reg;
+  }
+  IValue& output(const Instruction& inst, int i) {
+    return registers[get(inst.outputs, i)];
+  }
+
+  template <typename T>
+  void storeElements(const Instruction& inst, const std::vector<T>& elems) {
+    TORCH_CHECK(
+        elems.size() == static_cast<size_t>(inst.outputs.size),
+        "Expected ",
+        inst.outputs.size,
+        " elements in a list but found ",
+        elems.size());
+    for (int i = 0; i < inst.outputs.size; i++) {
+      output(inst, i) = T(elems[i]);
+    }
+  }
+
+  template <typename T, typename Convert>
+  std::vector<T> collectInputs(const Instruction& inst, Convert convert) {
+    std::vector<T> elems;
+    elems.reserve(inst.inputs.values.size);
+    for (int i = 0; i < inst.inputs.values.size; i++) {
+      elems.emplace_back(convert(takeInput(inst, i)));
+    }
+    return elems;
+  }
+
+  IValue constructList(const Instruction& inst) {
+    switch (inst.X) {
+      case IntListKind:
+        return collectInputs<int64_t>(
+            inst, [](const IValue& v) { return v.toInt(); });
+      case DoubleListKind:
+        return collectInputs<double>(
+            inst, [](const IValue& v) { return v.toDouble(); });
+      case BoolListKind:
+        return collectInputs<bool>(
+            inst, [](const IValue& v) { return v.toBool(); });
+      case TensorListKind:
+        return collectInputs<at::Tensor>(
+            inst, [](IValue&& v) { return std::move(v).toTensor(); });
+      default:
+        return collectInputs<IValue>(
+            inst, [](IValue&& v) { return std::move(v); });
+    }
+  }
+
   void loadTensorsFromRegisters(const UseList& uses, Stack& stack) {
     for (int i = 0; i < uses.values.size; i++) {
       int reg = get(uses.values, i);
@@ -795,6 +1144,10 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   // pc is critical for the interperter to pick up the progress from suspend
   size_t pc = 0;
   c10::intrusive_ptr<Future> future;
+  // the stream of a forked interpreter and the stream of the interpreter that
+  // forked it, see Note [Streams of forked interpreters]
+  c10::optional<c10::Stream> stream;
+  c10::optional<c10::Stream> parent_stream;
   std::shared_ptr<CodeImpl> function; // keep function alive
   // these are just copies of function to prevent indirections in interpreter
   int* int_data;
@@ -830,6 +1183,10 @@ const std::vector<GraphExecutor*>& Code::grad_executors() {
   return pImpl->grad_executors();
 }
 
+IValue Code::toBytecode() const {
+  return pImpl->toBytecode();
+}
+
 InterpreterState::InterpreterState(const Code& code)
     : pImpl(c10::make_intrusive<InterpreterStateImpl>(code)) {}
 InterpreterState::~InterpreterState() = default;
@@ -842,6 +1199,10 @@ c10::intrusive_ptr<Future> InterpreterState::runAsync(Stack& stack) {
   return static_cast<InterpreterStateImpl*>(pImpl.get())->runAsync(stack);
 }
 
+void InterpreterState::useForkedStream(at::ArrayRef<IValue> inputs) {
+  static_cast<InterpreterStateImpl*>(pImpl.get())->useForkedStream(inputs);
+}
+
 c10::intrusive_ptr<Future> InterpreterState::getFuture() {
   return static_cast<InterpreterStateImpl*>(pImpl.get())->getOrCreateFuture();
 }
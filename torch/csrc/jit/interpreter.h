@@ -1,4 +1,5 @@
 #pragma once
+#include <c10/core/Stream.h>
 #include <c10/util/Optional.h>
 #include <memory>
 #include <vector>
@@ -36,6 +37,11 @@ struct TORCH_API Code {
 
   const std::vector<GraphExecutor*>& grad_executors();
 
+  // The instructions of the code, serialized for the bytecode runtime. Throws
+  // if one of them calls an operation that can only be created for its node.
+  // See Note [Bytecode format] in torch/csrc/jit/mobile/interpreter.h
+  IValue toBytecode() const;
+
   explicit operator bool() const {
     return pImpl != nullptr;
   }
@@ -46,11 +52,30 @@ struct TORCH_API Code {
   friend std::ostream& operator<<(std::ostream& out, const Code& code);
 };
 
+// Note [Streams of forked interpreters]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// prim::fork runs its subgraph in a new interpreter on an inter-op thread.
+// Queueing the GPU work of every branch on the same stream would serialize
+// independent branches on the device, so when a fork gets a CUDA tensor as
+// input, the forked interpreter queues its work on a stream of the pool of the
+// device of that tensor instead:
+//
+//  - at the fork, the stream waits for the work queued so far on the current
+//    stream of the forking thread (the parent stream), which produced the
+//    inputs, and the inputs are recorded as used by the stream, so that their
+//    memory isn't reused while the fork reads them;
+//  - when the forked interpreter completes, before its future is marked
+//    completed (and so before a wait on it returns), the parent stream waits
+//    for the work queued on the stream, and the outputs are recorded as used
+//    by the parent stream, since they were allocated for the fork's stream.
 struct InterpreterState {
   TORCH_API InterpreterState(const Code& code);
   TORCH_API void run(Stack& stack);
   c10::intrusive_ptr<Future> runAsync(Stack& stack);
   c10::intrusive_ptr<Future> getFuture();
+  // Queues the work of this interpreter, which runs a subgraph forked with
+  // `inputs`, on a stream of its own. See Note [Streams of forked interpreters]
+  void useForkedStream(at::ArrayRef<IValue> inputs);
   TORCH_API ~InterpreterState();
 
  private:
@@ -142,8 +142,11 @@ void Node::printAttrValue(std::ostream& out, const Symbol& name) const {
       break;
     case AttributeKind::t: {
       at::Tensor tensor = t(name);
-      // 1-elem tensors are usually boxed scalars, so print them like it
-      if (tensor.numel() == 1) {
+      // MKLDNN tensors can't be printed, their values are opaque
+      if (tensor.is_mkldnn()) {
+        out << "<Tensor>";
+      } else if (tensor.numel() == 1) {
+        // 1-elem tensors are usually boxed scalars, so print them like it
         auto scalar_tensor = tensor.view({}).item();
         out << "{";
         if (scalar_tensor.isFloatingPoint()) {
@@ -817,10 +820,12 @@ bool Node::isNondeterministic() const {
   static const OperatorSet nondeterministic_ops = {
       "aten::dropout(Tensor input, float p, bool train) -> Tensor",
       "aten::_fused_dropout(Tensor self, float p, Generator? generator) -> (Tensor, Tensor)",
+      "aten::_fused_bias_dropout_add(Tensor self, Tensor? bias, Tensor? residual, float p, Generator? generator) -> (Tensor, Tensor)",
       "aten::_standard_gamma(Tensor self, Generator? generator) -> Tensor",
       "aten::bernoulli(Tensor self, *, Generator? generator) -> Tensor",
       "aten::bernoulli(Tensor self, float p, *, Generator? generator) -> Tensor",
       "aten::multinomial(Tensor self, int num_samples, bool replacement, *, Generator? generator) -> Tensor",
+      "aten::_multinomial_alias_draw(Tensor J, Tensor q, int num_samples, *, Generator? generator) -> Tensor",
       "aten::normal(Tensor mean, Tensor std, *, Generator? generator) -> Tensor",
       "aten::normal(float mean, Tensor std, *, Generator? generator) -> Tensor",
       "aten::normal(Tensor mean, float std, *, Generator? generator) -> Tensor",
@@ -0,0 +1,134 @@
+#include <torch/csrc/jit/mobile/import.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/pickler.h>
+
+#include "caffe2/core/common.h"
+#include "caffe2/serialize/file_adapter.h"
+#include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/istream_adapter.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+using caffe2::serialize::FileAdapter;
+using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::PyTorchStreamReader;
+using caffe2::serialize::ReadAdapterInterface;
+
+namespace {
+
+// Reads the archives written by ExportModuleForMobile, see
+// Note [Bytecode archive format]
+class BytecodeDeserializer final {
+ public:
+  explicit BytecodeDeserializer(std::unique_ptr<ReadAdapterInterface> rai)
+      : reader_(std::move(rai)) {}
+
+  Module deserialize() {
+    loadTensorTable();
+    auto elements = readArchive("bytecode.pkl", &tensor_table_);
+    TORCH_CHECK(
+        !elements.empty() && elements[0].isInt(),
+        "bytecode.pkl doesn't start with a bytecode version");
+    const int64_t version = elements[0].toInt();
+    TORCH_CHECK(
+        version == kBytecodeVersion,
+        "Attempted to read bytecode version ",
+        version,
+        ", but the maximum supported version is ",
+        kBytecodeVersion);
+
+    std::vector<Method> methods;
+    for (size_t i = 1; i < elements.size(); ++i) {
+      const auto& fields = elements[i].toTuple()->elements();
+      TORCH_CHECK(
+          fields.size() == 4,
+          "Expected a method with 4 fields, but got ",
+          fields.size());
+      methods.emplace_back(
+          fields[0].toStringRef(),
+          std::make_shared<Code>(fields[1]),
+          fields[2].toInt(),
+          fields[3].toGenericListRef());
+    }
+    return Module(std::move(methods));
+  }
+
+ private:
+  std::vector<IValue> readArchive(
+      const std::string& name,
+      const std::vector<at::Tensor>* tensor_table) {
+    at::DataPtr data_ptr;
+    size_t data_size;
+    std::tie(data_ptr, data_size) = reader_.getRecord(name);
+    Unpickler unpickler(data_ptr.get(), data_size, tensor_table);
+    return unpickler.parse_ivalue_list();
+  }
+
+  void loadTensorTable() {
+    for (const IValue& value : readArchive("tensors.pkl", nullptr)) {
+      const auto& fields = value.toTuple()->elements();
+      TORCH_CHECK(
+          fields.size() == 5,
+          "Expected a tensor with 5 fields, but got ",
+          fields.size());
+      const std::string& key = fields[0].toStringRef();
+      const auto type = static_cast<at::ScalarType>(fields[1].toInt());
+      const auto type_meta = at::scalarTypeToTypeMeta(type);
+
+      auto storage_it = storages_.find(key);
+      if (storage_it == storages_.end()) {
+        at::DataPtr storage_ptr;
+        size_t record_size;
+        std::tie(storage_ptr, record_size) = reader_.getRecord(key);
+        auto storage = at::Storage(
+            type_meta,
+            record_size / type_meta.itemsize(),
+            std::move(storage_ptr),
+            /*allocator=*/nullptr,
+            /*resizable=*/false);
+        storage_it = storages_.emplace(key, std::move(storage)).first;
+      }
+
+      auto tensor = at::empty({0}, at::TensorOptions(type))
+                        .set_(
+                            storage_it->second,
+                            fields[4].toInt(),
+                            fields[2].toIntListRef(),
+                            fields[3].toIntListRef());
+      tensor_table_.push_back(
+          autograd::make_variable(std::move(tensor), /*requires_grad=*/false));
+    }
+  }
+
+  PyTorchStreamReader reader_;
+  std::unordered_map<std::string, at::Storage> storages_;
+  std::vector<at::Tensor> tensor_table_;
+};
+
+} // namespace
+
+Module _load_for_mobile(std::istream& in) {
+  return _load_for_mobile(caffe2::make_unique<IStreamAdapter>(&in));
+}
+
+Module _load_for_mobile(const std::string& filename) {
+  return _load_for_mobile(caffe2::make_unique<FileAdapter>(filename));
+}
+
+Module _load_for_mobile(std::unique_ptr<ReadAdapterInterface> rai) {
+  BytecodeDeserializer deserializer(std::move(rai));
+  return deserializer.deserialize();
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
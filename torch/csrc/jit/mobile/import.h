@@ -0,0 +1,49 @@
+#pragma once
+
+#include <torch/csrc/jit/mobile/module.h>
+
+#include <istream>
+#include <memory>
+
+namespace caffe2 {
+namespace serialize {
+class ReadAdapterInterface;
+} // namespace serialize
+} // namespace caffe2
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// Note [Bytecode archive format]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// The archives written by ExportModuleForMobile (ScriptModule._save_for_mobile
+// in Python) are zip archives, like the ones of ExportModule, with the records
+//
+// - bytecode.pkl: a tuple of kBytecodeVersion followed by one tuple
+//   (name, bytecode, num_inputs, initial_ivalues) per method, where bytecode
+//   is the serialized Code of the method (see Note [Bytecode format]), and
+//   initial_ivalues are the parameters and attributes the method reads,
+//   passed after its inputs. Tensors are references into the tensor table.
+// - tensors.pkl: the tensor table, as a tuple with a tuple
+//   (storage key, scalar type, sizes, strides, storage offset) per tensor.
+// - the storages of the tensors, in the records named by their storage key.
+//
+// Unlike ExportModule archives, they contain neither code nor protobuf
+// metadata, so they can be loaded without the compiler or protobuf.
+constexpr int64_t kBytecodeVersion = 1;
+
+/// Loads a `mobile::Module` from an archive written by
+/// `torch::jit::ExportModuleForMobile`, with its tensors on the CPU.
+TORCH_API Module _load_for_mobile(std::istream& in);
+
+TORCH_API Module _load_for_mobile(const std::string& filename);
+
+/// Passing a `caffe2::serialize::MmapFileAdapter` maps the file, and lets the
+/// tensors alias the mapped pages instead of being copied out of the file.
+TORCH_API Module _load_for_mobile(
+    std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai);
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,299 @@
+#include <torch/csrc/jit/mobile/interpreter.h>
+
+#include <ATen/core/interned_strings.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/operator.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+namespace {
+
+Operation findOperation(const std::string& schema) {
+  const auto name = schema.substr(0, schema.find('('));
+  for (const auto& op : getAllOperatorsFor(Symbol::fromQualString(name))) {
+    if (op->hasOperation() && canonicalSchemaString(op->schema()) == schema) {
+      return op->getOperation();
+    }
+  }
+  AT_ERROR("Couldn't find an operator for ", schema);
+}
+
+template <typename T>
+void storeElements(
+    std::vector<IValue>& registers,
+    const int* outputs,
+    int outputs_size,
+    const std::vector<T>& elems) {
+  TORCH_CHECK(
+      elems.size() == static_cast<size_t>(outputs_size),
+      "Expected ",
+      outputs_size,
+      " elements in a list but found ",
+      elems.size());
+  for (int i = 0; i < outputs_size; i++) {
+    registers[outputs[i]] = T(elems[i]);
+  }
+}
+
+} // namespace
+
+Code::Code(const IValue& bytecode) {
+  const auto& elements = bytecode.toTuple()->elements();
+  TORCH_CHECK(
+      elements.size() == 4,
+      "Expected bytecode with 4 elements, but got ",
+      elements.size());
+  register_size_ = elements[3].toInt();
+  const auto checkRegister = [&](int64_t reg) {
+    TORCH_CHECK(
+        reg >= 0 && static_cast<size_t>(reg) < register_size_,
+        "Register ",
+        reg,
+        " is out of range");
+    return static_cast<int>(reg);
+  };
+
+  for (const IValue& value : elements[0].toGenericListRef()) {
+    const auto& fields = value.toTuple()->elements();
+    TORCH_CHECK(
+        fields.size() == 5,
+        "Expected an instruction with 5 fields, but got ",
+        fields.size());
+    Instruction inst;
+    const std::string& opcode = fields[0].toStringRef();
+    TORCH_CHECK(parseOpCode(opcode.c_str(), &inst.op), "Unknown opcode ", opcode);
+    inst.X = fields[1].toInt();
+    const auto& inputs = fields[2].toIntListRef();
+    const auto& move_flags = fields[3].toBoolListRef();
+    const auto& outputs = fields[4].toIntListRef();
+    TORCH_CHECK(
+        inputs.size() == move_flags.size(),
+        "Expected a move flag for each input of an instruction");
+    // move_flags_ is padded for the outputs, so that the offsets of the
+    // inputs are the same in both vectors
+    inst.inputs_begin = int_data_.size();
+    inst.inputs_size = inputs.size();
+    for (size_t i = 0; i < inputs.size(); i++) {
+      int_data_.push_back(checkRegister(inputs[i]));
+      move_flags_.push_back(move_flags[i]);
+    }
+    inst.outputs_begin = int_data_.size();
+    inst.outputs_size = outputs.size();
+    for (int64_t output : outputs) {
+      int_data_.push_back(checkRegister(output));
+      move_flags_.push_back(false);
+    }
+    instructions_.push_back(inst);
+  }
+
+  for (const IValue& schema : elements[1].toGenericListRef()) {
+    operators_.push_back(findOperation(schema.toStringRef()));
+  }
+  constants_ = elements[2].toGenericListRef();
+
+  for (const Instruction& inst : instructions_) {
+    if (inst.op == OP) {
+      TORCH_CHECK(
+          inst.X >= 0 && static_cast<size_t>(inst.X) < operators_.size(),
+          "Operator ",
+          inst.X,
+          " is out of range");
+    } else if (inst.op == LOADC) {
+      TORCH_CHECK(
+          inst.X >= 0 && static_cast<size_t>(inst.X) < constants_.size(),
+          "Constant ",
+          inst.X,
+          " is out of range");
+    }
+  }
+}
+
+InterpreterState::InterpreterState(std::shared_ptr<Code> code)
+    : code_(std::move(code)), registers_(code_->register_size_) {}
+
+void InterpreterState::run(Stack& stack) {
+  const auto& instructions = code_->instructions_;
+  const int* int_data = code_->int_data_.data();
+  const uint8_t* move_flags = code_->move_flags_.data();
+  size_t pc = 0;
+  while (pc < instructions.size()) {
+    const Instruction& inst = instructions[pc];
+    const int* inputs = int_data + inst.inputs_begin;
+    const uint8_t* moves = move_flags + inst.inputs_begin;
+    const int* outputs = int_data + inst.outputs_begin;
+    const auto input = [&](int i) -> const IValue& {
+      return registers_[inputs[i]];
+    };
+    const auto takeInput = [&](int i) -> IValue {
+      if (moves[i]) {
+        return std::move(registers_[inputs[i]]);
+      }
+      return registers_[inputs[i]];
+    };
+    const auto output = [&](int i) -> IValue& {
+      return registers_[outputs[i]];
+    };
+    const auto loadInputs = [&]() {
+      for (int i = 0; i < inst.inputs_size; i++) {
+        stack.push_back(takeInput(i));
+      }
+    };
+    const auto storeOutputs = [&]() {
+      for (int i = inst.outputs_size - 1; i >= 0; --i) {
+        output(i) = pop(stack);
+      }
+    };
+    switch (inst.op) {
+      case OP: {
+        loadInputs();
+        size_t new_pc = pc + 1 + code_->operators_[inst.X](stack);
+        storeOutputs();
+        pc = new_pc;
+      } break;
+      case ASSIGN:
+        loadInputs();
+        storeOutputs();
+        ++pc;
+        break;
+      case DROP:
+        for (int i = 0; i < inst.inputs_size; i++) {
+          if (moves[i]) {
+            registers_[inputs[i]] = IValue();
+          }
+        }
+        ++pc;
+        break;
+      case JMP:
+        pc += 1 + inst.X;
+        break;
+      case JF:
+        pc += 1 + (input(0).toBool() ? 0 : inst.X);
+        break;
+      case JT:
+        pc += 1 + (input(0).toBool() ? inst.X : 0);
+        break;
+      case LOADC:
+        output(0) = code_->constants_[inst.X];
+        ++pc;
+        break;
+      case TUPLE_CONSTRUCT: {
+        std::vector<IValue> elems;
+        elems.reserve(inst.inputs_size);
+        for (int i = 0; i < inst.inputs_size; i++) {
+          elems.emplace_back(takeInput(i));
+        }
+        output(0) = c10::ivalue::Tuple::create(std::move(elems));
+        ++pc;
+      } break;
+      case TUPLE_UNPACK: {
+        auto t = takeInput(0).toTuple();
+        storeElements(registers_, outputs, inst.outputs_size, t->elements());
+        ++pc;
+      } break;
+      case LIST_CONSTRUCT: {
+        switch (inst.X) {
+          case IntListKind: {
+            std::vector<int64_t> elems;
+            for (int i = 0; i < inst.inputs_size; i++) {
+              elems.push_back(input(i).toInt());
+            }
+            output(0) = std::move(elems);
+          } break;
+          case DoubleListKind: {
+            std::vector<double> elems;
+            for (int i = 0; i < inst.inputs_size; i++) {
+              elems.push_back(input(i).toDouble());
+            }
+            output(0) = std::move(elems);
+          } break;
+          case BoolListKind: {
+            std::vector<bool> elems;
+            for (int i = 0; i < inst.inputs_size; i++) {
+              elems.push_back(input(i).toBool());
+            }
+            output(0) = std::move(elems);
+          } break;
+          case TensorListKind: {
+            std::vector<at::Tensor> elems;
+            for (int i = 0; i < inst.inputs_size; i++) {
+              elems.push_back(takeInput(i).toTensor());
+            }
+            output(0) = std::move(elems);
+          } break;
+          default: {
+            std::vector<IValue> elems;
+            for (int i = 0; i < inst.inputs_size; i++) {
+              elems.push_back(takeInput(i));
+            }
+            output(0) = std::move(elems);
+          } break;
+        }
+        ++pc;
+      } break;
+      case LIST_UNPACK: {
+        auto list = takeInput(0);
+        switch (inst.X) {
+          case IntListKind:
+            storeElements(
+                registers_, outputs, inst.outputs_size, list.toIntListRef());
+            break;
+          case DoubleListKind:
+            storeElements(
+                registers_, outputs, inst.outputs_size, list.toDoubleListRef());
+            break;
+          case BoolListKind:
+            storeElements(
+                registers_, outputs, inst.outputs_size, list.toBoolListRef());
+            break;
+          case TensorListKind:
+            storeElements(
+                registers_, outputs, inst.outputs_size, list.toTensorListRef());
+            break;
+          default:
+            storeElements(
+                registers_,
+                outputs,
+                inst.outputs_size,
+                list.toGenericListRef());
+            break;
+        }
+        ++pc;
+      } break;
+#define INT_BINARY_OP(opcode, result) \
+  case opcode: {                      \
+    int64_t a = input(0).toInt();     \
+    int64_t b = input(1).toInt();     \
+    output(0) = result;               \
+    ++pc;                             \
+  } break;
+        INT_BINARY_OP(INT_ADD, a + b)
+        INT_BINARY_OP(INT_SUB, a - b)
+        INT_BINARY_OP(INT_MUL, a * b)
+        INT_BINARY_OP(INT_EQ, a == b)
+        INT_BINARY_OP(INT_NE, a != b)
+        INT_BINARY_OP(INT_LT, a < b)
+        INT_BINARY_OP(INT_LE, a <= b)
+        INT_BINARY_OP(INT_GT, a > b)
+        INT_BINARY_OP(INT_GE, a >= b)
+#undef INT_BINARY_OP
+      case BOOL_AND:
+        output(0) = input(0).toBool() && input(1).toBool();
+        ++pc;
+        break;
+      case BOOL_OR:
+        output(0) = input(0).toBool() || input(1).toBool();
+        ++pc;
+        break;
+      case BOOL_NOT:
+        output(0) = !input(0).toBool();
+        ++pc;
+        break;
+    }
+  }
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
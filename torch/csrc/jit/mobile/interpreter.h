@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <ATen/core/stack.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/instruction.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// The bytecode runtime runs the instructions of the interpreter (see
+// torch/csrc/jit/interpreter.cpp) that were computed and serialized ahead of
+// time, so that loading and running a model only needs ATen and the
+// registered operators, but not the compiler, the graph passes or the graph
+// executor.
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// Note [Bytecode format]
+// ~~~~~~~~~~~~~~~~~~~~~~
+// torch::jit::Code::toBytecode serializes the code of a graph as a tuple
+//
+//   (instructions, operators, constants, register_size)
+//
+// - instructions are tuples (opcode, X, inputs, move_flags, outputs), where
+//   opcode is the name of the OpCode, X its argument, inputs and outputs the
+//   registers it reads and writes, and move_flags whether each input is
+//   moved out of its register (see Note [Interpreter opcodes]).
+// - operators are the canonical schema strings of the operators called by
+//   the OP instructions, indexed by their X.
+// - constants are the values loaded by the LOADC instructions.
+// - register_size is the number of registers of the code.
+//
+// The inputs of the graph are popped from the stack into registers by the
+// first instruction, and its outputs pushed onto it by the last one. Only
+// operators whose operation doesn't depend on the node it is called for (see
+// Operator::hasOperation) can be serialized, which excludes e.g. prim::fork.
+
+struct Instruction {
+  OpCode op;
+  // jump offset, constant index, ListKind or operator index, depending on op
+  int X;
+  // offset and size of the inputs in int_data and move_flags, and of the
+  // outputs in int_data
+  int inputs_begin;
+  int inputs_size;
+  int outputs_begin;
+  int outputs_size;
+};
+
+struct TORCH_API Code {
+  // Parses code serialized by torch::jit::Code::toBytecode, and looks up its
+  // operators in the registry.
+  explicit Code(const IValue& bytecode);
+
+ private:
+  friend struct InterpreterState;
+  std::vector<Instruction> instructions_;
+  // registers of the inputs and outputs of all instructions, so that the
+  // interpreter is mostly linearly scanning through memory
+  std::vector<int> int_data_;
+  std::vector<uint8_t> move_flags_;
+  std::vector<Operation> operators_;
+  std::vector<IValue> constants_;
+  size_t register_size_;
+};
+
+struct TORCH_API InterpreterState {
+  explicit InterpreterState(std::shared_ptr<Code> code);
+  // Pops the inputs of the code from the stack, and pushes its outputs.
+  void run(Stack& stack);
+
+ private:
+  std::shared_ptr<Code> code_;
+  std::vector<IValue> registers_;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,45 @@
+#include <torch/csrc/jit/mobile/module.h>
+
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+IValue Method::operator()(std::vector<IValue> inputs) const {
+  TORCH_CHECK(
+      inputs.size() == num_inputs_,
+      name_,
+      "() expected ",
+      num_inputs_,
+      " inputs, but got ",
+      inputs.size());
+  autograd::AutoGradMode grad_mode(false);
+  Stack stack = std::move(inputs);
+  stack.insert(stack.end(), initial_ivalues_.begin(), initial_ivalues_.end());
+  InterpreterState(code_).run(stack);
+  TORCH_INTERNAL_ASSERT(stack.size() == 1);
+  return std::move(stack.front());
+}
+
+const Method* Module::find_method(const std::string& name) const {
+  for (const Method& method : methods_) {
+    if (method.name() == name) {
+      return &method;
+    }
+  }
+  return nullptr;
+}
+
+IValue Module::run_method(
+    const std::string& name,
+    std::vector<IValue> inputs) const {
+  const Method* method = find_method(name);
+  TORCH_CHECK(method, "Method '", name, "' is not defined");
+  return (*method)(std::move(inputs));
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
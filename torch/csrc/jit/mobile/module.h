@@ -0,0 +1,66 @@
+#pragma once
+
+#include <torch/csrc/jit/mobile/interpreter.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// A method of a module loaded by _load_for_mobile: the bytecode of the lowered
+// graph of a script::Method, and the values of the parameters and attributes
+// it reads, which are passed after its inputs like in script::Method::run.
+struct TORCH_API Method {
+  Method(
+      std::string name,
+      std::shared_ptr<Code> code,
+      size_t num_inputs,
+      std::vector<IValue> initial_ivalues)
+      : name_(std::move(name)),
+        code_(std::move(code)),
+        num_inputs_(num_inputs),
+        initial_ivalues_(std::move(initial_ivalues)) {}
+
+  const std::string& name() const {
+    return name_;
+  }
+
+  // The number of inputs of the method, not counting the initial ivalues.
+  size_t num_inputs() const {
+    return num_inputs_;
+  }
+
+  // Runs the method with grad mode disabled, since the runtime is only meant
+  // for inference.
+  IValue operator()(std::vector<IValue> inputs) const;
+
+ private:
+  std::string name_;
+  std::shared_ptr<Code> code_;
+  size_t num_inputs_;
+  std::vector<IValue> initial_ivalues_;
+};
+
+class TORCH_API Module {
+ public:
+  explicit Module(std::vector<Method> methods) : methods_(std::move(methods)) {}
+
+  const std::vector<Method>& get_methods() const {
+    return methods_;
+  }
+
+  // Returns nullptr if the module has no method called name.
+  const Method* find_method(const std::string& name) const;
+
+  IValue run_method(const std::string& name, std::vector<IValue> inputs) const;
+
+  IValue forward(std::vector<IValue> inputs) const {
+    return run_method("forward", std::move(inputs));
+  }
+
+ private:
+  std::vector<Method> methods_;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -16,6 +16,10 @@ namespace jit {
 namespace {
 
 bool tensorEqual(const at::Tensor& lhs, const at::Tensor& rhs) {
+  // MKLDNN tensors can't be compared by value
+  if (lhs.is_mkldnn() || rhs.is_mkldnn()) {
+    return lhs.is_same(rhs);
+  }
   return lhs.type() == rhs.type() && lhs.equal(rhs);
 }
 
@@ -23,7 +23,7 @@ struct OperatorRegistry {
   // list of operators whose schema have not yet been parsed, and must
   // be registered before any call to lookup an opeator
   std::vector<std::shared_ptr<Operator>> to_register;
-  // Those two maps are used to implement lookupByLiteral, which is needed for
+  // This map is used to implement lookupByLiteral, which is needed for
   // the n->match(...) calls. Basically, every function schema is assigned a
   // unique string you can use to match it. However, parsing those strings or
   // comparing and hashing them character by character would be very slow, so we
@@ -32,8 +32,9 @@ struct OperatorRegistry {
   // This allows us to memoize answers for every pointer, which is done by the
   // operators_by_sig_literal map. Still, this map is initially empty, and so we
   // still need to do the complete string matching at the first time, which is
-  // implemented by performing a lookup in the operators_by_sig map.
-  std::unordered_map<std::string, std::shared_ptr<Operator>> operators_by_sig;
+  // done against the overloads of the literal's operator only: building the
+  // canonical schema string of every registered operator up front would be a
+  // noticeable part of loading a model.
   std::unordered_map<const char*, std::shared_ptr<Operator>>
       operators_by_sig_literal;
 
@@ -42,7 +43,6 @@ struct OperatorRegistry {
     for (const auto& op : to_register) {
       Symbol sym = Symbol::fromQualString(op->schema().name());
       operators[sym].push_back(op);
-      operators_by_sig[canonicalSchemaString(op->schema())] = op;
     }
     to_register.clear();
   }
@@ -58,22 +58,31 @@ struct OperatorRegistry {
     registerPendingOperators();
     auto it = operators_by_sig_literal.find(name);
     if (it == operators_by_sig_literal.end()) {
-      auto op_ptr_it =
-          operators_by_sig.find(canonicalSchemaString(parseSchema(name)));
-      // Handy debugging code that dumps all operators we know about on mismatch
+      auto schema = parseSchema(name);
+      auto canonical_sig = canonicalSchemaString(schema);
+      std::shared_ptr<Operator> op;
+      auto overloads_it = operators.find(Symbol::fromQualString(schema.name()));
+      if (overloads_it != operators.end()) {
+        for (const auto& candidate : overloads_it->second) {
+          if (canonicalSchemaString(candidate->schema()) == canonical_sig) {
+            op = candidate;
+          }
+        }
+      }
+      // Handy debugging code that dumps the overloads we know about on mismatch
 #if 0
-      if (op_ptr_it == operators_by_sig.end()) {
-        for (auto & entry : operators_by_sig) {
-          std::cout << entry.first << std::endl;
+      if (!op && overloads_it != operators.end()) {
+        for (auto & candidate : overloads_it->second) {
+          std::cout << canonicalSchemaString(candidate->schema()) << std::endl;
         }
       }
 #endif
       TORCH_CHECK(
-          op_ptr_it != operators_by_sig.end(),
+          op,
           "Couldn't find an operator for ",
           name,
           ". Do you have to update a set of hardcoded JIT ops?");
-      it = operators_by_sig_literal.emplace_hint(it, name, op_ptr_it->second);
+      it = operators_by_sig_literal.emplace_hint(it, name, std::move(op));
     }
     return it->second;
   }
@@ -113,6 +113,12 @@ struct TORCH_API Operator {
 
   bool matches(const Node* node) const;
 
+  // Whether the operation doesn't depend on the node it is called for, i.e.
+  // getOperation can be called without a node.
+  bool hasOperation() const {
+    return op_ != nullptr;
+  }
+
   Operation getOperation(const Node* node = nullptr) const {
     if (op_) {
       return *op_;
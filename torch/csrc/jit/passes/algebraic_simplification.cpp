@@ -0,0 +1,193 @@
+#include <torch/csrc/jit/passes/algebraic_simplification.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/subgraph_matcher.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using ValueNames = std::unordered_map<std::string, Value*>;
+
+Value* matched(const Match& match, const ValueNames& vmap, const char* name) {
+  return match.values_map.at(vmap.at(name));
+}
+
+void rewrite(
+    std::shared_ptr<Graph>& graph,
+    const std::string& pattern,
+    const std::string& replacement,
+    const MatchFilter& filter = nullptr) {
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(pattern, replacement);
+  rewriter.runOnGraph(graph, filter);
+}
+
+// Replacing `output` by `input` makes them alias, which is only unobservable
+// if neither of them is written to, and we don't return an input from the
+// graph where the original returned a new tensor.
+bool canReplaceWithInput(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb,
+    Value* input,
+    Value* output) {
+  if (aliasDb.hasWriters(input->node()) || aliasDb.hasWriters(output->node())) {
+    return false;
+  }
+  for (const Use& use : output->uses()) {
+    if (use.user == graph->return_node() &&
+        aliasDb.mayContainAlias({input}, graph->inputs())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool isInversePermutation(
+    const std::vector<int64_t>& perm,
+    const std::vector<int64_t>& inverse) {
+  if (perm.size() != inverse.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < inverse.size(); ++i) {
+    int64_t dim = inverse[i];
+    if (dim < 0 || dim >= static_cast<int64_t>(perm.size()) ||
+        perm[dim] != static_cast<int64_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void eliminateViewPairs(std::shared_ptr<Graph>& graph) {
+  // These produce views of the input, so the result aliases it either way.
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %p, %q):
+  %y = aten::permute(%x, %p)
+  %z = aten::permute(%y, %q)
+  return (%z))IR",
+      R"IR(
+graph(%x, %p, %q):
+  return (%x))IR",
+      [](const Match& match, const ValueNames& vmap) {
+        auto perm =
+            constant_as<std::vector<int64_t>>(matched(match, vmap, "p"));
+        auto inverse =
+            constant_as<std::vector<int64_t>>(matched(match, vmap, "q"));
+        return perm && inverse && isInversePermutation(*perm, *inverse);
+      });
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %a, %b):
+  %y = aten::transpose(%x, %a, %b)
+  %z = aten::transpose(%y, %a, %b)
+  return (%z))IR",
+      R"IR(
+graph(%x, %a, %b):
+  return (%x))IR");
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %a, %b):
+  %y = aten::transpose(%x, %a, %b)
+  %z = aten::transpose(%y, %b, %a)
+  return (%z))IR",
+      R"IR(
+graph(%x, %a, %b):
+  return (%x))IR");
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %d):
+  %y = aten::unsqueeze(%x, %d)
+  %z = aten::squeeze(%y, %d)
+  return (%z))IR",
+      R"IR(
+graph(%x, %d):
+  return (%x))IR");
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %a, %b):
+  %y = aten::view(%x, %a)
+  %z = aten::view(%y, %b)
+  return (%z))IR",
+      R"IR(
+graph(%x, %a, %b):
+  %z = aten::view(%x, %b)
+  return (%z))IR");
+}
+
+void eliminateNoOps(std::shared_ptr<Graph>& graph) {
+  // contiguous() and dropout() in eval mode already return their input, the
+  // schemas just don't say so.
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %format):
+  %y = aten::contiguous(%x, %format)
+  return (%y))IR",
+      R"IR(
+graph(%x, %format):
+  return (%x))IR",
+      [](const Match& match, const ValueNames& vmap) {
+        auto format = constant_as<int64_t>(matched(match, vmap, "format"));
+        auto type =
+            matched(match, vmap, "x")->type()->cast<CompleteTensorType>();
+        return format &&
+            *format == static_cast<int64_t>(at::MemoryFormat::Contiguous) &&
+            type &&
+            type->strides() ==
+            CompleteTensorType::contiguousStridesOf(type->sizes());
+      });
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %p, %train):
+  %y = aten::dropout(%x, %p, %train)
+  return (%y))IR",
+      R"IR(
+graph(%x, %p, %train):
+  return (%x))IR",
+      [](const Match& match, const ValueNames& vmap) {
+        auto train = constant_as<bool>(matched(match, vmap, "train"));
+        return train && !*train;
+      });
+
+  AliasDb aliasDb(graph);
+  rewrite(
+      graph,
+      R"IR(
+graph(%x, %dim):
+  %list = prim::ListConstruct(%x)
+  %y = aten::cat(%list, %dim)
+  return (%y))IR",
+      R"IR(
+graph(%x, %dim):
+  return (%x))IR",
+      [&](const Match& match, const ValueNames& vmap) {
+        return canReplaceWithInput(
+            graph,
+            aliasDb,
+            matched(match, vmap, "x"),
+            matched(match, vmap, "y"));
+      });
+}
+
+} // namespace
+
+void AlgebraicSimplification(std::shared_ptr<Graph>& graph) {
+  eliminateViewPairs(graph);
+  eliminateNoOps(graph);
+  EliminateDeadCode(graph);
+}
+
+} // namespace jit
+} // namespace torch
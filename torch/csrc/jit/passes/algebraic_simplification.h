@@ -0,0 +1,26 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Removes operations that are no-ops, or that cancel each other, using the
+// pattern-based SubgraphRewriter:
+//
+//    - x.permute(p).permute(q) == x, when q is the inverse of p
+//    - x.transpose(a, b).transpose(a, b) == x
+//    - x.unsqueeze(d).squeeze(d) == x
+//    - x.view(a).view(b) == x.view(b)
+//    - torch.cat([x], dim) == x
+//    - x.contiguous() == x, when x is known to be contiguous
+//    - dropout(x, p, train=False) == x
+//
+// Ops that would return a new tensor are only removed when neither the input
+// nor the output is mutated, so that the rewrite can't be observed through
+// aliasing. Simplifications that need to look at a single node, like x * 1,
+// are done by PeepholeOptimize.
+TORCH_API void AlgebraicSimplification(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -585,6 +585,7 @@ void AliasDb::registerWrite(const Value* v, Node* n) {
 
   AT_ASSERT(elementMap_.count(v));
   writeIndex_[n].insert(v);
+  isWriteCacheStale_ = true;
 }
 
 void AliasDb::analyzeIf(Node* node) {
@@ -822,6 +823,8 @@ void AliasDb::makePointerTo(const Value* from, const Value* to) {
   auto toEl = getOrCreateElement(to);
 
   memoryDAG_->makePointerTo(fromEl, toEl);
+  // the memory locations of written values may have changed
+  isWriteCacheStale_ = true;
 }
 
 void AliasDb::addToContainedElements(
@@ -932,6 +935,47 @@ void AliasDb::giveFreshAlias(const Value* value) {
   elementMap_[value] = memoryDAG_->makeFreshValue(value);
 }
 
+void AliasDb::createValue(const Value* value) {
+  // The graph may have reused the memory of a removed value or node, so drop
+  // anything we still know about them.
+  wildcards_.erase(value);
+  elementMap_.erase(value);
+  Node* node = value->node();
+  if (writeIndex_.erase(node) || wildcardWriters_.erase(node)) {
+    isWriteCacheStale_ = true;
+  }
+  wildcardNodes_.erase(node);
+
+  giveFreshAlias(value);
+}
+
+void AliasDb::replaceWithNewValue(Value* existing, Value* new_value) {
+  AT_ASSERT(shouldAnnotate(existing) == shouldAnnotate(new_value));
+  if (!shouldAnnotate(existing)) {
+    return;
+  }
+
+  if (wildcards_.erase(existing)) {
+    wildcards_.insert(new_value);
+  }
+
+  auto it = elementMap_.find(existing);
+  if (it != elementMap_.end()) {
+    Element* el = it->second;
+    elementMap_.erase(it);
+    if (el->value == existing) {
+      el->value = new_value;
+    }
+    elementMap_[new_value] = el;
+  }
+
+  for (auto& pr : writeIndex_) {
+    if (pr.second.erase(existing)) {
+      pr.second.insert(new_value);
+    }
+  }
+}
+
 Element* AliasDb::getOrCreateElement(const Value* value) {
   if (!isTracked(value)) {
     giveFreshAlias(value);
@@ -1359,6 +1403,7 @@ void AliasDb::setWildcard(const Value* v) {
 }
 
 void AliasDb::rebuildWriteCache() const {
+  writeCache_.clear();
   for (const auto& pr : writeIndex_) {
     const auto& writtenValues = pr.second;
 
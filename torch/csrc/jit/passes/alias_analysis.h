@@ -121,6 +121,28 @@ class AliasDb {
   bool couldMoveAfterTopologically(Node* n, Node* movePoint);
   bool couldMoveBeforeTopologically(Node* n, Node* movePoint);
 
+  // Incremental updates.
+  //
+  // Building an AliasDb is linear in the size of the graph, so passes (and
+  // pipelines of passes) that mutate the graph can keep using the same one
+  // instead of rebuilding it, as long as they keep it up to date:
+  //   - Removing nodes and moving them around doesn't need any update. The
+  //     AliasDb may keep information about the removed nodes, which only
+  //     makes it more conservative.
+  //   - Values added to the graph must be registered with one of the methods
+  //     below before they are queried.
+  //   - Replacing the uses of a value that may be written to with another
+  //     value that is already in the graph isn't supported; rebuild the
+  //     AliasDb in that case.
+  //
+  // Register `value`, an output of a node that was just inserted and that
+  // doesn't write to anything, as pointing to a fresh memory location (e.g.
+  // the output of a new prim::Constant).
+  TORCH_API void createValue(const Value* value);
+  // Transfer the aliasing of `existing` to `new_value`, which replaces it in
+  // the graph. `existing` must not be queried afterwards.
+  TORCH_API void replaceWithNewValue(Value* existing, Value* new_value);
+
   // For debugging: print alias db state to stdout
   TORCH_API void dump() const;
 
@@ -447,6 +447,248 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Note [Horizontal batching]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Multi-head and multi-tower models often apply many small matrix multiplies,
+// linear layers or convolutions to the same input. When their weights are
+// constants (e.g. in a frozen module), we concatenate the weights ahead of
+// time, so that a single larger GEMM or convolution computes all of them, and
+// split its output back into the individual results:
+//
+//   a = mm(x, W1)                W = cat([W1, W2], dim=1) (a constant)
+//   b = mm(x, W2)     ===>       a, b = split(mm(x, W), [n1, n2], dim=1)
+//
+// Unlike MMBatchSide, this doesn't concatenate anything at runtime, so it pays
+// off from two ops on. All batched ops only depend on their common input and
+// on constants, so they can be computed where the first of them is.
+struct HorizontallyBatchableOp {
+  const char* schema;
+  size_t input_index;
+  size_t weight_index;
+  // -1 if the op has no bias
+  int64_t bias_index;
+  // the dimension of the weight that indexes the output features, and the
+  // dimension of the output the features end up in
+  int64_t weight_cat_dim;
+  int64_t output_split_dim;
+};
+
+static const HorizontallyBatchableOp horizontally_batchable_ops[] = {
+    {"aten::mm(Tensor self, Tensor mat2) -> Tensor", 0, 1, -1, 1, 1},
+    {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+     1, 2, 0, 1, 1},
+    {"aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor",
+     0, 1, 2, 0, -1},
+    {"aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor",
+     0, 1, 2, 0, 1},
+};
+
+const HorizontallyBatchableOp* getHorizontallyBatchableOp(Node* n) {
+  for (const auto& op : horizontally_batchable_ops) {
+    if (n->matches(op.schema)) {
+      // grouped convolutions can't be concatenated along the output channels
+      if (n->kind() == aten::conv2d) {
+        auto groups = toIValue(n->input(6));
+        if (!groups || groups->toInt() != 1) {
+          return nullptr;
+        }
+      }
+      return &op;
+    }
+  }
+  return nullptr;
+}
+
+c10::optional<at::Tensor> constantTensor(Value* v) {
+  auto ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  return ivalue->toTensor();
+}
+
+// Returns true if a and b are the same value, or constants of the same value.
+bool sameValue(Value* a, Value* b) {
+  if (a == b) {
+    return true;
+  }
+  auto ia = toIValue(a);
+  auto ib = toIValue(b);
+  if (!ia || !ib) {
+    return false;
+  }
+  if (ia->isNone() && ib->isNone()) {
+    return true;
+  }
+  if (ia->isInt() && ib->isInt()) {
+    return ia->toInt() == ib->toInt();
+  }
+  if (ia->isDouble() && ib->isDouble()) {
+    return ia->toDouble() == ib->toDouble();
+  }
+  if (ia->isBool() && ib->isBool()) {
+    return ia->toBool() == ib->toBool();
+  }
+  if (ia->isIntList() && ib->isIntList()) {
+    return ia->toIntListRef() == ib->toIntListRef();
+  }
+  return false;
+}
+
+// The weight and bias of a batchable op, if they are constants that can be
+// concatenated along the output features. The bias is undefined if the op has
+// none.
+c10::optional<std::pair<at::Tensor, at::Tensor>> constantParameters(
+    Node* n,
+    const HorizontallyBatchableOp& op) {
+  auto weight = constantTensor(n->input(op.weight_index));
+  if (!weight || weight->dim() <= op.weight_cat_dim) {
+    return c10::nullopt;
+  }
+  at::Tensor bias;
+  if (op.bias_index >= 0) {
+    Value* b = n->input(op.bias_index);
+    if (!b->mustBeNone()) {
+      auto constant = constantTensor(b);
+      // a bias that isn't broadcast along the features can't be concatenated
+      if (!constant || constant->dim() != 1 ||
+          constant->size(0) != weight->size(op.weight_cat_dim)) {
+        return c10::nullopt;
+      }
+      bias = *constant;
+    }
+  }
+  return std::make_pair(*weight, bias);
+}
+
+bool canBatchHorizontally(
+    Node* first,
+    const std::pair<at::Tensor, at::Tensor>& first_params,
+    Node* n,
+    const std::pair<at::Tensor, at::Tensor>& params,
+    const HorizontallyBatchableOp& op) {
+  if (n->kind() != first->kind()) {
+    return false;
+  }
+  for (size_t i = 0; i < n->inputs().size(); ++i) {
+    if (i != op.weight_index && i != static_cast<size_t>(op.bias_index) &&
+        !sameValue(n->input(i), first->input(i))) {
+      return false;
+    }
+  }
+  const at::Tensor& w = params.first;
+  const at::Tensor& first_w = first_params.first;
+  if (w.scalar_type() != first_w.scalar_type() ||
+      w.device() != first_w.device() || w.dim() != first_w.dim() ||
+      params.second.defined() != first_params.second.defined()) {
+    return false;
+  }
+  for (int64_t d = 0; d < w.dim(); ++d) {
+    if (d != op.weight_cat_dim && w.size(d) != first_w.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void batchHorizontally(
+    const std::vector<Node*>& nodes,
+    const std::vector<std::pair<at::Tensor, at::Tensor>>& params,
+    const HorizontallyBatchableOp& op) {
+  Node* first = nodes[0];
+  Graph* graph = first->owningGraph();
+  WithInsertPoint insert_guard{first};
+
+  std::vector<at::Tensor> weights;
+  std::vector<at::Tensor> biases;
+  std::vector<int64_t> split_sizes;
+  for (const auto& p : params) {
+    weights.push_back(p.first);
+    if (p.second.defined()) {
+      biases.push_back(p.second);
+    }
+    split_sizes.push_back(p.first.size(op.weight_cat_dim));
+  }
+  Value* weight = graph->insertConstant(at::cat(weights, op.weight_cat_dim));
+  Value* bias = nullptr;
+  if (!biases.empty()) {
+    bias = graph->insertConstant(at::cat(biases, 0));
+  }
+
+  Node* batched = graph->insertNode(graph->create(first->kind(), 1));
+  for (size_t i = 0; i < first->inputs().size(); ++i) {
+    if (i == op.weight_index) {
+      batched->addInput(weight);
+    } else if (i == static_cast<size_t>(op.bias_index) && bias) {
+      batched->addInput(bias);
+    } else {
+      batched->addInput(first->input(i));
+    }
+  }
+  batched->output()->setType(unshapedType(first->output()->type()));
+
+  Value* outputs = graph->insert(
+      aten::split_with_sizes,
+      {batched->output(), split_sizes, op.output_split_dim});
+  Node* unpack =
+      graph->insertNode(graph->createListUnpack(outputs, nodes.size()));
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    unpack->output(i)->setType(unshapedType(nodes[i]->output()->type()));
+    nodes[i]->output()->replaceAllUsesWith(unpack->output(i));
+  }
+  // NB: the original nodes are removed by DCE.
+}
+
+void BatchHorizontally(Block* block) {
+  // the groups of batchable nodes, keyed by the input they share
+  struct Group {
+    const HorizontallyBatchableOp* op;
+    std::vector<Node*> nodes;
+    std::vector<std::pair<at::Tensor, at::Tensor>> params;
+  };
+  std::unordered_map<Value*, std::vector<Group>> groups;
+  std::vector<Value*> inputs_in_order;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      BatchHorizontally(subblock);
+    }
+    const HorizontallyBatchableOp* op = getHorizontallyBatchableOp(node);
+    if (!op) {
+      continue;
+    }
+    auto params = constantParameters(node, *op);
+    if (!params) {
+      continue;
+    }
+    Value* input = node->input(op->input_index);
+    auto it = groups.find(input);
+    if (it == groups.end()) {
+      inputs_in_order.push_back(input);
+      it = groups.emplace(input, std::vector<Group>()).first;
+    }
+    auto group = std::find_if(
+        it->second.begin(), it->second.end(), [&](const Group& g) {
+          return g.op == op &&
+              canBatchHorizontally(
+                     g.nodes[0], g.params[0], node, *params, *op);
+        });
+    if (group == it->second.end()) {
+      it->second.push_back(Group{op, {node}, {*params}});
+    } else {
+      group->nodes.push_back(node);
+      group->params.push_back(*params);
+    }
+  }
+
+  for (Value* input : inputs_in_order) {
+    for (const Group& group : groups.at(input)) {
+      if (group.nodes.size() >= 2) {
+        batchHorizontally(group.nodes, group.params, *group.op);
+      }
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -464,8 +706,12 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
     // TODO(suo): make BatchMM mutability-safe
     return;
   }
-  AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
+  // Remove the matmuls merged into trees, so that they aren't batched again.
+  EliminateDeadCode(graph);
+  // See Note [Horizontal batching]
+  BatchHorizontally(graph->block());
+  AliasDb alias_db(graph);
   BatchMMSide(graph->block(), alias_db);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
@@ -80,6 +80,12 @@ void EliminateCommonSubexpression(
 
 void EliminateCommonSubexpression(std::shared_ptr<Graph>& graph) {
   AliasDb aliasDb(graph);
+  EliminateCommonSubexpression(graph, aliasDb);
+}
+
+void EliminateCommonSubexpression(
+    std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb) {
   EliminateCommonSubexpression(
       graph->block(), aliasDb, [](Node*) { return nullptr; });
 }
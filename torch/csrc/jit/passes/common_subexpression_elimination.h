@@ -5,7 +5,14 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 TORCH_API void EliminateCommonSubexpression(std::shared_ptr<Graph>& graph);
+// Reuse the alias analysis of a previous pass instead of rebuilding it. CSE
+// only removes nodes, so `aliasDb` stays valid for later passes.
+TORCH_API void EliminateCommonSubexpression(
+    std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb);
 
 }
 } // namespace torch
@@ -62,6 +62,12 @@ void ConstantPooling(
 
 void ConstantPooling(const std::shared_ptr<Graph>& graph) {
   AliasDb aliasDb(graph);
+  ConstantPooling(graph, aliasDb);
+}
+
+void ConstantPooling(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb) {
   std::unordered_set<Node*, HashNode, EqualNode> constants;
   ConstantPooling(graph->block(), constants, aliasDb);
 }
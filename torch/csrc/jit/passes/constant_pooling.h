@@ -5,7 +5,15 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 TORCH_API void ConstantPooling(const std::shared_ptr<Graph>& graph);
+// Reuse the alias analysis of a previous pass instead of rebuilding it.
+// Constant pooling only removes and moves nodes, so `aliasDb` stays valid for
+// later passes.
+TORCH_API void ConstantPooling(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb);
 
 }
 } // namespace torch
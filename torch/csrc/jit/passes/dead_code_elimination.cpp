@@ -16,7 +16,9 @@ using namespace ::c10::prim;
 class DeadCodeEliminator {
  public:
   explicit DeadCodeEliminator(std::shared_ptr<Graph> graph)
-      : aliasDb_(torch::make_unique<AliasDb>(std::move(graph))) {}
+      : ownedAliasDb_(torch::make_unique<AliasDb>(std::move(graph))),
+        aliasDb_(ownedAliasDb_.get()) {}
+  explicit DeadCodeEliminator(const AliasDb& aliasDb) : aliasDb_(&aliasDb) {}
   DeadCodeEliminator() = default;
 
   // The algorithm is an inverse mark-and-sweep. Starting from the return node,
@@ -261,7 +263,8 @@ class DeadCodeEliminator {
     }
   }
 
-  std::unique_ptr<AliasDb> aliasDb_ = nullptr;
+  std::unique_ptr<AliasDb> ownedAliasDb_ = nullptr;
+  const AliasDb* aliasDb_ = nullptr;
   std::unordered_map<Node*, bool> memo_;
   std::unordered_set<Node*> marked_;
   std::unordered_set<const Value*> liveValues_;
@@ -273,6 +276,12 @@ void EliminateDeadCode(const std::shared_ptr<Graph>& graph) {
   DeadCodeEliminator(graph).run(graph->block(), /*recurse=*/true);
 }
 
+void EliminateDeadCode(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb) {
+  DeadCodeEliminator(aliasDb).run(graph->block(), /*recurse=*/true);
+}
+
 void EliminateDeadCode(Block* block, bool recurse) {
   DeadCodeEliminator().run(block, recurse);
 }
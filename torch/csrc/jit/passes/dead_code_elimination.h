@@ -5,6 +5,8 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 // If given a top-level graph, DCE will construct do alias analysis that allows
 // for "smarter" dead code elimination (we will eliminate mutable ops if we can
 // prove the mutated values are not used). Otherwise, we will not allow DCE to
@@ -12,6 +14,12 @@ namespace jit {
 //
 // So, prefer to use the graph version if you can.
 TORCH_API void EliminateDeadCode(const std::shared_ptr<Graph>& graph);
+// Same as above, but reuses the alias analysis of a previous pass instead of
+// rebuilding it. DCE only removes nodes, so `aliasDb` stays valid for later
+// passes.
+TORCH_API void EliminateDeadCode(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb);
 TORCH_API void EliminateDeadCode(Block* block, bool recurse = true);
 
 // Invoke the user-provided callback on all live values before deleting anything
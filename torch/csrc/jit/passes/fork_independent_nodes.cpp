@@ -0,0 +1,301 @@
+#include <torch/csrc/jit/passes/fork_independent_nodes.h>
+
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+int64_t numel(const Value* v) {
+  if (auto type = v->type()->cast<CompleteTensorType>()) {
+    return static_cast<int64_t>(type->numel());
+  }
+  return 0;
+}
+
+c10::optional<int64_t> lastDim(const Value* v) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  if (!type || type->sizes().empty()) {
+    return c10::nullopt;
+  }
+  return type->sizes().back();
+}
+
+// The node in `block` that contains `n`, or nullptr if `n` isn't in it
+Node* ancestorInBlock(Node* n, Block* block) {
+  while (n && n->owningBlock() != block) {
+    n = n->owningBlock()->owningNode();
+  }
+  return n;
+}
+
+class IndependentNodesForker {
+ public:
+  IndependentNodesForker(std::shared_ptr<Graph> graph, int64_t min_cost)
+      : graph_(std::move(graph)), aliasDb_(graph_), min_cost_(min_cost) {}
+
+  void run() {
+    run(graph_->block());
+  }
+
+ private:
+  void run(Block* block) {
+    for (Node* node : block->nodes()) {
+      for (Block* sub_block : node->blocks()) {
+        run(sub_block);
+      }
+      forkInputsOf(node);
+    }
+    forkInputsOf(block->return_node());
+  }
+
+  bool isMovable(Node* n) const {
+    if (n->kind() == prim::Constant || n->kind() == prim::fork ||
+        n->kind() == aten::wait || n->kind() == prim::PythonOp ||
+        n->kind() == prim::DifferentiableGraph) {
+      return false;
+    }
+    // Nodes with blocks could write to their own values, and running them
+    // concurrently isn't worth the analysis.
+    if (!n->blocks().empty() || n->hasSideEffects() ||
+        n->isNondeterministic()) {
+      return false;
+    }
+    return !aliasDb_.hasWriters(n);
+  }
+
+  // Partitions the nodes computing the inputs of `join` into cones: sets of
+  // nodes whose outputs are only used by `join` and by nodes of the same
+  // cone. The nodes of a cone are in reverse topological order.
+  std::vector<std::vector<Node*>> findCones(Node* join) {
+    Block* block = join->owningBlock();
+    std::unordered_map<Node*, size_t> cone_of;
+    size_t num_cones = 0;
+    for (Value* input : join->inputs()) {
+      Node* producer = input->node();
+      if (producer->owningBlock() == block && !cone_of.count(producer) &&
+          isMovable(producer)) {
+        cone_of[producer] = num_cones++;
+      }
+    }
+    std::vector<std::vector<Node*>> cones(num_cones);
+    if (num_cones < 2) {
+      return cones;
+    }
+
+    // Producers of the inputs of the nodes in cones that haven't been visited
+    // yet. Once there are none left, no other node can be part of a cone.
+    std::unordered_set<Node*> pending;
+    for (auto& entry : cone_of) {
+      pending.insert(entry.first);
+    }
+    for (Node* n = join->prev(); !pending.empty() && n != block->param_node();
+         n = n->prev()) {
+      pending.erase(n);
+      if (!isMovable(n)) {
+        cone_of.erase(n);
+        continue;
+      }
+      c10::optional<size_t> cone;
+      auto it = cone_of.find(n);
+      if (it != cone_of.end()) {
+        cone = it->second;
+      }
+      bool only_used_by_cone = true;
+      for (Value* output : n->outputs()) {
+        for (const Use& use : output->uses()) {
+          Node* user = ancestorInBlock(use.user, block);
+          if (user == join) {
+            continue;
+          }
+          auto user_cone = cone_of.find(user);
+          if (user_cone == cone_of.end() ||
+              (cone && *cone != user_cone->second)) {
+            only_used_by_cone = false;
+            break;
+          }
+          cone = user_cone->second;
+        }
+      }
+      if (!cone || !only_used_by_cone) {
+        cone_of.erase(n);
+        continue;
+      }
+      cone_of[n] = *cone;
+      cones[*cone].push_back(n);
+      for (Value* input : n->inputs()) {
+        if (input->node()->owningBlock() == block) {
+          pending.insert(input->node());
+        }
+      }
+    }
+    return cones;
+  }
+
+  void forkInputsOf(Node* join) {
+    auto cones = findCones(join);
+    std::vector<std::vector<Node*>*> expensive;
+    for (auto& cone : cones) {
+      int64_t cost = 0;
+      for (Node* n : cone) {
+        cost += estimateNodeCost(n);
+      }
+      if (!cone.empty() && cost >= min_cost_) {
+        expensive.push_back(&cone);
+      }
+    }
+    if (expensive.size() < 2) {
+      return;
+    }
+    // the last one runs in this thread while the others are running
+    expensive.pop_back();
+    for (auto cone : expensive) {
+      std::reverse(cone->begin(), cone->end());
+      fork(*cone, join);
+    }
+  }
+
+  // Moves `cone`, in topological order, into the subgraph of a prim::fork,
+  // and waits for it right before `join`.
+  void fork(const std::vector<Node*>& cone, Node* join) {
+    Block* block = join->owningBlock();
+    auto subgraph = std::make_shared<Graph>();
+    std::unordered_map<Value*, Value*> env;
+    std::vector<Value*> fork_inputs;
+    auto lookup = [&](Value* v) -> Value* {
+      auto it = env.find(v);
+      if (it != env.end()) {
+        return it->second;
+      }
+      if (v->node()->kind() == prim::Constant) {
+        Node* constant = subgraph->appendNode(
+            subgraph->createClone(v->node(), [](Value*) -> Value* {
+              AT_ERROR("constants have no inputs");
+            }));
+        return env[v] = constant->output();
+      }
+      fork_inputs.push_back(v);
+      return env[v] = subgraph->addInput()->copyMetadata(v);
+    };
+
+    std::vector<Value*> outputs;
+    for (Node* n : cone) {
+      Node* clone = subgraph->appendNode(subgraph->createClone(n, lookup));
+      for (size_t i = 0; i < n->outputs().size(); ++i) {
+        Value* output = n->outputs()[i];
+        env[output] = clone->outputs()[i];
+        for (const Use& use : output->uses()) {
+          if (ancestorInBlock(use.user, block) == join) {
+            outputs.push_back(output);
+            break;
+          }
+        }
+      }
+    }
+    if (outputs.size() == 1) {
+      subgraph->registerOutput(env.at(outputs[0]));
+    } else {
+      auto values = fmap(outputs, [&](Value* v) { return env.at(v); });
+      subgraph->registerOutput(
+          subgraph->appendNode(subgraph->createTuple(values))->output());
+    }
+    TypePtr result_type = subgraph->outputs()[0]->type();
+
+    // The fork can start as soon as all of its inputs are computed.
+    Node* fork_node = graph_->create(prim::fork, fork_inputs, 1);
+    fork_node->g_(attr::Subgraph, subgraph);
+    fork_node->output()->setType(FutureType::create(result_type));
+    Node* last_input = nullptr;
+    for (Value* input : fork_inputs) {
+      Node* producer = input->node();
+      if (producer->owningBlock() == block &&
+          (!last_input || last_input->isBefore(producer))) {
+        last_input = producer;
+      }
+    }
+    if (last_input) {
+      fork_node->insertAfter(last_input);
+    } else {
+      fork_node->insertBefore(block->nodes().front());
+    }
+
+    Node* wait = graph_->create(aten::wait, {fork_node->output()}, 1);
+    wait->insertBefore(join);
+    wait->output()->setType(result_type);
+    std::vector<Value*> results = {wait->output()};
+    if (outputs.size() != 1) {
+      Node* unpack = graph_->createTupleUnpack(wait->output());
+      unpack->insertBefore(join);
+      results = unpack->outputs().vec();
+    }
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      // the uses that remain are from `join`, or from the blocks it contains
+      auto uses = outputs[i]->uses();
+      for (const Use& use : uses) {
+        if (ancestorInBlock(use.user, block) == join) {
+          use.user->replaceInput(use.offset, results[i]);
+        }
+      }
+    }
+    for (auto it = cone.rbegin(); it != cone.rend(); ++it) {
+      (*it)->destroy();
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  int64_t min_cost_;
+};
+
+} // namespace
+
+int64_t estimateNodeCost(const Node* node) {
+  int64_t cost = 0;
+  for (const Value* output : node->outputs()) {
+    cost += numel(output);
+  }
+  switch (node->kind()) {
+    case aten::mm:
+    case aten::bmm:
+    case aten::matmul:
+    case aten::linear:
+      // each output element is a dot product over the last dimension of the
+      // first input
+      return cost * lastDim(node->input(0)).value_or(1);
+    case aten::addmm:
+      return cost * lastDim(node->input(1)).value_or(1);
+    case aten::_convolution:
+    case aten::conv1d:
+    case aten::conv2d:
+    case aten::conv3d: {
+      // or over a filter of the weight
+      auto weight = node->input(1)->type()->cast<CompleteTensorType>();
+      if (weight && !weight->sizes().empty() && weight->sizes()[0] > 0) {
+        return cost * (weight->numel() / weight->sizes()[0]);
+      }
+      return cost;
+    }
+    case prim::FusionGroup: {
+      int64_t num_nodes = 0;
+      for (const Node* n : node->g(attr::Subgraph)->nodes()) {
+        (void)n;
+        ++num_nodes;
+      }
+      return cost * num_nodes;
+    }
+    default:
+      return cost;
+  }
+}
+
+void ForkIndependentNodes(std::shared_ptr<Graph>& graph, int64_t min_cost) {
+  IndependentNodesForker(graph, min_cost).run();
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// The default for `min_cost` in ForkIndependentNodes, in the units of
+// estimateNodeCost: roughly the number of multiply-adds or elements an op
+// computes. Launching a task on the inter-op thread pool costs about as much
+// as running an op over that many elements.
+constexpr int64_t kDefaultMinForkCost = 1 << 18;
+
+// Returns a rough estimate of the work done by `node`, computed from the
+// complete tensor types of its inputs and outputs, or 0 if they are unknown.
+TORCH_API int64_t estimateNodeCost(const Node* node);
+
+// Moves independent computations that are feeding the same node into
+// prim::fork subgraphs, so that the interpreter runs them concurrently on the
+// inter-op thread pool (see at::launch), like an explicit torch.jit._fork
+// would.
+//
+// For each node, the inputs that are computed by disjoint sets of nodes (e.g.
+// the towers of a multi-tower model, feeding a cat) are candidates. If at
+// least two of them cost more than `min_cost`, all of those but the last one
+// are forked, and the last one runs in the current thread while they do.
+// Cheaper computations are left inline. Only nodes without side effects, that
+// are deterministic and that don't use any value that is written to (as given
+// by AliasDb) are moved, so the order of the writes in the graph is kept.
+TORCH_API void ForkIndependentNodes(
+    std::shared_ptr<Graph>& graph,
+    int64_t min_cost = kDefaultMinForkCost);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,225 @@
+#include <torch/csrc/jit/passes/freeze_module.h>
+
+#include <ATen/core/functional.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// The value a slot is frozen to. Tensors are detached, because constants
+// must not require grad.
+IValue frozenValue(const script::Slot& slot) {
+  IValue value = slot.value();
+  if (value.isTensor()) {
+    auto t = value.toTensor();
+    if (t.defined() && t.is_variable()) {
+      return autograd::as_variable_ref(t).detach();
+    }
+  } else if (value.isTensorList()) {
+    return fmap(
+        value.toTensorList()->elements(),
+        [](const at::Tensor& t) -> at::Tensor {
+          if (t.is_variable()) {
+            return autograd::as_variable_ref(t).detach();
+          }
+          return t;
+        });
+  }
+  return value;
+}
+
+void checkConstantsAreNotMutated(Block* block, const AliasDb& aliasDb) {
+  for (Node* n : block->nodes()) {
+    for (Block* b : n->blocks()) {
+      checkConstantsAreNotMutated(b, aliasDb);
+    }
+    if (n->kind() == prim::Constant &&
+        n->output()->type()->isSubtypeOf(TensorType::get())) {
+      TORCH_CHECK(
+          !aliasDb.hasWriters(n->output()),
+          "Cannot freeze a module that modifies its parameters or attributes");
+    }
+  }
+}
+
+// dropout is the identity in inference mode
+void removeInferenceDropout(Block* block) {
+  static const char* dropout_schemas[] = {
+      "aten::dropout(Tensor input, float p, bool train) -> Tensor",
+      "aten::feature_dropout(Tensor input, float p, bool train) -> Tensor",
+      "aten::alpha_dropout(Tensor input, float p, bool train) -> Tensor",
+      "aten::feature_alpha_dropout(Tensor input, float p, bool train) -> Tensor",
+  };
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* n = *it++;
+    for (Block* b : n->blocks()) {
+      removeInferenceDropout(b);
+    }
+    for (const char* schema : dropout_schemas) {
+      if (!n->matches(schema)) {
+        continue;
+      }
+      auto train = toIValue(n->input(2));
+      if (train && !train->toBool()) {
+        n->output()->replaceAllUsesWith(n->input(0));
+        n->destroy();
+      }
+      break;
+    }
+  }
+}
+
+// Returns true if v is a constant tensor or None, in which case t is set to
+// its value (undefined for None).
+bool constantTensor(Value* v, at::Tensor& t) {
+  auto ivalue = toIValue(v);
+  if (!ivalue) {
+    return false;
+  }
+  if (ivalue->isNone()) {
+    t = at::Tensor();
+    return true;
+  }
+  if (!ivalue->isTensor()) {
+    return false;
+  }
+  t = ivalue->toTensor();
+  return true;
+}
+
+bool isFoldableConv(Node* n) {
+  if (n->matches(
+          "aten::conv1d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+      n->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+      n->matches(
+          "aten::conv3d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    return true;
+  }
+  if (n->matches(
+          "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor")) {
+    auto transposed = toIValue(n->input(6));
+    return transposed && !transposed->toBool();
+  }
+  return false;
+}
+
+void FoldConvBatchNorm(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* bn = *it++;
+    for (Block* b : bn->blocks()) {
+      FoldConvBatchNorm(b);
+    }
+    if (!bn->matches(
+            "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor")) {
+      continue;
+    }
+    Node* conv = bn->input(0)->node();
+    if (!isFoldableConv(conv) || conv->output()->uses().size() != 1) {
+      continue;
+    }
+    auto training = toIValue(bn->input(5));
+    auto eps = toIValue(bn->input(7));
+    if (!training || training->toBool() || !eps) {
+      continue;
+    }
+    at::Tensor conv_w, conv_b, bn_w, bn_b, mean, var;
+    if (!constantTensor(conv->input(1), conv_w) ||
+        !constantTensor(conv->input(2), conv_b) ||
+        !constantTensor(bn->input(1), bn_w) ||
+        !constantTensor(bn->input(2), bn_b) ||
+        !constantTensor(bn->input(3), mean) ||
+        !constantTensor(bn->input(4), var) || !mean.defined() ||
+        !var.defined()) {
+      continue;
+    }
+
+    // y = (conv(x, w) + b - mean) / sqrt(var + eps) * bn_w + bn_b
+    //   = conv(x, w * scale) + (b - mean) * scale + bn_b
+    // where scale = bn_w / sqrt(var + eps)
+    at::Tensor scale = at::rsqrt(var + eps->toDouble());
+    if (bn_w.defined()) {
+      scale = scale * bn_w;
+    }
+    std::vector<int64_t> scale_shape(conv_w.dim(), 1);
+    scale_shape[0] = -1;
+    at::Tensor new_w = conv_w * scale.reshape(scale_shape);
+    at::Tensor new_b =
+        ((conv_b.defined() ? conv_b : at::zeros_like(mean)) - mean) * scale;
+    if (bn_b.defined()) {
+      new_b = new_b + bn_b;
+    }
+
+    WithInsertPoint guard(conv);
+    auto graph = conv->owningGraph();
+    conv->replaceInput(1, graph->insertConstant(new_w));
+    conv->replaceInput(2, graph->insertConstant(new_b));
+    bn->output()->replaceAllUsesWith(conv->output());
+    bn->destroy();
+  }
+}
+
+} // namespace
+
+void FoldConvBatchNorm(std::shared_ptr<Graph>& graph) {
+  FoldConvBatchNorm(graph->block());
+  EliminateDeadCode(graph);
+}
+
+std::shared_ptr<script::Function> FreezeMethod(script::Method& method) {
+  method.owner().apply([](script::Module& module) {
+    TORCH_CHECK(
+        !module.is_training(),
+        "Freezing requires the module to be in eval mode, but '",
+        module.name(),
+        "' is in training mode");
+  });
+
+  // The lowered graph of a method takes the parameters and attributes it
+  // reads as extra inputs after the user's ones, see lower_graph.
+  auto graph = method.graph()->copy();
+  const auto& slots = method.initial_ivalues();
+  const size_t num_inputs = method.num_inputs();
+  AT_ASSERT(graph->inputs().size() == num_inputs + slots.size());
+  {
+    WithInsertPoint guard(*graph->nodes().begin());
+    for (size_t i = 0; i < slots.size(); ++i) {
+      Value* input = graph->inputs().at(num_inputs + i);
+      auto constant =
+          tryInsertConstant(*graph, frozenValue(slots[i]), input->type());
+      TORCH_CHECK(
+          constant,
+          "Cannot freeze attribute '",
+          slots[i].name(),
+          "' of type ",
+          slots[i].type()->python_str());
+      input->replaceAllUsesWith(*constant);
+    }
+  }
+  for (size_t i = slots.size(); i > 0; --i) {
+    graph->eraseInput(num_inputs + i - 1);
+  }
+
+  // Removes the branches on self.training, and pre-computes everything that
+  // only depends on the weights (e.g. transposes in linear layers).
+  ConstantPropagation(graph);
+  checkConstantsAreNotMutated(graph->block(), AliasDb(graph));
+  removeInferenceDropout(graph->block());
+  FoldConvBatchNorm(graph);
+  ConstantPropagation(graph);
+
+  script::CompilationUnit cu;
+  cu.set_optimized(method.function().is_optimized());
+  auto fn = cu.create_function(method.name(), graph);
+  fn->setSchema(method.getSchema());
+  return fn;
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,41 @@
+/** \brief This file defines the pass that freezes a module for inference.
+ *
+ * The pass has a python binding and is meant to be run once on a trained
+ * module, before it is deployed.
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/script/module.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Freezes a method of a module into a standalone function.
+ *
+ * Every parameter and attribute read by the method is inlined into the graph
+ * as a constant, which lets constant propagation fold everything that only
+ * depends on them: branches on `self.training` are removed, dropout is turned
+ * into a no-op and BatchNorm is folded into the convolution preceding it.
+ * The returned function takes the same arguments as the method.
+ *
+ * The returned function shares the tensors it didn't fold with the module,
+ * so the module should not be changed any more once it is frozen. The module
+ * (and all its submodules) must be in eval mode, and the method must not
+ * modify any of the values it reads.
+ *
+ * \param method the method to freeze.
+ */
+TORCH_API std::shared_ptr<script::Function> FreezeMethod(
+    script::Method& method);
+
+/** \brief Folds aten::batch_norm nodes in inference mode into the
+ * convolution that produces their input.
+ *
+ * The weight and bias of the convolution, as well as the parameters and
+ * running statistics of the batch norm, must be constants.
+ */
+TORCH_API void FoldConvBatchNorm(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -178,6 +178,43 @@ bool isFusableNorm(Node* normalize_op) {
   return false;
 }
 
+// Note [Fused reductions]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// A fusion group may end in reductions (sum or mean) over the last dimension
+// of the group's map size, so that e.g. `(x * w + b).relu().sum(-1)` runs
+// as a single pass over memory instead of materializing the pointwise
+// result. The fused kernel loops over the rows of the map size, computes the
+// pointwise values of a row and accumulates them, and stores the reduced
+// values once the row is done.
+//
+// The reduced values have a different shape than everything else in the
+// group, so they may only be outputs of the group: nothing that consumes them
+// is fused into the same group. Reductions are only fused on the CPU, and
+// only for float and double tensors.
+bool isFusableReduction(Node* node) {
+  static OperatorSet fusable_reductions{{
+      "aten::sum(Tensor self, int[] dim, bool keepdim) -> Tensor",
+      "aten::mean(Tensor self, int[] dim, bool keepdim) -> Tensor",
+  }};
+  if (!fusable_reductions.find(node) || !node->is_constant(attr::dim) ||
+      !node->is_constant(attr::keepdim)) {
+    return false;
+  }
+  auto type = node->input(0)->type()->cast<DimensionedTensorType>();
+  if (!type || !type->device().is_cpu() ||
+      (type->scalarType() != at::kFloat && type->scalarType() != at::kDouble)) {
+    return false;
+  }
+  const auto dims = node->get<std::vector<int64_t>>(attr::dim).value();
+  const int64_t ndim = type->dim();
+  return ndim > 0 && dims.size() == 1 &&
+      (dims[0] == -1 || dims[0] == ndim - 1);
+}
+
+bool isReduction(const Node* node) {
+  return node->kind() == aten::sum || node->kind() == aten::mean;
+}
+
 Value* broadcastSizes(at::ArrayRef<Value*> sizes) {
   AT_ASSERT(!sizes.empty());
   Graph* graph = sizes[0]->owningGraph();
@@ -223,6 +260,32 @@ struct GraphFuser {
     });
   }
 
+  bool containsReduction(Node* fusion_group) {
+    auto nodes = getSubgraph(fusion_group).nodes();
+    return std::any_of(nodes.begin(), nodes.end(), isReduction);
+  }
+
+  // Returns true if fusing producer into consumer would make a reduced value
+  // an intermediate of the group. See Note [Fused reductions].
+  bool consumesReduction(Node* consumer, Value* producer) {
+    Node* producer_node = producer->node();
+    if (producer_node->kind() != kind_) {
+      return isReduction(producer_node);
+    }
+    auto soutputs = getSubgraph(producer_node).outputs();
+    for (size_t i = 0; i < soutputs.size(); ++i) {
+      if (!isReduction(soutputs[i]->node())) {
+        continue;
+      }
+      for (const auto& u : producer_node->outputs()[i]->uses()) {
+        if (u.user == consumer) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   bool isFusable(Node* node) {
     return callback_(node);
   }
@@ -250,7 +313,9 @@ struct GraphFuser {
         fusableDevice &= isFusableDevice(output);
       }
     }
-    return fusableDevice && (isFusableMap(node) || isFusableNorm(node));
+    return fusableDevice &&
+        (isFusableMap(node) || isFusableNorm(node) ||
+         (node->owningBlock() == block_ && isFusableReduction(node)));
   }
 
   bool isFusableMap(Node* node) {
@@ -587,7 +652,7 @@ struct GraphFuser {
         // an output of the fusion group.
         aliasDb_->moveBeforeTopologicallyValid(producer->node(), consumer);
 
-    if (!shouldFuse) {
+    if (!shouldFuse || consumesReduction(consumer, producer)) {
       return at::nullopt;
     }
 
@@ -1122,6 +1187,11 @@ struct GraphFuser {
       if (n->kind() == prim::Constant) {
         continue;
       }
+      if (isReduction(n)) {
+        // Reduced values are always outputs, so as for concats we simply
+        // don't replace their size queries.
+        continue;
+      }
       if (n->kind() == prim::ConstantChunk) {
         Node* sizes_node = graph->insertNode(
             graph->create(prim::ChunkSizes, shape_of.at(n->input()), 2));
@@ -1182,7 +1252,7 @@ struct GraphFuser {
   }
 
   bool canFuseWithConcat(Value* producer, Node* before_check) {
-    if (!isFusable(producer->node())) {
+    if (!isFusable(producer->node()) || isReduction(producer->node())) {
       return false;
     }
     // NB: it is important that this check happens after isFusable, which checks
@@ -1206,7 +1276,8 @@ struct GraphFuser {
       auto subgraph = producer->node()->g(attr::Subgraph);
       auto* node = subgraph->outputs().at(producer->offset())->node();
       return node->kind() != prim::FusedConcat &&
-          !containsGradSumToSize(producer->node());
+          !containsGradSumToSize(producer->node()) &&
+          !containsReduction(producer->node());
     }
     return true;
   }
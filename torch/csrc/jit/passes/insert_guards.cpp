@@ -30,6 +30,13 @@ struct GuardInserter {
     for (auto it = b->nodes().begin(); it != b->nodes().end(); it++) {
       auto n = *it;
       if (n->kind() == prim::profile && n->outputs().size() == 1) {
+        // profile nodes that were never run (e.g. in a branch that wasn't
+        // taken) have no information to guard on
+        if (!n->output()->type()->isSubclass(TypeKind::ProfiledTensorType)) {
+          n->output()->replaceAllUsesWith(n->input());
+          it.destroyCurrent();
+          continue;
+        }
         // n->input() is Tensor type
         auto guard = graph_->create(prim::Guard, {n->input()}, 1);
         auto go = guard->output();
@@ -0,0 +1,142 @@
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <unordered_set>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+class LoopInvariantHoister {
+ public:
+  explicit LoopInvariantHoister(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)),
+        aliasDb_(graph_),
+        graphOutputs_(graph_->outputs().begin(), graph_->outputs().end()) {}
+
+  void run() {
+    run(graph_->block());
+  }
+
+ private:
+  void run(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* node = *it;
+      // hoisting moves nodes in front of the loop, and may move the loop into
+      // a guard, so advance the iterator first
+      ++it;
+      // Inner loops first, so that what they hoist can be hoisted further
+      for (Block* subblock : node->blocks()) {
+        run(subblock);
+      }
+      if (node->kind() == prim::Loop) {
+        hoist(node);
+      }
+    }
+  }
+
+  bool isInvariant(Node* node, const std::unordered_set<Value*>& variant) {
+    if (!node->blocks().empty() || node->hasSideEffects() ||
+        node->isNondeterministic()) {
+      return false;
+    }
+    for (Value* input : node->inputs()) {
+      if (variant.count(input)) {
+        return false;
+      }
+    }
+    // If anything writes to the inputs or outputs, the node may produce a
+    // different value at each iteration, or its outputs may be expected to be
+    // distinct objects at each iteration.
+    if (aliasDb_.hasWriters(node)) {
+      return false;
+    }
+    // The graph outputs may be mutated after they are returned, so don't
+    // introduce new aliasing among them.
+    return !aliasDb_.mayContainAlias(node->outputs(), graphOutputs_);
+  }
+
+  void hoist(Node* loop) {
+    Block* body = loop->blocks().at(0);
+    std::unordered_set<Value*> variant(
+        body->inputs().begin(), body->inputs().end());
+    std::vector<Node*> invariant_nodes;
+    for (Node* node : body->nodes()) {
+      if (isInvariant(node, variant)) {
+        invariant_nodes.push_back(node);
+      } else {
+        variant.insert(node->outputs().begin(), node->outputs().end());
+      }
+    }
+    if (invariant_nodes.empty()) {
+      return;
+    }
+
+    guardLoop(loop);
+    for (Node* node : invariant_nodes) {
+      node->moveBefore(loop);
+    }
+  }
+
+  // Unless the loop is known to run, moves it into
+  //
+  //   prim::If(max_trip_count > 0 and start_condition)
+  //     block0(): loop                   -> (loop outputs)
+  //     block1():                        -> (loop carried inputs)
+  //
+  // so that the nodes hoisted in front of it are only run if the loop body
+  // would have run them.
+  void guardLoop(Node* loop) {
+    WithInsertPoint guard(loop);
+    Value* runs = nullptr;
+    Value* max_trip_count = loop->inputs().at(0);
+    auto trip_count = constant_as<int64_t>(max_trip_count);
+    if (!trip_count || *trip_count <= 0) {
+      runs = graph_->insert(aten::gt, {max_trip_count, 0});
+    }
+    Value* start_condition = loop->inputs().at(1);
+    auto start = constant_as<bool>(start_condition);
+    if (!start || !*start) {
+      runs = runs ? graph_->insert(aten::__and__, {runs, start_condition})
+                  : start_condition;
+    }
+    if (!runs) {
+      return;
+    }
+
+    Node* if_node = graph_->create(prim::If, 0)->insertBefore(loop);
+    if_node->addInput(runs);
+    Block* then_block = if_node->addBlock();
+    Block* else_block = if_node->addBlock();
+    for (size_t i = 0; i < loop->outputs().size(); ++i) {
+      Value* loop_output = loop->outputs()[i];
+      Value* loop_input = loop->inputs().at(i + 2);
+      auto type = unifyTypes(loop_output->type(), loop_input->type());
+      Value* output =
+          if_node->addOutput()->setType(type ? *type : loop_output->type());
+      loop_output->replaceAllUsesWith(output);
+      then_block->registerOutput(loop_output);
+      else_block->registerOutput(loop_input);
+    }
+    loop->moveBefore(then_block->return_node());
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  // Outputs of the graph before any loop is guarded. A guard output aliases
+  // the loop output it replaces, so these are still the values to check for.
+  std::vector<Value*> graphOutputs_;
+};
+
+} // namespace
+
+void LoopInvariantCodeMotion(const std::shared_ptr<Graph>& graph) {
+  LoopInvariantHoister(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Hoists the nodes of prim::Loop bodies whose inputs are all defined outside
+// of the loop, and which can't observe or cause a mutation, out of the loop,
+// so that they are computed once instead of at every iteration (e.g. shapes,
+// masks or transposed weights in decoding loops).
+//
+// Unless the loop is known to run, the hoisted nodes and the loop are moved
+// into a prim::If that checks that the loop runs at least once, so that
+// nodes which may throw are only run if they would have been run before.
+TORCH_API void LoopInvariantCodeMotion(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
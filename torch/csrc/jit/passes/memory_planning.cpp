@@ -0,0 +1,252 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/jit/custom_operator.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Every tensor in the arena starts at a multiple of this many bytes, so that
+// kernels see the same alignment as with the default CPU allocator.
+constexpr int64_t kArenaAlignment = 64;
+
+RegisterOperators reg_arena({
+    Operator(
+        "prim::AllocateArena(int size) -> Tensor",
+        [](Stack& stack) {
+          int64_t size;
+          pop(stack, size);
+          push(stack, torch::empty({size}, at::kByte));
+          return 0;
+        }),
+    Operator(
+        "prim::ArenaTensor(Tensor(a) arena, int offset, int[] sizes, int[] strides, int dtype) -> Tensor(a)",
+        [](Stack& stack) {
+          auto dtype = static_cast<at::ScalarType>(pop(stack).toInt());
+          auto strides = pop(stack);
+          auto sizes = pop(stack);
+          auto offset = pop(stack).toInt();
+          auto arena = pop(stack).toTensor();
+          auto data = static_cast<uint8_t*>(arena.data_ptr()) + offset;
+          // the deleter keeps the arena alive for as long as the view is
+          push(
+              stack,
+              torch::from_blob(
+                  data,
+                  sizes.toIntListRef(),
+                  strides.toIntListRef(),
+                  [arena](void*) {},
+                  at::device(arena.device()).dtype(dtype)));
+          return 0;
+        }),
+});
+
+// Returns the `out=` overload of the op n calls, i.e. the one that takes the
+// same arguments followed by a mutable `out` tensor, or nullptr if there is
+// none.
+std::shared_ptr<Operator> findOutVariant(const Node* n) {
+  const FunctionSchema* schema = n->maybeSchema();
+  if (!schema || schema->is_vararg() || schema->is_mutable() ||
+      schema->returns().size() != 1) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  for (const auto& op : getAllOperatorsFor(n->kind())) {
+    const auto& out_args = op->schema().arguments();
+    if (out_args.size() != args.size() + 1 || out_args.back().name() != "out" ||
+        !out_args.back().alias_info() ||
+        !out_args.back().alias_info()->isWrite()) {
+      continue;
+    }
+    bool same_args = true;
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (args[i].name() != out_args[i].name() ||
+          *args[i].type() != *out_args[i].type()) {
+        same_args = false;
+        break;
+      }
+    }
+    if (same_args) {
+      return op;
+    }
+  }
+  return nullptr;
+}
+
+// The number of bytes a value takes in the arena, or 0 if it can't be placed
+// there.
+int64_t arenaSize(const Value* v) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  if (!type || type->device() != at::kCPU || type->numel() == 0 ||
+      type->strides() != type->contiguous()->strides()) {
+    return 0;
+  }
+  int64_t bytes = type->numel() * c10::elementSize(type->scalarType());
+  return (bytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+struct PlannedValue {
+  Value* value;
+  // positions of the producer and of the last user in the top-level block
+  size_t begin;
+  size_t end;
+  int64_t size;
+  int64_t offset;
+};
+
+bool overlapsInTime(const PlannedValue& a, const PlannedValue& b) {
+  return a.begin <= b.end && b.begin <= a.end;
+}
+
+// Note [Arena liveness]
+// ~~~~~~~~~~~~~~~~~~~~~
+// Only values produced in the top-level block are planned. A value is live
+// from the node that produces it until the last use of any value that may
+// alias it or contain it (e.g. a view of it, or a list that holds it): uses
+// inside nested blocks count as uses by the top-level node that owns them,
+// as in FindLastUses. Values that may alias a graph output are live until
+// the end of the run and past it, so they are not planned. Since a node's
+// inputs are live at its position, its output is never placed over them.
+std::vector<PlannedValue> computeLiveRanges(
+    const std::shared_ptr<Graph>& graph) {
+  std::unordered_map<const Node*, size_t> position;
+  std::vector<Value*> values;
+  size_t i = 0;
+  for (Node* n : graph->nodes()) {
+    position[n] = i++;
+    for (Value* v : n->outputs()) {
+      values.push_back(v);
+    }
+  }
+  const size_t return_position = i;
+  position[graph->return_node()] = return_position;
+
+  // the last top-level position at which v is used
+  auto lastUse = [&](const Value* v) {
+    size_t last = position.at(v->node());
+    for (const Use& use : v->uses()) {
+      Node* user = use.user;
+      while (user->owningBlock() != graph->block()) {
+        user = user->owningBlock()->owningNode();
+      }
+      last = std::max(last, position.at(user));
+    }
+    return last;
+  };
+
+  AliasDb aliasDb(graph);
+  std::vector<PlannedValue> planned;
+  for (Node* n : graph->nodes()) {
+    if (n->outputs().size() != 1) {
+      continue;
+    }
+    Value* v = n->output();
+    int64_t size = arenaSize(v);
+    if (size == 0) {
+      continue;
+    }
+    if (!findOutVariant(n)) {
+      continue;
+    }
+    size_t end = lastUse(v);
+    for (Value* other : values) {
+      if (other != v && aliasDb.mayContainAlias(v, other)) {
+        end = std::max(end, lastUse(other));
+      }
+    }
+    if (end >= return_position) {
+      continue;
+    }
+    planned.push_back(
+        {v, position.at(n), end, size, /*offset=*/0});
+  }
+  return planned;
+}
+
+// Assigns an offset to every value, largest first, at the lowest address
+// that doesn't overlap a value that is live at the same time. Returns the
+// size of the arena.
+int64_t assignOffsets(std::vector<PlannedValue>& planned) {
+  std::vector<PlannedValue*> order;
+  for (auto& p : planned) {
+    order.push_back(&p);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->size > b->size;
+      });
+
+  int64_t arena_size = 0;
+  std::vector<PlannedValue*> assigned;
+  for (PlannedValue* p : order) {
+    std::vector<PlannedValue*> live;
+    for (PlannedValue* other : assigned) {
+      if (overlapsInTime(*p, *other)) {
+        live.push_back(other);
+      }
+    }
+    std::sort(live.begin(), live.end(), [](PlannedValue* a, PlannedValue* b) {
+      return a->offset < b->offset;
+    });
+    int64_t offset = 0;
+    for (PlannedValue* other : live) {
+      if (offset + p->size <= other->offset) {
+        break;
+      }
+      offset = std::max(offset, other->offset + other->size);
+    }
+    p->offset = offset;
+    arena_size = std::max(arena_size, offset + p->size);
+    assigned.push_back(p);
+  }
+  return arena_size;
+}
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  auto planned = computeLiveRanges(graph);
+  if (planned.empty()) {
+    return;
+  }
+  const int64_t arena_size = assignOffsets(planned);
+
+  Value* arena;
+  {
+    WithInsertPoint guard(*graph->nodes().begin());
+    arena = graph->insert(prim::AllocateArena, {arena_size});
+  }
+  for (const auto& p : planned) {
+    Node* n = p.value->node();
+    auto type = p.value->type()->expect<CompleteTensorType>();
+    WithInsertPoint guard(n);
+    Value* buffer = graph->insert(
+        prim::ArenaTensor,
+        {arena,
+         p.offset,
+         type->sizes(),
+         type->strides(),
+         static_cast<int64_t>(type->scalarType())});
+    buffer->setType(type);
+
+    Node* out_node = graph->insertNode(graph->create(n->kind(), 1));
+    for (Value* input : n->inputs()) {
+      out_node->addInput(input);
+    }
+    out_node->addInput(buffer);
+    out_node->output()->setType(type);
+    p.value->replaceAllUsesWith(out_node->output());
+    n->destroy();
+  }
+}
+
+} // namespace jit
+} // namespace torch
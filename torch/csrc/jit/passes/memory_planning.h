@@ -0,0 +1,29 @@
+/** \brief This file defines the static memory planning pass.
+ *
+ * The pass is meant for inference graphs whose input shapes are known ahead
+ * of time, e.g. after running complete shape analysis on example inputs.
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Places the intermediate tensors of a graph in a single arena.
+ *
+ * Every intermediate CPU tensor with a complete, contiguous type that is
+ * produced by an op with an `out=` variant is given an offset in an arena,
+ * such that tensors that are live at the same time never overlap. The graph
+ * is rewritten to allocate the arena once at the start of each run
+ * (prim::AllocateArena), and to call the `out=` variants on views into it
+ * (prim::ArenaTensor), which replaces one allocation per op by one per run.
+ *
+ * Values that may alias a graph output are never planned, since they
+ * outlive the run. The rewritten graph is only valid for inputs whose types
+ * match the ones the graph was annotated with.
+ */
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
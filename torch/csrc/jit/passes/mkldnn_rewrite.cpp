@@ -0,0 +1,486 @@
+#include <torch/csrc/jit/passes/mkldnn_rewrite.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Returns the value of v if it is a constant float tensor on CPU.
+c10::optional<at::Tensor> constantFloatTensor(Value* v) {
+  auto ivalue = toIValue(v);
+  if (!ivalue || !ivalue->isTensor()) {
+    return c10::nullopt;
+  }
+  auto t = ivalue->toTensor();
+  if (!t.defined() || t.is_mkldnn() || t.device().type() != at::kCPU ||
+      t.scalar_type() != at::kFloat) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool isConstantFalse(Value* v) {
+  auto ivalue = toIValue(v);
+  return ivalue && ivalue->isBool() && !ivalue->toBool();
+}
+
+// Returns the number of dimensions of the shape argument of a reshape, or -1
+// if it isn't known.
+int64_t shapeRank(Value* shape) {
+  if (auto sizes = constant_as<std::vector<int64_t>>(shape)) {
+    return sizes->size();
+  }
+  if (shape->node()->kind() == prim::ListConstruct) {
+    return shape->node()->inputs().size();
+  }
+  return -1;
+}
+
+// Ops that return a new tensor, which is not aliased by anything else.
+bool returnsFreshTensor(Node* n) {
+  return n->matches(
+             "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+      n->matches(
+          "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor") ||
+      n->matches(
+          "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor") ||
+      n->matches("aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor") ||
+      n->matches("aten::relu(Tensor self) -> Tensor") ||
+      n->matches(
+          "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor");
+}
+
+// Replaces the in-place relu_ and add_ by their out-of-place versions when
+// nothing else sees the tensor they modify, as in `x = relu_(conv(x))`, since
+// MKLDNN values must not be mutated.
+void removeUnobservedInplaceOps(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* n = *it++;
+    for (Block* b : n->blocks()) {
+      removeUnobservedInplaceOps(b);
+    }
+    Symbol out_of_place;
+    if (n->matches("aten::relu_(Tensor self) -> Tensor")) {
+      out_of_place = aten::relu;
+    } else if (n->matches(
+                   "aten::add_(Tensor self, Tensor other, *, Scalar alpha) -> Tensor")) {
+      out_of_place = aten::add;
+    } else {
+      continue;
+    }
+    Value* self = n->input(0);
+    if (self->uses().size() != 1 || self->node()->owningBlock() != block ||
+        !returnsFreshTensor(self->node())) {
+      continue;
+    }
+    Node* replacement =
+        block->owningGraph()->create(out_of_place, n->inputs())->insertBefore(n);
+    replacement->output()->copyMetadata(n->output());
+    n->output()->replaceAllUsesWith(replacement->output());
+    n->destroy();
+  }
+}
+
+class MKLDNNRewriter {
+ public:
+  explicit MKLDNNRewriter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {}
+
+  void run() {
+    rewriteBlock(graph_->block());
+    fuseConvPostOps(graph_->block());
+  }
+
+ private:
+  // Inserts a constant MKLDNN tensor. insertConstant can't be used, since it
+  // infers a complete type from the strides, which MKLDNN tensors don't have.
+  Value* insertMKLDNNConstant(at::Tensor t) {
+    WithInsertPoint guard(*graph_->nodes().begin());
+    Node* n = graph_->create(prim::Constant);
+    n->t_(attr::value, std::move(t));
+    n->output()->setType(TensorType::get());
+    return graph_->insertNode(n)->output();
+  }
+
+  // Replaces the constant float tensor input i of n by an MKLDNN copy. The
+  // copy is made once by the pass instead of on every run.
+  bool replaceByMKLDNNConstant(Node* n, size_t i) {
+    auto t = constantFloatTensor(n->input(i));
+    if (!t) {
+      return false;
+    }
+    n->replaceInput(i, insertMKLDNNConstant(t->to_mkldnn()));
+    return true;
+  }
+
+  // The insertion point that dominates all uses of v.
+  static Node* afterDefinition(Value* v) {
+    Node* def = v->node();
+    if (def->kind() == prim::Param) {
+      return *def->owningBlock()->nodes().begin();
+    }
+    return def->next();
+  }
+
+  Value* toDense(Value* v) {
+    auto it = dense_.find(v);
+    if (it != dense_.end()) {
+      return it->second;
+    }
+    // MKLDNN values are never mutated, so one conversion serves all the
+    // dense uses.
+    WithInsertPoint guard(afterDefinition(v));
+    Value* dense = graph_->insert(
+        Symbol::fromQualString("aten::to_dense"), {v});
+    dense_[v] = dense;
+    return dense;
+  }
+
+  Value* toMKLDNN(Value* v, Node* user) {
+    if (aliasDb_.hasWriters(v)) {
+      // The conversion must see the writes before the user.
+      WithInsertPoint guard(user);
+      return graph_->insert(Symbol::fromQualString("aten::to_mkldnn"), {v});
+    }
+    auto it = mkldnn_.find(v);
+    if (it != mkldnn_.end()) {
+      return it->second;
+    }
+    WithInsertPoint guard(afterDefinition(v));
+    Value* mkldnn =
+        graph_->insert(Symbol::fromQualString("aten::to_mkldnn"), {v});
+    mkldnn_[v] = mkldnn;
+    return mkldnn;
+  }
+
+  bool isMKLDNN(Value* v) const {
+    return ranks_.count(v);
+  }
+
+  int64_t rank(Value* v) const {
+    auto it = ranks_.find(v);
+    return it == ranks_.end() ? -1 : it->second;
+  }
+
+  void setMKLDNN(Value* v, int64_t rank) {
+    ranks_[v] = rank;
+    v->setType(TensorType::get());
+  }
+
+  // Rewrites n to take and return MKLDNN tensors if it can, and returns the
+  // rank of its output (-1 if unknown), or nullopt if n stays dense.
+  c10::optional<int64_t> rewriteNode(Node* n) {
+    Value* input = n->inputs().empty() ? nullptr : n->input(0);
+
+    if (n->matches(
+            "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+        n->matches(
+            "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor")) {
+      const bool is_conv2d = n->kind() == aten::conv2d;
+      if (!is_conv2d && !isConstantFalse(n->input(6))) {
+        return c10::nullopt;
+      }
+      auto weight = constantFloatTensor(n->input(1));
+      auto stride = constant_as<std::vector<int64_t>>(n->input(3));
+      auto padding = constant_as<std::vector<int64_t>>(n->input(4));
+      auto dilation = constant_as<std::vector<int64_t>>(n->input(5));
+      auto groups = constant_as<int64_t>(n->input(is_conv2d ? 6 : 8));
+      if (!weight || weight->dim() != 4 || !stride || !padding || !dilation ||
+          !groups) {
+        return c10::nullopt;
+      }
+      if (!isMKLDNN(input)) {
+        n->replaceInput(0, toMKLDNN(input, n));
+      }
+      // Reorders the weight into the blocked format of MKLDNN convolutions.
+      n->replaceInput(
+          1,
+          insertMKLDNNConstant(at::mkldnn_reorder_conv2d_weight(
+              weight->to_mkldnn(), *padding, *stride, *dilation, *groups)));
+      if (!n->input(2)->mustBeNone()) {
+        replaceByMKLDNNConstant(n, 2);
+      }
+      return 4;
+    }
+
+    // The other ops only continue a subgraph that a convolution started.
+    if (!input || !isMKLDNN(input)) {
+      return c10::nullopt;
+    }
+
+    if (n->matches("aten::relu(Tensor self) -> Tensor")) {
+      return rank(input);
+    }
+    if (n->matches(
+            "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor")) {
+      // MKLDNN doesn't broadcast, so both inputs must come from MKLDNN ops of
+      // the same rank, such as the residual connections of ResNets.
+      if (!isMKLDNN(n->input(1)) || rank(input) < 0 ||
+          rank(input) != rank(n->input(1))) {
+        return c10::nullopt;
+      }
+      return rank(input);
+    }
+    if (n->matches(
+            "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor")) {
+      if (rank(input) != 4 || !isConstantFalse(n->input(5))) {
+        return c10::nullopt;
+      }
+      for (size_t i = 1; i <= 4; ++i) {
+        if (!constantFloatTensor(n->input(i))) {
+          return c10::nullopt;
+        }
+      }
+      for (size_t i = 1; i <= 4; ++i) {
+        replaceByMKLDNNConstant(n, i);
+      }
+      return 4;
+    }
+    if (n->matches(
+            "aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor")) {
+      if (rank(input) != 4 || !isConstantFalse(n->input(5))) {
+        return c10::nullopt;
+      }
+      return 4;
+    }
+    if (n->matches(
+            "aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad) -> Tensor")) {
+      if (rank(input) != 4 || !isConstantFalse(n->input(4))) {
+        return c10::nullopt;
+      }
+      return 4;
+    }
+    if (n->matches(
+            "aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor")) {
+      // MKLDNN only supports input sizes that are multiples of the output
+      // size, which is only known for global pooling. F.adaptive_avg_pool2d
+      // passes the output size through aten::list_with_default, which
+      // returns it unchanged.
+      Value* output_size_value = n->input(1);
+      if (output_size_value->node()->kind() ==
+          Symbol::fromQualString("aten::list_with_default")) {
+        output_size_value = output_size_value->node()->input(0);
+      }
+      auto output_size = constant_as<std::vector<int64_t>>(output_size_value);
+      if (rank(input) != 4 || !output_size ||
+          *output_size != std::vector<int64_t>{1, 1}) {
+        return c10::nullopt;
+      }
+      return 4;
+    }
+    if (n->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      if (rank(input) != 2 || !constantFloatTensor(n->input(1)) ||
+          (!n->input(2)->mustBeNone() && !constantFloatTensor(n->input(2)))) {
+        return c10::nullopt;
+      }
+      replaceByMKLDNNConstant(n, 1);
+      if (!n->input(2)->mustBeNone()) {
+        replaceByMKLDNNConstant(n, 2);
+      }
+      return 2;
+    }
+    if (n->matches(
+            "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor")) {
+      auto start_dim = constant_as<int64_t>(n->input(1));
+      auto end_dim = constant_as<int64_t>(n->input(2));
+      const int64_t input_rank = rank(input);
+      if (input_rank < 1 || !start_dim || !end_dim) {
+        return c10::nullopt;
+      }
+      const int64_t start = *start_dim < 0 ? *start_dim + input_rank : *start_dim;
+      const int64_t end = *end_dim < 0 ? *end_dim + input_rank : *end_dim;
+      if (start < 0 || end >= input_rank || start > end) {
+        return c10::nullopt;
+      }
+      return input_rank - (end - start);
+    }
+    if (n->matches("aten::reshape(Tensor self, int[] shape) -> Tensor")) {
+      return shapeRank(n->input(1));
+    }
+    return c10::nullopt;
+  }
+
+  // MKLDNN tensors can't be viewed, but since neither the input nor the
+  // output of the view are mutated, a reshape is equivalent.
+  Node* replaceViewByReshape(Node* view) {
+    Node* reshape =
+        graph_->create(aten::reshape, view->inputs())->insertBefore(view);
+    reshape->output()->copyMetadata(view->output());
+    view->output()->replaceAllUsesWith(reshape->output());
+    view->destroy();
+    return reshape;
+  }
+
+  // Ops that only read the metadata of a tensor work on MKLDNN tensors.
+  static bool readsMetadataOnly(Node* n) {
+    return n->matches("aten::size(Tensor self, int dim) -> int") ||
+        n->matches("aten::size(Tensor self) -> int[]") ||
+        n->matches("aten::dim(Tensor self) -> int");
+  }
+
+  void useDenseInputs(Node* n) {
+    for (size_t i = 0; i < n->inputs().size(); ++i) {
+      if (isMKLDNN(n->input(i))) {
+        n->replaceInput(i, toDense(n->input(i)));
+      }
+    }
+  }
+
+  // The nodes of sub-blocks can use the values of outer blocks without them
+  // being inputs of the node that owns the sub-blocks.
+  void useDenseValuesInBlocks(Node* n) {
+    for (Block* b : n->blocks()) {
+      for (Node* inner : b->nodes()) {
+        useDenseValuesInBlocks(inner);
+        if (!readsMetadataOnly(inner)) {
+          useDenseInputs(inner);
+        }
+      }
+      useDenseInputs(b->return_node());
+    }
+  }
+
+  void rewriteBlock(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* n = *it++;
+      if (!n->blocks().empty()) {
+        useDenseValuesInBlocks(n);
+        useDenseInputs(n);
+        for (Block* b : n->blocks()) {
+          rewriteBlock(b);
+        }
+        continue;
+      }
+      // The conversions the pass inserts are never visited, since they are
+      // inserted before the node being rewritten.
+      if (n->outputs().size() == 1 &&
+          n->output()->type()->isSubtypeOf(TensorType::get()) &&
+          !aliasDb_.hasWriters(n->output())) {
+        if (n->matches("aten::view(Tensor self, int[] size) -> Tensor") &&
+            isMKLDNN(n->input(0))) {
+          n = replaceViewByReshape(n);
+        }
+        if (auto output_rank = rewriteNode(n)) {
+          setMKLDNN(n->output(), *output_rank);
+          for (size_t i = 1; i < n->inputs().size(); ++i) {
+            Value* v = n->input(i);
+            if (v->type()->isSubtypeOf(TensorType::get()) && !isMKLDNN(v) &&
+                !v->mustBeNone() && v->node()->kind() != prim::Constant) {
+              // e.g. a dense bias computed in the graph.
+              n->replaceInput(i, toMKLDNN(v, n));
+            }
+          }
+          continue;
+        }
+      }
+      if (!readsMetadataOnly(n)) {
+        useDenseInputs(n);
+      }
+    }
+    useDenseInputs(block->return_node());
+  }
+
+  // Returns the only user of v if it is an MKLDNN op of the given kind.
+  Node* onlyMKLDNNUser(Value* v, NodeKind kind) const {
+    if (v->uses().size() != 1) {
+      return nullptr;
+    }
+    Node* user = v->uses()[0].user;
+    if (user->kind() != kind || user->outputs().size() != 1 ||
+        !isMKLDNN(user->output())) {
+      return nullptr;
+    }
+    return user;
+  }
+
+  // Fuses the add and the relu that follow MKLDNN convolutions into them,
+  // e.g. relu(conv(x) + y) in the residual blocks of ResNets, which MKLDNN
+  // applies as post-ops while it writes the output of the convolution.
+  void fuseConvPostOps(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* conv = *it++;
+      for (Block* b : conv->blocks()) {
+        fuseConvPostOps(b);
+      }
+      if ((conv->kind() != aten::conv2d &&
+           conv->kind() != aten::_convolution) ||
+          !isMKLDNN(conv->output())) {
+        continue;
+      }
+
+      std::vector<Node*> fused_nodes = {conv};
+      Value* sum = nullptr;
+      if (Node* add = onlyMKLDNNUser(conv->output(), aten::add)) {
+        // add(self, other, alpha) is self + alpha * other
+        auto alpha = toIValue(add->input(2));
+        if (alpha && alpha->isScalar() && alpha->toScalar().toDouble() == 1) {
+          sum = add->input(0) == conv->output() ? add->input(1)
+                                                : add->input(0);
+          fused_nodes.push_back(add);
+        }
+      }
+      Node* relu = onlyMKLDNNUser(fused_nodes.back()->output(), aten::relu);
+      if (relu) {
+        fused_nodes.push_back(relu);
+      }
+      if (fused_nodes.size() == 1) {
+        continue;
+      }
+
+      const bool is_conv2d = conv->kind() == aten::conv2d;
+      std::vector<NamedValue> kwargs;
+      if (sum) {
+        kwargs.emplace_back("sum", sum);
+      }
+      kwargs.emplace_back("relu", relu != nullptr);
+      // Inserted at the last fused node, where sum is defined.
+      WithInsertPoint guard(fused_nodes.back());
+      Value* fused = graph_->insert(
+          Symbol::fromQualString("aten::mkldnn_convolution_fused"),
+          {conv->input(0),
+           conv->input(1),
+           conv->input(2),
+           conv->input(4),
+           conv->input(3),
+           conv->input(5),
+           conv->input(is_conv2d ? 6 : 8)},
+          kwargs);
+      setMKLDNN(fused, 4);
+      fused_nodes.back()->output()->replaceAllUsesWith(fused);
+      for (auto node = fused_nodes.rbegin(); node != fused_nodes.rend();
+           ++node) {
+        if (*it == *node) {
+          ++it;
+        }
+        (*node)->destroy();
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb aliasDb_;
+  // The rank of every MKLDNN value, or -1 if it isn't known.
+  std::unordered_map<Value*, int64_t> ranks_;
+  std::unordered_map<Value*, Value*> dense_;
+  std::unordered_map<Value*, Value*> mkldnn_;
+};
+
+} // namespace
+
+void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN()) {
+    return;
+  }
+  removeUnobservedInplaceOps(graph->block());
+  MKLDNNRewriter(graph).run();
+  EliminateDeadCode(graph);
+}
+
+} // namespace jit
+} // namespace torch
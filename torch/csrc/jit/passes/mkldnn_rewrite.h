@@ -0,0 +1,38 @@
+/** \brief This file defines the pass that runs frozen graphs on MKLDNN
+ * tensors.
+ *
+ * The pass is meant for CPU inference, on the graphs returned by
+ * FreezeMethod, whose weights are constants.
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Converts the maximal subgraphs of ops that have MKLDNN kernels to
+ * run on MKLDNN tensors.
+ *
+ * Convolutions start an MKLDNN subgraph, and relu, add, batch_norm, the 2d
+ * poolings, linear and the reshapes that follow them stay in it. Tensors are
+ * only reordered at the boundaries of the subgraphs: aten::to_mkldnn is
+ * inserted before a convolution whose input is dense, and aten::to_dense
+ * before any other use of an MKLDNN value, including the graph outputs.
+ *
+ * The add and the relu that follow a convolution are fused into it as MKLDNN
+ * post-ops (aten::mkldnn_convolution_fused), so that they are applied while
+ * the output of the convolution is written instead of in separate passes.
+ *
+ * The constant weights of the converted ops are reordered once by the pass,
+ * into the blocked format of MKLDNN for the convolutions, so they are not
+ * reordered on every run. The MKLDNN constants can't be serialized, so the
+ * rewritten graph should only be run, not saved.
+ *
+ * Only float tensors that are never mutated are converted. The pass does
+ * nothing if PyTorch is built without MKLDNN.
+ */
+TORCH_API void ConvertFrozenOpsToMKLDNN(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -3,6 +3,9 @@
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/node_hashing.h>
 #include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
 #include <stack>
 
@@ -24,6 +27,8 @@ Operator* checkIfNodeQuantizable(Node* n) {
       "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] \
 stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor",
       "aten::relu(Tensor self) -> Tensor",
+      "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor",
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
       "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] \
 stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, \
 int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor"};
@@ -467,6 +472,81 @@ void FoldQuantNodesIntoInputsOutputs(std::shared_ptr<Graph>& graph) {
   throw std::runtime_error("Pass not implemented yet!");
 }
 
+void QuantFusion(std::shared_ptr<Graph>& graph) {
+  // The qparams of every quant-dequant pair are separate constants, merge
+  // them so that the patterns below can tell equal qparams apart.
+  ConstantPooling(graph);
+
+  SubgraphRewriter rewriter;
+  // The bias of quantized::fbgemm_linear is the int32 representation of the
+  // float bias, quantized with the scale of the accumulator.
+  rewriter.RegisterRewritePattern(
+      R"IR(
+graph(%a_quant, %a_scale, %a_zp, %a_dtype, %w_quant, %w_scale, %w_zp, %w_dtype, %b, %r_scale, %r_zp, %r_dtype):
+  %a_intrepr = aten::int_repr(%a_quant)
+  %a_dequant = aten::dequantize_linear(%a_intrepr, %a_scale, %a_zp, %a_dtype)
+  %w_intrepr = aten::int_repr(%w_quant)
+  %w_dequant = aten::dequantize_linear(%w_intrepr, %w_scale, %w_zp, %w_dtype)
+  %r = aten::linear(%a_dequant, %w_dequant, %b)
+  %r_quant = aten::quantize_linear(%r, %r_scale, %r_zp, %r_dtype)
+  return (%r_quant))IR",
+      R"IR(
+graph(%a_quant, %a_scale, %a_zp, %a_dtype, %w_quant, %w_scale, %w_zp, %w_dtype, %b, %r_scale, %r_zp, %r_dtype):
+  %w_packed = quantized::fbgemm_linear_prepack(%w_quant)
+  %b_scale = aten::mul(%a_scale, %w_scale)
+  %b_zp = prim::Constant[value=0]()
+  %b_dtype = prim::Constant[value=14]()
+  %b_quant = aten::quantize_linear(%b, %b_scale, %b_zp, %b_dtype)
+  %b_intrepr = aten::int_repr(%b_quant)
+  %r = quantized::fbgemm_linear(%a_quant, %w_packed, %b_intrepr, %r_scale, %r_zp)
+  return (%r))IR");
+  rewriter.RegisterRewritePattern(
+      R"IR(
+graph(%a_quant, %a_scale, %a_zp, %a_dtype, %b_quant, %b_scale, %b_zp, %b_dtype, %r_scale, %r_zp, %r_dtype):
+  %alpha = prim::Constant[value=1]()
+  %a_intrepr = aten::int_repr(%a_quant)
+  %a_dequant = aten::dequantize_linear(%a_intrepr, %a_scale, %a_zp, %a_dtype)
+  %b_intrepr = aten::int_repr(%b_quant)
+  %b_dequant = aten::dequantize_linear(%b_intrepr, %b_scale, %b_zp, %b_dtype)
+  %r = aten::add(%a_dequant, %b_dequant, %alpha)
+  %r_quant = aten::quantize_linear(%r, %r_scale, %r_zp, %r_dtype)
+  return (%r_quant))IR",
+      R"IR(
+graph(%a_quant, %a_scale, %a_zp, %a_dtype, %b_quant, %b_scale, %b_zp, %b_dtype, %r_scale, %r_zp, %r_dtype):
+  %r = quantized::add(%a_quant, %b_quant, %r_scale, %r_zp)
+  return (%r))IR");
+  // quantized::relu keeps the qparams of its input.
+  rewriter.RegisterRewritePattern(
+      R"IR(
+graph(%a_quant, %scale, %zp, %dtype):
+  %a_intrepr = aten::int_repr(%a_quant)
+  %a_dequant = aten::dequantize_linear(%a_intrepr, %scale, %zp, %dtype)
+  %r = aten::relu(%a_dequant)
+  %r_quant = aten::quantize_linear(%r, %scale, %zp, %dtype)
+  return (%r_quant))IR",
+      R"IR(
+graph(%a_quant, %scale, %zp, %dtype):
+  %r = quantized::relu(%a_quant)
+  return (%r))IR");
+  rewriter.runOnGraph(graph);
+
+  // The fused ops are quantized again where their outputs are dequantized
+  // for the next fused op, skip the round trip.
+  SubgraphRewriter redundant_pairs;
+  redundant_pairs.RegisterRewritePattern(
+      R"IR(
+graph(%a_quant, %scale, %zp, %dtype):
+  %a_intrepr = aten::int_repr(%a_quant)
+  %a_dequant = aten::dequantize_linear(%a_intrepr, %scale, %zp, %dtype)
+  %r_quant = aten::quantize_linear(%a_dequant, %scale, %zp, %dtype)
+  return (%r_quant))IR",
+      R"IR(
+graph(%a_quant, %scale, %zp, %dtype):
+  return (%a_quant))IR");
+  redundant_pairs.runOnGraph(graph);
+  EliminateDeadCode(graph);
+}
+
 void InsertQuantDequantNodesForParam(
     script::Method& method,
     const std::string& param_name,
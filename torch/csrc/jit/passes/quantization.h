@@ -81,6 +81,22 @@ TORCH_API void QuantLinting(std::shared_ptr<Graph>& graph);
  */
 TORCH_API void FoldQuantNodesIntoInputsOutputs(std::shared_ptr<Graph>& graph);
 
+/** \brief Fuses quant-dequant node pairs into the ops they surround.
+ *
+ * After quant-dequant nodes insertion, a quantizable op reads dequantized
+ * values and its output is quantized again. This pass rewrites such patterns
+ * into the corresponding quantized ops, which read and return the quantized
+ * values directly:
+ *   dequant -> aten::linear -> quant into quantized::fbgemm_linear on a
+ *     prepacked quantized weight (the bias is quantized to int32 with the
+ *     product of the input and weight scales),
+ *   dequant -> aten::add -> quant into quantized::add,
+ *   dequant -> aten::relu -> quant with the same qparams into quantized::relu.
+ * Quant nodes of dequantized values with the same qparams are then replaced
+ * by the values they were dequantized from.
+ */
+TORCH_API void QuantFusion(std::shared_ptr<Graph>& graph);
+
 /** \brief Inserts quant-dequant nodes for attributes.
  *
  * This is similar to Quant-Dequant pass but it inserts quant-dequant nodes
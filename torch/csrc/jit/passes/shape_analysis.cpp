@@ -339,7 +339,11 @@ class ShapePropagator {
       // some ops may have mixed tensor/primitive outputs
       // for primitives, we don't need to change the type because it is already
       // its most constrained form.
-      if (stack[i].isTensor())
+      // MKLDNN tensors (e.g. of aten::to_mkldnn) have no strides, so their
+      // types can't be complete.
+      if (stack[i].isTensor() && stack[i].toTensor().is_mkldnn())
+        node->outputs()[i]->setType(TensorType::get());
+      else if (stack[i].isTensor())
         node->outputs()[i]->inferTypeFrom(stack[i].toTensor());
     }
     return true;
@@ -0,0 +1,185 @@
+#include <torch/csrc/jit/passes/strength_reduction.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+struct InductionVariable {
+  // value at the first iteration
+  Value* init;
+  // value added at every iteration
+  Value* step;
+};
+
+bool isInt(Value* v) {
+  return v->type()->isSubtypeOf(IntType::get());
+}
+
+// Whether v is defined outside of loop, in which case it is invariant
+bool isDefinedOutside(Value* v, Node* loop) {
+  for (Block* b = v->node()->owningBlock(); b->owningNode();
+       b = b->owningNode()->owningBlock()) {
+    if (b->owningNode() == loop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Value* insertMul(Graph& graph, Value* a, Value* b) {
+  auto a_const = constant_as<int64_t>(a);
+  auto b_const = constant_as<int64_t>(b);
+  if (a_const && b_const) {
+    return graph.insertConstant(*a_const * *b_const);
+  } else if (a_const && *a_const == 1) {
+    return b;
+  } else if (b_const && *b_const == 1) {
+    return a;
+  }
+  return graph.insert(aten::mul, {a, b});
+}
+
+// Replaces `product = iv * factor` with a new carried value of the loop
+void reduceProduct(
+    Node* loop,
+    Node* product,
+    const InductionVariable& iv,
+    Value* factor) {
+  Graph& graph = *loop->owningGraph();
+  Block* body = loop->blocks().at(0);
+  Value* init;
+  Value* step;
+  {
+    WithInsertPoint guard(loop);
+    init = insertMul(graph, iv.init, factor);
+    step = insertMul(graph, iv.step, factor);
+  }
+  loop->addInput(init);
+  loop->addOutput()->setType(IntType::get());
+  Value* reduced = body->addInput()->setType(IntType::get());
+  product->output()->replaceAllUsesWith(reduced);
+  WithInsertPoint guard(body->return_node());
+  body->registerOutput(graph.insert(aten::add, {reduced, step}));
+}
+
+void reduceLoop(Node* loop) {
+  Graph& graph = *loop->owningGraph();
+  Block* body = loop->blocks().at(0);
+
+  std::unordered_map<Value*, InductionVariable> ivs;
+  {
+    WithInsertPoint guard(loop);
+    ivs[body->inputs().at(0)] = {graph.insertConstant(0),
+                                 graph.insertConstant(1)};
+  }
+  // Loop carried ints updated with `iv + step`, where step is invariant
+  for (size_t i = 1; i < body->inputs().size(); ++i) {
+    Value* carried = body->inputs()[i];
+    Node* update = body->outputs().at(i)->node();
+    if (!isInt(carried) || update->kind() != aten::add ||
+        update->inputs().size() != 2 ||
+        (update->input(0) != carried && update->input(1) != carried)) {
+      continue;
+    }
+    Value* step = update->input(0) == carried ? update->input(1)
+                                              : update->input(0);
+    if (isInt(step) && isDefinedOutside(step, loop)) {
+      ivs[carried] = {loop->inputs().at(i + 1), step};
+    }
+  }
+
+  for (Node* node : body->nodes()) {
+    if (node->kind() != aten::mul || node->inputs().size() != 2 ||
+        !isInt(node->output())) {
+      continue;
+    }
+    for (size_t i = 0; i < 2; ++i) {
+      auto it = ivs.find(node->input(i));
+      Value* factor = node->input(1 - i);
+      if (it != ivs.end() && isInt(factor) &&
+          isDefinedOutside(factor, loop)) {
+        reduceProduct(loop, node, it->second, factor);
+        break;
+      }
+    }
+  }
+}
+
+void reduceInductionVariables(Block* block) {
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      reduceInductionVariables(subblock);
+    }
+    if (node->kind() == prim::Loop) {
+      reduceLoop(node);
+    }
+  }
+}
+
+bool isListAppend(Node* node) {
+  return node->kind() == aten::append && node->inputs().size() == 2 &&
+      node->input(0)->type()->cast<ListType>();
+}
+
+bool isSelectLast(Node* node) {
+  if (node->kind() != aten::select || node->inputs().size() != 2 ||
+      !node->input(0)->type()->cast<ListType>()) {
+    return false;
+  }
+  auto index = constant_as<int64_t>(node->input(1));
+  return index && *index == -1;
+}
+
+// Replaces `l[-1]` with the last element appended to l, if nothing may have
+// written to l since then.
+void forwardAppendedElements(Block* block, const AliasDb& aliasDb) {
+  std::unordered_map<Value*, Value*> last_appended;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      forwardAppendedElements(subblock, aliasDb);
+    }
+    if (isSelectLast(node)) {
+      auto it = last_appended.find(node->input(0));
+      if (it != last_appended.end() &&
+          it->second->type()->isSubtypeOf(node->output()->type())) {
+        node->output()->replaceAllUsesWith(it->second);
+      }
+      continue;
+    }
+
+    if (node->hasSideEffects()) {
+      last_appended.clear();
+    }
+    for (auto it = last_appended.begin(); it != last_appended.end();) {
+      if (aliasDb.writesToAlias(node, {it->first}, /*recurseBlocks=*/true)) {
+        it = last_appended.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (isListAppend(node)) {
+      last_appended[node->input(0)] = node->input(1);
+    }
+  }
+}
+
+} // namespace
+
+void StrengthReduction(const std::shared_ptr<Graph>& graph) {
+  {
+    AliasDb aliasDb(graph);
+    forwardAppendedElements(graph->block(), aliasDb);
+  }
+  reduceInductionVariables(graph->block());
+  EliminateDeadCode(graph);
+}
+
+} // namespace jit
+} // namespace torch
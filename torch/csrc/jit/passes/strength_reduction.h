@@ -0,0 +1,19 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces expensive patterns in loops with cheaper equivalents:
+//
+// - an int product `iv * c` of an induction variable iv (the loop counter,
+//   or a carried int updated with `iv + step`) and a loop invariant c becomes
+//   a new carried int that is incremented by `step * c` at every iteration,
+//   so that e.g. offsets computed from the loop counter need no multiply.
+// - `l[-1]` right after `l.append(x)` is replaced with x, if nothing may
+//   have written to l in between.
+TORCH_API void StrengthReduction(const std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
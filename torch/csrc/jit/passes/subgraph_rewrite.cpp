@@ -37,15 +37,18 @@ std::shared_ptr<script::Module> SubgraphRewriter::runOnModule(
   return module;
 }
 
-void SubgraphRewriter::runOnGraph(std::shared_ptr<Graph>& graph) {
+void SubgraphRewriter::runOnGraph(
+    std::shared_ptr<Graph>& graph,
+    const MatchFilter& filter) {
   for (const RewritePatternDescr& pattern : patterns_) {
-    rewriteSinglePatternOnGraph(graph, pattern);
+    rewriteSinglePatternOnGraph(graph, pattern, filter);
   }
 }
 
 void SubgraphRewriter::rewriteSinglePatternOnGraph(
     std::shared_ptr<Graph>& graph,
-    RewritePatternDescr pattern) {
+    RewritePatternDescr pattern,
+    const MatchFilter& filter) {
   std::unordered_map<Value*, Value*> rewrite_map;
   std::vector<Value*> values_to_rewrite;
 
@@ -64,6 +67,9 @@ void SubgraphRewriter::rewriteSinglePatternOnGraph(
     if (overlapsWithPreviousMatches(&match)) {
       continue;
     }
+    if (filter && !filter(match, vmap)) {
+      continue;
+    }
 
     // Figure out what values we need to use as inputs and outputs for the
     // replacement subgraph. These would be inputs and outputs of the subgraph
@@ -91,9 +97,11 @@ void SubgraphRewriter::rewriteSinglePatternOnGraph(
       values_to_rewrite.push_back(outputs[idx]);
       rewrite_map[outputs[idx]] = new_outputs[idx];
     }
-    // Record all planned deletions
+    // Record all planned deletions. Matched constants may have uses outside
+    // the match, they are left to dead code elimination.
     for (Node* pattern_n : pattern_graph.nodes()) {
-      if (match.nodes_map.count(pattern_n)) {
+      if (match.nodes_map.count(pattern_n) &&
+          pattern_n->kind() != prim::Constant) {
         Node* n = match.nodes_map.at(pattern_n);
         nodes_to_delete_.insert(n);
       }
@@ -112,6 +120,7 @@ void SubgraphRewriter::rewriteSinglePatternOnGraph(
   for (auto n : nodes_to_delete_) {
     n->destroy();
   }
+  nodes_to_delete_.clear();
 }
 
 bool SubgraphRewriter::overlapsWithPreviousMatches(const Match* match) {
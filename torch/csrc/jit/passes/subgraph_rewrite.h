@@ -12,6 +12,9 @@
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/script/module.h>
 
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -22,6 +25,16 @@ namespace jit {
 struct RewritePatternDescr;
 struct Match;
 
+/** A predicate deciding whether a match of a pattern should be rewritten.
+ *
+ * It is given the match, and the map from the names of the values in the
+ * pattern IR to the values of the pattern graph (the keys of
+ * `Match::values_map`), so that e.g. the constants or types of the matched
+ * values can be checked.
+ */
+using MatchFilter = std::function<
+    bool(const Match&, const std::unordered_map<std::string, Value*>&)>;
+
 /** Run pattern-based subgraph rewrites on all methods in the module.
  *
  * This pass will go through all methods in the module and try to replace all
@@ -49,7 +62,10 @@ class TORCH_API SubgraphRewriter {
       std::shared_ptr<script::Module> module);
 
   // Run pattern-based subgraph rewrite pass on the graph (used in testing).
-  void runOnGraph(std::shared_ptr<Graph>& graph);
+  // If \p filter is given, only the matches it accepts are rewritten.
+  void runOnGraph(
+      std::shared_ptr<Graph>& graph,
+      const MatchFilter& filter = nullptr);
 
   // Register standard rewrite patterns.
   void RegisterDefaultPatterns();
@@ -72,7 +88,8 @@ class TORCH_API SubgraphRewriter {
 
   void rewriteSinglePatternOnGraph(
       std::shared_ptr<Graph>& graph,
-      RewritePatternDescr pattern);
+      RewritePatternDescr pattern,
+      const MatchFilter& filter);
   bool overlapsWithPreviousMatches(const Match* match);
 };
 
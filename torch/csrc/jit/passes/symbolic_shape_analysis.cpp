@@ -0,0 +1,810 @@
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/operator.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::optional<int64_t> wrapDim(int64_t dim, size_t rank) {
+  const int64_t r = rank;
+  if (dim < -r || dim >= r) {
+    return c10::nullopt;
+  }
+  return dim < 0 ? dim + r : dim;
+}
+
+// The dimension a constant int argument refers to, if it is in range
+c10::optional<int64_t> constantDim(Value* v, size_t rank) {
+  auto dim = constant_as<int64_t>(v);
+  if (!dim) {
+    return c10::nullopt;
+  }
+  return wrapDim(*dim, rank);
+}
+
+class SymbolicShapePropagator {
+ public:
+  explicit SymbolicShapePropagator(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  SymbolicShapes run(
+      const std::vector<c10::optional<SymbolicShape>>& input_shapes) {
+    auto inputs = graph_->inputs();
+    if (input_shapes.empty()) {
+      for (Value* input : inputs) {
+        setShapeFromType(input);
+      }
+    } else {
+      TORCH_CHECK(
+          input_shapes.size() == inputs.size(),
+          "Expected ",
+          inputs.size(),
+          " input shapes, but got ",
+          input_shapes.size());
+      // new symbols must not collide with the ones of the inputs
+      for (const auto& shape : input_shapes) {
+        if (shape) {
+          for (ShapeSymbol dim : *shape) {
+            next_symbol_ = std::min(next_symbol_, dim.value() - 1);
+          }
+        }
+      }
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        if (input_shapes[i]) {
+          setShape(inputs[i], *input_shapes[i]);
+        }
+      }
+    }
+    propagateBlock(graph_->block());
+    return std::move(result_);
+  }
+
+ private:
+  ShapeSymbol newSymbol() {
+    return ShapeSymbol::fromValue(next_symbol_--);
+  }
+
+  SymbolicShape newShape(size_t rank) {
+    SymbolicShape shape;
+    for (size_t i = 0; i < rank; ++i) {
+      shape.push_back(newSymbol());
+    }
+    return shape;
+  }
+
+  c10::optional<SymbolicShape> shapeOf(const Value* v) const {
+    if (const SymbolicShape* shape = result_.shapeOf(v)) {
+      return *shape;
+    }
+    return c10::nullopt;
+  }
+
+  void setShape(const Value* v, c10::optional<SymbolicShape> shape) {
+    if (shape) {
+      result_.shapes[v] = std::move(*shape);
+    } else {
+      result_.shapes.erase(v);
+    }
+  }
+
+  void setShapeFromType(const Value* v) {
+    if (auto type = v->type()->cast<CompleteTensorType>()) {
+      SymbolicShape shape;
+      for (int64_t size : type->sizes()) {
+        shape.push_back(ShapeSymbol::fromStaticSize(size));
+      }
+      setShape(v, std::move(shape));
+    } else if (auto type = v->type()->cast<DimensionedTensorType>()) {
+      setShape(v, newShape(type->dim()));
+    } else {
+      setShape(v, c10::nullopt);
+    }
+  }
+
+  // The size an int value stands for. Ints that aren't constants or sizes of
+  // tensors get a new symbol, so that their uses agree with each other.
+  ShapeSymbol sizeOf(const Value* v) {
+    if (auto size = result_.sizeOf(v)) {
+      return *size;
+    }
+    auto constant = constant_as<int64_t>(v);
+    ShapeSymbol size = constant && *constant >= 0
+        ? ShapeSymbol::fromStaticSize(*constant)
+        : newSymbol();
+    result_.sizes.emplace(v, size);
+    return size;
+  }
+
+  // The sizes in an int[] argument, with nullopt for the -1s, or nullopt if
+  // its length isn't known.
+  c10::optional<std::vector<c10::optional<ShapeSymbol>>> sizesOfList(
+      Value* list) {
+    std::vector<c10::optional<ShapeSymbol>> sizes;
+    if (auto constant = constant_as<std::vector<int64_t>>(list)) {
+      for (int64_t size : *constant) {
+        if (size == -1) {
+          sizes.emplace_back(c10::nullopt);
+        } else if (size >= 0) {
+          sizes.emplace_back(ShapeSymbol::fromStaticSize(size));
+        } else {
+          return c10::nullopt;
+        }
+      }
+      return sizes;
+    }
+    Node* producer = list->node();
+    if (producer->kind() == prim::ListConstruct) {
+      for (Value* element : producer->inputs()) {
+        auto constant = constant_as<int64_t>(element);
+        if (constant && *constant == -1) {
+          sizes.emplace_back(c10::nullopt);
+        } else {
+          sizes.emplace_back(sizeOf(element));
+        }
+      }
+      return sizes;
+    }
+    if (producer->matches("aten::size(Tensor self) -> int[]")) {
+      if (auto shape = shapeOf(producer->input())) {
+        sizes.assign(shape->begin(), shape->end());
+        return sizes;
+      }
+    }
+    return c10::nullopt;
+  }
+
+  ShapeSymbol broadcastDims(ShapeSymbol a, ShapeSymbol b) {
+    if (a == b) {
+      return a;
+    } else if (a.isStatic() && a.staticSize() == 1) {
+      return b;
+    } else if (b.isStatic() && b.staticSize() == 1) {
+      return a;
+    } else if (a.isStatic()) {
+      // b is either 1 or the same size
+      return a;
+    } else if (b.isStatic()) {
+      return b;
+    }
+    return newSymbol();
+  }
+
+  SymbolicShape broadcast(const SymbolicShape& a, const SymbolicShape& b) {
+    const size_t rank = std::max(a.size(), b.size());
+    SymbolicShape shape;
+    for (size_t i = 0; i < rank; ++i) {
+      if (i + a.size() < rank) {
+        shape.push_back(b[i + b.size() - rank]);
+      } else if (i + b.size() < rank) {
+        shape.push_back(a[i + a.size() - rank]);
+      } else {
+        shape.push_back(
+            broadcastDims(a[i + a.size() - rank], b[i + b.size() - rank]));
+      }
+    }
+    return shape;
+  }
+
+  // The size of the dimension that collapses the given ones
+  ShapeSymbol product(
+      SymbolicShape::const_iterator begin,
+      SymbolicShape::const_iterator end) {
+    int64_t static_size = 1;
+    c10::optional<ShapeSymbol> symbol;
+    size_t num_symbols = 0;
+    for (auto it = begin; it != end; ++it) {
+      if (it->isStatic()) {
+        static_size *= it->staticSize();
+      } else {
+        symbol = *it;
+        ++num_symbols;
+      }
+    }
+    if (num_symbols == 0) {
+      return ShapeSymbol::fromStaticSize(static_size);
+    } else if (num_symbols == 1 && static_size == 1) {
+      return *symbol;
+    }
+    return newSymbol();
+  }
+
+  ShapeSymbol sum(const std::vector<ShapeSymbol>& dims) {
+    int64_t static_size = 0;
+    for (ShapeSymbol dim : dims) {
+      if (!dim.isStatic()) {
+        return newSymbol();
+      }
+      static_size += dim.staticSize();
+    }
+    return ShapeSymbol::fromStaticSize(static_size);
+  }
+
+  // The size of the -1 in a view of a tensor of the given shape
+  ShapeSymbol inferViewDim(
+      const SymbolicShape& shape,
+      const std::vector<c10::optional<ShapeSymbol>>& sizes) {
+    int64_t input_static = 1;
+    std::vector<ShapeSymbol> input_symbols;
+    for (ShapeSymbol dim : shape) {
+      if (dim.isStatic()) {
+        input_static *= dim.staticSize();
+      } else {
+        input_symbols.push_back(dim);
+      }
+    }
+    int64_t output_static = 1;
+    for (const auto& size : sizes) {
+      if (!size) {
+        continue;
+      }
+      if (size->isStatic()) {
+        output_static *= size->staticSize();
+        continue;
+      }
+      auto it = std::find(input_symbols.begin(), input_symbols.end(), *size);
+      if (it == input_symbols.end()) {
+        return newSymbol();
+      }
+      input_symbols.erase(it);
+    }
+    if (output_static == 0 || input_static % output_static != 0) {
+      return newSymbol();
+    }
+    SymbolicShape remaining(input_symbols);
+    remaining.push_back(
+        ShapeSymbol::fromStaticSize(input_static / output_static));
+    return product(remaining.begin(), remaining.end());
+  }
+
+  c10::optional<SymbolicShape> matmul(
+      const SymbolicShape& a,
+      const SymbolicShape& b) {
+    if (a.empty() || b.empty()) {
+      return c10::nullopt;
+    }
+    if (a.size() == 1 && b.size() == 1) {
+      return SymbolicShape{};
+    } else if (a.size() == 1) {
+      SymbolicShape shape(b.begin(), b.end() - 2);
+      shape.push_back(b.back());
+      return shape;
+    } else if (b.size() == 1) {
+      return SymbolicShape(a.begin(), a.end() - 1);
+    }
+    auto shape = broadcast(
+        SymbolicShape(a.begin(), a.end() - 2),
+        SymbolicShape(b.begin(), b.end() - 2));
+    shape.push_back(a[a.size() - 2]);
+    shape.push_back(b.back());
+    return shape;
+  }
+
+  // A dimension for the outputs of control flow, which are one of the
+  // given values
+  ShapeSymbol mergeDims(ShapeSymbol a, ShapeSymbol b) {
+    return a == b ? a : newSymbol();
+  }
+
+  c10::optional<SymbolicShape> mergeShapes(
+      const c10::optional<SymbolicShape>& a,
+      const c10::optional<SymbolicShape>& b) {
+    if (!a || !b || a->size() != b->size()) {
+      return c10::nullopt;
+    }
+    SymbolicShape shape;
+    for (size_t i = 0; i < a->size(); ++i) {
+      shape.push_back(mergeDims((*a)[i], (*b)[i]));
+    }
+    return shape;
+  }
+
+  void propagateBlock(Block* block) {
+    for (Node* node : block->nodes()) {
+      propagateNode(node);
+    }
+  }
+
+  void propagateIf(Node* node) {
+    Block* then_block = node->blocks().at(0);
+    Block* else_block = node->blocks().at(1);
+    propagateBlock(then_block);
+    propagateBlock(else_block);
+    for (size_t i = 0; i < node->outputs().size(); ++i) {
+      setShape(
+          node->outputs()[i],
+          mergeShapes(
+              shapeOf(then_block->outputs()[i]),
+              shapeOf(else_block->outputs()[i])));
+    }
+  }
+
+  // The carried tensors keep the symbols of the dimensions that are the same
+  // at every iteration, and get new ones for the others. Since the symbols
+  // created in the body stand for sizes at a single iteration, those of the
+  // loop outputs are new as well.
+  void propagateLoop(Node* node) {
+    Block* body = node->blocks().at(0);
+    const size_t num_carried = node->outputs().size();
+    std::vector<c10::optional<SymbolicShape>> entry_shapes;
+    for (size_t i = 0; i < num_carried; ++i) {
+      entry_shapes.push_back(shapeOf(node->inputs().at(i + 2)));
+    }
+    // Every round makes at least one more dimension new, so this terminates
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t i = 0; i < num_carried; ++i) {
+        setShape(body->inputs().at(i + 1), entry_shapes[i]);
+      }
+      propagateBlock(body);
+      for (size_t i = 0; i < num_carried; ++i) {
+        auto& entry = entry_shapes[i];
+        if (!entry) {
+          continue;
+        }
+        auto exit = shapeOf(body->outputs().at(i + 1));
+        if (!exit || exit->size() != entry->size()) {
+          entry = c10::nullopt;
+          changed = true;
+          continue;
+        }
+        for (size_t d = 0; d < entry->size(); ++d) {
+          ShapeSymbol& dim = (*entry)[d];
+          if (dim != (*exit)[d] && !fresh_loop_symbols_.count(dim.value())) {
+            dim = newSymbol();
+            fresh_loop_symbols_.insert(dim.value());
+            changed = true;
+          }
+        }
+      }
+    }
+    for (size_t i = 0; i < num_carried; ++i) {
+      auto shape = entry_shapes[i];
+      if (shape) {
+        for (ShapeSymbol& dim : *shape) {
+          if (fresh_loop_symbols_.count(dim.value())) {
+            dim = newSymbol();
+          }
+        }
+      }
+      setShape(node->outputs()[i], shape);
+    }
+  }
+
+  void propagateNode(Node* node) {
+    if (node->kind() == prim::If) {
+      propagateIf(node);
+      return;
+    } else if (node->kind() == prim::Loop) {
+      propagateLoop(node);
+      return;
+    }
+    for (Block* block : node->blocks()) {
+      propagateBlock(block);
+    }
+    if (!propagateKnownOp(node)) {
+      for (Value* output : node->outputs()) {
+        setShapeFromType(output);
+      }
+    }
+  }
+
+  bool propagateKnownOp(Node* node) {
+    // Requirements:
+    //   shape          : preserved
+    //   tensor inputs  : the first one
+    static const OperatorSet shape_preserving_ops{
+        "aten::abs(Tensor self) -> Tensor",
+        "aten::neg(Tensor self) -> Tensor",
+        "aten::sigmoid(Tensor self) -> Tensor",
+        "aten::tanh(Tensor self) -> Tensor",
+        "aten::relu(Tensor self) -> Tensor",
+        "aten::clone(Tensor self) -> Tensor",
+        "aten::contiguous(Tensor self, *, MemoryFormat memory_format=contiguous_format) -> Tensor",
+        "aten::clamp(Tensor self, Scalar? min, Scalar? max) -> Tensor",
+        "aten::dropout(Tensor input, float p, bool train) -> Tensor",
+        "aten::exp(Tensor self) -> Tensor",
+        "aten::log(Tensor self) -> Tensor",
+        "aten::log_softmax(Tensor self, int dim) -> Tensor",
+        "aten::softmax(Tensor self, int dim) -> Tensor",
+        "aten::sqrt(Tensor self) -> Tensor",
+        "aten::rsqrt(Tensor self) -> Tensor",
+        "aten::leaky_relu(Tensor self, Scalar negative_slope) -> Tensor",
+        "aten::hardtanh(Tensor self, Scalar min_val, Scalar max_val) -> Tensor",
+        "aten::threshold(Tensor self, Scalar threshold, Scalar value) -> Tensor",
+        "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+        "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+        "aten::mul(Tensor self, Scalar other) -> Tensor",
+        "aten::div(Tensor self, Scalar other) -> Tensor",
+        "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor",
+        "aten::empty_like(Tensor self) -> Tensor",
+        "aten::ones_like(Tensor self) -> Tensor",
+        "aten::zeros_like(Tensor self) -> Tensor",
+        "aten::rand_like(Tensor self) -> Tensor",
+        "aten::randn_like(Tensor self) -> Tensor",
+    };
+
+    // Requirements:
+    //   shape          : broadcast all tensor inputs
+    static const OperatorSet broadcasting_ops{
+        "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+        "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+        "aten::mul(Tensor self, Tensor other) -> Tensor",
+        "aten::div(Tensor self, Tensor other) -> Tensor",
+        "aten::pow(Tensor self, Tensor exponent) -> Tensor",
+        "aten::max(Tensor self, Tensor other) -> Tensor",
+        "aten::min(Tensor self, Tensor other) -> Tensor",
+        "aten::where(Tensor condition, Tensor self, Tensor other) -> Tensor",
+        "aten::addcmul(Tensor self, Tensor tensor1, Tensor tensor2, *, Scalar value) -> Tensor",
+        "aten::addcdiv(Tensor self, Tensor tensor1, Tensor tensor2, *, Scalar value) -> Tensor",
+        "aten::eq(Tensor self, Tensor other) -> Tensor",
+        "aten::ne(Tensor self, Tensor other) -> Tensor",
+        "aten::lt(Tensor self, Tensor other) -> Tensor",
+        "aten::gt(Tensor self, Tensor other) -> Tensor",
+    };
+
+    static const OperatorSet size_factories{
+        "aten::empty(int[] size, *, int? dtype, int? layout, Device? device, bool? pin_memory) -> Tensor",
+        "aten::ones(int[] size, *, int? dtype, int? layout, Device? device, bool? pin_memory) -> Tensor",
+        "aten::zeros(int[] size, *, int? dtype, int? layout, Device? device, bool? pin_memory) -> Tensor",
+        "aten::rand(int[] size, *, int? dtype, int? layout, Device? device, bool? pin_memory) -> Tensor",
+        "aten::randn(int[] size, *, int? dtype, int? layout, Device? device, bool? pin_memory) -> Tensor",
+    };
+
+    static const OperatorSet dim_reduce_ops{
+        "aten::sum(Tensor self, int[] dim, bool keepdim) -> Tensor",
+        "aten::mean(Tensor self, int[] dim, bool keepdim) -> Tensor",
+    };
+
+    if (node->matches("aten::size(Tensor self, int dim) -> int")) {
+      // the body of a loop may be propagated several times
+      result_.sizes.erase(node->output());
+      if (auto shape = shapeOf(node->input(0))) {
+        if (auto d = constantDim(node->input(1), shape->size())) {
+          result_.sizes.emplace(node->output(), (*shape)[*d]);
+        }
+      }
+      return true;
+    }
+
+    if (node->outputs().size() != 1 ||
+        !node->output()->type()->isSubtypeOf(TensorType::get())) {
+      return false;
+    }
+    Value* output = node->output();
+
+    if (shape_preserving_ops.find(node)) {
+      setShape(output, shapeOf(node->input(0)));
+      return true;
+    }
+
+    if (broadcasting_ops.find(node)) {
+      c10::optional<SymbolicShape> shape = SymbolicShape{};
+      for (Value* input : node->inputs()) {
+        if (!input->type()->isSubtypeOf(TensorType::get())) {
+          continue;
+        }
+        auto input_shape = shapeOf(input);
+        if (!input_shape) {
+          return false;
+        }
+        shape = broadcast(*shape, *input_shape);
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (size_factories.find(node)) {
+      auto sizes = sizesOfList(node->input(0));
+      if (!sizes) {
+        return false;
+      }
+      SymbolicShape shape;
+      for (const auto& size : *sizes) {
+        shape.push_back(size ? *size : newSymbol());
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::cat(Tensor[] tensors, int dim) -> Tensor")) {
+      Node* list = node->input(0)->node();
+      if (list->kind() != prim::ListConstruct || list->inputs().empty()) {
+        return false;
+      }
+      c10::optional<SymbolicShape> shape;
+      c10::optional<int64_t> d;
+      std::vector<ShapeSymbol> cat_sizes;
+      for (Value* input : list->inputs()) {
+        auto input_shape = shapeOf(input);
+        if (!input_shape) {
+          return false;
+        }
+        if (!shape) {
+          shape = input_shape;
+          d = constantDim(node->input(1), shape->size());
+          if (!d) {
+            return false;
+          }
+        } else if (input_shape->size() != shape->size()) {
+          return false;
+        }
+        for (size_t i = 0; i < shape->size(); ++i) {
+          // all the other dimensions are the same, so keep the static ones
+          if (static_cast<int64_t>(i) != *d && (*input_shape)[i].isStatic()) {
+            (*shape)[i] = (*input_shape)[i];
+          }
+        }
+        cat_sizes.push_back((*input_shape)[*d]);
+      }
+      (*shape)[*d] = cat_sizes.size() == 1 ? cat_sizes[0] : sum(cat_sizes);
+      setShape(output, shape);
+      return true;
+    }
+
+    // Everything below needs the shape of the first input
+    auto self = shapeOf(node->input(0));
+    if (!self) {
+      return false;
+    }
+    const size_t rank = self->size();
+
+    if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor") ||
+        node->matches("aten::bmm(Tensor self, Tensor mat2) -> Tensor") ||
+        node->matches("aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+      auto other = shapeOf(node->input(1));
+      if (!other) {
+        return false;
+      }
+      auto shape = matmul(*self, *other);
+      if (!shape) {
+        return false;
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      auto weight = shapeOf(node->input(1));
+      if (rank == 0 || !weight || weight->size() != 2) {
+        return false;
+      }
+      SymbolicShape shape(self->begin(), self->end() - 1);
+      shape.push_back((*weight)[0]);
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+      auto mat1 = shapeOf(node->input(1));
+      auto mat2 = shapeOf(node->input(2));
+      if (!mat1 || !mat2 || mat1->size() != 2 || mat2->size() != 2) {
+        return false;
+      }
+      setShape(output, SymbolicShape{(*mat1)[0], (*mat2)[1]});
+      return true;
+    }
+
+    if (node->matches("aten::view(Tensor self, int[] size) -> Tensor") ||
+        node->matches("aten::reshape(Tensor self, int[] shape) -> Tensor")) {
+      auto sizes = sizesOfList(node->input(1));
+      if (!sizes ||
+          std::count(sizes->begin(), sizes->end(), c10::nullopt) > 1) {
+        return false;
+      }
+      SymbolicShape shape;
+      for (const auto& size : *sizes) {
+        shape.push_back(size ? *size : inferViewDim(*self, *sizes));
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::expand(Tensor self, int[] size, *, bool implicit) -> Tensor")) {
+      auto sizes = sizesOfList(node->input(1));
+      if (!sizes || sizes->size() < rank) {
+        return false;
+      }
+      SymbolicShape shape;
+      const size_t new_dims = sizes->size() - rank;
+      for (size_t i = 0; i < sizes->size(); ++i) {
+        const auto& size = (*sizes)[i];
+        if (size) {
+          shape.push_back(*size);
+        } else if (i >= new_dims) {
+          shape.push_back((*self)[i - new_dims]);
+        } else {
+          return false;
+        }
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor")) {
+      auto start = constant_as<int64_t>(node->input(1));
+      auto end = constant_as<int64_t>(node->input(2));
+      if (!start || !end) {
+        return false;
+      }
+      if (rank == 0) {
+        setShape(output, SymbolicShape{ShapeSymbol::fromStaticSize(1)});
+        return true;
+      }
+      auto s = wrapDim(*start, rank);
+      auto e = wrapDim(*end, rank);
+      if (!s || !e || *s > *e) {
+        return false;
+      }
+      SymbolicShape shape(self->begin(), self->begin() + *s);
+      shape.push_back(product(self->begin() + *s, self->begin() + *e + 1));
+      shape.insert(shape.end(), self->begin() + *e + 1, self->end());
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::t(Tensor self) -> Tensor")) {
+      SymbolicShape shape(*self);
+      std::reverse(shape.begin(), shape.end());
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::transpose(Tensor self, int dim0, int dim1) -> Tensor")) {
+      auto d0 = constantDim(node->input(1), rank);
+      auto d1 = constantDim(node->input(2), rank);
+      if (!d0 || !d1) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      std::swap(shape[*d0], shape[*d1]);
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::permute(Tensor self, int[] dims) -> Tensor")) {
+      auto dims = constant_as<std::vector<int64_t>>(node->input(1));
+      if (!dims || dims->size() != rank) {
+        return false;
+      }
+      SymbolicShape shape;
+      for (int64_t dim : *dims) {
+        auto d = wrapDim(dim, rank);
+        if (!d) {
+          return false;
+        }
+        shape.push_back((*self)[*d]);
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::unsqueeze(Tensor self, int dim) -> Tensor")) {
+      auto d = constantDim(node->input(1), rank + 1);
+      if (!d) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      shape.insert(shape.begin() + *d, ShapeSymbol::fromStaticSize(1));
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::squeeze(Tensor self, int dim) -> Tensor")) {
+      auto d = constantDim(node->input(1), rank);
+      if (!d) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      if (rank > 0) {
+        ShapeSymbol size = shape[*d];
+        if (!size.isStatic()) {
+          return false;
+        } else if (size.staticSize() == 1) {
+          shape.erase(shape.begin() + *d);
+        }
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches("aten::select(Tensor self, int dim, int index) -> Tensor")) {
+      auto d = constantDim(node->input(1), rank);
+      if (!d) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      shape.erase(shape.begin() + *d);
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::narrow(Tensor self, int dim, int start, int length) -> Tensor")) {
+      auto d = constantDim(node->input(1), rank);
+      if (!d) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      shape[*d] = sizeOf(node->input(3));
+      setShape(output, shape);
+      return true;
+    }
+
+    if (node->matches(
+            "aten::slice(Tensor self, int dim, int start, int end, int step) -> Tensor")) {
+      auto d = constantDim(node->input(1), rank);
+      if (!d) {
+        return false;
+      }
+      SymbolicShape shape(*self);
+      auto start = constant_as<int64_t>(node->input(2));
+      auto end = constant_as<int64_t>(node->input(3));
+      auto step = constant_as<int64_t>(node->input(4));
+      const bool whole = start && *start == 0 && end &&
+          *end == std::numeric_limits<int64_t>::max() && step && *step == 1;
+      if (!whole) {
+        shape[*d] = newSymbol();
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    if (dim_reduce_ops.find(node)) {
+      auto dims = constant_as<std::vector<int64_t>>(node->input(1));
+      auto keepdim = constant_as<bool>(node->input(2));
+      if (!dims || !keepdim) {
+        return false;
+      }
+      std::vector<bool> reduced(rank, false);
+      for (int64_t dim : *dims) {
+        auto d = wrapDim(dim, rank);
+        if (!d) {
+          return false;
+        }
+        reduced[*d] = true;
+      }
+      SymbolicShape shape;
+      for (size_t i = 0; i < rank; ++i) {
+        if (!reduced[i]) {
+          shape.push_back((*self)[i]);
+        } else if (*keepdim) {
+          shape.push_back(ShapeSymbol::fromStaticSize(1));
+        }
+      }
+      setShape(output, shape);
+      return true;
+    }
+
+    return false;
+  }
+
+  std::shared_ptr<Graph> graph_;
+  SymbolicShapes result_;
+  int64_t next_symbol_ = -1;
+  // symbols of the carried dimensions that vary across iterations
+  std::unordered_set<int64_t> fresh_loop_symbols_;
+};
+
+} // namespace
+
+SymbolicShapes PropagateSymbolicShapes(
+    const std::shared_ptr<Graph>& graph,
+    const std::vector<c10::optional<SymbolicShape>>& input_shapes) {
+  return SymbolicShapePropagator(graph).run(input_shapes);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// A dimension of a tensor: either a static size, or a symbol that stands for
+// a size that is only known at runtime (e.g. the batch size B, or the
+// sequence length S). All the dimensions with the same symbol are known to be
+// equal, even though their size isn't known.
+//
+// Static sizes are stored as non-negative values and symbols as negative
+// ones, so that shapes can be passed around as lists of ints.
+struct TORCH_API ShapeSymbol {
+  static ShapeSymbol fromStaticSize(int64_t size) {
+    AT_ASSERT(size >= 0);
+    return ShapeSymbol(size);
+  }
+  static ShapeSymbol fromValue(int64_t value) {
+    return ShapeSymbol(value);
+  }
+
+  bool isStatic() const {
+    return value_ >= 0;
+  }
+  int64_t staticSize() const {
+    AT_ASSERT(isStatic());
+    return value_;
+  }
+  int64_t value() const {
+    return value_;
+  }
+
+  bool operator==(const ShapeSymbol& other) const {
+    return value_ == other.value_;
+  }
+  bool operator!=(const ShapeSymbol& other) const {
+    return value_ != other.value_;
+  }
+
+ private:
+  explicit ShapeSymbol(int64_t value) : value_(value) {}
+  int64_t value_;
+};
+
+using SymbolicShape = std::vector<ShapeSymbol>;
+
+struct TORCH_API SymbolicShapes {
+  // The shape of a tensor value, or nullptr if its rank isn't known
+  const SymbolicShape* shapeOf(const Value* v) const {
+    auto it = shapes.find(v);
+    return it == shapes.end() ? nullptr : &it->second;
+  }
+  // The dimension an int value is known to be the size of, e.g. for
+  // `x.size(0)`
+  c10::optional<ShapeSymbol> sizeOf(const Value* v) const {
+    auto it = sizes.find(v);
+    if (it == sizes.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  std::unordered_map<const Value*, SymbolicShape> shapes;
+  std::unordered_map<const Value*, ShapeSymbol> sizes;
+};
+
+// Propagates symbolic shapes through the graph, starting from input_shapes,
+// which has an entry for each graph input (nullopt for non-tensors, or
+// tensors of unknown rank). If input_shapes is empty, they are taken from the
+// types of the inputs: the sizes of a CompleteTensorType, or a new symbol for
+// each dimension of a DimensionedTensorType.
+//
+// Broadcasting, matrix multiplications, views, reshapes, concatenations and
+// reductions propagate symbols, so that e.g. `x.view(x.size(0), -1)` of a
+// (B, 3, 4) tensor is known to be (B, 12). Other ops get new symbols for
+// every dimension of their DimensionedTensorType outputs, and the outputs of
+// control flow get new symbols where their branches or iterations disagree.
+//
+// Unlike PropagateInputShapes, this is an analysis: the graph isn't changed,
+// so passes like fusion and memory planning can use it to specialize on the
+// rank and the relative sizes of tensors without a graph per input shape.
+TORCH_API SymbolicShapes PropagateSymbolicShapes(
+    const std::shared_ptr<Graph>& graph,
+    const std::vector<c10::optional<SymbolicShape>>& input_shapes = {});
+
+} // namespace jit
+} // namespace torch
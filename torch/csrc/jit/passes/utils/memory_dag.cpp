@@ -18,14 +18,13 @@ bool MemoryDAG::mayAlias(const Element* a, const Element* b) const {
 bool MemoryDAG::memoryLocationOverlap(
     const std::unordered_set<const Element*>& aMemLoc,
     const std::unordered_set<const Element*>& bMemLoc) const {
-  // XXX: This could be more efficiently done as a bitwise AND on two bitfields
-  // that represent memory location membership. If these comparisons end up
-  // being a bottleneck, consider implementing it that way.
-  for (const auto aLoc : aMemLoc) {
-    for (const auto bLoc : bMemLoc) {
-      if (aLoc == bLoc) {
-        return true;
-      }
+  // Probe the larger set with the elements of the smaller one, so that this is
+  // linear in the size of the smaller set instead of quadratic.
+  const auto& smaller = aMemLoc.size() <= bMemLoc.size() ? aMemLoc : bMemLoc;
+  const auto& larger = aMemLoc.size() <= bMemLoc.size() ? bMemLoc : aMemLoc;
+  for (const auto loc : smaller) {
+    if (larger.count(loc)) {
+      return true;
     }
   }
 
@@ -33,8 +32,8 @@ bool MemoryDAG::memoryLocationOverlap(
 }
 
 bool MemoryDAG::mayAliasImpl(const Element* a, const Element* b) const {
-  const auto aMemLoc = a->getMemoryLocations();
-  const auto bMemLoc = b->getMemoryLocations();
+  const auto& aMemLoc = a->getMemoryLocations();
+  const auto& bMemLoc = b->getMemoryLocations();
 
   return memoryLocationOverlap(aMemLoc, bMemLoc);
 }
@@ -98,8 +97,17 @@ bool MemoryDAG::mayContainAlias(
 
 // Make `v` point at `to`.
 void MemoryDAG::makePointerTo(Element* from, Element* to) {
-  from->pointsTo.insert(to);
+  if (!from->pointsTo.insert(to).second) {
+    return;
+  }
   to->pointedFrom.insert(from);
+
+  // The memory locations of `from` and of every element that may point to it
+  // have changed. While the graph is being analyzed, `from` is usually a fresh
+  // value that nothing points to yet, so this is cheap.
+  from->bfs(
+      [](const Element* el) { el->cachedMemoryLocations_.clear(); },
+      BfsDirection::POINTED_FROM);
 }
 
 void MemoryDAG::addToContainedElements(Element* elem, Element* container) {
@@ -116,23 +124,22 @@ Element* MemoryDAG::makeFreshValue(const Value* v) {
   return rawPtr;
 }
 
-std::unordered_set<const Element*> Element::getMemoryLocations() const {
+const std::unordered_set<const Element*>& Element::getMemoryLocations()
+    const {
   if (!cachedMemoryLocations_.empty()) {
     return cachedMemoryLocations_;
   }
 
   // Do a BFS in the `points-to` direction, collecting all memory locations
-  std::unordered_set<const Element*> ret;
   this->bfs(
       [&](const Element* el) {
         if (el->pointsTo.empty()) {
-          ret.insert(el);
+          cachedMemoryLocations_.insert(el);
         }
       },
       BfsDirection::POINTS_TO);
 
-  cachedMemoryLocations_ = ret;
-  return ret;
+  return cachedMemoryLocations_;
 }
 
 // Do a breadth-first search over the graph, starting at `this` and
@@ -143,17 +150,17 @@ bool Element::bfs(Fn fn, BfsDirection dir) const {
   std::unordered_set<const Element*> seen;
 
   queue.push(this);
+  seen.insert(this);
   while (!queue.empty()) {
     const auto el = queue.front();
     queue.pop();
-    seen.insert(el);
 
     fn(el);
 
     switch (dir) {
       case BfsDirection::POINTS_TO: {
         for (auto ptr : el->pointsTo) {
-          if (!seen.count(ptr)) {
+          if (seen.insert(ptr).second) {
             queue.push(ptr);
           }
         }
@@ -161,7 +168,7 @@ bool Element::bfs(Fn fn, BfsDirection dir) const {
 
       case BfsDirection::POINTED_FROM: {
         for (auto ptr : el->pointedFrom) {
-          if (!seen.count(ptr)) {
+          if (seen.insert(ptr).second) {
             queue.push(ptr);
           }
         }
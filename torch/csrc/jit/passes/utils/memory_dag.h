@@ -39,6 +39,11 @@ class TORCH_API MemoryDAG {
   MemoryDAG& operator=(const MemoryDAG&)=delete;
 
   // Make `from` point at `to`.
+  //
+  // This may be called after memory locations have been queried (e.g. when a
+  // pass keeps its AliasDb up to date while mutating the graph), so it
+  // invalidates the cached memory locations of `from` and of everything that
+  // points to it.
   void makePointerTo(Element* from, Element* to);
 
   void addToContainedElements(Element* contained, Element* container);
@@ -133,7 +138,11 @@ struct Element {
   std::unordered_set<Element*> contained_elements;
 
   // Return the unique memory locations that `Element` might represent.
-  TORCH_API std::unordered_set<const Element*> getMemoryLocations() const;
+  //
+  // The returned set is owned by the element, and stays valid until the
+  // points-to graph reachable from it changes.
+  TORCH_API const std::unordered_set<const Element*>& getMemoryLocations()
+      const;
   // We do path compression to make repeated memory location queries faster.
   // An empty cache means it is invalidated (it can never be empty otherwise,
   // since every element must point to at least one memory location).
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/pickler.h>
 #include <ATen/ATen.h>
+#include <iterator>
 #include <string>
 #include <ATen/core/Dict.h>
 
@@ -162,15 +163,11 @@ void Pickler::addIValue(const IValue& ivalue) {
   } else if (ivalue.isTuple()) {
     pushTuple(ivalue);
   } else if (ivalue.isDouble()) {
-    pushDouble(ivalue);
+    pushDouble(ivalue.toDouble());
   } else if (ivalue.isInt()) {
-    pushInt(ivalue);
+    pushInt(ivalue.toInt());
   } else if (ivalue.isBool()) {
-    if (ivalue.toBool()) {
-      push<OpCode>(OpCode::NEWTRUE);
-    } else {
-      push<OpCode>(OpCode::NEWFALSE);
-    }
+    pushBool(ivalue.toBool());
   } else if (ivalue.isString()) {
     pushMemoizedString(ivalue);
   } else if (ivalue.isGenericList()) {
@@ -180,10 +177,12 @@ void Pickler::addIValue(const IValue& ivalue) {
   } else if (ivalue.isNone()) {
     push<OpCode>(OpCode::NONE);
   } else if (ivalue.isIntList()) {
+    // The items of specialized lists are pushed directly instead of going
+    // through addIValue, since they can't be memoized
     pushSpecializedList(
         ivalue, PicklerClass::INTLIST, [=](const IValue& ivalue) {
-          for (const auto& item : ivalue.toIntListRef()) {
-            addIValue(item);
+          for (int64_t item : ivalue.toIntListRef()) {
+            pushInt(item);
           }
         });
   } else if (ivalue.isTensorList()) {
@@ -196,15 +195,15 @@ void Pickler::addIValue(const IValue& ivalue) {
   } else if (ivalue.isDoubleList()) {
     pushSpecializedList(
         ivalue, PicklerClass::DOUBLELIST, [=](const IValue& ivalue) {
-          for (const auto& item : ivalue.toDoubleListRef()) {
-            addIValue(item);
+          for (double item : ivalue.toDoubleListRef()) {
+            pushDouble(item);
           }
         });
   } else if (ivalue.isBoolList()) {
     pushSpecializedList(
         ivalue, PicklerClass::BOOLLIST, [=](const IValue& ivalue) {
-          for (const auto& item : ivalue.toBoolListRef()) {
-            addIValue(bool(item));
+          for (bool item : ivalue.toBoolListRef()) {
+            pushBool(item);
           }
         });
   } else {
@@ -213,16 +212,14 @@ void Pickler::addIValue(const IValue& ivalue) {
 }
 
 /// Returns a void* uniquely identifying this IValue's data. For non-containers,
-/// returns nullptr. Also adds the ivalue to the Pickler's list of memoized
-/// IValues so the pointers are guaranteed to be valid for the Pickler's
-/// lifetime.
+/// returns nullptr. Tuples aren't memoized either: they are immutable, so
+/// sharing them can't be observed, and skipping them saves a memo lookup and
+/// a BINPUT for each one. Strings are, since repeating them costs space.
 const void* Pickler::getPointer(const IValue& ivalue) {
   if (ivalue.isGenericDict()) {
     return ivalue.toGenericDict().get();
   } else if (ivalue.isGenericList()) {
     return ivalue.toGenericList().get();
-  } else if (ivalue.isTuple()) {
-    return ivalue.toTuple().get();
   } else if (ivalue.isString()) {
     return ivalue.toString().get();
   } else if (ivalue.isIntList()) {
@@ -238,8 +235,11 @@ const void* Pickler::getPointer(const IValue& ivalue) {
   return nullptr;
 }
 
-void Pickler::pushInt(const IValue& ivalue) {
-  auto n = ivalue.toInt();
+void Pickler::pushBool(bool value) {
+  push<OpCode>(value ? OpCode::NEWTRUE : OpCode::NEWFALSE);
+}
+
+void Pickler::pushInt(int64_t n) {
   if (n >= std::numeric_limits<int8_t>::min() &&
       n <= std::numeric_limits<int8_t>::max()) {
     push<OpCode>(OpCode::BININT1);
@@ -269,12 +269,14 @@ void Pickler::pushBinGet(uint32_t memo_id) {
 }
 
 void Pickler::pushMemoizedString(const IValue& ivalue) {
-  const auto& string = ivalue.toStringRef();
+  pushUnicode(ivalue.toStringRef());
+  pushMemoization(ivalue);
+}
 
+void Pickler::pushUnicode(const std::string& string) {
   push<OpCode>(OpCode::BINUNICODE);
   push<uint32_t>(string.size());
   pushString(string);
-  pushMemoization(ivalue);
 }
 
 void Pickler::pushString(const std::string& string) {
@@ -321,15 +323,15 @@ void Pickler::pushLiteralTensor(const IValue& ivalue) {
   // Tuple for persistent_load
   push<OpCode>(OpCode::MARK);
   // typename
-  pushMemoizedString(std::string("storage"));
+  pushUnicode("storage");
   // data_type
   std::stringstream data_type;
   data_type << "torch\n" << toString(tensor.scalar_type()) << "Storage\n";
   pushGlobal(data_type.str());
   // root_key
-  pushMemoizedString(std::to_string(getStorageKey(tensor)));
+  pushUnicode(std::to_string(getStorageKey(tensor)));
   // location
-  pushMemoizedString(std::string("cpu"));
+  pushUnicode("cpu");
   // size
   pushInt(tensor.numel());
   // view_metadata
@@ -356,7 +358,7 @@ void Pickler::pushLiteralTensor(const IValue& ivalue) {
   push<OpCode>(OpCode::TUPLE);
 
   // requires_grad
-  addIValue(tensor.requires_grad());
+  pushBool(tensor.requires_grad());
 
   // backward_hooks
   pushGlobal("collections\nOrderedDict\n");
@@ -384,7 +386,7 @@ void Pickler::pushTensorReference(const IValue& ivalue) {
   // Reduce arguments are spread (e.g. `*args`) before calling the global,
   // so wrap in a tuple
   push<OpCode>(OpCode::MARK);
-  addIValue(tensor_id);
+  pushInt(tensor_id);
   push<OpCode>(OpCode::TUPLE);
 
   push<OpCode>(OpCode::REDUCE);
@@ -418,15 +420,16 @@ void Pickler::pushSpecializedList(
   pushMemoization(ivalue);
 }
 
-void Pickler::pushDouble(const IValue& ivalue) {
-  double value = ivalue.toDouble();
+void Pickler::pushDouble(double value) {
   AT_ASSERT(sizeof(double) == 8);
   char* bytes = reinterpret_cast<char*>(&value);
 
   push<OpCode>(OpCode::BINFLOAT);
-  for (size_t i = 0; i < 8; ++i) {
-    push<uint8_t>(bytes[8 - i - 1]);
-  }
+  // Pickle floats are big endian, so reverse the bytes
+  stack_.insert(
+      stack_.end(),
+      std::reverse_iterator<char*>(bytes + 8),
+      std::reverse_iterator<char*>(bytes));
 }
 
 void Pickler::pushDict(const IValue& ivalue) {
@@ -500,7 +503,6 @@ void Pickler::pushTuple(const IValue& ivalue) {
   }
 
   push<OpCode>(OpCode::TUPLE);
-  pushMemoization(ivalue);
 }
 
 std::vector<IValue> Unpickler::parse_ivalue_list() {
@@ -676,6 +678,8 @@ OpCode Unpickler::readInstruction() {
       size_t start = marks_.back();
       marks_.pop_back();
       auto dict = stack_.at(start - 1).ivalue().toGenericDict();
+      dict->elements().reserve(
+          dict->elements().size() + (stack_.size() - start) / 2);
       for (size_t i = start; i < stack_.size(); i += 2) {
         dict->elements().insert_or_assign(stack_[i].ivalue(), stack_[i + 1].ivalue());
       }
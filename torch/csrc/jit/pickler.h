@@ -126,10 +126,11 @@ class Pickler {
   void endTuple();
 
  private:
+  void pushBool(bool value);
   void pushDict(const IValue& ivalue);
-  void pushDouble(const IValue& ivalue);
+  void pushDouble(double value);
   void pushGenericList(const IValue& ivalue);
-  void pushInt(const IValue& ivalue);
+  void pushInt(int64_t value);
   void pushIntList(const IValue& ivalue);
   void pushList(const IValue& ivalue);
   void pushLiteralTensor(const IValue& ivalue);
@@ -148,6 +149,8 @@ class Pickler {
   void pushGlobal(const std::string& name);
   void pushMemoization(const void* item);
   void pushString(const std::string& string);
+  // Push a BINUNICODE string
+  void pushUnicode(const std::string& string);
   void pushTensorData(const at::Tensor& tensor);
 
   // Add a BINPUT op and return the memoization id used
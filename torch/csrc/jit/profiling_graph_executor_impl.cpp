@@ -1,5 +1,7 @@
 #include <torch/csrc/jit/profiling_graph_executor_impl.h>
 
+#include <torch/csrc/jit/passes/insert_guards.h>
+
 namespace torch {
 namespace jit {
 
@@ -8,6 +10,49 @@ bool& getProfilingMode() {
   return profiling_mode;
 }
 
+namespace {
+
+// The complete type a profiled tensor can be specialized to, or nullptr if
+// one of its properties varied between the profiled runs.
+CompleteTensorTypePtr toCompleteType(const ProfiledTensorTypePtr& type) {
+  auto sizes = type->sizes().concrete_sizes();
+  auto strides = type->strides().concrete_sizes();
+  if (!type->scalarType() || !type->device() || !type->requiresGrad() ||
+      !sizes || !strides) {
+    return nullptr;
+  }
+  return CompleteTensorType::create(
+      *type->scalarType(),
+      *type->device(),
+      at::IntArrayRef(*sizes),
+      at::IntArrayRef(*strides),
+      *type->requiresGrad());
+}
+
+// Removes the guards inserted by InsertGuards, merging the profiled types of
+// the graph inputs they guard into `profiled`.
+void removeGuards(Block* b, std::vector<ProfiledTensorTypePtr>& profiled) {
+  for (auto it = b->nodes().begin(); it != b->nodes().end(); it++) {
+    auto n = *it;
+    if (n->kind() == prim::Guard) {
+      Value* input = n->input();
+      if (input->node()->kind() == prim::Param) {
+        auto type = n->output()->type()->expect<ProfiledTensorType>();
+        auto& merged = profiled.at(input->offset());
+        merged = merged ? merged->merge(type) : type;
+      }
+      n->output()->replaceAllUsesWith(input);
+      it.destroyCurrent();
+    } else {
+      for (Block* ib : n->blocks()) {
+        removeGuards(ib, profiled);
+      }
+    }
+  }
+}
+
+} // namespace
+
 void ProfilingGraphExecutorImpl::run(Stack& stack) {
   TORCH_CHECK(
       stack.size() >= num_inputs,
@@ -16,22 +61,94 @@ void ProfilingGraphExecutorImpl::run(Stack& stack) {
       " inputs, but got only ",
       stack.size());
 
-  {
-    std::lock_guard<std::mutex> lock(compile_mutex);
-    if (!pr_) {
-      auto g = graph->copy();
-      runRequiredPasses(g);
-      pr_ = ProfilingRecord::instrumentGraph(g);
-      exec_plan_ = caffe2::make_unique<ExecutionPlan>(pr_->profiled_graph_);
+  if (!optimized_ready_.load(std::memory_order_acquire)) {
+    {
+      std::lock_guard<std::mutex> lock(compile_mutex);
+      if (!pr_ && optimize) {
+        auto g = graph->copy();
+        runRequiredPasses(g);
+        pr_ = ProfilingRecord::instrumentGraph(g);
+        exec_plan_ = caffe2::make_unique<ExecutionPlan>(pr_->profiled_graph_);
+      }
+      if (!optimized_ready_) {
+        bool profiling_done = true;
+        if (pr_) {
+          std::lock_guard<std::mutex> pr_lock(pr_->mutex_);
+          profiling_done = pr_->profiling_count_ == 0;
+        }
+        if (profiling_done) {
+          compileOptimizedPlans();
+          optimized_ready_.store(true, std::memory_order_release);
+        }
+      }
+    }
+    if (!optimized_ready_.load(std::memory_order_acquire)) {
+      exec_plan_->run(stack);
+      return;
     }
   }
 
-  if (pr_->profiling_count_ > 0) {
-    exec_plan_->run(stack);
+  if (optimized_plan_ && grad_enabled_ == autograd::GradMode::is_enabled() &&
+      inputsMatchGuards(stack)) {
+    optimized_plan_->run(stack);
   } else {
-    AT_ERROR("Not yet implemented");
+    fallback_plan_->run(stack);
+  }
+}
+
+void ProfilingGraphExecutorImpl::compileOptimizedPlans() {
+  auto fallback_graph = graph->copy();
+  runRequiredPasses(fallback_graph);
+  fallback_plan_ = caffe2::make_unique<ExecutionPlan>(fallback_graph);
+  if (!pr_) {
+    return;
+  }
+
+  std::shared_ptr<Graph> opt_graph;
+  {
+    // other threads may still be recording into the profiled graph
+    std::lock_guard<std::mutex> pr_lock(pr_->mutex_);
+    opt_graph = pr_->profiled_graph_->copy();
+  }
+  InsertGuards(opt_graph);
+  std::vector<ProfiledTensorTypePtr> profiled(opt_graph->inputs().size());
+  removeGuards(opt_graph->block(), profiled);
+  input_guards_.resize(profiled.size());
+  for (size_t i = 0; i < profiled.size(); ++i) {
+    if (profiled[i]) {
+      input_guards_[i] = toCompleteType(profiled[i]);
+    }
+    if (input_guards_[i]) {
+      opt_graph->inputs()[i]->setType(input_guards_[i]);
+    }
+  }
+  // the profiling nodes are gone, but the graph has already been through
+  // runRequiredPasses before it was instrumented
+  runSpecializedOptimizations(opt_graph);
+  grad_enabled_ = autograd::GradMode::is_enabled();
+  optimized_plan_ = caffe2::make_unique<ExecutionPlan>(opt_graph);
+}
+
+bool ProfilingGraphExecutorImpl::inputsMatchGuards(const Stack& stack) const {
+  auto inputs = last(stack, num_inputs);
+  for (size_t i = 0; i < num_inputs; ++i) {
+    const auto& guard = input_guards_[i];
+    if (!guard) {
+      continue;
+    }
+    if (!inputs[i].isTensor()) {
+      return false;
+    }
+    const at::Tensor& t = inputs[i].toTensor();
+    if (!t.defined() || t.scalar_type() != guard->scalarType() ||
+        t.device() != guard->device() ||
+        t.requires_grad() != guard->requires_grad() ||
+        !t.sizes().equals(guard->sizes()) ||
+        !t.strides().equals(guard->strides())) {
+      return false;
+    }
   }
-  return;
+  return true;
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
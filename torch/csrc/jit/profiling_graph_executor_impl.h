@@ -4,6 +4,23 @@
 namespace torch {
 namespace jit {
 
+// Note [Profiling executor]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~
+// The first runs of the graph are profiled, recording the types of all
+// tensors the graph uses. Once profiling is done, two plans are compiled:
+//
+// - an optimized plan, whose tensor inputs are specialized to the complete
+//   types (sizes, strides, dtype, device and requires_grad) that were
+//   observed, so that shape propagation, fusion and autodiff see the same
+//   information as with an ArgumentSpec that includes sizes.
+// - a fallback plan, which makes no assumptions about its inputs.
+//
+// The optimized plan is guarded on the profiled types of its inputs: every
+// run checks them, and runs the fallback if any of them doesn't match. The
+// interpreter has no way to bail out in the middle of a plan, so the guards
+// on intermediate values are dropped and their types are derived from the
+// inputs by shape propagation. Inputs whose properties varied between the
+// profiled runs are neither specialized nor guarded.
 struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   using GraphExecutorImplBase::GraphExecutorImplBase;
 
@@ -12,8 +29,21 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ~ProfilingGraphExecutorImpl() override = default;
 
  private:
+  void compileOptimizedPlans();
+  bool inputsMatchGuards(const Stack& stack) const;
+
   std::unique_ptr<ProfilingRecord> pr_;
   std::unique_ptr<ExecutionPlan> exec_plan_;
+
+  // Populated once profiling is done, see Note [Profiling executor]
+  std::unique_ptr<ExecutionPlan> optimized_plan_;
+  std::unique_ptr<ExecutionPlan> fallback_plan_;
+  // The type every input of optimized_plan_ is specialized to, or nullptr
+  // for inputs that aren't guarded.
+  std::vector<CompleteTensorTypePtr> input_guards_;
+  // optimized_plan_ is only valid in the grad mode it was compiled in
+  bool grad_enabled_ = false;
+  std::atomic<bool> optimized_ready_{false};
 };
 
 } // namespace jit
@@ -244,7 +244,7 @@ void initPythonIRBindings(PyObject* module_) {
             std::unordered_map<std::string, py::bytes>
                 python_serialized_export_map;
             for (auto& kv : export_map) {
-              auto t = kv.second;
+              auto t = kv.second.contiguous().cpu();
               size_t copy_bytes = t.element_size() * t.numel();
               // TODO: this is an unecessary copy. In theory we can directly
               // return the map from identifier to Tensor, but we need some API
@@ -261,6 +261,30 @@ void initPythonIRBindings(PyObject* module_) {
           py::arg("operator_export_type") =
               ::torch::onnx::OperatorExportTypes::ONNX,
           py::arg("strip_doc_string") = true)
+      .def(
+          "_export_onnx_to_directory",
+          [](const std::shared_ptr<Graph> g,
+             const std::map<std::string, at::Tensor>& initializers,
+             int64_t onnx_opset_version,
+             const std::string& directory,
+             ::torch::onnx::OperatorExportTypes operator_export_type,
+             bool strip_doc_string) {
+            // writing the files doesn't touch Python objects
+            AutoNoGIL no_gil;
+            export_onnx_to_directory(
+                g,
+                initializers,
+                onnx_opset_version,
+                directory,
+                operator_export_type,
+                strip_doc_string);
+          },
+          py::arg("initializers"),
+          py::arg("onnx_opset_version"),
+          py::arg("directory"),
+          py::arg("operator_export_type") =
+              ::torch::onnx::OperatorExportTypes::ONNX,
+          py::arg("strip_doc_string") = true)
       .def(
           "_pretty_print_onnx",
           [](const std::shared_ptr<Graph> g,
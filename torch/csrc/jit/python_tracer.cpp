@@ -140,7 +140,9 @@ void initPythonTracerBindings(PyObject* module) {
       .def(
           "set_graph",
           [](TracingState& s, std::shared_ptr<Graph> g) { s.graph = g; })
-      .def("graph", [](TracingState& s) { return s.graph; });
+      .def("graph", [](TracingState& s) { return s.graph; })
+      .def_readwrite(
+          "record_source_locations", &TracingState::record_source_locations);
 
   m.def("_tracer_warn_use_python", []() { tracer::setWarn(pythonWarn); });
   m.def("_tracer_enter", [](py::args trace_inputs) {
@@ -160,6 +162,27 @@ void initPythonTracerBindings(PyObject* module) {
   m.def("_set_value_trace", [](const Variable& var, Value* value) {
     return setValueTrace(var, value);
   });
+  m.def("_tracer_last_node", []() {
+    auto& graph = getTracingState()->graph;
+    return graph->block()->return_node()->prev();
+  });
+  m.def("_tracer_find_value_traces", [](const variable_list& vars) {
+    return findValueTraces(vars);
+  });
+  m.def(
+      "_tracer_extract_trace",
+      [](Node* begin,
+         const std::vector<Value*>& inputs,
+         const variable_list& outputs) {
+        return extractTrace(begin, inputs, outputs);
+      });
+  m.def(
+      "_tracer_replay_trace",
+      [](std::shared_ptr<Graph> trace,
+         const std::vector<Value*>& inputs,
+         const variable_list& outputs) {
+        replayTrace(*trace, inputs, outputs);
+      });
   m.def("_tracer_set_get_unique_name_fn", [](py::function func) {
     const auto& tracing_state = getTracingState();
     AT_ASSERT(tracing_state);
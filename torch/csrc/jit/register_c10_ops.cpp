@@ -39,7 +39,7 @@ IValue unwrap(IValue&& ivalue) {
 }
 
 at::Tensor wrap_tensor(at::Tensor&& tensor) {
-  return torch::autograd::make_variable(tensor);
+  return torch::autograd::make_variable(std::move(tensor));
 }
 
 IValue wrap(IValue&& ivalue) {
@@ -84,6 +84,15 @@ Operation listConstruct(int64_t num_inputs) {
   };
 }
 
+// The interpreter moves a value off its register at its last use, so a list,
+// tuple or dict popped with a use count of 1 is referenced by nothing else:
+// ops can then take its elements or modify it in place instead of copying it,
+// and nobody can observe the difference.
+template <typename T>
+bool isUniquelyOwned(const c10::intrusive_ptr<T>& ptr) {
+  return ptr.unique();
+}
+
 static int64_t floordiv(int64_t a, int64_t b) {
   if (b == 0) {
     throw std::runtime_error("division by 0");
@@ -669,7 +678,7 @@ RegisterOperators reg(
            size_t num_elems = node->outputs().size();
            return [=](Stack& stack) {
              auto t = pop(stack).toTuple();
-             const auto& elems = t->elements();
+             auto& elems = t->elements();
              if (elems.size() != num_elems) {
                AT_ERROR(
                    "Expected a tuple of ",
@@ -677,7 +686,14 @@ RegisterOperators reg(
                    " elements, but got ",
                    elems.size());
              }
-             stack.insert(stack.end(), elems.begin(), elems.end());
+             if (isUniquelyOwned(t)) {
+               stack.insert(
+                   stack.end(),
+                   std::make_move_iterator(elems.begin()),
+                   std::make_move_iterator(elems.end()));
+             } else {
+               stack.insert(stack.end(), elems.begin(), elems.end());
+             }
              return 0;
            };
          }),
@@ -690,6 +706,7 @@ RegisterOperators reg(
              auto t = pop(stack).toTuple();
              const auto& elems = t->elements();
              std::vector<IValue> output_elems;
+             output_elems.reserve(std::max<int64_t>(end_ind - beg_ind, 0));
              for (int64_t i = beg_ind; i < end_ind; ++i) {
                output_elems.emplace_back(elems.at(i));
              }
@@ -703,13 +720,17 @@ RegisterOperators reg(
            return [](Stack& stack) {
              int64_t index = pop(stack).toInt();
              auto tup = pop(stack).toTuple();
-             const auto& elems = tup->elements();
+             auto& elems = tup->elements();
              auto norm_index = normalizeIndex(index, elems.size());
              if (norm_index < 0 ||
                  norm_index > static_cast<int64_t>(elems.size())) {
                throw std::out_of_range("Tuple list index out of range");
              }
-             stack.emplace_back(elems.at(norm_index));
+             if (isUniquelyOwned(tup)) {
+               stack.emplace_back(std::move(elems.at(norm_index)));
+             } else {
+               stack.emplace_back(elems.at(norm_index));
+             }
              return 0;
            };
          }),
@@ -803,28 +824,42 @@ RegisterOperators reg(
              };
            } else if (lt->getElementType() == TensorType::get()) {
              return [=](Stack& stack) {
-               auto ilist = pop(stack);
-               const auto& list = ilist.toTensorList()->elements();
+               auto ptr = pop(stack).toTensorList();
+               auto& list = ptr->elements();
                TORCH_CHECK(
                    list.size() == num_outputs,
                    "Expected ",
                    num_outputs,
                    " elements in a list but found ",
                    list.size());
-               stack.insert(stack.end(), list.begin(), list.end());
+               if (isUniquelyOwned(ptr)) {
+                 stack.insert(
+                     stack.end(),
+                     std::make_move_iterator(list.begin()),
+                     std::make_move_iterator(list.end()));
+               } else {
+                 stack.insert(stack.end(), list.begin(), list.end());
+               }
                return 0;
              };
            } else {
              return [=](Stack& stack) {
-               auto glist = pop(stack);
-               const auto& list = glist.toGenericList()->elements();
+               auto ptr = pop(stack).toGenericList();
+               auto& list = ptr->elements();
                TORCH_CHECK(
                    list.size() == num_outputs,
                    "Expected ",
                    num_outputs,
                    " elements in a list but found ",
                    list.size());
-               stack.insert(stack.end(), list.begin(), list.end());
+               if (isUniquelyOwned(ptr)) {
+                 stack.insert(
+                     stack.end(),
+                     std::make_move_iterator(list.begin()),
+                     std::make_move_iterator(list.end()));
+               } else {
+                 stack.insert(stack.end(), list.begin(), list.end());
+               }
                return 0;
              };
            }
@@ -876,6 +911,7 @@ RegisterOperators reg(
            }
            return [=](Stack& stack) {
              c10::impl::GenericDict vals;
+             vals.reserve(num_inputs / 2);
              for (size_t i = 0; i < num_inputs; i += 2) {
                auto val = pop(stack);
                auto key = pop(stack);
@@ -907,6 +943,7 @@ RegisterOperators reg(
            return [=](Stack& stack) {
              // Move inputs to a separate stack
              InterpreterState forked_interprester(code);
+             forked_interprester.useForkedStream(last(stack, n_inputs));
              InterpreterContinuation continuation(
                  forked_interprester,
                  Stack(stack.end() - n_inputs, stack.end()),
@@ -1115,8 +1152,8 @@ int listAppend(Stack& stack) {
   TElement el;
   pop(stack, a, el);
 
-  a->elements().push_back(el);
-  push(stack, a);
+  a->elements().push_back(std::move(el));
+  push(stack, std::move(a));
 
   return 0;
 }
@@ -1194,12 +1231,12 @@ int listInsert(Stack& stack) {
 
   if (normalized_idx < 0 || normalized_idx >= list_size) {
     if (normalized_idx < 0) {
-      elements.insert(elements.begin(), elem);
+      elements.insert(elements.begin(), std::move(elem));
     } else {
-      elements.push_back(elem);
+      elements.push_back(std::move(elem));
     }
   } else {
-    elements.insert(elements.begin() + normalized_idx, elem);
+    elements.insert(elements.begin() + normalized_idx, std::move(elem));
   }
 
   return 0;
@@ -1323,8 +1360,19 @@ Operation listExtend(const Node* node) {
     pop(stack, a, b);
 
     auto& vec_a = a->elements();
-    const auto& vec_b = b->elements();
-    vec_a.insert(vec_a.end(), vec_b.cbegin(), vec_b.cend());
+    auto& vec_b = b->elements();
+    if (a.get() == b.get()) {
+      // x.extend(x): vector::insert can't take a range of its own elements
+      auto copy = vec_b;
+      vec_a.insert(vec_a.end(), copy.begin(), copy.end());
+    } else if (isUniquelyOwned(b)) {
+      vec_a.insert(
+          vec_a.end(),
+          std::make_move_iterator(vec_b.begin()),
+          std::make_move_iterator(vec_b.end()));
+    } else {
+      vec_a.insert(vec_a.end(), vec_b.cbegin(), vec_b.cend());
+    }
     return 0;
   };
 }
@@ -1447,6 +1495,22 @@ int listAdd(Stack& stack) {
   TList b;
   pop(stack, a, b);
 
+  if (isUniquelyOwned(a) && a.get() != b.get()) {
+    // e.g. `l = l + [x]`: append to the dead `a` instead of copying it
+    auto& elements = a->elements();
+    if (isUniquelyOwned(b)) {
+      elements.insert(
+          elements.end(),
+          std::make_move_iterator(b->elements().begin()),
+          std::make_move_iterator(b->elements().end()));
+    } else {
+      elements.insert(
+          elements.end(), b->elements().begin(), b->elements().end());
+    }
+    push(stack, std::move(a));
+    return 0;
+  }
+
   std::vector<TElement> ret;
   const auto total_size = a->elements().size() + b->elements().size();
   ret.reserve(total_size);
@@ -1565,9 +1629,9 @@ int listSetItem(Stack& stack) {
   TElement value;
 
   pop(stack, list, idx, value);
-  getItem(list, idx) = value;
+  getItem(list, idx) = std::move(value);
 
-  push(stack, list);
+  push(stack, std::move(list));
   return 0;
 }
 
@@ -1586,7 +1650,7 @@ int listSetItem<Shared<BoolList>, bool>(Stack& stack) {
   }
   list->elements()[normalized_idx] = value;
 
-  push(stack, list);
+  push(stack, std::move(list));
   return 0;
 }
 
@@ -1612,7 +1676,7 @@ int dictKeys(Stack& stack) {
   for (auto item : dict->elements()) {
     keys.push_back(item.key());
   }
-  push(stack, IValue(keys));
+  push(stack, IValue(std::move(keys)));
   return 0;
 }
 
@@ -1621,7 +1685,7 @@ std::vector<Elem> makeListForDictValues(
     const c10::ivalue::GenericDict::IterationOrder& order) {
   std::vector<Elem> values;
   values.reserve(order.size());
-  for (auto item : order) {
+  for (const auto& item : order) {
     values.push_back(item.second.to<Elem>());
   }
   return values;
@@ -1,7 +1,9 @@
 #include <torch/csrc/jit/script/init.h>
 
 #include <torch/csrc/Device.h>
+#include <torch/csrc/jit/export.h>
 #include <torch/csrc/jit/import.h>
+#include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/script/compiler.h>
 #include <torch/csrc/jit/script/module.h>
 #include <torch/csrc/jit/script/module_python.h>
@@ -26,6 +28,7 @@
 #include <ATen/ATen.h>
 #include <ATen/core/function_schema.h>
 #include <ATen/core/qualified_name.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 
 #include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
@@ -233,6 +236,26 @@ static std::shared_ptr<Graph> _propagate_and_assign_input_and_output_shapes(
   return retval;
 }
 
+// Python ops call the Python objects they were created for, which may belong
+// to the module instance they were compiled for.
+bool hasPythonOps(Block* block) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == prim::PythonOp) {
+      return true;
+    }
+    for (Block* sub_block : node->blocks()) {
+      if (hasPythonOps(sub_block)) {
+        return true;
+      }
+    }
+    if (node->kind() == prim::fork &&
+        hasPythonOps(node->g(attr::Subgraph)->block())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void addFunctionToModule(
     Module& module,
     const std::shared_ptr<Function>& func) {
@@ -274,7 +297,21 @@ void initJitScriptBindings(PyObject* module) {
             return py::bytes(buf.str());
           },
           py::arg("_extra_files") = ExtraFilesMap())
+      .def(
+          "_save_for_mobile",
+          [](std::shared_ptr<Module> m, const std::string& filename) {
+            ExportModuleForMobile(*m, filename);
+          },
+          py::arg("filename"))
+      .def(
+          "_save_to_buffer_for_mobile",
+          [](std::shared_ptr<Module> m) {
+            std::ostringstream buf;
+            ExportModuleForMobile(*m, buf);
+            return py::bytes(buf.str());
+          })
       .def("_set_optimized", &Module::set_optimized)
+      .def("_is_optimized", &Module::is_optimized)
       .def(
           "_define",
           [](std::shared_ptr<Module> m,
@@ -316,6 +353,27 @@ void initJitScriptBindings(PyObject* module) {
             }
             didFinishEmitModule(m);
           })
+      .def(
+          "_share_methods_from",
+          [](std::shared_ptr<Module> m, const std::shared_ptr<Module>& orig) {
+            if (!m->share_methods_from(*orig)) {
+              return false;
+            }
+            didFinishEmitModule(m);
+            return true;
+          })
+      .def(
+          "_can_share_methods",
+          [](Module& self) {
+            // Whether the compiled methods only depend on the structure of
+            // the module, and can be shared with identical modules
+            for (const auto& fn : self.class_compilation_unit().get_functions()) {
+              if (hasPythonOps(fn->graph()->block())) {
+                return false;
+              }
+            }
+            return true;
+          })
       .def(
           "_get_method",
           [](Module& self, const std::string& name) -> const Method& {
@@ -438,6 +496,15 @@ void initJitScriptBindings(PyObject* module) {
             throw std::runtime_error(
                 "Attempted to call get_debug_state on a Module without a compiled forward()");
           })
+      .def(
+          "_freeze_executors",
+          [](Module& self) {
+            self.apply([](Module& module) {
+              for (auto& method : module.get_methods()) {
+                method->get_executor().freeze();
+              }
+            });
+          })
       .def_property_readonly(
           "code",
           [](Module& self) {
@@ -627,6 +694,18 @@ void initJitScriptBindings(PyObject* module) {
         }
         import_ir_module(module_lookup, filename, optional_device, extra_files);
       });
+  m.def(
+      "import_ir_module_lazily",
+      [](ModuleLookup module_lookup,
+         const std::string& filename,
+         ExtraFilesMap& extra_files) {
+        // See load_lazily
+        import_ir_module(
+            module_lookup,
+            caffe2::make_unique<caffe2::serialize::MmapFileAdapter>(filename),
+            at::Device(at::kCPU),
+            extra_files);
+      });
   m.def(
       "import_ir_module_from_buffer",
       [](ModuleLookup module_lookup,
@@ -643,6 +722,52 @@ void initJitScriptBindings(PyObject* module) {
         import_ir_module(module_lookup, in, optional_device, extra_files);
       });
 
+  m.def(
+      "reload_ir_module_parameters",
+      [](Module& module,
+         const std::string& filename,
+         py::object map_location) {
+        c10::optional<at::Device> optional_device;
+        if (!map_location.is(py::none())) {
+          AT_ASSERT(THPDevice_Check(map_location.ptr()));
+          optional_device =
+              reinterpret_cast<THPDevice*>(map_location.ptr())->device;
+        }
+        reload_parameters(module, filename, optional_device);
+      });
+  m.def(
+      "reload_ir_module_parameters_from_buffer",
+      [](Module& module, const std::string& buffer, py::object map_location) {
+        std::istringstream in(buffer);
+        c10::optional<at::Device> optional_device;
+        if (!map_location.is(py::none())) {
+          AT_ASSERT(THPDevice_Check(map_location.ptr()));
+          optional_device =
+              reinterpret_cast<THPDevice*>(map_location.ptr())->device;
+        }
+        reload_parameters(module, in, optional_device);
+      });
+
+  py::class_<mobile::Module>(m, "LiteScriptModule")
+      .def(
+          "run_method",
+          [](const mobile::Module& self,
+             const std::string& method_name,
+             py::args args) {
+            auto stack = toStack(args);
+            return toPyObject(self.run_method(method_name, std::move(stack)));
+          })
+      .def("forward", [](const mobile::Module& self, py::args args) {
+        return toPyObject(self.forward(toStack(args)));
+      });
+  m.def("_load_for_mobile", [](const std::string& filename) {
+    return mobile::_load_for_mobile(filename);
+  });
+  m.def("_load_for_mobile_from_buffer", [](const std::string& buffer) {
+    std::istringstream in(buffer);
+    return mobile::_load_for_mobile(in);
+  });
+
   m.def(
       "_jit_import_functions",
       [](CompilationUnit& cu,
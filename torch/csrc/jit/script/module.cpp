@@ -265,6 +265,16 @@ Method::Method(Module* owner, Function* first_class_function)
       owner->lower_first_class_method(first_class_function);
 }
 
+Method::Method(
+    Module* owner,
+    Function* first_class_function,
+    std::shared_ptr<Function> lowered_function,
+    std::vector<Slot> initial_ivalues)
+    : owner_(owner),
+      function_(std::move(lowered_function)),
+      initial_ivalues_(std::move(initial_ivalues)),
+      schema_(sliceFirst(first_class_function->getSchema())) {}
+
 void Module::define(const std::string& src, const ResolverPtr& resolver) {
   class_compilation_unit().define(
       src,
@@ -348,6 +358,84 @@ void Module::clone_method(const Module& orig, const std::string& name) {
   return clone_method(orig, name, type_remap);
 }
 
+bool Module::share_methods_from(const Module& orig) {
+  if (!class_compilation_unit().get_functions().empty()) {
+    return false;
+  }
+
+  // Pair up the module objects of both hierarchies
+  std::vector<std::pair<const Module*, const Module*>> pairs;
+  std::vector<std::pair<const Module*, const Module*>> to_scan = {
+      {&orig, this}};
+  while (!to_scan.empty()) {
+    auto entry = to_scan.back();
+    to_scan.pop_back();
+    pairs.push_back(entry);
+    const auto& orig_modules = entry.first->get_modules();
+    const auto& modules = entry.second->get_modules();
+    if (orig_modules.size() != modules.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < orig_modules.size(); ++i) {
+      if (orig_modules[i]->name() != modules[i]->name()) {
+        return false;
+      }
+      to_scan.emplace_back(orig_modules[i].get(), modules[i].get());
+    }
+  }
+
+  std::unordered_map<TypePtr, TypePtr> type_remap;
+  std::unordered_map<const c10::ivalue::Object*, ModulePtr> object_remap;
+  for (const auto& entry : pairs) {
+    type_remap[entry.first->module_object()->type()] =
+        entry.second->module_object()->type();
+    object_remap[entry.first->module_object().get()] =
+        entry.second->module_object();
+  }
+  auto type_remap_fn = [&](const TypePtr& in) {
+    auto it = type_remap.find(in);
+    return it == type_remap.end() ? in : it->second;
+  };
+  for (const auto& entry : pairs) {
+    const auto& orig_type = entry.first->module_object()->type();
+    const auto& type = entry.second->module_object()->type();
+    if (orig_type->numAttributes() != type->numAttributes()) {
+      return false;
+    }
+    for (size_t i = 0; i < type->numAttributes(); ++i) {
+      if (orig_type->getAttributeName(i) != type->getAttributeName(i) ||
+          *type_remap_fn(orig_type->getAttribute(i)) != *type->getAttribute(i)) {
+        return false;
+      }
+    }
+  }
+
+  // Lower the methods of `orig` before changing anything, since lowering
+  // may fail
+  const auto& functions = orig.class_compilation_unit().get_functions();
+  std::vector<const Method*> orig_methods;
+  for (const auto& fn : functions) {
+    orig_methods.push_back(&orig.get_method(fn->name()));
+  }
+
+  for (const auto& fn : functions) {
+    clone_method(orig, fn->name(), type_remap);
+  }
+  for (const Method* orig_method : orig_methods) {
+    std::vector<Slot> initial_ivalues;
+    for (const Slot& slot : orig_method->initial_ivalues()) {
+      initial_ivalues.emplace_back(
+          object_remap.at(slot.container_.get()), slot.offset_);
+    }
+    Function* fn =
+        class_compilation_unit().find_function(orig_method->name()).get();
+    std::unique_ptr<Method> m(new Method(
+        this, fn, orig_method->function_, std::move(initial_ivalues)));
+    insert(fn->name(), methods_, EntityType::METHOD, std::move(m));
+  }
+  return true;
+}
+
 void Module::train(bool on) {
   for (auto& submod : get_modules()) {
     submod->train(on);
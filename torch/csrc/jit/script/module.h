@@ -58,6 +58,13 @@ using ModuleLookup =
 
 struct TORCH_API Method {
   Method(Module* owner, Function* function);
+  // Bind a lowered function that is shared with the method of another module,
+  // see Module::share_methods_from.
+  Method(
+      Module* owner,
+      Function* function,
+      std::shared_ptr<Function> lowered_function,
+      std::vector<Slot> initial_ivalues);
 
   // the module that contains this method.
   Module& owner() const {
@@ -128,6 +135,7 @@ struct TORCH_API Method {
   // before calling function_
   std::vector<Slot> initial_ivalues_;
   FunctionSchema schema_;
+  friend struct Module;
 };
 
 struct Module;
@@ -414,6 +422,16 @@ struct TORCH_API Module {
 
   void clone_method(const Module& orig, const std::string& name);
 
+  // Copy the methods of `orig` without compiling them again. `orig` must have
+  // the same structure as this module: parameters, attributes and submodules
+  // with the same names and types, recursively. The methods of both modules
+  // share their lowered functions, and so their graph executors and optimized
+  // graphs, and each module only binds its own parameters and attributes.
+  //
+  // Returns false without changing anything if this module already has
+  // methods, or if the structures differ.
+  bool share_methods_from(const Module& orig);
+
   enum class EntityType { MODULE, PARAMETER, ATTRIBUTE, METHOD };
 
   at::optional<EntityType> kind_of(const std::string& name) const {
@@ -71,7 +71,9 @@ bool patternGraphIsValid(const Graph& pattern) {
  *
  * The values are considered matching if:
  * 1) the nodes defining them match
- * 2) they have the same number of uses, except they are entry or exit nodes.
+ * 2) they have the same number of uses, except they are entry or exit nodes,
+ * or constants (which the graph is free to share with nodes outside the
+ * match).
  */
 bool SubgraphMatcher::matchValues(const Value* v1, Value* v2) {
   // Check if we've already visited these values.
@@ -81,9 +83,11 @@ bool SubgraphMatcher::matchValues(const Value* v1, Value* v2) {
 
   // When V2 is ANCHOR, we're comparing exiting values, and when V1->node is
   // PARAM, we're comparing entering values - in these two cases the number of
-  // uses don't need to be the same.
+  // uses don't need to be the same. Neither do they for constants, which
+  // ConstantPooling merges with equal constants used elsewhere.
   if (v1->uses().size() != v2->uses().size() && v2->node() != anchor_ &&
-      v1->node()->kind() != prim::Param) {
+      v1->node()->kind() != prim::Param &&
+      v1->node()->kind() != prim::Constant) {
     return false;
   }
 
@@ -31,7 +31,8 @@ struct Match {
  * Matching rules:
  *  - Pattern graph must contain a single block.
  *  - Matched subgraphs do not span across different blocks.
- *  - No uses outside the match are allowed, except for Param and Return nodes.
+ *  - No uses outside the match are allowed, except for Param and Return nodes,
+ *  and for the values of constants.
  *  Basically, we're matching hammocks, not arbitrary subgraphs.
  *  - Pattern graph must return only one value (i.e. it must have a single
  *  node leading to return).
@@ -336,6 +336,123 @@ void abandon() {
   setTracingState(nullptr);
 }
 
+// See Note [Reusing module traces]
+c10::optional<std::vector<Value*>> findValueTraces(const variable_list& vars) {
+  auto& env_stack = getTracingState()->env_stack;
+  std::vector<Value*> values;
+  values.reserve(vars.size());
+  for (const Variable& var : vars) {
+    Value* value = nullptr;
+    for (size_t i = 0; i < env_stack.size() && !value; ++i) {
+      auto& value_map = env_stack.at(env_stack.size() - 1 - i).value_map;
+      auto it = value_map.find(var);
+      if (it != value_map.end()) {
+        value = it->second;
+      }
+    }
+    if (!value) {
+      return c10::nullopt;
+    }
+    values.push_back(value);
+  }
+  return values;
+}
+
+std::shared_ptr<Graph> extractTrace(
+    Node* begin,
+    at::ArrayRef<Value*> inputs,
+    const variable_list& outputs) {
+  auto& state = getTracingState();
+  AT_ASSERT(begin->owningGraph() == state->graph.get());
+  auto trace = std::make_shared<Graph>();
+  // remember the scope the nodes were traced in, so that replayTrace can move
+  // them to the scope of the call they are replayed for
+  trace->set_current_scope(state->graph->current_scope());
+  std::unordered_map<Value*, Value*> value_map;
+  for (Value* input : inputs) {
+    // a value passed for several inputs is mapped to the first of them
+    value_map.emplace(input, trace->addInput()->copyMetadata(input));
+  }
+
+  bool uses_outside_values = false;
+  auto lookup = [&](Value* v) -> Value* {
+    auto it = value_map.find(v);
+    if (it != value_map.end()) {
+      return it->second;
+    }
+    // constants created before 'begin' are cloned, anything else can't be
+    // passed to the replayed graph
+    if (v->node()->kind() == prim::Constant) {
+      auto constant = trace->createClone(v->node(), [](Value*) -> Value* {
+        AT_ERROR("constants have no inputs");
+      });
+      trace->block()->prependNode(constant);
+      return value_map[v] = constant->output();
+    }
+    // keep cloning so that the graph stays well formed, it is discarded below
+    uses_outside_values = true;
+    return trace->addInput();
+  };
+
+  Node* end = state->graph->block()->return_node();
+  for (Node* n = begin->next(); n != end; n = n->next()) {
+    Node* clone = trace->appendNode(trace->createClone(n, lookup));
+    if (uses_outside_values) {
+      return nullptr;
+    }
+    for (size_t i = 0; i < n->outputs().size(); ++i) {
+      value_map[n->outputs()[i]] = clone->outputs()[i];
+    }
+  }
+
+  auto values = findValueTraces(outputs);
+  if (!values) {
+    return nullptr;
+  }
+  for (Value* output : *values) {
+    trace->registerOutput(lookup(output));
+  }
+  if (uses_outside_values) {
+    return nullptr;
+  }
+  return trace;
+}
+
+static ScopePtr rebaseScope(
+    const ScopePtr& scope,
+    const ScopePtr& from,
+    const ScopePtr& to) {
+  if (scope == from || scope->isRoot()) {
+    return to;
+  }
+  return rebaseScope(scope->parent(), from, to)->push(scope->name());
+}
+
+static void rebaseScopes(Node* n, const ScopePtr& from, const ScopePtr& to) {
+  n->setScope(rebaseScope(n->scope(), from, to));
+  for (Block* b : n->blocks()) {
+    for (Node* inner : b->nodes()) {
+      rebaseScopes(inner, from, to);
+    }
+  }
+}
+
+void replayTrace(
+    Graph& trace,
+    at::ArrayRef<Value*> inputs,
+    const variable_list& outputs) {
+  auto& graph = getTracingState()->graph;
+  AT_ASSERT(trace.outputs().size() == outputs.size());
+  Node* last = graph->insertPoint()->prev();
+  auto values = inlineCallTo(*graph, trace, inputs);
+  for (Node* n = last->next(); n != graph->insertPoint(); n = n->next()) {
+    rebaseScopes(n, trace.current_scope(), graph->current_scope());
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    setValueTrace(outputs[i], values[i]);
+  }
+}
+
 void setValueTrace(const IValue& v, Value* value) {
   if (v.isTensor()) {
     auto var = v.toTensor();
@@ -656,6 +773,10 @@ void defaultRecordSourceLocation(Node* n) {}
 std::atomic<decltype(&defaultRecordSourceLocation)> record_source_location(
     defaultRecordSourceLocation);
 void recordSourceLocation(Node* n) {
+  const auto& state = getTracingState();
+  if (state && !state->record_source_locations) {
+    return;
+  }
   return record_source_location.load()(n);
 }
 void setRecordSourceLocation(void (*v)(Node*)) {
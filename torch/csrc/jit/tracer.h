@@ -99,6 +99,36 @@ TORCH_API void exit(const Stack& outputs);
 
 TORCH_API void abandon();
 
+// Note [Reusing module traces]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Deep models call many submodules that have the same structure on inputs of
+// the same types, and each of those calls traces to the same nodes. Instead of
+// tracing all of them, torch.jit traces the first call, copies the nodes it
+// recorded into a graph with extractTrace, and for the following calls runs
+// the module with tracing paused and inserts that graph with replayTrace. The
+// time spent in the tracer then scales with the number of distinct submodules
+// rather than with the depth of the model.
+
+// The values that trace each of vars, or nullopt if one of them isn't traced
+// (in which case getValueTrace would bake it in as a constant).
+TORCH_API c10::optional<std::vector<Value*>> findValueTraces(
+    const variable_list& vars);
+
+// Copies the nodes traced after 'begin' into a new graph whose inputs are
+// 'inputs' and whose outputs are the traces of 'outputs'. Returns nullptr if
+// those nodes use any value other than 'inputs' and constants.
+TORCH_API std::shared_ptr<Graph> extractTrace(
+    Node* begin,
+    at::ArrayRef<Value*> inputs,
+    const variable_list& outputs);
+
+// Inserts a graph returned by extractTrace into the current trace, and makes
+// its outputs the traces of 'outputs'.
+TORCH_API void replayTrace(
+    Graph& trace,
+    at::ArrayRef<Value*> inputs,
+    const variable_list& outputs);
+
 // NB: those serve both as an intermediate steps in addInputs below,
 // as well as the overloads that terminate template recursion
 TORCH_API void addInputs(Node* n, const char* name, int64_t value);
@@ -59,6 +59,10 @@ struct TORCH_API TracingState
   std::shared_ptr<Graph> graph;
   bool warn = true;
   bool force_outplace = false;
+  // Recording the Python stack of every traced node dominates the cost of
+  // tracing large models, so it can be turned off when the source ranges in
+  // the graph aren't needed.
+  bool record_source_locations = true;
   std::function<std::string(const Variable& var)> lookup_var_name_fn =
       [](const Variable& var) { return ""; };
 };
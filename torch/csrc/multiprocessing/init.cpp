@@ -2,7 +2,10 @@
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
+#include <TH/THAllocator.h>
+
 #include <stdexcept>
+#include <tuple>
 
 #if defined(__linux__)
 #include <sys/prctl.h>
@@ -34,6 +37,19 @@ PyObject* multiprocessing_init(PyObject* _unused) {
 #endif
   });
 
+  module.def(
+      "_set_shared_memory_placement", [](bool huge_pages, int numa_node) {
+        THSharedMemoryPlacement placement;
+        placement.huge_pages = huge_pages;
+        placement.numa_node = numa_node;
+        THSetSharedMemoryPlacement(placement);
+      });
+
+  module.def("_get_shared_memory_placement", []() {
+    auto placement = THGetSharedMemoryPlacement();
+    return std::make_tuple(placement.huge_pages, placement.numa_node);
+  });
+
   Py_RETURN_TRUE;
 }
 
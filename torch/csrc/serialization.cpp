@@ -1,9 +1,14 @@
 #include <torch/csrc/python_headers.h>
 #include <system_error>
 
+#include <ATen/Parallel.h>
 #include <torch/csrc/THP.h>
 #include <torch/csrc/serialization.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
 template <class io>
 ssize_t doPartialRead(io fildes, void* buf, size_t nbytes);
 
@@ -152,6 +157,64 @@ void doRead(io fildes, void* raw_buf, size_t nbytes) {
   }
 }
 
+#ifndef _WIN32
+// Reads EXACTLY nbytes at offset of fd; fails if we don't.
+static void doPread(int fd, char* buf, size_t nbytes, int64_t offset) {
+  while (nbytes > 0) {
+    // we read in 1GB blocks to avoid bugs on Mac OS X Lion, like doRead
+    ssize_t r = pread(fd, buf, std::min<size_t>(nbytes, 1073741824), offset);
+    if (r < 0) {
+      int err = errno;
+      if (err == EINTR) {
+        continue;
+      }
+      AT_ERROR("pread(): fd ", fd, " failed with ", strerror(err));
+    } else if (r == 0) {
+      AT_ERROR("unexpected EOF, expected ", nbytes, " more bytes. The file might be corrupted.");
+    }
+    AT_ASSERT(static_cast<size_t>(r) <= nbytes);
+    buf += r;
+    offset += r;
+    nbytes -= r;
+  }
+}
+#endif
+
+// Reads of storages from a real file are split into blocks of this size, read
+// by the intra-op threads. Several reads in flight keep fast (NVMe) drives
+// busy, which a single synchronous read(2) doesn't.
+static constexpr size_t kPreadBlockSize = 64 * 1024 * 1024;
+
+template <>
+void doRead<THPPreadFile*>(THPPreadFile* file, void* raw_buf, size_t nbytes) {
+  char* buf = static_cast<char*>(raw_buf);
+#ifdef _WIN32
+  // no pread, read sequentially from the offset
+  TORCH_CHECK(_lseeki64(file->fd, file->offset, SEEK_SET) == file->offset,
+      "lseek(): fd ", file->fd, " failed with ", strerror(errno));
+  doRead(file->fd, buf, nbytes);
+#else
+  const int64_t offset = file->offset;
+  const int64_t num_blocks = (nbytes + kPreadBlockSize - 1) / kPreadBlockSize;
+  if (num_blocks <= 1) {
+    doPread(file->fd, buf, nbytes, offset);
+  } else {
+#ifdef POSIX_FADV_SEQUENTIAL
+    // only a hint, so failures don't matter
+    posix_fadvise(file->fd, offset, nbytes, POSIX_FADV_SEQUENTIAL);
+#endif
+    at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t block = begin; block < end; ++block) {
+        const size_t block_begin = block * kPreadBlockSize;
+        const size_t block_size = std::min(kPreadBlockSize, nbytes - block_begin);
+        doPread(file->fd, buf + block_begin, block_size, offset + block_begin);
+      }
+    });
+  }
+#endif
+  file->offset += nbytes;
+}
+
 template <typename io>
 void doWrite(io fildes, void* raw_buf, size_t nbytes) {
   char* buf = static_cast<char*>(raw_buf);
@@ -1,6 +1,16 @@
 #ifndef THP_SERIALIZATION_INC
 #define THP_SERIALIZATION_INC
 
+#include <cstdint>
+
+// A file descriptor read with pread(2) from `offset` on, which doRead
+// advances. It doesn't use the file position, so doRead splits large reads
+// into blocks that are read concurrently, without the GIL.
+struct THPPreadFile {
+  int fd;
+  int64_t offset;
+};
+
 #include <torch/csrc/generic/serialization.h>
 #include <TH/THGenerateAllTypes.h>
 
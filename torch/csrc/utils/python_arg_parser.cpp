@@ -488,12 +488,15 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
       }
       obj = PyTuple_GET_ITEM(args, arg_pos);
     } else if (kwargs) {
-      obj = PyDict_GetItem(kwargs, param.python_name);
-      for (PyObject *numpy_name: param.numpy_python_names) {
-        if (obj) {
-          break;
+      // once all keyword arguments are bound, the remaining lookups would miss
+      if (remaining_kwargs > 0) {
+        obj = PyDict_GetItem(kwargs, param.python_name);
+        for (PyObject *numpy_name: param.numpy_python_names) {
+          if (obj) {
+            break;
+          }
+          obj = PyDict_GetItem(kwargs, numpy_name);
         }
-        obj = PyDict_GetItem(kwargs, numpy_name);
       }
       is_kwd = true;
     }
@@ -552,9 +555,76 @@ bool FunctionSignature::parse(PyObject* args, PyObject* kwargs, PyObject* dst[],
   return true;
 }
 
+// Note [Overload cache]
+// ~~~~~~~~~~~~~~~~~~~~~
+// Parsers with several signatures try them in order (see Note [Order of
+// overloads matters]), so e.g. `x.add(2)` first fails to bind to the Tensor
+// overload of add. Whether a positional argument binds to a parameter only
+// depends on its type and, for Variables, on their scalar type and on whether
+// they require grad, are zero-dim or have a single element (see
+// FunctionParameter::check and THPUtils_checkIndex). So each parser remembers
+// these kinds of the positional arguments of its last call, and the signature
+// that call bound to: a call with the same kinds of arguments binds to the
+// same signature, and is parsed with it directly.
+//
+// Calls with keyword arguments or more than PositionalArgKinds::kMaxArgs
+// arguments aren't cached, nor are calls with arguments of other types (e.g.
+// NumPy scalars, or objects with an __index__), which could bind depending on
+// their values. Parsers are only used with the GIL held, which also guards
+// their cache.
+
+bool PositionalArgKinds::compute(PyObject* args) {
+  nargs = PyTuple_GET_SIZE(args);
+  if (nargs > kMaxArgs) {
+    return false;
+  }
+  for (ssize_t i = 0; i < nargs; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(args, i);
+    types[i] = Py_TYPE(obj);
+    variable_flags[i] = 0;
+    if (THPVariable_Check(obj)) {
+      auto& var = ((THPVariable*)obj)->cdata;
+      if (!var.defined()) {
+        return false;
+      }
+      variable_flags[i] = static_cast<uint16_t>(var.scalar_type()) << 3 |
+          (var.requires_grad() ? 1 : 0) |
+          (var.dim() == 0 ? 2 : 0) |
+          (var.numel() == 1 ? 4 : 0);
+      continue;
+    }
+    bool known_type = obj == Py_None || PyBool_Check(obj) ||
+        PyLong_CheckExact(obj) || PyFloat_CheckExact(obj) ||
+        PyComplex_CheckExact(obj) || PyUnicode_CheckExact(obj) ||
+        PyTuple_CheckExact(obj) || PyList_CheckExact(obj) ||
+        THPDtype_Check(obj) || THPLayout_Check(obj) ||
+        THPMemoryFormat_Check(obj) || THPDevice_Check(obj);
+#if PY_MAJOR_VERSION == 2
+    known_type = known_type || PyInt_CheckExact(obj) || PyString_CheckExact(obj);
+#endif
+    if (!known_type) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PositionalArgKinds::operator==(const PositionalArgKinds& other) const {
+  if (nargs != other.nargs) {
+    return false;
+  }
+  for (ssize_t i = 0; i < nargs; i++) {
+    if (types[i] != other.types[i] || variable_flags[i] != other.variable_flags[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
  : max_args(0)
  , traceable(traceable)
+ , cached_idx_(-1)
 {
   for (auto& fmt : fmts) {
     signatures_.emplace_back(fmt);
@@ -576,9 +646,23 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(0, traceable, signature, parsed_args);
   }
 
+  // See Note [Overload cache]
+  PositionalArgKinds kinds;
+  bool cacheable = (!kwargs || PyDict_Size(kwargs) == 0) && kinds.compute(args);
+  if (cacheable && cached_idx_ >= 0 && kinds == cached_kinds_) {
+    auto& signature = signatures_[cached_idx_];
+    if (signature.parse(args, kwargs, parsed_args, false)) {
+      return PythonArgs(cached_idx_, traceable, signature, parsed_args);
+    }
+  }
+
   int i = 0;
   for (auto& signature : signatures_) {
     if (signature.parse(args, kwargs, parsed_args, false)) {
+      if (cacheable) {
+        cached_kinds_ = kinds;
+        cached_idx_ = i;
+      }
       return PythonArgs(i, traceable, signature, parsed_args);
     }
     i++;
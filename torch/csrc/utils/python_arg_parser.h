@@ -62,6 +62,7 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -85,6 +86,23 @@ struct ParsedArgs {
   PyObject* args[N];
 };
 
+// The kinds of the positional arguments of a call, which determine the
+// signature they bind to. See Note [Overload cache]
+struct PositionalArgKinds {
+  static constexpr int kMaxArgs = 6;
+
+  // Returns false if the kinds of `args` don't determine the signature it
+  // binds to, or if there are too many of them.
+  bool compute(PyObject* args);
+  bool operator==(const PositionalArgKinds& other) const;
+
+  ssize_t nargs = -1;
+  std::array<PyTypeObject*, kMaxArgs> types;
+  // For Variables: their scalar type, and whether they require grad, are
+  // zero-dim or have a single element
+  std::array<uint16_t, kMaxArgs> variable_flags;
+};
+
 struct PythonArgParser {
   explicit PythonArgParser(std::vector<std::string> fmts, bool traceable=false);
 
@@ -100,6 +118,10 @@ private:
   std::string function_name;
   ssize_t max_args;
   bool traceable;
+  // The kinds of the positional arguments of the last call that could be
+  // cached, and the index of the signature it bound to
+  PositionalArgKinds cached_kinds_;
+  int cached_idx_;
 };
 
 struct PythonArgs {
@@ -23,6 +23,9 @@ inline void store_scalar(void* data, at::ScalarType scalarType, PyObject* obj) {
     case at::kComplexFloat: *(std::complex<float>*)data = (std::complex<float>)THPUtils_unpackComplexDouble(obj); break;
     case at::kComplexDouble: *(std::complex<double>*)data = THPUtils_unpackComplexDouble(obj); break;
     case at::kBool: *(bool*)data = (bool)THPUtils_unpackLong(obj); break;
+    case at::kBFloat16:
+      *(at::BFloat16*)data = at::convert<at::BFloat16, double>(THPUtils_unpackDouble(obj));
+      break;
     default: throw std::runtime_error("invalid type");
   }
 }
@@ -40,6 +43,7 @@ inline PyObject* load_scalar(void* data, at::ScalarType scalarType) {
     case at::kComplexFloat: return PyComplex_FromCComplex(*reinterpret_cast<Py_complex *>((std::complex<float>*)data));
     case at::kComplexDouble: return PyComplex_FromCComplex(*reinterpret_cast<Py_complex *>((std::complex<double>*)data));
     case at::kBool: return PyBool_FromLong(*(bool*)data);
+    case at::kBFloat16: return PyFloat_FromDouble(at::convert<double, at::BFloat16>(*(at::BFloat16*)data));
     default: throw std::runtime_error("invalid type");
   }
 }
@@ -49,7 +49,9 @@ inline THPObjectPtr maybeAsTuple(PyStructSequence *obj) {
 }
 
 inline THPObjectPtr maybeAsTuple(PyObject *obj) {
-  if (isStructSeq(obj))
+  // Checking the type's __module__ is slow, and tuples and lists never need
+  // to be converted
+  if (!PyTuple_Check(obj) && !PyList_Check(obj) && isStructSeq(obj))
     return maybeAsTuple((PyStructSequence *)obj);
   Py_INCREF(obj);
   return THPObjectPtr(obj);
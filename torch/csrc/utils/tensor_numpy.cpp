@@ -107,39 +107,51 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
   }
 
   auto array = (PyArrayObject*)obj;
+  if (!PyArray_ISWRITEABLE(array)) {
+    // Tensors have no notion of read-only memory, so the array is shared as
+    // is (in particular read-only memory maps) rather than copied.
+    if (PyErr_WarnEx(PyExc_UserWarning,
+          "The given NumPy array is not writeable, and PyTorch does not support "
+          "non-writeable tensors. The tensor shares the memory of the array, so "
+          "writing to it is undefined behavior. You may want to copy the array "
+          "to protect its data or make it writeable before converting it.", 1) != 0) {
+      throw python_error();
+    }
+  }
+
   int ndim = PyArray_NDIM(array);
   auto sizes = to_aten_shape(ndim, PyArray_DIMS(array));
   auto strides = to_aten_shape(ndim, PyArray_STRIDES(array));
   // NumPy strides use bytes. Torch strides use element counts.
   auto element_size_in_bytes = PyArray_ITEMSIZE(array);
-  for (auto& stride : strides) {
+  char* data_ptr = static_cast<char*>(PyArray_DATA(array));
+  std::vector<int64_t> flipped_dims;
+  for (int i = 0; i < ndim; i++) {
+    auto& stride = strides[i];
     if (stride%element_size_in_bytes != 0) {
       throw ValueError(
         "given numpy array strides not a multiple of the element byte size. "
         "Copy the numpy array to reallocate the memory.");
     }
-    stride /= element_size_in_bytes;
-  }
-
-  size_t storage_size = 1;
-  for (int i = 0; i < ndim; i++) {
-    if (strides[i] < 0) {
-      throw ValueError(
-          "some of the strides of a given numpy array are negative. This is "
-          "currently not supported, but will be added in future releases.");
+    if (stride < 0) {
+      // Tensors can't have negative strides: wrap the memory of the array in
+      // the opposite order along this dimension and flip it back below.
+      if (sizes[i] > 0) {
+        data_ptr += (sizes[i] - 1) * stride;
+      }
+      stride = -stride;
+      flipped_dims.push_back(i);
     }
-    // XXX: this won't work for negative strides
-    storage_size += (sizes[i] - 1) * strides[i];
+    stride /= element_size_in_bytes;
   }
 
-  void* data_ptr = PyArray_DATA(array);
   if (!PyArray_EquivByteorders(PyArray_DESCR(array)->byteorder, NPY_NATIVE)) {
     throw ValueError(
         "given numpy array has byte order different from the native byte order. "
         "Conversion between byte orders is currently not supported.");
   }
   Py_INCREF(obj);
-  return at::from_blob(
+  auto tensor = at::from_blob(
       data_ptr,
       sizes,
       strides,
@@ -149,6 +161,11 @@ at::Tensor tensor_from_numpy(PyObject* obj) {
       },
       at::device(kCPU).dtype(numpy_dtype_to_aten(PyArray_TYPE(array)))
   );
+  if (!flipped_dims.empty()) {
+    // flip copies, so only these arrays do not share memory with the result
+    return tensor.flip(flipped_dims);
+  }
+  return tensor;
 }
 
 static int aten_to_dtype(const ScalarType scalar_type) {
@@ -559,6 +559,68 @@ def reset_max_memory_cached(device=None):
     return torch._C._cuda_resetMaxMemoryCached(device)
 
 
+def memory_snapshot():
+    r"""Returns a snapshot of the CUDA memory allocator state across all devices.
+
+    The result is a list of segments, one per contiguous range of memory
+    obtained from the driver. Each segment is a dict with its ``device``,
+    ``address``, ``stream``, ``total_size``, ``allocated_size``,
+    ``segment_type`` (``"large"`` or ``"small"``) and ``blocks``. Each block
+    is a dict with its ``size``, ``state`` (``"active_allocated"``,
+    ``"active_pending_free"`` for freed blocks that still wait on streams
+    recorded with :meth:`~torch.Tensor.record_stream`, or ``"inactive"``) and,
+    if :func:`~torch.cuda._record_memory_history` was enabled when it was
+    allocated, the ``history`` of the allocation.
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    if not _initialized:
+        return []
+    return torch._C._cuda_memorySnapshot()
+
+
+def memory_event_counts(device=None):
+    r"""Returns a dict of counters of caching allocator events for a given
+    device since the beginning of the program: ``num_allocs``, ``num_frees``,
+    ``num_cuda_mallocs`` and ``num_cuda_frees`` (segments obtained from and
+    returned to the driver), ``num_alloc_retries`` (allocations that had to
+    release cached memory first), ``num_ooms``, ``num_splits`` and
+    ``num_merges``.
+
+    Arguments:
+        device (torch.device or int, optional): selected device. Returns
+            statistic for the current device, given by :func:`~torch.cuda.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    device = _get_device_index(device, optional=True)
+    return torch._C._cuda_memoryEventCounts(device)
+
+
+def host_memory_stats():
+    r"""Returns a dict of statistics of the caching allocator of pinned host
+    memory, which serves :meth:`~torch.Tensor.pin_memory` and tensors created
+    with ``pin_memory=True`` (e.g. by a :class:`~torch.utils.data.DataLoader`
+    with ``pin_memory=True``): ``allocated_bytes`` and ``cached_bytes`` (the
+    memory currently allocated, and obtained with ``cudaHostAlloc``), and the
+    counters since the beginning of the program ``num_allocs``,
+    ``num_host_allocs`` and ``num_host_frees`` (calls to ``cudaHostAlloc`` and
+    ``cudaFreeHost``), ``num_splits`` and ``num_merges``.
+    """
+    _lazy_init()
+    return torch._C._cuda_hostMemoryStats()
+
+
+def _record_memory_history(enabled):
+    r"""Enables or disables recording a backtrace for every allocation, which
+    is then reported by :func:`~torch.cuda.memory_snapshot`. This slows down
+    allocations considerably and is meant for debugging only.
+    """
+    _lazy_init()
+    torch._C._cuda_recordMemoryHistory(bool(enabled))
+
+
 def _host_allocator():
     _lazy_init()
     return torch._C._cuda_cudaHostAllocator()
@@ -672,3 +734,4 @@ from . import sparse  # noqa: F401
 from . import profiler  # noqa: F401
 from . import nvtx  # noqa: F401
 from .streams import Stream, Event  # noqa: F401
+from .graphs import CUDAGraph  # noqa: F401
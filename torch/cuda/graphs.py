@@ -0,0 +1,57 @@
+import torch
+
+
+class CUDAGraph(object):
+    r"""Wrapper around a CUDA graph: records the kernels launched on the
+    current stream between :meth:`capture_begin` and :meth:`capture_end`, and
+    replays all of them with a single launch on each call to :meth:`replay`.
+    This removes the CPU overhead of launching the kernels one by one, e.g. in
+    small batch inference.
+
+    Nothing is executed while capturing, and replays always read and write the
+    memory used during capture: inputs should be copied into the tensors that
+    were used as inputs during capture before each replay, and outputs read
+    from the tensors that were returned during capture. The memory allocated
+    or freed while capturing is reserved for the graph, and only reused once the
+    graph is reset or destroyed.
+
+    The captured work must have been run once before, must only use tensors of
+    the same shapes, must not synchronize with the CPU, and must be captured on
+    a stream other than the default one. Requires CUDA 10.1 or newer.
+
+    Example::
+
+        >>> static_input = torch.randn(8, 64, device='cuda')
+        >>> s = torch.cuda.Stream()
+        >>> with torch.cuda.stream(s):
+        ...     model(static_input)  # warm up
+        ...     graph = torch.cuda.CUDAGraph()
+        ...     graph.capture_begin()
+        ...     static_output = model(static_input)
+        ...     graph.capture_end()
+        >>> static_input.copy_(new_input)
+        >>> graph.replay()
+        >>> static_output  # the output of model(new_input)
+    """
+
+    def __init__(self):
+        torch.cuda._lazy_init()
+        self._graph = torch.cuda._CUDAGraph()
+
+    def capture_begin(self):
+        r"""Starts capturing the work issued on the current stream."""
+        self._graph.capture_begin()
+
+    def capture_end(self):
+        r"""Stops capturing, and makes the graph ready to be replayed. Must be
+        called on the stream :meth:`capture_begin` was called on."""
+        self._graph.capture_end()
+
+    def replay(self):
+        r"""Launches the captured work on the current stream."""
+        self._graph.replay()
+
+    def reset(self):
+        r"""Destroys the captured graph, and releases the memory reserved for
+        it. The graph can then be captured again."""
+        self._graph.reset()
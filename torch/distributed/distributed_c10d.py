@@ -9,6 +9,7 @@ from datetime import timedelta
 from .rendezvous import rendezvous, register_rendezvous_handler  # noqa: F401
 from . import (
     AllreduceOptions,
+    AllToAllOptions,
     BroadcastOptions,
     GatherOptions,
     ReduceOptions,
@@ -17,6 +18,7 @@ from . import (
 )
 from . import ReduceOp
 from . import PrefixStore
+from . import ProcessGroupHierarchical
 
 
 _MPI_AVAILABLE = True
@@ -352,7 +354,11 @@ def init_process_group(backend,
                                 Mutually exclusive with ``init_method``.
         timeout (timedelta, optional): Timeout for operations executed against
             the process group. Default value equals 30 minutes.
-            This is only applicable for the ``gloo`` backend.
+            This is applicable for the ``gloo`` and ``nccl`` backends. For
+            ``nccl``, operations that time out or fail asynchronously (e.g.
+            because a peer died) abort the communicators and make their works
+            raise; set the environment variable ``NCCL_BLOCKING_WAIT=1`` for
+            ``wait()`` to block until the operation completed or failed.
         group_name (str, optional, deprecated): Group name.
 
     To enable ``backend == Backend.MPI``, PyTorch needs to built from source
@@ -492,7 +498,8 @@ def _new_process_group_helper(world_size,
                 prefix_store,
                 rank,
                 world_size,
-                group_name)
+                group_name,
+                timeout=timeout)
             _pg_map[pg] = (Backend.NCCL, store)
             _pg_names[pg] = group_name
         else:
@@ -907,6 +914,51 @@ def all_reduce(tensor,
         work.wait()
 
 
+def all_reduce_coalesced(tensors,
+                         op=ReduceOp.SUM,
+                         group=group.WORLD,
+                         async_op=False):
+    """
+    Reduces each tensor of a list across all machines, like calling
+    :func:`all_reduce` on each of them, but as a single collective: the
+    tensors are reduced together, which saves the overhead of a collective
+    per tensor when there are many small ones.
+
+    Only nccl backend is currently supported.
+
+    Arguments:
+        tensors (List[Tensor]): Inputs and outputs of the collective. The
+            function operates in-place. The tensors must be GPU tensors of the
+            same type on the same GPU, and the list must have the same number
+            and sizes of tensors in all processes.
+        op (optional): One of the values from
+            ``torch.distributed.ReduceOp``
+            enum.  Specifies an operation used for element-wise reductions.
+        group (ProcessGroup, optional): The process group to work on
+        async_op (bool, optional): Whether this op should be an async op
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group
+
+    """
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllreduceOptions()
+    opts.reduceOp = op
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.allreduce_coalesced(tensors, opts)
+    else:
+        work = group.allreduce_coalesced(tensors, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def reduce_multigpu(tensor_list,
                     dst,
                     op=ReduceOp.SUM,
@@ -1334,6 +1386,112 @@ def reduce_scatter(output,
         work.wait()
 
 
+def all_to_all_single(output,
+                      input,
+                      output_split_sizes=None,
+                      input_split_sizes=None,
+                      group=group.WORLD,
+                      async_op=False):
+    """
+    Splits the input tensor along its first dimension and scatters the slices
+    to all processes in a group, then concatenates the slices received from
+    all processes, in rank order, into the output tensor.
+
+    Arguments:
+        output (Tensor): Output tensor.
+        input (Tensor): Input tensor to scatter.
+        output_split_sizes (list[Int], optional): Sizes along the first
+            dimension of the slices received from every process. The output
+            is split evenly if it is ``None`` or empty.
+        input_split_sizes (list[Int], optional): Sizes along the first
+            dimension of the slices sent to every process. The input is split
+            evenly if it is ``None`` or empty.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_single_tensor(output, "output")
+    _check_single_tensor(input, "input")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllToAllOptions()
+    output_split_sizes = [] if output_split_sizes is None else output_split_sizes
+    input_split_sizes = [] if input_split_sizes is None else input_split_sizes
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+    else:
+        work = group.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
+def all_to_all(output_tensor_list,
+               input_tensor_list,
+               group=group.WORLD,
+               async_op=False):
+    """
+    Scatters the list of input tensors to all processes in a group, and
+    returns the tensors received from all processes in the output list:
+    ``input_tensor_list[i]`` of process ``j`` is received as
+    ``output_tensor_list[j]`` of process ``i``. The tensors may have
+    different sizes along their first dimension, but must agree in all other
+    dimensions.
+
+    Arguments:
+        output_tensor_list (list[Tensor]): List of ``world_size`` tensors to
+            receive into.
+        input_tensor_list (list[Tensor]): List of ``world_size`` tensors to
+            scatter.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether to return the work handle. The
+            call always waits for the operation to complete.
+
+    Returns:
+        Completed work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_tensor_list(output_tensor_list, "output_tensor_list")
+    _check_tensor_list(input_tensor_list, "input_tensor_list")
+    if _rank_not_in_group(group):
+        return
+
+    output = torch.cat(output_tensor_list)
+    input = torch.cat(input_tensor_list)
+    output_split_sizes = [t.shape[0] for t in output_tensor_list]
+    input_split_sizes = [t.shape[0] for t in input_tensor_list]
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes)
+    else:
+        work = group.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes)
+
+    # The received slices are copied out of the concatenated output once it
+    # is ready, so this waits for the operation even with async_op.
+    work.wait()
+    for tensor, received in zip(output_tensor_list,
+                                output.split(output_split_sizes)):
+        tensor.copy_(received)
+
+    if async_op:
+        return work
+
+
 def barrier(group=group.WORLD,
             async_op=False):
     """
@@ -1378,7 +1536,11 @@ def new_group(ranks=None, timeout=_default_pg_timeout, backend=None):
         ranks (list[int]): List of ranks of group members.
         timeout (timedelta, optional): Timeout for operations executed against
             the process group. Default value equals 30 minutes.
-            This is only applicable for the ``gloo`` backend.
+            This is applicable for the ``gloo`` and ``nccl`` backends. For
+            ``nccl``, operations that time out or fail asynchronously (e.g.
+            because a peer died) abort the communicators and make their works
+            raise; set the environment variable ``NCCL_BLOCKING_WAIT=1`` for
+            ``wait()`` to block until the operation completed or failed.
         backend (str or Backend, optional): The backend to use. Depending on
             build-time configurations, valid values are ``gloo`` and ``nccl``.
             By default uses the same backend as the global group. This field
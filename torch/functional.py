@@ -24,6 +24,7 @@ __all__ = [
     'potrf',
     'potri',
     'potrs',
+    'istft',
     'split',
     'stft',
     'tensordot',
@@ -388,6 +389,303 @@ def stft(input, n_fft, hop_length=None, win_length=None, window=None,
     return torch._C._VariableFunctions.stft(input, n_fft, hop_length, win_length, window, normalized, onesided)
 
 
+def _frame_window(n_fft, win_length, window, like):
+    # the window applied to each frame of size n_fft, as in the native stft
+    if win_length is None:
+        win_length = n_fft
+    if window is None:
+        window = like.new_ones(win_length)
+    if win_length < n_fft:
+        left = (n_fft - win_length) // 2
+        window = F.pad(window, (left, n_fft - win_length - left))
+    return window
+
+
+def _reflect_pad(input, left, right):
+    signal_dim = input.dim()
+    extended_shape = [1] * (3 - signal_dim) + list(input.size())
+    output = F.pad(input.reshape(extended_shape), (left, right), 'reflect')
+    return output.view(output.shape[-signal_dim:])
+
+
+class STFTStream(object):
+    r"""Computes the :func:`torch.stft` of a signal that arrives in chunks.
+
+    Every call of :meth:`push` returns the frames completed by the new
+    samples, so a frame is emitted as soon as its last sample arrives, and
+    only the last ``n_fft - hop_length`` samples (plus what does not fill a
+    hop yet) are kept between calls. Concatenating the results of all
+    :meth:`push` calls and of the final :meth:`flush` along the frame
+    dimension gives the same result as :func:`torch.stft` on the whole
+    signal.
+
+    The arguments are those of :func:`torch.stft`, except that only
+    ``"reflect"`` padding is supported when :attr:`center` is ``True``. Note
+    that centering delays the first frames by ``n_fft // 2`` samples, and
+    the last ones until :meth:`flush`.
+
+    Example::
+
+        >>> stream = torch.functional.STFTStream(400, 160, window=torch.hann_window(400))
+        >>> for chunk in microphone_chunks:
+        ...     frames = stream.push(chunk)  # (201, T, 2), T >= 0
+        >>> frames = stream.flush()
+    """
+
+    def __init__(self, n_fft, hop_length=None, win_length=None, window=None,
+                 center=False, normalized=False, onesided=True):
+        self.n_fft = n_fft
+        self.hop_length = hop_length if hop_length is not None else n_fft // 4
+        if not 0 < self.hop_length <= n_fft:
+            raise ValueError("STFTStream: expected 0 < hop_length <= n_fft, but got "
+                             "hop_length={}".format(self.hop_length))
+        self.win_length = win_length
+        self.window = window
+        self.center = center
+        self.normalized = normalized
+        self.onesided = onesided
+        self.reset()
+
+    def reset(self):
+        r"""Drops the buffered samples, to start a new signal."""
+        self._buffer = None
+        self._started = not self.center
+        # the last n_fft // 2 + 1 samples, that the right padding reflects
+        self._recent = None
+
+    def _empty_frames(self, like):
+        freqs = self.n_fft // 2 + 1 if self.onesided else self.n_fft
+        return like.new_empty(like.shape[:-1] + (freqs, 0, 2))
+
+    def _frames(self):
+        if self._buffer.size(-1) < self.n_fft:
+            return self._empty_frames(self._buffer)
+        frames = torch._C._VariableFunctions.stft(
+            self._buffer, self.n_fft, self.hop_length, self.win_length,
+            self.window, self.normalized, self.onesided)
+        self._buffer = self._buffer[..., frames.size(-2) * self.hop_length:]
+        return frames
+
+    def push(self, input):
+        r"""Appends the 1-D signal or 2-D batch of signals :attr:`input` and
+        returns the frames it completes."""
+        if self._buffer is None:
+            self._buffer = input
+        else:
+            self._buffer = torch.cat([self._buffer, input], -1)
+        if self.center:
+            recent = input if self._recent is None else torch.cat([self._recent, input], -1)
+            self._recent = recent[..., max(0, recent.size(-1) - self.n_fft // 2 - 1):]
+        if not self._started:
+            pad = self.n_fft // 2
+            # reflect padding needs the first pad + 1 samples
+            if self._buffer.size(-1) <= pad:
+                return self._empty_frames(self._buffer)
+            self._buffer = _reflect_pad(self._buffer, pad, 0)
+            self._started = True
+        return self._frames()
+
+    def flush(self):
+        r"""Returns the remaining frames, including the ones that need the
+        right padding when :attr:`center` is ``True``, and resets the
+        stream."""
+        if self._buffer is None:
+            raise RuntimeError("STFTStream.flush: no samples were pushed")
+        if self.center:
+            pad = self.n_fft // 2
+            if not self._started:
+                self._buffer = _reflect_pad(self._buffer, pad, 0)
+            # the frames consumed most of the signal, so reflect the samples
+            # kept aside
+            if self._recent.size(-1) <= pad:
+                raise RuntimeError("STFTStream.flush: reflect padding of {} needs more than "
+                                   "{} samples".format(pad, pad))
+            right = self._recent.flip(-1)[..., 1:]
+            self._buffer = torch.cat([self._buffer, right], -1)
+        frames = self._frames()
+        self.reset()
+        return frames
+
+
+class ISTFTStream(object):
+    r"""Inverts a short-time Fourier transform that arrives in chunks of
+    frames, by weighted overlap-add.
+
+    Every call of :meth:`push` returns the samples that no later frame
+    overlaps, i.e. all but the last ``n_fft - hop_length`` samples covered so
+    far, and only those last samples are kept between calls. The samples are
+    normalized by the sum of the squared windows of the frames overlapping
+    them, so that a signal is recovered from its :func:`torch.stft` with the
+    same arguments wherever that sum is not zero.
+
+    The arguments are those of :func:`torch.stft`. With :attr:`center`, the
+    first ``n_fft // 2`` samples, which are the padding added by
+    :func:`torch.stft`, are dropped. So are the last ``n_fft // 2`` ones
+    unless :attr:`length`, the length of the original signal, is given, and
+    for that they are only returned once a frame follows them.
+    """
+
+    def __init__(self, n_fft, hop_length=None, win_length=None, window=None,
+                 center=False, normalized=False, onesided=True, length=None):
+        self.n_fft = n_fft
+        self.hop_length = hop_length if hop_length is not None else n_fft // 4
+        if not 0 < self.hop_length <= n_fft:
+            raise ValueError("ISTFTStream: expected 0 < hop_length <= n_fft, but got "
+                             "hop_length={}".format(self.hop_length))
+        self.win_length = win_length
+        self.window = window
+        self.center = center
+        self.normalized = normalized
+        self.onesided = onesided
+        self.length = length
+        self.reset()
+
+    def reset(self):
+        r"""Drops the buffered samples, to start a new signal."""
+        self._signal = None
+        self._remaining = self.length
+        self._envelope = None
+        self._skip = self.n_fft // 2 if self.center else 0
+        self._held = None
+        self._batched = False
+
+    def _emit(self, samples):
+        # drop the left padding, and hold back what may be right padding
+        if self._skip > 0:
+            skipped = min(self._skip, samples.size(-1))
+            samples = samples[..., skipped:]
+            self._skip -= skipped
+        if self._remaining is not None:
+            samples = samples[..., :self._remaining]
+            self._remaining -= samples.size(-1)
+        elif self.center:
+            if self._held is not None:
+                samples = torch.cat([self._held, samples], -1)
+            hold = min(self.n_fft // 2, samples.size(-1))
+            self._held = samples[..., samples.size(-1) - hold:]
+            samples = samples[..., :samples.size(-1) - hold]
+        return samples
+
+    def push(self, input):
+        r"""Appends the frames :attr:`input`, of size :math:`(* \times N
+        \times T \times 2)` as returned by :func:`torch.stft`, and returns the
+        samples they complete."""
+        n_fft, hop = self.n_fft, self.hop_length
+        batched = input.dim() == 4
+        self._batched = batched
+        if not batched:
+            input = input.unsqueeze(0)
+        num_frames = input.size(2)
+        window = _frame_window(n_fft, self.win_length, self.window, input)
+        if num_frames > 0:
+            frames = torch.irfft(input.transpose(1, 2), 1, normalized=self.normalized,
+                                 onesided=self.onesided, signal_sizes=(n_fft,))
+            frames = frames * window
+            length = n_fft + hop * (num_frames - 1)
+            # overlap-add with col2im, which adds the frames in a single pass
+            signal = F.fold(frames.transpose(1, 2), (1, length), (1, n_fft),
+                            stride=(1, hop)).view(input.size(0), length)
+            envelope = F.fold((window * window).view(1, n_fft, 1).expand(1, n_fft, num_frames),
+                              (1, length), (1, n_fft), stride=(1, hop)).view(length)
+            if self._signal is not None:
+                tail = self._signal.size(-1)
+                signal[:, :tail] += self._signal
+                envelope[:tail] += self._envelope
+        else:
+            signal, envelope = self._signal, self._envelope
+            if signal is None:
+                signal = input.new_zeros(input.size(0), 0)
+                envelope = input.new_zeros(0)
+        done = hop * num_frames
+        self._signal = signal[:, done:]
+        self._envelope = envelope[done:]
+        samples = self._normalize(signal[:, :done], envelope[:done])
+        samples = self._emit(samples)
+        return samples if batched else samples.squeeze(0)
+
+    def _normalize(self, signal, envelope):
+        return signal / torch.where(envelope > 1e-11, envelope, torch.ones_like(envelope))
+
+    def flush(self):
+        r"""Returns the remaining samples and resets the stream."""
+        if self._signal is None:
+            raise RuntimeError("ISTFTStream.flush: no frames were pushed")
+        samples = self._emit(self._normalize(self._signal, self._envelope))
+        batched = self._batched
+        self.reset()
+        return samples if batched else samples.squeeze(0)
+
+
+def istft(input, n_fft, hop_length=None, win_length=None, window=None,
+          center=True, normalized=False, onesided=True, length=None):
+    r"""Inverse short-time Fourier transform, recovering the signal from the
+    result of :func:`torch.stft` called with the same arguments.
+
+    The frames are transformed back with :func:`torch.irfft`, multiplied by
+    the window and overlap-added, and each sample is divided by the sum of
+    the squared windows of the frames overlapping it. Samples that no window
+    covers, such as the end of a signal whose length is not a multiple of
+    :attr:`hop_length`, cannot be recovered; :attr:`length` trims or
+    zero-pads the result to the length of the original signal.
+
+    To invert frames as they arrive, see :class:`torch.functional.ISTFTStream`.
+
+    Arguments:
+        input (Tensor): the STFT, of size :math:`(* \times N \times T \times 2)`
+        n_fft, hop_length, win_length, window, center, normalized, onesided:
+            the arguments given to :func:`torch.stft`
+        length (int, optional): the length of the returned signal.
+            Default: ``None`` (as many samples as the frames cover)
+
+    Returns:
+        Tensor: the 1-D signal or 2-D batch of signals
+    """
+    stream = ISTFTStream(n_fft, hop_length, win_length, window, center,
+                         normalized, onesided, length)
+    output = torch.cat([stream.push(input), stream.flush()], -1)
+    if length is not None and output.size(-1) < length:
+        output = F.pad(output, (0, length - output.size(-1)))
+    return output
+
+
+class AliasMultinomial(object):
+    r"""Draws samples with replacement from a fixed categorical distribution
+    by the alias method.
+
+    Building the tables takes :math:`O(K)` time for :math:`K` categories,
+    after which every draw takes :math:`O(1)` time, against the
+    :math:`O(\log K)` binary search per draw of :func:`torch.multinomial`
+    (which also rebuilds the cumulative distribution on every call). This
+    pays off when many samples are drawn from the same distribution, as in
+    negative sampling. On CPU, the samples of one :meth:`draw` are drawn in
+    parallel.
+
+    Arguments:
+        probs (Tensor): 1-D tensor of non-negative weights of the categories.
+            They do not need to sum to one.
+
+    Example::
+
+        >>> counts = torch.tensor([10., 4., 1., 0., 5.])
+        >>> sampler = torch.functional.AliasMultinomial(counts.pow(0.75))
+        >>> sampler.draw(8)
+        tensor([0, 4, 0, 1, 0, 2, 0, 4])
+    """
+
+    def __init__(self, probs):
+        self.alias_table, self.prob_table = torch._multinomial_alias_setup(probs)
+
+    @property
+    def num_categories(self):
+        return self.prob_table.numel()
+
+    def draw(self, num_samples, generator=None):
+        r"""Returns a 1-D ``torch.long`` tensor of :attr:`num_samples`
+        category indices."""
+        return torch._multinomial_alias_draw(self.prob_table, self.alias_table,
+                                             num_samples, generator=generator)
+
+
 del torch.unique_dim
 
 
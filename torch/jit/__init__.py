@@ -73,7 +73,7 @@ def scope(scope_name):
 DEFAULT_EXTRA_FILES_MAP = torch._C.ExtraFilesMap()
 
 
-def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP, lazy=False):
     r"""
         Load a ``ScriptModule`` previously saved with :func:`save <torch.jit.save>`
 
@@ -93,6 +93,11 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             _extra_files: map from filename to content. The extra
                 filenames given in the map would be loaded and their content
                 would be stored in the provided map.
+            lazy: if ``True``, the file is memory-mapped and the tensors of the
+                module are views of the mapping, so they are only read from disk
+                when they are first used. Writing to them doesn't change the
+                file. Requires ``f`` to be a file name, loads onto CPU only, and
+                isn't supported on Windows.
 
 
         Returns:
@@ -119,6 +124,9 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             files = {'metadata.json' : ''}
             torch.jit.load('scriptmodule.pt', _extra_files = files)
             print (files['metadata.json'])
+
+            # Read the tensors of the module only when they are used
+            torch.jit.load('scriptmodule.pt', lazy=True)
     """
     m = ScriptModule()
 
@@ -138,12 +146,20 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
               isinstance(map_location, torch.device)):
         raise ValueError("map_location should be either None, string or torch.device, "
                          "but got type: " + str(type(map_location)))
+    if lazy and map_location is not None and map_location.type != 'cpu':
+        raise ValueError("lazy loading only supports loading onto CPU, "
+                         "but got map_location: " + str(map_location))
     if (str(map_location).startswith('cuda')):
         validate_cuda_device(map_location)
 
-    if isinstance(f, str) or \
-            (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
-            (sys.version_info[0] == 3 and isinstance(f, pathlib.Path)):
+    is_filename = isinstance(f, str) or \
+        (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
+        (sys.version_info[0] == 3 and isinstance(f, pathlib.Path))
+    if lazy:
+        if not is_filename:
+            raise ValueError("lazy loading requires a file name, but got type: " + str(type(f)))
+        torch._C.import_ir_module_lazily(module_lookup, str(f), _extra_files)
+    elif is_filename:
         torch._C.import_ir_module(module_lookup, f, map_location, _extra_files)
     else:
         torch._C.import_ir_module_from_buffer(module_lookup, f.read(), map_location, _extra_files)
@@ -151,6 +167,49 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
     return m
 
 
+def reload_parameters(m, f, map_location=None):
+    r"""
+        Replace the parameters and buffers of the ``ScriptModule`` ``m`` with those
+        of a module previously saved with :func:`save <torch.jit.save>`, without
+        compiling ``m`` again.
+
+        The saved module must have the same structure as ``m``: the same submodules,
+        and parameters and buffers with the same names, dtypes, sizes and
+        ``requires_grad``, and on the same devices once ``map_location`` is applied.
+        Its code, its other attributes and its training flag are ignored. If
+        anything differs, an exception is raised and ``m`` is left unchanged. The
+        methods of ``m`` keep their optimized graphs, so that e.g. a served model
+        can pick up new weights without the cost of :func:`load <torch.jit.load>`.
+        ``m`` must not be run by other threads while its tensors are replaced.
+
+        Arguments:
+            m: the ``ScriptModule`` to update
+            f: a file-like object (has to implement read, readline, tell, and seek),
+                or a string containing a file name
+            map_location: a string (e.g., 'cpu', 'cuda:0') or a device, as for
+                :func:`load <torch.jit.load>`
+
+        Example: ::
+
+            model = torch.jit.load('model.pt')
+            ...
+            torch.jit.reload_parameters(model, 'model_retrained.pt')
+    """
+    if isinstance(map_location, string_classes):
+        map_location = torch.device(map_location)
+    elif not (map_location is None or
+              isinstance(map_location, torch.device)):
+        raise ValueError("map_location should be either None, string or torch.device, "
+                         "but got type: " + str(type(map_location)))
+    is_filename = isinstance(f, str) or \
+        (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
+        (sys.version_info[0] == 3 and isinstance(f, pathlib.Path))
+    if is_filename:
+        torch._C.reload_ir_module_parameters(m._c, str(f), map_location)
+    else:
+        torch._C.reload_ir_module_parameters_from_buffer(m._c, f.read(), map_location)
+
+
 def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
     """
         Save an offline version of this module for use in a separate process. The saved
@@ -469,7 +528,8 @@ class TracingCheckError(Exception):
 
 # Check the traced module against a set of user-provided validation inputs
 @torch.no_grad()
-def _check_trace(check_inputs, func, executor_options, traced_func, check_tolerance, force_outplace, is_trace_module):
+def _check_trace(check_inputs, func, executor_options, traced_func, check_tolerance, force_outplace, is_trace_module,
+                 reuse_module_traces=False):
     # Note: tracing is independent of optimizations, which consume the trace
     executor_options['optimize'] = False
     for inputs in check_inputs:
@@ -486,6 +546,7 @@ def _check_trace(check_inputs, func, executor_options, traced_func, check_tolera
                 copied_dict,
                 check_trace=False,
                 _force_outplace=force_outplace,
+                _reuse_module_traces=reuse_module_traces,
                 **executor_options)
             check_mod_func = check_mod._c._get_method(traced_func.name)
             inputs = inputs[traced_func.name]
@@ -497,6 +558,7 @@ def _check_trace(check_inputs, func, executor_options, traced_func, check_tolera
                 _clone_inputs(inputs),
                 check_trace=False,
                 _force_outplace=force_outplace,
+                _reuse_module_traces=reuse_module_traces,
                 **executor_options)
             check_mod_func = check_mod
 
@@ -639,6 +701,109 @@ def make_module(mod, _module_class, executor_options):
     return _module_class(mod, **executor_options)
 
 
+# See Note [Reusing module traces] in tracer.h. Calls of modules with the same
+# structure, on inputs with the same types, shapes and aliasing, trace to the
+# same graph, so only the first of them is traced and the graph it produced is
+# inserted for the others.
+_MODULE_INTERNAL_ATTRS = {'_parameters', '_buffers', '_modules', '_backward_hooks', '_forward_hooks',
+                          '_forward_pre_hooks', '_state_dict_hooks', '_load_state_dict_pre_hooks'}
+
+
+def _with_reused_module_traces(func):
+    def traced_fn(*args, **kwargs):
+        tracing_state = torch._C._get_tracing_state()
+        tracing_state.record_source_locations = False
+        tracing_state._module_traces = {}
+        return func(*args, **kwargs)
+    return traced_fn
+
+
+def _is_plain_value(value):
+    if isinstance(value, (tuple, list)):
+        return all(_is_plain_value(v) for v in value)
+    return value is None or isinstance(value, (bool, int, float, str, torch.dtype, torch.device))
+
+
+def _module_structure(module):
+    # None if the trace of the module could depend on something that isn't
+    # captured by its structure, its parameters and its inputs
+    if module._backward_hooks or module._forward_hooks or module._forward_pre_hooks:
+        return None
+    attrs = []
+    for name, value in sorted(module.__dict__.items()):
+        if name in _MODULE_INTERNAL_ATTRS:
+            continue
+        if not _is_plain_value(value):
+            return None
+        attrs.append((name, repr(value)))
+    children = []
+    for name, child in module._modules.items():
+        child_structure = _module_structure(child) if child is not None else ()
+        if child_structure is None:
+            return None
+        children.append((name, child_structure))
+    return (type(module), tuple(attrs), tuple(module._parameters.keys()),
+            tuple(module._buffers.keys()), tuple(children))
+
+
+def _module_state(module):
+    # unlike named_parameters() this doesn't deduplicate shared modules or
+    # tensors, so that the order matches the structure of the module
+    state = list(module._parameters.values()) + list(module._buffers.values())
+    for child in module._modules.values():
+        if child is not None:
+            state += _module_state(child)
+    return state
+
+
+def _tensor_signature(tensors):
+    signature = []
+    first_index = {}
+    for i, t in enumerate(tensors):
+        if t is None:
+            signature.append(None)
+        else:
+            alias = first_index.setdefault(id(t), i)
+            signature.append((t.dtype, t.device, t.shape, t.requires_grad, alias))
+    return tuple(signature)
+
+
+def _call_with_reused_trace(module, module_traces, inputs, kwargs):
+    structure = _module_structure(module)
+    if kwargs or structure is None or not all(isinstance(i, torch.Tensor) for i in inputs):
+        return module.forward(*inputs, **kwargs)
+    state = _module_state(module)
+    tensors = list(inputs) + [t for t in state if t is not None]
+    values = torch._C._tracer_find_value_traces(tensors)
+    if values is None:
+        return module.forward(*inputs)
+    key = (structure, _tensor_signature(list(inputs) + state))
+
+    trace = module_traces.get(key)
+    if trace is not None:
+        with _disable_tracing():
+            outputs = module.forward(*inputs)
+        flat_outputs, _ = _flatten(outputs)
+        if len(flat_outputs) + len(tensors) != len(list(trace.outputs())):
+            raise RuntimeError("Reusing the trace of a {} failed because its outputs changed. Pass "
+                               "_reuse_module_traces=False to trace it".format(type(module).__name__))
+        # inputs and parameters are outputs as well, in case they were updated in place
+        torch._C._tracer_replay_trace(trace, values, flat_outputs + tensors)
+        return outputs
+
+    begin = torch._C._tracer_last_node()
+    outputs = module.forward(*inputs)
+    if key not in module_traces:
+        # None if the trace can't be reused, so that it isn't extracted again
+        try:
+            flat_outputs, _ = _flatten(outputs)
+        except RuntimeError:
+            module_traces[key] = None
+        else:
+            module_traces[key] = torch._C._tracer_extract_trace(begin, values, flat_outputs + tensors)
+    return outputs
+
+
 def trace(func,
           example_inputs,
           optimize=True,
@@ -646,7 +811,8 @@ def trace(func,
           check_inputs=None,
           check_tolerance=1e-5,
           _force_outplace=False,
-          _module_class=None):
+          _module_class=None,
+          _reuse_module_traces=False):
     """
     Trace a function and return an executable ``ScriptModule`` that will be optimized
     using just-in-time compilation.
@@ -722,13 +888,15 @@ def trace(func,
     if isinstance(func, torch.nn.Module):
         return trace_module(func, {'forward': example_inputs}, optimize,
                             check_trace, check_inputs,
-                            check_tolerance, _force_outplace, _module_class)
+                            check_tolerance, _force_outplace, _module_class,
+                            _reuse_module_traces)
 
     if (hasattr(func, '__self__') and isinstance(func.__self__, torch.nn.Module) and
             func.__name__ == 'forward'):
         return trace_module(func.__self__, {'forward': example_inputs}, optimize,
                             check_trace, check_inputs,
-                            check_tolerance, _force_outplace, _module_class)
+                            check_tolerance, _force_outplace, _module_class,
+                            _reuse_module_traces)
 
     executor_options = {'optimize': bool(optimize)}
     # Special case for common case of passing a single Tensor
@@ -747,16 +915,19 @@ def trace(func,
     name = getattr(func, '__name__', 'forward')
     if name == '<lambda>':
         name = '_lambda'  # make name a valid identifier
-    traced = torch._C._create_function_from_trace(name, func, example_inputs,
+    traced_fn = _with_reused_module_traces(func) if _reuse_module_traces else func
+    traced = torch._C._create_function_from_trace(name, traced_fn, example_inputs,
                                                   var_lookup_fn,
                                                   _force_outplace)
 
     # Check the trace against new traces created from user-specified inputs
     if check_trace:
         if check_inputs is not None:
-            _check_trace(check_inputs, func, executor_options, traced, check_tolerance, _force_outplace, False)
+            _check_trace(check_inputs, func, executor_options, traced, check_tolerance, _force_outplace, False,
+                         _reuse_module_traces)
         else:
-            _check_trace([example_inputs], func, executor_options, traced, check_tolerance, _force_outplace, False)
+            _check_trace([example_inputs], func, executor_options, traced, check_tolerance, _force_outplace, False,
+                         _reuse_module_traces)
 
     return traced
 
@@ -768,7 +939,8 @@ def trace_module(mod,
                  check_inputs=None,
                  check_tolerance=1e-5,
                  _force_outplace=False,
-                 _module_class=None):
+                 _module_class=None,
+                 _reuse_module_traces=False):
     """
     Trace a function and return an executable ``ScriptModule`` that will be optimized
     using just-in-time compilation.
@@ -840,17 +1012,18 @@ def trace_module(mod,
         # this is needed since Module.__call__ sets up some extra tracing
         func = mod if method_name == "forward" else getattr(mod, method_name)
         example_inputs = make_tuple(example_inputs)
-        module._c._create_method_from_trace(method_name, func, example_inputs, var_lookup_fn, _force_outplace)
+        traced_fn = _with_reused_module_traces(func) if _reuse_module_traces else func
+        module._c._create_method_from_trace(method_name, traced_fn, example_inputs, var_lookup_fn, _force_outplace)
         check_trace_method = module._c._get_method(method_name)
 
         # Check the trace against new traces created from user-specified inputs
         if check_trace:
             if check_inputs is not None:
                 _check_trace(check_inputs, func, executor_options, check_trace_method,
-                             check_tolerance, _force_outplace, True)
+                             check_tolerance, _force_outplace, True, _reuse_module_traces)
             else:
                 _check_trace([inputs], func, executor_options, check_trace_method,
-                             check_tolerance, _force_outplace, True)
+                             check_tolerance, _force_outplace, True, _reuse_module_traces)
 
         return module
 
@@ -1201,12 +1374,79 @@ def _get_valid_constant(attr, v):
         """.format(type(v).__name__, attr, constants)))
 
 
+# Modules whose methods were compiled from stubs, by compilation key (see
+# _get_compilation_key). Identical modules, e.g. the layers of a deep network,
+# share the compiled methods of the first one instead of compiling them again.
+# The values are (stubs, weakref to the module): keeping the stubs alive keeps
+# their ids, which are part of the key, from being reused.
+_compiled_modules = {}
+
+
+def _get_compilation_key(self, stubs):
+    r"""
+    Returns a key that identifies everything the compiled methods of ``self``
+    can depend on besides its parameters and attributes: the code of the
+    methods, the constants, the structure of the module, and the keys of its
+    submodules. Returns None if the module can't share compiled methods.
+    """
+    if self._c._get_functions():
+        # methods that weren't compiled from stubs
+        return None
+    submodules = []
+    for name, submodule in self._modules.items():
+        if not isinstance(submodule, ScriptModule):
+            return None
+        key = submodule.__dict__.get('_compilation_key')
+        # the submodule may have been given more methods after it was compiled
+        if key is None or len(submodule._c._get_functions()) != len(key[0]):
+            return None
+        submodules.append((name, key))
+    constants = []
+    for name in sorted(self._constants_set):
+        if self._c._has_attribute(name) or self._c._has_parameter(name) or self._c._has_module(name):
+            continue
+        value = getattr(self, name, None)
+        if isinstance(value, Module):
+            continue
+        constants.append((name, repr(value)))
+    parameters = tuple(name for name, _ in self._c._get_parameters())
+    attributes = tuple((name, str(the_type)) for name, the_type, _ in self._c._get_attributes())
+    return (tuple(id(stub) for stub in stubs), self._c._is_optimized(), tuple(constants),
+            parameters, attributes, tuple(submodules))
+
+
+def _copy_training_buffers(orig, module):
+    # Compilation registers a 'training' buffer on the modules whose
+    # `training` flag is used, which a module sharing the compiled methods
+    # needs as well.
+    if orig._c._has_buffer('training') and not module._c._has_buffer('training'):
+        module._c._register_buffer('training', torch.tensor(1 if module.training else 0))
+    for name, submodule in orig._modules.items():
+        _copy_training_buffers(submodule, module._modules[name])
+
+
 def _create_methods_from_stubs(self, stubs):
+    key = _get_compilation_key(self, stubs)
+    if key is not None and key in _compiled_modules:
+        orig = _compiled_modules[key][1]()
+        if orig is not None:
+            _copy_training_buffers(orig, self)
+            if self._c._share_methods_from(orig._c):
+                self.__dict__['_compilation_key'] = key
+                return
+
     defs = [m.def_ for m in stubs]
     rcbs = [m.resolution_callback for m in stubs]
     defaults = [get_default_args(m.original_method) for m in stubs]
     self._c._create_methods(self, defs, rcbs, defaults)
 
+    if key is not None and self._c._can_share_methods():
+        def remove(ref):
+            if _compiled_modules.get(key, (None, None))[1] is ref:
+                del _compiled_modules[key]
+        _compiled_modules[key] = (stubs, weakref.ref(self, remove))
+        self.__dict__['_compilation_key'] = key
+
 # For each user-defined class that subclasses ScriptModule this meta-class,
 # (1) finds all the methods annotated with @script_method
 # in a ScriptModule and removes them from the class attributes, and
@@ -1411,6 +1651,19 @@ if _enabled:
         def save_to_buffer(self, *args, **kwargs):
             return self._c.save_to_buffer(*args, **kwargs)
 
+        def _save_for_mobile(self, *args, **kwargs):
+            r"""
+            Saves the bytecode of the methods of the module, which is loaded by
+            ``torch._C._load_for_mobile`` or ``torch::jit::mobile::_load_for_mobile``
+            in C++, and run without compiling the module. The module must only
+            call operators that don't depend on the nodes they are called for,
+            which e.g. excludes ``torch.jit._fork``.
+            """
+            return self._c._save_for_mobile(*args, **kwargs)
+
+        def _save_to_buffer_for_mobile(self, *args, **kwargs):
+            return self._c._save_to_buffer_for_mobile(*args, **kwargs)
+
         def get_debug_state(self, *args, **kwargs):
             return self._c.get_debug_state()
 
@@ -1,9 +1,22 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include <nccl.h>
 
+// ncclCommGetAsyncError and ncclCommAbort were introduced in NCCL 2.4.
+#if defined(NCCL_MAJOR) && \
+    ((NCCL_MAJOR > 2) || (NCCL_MAJOR == 2 && NCCL_MINOR >= 4))
+#define ENABLE_NCCL_ERROR_CHECKING
+#endif
+
+// ncclSend and ncclRecv were introduced in NCCL 2.7.
+#if defined(NCCL_MAJOR) && \
+    ((NCCL_MAJOR > 2) || (NCCL_MAJOR == 2 && NCCL_MINOR >= 7))
+#define ENABLE_NCCL_P2P_SUPPORT
+#endif
+
 #define C10D_NCCL_CHECK(cmd)                                              \
   do {                                                                    \
     ncclResult_t error = cmd;                                             \
@@ -25,7 +38,8 @@ class NCCLComm {
   NCCLComm() : NCCLComm(nullptr) {}
 
   ~NCCLComm() noexcept(false) {
-    if (ncclComm_) {
+    // An aborted communicator has already released its resources.
+    if (ncclComm_ && !aborted_) {
       C10D_NCCL_CHECK(ncclCommDestroy(ncclComm_));
     }
   }
@@ -47,19 +61,70 @@ class NCCLComm {
   // Move constructable
   NCCLComm(NCCLComm&& other) {
     std::swap(ncclComm_, other.ncclComm_);
+    std::swap(aborted_, other.aborted_);
+    std::swap(ncclAsyncErr_, other.ncclAsyncErr_);
   }
   // Move assignable
   NCCLComm& operator=(NCCLComm&& other) {
     std::swap(ncclComm_, other.ncclComm_);
+    std::swap(aborted_, other.aborted_);
+    std::swap(ncclAsyncErr_, other.ncclAsyncErr_);
     return *this;
   }
 
   ncclComm_t getNcclComm() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (aborted_) {
+      throw std::runtime_error(
+          "NCCL communicator was aborted, most likely because of an error or "
+          "timeout in a previous collective");
+    }
     return ncclComm_;
   }
 
+  // Aborts the communicator, which makes the NCCL kernels that are still
+  // running on it return, instead of blocking their GPU forever. Can be
+  // called from any thread; the communicator cannot be used afterwards.
+  void ncclCommAbort() {
+    std::unique_lock<std::mutex> lock(mutex_);
+#ifdef ENABLE_NCCL_ERROR_CHECKING
+    if (aborted_) {
+      return;
+    }
+    C10D_NCCL_CHECK(::ncclCommAbort(ncclComm_));
+    aborted_ = true;
+#else
+    throw std::runtime_error(
+        "Aborting NCCL communicators requires NCCL 2.4 or later");
+#endif
+  }
+
+  bool isAborted() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return aborted_;
+  }
+
+  // Returns the asynchronous error the communicator ran into, e.g. because
+  // a peer went away, or ncclSuccess. Once an error was seen, it is returned
+  // by every later call.
+  ncclResult_t checkForNcclError() {
+    std::unique_lock<std::mutex> lock(mutex_);
+#ifdef ENABLE_NCCL_ERROR_CHECKING
+    if (ncclAsyncErr_ != ncclSuccess || aborted_) {
+      return ncclAsyncErr_;
+    }
+    C10D_NCCL_CHECK(ncclCommGetAsyncError(ncclComm_, &ncclAsyncErr_));
+    return ncclAsyncErr_;
+#else
+    return ncclSuccess;
+#endif
+  }
+
  protected:
   ncclComm_t ncclComm_;
+  bool aborted_ = false;
+  ncclResult_t ncclAsyncErr_ = ncclSuccess;
+  mutable std::mutex mutex_;
 };
 
 } // namespace c10d
@@ -48,4 +48,20 @@ ProcessGroup::ProcessGroup(int rank, int size) : rank_(rank), size_(size) {}
 
 ProcessGroup::~ProcessGroup() {}
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::allreduce_coalesced(
+    std::vector<at::Tensor>& /* unused */,
+    const AllreduceOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroup does not support allreduce_coalesced");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::alltoall_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroup does not support alltoall");
+}
+
 } // namespace c10d
@@ -7,6 +7,7 @@
 #include <gloo/gather.h>
 #include <gloo/reduce.h>
 #include <gloo/scatter.h>
+#include <gloo/types.h>
 
 #ifdef USE_CUDA
 #include <ATen/cuda/CUDAEvent.h>
@@ -18,6 +19,7 @@
 #endif
 
 #include <gloo/rendezvous/context.h>
+#include <gloo/rendezvous/prefix_store.h>
 #include <gloo/transport/tcp/device.h>
 
 #define GENERATE_ALL_TYPES(type, func, args...)        \
@@ -115,6 +117,19 @@ void setOutputs(O& opts, std::vector<at::Tensor>& tensors) {
   opts.setOutputs(getDataPointers<T>(tensors), tensors[0].numel());
 }
 
+template <typename T, typename O>
+void setOutputs(
+    O& opts,
+    std::vector<at::Tensor>& tensors,
+    size_t offset,
+    size_t length) {
+  auto ptrs = getDataPointers<T>(tensors);
+  for (auto& ptr : ptrs) {
+    ptr += offset;
+  }
+  opts.setOutputs(ptrs, length);
+}
+
 template <typename T, typename O>
 void setOutput(O& opts, at::Tensor& tensor) {
   opts.setOutput(getDataPointer<T>(tensor), tensor.numel());
@@ -275,10 +290,13 @@ ProcessGroupGloo::ProcessGroupGloo(
     throw std::runtime_error("No device(s) specified");
   }
 
-  for (auto& device : options.devices) {
+  // Every context needs its own rendezvous keys, so prefix them with the
+  // index of the device it connects over.
+  for (size_t i = 0; i < options.devices.size(); i++) {
     auto context = std::make_shared<::gloo::rendezvous::Context>(rank_, size_);
+    auto store = ::gloo::rendezvous::PrefixStore(std::to_string(i), *store_);
     context->setTimeout(options.timeout);
-    context->connectFullMesh(*store_, device);
+    context->connectFullMesh(store, options.devices[i]);
     contexts_.push_back(std::move(context));
   }
 
@@ -316,6 +334,10 @@ uint32_t ProcessGroupGloo::nextTag() {
   return collectiveCounter_++;
 }
 
+std::shared_ptr<::gloo::Context> ProcessGroupGloo::getContext(uint32_t tag) {
+  return contexts_[tag % contexts_.size()];
+}
+
 void ProcessGroupGloo::runLoop(int workerIndex) {
   std::unique_lock<std::mutex> lock(workMutex_);
 
@@ -479,14 +501,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::broadcast(
   }
 
   std::shared_ptr<AsyncBroadcastWork> work;
-  auto& context = contexts_[0];
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncBroadcastWork>(
-        context, inputs, opts.rootRank, opts.rootTensor, nextTag());
+        context, inputs, opts.rootRank, opts.rootTensor, tag);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncBroadcastCUDAWork>(
-        context, inputs, opts.rootRank, opts.rootTensor, nextTag());
+        context, inputs, opts.rootRank, opts.rootTensor, tag);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -498,29 +521,89 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::broadcast(
 
 namespace {
 
+// Note [Multiple Gloo devices]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Every device in the options of a process group gets its own context, with
+// its own pair to every peer. A single pair (a single TCP connection) cannot
+// saturate a fast link, so listing the same device multiple times gives the
+// process group multiple connections to every peer. Consecutive collectives
+// use the contexts in turn, which lets collectives executed concurrently by
+// the worker threads use different connections. A large allreduce is split
+// into stripes instead, which are reduced concurrently, each over its own
+// context. The tag of a collective decides on its context(s), and tags are
+// identical across processes, so all processes pick the same ones.
 class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncAllreduceWork(
-      const std::shared_ptr<gloo::Context>& context,
+      const std::vector<std::shared_ptr<gloo::Context>>& contexts,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
       uint32_t tag)
-      : context(context), inputs(inputs), reduceOp(reduceOp), tag(tag) {}
+      : contexts(contexts), inputs(inputs), reduceOp(reduceOp), tag(tag) {}
 
-  std::shared_ptr<gloo::Context> context;
+  // Allreduces smaller than twice this size are not striped.
+  static constexpr size_t kMinBytesPerStripe = 256 * 1024;
+
+  std::vector<std::shared_ptr<gloo::Context>> contexts;
   std::vector<at::Tensor> inputs;
   const ReduceOp reduceOp;
   const uint32_t tag;
 
-  void allreduce(std::vector<at::Tensor>& tensors) {
+  // Allreduces `length` elements of the tensors, starting at `offset`.
+  void allreduce(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& tensors,
+      size_t offset,
+      size_t length) {
     const auto& scalarType = tensors[0].scalar_type();
     gloo::AllreduceOptions opts(context);
     opts.setReduceFunction(getFunction(scalarType, reduceOp));
     opts.setTag(tag);
-    GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
+    GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors, offset, length);
     gloo::allreduce(opts);
   }
 
+  void allreduce(std::vector<at::Tensor>& tensors) {
+    const size_t numel = tensors[0].numel();
+    const size_t bytes = numel * tensors[0].element_size();
+    const size_t stripes = std::min(
+        contexts.size(), std::max<size_t>(bytes / kMinBytesPerStripe, 1));
+    if (stripes == 1) {
+      allreduce(contexts[tag % contexts.size()], tensors, 0, numel);
+      return;
+    }
+
+    // Reduce the stripes concurrently. See Note [Multiple Gloo devices].
+    const size_t stripeLength = (numel + stripes - 1) / stripes;
+    std::vector<std::exception_ptr> eptrs(stripes);
+    auto runStripe = [&](size_t i) {
+      try {
+        const size_t offset = i * stripeLength;
+        allreduce(
+            contexts[i],
+            tensors,
+            offset,
+            std::min(stripeLength, numel - offset));
+      } catch (...) {
+        eptrs[i] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(stripes - 1);
+    for (size_t i = 1; i < stripes; i++) {
+      threads.emplace_back(runStripe, i);
+    }
+    runStripe(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& eptr : eptrs) {
+      if (eptr) {
+        std::rethrow_exception(eptr);
+      }
+    }
+  }
+
   void run() override {
     allreduce(inputs);
 
@@ -552,11 +635,11 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
 class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCUDAWork(
-      const std::shared_ptr<gloo::Context>& context,
+      const std::vector<std::shared_ptr<gloo::Context>>& contexts,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
       uint32_t tag)
-      : AsyncAllreduceWork(context, inputs, reduceOp, tag) {
+      : AsyncAllreduceWork(contexts, inputs, reduceOp, tag) {
     initializeStreamsEvents(inputs, streams, events);
 
     // Kick off copy from CUDA tensors to pinned CPU tensors.
@@ -608,6 +691,177 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
 
 #endif
 
+// Note [Sparse allreduce]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// A sparse tensor is allreduced by allgathering the indices and values of
+// every process and summing them locally, so the bytes sent are proportional
+// to the number of nonzero entries instead of to the dense size. Gloo's
+// allgather requires inputs of the same size everywhere, so the number of
+// nonzero entries of every process is allgathered first, and the indices and
+// values are padded to the largest of them. Only ReduceOp::SUM is supported.
+class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncSparseAllreduceWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      uint32_t tag)
+      : context(context), inputs(inputs), tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  std::vector<at::Tensor> inputs;
+  const uint32_t tag;
+
+  // Allgathers a dense tensor that has the same sizes in every process.
+  // The first dimension of the result is the rank of the contributing process.
+  at::Tensor allgather(at::Tensor tensor) {
+    tensor = tensor.contiguous();
+    auto sizes = tensor.sizes().vec();
+    sizes.insert(sizes.begin(), context->size);
+    at::Tensor output = at::empty(sizes, tensor.options());
+
+    const auto& scalarType = tensor.scalar_type();
+    gloo::AllgatherOptions opts(context);
+    opts.setTag(tag);
+    GENERATE_ALL_TYPES(scalarType, setInput, opts, tensor);
+    GENERATE_ALL_TYPES(scalarType, setOutput, opts, output);
+    gloo::allgather(opts);
+    return output;
+  }
+
+  at::Tensor allreduce(std::vector<at::Tensor>& tensors) {
+    // Sum the tensors of this process before exchanging anything.
+    auto input = tensors[0];
+    for (size_t i = 1; i < tensors.size(); i++) {
+      input = input + tensors[i];
+    }
+    input = input.coalesce();
+
+    const int64_t sparseDim = input.sparse_dim();
+    const int64_t denseDim = input.dense_dim();
+    const int64_t nnz = input._nnz();
+    auto localMetadata = at::empty({3}, at::kLong);
+    auto localMetadataAccessor = localMetadata.accessor<int64_t, 1>();
+    localMetadataAccessor[0] = sparseDim;
+    localMetadataAccessor[1] = denseDim;
+    localMetadataAccessor[2] = nnz;
+    const auto metadata = allgather(localMetadata);
+    auto metadataAccessor = metadata.accessor<int64_t, 2>();
+    int64_t maxNnz = 0;
+    for (int i = 0; i < context->size; i++) {
+      if (metadataAccessor[i][0] != sparseDim ||
+          metadataAccessor[i][1] != denseDim) {
+        throw std::invalid_argument(
+            "ProcessGroupGloo::allreduce: sparse tensors must have the same "
+            "number of sparse and dense dimensions in every process");
+      }
+      maxNnz = std::max(maxNnz, metadataAccessor[i][2]);
+    }
+    if (maxNnz == 0) {
+      return input;
+    }
+
+    // Pad the indices and values to the largest number of nonzero entries.
+    auto indices = at::zeros({sparseDim, maxNnz}, input._indices().options());
+    indices.narrow(1, 0, nnz).copy_(input._indices());
+    auto valuesSizes = input._values().sizes().vec();
+    valuesSizes[0] = maxNnz;
+    auto values = at::zeros(valuesSizes, input._values().options());
+    values.narrow(0, 0, nnz).copy_(input._values());
+
+    const auto allIndices = allgather(indices);
+    const auto allValues = allgather(values);
+
+    // Concatenate the entries of all processes without their padding.
+    // Coalescing the result adds up the values of the same indices.
+    std::vector<at::Tensor> indicesList;
+    std::vector<at::Tensor> valuesList;
+    indicesList.reserve(context->size);
+    valuesList.reserve(context->size);
+    for (int i = 0; i < context->size; i++) {
+      const auto length = metadataAccessor[i][2];
+      indicesList.push_back(allIndices[i].narrow(1, 0, length));
+      valuesList.push_back(allValues[i].narrow(0, 0, length));
+    }
+    return at::sparse_coo_tensor(
+               at::cat(indicesList, 1),
+               at::cat(valuesList, 0),
+               input.sizes(),
+               input.options())
+        .coalesce();
+  }
+
+  void run() override {
+    auto output = allreduce(inputs);
+    for (size_t i = 0; i < inputs.size(); i++) {
+      inputs[i].copy_(output);
+    }
+  }
+};
+
+#ifdef USE_CUDA
+
+class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
+ public:
+  AsyncSparseAllreduceCUDAWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      uint32_t tag)
+      : AsyncSparseAllreduceWork(context, inputs, tag) {
+    // Like initializeStreamsEvents, except that the memory of a sparse
+    // tensor is held by its indices and values rather than by a storage.
+    at::cuda::OptionalCUDAGuard guard;
+    streams.reserve(inputs.size());
+    events.resize(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.set_index(inputs[i].device().index());
+      events[i].record(at::cuda::getCurrentCUDAStream());
+      streams.push_back(at::cuda::getStreamFromPool(
+          /* isHighPriority */ true, inputs[i].device().index()));
+      events[i].block(streams[i]);
+      c10::cuda::CUDACachingAllocator::recordStream(
+          inputs[i]._indices().storage().data(), streams[i]);
+      c10::cuda::CUDACachingAllocator::recordStream(
+          inputs[i]._values().storage().data(), streams[i]);
+    }
+  }
+
+  void run() override {
+    // Copy the CUDA tensors to host memory. Coalescing a sparse tensor
+    // synchronizes with the device anyway, so these copies are blocking.
+    at::cuda::OptionalCUDAStreamGuard guard;
+    std::vector<at::Tensor> tmp;
+    tmp.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(streams[i]);
+      tmp.push_back(inputs[i].coalesce().to(at::kCPU));
+    }
+
+    // Run allreduce on host side tensors.
+    auto output = allreduce(tmp);
+
+    // Kick off copy back to the CUDA tensors.
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(streams[i]);
+      inputs[i].copy_(output, /* non_blocking */ true);
+      events[i].record(streams[i]);
+    }
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.set_index(inputs[i].device().index());
+      events[i].block(at::cuda::getCurrentCUDAStream());
+    }
+  }
+
+  std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> events;
+};
+
+#endif
+
 } // namespace
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
@@ -618,7 +872,6 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   };
 
   assertNonEmpty(invalidArgument, inputs);
-  assertDense(invalidArgument, inputs);
   assertTypeAndSizesMatch(invalidArgument, inputs);
 
   const auto& device = inputs[0].device();
@@ -632,15 +885,42 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
       invalidArgument("unsupported device type");
   }
 
-  std::shared_ptr<AsyncAllreduceWork> work;
-  auto& context = contexts_[0];
+  const auto& layout = inputs[0].layout();
+  switch (layout) {
+    case at::kStrided:
+      break;
+    case at::kSparse:
+      // See Note [Sparse allreduce].
+      if (opts.reduceOp != ReduceOp::SUM) {
+        invalidArgument(
+            "unsupported reduction operation "
+            "(allreduce of sparse tensors only works with ReduceOp.SUM)");
+      }
+      break;
+    default:
+      invalidArgument("unsupported layout");
+  }
+
+  std::shared_ptr<AsyncWork> work;
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
-    work = std::make_shared<AsyncAllreduceWork>(
-        context, inputs, opts.reduceOp, nextTag());
+    if (layout == at::kStrided) {
+      work = std::make_shared<AsyncAllreduceWork>(
+          contexts_, inputs, opts.reduceOp, tag);
+    } else {
+      work = std::make_shared<AsyncSparseAllreduceWork>(
+          context, inputs, tag);
+    }
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
-    work = std::make_shared<AsyncAllreduceCUDAWork>(
-        context, inputs, opts.reduceOp, nextTag());
+    if (layout == at::kStrided) {
+      work = std::make_shared<AsyncAllreduceCUDAWork>(
+          contexts_, inputs, opts.reduceOp, tag);
+    } else {
+      work = std::make_shared<AsyncSparseAllreduceCUDAWork>(
+          context, inputs, tag);
+    }
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -789,7 +1069,8 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce(
   }
 
   std::shared_ptr<AsyncReduceWork> work;
-  auto& context = contexts_[0];
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncReduceWork>(
         context,
@@ -797,7 +1078,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce(
         opts.rootRank,
         opts.rootTensor,
         opts.reduceOp,
-        nextTag());
+        tag);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncReduceCUDAWork>(
@@ -806,7 +1087,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce(
         opts.rootRank,
         opts.rootTensor,
         opts.reduceOp,
-        nextTag());
+        tag);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -995,14 +1276,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allgather(
   }
 
   std::shared_ptr<AsyncAllgatherWork> work;
-  auto& context = contexts_[0];
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncAllgatherWork>(
-        context, outputs, inputs, nextTag());
+        context, outputs, inputs, tag);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncAllgatherCUDAWork>(
-        context, outputs, inputs, nextTag());
+        context, outputs, inputs, tag);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -1192,14 +1474,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::gather(
   }
 
   std::shared_ptr<AsyncGatherWork> work;
-  auto& context = contexts_[0];
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncGatherWork>(
-        context, outputs, inputs, opts.rootRank, nextTag());
+        context, outputs, inputs, opts.rootRank, tag);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncGatherCUDAWork>(
-        context, outputs, inputs, opts.rootRank, nextTag());
+        context, outputs, inputs, opts.rootRank, tag);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -1371,14 +1654,15 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   }
 
   std::shared_ptr<AsyncScatterWork> work;
-  auto& context = contexts_[0];
+  const auto tag = nextTag();
+  auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncScatterWork>(
-        context, outputs, inputs, opts.rootRank, nextTag());
+        context, outputs, inputs, opts.rootRank, tag);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncScatterCUDAWork>(
-        context, outputs, inputs, opts.rootRank, nextTag());
+        context, outputs, inputs, opts.rootRank, tag);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -1387,11 +1671,443 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   return work;
 }
 
+namespace {
+
+// Gloo has no alltoall and reduce_scatter algorithms, so these exchange the
+// slices of their tensors directly through unbound buffers. Every process
+// sends each slice straight to the process it belongs to, which is what a
+// ring or tree would have to send as well, and receives from all processes
+// concurrently. The processes start with different peers, so that they don't
+// all send to the same process first. Slots are built from the collective's
+// tag, so they don't collide with concurrent collectives or user send/recv.
+constexpr uint8_t kAlltoallSlotPrefix = 0x11;
+constexpr uint8_t kReduceScatterSlotPrefix = 0x12;
+
+// Reduces `tensor' into `result' with `op'
+void reduceInto(at::Tensor& result, const at::Tensor& tensor, ReduceOp op) {
+  switch (op) {
+    case ReduceOp::SUM:
+      result.add_(tensor);
+      break;
+    case ReduceOp::PRODUCT:
+      result.mul_(tensor);
+      break;
+    case ReduceOp::MIN:
+      at::min_out(result, result, tensor);
+      break;
+    case ReduceOp::MAX:
+      at::max_out(result, result, tensor);
+      break;
+    default:
+      throw std::runtime_error("Unhandled ReduceOp");
+  }
+}
+
+class AsyncAlltoallWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAlltoallWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      uint32_t tag)
+      : context(context),
+        outputTensor(outputTensor),
+        inputTensor(inputTensor),
+        outputCounts(outputCounts),
+        inputCounts(inputCounts),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  at::Tensor outputTensor;
+  at::Tensor inputTensor;
+  std::vector<int64_t> outputCounts;
+  std::vector<int64_t> inputCounts;
+  const uint32_t tag;
+
+  void alltoall(at::Tensor& outputTensor, at::Tensor& inputTensor) {
+    const int rank = context->rank;
+    const int size = context->size;
+    const size_t elementSize = inputTensor.element_size();
+    std::vector<size_t> sendLengths(size), sendOffsets(size);
+    std::vector<size_t> recvLengths(size), recvOffsets(size);
+    computeLengthsAndOffsets(
+        inputCounts, inputTensor, &sendLengths, &sendOffsets);
+    computeLengthsAndOffsets(
+        outputCounts, outputTensor, &recvLengths, &recvOffsets);
+
+    const auto slot = gloo::Slot::build(kAlltoallSlotPrefix, tag);
+    auto sendBuffer = context->createUnboundBuffer(
+        inputTensor.data_ptr(), inputTensor.numel() * elementSize);
+    auto recvBuffer = context->createUnboundBuffer(
+        outputTensor.data_ptr(), outputTensor.numel() * elementSize);
+    size_t numSends = 0;
+    size_t numRecvs = 0;
+    for (int i = 1; i < size; i++) {
+      const int dst = (rank + i) % size;
+      const int src = (rank - i + size) % size;
+      if (sendLengths[dst] > 0) {
+        sendBuffer->send(
+            dst,
+            slot,
+            sendOffsets[dst] * elementSize,
+            sendLengths[dst] * elementSize);
+        numSends++;
+      }
+      if (recvLengths[src] > 0) {
+        recvBuffer->recv(
+            src,
+            slot,
+            recvOffsets[src] * elementSize,
+            recvLengths[src] * elementSize);
+        numRecvs++;
+      }
+    }
+
+    // The slice this process keeps doesn't go through the transport.
+    AT_ASSERT(sendLengths[rank] == recvLengths[rank]);
+    if (sendLengths[rank] > 0) {
+      memcpy(
+          static_cast<uint8_t*>(outputTensor.data_ptr()) +
+              recvOffsets[rank] * elementSize,
+          static_cast<uint8_t*>(inputTensor.data_ptr()) +
+              sendOffsets[rank] * elementSize,
+          sendLengths[rank] * elementSize);
+    }
+
+    for (size_t i = 0; i < numRecvs; i++) {
+      recvBuffer->waitRecv();
+    }
+    for (size_t i = 0; i < numSends; i++) {
+      sendBuffer->waitSend();
+    }
+  }
+
+  void run() override {
+    alltoall(outputTensor, inputTensor);
+  }
+};
+
+#ifdef USE_CUDA
+
+class AsyncAlltoallCUDAWork : public AsyncAlltoallWork {
+ public:
+  AsyncAlltoallCUDAWork(
+      const std::shared_ptr<gloo::Context>& context,
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      uint32_t tag)
+      : AsyncAlltoallWork(
+            context,
+            outputTensor,
+            inputTensor,
+            outputCounts,
+            inputCounts,
+            tag) {
+    inputs = {inputTensor};
+    outputs = {outputTensor};
+    initializeStreamsEvents(inputs, inputStreams, inputEvents);
+    initializeStreamsEvents(outputs, outputStreams, outputEvents);
+
+    // Kick off copy from CUDA tensor to pinned CPU tensor.
+    at::cuda::OptionalCUDAStreamGuard guard;
+    guard.reset_stream(inputStreams[0]);
+    tmpInput = pinnedLike(inputTensor).copy_(inputTensor, true);
+    tmpOutput = pinnedLike(outputTensor);
+  }
+
+  void run() override {
+    // Synchronize with copy operation.
+    at::cuda::OptionalCUDAGuard device_guard;
+    device_guard.set_index(inputTensor.device().index());
+    AT_CUDA_CHECK(cudaStreamSynchronize(inputStreams[0]));
+    device_guard.set_index(outputTensor.device().index());
+    AT_CUDA_CHECK(cudaStreamSynchronize(outputStreams[0]));
+
+    // Run alltoall on host side tensors.
+    alltoall(tmpOutput, tmpInput);
+
+    // Kick off copy back to the CUDA tensor.
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    stream_guard.reset_stream(outputStreams[0]);
+    outputTensor.copy_(tmpOutput, /* non_blocking */ true);
+    outputEvents[0].record(outputStreams[0]);
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensor.
+    at::cuda::OptionalCUDAGuard guard;
+    guard.set_index(outputTensor.device().index());
+    outputEvents[0].block(at::cuda::getCurrentCUDAStream());
+  }
+
+  std::vector<at::Tensor> inputs;
+  at::Tensor tmpInput;
+  std::vector<at::cuda::CUDAStream> inputStreams;
+  std::vector<at::cuda::CUDAEvent> inputEvents;
+
+  std::vector<at::Tensor> outputs;
+  at::Tensor tmpOutput;
+  std::vector<at::cuda::CUDAStream> outputStreams;
+  std::vector<at::cuda::CUDAEvent> outputEvents;
+};
+
+#endif
+
+class AsyncReduceScatterWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncReduceScatterWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : context(context),
+        outputs(outputs),
+        inputs(inputs),
+        reduceOp(reduceOp),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  std::vector<at::Tensor> outputs;
+  std::vector<std::vector<at::Tensor>> inputs;
+  const ReduceOp reduceOp;
+  const uint32_t tag;
+
+  void reduceScatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs) {
+    const int rank = context->rank;
+    const int size = context->size;
+    const auto slot = gloo::Slot::build(kReduceScatterSlotPrefix, tag);
+    const size_t nbytes = outputs[0].numel() * outputs[0].element_size();
+    if (nbytes == 0) {
+      return;
+    }
+
+    // Receive the slice of every other process into a buffer of its own.
+    std::vector<at::Tensor> received(size);
+    std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> recvBuffers;
+    std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> sendBuffers;
+    for (int i = 1; i < size; i++) {
+      const int dst = (rank + i) % size;
+      const int src = (rank - i + size) % size;
+      auto& input = inputs[0][dst];
+      sendBuffers.push_back(
+          context->createUnboundBuffer(input.data_ptr(), nbytes));
+      sendBuffers.back()->send(dst, slot);
+      received[src] = at::empty_like(outputs[0]);
+      recvBuffers.push_back(
+          context->createUnboundBuffer(received[src].data_ptr(), nbytes));
+      recvBuffers.back()->recv(src, slot);
+    }
+
+    // Reduce the slices in rank order, so every element is reduced in the
+    // same order on all processes.
+    auto& output = outputs[0];
+    for (auto& buffer : recvBuffers) {
+      buffer->waitRecv();
+    }
+    received[rank] = inputs[0][rank];
+    output.copy_(received[0]);
+    for (int i = 1; i < size; i++) {
+      reduceInto(output, received[i], reduceOp);
+    }
+    for (auto& buffer : sendBuffers) {
+      buffer->waitSend();
+    }
+  }
+
+  void run() override {
+    reduceScatter(outputs, inputs);
+  }
+};
+
+#ifdef USE_CUDA
+
+class AsyncReduceScatterCUDAWork : public AsyncReduceScatterWork {
+ public:
+  AsyncReduceScatterCUDAWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncReduceScatterWork(context, outputs, inputs, reduceOp, tag) {
+    initializeStreamsEvents(inputs, inputStreams, inputEvents);
+    initializeStreamsEvents(outputs, outputStreams, outputEvents);
+
+    // Kick off copy from CUDA tensors to pinned CPU tensors.
+    tmpInputs.resize(inputs.size());
+    at::cuda::OptionalCUDAStreamGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(inputStreams[i]);
+      tmpInputs[i].reserve(inputs[i].size());
+      for (size_t j = 0; j < inputs[i].size(); j++) {
+        tmpInputs[i].push_back(
+            pinnedLike(inputs[i][j]).copy_(inputs[i][j], true));
+      }
+    }
+
+    tmpOutputs.reserve(outputs.size());
+    for (size_t i = 0; i < outputs.size(); i++) {
+      tmpOutputs.push_back(pinnedLike(outputs[i]));
+    }
+  }
+
+  void run() override {
+    // Synchronize with copy operations.
+    at::cuda::OptionalCUDAGuard device_guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      device_guard.set_index(inputs[i][0].get_device());
+      AT_CUDA_CHECK(cudaStreamSynchronize(inputStreams[i]));
+    }
+    for (size_t i = 0; i < outputs.size(); i++) {
+      device_guard.set_index(outputs[i].get_device());
+      AT_CUDA_CHECK(cudaStreamSynchronize(outputStreams[i]));
+    }
+
+    // Run reduce_scatter on host side tensors.
+    reduceScatter(tmpOutputs, tmpInputs);
+
+    // Kick off copy back to the CUDA tensors.
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    for (size_t i = 0; i < outputs.size(); i++) {
+      stream_guard.reset_stream(outputStreams[i]);
+      outputs[i].copy_(tmpOutputs[i], /* non_blocking */ true);
+      outputEvents[i].record(outputStreams[i]);
+    }
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    for (size_t i = 0; i < outputs.size(); i++) {
+      guard.set_index(static_cast<at::DeviceIndex>(outputs[i].get_device()));
+      outputEvents[i].block(at::cuda::getCurrentCUDAStream());
+    }
+  }
+
+  std::vector<at::Tensor> tmpOutputs;
+  std::vector<at::cuda::CUDAStream> outputStreams;
+  std::vector<at::cuda::CUDAEvent> outputEvents;
+
+  std::vector<std::vector<at::Tensor>> tmpInputs;
+  std::vector<at::cuda::CUDAStream> inputStreams;
+  std::vector<at::cuda::CUDAEvent> inputEvents;
+};
+
+#endif
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::reduce_scatter: " + msg);
+  };
+
+  assertSingleElementOutput(invalidArgument, outputs);
+  assertDense(invalidArgument, outputs);
+  if (inputs.size() != 1 ||
+      inputs[0].size() != static_cast<size_t>(getSize())) {
+    invalidArgument(
+        "requires a single-element input list "
+        "containing a list with <size> tensors");
+  }
+  const auto& type = outputs[0].type();
+  const auto& sizes = outputs[0].sizes();
+  assertTypeAndSizesMatch(invalidArgument, inputs[0], type, sizes);
+  for (const auto& input : inputs[0]) {
+    if (!input.is_contiguous()) {
+      invalidArgument("requires contiguous input tensors");
+    }
+  }
+
+  const auto& device = outputs[0].device();
+  switch (device.type()) {
+    case at::kCPU:
+#ifdef USE_CUDA
+    case at::kCUDA:
+#endif
+      break;
+    default:
+      invalidArgument("unsupported device type");
+  }
+
+  std::shared_ptr<AsyncReduceScatterWork> work;
+  const auto tag = nextTag();
+  auto context = getContext(tag);
+  if (device.type() == at::kCPU) {
+    work = std::make_shared<AsyncReduceScatterWork>(
+        context, outputs, inputs, opts.reduceOp, tag);
+#ifdef USE_CUDA
+  } else if (device.type() == at::kCUDA) {
+    work = std::make_shared<AsyncReduceScatterCUDAWork>(
+        context, outputs, inputs, opts.reduceOp, tag);
+#endif
+  } else {
+    throw std::runtime_error("Invalid backend");
+  }
+  enqueue(work);
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputCounts,
+    std::vector<int64_t>& inputCounts,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall_base: " + msg);
+  };
+
+  if (outputTensor.device() != inputTensor.device()) {
+    invalidArgument("requires input and output on the same device");
+  }
+  if (outputTensor.type() != inputTensor.type()) {
+    invalidArgument("requires input and output of the same type");
+  }
+  if (outputTensor.is_sparse() || inputTensor.is_sparse() ||
+      !outputTensor.is_contiguous() || !inputTensor.is_contiguous()) {
+    invalidArgument("only supports dense contiguous tensors");
+  }
+  checkSplitSizes(invalidArgument, inputCounts, inputTensor, size_);
+  checkSplitSizes(invalidArgument, outputCounts, outputTensor, size_);
+
+  const auto& device = outputTensor.device();
+  switch (device.type()) {
+    case at::kCPU:
+#ifdef USE_CUDA
+    case at::kCUDA:
+#endif
+      break;
+    default:
+      invalidArgument("unsupported device type");
+  }
+
+  std::shared_ptr<AsyncAlltoallWork> work;
+  const auto tag = nextTag();
+  auto context = getContext(tag);
+  if (device.type() == at::kCPU) {
+    work = std::make_shared<AsyncAlltoallWork>(
+        context, outputTensor, inputTensor, outputCounts, inputCounts, tag);
+#ifdef USE_CUDA
+  } else if (device.type() == at::kCUDA) {
+    work = std::make_shared<AsyncAlltoallCUDAWork>(
+        context, outputTensor, inputTensor, outputCounts, inputCounts, tag);
+#endif
+  } else {
+    throw std::runtime_error("Invalid backend");
+  }
+  enqueue(work);
+  return work;
 }
 
 at::Tensor& checkSingleTensor(std::vector<at::Tensor>& tensors) {
@@ -1526,8 +2242,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::barrier(
     priorWork.insert(priorWork.end(), workQueue_.begin(), workQueue_.end());
   }
 
+  const auto tag = nextTag();
   auto work = std::make_shared<AsyncBarrierWork>(
-      contexts_[0], std::move(priorWork), nextTag());
+      getContext(tag), std::move(priorWork), tag);
   enqueue(work);
   return work;
 }
@@ -14,6 +14,7 @@
 #include <gloo/transport/device.h>
 
 #include <torch/csrc/utils/hash.h>
+#include <c10/util/static_tracepoint.h>
 
 #ifdef USE_CUDA
 #include <ATen/cuda/CUDAEvent.h>
@@ -70,11 +71,13 @@ class ProcessGroupGloo : public ProcessGroup {
    public:
     static void execute(std::shared_ptr<AsyncWork> work) {
       std::exception_ptr eptr;
+      C10_SDT(c10d_collective_start, work.get());
       try {
         work->run();
       } catch (...) {
         eptr = std::current_exception();
       }
+      C10_SDT(c10d_collective_end, work.get(), static_cast<bool>(eptr));
       work->finish(eptr);
     }
 
@@ -122,6 +125,9 @@ class ProcessGroupGloo : public ProcessGroup {
   struct Options {
     explicit Options();
 
+    // Every device connects its own pair to every peer. The same device can
+    // be listed multiple times to open multiple connections over a single
+    // network interface. See Note [Multiple Gloo devices].
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
@@ -167,6 +173,13 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputs,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputCounts,
+      std::vector<int64_t>& inputCounts,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> send(
       std::vector<at::Tensor>& tensors,
       int dstRank,
@@ -199,6 +212,11 @@ class ProcessGroupGloo : public ProcessGroup {
   // Returns next collective tag to use (uses collectiveCounter_).
   uint32_t nextTag();
 
+  // Returns the context to use for the specified tag.
+  // With `contexts_` connected over multiple devices, this spreads
+  // consecutive collectives over them. See Note [Multiple Gloo devices].
+  std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
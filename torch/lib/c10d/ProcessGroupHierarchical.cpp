@@ -0,0 +1,312 @@
+#include <c10d/ProcessGroupHierarchical.hpp>
+
+#include <stdexcept>
+
+namespace c10d {
+
+namespace {
+
+// Checking the input tensor's validity
+void checkSingleTensor(
+    std::function<void(const std::string&)> fn,
+    const std::vector<at::Tensor>& tensors) {
+  assertSingleElement(fn, tensors);
+  assertDense(fn, tensors);
+  if (!tensors[0].is_contiguous()) {
+    fn("input tensor has to be contiguous");
+  }
+}
+
+// Returns `count` consecutive views of `length` elements into `flat`.
+std::vector<at::Tensor> splitFlat(
+    const at::Tensor& flat,
+    int64_t count,
+    int64_t length) {
+  std::vector<at::Tensor> views;
+  views.reserve(count);
+  for (int64_t i = 0; i < count; i++) {
+    views.push_back(flat.narrow(0, i * length, length));
+  }
+  return views;
+}
+
+} // namespace
+
+ProcessGroupHierarchical::ProcessGroupHierarchical(
+    std::shared_ptr<ProcessGroup> intraGroup,
+    std::shared_ptr<ProcessGroup> interGroup)
+    : ProcessGroup(
+          interGroup->getRank() * intraGroup->getSize() +
+              intraGroup->getRank(),
+          interGroup->getSize() * intraGroup->getSize()),
+      intraGroup_(std::move(intraGroup)),
+      interGroup_(std::move(interGroup)),
+      stop_(false) {
+  // Start the worker thread running the steps of every collective
+  workerThread_ = std::thread(&ProcessGroupHierarchical::runLoop, this);
+}
+
+ProcessGroupHierarchical::~ProcessGroupHierarchical() {
+  std::unique_lock<std::mutex> lock(pgMutex_);
+  queueConsumeCV_.wait(lock, [&] { return queue_.empty(); });
+
+  // Queue is empty, signal stop
+  stop_ = true;
+
+  // Release lock to allow threads to terminate
+  lock.unlock();
+  queueProduceCV_.notify_all();
+
+  // Join the single worker thread
+  workerThread_.join();
+}
+
+void ProcessGroupHierarchical::runLoop() {
+  std::unique_lock<std::mutex> lock(pgMutex_);
+
+  while (!stop_) {
+    if (queue_.empty()) {
+      queueProduceCV_.wait(lock);
+      continue;
+    }
+
+    auto workTuple = std::move(queue_.front());
+
+    queue_.pop_front();
+
+    auto& fn = std::get<0>(workTuple);
+    auto& work = std::get<1>(workTuple);
+
+    lock.unlock();
+    queueConsumeCV_.notify_one();
+
+    try {
+      fn();
+      work->finish();
+    } catch (...) {
+      work->finish(std::current_exception());
+    }
+
+    lock.lock();
+  }
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::enqueue(
+    std::function<void()> fn) {
+  auto work = std::make_shared<WorkHierarchical>();
+  std::unique_lock<std::mutex> lock(pgMutex_);
+  queue_.push_back(std::make_tuple(std::move(fn), work));
+  lock.unlock();
+  queueProduceCV_.notify_one();
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupHierarchical::broadcast: " + msg);
+  };
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+  checkSingleTensor(invalidArgument, tensors);
+
+  return enqueue([tensors, opts, this]() mutable {
+    const auto intraSize = intraGroup_->getSize();
+
+    // The processes with the same intra-node rank as the root first
+    // broadcast across nodes, then every node broadcasts locally.
+    BroadcastOptions intraOpts;
+    intraOpts.rootRank = opts.rootRank % intraSize;
+    intraOpts.timeout = opts.timeout;
+    if (intraGroup_->getRank() == intraOpts.rootRank) {
+      BroadcastOptions interOpts;
+      interOpts.rootRank = opts.rootRank / intraSize;
+      interOpts.timeout = opts.timeout;
+      interGroup_->broadcast(tensors, interOpts)->wait();
+    }
+    intraGroup_->broadcast(tensors, intraOpts)->wait();
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupHierarchical::allreduce: " + msg);
+  };
+  checkSingleTensor(invalidArgument, tensors);
+
+  return enqueue([tensors, opts, this]() {
+    const auto& tensor = tensors[0];
+    const int64_t intraSize = intraGroup_->getSize();
+    const int64_t numel = tensor.numel();
+    if (numel == 0) {
+      return;
+    }
+
+    // Pad the flattened tensor to a multiple of the node size, so that it
+    // can be split into equally sized shards.
+    const int64_t shardNumel = (numel + intraSize - 1) / intraSize;
+    auto flat = at::empty({shardNumel * intraSize}, tensor.options());
+    flat.narrow(0, 0, numel).copy_(tensor.view({-1}));
+    if (shardNumel * intraSize > numel) {
+      flat.narrow(0, numel, shardNumel * intraSize - numel).zero_();
+    }
+    std::vector<std::vector<at::Tensor>> shards = {
+        splitFlat(flat, intraSize, shardNumel)};
+    std::vector<at::Tensor> shard = {at::empty({shardNumel}, tensor.options())};
+
+    // 1. Reduce every shard onto one process of the node.
+    ReduceScatterOptions reduceScatterOpts;
+    reduceScatterOpts.reduceOp = opts.reduceOp;
+    reduceScatterOpts.timeout = opts.timeout;
+    intraGroup_->reduce_scatter(shard, shards, reduceScatterOpts)->wait();
+
+    // 2. Reduce the shard across nodes.
+    interGroup_->allreduce(shard, opts)->wait();
+
+    // 3. Collect the reduced shards on every process of the node.
+    AllgatherOptions allgatherOpts;
+    allgatherOpts.timeout = opts.timeout;
+    intraGroup_->allgather(shards, shard, allgatherOpts)->wait();
+
+    tensor.view({-1}).copy_(flat.narrow(0, 0, numel));
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce(
+    std::vector<at::Tensor>& tensors,
+    const ReduceOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupHierarchical::reduce: " + msg);
+  };
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+  checkSingleTensor(invalidArgument, tensors);
+
+  return enqueue([tensors, opts, this]() mutable {
+    const auto intraSize = intraGroup_->getSize();
+
+    // Every node reduces onto the process with the same intra-node rank as
+    // the root, then these processes reduce across nodes.
+    ReduceOptions intraOpts;
+    intraOpts.reduceOp = opts.reduceOp;
+    intraOpts.rootRank = opts.rootRank % intraSize;
+    intraOpts.timeout = opts.timeout;
+    intraGroup_->reduce(tensors, intraOpts)->wait();
+    if (intraGroup_->getRank() == intraOpts.rootRank) {
+      ReduceOptions interOpts;
+      interOpts.reduceOp = opts.reduceOp;
+      interOpts.rootRank = opts.rootRank / intraSize;
+      interOpts.timeout = opts.timeout;
+      interGroup_->reduce(tensors, interOpts)->wait();
+    }
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather(
+    std::vector<std::vector<at::Tensor>>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllgatherOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupHierarchical::allgather: " + msg);
+  };
+  checkSingleTensor(invalidArgument, inputTensors);
+  if (outputTensors.size() != 1) {
+    invalidArgument("requires a single-element output list");
+  }
+  if (outputTensors[0].size() != static_cast<size_t>(size_)) {
+    invalidArgument(
+        "requires output list to have size equal to the group size (" +
+        std::to_string(size_) + ")");
+  }
+  assertTypeAndSizesMatch(
+      invalidArgument,
+      outputTensors[0],
+      inputTensors[0].type(),
+      inputTensors[0].sizes());
+
+  return enqueue([outputTensors, inputTensors, opts, this]() mutable {
+    const auto& input = inputTensors[0];
+    const int64_t intraSize = intraGroup_->getSize();
+    const int64_t interSize = interGroup_->getSize();
+    const int64_t numel = input.numel();
+
+    // Gather the tensors of this node into one flat tensor, then gather
+    // these across nodes. Ranks are numbered node by node, so the result
+    // is ordered by rank.
+    auto nodeFlat = at::empty({intraSize * numel}, input.options());
+    std::vector<std::vector<at::Tensor>> nodeOutputs = {
+        splitFlat(nodeFlat, intraSize, numel)};
+    std::vector<at::Tensor> nodeInputs = {input.view({-1})};
+    intraGroup_->allgather(nodeOutputs, nodeInputs, opts)->wait();
+
+    auto flat = at::empty({interSize * intraSize * numel}, input.options());
+    std::vector<std::vector<at::Tensor>> outputs = {
+        splitFlat(flat, interSize, intraSize * numel)};
+    std::vector<at::Tensor> inputs = {nodeFlat};
+    interGroup_->allgather(outputs, inputs, opts)->wait();
+
+    for (int64_t i = 0; i < interSize * intraSize; i++) {
+      outputTensors[0][i].copy_(
+          flat.narrow(0, i * numel, numel).view(input.sizes()));
+    }
+  });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::gather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const GatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support gather");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ScatterOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce_scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ReduceScatterOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support reduce_scatter");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::send(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support send");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recv(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recvAnysource(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupHierarchical::barrier(
+    const BarrierOptions& opts) {
+  return enqueue([opts, this]() {
+    // Once the intra-node barrier has completed, all processes of this node
+    // have entered. Once the inter-node barrier has completed, the same holds
+    // for every other node.
+    intraGroup_->barrier(opts)->wait();
+    interGroup_->barrier(opts)->wait();
+  });
+}
+
+} // namespace c10d
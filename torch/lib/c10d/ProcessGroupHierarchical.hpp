@@ -0,0 +1,140 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+#include <c10d/Types.hpp>
+#include <c10d/Utils.hpp>
+
+namespace c10d {
+
+// ProcessGroupHierarchical composes two existing process groups into one
+// group spanning multiple nodes.
+//
+// - The intra-node group holds the processes of this node (typically
+//   ProcessGroupNCCL with one GPU per process).
+// - The inter-node group holds the processes on all nodes with the same
+//   rank in their intra-node group (typically ProcessGroupGloo or
+//   ProcessGroupMPI).
+//
+// All nodes must run the same number of processes. The rank of a process
+// in the composite group is `interRank * intraSize + intraRank`, so the
+// processes of a node have consecutive ranks.
+//
+// An allreduce is done in three steps:
+//
+//   1. reduce_scatter within the node, so every process holds the
+//      node-wide reduction of a 1/intraSize shard of the tensor,
+//   2. allreduce of that shard across nodes,
+//   3. allgather of the shards within the node.
+//
+// Every process only sends its shard over the inter-node links, so the
+// bytes crossing node boundaries are reduced by a factor of intraSize
+// compared to a flat ring over all processes. This requires the intra-node
+// group to support reduce_scatter (as ProcessGroupNCCL does). Broadcast,
+// reduce, allgather and barrier are similarly split into an intra-node and an
+// inter-node step.
+//
+// All functions of this class are expected to be called in the same order
+// across all processes in the group. They are asynchronous: the steps of a
+// collective are run in sequence by a single worker thread that is owned by
+// this class, so the steps of consecutive collectives are issued to the
+// underlying groups in the same order on all processes. The underlying groups
+// must not be used directly for as long as this group is in use.
+//
+// Like ProcessGroupMPI, only a single tensor per process is supported. CUDA
+// tensors are expected to be produced on the default stream of their
+// device, which is the stream the worker thread runs the steps on.
+class ProcessGroupHierarchical : public ProcessGroup {
+ public:
+  class WorkHierarchical : public ProcessGroup::Work {
+   protected:
+    friend class ProcessGroupHierarchical;
+  };
+
+  // Constructor will spawn up the worker thread loop
+  explicit ProcessGroupHierarchical(
+      std::shared_ptr<ProcessGroup> intraGroup,
+      std::shared_ptr<ProcessGroup> interGroup);
+
+  virtual ~ProcessGroupHierarchical();
+
+  std::shared_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<std::vector<at::Tensor>>& inputTensors,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<std::vector<at::Tensor>>& inputTensors,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  std::shared_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ protected:
+  using WorkType =
+      std::tuple<std::function<void()>, std::shared_ptr<WorkHierarchical>>;
+
+  // Worker thread loop
+  void runLoop();
+
+  std::shared_ptr<ProcessGroup::Work> enqueue(std::function<void()> fn);
+
+  const std::shared_ptr<ProcessGroup> intraGroup_;
+  const std::shared_ptr<ProcessGroup> interGroup_;
+
+  bool stop_;
+
+  std::mutex pgMutex_;
+  std::thread workerThread_;
+
+  std::deque<WorkType> queue_;
+  std::condition_variable queueProduceCV_;
+  std::condition_variable queueConsumeCV_;
+};
+
+} // namespace c10d
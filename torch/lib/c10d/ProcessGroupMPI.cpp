@@ -556,7 +556,101 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce_scatter(
     std::vector<at::Tensor>& outputTensors,
     std::vector<std::vector<at::Tensor>>& inputTensors,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupMPI does not support reduce_scatter");
+  checkSingleTensor(outputTensors);
+  if (inputTensors.size() != 1) {
+    throw std::runtime_error(
+        "MPI process group only supports a single "
+        "tensor op");
+  }
+  if (static_cast<size_t>(size_) != inputTensors[0].size()) {
+    throw std::runtime_error(
+        "Reduce scatter: number of input tensors should equal "
+        "to the world size");
+  }
+
+  checkSameSizeAndType(outputTensors[0], inputTensors[0]);
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [opts, this](std::unique_ptr<WorkEntry>& entry) {
+        auto data = (entry->dst)[0];
+        auto flatInputTensor = flattenDenseTensors(entry->src);
+
+        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        MPI_CHECK(MPI_Reduce_scatter_block(
+            flatInputTensor.data_ptr(),
+            data.data_ptr(),
+            data.numel(),
+            mpiDatatype.at(data.scalar_type()),
+            mpiOp.at(opts.reduceOp),
+            pgComm_));
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors[0], &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  checkSingleTensorHelper(inputTensor);
+  checkSingleTensorHelper(outputTensor);
+  if (inputTensor.scalar_type() != outputTensor.scalar_type()) {
+    throw std::runtime_error(
+        "Alltoall: input and output tensors should have the same type");
+  }
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::runtime_error("Alltoall: " + msg);
+  };
+  checkSplitSizes(invalidArgument, inputSplitSizes, inputTensor, size_);
+  checkSplitSizes(invalidArgument, outputSplitSizes, outputTensor, size_);
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [outputSplitSizes, inputSplitSizes, this](
+          std::unique_ptr<WorkEntry>& entry) {
+        auto srcData = (entry->src)[0];
+        auto dstData = (entry->dst)[0];
+        const auto datatype = mpiDatatype.at(srcData.scalar_type());
+
+        if (outputSplitSizes.empty() && inputSplitSizes.empty()) {
+          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          MPI_CHECK(MPI_Alltoall(
+              srcData.data_ptr(),
+              srcData.numel() / size_,
+              datatype,
+              dstData.data_ptr(),
+              dstData.numel() / size_,
+              datatype,
+              pgComm_));
+          return;
+        }
+
+        std::vector<int> sendLengths(size_), sendOffsets(size_);
+        std::vector<int> recvLengths(size_), recvOffsets(size_);
+        computeLengthsAndOffsets(
+            inputSplitSizes, srcData, &sendLengths, &sendOffsets);
+        computeLengthsAndOffsets(
+            outputSplitSizes, dstData, &recvLengths, &recvOffsets);
+
+        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        MPI_CHECK(MPI_Alltoallv(
+            srcData.data_ptr(),
+            sendLengths.data(),
+            sendOffsets.data(),
+            datatype,
+            dstData.data_ptr(),
+            recvLengths.data(),
+            recvOffsets.data(),
+            datatype,
+            pgComm_));
+      };
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors, &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::send(
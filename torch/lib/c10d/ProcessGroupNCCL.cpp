@@ -1,5 +1,8 @@
 #include <c10d/ProcessGroupNCCL.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <map>
 #include <tuple>
 #include <unordered_set>
@@ -8,6 +11,7 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/util/static_tracepoint.h>
 
 #include <c10d/Utils.hpp>
 
@@ -91,10 +95,49 @@ void syncStreams(
   }
 }
 
+// Interval at which a blocking wait() polls for the completion of its work
+constexpr auto kSynchronizeBusyWaitMillis = std::chrono::milliseconds(10);
+
+// Whether the environment asks WorkNCCL::wait() to block, see
+// NCCL_BLOCKING_WAIT
+bool blockingWaitFromEnv() {
+  const char* env = std::getenv("NCCL_BLOCKING_WAIT");
+  return env != nullptr && std::string(env) == "1";
+}
+
+std::exception_ptr ncclErrorException(ncclResult_t error) {
+  return std::make_exception_ptr(std::runtime_error(
+      "NCCL error: " + std::string(ncclGetErrorString(error))));
+}
+
 } // namespace
 
+// Note [NCCL watchdog]
+// ~~~~~~~~~~~~~~~~~~~~
+// Once enqueued, a NCCL kernel runs until all ranks took part in the
+// collective. If a rank dies, or its peers' network connections fail, the
+// kernels of the other ranks never return, and neither does any later CUDA
+// synchronization of their devices, so the job hangs instead of failing.
+//
+// Every ProcessGroupNCCL therefore runs a watchdog thread that wakes up every
+// kWatchdogThreadSleepMillis and
+//
+//   1. polls all its communicators for asynchronous errors with
+//      ncclCommGetAsyncError, which NCCL reports e.g. when a peer went away,
+//   2. checks whether one of the works that have not finished on the GPU has
+//      been running for longer than the timeout of the process group,
+//   3. sets an exception on every unfinished work that runs on a communicator
+//      with an error or a timed out work, and aborts these communicators with
+//      ncclCommAbort, which makes their kernels return.
+//
+// The exception is then returned by WorkNCCL::exception(), and thrown by
+// wait() and synchronize(), so the training loop fails within a timeout
+// instead of hanging, and can be restarted. Operations on an aborted
+// communicator throw when they are enqueued. Aborting needs NCCL 2.4; with
+// earlier versions the watchdog only reports timeouts.
+
 ProcessGroupNCCL::WorkNCCL::WorkNCCL(const std::vector<at::Device>& devices)
-    : devices_(devices) {
+    : devices_(devices), workStartTime_(std::chrono::steady_clock::now()) {
   // Creates the CUDA event wrappers
   // Note: The actual events are lazily created when first recorded to with
   // DEFAULT_FLAGS = cudaEventDisableTiming.
@@ -104,18 +147,41 @@ ProcessGroupNCCL::WorkNCCL::WorkNCCL(const std::vector<at::Device>& devices)
 ProcessGroupNCCL::WorkNCCL::~WorkNCCL() {}
 
 bool ProcessGroupNCCL::WorkNCCL::isCompleted() {
-  return finishedGPUExecution();
+  checkAndSetException();
+  return exception() || finishedGPUExecution();
 }
 
 bool ProcessGroupNCCL::WorkNCCL::isSuccess() const {
-  return true;
+  std::unique_lock<std::mutex> lock(mutex_);
+  return !exception_;
 }
 
 std::exception_ptr ProcessGroupNCCL::WorkNCCL::exception() const {
-  throw std::runtime_error(
-      "exception() is not supported by NCCL process "
-      "group's work, since isSuccess() will always return true, and "
-      "isCompleted() and wait() will either succeed or throw");
+  std::unique_lock<std::mutex> lock(mutex_);
+  return exception_;
+}
+
+void ProcessGroupNCCL::WorkNCCL::checkAndSetException() {
+  for (auto& ncclComm : ncclComms_) {
+    const auto ncclErr = ncclComm->checkForNcclError();
+    if (ncclErr != ncclSuccess) {
+      setException(ncclErrorException(ncclErr));
+      return;
+    }
+  }
+}
+
+void ProcessGroupNCCL::WorkNCCL::setException(
+    std::exception_ptr exception) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!exception_) {
+    exception_ = exception;
+  }
+}
+
+bool ProcessGroupNCCL::WorkNCCL::timedOut() const {
+  return opTimeout_ != Store::kNoTimeout &&
+      std::chrono::steady_clock::now() - workStartTime_ > opTimeout_;
 }
 
 // Helper that checks if the NCCL kernels are completed on the GPUs
@@ -135,6 +201,12 @@ bool ProcessGroupNCCL::WorkNCCL::finishedGPUExecution() {
 
 // Waiting on the work's corresponding CUDA events
 void ProcessGroupNCCL::WorkNCCL::synchronize() {
+  // Throw the errors that have been detected so far.
+  // See Note [NCCL watchdog].
+  checkAndSetException();
+  if (auto exception = this->exception()) {
+    std::rethrow_exception(exception);
+  }
   for (size_t i = 0; i < devices_.size(); ++i) {
     auto currentStream = at::cuda::getCurrentCUDAStream(devices_[i].index());
     // Block the current stream on the NCCL stream
@@ -147,11 +219,27 @@ void ProcessGroupNCCL::WorkNCCL::synchronize() {
   }
 }
 
-// Same as calling synchronize().
+// Same as calling synchronize(), after waiting for the work to complete,
+// fail or time out if NCCL_BLOCKING_WAIT is set.
 void ProcessGroupNCCL::WorkNCCL::wait() {
+  if (blockingWait_) {
+    while (!isCompleted()) {
+      if (timedOut()) {
+        // The watchdog thread aborts the communicators.
+        setException(std::make_exception_ptr(std::runtime_error(
+            "NCCL operation timed out after " +
+            std::to_string(opTimeout_.count()) + " ms")));
+        break;
+      }
+      std::this_thread::sleep_for(kSynchronizeBusyWaitMillis);
+    }
+  }
   synchronize();
 }
 
+constexpr std::chrono::milliseconds
+    ProcessGroupNCCL::kWatchdogThreadSleepMillis;
+
 std::unordered_map<std::string, ssize_t> ProcessGroupNCCL::pgUniqueNCCLIDCnt_;
 std::unordered_map<std::string, ssize_t>
     ProcessGroupNCCL::processGroupCounterMap_;
@@ -162,8 +250,13 @@ ProcessGroupNCCL::ProcessGroupNCCL(
     const std::shared_ptr<Store>& store,
     int rank,
     int size,
-    const std::string& groupName)
-    : ProcessGroup(rank, size), store_(store), groupName_(groupName) {
+    const std::string& groupName,
+    const std::chrono::milliseconds& opTimeout)
+    : ProcessGroup(rank, size),
+      store_(store),
+      groupName_(groupName),
+      opTimeout_(opTimeout),
+      blockingWait_(blockingWaitFromEnv()) {
   // Generate the Process Group ID for current PG, this needs to be identical
   // for all processes
   std::unique_lock<std::mutex> lock(pgTrackingLock_);
@@ -176,13 +269,111 @@ ProcessGroupNCCL::ProcessGroupNCCL(
   processGroupID_ = std::to_string(processGroupCounterMap_[groupKey]);
   groupPgID_ = groupName_ + "_" + processGroupID_;
   pgUniqueNCCLIDCnt_[groupPgID_] = -1;
+  lock.unlock();
+
+  ncclCommWatchdogThread_ =
+      std::thread(&ProcessGroupNCCL::ncclCommWatchdog, this);
 }
 
 ProcessGroupNCCL::~ProcessGroupNCCL() {
+  terminateWatchdog_.store(true);
+  watchdogCV_.notify_one();
+  ncclCommWatchdogThread_.join();
+
   std::unique_lock<std::mutex> lock(pgTrackingLock_);
   pgUniqueNCCLIDCnt_.erase(groupPgID_);
 }
 
+// See Note [NCCL watchdog].
+void ProcessGroupNCCL::ncclCommWatchdog() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!terminateWatchdog_.load()) {
+    // The communicators to abort, and the exception to set on the unfinished
+    // works that run on them
+    std::vector<std::pair<std::shared_ptr<NCCLComm>, std::exception_ptr>>
+        abortedComms;
+    const auto isAborted = [&](const std::shared_ptr<NCCLComm>& ncclComm) {
+      for (const auto& aborted : abortedComms) {
+        if (aborted.first == ncclComm) {
+          return true;
+        }
+      }
+      return ncclComm->isAborted();
+    };
+
+    for (auto& it : devNCCLCommMap_) {
+      for (auto& ncclComm : it.second) {
+        if (isAborted(ncclComm)) {
+          continue;
+        }
+        try {
+          const auto ncclErr = ncclComm->checkForNcclError();
+          if (ncclErr != ncclSuccess) {
+            abortedComms.emplace_back(ncclComm, ncclErrorException(ncclErr));
+          }
+        } catch (...) {
+          abortedComms.emplace_back(ncclComm, std::current_exception());
+        }
+      }
+    }
+
+    // Whether a work has finished on the GPU, where a failing event query
+    // counts as finished, with the failure as the exception of the work
+    const auto finished = [](const std::shared_ptr<WorkNCCL>& work) {
+      try {
+        return work->finishedGPUExecution();
+      } catch (...) {
+        work->setException(std::current_exception());
+        return true;
+      }
+    };
+
+    for (auto& work : workList_) {
+      if (finished(work) || !work->timedOut()) {
+        continue;
+      }
+      auto exception = std::make_exception_ptr(std::runtime_error(
+          "NCCL operation timed out after " +
+          std::to_string(opTimeout_.count()) + " ms"));
+      work->setException(exception);
+      for (auto& ncclComm : work->ncclComms_) {
+        if (!isAborted(ncclComm)) {
+          abortedComms.emplace_back(ncclComm, exception);
+        }
+      }
+    }
+
+    // Fail the unfinished works before the abort makes their kernels return.
+    for (auto& work : workList_) {
+      for (const auto& aborted : abortedComms) {
+        const auto& comms = work->ncclComms_;
+        if (std::find(comms.begin(), comms.end(), aborted.first) !=
+                comms.end() &&
+            !finished(work)) {
+          work->setException(aborted.second);
+        }
+      }
+    }
+
+    for (auto& aborted : abortedComms) {
+      try {
+        aborted.first->ncclCommAbort();
+      } catch (const std::exception& e) {
+        std::cerr << "[" << rank_ << "] Failed to abort NCCL communicator: "
+                  << e.what() << std::endl;
+      }
+    }
+
+    workList_.remove_if([&](const std::shared_ptr<WorkNCCL>& work) {
+      return work->exception() || finished(work);
+    });
+
+    watchdogCV_.wait_for(lock, kWatchdogThreadSleepMillis, [&] {
+      return terminateWatchdog_.load();
+    });
+  }
+}
+
 void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
   // Every time when we create a new unique NCCL ID, we need to use a new
   // global key to access/update the store.
@@ -231,9 +422,12 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     usedDeviceIdxs_.insert(device.index());
   }
 
-  if (devNCCLCommMap_.find(devicesKey) != devNCCLCommMap_.end()) {
-    // Reuse the cached communicator if there is one.
-    return devNCCLCommMap_[devicesKey];
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (devNCCLCommMap_.find(devicesKey) != devNCCLCommMap_.end()) {
+      // Reuse the cached communicator if there is one.
+      return devNCCLCommMap_[devicesKey];
+    }
   }
   // NCCL communicator not cached, create a new entry
   std::vector<std::shared_ptr<NCCLComm>> ncclComms;
@@ -272,6 +466,7 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   C10D_NCCL_CHECK(ncclGroupEnd());
 
   // Move the NCCL resource to cache
+  std::unique_lock<std::mutex> lock(mutex_);
   devNCCLCommMap_.emplace(devicesKey, std::move(ncclComms));
   ncclStreams_.emplace(devicesKey, std::move(streamVal));
 
@@ -327,6 +522,31 @@ void check_gpu_tensors(const std::vector<at::Tensor>& tensors) {
   }
 }
 
+// Check that all `tensors' have the same type, are dense and contiguous, and
+// are on the same GPU.
+void check_gpu_tensors_same_device(const std::vector<at::Tensor>& tensors) {
+  if (tensors.size() == 0) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+
+  const auto& first = tensors.front();
+
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.scalar_type() != first.scalar_type()) {
+      throw std::runtime_error("Tensors must have identical type");
+    }
+    if (!t.is_contiguous()) {
+      throw std::runtime_error("Tensors must be contiguous");
+    }
+    if (t.get_device() != first.get_device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+  }
+}
+
 // Flatten each list in `tensor_lists' for a gather or scatter operation, and
 // ensure compatibility with the corresponding tensor in `other'.
 std::vector<at::Tensor> flatten_for_scatter_gather(
@@ -389,8 +609,22 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
   // First let NCCL streams wait for input tensors allocation streams
   syncStreams(devices, ncclEvents_[key], ncclStreams_[key]);
 
+  // Fail before starting the NCCL group if the watchdog thread aborted one
+  // of the communicators. See Note [NCCL watchdog].
+  for (auto& ncclComm : ncclComms) {
+    if (ncclComm->isAborted()) {
+      throw std::runtime_error(
+          "NCCL communicator was aborted, most likely because of an error or "
+          "timeout in a previous collective");
+    }
+  }
+
   // Work itself will create the CUDA events on all GPUs of tensors
   auto work = std::make_shared<ProcessGroupNCCL::WorkNCCL>(devices);
+  work->ncclComms_ = ncclComms;
+  work->opTimeout_ = opTimeout_;
+  work->blockingWait_ = blockingWait_;
+  C10_SDT(c10d_collective_start, work.get());
 
   at::cuda::OptionalCUDAGuard gpuGuard;
 
@@ -434,6 +668,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     work->cudaEvents_[i].record(ncclStream);
   }
 
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    workList_.push_back(work);
+  }
+
+  // The kernels are only enqueued at this point, their completion is
+  // recorded by the CUDA events of the work.
+  C10_SDT(c10d_collective_end, work.get(), false);
   return work;
 }
 
@@ -470,6 +712,45 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce(
   );
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  check_gpu_tensors_same_device(tensors);
+
+  // The copy into the flat tensor is queued on the current stream, which the
+  // NCCL stream waits for. See [Sync Streams].
+  std::vector<at::Tensor> flat = {flattenDenseTensors(tensors)};
+
+  return collective(flat, flat,
+    [&] (at::Tensor& input, at::Tensor& output,
+         ncclComm_t comm, at::cuda::CUDAStream& stream) {
+      return ncclAllReduce(
+        input.data_ptr(),
+        output.data_ptr(),
+        input.numel(),
+        getNcclDataType(input.scalar_type()),
+        ncclOp[opts.reduceOp],
+        comm,
+        stream.stream()
+      );
+    },
+    [] (std::vector<at::cuda::CUDAStream>&) {},
+    [&] (std::vector<at::cuda::CUDAStream>& ncclStreams) {
+      // Copy the result back into the tensors on the NCCL stream, so that the
+      // work completes once they hold it
+      at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+      int64_t offset = 0;
+      for (auto& tensor : tensors) {
+        const auto numel = tensor.numel();
+        tensor.view({-1}).copy_(flat[0].narrow(0, offset, numel), true);
+        offset += numel;
+        c10::cuda::CUDACachingAllocator::recordStream(
+          tensor.storage().data(), ncclStreams[0]);
+      }
+    }
+  );
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
     std::vector<at::Tensor>& tensors,
     const BroadcastOptions& opts) {
@@ -601,6 +882,68 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
   );
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  check_gpu_tensors(inputTensors);
+  check_gpu_tensors(outputTensors);
+  if (inputTensor.device() != outputTensor.device() ||
+      inputTensor.scalar_type() != outputTensor.scalar_type()) {
+    throw std::runtime_error(
+        "Input and output tensors must be of the same type and on the same "
+        "GPU device");
+  }
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::runtime_error("ProcessGroupNCCL::alltoall_base: " + msg);
+  };
+  checkSplitSizes(invalidArgument, inputSplitSizes, inputTensor, size_);
+  checkSplitSizes(invalidArgument, outputSplitSizes, outputTensor, size_);
+
+  return collective(inputTensors, outputTensors,
+    [&] (at::Tensor& input, at::Tensor& output,
+         ncclComm_t comm, at::cuda::CUDAStream& stream) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+        output.storage().data(), stream
+      );
+      std::vector<size_t> sendLengths(size_), sendOffsets(size_);
+      std::vector<size_t> recvLengths(size_), recvOffsets(size_);
+      computeLengthsAndOffsets(
+          inputSplitSizes, input, &sendLengths, &sendOffsets);
+      computeLengthsAndOffsets(
+          outputSplitSizes, output, &recvLengths, &recvOffsets);
+      const auto type = getNcclDataType(input.scalar_type());
+      const size_t elementSize = input.element_size();
+      auto sendBuffer = static_cast<uint8_t*>(input.data_ptr());
+      auto recvBuffer = static_cast<uint8_t*>(output.data_ptr());
+
+      // The sends and receives are part of the group started by
+      // collective(), so NCCL runs them concurrently.
+      for (int r = 0; r < size_; ++r) {
+        if (sendLengths[r] > 0) {
+          C10D_NCCL_CHECK(ncclSend(
+            sendBuffer + sendOffsets[r] * elementSize,
+            sendLengths[r], type, r, comm, stream.stream()));
+        }
+        if (recvLengths[r] > 0) {
+          C10D_NCCL_CHECK(ncclRecv(
+            recvBuffer + recvOffsets[r] * elementSize,
+            recvLengths[r], type, r, comm, stream.stream()));
+        }
+      }
+      return ncclSuccess;
+    });
+#else
+  throw std::runtime_error(
+      "ProcessGroupNCCL::alltoall_base requires NCCL 2.7 or later");
+#endif
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
     const BarrierOptions& opts) {
   std::vector<at::Device> devices;
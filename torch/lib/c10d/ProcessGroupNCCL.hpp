@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 
 #include <c10d/NCCLUtils.hpp>
@@ -31,12 +36,16 @@ namespace c10d {
 // either WorkNCCL::wait() or WorkNCCL::synchronize(), both achieves the same
 // functionality and are synonyms.
 //
-// Note that WorkNCCL::isSuccess() and WorkNCCL::isCompleted() will always
-// return true since ProcessGroupNCCL is single threaded. Every single NCCL
-// or CUDA failure will simply raise std::runtime_error.
+// Every NCCL or CUDA failure while enqueueing an operation simply raises
+// std::runtime_error. Failures that happen while the NCCL kernels run, e.g.
+// because a peer process died, and operations that exceed the timeout of the
+// process group are detected asynchronously, see Note [NCCL watchdog]. Once
+// detected, isSuccess() returns false, exception() returns the error, and
+// wait() and synchronize() throw it.
 //
-// Therefore, WorkNCCL::exception() is not supported since isSuccess() always
-// returns true.
+// By default, wait() does not block the calling thread. If the environment
+// variable NCCL_BLOCKING_WAIT is set to 1, wait() blocks until the operation
+// completed, failed or timed out, and throws in the last two cases.
 //
 // Also note that WorkNCCL::finishedGPUExecution() is a helper function only
 // provided by ProcessGroupNCCL to check if the NCCL operation of WorkNCCL has
@@ -63,34 +72,59 @@ class ProcessGroupNCCL : public ProcessGroup {
     virtual ~WorkNCCL();
 
     // Checks if request has completed. In this specific case of NCCL, it checks
-    // if the NCCL operation has completed on the GPU in its own NCCL stream.
-    // Non-blocking operation.
+    // if the NCCL operation has completed on the GPU in its own NCCL stream,
+    // or failed. Non-blocking operation.
     bool isCompleted() override;
 
-    // Same as calling synchronize() for NCCL work.
+    // Same as calling synchronize() for NCCL work, unless NCCL_BLOCKING_WAIT
+    // is set, in which case it blocks until the work completed.
     void wait() override;
 
-    // Will always return true
+    // Returns false once an error or timeout has been detected.
     bool isSuccess() const override;
 
     // Let current stream wait on the completing of the NCCL work
     // Throws on exceptions. Non-blocking operation.
     void synchronize() override;
 
-    // Will always throw because it should not be called (isSuccess() -> true).
+    // Returns the error or timeout detected for this work, if any.
     std::exception_ptr exception() const override;
 
     // Helper function that checks if the NCCL kernels have finished
     // execution on the GPUs
     bool finishedGPUExecution();
 
+    // Whether the work has been running for longer than the timeout of its
+    // process group.
+    bool timedOut() const;
+
    protected:
+    // Records the asynchronous error of the communicators of the work, if
+    // there is one, as the exception of the work.
+    void checkAndSetException();
+
+    // Records `exception' as the exception of the work, unless it already
+    // has one.
+    void setException(std::exception_ptr exception);
+
     // The cached list of CUDA devices to operate on
     std::vector<at::Device> devices_;
 
     // The CUDA events tracking this work item on multiple CUDA devices
     std::vector<at::cuda::CUDAEvent> cudaEvents_;
 
+    // The NCCL communicators the work runs on, polled for asynchronous
+    // errors
+    std::vector<std::shared_ptr<NCCLComm>> ncclComms_;
+
+    // Time at which the work was enqueued, and after how long it times out.
+    // The work never times out if opTimeout_ is Store::kNoTimeout.
+    std::chrono::steady_clock::time_point workStartTime_;
+    std::chrono::milliseconds opTimeout_ = Store::kNoTimeout;
+
+    // Whether wait() blocks the calling thread, see NCCL_BLOCKING_WAIT
+    bool blockingWait_ = false;
+
     // Tensors used for barrier op
     std::vector<at::Tensor> barrierTensors_;
 
@@ -111,11 +145,15 @@ class ProcessGroupNCCL : public ProcessGroup {
   // will have a unique name to be passed into the ProcessGroupNCCL constructor.
   // If you would like to use ProcessGroupNCCL constructor directly, it is
   // your reponsibility to do so as well.
+  //
+  // Operations that run for longer than `opTimeout' are aborted by the
+  // watchdog thread, see Note [NCCL watchdog].
   ProcessGroupNCCL(
       const std::shared_ptr<Store>& store,
       int rank,
       int size,
-      const std::string& groupName = "");
+      const std::string& groupName = "",
+      const std::chrono::milliseconds& opTimeout = Store::kNoTimeout);
 
   virtual ~ProcessGroupNCCL();
 
@@ -127,6 +165,13 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  // Reduces the tensors with a single NCCL call on a flat copy of them, and
+  // a single work object tracking its completion, instead of one of each per
+  // tensor. The tensors must be on the same GPU and have the same type.
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -141,6 +186,15 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  // Exchanges the slices with a ncclSend and a ncclRecv per peer, grouped
+  // into a single NCCL call. Requires NCCL 2.7 or later.
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
@@ -179,6 +233,13 @@ class ProcessGroupNCCL : public ProcessGroup {
       const std::string& devicesKey,
       const std::vector<at::Device>& devices);
 
+  // Function that runs as the watchdog thread, see Note [NCCL watchdog]
+  void ncclCommWatchdog();
+
+  // Interval at which the watchdog thread polls for errors and timeouts
+  static constexpr std::chrono::milliseconds kWatchdogThreadSleepMillis =
+      std::chrono::milliseconds(100);
+
  private:
   // Helper that encapsulates work shared across all collective communication
   // primitives.  The callbacks have the following signatures:
@@ -228,6 +289,25 @@ class ProcessGroupNCCL : public ProcessGroup {
   std::unordered_map<std::string, std::vector<std::shared_ptr<NCCLComm>>>
       devNCCLCommMap_;
 
+  // Mutex guarding devNCCLCommMap_ and workList_, which are shared with the
+  // watchdog thread
+  std::mutex mutex_;
+
+  // The works that have been enqueued and not yet seen completed by the
+  // watchdog thread
+  std::list<std::shared_ptr<WorkNCCL>> workList_;
+
+  // Timeout of the operations of this process group
+  std::chrono::milliseconds opTimeout_;
+
+  // Whether wait() blocks the calling thread, see NCCL_BLOCKING_WAIT
+  bool blockingWait_ = false;
+
+  // Watchdog thread, its wakeup and its termination flag
+  std::thread ncclCommWatchdogThread_;
+  std::condition_variable watchdogCV_;
+  std::atomic<bool> terminateWatchdog_{false};
+
   // The CUDA steams used by NCCL kernels
   std::unordered_map<std::string, std::vector<at::cuda::CUDAStream>>
       ncclStreams_;
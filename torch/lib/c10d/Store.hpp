@@ -35,6 +35,26 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Gets the values of several keys, waiting for them like get() does. The
+  // default implementation gets them one at a time; stores that talk to a
+  // server should get them in a single round trip.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  // Sets the values of several keys. The default implementation sets them one
+  // at a time.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  // Atomically sets `key` to `desiredValue` if its value is `expectedValue`,
+  // or if it doesn't exist and `expectedValue` is empty, and returns the value
+  // of `key` afterwards. Stores that don't support it throw.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,6 +1,10 @@
 #include <c10d/TCPStore.hpp>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
 #include <poll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,7 +14,21 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_GET,
+  MULTI_SET,
+  COMPARE_SET
+};
+
+#ifdef __linux__
+// The maximum number of events returned by a call to epoll_wait
+constexpr int kMaxEpollEvents = 256;
+#endif
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
@@ -54,6 +72,74 @@ void TCPStoreDaemon::join() {
   daemonThread_.join();
 }
 
+#ifdef __linux__
+// With thousands of clients, poll() would scan all of their sockets on every
+// query, so on Linux the daemon waits with epoll, which only returns the
+// sockets that are ready.
+void TCPStoreDaemon::run() {
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  auto watch = [epollFd](int fd, uint32_t events) {
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  watch(storeListenSocket_, EPOLLIN);
+  // Watch the read end of the pipe to signal the stopping of the daemon run
+  watch(controlPipeFd_[0], EPOLLIN);
+
+  std::vector<struct epoll_event> events(kMaxEpollEvents);
+
+  // receive the queries
+  bool finished = false;
+  while (!finished) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events.data(), events.size(), -1));
+    for (int i = 0; i < numEvents; ++i) {
+      const int fd = events[i].data.fd;
+      const uint32_t revents = events[i].events;
+
+      // TCPStore's listening socket has an event and it should now be able to
+      // accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.push_back(sockFd);
+        watch(sockFd, EPOLLIN);
+        continue;
+      }
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        finished = true;
+        break;
+      }
+
+      if (!(revents & EPOLLIN)) {
+        // The client hung up or its socket has an error
+        closeSocket(fd);
+        continue;
+      }
+      // Now query the socket that has the event
+      try {
+        query(fd);
+      } catch (...) {
+        // See the poll() version below. Closing the socket also removes it
+        // from the epoll set.
+        closeSocket(fd);
+      }
+    }
+  }
+  ::close(epollFd);
+}
+#else
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
   fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
@@ -63,8 +149,8 @@ void TCPStoreDaemon::run() {
   // receive the queries
   bool finished = false;
   while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
+    for (auto& fd : fds) {
+      fd.revents = 0;
     }
 
     SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
@@ -122,38 +208,37 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        closeSocket(fds[fdIdx].fd);
         fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
         --fdIdx;
         continue;
       }
     }
   }
 }
+#endif
+
+void TCPStoreDaemon::closeSocket(int socket) {
+  ::close(socket);
+
+  // Remove all the tracking state of the closed FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  sockets_.erase(std::remove(sockets_.begin(), sockets_.end(), socket), sockets_.end());
+}
 
 void TCPStoreDaemon::stop() {
   if (controlPipeFd_[1] != -1) {
@@ -166,7 +251,7 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of check, wait, multi get and multi set
 // type of query | number of args | size of arg1 | arg1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
@@ -187,6 +272,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -235,6 +329,54 @@ void TCPStoreDaemon::getHandler(int socket) const {
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    tcputil::sendVector<uint8_t>(socket, tcpStore_.at(keys[i]), (i != (nargs - 1)));
+  }
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::compareSetHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  auto expectedValue = tcputil::recvVector<uint8_t>(socket);
+  auto desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  auto pos = tcpStore_.find(key);
+  if (pos == tcpStore_.end()) {
+    if (expectedValue.empty()) {
+      tcpStore_[key] = desiredValue;
+      tcputil::sendVector<uint8_t>(socket, desiredValue);
+      wakeupWaitingClients(key);
+    } else {
+      tcputil::sendVector<uint8_t>(socket, expectedValue);
+    }
+  } else {
+    const bool matched = pos->second == expectedValue;
+    if (matched) {
+      pos->second = desiredValue;
+    }
+    tcputil::sendVector<uint8_t>(socket, pos->second);
+    if (matched) {
+      wakeupWaitingClients(key);
+    }
+  }
+}
+
 void TCPStoreDaemon::checkHandler(int socket) const {
   SizeType nargs;
   tcputil::recvBytes<SizeType>(socket, &nargs, 1);
@@ -365,6 +507,54 @@ int64_t TCPStore::addHelper_(const std::string& key, int64_t value) {
   return tcputil::recvValue<int64_t>(storeSocket_);
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  waitHelper_(regKeys, timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values[i] = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("multiSet expects as many values as keys");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regularPrefix_ + keys[i], true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 bool TCPStore::check(const std::vector<std::string>& keys) {
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
   SizeType nkeys = keys.size();
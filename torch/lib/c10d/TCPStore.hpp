@@ -21,12 +21,17 @@ class TCPStoreDaemon {
   void stop();
 
   void query(int socket);
+  // Closes the connection of a client and drops its waits
+  void closeSocket(int socket);
 
   void setHandler(int socket);
   void addHandler(int socket);
   void getHandler(int socket) const;
   void checkHandler(int socket) const;
   void waitHandler(int socket);
+  void multiGetHandler(int socket) const;
+  void multiSetHandler(int socket);
+  void compareSetHandler(int socket);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
@@ -38,6 +43,7 @@ class TCPStoreDaemon {
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
 
+  // The client sockets
   std::vector<int> sockets_;
   int storeListenSocket_;
   std::vector<int> controlPipeFd_{-1, -1};
@@ -67,6 +73,18 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
  protected:
   int64_t addHelper_(const std::string& key, int64_t value);
   std::vector<uint8_t> getHelper_(const std::string& key);
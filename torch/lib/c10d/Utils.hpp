@@ -270,6 +270,59 @@ inline std::vector<int> getDevices(const std::vector<at::Tensor>& tensors) {
   return devices;
 }
 
+// Checks the split sizes of an alltoall: they must either be empty, in
+// which case the first dimension of `tensor' is split evenly among the
+// `groupSize' processes, or have one entry per process that sum up to the
+// first dimension.
+inline void checkSplitSizes(
+    std::function<void(const std::string&)> fn,
+    const std::vector<int64_t>& splitSizes,
+    const at::Tensor& tensor,
+    int groupSize) {
+  if (splitSizes.size() == 0) {
+    if (tensor.dim() == 0 || tensor.size(0) % groupSize != 0) {
+      fn("tensor's first dimension must be divisible by the group size");
+    }
+    return;
+  }
+  if (splitSizes.size() != static_cast<size_t>(groupSize)) {
+    fn("number of split sizes must equal the group size");
+  }
+  int64_t sum = 0;
+  for (const auto splitSize : splitSizes) {
+    if (splitSize < 0) {
+      fn("split sizes must be non-negative");
+    }
+    sum += splitSize;
+  }
+  if (tensor.dim() == 0 || sum != tensor.size(0)) {
+    fn("split sizes must sum up to the tensor's first dimension");
+  }
+}
+
+// Computes the number of elements and the element offset of the slice of
+// `tensor' that an alltoall exchanges with every process, given split sizes
+// checked by checkSplitSizes. Returns the total number of elements.
+template <typename T>
+size_t computeLengthsAndOffsets(
+    const std::vector<int64_t>& splitSizes,
+    const at::Tensor& tensor,
+    std::vector<T>* lengths,
+    std::vector<T>* offsets) {
+  const size_t groupSize = lengths->size();
+  const bool equalSplits = splitSizes.size() == 0;
+  const size_t rowSize =
+      tensor.size(0) == 0 ? 0 : tensor.numel() / tensor.size(0);
+  size_t offset = 0;
+  for (size_t i = 0; i < groupSize; i++) {
+    const size_t rows = equalSplits ? tensor.size(0) / groupSize : splitSizes[i];
+    (*lengths)[i] = static_cast<T>(rows * rowSize);
+    (*offsets)[i] = static_cast<T>(offset);
+    offset += rows * rowSize;
+  }
+  return offset;
+}
+
 template <typename T>
 inline T* getDataPointer(const at::Tensor& tensor) {
   // NB: This does NOT respect storage_offset from the tensor
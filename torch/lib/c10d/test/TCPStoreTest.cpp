@@ -22,6 +22,27 @@ void testHelper(const std::string& prefix = "") {
   c10d::test::check(serverStore, "key1", "value1");
   c10d::test::check(serverStore, "key2", "value2");
 
+  // Batched set/get on the server store
+  serverStore.multiSet(
+      {"key3", "key4"},
+      {std::vector<uint8_t>{'3'}, std::vector<uint8_t>{'4'}});
+  auto values = serverStore.multiGet({"key0", "key3", "key4"});
+  if (values.size() != 3 || values[1] != std::vector<uint8_t>{'3'} ||
+      values[2] != std::vector<uint8_t>{'4'}) {
+    throw std::runtime_error("multiGet returned unexpected values");
+  }
+  c10d::test::check(serverStore, "key3", "3");
+
+  // compareSet only replaces the value when it matches the expected one
+  serverStore.compareSet(
+      "key5", std::vector<uint8_t>(), std::vector<uint8_t>{'a'});
+  serverStore.compareSet(
+      "key5", std::vector<uint8_t>{'b'}, std::vector<uint8_t>{'c'});
+  c10d::test::check(serverStore, "key5", "a");
+  serverStore.compareSet(
+      "key5", std::vector<uint8_t>{'a'}, std::vector<uint8_t>{'c'});
+  c10d::test::check(serverStore, "key5", "c");
+
   // Hammer on TCPStore
   std::vector<std::thread> threads;
   const auto numIterations = 1000;
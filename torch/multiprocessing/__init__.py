@@ -19,7 +19,8 @@ from .reductions import init_reductions
 import multiprocessing
 
 __all__ = ['set_sharing_strategy', 'get_sharing_strategy',
-           'get_all_sharing_strategies']
+           'get_all_sharing_strategies', 'set_shared_memory_placement',
+           'get_shared_memory_placement']
 
 
 from multiprocessing import *  # noqa: F401
@@ -75,4 +76,37 @@ def get_all_sharing_strategies():
     return _all_sharing_strategies
 
 
+def set_shared_memory_placement(huge_pages=False, numa_node=None):
+    """Sets where the pages of the shared memory that this process maps for
+    CPU tensors are placed.
+
+    This only affects shared memory that is mapped afterwards, and is best
+    effort: options that the system doesn't support are ignored. Processes
+    that are forked afterwards inherit the setting, other processes have to
+    set it themselves.
+
+    Arguments:
+        huge_pages (bool): ask for transparent huge pages, which reduces TLB
+            misses on large shared tensors. This requires
+            ``/sys/kernel/mm/transparent_hugepage/shmem_enabled`` to be
+            ``advise`` or ``always``.
+        numa_node (int, optional): prefer allocating the pages on this NUMA
+            node. The policy of a shared memory segment is shared by all
+            processes that map it. Linux only.
+    """
+    if numa_node is None:
+        numa_node = -1
+    elif numa_node < 0:
+        raise ValueError("numa_node should be a non-negative integer or None, "
+                         "but got {}".format(numa_node))
+    _set_shared_memory_placement(bool(huge_pages), int(numa_node))
+
+
+def get_shared_memory_placement():
+    """Returns the ``(huge_pages, numa_node)`` set with
+    :func:`set_shared_memory_placement`."""
+    huge_pages, numa_node = _get_shared_memory_placement()
+    return huge_pages, (numa_node if numa_node >= 0 else None)
+
+
 init_reductions()
@@ -1563,7 +1563,10 @@ def embedding_bag(input, weight, offsets=None, max_norm=None, norm_type=2,
             returned vectors filled by zeros.
 
         - :attr:`weight` (Tensor): the learnable weights of the module of
-          shape `(num_embeddings, embedding_dim)`
+          shape `(num_embeddings, embedding_dim)`. On CPU, this can also be a
+          table quantized rowwise by ``torch._embedding_bag_pack_8bit_rowwise``,
+          of shape `(num_embeddings, embedding_dim + 8)`, for ``"sum"`` and
+          ``"mean"`` mode. Quantized tables are not differentiable.
 
         - :attr:`per_sample_weights` (Tensor, optional). Has the same shape as
           :attr:`input`.
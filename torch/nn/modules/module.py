@@ -478,7 +478,11 @@ class Module(object):
             tracing_state.push_scope(self._get_name())
         tracing_state._traced_module_stack.append(self)
         try:
-            result = self.forward(*input, **kwargs)
+            module_traces = getattr(tracing_state, '_module_traces', None)
+            if module_traces is not None and len(tracing_state._traced_module_stack) > 1:
+                result = torch.jit._call_with_reused_trace(self, module_traces, input, kwargs)
+            else:
+                result = self.forward(*input, **kwargs)
         finally:
             tracing_state.pop_scope()
             tracing_state._traced_module_stack.pop()
@@ -216,6 +216,12 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        fp16_compression (bool): Cast gradients of float and double parameters
+                                 to half precision before they are all-reduced,
+                                 and cast the result back afterwards. This halves
+                                 the bytes sent compared to float, at the cost
+                                 of precision of the averaged gradients.
+                                 (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -229,7 +235,8 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 fp16_compression=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -272,6 +279,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.fp16_compression = fp16_compression
 
         if check_reduction:
             # This argument is no longer used since the reducer
@@ -329,22 +337,45 @@ class DistributedDataParallel(Module):
             list(filter(lambda p: p.requires_grad, module.parameters()))
             for module in self._module_copies]
 
+        # Sparse gradients are reduced in a bucket of their own, without
+        # being densified. This requires a backend with sparse allreduce.
+        def produces_sparse_gradient(module):
+            if isinstance(module, (torch.nn.Embedding, torch.nn.EmbeddingBag)):
+                return module.sparse
+            return False
+
+        expect_sparse_gradient = []
+        for module, params in zip(self._module_copies, param_list):
+            sparse_params = set(
+                id(p) for submodule in module.modules()
+                if produces_sparse_gradient(submodule)
+                for p in submodule.parameters(recurse=False))
+            expect_sparse_gradient.append([id(p) in sparse_params for p in params])
+
         # The bucket size limit is specified in the constructor.
         # Additionally, we allow for a single small bucket for parameters
         # that are defined first, such that their gradients don't spill into
         # a much larger bucket, adding unnecessary latency after gradient
         # computation finishes. Experiments showed 1MB is a reasonable value.
+        bucket_size_limits = [1024 * 1024, self.bucket_bytes_cap]
         bucket_indices = dist._compute_bucket_assignment_by_size(
             param_list[0],
-            [1024 * 1024, self.bucket_bytes_cap])
+            bucket_size_limits,
+            expect_sparse_gradient[0])
 
         # Note: reverse list of buckets because we want to approximate the
         # order in which their gradients are produced, and assume they
         # are used in the forward pass in the order they are defined.
+        # The reducer rebuilds the buckets with the same size limits after
+        # the first iteration, using the order in which gradients were
+        # actually produced.
         self.reducer = dist.Reducer(
             param_list,
             list(reversed(bucket_indices)),
-            self.process_group)
+            self.process_group,
+            bucket_size_limits,
+            self.fp16_compression,
+            expect_sparse_gradient)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -360,8 +391,26 @@ class DistributedDataParallel(Module):
         # If serializable, then the process group should be the default one
         self.process_group = _get_default_group()
         super(DistributedDataParallel, self).__setstate__(state)
+        self.__dict__.setdefault('fp16_compression', False)
         self._ddp_init_helper()
 
+    def _register_comm_hook(self, hook):
+        r"""
+        Registers a hook that reduces the gradient buckets in place of the
+        allreduce of the reducer. The hook is called with the list of
+        gradient bucket tensors of all model replicas as soon as a bucket is
+        ready, and must return the work of the collective that reduces them,
+        e.g. ``process_group.allreduce(tensors)``. Gradients are not divided
+        by the world size before the hook is called, so the hook is
+        responsible for any averaging. Must be called before the first
+        backward pass, and cannot be combined with ``fp16_compression``.
+
+        Arguments:
+            hook (callable): callable taking a list of tensors and returning
+                a ``Work`` object
+        """
+        self.reducer._register_comm_hook(hook)
+
     def _check_default_group(self):
         pickle_not_supported = False
         try:
@@ -0,0 +1,223 @@
+import torch
+import torch.distributed as dist
+
+if dist.is_available():
+    from torch.distributed.distributed_c10d import _get_default_group
+
+from ..modules import Module
+from ..parameter import Parameter
+
+
+class _Unit(object):
+    r"""
+    A group of parameters that are gathered together, namely the direct
+    parameters of the given ``(prefix, module)`` pairs. The parameters are
+    flattened into a single tensor, padded to a multiple of the world size,
+    of which every process owns one contiguous shard.
+    """
+
+    def __init__(self, owners, process_group):
+        self.process_group = process_group
+        # (key, owner, name, shape, offset) of every flattened parameter
+        self.entries = []
+        self.pending = None
+
+        params = []
+        offset = 0
+        for prefix, owner in owners:
+            for name, param in list(owner._parameters.items()):
+                if param is None:
+                    continue
+                key = prefix + '.' + name if prefix else name
+                self.entries.append((key, owner, name, param.shape, offset))
+                offset += param.numel()
+                params.append(param)
+                # The parameter becomes a plain attribute, which holds a view
+                # of the gathered parameters during forward only.
+                del owner._parameters[name]
+                setattr(owner, name, None)
+
+        if len(set(p.dtype for p in params)) != 1 or \
+                len(set(p.device for p in params)) != 1:
+            raise ValueError("ShardedDataParallel requires the parameters of "
+                             "every submodule to have the same type and device")
+
+        world_size = process_group.size()
+        flat = torch.cat([p.detach().reshape(-1) for p in params])
+        padding = -flat.numel() % world_size
+        if padding > 0:
+            flat = torch.cat([flat, flat.new_zeros(padding)])
+        self.numel = flat.numel()
+        self.shard = Parameter(
+            flat.chunk(world_size)[process_group.rank()].clone())
+
+    def start_gather(self):
+        r"""Starts gathering the shards of all processes, unless it already
+        started."""
+        if self.pending is None:
+            gathered = self.shard.new_empty(self.numel)
+            outputs = list(gathered.chunk(self.process_group.size()))
+            work = self.process_group.allgather([outputs], [self.shard.detach()])
+            self.pending = (work, gathered)
+
+    def wait_gather(self):
+        self.start_gather()
+        work, gathered = self.pending
+        self.pending = None
+        work.wait()
+        return gathered
+
+    def views(self, gathered):
+        r"""Yields the key, the owner, the name and the view of the gathered
+        parameters of every parameter of the unit."""
+        for key, owner, name, shape, offset in self.entries:
+            numel = 1
+            for size in shape:
+                numel *= size
+            yield key, owner, name, gathered[offset:offset + numel].view(shape)
+
+    def set_parameters(self, gathered):
+        if gathered is None:
+            for _, owner, name, _, _ in self.entries:
+                setattr(owner, name, None)
+        else:
+            for _, owner, name, view in self.views(gathered):
+                setattr(owner, name, view)
+
+
+class _GatherShards(torch.autograd.Function):
+    r"""
+    Returns the gathered parameters of a unit, and reduce-scatters their
+    gradient into the gradient of the shard of this process.
+    """
+
+    @staticmethod
+    def forward(ctx, shard, unit):
+        ctx.process_group = unit.process_group
+        return unit.wait_gather()
+
+    @staticmethod
+    def backward(ctx, grad_output):
+        process_group = ctx.process_group
+        world_size = process_group.size()
+        inputs = list(grad_output.contiguous().chunk(world_size))
+        grad_shard = torch.empty_like(inputs[0])
+        process_group.reduce_scatter([grad_shard], [inputs]).wait()
+        grad_shard.div_(world_size)
+        return grad_shard, None
+
+
+class ShardedDataParallel(Module):
+    r"""Implements data parallelism at the module level, with sharded
+    parameters, gradients and optimizer state.
+
+    Like :class:`~torch.nn.parallel.DistributedDataParallel`, this container
+    runs a replica of the module in every process, on its part of the input
+    batch, and averages the gradients across processes. Instead of keeping
+    all parameters in every process, it flattens the parameters of every
+    direct submodule of ``module`` (and the direct parameters of ``module``)
+    into a unit, and every process keeps one ``1 / world_size`` shard of
+    every unit. The parameters of ``module`` are replaced by the shards, so
+    an optimizer created for :meth:`parameters` only keeps state for the
+    shards, and the memory of parameters, gradients and optimizer state
+    scales down with the world size.
+
+    The parameters of a unit are all-gathered just before its forward pass,
+    and the gathering of the next unit starts at the same time, so
+    communication overlaps with computation when the submodules run in
+    registration order (as in :class:`~torch.nn.Sequential`). After the
+    forward pass of a unit, the module no longer references its gathered
+    parameters, which autograd releases after the backward pass. The
+    gradients of the gathered parameters are reduce-scattered into the
+    gradients of the shards as soon as autograd computes them.
+
+    .. warning::
+        The parameters of a unit must have the same type and device, the
+        module must be on a single device, and its buffers are only
+        broadcast from rank 0 at construction. The state dict of the wrapped
+        module no longer contains its parameters; use
+        :meth:`gathered_state_dict` to save a checkpoint.
+
+    Args:
+        module (Module): module to be parallelized
+        process_group: the c10d process group to be used. The default group
+            is used if ``None``.
+
+    Example::
+
+        >>> torch.distributed.init_process_group(backend='nccl')
+        >>> model = torch.nn.Sequential(
+        ...     torch.nn.Linear(1024, 4096), torch.nn.ReLU(),
+        ...     torch.nn.Linear(4096, 1024)).cuda()
+        >>> model = torch.nn.parallel.ShardedDataParallel(model)
+        >>> optimizer = torch.optim.Adam(model.parameters())
+    """
+
+    def __init__(self, module, process_group=None):
+        super(ShardedDataParallel, self).__init__()
+
+        if process_group is None:
+            self.process_group = _get_default_group()
+        else:
+            self.process_group = process_group
+
+        # Start from the module state of rank 0.
+        module_states = list(module.state_dict().values())
+        if len(module_states) > 0:
+            MB = 1024 * 1024
+            dist._broadcast_coalesced(
+                self.process_group, module_states, int(250 * MB))
+
+        self.module = module
+        self._units = []
+        submodules = []
+        if any(p is not None for p in module._parameters.values()):
+            # The direct parameters of `module` form a unit of their own.
+            self._units.append(_Unit([('', module)], self.process_group))
+            submodules.append(module)
+        for name, child in module.named_children():
+            if not any(True for _ in child.parameters()):
+                continue
+            owners = [(name + '.' + prefix if prefix else name, owner)
+                      for prefix, owner in child.named_modules()]
+            self._units.append(_Unit(owners, self.process_group))
+            submodules.append(child)
+        self.shards = torch.nn.ParameterList(
+            [unit.shard for unit in self._units])
+
+        for index, submodule in enumerate(submodules):
+            submodule.register_forward_pre_hook(self._make_pre_hook(index))
+            submodule.register_forward_hook(self._make_post_hook(index))
+
+    def _make_pre_hook(self, index):
+        def hook(module, input):
+            unit = self._units[index]
+            gathered = _GatherShards.apply(unit.shard, unit)
+            # Overlap the gathering of the next unit with this forward pass.
+            if index + 1 < len(self._units):
+                self._units[index + 1].start_gather()
+            unit.set_parameters(gathered)
+        return hook
+
+    def _make_post_hook(self, index):
+        def hook(module, input, output):
+            self._units[index].set_parameters(None)
+        return hook
+
+    def forward(self, *inputs, **kwargs):
+        # Gathers left over from the previous iteration hold stale shards.
+        for unit in self._units:
+            if unit.pending is not None:
+                unit.wait_gather()
+        return self.module(*inputs, **kwargs)
+
+    def gathered_state_dict(self):
+        r"""Returns the state dict of the wrapped module, with its full
+        parameters gathered from all processes. Must be called by all
+        processes."""
+        state_dict = self.module.state_dict()
+        for unit in self._units:
+            gathered = unit.wait_gather()
+            for key, _, _, view in unit.views(gathered):
+                state_dict[key] = view.clone()
+        return state_dict
@@ -319,6 +319,40 @@ def pad_packed_sequence(sequence, batch_first=False, padding_value=0.0, total_le
     return padded_output, lengths
 
 
+def sum_packed_sequence(sequence):
+    r"""Sums each sequence of a packed batch over time.
+
+    The sums are computed directly from the packed data, without padding it
+    first. Together with functions applied to :attr:`sequence.data` (which
+    holds the steps of all the sequences, e.g. the output of an
+    :class:`~torch.nn.Linear` layer or of an elementwise function), this allows
+    reducing a batch of variable length sequences without computing anything on
+    padding.
+
+    The returned Tensor's data will be of size ``B x *``, where `B` is the batch
+    size, and its batch elements are in the same order as the ones of the
+    sequences :attr:`sequence` was packed from.
+
+    Example:
+        >>> from torch.nn.utils.rnn import pack_sequence, sum_packed_sequence
+        >>> a = torch.tensor([1, 2, 3])
+        >>> b = torch.tensor([4, 5])
+        >>> c = torch.tensor([6])
+        >>> sum_packed_sequence(pack_sequence([a, b, c]))
+        tensor([ 6,  9,  6])
+
+    Arguments:
+        sequence (PackedSequence): batch to sum
+
+    Returns:
+        Tensor containing the sum of each sequence in the batch.
+
+    """
+    output = torch._C._VariableFunctions._sum_packed_sequence(sequence.data, sequence.batch_sizes)
+    if sequence.unsorted_indices is not None:
+        return output.index_select(0, sequence.unsorted_indices)
+    return output
+
 def pad_sequence(sequences, batch_first=False, padding_value=0):
     r"""Pad a list of variable length Tensors with ``padding_value``
 
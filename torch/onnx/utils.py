@@ -362,6 +362,17 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
                                                         example_outputs, propagate,
                                                         _retain_param_name, do_constant_folding)
 
+        if export_type == ExportTypes.DIRECTORY and export_params:
+            # the weights are written from C++, without building the whole
+            # protobuf or copying them into Python bytes first
+            import os
+            if os.path.exists(f):
+                assert(os.path.isdir(f))
+            else:
+                os.makedirs(f)
+            graph._export_onnx_to_directory(params_dict, opset_version, f, operator_export_type, strip_doc_string)
+            return torch_out
+
         # TODO: Don't allocate a in-memory string for the protobuf
         defer_weight_export = export_type is not ExportTypes.PROTOBUF_FILE
         if export_params:
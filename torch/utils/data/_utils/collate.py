@@ -8,6 +8,7 @@ static methods.
 import torch
 import re
 from torch._six import container_abcs, string_classes, int_classes
+from . import shm_ring
 
 _use_shared_memory = False
 r"""Whether to use shared memory in default_collate"""
@@ -38,7 +39,7 @@ def default_collate(batch):
             # If we're in a background process, concatenate directly into a
             # shared memory tensor to avoid an extra copy
             numel = sum([x.numel() for x in batch])
-            storage = batch[0].storage()._new_shared(numel)
+            storage = shm_ring.new_shared_storage(batch[0].storage(), numel)
             out = batch[0].new(storage)
         return torch.stack(batch, 0, out=out)
     elif elem_type.__module__ == 'numpy' and elem_type.__name__ != 'str_' \
@@ -0,0 +1,178 @@
+r""""Contains definitions of the shared memory rings that _DataLoaderIter
+workers collate batches into.
+
+NOTE [ Data Loader Shared Memory Rings ]
+
+Sending a tensor from a worker to the main process normally creates a new
+shared memory segment for its storage, and passes a file descriptor (or a
+file name) for it along with the batch, which the main process then maps.
+With small batches at a high rate, creating, passing and mapping segments
+takes longer than collating.
+
+Instead, each worker allocates the storages of the batches it collates from
+a few persistent segments, one per storage type, which are used as ring
+buffers. A segment is only sent to the main process along with the first
+batch that uses it; later batches only carry the offset and size of their
+storage in it, and the main process rebuilds them as slices of its mapping.
+
+The main process tracks when the storages it rebuilt from a segment die
+(with weak references) and publishes the position up to which the ring has
+been released in a small shared counter that is sent with the segment. Slots
+are released in allocation order, so a batch that is held on to delays the
+reuse of the ones after it. If a ring doesn't have enough free space, the
+worker falls back to a new segment for that storage, which is always
+correct.
+
+Storages rebuilt from a ring are slices of a shared storage, so they don't
+report is_shared() themselves, and are moved to a segment of their own if
+they are sent to yet another process.
+"""
+
+import os
+import threading
+from collections import deque
+from multiprocessing.reduction import ForkingPickler
+
+import torch
+from torch.multiprocessing import reductions
+
+RING_SLOTS = 8
+r"""Number of storages of the first size requested from a ring that it can
+hold at once"""
+
+
+class _WorkerRing(object):
+    r"""A shared memory ring in a worker process"""
+
+    def __init__(self, key, storage_type, capacity):
+        self.key = key
+        self.segment = storage_type._new_shared(capacity)
+        self.released = torch.LongStorage._new_shared(1)
+        self.released[0] = 0
+        self.capacity = capacity
+        self.start = self.segment.data_ptr()
+        self.end = self.start + capacity * self.segment.element_size()
+        # absolute position of the next allocation, its offset in the segment
+        # is head % capacity
+        self.head = 0
+        # offset of a live storage -> position the ring can be released up to
+        # once it dies
+        self.ends = {}
+        self.sent = False
+
+    def allocate(self, numel):
+        offset = self.head % self.capacity
+        if offset + numel > self.capacity:
+            # don't wrap storages around the end of the segment
+            padding = self.capacity - offset
+            offset = 0
+        else:
+            padding = 0
+        if self.head + padding + numel - self.released[0] > self.capacity:
+            return None
+        self.head += padding + numel
+        self.ends[offset] = self.head
+        return self.segment[offset:offset + numel]
+
+    def contains(self, storage):
+        return self.start <= storage.data_ptr() < self.end
+
+
+_worker_rings = {}
+_rings_enabled = False
+
+
+def new_shared_storage(like, numel):
+    r"""Returns a shared memory storage of the same type as ``like`` with
+    ``numel`` elements, carved out of this worker's ring for that type if it
+    has room. See NOTE [ Data Loader Shared Memory Rings ]."""
+    storage_type = type(like)
+    if not _rings_enabled or numel == 0:
+        return like._new_shared(numel)
+    ring = _worker_rings.get(storage_type)
+    if ring is None:
+        key = (os.getpid(), len(_worker_rings))
+        ring = _WorkerRing(key, storage_type, numel * RING_SLOTS)
+        _worker_rings[storage_type] = ring
+    storage = ring.allocate(numel)
+    if storage is None:
+        return like._new_shared(numel)
+    return storage
+
+
+class _SharedStorage(object):
+    r"""Pickles a storage the way torch.multiprocessing always does, even if
+    it lives in a ring"""
+
+    def __init__(self, storage):
+        self.storage = storage
+
+    def __reduce__(self):
+        return reductions.reduce_storage(self.storage)
+
+
+def _reduce_storage(storage):
+    ring = _worker_rings.get(type(storage))
+    if ring is None or not ring.contains(storage):
+        return reductions.reduce_storage(storage)
+    offset = (storage.data_ptr() - ring.start) // storage.element_size()
+    end = ring.ends.pop(offset, None)
+    if end is None:
+        # e.g. the same storage sent twice, or a slice of one from the ring
+        return reductions.reduce_storage(storage)
+    if ring.sent:
+        segment = None
+    else:
+        segment = (_SharedStorage(ring.segment), _SharedStorage(ring.released))
+        ring.sent = True
+    return (_rebuild_storage, (ring.key, segment, offset, storage.size(), end))
+
+
+def init_worker_reductions():
+    r"""Makes the batches a worker sends refer to its rings"""
+    global _rings_enabled
+    _rings_enabled = True
+    for t in torch._storage_classes:
+        ForkingPickler.register(t, _reduce_storage)
+
+
+class _MainRing(object):
+    r"""The main process side of a worker's shared memory ring"""
+
+    def __init__(self, segment, released):
+        self.segment = segment
+        self.released = released
+        # (weak reference to a storage, position released with it), in
+        # allocation order
+        self.live = deque()
+
+    def release_dead_storages(self):
+        released = None
+        while self.live and self.live[0][0].expired():
+            released = self.live.popleft()[1]
+        if released is not None:
+            self.released[0] = released
+
+
+_main_rings = {}
+_main_rings_lock = threading.Lock()
+
+
+def _rebuild_storage(key, segment, offset, size, end):
+    with _main_rings_lock:
+        if segment is not None:
+            _main_rings[key] = _MainRing(*segment)
+        ring = _main_rings[key]
+        ring.release_dead_storages()
+        storage = ring.segment[offset:offset + size]
+        ring.live.append((reductions.StorageWeakRef(storage), end))
+    return storage
+
+
+def release_worker_rings(pids):
+    r"""Unmaps the rings of the given worker processes in the main process.
+    Storages rebuilt from them keep their part of the mapping alive."""
+    with _main_rings_lock:
+        for key in list(_main_rings.keys()):
+            if key[0] in pids:
+                del _main_rings[key]
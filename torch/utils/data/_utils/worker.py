@@ -9,7 +9,7 @@ import random
 import sys
 import os
 from torch._six import queue
-from . import collate, signal_handling, MP_STATUS_CHECK_INTERVAL, \
+from . import collate, signal_handling, shm_ring, MP_STATUS_CHECK_INTERVAL, \
     ExceptionWrapper, IS_WINDOWS
 
 if IS_WINDOWS:
@@ -61,6 +61,8 @@ def _worker_loop(dataset, index_queue, data_queue, done_event, collate_fn, seed,
 
     try:
         collate._use_shared_memory = True
+        # See NOTE [ Data Loader Shared Memory Rings ]
+        shm_ring.init_worker_reductions()
 
         # Intialize C side signal handlers for SIGBUS and SIGSEGV. Python signal
         # module's handlers are executed after Python returns from C low-level
@@ -671,6 +671,7 @@ class _DataLoaderIter(object):
                 if self.worker_pids_set:
                     _utils.signal_handling._remove_worker_pids(id(self))
                     self.worker_pids_set = False
+                _utils.shm_ring.release_worker_rings(set(w.pid for w in self.workers))
 
     def __del__(self):
         if self.num_workers > 0:
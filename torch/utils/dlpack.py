@@ -1,28 +1,76 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 import torch
 
-from torch._C import _from_dlpack as from_dlpack
-from torch._C import _to_dlpack as to_dlpack
+from torch._six import int_classes
 
-torch._C._add_docstr(from_dlpack, r"""from_dlpack(dlpack) -> Tensor
 
-Decodes a DLPack to a tensor.
+def _stream_handle(stream):
+    if isinstance(stream, torch.cuda.Stream):
+        return stream.cuda_stream
+    if isinstance(stream, int_classes):
+        return stream
+    raise TypeError("expected stream to be a torch.cuda.Stream or a raw CUDA "
+                    "stream handle as int, but got {}".format(type(stream).__name__))
 
-Args:
-    dlpack: a PyCapsule object with the dltensor
 
-The tensor will share the memory with the object represented
-in the dlpack.
-Note that each dlpack can only be consumed once.
-""")
+def from_dlpack(dlpack, stream=None):
+    r"""from_dlpack(dlpack, stream=None) -> Tensor
 
-torch._C._add_docstr(to_dlpack, r"""to_dlpack(tensor) -> PyCapsule
+    Decodes a DLPack to a tensor.
 
-Returns a DLPack representing the tensor.
+    Args:
+        dlpack: a PyCapsule object with the dltensor
+        stream (torch.cuda.Stream or int, optional): the CUDA stream the
+            producer of a CUDA DLPack last used its memory on, either as a
+            :class:`torch.cuda.Stream` or as a raw ``cudaStream_t`` handle
+            (e.g. from another library). If given, the current stream waits
+            for the work queued on :attr:`stream` so far before any work
+            queued on the returned tensor, without blocking the host.
+            Default: ``None``, meaning the producer already synchronized.
 
-Args:
-    tensor: a tensor to be exported
+    The tensor will share the memory with the object represented
+    in the dlpack, including its strides and byte offset, so no data is
+    copied. Note that each dlpack can only be consumed once.
+    """
+    tensor = torch._C._from_dlpack(dlpack)
+    if stream is not None and tensor.is_cuda:
+        with torch.cuda.device(tensor.device):
+            torch._C._cuda_streamWaitStream(torch.cuda.current_stream().cuda_stream,
+                                            _stream_handle(stream))
+    return tensor
 
-The dlpack shares the tensors memory.
-Note that each dlpack can only be consumed once.
-""")
+
+def to_dlpack(tensor, stream=None):
+    r"""to_dlpack(tensor, stream=None) -> PyCapsule
+
+    Returns a DLPack representing the tensor.
+
+    Args:
+        tensor: a tensor to be exported
+        stream (torch.cuda.Stream or int, optional): the CUDA stream the
+            consumer of a CUDA tensor is going to use its memory on, either
+            as a :class:`torch.cuda.Stream` or as a raw ``cudaStream_t``
+            handle (e.g. from another library). If given, :attr:`stream`
+            waits for the work queued on the current stream so far, without
+            blocking the host, so the consumer doesn't have to synchronize.
+            Default: ``None``.
+
+    The dlpack shares the tensors memory, and describes non-contiguous
+    tensors by their strides, so no data is copied.
+    Note that each dlpack can only be consumed once.
+
+    .. note::
+        If :attr:`stream` is a :class:`torch.cuda.Stream`, the memory of
+        :attr:`tensor` is also marked as in use by it (see
+        :meth:`~torch.Tensor.record_stream`). This isn't possible for raw
+        handles, so then the consumer has to finish its work on the memory
+        before the tensor is freed.
+    """
+    if stream is not None and tensor.is_cuda:
+        handle = _stream_handle(stream)
+        with torch.cuda.device(tensor.device):
+            torch._C._cuda_streamWaitStream(handle,
+                                            torch.cuda.current_stream().cuda_stream)
+        if isinstance(stream, torch.cuda.Stream):
+            tensor.record_stream(stream)
+    return torch._C._to_dlpack(tensor)